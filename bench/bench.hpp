@@ -0,0 +1,225 @@
+#pragma once
+
+// Minimal benchmark harness shared by the bench/ programs: repeated timed
+// runs with the median reported, plus an in-memory CAN feed for IsoNet.
+// Each program prints a table to stderr and JSON to stdout (or --out FILE),
+// so runs can be diffed between releases. A program that defines
+// BENCH_COUNT_ALLOCATIONS before including this header also gets heap
+// allocations per operation: the global operator new is replaced with a
+// counting one.
+
+#include <agrobus/net/eth_can.hpp>
+#include <agrobus/net/frame.hpp>
+#include <agrobus/net/trace.hpp>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <wirebit/can/can_endpoint.hpp>
+
+namespace bench {
+
+    using namespace agrobus::net;
+
+    // Keep a value alive so the optimizer cannot drop the work behind it
+    template <typename T> inline void keep(const T &value) { asm volatile("" : : "r,m"(value) : "memory"); }
+
+    // ─── Allocation counting ─────────────────────────────────────────────────────
+#ifdef BENCH_COUNT_ALLOCATIONS
+    inline constexpr bool counting_allocations = true;
+#else
+    inline constexpr bool counting_allocations = false;
+#endif
+    inline std::atomic<u64> allocations{0}; // operator new calls so far
+
+    // ─── Results ─────────────────────────────────────────────────────────────────
+    struct Result {
+        dp::String name;
+        dp::String params;
+        u64 ops = 0;                // Operations per run
+        u64 bytes_per_op = 0;       // For MB/s; 0 when not a throughput case
+        double ns_per_op = 0.0;     // Median over the runs
+        double ns_min = 0.0;        // Fastest run
+        double allocs_per_op = 0.0; // Over the timed runs; with BENCH_COUNT_ALLOCATIONS
+        double ops_per_s() const { return ns_per_op > 0.0 ? 1e9 / ns_per_op : 0.0; }
+        double mb_per_s() const { return ns_per_op > 0.0 ? bytes_per_op * 1e3 / ns_per_op : 0.0; }
+    };
+
+    // ─── Suite ───────────────────────────────────────────────────────────────────
+    // Options: --out FILE (JSON destination), --repeats N (default 5),
+    // --quick (a tenth of the operations, for smoke runs)
+    class Suite {
+        const char *suite_;
+        const char *out_path_ = nullptr;
+        u32 repeats_ = 5;
+        u64 divisor_ = 1;
+        dp::Vector<Result> results_;
+        u32 failures_ = 0;
+
+      public:
+        Suite(const char *name, int argc, char **argv) : suite_(name) {
+            for (int i = 1; i < argc; ++i) {
+                if (std::strcmp(argv[i], "--out") == 0 && i + 1 < argc)
+                    out_path_ = argv[++i];
+                else if (std::strcmp(argv[i], "--repeats") == 0 && i + 1 < argc)
+                    repeats_ = static_cast<u32>(std::atoi(argv[++i]));
+                else if (std::strcmp(argv[i], "--quick") == 0)
+                    divisor_ = 10;
+            }
+            if (repeats_ == 0)
+                repeats_ = 1;
+        }
+
+        // Time `fn(ops)`, which must perform `ops` operations, after one warm-up
+        template <typename Fn>
+        void run(const char *name, dp::String params, u64 ops, u64 bytes_per_op, Fn &&fn) {
+            ops = ops / divisor_ > 0 ? ops / divisor_ : 1;
+            fn(ops);
+            dp::Vector<double> samples;
+            u64 allocs_before = allocations.load(std::memory_order_relaxed);
+            for (u32 r = 0; r < repeats_; ++r) {
+                auto start = std::chrono::steady_clock::now();
+                fn(ops);
+                auto ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+                double per_op = ns / static_cast<double>(ops);
+                // Insertion sort; a handful of samples
+                usize at = samples.size();
+                samples.push_back(per_op);
+                while (at > 0 && samples[at - 1] > per_op) {
+                    samples[at] = samples[at - 1];
+                    --at;
+                }
+                samples[at] = per_op;
+            }
+            Result res;
+            res.name = name;
+            res.params = std::move(params);
+            res.ops = ops;
+            res.bytes_per_op = bytes_per_op;
+            res.ns_per_op = samples[samples.size() / 2];
+            res.ns_min = samples[0];
+            res.allocs_per_op = static_cast<double>(allocations.load(std::memory_order_relaxed) - allocs_before) /
+                                static_cast<double>(ops * repeats_);
+            std::fprintf(stderr, "%-28s %-22s %12.1f ns/op %14.0f op/s", res.name.c_str(), res.params.c_str(),
+                         res.ns_per_op, res.ops_per_s());
+            if (bytes_per_op > 0)
+                std::fprintf(stderr, " %10.1f MB/s", res.mb_per_s());
+            if (counting_allocations)
+                std::fprintf(stderr, " %10.2f alloc/op", res.allocs_per_op);
+            std::fprintf(stderr, "\n");
+            results_.push_back(std::move(res));
+        }
+
+        // Sanity check on what a case did (a transfer that aborted every time
+        // would otherwise look fast); a failure makes finish() return 1
+        void check(bool ok, const char *what) {
+            if (!ok) {
+                std::fprintf(stderr, "check failed: %s\n", what);
+                ++failures_;
+            }
+        }
+
+        // Write the JSON report; returns the process exit code
+        int finish() const {
+            FILE *out = out_path_ ? std::fopen(out_path_, "w") : stdout;
+            if (!out) {
+                std::fprintf(stderr, "cannot write %s\n", out_path_);
+                return 1;
+            }
+            // The trace level is part of the report: runs at different levels are
+            // how the cost of compiled-in tracing is measured
+            std::fprintf(out, "{\n  \"suite\": \"%s\",\n  \"repeats\": %u,\n  \"trace_level\": %d,\n  \"results\": [\n",
+                         suite_, repeats_, AGROBUS_TRACE_LEVEL);
+            for (usize i = 0; i < results_.size(); ++i) {
+                const Result &r = results_[i];
+                char allocs[48] = "";
+                if (counting_allocations)
+                    std::snprintf(allocs, sizeof(allocs), ", \"allocs_per_op\": %.2f", r.allocs_per_op);
+                std::fprintf(out,
+                             "    {\"name\": \"%s\", \"params\": \"%s\", \"ops\": %llu, \"ns_per_op\": %.2f, "
+                             "\"ns_per_op_min\": %.2f, \"ops_per_s\": %.0f, \"mb_per_s\": %.2f%s}%s\n",
+                             r.name.c_str(), r.params.c_str(), static_cast<unsigned long long>(r.ops), r.ns_per_op,
+                             r.ns_min, r.ops_per_s(), r.mb_per_s(), allocs, i + 1 < results_.size() ? "," : "");
+            }
+            std::fprintf(out, "  ]\n}\n");
+            if (out != stdout)
+                std::fclose(out);
+            return failures_ > 0 ? 1 : 0;
+        }
+    };
+
+    inline dp::String param(const char *key, u64 value) {
+        char buf[64];
+        std::snprintf(buf, sizeof(buf), "%s=%llu", key, static_cast<unsigned long long>(value));
+        return buf;
+    }
+
+    // ─── FrameFeed ───────────────────────────────────────────────────────────────
+    // Receive-only CAN endpoint that cycles through a fixed set of frames,
+    // `load(n)` of them at a time, so IsoNet::update() drains exactly n frames
+    // without a kernel in the way. Sent frames are only counted.
+    class FrameFeed {
+        dp::Vector<can_frame> frames_;
+        usize next_ = 0;
+        u64 remaining_ = 0;
+        u64 sent_ = 0;
+        std::shared_ptr<CanTunnelLink<FrameFeed>> link_;
+        wirebit::CanEndpoint can_ep_;
+
+      public:
+        FrameFeed()
+            : link_(std::make_shared<CanTunnelLink<FrameFeed>>(this, "bench_feed")),
+              can_ep_(std::static_pointer_cast<wirebit::Link>(link_), wirebit::CanConfig{.bitrate = 250000}, 0) {}
+
+        FrameFeed(const FrameFeed &) = delete;
+        FrameFeed &operator=(const FrameFeed &) = delete;
+
+        void add(const Frame &f) {
+            can_frame cf = {};
+            cf.can_id = f.id.raw | CAN_EFF_FLAG;
+            cf.can_dlc = f.length;
+            std::memcpy(cf.data, f.data.data(), 8);
+            frames_.push_back(cf);
+        }
+
+        void load(u64 n) { remaining_ = n; }
+
+        // Attach as port `port` of `nm`, on the direct receive path
+        template <typename Net> void attach(Net &nm, u8 port = 0) {
+            nm.set_endpoint(port, &can_ep_);
+            nm.set_rx_source(port, [this](can_frame &cf) { return pop_can(cf); });
+        }
+
+        bool pop_can(can_frame &cf) {
+            if (remaining_ == 0 || frames_.empty())
+                return false;
+            --remaining_;
+            cf = frames_[next_];
+            if (++next_ == frames_.size())
+                next_ = 0;
+            return true;
+        }
+        void send_can(const can_frame &) { ++sent_; }
+        u32 rx_pending() const noexcept { return remaining_ > 0 ? 1 : 0; }
+
+        wirebit::CanEndpoint &can_endpoint() noexcept { return can_ep_; }
+        u64 sent() const noexcept { return sent_; }
+    };
+
+} // namespace bench
+
+#ifdef BENCH_COUNT_ALLOCATIONS
+#include <new>
+
+// Counting replacements; the array and nothrow forms forward to these. Kept
+// out of line so GCC does not pair malloc/free across them and warn.
+__attribute__((noinline)) void *operator new(std::size_t size) {
+    bench::allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void *p = std::malloc(size > 0 ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+__attribute__((noinline)) void operator delete(void *p) noexcept { std::free(p); }
+__attribute__((noinline)) void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+#endif
@@ -0,0 +1,101 @@
+// Scale test: the network under test on a timed loopback bus with many
+// virtual ECUs. Options: --ecus N (default 40), --load PERCENT (background,
+// default 30), --seconds S (default 30), --storm MS (claim storm interval,
+// 0 = off), --out FILE. Prints a table to stderr and JSON to stdout (or FILE);
+// exits 1 when a kind of traffic lost more than 1% of its messages.
+
+#include <agrobus/net/load_generator.hpp>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+using namespace agrobus::net;
+
+namespace {
+
+    const char *kind_name(usize kind) {
+        static const char *names[LOAD_KINDS] = {"periodic", "bam", "tp", "etp", "fast_packet", "dm1"};
+        return names[kind];
+    }
+
+} // namespace
+
+int main(int argc, char **argv) {
+    LoadConfig config = LoadConfig{}
+                            .periodic(2, 500)
+                            .bam(5000, 100)
+                            .tp(10000, 200)
+                            .etp(120000, 2000)
+                            .fast_packet(5000, 43)
+                            .dm1(1000, 1)
+                            .claim_storms(10000);
+    u64 seconds = 30;
+    const char *out_path = nullptr;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--ecus") == 0 && i + 1 < argc)
+            config.count(static_cast<u32>(std::atoi(argv[++i])));
+        else if (std::strcmp(argv[i], "--load") == 0 && i + 1 < argc)
+            config.bus(config.bitrate, static_cast<f32>(std::atof(argv[++i])));
+        else if (std::strcmp(argv[i], "--seconds") == 0 && i + 1 < argc)
+            seconds = static_cast<u64>(std::atoll(argv[++i]));
+        else if (std::strcmp(argv[i], "--storm") == 0 && i + 1 < argc)
+            config.claim_storms(static_cast<u32>(std::atoi(argv[++i])));
+        else if (std::strcmp(argv[i], "--out") == 0 && i + 1 < argc)
+            out_path = argv[++i];
+    }
+
+    IsoNet dut(NetworkConfig{}.fast_packet(true).foreign_transport_filter());
+    InternalCF *target =
+        dut.create_internal(Name::build().set_identity_number(1).set_self_configurable(true), 0, 0x80).value();
+    dut.start_address_claiming();
+    LoadGenerator generator(dut, target, config);
+    LoadReport report = generator.run(seconds * 1000);
+
+    std::fprintf(stderr, "%u ECUs, %.0f%% background, %llu s simulated: bus %.1f%%, %llu frames\n", config.ecus,
+                 static_cast<double>(config.background_percent), static_cast<unsigned long long>(report.sim_ms / 1000),
+                 report.bus_load_percent, static_cast<unsigned long long>(report.bus_frames));
+    std::fprintf(stderr, "%-12s %10s %10s %8s\n", "kind", "sent", "received", "drop%");
+    bool ok = true;
+    for (usize k = 0; k < LOAD_KINDS; ++k) {
+        const LoadKindStats &s = report.kinds[k];
+        std::fprintf(stderr, "%-12s %10llu %10llu %8.2f\n", kind_name(k), static_cast<unsigned long long>(s.sent),
+                     static_cast<unsigned long long>(s.received), s.drop_rate() * 100.0);
+        ok = ok && s.drop_rate() <= 0.01;
+    }
+    std::fprintf(stderr, "latency p50 %.2f ms, p99 %.2f ms, max %.2f ms\n", report.latency.p50_ns / 1e6,
+                 report.latency.p99_ns / 1e6, report.latency.max_ns / 1e6);
+    std::fprintf(stderr, "ring drops %llu, claims %llu, cpu %.0f ns/frame\n",
+                 static_cast<unsigned long long>(report.ring_drops),
+                 static_cast<unsigned long long>(report.claims_received), report.cpu_ns_per_frame);
+
+    FILE *out = out_path ? std::fopen(out_path, "w") : stdout;
+    if (!out) {
+        std::fprintf(stderr, "cannot write %s\n", out_path);
+        return 1;
+    }
+    std::fprintf(out,
+                 "{\n  \"suite\": \"load_gen\",\n  \"ecus\": %u,\n  \"background_percent\": %.1f,\n"
+                 "  \"sim_ms\": %llu,\n  \"bus_load_percent\": %.2f,\n  \"bus_frames\": %llu,\n"
+                 "  \"frames_received\": %llu,\n  \"ring_drops\": %llu,\n  \"claims_received\": %llu,\n"
+                 "  \"drop_rate\": %.6f,\n  \"latency_ns\": {\"p50\": %llu, \"p99\": %llu, \"max\": %llu},\n"
+                 "  \"cpu_ns_per_frame\": %.1f,\n  \"kinds\": [\n",
+                 config.ecus, static_cast<double>(config.background_percent),
+                 static_cast<unsigned long long>(report.sim_ms), report.bus_load_percent,
+                 static_cast<unsigned long long>(report.bus_frames),
+                 static_cast<unsigned long long>(report.frames_received),
+                 static_cast<unsigned long long>(report.ring_drops),
+                 static_cast<unsigned long long>(report.claims_received), report.drop_rate(),
+                 static_cast<unsigned long long>(report.latency.p50_ns),
+                 static_cast<unsigned long long>(report.latency.p99_ns),
+                 static_cast<unsigned long long>(report.latency.max_ns), report.cpu_ns_per_frame);
+    for (usize k = 0; k < LOAD_KINDS; ++k) {
+        const LoadKindStats &s = report.kinds[k];
+        std::fprintf(out, "    {\"name\": \"%s\", \"sent\": %llu, \"received\": %llu, \"drop_rate\": %.6f}%s\n",
+                     kind_name(k), static_cast<unsigned long long>(s.sent),
+                     static_cast<unsigned long long>(s.received), s.drop_rate(), k + 1 < LOAD_KINDS ? "," : "");
+    }
+    std::fprintf(out, "  ]\n}\n");
+    if (out != stdout)
+        std::fclose(out);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,103 @@
+#include "bench.hpp"
+#include <agrobus/net/network_manager.hpp>
+
+using namespace bench;
+
+namespace {
+
+    Frame broadcast(PGN pgn, Address src, u8 seed) {
+        u8 payload[8];
+        for (u8 i = 0; i < 8; ++i)
+            payload[i] = static_cast<u8>(seed + i);
+        return Frame::from_message(Priority::Default, pgn, src, BROADCAST_ADDRESS, payload, 8);
+    }
+
+    // Frames/s from the endpoint through decode, filtering and dispatch
+    void receive_path(Suite &suite) {
+        for (u32 callbacks : {0u, 1u, 8u}) {
+            IsoNet nm;
+            FrameFeed feed;
+            for (u8 i = 0; i < 16; ++i)
+                feed.add(broadcast(0xFEF0 + (i & 3), 0x20 + i, i));
+            feed.attach(nm);
+            u64 hits = 0;
+            for (u32 c = 0; c < callbacks; ++c) {
+                for (PGN pgn = 0xFEF0; pgn < 0xFEF4; ++pgn)
+                    nm.register_pgn_callback(pgn, [&hits](const Message &msg) { hits += msg.data.size(); });
+            }
+            suite.run("isonet_receive", param("callbacks", callbacks), 1000000, 0, [&](u64 ops) {
+                feed.load(ops);
+                nm.update(0);
+            });
+            suite.check(callbacks == 0 || hits > 0, "isonet_receive reaches the callbacks");
+        }
+    }
+
+    // The receive path with the traffic profiler on, against isonet_receive
+    void receive_profiled(Suite &suite) {
+        IsoNet nm(NetworkConfig{}.profile(1024));
+        FrameFeed feed;
+        for (u8 i = 0; i < 16; ++i)
+            feed.add(broadcast(0xFEF0 + (i & 3), 0x20 + i, i));
+        feed.attach(nm);
+        suite.run("isonet_receive", "callbacks=0 profile", 1000000, 0, [&](u64 ops) {
+            feed.load(ops);
+            nm.update(0);
+        });
+        suite.check(nm.traffic_profile()->streams() == 16, "isonet_receive profiles every stream");
+    }
+
+    // Cost of one single-frame dispatch by the number of callbacks on its PGN
+    void dispatch(Suite &suite) {
+        for (u32 callbacks : {1u, 4u, 16u, 64u}) {
+            IsoNet nm;
+            u64 hits = 0;
+            for (u32 c = 0; c < callbacks; ++c)
+                nm.register_pgn_callback(0xFEF1, [&hits](const Message &msg) { hits += msg.data[0]; });
+            Message msg(0xFEF1, Payload{1, 2, 3, 4, 5, 6, 7, 8}, 0x28);
+            suite.run("dispatch_message", param("callbacks", callbacks), 1000000, 0, [&](u64 ops) {
+                for (u64 i = 0; i < ops; ++i)
+                    nm.inject_message(msg);
+            });
+            suite.check(hits > 0, "dispatch_message reaches the callbacks");
+        }
+    }
+
+    // A bus full of claimants: claims from many NAMEs, some contending for
+    // the address our own CF holds
+    void claim_storm(Suite &suite) {
+        for (u32 claimants : {32u, 200u}) {
+            IsoNet nm;
+            FrameFeed feed;
+            feed.attach(nm);
+            Name own = Name::build().set_identity_number(1).set_self_configurable(true);
+            auto *cf = nm.create_internal(own, 0, 0x80).value();
+            nm.start_address_claiming();
+            nm.update(300);
+
+            for (u32 i = 0; i < claimants; ++i) {
+                Name name = Name::build().set_identity_number(1000 + i).set_function_code(static_cast<u8>(i));
+                auto bytes = name.to_bytes();
+                Address sa = static_cast<Address>(i % 16 == 0 ? 0x80 : 0x10 + i % 0xD0);
+                feed.add(Frame::from_message(Priority::Default, PGN_ADDRESS_CLAIMED, sa, BROADCAST_ADDRESS,
+                                             bytes.data(), 8));
+            }
+            suite.run("address_claim_storm", param("claimants", claimants), 200000, 0, [&](u64 ops) {
+                feed.load(ops);
+                nm.update(0);
+            });
+            keep(cf);
+            keep(feed.sent());
+        }
+    }
+
+} // namespace
+
+int main(int argc, char **argv) {
+    Suite suite("net", argc, argv);
+    receive_path(suite);
+    receive_profiled(suite);
+    dispatch(suite);
+    claim_storm(suite);
+    return suite.finish();
+}
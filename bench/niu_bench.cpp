@@ -0,0 +1,64 @@
+#include "bench.hpp"
+#include <agrobus/net/niu.hpp>
+
+using namespace bench;
+
+namespace {
+
+    // Frames/s through the filter table and onto the other network: handed to
+    // the NIU directly, or end to end from the tractor endpoint in cut-through
+    void forwarding(Suite &suite) {
+        for (u32 rules : {0u, 16u, 256u}) {
+            for (bool cut_through : {false, true}) {
+                IsoNet tractor;
+                IsoNet implement;
+                FrameFeed tractor_bus;
+                FrameFeed implement_bus;
+                tractor_bus.attach(tractor);
+                implement_bus.attach(implement);
+
+                NIU niu(NIUConfig{}.events(false).cut_through_mode(cut_through));
+                for (u32 r = 0; r < rules; ++r) {
+                    if (r % 2)
+                        niu.block_pgn(0xFF00 + r);
+                    else
+                        niu.allow_pgn(0xFE00 + r);
+                }
+                niu.attach_tractor(&tractor);
+                niu.attach_implement(&implement);
+                niu.start();
+
+                dp::Vector<Frame> frames;
+                for (u8 i = 0; i < 16; ++i) {
+                    u8 payload[8] = {i, 0, 0, 0, 0, 0, 0, 0};
+                    frames.push_back(
+                        Frame::from_message(Priority::Default, 0xFE00 + i * 2, 0x20 + i, BROADCAST_ADDRESS, payload));
+                    tractor_bus.add(frames.back());
+                }
+                dp::String params = param("rules", rules);
+                if (cut_through) {
+                    // From the tractor endpoint through the RX tap
+                    params += " rx_tap";
+                    suite.run("niu_forward", std::move(params), 500000, 0, [&](u64 ops) {
+                        tractor_bus.load(ops);
+                        tractor.update(0);
+                    });
+                } else {
+                    params += " direct";
+                    suite.run("niu_forward", std::move(params), 500000, 0, [&](u64 ops) {
+                        for (u64 i = 0; i < ops; ++i)
+                            niu.process_tractor_frame(frames[i & 15]);
+                    });
+                }
+                suite.check(implement_bus.sent() > 0, "niu_forward reaches the implement bus");
+            }
+        }
+    }
+
+} // namespace
+
+int main(int argc, char **argv) {
+    Suite suite("niu", argc, argv);
+    forwarding(suite);
+    return suite.finish();
+}
@@ -0,0 +1,226 @@
+// NMEA: SerialGNSS sentence parsing (GGA/RMC/VTG/GSA at 1 to 50 Hz),
+// NMEAInterface decode for each N2K PGN it listens to, fast-packet
+// reassembly with many senders interleaved, and GNSSBatch frame conversions
+// on million-point batches. Heap allocations are counted per message.
+
+#define BENCH_COUNT_ALLOCATIONS
+#include "bench.hpp"
+#include <agrobus/net/fast_packet.hpp>
+#include <agrobus/net/network_manager.hpp>
+#include <agrobus/nmea/interface.hpp>
+#include <agrobus/nmea/serial_gnss.hpp>
+#include <cstdio>
+
+using namespace bench;
+using namespace agrobus::nmea;
+
+namespace {
+
+    // ─── NMEA-0183 ───────────────────────────────────────────────────────────────
+    void append_sentence(dp::String &out, const char *body) {
+        char line[128];
+        std::snprintf(line, sizeof(line), "$%s*%02X\r\n", body, nmea_checksum(body));
+        out += line;
+    }
+
+    // One second of receiver output at `hz`: GGA, RMC and VTG every epoch,
+    // GSA for GPS and GLONASS once a second
+    dp::String receiver_second(u32 hz, u32 &sentences) {
+        dp::String out;
+        char body[112];
+        for (u32 epoch = 0; epoch < hz; ++epoch) {
+            u32 cs = epoch * 100 / hz;
+            f64 lon = 11.516674 + epoch * 1e-6;
+            std::snprintf(body, sizeof(body),
+                          "GNGGA,123519.%02u,4807.038123,N,%011.6f,E,4,12,0.8,545.4,M,46.9,M,1.0,0000", cs,
+                          lon * 100.0);
+            append_sentence(out, body);
+            std::snprintf(body, sizeof(body), "GNRMC,123519.%02u,A,4807.038123,N,%011.6f,E,5.8,84.4,230394,3.1,W,R", cs,
+                          lon * 100.0);
+            append_sentence(out, body);
+            append_sentence(out, "GNVTG,84.4,T,87.5,M,5.8,N,10.7,K,R");
+        }
+        append_sentence(out, "GNGSA,A,3,04,05,09,12,24,25,29,31,,,,,1.6,0.8,1.4,1");
+        append_sentence(out, "GNGSA,A,3,65,66,72,73,81,,,,,,,,1.6,0.8,1.4,2");
+        sentences = hz * 3 + 2;
+        return out;
+    }
+
+    // Receive-only stand-in for the UART; the bench feeds SerialGNSS directly
+    class NullLink : public wirebit::Link {
+      public:
+        wirebit::Result<wirebit::Unit, wirebit::Error> send(const wirebit::Frame &) override {
+            return wirebit::Result<wirebit::Unit, wirebit::Error>::ok(wirebit::Unit{});
+        }
+        wirebit::Result<wirebit::Frame, wirebit::Error> recv() override {
+            return wirebit::Result<wirebit::Frame, wirebit::Error>::err(wirebit::Error::timeout("empty"));
+        }
+        bool can_send() const override { return true; }
+        bool can_recv() const override { return false; }
+        wirebit::String name() const override { return "bench_null"; }
+    };
+
+    // Sentences as a tty read hands them over: 32 bytes at a time
+    void serial_parse(Suite &suite) {
+        constexpr usize READ = 32;
+        wirebit::SerialEndpoint serial(std::make_shared<NullLink>(), {.baud = 115200}, 1);
+        for (u32 hz : {1u, 10u, 20u, 50u}) {
+            SerialGNSS gnss(serial);
+            u64 positions = 0;
+            gnss.on_position.subscribe([&positions](const GNSSPosition &) { ++positions; });
+            u32 per_second = 0;
+            dp::String stream = receiver_second(hz, per_second);
+            const u8 *bytes = reinterpret_cast<const u8 *>(stream.data());
+            u64 sentence_bytes = (stream.size() + per_second / 2) / per_second;
+            suite.run("serial_gnss_parse", param("hz", hz), static_cast<u64>(per_second) * 1000, sentence_bytes,
+                      [&](u64 ops) {
+                          for (u64 s = 0; s < ops / per_second; ++s) {
+                              for (usize at = 0; at < stream.size(); at += READ)
+                                  gnss.feed(bytes + at, stream.size() - at < READ ? stream.size() - at : READ);
+                          }
+                      });
+            suite.check(positions > 0 && gnss.latest_position().has_value(), "serial_gnss_parse yields positions");
+        }
+    }
+
+    // ─── NMEA 2000 ───────────────────────────────────────────────────────────────
+    struct Handler {
+        const char *name;
+        PGN pgn;
+        u8 size;
+    };
+
+    constexpr Handler HANDLERS[] = {
+        {"position_rapid", PGN_GNSS_POSITION_RAPID, 8},
+        {"cog_sog", PGN_GNSS_COG_SOG_RAPID, 8},
+        {"attitude", PGN_ATTITUDE, 8},
+        {"rate_of_turn", PGN_RATE_OF_TURN, 8},
+        {"position_data", PGN_GNSS_POSITION_DATA, 43},
+        {"heading", PGN_HEADING_TRACK, 8},
+        {"gnss_dops", PGN_GNSS_DOPs, 8},
+        {"magnetic_variation", PGN_MAGNETIC_VARIATION, 8},
+        {"wind", N2KLayout<WindData>::pgn, 8},
+        {"temperature", N2KLayout<TemperatureData>::pgn, 8},
+        {"engine", N2KLayout<EngineData>::pgn, 8},
+        {"depth", N2KLayout<WaterDepthData>::pgn, 8},
+        {"system_time", N2KLayout<SystemTimeData>::pgn, 8},
+        {"humidity", N2KLayout<HumidityData>::pgn, 8},
+        {"pressure", N2KLayout<PressureData>::pgn, 8},
+        {"outside_environmental", N2KLayout<OutsideEnvironmentalData>::pgn, 8},
+        {"fluid_level", N2KLayout<FluidLevelData>::pgn, 8},
+        {"battery", N2KLayout<BatteryStatusData>::pgn, 8},
+        {"speed_water", N2KLayout<SpeedWaterData>::pgn, 8},
+        {"xte", N2KLayout<XTEData>::pgn, 8},
+        {"rudder", N2KLayout<RudderData>::pgn, 8},
+    };
+
+    // A reassembled message per PGN through dispatch and its handler
+    void interface_decode(Suite &suite) {
+        IsoNet nm(NetworkConfig{}.fast_packet(true));
+        auto *cf = nm.create_internal(Name::build().set_identity_number(1), 0, 0x80).value();
+        NMEAInterface nmea(nm, cf, NMEAConfig{}.all());
+        nmea.initialize();
+        for (const Handler &h : HANDLERS) {
+            dp::Vector<u8> data(h.size);
+            for (u8 i = 0; i < h.size; ++i)
+                data[i] = static_cast<u8>((i * 29 + 3) & 0x7F); // Clear of the "not available" patterns
+            Message msg(h.pgn, data, 0x1C);
+            suite.run("nmea_decode", h.name, 1000000, h.size, [&](u64 ops) {
+                for (u64 i = 0; i < ops; ++i) {
+                    msg.timestamp_us += 50000;
+                    nm.inject_message(msg);
+                }
+            });
+        }
+        suite.check(nmea.latest_position().has_value(), "nmea_decode updates the position");
+    }
+
+    // 129029 from `senders` sources, their frames interleaved on the bus
+    void fast_packet_interleaved(Suite &suite) {
+        for (u32 senders : {1u, 8u, 32u, 128u}) {
+            dp::Vector<Frame> frames;
+            dp::Vector<dp::Vector<Frame>> per_sender;
+            FastPacketProtocol tx;
+            dp::Vector<u8> payload(43, 0x5A);
+            for (u32 s = 0; s < senders; ++s)
+                per_sender.push_back(tx.send(PGN_GNSS_POSITION_DATA, payload, static_cast<Address>(s)).value());
+            for (usize f = 0; f < per_sender[0].size(); ++f) {
+                for (u32 s = 0; s < senders; ++s)
+                    frames.push_back(per_sender[s][f]);
+            }
+            // One slot per sender, as a receiver sized for the bus would have
+            FastPacketProtocol rx(senders > FastPacketProtocol::DEFAULT_RX_SLOTS ? senders
+                                                                                : FastPacketProtocol::DEFAULT_RX_SLOTS);
+            u64 completed = 0;
+            suite.run("fast_packet_interleaved", param("senders", senders), 200000, payload.size(), [&](u64 ops) {
+                for (u64 done = 0; done < ops; done += senders) {
+                    for (const auto &f : frames)
+                        completed += rx.process_frame_view(f).has_value() ? 1 : 0;
+                }
+            });
+            suite.check(completed > 0 && rx.rx_evictions() == 0, "fast_packet_interleaved completes every message");
+        }
+    }
+
+    // ─── Batch conversions ───────────────────────────────────────────────────────
+    // A logged pass: fixes 0.15 m apart heading north-east. The batch is built
+    // in the warm-up call, at the run's size.
+    void fill(GNSSBatch &batch, u64 points) {
+        batch.positions.clear();
+        batch.positions.reserve(points);
+        for (u64 i = 0; i < points; ++i) {
+            GNSSPosition p;
+            f64 step = static_cast<f64>(i % 100000);
+            p.wgs = concord::earth::WGS(48.0 + step * 1e-6, 11.0 + step * 1.5e-6, 400.0 + (i % 50) * 0.1);
+            p.fix_type = GNSSFixType::RTKFixed;
+            batch.positions.push_back(p);
+        }
+    }
+
+    void batch_conversions(Suite &suite) {
+        constexpr u64 POINTS = 1000000;
+        const dp::Geo ref{48.0, 11.0, 400.0};
+        GNSSBatch batch;
+        dp::Vector<f64> a, b, c;
+        auto prepare = [&](u64 ops) {
+            if (batch.positions.size() == ops)
+                return;
+            fill(batch, ops);
+            a.assign(ops, 0.0);
+            b.assign(ops, 0.0);
+            c.assign(ops, 0.0);
+        };
+
+        suite.run("gnss_to_enu_batch", "vector", POINTS, 0, [&](u64 ops) {
+            prepare(ops);
+            keep(batch.to_enu_batch(ref).size());
+        });
+        for (u32 threads : {1u, 0u}) {
+            suite.run("gnss_to_enu_batch", threads == 1 ? "kernel threads=1" : "kernel threads=all", POINTS, 0,
+                      [&](u64 ops) {
+                          prepare(ops);
+                          batch.to_enu_batch(ref, a.data(), b.data(), c.data(), threads);
+                          keep(a[ops / 2]);
+                      });
+        }
+        suite.run("gnss_to_ecf_batch", "vector", POINTS, 0, [&](u64 ops) {
+            prepare(ops);
+            keep(batch.to_ecf_batch().size());
+        });
+        suite.run("gnss_to_ecf_batch", "kernel", POINTS, 0, [&](u64 ops) {
+            prepare(ops);
+            batch.to_ecf_batch(a.data(), b.data(), c.data());
+            keep(a[ops / 2]);
+        });
+    }
+
+} // namespace
+
+int main(int argc, char **argv) {
+    Suite suite("nmea", argc, argv);
+    serial_parse(suite);
+    interface_decode(suite);
+    fast_packet_interleaved(suite);
+    batch_conversions(suite);
+    return suite.finish();
+}
@@ -0,0 +1,317 @@
+// Task controller: TC-GEO rate lookups on prescription maps of 1k to 100k
+// zones, DDOP serialize/deserialize/validate/to_isoxml on large sprayer and
+// planter pools, and the DDI database with its batch conversions. The yardstick is a 100-section boom
+// updated at 20 Hz: geo_section_rates is one such update, 50 ms of budget.
+
+#include "bench.hpp"
+#include <agrobus/isobus/tc/ddi_database.hpp>
+#include <agrobus/isobus/tc/ddi_kernels.hpp>
+#include <agrobus/isobus/tc/ddop.hpp>
+#include <agrobus/isobus/tc/geo.hpp>
+#include <agrobus/net/network_manager.hpp>
+#include <cmath>
+
+using namespace bench;
+using namespace agrobus::isobus::tc;
+
+namespace {
+
+    // ─── Prescription maps ───────────────────────────────────────────────────────
+    constexpr f64 FIELD_LAT = 48.0;
+    constexpr f64 FIELD_LON = 11.0;
+    constexpr f64 ZONE_M = 20.0;
+    constexpr f64 M_PER_DEG_LAT = 111320.0;
+
+    f64 m_per_deg_lon() { return M_PER_DEG_LAT * std::cos(FIELD_LAT * M_PI / 180.0); }
+
+    // Square zones of ZONE_M in a grid of about `zones` cells, rates varying
+    // from zone to zone as a soil-sampled map does
+    PrescriptionMap grid_map(u32 zones, u32 &side) {
+        side = static_cast<u32>(std::sqrt(static_cast<f64>(zones)));
+        f64 dlat = ZONE_M / M_PER_DEG_LAT;
+        f64 dlon = ZONE_M / m_per_deg_lon();
+        PrescriptionMap map;
+        map.structure_label = "bench";
+        map.zones.reserve(static_cast<usize>(side) * side);
+        for (u32 row = 0; row < side; ++row) {
+            for (u32 col = 0; col < side; ++col) {
+                f64 lat = FIELD_LAT + row * dlat;
+                f64 lon = FIELD_LON + col * dlon;
+                PrescriptionZone zone;
+                zone.boundary = {concord::earth::WGS(lat, lon, 0), concord::earth::WGS(lat + dlat, lon, 0),
+                                 concord::earth::WGS(lat + dlat, lon + dlon, 0),
+                                 concord::earth::WGS(lat, lon + dlon, 0)};
+                zone.application_rate = static_cast<i32>(1000 + (row * 37 + col * 11) % 400);
+                map.zones.push_back(std::move(zone));
+            }
+        }
+        return map;
+    }
+
+    // GNSS fixes at 20 Hz and 3 m/s along the first pass of a field of
+    // `side` zones, or scattered over the whole field
+    dp::Vector<concord::earth::WGS> drive(u32 side, bool scattered) {
+        f64 field_m = side * ZONE_M;
+        dp::Vector<concord::earth::WGS> fixes;
+        u64 seed = 0x9E3779B97F4A7C15ull;
+        for (u32 i = 0; i < 4096; ++i) {
+            f64 east, north;
+            if (scattered) {
+                seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+                east = static_cast<f64>(seed >> 40) / static_cast<f64>(1u << 24) * field_m;
+                north = static_cast<f64>((seed >> 16) & 0xFFFFFF) / static_cast<f64>(1u << 24) * field_m;
+            } else {
+                east = std::fmod(i * 0.15, field_m);
+                north = ZONE_M * 0.5;
+            }
+            fixes.push_back(concord::earth::WGS(FIELD_LAT + north / M_PER_DEG_LAT, FIELD_LON + east / m_per_deg_lon(),
+                                                0));
+        }
+        return fixes;
+    }
+
+    void geo_lookup(Suite &suite) {
+        IsoNet nm;
+        auto *cf = nm.create_internal(Name::build().set_identity_number(1), 0, 0x80).value();
+        for (u32 zones : {1000u, 10000u, 100000u}) {
+            TCGEOInterface geo(nm, cf);
+            u32 side = 0;
+            geo.add_prescription_map(grid_map(zones, side));
+            for (bool scattered : {false, true}) {
+                auto fixes = drive(side, scattered);
+                u64 hits = 0;
+                dp::String p = param("zones", static_cast<u64>(side) * side);
+                p += scattered ? " scattered" : " pass";
+                suite.run("geo_rate_lookup", p, 1000000, 0, [&](u64 ops) {
+                    for (u64 i = 0; i < ops; ++i)
+                        hits += geo.get_rate_at_position(fixes[i & 4095]).has_value() ? 1 : 0;
+                });
+                suite.check(hits > 0, "geo_rate_lookup finds the zones");
+            }
+        }
+    }
+
+    // One 20 Hz update of a 36 m, 100-section boom with look-ahead
+    void section_rates(Suite &suite) {
+        constexpr u32 SECTIONS = 100;
+        IsoNet nm;
+        auto *cf = nm.create_internal(Name::build().set_identity_number(1), 0, 0x80).value();
+        TCGEOInterface geo(nm, cf);
+        u32 side = 0;
+        geo.add_prescription_map(grid_map(100000, side));
+        dp::Vector<SectionOffset> offsets;
+        for (u32 i = 0; i < SECTIONS; ++i)
+            offsets.push_back(SectionOffset{-4.0, -18.0 + 0.36 * (i + 0.5)});
+        geo.set_sections(std::move(offsets));
+        geo.set_motion(M_PI / 2.0, 3.0); // Due east
+        auto fixes = drive(side, false);
+        bool rated = false;
+        suite.run("geo_section_rates", param("sections", SECTIONS), 100000, 0, [&](u64 ops) {
+            for (u64 i = 0; i < ops; ++i) {
+                geo.set_position(GeoPoint{fixes[i & 4095], i * 50000});
+                rated = geo.update_section_rates();
+            }
+        });
+        suite.check(rated && geo.section_rates()[SECTIONS / 2].has_value(), "geo_section_rates rates the sections");
+    }
+
+    // ─── DDOP ────────────────────────────────────────────────────────────────────
+    // The pool of examples/complex/section_control_simulator.cpp scaled up: a
+    // boom with condensed work states for all its sections and, per section,
+    // offsets, width and the process data a rate controller reports
+    DDOP implement_ddop(u16 sections, bool planter) {
+        DDOP ddop;
+        ddop.next_id(); // ID 0 asks add_*() for a fresh one
+        ObjectID vp_mm = ddop.next_id();
+        ddop.add_value_presentation(
+            DeviceValuePresentation{}.set_id(vp_mm).set_offset(0).set_scale(1.0f).set_decimals(0).set_unit("mm"));
+        ObjectID vp_rate = ddop.next_id();
+        ddop.add_value_presentation(DeviceValuePresentation{}
+                                        .set_id(vp_rate)
+                                        .set_offset(0)
+                                        .set_scale(planter ? 0.001f : 0.0001f)
+                                        .set_decimals(1)
+                                        .set_unit(planter ? "seeds/m2" : "L/ha"));
+        ddop.add_device(DeviceObject{}
+                            .set_id(ddop.next_id())
+                            .set_designator(planter ? "PlanterSim" : "SprayerSim")
+                            .set_software_version("1.0.0")
+                            .set_serial_number("SIM001")
+                            .set_structure_label({'B', 'E', 'N', 'C', 'H', '0', '1'})
+                            .set_localization_label({0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF}));
+
+        auto process_data = [&](DDI ddi, ObjectID vp, const char *name) {
+            ObjectID id = ddop.next_id();
+            ddop.add_process_data(DeviceProcessData{}
+                                      .set_id(id)
+                                      .set_ddi(ddi)
+                                      .add_trigger(TriggerMethod::OnChange)
+                                      .add_trigger(TriggerMethod::TimeInterval)
+                                      .set_presentation(vp)
+                                      .set_designator(name));
+            return id;
+        };
+        auto property = [&](DDI ddi, i32 value, const char *name) {
+            ObjectID id = ddop.next_id();
+            ddop.add_property(
+                DeviceProperty{}.set_id(id).set_ddi(ddi).set_value(value).set_presentation(vp_mm).set_designator(name));
+            return id;
+        };
+
+        ObjectID root_id = ddop.next_id();
+        ObjectID boom_id = ddop.next_id();
+        i32 width_mm = sections * (planter ? 760 : 360);
+        DeviceElement boom = DeviceElement{}
+                                 .set_id(boom_id)
+                                 .set_type(DeviceElementType::Function)
+                                 .set_number(1)
+                                 .set_designator("Boom")
+                                 .set_parent(root_id);
+        for (u16 block = 0; block * 16 < sections; ++block) {
+            boom.add_child(process_data(static_cast<DDI>(ddi::ACTUAL_CONDENSED_WORK_STATE_1_16 + block), 0xFFFF,
+                                        "ActualCWS"));
+            boom.add_child(process_data(static_cast<DDI>(ddi::SETPOINT_CONDENSED_WORK_STATE_1_16 + block), 0xFFFF,
+                                        "SetpointCWS"));
+        }
+        boom.add_child(property(ddi::WORKING_WIDTH, width_mm, "BoomWidth"));
+
+        for (u16 i = 0; i < sections; ++i) {
+            ObjectID section_id = ddop.next_id();
+            DeviceElement section = DeviceElement{}
+                                        .set_id(section_id)
+                                        .set_type(DeviceElementType::Section)
+                                        .set_number(static_cast<ElementNumber>(2 + i))
+                                        .set_designator("Sect" + dp::String(dp::to_string(i + 1).c_str()))
+                                        .set_parent(boom_id);
+            i32 pitch = width_mm / sections;
+            section.add_child(property(ddi::DEVICE_ELEMENT_OFFSET_X, 0, "SectX"));
+            section.add_child(property(ddi::DEVICE_ELEMENT_OFFSET_Y, -width_mm / 2 + pitch * i + pitch / 2, "SectY"));
+            section.add_child(property(ddi::WORKING_WIDTH, pitch, "SectW"));
+            if (planter) {
+                section.add_child(process_data(ddi::SETPOINT_COUNT_PER_AREA_APPLICATION_RATE, vp_rate, "SetRate"));
+                section.add_child(process_data(ddi::ACTUAL_COUNT_PER_AREA_APPLICATION_RATE, vp_rate, "Rate"));
+                section.add_child(process_data(ddi::ACTUAL_SEED_SINGULATION_PERCENTAGE, 0xFFFF, "Singulation"));
+                section.add_child(process_data(ddi::ACTUAL_SEED_SKIP_PERCENTAGE, 0xFFFF, "Skips"));
+                section.add_child(process_data(ddi::ACTUAL_DOWNFORCE_AS_FORCE, 0xFFFF, "Downforce"));
+            } else {
+                section.add_child(process_data(ddi::SETPOINT_VOLUME_PER_AREA_APPLICATION_RATE, vp_rate, "SetRate"));
+                section.add_child(process_data(ddi::ACTUAL_VOLUME_PER_AREA_APPLICATION_RATE, vp_rate, "Rate"));
+            }
+            ddop.add_element(section);
+            boom.add_child(section_id);
+        }
+        ddop.add_element(DeviceElement{}
+                             .set_id(root_id)
+                             .set_type(DeviceElementType::Device)
+                             .set_number(0)
+                             .set_designator("Root")
+                             .add_child(boom_id));
+        ddop.add_element(boom);
+        return ddop;
+    }
+
+    // Whole pools per run: at least ten, so --quick still does one
+    u64 ops_for(usize objects) { return objects * (200000 / objects > 10 ? 200000 / objects : 10); }
+
+    u64 per_object(usize bytes, usize objects) { return objects > 0 ? (bytes + objects / 2) / objects : 0; }
+
+    void ddop_ops(Suite &suite, const char *kind, u16 sections, bool planter) {
+        DDOP ddop = implement_ddop(sections, planter);
+        usize n = ddop.object_count();
+        dp::String p = dp::String(kind) + " " + param("sections", sections).c_str();
+        dp::Vector<u8> bytes = ddop.serialize().value();
+
+        suite.run("ddop_serialize", p, ops_for(n), per_object(bytes.size(), n), [&](u64 ops) {
+            for (u64 done = 0; done < ops; done += n) {
+                auto out = ddop.serialize_into(bytes.data(), bytes.size());
+                keep(out);
+            }
+        });
+
+        bool round_trip = false;
+        suite.run("ddop_deserialize", p, ops_for(n), per_object(bytes.size(), n), [&](u64 ops) {
+            for (u64 done = 0; done < ops; done += n) {
+                auto parsed = DDOP::deserialize(DataSpan(bytes.data(), bytes.size()));
+                round_trip = parsed.is_ok() && parsed.value().object_count() == n;
+            }
+        });
+        suite.check(round_trip, "ddop_deserialize gets every object back");
+
+        bool valid = false;
+        suite.run("ddop_validate", p, ops_for(n), 0, [&](u64 ops) {
+            for (u64 done = 0; done < ops; done += n)
+                valid = ddop.validate().is_ok();
+        });
+        suite.check(valid, "ddop_validate accepts the pool");
+
+        usize xml_bytes = ddop.to_isoxml().size();
+        suite.run("ddop_to_isoxml", p, ops_for(n), per_object(xml_bytes, n), [&](u64 ops) {
+            for (u64 done = 0; done < ops; done += n) {
+                dp::String xml = ddop.to_isoxml();
+                keep(xml.size());
+            }
+        });
+    }
+
+    // ─── DDI database ────────────────────────────────────────────────────────────
+    // The DDIs of a busy process-data stream, with a few unknown ones
+    void ddi_database(Suite &suite) {
+        DDOP ddop = implement_ddop(100, true);
+        dp::Vector<u16> ddis;
+        for (const auto &pd : ddop.process_data())
+            ddis.push_back(pd.ddi);
+        for (u16 unknown : {u16(9999), u16(0xDFFF), u16(60000)})
+            ddis.push_back(unknown);
+        usize n = ddis.size();
+
+        u64 found = 0;
+        suite.run("ddi_lookup", param("ddis", n), 10000000, 0, [&](u64 ops) {
+            for (u64 i = 0; i < ops; ++i)
+                found += ddi_lookup(ddis[i % n]) ? 1 : 0;
+        });
+        suite.check(found > 0, "ddi_lookup finds the DDIs");
+
+        f64 sum = 0.0;
+        suite.run("ddi_to_engineering", param("ddis", n), 10000000, 0, [&](u64 ops) {
+            for (u64 i = 0; i < ops; ++i)
+                sum += ddi_to_engineering(ddis[i % n], static_cast<i32>(i));
+        });
+        keep(sum);
+
+        // A million logged (DDI, raw) samples, SoA, converted in one call
+        constexpr u64 SAMPLES = 1000000;
+        dp::Vector<u16> sample_ddis(SAMPLES);
+        dp::Vector<i32> raw(SAMPLES);
+        dp::Vector<f64> eng(SAMPLES);
+        dp::Vector<i32> back(SAMPLES);
+        for (u64 i = 0; i < SAMPLES; ++i) {
+            sample_ddis[i] = ddis[i % n];
+            raw[i] = static_cast<i32>(i * 37);
+        }
+        suite.run("ddi_to_engineering_batch", param("samples", SAMPLES), SAMPLES, 0, [&](u64 ops) {
+            for (u64 done = 0; done < ops; done += SAMPLES)
+                ddi_to_engineering(sample_ddis.data(), raw.data(), ops - done < SAMPLES ? ops - done : SAMPLES, eng.data());
+            keep(eng[SAMPLES / 2]);
+        });
+        suite.run("ddi_from_engineering_batch", param("samples", SAMPLES), SAMPLES, 0, [&](u64 ops) {
+            for (u64 done = 0; done < ops; done += SAMPLES)
+                ddi_from_engineering(sample_ddis.data(), eng.data(), ops - done < SAMPLES ? ops - done : SAMPLES, back.data());
+            keep(back[SAMPLES / 2]);
+        });
+        bool same = true;
+        for (u64 i = 0; i < SAMPLES; i += 997)
+            same = same && back[i] == ddi_from_engineering(sample_ddis[i], eng[i]);
+        suite.check(same, "batch DDI conversion matches the scalar one");
+    }
+
+} // namespace
+
+int main(int argc, char **argv) {
+    Suite suite("tc", argc, argv);
+    geo_lookup(suite);
+    section_rates(suite);
+    ddop_ops(suite, "sprayer", 100, false);
+    ddop_ops(suite, "planter", 48, true);
+    ddi_database(suite);
+    return suite.finish();
+}
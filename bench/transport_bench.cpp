@@ -0,0 +1,161 @@
+#include "bench.hpp"
+#include <agrobus/net/etp.hpp>
+#include <agrobus/net/fast_packet.hpp>
+#include <agrobus/net/loopback_bus.hpp>
+#include <agrobus/net/tp.hpp>
+
+using namespace bench;
+
+namespace {
+
+    // BAM announce and DT frames for one broadcast transfer from 0x28
+    dp::Vector<Frame> bam_frames(u16 size) {
+        dp::Vector<Frame> frames;
+        u8 packets = static_cast<u8>((size + 6) / 7);
+        Frame cm;
+        cm.id = Identifier::encode(Priority::Lowest, PGN_TP_CM, 0x28, BROADCAST_ADDRESS);
+        cm.data = {tp_cm::BAM, static_cast<u8>(size & 0xFF), static_cast<u8>(size >> 8), packets, 0xFF, 0xCA, 0xFE,
+                   0x00};
+        frames.push_back(cm);
+        for (u32 seq = 1; seq <= packets; ++seq) {
+            Frame dt;
+            dt.id = Identifier::encode(Priority::Lowest, PGN_TP_DT, 0x28, BROADCAST_ADDRESS);
+            dt.data[0] = static_cast<u8>(seq);
+            for (u8 j = 0; j < 7; ++j)
+                dt.data[j + 1] = static_cast<u8>(seq * 7 + j);
+            frames.push_back(dt);
+        }
+        return frames;
+    }
+
+    // RTS, then one DPO and up to 255 DTs per window, from 0x28 to 0x30
+    dp::Vector<Frame> etp_frames(u32 size) {
+        dp::Vector<Frame> frames;
+        Frame rts;
+        rts.id = Identifier::encode(Priority::Lowest, PGN_ETP_CM, 0x28, 0x30);
+        rts.data = {etp_cm::RTS,
+                    static_cast<u8>(size & 0xFF),
+                    static_cast<u8>((size >> 8) & 0xFF),
+                    static_cast<u8>((size >> 16) & 0xFF),
+                    static_cast<u8>(size >> 24),
+                    0xCA,
+                    0xFE,
+                    0x00};
+        frames.push_back(rts);
+        u32 total_packets = (size + 6) / 7;
+        for (u32 offset = 0; offset < total_packets; offset += 255) {
+            u8 count = static_cast<u8>(total_packets - offset < 255 ? total_packets - offset : 255);
+            Frame dpo;
+            dpo.id = Identifier::encode(Priority::Lowest, PGN_ETP_CM, 0x28, 0x30);
+            dpo.data = {etp_cm::DPO,
+                        count,
+                        static_cast<u8>(offset & 0xFF),
+                        static_cast<u8>((offset >> 8) & 0xFF),
+                        static_cast<u8>((offset >> 16) & 0xFF),
+                        0xCA,
+                        0xFE,
+                        0x00};
+            frames.push_back(dpo);
+            for (u32 seq = 1; seq <= count; ++seq) {
+                Frame dt;
+                dt.id = Identifier::encode(Priority::Lowest, PGN_ETP_DT, 0x28, 0x30);
+                dt.data[0] = static_cast<u8>(seq);
+                for (u8 j = 0; j < 7; ++j)
+                    dt.data[j + 1] = static_cast<u8>(offset + seq + j);
+                frames.push_back(dt);
+            }
+        }
+        return frames;
+    }
+
+    void tp_reassembly(Suite &suite) {
+        for (u16 size : {u16(100), u16(1785)}) {
+            TransportProtocol tp;
+            u64 completed = 0;
+            tp.on_complete.subscribe([&](TransportSession &) { ++completed; });
+            auto frames = bam_frames(size);
+            suite.run("tp_bam_reassembly", param("bytes", size), 20000, size, [&](u64 ops) {
+                for (u64 i = 0; i < ops; ++i) {
+                    for (const auto &f : frames)
+                        keep(tp.process_frame(f));
+                }
+            });
+            suite.check(completed > 0, "tp_bam_reassembly completes");
+        }
+    }
+
+    void etp_reassembly(Suite &suite) {
+        for (u32 size : {10000u, 1000000u}) {
+            ExtendedTransportProtocol etp;
+            u64 completed = 0;
+            etp.on_complete.subscribe([&](TransportSession &) { ++completed; });
+            auto frames = etp_frames(size);
+            suite.run("etp_reassembly", param("bytes", size), size >= 1000000 ? 20 : 2000, size, [&](u64 ops) {
+                for (u64 i = 0; i < ops; ++i) {
+                    for (const auto &f : frames)
+                        keep(etp.process_frame(f));
+                }
+            });
+            suite.check(completed > 0, "etp_reassembly completes");
+        }
+    }
+
+    void fast_packet_reassembly(Suite &suite) {
+        for (u16 size : {u16(20), u16(FAST_PACKET_MAX_DATA)}) {
+            FastPacketProtocol tx;
+            dp::Vector<u8> payload(size, 0x5A);
+            auto frames = tx.send(PGN_GNSS_POSITION, payload, 0x28).value();
+            FastPacketProtocol rx;
+            u64 completed = 0;
+            suite.run("fast_packet_reassembly", param("bytes", size), 200000, size, [&](u64 ops) {
+                for (u64 i = 0; i < ops; ++i) {
+                    for (const auto &f : frames) {
+                        if (rx.process_frame(f))
+                            ++completed;
+                    }
+                }
+            });
+            suite.check(completed > 0, "fast_packet_reassembly completes");
+        }
+    }
+
+    // A whole RTS/CTS session between two stacks on an ideal loopback bus:
+    // pure stack cost end to end, handshakes included
+    void tp_end_to_end(Suite &suite) {
+        for (u16 size : {u16(100), u16(1785)}) {
+            LoopbackBus bus;
+            IsoNet sender;
+            IsoNet receiver;
+            bus.attach(sender);
+            bus.attach(receiver);
+            auto *cf = sender.create_internal(Name::build().set_identity_number(1), 0, 0x28).value();
+            receiver.create_internal(Name::build().set_identity_number(2), 0, 0x30).value();
+            u64 completed = 0;
+            receiver.register_pgn_callback(0xCA00, [&](const Message &) { ++completed; });
+            ControlFunction dest;
+            dest.address = 0x30;
+            dp::Vector<u8> payload(size, 0x5A);
+            suite.run("tp_rts_cts_loopback", param("bytes", size), 2000, size, [&](u64 ops) {
+                for (u64 i = 0; i < ops; ++i) {
+                    u64 target = completed + 1;
+                    sender.send(0xCA00, payload, cf, &dest);
+                    for (u32 round = 0; round < 1000 && completed < target; ++round) {
+                        sender.update(1);
+                        receiver.update(1);
+                    }
+                }
+            });
+            suite.check(completed > 0, "tp_rts_cts_loopback completes");
+        }
+    }
+
+} // namespace
+
+int main(int argc, char **argv) {
+    Suite suite("transport", argc, argv);
+    tp_reassembly(suite);
+    etp_reassembly(suite);
+    fast_packet_reassembly(suite);
+    tp_end_to_end(suite);
+    return suite.finish();
+}
@@ -0,0 +1,287 @@
+// VT object pools: ObjectPool operations, IOP parsing and VTServer pool
+// ingestion on synthetic pools of 100 to 20000 objects. One operation is one
+// object, so op/s reads as objects/s and MB/s comes from the mean object size.
+// Customer pools can be added with --iop FILE (repeatable).
+
+#define BENCH_COUNT_ALLOCATIONS
+#include "bench.hpp"
+#include <agrobus/isobus/vt/server.hpp>
+#include <agrobus/net/iop_parser.hpp>
+
+using namespace bench;
+using namespace agrobus::isobus::vt;
+
+namespace {
+
+    // Type mix of a production implement pool: mostly output fields, their
+    // variables and the attribute objects they share
+    constexpr ObjectType MIX[20] = {
+        ObjectType::OutputString,   ObjectType::OutputString,   ObjectType::OutputString,
+        ObjectType::OutputString,   ObjectType::OutputNumber,   ObjectType::OutputNumber,
+        ObjectType::OutputNumber,   ObjectType::NumberVariable, ObjectType::NumberVariable,
+        ObjectType::StringVariable, ObjectType::Container,      ObjectType::Button,
+        ObjectType::Button,         ObjectType::InputNumber,    ObjectType::Rectangle,
+        ObjectType::FontAttributes, ObjectType::FontAttributes, ObjectType::FillAttributes,
+        ObjectType::LineAttributes, ObjectType::Macro,
+    };
+    constexpr u16 OBJECTS_PER_MASK = 50;
+
+    // IOP form of one object after its id and type: width, height and the
+    // type's fixed fields (IOPParser::get_object_data_length)
+    dp::Vector<u8> iop_body(ObjectType type, u16 id) {
+        dp::Vector<u8> body = {0xC8, 0x00, 0x3C, 0x00};
+        auto fill = [&](usize n) {
+            for (usize i = 0; i < n; ++i)
+                body.push_back(static_cast<u8>(id + i));
+        };
+        auto text = [&](u16 len) {
+            body.push_back(static_cast<u8>(len));
+            body.push_back(static_cast<u8>(len >> 8));
+            for (u16 i = 0; i < len; ++i)
+                body.push_back(static_cast<u8>('A' + (id + i) % 26));
+        };
+        switch (type) {
+        case ObjectType::WorkingSet:
+            fill(4);
+            break;
+        case ObjectType::DataMask:
+            fill(3);
+            break;
+        case ObjectType::Button:
+            fill(6);
+            break;
+        case ObjectType::InputNumber:
+            fill(16);
+            break;
+        case ObjectType::OutputString:
+            text(static_cast<u16>(8 + id % 24));
+            fill(4);
+            break;
+        case ObjectType::OutputNumber:
+            fill(12);
+            break;
+        case ObjectType::NumberVariable:
+            fill(4);
+            break;
+        case ObjectType::StringVariable:
+            text(static_cast<u16>(16 + id % 16));
+            break;
+        case ObjectType::FontAttributes:
+        case ObjectType::LineAttributes:
+            fill(3);
+            break;
+        case ObjectType::FillAttributes:
+            fill(5);
+            break;
+        case ObjectType::Macro:
+            body.push_back(8);
+            fill(8);
+            break;
+        default:
+            break;
+        }
+        return body;
+    }
+
+    ObjectType type_of(u16 id, u16 masks) {
+        if (id == 0)
+            return ObjectType::WorkingSet;
+        if (id <= masks)
+            return ObjectType::DataMask;
+        return MIX[id % 20];
+    }
+
+    // A pool of `objects`: the Working Set, one Data Mask per 50 objects and
+    // the rest split between the masks as their children
+    struct Synthetic {
+        dp::Vector<VTObject> objects;
+        dp::Vector<u8> vt_bytes;  // ObjectPool::serialize() form
+        dp::Vector<u8> iop_bytes; // IOP file form
+    };
+
+    ObjectPool build(const Synthetic &s) {
+        ObjectPool pool;
+        for (const auto &obj : s.objects)
+            pool.add(obj);
+        return pool;
+    }
+
+    Synthetic synthesize(u16 objects) {
+        Synthetic s;
+        u16 masks = static_cast<u16>(objects / OBJECTS_PER_MASK > 0 ? objects / OBJECTS_PER_MASK : 1);
+        u16 first_leaf = static_cast<u16>(masks + 1);
+        for (u16 id = 0; id < objects; ++id) {
+            ObjectType type = type_of(id, masks);
+            VTObject obj = VTObject().set_id(id).set_type(type).set_body(iop_body(type, id));
+            s.iop_bytes.push_back(static_cast<u8>(id));
+            s.iop_bytes.push_back(static_cast<u8>(id >> 8));
+            s.iop_bytes.push_back(static_cast<u8>(type));
+            s.iop_bytes.insert(s.iop_bytes.end(), obj.body.begin(), obj.body.end());
+            if (type == ObjectType::WorkingSet) {
+                for (u16 m = 1; m <= masks; ++m)
+                    obj.add_child(m);
+            } else if (type == ObjectType::DataMask) {
+                for (u16 leaf = first_leaf + (id - 1); leaf < objects; leaf += masks)
+                    obj.add_child(leaf);
+            } else if (type == ObjectType::Macro) {
+                // The pool form is the command list the server compiles: one Change Numeric Value
+                obj.set_body({8, 0, vt_cmd::CHANGE_NUMERIC_VALUE, static_cast<u8>(id - 12),
+                              static_cast<u8>((id - 12) >> 8), 0xFF, 1, 0, 0, 0});
+            }
+            s.objects.push_back(std::move(obj));
+        }
+        s.vt_bytes = build(s).serialize().value();
+        return s;
+    }
+
+    // Whole pools per run: at least ten, so --quick still does one
+    u64 ops_for(usize objects) { return objects * (200000 / objects > 10 ? 200000 / objects : 10); }
+
+    u64 per_object(usize bytes, usize objects) { return objects > 0 ? (bytes + objects / 2) / objects : 0; }
+
+    void pool_ops(Suite &suite, const Synthetic &s) {
+        usize n = s.objects.size();
+        dp::String p = param("objects", n);
+        u64 object_bytes = per_object(s.vt_bytes.size(), n);
+
+        // Copies each object in, as a client building its pool does
+        suite.run("pool_add", p, ops_for(n), object_bytes, [&](u64 ops) {
+            ObjectPool pool;
+            for (u64 i = 0; i < ops; ++i) {
+                if (i % n == 0 && i > 0)
+                    pool.clear();
+                pool.add(s.objects[i % n]);
+            }
+            keep(pool.size());
+        });
+
+        const ObjectPool pool = build(s);
+        u64 found = 0;
+        suite.run("pool_find", p, 1000000, 0, [&](u64 ops) {
+            u32 id = 0;
+            for (u64 i = 0; i < ops; ++i) {
+                id = (id + 7919) % static_cast<u32>(n); // Stride through the whole pool
+                found += pool.find(static_cast<ObjectID>(id)).has_value() ? 1 : 0;
+            }
+        });
+        suite.check(found > 0, "pool_find finds the objects");
+
+        suite.run("pool_serialize", p, ops_for(n), object_bytes, [&](u64 ops) {
+            dp::Vector<u8> out;
+            for (u64 done = 0; done < ops; done += n) {
+                out.clear();
+                pool.serialize_into(out);
+            }
+            keep(out.data());
+        });
+
+        bool round_trip = false;
+        suite.run("pool_deserialize", p, ops_for(n), object_bytes, [&](u64 ops) {
+            for (u64 done = 0; done < ops; done += n) {
+                auto parsed = ObjectPool::deserialize(s.vt_bytes);
+                round_trip = parsed.is_ok() && parsed.value().size() == n;
+            }
+        });
+        suite.check(round_trip, "pool_deserialize gets every object back");
+
+        // The graph is rebuilt every time: find() on the mutable pool marks it stale
+        ObjectPool graph_pool = build(s);
+        bool valid = false;
+        suite.run("pool_validate", p, ops_for(n), object_bytes, [&](u64 ops) {
+            for (u64 done = 0; done < ops; done += n) {
+                graph_pool.find(0);
+                valid = graph_pool.validate().is_ok();
+            }
+        });
+        suite.check(valid, "pool_validate accepts the pool");
+    }
+
+    void iop_ops(Suite &suite, const dp::Vector<u8> &iop, dp::String p, usize objects) {
+        u64 object_bytes = per_object(iop.size(), objects);
+        for (u32 threads : {1u, 0u}) {
+            usize parsed = 0;
+            suite.run("iop_parse", threads == 1 ? p : p + " threads=all", ops_for(objects), object_bytes,
+                      [&](u64 ops) {
+                          for (u64 done = 0; done < ops; done += objects) {
+                              auto pool = IOPParser::parse_iop_data(iop, threads);
+                              parsed = pool.is_ok() ? pool.value().size() : 0;
+                          }
+                      });
+            suite.check(parsed == objects, "iop_parse reads every object");
+        }
+
+        dp::String version;
+        suite.run("iop_hash", p, ops_for(objects), object_bytes, [&](u64 ops) {
+            for (u64 done = 0; done < ops; done += objects)
+                version = IOPParser::hash_to_version(DataSpan(iop.data(), iop.size())).value();
+        });
+        suite.check(!version.empty(), "iop_hash gives a version label");
+    }
+
+    // Get Memory, the pool in one transfer and End of Object Pool, as the
+    // transport hands them to the server
+    void server_ingest(Suite &suite, const Synthetic &s) {
+        usize n = s.objects.size();
+        u32 size = static_cast<u32>(s.vt_bytes.size());
+        Message get_memory(PGN_ECU_TO_VT,
+                           {vt_cmd::GET_MEMORY, 0xFF, static_cast<u8>(size), static_cast<u8>(size >> 8),
+                            static_cast<u8>(size >> 16), static_cast<u8>(size >> 24), 0xFF, 0xFF},
+                           0x80, 0x10);
+        dp::Vector<u8> data;
+        data.push_back(vt_cmd::OBJECT_POOL_TRANSFER);
+        data.insert(data.end(), s.vt_bytes.begin(), s.vt_bytes.end());
+        Message transfer(PGN_ECU_TO_VT, data, 0x80, 0x10);
+        Message end_of_pool(PGN_ECU_TO_VT, {vt_cmd::END_OF_POOL, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF}, 0x80,
+                            0x10);
+
+        IsoNet nm;
+        auto *cf = nm.create_internal(Name::build().set_identity_number(1), 0, 0x10).value();
+        VTServer server(nm, cf, VTServerConfig{});
+        server.start();
+        suite.run("vt_server_ingest", param("objects", n), ops_for(n), per_object(s.vt_bytes.size(), n),
+                  [&](u64 ops) {
+                      for (u64 done = 0; done < ops; done += n) {
+                          nm.inject_message(get_memory);
+                          nm.inject_message(transfer);
+                          nm.inject_message(end_of_pool);
+                      }
+                  });
+        suite.check(!server.clients().empty() && server.clients()[0].pool_uploaded,
+                    "vt_server_ingest uploads the pool");
+    }
+
+    // Pools passed with --iop FILE
+    void customer_pools(Suite &suite, int argc, char **argv) {
+        for (int i = 1; i < argc; ++i) {
+            if (std::strcmp(argv[i], "--iop") != 0 || i + 1 >= argc)
+                continue;
+            const char *path = argv[++i];
+            auto data = IOPParser::read_iop_file(path);
+            if (!data.is_ok()) {
+                suite.check(false, "--iop file readable");
+                continue;
+            }
+            auto pool = IOPParser::parse_iop_data(data.value());
+            usize objects = pool.is_ok() ? pool.value().size() : 0;
+            if (objects == 0) {
+                suite.check(false, "--iop file holds objects");
+                continue;
+            }
+            const char *name = std::strrchr(path, '/');
+            iop_ops(suite, data.value(), name ? name + 1 : path, objects);
+        }
+    }
+
+} // namespace
+
+int main(int argc, char **argv) {
+    Suite suite("vt_pool", argc, argv);
+    for (u16 objects : {u16(100), u16(1000), u16(20000)}) {
+        Synthetic s = synthesize(objects);
+        pool_ops(suite, s);
+        iop_ops(suite, s.iop_bytes, param("objects", objects), objects);
+        server_ingest(suite, s);
+    }
+    customer_pools(suite, argc, argv);
+    return suite.finish();
+}
@@ -224,7 +224,9 @@ int main() {
             );
         }
 
-        // Run the periodic update (triggers auto-send when timer elapses)
+        // The network's timer wheel sends DM1 when its interval elapses;
+        // diag.update() runs the DM13 suspend durations
+        nm.update(elapsed_per_tick);
         diag.update(elapsed_per_tick);
 
         // Print current status
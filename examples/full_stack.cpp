@@ -124,7 +124,6 @@ int main(int argc, char* argv[]) {
 
     while (running) {
         nm.update(10);
-        heartbeat.update(10);
         diag.update(10);
         tc_client.update(10);
         vt_client.update(10);
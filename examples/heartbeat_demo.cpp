@@ -36,7 +36,7 @@ int main() {
 
     // Simulate time passing without receiving heartbeat from tracked device
     for (i32 i = 0; i < 5; ++i) {
-        hb.update(100);
+        nm.update(100); // Heartbeat timers run on the network's timer wheel
     }
 
     return 0;
@@ -130,7 +130,6 @@ int main() {
     // Simulate operation
     for (u32 i = 0; i < 50; ++i) {
         nm.update(100);
-        heartbeat.update(100);
         func.update(100);
         tim.update(100);
         geo.update(100);
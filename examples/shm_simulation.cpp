@@ -95,8 +95,6 @@ int main() {
     while (running && cycle < 100) {
         nm1.update(10);
         nm2.update(10);
-        hb1.update(10);
-        hb2.update(10);
 
         // Every 500ms, send a speed message from tractor
         if (cycle % 50 == 0) {
@@ -123,7 +121,6 @@ int main() {
     for (i32 i = 0; i < 20; ++i) {
         nm1.update(10);
         nm2.update(10);
-        hb1.update(10);
     }
 
     echo::info("After impairment: dropped=", server_link->stats().frames_dropped);
@@ -79,7 +79,6 @@ int main(int argc, char* argv[]) {
 
     while (running) {
         nm.update(10);
-        hb.update(10);
 
         usleep(10000); // 10ms
     }
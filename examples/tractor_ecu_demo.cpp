@@ -104,7 +104,6 @@ int main() {
         nm.update(100);
         tim.update(100);
         tc.update(100);
-        heartbeat.update(100);
         func.update(100);
 
         if (i % 10 == 0) {
@@ -81,7 +81,6 @@ int main() {
     hb1.enable();
 
     for (u32 i = 0; i < 10; ++i) {
-        hb1.update(10);
         nm1.update(10);
         nm2.update(10);
     }
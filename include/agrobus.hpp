@@ -3,40 +3,87 @@
 // ─── Net (CAN bus, transport, network management) ───────────────────────────
 #include "agrobus/net/address_claimer.hpp"
 #include "agrobus/net/bitfield.hpp"
+#include "agrobus/net/buffer_pool.hpp"
 #include "agrobus/net/bus_load.hpp"
 #include "agrobus/net/can_bus_config.hpp"
+#include "agrobus/net/can_errors.hpp"
+#include "agrobus/net/can_filter.hpp"
+#include "agrobus/net/can_log.hpp"
+#include "agrobus/net/capture.hpp"
+#include "agrobus/net/cf_directory.hpp"
+#include "agrobus/net/claim_cache.hpp"
+#include "agrobus/net/clock.hpp"
 #include "agrobus/net/constants.hpp"
 #include "agrobus/net/control_function.hpp"
+#include "agrobus/net/coro.hpp"
+#include "agrobus/net/cts_window.hpp"
 #include "agrobus/net/data_span.hpp"
+#include "agrobus/net/delegate.hpp"
 #include "agrobus/net/error.hpp"
 #include "agrobus/net/eth_can.hpp"
 #include "agrobus/net/etp.hpp"
 #include "agrobus/net/event.hpp"
 #include "agrobus/net/fast_packet.hpp"
+#include "agrobus/net/flight_recorder.hpp"
 #include "agrobus/net/frame.hpp"
 #include "agrobus/net/identifier.hpp"
 #include "agrobus/net/internal_cf.hpp"
+#include "agrobus/net/io_ring.hpp"
 #include "agrobus/net/iop_parser.hpp"
+#include "agrobus/net/last_value.hpp"
+#include "agrobus/net/latency.hpp"
+#include "agrobus/net/load_generator.hpp"
+#include "agrobus/net/memory_budget.hpp"
+#include "agrobus/net/loopback_bus.hpp"
 #include "agrobus/net/message.hpp"
+#include "agrobus/net/mpsc_queue.hpp"
+#include "agrobus/net/multi_pg.hpp"
 #include "agrobus/net/name.hpp"
 #include "agrobus/net/name_manager.hpp"
+#include "agrobus/net/name_table.hpp"
 #include "agrobus/net/network_manager.hpp"
 #include "agrobus/net/niu.hpp"
+#include "agrobus/net/niu_filter.hpp"
 #include "agrobus/net/partner_cf.hpp"
+#include "agrobus/net/payload.hpp"
 #include "agrobus/net/pgn.hpp"
+#include "agrobus/net/periodic_sender.hpp"
+#include "agrobus/net/pgn_codec.hpp"
+#include "agrobus/net/pgn_dispatch.hpp"
 #include "agrobus/net/pgn_defs.hpp"
 #include "agrobus/net/policy.hpp"
+#include "agrobus/net/port_executor.hpp"
+#include "agrobus/net/rt_channel.hpp"
 #include "agrobus/net/scheduler.hpp"
 #include "agrobus/net/session.hpp"
+#include "agrobus/net/session_table.hpp"
+#include "agrobus/net/shared_message.hpp"
+#include "agrobus/net/shm_bus.hpp"
+#include "agrobus/net/slab.hpp"
+#include "agrobus/net/snapshot.hpp"
+#include "agrobus/net/socketcan_fd.hpp"
+#include "agrobus/net/spsc_ring.hpp"
 #include "agrobus/net/state_machine.hpp"
+#include "agrobus/net/static_alloc.hpp"
+#include "agrobus/net/telemetry_uplink.hpp"
 #include "agrobus/net/timer.hpp"
+#include "agrobus/net/timer_wheel.hpp"
 #include "agrobus/net/tp.hpp"
+#include "agrobus/net/trace.hpp"
+#include "agrobus/net/traffic_profile.hpp"
+#include "agrobus/net/transport_limits.hpp"
+#include "agrobus/net/transport_metrics.hpp"
+#include "agrobus/net/tx_queue.hpp"
+#include "agrobus/net/work_pool.hpp"
 #include "agrobus/net/types.hpp"
+#include "agrobus/net/udp_can.hpp"
+#include "agrobus/net/update_profiler.hpp"
 #include "agrobus/net/working_set.hpp"
 
 // ─── J1939 (engine, diagnostics, protocol messages) ─────────────────────────
 #include "agrobus/j1939/acknowledgment.hpp"
 #include "agrobus/j1939/diagnostic.hpp"
+#include "agrobus/j1939/dm1_aggregator.hpp"
 #include "agrobus/j1939/dm_memory.hpp"
 #include "agrobus/j1939/engine.hpp"
 #include "agrobus/j1939/heartbeat.hpp"
@@ -45,16 +92,23 @@
 #include "agrobus/j1939/pgn_request.hpp"
 #include "agrobus/j1939/proprietary.hpp"
 #include "agrobus/j1939/request2.hpp"
+#include "agrobus/j1939/response_coalescer.hpp"
 #include "agrobus/j1939/shortcut_button.hpp"
 #include "agrobus/j1939/speed_distance.hpp"
+#include "agrobus/j1939/spn_columns.hpp"
 #include "agrobus/j1939/time_date.hpp"
+#include "agrobus/j1939/time_sync.hpp"
 #include "agrobus/j1939/transmission.hpp"
 
 // ─── ISOBUS (VT, TC, SC, implement, file server) ───────────────────────────
 #include "agrobus/isobus/auxiliary.hpp"
+#include "agrobus/isobus/bring_up.hpp"
 #include "agrobus/isobus/file_transfer.hpp"
 #include "agrobus/isobus/fs/connection.hpp"
+#include "agrobus/isobus/fs/io_worker.hpp"
 #include "agrobus/isobus/fs/properties.hpp"
+#include "agrobus/isobus/fs/send_queue.hpp"
+#include "agrobus/isobus/fs/storage.hpp"
 #include "agrobus/isobus/functionalities.hpp"
 #include "agrobus/isobus/group_function.hpp"
 #include "agrobus/isobus/guidance.hpp"
@@ -64,34 +118,63 @@
 #include "agrobus/isobus/implement/lighting.hpp"
 #include "agrobus/isobus/implement/machine_speed_cmd.hpp"
 #include "agrobus/isobus/implement/speed_distance.hpp"
+#include "agrobus/isobus/implement/speed_fusion.hpp"
 #include "agrobus/isobus/implement/tractor_commands.hpp"
 #include "agrobus/isobus/implement/tractor_facilities.hpp"
 #include "agrobus/isobus/sc/client.hpp"
 #include "agrobus/isobus/sc/master.hpp"
 #include "agrobus/isobus/sc/types.hpp"
 #include "agrobus/isobus/tc/client.hpp"
+#include "agrobus/isobus/tc/coverage.hpp"
+#include "agrobus/isobus/tc/data_logger.hpp"
 #include "agrobus/isobus/tc/ddi_database.hpp"
+#include "agrobus/isobus/tc/ddi_kernels.hpp"
 #include "agrobus/isobus/tc/ddop.hpp"
 #include "agrobus/isobus/tc/ddop_helpers.hpp"
+#include "agrobus/isobus/tc/ddop_view.hpp"
 #include "agrobus/isobus/tc/geo.hpp"
+#include "agrobus/isobus/tc/isoxml.hpp"
+#include "agrobus/isobus/tc/isoxml_reader.hpp"
+#include "agrobus/isobus/tc/measurement.hpp"
 #include "agrobus/isobus/tc/objects.hpp"
 #include "agrobus/isobus/tc/peer_control.hpp"
+#include "agrobus/isobus/tc/prescription.hpp"
+#include "agrobus/isobus/tc/prescription_grid.hpp"
+#include "agrobus/isobus/tc/section_state.hpp"
 #include "agrobus/isobus/tc/server.hpp"
 #include "agrobus/isobus/tc/server_options.hpp"
+#include "agrobus/isobus/tc/value_store.hpp"
 #include "agrobus/isobus/tim.hpp"
+#include "agrobus/isobus/vt/activation_table.hpp"
 #include "agrobus/isobus/vt/auxiliary_caps.hpp"
+#include "agrobus/isobus/vt/change_journal.hpp"
 #include "agrobus/isobus/vt/client.hpp"
+#include "agrobus/isobus/vt/command_queue.hpp"
 #include "agrobus/isobus/vt/commands.hpp"
+#include "agrobus/isobus/vt/language_pools.hpp"
+#include "agrobus/isobus/vt/macro_table.hpp"
 #include "agrobus/isobus/vt/objects.hpp"
+#include "agrobus/isobus/vt/pool_image.hpp"
+#include "agrobus/isobus/vt/pool_scaler.hpp"
+#include "agrobus/isobus/vt/resource_cache.hpp"
 #include "agrobus/isobus/vt/server.hpp"
 #include "agrobus/isobus/vt/server_working_set.hpp"
 #include "agrobus/isobus/vt/state_tracker.hpp"
+#include "agrobus/isobus/vt/static_pool.hpp"
 #include "agrobus/isobus/vt/update_helper.hpp"
+#include "agrobus/isobus/vt/version_store.hpp"
 #include "agrobus/isobus/vt/working_set.hpp"
 
 // ─── NMEA2000 ───────────────────────────────────────────────────────────────
 #include "agrobus/nmea/definitions.hpp"
+#include "agrobus/nmea/geo_kernels.hpp"
+#include "agrobus/nmea/gnss_binary.hpp"
 #include "agrobus/nmea/interface.hpp"
+#include "agrobus/nmea/n2k_decode.hpp"
+#include "agrobus/nmea/n2k_inventory.hpp"
 #include "agrobus/nmea/n2k_management.hpp"
+#include "agrobus/nmea/n2k_template.hpp"
 #include "agrobus/nmea/position.hpp"
+#include "agrobus/nmea/position_fusion.hpp"
+#include "agrobus/nmea/sentence.hpp"
 #include "agrobus/nmea/serial_gnss.hpp"
@@ -8,6 +8,7 @@
 #include <agrobus/net/network_manager.hpp>
 #include <agrobus/net/types.hpp>
 #include <datapod/datapod.hpp>
+#include <bit>
 #include <echo/echo.hpp>
 
 namespace agrobus::isobus {
@@ -41,7 +42,7 @@ namespace agrobus::isobus {
 
     // ─── AUX Config ──────────────────────────────────────────────────────────────
     struct AuxConfig {
-        bool auto_send_status = false;
+        bool auto_send_status = false; // update() sends the functions changed since its last send
         u32 status_interval_ms = 100;
 
         AuxConfig &auto_send(bool enable) {
@@ -54,12 +55,102 @@ namespace agrobus::isobus {
         }
     };
 
+    inline AuxFunctionState aux_state(AuxFunctionType type, u16 setpoint) noexcept {
+        if (type != AuxFunctionType::Type0)
+            return AuxFunctionState::Variable;
+        return setpoint > 0 ? AuxFunctionState::On : AuxFunctionState::Off;
+    }
+
+    // ─── Auxiliary function table ────────────────────────────────────────────────
+    // Functions stored densely in the order added, found through a table
+    // indexed by function number (one u16 per possible number), so an input
+    // costs the same with 2 functions or 200. A bit per number records the
+    // functions changed since the last flush().
+    template <typename Function> class AuxFunctionTable {
+        static constexpr u16 NONE = 0xFFFF;
+
+        dp::Array<u16, 256> slot_; // Function number -> index into functions_
+        dp::Vector<Function> functions_;
+        dp::Array<u64, 4> dirty_{};
+
+      public:
+        AuxFunctionTable() { slot_.fill(NONE); }
+
+        Function *find(u8 number) noexcept {
+            u16 i = slot_[number];
+            return i != NONE ? &functions_[i] : nullptr;
+        }
+        const Function *find(u8 number) const noexcept {
+            u16 i = slot_[number];
+            return i != NONE ? &functions_[i] : nullptr;
+        }
+
+        Function &insert(Function f) {
+            slot_[f.function_number] = static_cast<u16>(functions_.size());
+            functions_.push_back(f);
+            return functions_.back();
+        }
+
+        void mark(u8 number) noexcept { dirty_[number / 64] |= u64(1) << (number % 64); }
+        bool pending() const noexcept { return (dirty_[0] | dirty_[1] | dirty_[2] | dirty_[3]) != 0; }
+
+        // fn(function) for every function marked since the last flush, by number
+        template <typename Fn> void flush(Fn &&fn) {
+            for (u32 w = 0; w < 4; ++w) {
+                u64 bits = dirty_[w];
+                dirty_[w] = 0;
+                while (bits) {
+                    u32 number = w * 64 + static_cast<u32>(std::countr_zero(bits));
+                    bits &= bits - 1;
+                    if (const auto *f = find(static_cast<u8>(number)))
+                        fn(*f);
+                }
+            }
+        }
+
+        const dp::Vector<Function> &functions() const noexcept { return functions_; }
+        usize size() const noexcept { return functions_.size(); }
+    };
+
+    namespace detail {
+        // Shared by both interfaces: change a function, reporting only an actual change
+        template <typename Function, typename Changed>
+        void set_aux_function(AuxFunctionTable<Function> &table, u8 number, AuxFunctionType type, u16 setpoint,
+                              Changed &&changed) {
+            AuxFunctionState state = aux_state(type, setpoint);
+            auto *f = table.find(number);
+            if (!f) {
+                changed(table.insert(Function{number, type, state, setpoint}));
+                table.mark(number);
+                return;
+            }
+            if (f->type == type && f->setpoint == setpoint && f->state == state)
+                return; // Repeated input: no event, nothing to send
+            f->type = type;
+            f->setpoint = setpoint;
+            f->state = state;
+            table.mark(number);
+            changed(*f);
+        }
+
+        template <typename Function> dp::Vector<u8> aux_status(const Function &f) {
+            dp::Vector<u8> data(8, 0xFF);
+            data[0] = f.function_number;
+            data[1] = static_cast<u8>(f.type);
+            data[2] = static_cast<u8>(f.state);
+            data[3] = static_cast<u8>(f.setpoint & 0xFF);
+            data[4] = static_cast<u8>((f.setpoint >> 8) & 0xFF);
+            return data;
+        }
+    } // namespace detail
+
     // ─── AUX-O Interface ─────────────────────────────────────────────────────────
     class AuxOInterface {
         IsoNet &net_;
         InternalCF *cf_;
         AuxConfig config_;
-        dp::Vector<AuxOFunction> functions_;
+        AuxFunctionTable<AuxOFunction> functions_;
+        u32 status_timer_ms_ = 0;
 
       public:
         AuxOInterface(IsoNet &net, InternalCF *cf, AuxConfig config = {}) : net_(net), cf_(cf), config_(config) {}
@@ -74,70 +165,64 @@ namespace agrobus::isobus {
         }
 
         Result<void> add_function(u8 number, AuxFunctionType type) {
-            for (auto &f : functions_) {
-                if (f.function_number == number) {
-                    f.type = type;
-                    return {};
-                }
+            if (auto *f = functions_.find(number)) {
+                f->type = type;
+                return {};
             }
-            functions_.push_back({number, type, AuxFunctionState::Off, 0});
+            functions_.insert({number, type, AuxFunctionState::Off, 0});
             return {};
         }
 
+        // on_function_changed fires only when the type, state or setpoint changes
         void set_function(u8 number, AuxFunctionType type, u16 setpoint) {
-            for (auto &f : functions_) {
-                if (f.function_number == number) {
-                    f.type = type;
-                    auto old_setpoint = f.setpoint;
-                    f.setpoint = setpoint;
-                    f.state = (setpoint > 0) ? AuxFunctionState::On : AuxFunctionState::Off;
-                    if (f.type == AuxFunctionType::Type1 || f.type == AuxFunctionType::Type2) {
-                        f.state = AuxFunctionState::Variable;
-                    }
-                    if (old_setpoint != setpoint) {
-                        on_function_changed.emit(f);
-                    }
-                    return;
-                }
-            }
-            AuxOFunction func{number, type, AuxFunctionState::Off, setpoint};
-            if (setpoint > 0) {
-                func.state = AuxFunctionState::On;
-            }
-            functions_.push_back(func);
-            on_function_changed.emit(functions_.back());
+            detail::set_aux_function(functions_, number, type, setpoint,
+                                     [this](const AuxOFunction &f) { on_function_changed.emit(f); });
         }
 
         dp::Optional<AuxOFunction> get_function(u8 number) const {
-            for (const auto &f : functions_) {
-                if (f.function_number == number)
-                    return f;
-            }
+            if (const auto *f = functions_.find(number))
+                return *f;
             return dp::nullopt;
         }
 
-        const dp::Vector<AuxOFunction> &functions() const noexcept { return functions_; }
+        const dp::Vector<AuxOFunction> &functions() const noexcept { return functions_.functions(); }
 
         Result<void> send_status(u8 function_number) {
             echo::category("isobus.protocol.aux_o").debug("sending status for func=", function_number);
-            auto func = get_function(function_number);
-            if (!func.has_value()) {
+            const auto *func = functions_.find(function_number);
+            if (!func) {
                 return Result<void>::err(Error::invalid_state("function not found"));
             }
+            return net_.send(PGN_AUX_INPUT_STATUS, detail::aux_status(*func), cf_, nullptr, Priority::Default);
+        }
 
-            dp::Vector<u8> data(8, 0xFF);
-            data[0] = func->function_number;
-            data[1] = static_cast<u8>(func->type);
-            data[2] = static_cast<u8>(func->state);
-            data[3] = static_cast<u8>(func->setpoint & 0xFF);
-            data[4] = static_cast<u8>((func->setpoint >> 8) & 0xFF);
-            return net_.send(PGN_AUX_INPUT_STATUS, data, cf_, nullptr, Priority::Default);
+        // Status of every function changed since the last call, one pass over
+        // the changed ones; returns the first send error, after trying them all
+        Result<void> send_changed() {
+            Result<void> result{};
+            functions_.flush([&](const AuxOFunction &f) {
+                auto r = net_.send(PGN_AUX_INPUT_STATUS, detail::aux_status(f), cf_, nullptr, Priority::Default);
+                if (!r.is_ok() && result.is_ok())
+                    result = r;
+            });
+            return result;
         }
 
+        bool changes_pending() const noexcept { return functions_.pending(); }
+
         // Events
         Event<const AuxOFunction &> on_function_changed;
 
-        void update(u32 /*elapsed_ms*/) {}
+        void update(u32 elapsed_ms) {
+            if (!config_.auto_send_status)
+                return;
+            status_timer_ms_ += elapsed_ms;
+            if (status_timer_ms_ < config_.status_interval_ms)
+                return;
+            status_timer_ms_ = 0;
+            if (functions_.pending())
+                send_changed();
+        }
 
       private:
         void handle_input(const Message &msg) {
@@ -158,7 +243,8 @@ namespace agrobus::isobus {
         IsoNet &net_;
         InternalCF *cf_;
         AuxConfig config_;
-        dp::Vector<AuxNFunction> functions_;
+        AuxFunctionTable<AuxNFunction> functions_;
+        u32 status_timer_ms_ = 0;
 
       public:
         AuxNInterface(IsoNet &net, InternalCF *cf, AuxConfig config = {}) : net_(net), cf_(cf), config_(config) {}
@@ -173,73 +259,64 @@ namespace agrobus::isobus {
         }
 
         Result<void> add_function(u8 number, AuxFunctionType type) {
-            for (auto &f : functions_) {
-                if (f.function_number == number) {
-                    f.type = type;
-                    return {};
-                }
+            if (auto *f = functions_.find(number)) {
+                f->type = type;
+                return {};
             }
-            functions_.push_back({number, type, AuxFunctionState::Off, 0});
+            functions_.insert({number, type, AuxFunctionState::Off, 0});
             return {};
         }
 
+        // on_function_changed fires only when the type, state or setpoint changes
         void set_function(u8 number, AuxFunctionType type, u16 setpoint) {
-            for (auto &f : functions_) {
-                if (f.function_number == number) {
-                    f.type = type;
-                    auto old_setpoint = f.setpoint;
-                    f.setpoint = setpoint;
-                    if (type == AuxFunctionType::Type0) {
-                        f.state = (setpoint > 0) ? AuxFunctionState::On : AuxFunctionState::Off;
-                    } else {
-                        f.state = AuxFunctionState::Variable;
-                    }
-                    if (old_setpoint != setpoint) {
-                        on_function_changed.emit(f);
-                    }
-                    return;
-                }
-            }
-            AuxFunctionState state = AuxFunctionState::Off;
-            if (type == AuxFunctionType::Type0) {
-                state = (setpoint > 0) ? AuxFunctionState::On : AuxFunctionState::Off;
-            } else {
-                state = AuxFunctionState::Variable;
-            }
-            functions_.push_back({number, type, state, setpoint});
-            on_function_changed.emit(functions_.back());
+            detail::set_aux_function(functions_, number, type, setpoint,
+                                     [this](const AuxNFunction &f) { on_function_changed.emit(f); });
         }
 
         dp::Optional<AuxNFunction> get_function(u8 number) const {
-            for (const auto &f : functions_) {
-                if (f.function_number == number)
-                    return f;
-            }
+            if (const auto *f = functions_.find(number))
+                return *f;
             return dp::nullopt;
         }
 
-        const dp::Vector<AuxNFunction> &functions() const noexcept { return functions_; }
+        const dp::Vector<AuxNFunction> &functions() const noexcept { return functions_.functions(); }
 
         Result<void> send_status(u8 function_number) {
             echo::category("isobus.protocol.aux_n").debug("sending status for func=", function_number);
-            auto func = get_function(function_number);
-            if (!func.has_value()) {
+            const auto *func = functions_.find(function_number);
+            if (!func) {
                 return Result<void>::err(Error::invalid_state("function not found"));
             }
+            return net_.send(PGN_AUX_INPUT_TYPE2, detail::aux_status(*func), cf_, nullptr, Priority::Default);
+        }
 
-            dp::Vector<u8> data(8, 0xFF);
-            data[0] = func->function_number;
-            data[1] = static_cast<u8>(func->type);
-            data[2] = static_cast<u8>(func->state);
-            data[3] = static_cast<u8>(func->setpoint & 0xFF);
-            data[4] = static_cast<u8>((func->setpoint >> 8) & 0xFF);
-            return net_.send(PGN_AUX_INPUT_TYPE2, data, cf_, nullptr, Priority::Default);
+        // Status of every function changed since the last call, one pass over
+        // the changed ones; returns the first send error, after trying them all
+        Result<void> send_changed() {
+            Result<void> result{};
+            functions_.flush([&](const AuxNFunction &f) {
+                auto r = net_.send(PGN_AUX_INPUT_TYPE2, detail::aux_status(f), cf_, nullptr, Priority::Default);
+                if (!r.is_ok() && result.is_ok())
+                    result = r;
+            });
+            return result;
         }
 
+        bool changes_pending() const noexcept { return functions_.pending(); }
+
         // Events
         Event<const AuxNFunction &> on_function_changed;
 
-        void update(u32 /*elapsed_ms*/) {}
+        void update(u32 elapsed_ms) {
+            if (!config_.auto_send_status)
+                return;
+            status_timer_ms_ += elapsed_ms;
+            if (status_timer_ms_ < config_.status_interval_ms)
+                return;
+            status_timer_ms_ = 0;
+            if (functions_.pending())
+                send_changed();
+        }
 
       private:
         void handle_input(const Message &msg) {
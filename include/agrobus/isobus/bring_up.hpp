@@ -0,0 +1,240 @@
+#pragma once
+
+#include "file_transfer.hpp"
+#include "tc/client.hpp"
+#include "vt/client.hpp"
+#include <agrobus/net/error.hpp>
+#include <agrobus/net/event.hpp>
+#include <agrobus/net/internal_cf.hpp>
+#include <agrobus/net/types.hpp>
+#include <agrobus/net/working_set.hpp>
+#include <datapod/datapod.hpp>
+#include <echo/echo.hpp>
+#include <functional>
+
+namespace agrobus::isobus {
+    using namespace agrobus::net;
+
+    // ─── Bring-up status of one service ──────────────────────────────────────────
+    enum class ServiceStatus : u8 {
+        Waiting,     // Not connected yet: before the claim, or between attempts
+        Connecting,  // connect() made, the client's state machine is running
+        Operational, // Connected to its server
+        Failed       // Out of attempts
+    };
+
+    // ─── Bring-up Config ─────────────────────────────────────────────────────────
+    struct BringUpConfig {
+        u32 retry_ms = 1000; // Wait after a failed connect before the next one
+        u8 max_attempts = 0; // Connects per service before it is Failed; 0 = unlimited
+
+        BringUpConfig &retry(u32 ms) {
+            retry_ms = ms;
+            return *this;
+        }
+        BringUpConfig &attempts(u8 n) {
+            max_attempts = n;
+            return *this;
+        }
+    };
+
+    // Times are milliseconds since key_on()
+    struct ServiceReport {
+        dp::String name;
+        ServiceStatus status = ServiceStatus::Waiting;
+        u32 started_ms = 0;     // First connect
+        u32 operational_ms = 0; // Set once Operational: the key-on-to-ready time
+        u8 attempts = 0;
+    };
+
+    // ─── Bring-up orchestrator ───────────────────────────────────────────────────
+    // Connects every client of an ECU at once as soon as its address is
+    // claimed, instead of one after another, and times each from key-on to
+    // operational. The VT pool and the DDOP then go out while the other
+    // client still waits on its server: TP and ETP interleave sessions to
+    // different destinations frame by frame, so one large transfer does not
+    // hold up the other. With a WorkingSetManager the clients share one
+    // working set announcement rather than sending a master message each.
+    //
+    // The clients are still updated by the application; update() only reads
+    // their states, restarts failed connects after `retry_ms` and keeps the
+    // clock. Other services plug in with a connect function and ready/failed
+    // predicates.
+    class BringUp {
+        struct Service {
+            ServiceReport report;
+            std::function<Result<void>()> connect;
+            std::function<bool()> ready;
+            std::function<bool()> failed;
+            u32 retry_timer_ms = 0;
+        };
+
+        InternalCF *cf_;
+        WorkingSetManager *announcer_;
+        BringUpConfig config_;
+        dp::Vector<Service> services_;
+        u32 clock_ms_ = 0;
+        u32 claimed_ms_ = 0;
+        u32 operational_ms_ = 0;
+        bool claimed_ = false;
+        bool operational_ = false;
+
+      public:
+        BringUp(InternalCF *cf, WorkingSetManager *announcer = nullptr, BringUpConfig config = {})
+            : cf_(cf), announcer_(announcer), config_(config) {}
+
+        // ─── Services ────────────────────────────────────────────────────────────
+        // `failed` is asked only while connecting and not ready; returns the index
+        usize add(dp::String name, std::function<Result<void>()> connect, std::function<bool()> ready,
+                  std::function<bool()> failed) {
+            Service service;
+            service.report.name = std::move(name);
+            service.connect = std::move(connect);
+            service.ready = std::move(ready);
+            service.failed = std::move(failed);
+            services_.push_back(std::move(service));
+            operational_ = false;
+            return services_.size() - 1;
+        }
+
+        usize add(vt::VTClient &client, dp::String name = "VT") {
+            if (announcer_)
+                client.set_working_set_manager(announcer_);
+            return add(
+                std::move(name), [&client] { return client.connect(); },
+                [&client] { return client.state() == vt::VTState::Connected; },
+                [&client] { return client.state() == vt::VTState::Disconnected; });
+        }
+
+        usize add(tc::TaskControllerClient &client, dp::String name = "TC") {
+            if (announcer_)
+                client.set_working_set_manager(announcer_);
+            return add(
+                std::move(name), [&client] { return client.connect(); },
+                [&client] { return client.state() == tc::TCState::Connected; },
+                [&client] { return client.state() == tc::TCState::Disconnected; });
+        }
+
+        // Operational once a file server's status is seen
+        usize add(FileClient &client, dp::String name = "FS") {
+            if (announcer_)
+                client.set_working_set_manager(announcer_);
+            return add(
+                std::move(name), [&client] { return client.connect(); }, [&client] { return client.server_found(); },
+                [&client] { return !client.is_request_pending(); });
+        }
+
+        usize size() const noexcept { return services_.size(); }
+        const ServiceReport &report(usize index) const { return services_[index].report; }
+
+        // ─── Clock ───────────────────────────────────────────────────────────────
+        // Call at power-up, before the address claim: every time counts from
+        // here. Services start over, Waiting for the claim.
+        void key_on() {
+            clock_ms_ = 0;
+            claimed_ms_ = 0;
+            operational_ms_ = 0;
+            claimed_ = false;
+            operational_ = false;
+            for (auto &s : services_) {
+                s.report = ServiceReport{std::move(s.report.name)};
+                s.retry_timer_ms = 0;
+            }
+        }
+
+        u32 elapsed_ms() const noexcept { return clock_ms_; }
+        bool claimed() const noexcept { return claimed_; }
+        u32 claimed_ms() const noexcept { return claimed_ms_; }
+
+        // Every service operational, and when
+        bool operational() const noexcept { return operational_; }
+        u32 operational_ms() const noexcept { return operational_ms_; }
+
+        // Events
+        Event<const ServiceReport &> on_service_operational;
+        Event<const ServiceReport &> on_service_failed; // Out of attempts
+        Event<u32> on_operational;                      // ms since key-on, all services up
+
+        void update(u32 elapsed_ms) {
+            clock_ms_ += elapsed_ms;
+            if (!claimed_) {
+                if (!cf_ || cf_->claim_state() != ClaimState::Claimed)
+                    return;
+                claimed_ = true;
+                claimed_ms_ = clock_ms_;
+                echo::category("isobus.bring_up").debug("address claimed after ", clock_ms_, " ms");
+            }
+
+            // Every waiting service connects in this same pass
+            for (auto &s : services_) {
+                switch (s.report.status) {
+                case ServiceStatus::Waiting:
+                    s.retry_timer_ms += elapsed_ms;
+                    if (s.report.attempts == 0 || s.retry_timer_ms >= config_.retry_ms)
+                        start(s);
+                    break;
+                case ServiceStatus::Connecting:
+                    poll(s);
+                    break;
+                default:
+                    break;
+                }
+            }
+
+            if (!operational_ && !services_.empty() && all(ServiceStatus::Operational)) {
+                operational_ = true;
+                operational_ms_ = clock_ms_;
+                echo::category("isobus.bring_up").info("operational after ", clock_ms_, " ms");
+                on_operational.emit(clock_ms_);
+            }
+        }
+
+      private:
+        bool all(ServiceStatus status) const noexcept {
+            for (const auto &s : services_) {
+                if (s.report.status != status)
+                    return false;
+            }
+            return true;
+        }
+
+        void start(Service &s) {
+            if (s.report.attempts == 0)
+                s.report.started_ms = clock_ms_;
+            ++s.report.attempts;
+            s.retry_timer_ms = 0;
+            auto result = s.connect();
+            if (!result.is_ok()) {
+                echo::category("isobus.bring_up").warn(s.report.name, " connect failed: ", result.error().message);
+                give_up_or_retry(s);
+                return;
+            }
+            s.report.status = ServiceStatus::Connecting;
+            poll(s); // A response inside connect() already counts
+        }
+
+        void poll(Service &s) {
+            if (s.ready()) {
+                s.report.status = ServiceStatus::Operational;
+                s.report.operational_ms = clock_ms_;
+                echo::category("isobus.bring_up").info(s.report.name, " operational after ", clock_ms_, " ms");
+                on_service_operational.emit(s.report);
+            } else if (s.failed()) {
+                give_up_or_retry(s);
+            }
+        }
+
+        void give_up_or_retry(Service &s) {
+            if (config_.max_attempts != 0 && s.report.attempts >= config_.max_attempts) {
+                s.report.status = ServiceStatus::Failed;
+                echo::category("isobus.bring_up")
+                    .warn(s.report.name, " failed after ", static_cast<u32>(s.report.attempts), " attempts");
+                on_service_failed.emit(s.report);
+                return;
+            }
+            s.report.status = ServiceStatus::Waiting;
+            s.retry_timer_ms = 0;
+        }
+    };
+
+} // namespace agrobus::isobus
@@ -1,15 +1,24 @@
 #pragma once
 
+#include "fs/connection.hpp"
+#include "fs/io_worker.hpp"
+#include "fs/send_queue.hpp"
+#include "fs/storage.hpp"
 #include <agrobus/net/constants.hpp>
 #include <agrobus/net/control_function.hpp>
 #include <agrobus/net/error.hpp>
 #include <agrobus/net/event.hpp>
 #include <agrobus/net/internal_cf.hpp>
+#include <agrobus/net/memory_budget.hpp>
 #include <agrobus/net/message.hpp>
 #include <agrobus/net/network_manager.hpp>
+#include <agrobus/net/session.hpp>
 #include <agrobus/net/types.hpp>
+#include <agrobus/net/working_set.hpp>
+#include <cstring>
 #include <datapod/datapod.hpp>
 #include <echo/echo.hpp>
+#include <memory>
 
 namespace agrobus::isobus {
     using namespace agrobus::net;
@@ -99,6 +108,9 @@ namespace agrobus::isobus {
     // ─── File client request timeout (ISO 11783-13: wait for response) ──────────
     inline constexpr u32 FS_REQUEST_TIMEOUT_MS = 6000;
 
+    // ─── Largest read/write chunk whose message still fits one TP session ────────
+    inline constexpr u16 FS_TP_CHUNK_BYTES = static_cast<u16>(TP_MAX_DATA_LENGTH - 4);
+
     // ─── File Server Config ──────────────────────────────────────────────────────
     struct FileServerConfig {
         dp::String base_path = "";
@@ -107,6 +119,8 @@ namespace agrobus::isobus {
         dp::String volume_name = "ISOBUS";
         u32 volume_total_bytes = 1024 * 1024; // 1 MB default
         u32 volume_free_bytes = 512 * 1024;   // 512 KB default
+        u32 read_ahead_bytes = 0;             // Per-handle read-ahead on mounted storage (0: read inline)
+        MemoryBudget *memory = nullptr;       // Write buffers of open in-memory files are charged here
 
         FileServerConfig &path(dp::String p) {
             base_path = std::move(p);
@@ -126,14 +140,58 @@ namespace agrobus::isobus {
             volume_free_bytes = free;
             return *this;
         }
+        FileServerConfig &read_ahead(u32 bytes) {
+            read_ahead_bytes = bytes;
+            return *this;
+        }
+        FileServerConfig &budget(MemoryBudget *b) {
+            memory = b;
+            return *this;
+        }
+    };
+
+    // ─── A read answered once the disk has caught up ──────────────────────────────
+    struct PendingRead {
+        Address requester = NULL_ADDRESS;
+        u32 offset = 0;
+        u32 len = 0;
     };
 
     // ─── Open file state ──────────────────────────────────────────────────────────
+    // A handle shares the stored content instead of copying it on open; the
+    // first write copies it into `data`, which replaces it on close. Files on
+    // mounted storage are read and written through `disk` instead, and with
+    // read-ahead on, a handle that is only read keeps the file's next bytes in
+    // `ahead` while the server's reader thread refills `fill` behind it.
     struct OpenFileState {
         dp::String filename;
-        dp::Vector<u8> data; // File content buffer
-        u32 position = 0;    // Current read/write position
+        SharedPayload content; // Stored file content, shared with the server (null: empty file)
+        dp::Vector<u8> data;   // Written content, once writable
+        u32 position = 0;      // Current read/write position
         bool writable = false;
+        i32 disk = -1; // FileStorage handle, for a file on mounted storage
+
+        std::shared_ptr<dp::Vector<u8>> ahead; // File bytes from ahead_start, ahead_len of them
+        std::shared_ptr<dp::Vector<u8>> fill;  // Owned by the reader thread while `job` is set
+        u64 ahead_start = 0;
+        u32 ahead_len = 0;
+        u32 job = 0;       // Read in flight (0: none)
+        u32 next_read = 0; // Where a sequential read continues
+        dp::Vector<PendingRead> waiting; // In request order
+        MemoryCharge charge;             // Bytes of `data`, against the server's budget
+
+        usize size() const noexcept { return writable ? data.size() : (content ? content->size() : 0); }
+        const u8 *bytes() const noexcept { return writable ? data.data() : (content ? content->data() : nullptr); }
+
+        // Copy-on-write: the shared content becomes this handle's own buffer
+        void make_writable() {
+            if (writable)
+                return;
+            if (content)
+                data.assign(content->begin(), content->end());
+            content.reset();
+            writable = true;
+        }
     };
 
     // ─── File Server ─────────────────────────────────────────────────────────────
@@ -148,10 +206,28 @@ namespace agrobus::isobus {
         FileServerConfig config_;
         VolumeInfo volume_;
         bool busy_ = false;
+        std::unique_ptr<fs::FileStorage> storage_; // Files under base_path_, once mounted
+        fs::ConnectionManager clients_{255};
+        fs::SendQueue responses_; // Responses leave in request order to each client
+
+        // A closed handle whose read was still with the reader thread
+        struct Draining {
+            u32 job = 0;
+            u32 disk = 0;
+            std::shared_ptr<dp::Vector<u8>> buffer;
+        };
+        dp::Vector<Draining> draining_;
+        u32 next_job_ = 1;
+        u64 ahead_hits_ = 0;
+        u64 ahead_misses_ = 0;
+        // Last: joined or drained before the buffers they write go away
+        std::unique_ptr<fs::ReadWorker> reader_;
+        std::unique_ptr<fs::RingReader> ring_reader_; // Instead of the thread, see read_through()
 
       public:
         FileServer(IsoNet &net, InternalCF *cf, FileServerConfig config = {})
-            : net_(net), cf_(cf), base_path_(std::move(config.base_path)), config_(config) {
+            : net_(net), cf_(cf), base_path_(std::move(config.base_path)), config_(config),
+              responses_(net, PGN_FILE_SERVER_TO_CLIENT, cf) {
             volume_.name = config_.volume_name;
             volume_.total_bytes = config_.volume_total_bytes;
             volume_.free_bytes = config_.volume_free_bytes;
@@ -172,53 +248,118 @@ namespace agrobus::isobus {
             return {};
         }
 
+        // Serve the files in base_path_ from disk through a bounded page cache
+        // (see fs::FileStorage). Files added with content stay in memory; the
+        // rest are opened, read and written on disk, with written pages going
+        // back when evicted and at close. Adds the directory's files to files().
+        // With read_ahead_bytes set, reads of files that are not being written
+        // are served from per-handle buffers filled by a reader thread: a read
+        // the buffer cannot answer is answered from update() once its bytes are
+        // in, so one client waiting on the disk holds up nobody else.
+        // Changes made to the directory by others reach files() through
+        // inotify (Linux), and the volume reports the file system's sizes.
+        Result<void> mount(fs::FileStorageConfig config = {}) {
+            if (base_path_.empty())
+                return Result<void>::err(Error::invalid_state("no base path to mount"));
+            auto storage = std::make_unique<fs::FileStorage>(base_path_, config);
+            auto listed = storage->list();
+            if (!listed.is_ok())
+                return Result<void>::err(listed.error());
+            for (const auto &stored : listed.value()) {
+                if (!find_file(stored.name))
+                    store_properties(stored);
+            }
+            // Without notification the listing still follows the server's own changes
+            if (!storage->watch().is_ok())
+                echo::category("isobus.protocol.file_server").debug("storage not watched: ", base_path_);
+            storage_ = std::move(storage);
+            directory_changed();
+            if (config_.read_ahead_bytes > 0 && !reader_ && !ring_reader_) {
+                reader_ = std::make_unique<fs::ReadWorker>(config_.max_open_files + 1u);
+                reader_->start();
+            }
+            echo::category("isobus.protocol.file_server").info("storage mounted: ", base_path_);
+            return {};
+        }
+
+        // Fill the read-ahead buffers with reads on `ring` instead of a reader
+        // thread, so the disk is served by the same reactor as the buses.
+        // Call before mount(); `ring` must be open and outlive the server.
+        Result<void> read_through(IoRing &ring) {
+            if (reader_)
+                return Result<void>::err(Error::invalid_state("reader thread already started"));
+            if (!ring.is_open())
+                return Result<void>::err(Error::invalid_state("io_uring not open"));
+            ring_reader_ = std::make_unique<fs::RingReader>(ring, config_.max_open_files + 1u);
+            return {};
+        }
+
+        bool mounted() const noexcept { return storage_ != nullptr; }
+        const fs::FileStorage *storage() const noexcept { return storage_.get(); }
+        const fs::ConnectionManager &clients() const noexcept { return clients_; }
+
+        // Disk reads answered from a read-ahead buffer, and those that waited on the reader thread
+        u64 read_ahead_hits() const noexcept { return ahead_hits_; }
+        u64 read_ahead_misses() const noexcept { return ahead_misses_; }
+
         // Register files that this server provides (with properties)
         Result<void> add_file(dp::String filename, dp::Vector<u8> data = {}, u8 attributes = 0) {
             FileProperties props;
             props.name = std::move(filename);
             props.size_bytes = static_cast<u32>(data.size());
             props.attributes = attributes;
+            if (file_index_.find(props.name) == file_index_.end())
+                file_index_[props.name] = static_cast<u32>(file_list_.size());
             file_list_.push_back(std::move(props));
             // Store content in the file content map
             if (!data.empty()) {
-                file_contents_[file_list_.back().name] = std::move(data);
+                file_contents_[file_list_.back().name] = std::make_shared<const dp::Vector<u8>>(std::move(data));
             }
+            directory_changed();
             return {};
         }
 
         Result<void> remove_file(const dp::String &filename) {
-            for (auto it = file_list_.begin(); it != file_list_.end(); ++it) {
-                if (it->name == filename) {
-                    file_list_.erase(it);
-                    file_contents_.erase(filename);
-                    return {};
-                }
-            }
-            return Result<void>::err(Error::invalid_state("file not found"));
+            auto it = file_index_.find(filename);
+            if (it == file_index_.end())
+                return Result<void>::err(Error::invalid_state("file not found"));
+            file_list_.erase(file_list_.begin() + it->second);
+            file_contents_.erase(filename);
+            reindex();
+            directory_changed();
+            return {};
         }
 
         // Set file data content
         Result<void> set_file_data(const dp::String &filename, dp::Vector<u8> data) {
-            for (auto &f : file_list_) {
-                if (f.name == filename) {
-                    f.size_bytes = static_cast<u32>(data.size());
-                    file_contents_[filename] = std::move(data);
-                    return {};
-                }
-            }
-            return Result<void>::err(Error::invalid_state("file not found"));
+            auto *f = find_file(filename);
+            if (!f)
+                return Result<void>::err(Error::invalid_state("file not found"));
+            f->size_bytes = static_cast<u32>(data.size());
+            file_contents_[filename] = std::make_shared<const dp::Vector<u8>>(std::move(data));
+            directory_changed();
+            return {};
         }
 
         dp::Optional<dp::Vector<u8>> get_file_data(const dp::String &filename) const {
             auto it = file_contents_.find(filename);
             if (it != file_contents_.end())
-                return it->second;
+                return *it->second;
             return dp::nullopt;
         }
 
+        // The stored content itself, shared rather than copied (null if none)
+        SharedPayload file_content(const dp::String &filename) const {
+            auto it = file_contents_.find(filename);
+            return it != file_contents_.end() ? it->second : nullptr;
+        }
+
         const dp::Vector<FileProperties> &files() const noexcept { return file_list_; }
         const VolumeInfo &volume() const noexcept { return volume_; }
-        void set_volume(VolumeInfo info) { volume_ = std::move(info); }
+        void set_volume(VolumeInfo info) {
+            volume_ = std::move(info);
+            volume_stale_ = false;
+        }
 
         const dp::String &base_path() const noexcept { return base_path_; }
 
@@ -236,9 +377,20 @@ namespace agrobus::isobus {
         // Events
         Event<dp::String, Address> on_file_read_request;
         Event<dp::String, dp::Vector<u8>, Address> on_file_write_complete; // filename, data, source
+        Event<dp::String, u64, Address> on_file_stored; // filename, size, source: a written disk file closed
         Event<dp::String, Address> on_file_delete_request;
 
         void update(u32 elapsed_ms) {
+            ProfileScope profile(net_.update_profiler(), "file_server");
+            if (reader_)
+                reader_->poll([this](const fs::ReadJob &job) { complete_read(job); });
+            if (ring_reader_)
+                ring_reader_->poll([this](const fs::ReadJob &job) { complete_read(job); });
+            if (storage_)
+                storage_->poll_changes([this](const dp::String &name) { stored_changed(name); });
+            responses_.update();
+            (void)clients_.update(elapsed_ms);
+
             status_timer_ms_ += elapsed_ms;
             u32 interval = effective_status_interval();
             if (status_timer_ms_ >= interval) {
@@ -248,13 +400,107 @@ namespace agrobus::isobus {
         }
 
       private:
-        dp::Map<dp::String, dp::Vector<u8>> file_contents_; // filename -> data
+        dp::Map<dp::String, SharedPayload> file_contents_; // filename -> data, shared with open handles
+
+        // ─── Directory cache ────────────────────────────────────────────────────
+        // Lookups by name go through file_index_; the List response and, on
+        // mounted storage, the volume sizes are worked out once per change to
+        // the file set rather than per request. Changes come from the server's
+        // own calls and, on mounted storage, from inotify.
+        dp::Map<dp::String, u32> file_index_; // filename -> index into file_list_ (first of that name)
+        SharedPayload listing_;               // Encoded List response (null: stale)
+        bool volume_stale_ = false;
+
+        FileProperties *find_file(const dp::String &name) {
+            auto it = file_index_.find(name);
+            return it != file_index_.end() ? &file_list_[it->second] : nullptr;
+        }
+
+        void reindex() {
+            file_index_.clear();
+            for (u32 i = 0; i < file_list_.size(); ++i) {
+                if (file_index_.find(file_list_[i].name) == file_index_.end())
+                    file_index_[file_list_[i].name] = i;
+            }
+        }
+
+        void directory_changed() {
+            listing_.reset();
+            volume_stale_ = storage_ != nullptr;
+        }
+
+        void store_properties(const fs::StoredFile &stored) {
+            FileProperties props;
+            props.name = stored.name;
+            props.size_bytes = static_cast<u32>(stored.size_bytes);
+            props.attributes = stored.read_only ? static_cast<u8>(FileAttribute::ReadOnly) : 0;
+            if (auto *f = find_file(stored.name)) {
+                *f = std::move(props);
+                return;
+            }
+            file_index_[props.name] = static_cast<u32>(file_list_.size());
+            file_list_.push_back(std::move(props));
+        }
+
+        // A file in the storage root was created, removed or rewritten
+        void stored_changed(const dp::String &name) {
+            if (file_contents_.find(name) != file_contents_.end())
+                return; // Served from memory, whatever is on disk
+            if (auto stored = storage_->stat(name)) {
+                store_properties(*stored);
+            } else if (auto it = file_index_.find(name); it != file_index_.end()) {
+                file_list_.erase(file_list_.begin() + it->second);
+                reindex();
+            }
+            directory_changed();
+        }
+
+        const dp::Vector<u8> &listing() {
+            if (!listing_) {
+                auto response = std::make_shared<dp::Vector<u8>>();
+                response->push_back(static_cast<u8>(FileOperation::List));
+                response->push_back(static_cast<u8>(FileTransferError::NoError));
+                response->push_back(static_cast<u8>(file_list_.size()));
+                for (const auto &f : file_list_) {
+                    response->push_back(static_cast<u8>(f.name.size()));
+                    for (char c : f.name)
+                        response->push_back(static_cast<u8>(c));
+                }
+                while (response->size() < 8)
+                    response->push_back(0xFF);
+                listing_ = std::move(response);
+            }
+            return *listing_;
+        }
+
+        // Mounted storage reports the file system's own sizes
+        void refresh_volume() {
+            if (!volume_stale_)
+                return;
+            volume_stale_ = false;
+            auto space = storage_->space();
+            if (!space.is_ok())
+                return;
+            constexpr u64 MAX = 0xFFFFFFFFu;
+            volume_.total_bytes = static_cast<u32>(space.value().total_bytes < MAX ? space.value().total_bytes : MAX);
+            volume_.free_bytes = static_cast<u32>(space.value().free_bytes < MAX ? space.value().free_bytes : MAX);
+        }
+
+        // Mounted storage holds every file that has no content in memory
+        bool on_disk(const dp::String &name) const {
+            return storage_ && file_contents_.find(name) == file_contents_.end();
+        }
+
+        u64 file_size(const OpenFileState &file) const {
+            return file.disk >= 0 ? storage_->size(static_cast<u32>(file.disk)) : file.size();
+        }
 
         void handle_client_request(const Message &msg) {
             if (msg.data.empty())
                 return;
 
             auto op = static_cast<FileOperation>(msg.data[0]);
+            clients_.connect(msg.source, clients_.elapsed_total());
 
             switch (op) {
             case FileOperation::OpenFile:
@@ -300,9 +546,7 @@ namespace agrobus::isobus {
         }
 
         Result<void> send_response(const dp::Vector<u8> &data, Address requester) {
-            ControlFunction dest_cf;
-            dest_cf.address = requester;
-            return net_.send(PGN_FILE_SERVER_TO_CLIENT, data, cf_, &dest_cf, Priority::Default);
+            return responses_.send(data, requester);
         }
 
         void handle_open(const Message &msg) {
@@ -324,26 +568,30 @@ namespace agrobus::isobus {
                 return;
             }
 
-            // Check if file exists
-            bool found = false;
-            for (const auto &f : file_list_) {
-                if (f.name == filename) {
-                    found = true;
-                    break;
-                }
-            }
+            bool found = find_file(filename) != nullptr;
 
             dp::Vector<u8> response(8, 0xFF);
             response[0] = static_cast<u8>(FileOperation::OpenFile);
             if (found) {
-                u8 handle = next_handle_++;
                 OpenFileState state;
+                if (on_disk(filename)) {
+                    auto opened = storage_->open(filename);
+                    if (!opened.is_ok()) {
+                        response[1] = static_cast<u8>(FileTransferError::FileNotFound);
+                        response[2] = 0;
+                        send_response(response, msg.source);
+                        return;
+                    }
+                    state.disk = static_cast<i32>(opened.value());
+                }
+                u8 handle = next_handle_++;
                 state.filename = filename;
+                state.charge = MemoryCharge(config_.memory);
                 state.position = 0;
-                // Load file data if available
+                // Share the stored content; nothing is copied until a write
                 auto it = file_contents_.find(filename);
                 if (it != file_contents_.end()) {
-                    state.data = it->second;
+                    state.content = it->second;
                 }
                 open_files_[handle] = std::move(state);
                 response[1] = static_cast<u8>(FileTransferError::NoError);
@@ -367,18 +615,35 @@ namespace agrobus::isobus {
             response[0] = static_cast<u8>(FileOperation::CloseFile);
 
             auto it = open_files_.find(handle);
-            if (it != open_files_.end()) {
+            if (it != open_files_.end() && it->second.disk >= 0) {
+                // Written pages go back to disk here
+                u32 disk = static_cast<u32>(it->second.disk);
+                u64 size = storage_->size(disk);
+                bool written = it->second.writable;
+                for (const auto &read : it->second.waiting)
+                    send_read_error(FileTransferError::InvalidHandle, read.requester);
+                // The reader thread may still be using the descriptor: that read closes it
+                auto closed = it->second.job ? storage_->flush(disk) : storage_->close(disk);
+                if (it->second.job)
+                    draining_.push_back({it->second.job, disk, std::move(it->second.fill)});
+                if (written && closed.is_ok()) {
+                    if (auto *f = find_file(it->second.filename))
+                        f->size_bytes = static_cast<u32>(size);
+                    directory_changed();
+                    on_file_stored.emit(it->second.filename, size, msg.source);
+                }
+                open_files_.erase(it);
+                response[1] = static_cast<u8>(closed.is_ok() ? FileTransferError::NoError : FileTransferError::IOError);
+            } else if (it != open_files_.end()) {
                 // If file was written, persist data and emit event
                 if (it->second.writable && !it->second.data.empty()) {
-                    file_contents_[it->second.filename] = it->second.data;
+                    auto stored = std::make_shared<const dp::Vector<u8>>(std::move(it->second.data));
+                    file_contents_[it->second.filename] = stored;
                     // Update file size in properties
-                    for (auto &f : file_list_) {
-                        if (f.name == it->second.filename) {
-                            f.size_bytes = static_cast<u32>(it->second.data.size());
-                            break;
-                        }
-                    }
-                    on_file_write_complete.emit(it->second.filename, it->second.data, msg.source);
+                    if (auto *f = find_file(it->second.filename))
+                        f->size_bytes = static_cast<u32>(stored->size());
+                    directory_changed();
+                    on_file_write_complete.emit(it->second.filename, *stored, msg.source);
                 }
                 open_files_.erase(it);
                 response[1] = static_cast<u8>(FileTransferError::NoError);
@@ -396,37 +661,177 @@ namespace agrobus::isobus {
 
             auto it = open_files_.find(handle);
             if (it == open_files_.end()) {
-                dp::Vector<u8> response(8, 0xFF);
-                response[0] = static_cast<u8>(FileOperation::ReadData);
-                response[1] = static_cast<u8>(FileTransferError::InvalidHandle);
-                send_response(response, msg.source);
+                send_read_error(FileTransferError::InvalidHandle, msg.source);
                 return;
             }
-
             auto &file = it->second;
-            dp::Vector<u8> response;
-            response.push_back(static_cast<u8>(FileOperation::ReadData));
-
-            if (file.position >= file.data.size()) {
-                response.push_back(static_cast<u8>(FileTransferError::EndOfFile));
-                response.push_back(0);
-                response.push_back(0); // 0 bytes read
-                while (response.size() < 8)
-                    response.push_back(0xFF);
-            } else {
-                u32 avail = static_cast<u32>(file.data.size() - file.position);
-                u32 to_read = (read_len > avail) ? avail : read_len;
-                response.push_back(static_cast<u8>(FileTransferError::NoError));
-                response.push_back(static_cast<u8>(to_read & 0xFF));
-                response.push_back(static_cast<u8>((to_read >> 8) & 0xFF));
-                for (u32 i = 0; i < to_read; ++i) {
-                    response.push_back(file.data[file.position + i]);
+
+            // Reads queued behind the disk move the position they will leave behind
+            u32 from = file.waiting.empty() ? file.position : file.waiting.back().offset + file.waiting.back().len;
+            u64 size = file_size(file);
+            u32 avail = from < size ? static_cast<u32>(size - from) : 0;
+            u32 to_read = (read_len > avail) ? avail : read_len;
+            if (!file.waiting.empty()) {
+                file.waiting.push_back(PendingRead{msg.source, from, to_read});
+                return;
+            }
+            if (to_read > 0 && reads_ahead(file)) {
+                if (serve_ahead(file, msg.source, file.position, to_read)) {
+                    ++ahead_hits_;
+                    return;
+                }
+                if (file.job != 0 || start_read(file, file.position, to_read)) {
+                    // Answered from update() once the reader thread has it
+                    file.waiting.push_back(PendingRead{msg.source, file.position, to_read});
+                    ++ahead_misses_;
+                    return;
                 }
-                file.position += to_read;
             }
-            while (response.size() < 8)
-                response.push_back(0xFF);
-            send_response(response, msg.source);
+            send_read(file, msg.source, to_read, avail == 0);
+        }
+
+        // One block copy from the file into the response, which TP/ETP then
+        // send from in place (the 4-byte header in front of the data keeps
+        // the transport from reading the file storage itself)
+        void send_read(OpenFileState &file, Address dest, u32 to_read, bool eof) {
+            auto response = read_response(to_read, eof);
+            u8 *out = response->data();
+            if (to_read > 0 && file.disk >= 0) {
+                // Straight from the page cache into the response
+                auto read = storage_->read(static_cast<u32>(file.disk), file.position, out + 4, to_read);
+                if (!read.is_ok()) {
+                    send_read_error(FileTransferError::IOError, dest);
+                    return;
+                }
+            } else if (to_read > 0) {
+                std::memcpy(out + 4, file.bytes() + file.position, to_read);
+            }
+            file.position += to_read;
+            send_shared_response(std::move(response), dest);
+        }
+
+        std::shared_ptr<dp::Vector<u8>> read_response(u32 to_read, bool eof) const {
+            auto response = std::make_shared<dp::Vector<u8>>(to_read + 4 < 8 ? 8 : to_read + 4, 0xFF);
+            u8 *out = response->data();
+            out[0] = static_cast<u8>(FileOperation::ReadData);
+            out[1] = static_cast<u8>(eof ? FileTransferError::EndOfFile : FileTransferError::NoError);
+            out[2] = static_cast<u8>(to_read & 0xFF);
+            out[3] = static_cast<u8>((to_read >> 8) & 0xFF);
+            return response;
+        }
+
+        void send_shared_response(SharedPayload response, Address dest) {
+            (void)responses_.send(std::move(response), dest);
+        }
+
+        void send_read_error(FileTransferError error, Address dest) {
+            dp::Vector<u8> response(8, 0xFF);
+            response[0] = static_cast<u8>(FileOperation::ReadData);
+            response[1] = static_cast<u8>(error);
+            send_response(response, dest);
+        }
+
+        // ─── Read-ahead (mounted storage) ───────────────────────────────────────
+        // Once written, a handle reads through the page cache, which holds its writes
+        bool reads_ahead(const OpenFileState &file) const noexcept {
+            return (reader_ || ring_reader_) && file.disk >= 0 && !file.writable;
+        }
+
+        bool serve_ahead(OpenFileState &file, Address dest, u32 offset, u32 len) {
+            if (offset < file.ahead_start || offset + len > file.ahead_start + file.ahead_len)
+                return false;
+            auto response = read_response(len, false);
+            std::memcpy(response->data() + 4, file.ahead->data() + (offset - file.ahead_start), len);
+            file.position = offset + len;
+            file.next_read = file.position;
+            send_shared_response(std::move(response), dest);
+
+            // Refill once half the buffer has been read; the unread rest is read again with it
+            u64 end = file.ahead_start + file.ahead_len;
+            if (file.job == 0 && end < file_size(file) && end - file.position < config_.read_ahead_bytes / 2)
+                (void)start_read(file, file.position, 0);
+            return true;
+        }
+
+        // A read of at least `len` bytes from `offset`, a full buffer when reading sequentially
+        bool start_read(OpenFileState &file, u32 offset, u32 len) {
+            u32 disk = static_cast<u32>(file.disk);
+            u64 size = storage_->size(disk);
+            u32 want = len;
+            if (offset == file.next_read && want < config_.read_ahead_bytes)
+                want = config_.read_ahead_bytes;
+            if (want > size - offset)
+                want = static_cast<u32>(size - offset);
+            if (!file.fill)
+                file.fill = std::make_shared<dp::Vector<u8>>();
+            if (file.fill->size() < want)
+                file.fill->resize(want);
+
+            fs::ReadJob job;
+            job.id = next_job_++;
+            if (next_job_ == 0)
+                next_job_ = 1;
+            job.fd = storage_->descriptor(disk);
+            job.offset = offset;
+            job.len = want;
+            job.dest = file.fill->data();
+            if (!(ring_reader_ ? ring_reader_->submit(job) : reader_->submit(job)))
+                return false;
+            file.job = job.id;
+            return true;
+        }
+
+        void complete_read(const fs::ReadJob &job) {
+            for (auto it = draining_.begin(); it != draining_.end(); ++it) {
+                if (it->job == job.id) {
+                    (void)storage_->close(it->disk);
+                    draining_.erase(it);
+                    return;
+                }
+            }
+            OpenFileState *file = nullptr;
+            for (auto &[handle, state] : open_files_) {
+                if (state.job == job.id)
+                    file = &state;
+            }
+            if (!file)
+                return;
+
+            file->job = 0;
+            if (job.result >= 0 && !file->writable) {
+                std::swap(file->ahead, file->fill);
+                file->ahead_start = job.offset;
+                file->ahead_len = static_cast<u32>(job.result);
+            }
+            if (job.result < 0) {
+                for (const auto &read : file->waiting)
+                    send_read_error(FileTransferError::IOError, read.requester);
+                file->waiting.clear();
+                return;
+            }
+            serve_waiting(*file);
+        }
+
+        // Answers queued reads in order, until one needs the disk again
+        void serve_waiting(OpenFileState &file) {
+            while (!file.waiting.empty()) {
+                PendingRead read = file.waiting.front();
+                if (read.len > 0 && !serve_ahead(file, read.requester, read.offset, read.len)) {
+                    if (file.job != 0)
+                        return; // A refill is already on its way
+                    // A read outside the buffer, or a handle written meanwhile
+                    if (reads_ahead(file) && start_read(file, read.offset, read.len))
+                        return;
+                    file.position = read.offset;
+                    u64 size = file_size(file);
+                    u32 avail = read.offset < size ? static_cast<u32>(size - read.offset) : 0;
+                    send_read(file, read.requester, read.len > avail ? avail : read.len, avail == 0);
+                } else if (read.len == 0) {
+                    file.position = read.offset;
+                    send_read(file, read.requester, 0, read.offset >= file_size(file));
+                }
+                file.waiting.erase(file.waiting.begin());
+            }
         }
 
         void handle_write_data(const Message &msg) {
@@ -445,23 +850,41 @@ namespace agrobus::isobus {
             }
 
             auto &file = it->second;
-            file.writable = true;
 
             // Append or overwrite at current position
             u16 data_avail = static_cast<u16>(msg.data.size() - 4);
             u16 actual_len = (write_len > data_avail) ? data_avail : write_len;
-
-            if (file.position + actual_len > file.data.size()) {
-                file.data.resize(file.position + actual_len);
-            }
-            for (u16 i = 0; i < actual_len; ++i) {
-                file.data[file.position + i] = msg.data[4 + i];
+            FileTransferError error = FileTransferError::NoError;
+
+            if (file.disk >= 0) {
+                u32 disk = static_cast<u32>(file.disk);
+                auto written = storage_->write(disk, file.position, msg.data.data() + 4, actual_len);
+                if (written.is_ok()) {
+                    file.writable = true;
+                    file.ahead_len = 0;
+                } else {
+                    error = storage_->writable(disk) ? FileTransferError::IOError : FileTransferError::AccessDenied;
+                    actual_len = 0;
+                }
+            } else if (u64 end = file.position + actual_len;
+                       !file.charge.resize(end > file.size() ? end : file.size()).is_ok()) {
+                // The writable copy would not fit the budget: the file stays as it was
+                error = FileTransferError::DiskFull;
+                actual_len = 0;
+            } else {
+                file.make_writable();
+                if (file.position + actual_len > file.data.size()) {
+                    file.data.resize(file.position + actual_len);
+                }
+                for (u16 i = 0; i < actual_len; ++i) {
+                    file.data[file.position + i] = msg.data[4 + i];
+                }
             }
             file.position += actual_len;
 
             dp::Vector<u8> response(8, 0xFF);
             response[0] = static_cast<u8>(FileOperation::WriteData);
-            response[1] = static_cast<u8>(FileTransferError::NoError);
+            response[1] = static_cast<u8>(error);
             response[2] = static_cast<u8>(actual_len & 0xFF);
             response[3] = static_cast<u8>((actual_len >> 8) & 0xFF);
             send_response(response, msg.source);
@@ -480,7 +903,7 @@ namespace agrobus::isobus {
 
             if (it == open_files_.end()) {
                 response[1] = static_cast<u8>(FileTransferError::InvalidHandle);
-            } else if (position > it->second.data.size()) {
+            } else if (position > file_size(it->second)) {
                 response[1] = static_cast<u8>(FileTransferError::InvalidSeekPosition);
             } else {
                 it->second.position = position;
@@ -494,20 +917,8 @@ namespace agrobus::isobus {
         }
 
         void handle_list(const Message &msg) {
-            dp::Vector<u8> response;
-            response.push_back(static_cast<u8>(FileOperation::List));
-            response.push_back(static_cast<u8>(FileTransferError::NoError));
-            response.push_back(static_cast<u8>(file_list_.size()));
-
-            for (const auto &f : file_list_) {
-                response.push_back(static_cast<u8>(f.name.size()));
-                for (char c : f.name) {
-                    response.push_back(static_cast<u8>(c));
-                }
-            }
-            while (response.size() < 8)
-                response.push_back(0xFF);
-            send_response(response, msg.source);
+            (void)listing();
+            send_shared_response(listing_, msg.source);
         }
 
         void handle_delete(const Message &msg) {
@@ -520,6 +931,8 @@ namespace agrobus::isobus {
             }
 
             on_file_delete_request.emit(filename, msg.source);
+            if (find_file(filename) && on_disk(filename))
+                (void)storage_->remove(filename);
             remove_file(filename);
 
             dp::Vector<u8> response(8, 0xFF);
@@ -540,17 +953,15 @@ namespace agrobus::isobus {
             dp::Vector<u8> response(8, 0xFF);
             response[0] = static_cast<u8>(FileOperation::GetAttributes);
 
-            for (const auto &f : file_list_) {
-                if (f.name == filename) {
-                    response[1] = static_cast<u8>(FileTransferError::NoError);
-                    response[2] = f.attributes;
-                    response[3] = static_cast<u8>(f.size_bytes & 0xFF);
-                    response[4] = static_cast<u8>((f.size_bytes >> 8) & 0xFF);
-                    response[5] = static_cast<u8>((f.size_bytes >> 16) & 0xFF);
-                    response[6] = static_cast<u8>((f.size_bytes >> 24) & 0xFF);
-                    send_response(response, msg.source);
-                    return;
-                }
+            if (const auto *f = find_file(filename)) {
+                response[1] = static_cast<u8>(FileTransferError::NoError);
+                response[2] = f->attributes;
+                response[3] = static_cast<u8>(f->size_bytes & 0xFF);
+                response[4] = static_cast<u8>((f->size_bytes >> 8) & 0xFF);
+                response[5] = static_cast<u8>((f->size_bytes >> 16) & 0xFF);
+                response[6] = static_cast<u8>((f->size_bytes >> 24) & 0xFF);
+                send_response(response, msg.source);
+                return;
             }
             response[1] = static_cast<u8>(FileTransferError::FileNotFound);
             send_response(response, msg.source);
@@ -566,7 +977,7 @@ namespace agrobus::isobus {
 
             auto it = open_files_.find(handle);
             if (it != open_files_.end()) {
-                u32 size = static_cast<u32>(it->second.data.size());
+                u32 size = static_cast<u32>(file_size(it->second));
                 response[1] = static_cast<u8>(FileTransferError::NoError);
                 response[2] = static_cast<u8>(size & 0xFF);
                 response[3] = static_cast<u8>((size >> 8) & 0xFF);
@@ -579,6 +990,7 @@ namespace agrobus::isobus {
         }
 
         void handle_get_free_space(const Message &msg) {
+            refresh_volume();
             dp::Vector<u8> response(8, 0xFF);
             response[0] = static_cast<u8>(FileOperation::GetFreeSpace);
             response[1] = static_cast<u8>(FileTransferError::NoError);
@@ -590,6 +1002,7 @@ namespace agrobus::isobus {
         }
 
         void handle_get_volume_info(const Message &msg) {
+            refresh_volume();
             dp::Vector<u8> response;
             response.push_back(static_cast<u8>(FileOperation::GetVolumeInfo));
             response.push_back(static_cast<u8>(FileTransferError::NoError));
@@ -630,25 +1043,66 @@ namespace agrobus::isobus {
             data[1] = static_cast<u8>(open_files_.size());
             data[2] = config_.max_open_files;
             data[3] = static_cast<u8>(file_list_.size());
-            ControlFunction dest_cf;
-            dest_cf.address = dest;
-            net_.send(PGN_FILE_SERVER_TO_CLIENT, data, cf_, &dest_cf, Priority::Default);
+            send_response(data, dest);
+        }
+    };
+
+    // ─── File Client ─────────────────────────────────────────────────────────────
+    // ─── File Client Config ──────────────────────────────────────────────────────
+    struct FileClientConfig {
+        u8 window = 1;                       // Read/write requests outstanding at once in a transfer
+        u16 chunk_bytes = FS_TP_CHUNK_BYTES; // Data per request; larger chunks go over ETP
+
+        FileClientConfig &pipeline(u8 requests) {
+            window = requests;
+            return *this;
+        }
+        FileClientConfig &chunk(u16 bytes) {
+            chunk_bytes = bytes;
+            return *this;
         }
     };
 
     // ─── File Client ─────────────────────────────────────────────────────────────
+    // Single requests follow the one-inflight rule. read_file()/write_file()
+    // stream a whole range instead, keeping up to `window` ReadData/WriteData
+    // requests outstanding so the next chunk is already asked for while the
+    // previous one is on the bus. The server answers them in order.
     class FileClient {
+        struct Transfer {
+            bool active = false;
+            bool write = false;
+            bool ended = false; // End of file, or an error: ask for nothing more
+            u8 handle = 0;
+            u32 length = 0; // Bytes to move
+            u32 issued = 0; // Bytes asked for
+            u32 done = 0;   // Bytes answered
+            u32 idle_ms = 0;
+            dp::Vector<u16> sizes; // Outstanding requests, oldest first
+            dp::Vector<u8> data;   // Bytes to write
+        };
+
         IsoNet &net_;
         InternalCF *cf_;
         ControlFunction *server_ = nullptr;
+        WorkingSetManager *announcer_ = nullptr;
+        FileClientConfig config_;
         FileClientState state_ = FileClientState::Idle;
         u8 current_handle_ = 0;
+        Address status_source_ = NULL_ADDRESS; // Server of the last status seen
         bool request_pending_ = false;
         u32 pending_timeout_ms_ = 0;
+        Transfer transfer_;
+        fs::SendQueue requests_;
 
       public:
-        FileClient(IsoNet &net, InternalCF *cf, ControlFunction *server = nullptr)
-            : net_(net), cf_(cf), server_(server) {}
+        FileClient(IsoNet &net, InternalCF *cf, ControlFunction *server = nullptr, FileClientConfig config = {})
+            : net_(net), cf_(cf), server_(server), config_(config), requests_(net, PGN_FILE_CLIENT_TO_SERVER, cf) {
+            if (config_.window == 0)
+                config_.window = 1;
+            if (config_.chunk_bytes == 0)
+                config_.chunk_bytes = FS_TP_CHUNK_BYTES;
+        }
 
         Result<void> initialize() {
             if (!cf_) {
@@ -662,8 +1116,11 @@ namespace agrobus::isobus {
 
         void set_server(ControlFunction *server) { server_ = server; }
 
+        // Working set announced (once, shared with the VT and TC clients) before the first open
+        void set_working_set_manager(WorkingSetManager *manager) { announcer_ = manager; }
+
         Result<void> request_open(const dp::String &filename) {
-            if (request_pending_) {
+            if (request_pending_ || transfer_.active) {
                 return Result<void>::err(Error::invalid_state("request already pending"));
             }
             echo::category("isobus.protocol.file_client").debug("requesting open: ", filename);
@@ -676,14 +1133,40 @@ namespace agrobus::isobus {
             while (data.size() < 8)
                 data.push_back(0xFF);
 
+            if (announcer_) {
+                if (auto r = announcer_->announce(); !r.is_ok())
+                    return r;
+            }
             state_ = FileClientState::Transferring;
             request_pending_ = true;
             pending_timeout_ms_ = 0;
             return net_.send(PGN_FILE_CLIENT_TO_SERVER, data, cf_, server_, Priority::Default);
         }
 
+        // Asks the server for its status (broadcast without a server set); the
+        // answer, or the server's periodic status, marks it found. The
+        // working set is announced first, as before any other request.
+        Result<void> connect() {
+            if (request_pending_ || transfer_.active) {
+                return Result<void>::err(Error::invalid_state("request already pending"));
+            }
+            if (announcer_) {
+                if (auto r = announcer_->announce(); !r.is_ok())
+                    return r;
+            }
+            echo::category("isobus.protocol.file_client").debug("requesting server status");
+            dp::Vector<u8> data(8, 0xFF);
+            data[0] = static_cast<u8>(FileOperation::GetServerStatus);
+            request_pending_ = true;
+            pending_timeout_ms_ = 0;
+            return net_.send(PGN_FILE_CLIENT_TO_SERVER, data, cf_, server_, Priority::Default);
+        }
+
+        bool server_found() const noexcept { return status_source_ != NULL_ADDRESS; }
+        Address status_source() const noexcept { return status_source_; }
+
         Result<void> request_close(u8 handle) {
-            if (request_pending_) {
+            if (request_pending_ || transfer_.active) {
                 return Result<void>::err(Error::invalid_state("request already pending"));
             }
             dp::Vector<u8> data(8, 0xFF);
@@ -695,7 +1178,7 @@ namespace agrobus::isobus {
         }
 
         Result<void> request_list() {
-            if (request_pending_) {
+            if (request_pending_ || transfer_.active) {
                 return Result<void>::err(Error::invalid_state("request already pending"));
             }
             echo::category("isobus.protocol.file_client").debug("requesting list");
@@ -707,7 +1190,7 @@ namespace agrobus::isobus {
         }
 
         Result<void> request_delete(const dp::String &filename) {
-            if (request_pending_) {
+            if (request_pending_ || transfer_.active) {
                 return Result<void>::err(Error::invalid_state("request already pending"));
             }
             echo::category("isobus.protocol.file_client").debug("requesting delete: ", filename);
@@ -724,6 +1207,21 @@ namespace agrobus::isobus {
             return net_.send(PGN_FILE_CLIENT_TO_SERVER, data, cf_, server_, Priority::Default);
         }
 
+        // ─── Pipelined transfers ───────────────────────────────────────────────
+        // Reads up to `length` bytes from the handle's position, fewer at the end of the file
+        Result<void> read_file(u8 handle, u32 length) { return start_transfer(handle, length, false, {}); }
+
+        // Writes `data` at the handle's position
+        Result<void> write_file(u8 handle, dp::Vector<u8> data) {
+            u32 length = static_cast<u32>(data.size());
+            return start_transfer(handle, length, true, std::move(data));
+        }
+
+        bool is_transfer_active() const noexcept { return transfer_.active; }
+        u32 transfer_done() const noexcept { return transfer_.done; }
+        u8 outstanding() const noexcept { return static_cast<u8>(transfer_.sizes.size()); }
+        const FileClientConfig &config() const noexcept { return config_; }
+
         FileClientState state() const noexcept { return state_; }
         u8 current_handle() const noexcept { return current_handle_; }
         bool is_request_pending() const noexcept { return request_pending_; }
@@ -734,8 +1232,23 @@ namespace agrobus::isobus {
         Event<u8> on_file_count;                       // number of files
         Event<> on_file_deleted;
         Event<> on_timeout; // request timed out (ISO 11783-13)
+        Event<u32, dp::Vector<u8>> on_read_chunk; // offset into the transfer, bytes (in order)
+        Event<u32> on_transfer_complete;          // bytes read or written
+        Event<Address> on_server_status;          // server address
 
         void update(u32 elapsed_ms) {
+            ProfileScope profile(net_.update_profiler(), "file_client");
+            requests_.update();
+            if (transfer_.active && !transfer_.sizes.empty()) {
+                transfer_.idle_ms += elapsed_ms;
+                if (transfer_.idle_ms >= FS_REQUEST_TIMEOUT_MS) {
+                    echo::category("isobus.protocol.file_client")
+                        .warn("transfer timeout after ", transfer_.done, " of ", transfer_.length, " bytes");
+                    transfer_ = {};
+                    state_ = FileClientState::Error;
+                    on_timeout.emit();
+                }
+            }
             if (request_pending_) {
                 pending_timeout_ms_ += elapsed_ms;
                 if (pending_timeout_ms_ >= FS_REQUEST_TIMEOUT_MS) {
@@ -749,15 +1262,134 @@ namespace agrobus::isobus {
         }
 
       private:
+        Address server_address() const noexcept { return server_ ? server_->address : BROADCAST_ADDRESS; }
+
+        Result<void> start_transfer(u8 handle, u32 length, bool write, dp::Vector<u8> data) {
+            if (request_pending_ || transfer_.active)
+                return Result<void>::err(Error::invalid_state("request already pending"));
+            transfer_ = {};
+            transfer_.active = true;
+            transfer_.write = write;
+            transfer_.handle = handle;
+            transfer_.length = length;
+            transfer_.data = std::move(data);
+            state_ = FileClientState::Transferring;
+            echo::category("isobus.protocol.file_client")
+                .debug(write ? "writing " : "reading ", length, " bytes, window=", config_.window);
+            auto issued = issue();
+            if (!issued.is_ok()) {
+                transfer_ = {};
+                state_ = FileClientState::Error;
+                return issued;
+            }
+            finish_if_done();
+            return {};
+        }
+
+        // Fills the window with further requests
+        Result<void> issue() {
+            while (transfer_.sizes.size() < config_.window && !transfer_.ended && transfer_.issued < transfer_.length) {
+                u32 left = transfer_.length - transfer_.issued;
+                u16 n = left < config_.chunk_bytes ? static_cast<u16>(left) : config_.chunk_bytes;
+                Result<void> sent;
+                if (transfer_.write) {
+                    auto data = std::make_shared<dp::Vector<u8>>(4 + n < 8 ? 8 : 4 + n, 0xFF);
+                    (*data)[0] = static_cast<u8>(FileOperation::WriteData);
+                    (*data)[1] = transfer_.handle;
+                    (*data)[2] = static_cast<u8>(n & 0xFF);
+                    (*data)[3] = static_cast<u8>((n >> 8) & 0xFF);
+                    std::memcpy(data->data() + 4, transfer_.data.data() + transfer_.issued, n);
+                    sent = requests_.send(std::move(data), server_address());
+                } else {
+                    dp::Vector<u8> data(8, 0xFF);
+                    data[0] = static_cast<u8>(FileOperation::ReadData);
+                    data[1] = transfer_.handle;
+                    data[2] = static_cast<u8>(n & 0xFF);
+                    data[3] = static_cast<u8>((n >> 8) & 0xFF);
+                    sent = requests_.send(data, server_address());
+                }
+                if (!sent.is_ok())
+                    return sent;
+                transfer_.issued += n;
+                transfer_.sizes.push_back(n);
+            }
+            return {};
+        }
+
+        void handle_transfer_response(const Message &msg, FileTransferError err) {
+            if (transfer_.sizes.empty())
+                return;
+            u16 asked = transfer_.sizes.front();
+            transfer_.sizes.erase(transfer_.sizes.begin());
+            transfer_.idle_ms = 0;
+            u16 len = msg.data.size() >= 4 ? static_cast<u16>(msg.data[2] | (msg.data[3] << 8)) : 0;
+
+            if (err != FileTransferError::NoError && err != FileTransferError::EndOfFile) {
+                if (!transfer_.ended)
+                    on_error.emit(err, transfer_.write ? "write failed" : "read failed");
+                transfer_.ended = true;
+                state_ = FileClientState::Error;
+            } else if (!transfer_.ended) {
+                if (!transfer_.write && len > 0 && msg.data.size() >= 4u + len) {
+                    dp::Vector<u8> chunk(msg.data.begin() + 4, msg.data.begin() + 4 + len);
+                    on_read_chunk.emit(transfer_.done, std::move(chunk));
+                }
+                transfer_.done += len;
+                if (err == FileTransferError::EndOfFile || len < asked)
+                    transfer_.ended = true; // Requests still out come back empty
+            }
+            if (!transfer_.ended && !issue().is_ok()) {
+                on_error.emit(FileTransferError::Unknown, "request not sent");
+                transfer_.ended = true;
+                state_ = FileClientState::Error;
+            }
+            finish_if_done();
+        }
+
+        void finish_if_done() {
+            if (!transfer_.active || !transfer_.sizes.empty())
+                return;
+            if (!transfer_.ended && transfer_.issued < transfer_.length)
+                return;
+            u32 done = transfer_.done;
+            bool failed = state_ == FileClientState::Error;
+            transfer_ = {};
+            if (!failed) {
+                state_ = FileClientState::Complete;
+                on_transfer_complete.emit(done);
+            }
+        }
+
         void handle_server_response(const Message &msg) {
             if (msg.data.empty())
                 return;
+            if (msg.destination != cf_->address() && msg.destination != BROADCAST_ADDRESS)
+                return; // Another client's answer
+
+            auto op = static_cast<FileOperation>(msg.data[0]);
+            if (transfer_.active && (op == FileOperation::ReadData || op == FileOperation::WriteData)) {
+                auto err = static_cast<FileTransferError>(msg.data.size() > 1 ? msg.data[1] : 0);
+                handle_transfer_response(msg, err);
+                return;
+            }
+
+            // The periodic status is broadcast: it answers connect() only
+            if (op == FileOperation::GetServerStatus) {
+                if (server_ && msg.source != server_->address)
+                    return;
+                status_source_ = msg.source;
+                if (msg.destination == cf_->address()) {
+                    request_pending_ = false;
+                    pending_timeout_ms_ = 0;
+                }
+                on_server_status.emit(msg.source);
+                return;
+            }
 
             // Any response clears the pending state (ISO 11783-13 one-inflight rule)
             request_pending_ = false;
             pending_timeout_ms_ = 0;
 
-            auto op = static_cast<FileOperation>(msg.data[0]);
             auto err = (msg.data.size() > 1) ? static_cast<FileTransferError>(msg.data[1]) : FileTransferError::NoError;
 
             switch (op) {
@@ -38,8 +38,12 @@ namespace agrobus::isobus::fs {
     };
 
     // ─── Connection manager for file server ─────────────────────────────────────
+    // Connections are kept packed in a vector and found through a table indexed
+    // by source address, so each request costs one lookup whatever the number of
+    // clients. Removal moves the last connection into the freed place.
     class ConnectionManager {
         dp::Vector<ClientConnection> connections_;
+        dp::Array<u8, 256> slot_{}; // Address -> index into connections_ + 1 (0: not connected)
         u8 max_clients_;
         u32 elapsed_total_ms_ = 0;
         u32 status_timer_ms_ = 0;
@@ -53,12 +57,10 @@ namespace agrobus::isobus::fs {
         // Register or update a client connection
         bool connect(Address client, u32 current_time_ms) {
             // Check if already connected
-            for (auto &conn : connections_) {
-                if (conn.client_address == client) {
-                    conn.connected = true;
-                    conn.touch(current_time_ms);
-                    return true;
-                }
+            if (auto *conn = find(client)) {
+                conn->connected = true;
+                conn->touch(current_time_ms);
+                return true;
             }
 
             // Check capacity
@@ -71,29 +73,23 @@ namespace agrobus::isobus::fs {
             conn.connected = true;
             conn.last_activity_ms = current_time_ms;
             connections_.push_back(conn);
+            slot_[client] = static_cast<u8>(connections_.size());
             has_active_clients_ = true;
             return true;
         }
 
         // Disconnect a client
         void disconnect(Address client) {
-            for (auto it = connections_.begin(); it != connections_.end(); ++it) {
-                if (it->client_address == client) {
-                    connections_.erase(it);
-                    update_active_state();
-                    return;
-                }
-            }
+            if (slot_[client] == 0)
+                return;
+            remove_at(slot_[client] - 1u);
+            update_active_state();
         }
 
         // Record activity from a client
         void record_activity(Address client, u32 current_time_ms) {
-            for (auto &conn : connections_) {
-                if (conn.client_address == client) {
-                    conn.touch(current_time_ms);
-                    return;
-                }
-            }
+            if (auto *conn = find(client))
+                conn->touch(current_time_ms);
         }
 
         // Update timers and check for timeouts
@@ -109,12 +105,12 @@ namespace agrobus::isobus::fs {
 
             // Check for timed-out connections
             dp::Vector<Address> timed_out;
-            for (auto it = connections_.begin(); it != connections_.end();) {
-                if (it->is_timed_out(elapsed_total_ms_)) {
-                    timed_out.push_back(it->client_address);
-                    it = connections_.erase(it);
+            for (usize i = 0; i < connections_.size();) {
+                if (connections_[i].is_timed_out(elapsed_total_ms_)) {
+                    timed_out.push_back(connections_[i].client_address);
+                    remove_at(i);
                 } else {
-                    ++it;
+                    ++i;
                 }
             }
 
@@ -153,38 +149,43 @@ namespace agrobus::isobus::fs {
         u8 active_client_count() const noexcept { return static_cast<u8>(connections_.size()); }
         u8 max_clients() const noexcept { return max_clients_; }
         u32 elapsed_total() const noexcept { return elapsed_total_ms_; }
+        bool is_connected(Address client) const noexcept { return slot_[client] != 0; }
 
         // Get connection for a specific client
         dp::Optional<ClientConnection> get_connection(Address client) const {
-            for (const auto &conn : connections_) {
-                if (conn.client_address == client) {
-                    return conn;
-                }
-            }
-            return dp::nullopt;
+            if (slot_[client] == 0)
+                return dp::nullopt;
+            return connections_[slot_[client] - 1u];
         }
 
         // Increment open file count for a client
         void increment_open_files(Address client) {
-            for (auto &conn : connections_) {
-                if (conn.client_address == client) {
-                    ++conn.open_file_count;
-                    return;
-                }
-            }
+            if (auto *conn = find(client))
+                ++conn->open_file_count;
         }
 
         // Decrement open file count for a client
         void decrement_open_files(Address client) {
-            for (auto &conn : connections_) {
-                if (conn.client_address == client && conn.open_file_count > 0) {
-                    --conn.open_file_count;
-                    return;
-                }
-            }
+            auto *conn = find(client);
+            if (conn && conn->open_file_count > 0)
+                --conn->open_file_count;
         }
 
       private:
+        ClientConnection *find(Address client) noexcept {
+            return slot_[client] != 0 ? &connections_[slot_[client] - 1u] : nullptr;
+        }
+
+        // Swap-remove, keeping the address table in step
+        void remove_at(usize index) {
+            slot_[connections_[index].client_address] = 0;
+            if (index + 1 != connections_.size()) {
+                connections_[index] = connections_.back();
+                slot_[connections_[index].client_address] = static_cast<u8>(index + 1);
+            }
+            connections_.pop_back();
+        }
+
         void update_active_state() noexcept {
             has_active_clients_ = false;
             for (const auto &conn : connections_) {
@@ -0,0 +1,172 @@
+#pragma once
+
+#include <agrobus/net/io_ring.hpp>
+#include <agrobus/net/spsc_ring.hpp>
+#include <agrobus/net/types.hpp>
+#include <atomic>
+#include <chrono>
+#include <datapod/datapod.hpp>
+#include <thread>
+#include <unistd.h>
+
+namespace agrobus::isobus::fs {
+    using namespace agrobus::net;
+
+    // ─── One disk read handed to the worker ─────────────────────────────────────
+    // `dest` must stay valid until the job comes back from poll().
+    struct ReadJob {
+        u32 id = 0;
+        int fd = -1;
+        u64 offset = 0;
+        u32 len = 0;
+        u8 *dest = nullptr;
+        i64 result = 0; // Bytes read, or -1 on error (set by the worker)
+    };
+
+    // ─── Background disk reader ─────────────────────────────────────────────────
+    // Jobs go to one reader thread through a lock-free ring and come back through
+    // another, so the thread that owns the network never waits on the disk. The
+    // worker only calls pread() on descriptors it is given; every other piece of
+    // file state stays with the caller. At most capacity() jobs are in flight:
+    // submit() refuses more, and the done ring can never overflow.
+    class ReadWorker {
+        SpscRing<ReadJob> jobs_;
+        SpscRing<ReadJob> done_;
+        std::atomic<u32> in_flight_{0};
+        std::atomic<bool> running_{false};
+        std::thread thread_;
+        u32 idle_us_;
+
+      public:
+        explicit ReadWorker(usize capacity = 32, u32 idle_us = 200)
+            : jobs_(capacity), done_(capacity), idle_us_(idle_us) {}
+
+        ReadWorker(const ReadWorker &) = delete;
+        ReadWorker &operator=(const ReadWorker &) = delete;
+
+        ~ReadWorker() { stop(); }
+
+        void start() {
+            if (thread_.joinable())
+                return;
+            running_.store(true, std::memory_order_release);
+            thread_ = std::thread([this]() { worker_main(); });
+        }
+
+        // Jobs not yet read are still returned by poll(), with result -1
+        void stop() {
+            if (!thread_.joinable())
+                return;
+            running_.store(false, std::memory_order_release);
+            thread_.join();
+            ReadJob job;
+            while (jobs_.try_pop(job)) {
+                job.result = -1;
+                (void)done_.try_push(job);
+            }
+        }
+
+        bool running() const noexcept { return thread_.joinable(); }
+
+        // False when capacity() jobs are already in flight
+        bool submit(const ReadJob &job) {
+            if (in_flight_.load(std::memory_order_relaxed) >= jobs_.capacity() || !jobs_.try_push(job))
+                return false;
+            in_flight_.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+
+        // Hands each finished job to `fn`; returns how many
+        template <typename Fn> usize poll(Fn &&fn) {
+            usize n = 0;
+            ReadJob job;
+            while (done_.try_pop(job)) {
+                in_flight_.fetch_sub(1, std::memory_order_relaxed);
+                fn(job);
+                ++n;
+            }
+            return n;
+        }
+
+        u32 in_flight() const noexcept { return in_flight_.load(std::memory_order_relaxed); }
+        usize capacity() const noexcept { return jobs_.capacity(); }
+
+      private:
+        void worker_main() {
+            ReadJob job;
+            while (running_.load(std::memory_order_acquire)) {
+                if (!jobs_.try_pop(job)) {
+                    std::this_thread::sleep_for(std::chrono::microseconds(idle_us_));
+                    continue;
+                }
+                usize done = 0;
+                job.result = 0;
+                while (done < job.len) {
+                    ssize_t n = ::pread(job.fd, job.dest + done, job.len - done, static_cast<off_t>(job.offset + done));
+                    if (n < 0) {
+                        job.result = -1;
+                        break;
+                    }
+                    if (n == 0)
+                        break;
+                    done += static_cast<usize>(n);
+                }
+                if (job.result == 0)
+                    job.result = static_cast<i64>(done);
+                (void)done_.try_push(job);
+            }
+        }
+    };
+
+    // ─── Disk reads on an io_uring ──────────────────────────────────────────────
+    // ReadWorker's contract without the thread: each job is a read submitted on
+    // the caller's IoRing, so the disk shares one reactor (and its syscalls)
+    // with the buses. Jobs complete while the ring runs and are handed out by
+    // poll(). Short reads are not retried: for a regular file they mean end of
+    // file. The ring must outlive the reader.
+    class RingReader {
+        IoRing &ring_;
+        u32 capacity_;
+        u32 in_flight_ = 0;
+        dp::Vector<ReadJob> done_;
+
+      public:
+        RingReader(IoRing &ring, u32 capacity) : ring_(ring), capacity_(capacity) {}
+
+        RingReader(const RingReader &) = delete;
+        RingReader &operator=(const RingReader &) = delete;
+
+        // The kernel may still be writing into the jobs' buffers: let it finish
+        ~RingReader() {
+            for (int i = 0; i < 1000 && in_flight_ > 0 && ring_.is_open(); ++i)
+                ring_.run(1);
+        }
+
+        // False when capacity() jobs are already in flight or the ring is full
+        bool submit(const ReadJob &job) {
+            if (in_flight_ >= capacity_)
+                return false;
+            bool queued = ring_.read_at(job.fd, job.offset, job.dest, job.len, [this, job](i64 result) {
+                done_.push_back(job);
+                done_.back().result = result < 0 ? -1 : result;
+                --in_flight_;
+            });
+            if (queued)
+                ++in_flight_;
+            return queued;
+        }
+
+        // Hands each finished job to `fn`; returns how many
+        template <typename Fn> usize poll(Fn &&fn) {
+            dp::Vector<ReadJob> done;
+            std::swap(done, done_);
+            for (const auto &job : done)
+                fn(job);
+            return done.size();
+        }
+
+        u32 in_flight() const noexcept { return in_flight_; }
+        usize capacity() const noexcept { return capacity_; }
+    };
+
+} // namespace agrobus::isobus::fs
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <agrobus/net/data_span.hpp>
 #include <agrobus/net/types.hpp>
 #include <datapod/datapod.hpp>
 
@@ -47,7 +48,7 @@ namespace agrobus::isobus::fs {
             return data;
         }
 
-        static FileServerProperties decode(const dp::Vector<u8> &data) {
+        static FileServerProperties decode(DataSpan data) {
             FileServerProperties props;
 
             if (data.size() < 5)
@@ -122,7 +123,7 @@ namespace agrobus::isobus::fs {
             return data;
         }
 
-        static VolumeStatus decode(const dp::Vector<u8> &data) {
+        static VolumeStatus decode(DataSpan data) {
             VolumeStatus vol;
 
             if (data.size() < 12)
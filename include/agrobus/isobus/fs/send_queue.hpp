@@ -0,0 +1,105 @@
+#pragma once
+
+#include <agrobus/net/error.hpp>
+#include <agrobus/net/internal_cf.hpp>
+#include <agrobus/net/network_manager.hpp>
+#include <agrobus/net/session.hpp>
+#include <agrobus/net/types.hpp>
+#include <datapod/datapod.hpp>
+#include <memory>
+
+namespace agrobus::isobus::fs {
+    using namespace agrobus::net;
+
+    // ─── In-order sends to each peer ────────────────────────────────────────────
+    // Only one TP/ETP session runs per (source, destination, PGN), so a second
+    // multi-packet message to a peer must wait for the first to end, and any
+    // message sent meanwhile would overtake it. While a transfer to a peer is
+    // out, later messages to that peer queue behind it and leave from update().
+    //
+    // The transport holds a reference to a zero-copy payload until its session
+    // ends; the queue hands it a reference of its own and watches it expire.
+    class SendQueue {
+        struct Peer {
+            std::weak_ptr<const dp::Vector<u8>> in_flight; // Expires when the transport lets go
+            dp::Vector<SharedPayload> queued;
+
+            bool busy() const noexcept { return !in_flight.expired() || !queued.empty(); }
+        };
+
+        IsoNet &net_;
+        PGN pgn_;
+        InternalCF *cf_;
+        dp::Map<Address, Peer> peers_;
+
+      public:
+        SendQueue(IsoNet &net, PGN pgn, InternalCF *cf) : net_(net), pgn_(pgn), cf_(cf) {}
+
+        // Single frames go straight out unless something is queued ahead of them
+        Result<void> send(const dp::Vector<u8> &data, Address dest) {
+            if (data.size() <= CAN_DATA_LENGTH && !busy(dest))
+                return transmit_frame(data, dest);
+            return send(std::make_shared<const dp::Vector<u8>>(data), dest);
+        }
+
+        Result<void> send(SharedPayload data, Address dest) {
+            if (!data)
+                return Result<void>::err(Error::invalid_state("null payload"));
+            Peer &peer = peers_[dest];
+            if (peer.busy()) {
+                peer.queued.push_back(std::move(data));
+                return {};
+            }
+            auto sent = transmit(peer, data, dest);
+            if (!sent.is_ok() && sent.error().code == ErrorCode::SessionExists) {
+                peer.queued.push_back(std::move(data)); // Another sender's session: retried from update()
+                return {};
+            }
+            return sent;
+        }
+
+        // Sends what the finished transfers were holding back
+        void update() {
+            for (auto &[dest, peer] : peers_) {
+                while (!peer.queued.empty() && peer.in_flight.expired()) {
+                    auto sent = transmit(peer, peer.queued.front(), dest);
+                    if (!sent.is_ok() && sent.error().code == ErrorCode::SessionExists)
+                        break;
+                    peer.queued.erase(peer.queued.begin());
+                }
+            }
+        }
+
+        bool busy(Address dest) const {
+            auto it = peers_.find(dest);
+            return it != peers_.end() && it->second.busy();
+        }
+
+        usize queued(Address dest) const {
+            auto it = peers_.find(dest);
+            return it != peers_.end() ? it->second.queued.size() : 0;
+        }
+
+        void clear() { peers_.clear(); }
+
+      private:
+        Result<void> transmit_frame(const dp::Vector<u8> &data, Address dest) {
+            ControlFunction dest_cf;
+            dest_cf.address = dest;
+            return net_.send(pgn_, data, cf_, dest == BROADCAST_ADDRESS ? nullptr : &dest_cf, Priority::Default);
+        }
+
+        Result<void> transmit(Peer &peer, const SharedPayload &data, Address dest) {
+            if (data->size() <= CAN_DATA_LENGTH)
+                return transmit_frame(*data, dest);
+            // A reference of the transport's own, keeping `data` alive through it
+            SharedPayload tracked(data.get(), [keep = data](const dp::Vector<u8> *) {});
+            peer.in_flight = tracked;
+            ControlFunction dest_cf;
+            dest_cf.address = dest;
+            return net_.send_shared(pgn_, std::move(tracked), cf_, dest == BROADCAST_ADDRESS ? nullptr : &dest_cf,
+                                    Priority::Default);
+        }
+    };
+
+} // namespace agrobus::isobus::fs
@@ -0,0 +1,411 @@
+#pragma once
+
+#include <agrobus/net/error.hpp>
+#include <agrobus/net/types.hpp>
+#include <cerrno>
+#include <cstring>
+#include <datapod/datapod.hpp>
+#include <dirent.h>
+#include <echo/echo.hpp>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/statvfs.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <sys/inotify.h>
+#endif
+
+namespace agrobus::isobus::fs {
+    using namespace agrobus::net;
+
+    // ─── Disk storage configuration ─────────────────────────────────────────────
+    struct FileStorageConfig {
+        u32 page_bytes = 4096;
+        u32 cache_pages = 256; // 1 MB of cache with the default page size
+
+        FileStorageConfig &page_size(u32 bytes) {
+            page_bytes = bytes;
+            return *this;
+        }
+        FileStorageConfig &cache(u32 pages) {
+            cache_pages = pages;
+            return *this;
+        }
+    };
+
+    // ─── A file found under the storage root ────────────────────────────────────
+    struct StoredFile {
+        dp::String name;
+        u64 size_bytes = 0;
+        bool read_only = false;
+    };
+
+    struct StorageSpace {
+        u64 total_bytes = 0;
+        u64 free_bytes = 0;
+    };
+
+    // ─── Disk-backed file storage ───────────────────────────────────────────────
+    // Files in one directory, read and written with pread/pwrite through a page
+    // cache of fixed size shared by every open file. Reads fill pages on a miss;
+    // writes go into cached pages, which reach the disk when evicted (least
+    // recently used first) or when their file is flushed or closed. No file is
+    // ever held in memory whole, whatever its size.
+    //
+    // Names are plain file names: no directories, no "." or "..".
+    class FileStorage {
+        struct OpenFile {
+            int fd = -1;
+            u64 size = 0;
+            bool writable = false;
+        };
+
+        struct Page {
+            u64 key = 0; // Open file index << 40 | page number
+            u64 last_use = 0;
+            bool used = false;
+            bool dirty = false;
+        };
+
+        dp::String root_;
+        FileStorageConfig config_;
+        dp::Vector<OpenFile> files_; // Handle = index; fd < 0 marks a free slot
+        dp::Vector<Page> pages_;
+        dp::Vector<u8> memory_;        // cache_pages * page_bytes
+        dp::Map<u64, u32> page_slot_; // Page key -> index into pages_
+        int watch_fd_ = -1;           // inotify descriptor, once watching
+        u64 clock_ = 0;
+        u64 hits_ = 0;
+        u64 misses_ = 0;
+        u64 writebacks_ = 0;
+
+      public:
+        explicit FileStorage(dp::String root, FileStorageConfig config = {}) : root_(std::move(root)), config_(config) {
+            if (config_.page_bytes == 0)
+                config_.page_bytes = 4096;
+            if (config_.cache_pages == 0)
+                config_.cache_pages = 1;
+            pages_.resize(config_.cache_pages);
+            memory_.resize(static_cast<usize>(config_.cache_pages) * config_.page_bytes);
+        }
+
+        FileStorage(const FileStorage &) = delete;
+        FileStorage &operator=(const FileStorage &) = delete;
+
+        ~FileStorage() {
+            for (u32 i = 0; i < files_.size(); ++i) {
+                if (files_[i].fd >= 0)
+                    (void)close(i);
+            }
+            if (watch_fd_ >= 0)
+                ::close(watch_fd_);
+        }
+
+        const dp::String &root() const noexcept { return root_; }
+
+        static bool valid_name(const dp::String &name) noexcept {
+            if (name.empty() || name == "." || name == "..")
+                return false;
+            for (char c : name) {
+                if (c == '/' || c == '\\' || c == '\0')
+                    return false;
+            }
+            return true;
+        }
+
+        // Regular files in the root directory
+        Result<dp::Vector<StoredFile>> list() const {
+            DIR *dir = ::opendir(root_.c_str());
+            if (!dir)
+                return Result<dp::Vector<StoredFile>>::err(Error(ErrorCode::DriverError, "cannot open storage root"));
+            dp::Vector<StoredFile> out;
+            while (dirent *entry = ::readdir(dir)) {
+                if (auto file = stat(entry->d_name))
+                    out.push_back(std::move(*file));
+            }
+            ::closedir(dir);
+            return Result<dp::Vector<StoredFile>>::ok(std::move(out));
+        }
+
+        // One regular file in the root directory, if there is one
+        dp::Optional<StoredFile> stat(const dp::String &name) const {
+            struct stat st {};
+            if (!valid_name(name) || ::stat(path(name).c_str(), &st) != 0 || !S_ISREG(st.st_mode))
+                return dp::nullopt;
+            StoredFile file;
+            file.name = name;
+            file.size_bytes = static_cast<u64>(st.st_size);
+            file.read_only = ::access(path(name).c_str(), W_OK) != 0;
+            return file;
+        }
+
+        Result<StorageSpace> space() const {
+            struct statvfs vfs {};
+            if (::statvfs(root_.empty() ? "." : root_.c_str(), &vfs) != 0)
+                return Result<StorageSpace>::err(Error(ErrorCode::DriverError, "cannot query storage space"));
+            StorageSpace out;
+            out.total_bytes = static_cast<u64>(vfs.f_blocks) * vfs.f_frsize;
+            out.free_bytes = static_cast<u64>(vfs.f_bavail) * vfs.f_frsize;
+            return Result<StorageSpace>::ok(out);
+        }
+
+        // ─── Change notification ────────────────────────────────────────────────
+        // Reports files created, removed, renamed or rewritten in the root by
+        // anyone, this process included (inotify; not available elsewhere).
+        Result<void> watch() {
+#ifdef __linux__
+            if (watch_fd_ >= 0)
+                return {};
+            int fd = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+            if (fd < 0)
+                return Result<void>::err(Error(ErrorCode::DriverError, "inotify unavailable"));
+            u32 mask = IN_CREATE | IN_DELETE | IN_CLOSE_WRITE | IN_MOVED_FROM | IN_MOVED_TO | IN_ATTRIB;
+            if (::inotify_add_watch(fd, root_.empty() ? "." : root_.c_str(), mask) < 0) {
+                ::close(fd);
+                return Result<void>::err(Error(ErrorCode::DriverError, "cannot watch storage root"));
+            }
+            watch_fd_ = fd;
+            return {};
+#else
+            return Result<void>::err(Error(ErrorCode::DriverError, "change notification not supported"));
+#endif
+        }
+
+        bool watching() const noexcept { return watch_fd_ >= 0; }
+
+        // Hands the name of each file changed since the last call to `fn`; never blocks
+        template <typename Fn> usize poll_changes(Fn &&fn) {
+            usize n = 0;
+#ifdef __linux__
+            if (watch_fd_ < 0)
+                return 0;
+            alignas(inotify_event) char buf[4096];
+            ssize_t len;
+            while ((len = ::read(watch_fd_, buf, sizeof(buf))) > 0) {
+                for (ssize_t at = 0; at < len;) {
+                    auto *event = reinterpret_cast<const inotify_event *>(buf + at);
+                    if (event->len > 0) {
+                        fn(dp::String(event->name));
+                        ++n;
+                    }
+                    at += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+                }
+            }
+#else
+            (void)fn;
+#endif
+            return n;
+        }
+
+        // Opens read-write where permitted, read-only otherwise
+        Result<u32> open(const dp::String &name, bool create = false) {
+            if (!valid_name(name))
+                return Result<u32>::err(Error::invalid_state("invalid file name"));
+            dp::String full = path(name);
+            int fd = ::open(full.c_str(), O_RDWR | O_CLOEXEC | (create ? O_CREAT : 0), 0644);
+            bool writable = fd >= 0;
+            if (fd < 0 && (errno == EACCES || errno == EROFS))
+                fd = ::open(full.c_str(), O_RDONLY | O_CLOEXEC);
+            if (fd < 0)
+                return Result<u32>::err(Error::invalid_state("file not found"));
+            struct stat st {};
+            if (::fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+                ::close(fd);
+                return Result<u32>::err(Error::invalid_state("not a regular file"));
+            }
+
+            u32 handle = 0;
+            while (handle < files_.size() && files_[handle].fd >= 0)
+                ++handle;
+            if (handle == files_.size())
+                files_.push_back({});
+            files_[handle] = {fd, static_cast<u64>(st.st_size), writable};
+            return Result<u32>::ok(handle);
+        }
+
+        // Writes back the file's pages and closes it
+        Result<void> close(u32 handle) {
+            if (!is_open(handle))
+                return Result<void>::err(Error::invalid_state("invalid storage handle"));
+            auto flushed = flush(handle);
+            for (u32 slot = 0; slot < pages_.size(); ++slot) {
+                if (pages_[slot].used && file_of(pages_[slot].key) == handle)
+                    release(slot);
+            }
+            ::close(files_[handle].fd);
+            files_[handle] = {};
+            return flushed;
+        }
+
+        Result<void> flush(u32 handle) {
+            if (!is_open(handle))
+                return Result<void>::err(Error::invalid_state("invalid storage handle"));
+            for (u32 slot = 0; slot < pages_.size(); ++slot) {
+                if (pages_[slot].used && pages_[slot].dirty && file_of(pages_[slot].key) == handle) {
+                    auto result = write_back(slot);
+                    if (!result.is_ok())
+                        return result;
+                }
+            }
+            return {};
+        }
+
+        Result<void> remove(const dp::String &name) {
+            if (!valid_name(name) || ::unlink(path(name).c_str()) != 0)
+                return Result<void>::err(Error::invalid_state("cannot remove file"));
+            return {};
+        }
+
+        bool is_open(u32 handle) const noexcept { return handle < files_.size() && files_[handle].fd >= 0; }
+        bool writable(u32 handle) const noexcept { return is_open(handle) && files_[handle].writable; }
+        u64 size(u32 handle) const noexcept { return is_open(handle) ? files_[handle].size : 0; }
+        // For pread() on another thread; bypasses the cache, so it only sees written pages once flushed
+        int descriptor(u32 handle) const noexcept { return is_open(handle) ? files_[handle].fd : -1; }
+
+        // Up to `len` bytes from `offset`; fewer at the end of the file
+        Result<usize> read(u32 handle, u64 offset, u8 *out, usize len) {
+            if (!is_open(handle))
+                return Result<usize>::err(Error::invalid_state("invalid storage handle"));
+            u64 size = files_[handle].size;
+            if (offset >= size)
+                return Result<usize>::ok(0);
+            if (len > size - offset)
+                len = static_cast<usize>(size - offset);
+
+            usize done = 0;
+            while (done < len) {
+                u64 pos = offset + done;
+                u64 page = pos / config_.page_bytes;
+                usize in_page = static_cast<usize>(pos % config_.page_bytes);
+                usize n = config_.page_bytes - in_page;
+                if (n > len - done)
+                    n = len - done;
+                auto slot = acquire(handle, page, true);
+                if (!slot.is_ok())
+                    return Result<usize>::err(slot.error());
+                std::memcpy(out + done, page_data(slot.value()) + in_page, n);
+                done += n;
+            }
+            return Result<usize>::ok(done);
+        }
+
+        // Writes into the cache; the file grows when writing past its end
+        Result<usize> write(u32 handle, u64 offset, const u8 *data, usize len) {
+            if (!is_open(handle))
+                return Result<usize>::err(Error::invalid_state("invalid storage handle"));
+            if (!files_[handle].writable)
+                return Result<usize>::err(Error::invalid_state("file is read-only"));
+
+            usize done = 0;
+            while (done < len) {
+                u64 pos = offset + done;
+                u64 page = pos / config_.page_bytes;
+                usize in_page = static_cast<usize>(pos % config_.page_bytes);
+                usize n = config_.page_bytes - in_page;
+                if (n > len - done)
+                    n = len - done;
+                // A page written whole needs nothing from the disk
+                bool load = n < config_.page_bytes && page * config_.page_bytes < files_[handle].size;
+                auto slot = acquire(handle, page, load);
+                if (!slot.is_ok())
+                    return Result<usize>::err(slot.error());
+                std::memcpy(page_data(slot.value()) + in_page, data + done, n);
+                pages_[slot.value()].dirty = true;
+                done += n;
+                if (pos + n > files_[handle].size)
+                    files_[handle].size = pos + n;
+            }
+            return Result<usize>::ok(done);
+        }
+
+        // ─── Cache statistics ───────────────────────────────────────────────────
+        u64 hits() const noexcept { return hits_; }
+        u64 misses() const noexcept { return misses_; }
+        u64 writebacks() const noexcept { return writebacks_; } // Dirty pages written to disk
+        usize cache_bytes() const noexcept { return memory_.size(); }
+
+      private:
+        static constexpr u64 key(u32 handle, u64 page) noexcept { return (static_cast<u64>(handle) << 40) | page; }
+        static constexpr u32 file_of(u64 key) noexcept { return static_cast<u32>(key >> 40); }
+        static constexpr u64 page_of(u64 key) noexcept { return key & ((u64(1) << 40) - 1); }
+
+        dp::String path(const dp::String &name) const { return root_.empty() ? name : root_ + "/" + name; }
+
+        u8 *page_data(u32 slot) noexcept { return memory_.data() + static_cast<usize>(slot) * config_.page_bytes; }
+
+        // The cache slot holding (file, page), filled from disk when `load`
+        Result<u32> acquire(u32 handle, u64 page, bool load) {
+            u64 k = key(handle, page);
+            auto it = page_slot_.find(k);
+            if (it != page_slot_.end()) {
+                ++hits_;
+                pages_[it->second].last_use = ++clock_;
+                return Result<u32>::ok(it->second);
+            }
+            ++misses_;
+
+            // A free slot, else the least recently used one
+            u32 slot = 0;
+            for (u32 i = 0; i < pages_.size(); ++i) {
+                if (!pages_[i].used) {
+                    slot = i;
+                    break;
+                }
+                if (pages_[i].last_use < pages_[slot].last_use)
+                    slot = i;
+            }
+            if (pages_[slot].used) {
+                if (pages_[slot].dirty) {
+                    auto result = write_back(slot);
+                    if (!result.is_ok())
+                        return Result<u32>::err(result.error());
+                }
+                release(slot);
+            }
+
+            u8 *buf = page_data(slot);
+            usize got = 0;
+            if (load) {
+                ssize_t n = ::pread(files_[handle].fd, buf, config_.page_bytes,
+                                    static_cast<off_t>(page * config_.page_bytes));
+                if (n < 0)
+                    return Result<u32>::err(Error(ErrorCode::DriverError, "storage read failed"));
+                got = static_cast<usize>(n);
+            }
+            std::memset(buf + got, 0, config_.page_bytes - got);
+
+            pages_[slot] = {k, ++clock_, true, false};
+            page_slot_[k] = slot;
+            return Result<u32>::ok(slot);
+        }
+
+        // Writes the page's bytes that lie inside the file
+        Result<void> write_back(u32 slot) {
+            Page &p = pages_[slot];
+            const OpenFile &file = files_[file_of(p.key)];
+            u64 start = page_of(p.key) * config_.page_bytes;
+            usize len = config_.page_bytes;
+            if (start + len > file.size)
+                len = file.size > start ? static_cast<usize>(file.size - start) : 0;
+            const u8 *buf = page_data(slot);
+            usize done = 0;
+            while (done < len) {
+                ssize_t n = ::pwrite(file.fd, buf + done, len - done, static_cast<off_t>(start + done));
+                if (n <= 0) {
+                    echo::category("isobus.fs.storage").error("write-back failed: ", std::strerror(errno));
+                    return Result<void>::err(Error(ErrorCode::DriverError, "storage write failed"));
+                }
+                done += static_cast<usize>(n);
+            }
+            p.dirty = false;
+            ++writebacks_;
+            return {};
+        }
+
+        void release(u32 slot) {
+            page_slot_.erase(pages_[slot].key);
+            pages_[slot] = {};
+        }
+    };
+
+} // namespace agrobus::isobus::fs
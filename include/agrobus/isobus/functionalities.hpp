@@ -38,6 +38,8 @@ namespace agrobus::isobus {
         FileServerClient = 18
     };
 
+    inline constexpr usize FUNCTIONALITY_COUNT = 19;
+
     enum class MinimumControlFunctionOptions : u8 {
         NoOptions = 0x00,
         Type1ECUInternalWeakTermination = 0x01,
@@ -134,6 +136,14 @@ namespace agrobus::isobus {
         InternalCF *cf_;
         dp::Vector<FunctionalityData> supported_;
 
+        // Position of each functionality in supported_, NOT_SUPPORTED if absent
+        static constexpr u8 NOT_SUPPORTED = 0xFF;
+        dp::Array<u8, FUNCTIONALITY_COUNT> index_;
+
+        // Encoded PGN 0xFC8E payload, rebuilt on the first request after a change
+        mutable dp::Vector<u8> encoded_;
+        mutable bool dirty_ = true;
+
         // Separate option storage for complex options
         u8 min_cf_options_ = 0;
         u8 aux_o_inputs_options_ = 0;
@@ -159,6 +169,7 @@ namespace agrobus::isobus {
 
       public:
         ControlFunctionFunctionalities(IsoNet &net, InternalCF *cf) : net_(net), cf_(cf) {
+            index_.fill(NOT_SUPPORTED);
             // Always support MinimumControlFunction
             set_functionality_is_supported(Functionality::MinimumControlFunction, 1, true);
         }
@@ -173,44 +184,44 @@ namespace agrobus::isobus {
 
         // ─── Functionality management ────────────────────────────────────────────
         void set_functionality_is_supported(Functionality functionality, u8 generation, bool is_supported) {
+            auto slot = static_cast<usize>(functionality);
+            if (slot >= FUNCTIONALITY_COUNT)
+                return;
+            u8 pos = index_[slot];
             if (is_supported) {
-                for (auto &f : supported_) {
-                    if (f.functionality == functionality) {
-                        f.generation = generation;
-                        return;
+                if (pos != NOT_SUPPORTED) {
+                    if (supported_[pos].generation != generation) {
+                        supported_[pos].generation = generation;
+                        invalidate();
                     }
+                    return;
                 }
+                index_[slot] = static_cast<u8>(supported_.size());
                 supported_.push_back({functionality, generation, {}});
+                invalidate();
                 echo::category("isobus.protocol.functionalities")
                     .debug("Functionality added: ", static_cast<u8>(functionality), " gen=", generation);
-            } else {
-                for (auto it = supported_.begin(); it != supported_.end(); ++it) {
-                    if (it->functionality == functionality) {
-                        supported_.erase(it);
-                        return;
-                    }
-                }
+            } else if (pos != NOT_SUPPORTED) {
+                supported_.erase(supported_.begin() + pos);
+                index_[slot] = NOT_SUPPORTED;
+                for (usize i = pos; i < supported_.size(); ++i)
+                    index_[static_cast<usize>(supported_[i].functionality)] = static_cast<u8>(i);
+                invalidate();
             }
         }
 
         bool get_functionality_is_supported(Functionality functionality) const {
-            for (const auto &f : supported_) {
-                if (f.functionality == functionality)
-                    return true;
-            }
-            return false;
+            return find(functionality) != nullptr;
         }
 
         u8 get_functionality_generation(Functionality functionality) const {
-            for (const auto &f : supported_) {
-                if (f.functionality == functionality)
-                    return f.generation;
-            }
-            return 0;
+            const auto *f = find(functionality);
+            return f ? f->generation : 0;
         }
 
         // ─── Minimum CF options ──────────────────────────────────────────────────
         void set_minimum_control_function_option_state(MinimumControlFunctionOptions option, bool state) {
+            invalidate();
             if (state)
                 min_cf_options_ |= static_cast<u8>(option);
             else
@@ -223,6 +234,7 @@ namespace agrobus::isobus {
 
         // ─── AUX-O options ───────────────────────────────────────────────────────
         void set_aux_O_inputs_option_state(AuxOOptions option, bool state) {
+            invalidate();
             if (state)
                 aux_o_inputs_options_ |= static_cast<u8>(option);
             else
@@ -234,6 +246,7 @@ namespace agrobus::isobus {
         }
 
         void set_aux_O_functions_option_state(AuxOOptions option, bool state) {
+            invalidate();
             if (state)
                 aux_o_functions_options_ |= static_cast<u8>(option);
             else
@@ -246,6 +259,7 @@ namespace agrobus::isobus {
 
         // ─── AUX-N options ───────────────────────────────────────────────────────
         void set_aux_N_inputs_option_state(AuxNOptions option, bool state) {
+            invalidate();
             if (state)
                 aux_n_inputs_options_ |= static_cast<u16>(option);
             else
@@ -257,6 +271,7 @@ namespace agrobus::isobus {
         }
 
         void set_aux_N_functions_option_state(AuxNOptions option, bool state) {
+            invalidate();
             if (state)
                 aux_n_functions_options_ |= static_cast<u16>(option);
             else
@@ -269,6 +284,7 @@ namespace agrobus::isobus {
 
         // ─── TC GEO options ──────────────────────────────────────────────────────
         void set_task_controller_geo_server_option_state(TaskControllerGeoServerOptions option, bool state) {
+            invalidate();
             if (state)
                 tc_geo_server_options_ |= static_cast<u8>(option);
             else
@@ -280,6 +296,7 @@ namespace agrobus::isobus {
         }
 
         void set_task_controller_geo_client_option(u8 number_of_control_channels) {
+            invalidate();
             tc_geo_client_channels_ = number_of_control_channels;
         }
 
@@ -287,6 +304,7 @@ namespace agrobus::isobus {
 
         // ─── TC Section Control options ──────────────────────────────────────────
         void set_task_controller_section_control_server_option_state(u8 num_booms, u8 num_sections) {
+            invalidate();
             tc_sc_server_booms_ = num_booms;
             tc_sc_server_sections_ = num_sections;
         }
@@ -297,6 +315,7 @@ namespace agrobus::isobus {
         }
 
         void set_task_controller_section_control_client_option_state(u8 num_booms, u8 num_sections) {
+            invalidate();
             tc_sc_client_booms_ = num_booms;
             tc_sc_client_sections_ = num_sections;
         }
@@ -308,6 +327,7 @@ namespace agrobus::isobus {
 
         // ─── Basic Tractor ECU options ───────────────────────────────────────────
         void set_basic_tractor_ECU_server_option_state(BasicTractorECUOptions option, bool state) {
+            invalidate();
             if (state)
                 basic_tecu_server_options_ |= static_cast<u8>(option);
             else
@@ -319,6 +339,7 @@ namespace agrobus::isobus {
         }
 
         void set_basic_tractor_ECU_implement_client_option_state(BasicTractorECUOptions option, bool state) {
+            invalidate();
             if (state)
                 basic_tecu_client_options_ |= static_cast<u8>(option);
             else
@@ -332,6 +353,7 @@ namespace agrobus::isobus {
         // ─── TIM options ─────────────────────────────────────────────────────────
         void set_tractor_implement_management_server_option_state(TractorImplementManagementOptions option,
                                                                   bool state) {
+            invalidate();
             u8 bit = static_cast<u8>(option);
             u8 byte_idx = bit / 8;
             u8 bit_idx = bit % 8;
@@ -354,6 +376,7 @@ namespace agrobus::isobus {
 
         void set_tractor_implement_management_server_aux_valve_option(u8 valve_index, bool state_supported,
                                                                       bool flow_supported) {
+            invalidate();
             if (valve_index >= 32)
                 return;
             u8 byte_idx = valve_index / 4;
@@ -383,6 +406,7 @@ namespace agrobus::isobus {
 
         void set_tractor_implement_management_client_option_state(TractorImplementManagementOptions option,
                                                                   bool state) {
+            invalidate();
             u8 bit = static_cast<u8>(option);
             u8 byte_idx = bit / 8;
             u8 bit_idx = bit % 8;
@@ -405,6 +429,7 @@ namespace agrobus::isobus {
 
         void set_tractor_implement_management_client_aux_valve_option(u8 valve_index, bool state_supported,
                                                                       bool flow_supported) {
+            invalidate();
             if (valve_index >= 32)
                 return;
             u8 byte_idx = valve_index / 4;
@@ -529,24 +554,25 @@ namespace agrobus::isobus {
         }
 
         // ─── Serialization ───────────────────────────────────────────────────────
-        dp::Vector<u8> serialize() const {
-            dp::Vector<u8> data;
-            // Byte 0: Number of functionalities
-            data.push_back(static_cast<u8>(supported_.size()));
-
-            for (const auto &func : supported_) {
-                // Functionality byte
-                data.push_back(static_cast<u8>(func.functionality));
-                // Generation byte
-                data.push_back(func.generation);
-                // Option bytes (functionality-dependent)
-                auto opts = get_option_bytes(func.functionality);
-                for (auto b : opts)
-                    data.push_back(b);
+        // Encoded payload, cached until the next set_* call changes it
+        const dp::Vector<u8> &encoded() const {
+            if (dirty_) {
+                encoded_.clear();
+                // Byte 0: Number of functionalities
+                encoded_.push_back(static_cast<u8>(supported_.size()));
+                for (const auto &func : supported_) {
+                    encoded_.push_back(static_cast<u8>(func.functionality));
+                    encoded_.push_back(func.generation);
+                    // Option bytes (functionality-dependent)
+                    append_option_bytes(encoded_, func.functionality);
+                }
+                dirty_ = false;
             }
-            return data;
+            return encoded_;
         }
 
+        dp::Vector<u8> serialize() const { return encoded(); }
+
         const dp::Vector<FunctionalityData> &supported_functionalities() const { return supported_; }
 
         void update(u32 /*elapsed_ms*/) {
@@ -557,8 +583,16 @@ namespace agrobus::isobus {
         Event<const dp::Vector<u8> &> on_functionalities_request;
 
       private:
-        dp::Vector<u8> get_option_bytes(Functionality func) const {
-            dp::Vector<u8> opts;
+        void invalidate() noexcept { dirty_ = true; }
+
+        const FunctionalityData *find(Functionality functionality) const {
+            auto slot = static_cast<usize>(functionality);
+            if (slot >= FUNCTIONALITY_COUNT || index_[slot] == NOT_SUPPORTED)
+                return nullptr;
+            return &supported_[index_[slot]];
+        }
+
+        void append_option_bytes(dp::Vector<u8> &opts, Functionality func) const {
             switch (func) {
             case Functionality::MinimumControlFunction:
                 opts.push_back(min_cf_options_);
@@ -614,7 +648,6 @@ namespace agrobus::isobus {
                 opts.push_back(0x00);
                 break;
             }
-            return opts;
         }
 
         void handle_request(const Message &msg) {
@@ -629,7 +662,7 @@ namespace agrobus::isobus {
 
             echo::category("isobus.protocol.functionalities").debug("Functionalities request from ", msg.source);
 
-            auto data = serialize();
+            const auto &data = encoded();
             on_functionalities_request.emit(data);
             net_.send(PGN_CF_FUNCTIONALITIES, data, cf_, nullptr, Priority::Default);
         }
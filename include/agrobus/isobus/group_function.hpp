@@ -6,10 +6,12 @@
 #include <agrobus/net/internal_cf.hpp>
 #include <agrobus/net/message.hpp>
 #include <agrobus/net/network_manager.hpp>
+#include <agrobus/net/pgn_dispatch.hpp>
 #include <agrobus/net/types.hpp>
 #include <datapod/datapod.hpp>
 #include <echo/echo.hpp>
 #include <functional>
+#include <memory>
 
 namespace agrobus::isobus {
     using namespace agrobus::net;
@@ -31,19 +33,25 @@ namespace agrobus::isobus {
         GroupFunctionType function_type = GroupFunctionType::Request;
         dp::Vector<u8> parameters; // Function-specific parameter data
 
+        // Single frame padded with 0xFF; more than 4 parameter bytes go multi-packet
         dp::Vector<u8> encode() const {
-            dp::Vector<u8> data(8, 0xFF);
-            data[0] = static_cast<u8>(function_type);
-            data[1] = static_cast<u8>(target_pgn & 0xFF);
-            data[2] = static_cast<u8>((target_pgn >> 8) & 0xFF);
-            data[3] = static_cast<u8>((target_pgn >> 16) & 0xFF);
-            for (usize i = 0; i < parameters.size() && i < 4; ++i) {
-                data[4 + i] = parameters[i];
-            }
+            dp::Vector<u8> data;
+            encode_into(data, function_type, target_pgn, parameters);
             return data;
         }
 
-        static GroupFunctionMsg decode(const dp::Vector<u8> &data) {
+        static void encode_into(dp::Vector<u8> &data, GroupFunctionType type, PGN pgn, DataSpan params) {
+            data.assign(params.size() > 4 ? 4 + params.size() : 8, 0xFF);
+            data[0] = static_cast<u8>(type);
+            data[1] = static_cast<u8>(pgn & 0xFF);
+            data[2] = static_cast<u8>((pgn >> 8) & 0xFF);
+            data[3] = static_cast<u8>((pgn >> 16) & 0xFF);
+            for (usize i = 0; i < params.size(); ++i) {
+                data[4 + i] = params[i];
+            }
+        }
+
+        static GroupFunctionMsg decode(DataSpan data) {
             GroupFunctionMsg msg;
             if (data.size() >= 4) {
                 msg.function_type = static_cast<GroupFunctionType>(data[0]);
@@ -57,6 +65,96 @@ namespace agrobus::isobus {
         }
     };
 
+    // ─── Batched parameters ──────────────────────────────────────────────────────
+    // A multi-parameter read or write carries a count byte followed by one
+    // entry per parameter: its index and its value (u32 LE; 0xFFFFFFFF in a
+    // read request). One command sets, or one request reads, all of them.
+    struct GroupFunctionParam {
+        u8 index = 0;
+        u32 value = 0xFFFFFFFF;
+    };
+
+    class GroupFunctionParams {
+        DataSpan data_;
+
+      public:
+        static constexpr usize ENTRY_BYTES = 5;
+
+        GroupFunctionParams() = default;
+        explicit GroupFunctionParams(DataSpan data) : data_(data) {}
+
+        // Entries present, never more than the bytes hold
+        usize size() const noexcept {
+            if (data_.empty())
+                return 0;
+            usize fit = (data_.size() - 1) / ENTRY_BYTES;
+            return data_[0] < fit ? data_[0] : fit;
+        }
+        bool empty() const noexcept { return size() == 0; }
+
+        GroupFunctionParam operator[](usize i) const noexcept {
+            usize offset = 1 + i * ENTRY_BYTES;
+            return {data_[offset], data_.get_u32_le(offset + 1)};
+        }
+
+        template <typename Fn> void for_each(Fn &&fn) const {
+            for (usize i = 0, n = size(); i < n; ++i)
+                fn((*this)[i]);
+        }
+
+        static dp::Vector<u8> encode(const dp::Vector<GroupFunctionParam> &params) {
+            dp::Vector<u8> data;
+            encode_into(data, params);
+            return data;
+        }
+
+        static void encode_into(dp::Vector<u8> &data, const dp::Vector<GroupFunctionParam> &params) {
+            usize count = params.size() < 0xFF ? params.size() : 0xFE;
+            data.clear();
+            data.push_back(static_cast<u8>(count));
+            for (usize i = 0; i < count; ++i) {
+                data.push_back(params[i].index);
+                for (u8 shift = 0; shift < 32; shift += 8)
+                    data.push_back(static_cast<u8>((params[i].value >> shift) & 0xFF));
+            }
+        }
+    };
+
+    // ─── Non-owning group function view ──────────────────────────────────────────
+    // Reads a received group function in place; `pgn` is the target PGN and
+    // the routing key. `parameters` is the whole tail after the header, pad
+    // bytes included; decode() trims it at the first 0xFF like
+    // GroupFunctionMsg::decode. Only valid while the message it points into is.
+    struct GroupFunctionView {
+        PGN pgn = 0;
+        GroupFunctionType function_type = GroupFunctionType::Reserved;
+        DataSpan parameters;
+        Address source = NULL_ADDRESS;
+
+        GroupFunctionView() = default;
+        explicit GroupFunctionView(DataSpan data, Address src = NULL_ADDRESS) : source(src) {
+            if (data.size() >= 4) {
+                function_type = static_cast<GroupFunctionType>(data[0]);
+                pgn = static_cast<PGN>(data[1]) | (static_cast<PGN>(data[2]) << 8) | (static_cast<PGN>(data[3]) << 16);
+                parameters = data.subspan(4);
+            }
+        }
+
+        bool valid() const noexcept { return function_type != GroupFunctionType::Reserved; }
+
+        GroupFunctionParams params() const noexcept { return GroupFunctionParams(parameters); }
+
+        GroupFunctionMsg decode() const {
+            GroupFunctionMsg msg;
+            msg.target_pgn = pgn;
+            msg.function_type = function_type;
+            for (usize i = 0; i < parameters.size() && parameters[i] != 0xFF; ++i) {
+                msg.parameters.push_back(parameters[i]);
+            }
+            return msg;
+        }
+    };
+
     // Group function error codes for acknowledgment
     enum class GroupFunctionError : u8 {
         NoError = 0,
@@ -68,12 +166,37 @@ namespace agrobus::isobus {
     };
 
     // ─── Group Function Handler ──────────────────────────────────────────────────
+    // Incoming messages are read through a GroupFunctionView and routed by
+    // target PGN through a compiled dispatch table, so a message whose PGN has
+    // a view or batch handler is served without building a GroupFunctionMsg.
+    // One handler per PGN: registering again replaces it, whatever its kind.
     class GroupFunctionHandler {
+      public:
+        using HandlerFn = std::function<Result<dp::Vector<u8>>(const GroupFunctionMsg &)>;
+        using ViewHandlerFn = std::function<void(const GroupFunctionView &)>;
+        // Applies every entry of a Command, or appends the value of every entry
+        // of a Request to `out`, in one call
+        using BatchHandlerFn = std::function<GroupFunctionError(GroupFunctionType, const GroupFunctionParams &,
+                                                                dp::Vector<GroupFunctionParam> &out)>;
+
+      private:
+        struct Route {
+            PGN pgn = 0;
+            HandlerFn handler;
+            ViewHandlerFn view_handler;
+            BatchHandlerFn batch_handler;
+        };
+
         IsoNet &net_;
         InternalCF *cf_;
 
-        using HandlerFn = std::function<Result<dp::Vector<u8>>(const GroupFunctionMsg &)>;
-        dp::Map<PGN, HandlerFn> handlers_;
+        dp::Vector<std::unique_ptr<Route>> routes_; // Stable addresses for the dispatch table
+        BasicPGNDispatchTable<GroupFunctionView> dispatch_;
+
+        // Reused across messages so replies do not allocate once warm
+        dp::Vector<GroupFunctionParam> batch_out_;
+        dp::Vector<u8> batch_bytes_;
+        dp::Vector<u8> reply_bytes_;
 
       public:
         GroupFunctionHandler(IsoNet &net, InternalCF *cf) : net_(net), cf_(cf) {}
@@ -91,10 +214,32 @@ namespace agrobus::isobus {
             if (!handler) {
                 return Result<void>::err(Error::invalid_state("null handler"));
             }
-            handlers_[pgn] = std::move(handler);
+            route(pgn) = Route{pgn, std::move(handler), {}, {}};
             return {};
         }
 
+        // Zero-copy variant: the view is only valid during the call; answer with reply()
+        Result<void> register_view_handler(PGN pgn, ViewHandlerFn handler) {
+            if (!handler) {
+                return Result<void>::err(Error::invalid_state("null handler"));
+            }
+            route(pgn) = Route{pgn, {}, std::move(handler), {}};
+            return {};
+        }
+
+        // Multi-parameter read/write: a Request is answered with a ReadReply of
+        // the values the handler appended, a Command with an Acknowledge
+        // carrying the returned error code
+        Result<void> register_batch_handler(PGN pgn, BatchHandlerFn handler) {
+            if (!handler) {
+                return Result<void>::err(Error::invalid_state("null handler"));
+            }
+            route(pgn) = Route{pgn, {}, {}, std::move(handler)};
+            return {};
+        }
+
+        bool has_handler(PGN pgn) { return dispatch_.has_handlers(pgn); }
+
         // Send a group function request
         Result<void> send_request(PGN target_pgn, const dp::Vector<u8> &params = {},
                                   Address destination = BROADCAST_ADDRESS) {
@@ -115,37 +260,92 @@ namespace agrobus::isobus {
             return send_group_function(msg, destination);
         }
 
+        // Read several parameters of a PGN with one request (values are ignored)
+        Result<void> send_batch_request(PGN target_pgn, const dp::Vector<GroupFunctionParam> &params,
+                                        Address destination = BROADCAST_ADDRESS) {
+            GroupFunctionMsg msg;
+            msg.function_type = GroupFunctionType::Request;
+            msg.target_pgn = target_pgn;
+            msg.parameters = GroupFunctionParams::encode(params);
+            return send_group_function(msg, destination);
+        }
+
+        // Write several parameters of a PGN with one command
+        Result<void> send_batch_command(PGN target_pgn, const dp::Vector<GroupFunctionParam> &params,
+                                        Address destination = BROADCAST_ADDRESS) {
+            GroupFunctionMsg msg;
+            msg.function_type = GroupFunctionType::Command;
+            msg.target_pgn = target_pgn;
+            msg.parameters = GroupFunctionParams::encode(params);
+            return send_group_function(msg, destination);
+        }
+
         // Process an incoming group function message
-        void handle_message(const Message &msg) {
+        void handle_message(const Message &msg) { handle_view(MessageView(msg)); }
+
+        void handle_view(const MessageView &msg) {
             if (msg.data.size() < 4)
                 return;
 
-            auto gf = GroupFunctionMsg::decode(msg.data);
+            GroupFunctionView gf(msg.data, msg.source);
             echo::category("isobus.protocol.group_fn")
-                .debug("received: type=", static_cast<u8>(gf.function_type), " pgn=", gf.target_pgn,
-                       " from=", msg.source);
-
-            on_group_function.emit(gf, msg.source);
-
-            auto it = handlers_.find(gf.target_pgn);
-            if (it != handlers_.end()) {
-                auto result = it->second(gf);
-                if (result.is_ok() && !result.value().empty()) {
-                    ControlFunction dest_cf;
-                    dest_cf.address = msg.source;
-                    GroupFunctionMsg reply;
-                    reply.function_type = GroupFunctionType::Acknowledge;
-                    reply.target_pgn = gf.target_pgn;
-                    reply.parameters = result.value();
-                    net_.send(PGN_ACKNOWLEDGMENT, reply.encode(), cf_, &dest_cf);
-                }
-            }
+                .debug("received: type=", static_cast<u8>(gf.function_type), " pgn=", gf.pgn, " from=", msg.source);
+
+            if (on_group_function.count() > 0)
+                on_group_function.emit(gf.decode(), msg.source);
+
+            dispatch_.dispatch(gf);
+        }
+
+        // Acknowledge `gf` back to its sender with `params`
+        Result<void> reply(const GroupFunctionView &gf, DataSpan params) {
+            return send_reply(gf.source, GroupFunctionType::Acknowledge, gf.pgn, params);
         }
 
         // Events
         Event<GroupFunctionMsg, Address> on_group_function;
 
       private:
+        // The route for `pgn`, created and added to the dispatch table on first use
+        Route &route(PGN pgn) {
+            for (auto &r : routes_) {
+                if (r->pgn == pgn)
+                    return *r;
+            }
+            routes_.push_back(std::make_unique<Route>());
+            Route *r = routes_.back().get();
+            r->pgn = pgn;
+            dispatch_.add(pgn, [this, r](const GroupFunctionView &gf) { invoke(*r, gf); });
+            return *r;
+        }
+
+        void invoke(Route &r, const GroupFunctionView &gf) {
+            if (r.view_handler) {
+                r.view_handler(gf);
+            } else if (r.batch_handler) {
+                batch_out_.clear();
+                GroupFunctionError err = r.batch_handler(gf.function_type, gf.params(), batch_out_);
+                if (gf.function_type == GroupFunctionType::Request && err == GroupFunctionError::NoError) {
+                    GroupFunctionParams::encode_into(batch_bytes_, batch_out_);
+                    send_reply(gf.source, GroupFunctionType::ReadReply, gf.pgn, batch_bytes_);
+                } else {
+                    u8 code = static_cast<u8>(err);
+                    send_reply(gf.source, GroupFunctionType::Acknowledge, gf.pgn, DataSpan(&code, 1));
+                }
+            } else if (r.handler) {
+                auto result = r.handler(gf.decode());
+                if (result.is_ok() && !result.value().empty())
+                    reply(gf, result.value());
+            }
+        }
+
+        Result<void> send_reply(Address destination, GroupFunctionType type, PGN pgn, DataSpan params) {
+            GroupFunctionMsg::encode_into(reply_bytes_, type, pgn, params);
+            ControlFunction dest_cf;
+            dest_cf.address = destination;
+            return net_.send(PGN_ACKNOWLEDGMENT, reply_bytes_, cf_, &dest_cf);
+        }
+
         Result<void> send_group_function(const GroupFunctionMsg &msg, Address destination) {
             if (destination == BROADCAST_ADDRESS) {
                 return net_.send(PGN_ACKNOWLEDGMENT, msg.encode(), cf_, nullptr, Priority::Default);
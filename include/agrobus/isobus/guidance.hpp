@@ -4,6 +4,7 @@
 #include <agrobus/net/event.hpp>
 #include <agrobus/net/message.hpp>
 #include <agrobus/net/network_manager.hpp>
+#include <agrobus/net/rt_channel.hpp>
 #include <agrobus/net/types.hpp>
 #include <datapod/datapod.hpp>
 #include <echo/echo.hpp>
@@ -42,10 +43,12 @@ namespace agrobus::isobus {
         GuidanceConfig config_;
         dp::Optional<GuidanceData> latest_machine_;
         dp::Optional<GuidanceData> latest_system_;
+        RealtimeChannel system_channel_;
 
       public:
         GuidanceInterface(IsoNet &net, InternalCF *cf, GuidanceConfig config = {})
-            : net_(net), cf_(cf), config_(config) {}
+            : net_(net), cf_(cf), config_(config),
+              system_channel_(net, cf, PGN_GUIDANCE_SYSTEM, Priority::AboveNormal) {}
 
         Result<void> initialize() {
             if (!cf_) {
@@ -68,23 +71,38 @@ namespace agrobus::isobus {
         Result<void> send_system_command(const GuidanceData &gd) {
             echo::category("isobus.guidance").debug("sending system command");
             dp::Vector<u8> data(8, 0xFF);
-            if (gd.curvature) {
-                // Curvature: 0.25 km^-1 per bit, offset -8032
-                i16 raw = static_cast<i16>((*gd.curvature * 1000.0) / 0.25 + 8032);
-                data[0] = static_cast<u8>(raw & 0xFF);
-                data[1] = static_cast<u8>((raw >> 8) & 0xFF);
-            }
-            if (gd.status) {
-                data[2] = *gd.status;
-            }
+            encode_into(gd, data.data());
             return net_.send(PGN_GUIDANCE_SYSTEM, data, cf_, nullptr, Priority::AboveNormal);
         }
 
+        // Closed-loop path for the system command: pre-encoded frame written
+        // straight to the bus, with send confirmation and jitter statistics
+        // on system_channel()
+        Result<void> send_system_command_realtime(const GuidanceData &gd) {
+            encode_into(gd, system_channel_.payload());
+            return system_channel_.send();
+        }
+
+        RealtimeChannel &system_channel() noexcept { return system_channel_; }
+
         // Send guidance machine info (from implement)
         Result<void> send_machine_info(const GuidanceData &gd) {
             echo::category("isobus.guidance").debug("sending machine info");
             dp::Vector<u8> data(8, 0xFF);
+            encode_into(gd, data.data());
+            return net_.send(PGN_GUIDANCE_MACHINE, data, cf_, nullptr, Priority::AboveNormal);
+        }
+
+        Event<const GuidanceData &> on_guidance_machine;
+        Event<const GuidanceData &> on_guidance_system;
+
+      private:
+        // 8 bytes; fields without a value stay 0xFF
+        static void encode_into(const GuidanceData &gd, u8 *data) noexcept {
+            for (u8 i = 0; i < 8; ++i)
+                data[i] = 0xFF;
             if (gd.curvature) {
+                // Curvature: 0.25 km^-1 per bit, offset -8032
                 i16 raw = static_cast<i16>((*gd.curvature * 1000.0) / 0.25 + 8032);
                 data[0] = static_cast<u8>(raw & 0xFF);
                 data[1] = static_cast<u8>((raw >> 8) & 0xFF);
@@ -92,13 +110,8 @@ namespace agrobus::isobus {
             if (gd.status) {
                 data[2] = *gd.status;
             }
-            return net_.send(PGN_GUIDANCE_MACHINE, data, cf_, nullptr, Priority::AboveNormal);
         }
 
-        Event<const GuidanceData &> on_guidance_machine;
-        Event<const GuidanceData &> on_guidance_system;
-
-      private:
         void handle_guidance_machine(const Message &msg) {
             echo::category("isobus.guidance").trace("guidance data received");
             auto gd = parse_guidance(msg);
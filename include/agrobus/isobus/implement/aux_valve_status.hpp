@@ -6,6 +6,7 @@
 #include <agrobus/net/internal_cf.hpp>
 #include <agrobus/net/message.hpp>
 #include <agrobus/net/network_manager.hpp>
+#include <agrobus/net/pgn_codec.hpp>
 #include <datapod/datapod.hpp>
 #include <echo/echo.hpp>
 
@@ -50,30 +51,17 @@ namespace agrobus::isobus::implement {
         f64 extend_flow() const { return extend_flow_percent == 0xFF ? 0.0 : extend_flow_percent * 0.4; }
         f64 retract_flow() const { return retract_flow_percent == 0xFF ? 0.0 : retract_flow_percent * 0.4; }
 
-        dp::Vector<u8> encode() const {
-            dp::Vector<u8> data(8, 0xFF);
-            // Byte 0: Extend flow percent
-            data[0] = extend_flow_percent;
-            // Byte 1: Retract flow percent
-            data[1] = retract_flow_percent;
-            // Byte 2: state (bits 0-1) | limit_status (bits 2-4) | fail_safe (bits 5-6) | reserved (bit 7)
-            data[2] = static_cast<u8>((static_cast<u8>(state) & 0x03) | ((static_cast<u8>(limit_status) & 0x07) << 2) |
-                                      ((static_cast<u8>(fail_safe) & 0x03) << 5) | (0x01 << 7) // reserved bit set to 1
-            );
-            // Bytes 3-7: Reserved (already 0xFF)
-            return data;
-        }
+        // valve_index selects the PGN and is not part of the payload
+        using Codec = PgnCodec<AuxValveFlowMsg, Field<&AuxValveFlowMsg::extend_flow_percent, 0, 8>,
+                               Field<&AuxValveFlowMsg::retract_flow_percent, 8, 8>,
+                               Field<&AuxValveFlowMsg::state, 16, 2>, Field<&AuxValveFlowMsg::limit_status, 18, 3>,
+                               Field<&AuxValveFlowMsg::fail_safe, 21, 2>>;
+
+        dp::Vector<u8> encode() const { return Codec::encode(*this); }
 
-        static AuxValveFlowMsg decode(const dp::Vector<u8> &data, u8 valve_idx) {
-            AuxValveFlowMsg msg;
+        static AuxValveFlowMsg decode(DataSpan data, u8 valve_idx) {
+            AuxValveFlowMsg msg = Codec::decode(data);
             msg.valve_index = valve_idx;
-            if (data.size() >= 3) {
-                msg.extend_flow_percent = data[0];
-                msg.retract_flow_percent = data[1];
-                msg.state = static_cast<ValveState>(data[2] & 0x03);
-                msg.limit_status = static_cast<ValveLimitStatus>((data[2] >> 2) & 0x07);
-                msg.fail_safe = static_cast<ValveFailSafe>((data[2] >> 5) & 0x03);
-            }
             return msg;
         }
     };
@@ -6,6 +6,7 @@
 #include <agrobus/net/internal_cf.hpp>
 #include <agrobus/net/message.hpp>
 #include <agrobus/net/network_manager.hpp>
+#include <agrobus/net/pgn_codec.hpp>
 #include <agrobus/net/types.hpp>
 #include <datapod/datapod.hpp>
 #include <echo/echo.hpp>
@@ -24,23 +25,12 @@ namespace agrobus::isobus::implement {
         u8 target_speed_limit_percent = 0xFF; // 0.4%/bit (0-100%), 0xFF=N/A
         u8 target_engine_load_percent = 0xFF; // 0.4%/bit (0-100%), 0xFF=N/A
 
-        dp::Vector<u8> encode() const {
-            dp::Vector<u8> data(8, 0xFF);
-            data[0] = static_cast<u8>(mode);
-            data[1] = target_speed_limit_percent;
-            data[2] = target_engine_load_percent;
-            return data;
-        }
+        using Codec = PgnCodec<DriveStrategyCmd, Field<&DriveStrategyCmd::mode, 0, 8>,
+                               Field<&DriveStrategyCmd::target_speed_limit_percent, 8, 8>,
+                               Field<&DriveStrategyCmd::target_engine_load_percent, 16, 8>>;
 
-        static DriveStrategyCmd decode(const dp::Vector<u8> &data) {
-            DriveStrategyCmd msg;
-            if (data.size() >= 3) {
-                msg.mode = static_cast<DriveStrategyMode>(data[0]);
-                msg.target_speed_limit_percent = data[1];
-                msg.target_engine_load_percent = data[2];
-            }
-            return msg;
-        }
+        dp::Vector<u8> encode() const { return Codec::encode(*this); }
+        static DriveStrategyCmd decode(DataSpan data) { return Codec::decode(data); }
     };
 
     // ─── Guidance System Command (PGN 0xAD00) ─────────────────────────────────
@@ -51,26 +41,12 @@ namespace agrobus::isobus::implement {
         u8 steering_input_authority = 0xFF; // 0.4%/bit (0-100%), 0xFF=N/A
         u8 system_command = 0xFF;           // Implementation-specific
 
-        dp::Vector<u8> encode() const {
-            dp::Vector<u8> data(8, 0xFF);
-            u16 curv_raw = static_cast<u16>((commanded_curvature + 8032.0) / 0.25);
-            data[0] = static_cast<u8>(curv_raw & 0xFF);
-            data[1] = static_cast<u8>((curv_raw >> 8) & 0xFF);
-            data[2] = steering_input_authority;
-            data[3] = system_command;
-            return data;
-        }
+        using Codec = PgnCodec<GuidanceSystemCmd, Field<&GuidanceSystemCmd::commanded_curvature, 0, 16, 1, 4, -8032>,
+                               Field<&GuidanceSystemCmd::steering_input_authority, 16, 8>,
+                               Field<&GuidanceSystemCmd::system_command, 24, 8>>;
 
-        static GuidanceSystemCmd decode(const dp::Vector<u8> &data) {
-            GuidanceSystemCmd msg;
-            if (data.size() >= 4) {
-                u16 curv_raw = static_cast<u16>(data[0]) | (static_cast<u16>(data[1]) << 8);
-                msg.commanded_curvature = curv_raw * 0.25 - 8032.0;
-                msg.steering_input_authority = data[2];
-                msg.system_command = data[3];
-            }
-            return msg;
-        }
+        dp::Vector<u8> encode() const { return Codec::encode(*this); }
+        static GuidanceSystemCmd decode(DataSpan data) { return Codec::decode(data); }
     };
 
     // ─── Hitch and PTO Combined Command (PGN 0xFE42) ──────────────────────────
@@ -83,26 +59,14 @@ namespace agrobus::isobus::implement {
 
         f64 pto_speed_rpm() const { return pto_speed_raw == 0xFFFF ? 0.0 : pto_speed_raw * 0.125; }
 
-        dp::Vector<u8> encode() const {
-            dp::Vector<u8> data(8, 0xFF);
-            data[0] = static_cast<u8>(hitch_position & 0xFF);
-            data[1] = static_cast<u8>((hitch_position >> 8) & 0xFF);
-            data[2] = static_cast<u8>(pto_speed_raw & 0xFF);
-            data[3] = static_cast<u8>((pto_speed_raw >> 8) & 0xFF);
-            data[4] = (hitch_cmd & 0x03) | ((pto_cmd & 0x03) << 2);
-            return data;
-        }
+        // Byte 4: hitch command (bits 0-1), PTO command (bits 2-3), the rest sent as 0
+        using Codec = PgnCodec<HitchPTOCombinedCmd, Field<&HitchPTOCombinedCmd::hitch_position, 0, 16>,
+                               Field<&HitchPTOCombinedCmd::pto_speed_raw, 16, 16>,
+                               Field<&HitchPTOCombinedCmd::hitch_cmd, 32, 2>,
+                               Field<&HitchPTOCombinedCmd::pto_cmd, 34, 2>, Fixed<36, 4>>;
 
-        static HitchPTOCombinedCmd decode(const dp::Vector<u8> &data) {
-            HitchPTOCombinedCmd msg;
-            if (data.size() >= 5) {
-                msg.hitch_position = static_cast<u16>(data[0]) | (static_cast<u16>(data[1]) << 8);
-                msg.pto_speed_raw = static_cast<u16>(data[2]) | (static_cast<u16>(data[3]) << 8);
-                msg.hitch_cmd = data[4] & 0x03;
-                msg.pto_cmd = (data[4] >> 2) & 0x03;
-            }
-            return msg;
-        }
+        dp::Vector<u8> encode() const { return Codec::encode(*this); }
+        static HitchPTOCombinedCmd decode(DataSpan data) { return Codec::decode(data); }
     };
 
     // ─── Hitch Roll/Pitch Command (PGN 0xF100/0xF102) ─────────────────────────
@@ -112,23 +76,12 @@ namespace agrobus::isobus::implement {
         u16 pitch_position = 0xFFFF; // 0.0025%/bit, offset 50% (center)
         bool is_front = false;       // true = front (0xF100), false = rear (0xF102)
 
-        dp::Vector<u8> encode() const {
-            dp::Vector<u8> data(8, 0xFF);
-            data[0] = static_cast<u8>(roll_position & 0xFF);
-            data[1] = static_cast<u8>((roll_position >> 8) & 0xFF);
-            data[2] = static_cast<u8>(pitch_position & 0xFF);
-            data[3] = static_cast<u8>((pitch_position >> 8) & 0xFF);
-            return data;
-        }
+        // is_front selects the PGN and is not part of the payload
+        using Codec = PgnCodec<HitchRollPitchCmd, Field<&HitchRollPitchCmd::roll_position, 0, 16>,
+                               Field<&HitchRollPitchCmd::pitch_position, 16, 16>>;
 
-        static HitchRollPitchCmd decode(const dp::Vector<u8> &data) {
-            HitchRollPitchCmd msg;
-            if (data.size() >= 4) {
-                msg.roll_position = static_cast<u16>(data[0]) | (static_cast<u16>(data[1]) << 8);
-                msg.pitch_position = static_cast<u16>(data[2]) | (static_cast<u16>(data[3]) << 8);
-            }
-            return msg;
-        }
+        dp::Vector<u8> encode() const { return Codec::encode(*this); }
+        static HitchRollPitchCmd decode(DataSpan data) { return Codec::decode(data); }
     };
 
     // ─── Drive Strategy Interface ──────────────────────────────────────────────
@@ -6,6 +6,7 @@
 #include <agrobus/net/internal_cf.hpp>
 #include <agrobus/net/message.hpp>
 #include <agrobus/net/network_manager.hpp>
+#include <agrobus/net/rt_channel.hpp>
 #include <agrobus/net/types.hpp>
 #include <datapod/datapod.hpp>
 #include <echo/echo.hpp>
@@ -34,15 +35,22 @@ namespace agrobus::isobus::implement {
 
         dp::Vector<u8> encode() const {
             dp::Vector<u8> data(8, 0xFF);
+            encode_into(data.data());
+            return data;
+        }
+
+        // Into an 8-byte frame buffer (RealtimeChannel::payload())
+        void encode_into(u8 *data) const noexcept {
             // Curvature: 0.25 1/km per bit, offset -8032, 2 bytes (bytes 0-1)
             u16 curv_raw = static_cast<u16>((curvature + 8032.0) / 0.25);
             data[0] = static_cast<u8>(curv_raw & 0xFF);
             data[1] = static_cast<u8>((curv_raw >> 8) & 0xFF);
             // Bytes 2-7: Reserved
-            return data;
+            for (u8 i = 2; i < 8; ++i)
+                data[i] = 0xFF;
         }
 
-        static CurvatureCommand decode(const dp::Vector<u8> &data) {
+        static CurvatureCommand decode(DataSpan data) {
             CurvatureCommand msg;
             if (data.size() >= 2) {
                 u16 curv_raw = static_cast<u16>(data[0]) | (static_cast<u16>(data[1]) << 8);
@@ -69,7 +77,7 @@ namespace agrobus::isobus::implement {
             return data;
         }
 
-        static GuidanceMachineInfo decode(const dp::Vector<u8> &data) {
+        static GuidanceMachineInfo decode(DataSpan data) {
             GuidanceMachineInfo msg;
             if (data.size() >= 3) {
                 u16 curv_raw = static_cast<u16>(data[0]) | (static_cast<u16>(data[1]) << 8);
@@ -98,7 +106,7 @@ namespace agrobus::isobus::implement {
             return data;
         }
 
-        static GuidanceSystemStatus decode(const dp::Vector<u8> &data) {
+        static GuidanceSystemStatus decode(DataSpan data) {
             GuidanceSystemStatus msg;
             if (data.size() >= 3) {
                 u16 curv_raw = static_cast<u16>(data[0]) | (static_cast<u16>(data[1]) << 8);
@@ -115,9 +123,11 @@ namespace agrobus::isobus::implement {
     class GuidanceCurvatureInterface {
         IsoNet &net_;
         InternalCF *cf_;
+        RealtimeChannel curvature_channel_;
 
       public:
-        GuidanceCurvatureInterface(IsoNet &net, InternalCF *cf) : net_(net), cf_(cf) {}
+        GuidanceCurvatureInterface(IsoNet &net, InternalCF *cf)
+            : net_(net), cf_(cf), curvature_channel_(net, cf, PGN_GUIDANCE_CURVATURE_CMD, Priority::Normal) {}
 
         Result<void> initialize() {
             if (!cf_) {
@@ -141,6 +151,16 @@ namespace agrobus::isobus::implement {
             return net_.send(PGN_GUIDANCE_CURVATURE_CMD, msg.encode(), cf_, nullptr, Priority::Default);
         }
 
+        // Closed-loop path for the same command: pre-encoded frame written
+        // straight to the bus, timestamped and with jitter statistics. Set the
+        // loop period on curvature_channel() to get the jitter histogram.
+        Result<void> send_curvature_realtime(const CurvatureCommand &msg) {
+            msg.encode_into(curvature_channel_.payload());
+            return curvature_channel_.send();
+        }
+
+        RealtimeChannel &curvature_channel() noexcept { return curvature_channel_; }
+
         // Send machine info (TECU -> network)
         Result<void> send_machine_info(const GuidanceMachineInfo &msg) {
             return net_.send(PGN_GUIDANCE_MACHINE, msg.encode(), cf_, nullptr, Priority::Default);
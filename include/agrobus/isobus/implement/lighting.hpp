@@ -6,6 +6,7 @@
 #include <agrobus/net/internal_cf.hpp>
 #include <agrobus/net/message.hpp>
 #include <agrobus/net/network_manager.hpp>
+#include <agrobus/net/pgn_codec.hpp>
 #include <datapod/datapod.hpp>
 #include <echo/echo.hpp>
 
@@ -42,52 +43,26 @@ namespace agrobus::isobus::implement {
         LightState left_stop = LightState::NotAvailable;
         LightState right_stop = LightState::NotAvailable;
 
-        // Encode to 8-byte CAN data (2 bits per light, packed into bytes)
-        dp::Vector<u8> encode() const {
-            dp::Vector<u8> data(8, 0xFF);
-            // Byte 0: left_turn(0:1), right_turn(2:3), low_beam(4:5), high_beam(6:7)
-            data[0] = static_cast<u8>((static_cast<u8>(left_turn) << 0) | (static_cast<u8>(right_turn) << 2) |
-                                      (static_cast<u8>(low_beam) << 4) | (static_cast<u8>(high_beam) << 6));
-            // Byte 1: front_fog(0:1), rear_fog(2:3), beacon(4:5), running(6:7)
-            data[1] = static_cast<u8>((static_cast<u8>(front_fog) << 0) | (static_cast<u8>(rear_fog) << 2) |
-                                      (static_cast<u8>(beacon) << 4) | (static_cast<u8>(running) << 6));
-            // Byte 2: rear_work(0:1), front_work(2:3), side_work(4:5), hazard(6:7)
-            data[2] = static_cast<u8>((static_cast<u8>(rear_work) << 0) | (static_cast<u8>(front_work) << 2) |
-                                      (static_cast<u8>(side_work) << 4) | (static_cast<u8>(hazard) << 6));
-            // Byte 3: backup(0:1), center_stop(2:3), left_stop(4:5), right_stop(6:7)
-            data[3] = static_cast<u8>((static_cast<u8>(backup) << 0) | (static_cast<u8>(center_stop) << 2) |
-                                      (static_cast<u8>(left_stop) << 4) | (static_cast<u8>(right_stop) << 6));
-            // Bytes 4-7: reserved (already 0xFF)
-            return data;
-        }
-
-        // Decode from 8-byte CAN data
-        static LightingState decode(const dp::Vector<u8> &data) {
-            LightingState state;
-            if (data.size() >= 4) {
-                // Byte 0
-                state.left_turn = static_cast<LightState>((data[0] >> 0) & 0x03);
-                state.right_turn = static_cast<LightState>((data[0] >> 2) & 0x03);
-                state.low_beam = static_cast<LightState>((data[0] >> 4) & 0x03);
-                state.high_beam = static_cast<LightState>((data[0] >> 6) & 0x03);
-                // Byte 1
-                state.front_fog = static_cast<LightState>((data[1] >> 0) & 0x03);
-                state.rear_fog = static_cast<LightState>((data[1] >> 2) & 0x03);
-                state.beacon = static_cast<LightState>((data[1] >> 4) & 0x03);
-                state.running = static_cast<LightState>((data[1] >> 6) & 0x03);
-                // Byte 2
-                state.rear_work = static_cast<LightState>((data[2] >> 0) & 0x03);
-                state.front_work = static_cast<LightState>((data[2] >> 2) & 0x03);
-                state.side_work = static_cast<LightState>((data[2] >> 4) & 0x03);
-                state.hazard = static_cast<LightState>((data[2] >> 6) & 0x03);
-                // Byte 3
-                state.backup = static_cast<LightState>((data[3] >> 0) & 0x03);
-                state.center_stop = static_cast<LightState>((data[3] >> 2) & 0x03);
-                state.left_stop = static_cast<LightState>((data[3] >> 4) & 0x03);
-                state.right_stop = static_cast<LightState>((data[3] >> 6) & 0x03);
-            }
-            return state;
-        }
+        using Codec = PgnCodec<LightingState,
+                               Field<&LightingState::left_turn, 0, 2>,
+                               Field<&LightingState::right_turn, 2, 2>,
+                               Field<&LightingState::low_beam, 4, 2>,
+                               Field<&LightingState::high_beam, 6, 2>,
+                               Field<&LightingState::front_fog, 8, 2>,
+                               Field<&LightingState::rear_fog, 10, 2>,
+                               Field<&LightingState::beacon, 12, 2>,
+                               Field<&LightingState::running, 14, 2>,
+                               Field<&LightingState::rear_work, 16, 2>,
+                               Field<&LightingState::front_work, 18, 2>,
+                               Field<&LightingState::side_work, 20, 2>,
+                               Field<&LightingState::hazard, 22, 2>,
+                               Field<&LightingState::backup, 24, 2>,
+                               Field<&LightingState::center_stop, 26, 2>,
+                               Field<&LightingState::left_stop, 28, 2>,
+                               Field<&LightingState::right_stop, 30, 2>>;
+
+        dp::Vector<u8> encode() const { return Codec::encode(*this); }
+        static LightingState decode(DataSpan data) { return Codec::decode(data); }
     };
 
     // ─── Lighting Interface (ISO 11783-7 Section 4.5) ─────────────────────────────
@@ -6,6 +6,7 @@
 #include <agrobus/net/internal_cf.hpp>
 #include <agrobus/net/message.hpp>
 #include <agrobus/net/network_manager.hpp>
+#include <agrobus/net/pgn_codec.hpp>
 #include <datapod/datapod.hpp>
 #include <echo/echo.hpp>
 
@@ -30,35 +31,15 @@ namespace agrobus::isobus::implement {
 
         f64 speed_mps() const { return speed_raw == 0xFFFF ? 0.0 : speed_raw * 0.001; }
 
-        dp::Vector<u8> encode() const {
-            dp::Vector<u8> data(8, 0xFF);
-            // Byte 0-1: speed (0.001 m/s per bit, LE)
-            data[0] = static_cast<u8>(speed_raw & 0xFF);
-            data[1] = static_cast<u8>((speed_raw >> 8) & 0xFF);
-            // Byte 2-3: distance (not used here, 0xFF)
-            data[2] = 0xFF;
-            data[3] = 0xFF;
-            // Byte 4: bits 0-1: direction, bits 2-3: source, bits 4-5: limit_status, bits 6-7: reserved
-            data[4] = static_cast<u8>((static_cast<u8>(direction) & 0x03) | ((static_cast<u8>(source) & 0x03) << 2) |
-                                      ((static_cast<u8>(limit_status) & 0x03) << 4) | 0xC0 // reserved bits set to 1
-            );
-            // Bytes 5-7: reserved
-            data[5] = 0xFF;
-            data[6] = 0xFF;
-            data[7] = 0xFF;
-            return data;
-        }
+        // Bytes 0-1: speed, 2-3: distance (not sent, 0xFF), byte 4: direction (bits 0-1),
+        // source (bits 2-3), limit status (bits 4-5), reserved
+        using Codec = PgnCodec<MachineSelectedSpeedMsg, Field<&MachineSelectedSpeedMsg::speed_raw, 0, 16>,
+                               Field<&MachineSelectedSpeedMsg::direction, 32, 2>,
+                               Field<&MachineSelectedSpeedMsg::source, 34, 2>,
+                               Field<&MachineSelectedSpeedMsg::limit_status, 36, 2>>;
 
-        static MachineSelectedSpeedMsg decode(const dp::Vector<u8> &data) {
-            MachineSelectedSpeedMsg msg;
-            if (data.size() >= 5) {
-                msg.speed_raw = static_cast<u16>(data[0]) | (static_cast<u16>(data[1]) << 8);
-                msg.direction = static_cast<MachineDirection>(data[4] & 0x03);
-                msg.source = static_cast<SpeedSource>((data[4] >> 2) & 0x03);
-                msg.limit_status = static_cast<SpeedExitCode>((data[4] >> 4) & 0x03);
-            }
-            return msg;
-        }
+        dp::Vector<u8> encode() const { return Codec::encode(*this); }
+        static MachineSelectedSpeedMsg decode(DataSpan data) { return Codec::decode(data); }
     };
 
     // ─── Machine Selected Speed Command (from implement, PGN 0xFE4C) ───────────
@@ -78,30 +59,12 @@ namespace agrobus::isobus::implement {
             return *this;
         }
 
-        dp::Vector<u8> encode() const {
-            dp::Vector<u8> data(8, 0xFF);
-            // Byte 0-1: target speed (0.001 m/s per bit, LE)
-            data[0] = static_cast<u8>(target_speed_raw & 0xFF);
-            data[1] = static_cast<u8>((target_speed_raw >> 8) & 0xFF);
-            // Byte 2: bits 0-1: direction command, bits 2-7: reserved (0xFF mask)
-            data[2] = static_cast<u8>((static_cast<u8>(direction_cmd) & 0x03) | 0xFC);
-            // Bytes 3-7: reserved
-            data[3] = 0xFF;
-            data[4] = 0xFF;
-            data[5] = 0xFF;
-            data[6] = 0xFF;
-            data[7] = 0xFF;
-            return data;
-        }
+        // Bytes 0-1: target speed, byte 2: direction command (bits 0-1), reserved
+        using Codec = PgnCodec<MachineSpeedCommandMsg, Field<&MachineSpeedCommandMsg::target_speed_raw, 0, 16>,
+                               Field<&MachineSpeedCommandMsg::direction_cmd, 16, 2>>;
 
-        static MachineSpeedCommandMsg decode(const dp::Vector<u8> &data) {
-            MachineSpeedCommandMsg msg;
-            if (data.size() >= 3) {
-                msg.target_speed_raw = static_cast<u16>(data[0]) | (static_cast<u16>(data[1]) << 8);
-                msg.direction_cmd = static_cast<MachineDirection>(data[2] & 0x03);
-            }
-            return msg;
-        }
+        dp::Vector<u8> encode() const { return Codec::encode(*this); }
+        static MachineSpeedCommandMsg decode(DataSpan data) { return Codec::decode(data); }
     };
 
     // ─── Machine Speed Interface (ISO 11783-7/9) ────────────────────────────────
@@ -7,6 +7,8 @@
 #include <agrobus/net/internal_cf.hpp>
 #include <agrobus/net/message.hpp>
 #include <agrobus/net/network_manager.hpp>
+#include <agrobus/net/pgn_codec.hpp>
+#include <agrobus/net/snapshot.hpp>
 #include <agrobus/net/types.hpp>
 #include <datapod/datapod.hpp>
 #include <echo/echo.hpp>
@@ -25,35 +27,14 @@ namespace agrobus::isobus::implement {
         u8 max_power_time_min = 0xFF; // Max time of tractor power, minutes (0xFF=N/A)
         u8 start_stop_state = 0x03;   // 2 bits: 0=key off, 1=not requested, 2=error, 3=N/A
 
-        dp::Vector<u8> encode() const {
-            dp::Vector<u8> data(8, 0xFF);
-            u16 spd = static_cast<u16>(speed_mps / 0.001);
-            data[0] = static_cast<u8>(spd & 0xFF);
-            data[1] = static_cast<u8>((spd >> 8) & 0xFF);
-            u32 dist = static_cast<u32>(distance_m / 0.001);
-            data[2] = static_cast<u8>(dist & 0xFF);
-            data[3] = static_cast<u8>((dist >> 8) & 0xFF);
-            data[4] = static_cast<u8>((dist >> 16) & 0xFF);
-            data[5] = static_cast<u8>((dist >> 24) & 0xFF);
-            data[6] = max_power_time_min;
-            data[7] = (static_cast<u8>(direction) & 0x03) | ((start_stop_state & 0x03) << 2);
-            return data;
-        }
+        using Codec = PgnCodec<WheelBasedSpeedDist, Field<&WheelBasedSpeedDist::speed_mps, 0, 16, 1, 1000>,
+                               Field<&WheelBasedSpeedDist::distance_m, 16, 32, 1, 1000>,
+                               Field<&WheelBasedSpeedDist::max_power_time_min, 48, 8>,
+                               Field<&WheelBasedSpeedDist::direction, 56, 2>,
+                               Field<&WheelBasedSpeedDist::start_stop_state, 58, 2>>;
 
-        static WheelBasedSpeedDist decode(const dp::Vector<u8> &data) {
-            WheelBasedSpeedDist msg;
-            if (data.size() >= 8) {
-                u16 spd = static_cast<u16>(data[0]) | (static_cast<u16>(data[1]) << 8);
-                msg.speed_mps = spd * 0.001;
-                u32 dist = static_cast<u32>(data[2]) | (static_cast<u32>(data[3]) << 8) |
-                           (static_cast<u32>(data[4]) << 16) | (static_cast<u32>(data[5]) << 24);
-                msg.distance_m = dist * 0.001;
-                msg.max_power_time_min = data[6];
-                msg.direction = static_cast<MachineDirection>(data[7] & 0x03);
-                msg.start_stop_state = (data[7] >> 2) & 0x03;
-            }
-            return msg;
-        }
+        dp::Vector<u8> encode() const { return Codec::encode(*this); }
+        static WheelBasedSpeedDist decode(DataSpan data) { return Codec::decode(data); }
     };
 
     // ─── Ground-Based Speed and Distance (PGN 0xFE49) ───────────────────────────
@@ -63,33 +44,12 @@ namespace agrobus::isobus::implement {
         f64 distance_m = 0.0; // 0.001 m per bit, 4 bytes (total accumulated)
         MachineDirection direction = MachineDirection::NotAvailable;
 
-        dp::Vector<u8> encode() const {
-            dp::Vector<u8> data(8, 0xFF);
-            u16 spd = static_cast<u16>(speed_mps / 0.001);
-            data[0] = static_cast<u8>(spd & 0xFF);
-            data[1] = static_cast<u8>((spd >> 8) & 0xFF);
-            u32 dist = static_cast<u32>(distance_m / 0.001);
-            data[2] = static_cast<u8>(dist & 0xFF);
-            data[3] = static_cast<u8>((dist >> 8) & 0xFF);
-            data[4] = static_cast<u8>((dist >> 16) & 0xFF);
-            data[5] = static_cast<u8>((dist >> 24) & 0xFF);
-            data[6] = 0xFF; // reserved
-            data[7] = static_cast<u8>(direction) & 0x03;
-            return data;
-        }
+        using Codec = PgnCodec<GroundBasedSpeedDist, Field<&GroundBasedSpeedDist::speed_mps, 0, 16, 1, 1000>,
+                               Field<&GroundBasedSpeedDist::distance_m, 16, 32, 1, 1000>,
+                               Field<&GroundBasedSpeedDist::direction, 56, 2>>;
 
-        static GroundBasedSpeedDist decode(const dp::Vector<u8> &data) {
-            GroundBasedSpeedDist msg;
-            if (data.size() >= 8) {
-                u16 spd = static_cast<u16>(data[0]) | (static_cast<u16>(data[1]) << 8);
-                msg.speed_mps = spd * 0.001;
-                u32 dist = static_cast<u32>(data[2]) | (static_cast<u32>(data[3]) << 8) |
-                           (static_cast<u32>(data[4]) << 16) | (static_cast<u32>(data[5]) << 24);
-                msg.distance_m = dist * 0.001;
-                msg.direction = static_cast<MachineDirection>(data[7] & 0x03);
-            }
-            return msg;
-        }
+        dp::Vector<u8> encode() const { return Codec::encode(*this); }
+        static GroundBasedSpeedDist decode(DataSpan data) { return Codec::decode(data); }
     };
 
     // ─── Machine Selected Speed (PGN 0xF022) ────────────────────────────────────
@@ -102,37 +62,15 @@ namespace agrobus::isobus::implement {
         u8 limit_status = 0x07; // 3 bits: 0=not limited, ...7=N/A
         u8 exit_code = 0xFF;
 
-        dp::Vector<u8> encode() const {
-            dp::Vector<u8> data(8, 0xFF);
-            u16 spd = static_cast<u16>(speed_mps / 0.001);
-            data[0] = static_cast<u8>(spd & 0xFF);
-            data[1] = static_cast<u8>((spd >> 8) & 0xFF);
-            u32 dist = static_cast<u32>(distance_m / 0.001);
-            data[2] = static_cast<u8>(dist & 0xFF);
-            data[3] = static_cast<u8>((dist >> 8) & 0xFF);
-            data[4] = static_cast<u8>((dist >> 16) & 0xFF);
-            data[5] = static_cast<u8>((dist >> 24) & 0xFF);
-            data[6] = exit_code;
-            data[7] = (static_cast<u8>(direction) & 0x03) | ((static_cast<u8>(source) & 0x03) << 2) |
-                      ((limit_status & 0x07) << 4);
-            return data;
-        }
+        using Codec = PgnCodec<MachineSelectedSpeed, Field<&MachineSelectedSpeed::speed_mps, 0, 16, 1, 1000>,
+                               Field<&MachineSelectedSpeed::distance_m, 16, 32, 1, 1000>,
+                               Field<&MachineSelectedSpeed::exit_code, 48, 8>,
+                               Field<&MachineSelectedSpeed::direction, 56, 2>,
+                               Field<&MachineSelectedSpeed::source, 58, 2>,
+                               Field<&MachineSelectedSpeed::limit_status, 60, 3>>;
 
-        static MachineSelectedSpeed decode(const dp::Vector<u8> &data) {
-            MachineSelectedSpeed msg;
-            if (data.size() >= 8) {
-                u16 spd = static_cast<u16>(data[0]) | (static_cast<u16>(data[1]) << 8);
-                msg.speed_mps = spd * 0.001;
-                u32 dist = static_cast<u32>(data[2]) | (static_cast<u32>(data[3]) << 8) |
-                           (static_cast<u32>(data[4]) << 16) | (static_cast<u32>(data[5]) << 24);
-                msg.distance_m = dist * 0.001;
-                msg.exit_code = data[6];
-                msg.direction = static_cast<MachineDirection>(data[7] & 0x03);
-                msg.source = static_cast<SpeedSource>((data[7] >> 2) & 0x03);
-                msg.limit_status = (data[7] >> 4) & 0x07;
-            }
-            return msg;
-        }
+        dp::Vector<u8> encode() const { return Codec::encode(*this); }
+        static MachineSelectedSpeed decode(DataSpan data) { return Codec::decode(data); }
     };
 
     // ─── Hitch / PTO Status Feedback (ISO 11783-7 Class 3) ──────────────────────
@@ -148,30 +86,14 @@ namespace agrobus::isobus::implement {
         f64 draft_force_n = 0.0; // Draft force (Class 2 TECU, 10 N/bit, offset -320000)
         bool is_rear = true;
 
-        dp::Vector<u8> encode() const {
-            dp::Vector<u8> data(8, 0xFF);
-            data[0] = position_percent;
-            data[1] = (in_work_indication & 0x03) | ((static_cast<u8>(limit_status) & 0x03) << 2) |
-                      ((static_cast<u8>(exit_code) & 0x07) << 4);
-            // Bytes 2-3: nominal lower link force (rear draft), 10 N/bit, offset -320000
-            i32 force_raw = static_cast<i32>((draft_force_n + 320000.0) / 10.0);
-            data[2] = static_cast<u8>(force_raw & 0xFF);
-            data[3] = static_cast<u8>((force_raw >> 8) & 0xFF);
-            return data;
-        }
+        // Bytes 2-3: nominal lower link force (rear draft), 10 N/bit, offset -320000
+        using Codec = PgnCodec<HitchStatus, Field<&HitchStatus::position_percent, 0, 8>,
+                               Field<&HitchStatus::in_work_indication, 8, 2>, Field<&HitchStatus::limit_status, 10, 2>,
+                               Field<&HitchStatus::exit_code, 12, 3>,
+                               Field<&HitchStatus::draft_force_n, 16, 16, 10, 1, -320000>>;
 
-        static HitchStatus decode(const dp::Vector<u8> &data) {
-            HitchStatus msg;
-            if (data.size() >= 4) {
-                msg.position_percent = data[0];
-                msg.in_work_indication = data[1] & 0x03;
-                msg.limit_status = static_cast<LimitStatus>((data[1] >> 2) & 0x03);
-                msg.exit_code = static_cast<ExitReasonCode>((data[1] >> 4) & 0x07);
-                i32 force_raw = static_cast<i32>(data[2]) | (static_cast<i32>(data[3]) << 8);
-                msg.draft_force_n = force_raw * 10.0 - 320000.0;
-            }
-            return msg;
-        }
+        dp::Vector<u8> encode() const { return Codec::encode(*this); }
+        static HitchStatus decode(DataSpan data) { return Codec::decode(data); }
     };
 
     struct PTOStatus {
@@ -182,36 +104,45 @@ namespace agrobus::isobus::implement {
         u8 economy_mode = 3; // 2 bits: 0=not active, 1=active, 2=error, 3=N/A
         bool is_rear = true;
 
-        dp::Vector<u8> encode() const {
-            dp::Vector<u8> data(8, 0xFF);
-            u16 rpm = static_cast<u16>(shaft_speed_rpm / 0.125);
-            data[0] = static_cast<u8>(rpm & 0xFF);
-            data[1] = static_cast<u8>((rpm >> 8) & 0xFF);
-            data[2] = (engagement & 0x03) | ((economy_mode & 0x03) << 2) |
-                      ((static_cast<u8>(limit_status) & 0x03) << 4) | ((static_cast<u8>(exit_code) & 0x03) << 6);
-            return data;
-        }
+        using Codec = PgnCodec<PTOStatus, Field<&PTOStatus::shaft_speed_rpm, 0, 16, 1, 8>,
+                               Field<&PTOStatus::engagement, 16, 2>, Field<&PTOStatus::economy_mode, 18, 2>,
+                               Field<&PTOStatus::limit_status, 20, 2>, Field<&PTOStatus::exit_code, 22, 2>>;
 
-        static PTOStatus decode(const dp::Vector<u8> &data) {
-            PTOStatus msg;
-            if (data.size() >= 3) {
-                u16 rpm = static_cast<u16>(data[0]) | (static_cast<u16>(data[1]) << 8);
-                msg.shaft_speed_rpm = rpm * 0.125;
-                msg.engagement = data[2] & 0x03;
-                msg.economy_mode = (data[2] >> 2) & 0x03;
-                msg.limit_status = static_cast<LimitStatus>((data[2] >> 4) & 0x03);
-                msg.exit_code = static_cast<ExitReasonCode>((data[2] >> 6) & 0x03);
-            }
-            return msg;
-        }
+        dp::Vector<u8> encode() const { return Codec::encode(*this); }
+        static PTOStatus decode(DataSpan data) { return Codec::decode(data); }
+    };
+
+    // ─── Latest received speed/distance state ───────────────────────────────────
+    // Everything TECUSpeedDistance has decoded so far, published as one value so
+    // other threads see the speeds, hitches and PTOs of the same update.
+    struct SpeedDistanceState {
+        WheelBasedSpeedDist wheel;
+        GroundBasedSpeedDist ground;
+        MachineSelectedSpeed machine;
+        HitchStatus rear_hitch;
+        HitchStatus front_hitch = [] {
+            HitchStatus h;
+            h.is_rear = false;
+            return h;
+        }();
+        PTOStatus rear_pto;
+        PTOStatus front_pto = [] {
+            PTOStatus p;
+            p.is_rear = false;
+            return p;
+        }();
+        u64 timestamp_us = 0; // RX time of the newest message folded in
     };
 
     // ─── Speed/Distance Interface ────────────────────────────────────────────────
     // Handles reception and transmission of speed/distance/direction messages.
+    // Received values are also kept in a Snapshot for readers on other threads.
 
     class TECUSpeedDistance {
         IsoNet &net_;
         InternalCF *cf_;
+        SpeedDistanceState state_;
+        Snapshot<SpeedDistanceState> snapshot_;
 
       public:
         TECUSpeedDistance(IsoNet &net, InternalCF *cf) : net_(net), cf_(cf) {}
@@ -229,21 +160,29 @@ namespace agrobus::isobus::implement {
             net_.register_pgn_callback(PGN_REAR_HITCH, [this](const Message &msg) {
                 auto s = HitchStatus::decode(msg.data);
                 s.is_rear = true;
+                state_.rear_hitch = s;
+                publish(msg);
                 on_hitch_status.emit(s, msg.source);
             });
             net_.register_pgn_callback(PGN_FRONT_HITCH, [this](const Message &msg) {
                 auto s = HitchStatus::decode(msg.data);
                 s.is_rear = false;
+                state_.front_hitch = s;
+                publish(msg);
                 on_hitch_status.emit(s, msg.source);
             });
             net_.register_pgn_callback(PGN_REAR_PTO, [this](const Message &msg) {
                 auto s = PTOStatus::decode(msg.data);
                 s.is_rear = true;
+                state_.rear_pto = s;
+                publish(msg);
                 on_pto_status.emit(s, msg.source);
             });
             net_.register_pgn_callback(PGN_FRONT_PTO, [this](const Message &msg) {
                 auto s = PTOStatus::decode(msg.data);
                 s.is_rear = false;
+                state_.front_pto = s;
+                publish(msg);
                 on_pto_status.emit(s, msg.source);
             });
             echo::category("isobus.implement.speed").debug("initialized");
@@ -275,6 +214,10 @@ namespace agrobus::isobus::implement {
             return net_.send(pgn, msg.encode(), cf_, nullptr, Priority::Default);
         }
 
+        // ─── Cross-thread access ─────────────────────────────────────────────────
+        const Snapshot<SpeedDistanceState> &snapshot() const noexcept { return snapshot_; }
+        SpeedDistanceState state() const { return snapshot_.load(); }
+
         // Events
         Event<WheelBasedSpeedDist, Address> on_wheel_speed;
         Event<GroundBasedSpeedDist, Address> on_ground_speed;
@@ -283,18 +226,29 @@ namespace agrobus::isobus::implement {
         Event<PTOStatus, Address> on_pto_status;
 
       private:
+        void publish(const Message &msg) {
+            state_.timestamp_us = msg.timestamp_us;
+            snapshot_.publish(state_);
+        }
+
         void handle_wheel_speed(const Message &msg) {
             auto data = WheelBasedSpeedDist::decode(msg.data);
+            state_.wheel = data;
+            publish(msg);
             on_wheel_speed.emit(data, msg.source);
         }
 
         void handle_ground_speed(const Message &msg) {
             auto data = GroundBasedSpeedDist::decode(msg.data);
+            state_.ground = data;
+            publish(msg);
             on_ground_speed.emit(data, msg.source);
         }
 
         void handle_machine_speed(const Message &msg) {
             auto data = MachineSelectedSpeed::decode(msg.data);
+            state_.machine = data;
+            publish(msg);
             on_machine_speed.emit(data, msg.source);
         }
     };
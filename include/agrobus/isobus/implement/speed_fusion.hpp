@@ -0,0 +1,239 @@
+#pragma once
+
+#include "machine_speed_cmd.hpp"
+#include <agrobus/net/constants.hpp>
+#include <agrobus/net/data_span.hpp>
+#include <agrobus/net/event.hpp>
+#include <agrobus/net/message.hpp>
+#include <agrobus/net/network_manager.hpp>
+#include <agrobus/net/snapshot.hpp>
+#include <agrobus/net/types.hpp>
+#include <datapod/datapod.hpp>
+#include <echo/echo.hpp>
+
+namespace agrobus::isobus::implement {
+    using namespace agrobus::net;
+
+    // ─── Speed inputs ───────────────────────────────────────────────────────────
+    enum class SpeedInput : u8 {
+        MachineSelected = 0, // PGN 0xF022, the TECU's own choice
+        GroundBased = 1,     // PGN 0xFE49, radar
+        WheelBased = 2,      // PGN 0xFE48, slips under draft
+        Gnss = 3,            // PGN 129026 speed over ground
+        None = 0xFF
+    };
+    inline constexpr usize SPEED_INPUTS = 4;
+
+    // ─── Speed fusion configuration ─────────────────────────────────────────────
+    struct SpeedFusionConfig {
+        // Best first; an input not listed is never chosen
+        dp::Array<SpeedInput, SPEED_INPUTS> preference{SpeedInput::MachineSelected, SpeedInput::GroundBased,
+                                                       SpeedInput::WheelBased, SpeedInput::Gnss};
+        u64 stale_us = 300000;    // Three missed 100 ms broadcasts and the input is dropped
+        u64 max_gap_us = 1000000; // Longer receive gaps are integrated as this long
+        bool listen_machine = true;
+        bool listen_ground = true;
+        bool listen_wheel = true;
+        bool listen_gnss = true;
+
+        SpeedFusionConfig &prefer(SpeedInput first, SpeedInput second = SpeedInput::None,
+                                  SpeedInput third = SpeedInput::None, SpeedInput fourth = SpeedInput::None) {
+            preference = {first, second, third, fourth};
+            return *this;
+        }
+        SpeedFusionConfig &stale(u32 ms) {
+            stale_us = static_cast<u64>(ms) * 1000;
+            return *this;
+        }
+        SpeedFusionConfig &max_gap(u32 ms) {
+            max_gap_us = static_cast<u64>(ms) * 1000;
+            return *this;
+        }
+        SpeedFusionConfig &machine_speed(bool enable) {
+            listen_machine = enable;
+            return *this;
+        }
+        SpeedFusionConfig &ground_speed(bool enable) {
+            listen_ground = enable;
+            return *this;
+        }
+        SpeedFusionConfig &wheel_speed(bool enable) {
+            listen_wheel = enable;
+            return *this;
+        }
+        SpeedFusionConfig &gnss_speed(bool enable) {
+            listen_gnss = enable;
+            return *this;
+        }
+    };
+
+    // ─── Fused speed and distance ───────────────────────────────────────────────
+    struct OdometerReading {
+        f64 speed_mps = 0.0;  // Of the chosen input
+        f64 distance_m = 0.0; // Travelled since start or reset, either direction
+        MachineDirection direction = MachineDirection::NotAvailable;
+        SpeedInput source = SpeedInput::None;
+        u64 timestamp_us = 0; // RX time distance_m was integrated up to
+
+        // Distance extrapolated to `t_us` with the current speed
+        f64 distance_at(u64 t_us) const noexcept {
+            if (source == SpeedInput::None || t_us <= timestamp_us)
+                return distance_m;
+            return distance_m + speed_mps * static_cast<f64>(t_us - timestamp_us) * 1e-6;
+        }
+    };
+
+    // ─── Speed/odometry fusion ───────────────────────────────────────────────────
+    // One speed and one odometer from every speed broadcast on the bus: the
+    // TECU's wheel-based, ground-based and machine-selected speed and GNSS
+    // speed over ground. Each input keeps its newest value and receive time;
+    // on every sample the most preferred input that is not stale is chosen,
+    // and its sample integrates distance (trapezoid) from the previous
+    // odometer update to its own receive time. The distances the TECU sends
+    // are not used: they wrap, restart with the ECU and GNSS has none.
+    //
+    // Readers get the result in constant time, from any thread, through the
+    // snapshot: reading().distance_m for TC distance triggers, speed_mps()
+    // for the TC-GEO look-ahead. add_sample() takes inputs that do not come
+    // over this bus (a serial GNSS receiver, a simulator).
+    class SpeedFusion {
+        struct Input {
+            f64 speed_mps = 0.0;
+            MachineDirection direction = MachineDirection::NotAvailable;
+            u64 at_us = 0;
+            bool valid = false;
+        };
+
+        IsoNet &net_;
+        SpeedFusionConfig config_;
+        dp::Array<Input, SPEED_INPUTS> inputs_{};
+        OdometerReading reading_;
+        Snapshot<OdometerReading> snapshot_;
+        u64 switches_ = 0;
+
+      public:
+        explicit SpeedFusion(IsoNet &net, SpeedFusionConfig config = {}) : net_(net), config_(config) {}
+
+        Result<void> initialize() {
+            if (config_.listen_machine)
+                net_.register_pgn_view_callback(PGN_MACHINE_SELECTED_SPEED, [this](const MessageView &msg) {
+                    handle_tecu(SpeedInput::MachineSelected, msg);
+                });
+            if (config_.listen_ground)
+                net_.register_pgn_view_callback(PGN_GROUND_BASED_SPEED_DIST, [this](const MessageView &msg) {
+                    handle_tecu(SpeedInput::GroundBased, msg);
+                });
+            if (config_.listen_wheel)
+                net_.register_pgn_view_callback(PGN_WHEEL_BASED_SPEED_DIST, [this](const MessageView &msg) {
+                    handle_tecu(SpeedInput::WheelBased, msg);
+                });
+            if (config_.listen_gnss)
+                net_.register_pgn_view_callback(PGN_GNSS_COG_SOG_RAPID,
+                                                [this](const MessageView &msg) { handle_cog_sog(msg); });
+            echo::category("isobus.implement.speed").debug("speed fusion initialized");
+            return {};
+        }
+
+        // ─── Inputs ──────────────────────────────────────────────────────────────
+        // A speed from `input` received at `timestamp_us`; samples older than the
+        // input's newest are dropped
+        void add_sample(SpeedInput input, f64 speed_mps, u64 timestamp_us,
+                        MachineDirection direction = MachineDirection::NotAvailable) {
+            usize slot = static_cast<usize>(input);
+            if (slot >= SPEED_INPUTS)
+                return;
+            Input &in = inputs_[slot];
+            if (in.valid && timestamp_us < in.at_us)
+                return;
+            in.speed_mps = speed_mps < 0.0 ? -speed_mps : speed_mps;
+            in.direction = direction;
+            in.at_us = timestamp_us;
+            in.valid = true;
+
+            SpeedInput best = select(timestamp_us);
+            if (best != input)
+                return; // A better input is fresh; it drives the odometer
+            if (best != reading_.source) {
+                ++switches_;
+                echo::category("isobus.implement.speed").debug("speed source: ", static_cast<u8>(best));
+            }
+            if (reading_.source != SpeedInput::None && timestamp_us > reading_.timestamp_us) {
+                u64 dt = timestamp_us - reading_.timestamp_us;
+                if (dt > config_.max_gap_us)
+                    dt = config_.max_gap_us;
+                reading_.distance_m += (reading_.speed_mps + in.speed_mps) * 0.5 * static_cast<f64>(dt) * 1e-6;
+            }
+            reading_.speed_mps = in.speed_mps;
+            reading_.direction = direction;
+            reading_.source = best;
+            reading_.timestamp_us = timestamp_us;
+            snapshot_.publish(reading_);
+            on_update.emit(reading_);
+        }
+
+        // Restart the odometer at `distance_m` (e.g. at a field boundary)
+        void reset_distance(f64 distance_m = 0.0) {
+            reading_.distance_m = distance_m;
+            snapshot_.publish(reading_);
+        }
+
+        // ─── Queries (any thread) ────────────────────────────────────────────────
+        OdometerReading reading() const { return snapshot_.load(); }
+        f64 distance_m() const { return snapshot_.load().distance_m; }
+        f64 speed_mps() const { return snapshot_.load().speed_mps; }
+        const Snapshot<OdometerReading> &snapshot() const noexcept { return snapshot_; }
+
+        // ─── Per-input state (update thread) ─────────────────────────────────────
+        // Newest speed of `input`, if it has sent one
+        dp::Optional<f64> input_speed(SpeedInput input) const noexcept {
+            usize slot = static_cast<usize>(input);
+            if (slot >= SPEED_INPUTS || !inputs_[slot].valid)
+                return dp::nullopt;
+            return inputs_[slot].speed_mps;
+        }
+        u64 input_time_us(SpeedInput input) const noexcept {
+            usize slot = static_cast<usize>(input);
+            return slot < SPEED_INPUTS ? inputs_[slot].at_us : 0;
+        }
+        // Times the chosen input changed
+        u64 source_switches() const noexcept { return switches_; }
+
+        Event<const OdometerReading &> on_update;
+
+      private:
+        // Most preferred input with a sample no older than stale_us at `now_us`
+        SpeedInput select(u64 now_us) const noexcept {
+            for (SpeedInput input : config_.preference) {
+                usize slot = static_cast<usize>(input);
+                if (slot >= SPEED_INPUTS || !inputs_[slot].valid)
+                    continue;
+                if (now_us - inputs_[slot].at_us <= config_.stale_us || inputs_[slot].at_us > now_us)
+                    return input;
+            }
+            return SpeedInput::None;
+        }
+
+        // Wheel, ground and machine-selected speed share the layout: 0.001 m/s
+        // in bytes 0-1, direction in the low bits of byte 7
+        void handle_tecu(SpeedInput input, const MessageView &msg) {
+            if (msg.data.size() < 2)
+                return;
+            u16 raw = msg.data.get_u16_le(0);
+            if (raw > 0xFAFF)
+                return; // Error or not available
+            auto direction = msg.data.size() >= 8 ? static_cast<MachineDirection>(msg.data[7] & 0x03)
+                                                  : MachineDirection::NotAvailable;
+            add_sample(input, static_cast<f64>(raw) * 0.001, msg.timestamp_us, direction);
+        }
+
+        void handle_cog_sog(const MessageView &msg) {
+            if (msg.data.size() < 6)
+                return;
+            u16 raw = msg.data.get_u16_le(4); // 0.01 m/s
+            if (raw > 0xFAFF)
+                return;
+            add_sample(SpeedInput::Gnss, static_cast<f64>(raw) * 0.01, msg.timestamp_us);
+        }
+    };
+
+} // namespace agrobus::isobus::implement
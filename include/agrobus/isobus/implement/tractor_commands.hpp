@@ -6,6 +6,8 @@
 #include <agrobus/net/internal_cf.hpp>
 #include <agrobus/net/message.hpp>
 #include <agrobus/net/network_manager.hpp>
+#include <agrobus/net/pgn_codec.hpp>
+#include <algorithm>
 #include <datapod/datapod.hpp>
 #include <echo/echo.hpp>
 
@@ -20,107 +22,51 @@ namespace agrobus::isobus::implement {
     enum class ValveCommand : u8 { NoAction = 0, Extend = 1, Retract = 2, Float = 3, Block = 4 };
 
     // ─── Hitch Command Message (ISO 11783-7) ────────────────────────────────────
+    // Bytes 0-1: target position (0.0025%/bit), byte 2: reserved, byte 3: rate
+    // of change, byte 4: command (bits 0-1, the rest of the byte sent as 0)
     struct HitchCommandMsg {
         HitchCommand command = HitchCommand::NoAction;
         u16 target_position = 0xFFFF; // 0-100% scaled to 0-40000
         u8 rate = 0xFF;               // Rate of change
 
-        dp::Vector<u8> encode() const {
-            dp::Vector<u8> data(8, 0xFF);
-            // Byte 0-1: Target position (0.0025% per bit, 0-100%)
-            data[0] = static_cast<u8>(target_position & 0xFF);
-            data[1] = static_cast<u8>((target_position >> 8) & 0xFF);
-            // Byte 2: Reserved
-            data[2] = 0xFF;
-            // Byte 3: Rate of change
-            data[3] = rate;
-            // Byte 4: Command (bits 0-1)
-            data[4] = static_cast<u8>(command);
-            // Bytes 5-7: Reserved
-            data[5] = 0xFF;
-            data[6] = 0xFF;
-            data[7] = 0xFF;
-            return data;
-        }
+        using Codec = PgnCodec<HitchCommandMsg, Field<&HitchCommandMsg::target_position, 0, 16>,
+                               Field<&HitchCommandMsg::rate, 24, 8>, Field<&HitchCommandMsg::command, 32, 2>,
+                               Fixed<34, 6>>;
 
-        static HitchCommandMsg decode(const dp::Vector<u8> &data) {
-            HitchCommandMsg msg;
-            if (data.size() >= 5) {
-                msg.target_position = static_cast<u16>(data[0]) | (static_cast<u16>(data[1]) << 8);
-                msg.rate = data[3];
-                msg.command = static_cast<HitchCommand>(data[4] & 0x03);
-            }
-            return msg;
-        }
+        dp::Vector<u8> encode() const { return Codec::encode(*this); }
+        static HitchCommandMsg decode(DataSpan data) { return Codec::decode(data); }
     };
 
     // ─── PTO Command Message (ISO 11783-7) ──────────────────────────────────────
+    // Bytes 0-1: target speed (0.125 rpm/bit), byte 2: reserved, byte 3: ramp
+    // rate, byte 4: command (bits 0-1, the rest of the byte sent as 0)
     struct PTOCommandMsg {
         PTOCommand command = PTOCommand::NoAction;
         u16 target_speed_rpm = 0xFFFF; // 0.125 rpm per bit
         u8 ramp_rate = 0xFF;           // Rate of change
 
-        dp::Vector<u8> encode() const {
-            dp::Vector<u8> data(8, 0xFF);
-            // Byte 0-1: Target speed (0.125 rpm/bit)
-            data[0] = static_cast<u8>(target_speed_rpm & 0xFF);
-            data[1] = static_cast<u8>((target_speed_rpm >> 8) & 0xFF);
-            // Byte 2: Reserved
-            data[2] = 0xFF;
-            // Byte 3: Ramp rate
-            data[3] = ramp_rate;
-            // Byte 4: Command (bits 0-1)
-            data[4] = static_cast<u8>(command);
-            // Bytes 5-7: Reserved
-            data[5] = 0xFF;
-            data[6] = 0xFF;
-            data[7] = 0xFF;
-            return data;
-        }
+        using Codec = PgnCodec<PTOCommandMsg, Field<&PTOCommandMsg::target_speed_rpm, 0, 16>,
+                               Field<&PTOCommandMsg::ramp_rate, 24, 8>, Field<&PTOCommandMsg::command, 32, 2>,
+                               Fixed<34, 6>>;
 
-        static PTOCommandMsg decode(const dp::Vector<u8> &data) {
-            PTOCommandMsg msg;
-            if (data.size() >= 5) {
-                msg.target_speed_rpm = static_cast<u16>(data[0]) | (static_cast<u16>(data[1]) << 8);
-                msg.ramp_rate = data[3];
-                msg.command = static_cast<PTOCommand>(data[4] & 0x03);
-            }
-            return msg;
-        }
+        dp::Vector<u8> encode() const { return Codec::encode(*this); }
+        static PTOCommandMsg decode(DataSpan data) { return Codec::decode(data); }
     };
 
     // ─── Auxiliary Valve Command Message (ISO 11783-7) ───────────────────────────
+    // Byte 0: valve index, bytes 1-2: flow rate (0.4%/bit), byte 3: command
+    // (bits 0-2, the rest of the byte sent as 0)
     struct AuxValveCommandMsg {
         u8 valve_index = 0;
         ValveCommand command = ValveCommand::NoAction;
         u16 flow_rate = 0xFFFF; // % of max (0.4% per bit, 0-100%)
 
-        dp::Vector<u8> encode() const {
-            dp::Vector<u8> data(8, 0xFF);
-            // Byte 0: Valve index
-            data[0] = valve_index;
-            // Byte 1-2: Flow rate (0.4% per bit)
-            data[1] = static_cast<u8>(flow_rate & 0xFF);
-            data[2] = static_cast<u8>((flow_rate >> 8) & 0xFF);
-            // Byte 3: Command (bits 0-2)
-            data[3] = static_cast<u8>(command);
-            // Bytes 4-7: Reserved
-            data[4] = 0xFF;
-            data[5] = 0xFF;
-            data[6] = 0xFF;
-            data[7] = 0xFF;
-            return data;
-        }
+        using Codec = PgnCodec<AuxValveCommandMsg, Field<&AuxValveCommandMsg::valve_index, 0, 8>,
+                               Field<&AuxValveCommandMsg::flow_rate, 8, 16>,
+                               Field<&AuxValveCommandMsg::command, 24, 3>, Fixed<27, 5>>;
 
-        static AuxValveCommandMsg decode(const dp::Vector<u8> &data) {
-            AuxValveCommandMsg msg;
-            if (data.size() >= 4) {
-                msg.valve_index = data[0];
-                msg.flow_rate = static_cast<u16>(data[1]) | (static_cast<u16>(data[2]) << 8);
-                msg.command = static_cast<ValveCommand>(data[3] & 0x07);
-            }
-            return msg;
-        }
+        dp::Vector<u8> encode() const { return Codec::encode(*this); }
+        static AuxValveCommandMsg decode(DataSpan data) { return Codec::decode(data); }
     };
 
     // ─── Tractor Control Mode (ISO 11783-7, PGN 0xFE4D) ─────────────────────────
@@ -134,28 +80,15 @@ namespace agrobus::isobus::implement {
         TractorMode front_pto_mode = TractorMode::NotAvailable;   // 2 bits: front PTO control mode
         u8 speed_control_state = 0xFF;                            // 0xFF = N/A, bit-encoded speed control modes
 
-        dp::Vector<u8> encode() const {
-            dp::Vector<u8> data(8, 0xFF);
-            // Byte 0: bits 0-1: rear hitch, bits 2-3: rear PTO,
-            //         bits 4-5: front hitch, bits 6-7: front PTO
-            data[0] = (static_cast<u8>(hitch_mode) & 0x03) | ((static_cast<u8>(pto_mode) & 0x03) << 2) |
-                      ((static_cast<u8>(front_hitch_mode) & 0x03) << 4) |
-                      ((static_cast<u8>(front_pto_mode) & 0x03) << 6);
-            data[1] = speed_control_state;
-            return data;
-        }
+        // Byte 0: rear hitch, rear PTO, front hitch, front PTO (2 bits each); byte 1: speed control
+        using Codec = PgnCodec<TractorControlModeMsg, Field<&TractorControlModeMsg::hitch_mode, 0, 2>,
+                               Field<&TractorControlModeMsg::pto_mode, 2, 2>,
+                               Field<&TractorControlModeMsg::front_hitch_mode, 4, 2>,
+                               Field<&TractorControlModeMsg::front_pto_mode, 6, 2>,
+                               Field<&TractorControlModeMsg::speed_control_state, 8, 8>>;
 
-        static TractorControlModeMsg decode(const dp::Vector<u8> &data) {
-            TractorControlModeMsg msg;
-            if (data.size() >= 2) {
-                msg.hitch_mode = static_cast<TractorMode>(data[0] & 0x03);
-                msg.pto_mode = static_cast<TractorMode>((data[0] >> 2) & 0x03);
-                msg.front_hitch_mode = static_cast<TractorMode>((data[0] >> 4) & 0x03);
-                msg.front_pto_mode = static_cast<TractorMode>((data[0] >> 6) & 0x03);
-                msg.speed_control_state = data[1];
-            }
-            return msg;
-        }
+        dp::Vector<u8> encode() const { return Codec::encode(*this); }
+        static TractorControlModeMsg decode(DataSpan data) { return Codec::decode(data); }
     };
 
     // ─── Tractor Command Interface (ISO 11783-7) ────────────────────────────────
@@ -277,4 +210,162 @@ namespace agrobus::isobus::implement {
         Event<TractorControlModeMsg> on_control_mode;
     };
 
+    // ─── Command arbitration ─────────────────────────────────────────────────────
+    enum class CommandTarget : u8 { RearHitch, FrontHitch, RearPTO, FrontPTO, AuxValve0 };
+
+    inline constexpr usize COMMAND_TARGETS = static_cast<usize>(CommandTarget::AuxValve0) + 16;
+
+    struct CommandArbiterConfig {
+        u32 slot_ms = 20;       // One send slot per this period
+        u32 keepalive_ms = 100; // An unchanged command is repeated this often
+
+        CommandArbiterConfig &slot(u32 ms) {
+            slot_ms = ms == 0 ? 1 : ms;
+            return *this;
+        }
+        CommandArbiterConfig &keepalive(u32 ms) {
+            keepalive_ms = ms;
+            return *this;
+        }
+    };
+
+    struct CommandArbiterStats {
+        u64 requests = 0;   // request_* calls
+        u64 merged = 0;     // Requests replaced by a later one before their slot
+        u64 sent = 0;       // Commands put on the bus
+        u64 suppressed = 0; // Slots where an unchanged command was held back
+    };
+
+    // ─── Tractor command arbiter ────────────────────────────────────────────────
+    // Sits between the implement functions and the bus for hitch, PTO and aux
+    // valve commands. Requests only update the target's wanted command; one
+    // periodic timer slot on the IsoNet clock sends, per target, the latest
+    // request if it differs from what was last sent, or repeats it once
+    // keepalive_ms has passed. Several functions asking for the same hitch in
+    // one tick produce one frame, and a steady command costs one frame per
+    // keep-alive period. release() stops commanding a target.
+    class TractorCommandArbiter {
+        struct Target {
+            dp::Array<u8, 8> wanted{};
+            dp::Array<u8, 8> last{};
+            u64 last_ms = 0;
+            bool active = false;  // Has a wanted command
+            bool pending = false; // Requested since the last slot
+            bool sent = false;    // last holds a sent command
+        };
+
+        IsoNet &net_;
+        InternalCF *cf_;
+        CommandArbiterConfig config_;
+        dp::Array<Target, COMMAND_TARGETS> targets_{};
+        dp::Vector<u8> payload_; // Reused for every send
+        CommandArbiterStats stats_;
+        TimerId timer_ = INVALID_TIMER;
+
+      public:
+        TractorCommandArbiter(IsoNet &net, InternalCF *cf, CommandArbiterConfig config = {})
+            : net_(net), cf_(cf), config_(config), payload_(8, 0xFF) {}
+
+        // The timer callback points at this object
+        TractorCommandArbiter(const TractorCommandArbiter &) = delete;
+        TractorCommandArbiter &operator=(const TractorCommandArbiter &) = delete;
+
+        ~TractorCommandArbiter() { net_.timers().cancel(timer_); }
+
+        Result<void> initialize() {
+            if (!cf_) {
+                return Result<void>::err(Error::invalid_state("control function not set"));
+            }
+            if (timer_ == INVALID_TIMER)
+                timer_ = net_.timers().schedule_every(config_.slot_ms, 0, [this]() { flush(); });
+            return {};
+        }
+
+        // ─── Requests (latest per target wins until the next slot) ─────────────
+        void request_rear_hitch(const HitchCommandMsg &cmd) { request(CommandTarget::RearHitch, cmd.encode()); }
+        void request_front_hitch(const HitchCommandMsg &cmd) { request(CommandTarget::FrontHitch, cmd.encode()); }
+        void request_rear_pto(const PTOCommandMsg &cmd) { request(CommandTarget::RearPTO, cmd.encode()); }
+        void request_front_pto(const PTOCommandMsg &cmd) { request(CommandTarget::FrontPTO, cmd.encode()); }
+
+        Result<void> request_aux_valve(const AuxValveCommandMsg &cmd) {
+            if (cmd.valve_index >= 16) {
+                return Result<void>::err(Error::invalid_state("aux valve index out of range"));
+            }
+            request(aux_valve(cmd.valve_index), cmd.encode());
+            return {};
+        }
+
+        // Stop commanding a target (nothing more is sent for it)
+        void release(CommandTarget target) {
+            Target &t = targets_[index(target)];
+            t.active = false;
+            t.pending = false;
+            t.sent = false;
+        }
+
+        bool active(CommandTarget target) const noexcept { return targets_[index(target)].active; }
+
+        static constexpr CommandTarget aux_valve(u8 valve_index) noexcept {
+            return static_cast<CommandTarget>(static_cast<u8>(CommandTarget::AuxValve0) + (valve_index & 0x0F));
+        }
+
+        static constexpr PGN pgn_of(CommandTarget target) noexcept {
+            switch (target) {
+            case CommandTarget::RearHitch:
+                return PGN_REAR_HITCH_CMD;
+            case CommandTarget::FrontHitch:
+                return PGN_FRONT_HITCH_CMD;
+            case CommandTarget::RearPTO:
+                return PGN_REAR_PTO_CMD;
+            case CommandTarget::FrontPTO:
+                return PGN_FRONT_PTO_CMD;
+            default:
+                return PGN_AUX_VALVE_CMD + (static_cast<u8>(target) - static_cast<u8>(CommandTarget::AuxValve0));
+            }
+        }
+
+        const CommandArbiterStats &stats() const noexcept { return stats_; }
+
+        // Run one send slot now (the timer does this every slot_ms)
+        void flush() {
+            u64 now = net_.timers().now_ms();
+            for (usize i = 0; i < COMMAND_TARGETS; ++i) {
+                Target &t = targets_[i];
+                if (!t.active)
+                    continue;
+                t.pending = false;
+                bool changed = !t.sent || !std::equal(t.wanted.begin(), t.wanted.end(), t.last.begin());
+                if (!changed && now - t.last_ms < config_.keepalive_ms) {
+                    ++stats_.suppressed;
+                    continue;
+                }
+                for (usize b = 0; b < 8; ++b)
+                    payload_[b] = t.wanted[b];
+                auto result = net_.send(pgn_of(static_cast<CommandTarget>(i)), payload_, cf_);
+                if (result.is_err()) {
+                    echo::category("isobus.implement.tractor").warn("arbitrated command not sent: target=", i);
+                    continue; // Retried next slot
+                }
+                t.last = t.wanted;
+                t.last_ms = now;
+                t.sent = true;
+                ++stats_.sent;
+            }
+        }
+
+      private:
+        static constexpr usize index(CommandTarget target) noexcept { return static_cast<usize>(target); }
+
+        void request(CommandTarget target, const dp::Vector<u8> &data) {
+            Target &t = targets_[index(target)];
+            ++stats_.requests;
+            if (t.pending)
+                ++stats_.merged;
+            for (usize b = 0; b < 8; ++b)
+                t.wanted[b] = data[b];
+            t.active = true;
+            t.pending = true;
+        }
+    };
+
 } // namespace agrobus::isobus::implement
@@ -6,6 +6,7 @@
 #include <agrobus/net/internal_cf.hpp>
 #include <agrobus/net/message.hpp>
 #include <agrobus/net/network_manager.hpp>
+#include <agrobus/net/pgn_codec.hpp>
 #include <datapod/datapod.hpp>
 #include <echo/echo.hpp>
 
@@ -77,167 +78,53 @@ namespace agrobus::isobus::implement {
         bool front_pto_speed_limit_status = false;
         bool front_pto_exit_code = false;
 
-        // ─── Encode to 8 bytes (one bit per facility) ───────────────────────────
-        dp::Vector<u8> encode() const {
-            dp::Vector<u8> data(8, 0xFF);
-
-            // Byte 0: Class 1 + start of Class 2
-            data[0] = 0;
-            if (rear_hitch_position)
-                data[0] |= (1u << 0);
-            if (rear_hitch_in_work)
-                data[0] |= (1u << 1);
-            if (rear_pto_speed)
-                data[0] |= (1u << 2);
-            if (rear_pto_engagement)
-                data[0] |= (1u << 3);
-            if (wheel_based_speed)
-                data[0] |= (1u << 4);
-            if (ground_based_speed)
-                data[0] |= (1u << 5);
-            if (ground_based_distance)
-                data[0] |= (1u << 6);
-            if (ground_based_direction)
-                data[0] |= (1u << 7);
-
-            // Byte 1: Class 2 (cont) + Class 3
-            data[1] = 0;
-            if (wheel_based_distance)
-                data[1] |= (1u << 0);
-            if (wheel_based_direction)
-                data[1] |= (1u << 1);
-            if (rear_draft)
-                data[1] |= (1u << 2);
-            if (lighting)
-                data[1] |= (1u << 3);
-            if (aux_valve_flow)
-                data[1] |= (1u << 4);
-            if (rear_hitch_command)
-                data[1] |= (1u << 5);
-            if (rear_pto_command)
-                data[1] |= (1u << 6);
-            if (aux_valve_command)
-                data[1] |= (1u << 7);
-
-            // Byte 2: Front-mounted + Navigation + Guidance
-            data[2] = 0;
-            if (front_hitch_position)
-                data[2] |= (1u << 0);
-            if (front_hitch_in_work)
-                data[2] |= (1u << 1);
-            if (front_pto_speed)
-                data[2] |= (1u << 2);
-            if (front_pto_engagement)
-                data[2] |= (1u << 3);
-            if (front_hitch_command)
-                data[2] |= (1u << 4);
-            if (front_pto_command)
-                data[2] |= (1u << 5);
-            if (navigation)
-                data[2] |= (1u << 6);
-            if (guidance)
-                data[2] |= (1u << 7);
-
-            // Byte 3: Powertrain + v2 Class 3 limit/exit bits
-            data[3] = 0;
-            if (machine_selected_speed)
-                data[3] |= (1u << 0);
-            if (machine_selected_speed_command)
-                data[3] |= (1u << 1);
-            if (rear_hitch_limit_status)
-                data[3] |= (1u << 2);
-            if (rear_hitch_exit_code)
-                data[3] |= (1u << 3);
-            if (rear_pto_engagement_request)
-                data[3] |= (1u << 4);
-            if (rear_pto_speed_limit_status)
-                data[3] |= (1u << 5);
-            if (rear_pto_exit_code)
-                data[3] |= (1u << 6);
-            if (aux_valve_limit_status)
-                data[3] |= (1u << 7);
-
-            // Byte 4: v2 aux valve exit + front F addendum limit/exit bits
-            data[4] = 0xC0; // reserved bits 6-7 set to 1
-            if (aux_valve_exit_code)
-                data[4] |= (1u << 0);
-            if (front_hitch_limit_status)
-                data[4] |= (1u << 1);
-            if (front_hitch_exit_code)
-                data[4] |= (1u << 2);
-            if (front_pto_engagement_request)
-                data[4] |= (1u << 3);
-            if (front_pto_speed_limit_status)
-                data[4] |= (1u << 4);
-            if (front_pto_exit_code)
-                data[4] |= (1u << 5);
-
-            // Bytes 5-7: Reserved (0xFF)
-            data[5] = 0xFF;
-            data[6] = 0xFF;
-            data[7] = 0xFF;
-
-            return data;
-        }
-
-        // ─── Decode from 8-byte message data ────────────────────────────────────
-        static TractorFacilities decode(const dp::Vector<u8> &data) {
-            TractorFacilities f;
-            if (data.size() < 4)
-                return f;
-
-            // Byte 0
-            f.rear_hitch_position = (data[0] >> 0) & 0x01;
-            f.rear_hitch_in_work = (data[0] >> 1) & 0x01;
-            f.rear_pto_speed = (data[0] >> 2) & 0x01;
-            f.rear_pto_engagement = (data[0] >> 3) & 0x01;
-            f.wheel_based_speed = (data[0] >> 4) & 0x01;
-            f.ground_based_speed = (data[0] >> 5) & 0x01;
-            f.ground_based_distance = (data[0] >> 6) & 0x01;
-            f.ground_based_direction = (data[0] >> 7) & 0x01;
-
-            // Byte 1
-            f.wheel_based_distance = (data[1] >> 0) & 0x01;
-            f.wheel_based_direction = (data[1] >> 1) & 0x01;
-            f.rear_draft = (data[1] >> 2) & 0x01;
-            f.lighting = (data[1] >> 3) & 0x01;
-            f.aux_valve_flow = (data[1] >> 4) & 0x01;
-            f.rear_hitch_command = (data[1] >> 5) & 0x01;
-            f.rear_pto_command = (data[1] >> 6) & 0x01;
-            f.aux_valve_command = (data[1] >> 7) & 0x01;
-
-            // Byte 2
-            f.front_hitch_position = (data[2] >> 0) & 0x01;
-            f.front_hitch_in_work = (data[2] >> 1) & 0x01;
-            f.front_pto_speed = (data[2] >> 2) & 0x01;
-            f.front_pto_engagement = (data[2] >> 3) & 0x01;
-            f.front_hitch_command = (data[2] >> 4) & 0x01;
-            f.front_pto_command = (data[2] >> 5) & 0x01;
-            f.navigation = (data[2] >> 6) & 0x01;
-            f.guidance = (data[2] >> 7) & 0x01;
-
-            // Byte 3: Powertrain + v2 Class 3 limit/exit bits
-            f.machine_selected_speed = (data[3] >> 0) & 0x01;
-            f.machine_selected_speed_command = (data[3] >> 1) & 0x01;
-            f.rear_hitch_limit_status = (data[3] >> 2) & 0x01;
-            f.rear_hitch_exit_code = (data[3] >> 3) & 0x01;
-            f.rear_pto_engagement_request = (data[3] >> 4) & 0x01;
-            f.rear_pto_speed_limit_status = (data[3] >> 5) & 0x01;
-            f.rear_pto_exit_code = (data[3] >> 6) & 0x01;
-            f.aux_valve_limit_status = (data[3] >> 7) & 0x01;
-
-            // Byte 4: v2 front F addendum limit/exit bits
-            if (data.size() >= 5) {
-                f.aux_valve_exit_code = (data[4] >> 0) & 0x01;
-                f.front_hitch_limit_status = (data[4] >> 1) & 0x01;
-                f.front_hitch_exit_code = (data[4] >> 2) & 0x01;
-                f.front_pto_engagement_request = (data[4] >> 3) & 0x01;
-                f.front_pto_speed_limit_status = (data[4] >> 4) & 0x01;
-                f.front_pto_exit_code = (data[4] >> 5) & 0x01;
-            }
-
-            return f;
-        }
+        // ─── Wire layout: one bit per facility ──────────────────────────────────
+        // Bytes 0-3: Class 1/2/3, front (F), navigation (N), guidance (G),
+        // powertrain (P) and v2 Class 3 limit/exit bits. Byte 4 (bits 0-5): v2
+        // aux valve exit and front limit/exit bits, absent from 4-byte v1
+        // responses. Bits 38-63 are reserved (1).
+        using Codec = PgnCodec<TractorFacilities,
+                               Field<&TractorFacilities::rear_hitch_position, 0, 1>,
+                               Field<&TractorFacilities::rear_hitch_in_work, 1, 1>,
+                               Field<&TractorFacilities::rear_pto_speed, 2, 1>,
+                               Field<&TractorFacilities::rear_pto_engagement, 3, 1>,
+                               Field<&TractorFacilities::wheel_based_speed, 4, 1>,
+                               Field<&TractorFacilities::ground_based_speed, 5, 1>,
+                               Field<&TractorFacilities::ground_based_distance, 6, 1>,
+                               Field<&TractorFacilities::ground_based_direction, 7, 1>,
+                               Field<&TractorFacilities::wheel_based_distance, 8, 1>,
+                               Field<&TractorFacilities::wheel_based_direction, 9, 1>,
+                               Field<&TractorFacilities::rear_draft, 10, 1>,
+                               Field<&TractorFacilities::lighting, 11, 1>,
+                               Field<&TractorFacilities::aux_valve_flow, 12, 1>,
+                               Field<&TractorFacilities::rear_hitch_command, 13, 1>,
+                               Field<&TractorFacilities::rear_pto_command, 14, 1>,
+                               Field<&TractorFacilities::aux_valve_command, 15, 1>,
+                               Field<&TractorFacilities::front_hitch_position, 16, 1>,
+                               Field<&TractorFacilities::front_hitch_in_work, 17, 1>,
+                               Field<&TractorFacilities::front_pto_speed, 18, 1>,
+                               Field<&TractorFacilities::front_pto_engagement, 19, 1>,
+                               Field<&TractorFacilities::front_hitch_command, 20, 1>,
+                               Field<&TractorFacilities::front_pto_command, 21, 1>,
+                               Field<&TractorFacilities::navigation, 22, 1>,
+                               Field<&TractorFacilities::guidance, 23, 1>,
+                               Field<&TractorFacilities::machine_selected_speed, 24, 1>,
+                               Field<&TractorFacilities::machine_selected_speed_command, 25, 1>,
+                               Field<&TractorFacilities::rear_hitch_limit_status, 26, 1>,
+                               Field<&TractorFacilities::rear_hitch_exit_code, 27, 1>,
+                               Field<&TractorFacilities::rear_pto_engagement_request, 28, 1>,
+                               Field<&TractorFacilities::rear_pto_speed_limit_status, 29, 1>,
+                               Field<&TractorFacilities::rear_pto_exit_code, 30, 1>,
+                               Field<&TractorFacilities::aux_valve_limit_status, 31, 1>,
+                               Trailing<Field<&TractorFacilities::aux_valve_exit_code, 32, 1>>,
+                               Trailing<Field<&TractorFacilities::front_hitch_limit_status, 33, 1>>,
+                               Trailing<Field<&TractorFacilities::front_hitch_exit_code, 34, 1>>,
+                               Trailing<Field<&TractorFacilities::front_pto_engagement_request, 35, 1>>,
+                               Trailing<Field<&TractorFacilities::front_pto_speed_limit_status, 36, 1>>,
+                               Trailing<Field<&TractorFacilities::front_pto_exit_code, 37, 1>>>;
+
+        dp::Vector<u8> encode() const { return Codec::encode(*this); }
+        static TractorFacilities decode(DataSpan data) { return Codec::decode(data); }
 
         // ─── Fluent setters ─────────────────────────────────────────────────────
         TractorFacilities &set_class1_all() {
@@ -25,6 +25,7 @@ namespace agrobus::isobus::sc {
         u32 last_status_sent_ms_ = 0;
         u32 time_since_last_status_ms_ = 0;
         bool status_pending_ = false;
+        bool status_sent_ = false; // The first status has no spacing to keep
 
         u16 current_step_id_ = 0;
 
@@ -115,7 +116,7 @@ namespace agrobus::isobus::sc {
 
       private:
         void request_status_send() {
-            if (time_since_last_status_ms_ >= config_.min_status_spacing_ms) {
+            if (!status_sent_ || time_since_last_status_ms_ >= config_.min_status_spacing_ms) {
                 send_client_status();
             } else {
                 status_pending_ = true;
@@ -158,6 +159,7 @@ namespace agrobus::isobus::sc {
 
             net_.send(PGN_SC_CLIENT_STATUS, data, cf_, nullptr, Priority::Default);
             time_since_last_status_ms_ = 0;
+            status_sent_ = true;
         }
 
         // ─── ISO 11783-14 F.2: Decode SCMasterStatus message ────────────────────────
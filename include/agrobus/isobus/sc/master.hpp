@@ -7,12 +7,19 @@
 #include <agrobus/net/network_manager.hpp>
 #include <agrobus/net/state_machine.hpp>
 #include <datapod/datapod.hpp>
+#include <chrono>
 #include <echo/echo.hpp>
 
 namespace agrobus::isobus::sc {
     using namespace agrobus::net;
 
     // ─── ISO 11783-14 Sequence Control Master ────────────────────────────────────
+    // Event driven: a client status, step_completed() or a command changes the
+    // state at once and (with immediate_status) the new status goes out in the
+    // same call, so step-to-step latency does not depend on the update() period.
+    // The periodic status is a timer on the IsoNet timer wheel, running from
+    // start() until the sequence ends; update() only keeps the timeouts.
+    // Neither copyable nor movable: the timer and callbacks hold `this`.
     class SCMaster {
         IsoNet &net_;
         InternalCF *cf_;
@@ -20,9 +27,11 @@ namespace agrobus::isobus::sc {
         StateMachine<SCState> state_machine_{SCState::Idle};
 
         dp::Vector<SequenceStep> steps_;
+        dp::Vector<SCStepTiming> timings_; // One per step, laid out by start()
+        dp::Array<u8, 256> acked_{};       // Address -> index + 1 of the last step it reported
         usize current_step_index_ = 0;
 
-        u32 status_timer_ms_ = 0;
+        TimerId status_timer_ = INVALID_TIMER;
         u32 ready_timer_ms_ = 0;
         u32 active_timer_ms_ = 0;
         bool client_ack_received_ = false;
@@ -34,12 +43,21 @@ namespace agrobus::isobus::sc {
 
             // Forward state machine transitions to our event
             state_machine_.on_transition.subscribe([this](SCState old_state, SCState new_state) {
+                if (!running())
+                    stop_status();
                 on_state_change.emit(old_state, new_state);
                 echo::category("isobus.sc.master")
                     .debug("state: ", static_cast<int>(old_state), " -> ", static_cast<int>(new_state));
             });
         }
 
+        SCMaster(const SCMaster &) = delete;
+        SCMaster &operator=(const SCMaster &) = delete;
+        SCMaster(SCMaster &&) = delete;
+        SCMaster &operator=(SCMaster &&) = delete;
+
+        ~SCMaster() { net_.timers().cancel(status_timer_); }
+
         // ─── Initialization ─────────────────────────────────────────────────────
         Result<void> initialize() {
             if (!cf_) {
@@ -79,8 +97,17 @@ namespace agrobus::isobus::sc {
 
             current_step_index_ = 0;
             ready_timer_ms_ = 0;
-            status_timer_ms_ = 0;
+            timings_.clear();
+            timings_.reserve(steps_.size());
+            for (const auto &step : steps_) {
+                SCStepTiming timing;
+                timing.step_id = step.step_id;
+                timings_.push_back(timing);
+            }
+            acked_.fill(0);
             state_machine_.transition(SCState::Ready);
+            arm_status();
+            status_changed();
             echo::category("isobus.sc.master").info("sequence started, entering Ready");
             return {};
         }
@@ -91,6 +118,7 @@ namespace agrobus::isobus::sc {
                 return Result<void>::err(Error::invalid_state("nothing to abort"));
             }
             state_machine_.transition(SCState::Error);
+            status_changed();
             echo::category("isobus.sc.master").warn("sequence aborted");
             return {};
         }
@@ -100,6 +128,7 @@ namespace agrobus::isobus::sc {
                 return Result<void>::err(Error::invalid_state("can only pause in Active state"));
             }
             state_machine_.transition(SCState::Paused);
+            status_changed();
             echo::category("isobus.sc.master").info("sequence paused");
             return {};
         }
@@ -111,6 +140,7 @@ namespace agrobus::isobus::sc {
             active_timer_ms_ = 0;
             client_ack_received_ = false;
             state_machine_.transition(SCState::Active);
+            status_changed();
             echo::category("isobus.sc.master").info("sequence resumed");
             return {};
         }
@@ -128,6 +158,7 @@ namespace agrobus::isobus::sc {
             }
 
             steps_[current_step_index_].completed = true;
+            timings_[current_step_index_].completed_us = now_us();
             on_step_completed.emit(step_id);
             echo::category("isobus.sc.master").debug("step completed: ", step_id);
 
@@ -136,13 +167,11 @@ namespace agrobus::isobus::sc {
             if (current_step_index_ >= steps_.size()) {
                 // All steps complete
                 state_machine_.transition(SCState::Complete);
+                status_changed();
                 on_sequence_complete.emit();
                 echo::category("isobus.sc.master").info("sequence complete");
             } else {
-                // Start next step
-                active_timer_ms_ = 0;
-                client_ack_received_ = false;
-                on_step_started.emit(steps_[current_step_index_].step_id);
+                begin_step();
                 echo::category("isobus.sc.master").debug("step started: ", steps_[current_step_index_].step_id);
             }
             return {};
@@ -150,17 +179,8 @@ namespace agrobus::isobus::sc {
 
         // ─── Periodic update ─────────────────────────────────────────────────────
         void update(u32 elapsed_ms) {
-            if (state_machine_.is(SCState::Idle) || state_machine_.is(SCState::Complete) ||
-                state_machine_.is(SCState::Error)) {
+            if (!running())
                 return;
-            }
-
-            // Send periodic status messages
-            status_timer_ms_ += elapsed_ms;
-            if (status_timer_ms_ >= config_.status_interval_ms) {
-                status_timer_ms_ -= config_.status_interval_ms;
-                send_master_status();
-            }
 
             if (state_machine_.is(SCState::Ready)) {
                 ready_timer_ms_ += elapsed_ms;
@@ -185,6 +205,14 @@ namespace agrobus::isobus::sc {
         SCState state() const noexcept { return state_machine_.state(); }
         bool is(SCState s) const noexcept { return state_machine_.is(s); }
 
+        // ─── Step timing ─────────────────────────────────────────────────────────
+        // One entry per step of the running (or last) sequence, in step order
+        const dp::Vector<SCStepTiming> &timings() const noexcept { return timings_; }
+
+        const SCStepTiming *current_timing() const noexcept {
+            return current_step_index_ < timings_.size() ? &timings_[current_step_index_] : nullptr;
+        }
+
         // ─── Busy flags (ISO 11783-14 F.2, byte 5) ──────────────────────────────
         void set_busy_nv_memory(bool busy) noexcept { busy_nv_memory_ = busy; }
         void set_busy_parsing_scd(bool busy) noexcept { busy_parsing_scd_ = busy; }
@@ -198,6 +226,62 @@ namespace agrobus::isobus::sc {
         Event<Address, SCState> on_client_status;
 
       private:
+        static u64 now_us() noexcept {
+            return static_cast<u64>(std::chrono::duration_cast<std::chrono::microseconds>(
+                                        std::chrono::steady_clock::now().time_since_epoch())
+                                        .count());
+        }
+
+        // The current step goes out: timers reset, timing starts, clients told
+        void begin_step() {
+            active_timer_ms_ = 0;
+            client_ack_received_ = false;
+            timings_[current_step_index_].started_us = now_us();
+            status_changed();
+            on_step_started.emit(steps_[current_step_index_].step_id);
+        }
+
+        void status_changed() {
+            if (!config_.immediate_status)
+                return;
+            send_master_status();
+            if (running())
+                arm_status(); // The next periodic status is one interval after this one
+        }
+
+        bool running() const noexcept {
+            return !state_machine_.is(SCState::Idle) && !state_machine_.is(SCState::Complete) &&
+                   !state_machine_.is(SCState::Error);
+        }
+
+        // Periodic status on the network clock, anchored at the last status sent
+        void arm_status() {
+            net_.timers().cancel(status_timer_);
+            u32 interval = config_.status_interval_ms;
+            u32 phase = interval == 0 ? 0 : static_cast<u32>(net_.timers().now_ms() % interval);
+            status_timer_ = net_.timers().schedule_every(interval, phase, [this]() { send_master_status(); });
+        }
+
+        void stop_status() {
+            net_.timers().cancel(status_timer_);
+            status_timer_ = INVALID_TIMER;
+        }
+
+        // A client reporting PlayBack with our sequence number has the step
+        void record_ack(Address client, u8 seq_num) {
+            usize index = current_step_index_;
+            if (index >= timings_.size() || seq_num != (index <= 0x31 ? index : 0x31))
+                return;
+            if (acked_[client] == index + 1)
+                return;
+            acked_[client] = static_cast<u8>(index + 1);
+            SCStepTiming &timing = timings_[index];
+            u64 now = now_us();
+            if (timing.acks++ == 0)
+                timing.first_ack_us = now;
+            timing.last_ack_us = now;
+        }
+
         // ─── ISO 11783-14 state mapping helpers ──────────────────────────────────
         SCMasterState iso_master_state() const noexcept {
             switch (state_machine_.state()) {
@@ -284,12 +368,8 @@ namespace agrobus::isobus::sc {
 
             // In Ready state, if client reports Ready, transition to Active
             if (state_machine_.is(SCState::Ready) && mapped_state == SCState::Ready) {
-                active_timer_ms_ = 0;
-                client_ack_received_ = false;
                 state_machine_.transition(SCState::Active);
-                if (!steps_.empty()) {
-                    on_step_started.emit(steps_[0].step_id);
-                }
+                begin_step();
                 echo::category("isobus.sc.master").info("client ready, entering Active");
             }
 
@@ -297,6 +377,7 @@ namespace agrobus::isobus::sc {
             if (state_machine_.is(SCState::Active) && mapped_state == SCState::Active) {
                 client_ack_received_ = true;
                 active_timer_ms_ = 0;
+                record_ack(client_addr, msg.get_u8(2));
             }
         }
     };
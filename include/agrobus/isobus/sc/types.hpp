@@ -56,11 +56,28 @@ namespace agrobus::isobus::sc {
         bool completed = false;
     };
 
+    // ─── Per-step timing ───────────────────────────────────────────────────────────
+    // Microseconds on the master's steady clock: when the step went out, when
+    // the first and the last client reported it in PlayBack, when it completed.
+    struct SCStepTiming {
+        u16 step_id = 0;
+        u64 started_us = 0;
+        u64 first_ack_us = 0; // 0: no client reported the step yet
+        u64 last_ack_us = 0;
+        u64 completed_us = 0; // 0: still running
+        u8 acks = 0;          // Clients that reported the step
+
+        u64 ack_latency_us() const noexcept { return first_ack_us ? first_ack_us - started_us : 0; }
+        u64 spread_us() const noexcept { return last_ack_us - first_ack_us; } // First to last client
+        u64 duration_us() const noexcept { return completed_us ? completed_us - started_us : 0; }
+    };
+
     // ─── Master configuration ──────────────────────────────────────────────────────
     struct SCMasterConfig {
         u32 ready_timeout_ms = 3000;
         u32 active_timeout_ms = 600;
         u32 status_interval_ms = 100;
+        bool immediate_status = true; // Send status as soon as the state or step changes
 
         SCMasterConfig &ready_timeout(u32 ms) {
             ready_timeout_ms = ms;
@@ -74,6 +91,10 @@ namespace agrobus::isobus::sc {
             status_interval_ms = ms;
             return *this;
         }
+        SCMasterConfig &immediate(bool on) {
+            immediate_status = on;
+            return *this;
+        }
     };
 
     // ─── Client configuration ──────────────────────────────────────────────────────
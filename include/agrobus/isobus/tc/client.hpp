@@ -1,7 +1,10 @@
 #pragma once
 
 #include "ddop.hpp"
+#include "measurement.hpp"
 #include "objects.hpp"
+#include "server_options.hpp"
+#include "value_store.hpp"
 #include <agrobus/net/constants.hpp>
 #include <agrobus/net/error.hpp>
 #include <agrobus/net/event.hpp>
@@ -9,6 +12,7 @@
 #include <agrobus/net/message.hpp>
 #include <agrobus/net/network_manager.hpp>
 #include <agrobus/net/state_machine.hpp>
+#include <agrobus/net/working_set.hpp>
 #include <datapod/datapod.hpp>
 #include <echo/echo.hpp>
 #include <functional>
@@ -34,6 +38,10 @@ namespace agrobus::isobus::tc {
         SendWorkingSetMaster,
         RequestVersion,
         WaitForVersion,
+        RequestStructureLabel,
+        WaitForStructureLabel,
+        RequestLocalizationLabel,
+        WaitForLocalizationLabel,
         ProcessDDOP,
         TransferDDOP,
         WaitForPoolResponse,
@@ -41,25 +49,7 @@ namespace agrobus::isobus::tc {
         WaitForActivation,
         Connected
     };
-
-    // ─── TC command types ────────────────────────────────────────────────────────
-    namespace tc_cmd {
-        inline constexpr u8 VERSION_REQUEST = 0x00;
-        inline constexpr u8 VERSION_RESPONSE = 0x10;
-        inline constexpr u8 STRUCTURE_LABEL = 0x01;
-        inline constexpr u8 LOCALIZATION_LABEL = 0x21;
-        inline constexpr u8 REQUEST_OBJECT_POOL = 0x41;
-        inline constexpr u8 OBJECT_POOL_TRANSFER = 0x11;
-        inline constexpr u8 OBJECT_POOL_RESPONSE = 0x12;
-        inline constexpr u8 ACTIVATE_POOL = 0x22;
-        inline constexpr u8 ACTIVATE_RESPONSE = 0x23;
-        inline constexpr u8 DELETE_POOL = 0x32;
-        inline constexpr u8 PROCESS_DATA = 0x03;
-        inline constexpr u8 SET_VALUE = 0x24;
-        inline constexpr u8 REQUEST_VALUE = 0x04;
-        inline constexpr u8 VALUE_RESPONSE = 0x05;
-        inline constexpr u8 TC_STATUS = 0xFE;
-    } // namespace tc_cmd
+    constexpr usize state_count(TCState) { return static_cast<usize>(TCState::Connected) + 1; }
 
     // ─── Task Controller Client ──────────────────────────────────────────────────
     class TaskControllerClient {
@@ -68,11 +58,14 @@ namespace agrobus::isobus::tc {
         TCClientConfig config_;
         StateMachine<TCState> state_{TCState::Disconnected};
         DDOP ddop_;
+        WorkingSetManager *announcer_ = nullptr;
         u32 timer_ms_ = 0;
         u8 tc_address_ = NULL_ADDRESS;
         u8 tc_version_ = 0;
         u8 num_booms_ = 0;
         u8 num_sections_ = 0;
+        bool pool_reused_ = false;
+        bool listening_ = false;
 
         // Callbacks
         using ValueCallback = std::function<Result<i32>(ElementNumber, DDI)>;
@@ -80,13 +73,22 @@ namespace agrobus::isobus::tc {
         ValueCallback value_callback_;
         CommandCallback command_callback_;
 
+        MeasurementEngine measurements_;
+        ProcessDataStore values_;
+
       public:
         TaskControllerClient(IsoNet &net, InternalCF *cf, TCClientConfig config = {})
             : net_(net), cf_(cf), config_(config) {}
 
-        void set_ddop(DDOP pool) { ddop_ = std::move(pool); }
+        void set_ddop(DDOP pool) {
+            ddop_ = std::move(pool);
+            values_ = ProcessDataStore::from_ddop(ddop_);
+        }
         const DDOP &ddop() const noexcept { return ddop_; }
 
+        // Announce through a manager shared with the VT and file clients instead of a master message of our own
+        void set_working_set_manager(WorkingSetManager *manager) { announcer_ = manager; }
+
         Result<void> connect() {
             auto validation = ddop_.validate();
             if (!validation) {
@@ -97,8 +99,13 @@ namespace agrobus::isobus::tc {
             state_.transition(TCState::WaitForServerStatus);
             echo::category("isobus.tc.client").debug("state: ", static_cast<u8>(state_.state()));
             timer_ms_ = 0;
+            pool_reused_ = false;
 
-            net_.register_pgn_callback(PGN_TC_TO_ECU, [this](const Message &msg) { handle_tc_message(msg); });
+            // Registered once: a reconnect must not see every TC message twice
+            if (!listening_) {
+                net_.register_pgn_callback(PGN_TC_TO_ECU, [this](const Message &msg) { handle_tc_message(msg); });
+                listening_ = true;
+            }
 
             echo::category("isobus.tc.client").info("TC client connecting...");
             return {};
@@ -106,18 +113,61 @@ namespace agrobus::isobus::tc {
 
         Result<void> disconnect() {
             state_.transition(TCState::Disconnected);
+            measurements_.clear();
             echo::category("isobus.tc.client").debug("state: ", static_cast<u8>(state_.state()));
             echo::category("isobus.tc.client").info("TC client disconnected");
             return {};
         }
 
         TCState state() const noexcept { return state_.state(); }
+        // Time per state and transition counts, e.g. how long connect waited on the TC
+        const StateMachine<TCState> &state_machine() const noexcept { return state_; }
+
+        // True when the last connect activated the pool the TC already had
+        // (its structure and localization labels matched ours) with no transfer
+        bool pool_reused() const noexcept { return pool_reused_; }
 
         void on_value_request(ValueCallback cb) { value_callback_ = std::move(cb); }
         void on_value_command(CommandCallback cb) { command_callback_ = std::move(cb); }
 
+        // ─── Process data values ─────────────────────────────────────────────────
+        // Values given here go into the value store (built from the DDOP) and
+        // answer the TC's requests with no callback; the value request
+        // callback is only asked for values never set. send_values() reports
+        // everything set since its last call, one Value message each.
+        void set_value(ElementNumber element, DDI ddi, i32 value) {
+            values_.set(element, ddi, value);
+            measurements_.set_value(element, ddi, value);
+        }
+
+        usize send_values() {
+            if (state_.state() != TCState::Connected)
+                return 0;
+            return values_.flush_dirty([this](const ProcessDataStore::Value &v) {
+                send_value(v.element, v.ddi, v.value);
+                return true;
+            });
+        }
+
+        const ProcessDataStore &values() const noexcept { return values_; }
+
+        // ─── Measurement triggers ────────────────────────────────────────────────
+        // The triggers the TC set with measurement commands run here: give the
+        // client values as they change and the distance travelled, and update()
+        // reports whatever fell due. A measurement without a value set is asked
+        // of the value request callback when it fires.
+
+        // Total distance in metres, e.g. from SpeedFusion::on_update:
+        //   fusion.on_update += [&](const OdometerReading &r) { tc.set_distance(r.distance_m); };
+        void set_distance(f64 distance_m) { measurements_.set_distance(static_cast<u32>(distance_m * 1000.0)); }
+
+        const MeasurementEngine &measurements() const noexcept { return measurements_; }
+
         void update(u32 elapsed_ms) {
+            ProfileScope profile(net_.update_profiler(), "tc_client");
             timer_ms_ += elapsed_ms;
+            state_.advance(elapsed_ms);
+            values_.update(elapsed_ms);
 
             switch (state_.state()) {
             case TCState::WaitForServerStatus:
@@ -127,24 +177,6 @@ namespace agrobus::isobus::tc {
                 }
                 break;
 
-            case TCState::SendWorkingSetMaster: {
-                dp::Vector<u8> data(8, 0xFF);
-                data[0] = 1; // Number of members
-                net_.send(PGN_WORKING_SET_MASTER, data, cf_);
-                state_.transition(TCState::RequestVersion);
-                timer_ms_ = 0;
-                break;
-            }
-
-            case TCState::RequestVersion: {
-                dp::Vector<u8> data(8, 0xFF);
-                data[0] = tc_cmd::VERSION_REQUEST;
-                net_.send(PGN_ECU_TO_TC, data, cf_);
-                state_.transition(TCState::WaitForVersion);
-                timer_ms_ = 0;
-                break;
-            }
-
             case TCState::WaitForVersion:
                 if (timer_ms_ >= config_.timeout_ms) {
                     echo::category("isobus.tc.client").warn("Version response timeout");
@@ -152,35 +184,24 @@ namespace agrobus::isobus::tc {
                 }
                 break;
 
-            case TCState::TransferDDOP: {
-                auto pool_result = ddop_.serialize();
-                if (pool_result) {
-                    auto &pool_data = pool_result.value();
-                    // Send DDOP via IsoNet (auto-selects TP/ETP based on size)
-                    ControlFunction tc_cf;
-                    tc_cf.address = tc_address_;
-                    auto send_result = net_.send(PGN_ECU_TO_TC, pool_data, cf_, &tc_cf);
-                    if (!send_result.is_ok()) {
-                        echo::category("isobus.tc.client").error("DDOP transfer failed: transport error");
-                        state_.transition(TCState::Disconnected);
-                        break;
-                    }
-                    state_.transition(TCState::WaitForPoolResponse);
-                    timer_ms_ = 0;
-                    echo::category("isobus.tc.client")
-                        .info("DDOP transferred: ", pool_data.size(), " bytes via transport");
+            case TCState::WaitForStructureLabel:
+            case TCState::WaitForLocalizationLabel:
+                // A TC that does not answer label requests gets the pool
+                if (timer_ms_ >= config_.timeout_ms) {
+                    echo::category("isobus.tc.client").debug("label request unanswered, transferring DDOP");
+                    step(TCState::TransferDDOP);
                 }
                 break;
-            }
 
-            case TCState::ActivatePool: {
-                dp::Vector<u8> data(8, 0xFF);
-                data[0] = tc_cmd::ACTIVATE_POOL;
-                net_.send(PGN_ECU_TO_TC, data, cf_);
-                state_.transition(TCState::WaitForActivation);
-                timer_ms_ = 0;
+            // step() leaves these at once; only a transition made elsewhere rests here
+            case TCState::SendWorkingSetMaster:
+            case TCState::RequestVersion:
+            case TCState::RequestStructureLabel:
+            case TCState::RequestLocalizationLabel:
+            case TCState::TransferDDOP:
+            case TCState::ActivatePool:
+                step(state_.state());
                 break;
-            }
 
             case TCState::WaitForPoolResponse:
             case TCState::WaitForActivation:
@@ -190,6 +211,11 @@ namespace agrobus::isobus::tc {
                 }
                 break;
 
+            case TCState::Connected:
+                measurements_.update(elapsed_ms);
+                send_measurements();
+                break;
+
             default:
                 break;
             }
@@ -207,32 +233,133 @@ namespace agrobus::isobus::tc {
             switch (cmd) {
             case tc_cmd::TC_STATUS:
                 handle_tc_status(msg);
-                break;
+                return;
             case tc_cmd::VERSION_RESPONSE:
-                handle_version_response(msg);
+                if (state_.state() == TCState::WaitForVersion)
+                    handle_version_response(msg);
+                return;
+            case tc_cmd::STRUCTURE_LABEL_RESPONSE:
+                if (state_.state() == TCState::WaitForStructureLabel) {
+                    handle_label_response(msg, true);
+                    return;
+                }
+                break;
+            case tc_cmd::LOCALIZATION_LABEL_RESPONSE:
+                if (state_.state() == TCState::WaitForLocalizationLabel) {
+                    handle_label_response(msg, false);
+                    return;
+                }
                 break;
             case tc_cmd::OBJECT_POOL_RESPONSE:
-                handle_pool_response(msg);
+                // Once connected, the same byte is a request for element 1
+                if (state_.state() != TCState::Connected) {
+                    handle_pool_response(msg);
+                    return;
+                }
                 break;
             case tc_cmd::ACTIVATE_RESPONSE:
-                handle_activate_response(msg);
+                if (state_.state() != TCState::Connected) {
+                    handle_activate_response(msg);
+                    return;
+                }
                 break;
-            case tc_cmd::REQUEST_VALUE:
+            }
+
+            // Process data: command in the low nibble, as TaskControllerServer sends it
+            switch (static_cast<ProcessDataCommands>(cmd & 0x0F)) {
+            case ProcessDataCommands::RequestValue:
                 handle_value_request(msg);
                 break;
-            case tc_cmd::SET_VALUE:
+            case ProcessDataCommands::Value:
+            case ProcessDataCommands::SetValueAndAcknowledge:
                 handle_value_command(msg);
                 break;
+            case ProcessDataCommands::MeasurementTimeInterval:
+            case ProcessDataCommands::MeasurementDistanceInterval:
+            case ProcessDataCommands::MeasurementMinimumWithinThreshold:
+            case ProcessDataCommands::MeasurementMaximumWithinThreshold:
+            case ProcessDataCommands::MeasurementChangeThreshold:
+                handle_measurement(msg);
+                break;
+            default:
+                break;
             }
         }
 
+        // ─── Connect sequence ────────────────────────────────────────────────────
+        // Enters `next`. States that only send a message send it at once and
+        // move on to the response they wait for, so the sequence advances from
+        // the message handlers as responses arrive, not a step per update(). The
+        // working set master and version request go out back to back. The wait
+        // state is entered before sending, for a response delivered inside send.
+        void step(TCState next) {
+            timer_ms_ = 0;
+            ControlFunction tc_cf;
+            tc_cf.address = tc_address_;
+            dp::Vector<u8> data(8, 0xFF);
+
+            switch (next) {
+            case TCState::SendWorkingSetMaster:
+                if (announcer_) {
+                    announcer_->announce();
+                } else {
+                    data[0] = 1; // Number of members
+                    net_.send(PGN_WORKING_SET_MASTER, data, cf_);
+                }
+                [[fallthrough]];
+            case TCState::RequestVersion:
+                state_.transition(TCState::WaitForVersion);
+                data[0] = tc_cmd::VERSION_REQUEST;
+                net_.send(PGN_ECU_TO_TC, data, cf_);
+                break;
+
+            case TCState::RequestStructureLabel:
+            case TCState::RequestLocalizationLabel: {
+                bool structure = next == TCState::RequestStructureLabel;
+                state_.transition(structure ? TCState::WaitForStructureLabel : TCState::WaitForLocalizationLabel);
+                data[0] = structure ? tc_cmd::STRUCTURE_LABEL : tc_cmd::LOCALIZATION_LABEL;
+                net_.send(PGN_ECU_TO_TC, data, cf_, &tc_cf);
+                break;
+            }
+
+            case TCState::TransferDDOP: {
+                auto pool_result = ddop_.serialize();
+                if (!pool_result) {
+                    echo::category("isobus.tc.client").error("DDOP serialization failed");
+                    state_.transition(TCState::Disconnected);
+                    break;
+                }
+                auto &pool_data = pool_result.value();
+                state_.transition(TCState::WaitForPoolResponse);
+                // Send DDOP via IsoNet (auto-selects TP/ETP based on size)
+                auto send_result = net_.send(PGN_ECU_TO_TC, pool_data, cf_, &tc_cf);
+                if (!send_result.is_ok()) {
+                    echo::category("isobus.tc.client").error("DDOP transfer failed: transport error");
+                    state_.transition(TCState::Disconnected);
+                    break;
+                }
+                echo::category("isobus.tc.client").info("DDOP transferred: ", pool_data.size(), " bytes via transport");
+                break;
+            }
+
+            case TCState::ActivatePool:
+                state_.transition(TCState::WaitForActivation);
+                data[0] = tc_cmd::ACTIVATE_POOL;
+                net_.send(PGN_ECU_TO_TC, data, cf_);
+                break;
+
+            default:
+                state_.transition(next);
+                break;
+            }
+            echo::category("isobus.tc.client").debug("state: ", static_cast<u8>(state_.state()));
+        }
+
         void handle_tc_status(const Message &msg) {
             tc_address_ = msg.source;
             if (state_.state() == TCState::WaitForServerStatus) {
                 echo::category("isobus.tc.client").info("connected to TC at addr=", tc_address_);
-                state_.transition(TCState::SendWorkingSetMaster);
-                echo::category("isobus.tc.client").debug("state: ", static_cast<u8>(state_.state()));
-                timer_ms_ = 0;
+                step(TCState::SendWorkingSetMaster);
             }
         }
 
@@ -244,8 +371,36 @@ namespace agrobus::isobus::tc {
             num_sections_ = msg.data[3];
             echo::category("isobus.tc.client")
                 .info("TC version=", tc_version_, " booms=", num_booms_, " sections=", num_sections_);
-            state_.transition(TCState::TransferDDOP);
-            timer_ms_ = 0;
+            // A pool with a structure label may already be stored on the TC
+            const auto &devices = ddop_.devices();
+            bool labelled = false;
+            if (!devices.empty()) {
+                for (u8 b : devices[0].structure_label)
+                    labelled |= b != 0;
+            }
+            step(labelled ? TCState::RequestStructureLabel : TCState::TransferDDOP);
+        }
+
+        // The TC's label for our stored pool (all 0xFF: none); a match on both
+        // labels activates that pool, anything else transfers ours
+        void handle_label_response(const Message &msg, bool structure) {
+            if (msg.data.size() < 8)
+                return;
+            const auto &dev = ddop_.devices()[0];
+            const auto &ours = structure ? dev.structure_label : dev.localization_label;
+            bool match = true;
+            for (usize i = 0; i < 7; ++i)
+                match &= msg.data[1 + i] == ours[i];
+            if (!match) {
+                echo::category("isobus.tc.client").debug(structure ? "structure" : "localization", " label differs");
+                step(TCState::TransferDDOP);
+            } else if (structure) {
+                step(TCState::RequestLocalizationLabel);
+            } else {
+                echo::category("isobus.tc.client").info("TC has our DDOP, activating without transfer");
+                pool_reused_ = true;
+                step(TCState::ActivatePool);
+            }
         }
 
         void handle_pool_response(const Message &msg) {
@@ -254,12 +409,11 @@ namespace agrobus::isobus::tc {
             bool success = (msg.data[1] == 0);
             if (success) {
                 echo::category("isobus.tc.client").info("DDOP accepted");
-                state_.transition(TCState::ActivatePool);
+                step(TCState::ActivatePool);
             } else {
                 echo::category("isobus.tc.client").error("DDOP rejected");
-                state_.transition(TCState::Disconnected);
+                step(TCState::Disconnected);
             }
-            timer_ms_ = 0;
         }
 
         void handle_activate_response(const Message &msg) {
@@ -277,41 +431,81 @@ namespace agrobus::isobus::tc {
         }
 
         void handle_value_request(const Message &msg) {
-            if (msg.data.size() < 4 || !value_callback_)
+            if (msg.data.size() < 4)
                 return;
             // Packed format: low nibble = command, element = high nibble byte[0] | byte[1]<<4
             ElementNumber elem = static_cast<u16>((msg.data[0] >> 4) & 0x0F) | (static_cast<u16>(msg.data[1]) << 4);
             DDI ddi = static_cast<u16>(msg.data[2]) | (static_cast<u16>(msg.data[3]) << 8);
 
-            auto result = value_callback_(elem, ddi);
-            if (result) {
-                dp::Vector<u8> response(8, 0xFF);
-                // Pack: VALUE command in low nibble, element high nibble in high nibble
-                response[0] = (static_cast<u8>(tc_cmd::VALUE_RESPONSE) & 0x0F) | ((static_cast<u8>(elem) & 0x0F) << 4);
-                response[1] = static_cast<u8>((elem >> 4) & 0xFF);
-                response[2] = static_cast<u8>(ddi & 0xFF);
-                response[3] = static_cast<u8>((ddi >> 8) & 0xFF);
-                i32 val = result.value();
-                response[4] = static_cast<u8>(val & 0xFF);
-                response[5] = static_cast<u8>((val >> 8) & 0xFF);
-                response[6] = static_cast<u8>((val >> 16) & 0xFF);
-                response[7] = static_cast<u8>((val >> 24) & 0xFF);
-
-                ControlFunction tc_cf;
-                tc_cf.address = tc_address_;
-                net_.send(PGN_ECU_TO_TC, response, cf_, &tc_cf);
+            auto value = current_value(elem, ddi);
+            if (value)
+                send_value(elem, ddi, *value);
+        }
+
+        // From the store, or else the value request callback
+        dp::Optional<i32> current_value(ElementNumber elem, DDI ddi) {
+            if (auto stored = values_.get(elem, ddi))
+                return stored;
+            if (value_callback_) {
+                auto result = value_callback_(elem, ddi);
+                if (result)
+                    return result.value();
             }
+            return dp::nullopt;
+        }
+
+        void handle_measurement(const Message &msg) {
+            if (msg.data.size() < 8)
+                return;
+            auto cmd = static_cast<ProcessDataCommands>(msg.data[0] & 0x0F);
+            ElementNumber elem = static_cast<u16>((msg.data[0] >> 4) & 0x0F) | (static_cast<u16>(msg.data[1]) << 4);
+            DDI ddi = static_cast<u16>(msg.data[2]) | (static_cast<u16>(msg.data[3]) << 8);
+            i32 value = static_cast<i32>(msg.data[4]) | (static_cast<i32>(msg.data[5]) << 8) |
+                        (static_cast<i32>(msg.data[6]) << 16) | (static_cast<i32>(msg.data[7]) << 24);
+            measurements_.command(cmd, elem, ddi, value);
+        }
+
+        // Everything that fell due since the last update, one Value message each
+        void send_measurements() {
+            if (measurements_.pending() == 0)
+                return;
+            usize sent = measurements_.flush([this](const Measurement &m) -> dp::Optional<i32> {
+                dp::Optional<i32> value = m.value ? m.value : current_value(m.element, m.ddi);
+                if (value)
+                    send_value(m.element, m.ddi, *value);
+                return value;
+            });
+            echo::category("isobus.tc.client").trace("measurements sent: ", sent);
+        }
+
+        void send_value(ElementNumber elem, DDI ddi, i32 val) {
+            dp::Vector<u8> response(8, 0xFF);
+            // Pack: command in low nibble, element low nibble in high nibble
+            response[0] = (static_cast<u8>(ProcessDataCommands::Value) & 0x0F) | ((static_cast<u8>(elem) & 0x0F) << 4);
+            response[1] = static_cast<u8>((elem >> 4) & 0xFF);
+            response[2] = static_cast<u8>(ddi & 0xFF);
+            response[3] = static_cast<u8>((ddi >> 8) & 0xFF);
+            response[4] = static_cast<u8>(val & 0xFF);
+            response[5] = static_cast<u8>((val >> 8) & 0xFF);
+            response[6] = static_cast<u8>((val >> 16) & 0xFF);
+            response[7] = static_cast<u8>((val >> 24) & 0xFF);
+
+            ControlFunction tc_cf;
+            tc_cf.address = tc_address_;
+            net_.send(PGN_ECU_TO_TC, response, cf_, &tc_cf);
         }
 
         void handle_value_command(const Message &msg) {
-            if (msg.data.size() < 8 || !command_callback_)
+            if (msg.data.size() < 8)
                 return;
             // Packed format: low nibble = command, element = high nibble byte[0] | byte[1]<<4
             ElementNumber elem = static_cast<u16>((msg.data[0] >> 4) & 0x0F) | (static_cast<u16>(msg.data[1]) << 4);
             DDI ddi = static_cast<u16>(msg.data[2]) | (static_cast<u16>(msg.data[3]) << 8);
             i32 value = static_cast<i32>(msg.data[4]) | (static_cast<i32>(msg.data[5]) << 8) |
                         (static_cast<i32>(msg.data[6]) << 16) | (static_cast<i32>(msg.data[7]) << 24);
-            command_callback_(elem, ddi, value);
+            values_.receive(elem, ddi, value); // The setpoint the TC asked for, readable from values()
+            if (command_callback_)
+                command_callback_(elem, ddi, value);
         }
     };
 
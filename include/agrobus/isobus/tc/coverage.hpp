@@ -0,0 +1,397 @@
+#pragma once
+
+#include "prescription.hpp"
+#include <agrobus/net/error.hpp>
+#include <agrobus/net/types.hpp>
+#include <bit>
+#include <cmath>
+#include <concord/concord.hpp>
+#include <datapod/datapod.hpp>
+#include <echo/echo.hpp>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace agrobus::isobus::tc {
+    using namespace agrobus::net;
+
+    // ─── Swept area of one section over one tick ─────────────────────────────────
+    // Four corners in order around the quad, in the coverage map's frame.
+    struct CoverageQuad {
+        LocalPoint a;
+        LocalPoint b;
+        LocalPoint c;
+        LocalPoint d;
+
+        // The strip a section edge left0-right0 swept to left1-right1
+        static CoverageQuad swept(LocalPoint left0, LocalPoint right0, LocalPoint left1, LocalPoint right1) noexcept {
+            return {left0, right0, right1, left1};
+        }
+    };
+
+    // ─── As-applied coverage map ─────────────────────────────────────────────────
+    // One bit per square cell of a local ENU frame, in 64 x 64 cell tiles (one
+    // u64 per tile row) that exist only where something was applied. Tiles
+    // live in one pool: on the heap, or in a file mapped with map_file() so a
+    // whole field survives a restart and only the tiles touched are paged in.
+    //
+    // A quad is rasterised by cell centre, row by row: the quad's edges are
+    // cut at the row's centre line and each span is set or counted with one
+    // masked word per tile it crosses. Crossed edges (a section that turned
+    // past its own swath) are filled even-odd.
+    class CoverageMap {
+      public:
+        static constexpr u32 TILE_CELLS = 64;
+        static constexpr i32 MAX_QUAD_CELLS = 4096; // Per axis; larger quads are skipped
+
+      private:
+        static constexpr u32 MAGIC = 0x41474356; // "AGCV"
+        static constexpr u32 VERSION = 1;
+        static constexpr u32 NO_TILE = 0xFFFFFFFFu;
+
+        struct FileHeader {
+            u32 magic;
+            u32 version;
+            f32 cell_m;
+            u32 capacity; // Tiles
+            u32 count;
+            u32 reserved;
+            f64 origin_lat;
+            f64 origin_lon;
+            f64 origin_alt;
+        };
+        static_assert(sizeof(FileHeader) == 48);
+
+        dp::Geo origin_;
+        f32 cell_m_;
+        f32 inv_cell_;
+        dp::Map<u32, u32> slots_; // Tile key -> slot in the pool
+        dp::Vector<u32> heap_keys_;
+        dp::Vector<u64> heap_bits_;
+        u32 *keys_ = nullptr; // Slot -> tile key
+        u64 *bits_ = nullptr; // Slot * 64 + row
+        u32 capacity_ = 0;
+        u32 count_ = 0;
+        u64 covered_ = 0;
+        mutable u32 last_key_ = NO_TILE;
+        mutable u32 last_slot_ = NO_TILE;
+        bool full_warned_ = false;
+
+        int fd_ = -1;
+        void *map_ = nullptr;
+        usize map_size_ = 0;
+        FileHeader *header_ = nullptr;
+
+      public:
+        explicit CoverageMap(dp::Geo origin = {}, f32 cell_m = 0.25f)
+            : origin_(origin), cell_m_(cell_m > 0.0f ? cell_m : 0.25f), inv_cell_(1.0f / cell_m_) {}
+
+        ~CoverageMap() { close(); }
+
+        // keys_/bits_ point into this object or its mapping
+        CoverageMap(const CoverageMap &) = delete;
+        CoverageMap &operator=(const CoverageMap &) = delete;
+
+        // ─── Storage ─────────────────────────────────────────────────────────────
+        // Keeps the tiles in `path`, created for `capacity_tiles` tiles if it
+        // does not exist. An existing file brings back its origin, cell size
+        // and coverage. Call on an empty map.
+        Result<void> map_file(const dp::String &path, u32 capacity_tiles) {
+            if (count_ != 0)
+                return Result<void>::err(Error::invalid_state("coverage map not empty"));
+            close();
+            bool created = false;
+            fd_ = ::open(path.c_str(), O_RDWR | O_CREAT | O_EXCL, 0660);
+            created = fd_ >= 0;
+            if (fd_ < 0)
+                fd_ = ::open(path.c_str(), O_RDWR);
+            if (fd_ < 0)
+                return Result<void>::err(Error(ErrorCode::DriverError, "open failed"));
+
+            if (created) {
+                map_size_ = file_size(capacity_tiles);
+                if (capacity_tiles == 0 || ::ftruncate(fd_, static_cast<off_t>(map_size_)) < 0) {
+                    close();
+                    return Result<void>::err(Error(ErrorCode::DriverError, "ftruncate failed"));
+                }
+            } else {
+                struct stat st {};
+                if (::fstat(fd_, &st) != 0 || static_cast<usize>(st.st_size) < sizeof(FileHeader)) {
+                    close();
+                    return Result<void>::err(Error::invalid_state("not a coverage file"));
+                }
+                map_size_ = static_cast<usize>(st.st_size);
+            }
+
+            map_ = ::mmap(nullptr, map_size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+            if (map_ == MAP_FAILED) {
+                map_ = nullptr;
+                close();
+                return Result<void>::err(Error(ErrorCode::DriverError, "mmap failed"));
+            }
+            header_ = static_cast<FileHeader *>(map_);
+
+            if (created) {
+                header_->version = VERSION;
+                header_->cell_m = cell_m_;
+                header_->capacity = capacity_tiles;
+                header_->count = 0;
+                header_->reserved = 0;
+                header_->origin_lat = origin_.latitude;
+                header_->origin_lon = origin_.longitude;
+                header_->origin_alt = origin_.altitude;
+                header_->magic = MAGIC; // Zero-filled by ftruncate
+            } else if (header_->magic != MAGIC || header_->version != VERSION ||
+                       file_size(header_->capacity) > map_size_ || header_->count > header_->capacity ||
+                       !(header_->cell_m > 0.0f)) {
+                close();
+                return Result<void>::err(Error::invalid_state("not a coverage file"));
+            }
+
+            origin_ = dp::Geo{header_->origin_lat, header_->origin_lon, header_->origin_alt};
+            cell_m_ = header_->cell_m;
+            inv_cell_ = 1.0f / cell_m_;
+            capacity_ = header_->capacity;
+            keys_ = reinterpret_cast<u32 *>(static_cast<u8 *>(map_) + sizeof(FileHeader));
+            bits_ = reinterpret_cast<u64 *>(static_cast<u8 *>(map_) + bits_offset(capacity_));
+            heap_keys_.clear();
+            heap_bits_.clear();
+            reindex(header_->count);
+            echo::category("isobus.tc.coverage")
+                .info(created ? "created " : "opened ", path.c_str(), " tiles=", count_, "/", capacity_);
+            return {};
+        }
+
+        // Writes mapped tiles back to the file
+        Result<void> sync() {
+            if (map_ && ::msync(map_, map_size_, MS_SYNC) != 0)
+                return Result<void>::err(Error(ErrorCode::DriverError, "msync failed"));
+            return {};
+        }
+
+        // Unmaps the file (its coverage stays on disk) and leaves an empty map
+        void close() {
+            if (map_)
+                ::munmap(map_, map_size_);
+            map_ = nullptr;
+            header_ = nullptr;
+            map_size_ = 0;
+            if (fd_ >= 0) {
+                ::close(fd_);
+                fd_ = -1;
+            }
+            slots_.clear();
+            heap_keys_.clear();
+            heap_bits_.clear();
+            keys_ = nullptr;
+            bits_ = nullptr;
+            capacity_ = count_ = 0;
+            covered_ = 0;
+            last_key_ = last_slot_ = NO_TILE;
+            full_warned_ = false;
+        }
+
+        // ─── Frame ───────────────────────────────────────────────────────────────
+        const dp::Geo &origin() const noexcept { return origin_; }
+        f32 cell_size() const noexcept { return cell_m_; }
+
+        LocalPoint to_local(const concord::earth::WGS &pos) const {
+            concord::frame::ENU enu = concord::frame::to_enu(origin_, pos);
+            return {static_cast<f32>(enu.east()), static_cast<f32>(enu.north())};
+        }
+
+        // ─── Marking and queries ─────────────────────────────────────────────────
+        // Marks the cells whose centre is in `quad`; returns how many were new
+        u32 sweep(const CoverageQuad &quad) {
+            u32 fresh = 0;
+            spans(quad, [&](i32 cy, i32 cx0, i32 cx1) {
+                for_words(cy, cx0, cx1, [&](i32 tx, i32 ty, u32 row, u64 mask) {
+                    u32 slot = tile(tx, ty, true);
+                    if (slot == NO_TILE)
+                        return;
+                    u64 &bits = word(slot, row);
+                    fresh += static_cast<u32>(std::popcount(mask & ~bits));
+                    bits |= mask;
+                });
+            });
+            covered_ += fresh;
+            return fresh;
+        }
+
+        // Share of the cells of `quad` already covered (0 for a quad with no cell)
+        f32 overlap(const CoverageQuad &quad) const {
+            u64 cells = 0;
+            u64 hit = 0;
+            spans(quad, [&](i32 cy, i32 cx0, i32 cx1) {
+                cells += static_cast<u64>(cx1 - cx0 + 1);
+                for_words(cy, cx0, cx1, [&](i32 tx, i32 ty, u32 row, u64 mask) {
+                    u32 slot = tile(tx, ty);
+                    if (slot != NO_TILE)
+                        hit += static_cast<u64>(std::popcount(mask & word(slot, row)));
+                });
+            });
+            return cells == 0 ? 0.0f : static_cast<f32>(static_cast<f64>(hit) / static_cast<f64>(cells));
+        }
+
+        bool covered(LocalPoint p) const {
+            i32 cx = static_cast<i32>(std::floor(p.east * inv_cell_));
+            i32 cy = static_cast<i32>(std::floor(p.north * inv_cell_));
+            u32 slot = tile(cx >> 6, cy >> 6);
+            if (slot == NO_TILE)
+                return false;
+            return (word(slot, static_cast<u32>(cy & 63)) >> (cx & 63)) & 1;
+        }
+
+        u64 covered_cells() const noexcept { return covered_; }
+        f64 covered_area_m2() const noexcept { return static_cast<f64>(covered_) * cell_m_ * cell_m_; }
+        usize tiles() const noexcept { return count_; }
+        u32 capacity() const noexcept { return capacity_; }
+        bool mapped() const noexcept { return map_ != nullptr; }
+
+        // Forgets every tile (a mapped file is emptied too)
+        void clear() {
+            for (usize i = 0; i < static_cast<usize>(count_) * TILE_CELLS; ++i)
+                bits_[i] = 0;
+            slots_.clear();
+            count_ = 0;
+            covered_ = 0;
+            last_key_ = last_slot_ = NO_TILE;
+            if (header_)
+                header_->count = 0;
+        }
+
+      private:
+        static usize bits_offset(u32 capacity) noexcept {
+            usize keys_end = sizeof(FileHeader) + static_cast<usize>(capacity) * sizeof(u32);
+            return (keys_end + 7) & ~static_cast<usize>(7);
+        }
+        static usize file_size(u32 capacity) noexcept {
+            return bits_offset(capacity) + static_cast<usize>(capacity) * TILE_CELLS * sizeof(u64);
+        }
+
+        u64 &word(u32 slot, u32 row) noexcept { return bits_[static_cast<usize>(slot) * TILE_CELLS + row]; }
+        u64 word(u32 slot, u32 row) const noexcept { return bits_[static_cast<usize>(slot) * TILE_CELLS + row]; }
+
+        static u32 tile_key(i32 tx, i32 ty) noexcept {
+            return (static_cast<u32>(static_cast<u16>(tx)) << 16) | static_cast<u16>(ty);
+        }
+
+        void reindex(u32 count) {
+            slots_.clear();
+            count_ = count;
+            covered_ = 0;
+            for (u32 s = 0; s < count_; ++s) {
+                slots_[keys_[s]] = s;
+                for (u32 r = 0; r < TILE_CELLS; ++r)
+                    covered_ += static_cast<u64>(std::popcount(word(s, r)));
+            }
+            last_key_ = last_slot_ = NO_TILE;
+        }
+
+        u32 tile(i32 tx, i32 ty) const {
+            if (tx < -32768 || tx > 32767 || ty < -32768 || ty > 32767)
+                return NO_TILE;
+            u32 key = tile_key(tx, ty);
+            if (key == last_key_)
+                return last_slot_;
+            auto it = slots_.find(key);
+            if (it == slots_.end())
+                return NO_TILE;
+            last_key_ = key;
+            last_slot_ = it->second;
+            return it->second;
+        }
+
+        u32 tile(i32 tx, i32 ty, bool create) {
+            u32 slot = static_cast<const CoverageMap &>(*this).tile(tx, ty);
+            if (slot != NO_TILE || !create || tx < -32768 || tx > 32767 || ty < -32768 || ty > 32767)
+                return slot;
+            if (count_ == capacity_ && !grow()) {
+                if (!full_warned_)
+                    echo::category("isobus.tc.coverage").warn("coverage file full: ", capacity_, " tiles");
+                full_warned_ = true;
+                return NO_TILE;
+            }
+            slot = count_++;
+            u32 key = tile_key(tx, ty);
+            keys_[slot] = key;
+            for (u32 r = 0; r < TILE_CELLS; ++r)
+                word(slot, r) = 0;
+            slots_[key] = slot;
+            if (header_)
+                header_->count = count_;
+            last_key_ = key;
+            last_slot_ = slot;
+            return slot;
+        }
+
+        // Heap pool only; a mapped file has a fixed capacity
+        bool grow() {
+            if (map_)
+                return false;
+            u32 capacity = capacity_ == 0 ? 16 : capacity_ * 2;
+            heap_keys_.resize(capacity, 0);
+            heap_bits_.resize(static_cast<usize>(capacity) * TILE_CELLS, 0);
+            keys_ = heap_keys_.data();
+            bits_ = heap_bits_.data();
+            capacity_ = capacity;
+            return true;
+        }
+
+        // Calls fn(cy, cx0, cx1) for each row's run of cells (inclusive), by centre
+        template <typename Fn> void spans(const CoverageQuad &q, Fn &&fn) const {
+            const LocalPoint pts[4] = {q.a, q.b, q.c, q.d};
+            f32 min_n = pts[0].north, max_n = pts[0].north;
+            f32 min_e = pts[0].east, max_e = pts[0].east;
+            for (const auto &p : pts) {
+                min_n = p.north < min_n ? p.north : min_n;
+                max_n = p.north > max_n ? p.north : max_n;
+                min_e = p.east < min_e ? p.east : min_e;
+                max_e = p.east > max_e ? p.east : max_e;
+            }
+            if (!((max_n - min_n) * inv_cell_ < MAX_QUAD_CELLS && (max_e - min_e) * inv_cell_ < MAX_QUAD_CELLS))
+                return; // Also rejects NaN
+            i32 cy0 = static_cast<i32>(std::ceil(min_n * inv_cell_ - 0.5f));
+            i32 cy1 = static_cast<i32>(std::ceil(max_n * inv_cell_ - 0.5f)) - 1;
+            for (i32 cy = cy0; cy <= cy1; ++cy) {
+                f32 yc = (static_cast<f32>(cy) + 0.5f) * cell_m_;
+                f32 xs[4];
+                u32 n = 0;
+                for (u32 i = 0; i < 4; ++i) {
+                    const LocalPoint &p = pts[i];
+                    const LocalPoint &r = pts[(i + 1) & 3];
+                    if ((p.north > yc) != (r.north > yc))
+                        xs[n++] = p.east + (yc - p.north) * (r.east - p.east) / (r.north - p.north);
+                }
+                for (u32 i = 1; i < n; ++i) {
+                    for (u32 j = i; j > 0 && xs[j] < xs[j - 1]; --j) {
+                        f32 t = xs[j];
+                        xs[j] = xs[j - 1];
+                        xs[j - 1] = t;
+                    }
+                }
+                for (u32 i = 0; i + 1 < n; i += 2) {
+                    i32 cx0 = static_cast<i32>(std::ceil(xs[i] * inv_cell_ - 0.5f));
+                    i32 cx1 = static_cast<i32>(std::ceil(xs[i + 1] * inv_cell_ - 0.5f)) - 1;
+                    if (cx0 <= cx1)
+                        fn(cy, cx0, cx1);
+                }
+            }
+        }
+
+        // Splits a row run at tile edges: fn(tx, ty, row in tile, bit mask)
+        template <typename Fn> static void for_words(i32 cy, i32 cx0, i32 cx1, Fn &&fn) {
+            i32 ty = cy >> 6;
+            u32 row = static_cast<u32>(cy & 63);
+            for (i32 tx = cx0 >> 6; tx <= (cx1 >> 6); ++tx) {
+                i32 first = tx * 64;
+                u32 b0 = cx0 > first ? static_cast<u32>(cx0 - first) : 0;
+                u32 b1 = cx1 < first + 63 ? static_cast<u32>(cx1 - first) : 63;
+                u64 mask = (~u64{0} >> (63 - b1)) & (~u64{0} << b0);
+                fn(tx, ty, row, mask);
+            }
+        }
+    };
+
+} // namespace agrobus::isobus::tc
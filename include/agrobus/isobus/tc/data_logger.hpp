@@ -0,0 +1,454 @@
+#pragma once
+
+#include "objects.hpp"
+#include "server.hpp"
+#include <agrobus/net/error.hpp>
+#include <agrobus/net/spsc_ring.hpp>
+#include <agrobus/net/types.hpp>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <datapod/datapod.hpp>
+#include <echo/echo.hpp>
+#include <fcntl.h>
+#include <functional>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+
+namespace agrobus::isobus::tc {
+    using namespace agrobus::net;
+
+    // ─── One logged process data value ───────────────────────────────────────────
+    struct TCLogRecord {
+        u64 timestamp_us = 0;
+        i32 value = 0;
+        DDI ddi = 0;
+        ElementNumber element = 0;
+        Address client = NULL_ADDRESS;
+    };
+
+    // ─── Process data log format ─────────────────────────────────────────────────
+    // Append-only and memory-mapped:
+    //   [TCLogFileHeader (32)] [block] × N
+    // A block holds up to block_values values of one (client, element, DDI)
+    // series: a TCLogBlockHeader with the first timestamp and value, then
+    // for each further value the change in timestamp delta (delta of delta,
+    // 0 for a steady rate) and the value delta, as zigzag varints. Steadily
+    // sampled data costs two or three bytes per value. Blocks are not
+    // aligned; read the header with memcpy. The file header's `used` is
+    // advanced after each block, so a log cut short ends at its last whole
+    // block.
+    inline constexpr u32 TC_LOG_MAGIC = 0x4C544741; // "AGTL"
+    inline constexpr u32 TC_LOG_VERSION = 1;
+
+    struct TCLogFileHeader {
+        u32 magic;
+        u32 version;
+        u64 used;   // Bytes in use, header included
+        u64 blocks;
+        u64 values;
+    };
+    static_assert(sizeof(TCLogFileHeader) == 32);
+
+    struct TCLogBlockHeader {
+        u64 first_timestamp_us;
+        i32 first_value;
+        u32 payload_bytes;
+        ElementNumber element;
+        DDI ddi;
+        u16 count;
+        Address client;
+        u8 reserved;
+    };
+    static_assert(sizeof(TCLogBlockHeader) == 24);
+
+    namespace detail {
+        inline u8 *put_varint(u8 *p, u64 v) noexcept {
+            while (v >= 0x80) {
+                *p++ = static_cast<u8>(v | 0x80);
+                v >>= 7;
+            }
+            *p++ = static_cast<u8>(v);
+            return p;
+        }
+
+        inline u64 zigzag(i64 v) noexcept { return (static_cast<u64>(v) << 1) ^ static_cast<u64>(v >> 63); }
+        inline i64 unzigzag(u64 v) noexcept { return static_cast<i64>(v >> 1) ^ -static_cast<i64>(v & 1); }
+
+        // False when the varint runs past `end`
+        inline bool get_varint(const u8 *&p, const u8 *end, u64 &out) noexcept {
+            out = 0;
+            for (u32 shift = 0; shift < 64; shift += 7) {
+                if (p >= end)
+                    return false;
+                u8 b = *p++;
+                out |= static_cast<u64>(b & 0x7F) << shift;
+                if (!(b & 0x80))
+                    return true;
+            }
+            return false;
+        }
+    } // namespace detail
+
+    // ─── Logger configuration ────────────────────────────────────────────────────
+    struct TCDataLoggerConfig {
+        usize ring_records = 65536;    // Ingest queue; at 10k values/s, 6 s of backlog
+        u16 block_values = 1024;       // Values per block of one series
+        u32 flush_interval_ms = 5000;  // Partial blocks are written at least this often
+        u32 idle_us = 1000;            // Writer sleep when the queue is empty
+        u64 initial_bytes = 64u << 20; // File size to start with; doubles when full
+    };
+
+    // ─── TC process data logger ──────────────────────────────────────────────────
+    // Logs every value a TaskControllerServer receives for the working day.
+    // The network thread only pushes records into a lock-free SPSC ring
+    // (never blocks; a full ring drops and counts); a writer thread groups
+    // them per series, encodes full blocks and appends them to the mapped
+    // file, growing it as needed. At 10k values/s a 12 hour day is about
+    // 430M values, one to two gigabytes on disk.
+    //
+    //   TCDataLogger log;
+    //   log.open("day.tclog");
+    //   log.attach(server);               // Or log.log(batch) from your own callback
+    //   ...
+    //   log.close();                      // Drains, writes partial blocks, syncs
+    class TCDataLogger {
+        struct Series {
+            Address client;
+            ElementNumber element;
+            DDI ddi;
+            dp::Vector<u64> timestamps;
+            dp::Vector<i32> values;
+        };
+
+        TCDataLoggerConfig config_;
+        SpscRing<TCLogRecord> ring_;
+
+        // Writer thread state
+        int fd_ = -1;
+        u8 *map_ = nullptr;
+        usize map_size_ = 0;
+        dp::Map<u64, Series> series_;
+        dp::Vector<u8> scratch_;
+        u64 last_flush_us_ = 0;
+        bool failed_ = false;
+
+        std::thread thread_;
+        std::atomic<bool> running_{false};
+        std::atomic<u64> blocks_{0};
+        std::atomic<u64> values_{0};
+        std::atomic<u64> bytes_{0};
+
+      public:
+        explicit TCDataLogger(TCDataLoggerConfig config = {})
+            : config_(config), ring_(config.ring_records == 0 ? 1 : config.ring_records) {
+            if (config_.block_values == 0)
+                config_.block_values = 1;
+            // Header plus a worst-case varint pair of 10 + 5 bytes per value
+            scratch_.resize(sizeof(TCLogBlockHeader) + static_cast<usize>(config_.block_values) * 15);
+        }
+
+        ~TCDataLogger() { close(); }
+
+        TCDataLogger(const TCDataLogger &) = delete;
+        TCDataLogger &operator=(const TCDataLogger &) = delete;
+
+        // ─── File and writer thread ──────────────────────────────────────────────
+        // Creates (or truncates) `path` and starts the writer thread
+        Result<void> open(const dp::String &path) {
+            close();
+            fd_ = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+            if (fd_ < 0)
+                return Result<void>::err(Error(ErrorCode::DriverError, "cannot create TC log file"));
+            map_size_ = static_cast<usize>(config_.initial_bytes);
+            if (map_size_ < sizeof(TCLogFileHeader) + scratch_.size())
+                map_size_ = sizeof(TCLogFileHeader) + scratch_.size();
+            if (::ftruncate(fd_, static_cast<off_t>(map_size_)) < 0) {
+                close_file();
+                return Result<void>::err(Error(ErrorCode::DriverError, "ftruncate failed"));
+            }
+            void *map = ::mmap(nullptr, map_size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+            if (map == MAP_FAILED) {
+                close_file();
+                return Result<void>::err(Error(ErrorCode::DriverError, "mmap failed"));
+            }
+            map_ = static_cast<u8 *>(map);
+            TCLogFileHeader header{TC_LOG_MAGIC, TC_LOG_VERSION, sizeof(TCLogFileHeader), 0, 0};
+            std::memcpy(map_, &header, sizeof(header));
+            blocks_.store(0, std::memory_order_relaxed);
+            values_.store(0, std::memory_order_relaxed);
+            bytes_.store(sizeof(TCLogFileHeader), std::memory_order_relaxed);
+            failed_ = false;
+            last_flush_us_ = now_us();
+
+            running_.store(true, std::memory_order_release);
+            thread_ = std::thread([this]() { writer_main(); });
+            echo::category("isobus.tc.log").info("logging process data to ", path.c_str());
+            return {};
+        }
+
+        // Stops the writer after everything queued is written, then syncs,
+        // trims the file to its used size and closes it
+        void close() {
+            if (thread_.joinable()) {
+                running_.store(false, std::memory_order_release);
+                thread_.join();
+            }
+            if (map_) {
+                drain();
+                flush_series(true);
+                ::msync(map_, map_size_, MS_SYNC);
+                ::munmap(map_, map_size_);
+                map_ = nullptr;
+                if (::ftruncate(fd_, static_cast<off_t>(bytes_.load(std::memory_order_relaxed))) < 0)
+                    failed_ = true;
+            }
+            close_file();
+            series_.clear();
+        }
+
+        bool is_open() const noexcept { return fd_ >= 0; }
+
+        // ─── Ingest (network thread) ─────────────────────────────────────────────
+        bool log(const TCLogRecord &record) noexcept { return ring_.try_push(record); }
+
+        bool log(Address client, ElementNumber element, DDI ddi, i32 value, u64 timestamp_us) noexcept {
+            return ring_.try_push(TCLogRecord{timestamp_us, value, ddi, element, client});
+        }
+
+        // Every row of a server batch; returns the rows queued
+        usize log(const ValueBatch &batch) noexcept {
+            usize queued = 0;
+            for (usize i = 0; i < batch.size(); ++i)
+                queued += log(batch.clients[i], batch.elements[i], batch.ddis[i], batch.values[i],
+                              batch.timestamps_us[i]);
+            return queued;
+        }
+
+        // Takes the server's batch callback; log from your own callback instead
+        // if the application needs it too
+        void attach(TaskControllerServer &server) {
+            server.on_values_received([this](const ValueBatch &batch) { log(batch); });
+        }
+
+        // ─── Stats ───────────────────────────────────────────────────────────────
+        u64 dropped() const noexcept { return ring_.dropped(); }
+        usize queued() const noexcept { return ring_.size(); }
+        u64 blocks() const noexcept { return blocks_.load(std::memory_order_relaxed); }
+        u64 values() const noexcept { return values_.load(std::memory_order_relaxed); }
+        u64 bytes() const noexcept { return bytes_.load(std::memory_order_relaxed); }
+        bool failed() const noexcept { return failed_; } // Read after close()
+
+      private:
+        static u64 now_us() {
+            auto now = std::chrono::steady_clock::now().time_since_epoch();
+            return static_cast<u64>(std::chrono::duration_cast<std::chrono::microseconds>(now).count());
+        }
+
+        void close_file() {
+            if (fd_ >= 0)
+                ::close(fd_);
+            fd_ = -1;
+        }
+
+        void writer_main() {
+            while (running_.load(std::memory_order_acquire)) {
+                usize n = drain();
+                u64 now = now_us();
+                if (now - last_flush_us_ >= static_cast<u64>(config_.flush_interval_ms) * 1000) {
+                    flush_series(true);
+                    ::msync(map_, bytes_.load(std::memory_order_relaxed), MS_ASYNC);
+                    last_flush_us_ = now;
+                }
+                if (n == 0)
+                    std::this_thread::sleep_for(std::chrono::microseconds(config_.idle_us));
+            }
+        }
+
+        usize drain() {
+            usize n = 0;
+            TCLogRecord r;
+            while (ring_.try_pop(r)) {
+                u64 key = (static_cast<u64>(r.client) << 32) | (static_cast<u64>(r.element) << 16) | r.ddi;
+                auto it = series_.find(key);
+                if (it == series_.end()) {
+                    Series s{r.client, r.element, r.ddi, {}, {}};
+                    s.timestamps.reserve(config_.block_values);
+                    s.values.reserve(config_.block_values);
+                    series_[key] = std::move(s);
+                    it = series_.find(key);
+                }
+                Series &s = it->second;
+                s.timestamps.push_back(r.timestamp_us);
+                s.values.push_back(r.value);
+                if (s.values.size() >= config_.block_values)
+                    write_block(s);
+                ++n;
+            }
+            return n;
+        }
+
+        void flush_series(bool partial) {
+            for (auto &[key, s] : series_) {
+                if (!s.values.empty() && (partial || s.values.size() >= config_.block_values))
+                    write_block(s);
+            }
+        }
+
+        void write_block(Series &s) {
+            TCLogBlockHeader h{};
+            h.first_timestamp_us = s.timestamps[0];
+            h.first_value = s.values[0];
+            h.element = s.element;
+            h.ddi = s.ddi;
+            h.count = static_cast<u16>(s.values.size());
+            h.client = s.client;
+
+            u8 *p = scratch_.data() + sizeof(TCLogBlockHeader);
+            i64 prev_dt = 0;
+            for (usize i = 1; i < s.values.size(); ++i) {
+                i64 dt = static_cast<i64>(s.timestamps[i] - s.timestamps[i - 1]);
+                i64 dv = static_cast<i64>(s.values[i]) - static_cast<i64>(s.values[i - 1]);
+                p = detail::put_varint(p, detail::zigzag(dt - prev_dt));
+                prev_dt = dt;
+                p = detail::put_varint(p, detail::zigzag(dv));
+            }
+            usize payload = static_cast<usize>(p - scratch_.data()) - sizeof(TCLogBlockHeader);
+            h.payload_bytes = static_cast<u32>(payload);
+            std::memcpy(scratch_.data(), &h, sizeof(h));
+
+            usize size = sizeof(TCLogBlockHeader) + payload;
+            u64 used = bytes_.load(std::memory_order_relaxed);
+            if (!failed_ && (used + size <= map_size_ || grow(used + size))) {
+                std::memcpy(map_ + used, scratch_.data(), size);
+                used += size;
+                TCLogFileHeader header;
+                std::memcpy(&header, map_, sizeof(header));
+                header.used = used;
+                header.blocks += 1;
+                header.values += h.count;
+                std::memcpy(map_, &header, sizeof(header));
+                bytes_.store(used, std::memory_order_relaxed);
+                blocks_.fetch_add(1, std::memory_order_relaxed);
+                values_.fetch_add(h.count, std::memory_order_relaxed);
+            }
+            s.timestamps.clear();
+            s.values.clear();
+        }
+
+        bool grow(u64 needed) {
+            usize size = map_size_;
+            while (size < needed)
+                size *= 2;
+            void *map = MAP_FAILED;
+            if (::ftruncate(fd_, static_cast<off_t>(size)) == 0)
+                map = ::mremap(map_, map_size_, size, MREMAP_MAYMOVE);
+            if (map == MAP_FAILED) {
+                failed_ = true;
+                echo::category("isobus.tc.log").error("cannot grow TC log to ", size, " bytes");
+                return false;
+            }
+            map_ = static_cast<u8 *>(map);
+            map_size_ = size;
+            return true;
+        }
+    };
+
+    // ─── Reading a process data log ──────────────────────────────────────────────
+    // Maps a log read-only and decodes it block by block, for export. Values
+    // come out grouped by block, so per series in time order but series
+    // interleaved.
+    class TCLogReader {
+        int fd_ = -1;
+        const u8 *map_ = nullptr;
+        usize size_ = 0;
+        TCLogFileHeader header_{};
+
+      public:
+        TCLogReader() = default;
+        ~TCLogReader() { close(); }
+
+        TCLogReader(const TCLogReader &) = delete;
+        TCLogReader &operator=(const TCLogReader &) = delete;
+
+        Result<void> open(const dp::String &path) {
+            close();
+            fd_ = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+            if (fd_ < 0)
+                return Result<void>::err(Error(ErrorCode::DriverError, "cannot open TC log file"));
+            struct stat st {};
+            if (::fstat(fd_, &st) != 0 || static_cast<usize>(st.st_size) < sizeof(TCLogFileHeader)) {
+                close();
+                return Result<void>::err(Error::invalid_state("not a TC log file"));
+            }
+            size_ = static_cast<usize>(st.st_size);
+            void *map = ::mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd_, 0);
+            if (map == MAP_FAILED) {
+                close();
+                return Result<void>::err(Error(ErrorCode::DriverError, "mmap failed"));
+            }
+            map_ = static_cast<const u8 *>(map);
+            std::memcpy(&header_, map_, sizeof(header_));
+            if (header_.magic != TC_LOG_MAGIC || header_.version != TC_LOG_VERSION || header_.used > size_ ||
+                header_.used < sizeof(TCLogFileHeader)) {
+                close();
+                return Result<void>::err(Error::invalid_state("not a TC log file"));
+            }
+            return {};
+        }
+
+        void close() {
+            if (map_)
+                ::munmap(const_cast<u8 *>(map_), size_);
+            map_ = nullptr;
+            size_ = 0;
+            if (fd_ >= 0)
+                ::close(fd_);
+            fd_ = -1;
+            header_ = {};
+        }
+
+        u64 blocks() const noexcept { return header_.blocks; }
+        u64 values() const noexcept { return header_.values; }
+        u64 bytes() const noexcept { return header_.used; }
+
+        // Calls fn for every logged value; returns how many were read
+        Result<u64> for_each(const std::function<void(const TCLogRecord &)> &fn) const {
+            if (!map_)
+                return Result<u64>::err(Error::invalid_state("TC log not open"));
+            const u8 *p = map_ + sizeof(TCLogFileHeader);
+            const u8 *end = map_ + header_.used;
+            u64 count = 0;
+            while (p < end) {
+                if (static_cast<usize>(end - p) < sizeof(TCLogBlockHeader))
+                    return Result<u64>::err(Error::invalid_state("TC log block truncated"));
+                TCLogBlockHeader h;
+                std::memcpy(&h, p, sizeof(h));
+                p += sizeof(h);
+                if (h.payload_bytes > static_cast<usize>(end - p) || h.count == 0)
+                    return Result<u64>::err(Error::invalid_state("TC log block truncated"));
+                const u8 *block_end = p + h.payload_bytes;
+
+                TCLogRecord r{h.first_timestamp_us, h.first_value, h.ddi, h.element, h.client};
+                fn(r);
+                i64 dt = 0;
+                for (u16 i = 1; i < h.count; ++i) {
+                    u64 ddt = 0;
+                    u64 dv = 0;
+                    if (!detail::get_varint(p, block_end, ddt) || !detail::get_varint(p, block_end, dv))
+                        return Result<u64>::err(Error::invalid_state("TC log block truncated"));
+                    dt += detail::unzigzag(ddt);
+                    r.timestamp_us += static_cast<u64>(dt);
+                    r.value = static_cast<i32>(static_cast<i64>(r.value) + detail::unzigzag(dv));
+                    fn(r);
+                }
+                p = block_end;
+                count += h.count;
+            }
+            return Result<u64>::ok(count);
+        }
+    };
+
+} // namespace agrobus::isobus::tc
@@ -1571,31 +1571,83 @@ namespace agrobus::isobus::tc {
 
     inline constexpr usize DDI_DATABASE_SIZE = 760;
 
-    // ─── DDI Lookup ──────────────────────────────────────────────────────────
-    inline const DDIDefinition *ddi_lookup(u16 ddi) {
-        for (usize i = 0; i < DDI_DATABASE_SIZE; ++i) {
-            if (DDI_DATABASE[i].ddi == ddi)
-                return &DDI_DATABASE[i];
+    // ─── DDI Lookup Table ────────────────────────────────────────────────────
+    // Built at compile time. DDIs come in a few dense blocks (0..728 and six
+    // per 0x1000 page above 32768), so the table is two-level: the high byte
+    // picks one of the pages in use, the low byte a slot there holding the
+    // entry's index into DDI_DATABASE. About 6 KiB, one lookup in two loads.
+    namespace detail {
+        inline constexpr u16 DDI_NONE = 0xFFFF;
+
+        consteval usize ddi_page_count() {
+            bool used[256] = {};
+            usize count = 0;
+            for (const auto &def : DDI_DATABASE) {
+                if (!used[def.ddi >> 8]) {
+                    used[def.ddi >> 8] = true;
+                    ++count;
+                }
+            }
+            return count;
         }
-        return nullptr;
+
+        struct DDIIndex {
+            u8 page[256];                    // High byte -> page + 1 (0 when no DDI lives there)
+            u16 slot[ddi_page_count()][256]; // Low byte -> DDI_DATABASE index, or DDI_NONE
+        };
+
+        consteval DDIIndex build_ddi_index() {
+            DDIIndex index{};
+            for (auto &page : index.slot) {
+                for (auto &s : page)
+                    s = DDI_NONE;
+            }
+            u8 pages = 0;
+            for (usize i = 0; i < DDI_DATABASE_SIZE; ++i) {
+                u16 ddi = DDI_DATABASE[i].ddi;
+                u8 &p = index.page[ddi >> 8];
+                if (p == 0)
+                    p = ++pages;
+                index.slot[p - 1][ddi & 0xFF] = static_cast<u16>(i);
+            }
+            return index;
+        }
+
+        inline constexpr DDIIndex DDI_INDEX = build_ddi_index();
+
+        static_assert(sizeof(DDI_DATABASE) / sizeof(DDI_DATABASE[0]) == DDI_DATABASE_SIZE);
+        static_assert(ddi_page_count() < 256);
+    } // namespace detail
+
+    // ─── DDI Lookup ──────────────────────────────────────────────────────────
+    constexpr const DDIDefinition *ddi_lookup(u16 ddi) noexcept {
+        u8 page = detail::DDI_INDEX.page[ddi >> 8];
+        if (page == 0)
+            return nullptr;
+        u16 i = detail::DDI_INDEX.slot[page - 1][ddi & 0xFF];
+        return i == detail::DDI_NONE ? nullptr : &DDI_DATABASE[i];
     }
 
-    inline const char *ddi_name(u16 ddi) {
+    static_assert(ddi_lookup(1) == &DDI_DATABASE[1]);
+    static_assert(ddi_lookup(65535) == &DDI_DATABASE[DDI_DATABASE_SIZE - 1]);
+    static_assert(ddi_lookup(9999) == nullptr);
+
+    constexpr const char *ddi_name(u16 ddi) noexcept {
         auto *def = ddi_lookup(ddi);
         return def ? def->name : "Unknown";
     }
 
-    inline const char *ddi_unit(u16 ddi) {
+    constexpr const char *ddi_unit(u16 ddi) noexcept {
         auto *def = ddi_lookup(ddi);
         return def ? def->unit : "";
     }
 
-    inline f64 ddi_resolution(u16 ddi) {
+    constexpr f64 ddi_resolution(u16 ddi) noexcept {
         auto *def = ddi_lookup(ddi);
         return def ? def->resolution : 1.0;
     }
 
-    inline f64 ddi_to_engineering(u16 ddi, i32 raw) { return static_cast<f64>(raw) * ddi_resolution(ddi); }
+    constexpr f64 ddi_to_engineering(u16 ddi, i32 raw) noexcept { return static_cast<f64>(raw) * ddi_resolution(ddi); }
 
     inline i32 ddi_from_engineering(u16 ddi, f64 eng) {
         f64 res = ddi_resolution(ddi);
@@ -1615,20 +1667,23 @@ namespace agrobus::isobus::tc {
     // ─── Legacy DDIDatabase class (backwards compatibility) ──────────────────
     class DDIDatabase {
       public:
-        static dp::Optional<DDIEntry> lookup(u16 ddi) {
-            auto *def = ddi_lookup(ddi);
-            if (def) {
-                DDIEntry entry;
-                entry.ddi = def->ddi;
-                entry.name = def->name;
-                entry.unit = def->unit;
-                entry.resolution = def->resolution;
-                entry.min_value = def->min_value;
-                entry.max_value = def->max_value;
-                return entry;
-            }
-            return dp::nullopt;
-        }
+        // The database entry itself, no copy; empty for an unknown DDI
+        class Ref {
+            const DDIEntry *def_ = nullptr;
+
+          public:
+            constexpr Ref() noexcept = default;
+            constexpr explicit Ref(const DDIEntry *def) noexcept : def_(def) {}
+
+            constexpr bool has_value() const noexcept { return def_ != nullptr; }
+            constexpr explicit operator bool() const noexcept { return def_ != nullptr; }
+            constexpr const DDIEntry &operator*() const noexcept { return *def_; }
+            constexpr const DDIEntry *operator->() const noexcept { return def_; }
+            constexpr const DDIEntry &value() const noexcept { return *def_; }
+            constexpr const DDIEntry *get() const noexcept { return def_; }
+        };
+
+        static constexpr Ref lookup(u16 ddi) noexcept { return Ref(ddi_lookup(ddi)); }
 
         static const char *unit_for(u16 ddi) { return ddi_unit(ddi); }
         static const char *name_for(u16 ddi) { return ddi_name(ddi); }
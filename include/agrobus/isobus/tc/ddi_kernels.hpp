@@ -0,0 +1,159 @@
+#pragma once
+
+#include "ddi_database.hpp"
+#include <agrobus/net/types.hpp>
+
+#if !defined(AGROBUS_SIMD_DISABLED) && defined(__AVX2__)
+#include <immintrin.h>
+#define AGROBUS_DDI_AVX2 1
+#elif !defined(AGROBUS_SIMD_DISABLED) && defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define AGROBUS_DDI_NEON 1
+#endif
+
+namespace agrobus::isobus::tc {
+    using namespace agrobus::net;
+
+    // ─── Resolution table ────────────────────────────────────────────────────
+    // DDI_INDEX with the resolutions in place of the database indices, so a
+    // lane finds its resolution in two gathers: the high byte picks a row,
+    // the low byte a slot in it. Row 0 stands for every page without DDIs,
+    // and empty slots hold 1.0, as ddi_resolution() gives for unknown DDIs.
+    namespace detail {
+        inline constexpr usize DDI_RESOLUTION_ROWS = ddi_page_count() + 1;
+
+        struct DDIResolutionTable {
+            i32 row[256];                              // High byte -> row
+            f64 resolution[DDI_RESOLUTION_ROWS * 256]; // row * 256 + low byte
+        };
+
+        consteval DDIResolutionTable build_ddi_resolution_table() {
+            DDIResolutionTable t{};
+            for (auto &r : t.resolution)
+                r = 1.0;
+            for (usize hi = 0; hi < 256; ++hi)
+                t.row[hi] = DDI_INDEX.page[hi];
+            for (const auto &def : DDI_DATABASE)
+                t.resolution[static_cast<usize>(DDI_INDEX.page[def.ddi >> 8]) * 256 + (def.ddi & 0xFF)] =
+                    def.resolution;
+            return t;
+        }
+
+        inline constexpr DDIResolutionTable DDI_RESOLUTION = build_ddi_resolution_table();
+
+        constexpr f64 ddi_resolution_direct(u16 ddi) noexcept {
+            return DDI_RESOLUTION.resolution[static_cast<usize>(DDI_RESOLUTION.row[ddi >> 8]) * 256 + (ddi & 0xFF)];
+        }
+
+        static_assert(ddi_resolution_direct(1) == ddi_resolution(1));
+        static_assert(ddi_resolution_direct(9999) == 1.0);
+        static_assert(ddi_resolution_direct(57344) == 0.0);
+
+#if defined(AGROBUS_DDI_AVX2)
+        // Resolutions of four DDIs; the masked gathers, all lanes on, spell
+        // out the pass-through source the plain ones leave undefined
+        inline __m256d gather_resolutions(const u16 *ddis, __m128i low) noexcept {
+            const __m128i all = _mm_set1_epi32(-1);
+            __m128i d = _mm_cvtepu16_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(ddis)));
+            __m128i hi = _mm_srli_epi32(d, 8);
+            __m128i row = _mm_mask_i32gather_epi32(_mm_setzero_si128(), DDI_RESOLUTION.row, hi, all, 4);
+            __m128i slot = _mm_add_epi32(_mm_slli_epi32(row, 8), _mm_and_si128(d, low));
+            return _mm256_mask_i32gather_pd(_mm256_setzero_pd(), DDI_RESOLUTION.resolution, slot,
+                                            _mm256_castsi256_pd(_mm256_set1_epi64x(-1)), 8);
+        }
+#endif
+
+        // Divisor of from_engineering: a zero resolution passes the value through
+        inline f64 engineering_divisor(f64 res) noexcept { return res != 0.0 ? res : 1.0; }
+    } // namespace detail
+
+    // ─── Batch conversions ───────────────────────────────────────────────────
+    // Structure-of-arrays in, caller-supplied arrays out, nothing allocated.
+    // Same results as ddi_to_engineering()/ddi_from_engineering() per
+    // element (raw values truncated toward zero). Four elements per
+    // instruction with AVX2, resolutions gathered from the table above (two
+    // with NEON) unless the build sets AGROBUS_SIMD_DISABLED.
+
+    // raw[i] of ddis[i] to engineering units
+    inline void ddi_to_engineering(const u16 *ddis, const i32 *raw, usize n, f64 *out) noexcept {
+        usize i = 0;
+#if defined(AGROBUS_DDI_AVX2)
+        const __m128i low = _mm_set1_epi32(0xFF);
+        for (; i + 4 <= n; i += 4) {
+            __m256d res = detail::gather_resolutions(ddis + i, low);
+            __m256d v = _mm256_cvtepi32_pd(_mm_loadu_si128(reinterpret_cast<const __m128i *>(raw + i)));
+            _mm256_storeu_pd(out + i, _mm256_mul_pd(v, res));
+        }
+#elif defined(AGROBUS_DDI_NEON)
+        for (; i + 2 <= n; i += 2) {
+            float64x2_t res = {detail::ddi_resolution_direct(ddis[i]), detail::ddi_resolution_direct(ddis[i + 1])};
+            float64x2_t v = vcvtq_f64_s64(vmovl_s32(vld1_s32(raw + i)));
+            vst1q_f64(out + i, vmulq_f64(v, res));
+        }
+#endif
+        for (; i < n; ++i)
+            out[i] = static_cast<f64>(raw[i]) * detail::ddi_resolution_direct(ddis[i]);
+    }
+
+    // A column of one DDI, as a TimeLog value column is
+    inline void ddi_to_engineering(u16 ddi, const i32 *raw, usize n, f64 *out) noexcept {
+        const f64 res = detail::ddi_resolution_direct(ddi);
+        usize i = 0;
+#if defined(AGROBUS_DDI_AVX2)
+        const __m256d r = _mm256_set1_pd(res);
+        for (; i + 4 <= n; i += 4) {
+            __m256d v = _mm256_cvtepi32_pd(_mm_loadu_si128(reinterpret_cast<const __m128i *>(raw + i)));
+            _mm256_storeu_pd(out + i, _mm256_mul_pd(v, r));
+        }
+#elif defined(AGROBUS_DDI_NEON)
+        for (; i + 2 <= n; i += 2)
+            vst1q_f64(out + i, vmulq_n_f64(vcvtq_f64_s64(vmovl_s32(vld1_s32(raw + i))), res));
+#endif
+        for (; i < n; ++i)
+            out[i] = static_cast<f64>(raw[i]) * res;
+    }
+
+    // eng[i] of ddis[i] to raw values
+    inline void ddi_from_engineering(const u16 *ddis, const f64 *eng, usize n, i32 *out) noexcept {
+        usize i = 0;
+#if defined(AGROBUS_DDI_AVX2)
+        const __m128i low = _mm_set1_epi32(0xFF);
+        const __m256d zero = _mm256_setzero_pd();
+        const __m256d one = _mm256_set1_pd(1.0);
+        for (; i + 4 <= n; i += 4) {
+            __m256d res = detail::gather_resolutions(ddis + i, low);
+            __m256d div = _mm256_blendv_pd(res, one, _mm256_cmp_pd(res, zero, _CMP_EQ_OQ));
+            __m128i q = _mm256_cvttpd_epi32(_mm256_div_pd(_mm256_loadu_pd(eng + i), div));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(out + i), q);
+        }
+#elif defined(AGROBUS_DDI_NEON)
+        for (; i + 2 <= n; i += 2) {
+            float64x2_t div = {detail::engineering_divisor(detail::ddi_resolution_direct(ddis[i])),
+                               detail::engineering_divisor(detail::ddi_resolution_direct(ddis[i + 1]))};
+            vst1_s32(out + i, vqmovn_s64(vcvtq_s64_f64(vdivq_f64(vld1q_f64(eng + i), div))));
+        }
+#endif
+        for (; i < n; ++i)
+            out[i] = static_cast<i32>(eng[i] / detail::engineering_divisor(detail::ddi_resolution_direct(ddis[i])));
+    }
+
+    // A column of one DDI
+    inline void ddi_from_engineering(u16 ddi, const f64 *eng, usize n, i32 *out) noexcept {
+        const f64 div = detail::engineering_divisor(detail::ddi_resolution_direct(ddi));
+        usize i = 0;
+#if defined(AGROBUS_DDI_AVX2)
+        const __m256d d = _mm256_set1_pd(div);
+        for (; i + 4 <= n; i += 4) {
+            __m128i q = _mm256_cvttpd_epi32(_mm256_div_pd(_mm256_loadu_pd(eng + i), d));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(out + i), q);
+        }
+#elif defined(AGROBUS_DDI_NEON)
+        const float64x2_t d = vdupq_n_f64(div);
+        for (; i + 2 <= n; i += 2)
+            vst1_s32(out + i, vqmovn_s64(vcvtq_s64_f64(vdivq_f64(vld1q_f64(eng + i), d))));
+#endif
+        for (; i < n; ++i)
+            out[i] = static_cast<i32>(eng[i] / div);
+    }
+
+} // namespace agrobus::isobus::tc
@@ -1,7 +1,10 @@
 #pragma once
 
+#include "ddop_view.hpp"
+#include "isoxml.hpp"
 #include "objects.hpp"
 #include <agrobus/net/error.hpp>
+#include <agrobus/net/static_alloc.hpp>
 #include <cstring>
 #include <datapod/datapod.hpp>
 #include <echo/echo.hpp>
@@ -10,79 +13,123 @@ namespace agrobus::isobus::tc {
     using namespace agrobus::net;
 
     // ─── Device Descriptor Object Pool ──────────────────────────────────────────
+    // Objects are kept per type; every add (and deserialize) also records the
+    // object's ID -> (type, index) and, for an element's children, child ->
+    // parent element, so reference checks and lookups by ID are one map find.
+    // The first object added under an ID is the one the index keeps. In the
+    // static allocation profile a pool holds at most AGROBUS_MAX_DDOP_OBJECTS.
     class DDOP {
+      public:
+        using ObjectRef = tc::ObjectRef;
+
+      private:
         dp::Vector<DeviceObject> devices_;
         dp::Vector<DeviceElement> elements_;
         dp::Vector<DeviceProcessData> process_data_;
         dp::Vector<DeviceProperty> properties_;
         dp::Vector<DeviceValuePresentation> value_presentations_;
+        dp::Map<ObjectID, ObjectRef> index_;
+        dp::Map<ObjectID, u32> parents_; // Child object -> index into elements_
         ObjectID next_id_ = 0;
 
       public:
         ObjectID next_id() noexcept { return next_id_++; }
 
         Result<ObjectID> add_device(DeviceObject obj) {
+            if (static_alloc::full(object_count(), static_alloc::ddop_objects))
+                return Result<ObjectID>::err(static_alloc::exhausted("DDOP full"));
             if (obj.designator.empty()) {
                 return Result<ObjectID>::err(Error::invalid_state("device designator is required"));
             }
             if (obj.id == 0)
                 obj.id = next_id();
             devices_.push_back(std::move(obj));
+            index_object(TCObjectType::Device, devices_.back().id, devices_.size() - 1);
             return Result<ObjectID>::ok(devices_.back().id);
         }
 
         Result<ObjectID> add_element(DeviceElement elem) {
+            if (static_alloc::full(object_count(), static_alloc::ddop_objects))
+                return Result<ObjectID>::err(static_alloc::exhausted("DDOP full"));
             if (elem.id == 0)
                 elem.id = next_id();
             elements_.push_back(std::move(elem));
+            index_element(elements_.size() - 1);
             return Result<ObjectID>::ok(elements_.back().id);
         }
 
         Result<ObjectID> add_process_data(DeviceProcessData pd) {
+            if (static_alloc::full(object_count(), static_alloc::ddop_objects))
+                return Result<ObjectID>::err(static_alloc::exhausted("DDOP full"));
             if (pd.id == 0)
                 pd.id = next_id();
             process_data_.push_back(std::move(pd));
+            index_object(TCObjectType::DeviceProcessData, process_data_.back().id, process_data_.size() - 1);
             return Result<ObjectID>::ok(process_data_.back().id);
         }
 
         Result<ObjectID> add_property(DeviceProperty prop) {
+            if (static_alloc::full(object_count(), static_alloc::ddop_objects))
+                return Result<ObjectID>::err(static_alloc::exhausted("DDOP full"));
             if (prop.id == 0)
                 prop.id = next_id();
             properties_.push_back(std::move(prop));
+            index_object(TCObjectType::DeviceProperty, properties_.back().id, properties_.size() - 1);
             return Result<ObjectID>::ok(properties_.back().id);
         }
 
         Result<ObjectID> add_value_presentation(DeviceValuePresentation vp) {
+            if (static_alloc::full(object_count(), static_alloc::ddop_objects))
+                return Result<ObjectID>::err(static_alloc::exhausted("DDOP full"));
             if (vp.id == 0)
                 vp.id = next_id();
             value_presentations_.push_back(std::move(vp));
+            index_object(TCObjectType::DeviceValuePresentation, value_presentations_.back().id,
+                         value_presentations_.size() - 1);
             return Result<ObjectID>::ok(value_presentations_.back().id);
         }
 
-        // Serialize the entire DDOP to binary
-        Result<dp::Vector<u8>> serialize() const {
-            dp::Vector<u8> data;
+        // Size of the serialized pool in bytes
+        usize serialized_size() const noexcept {
+            usize total = 0;
+            for (const auto &dev : devices_)
+                total += dev.serialized_size();
+            for (const auto &elem : elements_)
+                total += elem.serialized_size();
+            for (const auto &pd : process_data_)
+                total += pd.serialized_size();
+            for (const auto &prop : properties_)
+                total += prop.serialized_size();
+            for (const auto &vp : value_presentations_)
+                total += vp.serialized_size();
+            return total;
+        }
 
-            for (const auto &dev : devices_) {
-                auto bytes = dev.serialize();
-                data.insert(data.end(), bytes.begin(), bytes.end());
-            }
-            for (const auto &elem : elements_) {
-                auto bytes = elem.serialize();
-                data.insert(data.end(), bytes.begin(), bytes.end());
-            }
-            for (const auto &pd : process_data_) {
-                auto bytes = pd.serialize();
-                data.insert(data.end(), bytes.begin(), bytes.end());
-            }
-            for (const auto &prop : properties_) {
-                auto bytes = prop.serialize();
-                data.insert(data.end(), bytes.begin(), bytes.end());
-            }
-            for (const auto &vp : value_presentations_) {
-                auto bytes = vp.serialize();
-                data.insert(data.end(), bytes.begin(), bytes.end());
-            }
+        // Write the pool into a caller buffer, returning the bytes written
+        Result<usize> serialize_into(u8 *out, usize capacity) const {
+            usize total = serialized_size();
+            if (total > capacity)
+                return Result<usize>::err(Error::invalid_state("buffer too small for DDOP"));
+            u8 *p = out;
+            for (const auto &dev : devices_)
+                p = dev.serialize_into(p);
+            for (const auto &elem : elements_)
+                p = elem.serialize_into(p);
+            for (const auto &pd : process_data_)
+                p = pd.serialize_into(p);
+            for (const auto &prop : properties_)
+                p = prop.serialize_into(p);
+            for (const auto &vp : value_presentations_)
+                p = vp.serialize_into(p);
+            return Result<usize>::ok(static_cast<usize>(p - out));
+        }
+
+        // Serialize the entire DDOP to binary: size it, then write it once
+        Result<dp::Vector<u8>> serialize() const {
+            dp::Vector<u8> data(serialized_size());
+            auto written = serialize_into(data.data(), data.size());
+            if (!written.is_ok())
+                return Result<dp::Vector<u8>>::err(written.error());
 
             echo::category("isobus.tc").debug("DDOP serialized: ", data.size(), " bytes");
             return Result<dp::Vector<u8>>::ok(std::move(data));
@@ -141,6 +188,48 @@ namespace agrobus::isobus::tc {
         const dp::Vector<DeviceElement> &elements() const noexcept { return elements_; }
         const dp::Vector<DeviceProcessData> &process_data() const noexcept { return process_data_; }
         const dp::Vector<DeviceProperty> &properties() const noexcept { return properties_; }
+        const dp::Vector<DeviceValuePresentation> &value_presentations() const noexcept {
+            return value_presentations_;
+        }
+
+        // ─── Lookup by object ID ───────────────────────────────────────────────────
+        dp::Optional<ObjectRef> find(ObjectID id) const {
+            auto it = index_.find(id);
+            if (it == index_.end())
+                return dp::nullopt;
+            return it->second;
+        }
+
+        bool contains(ObjectID id) const { return index_.find(id) != index_.end(); }
+
+        const DeviceObject *find_device(ObjectID id) const { return lookup(devices_, TCObjectType::Device, id); }
+        const DeviceElement *find_element(ObjectID id) const {
+            return lookup(elements_, TCObjectType::DeviceElement, id);
+        }
+        const DeviceProcessData *find_process_data(ObjectID id) const {
+            return lookup(process_data_, TCObjectType::DeviceProcessData, id);
+        }
+        const DeviceProperty *find_property(ObjectID id) const {
+            return lookup(properties_, TCObjectType::DeviceProperty, id);
+        }
+        const DeviceValuePresentation *find_value_presentation(ObjectID id) const {
+            return lookup(value_presentations_, TCObjectType::DeviceValuePresentation, id);
+        }
+
+        // DDI of a process data or property object
+        dp::Optional<DDI> ddi_of(ObjectID id) const {
+            if (const auto *pd = find_process_data(id))
+                return pd->ddi;
+            if (const auto *prop = find_property(id))
+                return prop->ddi;
+            return dp::nullopt;
+        }
+
+        // The element listing `id` among its children
+        const DeviceElement *parent_of(ObjectID id) const {
+            auto it = parents_.find(id);
+            return it == parents_.end() ? nullptr : &elements_[it->second];
+        }
 
         usize object_count() const noexcept {
             return devices_.size() + elements_.size() + process_data_.size() + properties_.size() +
@@ -170,63 +259,77 @@ namespace agrobus::isobus::tc {
         }
 
         // ─── Deserialization ────────────────────────────────────────────────────
-        // Parse a binary DDOP back into an object tree
-        static Result<DDOP> deserialize(const dp::Vector<u8> &data) {
-            DDOP ddop;
-            usize offset = 0;
+        // Parse a binary DDOP back into an object tree. The bytes are indexed
+        // once by DDOPView; use that directly when the pool is only read.
+        static Result<DDOP> deserialize(DataSpan data) {
+            auto parsed = DDOPView::parse(data);
+            if (!parsed.is_ok())
+                return Result<DDOP>::err(parsed.error());
+            const DDOPView &view = parsed.value();
 
-            while (offset < data.size()) {
-                if (offset + 3 > data.size()) {
-                    return Result<DDOP>::err(
-                        Error(ErrorCode::PoolValidation, "DDOP truncated: not enough bytes for object header"));
-                }
-
-                auto obj_type = static_cast<TCObjectType>(data[offset]);
-                ObjectID obj_id = static_cast<u16>(data[offset + 1]) | (static_cast<u16>(data[offset + 2]) << 8);
-                offset += 3;
-
-                switch (obj_type) {
-                case TCObjectType::Device: {
-                    auto result = parse_device(data, offset, obj_id);
-                    if (!result.is_ok())
-                        return Result<DDOP>::err(result.error());
-                    ddop.devices_.push_back(std::move(result.value()));
-                    break;
-                }
-                case TCObjectType::DeviceElement: {
-                    auto result = parse_element(data, offset, obj_id);
-                    if (!result.is_ok())
-                        return Result<DDOP>::err(result.error());
-                    ddop.elements_.push_back(std::move(result.value()));
-                    break;
-                }
-                case TCObjectType::DeviceProcessData: {
-                    auto result = parse_process_data(data, offset, obj_id);
-                    if (!result.is_ok())
-                        return Result<DDOP>::err(result.error());
-                    ddop.process_data_.push_back(std::move(result.value()));
-                    break;
-                }
-                case TCObjectType::DeviceProperty: {
-                    auto result = parse_property(data, offset, obj_id);
-                    if (!result.is_ok())
-                        return Result<DDOP>::err(result.error());
-                    ddop.properties_.push_back(std::move(result.value()));
-                    break;
-                }
-                case TCObjectType::DeviceValuePresentation: {
-                    auto result = parse_value_presentation(data, offset, obj_id);
-                    if (!result.is_ok())
-                        return Result<DDOP>::err(result.error());
-                    ddop.value_presentations_.push_back(std::move(result.value()));
-                    break;
-                }
-                default:
-                    return Result<DDOP>::err(Error(ErrorCode::PoolValidation, "unknown TC object type in DDOP"));
-                }
+            DDOP ddop;
+            ddop.devices_.reserve(view.devices().size());
+            for (const auto &v : view.devices()) {
+                DeviceObject dev;
+                dev.id = v.id;
+                dev.designator = dp::String(v.designator.data(), v.designator.size());
+                dev.software_version = dp::String(v.software_version.data(), v.software_version.size());
+                dev.serial_number = dp::String(v.serial_number.data(), v.serial_number.size());
+                std::memcpy(dev.structure_label.data(), v.structure_label.data(), 7);
+                std::memcpy(dev.localization_label.data(), v.localization_label.data(), 7);
+                ddop.devices_.push_back(std::move(dev));
+            }
+            ddop.elements_.reserve(view.elements().size());
+            for (const auto &v : view.elements()) {
+                DeviceElement elem;
+                elem.id = v.id;
+                elem.type = v.type;
+                elem.designator = dp::String(v.designator.data(), v.designator.size());
+                elem.number = v.number;
+                elem.parent_id = v.parent_id;
+                elem.child_objects.reserve(v.children.size());
+                for (u16 i = 0; i < v.children.size(); ++i)
+                    elem.child_objects.push_back(v.children[i]);
+                ddop.elements_.push_back(std::move(elem));
+                ddop.index_children(ddop.elements_.size() - 1);
+            }
+            ddop.process_data_.reserve(view.process_data().size());
+            for (const auto &v : view.process_data()) {
+                DeviceProcessData pd;
+                pd.id = v.id;
+                pd.ddi = v.ddi;
+                pd.trigger_methods = v.trigger_methods;
+                pd.presentation_object_id = v.presentation_object_id;
+                pd.designator = dp::String(v.designator.data(), v.designator.size());
+                ddop.process_data_.push_back(std::move(pd));
+            }
+            ddop.properties_.reserve(view.properties().size());
+            for (const auto &v : view.properties()) {
+                DeviceProperty prop;
+                prop.id = v.id;
+                prop.ddi = v.ddi;
+                prop.value = v.value;
+                prop.presentation_object_id = v.presentation_object_id;
+                prop.designator = dp::String(v.designator.data(), v.designator.size());
+                ddop.properties_.push_back(std::move(prop));
+            }
+            ddop.value_presentations_.reserve(view.value_presentations().size());
+            for (const auto &v : view.value_presentations()) {
+                DeviceValuePresentation vp;
+                vp.id = v.id;
+                vp.offset = v.offset;
+                vp.scale = v.scale;
+                vp.decimal_digits = v.decimal_digits;
+                vp.unit_designator = dp::String(v.unit_designator.data(), v.unit_designator.size());
+                ddop.value_presentations_.push_back(std::move(vp));
+            }
 
-                if (obj_id >= ddop.next_id_)
-                    ddop.next_id_ = obj_id + 1;
+            // Per-type positions match the view's, so its index (first ID in
+            // stream order wins) carries over as is
+            ddop.index_ = view.index();
+            for (const auto &[id, ref] : ddop.index_) {
+                if (id >= ddop.next_id_)
+                    ddop.next_id_ = id + 1;
             }
 
             echo::category("isobus.tc").debug("DDOP deserialized: ", ddop.object_count(), " objects");
@@ -234,48 +337,48 @@ namespace agrobus::isobus::tc {
         }
 
         // ─── ISOXML generation ─────────────────────────────────────────────────────
-        // Generates ISO 11783-10 TASKDATA.xml-conformant XML fragment for this DDOP
-        dp::String to_isoxml() const {
-            dp::String xml;
-            xml += "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n";
-            xml += "<ISO11783_TaskData VersionMajor=\"4\" VersionMinor=\"0\"";
-            xml += " DataTransferOrigin=\"1\">\n";
-
+        // Streams this pool's DVC/DET/DPD/DPT/DVP elements into an open
+        // document, so several DDOPs can share one TASKDATA.xml
+        Result<void> write_isoxml(IsoxmlWriter &xml) const {
             for (const auto &dev : devices_) {
-                xml += "  <DVC A=\"DVC-";
-                xml += dp::to_string(dev.id);
-                xml += "\" B=\"";
-                xml += xml_escape(dev.designator);
-                xml += "\" C=\"";
-                xml += xml_escape(dev.software_version);
-                xml += "\" D=\"";
-                xml += xml_escape(dev.serial_number);
-                xml += "\">\n";
-
-                // Emit elements that belong to this device
-                for (const auto &elem : elements_) {
-                    xml += emit_element_xml(elem);
-                }
-
-                xml += "  </DVC>\n";
+                xml.open("DVC")
+                    .ref("A", "DVC", dev.id)
+                    .attr("B", dev.designator)
+                    .attr("C", dev.software_version)
+                    .attr("D", dev.serial_number);
+                for (const auto &elem : elements_)
+                    write_element_xml(xml, elem);
+                xml.end("DVC");
             }
 
-            // Emit value presentations as standalone elements
+            // Value presentations as standalone elements
             for (const auto &vp : value_presentations_) {
-                xml += "  <DVP A=\"DVP-";
-                xml += dp::to_string(vp.id);
-                xml += "\" B=\"";
-                xml += dp::to_string(vp.offset);
-                xml += "\" C=\"";
-                xml += dp::to_string(vp.scale);
-                xml += "\" D=\"";
-                xml += dp::to_string(static_cast<u32>(vp.decimal_digits));
-                xml += "\" E=\"";
-                xml += xml_escape(vp.unit_designator);
-                xml += "\"/>\n";
+                xml.open("DVP")
+                    .ref("A", "DVP", vp.id)
+                    .attr("B", vp.offset)
+                    .attr("C", vp.scale)
+                    .attr("D", vp.decimal_digits)
+                    .attr("E", vp.unit_designator)
+                    .close();
             }
+            if (xml.failed())
+                return Result<void>::err(Error(ErrorCode::DriverError, "ISOXML sink write failed"));
+            return {};
+        }
 
-            xml += "</ISO11783_TaskData>\n";
+        // Generates ISO 11783-10 TASKDATA.xml-conformant XML fragment for this DDOP
+        dp::String to_isoxml() const {
+            dp::String xml;
+            {
+                IsoxmlWriter writer(string_sink(xml));
+                writer.declaration();
+                writer.open("ISO11783_TaskData")
+                    .attr("VersionMajor", 4)
+                    .attr("VersionMinor", 0)
+                    .attr("DataTransferOrigin", 1);
+                (void)write_isoxml(writer);
+                writer.end("ISO11783_TaskData");
+            }
             return xml;
         }
 
@@ -285,307 +388,75 @@ namespace agrobus::isobus::tc {
             process_data_.clear();
             properties_.clear();
             value_presentations_.clear();
+            index_.clear();
+            parents_.clear();
             next_id_ = 0;
         }
 
       private:
-        // ─── Deserialization helpers ────────────────────────────────────────────
-        static Result<DeviceObject> parse_device(const dp::Vector<u8> &data, usize &offset, ObjectID id) {
-            DeviceObject dev;
-            dev.id = id;
-            // Designator
-            if (offset >= data.size())
-                return Result<DeviceObject>::err(truncated_error());
-            u8 des_len = data[offset++];
-            if (offset + des_len > data.size())
-                return Result<DeviceObject>::err(truncated_error());
-            for (u8 i = 0; i < des_len; ++i)
-                dev.designator += static_cast<char>(data[offset++]);
-            // Software version
-            if (offset >= data.size())
-                return Result<DeviceObject>::err(truncated_error());
-            u8 sw_len = data[offset++];
-            if (offset + sw_len > data.size())
-                return Result<DeviceObject>::err(truncated_error());
-            for (u8 i = 0; i < sw_len; ++i)
-                dev.software_version += static_cast<char>(data[offset++]);
-            // Serial number
-            if (offset >= data.size())
-                return Result<DeviceObject>::err(truncated_error());
-            u8 sn_len = data[offset++];
-            if (offset + sn_len > data.size())
-                return Result<DeviceObject>::err(truncated_error());
-            for (u8 i = 0; i < sn_len; ++i)
-                dev.serial_number += static_cast<char>(data[offset++]);
-            // Structure label (7 bytes)
-            if (offset + 7 > data.size())
-                return Result<DeviceObject>::err(truncated_error());
-            for (usize i = 0; i < 7; ++i)
-                dev.structure_label[i] = data[offset++];
-            // Localization label (7 bytes)
-            if (offset + 7 > data.size())
-                return Result<DeviceObject>::err(truncated_error());
-            for (usize i = 0; i < 7; ++i)
-                dev.localization_label[i] = data[offset++];
-            return Result<DeviceObject>::ok(std::move(dev));
-        }
-
-        static Result<DeviceElement> parse_element(const dp::Vector<u8> &data, usize &offset, ObjectID id) {
-            DeviceElement elem;
-            elem.id = id;
-            if (offset >= data.size())
-                return Result<DeviceElement>::err(truncated_error());
-            elem.type = static_cast<DeviceElementType>(data[offset++]);
-            // Designator
-            if (offset >= data.size())
-                return Result<DeviceElement>::err(truncated_error());
-            u8 des_len = data[offset++];
-            if (offset + des_len > data.size())
-                return Result<DeviceElement>::err(truncated_error());
-            for (u8 i = 0; i < des_len; ++i)
-                elem.designator += static_cast<char>(data[offset++]);
-            // Element number
-            if (offset + 2 > data.size())
-                return Result<DeviceElement>::err(truncated_error());
-            elem.number = static_cast<u16>(data[offset]) | (static_cast<u16>(data[offset + 1]) << 8);
-            offset += 2;
-            // Parent ID
-            if (offset + 2 > data.size())
-                return Result<DeviceElement>::err(truncated_error());
-            elem.parent_id = static_cast<u16>(data[offset]) | (static_cast<u16>(data[offset + 1]) << 8);
-            offset += 2;
-            // Child objects
-            if (offset + 2 > data.size())
-                return Result<DeviceElement>::err(truncated_error());
-            u16 num_children = static_cast<u16>(data[offset]) | (static_cast<u16>(data[offset + 1]) << 8);
-            offset += 2;
-            if (offset + num_children * 2 > data.size())
-                return Result<DeviceElement>::err(truncated_error());
-            for (u16 i = 0; i < num_children; ++i) {
-                ObjectID child = static_cast<u16>(data[offset]) | (static_cast<u16>(data[offset + 1]) << 8);
-                offset += 2;
-                elem.child_objects.push_back(child);
-            }
-            return Result<DeviceElement>::ok(std::move(elem));
-        }
-
-        static Result<DeviceProcessData> parse_process_data(const dp::Vector<u8> &data, usize &offset, ObjectID id) {
-            DeviceProcessData pd;
-            pd.id = id;
-            if (offset + 5 > data.size())
-                return Result<DeviceProcessData>::err(truncated_error());
-            pd.ddi = static_cast<u16>(data[offset]) | (static_cast<u16>(data[offset + 1]) << 8);
-            offset += 2;
-            pd.trigger_methods = data[offset++];
-            pd.presentation_object_id = static_cast<u16>(data[offset]) | (static_cast<u16>(data[offset + 1]) << 8);
-            offset += 2;
-            // Designator
-            if (offset >= data.size())
-                return Result<DeviceProcessData>::err(truncated_error());
-            u8 des_len = data[offset++];
-            if (offset + des_len > data.size())
-                return Result<DeviceProcessData>::err(truncated_error());
-            for (u8 i = 0; i < des_len; ++i)
-                pd.designator += static_cast<char>(data[offset++]);
-            return Result<DeviceProcessData>::ok(std::move(pd));
-        }
-
-        static Result<DeviceProperty> parse_property(const dp::Vector<u8> &data, usize &offset, ObjectID id) {
-            DeviceProperty prop;
-            prop.id = id;
-            if (offset + 8 > data.size())
-                return Result<DeviceProperty>::err(truncated_error());
-            prop.ddi = static_cast<u16>(data[offset]) | (static_cast<u16>(data[offset + 1]) << 8);
-            offset += 2;
-            prop.value = static_cast<i32>(static_cast<u32>(data[offset]) | (static_cast<u32>(data[offset + 1]) << 8) |
-                                          (static_cast<u32>(data[offset + 2]) << 16) |
-                                          (static_cast<u32>(data[offset + 3]) << 24));
-            offset += 4;
-            prop.presentation_object_id = static_cast<u16>(data[offset]) | (static_cast<u16>(data[offset + 1]) << 8);
-            offset += 2;
-            // Designator
-            if (offset >= data.size())
-                return Result<DeviceProperty>::err(truncated_error());
-            u8 des_len = data[offset++];
-            if (offset + des_len > data.size())
-                return Result<DeviceProperty>::err(truncated_error());
-            for (u8 i = 0; i < des_len; ++i)
-                prop.designator += static_cast<char>(data[offset++]);
-            return Result<DeviceProperty>::ok(std::move(prop));
-        }
-
-        static Result<DeviceValuePresentation> parse_value_presentation(const dp::Vector<u8> &data, usize &offset,
-                                                                        ObjectID id) {
-            DeviceValuePresentation vp;
-            vp.id = id;
-            if (offset + 9 > data.size())
-                return Result<DeviceValuePresentation>::err(truncated_error());
-            vp.offset = static_cast<i32>(static_cast<u32>(data[offset]) | (static_cast<u32>(data[offset + 1]) << 8) |
-                                         (static_cast<u32>(data[offset + 2]) << 16) |
-                                         (static_cast<u32>(data[offset + 3]) << 24));
-            offset += 4;
-            u32 scale_bits = static_cast<u32>(data[offset]) | (static_cast<u32>(data[offset + 1]) << 8) |
-                             (static_cast<u32>(data[offset + 2]) << 16) | (static_cast<u32>(data[offset + 3]) << 24);
-            std::memcpy(&vp.scale, &scale_bits, sizeof(f32));
-            offset += 4;
-            vp.decimal_digits = data[offset++];
-            // Unit designator
-            if (offset >= data.size())
-                return Result<DeviceValuePresentation>::err(truncated_error());
-            u8 des_len = data[offset++];
-            if (offset + des_len > data.size())
-                return Result<DeviceValuePresentation>::err(truncated_error());
-            for (u8 i = 0; i < des_len; ++i)
-                vp.unit_designator += static_cast<char>(data[offset++]);
-            return Result<DeviceValuePresentation>::ok(std::move(vp));
-        }
-
-        static Error truncated_error() {
-            return Error(ErrorCode::PoolValidation, "DDOP data truncated during deserialization");
-        }
-
         // ─── ISOXML helpers ────────────────────────────────────────────────────
-        static dp::String xml_escape(const dp::String &s) {
-            dp::String out;
-            for (char c : s) {
-                switch (c) {
-                case '&':
-                    out += "&amp;";
-                    break;
-                case '<':
-                    out += "&lt;";
-                    break;
-                case '>':
-                    out += "&gt;";
-                    break;
-                case '"':
-                    out += "&quot;";
-                    break;
-                case '\'':
-                    out += "&apos;";
-                    break;
-                default:
-                    out += c;
-                    break;
+        void write_element_xml(IsoxmlWriter &xml, const DeviceElement &elem) const {
+            xml.open("DET")
+                .ref("A", "DET", elem.id)
+                .attr("B", static_cast<u8>(elem.type))
+                .attr("C", elem.designator)
+                .attr("D", elem.number)
+                .ref("E", "DET", elem.parent_id);
+
+            // Process data and properties that are children of this element
+            for (auto child_id : elem.child_objects) {
+                if (const auto *pd = find_process_data(child_id)) {
+                    xml.open("DPD")
+                        .ref("A", "DPD", pd->id)
+                        .attr("B", pd->ddi)
+                        .attr("C", pd->trigger_methods)
+                        .attr("D", pd->designator);
+                    if (pd->presentation_object_id != 0xFFFF)
+                        xml.ref("E", "DVP", pd->presentation_object_id);
+                    xml.close();
+                }
+                if (const auto *prop = find_property(child_id)) {
+                    xml.open("DPT")
+                        .ref("A", "DPT", prop->id)
+                        .attr("B", prop->ddi)
+                        .attr("C", prop->value)
+                        .attr("D", prop->designator);
+                    if (prop->presentation_object_id != 0xFFFF)
+                        xml.ref("E", "DVP", prop->presentation_object_id);
+                    xml.close();
                 }
             }
-            return out;
+            xml.end("DET");
         }
 
-        dp::String emit_element_xml(const DeviceElement &elem) const {
-            dp::String xml;
-            dp::String type_str;
-            switch (elem.type) {
-            case DeviceElementType::Device:
-                type_str = "1";
-                break;
-            case DeviceElementType::Function:
-                type_str = "2";
-                break;
-            case DeviceElementType::Bin:
-                type_str = "3";
-                break;
-            case DeviceElementType::Section:
-                type_str = "4";
-                break;
-            case DeviceElementType::Unit:
-                type_str = "5";
-                break;
-            case DeviceElementType::Connector:
-                type_str = "6";
-                break;
-            case DeviceElementType::NavigationReference:
-                type_str = "7";
-                break;
-            }
+        bool object_exists(ObjectID id) const { return contains(id); }
 
-            xml += "    <DET A=\"DET-";
-            xml += dp::to_string(elem.id);
-            xml += "\" B=\"";
-            xml += type_str;
-            xml += "\" C=\"";
-            xml += xml_escape(elem.designator);
-            xml += "\" D=\"";
-            xml += dp::to_string(elem.number);
-            xml += "\" E=\"DET-";
-            xml += dp::to_string(elem.parent_id);
-            xml += "\">\n";
-
-            // Emit process data and properties that are children of this element
-            for (auto child_id : elem.child_objects) {
-                for (const auto &pd : process_data_) {
-                    if (pd.id == child_id) {
-                        xml += "      <DPD A=\"DPD-";
-                        xml += dp::to_string(pd.id);
-                        xml += "\" B=\"";
-                        xml += dp::to_string(pd.ddi);
-                        xml += "\" C=\"";
-                        xml += dp::to_string(static_cast<u32>(pd.trigger_methods));
-                        xml += "\" D=\"";
-                        xml += xml_escape(pd.designator);
-                        xml += "\"";
-                        if (pd.presentation_object_id != 0xFFFF) {
-                            xml += " E=\"DVP-";
-                            xml += dp::to_string(pd.presentation_object_id);
-                            xml += "\"";
-                        }
-                        xml += "/>\n";
-                    }
-                }
-                for (const auto &prop : properties_) {
-                    if (prop.id == child_id) {
-                        xml += "      <DPT A=\"DPT-";
-                        xml += dp::to_string(prop.id);
-                        xml += "\" B=\"";
-                        xml += dp::to_string(prop.ddi);
-                        xml += "\" C=\"";
-                        xml += dp::to_string(prop.value);
-                        xml += "\" D=\"";
-                        xml += xml_escape(prop.designator);
-                        xml += "\"";
-                        if (prop.presentation_object_id != 0xFFFF) {
-                            xml += " E=\"DVP-";
-                            xml += dp::to_string(prop.presentation_object_id);
-                            xml += "\"";
-                        }
-                        xml += "/>\n";
-                    }
-                }
-            }
+        bool vp_exists(ObjectID id) const { return find_value_presentation(id) != nullptr; }
 
-            xml += "    </DET>\n";
-            return xml;
+        template <typename T>
+        const T *lookup(const dp::Vector<T> &objects, TCObjectType type, ObjectID id) const {
+            auto it = index_.find(id);
+            if (it == index_.end() || it->second.type != type)
+                return nullptr;
+            return &objects[it->second.index];
         }
-        bool object_exists(ObjectID id) const {
-            for (const auto &d : devices_) {
-                if (d.id == id)
-                    return true;
-            }
-            for (const auto &e : elements_) {
-                if (e.id == id)
-                    return true;
-            }
-            for (const auto &pd : process_data_) {
-                if (pd.id == id)
-                    return true;
-            }
-            for (const auto &p : properties_) {
-                if (p.id == id)
-                    return true;
-            }
-            for (const auto &vp : value_presentations_) {
-                if (vp.id == id)
-                    return true;
-            }
-            return false;
+
+        void index_object(TCObjectType type, ObjectID id, usize index) {
+            if (index_.find(id) == index_.end())
+                index_[id] = ObjectRef{type, static_cast<u32>(index)};
         }
 
-        bool vp_exists(ObjectID id) const {
-            for (const auto &vp : value_presentations_) {
-                if (vp.id == id)
-                    return true;
+        void index_element(usize index) {
+            const DeviceElement &elem = elements_[index];
+            index_object(TCObjectType::DeviceElement, elem.id, index);
+            index_children(index);
+        }
+
+        void index_children(usize index) {
+            for (auto child : elements_[index].child_objects) {
+                if (parents_.find(child) == parents_.end())
+                    parents_[child] = static_cast<u32>(index);
             }
-            return false;
         }
     };
 
@@ -0,0 +1,273 @@
+#pragma once
+
+#include "objects.hpp"
+#include <agrobus/net/data_span.hpp>
+#include <agrobus/net/error.hpp>
+#include <agrobus/net/types.hpp>
+#include <cstring>
+#include <datapod/datapod.hpp>
+#include <string_view>
+
+namespace agrobus::isobus::tc {
+    using namespace agrobus::net;
+
+    // ─── Child object IDs of an element, read from the pool bytes ────────────────
+    class ChildRefs {
+        const u8 *data_ = nullptr;
+        u16 count_ = 0;
+
+      public:
+        ChildRefs() = default;
+        ChildRefs(const u8 *data, u16 count) : data_(data), count_(count) {}
+
+        u16 size() const noexcept { return count_; }
+        bool empty() const noexcept { return count_ == 0; }
+        ObjectID operator[](u16 i) const noexcept {
+            return static_cast<ObjectID>(data_[i * 2]) | (static_cast<ObjectID>(data_[i * 2 + 1]) << 8);
+        }
+    };
+
+    // ─── Zero-copy view of a serialized DDOP ─────────────────────────────────────
+    // One pass over the bytes decodes each object's fixed fields into a small
+    // record; designators and child lists stay in the buffer as views. There
+    // is no per-object allocation, only the per-type record arrays and the ID
+    // index, for a TC server that needs to index a pool, not edit it. Every
+    // view points into the parsed bytes, which must outlive the DDOPView.
+    class DDOPView {
+      public:
+        struct Device {
+            ObjectID id = 0;
+            std::string_view designator;
+            std::string_view software_version;
+            std::string_view serial_number;
+            DataSpan structure_label; // 7 bytes
+            DataSpan localization_label;
+        };
+
+        struct Element {
+            ObjectID id = 0;
+            DeviceElementType type = DeviceElementType::Device;
+            std::string_view designator;
+            ElementNumber number = 0;
+            ObjectID parent_id = 0;
+            ChildRefs children;
+        };
+
+        struct ProcessData {
+            ObjectID id = 0;
+            DDI ddi = 0;
+            u8 trigger_methods = 0;
+            ObjectID presentation_object_id = 0xFFFF;
+            std::string_view designator;
+        };
+
+        struct Property {
+            ObjectID id = 0;
+            DDI ddi = 0;
+            i32 value = 0;
+            ObjectID presentation_object_id = 0xFFFF;
+            std::string_view designator;
+        };
+
+        struct ValuePresentation {
+            ObjectID id = 0;
+            i32 offset = 0;
+            f32 scale = 1.0f;
+            u8 decimal_digits = 0;
+            std::string_view unit_designator;
+        };
+
+      private:
+        DataSpan bytes_;
+        dp::Vector<Device> devices_;
+        dp::Vector<Element> elements_;
+        dp::Vector<ProcessData> process_data_;
+        dp::Vector<Property> properties_;
+        dp::Vector<ValuePresentation> value_presentations_;
+        dp::Map<ObjectID, ObjectRef> index_; // First object under each ID
+
+        // Bounds-checked little-endian reader over the pool bytes
+        struct Reader {
+            const u8 *data;
+            usize size;
+            usize offset = 0;
+            bool ok = true;
+
+            bool take(usize n) noexcept {
+                if (!ok || offset + n > size)
+                    ok = false;
+                return ok;
+            }
+            u8 u8_() noexcept { return take(1) ? data[offset++] : 0; }
+            u16 u16_() noexcept {
+                if (!take(2))
+                    return 0;
+                u16 v = static_cast<u16>(data[offset]) | (static_cast<u16>(data[offset + 1]) << 8);
+                offset += 2;
+                return v;
+            }
+            u32 u32_() noexcept {
+                if (!take(4))
+                    return 0;
+                u32 v = 0;
+                for (u8 i = 0; i < 4; ++i)
+                    v |= static_cast<u32>(data[offset + i]) << (8 * i);
+                offset += 4;
+                return v;
+            }
+            const u8 *bytes(usize n) noexcept {
+                if (!take(n))
+                    return nullptr;
+                const u8 *p = data + offset;
+                offset += n;
+                return p;
+            }
+            std::string_view string() noexcept {
+                u8 len = u8_();
+                const u8 *p = bytes(len);
+                return p ? std::string_view(reinterpret_cast<const char *>(p), len) : std::string_view();
+            }
+        };
+
+      public:
+        static Result<DDOPView> parse(DataSpan bytes) {
+            DDOPView view;
+            view.bytes_ = bytes;
+            Reader r{bytes.data(), bytes.size()};
+
+            while (r.offset < r.size) {
+                if (r.offset + 3 > r.size)
+                    return Result<DDOPView>::err(
+                        Error(ErrorCode::PoolValidation, "DDOP truncated: not enough bytes for object header"));
+                auto type = static_cast<TCObjectType>(r.u8_());
+                ObjectID id = r.u16_();
+                usize index = 0;
+
+                switch (type) {
+                case TCObjectType::Device: {
+                    Device d;
+                    d.id = id;
+                    d.designator = r.string();
+                    d.software_version = r.string();
+                    d.serial_number = r.string();
+                    const u8 *labels = r.bytes(14);
+                    if (labels) {
+                        d.structure_label = DataSpan(labels, 7);
+                        d.localization_label = DataSpan(labels + 7, 7);
+                    }
+                    index = view.devices_.size();
+                    view.devices_.push_back(d);
+                    break;
+                }
+                case TCObjectType::DeviceElement: {
+                    Element e;
+                    e.id = id;
+                    e.type = static_cast<DeviceElementType>(r.u8_());
+                    e.designator = r.string();
+                    e.number = r.u16_();
+                    e.parent_id = r.u16_();
+                    u16 count = r.u16_();
+                    const u8 *children = r.bytes(static_cast<usize>(count) * 2);
+                    if (children)
+                        e.children = ChildRefs(children, count);
+                    index = view.elements_.size();
+                    view.elements_.push_back(e);
+                    break;
+                }
+                case TCObjectType::DeviceProcessData: {
+                    ProcessData pd;
+                    pd.id = id;
+                    pd.ddi = r.u16_();
+                    pd.trigger_methods = r.u8_();
+                    pd.presentation_object_id = r.u16_();
+                    pd.designator = r.string();
+                    index = view.process_data_.size();
+                    view.process_data_.push_back(pd);
+                    break;
+                }
+                case TCObjectType::DeviceProperty: {
+                    Property prop;
+                    prop.id = id;
+                    prop.ddi = r.u16_();
+                    prop.value = static_cast<i32>(r.u32_());
+                    prop.presentation_object_id = r.u16_();
+                    prop.designator = r.string();
+                    index = view.properties_.size();
+                    view.properties_.push_back(prop);
+                    break;
+                }
+                case TCObjectType::DeviceValuePresentation: {
+                    ValuePresentation vp;
+                    vp.id = id;
+                    vp.offset = static_cast<i32>(r.u32_());
+                    u32 scale_bits = r.u32_();
+                    std::memcpy(&vp.scale, &scale_bits, sizeof(f32));
+                    vp.decimal_digits = r.u8_();
+                    vp.unit_designator = r.string();
+                    index = view.value_presentations_.size();
+                    view.value_presentations_.push_back(vp);
+                    break;
+                }
+                default:
+                    return Result<DDOPView>::err(Error(ErrorCode::PoolValidation, "unknown TC object type in DDOP"));
+                }
+
+                if (!r.ok)
+                    return Result<DDOPView>::err(
+                        Error(ErrorCode::PoolValidation, "DDOP data truncated during deserialization"));
+                if (view.index_.find(id) == view.index_.end())
+                    view.index_[id] = ObjectRef{type, static_cast<u32>(index)};
+            }
+            return Result<DDOPView>::ok(std::move(view));
+        }
+
+        // ─── Access ──────────────────────────────────────────────────────────────
+        DataSpan bytes() const noexcept { return bytes_; }
+        const dp::Vector<Device> &devices() const noexcept { return devices_; }
+        const dp::Vector<Element> &elements() const noexcept { return elements_; }
+        const dp::Vector<ProcessData> &process_data() const noexcept { return process_data_; }
+        const dp::Vector<Property> &properties() const noexcept { return properties_; }
+        const dp::Vector<ValuePresentation> &value_presentations() const noexcept { return value_presentations_; }
+
+        usize object_count() const noexcept {
+            return devices_.size() + elements_.size() + process_data_.size() + properties_.size() +
+                   value_presentations_.size();
+        }
+
+        const dp::Map<ObjectID, ObjectRef> &index() const noexcept { return index_; }
+
+        dp::Optional<ObjectRef> find(ObjectID id) const {
+            auto it = index_.find(id);
+            if (it == index_.end())
+                return dp::nullopt;
+            return it->second;
+        }
+
+        const Element *find_element(ObjectID id) const { return lookup(elements_, TCObjectType::DeviceElement, id); }
+        const ProcessData *find_process_data(ObjectID id) const {
+            return lookup(process_data_, TCObjectType::DeviceProcessData, id);
+        }
+        const Property *find_property(ObjectID id) const {
+            return lookup(properties_, TCObjectType::DeviceProperty, id);
+        }
+
+        // DDI of a process data or property object
+        dp::Optional<DDI> ddi_of(ObjectID id) const {
+            if (const auto *pd = find_process_data(id))
+                return pd->ddi;
+            if (const auto *prop = find_property(id))
+                return prop->ddi;
+            return dp::nullopt;
+        }
+
+      private:
+        template <typename T>
+        const T *lookup(const dp::Vector<T> &objects, TCObjectType type, ObjectID id) const {
+            auto it = index_.find(id);
+            if (it == index_.end() || it->second.type != type)
+                return nullptr;
+            return &objects[it->second.index];
+        }
+    };
+
+} // namespace agrobus::isobus::tc
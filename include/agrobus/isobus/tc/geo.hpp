@@ -1,6 +1,8 @@
 #pragma once
 
+#include "isoxml_reader.hpp"
 #include "objects.hpp"
+#include "prescription.hpp"
 #include "server_options.hpp"
 #include <agrobus/net/constants.hpp>
 #include <agrobus/net/control_function.hpp>
@@ -10,6 +12,7 @@
 #include <agrobus/net/message.hpp>
 #include <agrobus/net/network_manager.hpp>
 #include <agrobus/net/types.hpp>
+#include <cmath>
 #include <concord/concord.hpp>
 #include <datapod/datapod.hpp>
 #include <echo/echo.hpp>
@@ -33,26 +36,42 @@ namespace agrobus::isobus::tc {
         u64 timestamp_us = 0;
     };
 
-    struct PrescriptionZone {
-        dp::Vector<concord::earth::WGS> boundary; // Polygon vertices
-        i32 application_rate = 0;                 // Rate value (DDI-dependent units)
-    };
-
-    struct PrescriptionMap {
-        dp::String structure_label;
-        dp::Vector<PrescriptionZone> zones;
+    // Where a boom section's centre sits relative to the GNSS antenna
+    struct SectionOffset {
+        f64 forward_m = 0.0; // Along the heading (negative = behind the antenna)
+        f64 right_m = 0.0;   // Across it (negative = left)
     };
 
     // ─── TC-GEO Interface ────────────────────────────────────────────────────────
     // Position data arrives via GNSS PGNs (129025/129027). The TC-GEO interface
     // uses standard TC process data DDIs to communicate position to the TC server,
-    // and evaluates prescription maps to determine application rates.
+    // and evaluates prescription maps to determine application rates. Maps are
+    // indexed as they are added, so a rate lookup tests only the zones whose
+    // bounding box holds the position. Grid maps (ISOXML GRD) are read cell
+    // by cell instead; polygon maps come first, then the grids in order.
+    //
+    // With section offsets and a heading, update() also gives the rate for
+    // each section where it will be one look-ahead time from now, so the
+    // rate controller can open valves ahead of their response lag.
     class TCGEOInterface {
+
         IsoNet &net_;
         InternalCF *cf_;
         dp::Vector<PrescriptionMap> maps_;
+        PrescriptionIndex index_;
+        dp::Vector<GridMap> grids_;
+        u32 maps_version_ = 0; // Bumped on every change to maps_, so a load finishing late can tell
+        u32 loads_pending_ = 0;
         dp::Optional<GeoPoint> current_position_;
         dp::Optional<i32> last_rate_;
+        dp::Optional<f64> heading_rad_; // Course over ground, clockwise from north
+        f64 speed_mps_ = 0.0;
+        u32 look_ahead_ms_ = 500;
+        dp::Vector<SectionOffset> sections_;
+        dp::Vector<LocalPoint> section_positions_; // In the index's ENU frame
+        dp::Vector<u32> section_hints_;
+        dp::Vector<dp::Optional<i32>> section_rates_;
+        dp::Vector<dp::Optional<i32>> previous_rates_;
 
       public:
         TCGEOInterface(IsoNet &net, InternalCF *cf) : net_(net), cf_(cf) {}
@@ -63,6 +82,8 @@ namespace agrobus::isobus::tc {
             }
             // Listen for GNSS position updates (PGN 129025 - Position Rapid Update)
             net_.register_pgn_callback(PGN_GNSS_POSITION, [this](const Message &msg) { handle_gnss_position(msg); });
+            // Heading and speed for the section look-ahead (PGN 129026 - COG & SOG, Rapid Update)
+            net_.register_pgn_callback(PGN_GNSS_COG_SOG_RAPID, [this](const Message &msg) { handle_cog_sog(msg); });
             echo::category("isobus.tc.geo").info("TC-GEO interface initialized");
             return {};
         }
@@ -76,6 +97,72 @@ namespace agrobus::isobus::tc {
             return {};
         }
 
+        // Course over ground (radians, clockwise from north) and speed
+        void set_motion(f64 heading_rad, f64 speed_mps) noexcept {
+            heading_rad_ = heading_rad;
+            speed_mps_ = speed_mps;
+        }
+
+        dp::Optional<f64> heading() const noexcept { return heading_rad_; }
+        f64 speed() const noexcept { return speed_mps_; }
+
+        // ─── Section look-ahead ────────────────────────────────────────────────────
+        Result<void> set_sections(dp::Vector<SectionOffset> sections) {
+            sections_ = std::move(sections);
+            section_positions_.assign(sections_.size(), LocalPoint{});
+            section_hints_.assign(sections_.size(), PrescriptionIndex::NO_HINT);
+            section_rates_.assign(sections_.size(), dp::nullopt);
+            previous_rates_.assign(sections_.size(), dp::nullopt);
+            echo::category("isobus.tc.geo").debug("section offsets set: ", sections_.size());
+            return {};
+        }
+
+        // How far ahead in time section positions are projected (valve lag)
+        void set_look_ahead(u32 ms) noexcept { look_ahead_ms_ = ms; }
+        u32 look_ahead() const noexcept { return look_ahead_ms_; }
+
+        const dp::Vector<SectionOffset> &sections() const noexcept { return sections_; }
+        const dp::Vector<LocalPoint> &section_positions() const noexcept { return section_positions_; }
+        // Per section, the rate at its projected position (nullopt outside every zone)
+        const dp::Vector<dp::Optional<i32>> &section_rates() const noexcept { return section_rates_; }
+
+        // Projects every section one look-ahead ahead and looks up its rate.
+        // The antenna goes into the index's ENU frame once and the heading
+        // into an east/north step; each section is then a few multiplies in
+        // metres and one index lookup. Sections outside every zone then try
+        // the grids, the same offsets applied in each grid's own frame.
+        bool update_section_rates() {
+            if (!current_position_ || !heading_rad_ || sections_.empty() || (index_.empty() && grids_.empty()))
+                return false;
+            LocalPoint antenna = index_.empty() ? LocalPoint{} : index_.to_local(current_position_->position);
+            f64 ahead_m = speed_mps_ * static_cast<f64>(look_ahead_ms_) / 1000.0;
+            f64 sin_h = std::sin(*heading_rad_);
+            f64 cos_h = std::cos(*heading_rad_);
+            for (usize i = 0; i < sections_.size(); ++i) {
+                f64 forward = sections_[i].forward_m + ahead_m;
+                f64 right = sections_[i].right_m;
+                section_positions_[i].east = antenna.east + static_cast<f32>(forward * sin_h + right * cos_h);
+                section_positions_[i].north = antenna.north + static_cast<f32>(forward * cos_h - right * sin_h);
+            }
+            if (index_.empty())
+                section_rates_.assign(sections_.size(), dp::nullopt);
+            else
+                index_.rates_at(maps_, section_positions_, section_hints_, section_rates_);
+
+            // The same offsets from the antenna in each grid's own frame
+            for (const auto &grid : grids_) {
+                LocalPoint origin = grid.to_local(current_position_->position);
+                for (usize i = 0; i < sections_.size(); ++i) {
+                    if (section_rates_[i])
+                        continue;
+                    f32 east = origin.east + section_positions_[i].east - antenna.east;
+                    f32 north = origin.north + section_positions_[i].north - antenna.north;
+                    section_rates_[i] = grid.rate(LocalPoint{east, north});
+                }
+            }
+            return true;
+        }
+
         // ─── Send position as TC process data (DDI 135/136) ────────────────────────
         Result<void> send_position_process_data(ControlFunction *dest) {
             echo::category("isobus.tc.geo").debug("sending position process data");
@@ -116,25 +203,58 @@ namespace agrobus::isobus::tc {
             echo::category("isobus.tc.geo")
                 .info("Prescription map added: ", map.structure_label, " zones=", map.zones.size());
             maps_.push_back(std::move(map));
+            index_.build(maps_);
+            ++maps_version_;
+            return {};
+        }
+
+        // Reads the prescription maps of a TASKDATA.XML on the IsoNet work
+        // pool, building their index and mapping the grid files there too
+        // (load_prescription_index); lookups keep using the maps already
+        // loaded until the result is swapped in during a later
+        // IsoNet::update(). Without a work pool it all runs now. If maps were
+        // added or cleared meanwhile, the loaded ones are appended and the
+        // index rebuilt on this thread instead.
+        void load_prescription_maps(const dp::String &path, TaskDataOptions options = {}) {
+            ++loads_pending_;
+            u32 version = maps_version_;
+            bool replace = maps_.empty();
+            echo::category("isobus.tc.geo").debug("loading prescription maps: ", path);
+            net_.offload([path, options] { return load_prescription_index(path, options); },
+                         [this, version, replace](Result<LoadedPrescriptions> loaded) {
+                             prescriptions_loaded(version, replace, std::move(loaded));
+                         });
+        }
+
+        bool loading_prescription_maps() const noexcept { return loads_pending_ > 0; }
+
+        Result<void> add_grid_map(GridMap grid) {
+            echo::category("isobus.tc.geo")
+                .info("Grid map added: ", grid.label(), " cells=", grid.cells(), " products=", grid.products());
+            grids_.push_back(std::move(grid));
             return {};
         }
 
         Result<void> clear_prescription_maps() {
             maps_.clear();
+            index_.clear();
+            grids_.clear();
+            ++maps_version_;
             echo::category("isobus.tc.geo").trace("prescription maps cleared");
             return {};
         }
 
         const dp::Vector<PrescriptionMap> &prescription_maps() const noexcept { return maps_; }
+        const PrescriptionIndex &prescription_index() const noexcept { return index_; }
+        const dp::Vector<GridMap> &grid_maps() const noexcept { return grids_; }
 
         // Check if a position falls within any prescription zone and return rate
         dp::Optional<i32> get_rate_at_position(const concord::earth::WGS &pos) const {
-            for (const auto &map : maps_) {
-                for (const auto &zone : map.zones) {
-                    if (point_in_polygon(pos, zone.boundary)) {
-                        return zone.application_rate;
-                    }
-                }
+            if (const PrescriptionZone *zone = index_.find(maps_, pos))
+                return zone->application_rate;
+            for (const auto &grid : grids_) {
+                if (auto rate = grid.rate(pos))
+                    return rate;
             }
             return dp::nullopt;
         }
@@ -145,6 +265,9 @@ namespace agrobus::isobus::tc {
         Event<const GeoPoint &> on_position_update;
         Event<i32> on_application_rate_changed; // New rate based on position
         Event<const PrescriptionMap &> on_prescription_map_received;
+        Event<usize> on_prescription_maps_loaded;         // Maps and grids added by load_prescription_maps()
+        Event<const Error &> on_prescription_load_failed; // load_prescription_maps() could not read the file
+        Event<const dp::Vector<dp::Optional<i32>> &> on_section_rates_changed; // Look-ahead rate per section
 
         void update(u32 /*elapsed_ms*/) {
             // Check current position against prescription maps
@@ -155,9 +278,44 @@ namespace agrobus::isobus::tc {
                     on_application_rate_changed.emit(*rate);
                 }
             }
+            if (update_section_rates()) {
+                bool changed = false;
+                for (usize i = 0; i < section_rates_.size(); ++i) {
+                    if (section_rates_[i] != previous_rates_[i]) {
+                        previous_rates_[i] = section_rates_[i];
+                        changed = true;
+                    }
+                }
+                if (changed)
+                    on_section_rates_changed.emit(section_rates_);
+            }
         }
 
       private:
+        void prescriptions_loaded(u32 version, bool replace, Result<LoadedPrescriptions> loaded) {
+            --loads_pending_;
+            if (!loaded.is_ok()) {
+                echo::category("isobus.tc.geo").error("prescription load failed: ", loaded.error().message);
+                on_prescription_load_failed.emit(loaded.error());
+                return;
+            }
+            LoadedPrescriptions &result = loaded.value();
+            usize count = result.maps.size() + result.grids.size();
+            for (auto &grid : result.grids)
+                grids_.push_back(std::move(grid));
+            if (replace && version == maps_version_) {
+                maps_ = std::move(result.maps);
+                index_ = std::move(result.index);
+            } else {
+                for (auto &map : result.maps)
+                    maps_.push_back(std::move(map));
+                index_.build(maps_);
+            }
+            ++maps_version_;
+            echo::category("isobus.tc.geo").info("Prescription maps loaded: ", count, " zones=", index_.size());
+            on_prescription_maps_loaded.emit(count);
+        }
+
         void handle_gnss_position(const Message &msg) {
             if (msg.data.size() < 8)
                 return;
@@ -179,23 +337,14 @@ namespace agrobus::isobus::tc {
             set_position(point);
         }
 
-        // Ray-casting point-in-polygon test
-        static bool point_in_polygon(const concord::earth::WGS &point, const dp::Vector<concord::earth::WGS> &polygon) {
-            if (polygon.size() < 3)
-                return false;
-
-            bool inside = false;
-            usize n = polygon.size();
-            for (usize i = 0, j = n - 1; i < n; j = i++) {
-                f64 xi = polygon[i].longitude, yi = polygon[i].latitude;
-                f64 xj = polygon[j].longitude, yj = polygon[j].latitude;
-
-                bool intersect = ((yi > point.latitude) != (yj > point.latitude)) &&
-                                 (point.longitude < (xj - xi) * (point.latitude - yi) / (yj - yi) + xi);
-                if (intersect)
-                    inside = !inside;
-            }
-            return inside;
+        void handle_cog_sog(const Message &msg) {
+            if (msg.data.size() < 6)
+                return;
+            u16 cog_raw = msg.get_u16_le(2); // 1e-4 rad
+            u16 sog_raw = msg.get_u16_le(4); // 0.01 m/s
+            if (cog_raw == 0xFFFF || sog_raw == 0xFFFF)
+                return;
+            set_motion(static_cast<f64>(cog_raw) * 1e-4, static_cast<f64>(sog_raw) * 0.01);
         }
     };
 
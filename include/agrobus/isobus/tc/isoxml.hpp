@@ -0,0 +1,397 @@
+#pragma once
+
+#include "objects.hpp"
+#include <agrobus/net/data_span.hpp>
+#include <agrobus/net/error.hpp>
+#include <agrobus/net/types.hpp>
+#include <cstring>
+#include <datapod/datapod.hpp>
+#include <echo/echo.hpp>
+#include <fcntl.h>
+#include <functional>
+#include <string_view>
+#include <unistd.h>
+
+namespace agrobus::isobus::tc {
+    using namespace agrobus::net;
+
+    // ─── Output sinks ────────────────────────────────────────────────────────────
+    // A sink takes each filled buffer and returns false when it cannot. Files,
+    // a mapped region or a zip entry writer all fit behind the same callback.
+    using IsoxmlSink = std::function<bool(DataSpan)>;
+
+    // Appends to a string; for tests and small exports
+    inline IsoxmlSink string_sink(dp::String &out) {
+        return [&out](DataSpan bytes) {
+            out.append(reinterpret_cast<const char *>(bytes.data()), bytes.size());
+            return true;
+        };
+    }
+
+    // Writes to a file descriptor it owns
+    class FileSink {
+        int fd_ = -1;
+
+      public:
+        FileSink() = default;
+        ~FileSink() { close(); }
+
+        FileSink(const FileSink &) = delete;
+        FileSink &operator=(const FileSink &) = delete;
+
+        Result<void> open(const dp::String &path) {
+            close();
+            fd_ = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+            if (fd_ < 0)
+                return Result<void>::err(Error(ErrorCode::DriverError, "cannot create ISOXML file"));
+            return {};
+        }
+
+        void close() {
+            if (fd_ >= 0)
+                ::close(fd_);
+            fd_ = -1;
+        }
+
+        bool is_open() const noexcept { return fd_ >= 0; }
+
+        // The sink refers to this FileSink, which must outlive the writer
+        IsoxmlSink sink() {
+            return [this](DataSpan bytes) {
+                const u8 *p = bytes.data();
+                usize size = bytes.size();
+                while (size > 0) {
+                    if (fd_ < 0)
+                        return false;
+                    ssize_t n = ::write(fd_, p, size);
+                    if (n <= 0)
+                        return false;
+                    p += n;
+                    size -= static_cast<usize>(n);
+                }
+                return true;
+            };
+        }
+    };
+
+    // ─── Buffered output ─────────────────────────────────────────────────────────
+    // One fixed buffer, handed to the sink whenever it fills; nothing else is
+    // allocated while writing. After a sink failure further output is dropped
+    // and failed() stays set.
+    class SinkBuffer {
+        IsoxmlSink sink_;
+        dp::Vector<u8> buffer_;
+        usize used_ = 0;
+        u64 written_ = 0;
+        bool failed_ = false;
+
+      public:
+        explicit SinkBuffer(IsoxmlSink sink, usize capacity = 4096) : sink_(std::move(sink)) {
+            buffer_.assign(capacity == 0 ? 1 : capacity, 0);
+        }
+        ~SinkBuffer() { (void)flush(); }
+
+        SinkBuffer(const SinkBuffer &) = delete;
+        SinkBuffer &operator=(const SinkBuffer &) = delete;
+
+        void put(const void *data, usize size) {
+            const u8 *p = static_cast<const u8 *>(data);
+            while (size > 0 && !failed_) {
+                usize n = buffer_.size() - used_;
+                if (n > size)
+                    n = size;
+                std::memcpy(buffer_.data() + used_, p, n);
+                used_ += n;
+                p += n;
+                size -= n;
+                if (used_ == buffer_.size())
+                    (void)flush();
+            }
+        }
+
+        void put(char c) { put(&c, 1); }
+        void put(std::string_view s) { put(s.data(), s.size()); }
+
+        template <typename T> void put_le(T value) {
+            u8 bytes[sizeof(T)];
+            for (usize i = 0; i < sizeof(T); ++i)
+                bytes[i] = static_cast<u8>((static_cast<u64>(value) >> (8 * i)) & 0xFF);
+            put(bytes, sizeof(T));
+        }
+
+        Result<void> flush() {
+            if (used_ > 0 && !failed_) {
+                if (!sink_ || !sink_(DataSpan(buffer_.data(), used_))) {
+                    failed_ = true;
+                    echo::category("isobus.tc").error("ISOXML sink write failed");
+                } else {
+                    written_ += used_;
+                }
+            }
+            used_ = 0;
+            if (failed_)
+                return Result<void>::err(Error(ErrorCode::DriverError, "ISOXML sink write failed"));
+            return {};
+        }
+
+        bool failed() const noexcept { return failed_; }
+        u64 written() const noexcept { return written_ + used_; } // Bytes accepted so far
+    };
+
+    // ─── Streaming ISOXML writer ─────────────────────────────────────────────────
+    // Writes TASKDATA-style XML straight into a SinkBuffer: open() starts a
+    // tag, attr() adds escaped attributes, then either close() ends it empty
+    // or children follow and end() closes it. Indentation follows the
+    // nesting depth.
+    //
+    //   IsoxmlWriter xml(file.sink());
+    //   xml.declaration();
+    //   xml.open("ISO11783_TaskData").attr("VersionMajor", 4);
+    //   ddop.write_isoxml(xml);
+    //   xml.end("ISO11783_TaskData");
+    class IsoxmlWriter {
+        SinkBuffer out_;
+        u32 depth_ = 0;
+        bool in_tag_ = false; // Start tag written, '>' still pending
+
+      public:
+        explicit IsoxmlWriter(IsoxmlSink sink, usize capacity = 4096) : out_(std::move(sink), capacity) {}
+
+        void declaration() { out_.put("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"); }
+
+        IsoxmlWriter &open(std::string_view tag) {
+            finish_start();
+            indent();
+            out_.put('<');
+            out_.put(tag);
+            in_tag_ = true;
+            ++depth_;
+            return *this;
+        }
+
+        IsoxmlWriter &attr(std::string_view name, std::string_view value) {
+            begin_attr(name);
+            escape(value);
+            out_.put('"');
+            return *this;
+        }
+        IsoxmlWriter &attr(std::string_view name, const char *value) { return attr(name, std::string_view(value)); }
+        IsoxmlWriter &attr(std::string_view name, const dp::String &value) {
+            return attr(name, std::string_view(value.data(), value.size()));
+        }
+
+        IsoxmlWriter &attr(std::string_view name, i64 value) {
+            begin_attr(name);
+            number(value);
+            out_.put('"');
+            return *this;
+        }
+        IsoxmlWriter &attr(std::string_view name, i32 value) { return attr(name, static_cast<i64>(value)); }
+        IsoxmlWriter &attr(std::string_view name, u32 value) { return attr(name, static_cast<i64>(value)); }
+        IsoxmlWriter &attr(std::string_view name, u16 value) { return attr(name, static_cast<i64>(value)); }
+        IsoxmlWriter &attr(std::string_view name, u8 value) { return attr(name, static_cast<i64>(value)); }
+
+        IsoxmlWriter &attr(std::string_view name, f32 value) {
+            auto s = dp::to_string(value);
+            return attr(name, std::string_view(s.data(), s.size()));
+        }
+
+        // Object reference such as "DET-12"
+        IsoxmlWriter &ref(std::string_view name, std::string_view prefix, u32 id) {
+            begin_attr(name);
+            out_.put(prefix);
+            out_.put('-');
+            number(id);
+            out_.put('"');
+            return *this;
+        }
+
+        // Fixed-width upper-case hex, as DDIs are written (A="0001")
+        IsoxmlWriter &hex(std::string_view name, u32 value, u8 digits) {
+            static constexpr char DIGITS[] = "0123456789ABCDEF";
+            begin_attr(name);
+            for (u8 i = digits; i > 0; --i)
+                out_.put(DIGITS[(value >> (4 * (i - 1))) & 0xF]);
+            out_.put('"');
+            return *this;
+        }
+
+        // Ends the current tag with no children
+        void close() {
+            out_.put("/>\n");
+            in_tag_ = false;
+            --depth_;
+        }
+
+        void end(std::string_view tag) {
+            --depth_;
+            if (in_tag_) {
+                out_.put("/>\n");
+                in_tag_ = false;
+                return;
+            }
+            indent();
+            out_.put("</");
+            out_.put(tag);
+            out_.put(">\n");
+        }
+
+        Result<void> flush() { return out_.flush(); }
+        bool failed() const noexcept { return out_.failed(); }
+        u64 written() const noexcept { return out_.written(); }
+
+      private:
+        void finish_start() {
+            if (in_tag_) {
+                out_.put(">\n");
+                in_tag_ = false;
+            }
+        }
+
+        void begin_attr(std::string_view name) {
+            out_.put(' ');
+            out_.put(name);
+            out_.put("=\"");
+        }
+
+        void indent() {
+            for (u32 i = 0; i < depth_; ++i)
+                out_.put("  ");
+        }
+
+        void number(i64 value) {
+            char digits[20];
+            u8 n = 0;
+            u64 v = value < 0 ? static_cast<u64>(-(value + 1)) + 1 : static_cast<u64>(value);
+            do {
+                digits[n++] = static_cast<char>('0' + v % 10);
+                v /= 10;
+            } while (v != 0);
+            if (value < 0)
+                out_.put('-');
+            while (n > 0)
+                out_.put(digits[--n]);
+        }
+
+        void escape(std::string_view s) {
+            usize start = 0;
+            for (usize i = 0; i < s.size(); ++i) {
+                const char *entity = nullptr;
+                switch (s[i]) {
+                case '&':
+                    entity = "&amp;";
+                    break;
+                case '<':
+                    entity = "&lt;";
+                    break;
+                case '>':
+                    entity = "&gt;";
+                    break;
+                case '"':
+                    entity = "&quot;";
+                    break;
+                case '\'':
+                    entity = "&apos;";
+                    break;
+                default:
+                    continue;
+                }
+                out_.put(s.substr(start, i - start));
+                out_.put(std::string_view(entity));
+                start = i + 1;
+            }
+            out_.put(s.substr(start));
+        }
+    };
+
+    // ─── TimeLog (TLG) export ────────────────────────────────────────────────────
+    // ISO 11783-10 binary TimeLog: write_header() emits the TLGxxxxx.xml
+    // template (a TIM with a PTN and one DLV per logged value), then each
+    // write() appends one record to the .bin sink:
+    //   time of day (u32, ms) | date (u16, days since 1980-01-01)
+    //   | north, east (i32, 1e-7 deg) | position status (u8)
+    //   | DLV count (u8) | (DLV index (u8), value (i32)) × count
+    // Only values that changed since the last record need to be passed.
+    class TimeLogWriter {
+      public:
+        static constexpr usize MAX_VALUES = 255; // DLV index is one byte
+
+        struct Position {
+            i32 north = 0; // 1e-7 deg
+            i32 east = 0;  // 1e-7 deg
+            u8 status = 0; // PTN D: 0 no fix ... 5 RTK fixed
+        };
+
+        struct Sample {
+            u8 index = 0; // From add_value()
+            i32 value = 0;
+        };
+
+      private:
+        struct Column {
+            DDI ddi;
+            ObjectID element_id;
+        };
+
+        SinkBuffer bin_;
+        dp::Vector<Column> columns_;
+        u64 records_ = 0;
+
+      public:
+        explicit TimeLogWriter(IsoxmlSink bin_sink, usize capacity = 4096) : bin_(std::move(bin_sink), capacity) {}
+
+        // Declare a logged value (DDI on a device element); returns its DLV index
+        Result<u8> add_value(DDI ddi, ObjectID element_id) {
+            if (records_ > 0)
+                return Result<u8>::err(Error::invalid_state("TimeLog values must be declared before records"));
+            if (columns_.size() >= MAX_VALUES)
+                return Result<u8>::err(Error::invalid_state("TimeLog supports at most 255 values"));
+            columns_.push_back(Column{ddi, element_id});
+            return Result<u8>::ok(static_cast<u8>(columns_.size() - 1));
+        }
+
+        usize values() const noexcept { return columns_.size(); }
+        u64 records() const noexcept { return records_; }
+
+        // The header template that describes the binary records
+        void write_header(IsoxmlWriter &xml) const {
+            xml.open("TIM").attr("A", "").attr("D", static_cast<u8>(4));
+            xml.open("PTN").attr("A", "").attr("B", "").attr("D", "").close();
+            for (const auto &c : columns_)
+                xml.open("DLV").hex("A", c.ddi, 4).attr("B", "").ref("C", "DET", c.element_id).close();
+            xml.end("TIM");
+        }
+
+        Result<void> write(u32 time_ms, u16 date, const Position &pos, const Sample *samples, usize count) {
+            if (count > columns_.size())
+                return Result<void>::err(Error::invalid_state("more TimeLog samples than declared values"));
+            for (usize i = 0; i < count; ++i) {
+                if (samples[i].index >= columns_.size())
+                    return Result<void>::err(Error::invalid_state("TimeLog sample for an undeclared value"));
+            }
+            bin_.put_le<u32>(time_ms);
+            bin_.put_le<u16>(date);
+            bin_.put_le<u32>(static_cast<u32>(pos.north));
+            bin_.put_le<u32>(static_cast<u32>(pos.east));
+            bin_.put_le<u8>(pos.status);
+            bin_.put_le<u8>(static_cast<u8>(count));
+            for (usize i = 0; i < count; ++i) {
+                bin_.put_le<u8>(samples[i].index);
+                bin_.put_le<u32>(static_cast<u32>(samples[i].value));
+            }
+            ++records_;
+            if (bin_.failed())
+                return Result<void>::err(Error(ErrorCode::DriverError, "ISOXML sink write failed"));
+            return {};
+        }
+
+        Result<void> write(u32 time_ms, u16 date, const Position &pos, const dp::Vector<Sample> &samples) {
+            return write(time_ms, date, pos, samples.data(), samples.size());
+        }
+
+        Result<void> flush() { return bin_.flush(); }
+        bool failed() const noexcept { return bin_.failed(); }
+        u64 written() const noexcept { return bin_.written(); }
+    };
+
+} // namespace agrobus::isobus::tc
@@ -0,0 +1,566 @@
+#pragma once
+
+#include "objects.hpp"
+#include "prescription.hpp"
+#include "prescription_grid.hpp"
+#include <agrobus/net/error.hpp>
+#include <agrobus/net/types.hpp>
+#include <charconv>
+#include <concord/concord.hpp>
+#include <cstring>
+#include <datapod/datapod.hpp>
+#include <echo/echo.hpp>
+#include <fcntl.h>
+#include <memory>
+#include <string_view>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace agrobus::isobus::tc {
+    using namespace agrobus::net;
+
+    // ─── Attributes of one start tag ─────────────────────────────────────────────
+    // A view over the raw attribute text between the tag name and '>'; values
+    // come back as views into the document, entities left as written (ISOXML
+    // numbers and IDs never carry any). Nothing is copied or allocated.
+    class IsoxmlAttributes {
+        std::string_view raw_;
+
+      public:
+        IsoxmlAttributes() = default;
+        explicit IsoxmlAttributes(std::string_view raw) : raw_(raw) {}
+
+        // fn(name, value) for each attribute in document order
+        template <typename Fn> void for_each(Fn &&fn) const {
+            usize i = 0;
+            while (i < raw_.size()) {
+                while (i < raw_.size() && is_space(raw_[i]))
+                    ++i;
+                usize name_at = i;
+                while (i < raw_.size() && raw_[i] != '=' && !is_space(raw_[i]))
+                    ++i;
+                std::string_view name = raw_.substr(name_at, i - name_at);
+                while (i < raw_.size() && (raw_[i] == '=' || is_space(raw_[i])))
+                    ++i;
+                if (i >= raw_.size() || (raw_[i] != '"' && raw_[i] != '\''))
+                    return;
+                char quote = raw_[i++];
+                usize value_at = i;
+                while (i < raw_.size() && raw_[i] != quote)
+                    ++i;
+                fn(name, raw_.substr(value_at, i - value_at));
+                ++i;
+            }
+        }
+
+        // The raw value of `name`, empty when absent
+        std::string_view get(std::string_view name) const {
+            std::string_view found;
+            bool seen = false;
+            for_each([&](std::string_view n, std::string_view v) {
+                if (!seen && n == name) {
+                    found = v;
+                    seen = true;
+                }
+            });
+            return found;
+        }
+
+        std::string_view raw() const noexcept { return raw_; }
+
+        static bool is_space(char c) noexcept { return c == ' ' || c == '\t' || c == '\n' || c == '\r'; }
+    };
+
+    // ─── Attribute value helpers ─────────────────────────────────────────────────
+    namespace isoxml {
+        inline bool to_f64(std::string_view s, f64 &out) noexcept {
+            auto r = std::from_chars(s.data(), s.data() + s.size(), out);
+            return r.ec == std::errc{} && r.ptr == s.data() + s.size();
+        }
+
+        inline bool to_i64(std::string_view s, i64 &out, int base = 10) noexcept {
+            auto r = std::from_chars(s.data(), s.data() + s.size(), out, base);
+            return r.ec == std::errc{} && r.ptr == s.data() + s.size();
+        }
+
+        // Text with the five predefined entities decoded, for the few values
+        // that are kept (designators)
+        inline dp::String unescape(std::string_view s) {
+            dp::String out;
+            out.reserve(s.size());
+            for (usize i = 0; i < s.size(); ++i) {
+                if (s[i] != '&') {
+                    out += s[i];
+                    continue;
+                }
+                std::string_view rest = s.substr(i);
+                struct Entity {
+                    std::string_view name;
+                    char c;
+                };
+                static constexpr Entity ENTITIES[] = {
+                    {"&amp;", '&'}, {"&lt;", '<'}, {"&gt;", '>'}, {"&quot;", '"'}, {"&apos;", '\''}};
+                bool decoded = false;
+                for (const auto &e : ENTITIES) {
+                    if (rest.substr(0, e.name.size()) == e.name) {
+                        out += e.c;
+                        i += e.name.size() - 1;
+                        decoded = true;
+                        break;
+                    }
+                }
+                if (!decoded)
+                    out += '&';
+            }
+            return out;
+        }
+    } // namespace isoxml
+
+    // ─── Streaming ISOXML reader ─────────────────────────────────────────────────
+    // SAX-style pass over a whole document in memory (usually a mapping):
+    // the handler gets start(tag, attributes) and end(tag), an empty element
+    // giving both. No tree is built and tag names and attributes are views
+    // into the text, so a 100 MB TASKDATA.XML costs the handler's output and
+    // a stack of open tag names. Declarations, comments, CDATA and DOCTYPE
+    // are skipped; character data is ignored (ISOXML keeps it all in
+    // attributes).
+    //
+    //   struct Handler {
+    //       void start(std::string_view tag, const IsoxmlAttributes &attrs);
+    //       void end(std::string_view tag);
+    //   };
+    class IsoxmlReader {
+      public:
+        template <typename Handler> static Result<void> parse(std::string_view xml, Handler &handler) {
+            dp::Vector<std::string_view> open;
+            const char *base = xml.data();
+            usize n = xml.size();
+            usize i = 0;
+            while (i < n) {
+                const void *lt = std::memchr(base + i, '<', n - i);
+                if (!lt)
+                    break;
+                i = static_cast<usize>(static_cast<const char *>(lt) - base) + 1;
+                std::string_view rest = xml.substr(i);
+
+                if (rest.substr(0, 1) == "?" || rest.substr(0, 1) == "!") {
+                    std::string_view close = rest.substr(0, 3) == "!--"         ? "-->"
+                                             : rest.substr(0, 8) == "![CDATA[" ? "]]>"
+                                             : rest.substr(0, 1) == "?"        ? "?>"
+                                                                               : ">";
+                    usize end = rest.find(close);
+                    if (end == std::string_view::npos)
+                        return error("unterminated markup", i);
+                    i += end + close.size();
+                    continue;
+                }
+
+                usize gt = tag_end(xml, i);
+                if (gt == std::string_view::npos)
+                    return error("unterminated tag", i);
+
+                if (xml[i] == '/') {
+                    std::string_view name = trim(xml.substr(i + 1, gt - i - 1));
+                    if (open.empty() || open.back() != name)
+                        return error("mismatched end tag", i);
+                    open.pop_back();
+                    handler.end(name);
+                    i = gt + 1;
+                    continue;
+                }
+
+                bool empty = gt > i && xml[gt - 1] == '/';
+                usize stop = empty ? gt - 1 : gt;
+                usize name_end = i;
+                while (name_end < stop && !IsoxmlAttributes::is_space(xml[name_end]))
+                    ++name_end;
+                std::string_view name = xml.substr(i, name_end - i);
+                if (name.empty())
+                    return error("empty tag name", i);
+                handler.start(name, IsoxmlAttributes(xml.substr(name_end, stop - name_end)));
+                if (empty)
+                    handler.end(name);
+                else
+                    open.push_back(name);
+                i = gt + 1;
+            }
+            if (!open.empty())
+                return error("unclosed element", n);
+            return {};
+        }
+
+      private:
+        // The '>' ending the tag starting at `i`, skipping quoted values
+        static usize tag_end(std::string_view xml, usize i) noexcept {
+            char quote = 0;
+            for (; i < xml.size(); ++i) {
+                char c = xml[i];
+                if (quote) {
+                    if (c == quote)
+                        quote = 0;
+                } else if (c == '"' || c == '\'') {
+                    quote = c;
+                } else if (c == '>') {
+                    return i;
+                }
+            }
+            return std::string_view::npos;
+        }
+
+        static std::string_view trim(std::string_view s) noexcept {
+            while (!s.empty() && IsoxmlAttributes::is_space(s.back()))
+                s.remove_suffix(1);
+            return s;
+        }
+
+        static Result<void> error(const char *what, usize at) {
+            return Result<void>::err(
+                Error(ErrorCode::InvalidData, dp::String("ISOXML: ") + what + " at byte " + dp::to_string(at)));
+        }
+    };
+
+    // ─── Read-only file mapping ──────────────────────────────────────────────────
+    class MappedText {
+        void *addr_ = nullptr;
+        usize size_ = 0;
+
+        MappedText(void *a, usize s) : addr_(a), size_(s) {}
+
+      public:
+        MappedText() = default;
+        ~MappedText() {
+            if (addr_)
+                ::munmap(addr_, size_);
+        }
+        MappedText(MappedText &&o) noexcept : addr_(o.addr_), size_(o.size_) { o.addr_ = nullptr; }
+        MappedText &operator=(MappedText &&o) noexcept {
+            std::swap(addr_, o.addr_);
+            std::swap(size_, o.size_);
+            return *this;
+        }
+        MappedText(const MappedText &) = delete;
+        MappedText &operator=(const MappedText &) = delete;
+
+        // Pages are read ahead sequentially, the way the reader walks them
+        static Result<MappedText> open(const dp::String &path) {
+            int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+            if (fd < 0)
+                return Result<MappedText>::err(Error(ErrorCode::DriverError, "cannot open " + path));
+            struct stat st {};
+            if (::fstat(fd, &st) < 0 || st.st_size <= 0) {
+                ::close(fd);
+                return Result<MappedText>::err(Error(ErrorCode::DriverError, "empty file " + path));
+            }
+            usize size = static_cast<usize>(st.st_size);
+            void *m = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+            ::close(fd);
+            if (m == MAP_FAILED)
+                return Result<MappedText>::err(Error(ErrorCode::DriverError, "mmap failed: " + path));
+            ::madvise(m, size, MADV_SEQUENTIAL);
+            return Result<MappedText>::ok(MappedText(m, size));
+        }
+
+        std::string_view text() const noexcept { return {static_cast<const char *>(addr_), addr_ ? size_ : 0}; }
+    };
+
+    // ─── Prescriptions from TASKDATA ─────────────────────────────────────────────
+    struct TaskDataOptions {
+        dp::Optional<DDI> rate_ddi; // Rate from this DDI's PDV; the zone's first PDV when unset
+
+        TaskDataOptions &ddi(DDI d) {
+            rate_ddi = d;
+            return *this;
+        }
+    };
+
+    // Maps and the index over them, built off the network thread and handed
+    // over whole (TCGEOInterface::load_prescription_maps)
+    struct LoadedPrescriptions {
+        dp::Vector<PrescriptionMap> maps;
+        PrescriptionIndex index;
+        dp::Vector<GridMap> grids;
+    };
+
+    // A GRD element with what its cells need: the binary file's name (no
+    // directory or extension) and the treatment zones of its task
+    struct GridSource {
+        dp::String label; // Task designator
+        dp::String file;  // G
+        GridSpec spec;
+        dp::Vector<GridZone> zones;
+    };
+
+    // IsoxmlReader handler turning polygon treatment zones into prescription
+    // maps as the elements stream past: one map per task (TSK, labelled with
+    // its designator), one zone per exterior ring (LSG A="1") of each polygon
+    // (PLN) of a treatment zone (TZN), the zone's rate from its process data
+    // (PDV). Interior rings (holes) are not read; zones without a rate for
+    // the wanted DDI and tasks without zones are dropped. Grids (GRD) are
+    // collected with their task's treatment zones, every product kept, for
+    // the caller to map their binary files; so are external files (XFR), to
+    // be read with the same handler.
+    class PrescriptionReader {
+        TaskDataOptions options_;
+        dp::Vector<PrescriptionMap> maps_;
+        dp::Vector<dp::String> external_;
+        dp::Vector<GridSource> grids_;
+        dp::Vector<GridZone> task_zones_; // Process data of every TZN of the open task
+        usize grids_first_ = 0;           // First grid of the open task
+        bool in_task_ = false;
+        bool in_zone_ = false;
+        bool in_ring_ = false;
+        usize zone_first_ = 0; // First map zone of the open TZN
+        dp::Optional<i32> zone_rate_;
+        u64 vertices_ = 0;
+
+      public:
+        explicit PrescriptionReader(TaskDataOptions options = {}) : options_(options) {}
+
+        void start(std::string_view tag, const IsoxmlAttributes &attrs) {
+            if (tag == "PNT") {
+                if (in_ring_)
+                    point(attrs);
+            } else if (tag == "LSG") {
+                in_ring_ = in_zone_ && attrs.get("A") == "1";
+                if (in_ring_)
+                    maps_.back().zones.emplace_back();
+            } else if (tag == "PDV") {
+                if (in_zone_)
+                    process_data(attrs);
+            } else if (tag == "TZN") {
+                in_zone_ = in_task_;
+                zone_first_ = in_task_ ? maps_.back().zones.size() : 0;
+                zone_rate_.reset();
+                i64 code = 0;
+                if (in_task_ && isoxml::to_i64(attrs.get("A"), code))
+                    task_zones_.push_back(GridZone{static_cast<u8>(code), {}, {}});
+            } else if (tag == "GRD") {
+                if (in_task_)
+                    grid(attrs);
+            } else if (tag == "TSK") {
+                in_task_ = true;
+                task_zones_.clear();
+                grids_first_ = grids_.size();
+                PrescriptionMap map;
+                std::string_view label = attrs.get("B");
+                map.structure_label = isoxml::unescape(label.empty() ? attrs.get("A") : label);
+                maps_.push_back(std::move(map));
+            } else if (tag == "XFR") {
+                std::string_view file = attrs.get("A");
+                for (const auto &seen : external_) {
+                    if (std::string_view(seen.data(), seen.size()) == file)
+                        return;
+                }
+                if (!file.empty())
+                    external_.push_back(dp::String(file.data(), file.size()));
+            }
+        }
+
+        void end(std::string_view tag) {
+            if (tag == "LSG") {
+                if (in_ring_ && maps_.back().zones.back().boundary.size() < 3)
+                    maps_.back().zones.pop_back();
+                in_ring_ = false;
+            } else if (tag == "TZN") {
+                if (in_zone_)
+                    close_zone();
+                in_zone_ = false;
+            } else if (tag == "TSK") {
+                for (usize g = grids_first_; g < grids_.size(); ++g)
+                    grids_[g].zones = task_zones_;
+                if (maps_.back().zones.empty())
+                    maps_.pop_back();
+                in_task_ = false;
+            }
+        }
+
+        // Maps read so far; take() hands them over
+        const dp::Vector<PrescriptionMap> &maps() const noexcept { return maps_; }
+        dp::Vector<PrescriptionMap> take() { return std::move(maps_); }
+        // XFR file names (no directory or extension) met so far
+        const dp::Vector<dp::String> &external_files() const noexcept { return external_; }
+        // Grids of the tasks read so far
+        const dp::Vector<GridSource> &grids() const noexcept { return grids_; }
+        u64 vertices() const noexcept { return vertices_; }
+
+      private:
+        void point(const IsoxmlAttributes &attrs) {
+            f64 lat = 0.0, lon = 0.0;
+            bool has_lat = false, has_lon = false;
+            attrs.for_each([&](std::string_view name, std::string_view value) {
+                if (name == "C")
+                    has_lat = isoxml::to_f64(value, lat);
+                else if (name == "D")
+                    has_lon = isoxml::to_f64(value, lon);
+            });
+            if (has_lat && has_lon) {
+                maps_.back().zones.back().boundary.push_back(concord::earth::WGS(lat, lon));
+                ++vertices_;
+            }
+        }
+
+        void process_data(const IsoxmlAttributes &attrs) {
+            i64 ddi = 0, value = 0;
+            if (!isoxml::to_i64(attrs.get("A"), ddi, 16) || !isoxml::to_i64(attrs.get("B"), value))
+                return;
+            if (!task_zones_.empty()) {
+                task_zones_.back().ddis.push_back(static_cast<DDI>(ddi));
+                task_zones_.back().values.push_back(static_cast<i32>(value));
+            }
+            if (options_.rate_ddi ? static_cast<i64>(*options_.rate_ddi) == ddi : !zone_rate_)
+                zone_rate_ = static_cast<i32>(value);
+        }
+
+        void grid(const IsoxmlAttributes &attrs) {
+            GridSource src;
+            src.label = maps_.back().structure_label;
+            i64 columns = 0, rows = 0, type = 1, zone = 0;
+            attrs.for_each([&](std::string_view name, std::string_view value) {
+                if (name.size() != 1)
+                    return;
+                switch (name[0]) {
+                case 'A':
+                    isoxml::to_f64(value, src.spec.min_north);
+                    break;
+                case 'B':
+                    isoxml::to_f64(value, src.spec.min_east);
+                    break;
+                case 'C':
+                    isoxml::to_f64(value, src.spec.cell_north);
+                    break;
+                case 'D':
+                    isoxml::to_f64(value, src.spec.cell_east);
+                    break;
+                case 'E':
+                    isoxml::to_i64(value, columns);
+                    break;
+                case 'F':
+                    isoxml::to_i64(value, rows);
+                    break;
+                case 'G':
+                    src.file = dp::String(value.data(), value.size());
+                    break;
+                case 'I':
+                    isoxml::to_i64(value, type);
+                    break;
+                case 'J':
+                    isoxml::to_i64(value, zone);
+                    break;
+                default:
+                    break;
+                }
+            });
+            src.spec.columns = columns > 0 ? static_cast<u32>(columns) : 0;
+            src.spec.rows = rows > 0 ? static_cast<u32>(rows) : 0;
+            src.spec.type = static_cast<u8>(type);
+            src.spec.zone_code = static_cast<u8>(zone);
+            grids_.push_back(std::move(src));
+        }
+
+        void close_zone() {
+            auto &zones = maps_.back().zones;
+            if (!zone_rate_) {
+                zones.erase(zones.begin() + static_cast<isize>(zone_first_), zones.end());
+                return;
+            }
+            for (usize z = zone_first_; z < zones.size(); ++z)
+                zones[z].application_rate = *zone_rate_;
+        }
+    };
+
+    // Prescription maps in an ISOXML document held in memory; XFR references
+    // are not followed
+    inline Result<dp::Vector<PrescriptionMap>> read_prescriptions(std::string_view xml,
+                                                                  TaskDataOptions options = {}) {
+        PrescriptionReader reader(options);
+        auto r = IsoxmlReader::parse(xml, reader);
+        if (!r.is_ok())
+            return Result<dp::Vector<PrescriptionMap>>::err(r.error());
+        return Result<dp::Vector<PrescriptionMap>>::ok(reader.take());
+    }
+
+    namespace isoxml {
+        inline dp::String directory_of(const dp::String &path) {
+            usize size = path.size();
+            while (size > 0 && path[size - 1] != '/')
+                --size;
+            return dp::String(path.data(), size);
+        }
+
+        // A TASKDATA.XML through `reader`, then the files it references
+        // (XFR, "<name>.XML" beside it)
+        template <typename Handler> Result<void> read_taskdata(const dp::String &path, Handler &reader) {
+            auto file = MappedText::open(path);
+            if (!file.is_ok())
+                return Result<void>::err(file.error());
+            auto r = IsoxmlReader::parse(file.value().text(), reader);
+            dp::String dir = directory_of(path);
+            for (usize i = 0; r.is_ok() && i < reader.external_files().size(); ++i) {
+                auto ext = MappedText::open(dir + reader.external_files()[i] + ".XML");
+                if (!ext.is_ok())
+                    return Result<void>::err(ext.error());
+                r = IsoxmlReader::parse(ext.value().text(), reader);
+            }
+            return r;
+        }
+
+        // The cells of `src` mapped from "<file>.bin" (or ".BIN") in `dir`,
+        // rating the product of `rate_ddi` when set
+        inline Result<GridMap> map_grid(const dp::String &dir, const GridSource &src,
+                                        dp::Optional<DDI> rate_ddi = dp::nullopt) {
+            auto file = MappedText::open(dir + src.file + ".bin");
+            if (!file.is_ok())
+                file = MappedText::open(dir + src.file + ".BIN");
+            if (!file.is_ok())
+                return Result<GridMap>::err(file.error());
+            auto mapping = std::make_shared<MappedText>(std::move(file.value()));
+            std::string_view bytes = mapping->text();
+            auto grid = GridMap::view(mapping, reinterpret_cast<const u8 *>(bytes.data()), bytes.size(), src.spec,
+                                      src.zones);
+            if (grid.is_ok()) {
+                grid.value().set_label(src.label);
+                auto product = rate_ddi ? grid.value().product(*rate_ddi) : dp::Optional<u8>(0);
+                grid.value().set_rate_product(product ? *product : GridMap::NO_PRODUCT);
+            }
+            return grid;
+        }
+    } // namespace isoxml
+
+    // Prescription maps of a TASKDATA.XML read through a mapping, with the
+    // files it references read the same way
+    inline Result<dp::Vector<PrescriptionMap>> load_prescriptions(const dp::String &path,
+                                                                  TaskDataOptions options = {}) {
+        PrescriptionReader reader(options);
+        auto r = isoxml::read_taskdata(path, reader);
+        if (!r.is_ok())
+            return Result<dp::Vector<PrescriptionMap>>::err(r.error());
+        echo::category("isobus.tc.isoxml")
+            .info("TASKDATA read: ", path, " maps=", reader.maps().size(), " vertices=", reader.vertices());
+        return Result<dp::Vector<PrescriptionMap>>::ok(reader.take());
+    }
+
+    // load_prescriptions() with the index built and the grids' binary files
+    // mapped too, ready to be swapped in
+    inline Result<LoadedPrescriptions> load_prescription_index(const dp::String &path, TaskDataOptions options = {}) {
+        PrescriptionReader reader(options);
+        auto r = isoxml::read_taskdata(path, reader);
+        if (!r.is_ok())
+            return Result<LoadedPrescriptions>::err(r.error());
+        LoadedPrescriptions loaded;
+        dp::String dir = isoxml::directory_of(path);
+        for (const auto &src : reader.grids()) {
+            auto grid = isoxml::map_grid(dir, src, options.rate_ddi);
+            if (!grid.is_ok())
+                return Result<LoadedPrescriptions>::err(grid.error());
+            loaded.grids.push_back(std::move(grid.value()));
+        }
+        loaded.maps = reader.take();
+        loaded.index.build(loaded.maps);
+        echo::category("isobus.tc.isoxml")
+            .info("TASKDATA read: ", path, " maps=", loaded.maps.size(), " grids=", loaded.grids.size(),
+                  " vertices=", reader.vertices());
+        return Result<LoadedPrescriptions>::ok(std::move(loaded));
+    }
+
+} // namespace agrobus::isobus::tc
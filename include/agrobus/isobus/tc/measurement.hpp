@@ -0,0 +1,241 @@
+#pragma once
+
+#include "objects.hpp"
+#include "server_options.hpp"
+#include <agrobus/net/timer_wheel.hpp>
+#include <agrobus/net/types.hpp>
+#include <datapod/datapod.hpp>
+#include <echo/echo.hpp>
+
+namespace agrobus::isobus::tc {
+    using namespace agrobus::net;
+
+    // ─── Measurement commands (ISO 11783-10) ─────────────────────────────────────
+    // The TC asks a client to report a process data value by itself: every so
+    // many ms or mm travelled, on entering a threshold range, or on a change of
+    // at least a step. One Measurement per (element, DDI) holds every trigger
+    // the TC set on it, together with the last value the application gave.
+    struct Measurement {
+        ElementNumber element = 0;
+        DDI ddi = 0;
+        u32 time_interval_ms = 0;     // 0 = off
+        u32 distance_interval_mm = 0; // 0 = off
+        dp::Optional<i32> min_threshold;
+        dp::Optional<i32> max_threshold;
+        dp::Optional<i32> change_threshold;
+        dp::Optional<i32> value; // Latest from the application
+        dp::Optional<i32> sent;  // Last reported to the TC
+
+        bool has_triggers() const noexcept {
+            return time_interval_ms != 0 || distance_interval_mm != 0 || min_threshold || max_threshold ||
+                   change_threshold;
+        }
+
+        // Within the range the threshold commands set (true when there is none)
+        bool in_range(i32 v) const noexcept {
+            return (!min_threshold || v > *min_threshold) && (!max_threshold || v < *max_threshold);
+        }
+    };
+
+    // ─── Measurement trigger engine ──────────────────────────────────────────────
+    // Measurements are keyed by (element, DDI) into one dense array. Time
+    // triggers are periodic tag timers on a TimerWheel, so an update costs the
+    // ticks passed plus the timers that fired, not the number of measurements;
+    // distance triggers count down the odometer deltas given to set_distance().
+    // Threshold and change triggers are checked when the application sets a
+    // value. Whatever fired is marked pending once and reported by the next
+    // flush(), however often it fired in between.
+    class MeasurementEngine {
+        struct Entry {
+            Measurement m;
+            TimerId timer = INVALID_TIMER;
+            u32 distance_left_mm = 0;
+            bool pending = false;
+        };
+
+        dp::Map<u32, u32> slots_; // (element << 16 | DDI) -> index into entries_
+        dp::Vector<Entry> entries_;
+        TimerWheel timers_;        // Tag = index into entries_
+        dp::Vector<u32> distance_; // Entries with a distance trigger
+        dp::Vector<u32> pending_;
+        dp::Optional<u32> odometer_mm_;
+
+      public:
+        static constexpr u32 key(ElementNumber element, DDI ddi) noexcept {
+            return (static_cast<u32>(element) << 16) | ddi;
+        }
+
+        // Applies a measurement command from the TC; false for any other command
+        bool command(ProcessDataCommands cmd, ElementNumber element, DDI ddi, i32 value) {
+            Entry &e = entry(element, ddi);
+            u32 slot = static_cast<u32>(&e - entries_.data());
+            switch (cmd) {
+            case ProcessDataCommands::MeasurementTimeInterval:
+                e.m.time_interval_ms = value > 0 ? static_cast<u32>(value) : 0;
+                arm(e, slot);
+                break;
+            case ProcessDataCommands::MeasurementDistanceInterval: {
+                bool listed = e.m.distance_interval_mm != 0;
+                e.m.distance_interval_mm = value > 0 ? static_cast<u32>(value) : 0;
+                e.distance_left_mm = e.m.distance_interval_mm;
+                if (!listed && e.m.distance_interval_mm != 0)
+                    distance_.push_back(slot);
+                break;
+            }
+            case ProcessDataCommands::MeasurementMinimumWithinThreshold:
+                e.m.min_threshold = value;
+                break;
+            case ProcessDataCommands::MeasurementMaximumWithinThreshold:
+                e.m.max_threshold = value;
+                break;
+            case ProcessDataCommands::MeasurementChangeThreshold:
+                e.m.change_threshold = value;
+                break;
+            default:
+                return false;
+            }
+            echo::category("isobus.tc.measurement")
+                .debug("trigger ", static_cast<u8>(cmd), " elem=", element, " ddi=", ddi, " value=", value);
+            // A new threshold or step is measured against the current value right away
+            if (cmd != ProcessDataCommands::MeasurementTimeInterval &&
+                cmd != ProcessDataCommands::MeasurementDistanceInterval && e.m.value)
+                check(slot, *e.m.value, dp::nullopt);
+            return true;
+        }
+
+        // The application's current value; runs the threshold and change triggers
+        void set_value(ElementNumber element, DDI ddi, i32 value) {
+            auto it = slots_.find(key(element, ddi));
+            if (it == slots_.end())
+                return;
+            Entry &e = entries_[it->second];
+            dp::Optional<i32> before = e.m.value;
+            e.m.value = value;
+            if (!before || *before != value)
+                check(it->second, value, before);
+        }
+
+        // Advances the time triggers
+        void update(u32 elapsed_ms) {
+            timers_.advance(elapsed_ms, [this](TimerId, u32 slot) { mark(slot); });
+        }
+
+        // Total distance travelled (as in Wheel/Ground-based Speed and
+        // Distance), advancing the distance triggers by the change since the
+        // last call. The first call only sets the starting point.
+        void set_distance(u32 odometer_mm) {
+            if (!odometer_mm_) {
+                odometer_mm_ = odometer_mm;
+                return;
+            }
+            u32 moved = odometer_mm - *odometer_mm_; // Wraps with the odometer
+            odometer_mm_ = odometer_mm;
+            if (moved == 0)
+                return;
+            for (u32 slot : distance_) {
+                Entry &e = entries_[slot];
+                if (e.m.distance_interval_mm == 0)
+                    continue;
+                if (moved < e.distance_left_mm) {
+                    e.distance_left_mm -= moved;
+                    continue;
+                }
+                u32 over = (moved - e.distance_left_mm) % e.m.distance_interval_mm;
+                e.distance_left_mm = e.m.distance_interval_mm - over;
+                mark(slot);
+            }
+        }
+
+        // Hands each pending measurement to `send(const Measurement &)`, which
+        // returns the value it reported (nullopt if it had none to send)
+        template <typename Fn> usize flush(Fn &&send) {
+            usize sent = 0;
+            for (u32 slot : pending_) {
+                Entry &e = entries_[slot];
+                e.pending = false;
+                dp::Optional<i32> v = send(static_cast<const Measurement &>(e.m));
+                if (v) {
+                    e.m.sent = v;
+                    ++sent;
+                }
+            }
+            pending_.clear();
+            return sent;
+        }
+
+        const Measurement *find(ElementNumber element, DDI ddi) const noexcept {
+            auto it = slots_.find(key(element, ddi));
+            return it == slots_.end() ? nullptr : &entries_[it->second].m;
+        }
+
+        usize size() const noexcept { return entries_.size(); }
+        bool empty() const noexcept { return entries_.empty(); }
+        usize pending() const noexcept { return pending_.size(); }
+
+        // Drops every trigger (the TC sets them again after a reconnect)
+        void clear() {
+            slots_.clear();
+            entries_.clear();
+            timers_.clear();
+            distance_.clear();
+            pending_.clear();
+            odometer_mm_.reset();
+        }
+
+      private:
+        Entry &entry(ElementNumber element, DDI ddi) {
+            u32 k = key(element, ddi);
+            auto it = slots_.find(k);
+            if (it != slots_.end())
+                return entries_[it->second];
+            u32 slot = static_cast<u32>(entries_.size());
+            slots_[k] = slot;
+            entries_.push_back({});
+            entries_.back().m.element = element;
+            entries_.back().m.ddi = ddi;
+            return entries_.back();
+        }
+
+        // The first report is one interval after the command
+        void arm(Entry &e, u32 slot) {
+            u32 interval = e.m.time_interval_ms;
+            if (interval == 0) {
+                timers_.cancel(e.timer);
+                e.timer = INVALID_TIMER;
+                return;
+            }
+            u32 phase = static_cast<u32>(timers_.now_ms() % interval);
+            if (!timers_.set_period(e.timer, interval, phase))
+                e.timer = timers_.schedule_every_tag(interval, phase, slot);
+        }
+
+        // Threshold triggers fire on entering their range (from `before`), the
+        // change trigger on moving at least its step away from the value last
+        // reported. Outside the range nothing is reported.
+        void check(u32 slot, i32 value, dp::Optional<i32> before) {
+            const Measurement &m = entries_[slot].m;
+            bool ranged = m.min_threshold || m.max_threshold;
+            if (ranged && !m.in_range(value))
+                return;
+            if (ranged && (!before || !m.in_range(*before))) {
+                mark(slot);
+                return;
+            }
+            if (!m.change_threshold)
+                return;
+            i64 step = *m.change_threshold > 0 ? *m.change_threshold : 1;
+            i64 diff = m.sent ? static_cast<i64>(value) - static_cast<i64>(*m.sent) : step;
+            if (diff >= step || -diff >= step)
+                mark(slot);
+        }
+
+        void mark(u32 slot) {
+            Entry &e = entries_[slot];
+            if (e.pending)
+                return;
+            e.pending = true;
+            pending_.push_back(slot);
+        }
+    };
+
+} // namespace agrobus::isobus::tc
@@ -42,6 +42,43 @@ namespace agrobus::isobus::tc {
         Total = 0x10
     };
 
+    // Where an object sits in a pool: its type and index among objects of that type
+    struct ObjectRef {
+        TCObjectType type;
+        u32 index;
+    };
+
+    // ─── Serialization primitives ────────────────────────────────────────────────
+    // Objects are sized with serialized_size() and written with
+    // serialize_into(), which assumes the room is there and returns the end,
+    // so a whole pool goes into one buffer allocated once.
+    namespace detail {
+        inline u8 *put_u8(u8 *p, u8 v) noexcept {
+            *p = v;
+            return p + 1;
+        }
+        inline u8 *put_u16(u8 *p, u16 v) noexcept {
+            p[0] = static_cast<u8>(v & 0xFF);
+            p[1] = static_cast<u8>((v >> 8) & 0xFF);
+            return p + 2;
+        }
+        inline u8 *put_u32(u8 *p, u32 v) noexcept {
+            for (u8 i = 0; i < 4; ++i)
+                p[i] = static_cast<u8>((v >> (8 * i)) & 0xFF);
+            return p + 4;
+        }
+        // Length byte, then the characters
+        inline u8 *put_string(u8 *p, const dp::String &s) noexcept {
+            *p++ = static_cast<u8>(s.size());
+            if (!s.empty())
+                std::memcpy(p, s.data(), s.size());
+            return p + s.size();
+        }
+        inline u8 *put_header(u8 *p, TCObjectType type, ObjectID id) noexcept {
+            return put_u16(put_u8(p, static_cast<u8>(type)), id);
+        }
+    } // namespace detail
+
     // ─── Device object ───────────────────────────────────────────────────────────
     struct DeviceObject {
         ObjectID id = 0;
@@ -77,30 +114,24 @@ namespace agrobus::isobus::tc {
             return *this;
         }
 
+        // Header, three length-prefixed strings, two 7-byte labels
+        usize serialized_size() const noexcept {
+            return 3 + 3 + designator.size() + software_version.size() + serial_number.size() + 14;
+        }
+
+        u8 *serialize_into(u8 *p) const noexcept {
+            p = detail::put_header(p, TCObjectType::Device, id);
+            p = detail::put_string(p, designator);
+            p = detail::put_string(p, software_version);
+            p = detail::put_string(p, serial_number);
+            std::memcpy(p, structure_label.data(), 7);
+            std::memcpy(p + 7, localization_label.data(), 7);
+            return p + 14;
+        }
+
         dp::Vector<u8> serialize() const {
-            dp::Vector<u8> data;
-            data.push_back(static_cast<u8>(TCObjectType::Device));
-            // Object ID
-            data.push_back(static_cast<u8>(id & 0xFF));
-            data.push_back(static_cast<u8>((id >> 8) & 0xFF));
-            // Designator length + string
-            data.push_back(static_cast<u8>(designator.size()));
-            for (char c : designator)
-                data.push_back(static_cast<u8>(c));
-            // Software version
-            data.push_back(static_cast<u8>(software_version.size()));
-            for (char c : software_version)
-                data.push_back(static_cast<u8>(c));
-            // Serial number
-            data.push_back(static_cast<u8>(serial_number.size()));
-            for (char c : serial_number)
-                data.push_back(static_cast<u8>(c));
-            // Structure label
-            for (auto b : structure_label)
-                data.push_back(b);
-            // Localization label
-            for (auto b : localization_label)
-                data.push_back(b);
+            dp::Vector<u8> data(serialized_size());
+            serialize_into(data.data());
             return data;
         }
     };
@@ -144,27 +175,27 @@ namespace agrobus::isobus::tc {
             return *this;
         }
 
-        dp::Vector<u8> serialize() const {
-            dp::Vector<u8> data;
-            data.push_back(static_cast<u8>(TCObjectType::DeviceElement));
-            data.push_back(static_cast<u8>(id & 0xFF));
-            data.push_back(static_cast<u8>((id >> 8) & 0xFF));
-            data.push_back(static_cast<u8>(type));
-            data.push_back(static_cast<u8>(designator.size()));
-            for (char c : designator)
-                data.push_back(static_cast<u8>(c));
-            data.push_back(static_cast<u8>(number & 0xFF));
-            data.push_back(static_cast<u8>((number >> 8) & 0xFF));
-            data.push_back(static_cast<u8>(parent_id & 0xFF));
-            data.push_back(static_cast<u8>((parent_id >> 8) & 0xFF));
+        // Header, type, designator, number, parent, child count and IDs
+        usize serialized_size() const noexcept {
+            return 3 + 1 + 1 + designator.size() + 6 + 2 * child_objects.size();
+        }
+
+        u8 *serialize_into(u8 *p) const noexcept {
+            p = detail::put_header(p, TCObjectType::DeviceElement, id);
+            p = detail::put_u8(p, static_cast<u8>(type));
+            p = detail::put_string(p, designator);
+            p = detail::put_u16(p, number);
+            p = detail::put_u16(p, parent_id);
             // Number of child object references
-            u16 num_children = static_cast<u16>(child_objects.size());
-            data.push_back(static_cast<u8>(num_children & 0xFF));
-            data.push_back(static_cast<u8>((num_children >> 8) & 0xFF));
-            for (auto obj_id : child_objects) {
-                data.push_back(static_cast<u8>(obj_id & 0xFF));
-                data.push_back(static_cast<u8>((obj_id >> 8) & 0xFF));
-            }
+            p = detail::put_u16(p, static_cast<u16>(child_objects.size()));
+            for (auto obj_id : child_objects)
+                p = detail::put_u16(p, obj_id);
+            return p;
+        }
+
+        dp::Vector<u8> serialize() const {
+            dp::Vector<u8> data(serialized_size());
+            serialize_into(data.data());
             return data;
         }
     };
@@ -203,19 +234,19 @@ namespace agrobus::isobus::tc {
             return *this;
         }
 
+        usize serialized_size() const noexcept { return 3 + 5 + 1 + designator.size(); }
+
+        u8 *serialize_into(u8 *p) const noexcept {
+            p = detail::put_header(p, TCObjectType::DeviceProcessData, id);
+            p = detail::put_u16(p, ddi);
+            p = detail::put_u8(p, trigger_methods);
+            p = detail::put_u16(p, presentation_object_id);
+            return detail::put_string(p, designator);
+        }
+
         dp::Vector<u8> serialize() const {
-            dp::Vector<u8> data;
-            data.push_back(static_cast<u8>(TCObjectType::DeviceProcessData));
-            data.push_back(static_cast<u8>(id & 0xFF));
-            data.push_back(static_cast<u8>((id >> 8) & 0xFF));
-            data.push_back(static_cast<u8>(ddi & 0xFF));
-            data.push_back(static_cast<u8>((ddi >> 8) & 0xFF));
-            data.push_back(trigger_methods);
-            data.push_back(static_cast<u8>(presentation_object_id & 0xFF));
-            data.push_back(static_cast<u8>((presentation_object_id >> 8) & 0xFF));
-            data.push_back(static_cast<u8>(designator.size()));
-            for (char c : designator)
-                data.push_back(static_cast<u8>(c));
+            dp::Vector<u8> data(serialized_size());
+            serialize_into(data.data());
             return data;
         }
     };
@@ -250,22 +281,19 @@ namespace agrobus::isobus::tc {
             return *this;
         }
 
+        usize serialized_size() const noexcept { return 3 + 8 + 1 + designator.size(); }
+
+        u8 *serialize_into(u8 *p) const noexcept {
+            p = detail::put_header(p, TCObjectType::DeviceProperty, id);
+            p = detail::put_u16(p, ddi);
+            p = detail::put_u32(p, static_cast<u32>(value));
+            p = detail::put_u16(p, presentation_object_id);
+            return detail::put_string(p, designator);
+        }
+
         dp::Vector<u8> serialize() const {
-            dp::Vector<u8> data;
-            data.push_back(static_cast<u8>(TCObjectType::DeviceProperty));
-            data.push_back(static_cast<u8>(id & 0xFF));
-            data.push_back(static_cast<u8>((id >> 8) & 0xFF));
-            data.push_back(static_cast<u8>(ddi & 0xFF));
-            data.push_back(static_cast<u8>((ddi >> 8) & 0xFF));
-            data.push_back(static_cast<u8>(value & 0xFF));
-            data.push_back(static_cast<u8>((value >> 8) & 0xFF));
-            data.push_back(static_cast<u8>((value >> 16) & 0xFF));
-            data.push_back(static_cast<u8>((value >> 24) & 0xFF));
-            data.push_back(static_cast<u8>(presentation_object_id & 0xFF));
-            data.push_back(static_cast<u8>((presentation_object_id >> 8) & 0xFF));
-            data.push_back(static_cast<u8>(designator.size()));
-            for (char c : designator)
-                data.push_back(static_cast<u8>(c));
+            dp::Vector<u8> data(serialized_size());
+            serialize_into(data.data());
             return data;
         }
     };
@@ -300,26 +328,22 @@ namespace agrobus::isobus::tc {
             return *this;
         }
 
-        dp::Vector<u8> serialize() const {
-            dp::Vector<u8> data;
-            data.push_back(static_cast<u8>(TCObjectType::DeviceValuePresentation));
-            data.push_back(static_cast<u8>(id & 0xFF));
-            data.push_back(static_cast<u8>((id >> 8) & 0xFF));
-            data.push_back(static_cast<u8>(offset & 0xFF));
-            data.push_back(static_cast<u8>((offset >> 8) & 0xFF));
-            data.push_back(static_cast<u8>((offset >> 16) & 0xFF));
-            data.push_back(static_cast<u8>((offset >> 24) & 0xFF));
+        usize serialized_size() const noexcept { return 3 + 9 + 1 + unit_designator.size(); }
+
+        u8 *serialize_into(u8 *p) const noexcept {
+            p = detail::put_header(p, TCObjectType::DeviceValuePresentation, id);
+            p = detail::put_u32(p, static_cast<u32>(offset));
             // Scale as IEEE 754 float
             u32 scale_bits;
             std::memcpy(&scale_bits, &scale, sizeof(u32));
-            data.push_back(static_cast<u8>(scale_bits & 0xFF));
-            data.push_back(static_cast<u8>((scale_bits >> 8) & 0xFF));
-            data.push_back(static_cast<u8>((scale_bits >> 16) & 0xFF));
-            data.push_back(static_cast<u8>((scale_bits >> 24) & 0xFF));
-            data.push_back(decimal_digits);
-            data.push_back(static_cast<u8>(unit_designator.size()));
-            for (char c : unit_designator)
-                data.push_back(static_cast<u8>(c));
+            p = detail::put_u32(p, scale_bits);
+            p = detail::put_u8(p, decimal_digits);
+            return detail::put_string(p, unit_designator);
+        }
+
+        dp::Vector<u8> serialize() const {
+            dp::Vector<u8> data(serialized_size());
+            serialize_into(data.data());
             return data;
         }
     };
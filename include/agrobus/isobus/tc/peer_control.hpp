@@ -1,6 +1,7 @@
 #pragma once
 
 #include "objects.hpp"
+#include "server_options.hpp"
 #include <agrobus/net/constants.hpp>
 #include <agrobus/net/control_function.hpp>
 #include <agrobus/net/error.hpp>
@@ -48,13 +49,47 @@ namespace agrobus::isobus::tc {
         }
     };
 
+    // ─── Value forwarding ────────────────────────────────────────────────────────
+    // Once an assignment is active, source values go straight to the
+    // destination ECU as Value commands. A changed value is sent at once
+    // (no sooner than min_interval_ms after the last send); an unchanged one
+    // is repeated every repeat_ms so the destination sees the link is alive.
+    struct PeerForwardConfig {
+        u32 repeat_ms = 1000;    // 0: send on change only
+        u32 min_interval_ms = 0; // 0: every change goes out when it happens
+
+        PeerForwardConfig &repeat(u32 ms) {
+            repeat_ms = ms;
+            return *this;
+        }
+        PeerForwardConfig &min_interval(u32 ms) {
+            min_interval_ms = ms;
+            return *this;
+        }
+    };
+
     class PeerControlInterface {
+        // Forwarding state, one per assignment (same index)
+        struct Link {
+            i32 value = 0;
+            i32 sent = 0;
+            bool valid = false; // A source value was seen
+            bool dirty = false; // Differs from what the destination last got
+            u32 since_ms = 0;   // Since the last send
+        };
+
         IsoNet &net_;
         InternalCF *cf_;
+        PeerForwardConfig config_;
         dp::Vector<PeerControlAssignment> assignments_;
+        dp::Vector<Link> links_;
+        dp::Map<u32, u32> active_; // (source element << 16 | DDI) -> index of an active assignment
+        u64 forwarded_ = 0;
+        bool listening_ = false;
 
       public:
-        PeerControlInterface(IsoNet &net, InternalCF *cf) : net_(net), cf_(cf) {}
+        PeerControlInterface(IsoNet &net, InternalCF *cf, PeerForwardConfig config = {})
+            : net_(net), cf_(cf), config_(config) {}
 
         Result<void> initialize() {
             if (!cf_) {
@@ -73,6 +108,8 @@ namespace agrobus::isobus::tc {
                 }
             }
             assignments_.push_back(assignment);
+            links_.push_back({});
+            reindex();
             on_assignment_added.emit(assignments_.back());
             echo::category("isobus.tc.peer_control")
                 .debug("Assignment added: src_elem=", assignment.source_element,
@@ -81,10 +118,12 @@ namespace agrobus::isobus::tc {
         }
 
         Result<void> remove_assignment(ElementNumber source_element, DDI source_ddi) {
-            for (auto it = assignments_.begin(); it != assignments_.end(); ++it) {
-                if (it->source_element == source_element && it->source_ddi == source_ddi) {
-                    on_assignment_removed.emit(*it);
-                    assignments_.erase(it);
+            for (usize i = 0; i < assignments_.size(); ++i) {
+                if (assignments_[i].source_element == source_element && assignments_[i].source_ddi == source_ddi) {
+                    on_assignment_removed.emit(assignments_[i]);
+                    assignments_.erase(assignments_.begin() + i);
+                    links_.erase(links_.begin() + i);
+                    reindex();
                     return {};
                 }
             }
@@ -92,9 +131,12 @@ namespace agrobus::isobus::tc {
         }
 
         Result<void> activate_assignment(ElementNumber source_element, DDI source_ddi, bool active) {
-            for (auto &a : assignments_) {
+            for (usize i = 0; i < assignments_.size(); ++i) {
+                auto &a = assignments_[i];
                 if (a.source_element == source_element && a.source_ddi == source_ddi) {
                     a.active = active;
+                    links_[i] = {};
+                    reindex();
                     on_assignment_state_changed.emit(a);
                     return {};
                 }
@@ -102,7 +144,11 @@ namespace agrobus::isobus::tc {
             return Result<void>::err(Error::invalid_state("assignment not found"));
         }
 
-        void clear_assignments() { assignments_.clear(); }
+        void clear_assignments() {
+            assignments_.clear();
+            links_.clear();
+            active_.clear();
+        }
 
         const dp::Vector<PeerControlAssignment> &assignments() const noexcept { return assignments_; }
 
@@ -123,12 +169,121 @@ namespace agrobus::isobus::tc {
             return net_.send(PGN_ECU_TO_TC, data, cf_, tc_server, Priority::Default);
         }
 
+        // ─── Value forwarding ────────────────────────────────────────────────────
+        // A new value of a source process data variable, e.g. from the source
+        // ECU's own application. False when no active assignment takes it.
+        bool forward(ElementNumber source_element, DDI source_ddi, i32 value) {
+            auto it = active_.find(key(source_element, source_ddi));
+            if (it == active_.end())
+                return false;
+            accept(it->second, value);
+            return true;
+        }
+
+        // Forward the Value commands source ECUs report to the TC, so a node
+        // other than the source can carry the link with no application code.
+        // Only assignments whose source_address is set take bus values.
+        Result<void> listen() {
+            if (listening_)
+                return {};
+            auto result = net_.register_pgn_callback(PGN_ECU_TO_TC, [this](const Message &msg) { handle_value(msg); });
+            if (result.is_ok())
+                listening_ = true;
+            return result;
+        }
+
+        // Latest source value of an active assignment
+        dp::Optional<i32> forwarded_value(ElementNumber source_element, DDI source_ddi) const {
+            auto it = active_.find(key(source_element, source_ddi));
+            if (it == active_.end() || !links_[it->second].valid)
+                return dp::nullopt;
+            return links_[it->second].value;
+        }
+
+        usize active_count() const noexcept { return active_.size(); }
+        u64 forwarded() const noexcept { return forwarded_; } // Value commands sent
+
         // ─── Events ──────────────────────────────────────────────────────────────
         Event<const PeerControlAssignment &> on_assignment_added;
         Event<const PeerControlAssignment &> on_assignment_removed;
         Event<const PeerControlAssignment &> on_assignment_state_changed;
 
-        void update(u32 /*elapsed_ms*/) {}
+        // Sends changes held back by min_interval_ms and the periodic repeats
+        void update(u32 elapsed_ms) {
+            for (auto [k, index] : active_) {
+                (void)k;
+                Link &link = links_[index];
+                link.since_ms += elapsed_ms;
+                if (!link.valid)
+                    continue;
+                bool repeat = config_.repeat_ms != 0 && link.since_ms >= config_.repeat_ms;
+                if ((link.dirty && link.since_ms >= config_.min_interval_ms) || repeat)
+                    send_forward(index);
+            }
+        }
+
+      private:
+        static constexpr u32 key(ElementNumber element, DDI ddi) noexcept {
+            return (static_cast<u32>(element) << 16) | ddi;
+        }
+
+        // Active assignments change rarely; values arrive many times a second
+        void reindex() {
+            active_.clear();
+            for (usize i = 0; i < assignments_.size(); ++i) {
+                if (assignments_[i].active)
+                    active_[key(assignments_[i].source_element, assignments_[i].source_ddi)] = static_cast<u32>(i);
+            }
+        }
+
+        void accept(u32 index, i32 value) {
+            Link &link = links_[index];
+            bool first = !link.valid;
+            link.value = value;
+            link.valid = true;
+            link.dirty = first || value != link.sent;
+            if (link.dirty && (first || link.since_ms >= config_.min_interval_ms))
+                send_forward(index);
+        }
+
+        void send_forward(u32 index) {
+            const auto &a = assignments_[index];
+            Link &link = links_[index];
+            if (a.destination_address == NULL_ADDRESS)
+                return;
+            dp::Vector<u8> data(8, 0xFF);
+            data[0] = (static_cast<u8>(ProcessDataCommands::Value) & 0x0F) |
+                      ((static_cast<u8>(a.destination_element) & 0x0F) << 4);
+            data[1] = static_cast<u8>((a.destination_element >> 4) & 0xFF);
+            data[2] = static_cast<u8>(a.destination_ddi & 0xFF);
+            data[3] = static_cast<u8>((a.destination_ddi >> 8) & 0xFF);
+            data[4] = static_cast<u8>(link.value & 0xFF);
+            data[5] = static_cast<u8>((link.value >> 8) & 0xFF);
+            data[6] = static_cast<u8>((link.value >> 16) & 0xFF);
+            data[7] = static_cast<u8>((link.value >> 24) & 0xFF);
+            // The process data PGN the destination's TC client listens on
+            ControlFunction dest;
+            dest.address = a.destination_address;
+            if (!net_.send(PGN_TC_TO_ECU, data, cf_, &dest, Priority::Default).is_ok())
+                return; // Still dirty: retried on the next update
+            link.sent = link.value;
+            link.dirty = false;
+            link.since_ms = 0;
+            ++forwarded_;
+        }
+
+        void handle_value(const Message &msg) {
+            if (msg.data.size() < 8 || (msg.data[0] & 0x0F) != static_cast<u8>(ProcessDataCommands::Value))
+                return;
+            ElementNumber element = static_cast<u16>((msg.data[0] >> 4) & 0x0F) | (static_cast<u16>(msg.data[1]) << 4);
+            DDI ddi = static_cast<u16>(msg.data[2]) | (static_cast<u16>(msg.data[3]) << 8);
+            auto it = active_.find(key(element, ddi));
+            if (it == active_.end() || assignments_[it->second].source_address != msg.source)
+                return;
+            i32 value = static_cast<i32>(msg.data[4]) | (static_cast<i32>(msg.data[5]) << 8) |
+                        (static_cast<i32>(msg.data[6]) << 16) | (static_cast<i32>(msg.data[7]) << 24);
+            accept(it->second, value);
+        }
     };
 
 } // namespace agrobus::isobus::tc
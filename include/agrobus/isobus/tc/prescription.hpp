@@ -0,0 +1,422 @@
+#pragma once
+
+#include <agrobus/net/types.hpp>
+#include <bit>
+#include <cmath>
+#include <concord/concord.hpp>
+#include <datapod/datapod.hpp>
+
+#if !defined(AGROBUS_SIMD_DISABLED) && defined(__AVX2__)
+#include <immintrin.h>
+#define AGROBUS_PRESCRIPTION_AVX2 1
+#elif !defined(AGROBUS_SIMD_DISABLED) && defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define AGROBUS_PRESCRIPTION_NEON 1
+#endif
+
+namespace agrobus::isobus::tc {
+    using namespace agrobus::net;
+
+    // ─── Prescription maps ───────────────────────────────────────────────────────
+    struct PrescriptionZone {
+        dp::Vector<concord::earth::WGS> boundary; // Polygon vertices
+        i32 application_rate = 0;                 // Rate value (DDI-dependent units)
+    };
+
+    struct PrescriptionMap {
+        dp::String structure_label;
+        dp::Vector<PrescriptionZone> zones;
+    };
+
+    // Ray-casting point-in-polygon test on raw degrees (PrescriptionIndex tests
+    // in its local ENU frame instead)
+    inline bool point_in_polygon(const concord::earth::WGS &point, const dp::Vector<concord::earth::WGS> &polygon) {
+        if (polygon.size() < 3)
+            return false;
+
+        bool inside = false;
+        usize n = polygon.size();
+        for (usize i = 0, j = n - 1; i < n; j = i++) {
+            f64 xi = polygon[i].longitude, yi = polygon[i].latitude;
+            f64 xj = polygon[j].longitude, yj = polygon[j].latitude;
+
+            bool intersect = ((yi > point.latitude) != (yj > point.latitude)) &&
+                             (point.longitude < (xj - xi) * (point.latitude - yi) / (yj - yi) + xi);
+            if (intersect)
+                inside = !inside;
+        }
+        return inside;
+    }
+
+    // ─── Zone bounding box (degrees) ─────────────────────────────────────────────
+    struct ZoneBounds {
+        f64 min_lat = 0.0;
+        f64 min_lon = 0.0;
+        f64 max_lat = 0.0;
+        f64 max_lon = 0.0;
+
+        static ZoneBounds of(const dp::Vector<concord::earth::WGS> &polygon) noexcept {
+            ZoneBounds b;
+            if (polygon.empty())
+                return b;
+            b.min_lat = b.max_lat = polygon[0].latitude;
+            b.min_lon = b.max_lon = polygon[0].longitude;
+            for (const auto &p : polygon) {
+                b.min_lat = p.latitude < b.min_lat ? p.latitude : b.min_lat;
+                b.max_lat = p.latitude > b.max_lat ? p.latitude : b.max_lat;
+                b.min_lon = p.longitude < b.min_lon ? p.longitude : b.min_lon;
+                b.max_lon = p.longitude > b.max_lon ? p.longitude : b.max_lon;
+            }
+            return b;
+        }
+
+        bool contains(f64 lat, f64 lon) const noexcept {
+            return lat >= min_lat && lat <= max_lat && lon >= min_lon && lon <= max_lon;
+        }
+
+        bool intersects(const ZoneBounds &o) const noexcept {
+            return min_lat <= o.max_lat && o.min_lat <= max_lat && min_lon <= o.max_lon && o.min_lon <= max_lon;
+        }
+
+        void merge(const ZoneBounds &o) noexcept {
+            min_lat = o.min_lat < min_lat ? o.min_lat : min_lat;
+            min_lon = o.min_lon < min_lon ? o.min_lon : min_lon;
+            max_lat = o.max_lat > max_lat ? o.max_lat : max_lat;
+            max_lon = o.max_lon > max_lon ? o.max_lon : max_lon;
+        }
+    };
+
+    // ─── Local frame ─────────────────────────────────────────────────────────────
+    // East/north metres from an index's origin. Floats hold a few km of field
+    // to well under a millimetre.
+    struct LocalPoint {
+        f32 east = 0.0f;
+        f32 north = 0.0f;
+    };
+
+    struct LocalBox {
+        f32 min_east = 0.0f;
+        f32 min_north = 0.0f;
+        f32 max_east = 0.0f;
+        f32 max_north = 0.0f;
+
+        bool contains(LocalPoint p) const noexcept {
+            return p.east >= min_east && p.east <= max_east && p.north >= min_north && p.north <= max_north;
+        }
+
+        bool intersects(const LocalBox &o) const noexcept {
+            return min_east <= o.max_east && o.min_east <= max_east && min_north <= o.max_north &&
+                   o.min_north <= max_north;
+        }
+    };
+
+    // Crossing-number test over a closed ring of SoA vertices (count + 1
+    // entries, the last repeating the first). Edge k runs k -> k + 1, with no
+    // branch or division. Eight edges per step with AVX2 and four with NEON,
+    // unless the build sets AGROBUS_SIMD_DISABLED; the rest one at a time.
+    inline bool crossing_number(const f32 *xs, const f32 *ys, u32 count, LocalPoint p) noexcept {
+        u32 crossings = 0;
+        u32 k = 0;
+#if defined(AGROBUS_PRESCRIPTION_AVX2)
+        const __m256 pe = _mm256_set1_ps(p.east);
+        const __m256 pn = _mm256_set1_ps(p.north);
+        for (; k + 8 <= count; k += 8) {
+            __m256 xa = _mm256_loadu_ps(xs + k), ya = _mm256_loadu_ps(ys + k);
+            __m256 xb = _mm256_loadu_ps(xs + k + 1), yb = _mm256_loadu_ps(ys + k + 1);
+            __m256 straddles = _mm256_xor_ps(_mm256_cmp_ps(ya, pn, _CMP_GT_OQ), _mm256_cmp_ps(yb, pn, _CMP_GT_OQ));
+            __m256 lhs = _mm256_mul_ps(_mm256_sub_ps(pe, xa), _mm256_sub_ps(yb, ya));
+            __m256 rhs = _mm256_mul_ps(_mm256_sub_ps(pn, ya), _mm256_sub_ps(xb, xa));
+            // left = (lhs < rhs) == (yb > ya), so straddles & ~(less ^ rising)
+            __m256 flip = _mm256_xor_ps(_mm256_cmp_ps(lhs, rhs, _CMP_LT_OQ), _mm256_cmp_ps(yb, ya, _CMP_GT_OQ));
+            u32 mask = static_cast<u32>(_mm256_movemask_ps(_mm256_andnot_ps(flip, straddles)));
+            crossings += static_cast<u32>(std::popcount(mask));
+        }
+#elif defined(AGROBUS_PRESCRIPTION_NEON)
+        const float32x4_t pe = vdupq_n_f32(p.east);
+        const float32x4_t pn = vdupq_n_f32(p.north);
+        uint32x4_t hits = vdupq_n_u32(0);
+        for (; k + 4 <= count; k += 4) {
+            float32x4_t xa = vld1q_f32(xs + k), ya = vld1q_f32(ys + k);
+            float32x4_t xb = vld1q_f32(xs + k + 1), yb = vld1q_f32(ys + k + 1);
+            uint32x4_t straddles = veorq_u32(vcgtq_f32(ya, pn), vcgtq_f32(yb, pn));
+            float32x4_t lhs = vmulq_f32(vsubq_f32(pe, xa), vsubq_f32(yb, ya));
+            float32x4_t rhs = vmulq_f32(vsubq_f32(pn, ya), vsubq_f32(xb, xa));
+            uint32x4_t flip = veorq_u32(vcltq_f32(lhs, rhs), vcgtq_f32(yb, ya));
+            hits = vsubq_u32(hits, vbicq_u32(straddles, flip)); // All-ones lanes count as one
+        }
+        crossings += vaddvq_u32(hits);
+#endif
+        for (; k < count; ++k) {
+            f32 xa = xs[k], ya = ys[k];
+            f32 xb = xs[k + 1], yb = ys[k + 1];
+            bool straddles = (ya > p.north) != (yb > p.north);
+            // p is left of the edge at its height: (p.e - xa) / (p.n - ya) < (xb - xa) / (yb - ya)
+            bool left = ((p.east - xa) * (yb - ya) < (p.north - ya) * (xb - xa)) == (yb > ya);
+            crossings += static_cast<u32>(straddles & left);
+        }
+        return (crossings & 1) != 0;
+    }
+
+    // ─── Spatial index over prescription zones ───────────────────────────────────
+    // Zones are projected once, on build(), into a local ENU frame around the
+    // middle of the maps using the concord conversions, so distances are
+    // metres at any latitude. Vertices are kept as packed float east/north
+    // arrays for crossing_number().
+    //
+    // A uniform grid over the zones' boxes, sized to about one cell per zone,
+    // lists (CSR) the zones whose box touches each cell, in map then zone
+    // order. A lookup projects the position once, checks the boxes of its
+    // cell and runs the polygon test only on those that hold it; the first
+    // zone that contains it wins, as with a scan of the maps in order.
+    //
+    // A zone whose box meets no earlier zone's box is "exclusive": no earlier
+    // zone can win over it. The last zone matched is tried first, and if it is
+    // exclusive a hit there needs no other test, which is the common case for
+    // consecutive positions of a moving machine.
+    class PrescriptionIndex {
+      public:
+        static constexpr u32 NO_HINT = 0xFFFFFFFFu;
+
+      private:
+        static constexpr u32 MAX_CELLS_PER_AXIS = 1024;
+        static constexpr f64 BOUNDS_MARGIN_DEG = 1e-6; // Edges are straight in ENU, not in degrees
+
+        struct Zone {
+            u32 map;
+            u32 zone;
+            u32 first; // Into xs_/ys_
+            u32 count;
+            LocalBox box;
+            bool exclusive = false;
+        };
+
+        dp::Vector<Zone> zones_; // Priority order
+        dp::Vector<f32> xs_;     // East, one closed ring per zone
+        dp::Vector<f32> ys_;     // North
+        dp::Vector<u32> cell_start_;
+        dp::Vector<u32> cell_zones_;
+        dp::Geo origin_;
+        ZoneBounds bounds_; // Degrees, to skip positions off every map unprojected
+        LocalBox extent_;
+        u32 nx_ = 0;
+        u32 ny_ = 0;
+        f32 cell_east_ = 1.0f;
+        f32 cell_north_ = 1.0f;
+        mutable u32 last_ = NO_HINT;
+        mutable u64 polygon_tests_ = 0;
+
+      public:
+        void build(const dp::Vector<PrescriptionMap> &maps) {
+            clear();
+            bool first = true;
+            for (const auto &map : maps) {
+                for (const auto &zone : map.zones) {
+                    if (zone.boundary.size() < 3)
+                        continue;
+                    ZoneBounds box = ZoneBounds::of(zone.boundary);
+                    if (first)
+                        bounds_ = box;
+                    else
+                        bounds_.merge(box);
+                    first = false;
+                }
+            }
+            if (first)
+                return;
+            origin_ = dp::Geo{(bounds_.min_lat + bounds_.max_lat) / 2.0, (bounds_.min_lon + bounds_.max_lon) / 2.0,
+                              0.0};
+            bounds_.min_lat -= BOUNDS_MARGIN_DEG;
+            bounds_.min_lon -= BOUNDS_MARGIN_DEG;
+            bounds_.max_lat += BOUNDS_MARGIN_DEG;
+            bounds_.max_lon += BOUNDS_MARGIN_DEG;
+
+            for (u32 m = 0; m < maps.size(); ++m) {
+                for (u32 z = 0; z < maps[m].zones.size(); ++z) {
+                    const auto &boundary = maps[m].zones[z].boundary;
+                    if (boundary.size() < 3)
+                        continue;
+                    Zone entry{m, z, static_cast<u32>(xs_.size()), static_cast<u32>(boundary.size())};
+                    for (const auto &v : boundary) {
+                        LocalPoint p = to_local(v);
+                        xs_.push_back(p.east);
+                        ys_.push_back(p.north);
+                    }
+                    xs_.push_back(xs_[entry.first]);
+                    ys_.push_back(ys_[entry.first]);
+                    entry.box = local_box(entry.first, entry.count);
+                    if (zones_.empty())
+                        extent_ = entry.box;
+                    else
+                        merge(extent_, entry.box);
+                    zones_.push_back(entry);
+                }
+            }
+
+            // About one cell per zone, square-ish in metres
+            f32 width = extent_.max_east - extent_.min_east;
+            f32 height = extent_.max_north - extent_.min_north;
+            width = width > 1e-3f ? width : 1e-3f;
+            height = height > 1e-3f ? height : 1e-3f;
+            f64 n = static_cast<f64>(zones_.size());
+            nx_ = clamp_axis(std::sqrt(n * width / height));
+            ny_ = clamp_axis(n / nx_);
+            cell_east_ = width / static_cast<f32>(nx_);
+            cell_north_ = height / static_cast<f32>(ny_);
+
+            // Two passes: count, then fill
+            cell_start_.assign(static_cast<usize>(nx_) * ny_ + 1, 0);
+            for (const auto &z : zones_)
+                for_cells(z.box, [&](u32 cell) { ++cell_start_[cell + 1]; });
+            for (usize c = 1; c < cell_start_.size(); ++c)
+                cell_start_[c] += cell_start_[c - 1];
+            cell_zones_.assign(cell_start_.back(), 0);
+            dp::Vector<u32> fill(cell_start_.size() - 1, 0);
+            for (usize c = 0; c < fill.size(); ++c)
+                fill[c] = cell_start_[c];
+            for (u32 i = 0; i < zones_.size(); ++i)
+                for_cells(zones_[i].box, [&](u32 cell) { cell_zones_[fill[cell]++] = i; });
+
+            for (u32 i = 0; i < zones_.size(); ++i) {
+                bool exclusive = true;
+                for_cells(zones_[i].box, [&](u32 cell) {
+                    for (u32 k = cell_start_[cell]; k < cell_start_[cell + 1] && cell_zones_[k] < i; ++k) {
+                        if (zones_[cell_zones_[k]].box.intersects(zones_[i].box))
+                            exclusive = false;
+                    }
+                });
+                zones_[i].exclusive = exclusive;
+            }
+        }
+
+        // The index's ENU frame: origin and projection
+        const dp::Geo &origin() const noexcept { return origin_; }
+        LocalPoint to_local(const concord::earth::WGS &pos) const {
+            concord::frame::ENU enu = concord::frame::to_enu(origin_, pos);
+            return {static_cast<f32>(enu.east()), static_cast<f32>(enu.north())};
+        }
+
+        // The first zone of `maps` (the ones build() saw) containing `pos`
+        const PrescriptionZone *find(const dp::Vector<PrescriptionMap> &maps, const concord::earth::WGS &pos) const {
+            return find(maps, pos, last_);
+        }
+
+        // Same, with the caller keeping the last zone matched in `hint`
+        // (start it at NO_HINT); used to give each of several positions its
+        // own cache, as the sections of a boom each stay in their own zone
+        const PrescriptionZone *find(const dp::Vector<PrescriptionMap> &maps, const concord::earth::WGS &pos,
+                                     u32 &hint) const {
+            if (zones_.empty() || !bounds_.contains(pos.latitude, pos.longitude))
+                return nullptr;
+            return find(maps, to_local(pos), hint);
+        }
+
+        // Same, for a position already in the index's frame
+        const PrescriptionZone *find(const dp::Vector<PrescriptionMap> &maps, LocalPoint pos, u32 &hint) const {
+            if (zones_.empty() || !extent_.contains(pos))
+                return nullptr;
+            if (hint < zones_.size() && zones_[hint].exclusive && test(hint, pos))
+                return &zone_of(maps, hint);
+
+            u32 cell = cell_of(pos);
+            for (u32 k = cell_start_[cell]; k < cell_start_[cell + 1]; ++k) {
+                u32 i = cell_zones_[k];
+                if (test(i, pos)) {
+                    hint = i;
+                    return &zone_of(maps, i);
+                }
+            }
+            return nullptr;
+        }
+
+        // Rates at many positions in one call, one hint per position. Sized
+        // once, `hints` and `rates` are reused with no further allocation.
+        template <typename Point>
+        void rates_at(const dp::Vector<PrescriptionMap> &maps, const dp::Vector<Point> &positions,
+                      dp::Vector<u32> &hints, dp::Vector<dp::Optional<i32>> &rates) const {
+            if (hints.size() != positions.size())
+                hints.assign(positions.size(), NO_HINT);
+            if (rates.size() != positions.size())
+                rates.assign(positions.size(), dp::nullopt);
+            for (usize i = 0; i < positions.size(); ++i) {
+                const PrescriptionZone *zone = find(maps, positions[i], hints[i]);
+                rates[i] = zone ? dp::Optional<i32>(zone->application_rate) : dp::nullopt;
+            }
+        }
+
+        usize size() const noexcept { return zones_.size(); }
+        bool empty() const noexcept { return zones_.empty(); }
+        u32 columns() const noexcept { return nx_; }
+        u32 rows() const noexcept { return ny_; }
+        usize cell_entries() const noexcept { return cell_zones_.size(); }
+        usize vertices() const noexcept { return xs_.size(); }
+        u64 polygon_tests() const noexcept { return polygon_tests_; }
+
+        void clear() {
+            zones_.clear();
+            xs_.clear();
+            ys_.clear();
+            cell_start_.clear();
+            cell_zones_.clear();
+            origin_ = {};
+            bounds_ = {};
+            extent_ = {};
+            nx_ = ny_ = 0;
+            last_ = NO_HINT;
+        }
+
+      private:
+        static u32 clamp_axis(f64 cells) noexcept {
+            if (cells < 1.0)
+                return 1;
+            if (cells > MAX_CELLS_PER_AXIS)
+                return MAX_CELLS_PER_AXIS;
+            return static_cast<u32>(std::ceil(cells));
+        }
+
+        static void merge(LocalBox &a, const LocalBox &b) noexcept {
+            a.min_east = b.min_east < a.min_east ? b.min_east : a.min_east;
+            a.min_north = b.min_north < a.min_north ? b.min_north : a.min_north;
+            a.max_east = b.max_east > a.max_east ? b.max_east : a.max_east;
+            a.max_north = b.max_north > a.max_north ? b.max_north : a.max_north;
+        }
+
+        LocalBox local_box(u32 first, u32 count) const noexcept {
+            LocalBox b{xs_[first], ys_[first], xs_[first], ys_[first]};
+            for (u32 k = first; k < first + count; ++k)
+                merge(b, LocalBox{xs_[k], ys_[k], xs_[k], ys_[k]});
+            return b;
+        }
+
+        u32 column(f32 east) const noexcept {
+            f32 c = (east - extent_.min_east) / cell_east_;
+            return c <= 0.0f ? 0 : (c >= static_cast<f32>(nx_) ? nx_ - 1 : static_cast<u32>(c));
+        }
+        u32 row(f32 north) const noexcept {
+            f32 r = (north - extent_.min_north) / cell_north_;
+            return r <= 0.0f ? 0 : (r >= static_cast<f32>(ny_) ? ny_ - 1 : static_cast<u32>(r));
+        }
+        u32 cell_of(LocalPoint p) const noexcept { return row(p.north) * nx_ + column(p.east); }
+
+        template <typename Fn> void for_cells(const LocalBox &box, Fn &&fn) const {
+            u32 c0 = column(box.min_east), c1 = column(box.max_east);
+            u32 r0 = row(box.min_north), r1 = row(box.max_north);
+            for (u32 r = r0; r <= r1; ++r) {
+                for (u32 c = c0; c <= c1; ++c)
+                    fn(r * nx_ + c);
+            }
+        }
+
+        const PrescriptionZone &zone_of(const dp::Vector<PrescriptionMap> &maps, u32 i) const noexcept {
+            return maps[zones_[i].map].zones[zones_[i].zone];
+        }
+
+        bool test(u32 i, LocalPoint pos) const noexcept {
+            const Zone &z = zones_[i];
+            if (!z.box.contains(pos))
+                return false;
+            ++polygon_tests_;
+            return crossing_number(&xs_[z.first], &ys_[z.first], z.count, pos);
+        }
+    };
+
+} // namespace agrobus::isobus::tc
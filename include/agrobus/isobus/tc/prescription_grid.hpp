@@ -0,0 +1,237 @@
+#pragma once
+
+#include "objects.hpp"
+#include "prescription.hpp"
+#include <agrobus/net/error.hpp>
+#include <agrobus/net/types.hpp>
+#include <cmath>
+#include <concord/concord.hpp>
+#include <datapod/datapod.hpp>
+#include <memory>
+
+namespace agrobus::isobus::tc {
+    using namespace agrobus::net;
+
+    // ─── ISOXML grid (GRD) ───────────────────────────────────────────────────────
+    // The attributes of a GRD element. Cells are stored row by row from the
+    // south-west corner, west to east; a type 1 cell is one byte, the code of
+    // a treatment zone (TZN), a type 2 cell is one i32 LE per process data
+    // value of treatment zone `zone_code`.
+    struct GridSpec {
+        f64 min_north = 0.0;  // A, degrees
+        f64 min_east = 0.0;   // B, degrees
+        f64 cell_north = 0.0; // C, degrees
+        f64 cell_east = 0.0;  // D, degrees
+        u32 columns = 0;      // E
+        u32 rows = 0;         // F
+        u8 type = 1;          // I
+        u8 zone_code = 0;     // J, type 2 only
+    };
+
+    // A treatment zone's process data: the products of a type 2 grid, the
+    // rates of a type 1 cell holding its code
+    struct GridZone {
+        u8 code = 0;
+        dp::Vector<DDI> ddis;
+        dp::Vector<i32> values;
+    };
+
+    // ─── Grid prescription map ───────────────────────────────────────────────────
+    // Rates straight from the grid's cells, no polygons: a position becomes a
+    // cell with two subtractions and two divisions, and the cell's rates are
+    // read where the grid bytes lie (a mapped .bin), so a lookup costs the
+    // same on any size of map. Every product (DDI) of the grid has its rate
+    // per cell; type 1 grids go through a 256-entry table of zone rates.
+    //
+    // Positions in degrees give the cell exactly as ISOXML defines it. For
+    // points already in metres (boom sections projected ahead), to_local()
+    // puts the antenna in the grid's ENU frame, with its origin at the
+    // south-west corner, and the cell follows from the east/north offsets.
+    class GridMap {
+        std::shared_ptr<const void> owner_;
+        const u8 *cells_ = nullptr;
+        GridSpec spec_;
+        usize cell_bytes_ = 1;
+        dp::Vector<DDI> ddis_;
+        dp::Vector<i32> zone_rates_; // Type 1: [code * products + product]
+        dp::Vector<u8> zone_has_;    // Type 1: the zone has a rate for the product
+        dp::Geo origin_;
+        f64 cell_east_m_ = 1.0;
+        f64 cell_north_m_ = 1.0;
+        dp::String label_;
+        u8 rate_product_ = 0;
+
+      public:
+        static constexpr u8 NO_PRODUCT = 0xFF;
+
+        GridMap() = default;
+
+        // Cells in [data, data + size), kept alive by `owner`; `zones` are the
+        // task's treatment zones
+        static Result<GridMap> view(std::shared_ptr<const void> owner, const u8 *data, usize size,
+                                    const GridSpec &spec, const dp::Vector<GridZone> &zones) {
+            if (spec.columns == 0 || spec.rows == 0 || !(spec.cell_north > 0.0) || !(spec.cell_east > 0.0))
+                return Result<GridMap>::err(Error(ErrorCode::InvalidData, "grid without cells"));
+            if (spec.type != 1 && spec.type != 2)
+                return Result<GridMap>::err(Error(ErrorCode::InvalidData, "unknown grid type"));
+
+            GridMap grid;
+            grid.owner_ = std::move(owner);
+            grid.cells_ = data;
+            grid.spec_ = spec;
+            if (spec.type == 2) {
+                const GridZone *zone = nullptr;
+                for (const auto &z : zones) {
+                    if (z.code == spec.zone_code)
+                        zone = &z;
+                }
+                if (!zone || zone->ddis.empty())
+                    return Result<GridMap>::err(Error(ErrorCode::InvalidData, "grid type 2 without its zone"));
+                grid.ddis_ = zone->ddis;
+                grid.cell_bytes_ = 4 * zone->ddis.size();
+            } else {
+                grid.zone_table(zones);
+            }
+            if (size / grid.cell_bytes_ / spec.columns < spec.rows)
+                return Result<GridMap>::err(Error(ErrorCode::InvalidData, "grid file shorter than its cells"));
+
+            grid.origin_ = dp::Geo{spec.min_north, spec.min_east, 0.0};
+            concord::earth::WGS east_corner(spec.min_north, spec.min_east + spec.cell_east);
+            concord::earth::WGS north_corner(spec.min_north + spec.cell_north, spec.min_east);
+            grid.cell_east_m_ = grid.to_local(east_corner).east;
+            grid.cell_north_m_ = grid.to_local(north_corner).north;
+            return Result<GridMap>::ok(std::move(grid));
+        }
+
+        // Same over bytes in memory, taken over without a copy
+        static Result<GridMap> from_bytes(dp::Vector<u8> &&bytes, const GridSpec &spec,
+                                          const dp::Vector<GridZone> &zones) {
+            auto owned = std::make_shared<const dp::Vector<u8>>(std::move(bytes));
+            const u8 *data = owned->data();
+            usize size = owned->size();
+            return view(std::shared_ptr<const void>(owned, data), data, size, spec, zones);
+        }
+
+        // Designator of the task holding the grid
+        const dp::String &label() const noexcept { return label_; }
+        GridMap &set_label(dp::String l) {
+            label_ = std::move(l);
+            return *this;
+        }
+
+        const GridSpec &spec() const noexcept { return spec_; }
+        usize cells() const noexcept { return static_cast<usize>(spec_.columns) * spec_.rows; }
+
+        // ─── Products ────────────────────────────────────────────────────────────
+        u8 products() const noexcept { return static_cast<u8>(ddis_.size()); }
+        const dp::Vector<DDI> &ddis() const noexcept { return ddis_; }
+        dp::Optional<u8> product(DDI ddi) const noexcept {
+            for (usize p = 0; p < ddis_.size(); ++p) {
+                if (ddis_[p] == ddi)
+                    return static_cast<u8>(p);
+            }
+            return dp::nullopt;
+        }
+
+        // The product rate() gives when none is named; NO_PRODUCT for none
+        u8 rate_product() const noexcept { return rate_product_; }
+        GridMap &set_rate_product(u8 product) noexcept {
+            rate_product_ = product;
+            return *this;
+        }
+
+        // ─── Cells ───────────────────────────────────────────────────────────────
+        // Row-major cell index, nullopt off the grid
+        dp::Optional<u32> cell(const concord::earth::WGS &pos) const noexcept {
+            return cell_at((pos.longitude - spec_.min_east) / spec_.cell_east,
+                           (pos.latitude - spec_.min_north) / spec_.cell_north);
+        }
+
+        dp::Optional<u32> cell(LocalPoint p) const noexcept {
+            return cell_at(p.east / cell_east_m_, p.north / cell_north_m_);
+        }
+
+        // A position in the grid's ENU frame (origin at the south-west corner)
+        LocalPoint to_local(const concord::earth::WGS &pos) const {
+            concord::frame::ENU enu = concord::frame::to_enu(origin_, pos);
+            return {static_cast<f32>(enu.east()), static_cast<f32>(enu.north())};
+        }
+
+        // ─── Rates ───────────────────────────────────────────────────────────────
+        dp::Optional<i32> rate(u32 cell) const noexcept { return rate(cell, rate_product_); }
+        dp::Optional<i32> rate(u32 cell, u8 product) const noexcept {
+            if (cell >= cells() || product >= ddis_.size())
+                return dp::nullopt;
+            if (spec_.type == 2)
+                return read_i32(cells_ + static_cast<usize>(cell) * cell_bytes_ + product * 4u);
+            usize at = static_cast<usize>(cells_[cell]) * ddis_.size() + product;
+            return zone_has_[at] ? dp::Optional<i32>(zone_rates_[at]) : dp::nullopt;
+        }
+
+        dp::Optional<i32> rate(const concord::earth::WGS &pos) const noexcept { return rate(pos, rate_product_); }
+        dp::Optional<i32> rate(const concord::earth::WGS &pos, u8 product) const noexcept {
+            auto c = cell(pos);
+            return c ? rate(*c, product) : dp::nullopt;
+        }
+
+        dp::Optional<i32> rate(LocalPoint p) const noexcept { return rate(p, rate_product_); }
+        dp::Optional<i32> rate(LocalPoint p, u8 product) const noexcept {
+            auto c = cell(p);
+            return c ? rate(*c, product) : dp::nullopt;
+        }
+
+        // Every product's rate of one cell into `out` (products() entries);
+        // false, `out` untouched, off the grid or for a cell without rates
+        bool rates(u32 cell, i32 *out) const noexcept {
+            if (cell >= cells() || ddis_.empty())
+                return false;
+            if (spec_.type == 2) {
+                const u8 *at = cells_ + static_cast<usize>(cell) * cell_bytes_;
+                for (usize p = 0; p < ddis_.size(); ++p)
+                    out[p] = read_i32(at + p * 4);
+                return true;
+            }
+            usize at = static_cast<usize>(cells_[cell]) * ddis_.size();
+            bool any = false;
+            for (usize p = 0; p < ddis_.size(); ++p) {
+                if (zone_has_[at + p]) {
+                    out[p] = zone_rates_[at + p];
+                    any = true;
+                }
+            }
+            return any;
+        }
+
+      private:
+        dp::Optional<u32> cell_at(f64 column, f64 row) const noexcept {
+            if (!(column >= 0.0) || !(row >= 0.0) || column >= spec_.columns || row >= spec_.rows)
+                return dp::nullopt;
+            return static_cast<u32>(row) * spec_.columns + static_cast<u32>(column);
+        }
+
+        static i32 read_i32(const u8 *p) noexcept {
+            return static_cast<i32>(static_cast<u32>(p[0]) | (static_cast<u32>(p[1]) << 8) |
+                                    (static_cast<u32>(p[2]) << 16) | (static_cast<u32>(p[3]) << 24));
+        }
+
+        // Products are the DDIs of all zones, in the order first met
+        void zone_table(const dp::Vector<GridZone> &zones) {
+            for (const auto &z : zones) {
+                for (DDI d : z.ddis) {
+                    if (!product(d))
+                        ddis_.push_back(d);
+                }
+            }
+            zone_rates_.assign(256 * ddis_.size(), 0);
+            zone_has_.assign(256 * ddis_.size(), 0);
+            for (const auto &z : zones) {
+                for (usize k = 0; k < z.ddis.size() && k < z.values.size(); ++k) {
+                    usize at = static_cast<usize>(z.code) * ddis_.size() + *product(z.ddis[k]);
+                    zone_rates_[at] = z.values[k];
+                    zone_has_[at] = 1;
+                }
+            }
+        }
+    };
+
+} // namespace agrobus::isobus::tc
@@ -0,0 +1,324 @@
+#pragma once
+
+#include "objects.hpp"
+#include <agrobus/net/types.hpp>
+#include <bit>
+#include <datapod/datapod.hpp>
+
+#if !defined(AGROBUS_SIMD_DISABLED) && defined(__AVX2__)
+#include <immintrin.h>
+#define AGROBUS_SECTION_AVX2 1
+#elif !defined(AGROBUS_SIMD_DISABLED) && defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define AGROBUS_SECTION_NEON 1
+#endif
+
+namespace agrobus::isobus::tc {
+    using namespace agrobus::net;
+
+    // ─── Condensed work state (ISO 11783-10, DDIs 161-176 and 290-305) ───────────
+    // One DDI value carries 16 sections, 2 bits each, section 1 in the lowest
+    // bits: 0 = off, 1 = on, 2 = error, 3 = not installed.
+    namespace condensed {
+        inline constexpr u16 MAX_SECTIONS = 256;
+        inline constexpr u16 BLOCK_SECTIONS = 16;
+        inline constexpr u16 BLOCKS = MAX_SECTIONS / BLOCK_SECTIONS;
+        inline constexpr DDI ACTUAL_FIRST = 161;   // Actual Condensed Work State 1-16
+        inline constexpr DDI SETPOINT_FIRST = 290; // Setpoint Condensed Work State 1-16
+
+        inline constexpr u8 OFF = 0;
+        inline constexpr u8 ON = 1;
+        inline constexpr u8 IN_ERROR = 2;
+        inline constexpr u8 NOT_INSTALLED = 3;
+
+        constexpr DDI actual_ddi(u16 block) noexcept { return static_cast<DDI>(ACTUAL_FIRST + block); }
+        constexpr DDI setpoint_ddi(u16 block) noexcept { return static_cast<DDI>(SETPOINT_FIRST + block); }
+
+        // Block of a condensed DDI, or -1 if it is none
+        constexpr i32 actual_block(DDI ddi) noexcept {
+            return ddi >= ACTUAL_FIRST && ddi < ACTUAL_FIRST + BLOCKS ? ddi - ACTUAL_FIRST : -1;
+        }
+        constexpr i32 setpoint_block(DDI ddi) noexcept {
+            return ddi >= SETPOINT_FIRST && ddi < SETPOINT_FIRST + BLOCKS ? ddi - SETPOINT_FIRST : -1;
+        }
+
+        // Spreads 16 on/off bits to 2 bits each (bit i -> bit 2i)
+        constexpr u32 spread(u16 bits) noexcept {
+            u32 x = bits;
+            x = (x | (x << 8)) & 0x00FF00FFu;
+            x = (x | (x << 4)) & 0x0F0F0F0Fu;
+            x = (x | (x << 2)) & 0x33333333u;
+            x = (x | (x << 1)) & 0x55555555u;
+            return x;
+        }
+
+        // The low bit of each 2-bit field, packed back to 16 bits
+        constexpr u16 gather(u32 x) noexcept {
+            x &= 0x55555555u;
+            x = (x | (x >> 1)) & 0x33333333u;
+            x = (x | (x >> 2)) & 0x0F0F0F0Fu;
+            x = (x | (x >> 4)) & 0x00FF00FFu;
+            x = (x | (x >> 8)) & 0x0000FFFFu;
+            return static_cast<u16>(x);
+        }
+    } // namespace condensed
+
+    // ─── 256 section states, packed ──────────────────────────────────────────────
+    // Four words, one bit per section; every operation is a straight loop over
+    // the words, which the compiler unrolls and vectorizes (with the -mavx2 of
+    // AGROBUS_ENABLE_SIMD a 256-bit op is one instruction, so these need no
+    // intrinsics). Only at_least() has explicit AVX2/NEON code.
+    class SectionBits {
+      public:
+        static constexpr u16 WORDS = condensed::MAX_SECTIONS / 64;
+
+      private:
+        dp::Array<u64, WORDS> w_{};
+
+      public:
+        constexpr SectionBits() noexcept = default;
+
+        // The first `count` sections set
+        static constexpr SectionBits first(u16 count) noexcept {
+            SectionBits b;
+            for (u16 i = 0; i < WORDS; ++i) {
+                u32 lo = i * 64u;
+                if (count >= lo + 64)
+                    b.w_[i] = ~u64{0};
+                else if (count > lo)
+                    b.w_[i] = (u64{1} << (count - lo)) - 1;
+            }
+            return b;
+        }
+
+        // Sections whose level reaches `threshold` (e.g. overlap in percent).
+        // 32 levels per compare with AVX2 and 16 with NEON, unless the build
+        // sets AGROBUS_SIMD_DISABLED; the rest one at a time.
+        static SectionBits at_least(const u8 *levels, u16 count, u8 threshold) noexcept {
+            SectionBits b;
+            if (count > condensed::MAX_SECTIONS)
+                count = condensed::MAX_SECTIONS;
+            u16 i = 0;
+#if defined(AGROBUS_SECTION_AVX2)
+            const __m256i t = _mm256_set1_epi8(static_cast<char>(threshold));
+            for (; i + 32 <= count; i += 32) {
+                __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(levels + i));
+                // Unsigned v >= t exactly where max(v, t) == v
+                u32 mask = static_cast<u32>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_max_epu8(v, t), v)));
+                b.w_[i / 64] |= static_cast<u64>(mask) << (i % 64);
+            }
+#elif defined(AGROBUS_SECTION_NEON)
+            const uint8x16_t t = vdupq_n_u8(threshold);
+            const uint8x16_t weight = vreinterpretq_u8_u64(vdupq_n_u64(0x8040201008040201)); // Bit i in byte i
+            for (; i + 16 <= count; i += 16) {
+                uint8x16_t ge = vandq_u8(vcgeq_u8(vld1q_u8(levels + i), t), weight);
+                u32 mask = static_cast<u32>(vaddv_u8(vget_low_u8(ge))) |
+                           (static_cast<u32>(vaddv_u8(vget_high_u8(ge))) << 8);
+                b.w_[i / 64] |= static_cast<u64>(mask) << (i % 64);
+            }
+#endif
+            for (; i < count; ++i)
+                b.w_[i / 64] |= static_cast<u64>(levels[i] >= threshold) << (i % 64);
+            return b;
+        }
+
+        constexpr bool test(u16 i) const noexcept {
+            return i < condensed::MAX_SECTIONS && ((w_[i / 64] >> (i % 64)) & 1) != 0;
+        }
+        constexpr void set(u16 i, bool on = true) noexcept {
+            if (i >= condensed::MAX_SECTIONS)
+                return;
+            u64 bit = u64{1} << (i % 64);
+            w_[i / 64] = on ? (w_[i / 64] | bit) : (w_[i / 64] & ~bit);
+        }
+        constexpr void reset(u16 i) noexcept { set(i, false); }
+
+        // The 16 sections of one condensed block
+        constexpr u16 block(u16 b) const noexcept { return static_cast<u16>(w_[b / 4] >> ((b % 4) * 16)); }
+        constexpr void set_block(u16 b, u16 bits) noexcept {
+            u32 shift = (b % 4) * 16;
+            w_[b / 4] = (w_[b / 4] & ~(u64{0xFFFF} << shift)) | (static_cast<u64>(bits) << shift);
+        }
+
+        u32 count() const noexcept {
+            u32 n = 0;
+            for (auto word : w_)
+                n += static_cast<u32>(std::popcount(word));
+            return n;
+        }
+        constexpr bool none() const noexcept { return (w_[0] | w_[1] | w_[2] | w_[3]) == 0; }
+        constexpr bool any() const noexcept { return !none(); }
+
+        constexpr u64 word(u16 i) const noexcept { return w_[i]; }
+
+        constexpr SectionBits operator&(const SectionBits &o) const noexcept {
+            SectionBits r;
+            for (u16 i = 0; i < WORDS; ++i)
+                r.w_[i] = w_[i] & o.w_[i];
+            return r;
+        }
+        constexpr SectionBits operator|(const SectionBits &o) const noexcept {
+            SectionBits r;
+            for (u16 i = 0; i < WORDS; ++i)
+                r.w_[i] = w_[i] | o.w_[i];
+            return r;
+        }
+        constexpr SectionBits operator^(const SectionBits &o) const noexcept {
+            SectionBits r;
+            for (u16 i = 0; i < WORDS; ++i)
+                r.w_[i] = w_[i] ^ o.w_[i];
+            return r;
+        }
+        constexpr SectionBits operator~() const noexcept {
+            SectionBits r;
+            for (u16 i = 0; i < WORDS; ++i)
+                r.w_[i] = ~w_[i];
+            return r;
+        }
+        constexpr bool operator==(const SectionBits &o) const noexcept {
+            u64 diff = 0;
+            for (u16 i = 0; i < WORDS; ++i)
+                diff |= w_[i] ^ o.w_[i];
+            return diff == 0;
+        }
+    };
+
+    // ─── Section state engine ────────────────────────────────────────────────────
+    // Desired (setpoint) and actual work states of up to 256 sections as
+    // bitsets. evaluate() turns the operator's request into the desired state
+    // against the coverage map in a few word operations; the flush calls
+    // encode only the 16-section blocks that changed since they last went out
+    // into their condensed work state DDI.
+    class SectionStateEngine {
+        u16 sections_ = 0;
+        SectionBits installed_;
+        SectionBits desired_;
+        SectionBits actual_;
+        SectionBits errors_;
+        SectionBits sent_desired_; // As last flushed, per block
+        SectionBits sent_actual_;
+        SectionBits sent_errors_;
+        u16 force_desired_ = 0; // Blocks to send whatever they hold (after reset())
+        u16 force_actual_ = 0;
+
+      public:
+        explicit SectionStateEngine(u16 sections = 0) { set_sections(sections); }
+
+        void set_sections(u16 sections) {
+            sections_ = sections > condensed::MAX_SECTIONS ? condensed::MAX_SECTIONS : sections;
+            installed_ = SectionBits::first(sections_);
+            desired_ = desired_ & installed_;
+            actual_ = actual_ & installed_;
+            errors_ = errors_ & installed_;
+            reset();
+        }
+
+        u16 sections() const noexcept { return sections_; }
+        u16 blocks() const noexcept {
+            return static_cast<u16>((sections_ + condensed::BLOCK_SECTIONS - 1) / condensed::BLOCK_SECTIONS);
+        }
+
+        // ─── States ──────────────────────────────────────────────────────────────
+        void set_desired(u16 section, bool on) {
+            if (section < sections_)
+                desired_.set(section, on);
+        }
+        void set_desired(const SectionBits &bits) { desired_ = bits & installed_; }
+        void set_actual(u16 section, bool on) {
+            if (section < sections_)
+                actual_.set(section, on);
+        }
+        void set_actual(const SectionBits &bits) { actual_ = bits & installed_; }
+        void set_error(u16 section, bool error) {
+            if (section < sections_)
+                errors_.set(section, error);
+        }
+
+        const SectionBits &desired() const noexcept { return desired_; }
+        const SectionBits &actual() const noexcept { return actual_; }
+        const SectionBits &errors() const noexcept { return errors_; }
+        const SectionBits &installed() const noexcept { return installed_; }
+
+        // Sections not doing what they should
+        SectionBits mismatched() const noexcept { return (desired_ ^ actual_) & installed_ & ~errors_; }
+
+        // ─── Coverage ────────────────────────────────────────────────────────────
+        // Desired = requested, less the sections over covered ground, less
+        // those outside the field boundary. Returns the sections that changed.
+        SectionBits evaluate(const SectionBits &requested, const SectionBits &covered, const SectionBits &inside) {
+            SectionBits next = requested & ~covered & inside & installed_;
+            SectionBits changed = next ^ desired_;
+            desired_ = next;
+            return changed;
+        }
+
+        // As above with per-section overlap in percent: a section switches off
+        // once its overlap with covered ground reaches `max_overlap`
+        SectionBits evaluate(const SectionBits &requested, const u8 *overlap_percent, u8 max_overlap,
+                             const SectionBits &inside) {
+            return evaluate(requested, SectionBits::at_least(overlap_percent, sections_, max_overlap), inside);
+        }
+
+        // ─── Condensed work state ────────────────────────────────────────────────
+        // One block's value: on/off from `states`, not installed past
+        // sections(), and with `with_errors` error where errors() has it
+        i32 encode(const SectionBits &states, u16 block, bool with_errors = false) const noexcept {
+            u32 on = condensed::spread(states.block(block));
+            u32 err = with_errors ? condensed::spread(errors_.block(block)) : 0;
+            u32 absent = condensed::spread(static_cast<u16>(~installed_.block(block))) * 3;
+            return static_cast<i32>((on & ~err) | (err << 1) | absent);
+        }
+
+        // Takes a Setpoint Condensed Work State value into desired(); false for other DDIs
+        bool receive_setpoint(DDI ddi, i32 value) {
+            i32 block = condensed::setpoint_block(ddi);
+            if (block < 0 || block >= blocks())
+                return false;
+            u32 v = static_cast<u32>(value);
+            // Only fields reading exactly 1 are on; 2 and 3 leave the section off
+            u16 on = condensed::gather(v & ~(v >> 1));
+            u16 b = static_cast<u16>(block);
+            desired_.set_block(b, static_cast<u16>(on & installed_.block(b)));
+            return true;
+        }
+
+        // Sends the Setpoint Condensed Work State of every block whose desired
+        // state changed: send(DDI, i32). Returns the number of blocks sent.
+        template <typename Fn> usize flush_desired(Fn &&send) {
+            return flush(desired_, sent_desired_, nullptr, force_desired_, send);
+        }
+
+        // Same for Actual Condensed Work State, from actual() and errors()
+        template <typename Fn> usize flush_actual(Fn &&send) {
+            return flush(actual_, sent_actual_, &sent_errors_, force_actual_, send);
+        }
+
+        // Every block goes out on the next flush, e.g. after a reconnect
+        void reset() noexcept {
+            force_desired_ = force_actual_ = static_cast<u16>((1u << blocks()) - 1);
+        }
+
+      private:
+        // Errors are reported (and tracked for changes) with the actual state only
+        template <typename Fn>
+        usize flush(const SectionBits &states, SectionBits &sent, SectionBits *sent_errors, u16 &force, Fn &send) {
+            SectionBits changed = states ^ sent;
+            if (sent_errors)
+                changed = changed | (errors_ ^ *sent_errors);
+            usize count = 0;
+            for (u16 b = 0; b < blocks(); ++b) {
+                if (changed.block(b) == 0 && (force & (1u << b)) == 0)
+                    continue;
+                DDI ddi = sent_errors ? condensed::actual_ddi(b) : condensed::setpoint_ddi(b);
+                send(ddi, encode(states, b, sent_errors != nullptr));
+                sent.set_block(b, states.block(b));
+                if (sent_errors)
+                    sent_errors->set_block(b, errors_.block(b));
+                ++count;
+            }
+            force = 0;
+            return count;
+        }
+    };
+
+} // namespace agrobus::isobus::tc
@@ -3,11 +3,13 @@
 #include "ddop.hpp"
 #include "objects.hpp"
 #include "server_options.hpp"
+#include "value_store.hpp"
 #include <agrobus/net/constants.hpp>
 #include <agrobus/net/control_function.hpp>
 #include <agrobus/net/error.hpp>
 #include <agrobus/net/event.hpp>
 #include <agrobus/net/internal_cf.hpp>
+#include <agrobus/net/memory_budget.hpp>
 #include <agrobus/net/message.hpp>
 #include <agrobus/net/network_manager.hpp>
 #include <agrobus/net/state_machine.hpp>
@@ -24,6 +26,49 @@ namespace agrobus::isobus::tc {
         DDOP ddop;
         bool pool_activated = false;
         u32 last_status_ms = 0;
+        ProcessDataStore values; // Values received from the client, and setpoints for it
+    };
+
+    // ─── Batched process data ────────────────────────────────────────────────────
+    // Values received between two server updates, one column per field, so
+    // an application serving several implements gets thousands of values a
+    // second in a few calls instead of one callback each. Row i of every
+    // column is one Value message; timestamps are the message RX time, or
+    // the server clock when the driver gives none.
+    struct ValueBatch {
+        dp::Vector<Address> clients;
+        dp::Vector<ElementNumber> elements;
+        dp::Vector<DDI> ddis;
+        dp::Vector<i32> values;
+        dp::Vector<u64> timestamps_us;
+
+        usize size() const noexcept { return values.size(); }
+        bool empty() const noexcept { return values.empty(); }
+
+        void push(Address client, ElementNumber element, DDI ddi, i32 value, u64 timestamp_us) {
+            clients.push_back(client);
+            elements.push_back(element);
+            ddis.push_back(ddi);
+            values.push_back(value);
+            timestamps_us.push_back(timestamp_us);
+        }
+
+        // Keeps the capacity for the next tick
+        void clear() {
+            clients.clear();
+            elements.clear();
+            ddis.clear();
+            values.clear();
+            timestamps_us.clear();
+        }
+
+        void reserve(usize n) {
+            clients.reserve(n);
+            elements.reserve(n);
+            ddis.reserve(n);
+            values.reserve(n);
+            timestamps_us.reserve(n);
+        }
     };
 
     // ─── TC Status broadcast interval ────────────────────────────────────────────
@@ -37,6 +82,9 @@ namespace agrobus::isobus::tc {
         u8 num_sections = 0;
         u8 num_channels = 0;
         u8 server_options = 0;
+        // DDOPs of the clients and the ones stored by NAME are charged here; a
+        // transfer that would not fit is answered "not enough memory"
+        MemoryBudget *memory = nullptr;
 
         TCServerConfig &number(u8 n) {
             tc_number = n;
@@ -62,6 +110,10 @@ namespace agrobus::isobus::tc {
             server_options = o;
             return *this;
         }
+        TCServerConfig &budget(MemoryBudget *b) {
+            memory = b;
+            return *this;
+        }
     };
 
     // ─── ISO 11783-10 Task Controller Server ─────────────────────────────────────
@@ -70,6 +122,10 @@ namespace agrobus::isobus::tc {
         InternalCF *cf_;
         StateMachine<TCServerState> state_{TCServerState::Disconnected};
         dp::Vector<TCClientInfo> clients_;
+        dp::Map<u64, DDOP> pools_; // Last pool each client NAME transferred
+        dp::Array<u8, 256> client_slot_{}; // Address -> clients_ index + 1, 0 if not a client
+        ValueBatch batch_;
+        u64 clock_us_ = 0;
         u8 server_options_ = 0;
         u32 status_timer_ms_ = 0;
         u8 tc_number_ = 0;
@@ -77,6 +133,7 @@ namespace agrobus::isobus::tc {
         u8 num_booms_ = 0;
         u8 num_sections_ = 0;
         u8 num_channels_ = 0;
+        MemoryCharge memory_;
 
         // Callbacks
         using ValueRequestCallback = std::function<Result<i32>(ElementNumber, DDI, TCClientInfo *)>;
@@ -84,16 +141,18 @@ namespace agrobus::isobus::tc {
             std::function<Result<ProcessDataAcknowledgeErrorCodes>(ElementNumber, DDI, i32, TCClientInfo *)>;
         using PeerControlCallback =
             std::function<Result<void>(ElementNumber src_element, DDI src_ddi, ElementNumber dst_element, DDI dst_ddi)>;
+        using ValueBatchCallback = std::function<void(const ValueBatch &)>;
 
         dp::Optional<ValueRequestCallback> value_request_cb_;
         dp::Optional<ValueCallback> value_cb_;
         dp::Optional<PeerControlCallback> peer_control_cb_;
+        dp::Optional<ValueBatchCallback> value_batch_cb_;
 
       public:
         TaskControllerServer(IsoNet &net, InternalCF *cf, TCServerConfig config = {})
             : net_(net), cf_(cf), server_options_(config.server_options), tc_number_(config.tc_number),
               tc_version_(config.tc_version), num_booms_(config.num_booms), num_sections_(config.num_sections),
-              num_channels_(config.num_channels) {}
+              num_channels_(config.num_channels), memory_(config.memory) {}
 
         Result<void> start() {
             state_.transition(TCServerState::WaitForClients);
@@ -102,9 +161,14 @@ namespace agrobus::isobus::tc {
             return {};
         }
 
+        // Stored pools are kept: a client reconnecting after a restart of the
+        // server (not of the process) can still skip its transfer
         Result<void> stop() {
             state_.transition(TCServerState::Disconnected);
             clients_.clear();
+            client_slot_.fill(0);
+            batch_.clear();
+            account_memory();
             echo::category("isobus.tc.server").info("TC Server stopped");
             return {};
         }
@@ -116,6 +180,13 @@ namespace agrobus::isobus::tc {
         void on_value_received(ValueCallback cb) { value_cb_ = std::move(cb); }
         void on_peer_control_assignment(PeerControlCallback cb) { peer_control_cb_ = std::move(cb); }
 
+        // Received values collected per update() and handed over in one call,
+        // after the per-value callback (which still runs if set)
+        void on_values_received(ValueBatchCallback cb, usize reserve = 1024) {
+            value_batch_cb_ = std::move(cb);
+            batch_.reserve(reserve);
+        }
+
         // ─── Pool management ─────────────────────────────────────────────────────
         Result<ObjectPoolActivationError> activate_pool(TCClientInfo &client) {
             if (client.ddop.devices().empty()) {
@@ -126,6 +197,24 @@ namespace agrobus::isobus::tc {
             return Result<ObjectPoolActivationError>::ok(ObjectPoolActivationError::NoErrors);
         }
 
+        // Pools kept by client NAME. A client that connects again with the same
+        // structure and localization labels activates its pool without sending
+        // it; a changed label makes it transfer, which replaces the stored one.
+        usize stored_pools() const noexcept { return pools_.size(); }
+
+        const DDOP *stored_pool(Name name) const {
+            auto it = pools_.find(name.raw);
+            return it == pools_.end() ? nullptr : &it->second;
+        }
+
+        void forget_pool(Name name) {
+            pools_.erase(name.raw);
+            account_memory();
+        }
+
+        // Serialized bytes of the clients' DDOPs and the stored ones
+        u64 memory_bytes() const noexcept { return memory_.bytes(); }
+
         Result<void> send_request_value(ElementNumber element, DDI ddi, ControlFunction *dest) {
             dp::Vector<u8> data(8, 0xFF);
             data[0] =
@@ -149,6 +238,35 @@ namespace agrobus::isobus::tc {
             return net_.send(PGN_TC_TO_ECU, data, cf_, dest, Priority::Default);
         }
 
+        // ─── Process data values ─────────────────────────────────────────────────
+        // Each client's values are kept in TCClientInfo::values: those it reports
+        // as they arrive, and setpoints written here, which answer its requests
+        // with no callback and go out together through send_values().
+        Result<void> set_value(Address client, ElementNumber element, DDI ddi, i32 value) {
+            auto *c = find_client(client);
+            if (!c)
+                return Result<void>::err(Error::invalid_state("unknown TC client"));
+            c->values.set(element, ddi, value);
+            return {};
+        }
+
+        // Every setpoint written since the last call, one Value message each
+        usize send_values(Address client) {
+            auto *c = find_client(client);
+            if (!c)
+                return 0;
+            ControlFunction dest;
+            dest.address = client;
+            return c->values.flush_dirty([&](const ProcessDataStore::Value &v) {
+                return send_set_value(v.element, v.ddi, v.value, &dest).is_ok();
+            });
+        }
+
+        const TCClientInfo *client(Address addr) const noexcept {
+            u8 slot = client_slot_[addr];
+            return slot ? &clients_[slot - 1] : nullptr;
+        }
+
         const dp::Vector<TCClientInfo> &clients() const noexcept { return clients_; }
 
         // ─── Events ──────────────────────────────────────────────────────────────
@@ -159,9 +277,15 @@ namespace agrobus::isobus::tc {
 
         // ─── Update loop ─────────────────────────────────────────────────────────
         void update(u32 elapsed_ms) {
+            ProfileScope profile(net_.update_profiler(), "tc_server");
             if (state_.state() == TCServerState::Disconnected)
                 return;
 
+            clock_us_ += static_cast<u64>(elapsed_ms) * 1000;
+            flush_values();
+            for (auto &c : clients_)
+                c.values.update(elapsed_ms);
+
             status_timer_ms_ += elapsed_ms;
             if (status_timer_ms_ >= TC_STATUS_INTERVAL_MS) {
                 status_timer_ms_ -= TC_STATUS_INTERVAL_MS;
@@ -169,10 +293,19 @@ namespace agrobus::isobus::tc {
             }
         }
 
+        // Hand the values collected so far to the batch callback now
+        void flush_values() {
+            if (batch_.empty())
+                return;
+            if (value_batch_cb_.has_value())
+                (*value_batch_cb_)(batch_);
+            batch_.clear();
+        }
+
       private:
         void send_tc_status() {
             dp::Vector<u8> data(8, 0xFF);
-            data[0] = static_cast<u8>(ProcessDataCommands::Status);
+            data[0] = tc_cmd::TC_STATUS; // Status command, element number all ones
             data[1] = tc_number_;
             // Status byte: bit 0 = task active, bit 1 = busy
             data[2] = 0x00;
@@ -189,6 +322,17 @@ namespace agrobus::isobus::tc {
             if (msg.data.empty())
                 return;
 
+            // Object pool transfer and activation, ahead of the process data nibbles
+            if (msg.data.size() > 8) {
+                handle_pool_transfer(msg);
+                return;
+            }
+            if (msg.data.size() >= 4 && msg.data[0] == tc_cmd::ACTIVATE_POOL && msg.data[2] == 0xFF &&
+                msg.data[3] == 0xFF) {
+                handle_activate_pool(msg);
+                return;
+            }
+
             u8 cmd = msg.data[0] & 0x0F;
 
             switch (static_cast<ProcessDataCommands>(cmd)) {
@@ -218,7 +362,7 @@ namespace agrobus::isobus::tc {
 
             // Respond with our capabilities (addressed to requester)
             dp::Vector<u8> data(8, 0xFF);
-            data[0] = static_cast<u8>(ProcessDataCommands::TechnicalCapabilities);
+            data[0] = tc_cmd::VERSION_RESPONSE;
             data[1] = tc_version_;
             data[2] = num_booms_;
             data[3] = num_sections_;
@@ -230,27 +374,156 @@ namespace agrobus::isobus::tc {
             echo::category("isobus.tc.server").debug("Tech capabilities from client ", msg.source);
         }
 
-        void handle_device_descriptor(const Message & /*msg*/) {
-            // DDOP transfer handled by transport protocol
-            echo::category("isobus.tc.server").trace("Device descriptor received");
+        // Label requests: the labels of the pool stored for this client (its
+        // current one, else the one kept under its NAME), all 0xFF for none
+        void handle_device_descriptor(const Message &msg) {
+            u8 request = msg.data[0];
+            if (request == tc_cmd::REQUEST_OBJECT_POOL) {
+                handle_request_object_pool(msg);
+                return;
+            }
+            if (request != tc_cmd::STRUCTURE_LABEL && request != tc_cmd::LOCALIZATION_LABEL) {
+                echo::category("isobus.tc.server").trace("Device descriptor command ", request, " from ", msg.source);
+                return;
+            }
+            ensure_client(msg.source);
+            bool structure = request == tc_cmd::STRUCTURE_LABEL;
+
+            dp::Vector<u8> data(8, 0xFF);
+            data[0] = structure ? tc_cmd::STRUCTURE_LABEL_RESPONSE : tc_cmd::LOCALIZATION_LABEL_RESPONSE;
+            if (const DDOP *pool = pool_for(msg.source); pool && !pool->devices().empty()) {
+                const auto &dev = pool->devices()[0];
+                const auto &label = structure ? dev.structure_label : dev.localization_label;
+                for (usize i = 0; i < 7; ++i)
+                    data[1 + i] = label[i];
+            }
+            ControlFunction dest_cf;
+            dest_cf.address = msg.source;
+            net_.send(PGN_TC_TO_ECU, data, cf_, &dest_cf, Priority::Default);
+        }
+
+        // Request Object-pool Transfer: whether a DDOP of the announced size fits
+        void handle_request_object_pool(const Message &msg) {
+            ensure_client(msg.source);
+            u32 bytes = msg.data.size() >= 5 ? msg.get_u32_le(1) : 0;
+            bool enough = memory_.fits(bytes);
+            if (!enough)
+                echo::category("isobus.tc.server")
+                    .warn("DDOP of ", bytes, " bytes from client ", msg.source, " refused: memory budget");
+
+            dp::Vector<u8> data(8, 0xFF);
+            data[0] = tc_cmd::REQUEST_OBJECT_POOL_RESPONSE;
+            data[1] = enough ? 0x00 : 0x01; // 1 = not enough memory
+            ControlFunction dest_cf;
+            dest_cf.address = msg.source;
+            net_.send(PGN_TC_TO_ECU, data, cf_, &dest_cf, Priority::Default);
+        }
+
+        // A whole DDOP, reassembled by the transport layer
+        void handle_pool_transfer(const Message &msg) {
+            ensure_client(msg.source);
+            auto *client = find_client(msg.source);
+            if (!client)
+                return;
+
+            // A stored copy doubles the cost of a client with a NAME
+            u64 cost = msg.data.size() * (net_.names().name_at(cf_->port(), msg.source) ? 2u : 1u);
+            if (!memory_.fits(cost)) {
+                echo::category("isobus.tc.server").warn("DDOP from client ", msg.source, " refused: memory budget");
+                dp::Vector<u8> data(8, 0xFF);
+                data[0] = tc_cmd::OBJECT_POOL_RESPONSE;
+                data[1] = 0x01; // Not enough memory
+                ControlFunction dest_cf;
+                dest_cf.address = msg.source;
+                net_.send(PGN_TC_TO_ECU, data, cf_, &dest_cf, Priority::Default);
+                return;
+            }
+
+            auto parsed = DDOP::deserialize(msg.data);
+            bool ok = parsed.is_ok() && !parsed.value().devices().empty();
+            if (ok) {
+                client->ddop = std::move(parsed.value());
+                client->pool_activated = false;
+                if (auto name = net_.names().name_at(cf_->port(), msg.source))
+                    pools_[name->raw] = client->ddop;
+                echo::category("isobus.tc.server")
+                    .info("DDOP from client ", msg.source, ": ", client->ddop.object_count(), " objects");
+            } else {
+                echo::category("isobus.tc.server").warn("DDOP from client ", msg.source, " rejected");
+            }
+            account_memory();
+
+            dp::Vector<u8> data(8, 0xFF);
+            data[0] = tc_cmd::OBJECT_POOL_RESPONSE;
+            data[1] = ok ? 0x00 : 0x01;
+            ControlFunction dest_cf;
+            dest_cf.address = msg.source;
+            net_.send(PGN_TC_TO_ECU, data, cf_, &dest_cf, Priority::Default);
+        }
+
+        // Activates the pool just transferred, or the one stored for the client
+        void handle_activate_pool(const Message &msg) {
+            ensure_client(msg.source);
+            auto *client = find_client(msg.source);
+            if (!client)
+                return;
+            if (client->ddop.devices().empty()) {
+                if (auto name = net_.names().name_at(cf_->port(), msg.source)) {
+                    if (const DDOP *stored = stored_pool(*name))
+                        client->ddop = *stored;
+                }
+                account_memory();
+            }
+
+            auto result = activate_pool(*client);
+            auto error = result.is_ok() ? result.value() : ObjectPoolActivationError::ThereAreErrorsInTheDDOP;
+            if (error != ObjectPoolActivationError::NoErrors)
+                on_pool_activation_error.emit(error);
+
+            dp::Vector<u8> data(8, 0xFF);
+            data[0] = tc_cmd::ACTIVATE_RESPONSE;
+            data[1] = static_cast<u8>(error);
+            ControlFunction dest_cf;
+            dest_cf.address = msg.source;
+            net_.send(PGN_TC_TO_ECU, data, cf_, &dest_cf, Priority::Default);
+        }
+
+        void account_memory() {
+            u64 held = 0;
+            for (const auto &c : clients_)
+                held += c.ddop.serialized_size();
+            for (const auto &[name, pool] : pools_)
+                held += pool.serialized_size();
+            memory_.force(held);
+        }
+
+        const DDOP *pool_for(Address addr) const {
+            const auto *c = client(addr);
+            if (c && !c->ddop.devices().empty())
+                return &c->ddop;
+            auto name = net_.names().name_at(cf_->port(), addr);
+            return name ? stored_pool(*name) : nullptr;
         }
 
         void handle_value(const Message &msg) {
             if (msg.data.size() < 8)
                 return;
 
-            echo::category("isobus.tc.server").debug("process data from addr=", msg.source);
-
             ElementNumber element = static_cast<u16>((msg.data[0] >> 4) & 0x0F) | (static_cast<u16>(msg.data[1]) << 4);
             DDI ddi = static_cast<u16>(msg.data[2]) | (static_cast<u16>(msg.data[3]) << 8);
             i32 value = static_cast<i32>(msg.data[4]) | (static_cast<i32>(msg.data[5]) << 8) |
                         (static_cast<i32>(msg.data[6]) << 16) | (static_cast<i32>(msg.data[7]) << 24);
 
             auto *client = find_client(msg.source);
-            if (value_cb_.has_value() && client) {
+            if (!client)
+                return;
+            client->values.receive(element, ddi, value);
+            if (value_cb_.has_value()) {
                 auto result = (*value_cb_)(element, ddi, value, client);
                 (void)result;
             }
+            if (value_batch_cb_.has_value())
+                batch_.push(msg.source, element, ddi, value, msg.timestamp_us ? msg.timestamp_us : clock_us_);
         }
 
         void handle_request_value(const Message &msg) {
@@ -261,26 +534,30 @@ namespace agrobus::isobus::tc {
             DDI ddi = static_cast<u16>(msg.data[2]) | (static_cast<u16>(msg.data[3]) << 8);
 
             auto *client = find_client(msg.source);
-            if (value_request_cb_.has_value() && client) {
+            if (!client)
+                return;
+            dp::Optional<i32> value = client->values.get(element, ddi);
+            if (!value && value_request_cb_.has_value()) {
                 auto result = (*value_request_cb_)(element, ddi, client);
-                if (result.is_ok()) {
-                    dp::Vector<u8> data(8, 0xFF);
-                    data[0] =
-                        (static_cast<u8>(ProcessDataCommands::Value) & 0x0F) | ((static_cast<u8>(element) & 0x0F) << 4);
-                    data[1] = static_cast<u8>((element >> 4) & 0xFF);
-                    data[2] = static_cast<u8>(ddi & 0xFF);
-                    data[3] = static_cast<u8>((ddi >> 8) & 0xFF);
-                    i32 v = result.value();
-                    data[4] = static_cast<u8>(v & 0xFF);
-                    data[5] = static_cast<u8>((v >> 8) & 0xFF);
-                    data[6] = static_cast<u8>((v >> 16) & 0xFF);
-                    data[7] = static_cast<u8>((v >> 24) & 0xFF);
-                    // Address response back to requester
-                    ControlFunction dest_cf;
-                    dest_cf.address = msg.source;
-                    net_.send(PGN_TC_TO_ECU, data, cf_, &dest_cf, Priority::Default);
-                }
+                if (result.is_ok())
+                    value = result.value();
             }
+            if (!value)
+                return;
+            dp::Vector<u8> data(8, 0xFF);
+            data[0] = (static_cast<u8>(ProcessDataCommands::Value) & 0x0F) | ((static_cast<u8>(element) & 0x0F) << 4);
+            data[1] = static_cast<u8>((element >> 4) & 0xFF);
+            data[2] = static_cast<u8>(ddi & 0xFF);
+            data[3] = static_cast<u8>((ddi >> 8) & 0xFF);
+            i32 v = *value;
+            data[4] = static_cast<u8>(v & 0xFF);
+            data[5] = static_cast<u8>((v >> 8) & 0xFF);
+            data[6] = static_cast<u8>((v >> 16) & 0xFF);
+            data[7] = static_cast<u8>((v >> 24) & 0xFF);
+            // Address response back to requester
+            ControlFunction dest_cf;
+            dest_cf.address = msg.source;
+            net_.send(PGN_TC_TO_ECU, data, cf_, &dest_cf, Priority::Default);
         }
 
         void handle_peer_control(const Message &msg) {
@@ -316,11 +593,10 @@ namespace agrobus::isobus::tc {
         }
 
         void ensure_client(Address addr) {
-            for (auto &c : clients_) {
-                if (c.address == addr)
-                    return;
-            }
+            if (client_slot_[addr] != 0 || addr == NULL_ADDRESS || addr == BROADCAST_ADDRESS)
+                return;
             clients_.push_back({addr, {}, false, 0});
+            client_slot_[addr] = static_cast<u8>(clients_.size());
             echo::category("isobus.tc.server").info("client connected: addr=", addr);
             on_client_connected.emit(addr);
 
@@ -331,11 +607,8 @@ namespace agrobus::isobus::tc {
         }
 
         TCClientInfo *find_client(Address addr) {
-            for (auto &c : clients_) {
-                if (c.address == addr)
-                    return &c;
-            }
-            return nullptr;
+            u8 slot = client_slot_[addr];
+            return slot ? &clients_[slot - 1] : nullptr;
         }
     };
 
@@ -65,6 +65,28 @@ namespace agrobus::isobus::tc {
 
     enum class TCServerState : u8 { Disconnected, WaitForClients, Active };
 
+    // ─── TC command types ────────────────────────────────────────────────────────
+    namespace tc_cmd {
+        inline constexpr u8 VERSION_REQUEST = 0x00;
+        inline constexpr u8 VERSION_RESPONSE = 0x10;
+        inline constexpr u8 STRUCTURE_LABEL = 0x01;
+        inline constexpr u8 STRUCTURE_LABEL_RESPONSE = 0x11;
+        inline constexpr u8 LOCALIZATION_LABEL = 0x21;
+        inline constexpr u8 LOCALIZATION_LABEL_RESPONSE = 0x31;
+        inline constexpr u8 REQUEST_OBJECT_POOL = 0x41;
+        inline constexpr u8 REQUEST_OBJECT_POOL_RESPONSE = 0x51;
+        inline constexpr u8 OBJECT_POOL_TRANSFER = 0x11;
+        inline constexpr u8 OBJECT_POOL_RESPONSE = 0x12;
+        inline constexpr u8 ACTIVATE_POOL = 0x22;
+        inline constexpr u8 ACTIVATE_RESPONSE = 0x23;
+        inline constexpr u8 DELETE_POOL = 0x32;
+        inline constexpr u8 PROCESS_DATA = 0x03;
+        inline constexpr u8 SET_VALUE = 0x24;
+        inline constexpr u8 REQUEST_VALUE = 0x04;
+        inline constexpr u8 VALUE_RESPONSE = 0x05;
+        inline constexpr u8 TC_STATUS = 0xFE;
+    } // namespace tc_cmd
+
     // Bitwise operators for ServerOptions
     inline u8 operator|(ServerOptions a, ServerOptions b) { return static_cast<u8>(a) | static_cast<u8>(b); }
 
@@ -0,0 +1,159 @@
+#pragma once
+
+#include "ddop.hpp"
+#include "objects.hpp"
+#include <agrobus/net/types.hpp>
+#include <bit>
+#include <datapod/datapod.hpp>
+
+namespace agrobus::isobus::tc {
+    using namespace agrobus::net;
+
+    // ─── Process data value store ────────────────────────────────────────────────
+    // The current value of every (element, DDI) of a DDOP: the process data and
+    // properties each element lists as children. Keys go through one map to a
+    // dense array of values, so a request is answered with no callback hop, and
+    // values written since the last flush_dirty() are kept in a bitset and sent
+    // together. Entries not in the DDOP are added on the first write (a TC
+    // server may get values before it has the client's DDOP).
+    class ProcessDataStore {
+      public:
+        struct Value {
+            ElementNumber element = 0;
+            DDI ddi = 0;
+            i32 value = 0;
+            u64 updated_ms = 0; // Store clock at the last write
+            bool valid = false; // Written at least once (properties start valid)
+            bool property = false;
+        };
+
+      private:
+        dp::Map<u32, u32> slots_; // (element << 16 | DDI) -> index into values_
+        dp::Vector<Value> values_;
+        dp::Vector<u64> dirty_;
+        usize dirty_count_ = 0;
+        u64 now_ms_ = 0;
+
+      public:
+        static constexpr u32 key(ElementNumber element, DDI ddi) noexcept {
+            return (static_cast<u32>(element) << 16) | ddi;
+        }
+
+        static ProcessDataStore from_ddop(const DDOP &ddop) {
+            ProcessDataStore store;
+            for (const auto &elem : ddop.elements()) {
+                for (auto child : elem.child_objects) {
+                    if (const auto *pd = ddop.find_process_data(child)) {
+                        store.add(elem.number, pd->ddi);
+                    } else if (const auto *prop = ddop.find_property(child)) {
+                        Value &v = store.values_[store.add(elem.number, prop->ddi)];
+                        v.value = prop->value;
+                        v.valid = true;
+                        v.property = true;
+                    }
+                }
+            }
+            return store;
+        }
+
+        // Slot of (element, DDI), added if new
+        u32 add(ElementNumber element, DDI ddi) {
+            u32 k = key(element, ddi);
+            auto it = slots_.find(k);
+            if (it != slots_.end())
+                return it->second;
+            u32 slot = static_cast<u32>(values_.size());
+            slots_[k] = slot;
+            Value v;
+            v.element = element;
+            v.ddi = ddi;
+            values_.push_back(v);
+            if (dirty_.size() * 64 < values_.size())
+                dirty_.push_back(0);
+            return slot;
+        }
+
+        // Writes a value and marks it to send; an unchanged value stays clean
+        void set(ElementNumber element, DDI ddi, i32 value) {
+            u32 slot = add(element, ddi);
+            Value &v = values_[slot];
+            bool changed = !v.valid || v.value != value;
+            write(v, value);
+            if (changed)
+                mark(slot);
+        }
+
+        // Writes a value that came from the peer: nothing to send back
+        void receive(ElementNumber element, DDI ddi, i32 value) { write(values_[add(element, ddi)], value); }
+
+        const Value *find(ElementNumber element, DDI ddi) const noexcept {
+            auto it = slots_.find(key(element, ddi));
+            return it == slots_.end() ? nullptr : &values_[it->second];
+        }
+
+        dp::Optional<i32> get(ElementNumber element, DDI ddi) const noexcept {
+            const Value *v = find(element, ddi);
+            if (!v || !v->valid)
+                return dp::nullopt;
+            return v->value;
+        }
+
+        bool contains(ElementNumber element, DDI ddi) const noexcept { return find(element, ddi) != nullptr; }
+
+        // Hands every dirty value to send(const Value &) in slot order and
+        // clears it; a value send() returns false for stays dirty
+        template <typename Fn> usize flush_dirty(Fn &&send) {
+            usize sent = 0;
+            for (usize w = 0; w < dirty_.size(); ++w) {
+                u64 bits = dirty_[w];
+                while (bits != 0) {
+                    u32 slot = static_cast<u32>(w * 64 + static_cast<usize>(std::countr_zero(bits)));
+                    bits &= bits - 1;
+                    if (!send(static_cast<const Value &>(values_[slot])))
+                        continue;
+                    dirty_[w] &= ~(u64{1} << (slot % 64));
+                    --dirty_count_;
+                    ++sent;
+                }
+            }
+            return sent;
+        }
+
+        bool dirty(ElementNumber element, DDI ddi) const noexcept {
+            auto it = slots_.find(key(element, ddi));
+            return it != slots_.end() && (dirty_[it->second / 64] >> (it->second % 64)) & 1;
+        }
+
+        // Advances the clock stamped on writes
+        void update(u32 elapsed_ms) noexcept { now_ms_ += elapsed_ms; }
+        u64 now_ms() const noexcept { return now_ms_; }
+
+        const dp::Vector<Value> &values() const noexcept { return values_; }
+        usize size() const noexcept { return values_.size(); }
+        bool empty() const noexcept { return values_.empty(); }
+        usize dirty_count() const noexcept { return dirty_count_; }
+
+        void clear() {
+            slots_.clear();
+            values_.clear();
+            dirty_.clear();
+            dirty_count_ = 0;
+        }
+
+      private:
+        void write(Value &v, i32 value) noexcept {
+            v.value = value;
+            v.valid = true;
+            v.updated_ms = now_ms_;
+        }
+
+        void mark(u32 slot) noexcept {
+            u64 bit = u64{1} << (slot % 64);
+            if ((dirty_[slot / 64] & bit) == 0) {
+                dirty_[slot / 64] |= bit;
+                ++dirty_count_;
+            }
+        }
+    };
+
+} // namespace agrobus::isobus::tc
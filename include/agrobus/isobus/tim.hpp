@@ -2,6 +2,7 @@
 
 #include <agrobus/net/constants.hpp>
 #include <agrobus/net/control_function.hpp>
+#include <agrobus/net/data_span.hpp>
 #include <agrobus/net/error.hpp>
 #include <agrobus/net/event.hpp>
 #include <agrobus/net/internal_cf.hpp>
@@ -61,6 +62,77 @@ namespace agrobus::isobus {
 
     inline constexpr u8 MAX_AUX_VALVES = 32;
     inline constexpr u32 TIM_UPDATE_INTERVAL_MS = 100;
+    inline constexpr u8 AUX_VALVE_RECORDS_PER_FRAME = 2;
+
+    // ─── Packed aux valve states ─────────────────────────────────────────────────
+    // All valves of one side in flat arrays: a bit per valve for the state and
+    // the two capabilities, a word per valve for the flow. Finding what moved
+    // between two banks is one diff() rather than 32 AuxValve copies.
+    struct AuxValveBank {
+        u32 state = 0;
+        u32 state_supported = 0;
+        u32 flow_supported = 0;
+        dp::Array<u16, MAX_AUX_VALVES> flow{};
+
+        static constexpr u32 bit(u8 index) noexcept { return u32(1) << index; }
+
+        bool get_state(u8 index) const noexcept { return (state & bit(index)) != 0; }
+
+        // Index must be below MAX_AUX_VALVES; true when state or flow changed
+        bool set(u8 index, bool on, u16 value) noexcept {
+            bool changed = get_state(index) != on || flow[index] != value;
+            state = on ? (state | bit(index)) : (state & ~bit(index));
+            flow[index] = value;
+            return changed;
+        }
+
+        AuxValve valve(u8 index) const noexcept {
+            AuxValve v;
+            v.state_supported = (state_supported & bit(index)) != 0;
+            v.flow_supported = (flow_supported & bit(index)) != 0;
+            v.state = get_state(index);
+            v.flow = flow[index];
+            return v;
+        }
+
+        // Valves whose state or flow differ from `other`
+        u32 diff(const AuxValveBank &other) const noexcept {
+            u32 mask = state ^ other.state;
+            for (u8 i = 0; i < MAX_AUX_VALVES; ++i)
+                if (flow[i] != other.flow[i])
+                    mask |= bit(i);
+            return mask;
+        }
+    };
+
+    namespace detail {
+        // Valve records, AUX_VALVE_RECORDS_PER_FRAME to a frame: [index, state, flow lo, flow hi],
+        // index 0xFF for an unused slot. One record in the first four bytes is
+        // the single-valve layout. Calls send(data) per frame, returns frames.
+        template <typename Send> u32 send_aux_valve_records(const AuxValveBank &bank, u32 mask, Send &&send) {
+            u32 frames = 0;
+            dp::Vector<u8> data(8, 0xFF);
+            u8 slot = 0;
+            for (u8 i = 0; i < MAX_AUX_VALVES && mask != 0; ++i) {
+                if (!(mask & AuxValveBank::bit(i)))
+                    continue;
+                mask &= ~AuxValveBank::bit(i);
+                u8 *rec = data.data() + slot * 4;
+                rec[0] = i;
+                rec[1] = bank.get_state(i) ? 0x01 : 0x00;
+                rec[2] = static_cast<u8>(bank.flow[i] & 0xFF);
+                rec[3] = static_cast<u8>((bank.flow[i] >> 8) & 0xFF);
+                if (++slot == AUX_VALVE_RECORDS_PER_FRAME || mask == 0) {
+                    send(data);
+                    ++frames;
+                    slot = 0;
+                    for (auto &b : data)
+                        b = 0xFF;
+                }
+            }
+            return frames;
+        }
+    } // namespace detail
 
     // ─── TIM Server Config ──────────────────────────────────────────────────────
     struct TimServerConfig {
@@ -93,7 +165,15 @@ namespace agrobus::isobus {
     };
 
     // ─── TIM Server (Tractor ECU side) ───────────────────────────────────────────
+    // Status goes out when it changes, on the next update(), and everything
+    // is repeated every update_interval_ms from a timer on the IsoNet timer
+    // wheel. A PTO, hitch or valve that is set to the value it already has
+    // sends nothing extra. Valve status is packed two valves per frame on the
+    // estimated-flow PGN; the refresh covers every valve that has a capability
+    // or has been set. Neither copyable nor movable: the timer holds `this`.
     class TimServer {
+        enum : u8 { FRONT_PTO = 0x01, REAR_PTO = 0x02, FRONT_HITCH = 0x04, REAR_HITCH = 0x08, ALL = 0x0F };
+
         IsoNet &net_;
         InternalCF *cf_;
         TimServerConfig config_;
@@ -102,11 +182,27 @@ namespace agrobus::isobus {
         PTOState rear_pto_;
         HitchState front_hitch_;
         HitchState rear_hitch_;
-        dp::Array<AuxValve, MAX_AUX_VALVES> aux_valves_{};
-        u32 timer_ms_ = 0;
+        AuxValveBank aux_valves_;
+        u32 valves_in_use_ = 0;
+        u32 valves_dirty_ = 0;
+        u8 dirty_ = 0;
+        TimerId refresh_timer_ = INVALID_TIMER;
+        u64 frames_sent_ = 0;
 
       public:
-        TimServer(IsoNet &net, InternalCF *cf, TimServerConfig config = {}) : net_(net), cf_(cf), config_(config) {}
+        TimServer(IsoNet &net, InternalCF *cf, TimServerConfig config = {}) : net_(net), cf_(cf), config_(config) {
+            // Refresh every interval on the network clock from construction
+            u32 interval = config_.update_interval_ms;
+            u32 phase = interval == 0 ? 0 : static_cast<u32>(net_.timers().now_ms() % interval);
+            refresh_timer_ = net_.timers().schedule_every(interval, phase, [this]() { send(ALL, valves_in_use_); });
+        }
+
+        TimServer(const TimServer &) = delete;
+        TimServer &operator=(const TimServer &) = delete;
+        TimServer(TimServer &&) = delete;
+        TimServer &operator=(TimServer &&) = delete;
+
+        ~TimServer() { net_.timers().cancel(refresh_timer_); }
 
         Result<void> initialize() {
             if (!cf_) {
@@ -119,14 +215,20 @@ namespace agrobus::isobus {
         // ─── PTO control ─────────────────────────────────────────────────────────
         Result<void> set_front_pto(bool engaged, bool cw, u16 speed) {
             echo::category("isobus.protocol.tim").debug("front PTO: engaged=", engaged, " speed=", speed);
-            front_pto_ = {engaged, cw, speed};
+            PTOState next{engaged, cw, speed};
+            if (!same(front_pto_, next))
+                dirty_ |= FRONT_PTO;
+            front_pto_ = next;
             on_front_pto_changed.emit(front_pto_);
             return {};
         }
 
         Result<void> set_rear_pto(bool engaged, bool cw, u16 speed) {
             echo::category("isobus.protocol.tim").debug("rear PTO: engaged=", engaged, " speed=", speed);
-            rear_pto_ = {engaged, cw, speed};
+            PTOState next{engaged, cw, speed};
+            if (!same(rear_pto_, next))
+                dirty_ |= REAR_PTO;
+            rear_pto_ = next;
             on_rear_pto_changed.emit(rear_pto_);
             return {};
         }
@@ -136,13 +238,19 @@ namespace agrobus::isobus {
 
         // ─── Hitch control ───────────────────────────────────────────────────────
         Result<void> set_front_hitch(bool motion, u16 position) {
-            front_hitch_ = {motion, position};
+            HitchState next{motion, position};
+            if (!same(front_hitch_, next))
+                dirty_ |= FRONT_HITCH;
+            front_hitch_ = next;
             on_front_hitch_changed.emit(front_hitch_);
             return {};
         }
 
         Result<void> set_rear_hitch(bool motion, u16 position) {
-            rear_hitch_ = {motion, position};
+            HitchState next{motion, position};
+            if (!same(rear_hitch_, next))
+                dirty_ |= REAR_HITCH;
+            rear_hitch_ = next;
             on_rear_hitch_changed.emit(rear_hitch_);
             return {};
         }
@@ -155,25 +263,51 @@ namespace agrobus::isobus {
             if (index >= MAX_AUX_VALVES) {
                 return Result<void>::err(Error::invalid_state("valve index out of range"));
             }
-            aux_valves_[index].state = state;
-            aux_valves_[index].flow = flow;
-            on_aux_valve_changed.emit(index, aux_valves_[index]);
+            if (aux_valves_.set(index, state, flow))
+                valves_dirty_ |= AuxValveBank::bit(index);
+            valves_in_use_ |= AuxValveBank::bit(index);
+            on_aux_valve_changed.emit(index, aux_valves_.valve(index));
             return {};
         }
 
+        // Every valve at once; on_aux_valve_changed fires for the valves that changed
+        void set_aux_valves(const AuxValveBank &bank) {
+            u32 changed = bank.diff(aux_valves_);
+            aux_valves_.state = bank.state;
+            aux_valves_.flow = bank.flow;
+            valves_dirty_ |= changed;
+            valves_in_use_ |= changed;
+            for (u8 i = 0; i < MAX_AUX_VALVES && changed != 0; ++i) {
+                if (!(changed & AuxValveBank::bit(i)))
+                    continue;
+                changed &= ~AuxValveBank::bit(i);
+                on_aux_valve_changed.emit(i, aux_valves_.valve(i));
+            }
+        }
+
         void set_aux_valve_capabilities(u8 index, bool state_supported, bool flow_supported) {
             if (index < MAX_AUX_VALVES) {
-                aux_valves_[index].state_supported = state_supported;
-                aux_valves_[index].flow_supported = flow_supported;
+                u32 b = AuxValveBank::bit(index);
+                aux_valves_.state_supported = state_supported ? (aux_valves_.state_supported | b)
+                                                              : (aux_valves_.state_supported & ~b);
+                aux_valves_.flow_supported = flow_supported ? (aux_valves_.flow_supported | b)
+                                                            : (aux_valves_.flow_supported & ~b);
+                if (state_supported || flow_supported)
+                    valves_in_use_ |= b;
             }
         }
 
         AuxValve get_aux_valve(u8 index) const {
             if (index >= MAX_AUX_VALVES)
                 return {};
-            return aux_valves_[index];
+            return aux_valves_.valve(index);
         }
 
+        const AuxValveBank &aux_valves() const noexcept { return aux_valves_; }
+
+        // Status frames sent since construction
+        u64 frames_sent() const noexcept { return frames_sent_; }
+
         // ─── Events ──────────────────────────────────────────────────────────────
         Event<const PTOState &> on_front_pto_changed;
         Event<const PTOState &> on_rear_pto_changed;
@@ -182,60 +316,90 @@ namespace agrobus::isobus {
         Event<u8, const AuxValve &> on_aux_valve_changed;
 
         // ─── Update loop ─────────────────────────────────────────────────────────
-        void update(u32 elapsed_ms) {
-            timer_ms_ += elapsed_ms;
-            if (timer_ms_ >= config_.update_interval_ms) {
-                timer_ms_ -= config_.update_interval_ms;
-                send_pto_status();
-                send_hitch_status();
-            }
-        }
+        void update(u32 /*elapsed_ms*/) { send(dirty_, valves_dirty_); }
 
       private:
-        void send_pto_status() {
+        // Send the given items and valves; whatever was waiting is covered
+        void send(u8 items, u32 valves) {
+            items |= dirty_;
+            valves |= valves_dirty_;
+            dirty_ = 0;
+            valves_dirty_ = 0;
+            if (items & (FRONT_PTO | REAR_PTO))
+                send_pto_status(items);
+            if (items & (FRONT_HITCH | REAR_HITCH))
+                send_hitch_status(items);
+            if (valves != 0)
+                send_valve_status(valves);
+        }
+
+        static bool same(const PTOState &a, const PTOState &b) noexcept {
+            return a.engaged == b.engaged && a.cw_direction == b.cw_direction && a.speed == b.speed;
+        }
+        static bool same(const HitchState &a, const HitchState &b) noexcept {
+            return a.motion_enabled == b.motion_enabled && a.position == b.position;
+        }
+
+        void send_status(PGN pgn, const dp::Vector<u8> &data) {
+            if (net_.send(pgn, data, cf_, nullptr, Priority::Default).is_ok())
+                ++frames_sent_;
+        }
+
+        void send_pto_status(u8 items) {
             echo::category("isobus.protocol.tim").trace("sending PTO status");
             // Front PTO
-            {
+            if ((items & FRONT_PTO) && config_.enable_front_pto) {
                 dp::Vector<u8> data(8, 0xFF);
                 data[0] = front_pto_.engaged ? 0x01 : 0x00;
                 data[1] = front_pto_.cw_direction ? 0x01 : 0x00;
                 data[2] = static_cast<u8>(front_pto_.speed & 0xFF);
                 data[3] = static_cast<u8>((front_pto_.speed >> 8) & 0xFF);
-                net_.send(PGN_FRONT_PTO, data, cf_, nullptr, Priority::Default);
+                send_status(PGN_FRONT_PTO, data);
             }
             // Rear PTO
-            {
+            if ((items & REAR_PTO) && config_.enable_rear_pto) {
                 dp::Vector<u8> data(8, 0xFF);
                 data[0] = rear_pto_.engaged ? 0x01 : 0x00;
                 data[1] = rear_pto_.cw_direction ? 0x01 : 0x00;
                 data[2] = static_cast<u8>(rear_pto_.speed & 0xFF);
                 data[3] = static_cast<u8>((rear_pto_.speed >> 8) & 0xFF);
-                net_.send(PGN_REAR_PTO, data, cf_, nullptr, Priority::Default);
+                send_status(PGN_REAR_PTO, data);
             }
         }
 
-        void send_hitch_status() {
+        void send_hitch_status(u8 items) {
             echo::category("isobus.protocol.tim").trace("sending hitch status");
             // Front hitch
-            {
+            if ((items & FRONT_HITCH) && config_.enable_front_hitch) {
                 dp::Vector<u8> data(8, 0xFF);
                 data[0] = front_hitch_.motion_enabled ? 0x01 : 0x00;
                 data[1] = static_cast<u8>(front_hitch_.position & 0xFF);
                 data[2] = static_cast<u8>((front_hitch_.position >> 8) & 0xFF);
-                net_.send(PGN_FRONT_HITCH, data, cf_, nullptr, Priority::Default);
+                send_status(PGN_FRONT_HITCH, data);
             }
             // Rear hitch
-            {
+            if ((items & REAR_HITCH) && config_.enable_rear_hitch) {
                 dp::Vector<u8> data(8, 0xFF);
                 data[0] = rear_hitch_.motion_enabled ? 0x01 : 0x00;
                 data[1] = static_cast<u8>(rear_hitch_.position & 0xFF);
                 data[2] = static_cast<u8>((rear_hitch_.position >> 8) & 0xFF);
-                net_.send(PGN_REAR_HITCH, data, cf_, nullptr, Priority::Default);
+                send_status(PGN_REAR_HITCH, data);
             }
         }
+
+        void send_valve_status(u32 valves) {
+            echo::category("isobus.protocol.tim").trace("sending aux valve status");
+            detail::send_aux_valve_records(aux_valves_, valves, [this](const dp::Vector<u8> &data) {
+                send_status(PGN_AUX_VALVE_ESTIMATED_FLOW_BASE, data);
+            });
+        }
     };
 
     // ─── TIM Client (Implement ECU side) ─────────────────────────────────────────
+    // Valve requests can be batched: stage the wanted state of any number of
+    // valves during a control tick, then apply_aux_valves() sends only the
+    // valves that differ from what was last requested, two to a frame. Twelve
+    // valves with three moving cost two frames, with none moving nothing.
     class TimClient {
         IsoNet &net_;
         InternalCF *cf_;
@@ -245,7 +409,12 @@ namespace agrobus::isobus {
         PTOState rear_pto_;
         HitchState front_hitch_;
         HitchState rear_hitch_;
-        dp::Array<AuxValve, MAX_AUX_VALVES> aux_valves_{};
+        AuxValveBank aux_valves_; // As reported by the server
+        AuxValveBank wanted_;     // Staged by the application
+        AuxValveBank requested_;  // Last sent to the server
+        u32 staged_ = 0;          // Valves in wanted_
+        u32 requested_mask_ = 0;  // Valves requested at least once
+        u64 request_frames_ = 0;
 
       public:
         TimClient(IsoNet &net, InternalCF *cf, ControlFunction *tractor = nullptr)
@@ -259,6 +428,8 @@ namespace agrobus::isobus {
             net_.register_pgn_callback(PGN_REAR_PTO, [this](const Message &msg) { handle_rear_pto(msg); });
             net_.register_pgn_callback(PGN_FRONT_HITCH, [this](const Message &msg) { handle_front_hitch(msg); });
             net_.register_pgn_callback(PGN_REAR_HITCH, [this](const Message &msg) { handle_rear_hitch(msg); });
+            net_.register_pgn_view_callback(PGN_AUX_VALVE_ESTIMATED_FLOW_BASE,
+                                            [this](const MessageView &msg) { handle_aux_valves(msg.data); });
             echo::category("isobus.protocol.tim").info("TIM Client initialized");
             return {};
         }
@@ -273,8 +444,9 @@ namespace agrobus::isobus {
         AuxValve get_aux_valve(u8 index) const {
             if (index >= MAX_AUX_VALVES)
                 return {};
-            return aux_valves_[index];
+            return aux_valves_.valve(index);
         }
+        const AuxValveBank &aux_valves() const noexcept { return aux_valves_; }
 
         // ─── Request changes ─────────────────────────────────────────────────────
         Result<void> request_front_pto(bool engaged, bool cw, u16 speed) {
@@ -323,6 +495,53 @@ namespace agrobus::isobus {
             return net_.send(PGN_AUX_VALVE_0_7, data, cf_, tractor_server_, Priority::Default);
         }
 
+        // ─── Batched valve requests ──────────────────────────────────────────────
+        Result<void> stage_aux_valve(u8 index, bool state, u16 flow) {
+            if (index >= MAX_AUX_VALVES)
+                return Result<void>::err(Error::invalid_state("valve index out of range"));
+            wanted_.set(index, state, flow);
+            staged_ |= AuxValveBank::bit(index);
+            return {};
+        }
+
+        // Stage the valves in `mask` from `bank`
+        void stage_aux_valves(const AuxValveBank &bank, u32 mask) {
+            wanted_.state = (wanted_.state & ~mask) | (bank.state & mask);
+            for (u8 i = 0; i < MAX_AUX_VALVES; ++i)
+                if (mask & AuxValveBank::bit(i))
+                    wanted_.flow[i] = bank.flow[i];
+            staged_ |= mask;
+        }
+
+        // Send the staged valves that changed since the last request (or were
+        // never requested) in as few frames as possible. Valves whose frame
+        // failed are sent again on the next call.
+        Result<void> apply_aux_valves() {
+            u32 pending = (wanted_.diff(requested_) | ~requested_mask_) & staged_;
+            if (pending == 0)
+                return {};
+            Result<void> result;
+            detail::send_aux_valve_records(wanted_, pending, [&](const dp::Vector<u8> &data) {
+                auto sent = net_.send(PGN_AUX_VALVE_0_7, data, cf_, tractor_server_, Priority::Default);
+                if (sent.is_err()) {
+                    result = sent;
+                    return;
+                }
+                ++request_frames_;
+                for (u8 slot = 0; slot < AUX_VALVE_RECORDS_PER_FRAME; ++slot) {
+                    u8 index = data[slot * 4];
+                    if (index >= MAX_AUX_VALVES)
+                        continue;
+                    requested_.set(index, wanted_.get_state(index), wanted_.flow[index]);
+                    requested_mask_ |= AuxValveBank::bit(index);
+                }
+            });
+            return result;
+        }
+
+        // Valve request frames sent by apply_aux_valves()
+        u64 request_frames() const noexcept { return request_frames_; }
+
         // ─── Events ──────────────────────────────────────────────────────────────
         Event<const PTOState &> on_front_pto_updated;
         Event<const PTOState &> on_rear_pto_updated;
@@ -333,6 +552,18 @@ namespace agrobus::isobus {
         void update(u32 /*elapsed_ms*/) {}
 
       private:
+        // Valve status records from the server, two per frame
+        void handle_aux_valves(DataSpan data) {
+            for (usize off = 0; off + 4 <= data.size() && off < AUX_VALVE_RECORDS_PER_FRAME * 4; off += 4) {
+                u8 index = data[off];
+                if (index >= MAX_AUX_VALVES)
+                    continue;
+                u16 flow = static_cast<u16>(data[off + 2]) | (static_cast<u16>(data[off + 3]) << 8);
+                aux_valves_.set(index, (data[off + 1] & 0x01) != 0, flow);
+                on_aux_valve_updated.emit(index, aux_valves_.valve(index));
+            }
+        }
+
         void handle_front_pto(const Message &msg) {
             echo::category("isobus.protocol.tim").trace("front PTO update received");
             if (msg.data.size() < 4)
@@ -0,0 +1,94 @@
+#pragma once
+
+#include "commands.hpp"
+#include "objects.hpp"
+#include <agrobus/net/delegate.hpp>
+#include <agrobus/net/types.hpp>
+#include <datapod/datapod.hpp>
+
+namespace agrobus::isobus::vt {
+    using namespace agrobus::net;
+
+    // ─── Activation code filters ─────────────────────────────────────────────────
+    // One bit per ActivationCode, combined with |
+    namespace activation {
+        inline constexpr u8 RELEASED = 1u << static_cast<u8>(ActivationCode::Released);
+        inline constexpr u8 PRESSED = 1u << static_cast<u8>(ActivationCode::Pressed);
+        inline constexpr u8 HELD = 1u << static_cast<u8>(ActivationCode::Held);
+        inline constexpr u8 ABORTED = 1u << static_cast<u8>(ActivationCode::Aborted);
+        inline constexpr u8 ANY = RELEASED | PRESSED | HELD | ABORTED;
+    } // namespace activation
+
+    // ─── Per-object activation handlers ──────────────────────────────────────────
+    // Soft Key or Button handlers by object ID: the ID goes through an
+    // ObjectIndex (paged by the high byte) to a dense handler array, so an
+    // activation reaches its one handler in O(1), whatever the number of keys.
+    // Each handler has a filter of the activation codes it wants, and may
+    // bind or unbind handlers itself.
+    class ActivationTable {
+      public:
+        using Handler = Delegate<void(ActivationCode)>;
+
+      private:
+        struct Entry {
+            Handler fn;
+            u8 codes = 0;
+        };
+
+        ObjectIndex slots_; // Object ID -> index into entries_
+        dp::Vector<Entry> entries_;
+        usize bound_ = 0;
+
+      public:
+        // Replaces the object's handler if it has one
+        void bind(ObjectID id, Handler fn, u8 codes = activation::ANY) {
+            u32 slot = slots_.find(id);
+            if (slot == ObjectIndex::NONE) {
+                slot = static_cast<u32>(entries_.size());
+                slots_.insert(id, slot);
+                entries_.push_back({});
+            }
+            if (!entries_[slot].fn)
+                ++bound_;
+            entries_[slot] = Entry{std::move(fn), codes};
+        }
+
+        // The slot stays, empty, for a later bind()
+        bool unbind(ObjectID id) {
+            u32 slot = slots_.find(id);
+            if (slot == ObjectIndex::NONE || !entries_[slot].fn)
+                return false;
+            entries_[slot] = {};
+            --bound_;
+            return true;
+        }
+
+        // True if a handler took the activation
+        bool dispatch(ObjectID id, ActivationCode code) {
+            u32 slot = slots_.find(id);
+            if (slot == ObjectIndex::NONE)
+                return false;
+            auto &e = entries_[slot];
+            if (!e.fn || (e.codes & (1u << static_cast<u8>(code))) == 0)
+                return false;
+            Handler fn = e.fn; // The handler may bind others, moving the entries
+            fn(code);
+            return true;
+        }
+
+        bool bound(ObjectID id) const noexcept {
+            u32 slot = slots_.find(id);
+            return slot != ObjectIndex::NONE && static_cast<bool>(entries_[slot].fn);
+        }
+
+        usize size() const noexcept { return bound_; }
+        bool empty() const noexcept { return bound_ == 0; }
+
+        void clear() {
+            slots_.clear();
+            entries_.clear();
+            bound_ = 0;
+        }
+    };
+
+} // namespace agrobus::isobus::vt
@@ -19,7 +19,7 @@ namespace agrobus::isobus::vt {
         u16 resolution = 0;   // Steps for analog channels
         u8 function_type = 0; // Channel function type
 
-        static AuxChannelCapability decode(const dp::Vector<u8> &data, usize offset) {
+        static AuxChannelCapability decode(DataSpan data, usize offset) {
             AuxChannelCapability cap;
             if (offset + 5 <= data.size()) {
                 cap.channel_id = data[offset];
@@ -43,9 +43,35 @@ namespace agrobus::isobus::vt {
 
     // ─── Aggregated auxiliary capabilities ───────────────────────────────────────
     struct AuxCapabilities {
+        static constexpr u16 NO_CHANNEL = 0xFFFF;
+
         dp::Vector<AuxChannelCapability> channels;
+        dp::Array<u16, 256> channel_slot = filled(); // Channel ID -> index into channels
         u8 vt_version = 0;
         bool discovery_complete = false;
+
+        // O(1) by channel ID; nullptr if the VT did not report it
+        const AuxChannelCapability *channel(u8 id) const noexcept {
+            u16 i = channel_slot[id];
+            return i != NO_CHANNEL ? &channels[i] : nullptr;
+        }
+
+        void add(const AuxChannelCapability &cap) {
+            channel_slot[cap.channel_id] = static_cast<u16>(channels.size());
+            channels.push_back(cap);
+        }
+
+        void clear() {
+            channels.clear();
+            channel_slot = filled();
+        }
+
+      private:
+        static dp::Array<u16, 256> filled() noexcept {
+            dp::Array<u16, 256> a;
+            a.fill(NO_CHANNEL);
+            return a;
+        }
     };
 
     // ─── Auxiliary Capability Discovery (VT v5) ──────────────────────────────────
@@ -94,13 +120,12 @@ namespace agrobus::isobus::vt {
             // Parse capabilities response
             // Format: [cmd][sub_func][num_channels][channel_data...]
             u8 num_channels = msg.data[2];
-            caps_.channels.clear();
+            caps_.clear();
             caps_.vt_version = 5; // If responding to this, VT is at least v5
 
             usize offset = 3;
             for (u8 i = 0; i < num_channels && offset + 5 <= msg.data.size(); ++i) {
-                auto cap = AuxChannelCapability::decode(msg.data, offset);
-                caps_.channels.push_back(cap);
+                caps_.add(AuxChannelCapability::decode(msg.data, offset));
                 offset += 5;
             }
 
@@ -0,0 +1,131 @@
+#pragma once
+
+#include "objects.hpp"
+#include "pool_image.hpp"
+#include <agrobus/net/types.hpp>
+#include <datapod/datapod.hpp>
+
+namespace agrobus::isobus::vt {
+    using namespace agrobus::net;
+
+    // ─── Changes of one frame ────────────────────────────────────────────────────
+    struct VTChangeSet {
+        dp::Vector<ObjectID> changed;  // Objects whose value or attributes changed, in the order first changed
+        dp::Vector<ObjectID> affected; // `changed` and every object above them: containers, masks, the working set
+        bool full_redraw = false;      // The pool itself changed: redraw everything
+
+        bool empty() const noexcept { return !full_redraw && changed.empty(); }
+
+        bool affects(ObjectID id) const noexcept {
+            for (auto a : affected) {
+                if (a == id)
+                    return true;
+            }
+            return false;
+        }
+    };
+
+    // ─── Change journal for VT rendering ─────────────────────────────────────────
+    // Collects the objects a working set changed since the renderer last drew.
+    // take() closes the frame: it returns the set and starts an empty one. Each
+    // changed object is propagated up the parent chain through a reverse
+    // children index built once per pool (set_pool()), so a renderer redraws
+    // the masks and containers holding a changed object, not the whole active
+    // data mask.
+    //
+    // Uploaded pools keep opaque bodies (see PoolImage), so without children
+    // lists `affected` only holds the changed objects. A renderer that decodes
+    // the pool can hand its ObjectPool to set_pool() instead.
+    class VTChangeJournal {
+        static constexpr usize WORDS = 0x10000 / 64;
+
+        ParentIndex parents_;
+        dp::Vector<ObjectID> changed_;
+        dp::Vector<u64> marked_; // One bit per object ID, for changed_; allocated on first mark
+        dp::Vector<u64> seen_;   // Scratch for take(), all clear between calls
+        bool full_redraw_ = false;
+
+      public:
+        // A new pool: rebuild the index, the next frame redraws everything
+        void set_pool(const PoolImage &pool) {
+            reset(pool.build_parent_index());
+            full_redraw_ = true;
+        }
+        void set_pool(const ObjectPool &pool) {
+            reset(pool.build_parent_index());
+            full_redraw_ = true;
+        }
+
+        // `pool` is the previous one with the objects of `patch` replaced or added
+        // (a later Object Pool Transfer): only those are redrawn
+        void patch_pool(const PoolImage &pool, const PoolImage &patch) {
+            bool full = full_redraw_;
+            reset(pool.build_parent_index());
+            full_redraw_ = full;
+            patch.for_each([this](const ObjectView &obj) { mark(obj.id); });
+        }
+
+        void mark(ObjectID id) {
+            if (marked_.empty())
+                marked_.resize(WORDS, 0);
+            if (test_and_set(marked_, id))
+                return;
+            changed_.push_back(id);
+        }
+
+        void mark_all() noexcept { full_redraw_ = true; }
+
+        bool pending() const noexcept { return full_redraw_ || !changed_.empty(); }
+        usize size() const noexcept { return changed_.size(); }
+
+        // The changes since the last take(), parents resolved
+        VTChangeSet take() {
+            VTChangeSet set;
+            set.full_redraw = full_redraw_;
+            if (!changed_.empty()) {
+                if (seen_.empty())
+                    seen_.resize(WORDS, 0);
+                set.affected = changed_; // Distinct already
+                for (auto id : changed_)
+                    test_and_set(seen_, id);
+                // Breadth-first up the parents; `affected` doubles as the queue
+                for (usize i = 0; i < set.affected.size(); ++i) {
+                    for (auto parent : parents_.parents(set.affected[i])) {
+                        if (!test_and_set(seen_, parent))
+                            set.affected.push_back(parent);
+                    }
+                }
+                clear_bits(seen_, set.affected);
+                clear_bits(marked_, changed_);
+                set.changed = std::move(changed_);
+                changed_.clear();
+            }
+            full_redraw_ = false;
+            return set;
+        }
+
+        const ParentIndex &parent_index() const noexcept { return parents_; }
+
+      private:
+        void reset(ParentIndex parents) {
+            parents_ = std::move(parents);
+            clear_bits(marked_, changed_);
+            changed_.clear();
+        }
+
+        static void clear_bits(dp::Vector<u64> &bits, const dp::Vector<ObjectID> &ids) noexcept {
+            for (auto id : ids)
+                bits[id / 64] &= ~(u64(1) << (id % 64));
+        }
+
+        // True if the bit was already set
+        static bool test_and_set(dp::Vector<u64> &bits, ObjectID id) noexcept {
+            u64 &word = bits[id / 64];
+            u64 bit = u64(1) << (id % 64);
+            bool was = (word & bit) != 0;
+            word |= bit;
+            return was;
+        }
+    };
+
+} // namespace agrobus::isobus::vt
@@ -1,15 +1,23 @@
 #pragma once
 
+#include "activation_table.hpp"
+#include "command_queue.hpp"
 #include "commands.hpp"
+#include "language_pools.hpp"
+#include "macro_table.hpp"
 #include "objects.hpp"
+#include "pool_scaler.hpp"
+#include "static_pool.hpp"
 #include "working_set.hpp"
 #include <agrobus/net/constants.hpp>
 #include <agrobus/net/error.hpp>
 #include <agrobus/net/event.hpp>
 #include <agrobus/net/internal_cf.hpp>
+#include <agrobus/net/iop_parser.hpp>
 #include <agrobus/net/message.hpp>
 #include <agrobus/net/network_manager.hpp>
 #include <agrobus/net/state_machine.hpp>
+#include <agrobus/net/working_set.hpp>
 #include <datapod/datapod.hpp>
 #include <echo/echo.hpp>
 
@@ -21,6 +29,8 @@ namespace agrobus::isobus::vt {
         Disconnected,
         WaitForVTStatus,
         SendWorkingSetMaster,
+        WaitForGeometry,    // Scaling: Get Hardware and Get Number of Soft Keys sent
+        WaitForVersionLoad, // Version-first connect: Load Version sent, upload only if it fails
         SendGetMemory,
         WaitForMemory,
         UploadPool,
@@ -28,6 +38,7 @@ namespace agrobus::isobus::vt {
         WaitForPoolActivate,
         Connected
     };
+    constexpr usize state_count(VTState) { return static_cast<usize>(VTState::Connected) + 1; }
 
     // ─── VT Version ─────────────────────────────────────────────────────────────
     enum class VTVersion : u8 { Version3 = 3, Version4 = 4, Version5 = 5 };
@@ -36,6 +47,23 @@ namespace agrobus::isobus::vt {
     struct VTClientConfig {
         u32 timeout_ms = 6000;
         VTVersion preferred_version = VTVersion::Version4;
+        // Version-first connect: ask the VT to load the pool stored under
+        // `version_label` and upload only when it can't, then store the
+        // uploaded pool under that label for the next key cycle. An empty
+        // label is derived from the pool content (IOPParser::hash_to_version
+        // of the serialized pool); pass IOPParser::file_version() of the IOP
+        // to keep hashing off the connect path.
+        bool version_first = false;
+        dp::String version_label;
+        // Flow-controlled commands: object commands (hide/show, value, attribute,
+        // mask changes...) go through a VTCommandQueue that waits for the VT's
+        // responses instead of going on the bus the moment they are called
+        bool pipelined_commands = false;
+        VTCommandQueueConfig command_queue;
+        // Scale the pool (drawn for `design_geometry`) to the data mask and
+        // soft key size the VT reports before each upload; see ScaledPoolCache
+        bool scale_to_vt = false;
+        VTGeometry design_geometry;
 
         VTClientConfig &timeout(u32 ms) {
             timeout_ms = ms;
@@ -45,6 +73,21 @@ namespace agrobus::isobus::vt {
             preferred_version = v;
             return *this;
         }
+        VTClientConfig &stored_version(dp::String label = {}) {
+            version_first = true;
+            version_label = std::move(label);
+            return *this;
+        }
+        VTClientConfig &pipelined(VTCommandQueueConfig queue = {}) {
+            pipelined_commands = true;
+            command_queue = queue;
+            return *this;
+        }
+        VTClientConfig &scale_from(VTGeometry design) {
+            scale_to_vt = true;
+            design_geometry = design;
+            return *this;
+        }
     };
 
     // ─── VT Client ───────────────────────────────────────────────────────────────
@@ -54,29 +97,70 @@ namespace agrobus::isobus::vt {
         VTClientConfig config_;
         StateMachine<VTState> state_{VTState::Disconnected};
         ObjectPool pool_;
+        DataSpan rom_pool_;    // Serialized StaticPool in flash, in place of pool_
+        dp::String rom_label_; // Its compile-time version label
+        VTGeometry vt_geometry_;
+        u8 geometry_replies_ = 0;                  // GEOMETRY_* bits of the answers in
+        std::shared_ptr<const ScaledPool> scaled_; // pool_ scaled for this VT, when it differs
+        ScaledPoolCache *scaled_cache_ = nullptr;
+        dp::Optional<u64> pool_hash_; // Content hash of pool_, the cache key, until pool_ changes
         WorkingSet working_set_;
+        WorkingSetManager *announcer_ = nullptr;
         u32 timer_ms_ = 0;
         u8 vt_address_ = NULL_ADDRESS;
         u16 vt_version_ = 0;
         dp::String extended_version_label_;
         bool vt_supports_extended_versions_ = false;
         bool is_active_ws_ = false;
+        dp::String pool_label_;          // Label the version-first connect loads and stores
+        bool pool_from_version_ = false; // Last connect was served by Load Version
+        bool uploading_ = false;         // Object Pool Transfer still in flight
+        VTCommandQueue commands_;
 
       public:
-        VTClient(IsoNet &net, InternalCF *cf, VTClientConfig config = {}) : net_(net), cf_(cf), config_(config) {}
+        VTClient(IsoNet &net, InternalCF *cf, VTClientConfig config = {})
+            : net_(net), cf_(cf), config_(config), commands_(config.command_queue) {}
 
-        void set_object_pool(ObjectPool pool) { pool_ = std::move(pool); }
+        void set_object_pool(ObjectPool pool) {
+            pool_ = std::move(pool);
+            pool_hash_.reset();
+            rom_pool_ = {};
+        }
+        // A pool fixed at build time: uploaded straight from its bytes, nothing
+        // is built or serialized, and its label is the one stamped at compile
+        // time. `pool` must outlive the client (a constexpr pool in flash does).
+        template <usize Bytes, usize Objects> void set_object_pool(const StaticPool<Bytes, Objects> &pool) {
+            pool_.clear();
+            rom_pool_ = pool.bytes();
+            rom_label_ = pool.version_label();
+        }
+        // The pool of one language (see LanguagePools); a later language goes through update_pool()
+        void set_object_pool(const LanguagePools &pools, const dp::String &language) {
+            pool_ = pools.compose(language);
+            pool_hash_.reset();
+            rom_pool_ = {};
+        }
         void set_working_set(WorkingSet ws) { working_set_ = std::move(ws); }
+        // Announce through a manager shared with the TC and file clients instead of a master message of our own
+        void set_working_set_manager(WorkingSetManager *manager) { announcer_ = manager; }
+        // With VTClientConfig::scale_from(): keep scaled pools here, across
+        // connects and clients, instead of scaling on every connect
+        void set_scaled_pool_cache(ScaledPoolCache *cache) { scaled_cache_ = cache; }
 
         // ─── Active Working Set status ────────────────────────────────────────────
         bool is_active_ws() const noexcept { return is_active_ws_; }
 
         Result<void> connect() {
-            if (pool_.empty()) {
+            if (pool_.empty() && rom_pool_.empty()) {
                 return Result<void>::err(Error::invalid_state("object pool is empty"));
             }
             state_.transition(VTState::WaitForVTStatus);
             timer_ms_ = 0;
+            pool_from_version_ = false;
+            scaled_.reset();
+            commands_.clear();
+            if (config_.version_first)
+                refresh_pool_label();
 
             net_.register_pgn_callback(PGN_VT_TO_ECU, [this](const Message &msg) { handle_vt_message(msg); });
 
@@ -86,13 +170,80 @@ namespace agrobus::isobus::vt {
 
         Result<void> disconnect() {
             state_.transition(VTState::Disconnected);
+            commands_.clear();
             echo::category("isobus.vt.client").info("VT client disconnected");
             return {};
         }
 
         VTState state() const noexcept { return state_.state(); }
+        // Time per state and transition counts, e.g. how long connect waited on the VT
+        const StateMachine<VTState> &state_machine() const noexcept { return state_; }
+
+        // ─── Pool updates ────────────────────────────────────────────────────────
+        // Bring the VT from the current pool to `newer` without a full upload.
+        // Value-only changes of Number/String Variables go out as Change
+        // Numeric/String Value; every other changed or added object goes in one
+        // partial Object Pool Transfer followed by End of Object Pool, answered
+        // like after a full upload (WaitForPoolActivate, then Connected).
+        // Removed objects stay on the VT, unreferenced. When not connected the
+        // pool is only replaced. Returns the diff that was applied. A static
+        // pool is decoded into an ObjectPool first, to diff against; with a
+        // scaled pool the objects transferred are the rescaled ones.
+        Result<PoolDiff> update_pool(ObjectPool newer) {
+            if (newer.empty())
+                return Result<PoolDiff>::err(Error::invalid_state("object pool is empty"));
+            if (!rom_pool_.empty()) {
+                auto current = ObjectPool::deserialize(dp::Vector<u8>(rom_pool_.begin(), rom_pool_.end()));
+                if (!current.is_ok())
+                    return Result<PoolDiff>::err(current.error());
+                pool_ = std::move(current.value());
+                rom_pool_ = {};
+            }
+            PoolDiff diff = pool_.diff(newer);
+            if (state_.state() != VTState::Connected) {
+                pool_ = std::move(newer);
+                pool_hash_.reset();
+                return Result<PoolDiff>::ok(std::move(diff));
+            }
+
+            dp::Vector<ObjectID> transfer;
+            for (auto id : diff.changed) {
+                if (!send_value_change(**pool_.find(id), **newer.find(id)))
+                    transfer.push_back(id);
+            }
+            transfer.insert(transfer.end(), diff.added.begin(), diff.added.end());
+            pool_ = std::move(newer);
+            pool_hash_.reset();
+            if (scaled_)
+                prepare_scaled_pool();
+            if (config_.version_first)
+                refresh_pool_label();
+
+            echo::category("isobus.vt.client")
+                .info("Pool update: ", diff.changed.size(), " changed, ", diff.added.size(), " added, ",
+                      diff.removed.size(), " removed, ", transfer.size(), " transferred");
+            if (!transfer.empty() && scaled_)
+                upload_objects(ObjectPool::deserialize(scaled_->bytes).value().subset(transfer));
+            else if (!transfer.empty())
+                upload_objects(pool_.subset(transfer));
+            else if (config_.version_first && !diff.empty())
+                store_version(pool_label_);
+            return Result<PoolDiff>::ok(std::move(diff));
+        }
+
+        // Version label of the version-first connect, and whether the VT had it
+        const dp::String &pool_version_label() const noexcept { return pool_label_; }
+        bool pool_from_version() const noexcept { return pool_from_version_; }
+
+        // Data mask and soft key size the VT reported, and whether the pool
+        // had to be scaled to them (scale_from() only)
+        const VTGeometry &vt_geometry() const noexcept { return vt_geometry_; }
+        bool pool_scaled() const noexcept { return scaled_ != nullptr; }
 
         // ─── VT Commands ─────────────────────────────────────────────────────────
+        // With VTClientConfig::pipelined() these queue the command and return
+        // ok; a full queue is a buffer overflow, a command the VT never answers
+        // is reported through on_command_timeout.
         Result<void> hide_show(ObjectID id, bool visible) {
             if (state_.state() != VTState::Connected)
                 return Result<void>::err(Error::not_connected());
@@ -102,7 +253,7 @@ namespace agrobus::isobus::vt {
             data[1] = static_cast<u8>(id & 0xFF);
             data[2] = static_cast<u8>((id >> 8) & 0xFF);
             data[3] = visible ? 1 : 0;
-            return net_.send(PGN_ECU_TO_VT, data, cf_);
+            return send_command(std::move(data));
         }
 
         Result<void> enable_disable(ObjectID id, bool enabled) {
@@ -113,7 +264,7 @@ namespace agrobus::isobus::vt {
             data[1] = static_cast<u8>(id & 0xFF);
             data[2] = static_cast<u8>((id >> 8) & 0xFF);
             data[3] = enabled ? 1 : 0;
-            return net_.send(PGN_ECU_TO_VT, data, cf_);
+            return send_command(std::move(data));
         }
 
         Result<void> change_numeric_value(ObjectID id, u32 value) {
@@ -128,7 +279,7 @@ namespace agrobus::isobus::vt {
             data[5] = static_cast<u8>((value >> 8) & 0xFF);
             data[6] = static_cast<u8>((value >> 16) & 0xFF);
             data[7] = static_cast<u8>((value >> 24) & 0xFF);
-            return net_.send(PGN_ECU_TO_VT, data, cf_);
+            return send_command(std::move(data));
         }
 
         Result<void> change_string_value(ObjectID id, dp::String value) {
@@ -145,7 +296,7 @@ namespace agrobus::isobus::vt {
                 data.push_back(static_cast<u8>(c));
             while (data.size() < 8)
                 data.push_back(0xFF);
-            return net_.send(PGN_ECU_TO_VT, data, cf_);
+            return send_command(std::move(data));
         }
 
         Result<void> change_active_mask(ObjectID working_set_id, ObjectID mask_id) {
@@ -157,13 +308,18 @@ namespace agrobus::isobus::vt {
             data[2] = static_cast<u8>((working_set_id >> 8) & 0xFF);
             data[3] = static_cast<u8>(mask_id & 0xFF);
             data[4] = static_cast<u8>((mask_id >> 8) & 0xFF);
-            return net_.send(PGN_ECU_TO_VT, data, cf_);
+            return send_command(std::move(data));
         }
 
         // ─── Macro support (ISO 11783-6 Annex J) ────────────────────────────────
         struct VTMacro {
             ObjectID macro_id = 0;
             dp::Vector<dp::Vector<u8>> commands; // Each command is a VT command byte sequence
+
+            // As a Macro object for the pool: the VT compiles it on upload and runs it without the client
+            VTObject to_object() const {
+                return VTObject().set_id(macro_id).set_type(ObjectType::Macro).set_body(macro_body(commands));
+            }
         };
 
         Result<void> execute_macro(ObjectID macro_id) {
@@ -174,7 +330,7 @@ namespace agrobus::isobus::vt {
             data[1] = static_cast<u8>(macro_id & 0xFF);
             data[2] = static_cast<u8>((macro_id >> 8) & 0xFF);
             on_macro_executed.emit(macro_id);
-            return net_.send(PGN_ECU_TO_VT, data, cf_);
+            return send_command(std::move(data));
         }
 
         Result<void> register_macro(VTMacro macro) {
@@ -209,7 +365,7 @@ namespace agrobus::isobus::vt {
             data[3] = static_cast<u8>((data_mask_id >> 8) & 0xFF);
             data[4] = static_cast<u8>(sk_mask_id & 0xFF);
             data[5] = static_cast<u8>((sk_mask_id >> 8) & 0xFF);
-            return net_.send(PGN_ECU_TO_VT, data, cf_);
+            return send_command(std::move(data));
         }
 
         Result<void> change_attribute(ObjectID id, u8 attribute_id, u32 value) {
@@ -224,7 +380,7 @@ namespace agrobus::isobus::vt {
             data[5] = static_cast<u8>((value >> 8) & 0xFF);
             data[6] = static_cast<u8>((value >> 16) & 0xFF);
             data[7] = static_cast<u8>((value >> 24) & 0xFF);
-            return net_.send(PGN_ECU_TO_VT, data, cf_);
+            return send_command(std::move(data));
         }
 
         Result<void> change_size(ObjectID id, u16 width, u16 height) {
@@ -238,7 +394,7 @@ namespace agrobus::isobus::vt {
             data[4] = static_cast<u8>((width >> 8) & 0xFF);
             data[5] = static_cast<u8>(height & 0xFF);
             data[6] = static_cast<u8>((height >> 8) & 0xFF);
-            return net_.send(PGN_ECU_TO_VT, data, cf_);
+            return send_command(std::move(data));
         }
 
         Result<void> change_child_location(ObjectID parent_id, ObjectID child_id, i16 dx, i16 dy) {
@@ -254,7 +410,7 @@ namespace agrobus::isobus::vt {
             data[6] = static_cast<u8>((static_cast<u16>(dx) >> 8) & 0xFF);
             // Note: dy sent as relative offset in byte 7 (per ISO 11783-6)
             data[7] = static_cast<u8>(static_cast<u16>(dy) & 0xFF);
-            return net_.send(PGN_ECU_TO_VT, data, cf_);
+            return send_command(std::move(data));
         }
 
         Result<void> change_background_colour(ObjectID id, u8 colour) {
@@ -265,7 +421,7 @@ namespace agrobus::isobus::vt {
             data[1] = static_cast<u8>(id & 0xFF);
             data[2] = static_cast<u8>((id >> 8) & 0xFF);
             data[3] = colour;
-            return net_.send(PGN_ECU_TO_VT, data, cf_);
+            return send_command(std::move(data));
         }
 
         Result<void> change_list_item(ObjectID list_id, u8 index, ObjectID new_item_id) {
@@ -278,7 +434,7 @@ namespace agrobus::isobus::vt {
             data[3] = index;
             data[4] = static_cast<u8>(new_item_id & 0xFF);
             data[5] = static_cast<u8>((new_item_id >> 8) & 0xFF);
-            return net_.send(PGN_ECU_TO_VT, data, cf_);
+            return send_command(std::move(data));
         }
 
         Result<void> lock_unlock_mask(ObjectID mask_id, bool lock, u16 timeout_ms = 0) {
@@ -291,7 +447,7 @@ namespace agrobus::isobus::vt {
             data[3] = static_cast<u8>((mask_id >> 8) & 0xFF);
             data[4] = static_cast<u8>(timeout_ms & 0xFF);
             data[5] = static_cast<u8>((timeout_ms >> 8) & 0xFF);
-            return net_.send(PGN_ECU_TO_VT, data, cf_);
+            return send_command(std::move(data));
         }
 
         Result<void> control_audio_signal(u8 activations, u16 frequency_hz, u16 duration_ms, u16 off_time_ms) {
@@ -306,7 +462,7 @@ namespace agrobus::isobus::vt {
             data[5] = static_cast<u8>((duration_ms >> 8) & 0xFF);
             data[6] = static_cast<u8>(off_time_ms & 0xFF);
             data[7] = static_cast<u8>((off_time_ms >> 8) & 0xFF);
-            return net_.send(PGN_ECU_TO_VT, data, cf_);
+            return send_command(std::move(data));
         }
 
         // ─── Object pool version management (ISO 11783-6 Annex F) ────────────────
@@ -327,14 +483,7 @@ namespace agrobus::isobus::vt {
 
         // Load Version: requests the VT to load a previously stored pool
         Result<void> load_version(const dp::String &version_label) {
-            dp::Vector<u8> data(8, 0xFF);
-            data[0] = vt_cmd::LOAD_POOL;
-            for (usize i = 0; i < 7; ++i) {
-                data[1 + i] = (i < version_label.size()) ? static_cast<u8>(version_label[i]) : 0x20;
-            }
-            ControlFunction vt_cf;
-            vt_cf.address = vt_address_;
-            auto result = net_.send(PGN_ECU_TO_VT, data, cf_, &vt_cf);
+            auto result = send_load_version(version_label);
             if (result.is_ok()) {
                 state_.transition(VTState::WaitForPoolActivate);
                 timer_ms_ = 0;
@@ -445,8 +594,17 @@ namespace agrobus::isobus::vt {
         void set_vt_version_preference(VTVersion version) { vt_version_ = static_cast<u16>(version); }
         u16 get_vt_version() const noexcept { return vt_version_; }
 
+        // Commands waiting for the VT (pipelined())
+        const VTCommandQueue &command_queue() const noexcept { return commands_; }
+
         void update(u32 elapsed_ms) {
+            ProfileScope profile(net_.update_profiler(), "vt_client");
             timer_ms_ += elapsed_ms;
+            state_.advance(elapsed_ms);
+            if (config_.pipelined_commands && state_.state() == VTState::Connected)
+                commands_.update(
+                    elapsed_ms, [this](const dp::Vector<u8> &data) { return send_now(data); },
+                    [this](u8 function, ObjectID object) { on_command_timeout.emit(function, object); });
 
             switch (state_.state()) {
             case VTState::WaitForVTStatus:
@@ -457,14 +615,38 @@ namespace agrobus::isobus::vt {
                 break;
 
             case VTState::SendWorkingSetMaster: {
-                dp::Vector<u8> data(8, 0xFF);
-                data[0] = 1; // Number of members
-                net_.send(PGN_WORKING_SET_MASTER, data, cf_);
-                state_.transition(VTState::SendGetMemory);
+                if (announcer_) {
+                    announcer_->announce();
+                } else {
+                    dp::Vector<u8> data(8, 0xFF);
+                    data[0] = 1; // Number of members
+                    net_.send(PGN_WORKING_SET_MASTER, data, cf_);
+                }
                 timer_ms_ = 0;
+                if (config_.scale_to_vt && rom_pool_.empty())
+                    request_geometry();
+                else
+                    load_or_upload();
                 break;
             }
 
+            case VTState::WaitForGeometry:
+                if (timer_ms_ >= config_.timeout_ms) {
+                    echo::category("isobus.vt.client").warn("No VT geometry, uploading the pool unscaled");
+                    vt_geometry_ = config_.design_geometry;
+                    timer_ms_ = 0;
+                    load_or_upload();
+                }
+                break;
+
+            case VTState::WaitForVersionLoad:
+                if (timer_ms_ >= config_.timeout_ms) {
+                    echo::category("isobus.vt.client").warn("Load Version timeout, uploading pool");
+                    state_.transition(VTState::SendGetMemory);
+                    timer_ms_ = 0;
+                }
+                break;
+
             case VTState::SendGetMemory: {
                 // ISO 11783-6 F.33: Get Memory command
                 // [0] = 0xC0 (Get Memory)
@@ -472,8 +654,8 @@ namespace agrobus::isobus::vt {
                 // [5..7] = 0xFF reserved
                 dp::Vector<u8> data(8, 0xFF);
                 data[0] = vt_cmd::GET_MEMORY;
-                auto pool_data = pool_.serialize();
-                u32 pool_size = pool_data ? static_cast<u32>(pool_data.value().size()) : 0;
+                DataSpan ready = ready_bytes();
+                u32 pool_size = static_cast<u32>(ready.empty() ? pool_.serialized_size() : ready.size());
                 data[1] = static_cast<u8>(pool_size & 0xFF);
                 data[2] = static_cast<u8>((pool_size >> 8) & 0xFF);
                 data[3] = static_cast<u8>((pool_size >> 16) & 0xFF);
@@ -491,7 +673,7 @@ namespace agrobus::isobus::vt {
             case VTState::WaitForMemory:
             case VTState::WaitForPoolStore:
             case VTState::WaitForPoolActivate:
-                if (timer_ms_ >= config_.timeout_ms) {
+                if (timer_ms_ >= config_.timeout_ms && !uploading_) {
                     echo::category("isobus.vt.client").warn("VT response timeout");
                     state_.transition(VTState::Disconnected);
                 }
@@ -502,6 +684,19 @@ namespace agrobus::isobus::vt {
             }
         }
 
+        // ─── Per-object activation handlers ──────────────────────────────────────
+        // One handler per Soft Key or Button object, called only for the
+        // activation codes in `codes` (activation::PRESSED | ...), found in O(1).
+        // on_soft_key / on_button still see every activation.
+        void bind_soft_key(ObjectID id, ActivationTable::Handler fn, u8 codes = activation::ANY) {
+            soft_keys_.bind(id, std::move(fn), codes);
+        }
+        void bind_button(ObjectID id, ActivationTable::Handler fn, u8 codes = activation::ANY) {
+            buttons_.bind(id, std::move(fn), codes);
+        }
+        bool unbind_soft_key(ObjectID id) { return soft_keys_.unbind(id); }
+        bool unbind_button(ObjectID id) { return buttons_.unbind(id); }
+
         // ─── Events ──────────────────────────────────────────────────────────────
         Event<ObjectID, ActivationCode> on_soft_key;
         Event<ObjectID, ActivationCode> on_button;
@@ -517,9 +712,12 @@ namespace agrobus::isobus::vt {
         Event<bool, u8> on_extended_store_response;                  // (success, error_code)
         Event<bool, u8> on_extended_load_response;                   // (success, error_code)
         Event<bool> on_active_ws_status;                             // true if this client is active WS
+        Event<u8, ObjectID> on_command_timeout;                      // (function, object) never answered
 
       private:
         dp::Vector<VTMacro> macros_;
+        ActivationTable soft_keys_;
+        ActivationTable buttons_;
 
         void warn_if_not_active_ws() {
             if (!is_active_ws_ && state_.state() == VTState::Connected) {
@@ -527,10 +725,29 @@ namespace agrobus::isobus::vt {
             }
         }
 
+        // Object commands: straight to the bus, or through the command queue
+        Result<void> send_command(dp::Vector<u8> data) {
+            if (!config_.pipelined_commands)
+                return net_.send(PGN_ECU_TO_VT, data, cf_);
+            if (!commands_.push(std::move(data)))
+                return Result<void>::err(Error::buffer_overflow());
+            dispatch_commands();
+            return {};
+        }
+
+        bool send_now(const dp::Vector<u8> &data) { return net_.send(PGN_ECU_TO_VT, data, cf_).is_ok(); }
+
+        void dispatch_commands() {
+            commands_.dispatch([this](const dp::Vector<u8> &data) { return send_now(data); });
+        }
+
         void handle_vt_message(const Message &msg) {
             if (msg.data.size() < 1)
                 return;
             u8 func = msg.data[0];
+            if (config_.pipelined_commands && cf_ && msg.destination == cf_->address() &&
+                commands_.on_response(msg.data))
+                dispatch_commands();
 
             switch (func) {
             case vt_cmd::VT_STATUS:
@@ -539,6 +756,10 @@ namespace agrobus::isobus::vt {
             case vt_cmd::GET_MEMORY_RESPONSE:
                 handle_get_memory_response(msg);
                 break;
+            case vt_cmd::GET_HARDWARE:
+            case vt_cmd::GET_NUMBER_SOFTKEYS:
+                handle_geometry_response(msg);
+                break;
             case vt_cmd::END_OF_POOL:
                 handle_end_of_pool_response(msg);
                 break;
@@ -604,9 +825,12 @@ namespace agrobus::isobus::vt {
         }
 
         void handle_get_memory_response(const Message &msg) {
-            if (msg.data.size() < 2)
+            // [1] = VT version, [2] = 0 when there is enough memory. Only our
+            // own Get Memory counts: a disconnected client on the same CF
+            // sees the answers to a newer one's.
+            if (state_.state() != VTState::WaitForMemory || msg.data.size() < 3)
                 return;
-            bool enough_memory = (msg.data[1] == 0);
+            bool enough_memory = (msg.data[2] == 0);
             if (enough_memory) {
                 state_.transition(VTState::UploadPool);
                 echo::category("isobus.vt.client").info("VT has enough memory, uploading pool");
@@ -617,9 +841,102 @@ namespace agrobus::isobus::vt {
             }
         }
 
+        // ─── VT geometry and scaling ─────────────────────────────────────────────
+        static constexpr u8 GEOMETRY_HARDWARE = 0x01;
+        static constexpr u8 GEOMETRY_SOFT_KEYS = 0x02;
+
+        void request_geometry() {
+            geometry_replies_ = 0;
+            vt_geometry_ = config_.design_geometry;
+            ControlFunction vt_cf;
+            vt_cf.address = vt_address_;
+            for (u8 function : {vt_cmd::GET_HARDWARE, vt_cmd::GET_NUMBER_SOFTKEYS}) {
+                dp::Vector<u8> data(8, 0xFF);
+                data[0] = function;
+                net_.send(PGN_ECU_TO_VT, data, cf_, &vt_cf);
+            }
+            state_.transition(VTState::WaitForGeometry);
+        }
+
+        // Get Hardware response: [4..5] data mask X pixels. Get Number of Soft
+        // Keys response: [4] X dots, [5] Y dots.
+        void handle_geometry_response(const Message &msg) {
+            if (state_.state() != VTState::WaitForGeometry || msg.data.size() < 8)
+                return;
+            if (msg.data[0] == vt_cmd::GET_HARDWARE) {
+                u16 pixels = msg.get_u16_le(4);
+                if (pixels > 0 && pixels != 0xFFFF)
+                    vt_geometry_.data_mask = pixels;
+                geometry_replies_ |= GEOMETRY_HARDWARE;
+            } else {
+                if (msg.data[4] > 0 && msg.data[4] != 0xFF && msg.data[5] > 0 && msg.data[5] != 0xFF) {
+                    vt_geometry_.soft_key_width = msg.data[4];
+                    vt_geometry_.soft_key_height = msg.data[5];
+                }
+                geometry_replies_ |= GEOMETRY_SOFT_KEYS;
+            }
+            if (geometry_replies_ != (GEOMETRY_HARDWARE | GEOMETRY_SOFT_KEYS))
+                return;
+            prepare_scaled_pool();
+            timer_ms_ = 0;
+            load_or_upload();
+        }
+
+        // The pool as this VT needs it: from the cache when the VT model was
+        // seen before, otherwise scaled (and cached) now
+        void prepare_scaled_pool() {
+            scaled_.reset();
+            if (vt_geometry_ == config_.design_geometry)
+                return;
+            if (scaled_cache_) {
+                if (!pool_hash_.has_value())
+                    pool_hash_ = IOPParser::content_hash(pool_.serialize().value());
+                scaled_ = scaled_cache_->get(*pool_hash_, pool_, config_.design_geometry, vt_geometry_);
+            } else {
+                auto scaled = std::make_shared<ScaledPool>();
+                scaled->bytes = scale_pool(pool_, config_.design_geometry, vt_geometry_);
+                scaled->label = IOPParser::version_label(IOPParser::content_hash(scaled->bytes));
+                scaled_ = std::move(scaled);
+            }
+            echo::category("isobus.vt.client")
+                .info("Pool scaled to data mask ", vt_geometry_.data_mask, ", soft keys ",
+                      vt_geometry_.soft_key_width, "x", vt_geometry_.soft_key_height);
+            if (config_.version_first)
+                refresh_pool_label();
+        }
+
+        // After the master message (and the geometry): Load Version first when
+        // asked to, else straight to Get Memory
+        void load_or_upload() {
+            if (config_.version_first && send_load_version(pool_label_).is_ok()) {
+                state_.transition(VTState::WaitForVersionLoad);
+                echo::category("isobus.vt.client").info("Trying stored pool version: ", pool_label_);
+            } else {
+                state_.transition(VTState::SendGetMemory);
+            }
+        }
+
+        // The whole upload when it exists ready-made: the pool scaled for this
+        // VT, or a static pool
+        DataSpan ready_bytes() const noexcept { return scaled_ ? DataSpan(scaled_->bytes) : rom_pool_; }
+
         void upload_pool() {
-            auto pool_data = pool_.serialize();
-            if (!pool_data.is_ok() || pool_data.value().empty()) {
+            DataSpan ready = ready_bytes();
+            if (ready.empty()) {
+                upload_objects(pool_);
+                return;
+            }
+            dp::Vector<u8> transfer_data;
+            transfer_data.reserve(1 + ready.size());
+            transfer_data.push_back(vt_cmd::OBJECT_POOL_TRANSFER);
+            transfer_data.insert(transfer_data.end(), ready.begin(), ready.end());
+            start_upload(std::move(transfer_data));
+        }
+
+        // Object Pool Transfer of `objects`: the whole pool, or the part a
+        // pool update changed
+        void upload_objects(const ObjectPool &objects) {
+            if (objects.empty()) {
                 echo::category("isobus.vt.client").error("Failed to serialize object pool");
                 state_.transition(VTState::Disconnected);
                 return;
@@ -627,27 +944,87 @@ namespace agrobus::isobus::vt {
 
             // ISO 11783-6 F.39: Object Pool Transfer
             // The pool data is prepended with the Object Pool Transfer command byte (0x11)
-            // and sent as a multi-frame message via TP/ETP transport.
+            // and sent as a multi-frame message via TP/ETP transport. The pool is
+            // serialized straight behind the command byte.
             dp::Vector<u8> transfer_data;
-            transfer_data.reserve(1 + pool_data.value().size());
+            transfer_data.reserve(1 + objects.serialized_size());
             transfer_data.push_back(vt_cmd::OBJECT_POOL_TRANSFER);
-            transfer_data.insert(transfer_data.end(), pool_data.value().begin(), pool_data.value().end());
+            objects.serialize_into(transfer_data);
+            start_upload(std::move(transfer_data));
+        }
+
+        void start_upload(dp::Vector<u8> transfer_data) {
+            state_.transition(VTState::WaitForPoolActivate);
+            timer_ms_ = 0;
+            uploading_ = true;
+            upload_flow(std::move(transfer_data)); // Detached: resumed from IsoNet::update()
+        }
 
+        // End of Object Pool only once the VT acknowledged the whole transfer;
+        // the activation timeout starts from there, not from the first frame
+        Task<Result<void>> upload_flow(dp::Vector<u8> transfer_data) {
             ControlFunction vt_cf;
             vt_cf.address = vt_address_;
-            auto result = net_.send(PGN_ECU_TO_VT, transfer_data, cf_, &vt_cf);
+            usize bytes = transfer_data.size() - 1;
+            auto result = co_await net_.send_and_wait(PGN_ECU_TO_VT, transfer_data, cf_, &vt_cf);
+            uploading_ = false;
+            timer_ms_ = 0;
+            if (state_.state() != VTState::WaitForPoolActivate)
+                co_return result;
             if (!result.is_ok()) {
                 echo::category("isobus.vt.client").error("Pool upload failed: transport error");
                 state_.transition(VTState::Disconnected);
-                return;
+                co_return result;
             }
 
-            echo::category("isobus.vt.client").info("Pool uploaded: ", pool_data.value().size(), " bytes");
-
-            // Send End of Object Pool Transfer
+            echo::category("isobus.vt.client").info("Pool uploaded: ", bytes, " bytes");
             send_end_of_pool();
-            state_.transition(VTState::WaitForPoolActivate);
-            timer_ms_ = 0;
+            co_return Result<void>{};
+        }
+
+        void refresh_pool_label() {
+            pool_label_ = config_.version_label;
+            if (pool_label_.empty() && scaled_) {
+                pool_label_ = scaled_->label;
+            } else if (pool_label_.empty() && !rom_pool_.empty()) {
+                pool_label_ = rom_label_;
+            } else if (pool_label_.empty()) {
+                auto bytes = pool_.serialize();
+                pool_label_ = IOPParser::hash_to_version(bytes.value()).value();
+            }
+            pool_label_ = pool_label_.substr(0, vt_cmd::CLASSIC_VERSION_LABEL_SIZE);
+        }
+
+        // A change the VT can take as a value command: Number Variable [value u32],
+        // String Variable [length u16][chars] with the length unchanged
+        bool send_value_change(const VTObject &old_obj, const VTObject &new_obj) {
+            if (old_obj.type != new_obj.type || old_obj.children != new_obj.children)
+                return false;
+            const auto &body = new_obj.body;
+            if (new_obj.type == ObjectType::NumberVariable && body.size() == 4 && old_obj.body.size() == 4) {
+                u32 value = static_cast<u32>(body[0]) | (static_cast<u32>(body[1]) << 8) |
+                            (static_cast<u32>(body[2]) << 16) | (static_cast<u32>(body[3]) << 24);
+                return change_numeric_value(new_obj.id, value).is_ok();
+            }
+            if (new_obj.type == ObjectType::StringVariable && body.size() >= 2 &&
+                body.size() == old_obj.body.size() && static_cast<usize>(body[0] | (body[1] << 8)) + 2 == body.size()) {
+                dp::String value;
+                for (usize i = 2; i < body.size(); ++i)
+                    value += static_cast<char>(body[i]);
+                return change_string_value(new_obj.id, std::move(value)).is_ok();
+            }
+            return false;
+        }
+
+        Result<void> send_load_version(const dp::String &version_label) {
+            dp::Vector<u8> data(8, 0xFF);
+            data[0] = vt_cmd::LOAD_POOL;
+            for (usize i = 0; i < 7; ++i) {
+                data[1 + i] = (i < version_label.size()) ? static_cast<u8>(version_label[i]) : 0x20;
+            }
+            ControlFunction vt_cf;
+            vt_cf.address = vt_address_;
+            return net_.send(PGN_ECU_TO_VT, data, cf_, &vt_cf);
         }
 
         void send_end_of_pool() {
@@ -670,6 +1047,9 @@ namespace agrobus::isobus::vt {
                 echo::category("isobus.vt.client").debug("state: ", static_cast<u8>(state_.state()));
                 echo::category("isobus.vt.client").info("Pool activated successfully");
                 on_state_change.emit(VTState::Connected);
+                // Next connect can load instead of upload
+                if (config_.version_first && !pool_label_.empty())
+                    store_version(pool_label_);
             } else {
                 u8 error_code = msg.data.size() > 2 ? msg.data[2] : 0xFF;
                 echo::category("isobus.vt.client").error("pool upload rejected");
@@ -684,6 +1064,7 @@ namespace agrobus::isobus::vt {
                 return;
             ObjectID key_id = static_cast<u16>(msg.data[1]) | (static_cast<u16>(msg.data[2]) << 8);
             auto code = static_cast<ActivationCode>(msg.data[3]);
+            soft_keys_.dispatch(key_id, code);
             on_soft_key.emit(key_id, code);
         }
 
@@ -692,6 +1073,7 @@ namespace agrobus::isobus::vt {
                 return;
             ObjectID btn_id = static_cast<u16>(msg.data[1]) | (static_cast<u16>(msg.data[2]) << 8);
             auto code = static_cast<ActivationCode>(msg.data[3]);
+            buttons_.dispatch(btn_id, code);
             on_button.emit(btn_id, code);
         }
 
@@ -734,6 +1116,19 @@ namespace agrobus::isobus::vt {
             bool success = (msg.data[1] == 0);
             u8 error_code = msg.data.size() > 2 ? msg.data[2] : 0;
             on_load_version_response.emit(success, error_code);
+            if (state_.state() == VTState::WaitForVersionLoad) {
+                if (success) {
+                    pool_from_version_ = true;
+                    state_.transition(VTState::Connected);
+                    on_state_change.emit(VTState::Connected);
+                    echo::category("isobus.vt.client").info("Pool loaded from stored version ", pool_label_);
+                } else {
+                    echo::category("isobus.vt.client").info("Version ", pool_label_, " not stored, uploading pool");
+                    state_.transition(VTState::SendGetMemory);
+                    timer_ms_ = 0;
+                }
+                return;
+            }
             if (success) {
                 state_.transition(VTState::Connected);
                 on_state_change.emit(VTState::Connected);
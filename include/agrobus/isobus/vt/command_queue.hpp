@@ -0,0 +1,275 @@
+#pragma once
+
+#include "commands.hpp"
+#include "objects.hpp"
+#include <agrobus/net/types.hpp>
+#include <datapod/datapod.hpp>
+#include <echo/echo.hpp>
+
+namespace agrobus::isobus::vt {
+    using namespace agrobus::net;
+
+    // ─── Command queue configuration ─────────────────────────────────────────────
+    struct VTCommandQueueConfig {
+        u8 max_window = 4;      // Commands awaiting a response at most
+        u32 timeout_ms = 1000;  // Per attempt
+        u8 retries = 2;         // Resends after a timeout before the command is dropped
+        usize max_queued = 256; // Waiting to be sent; push() fails beyond
+
+        VTCommandQueueConfig &window(u8 n) {
+            max_window = n > 0 ? n : 1;
+            return *this;
+        }
+        VTCommandQueueConfig &timeout(u32 ms) {
+            timeout_ms = ms;
+            return *this;
+        }
+        VTCommandQueueConfig &retry(u8 n) {
+            retries = n;
+            return *this;
+        }
+    };
+
+    // ─── Flow-controlled VT command queue ────────────────────────────────────────
+    // Keeps at most window() commands outstanding and sends the next one when
+    // the VT answers. A response is matched by function code and object ID
+    // (function code alone for commands without one); a command without an
+    // answer is resent after timeout_ms, dropped after `retries` resends.
+    //
+    // The window adapts to the VT: it starts at 1, grows by one for every
+    // window() commands answered in time and halves on a timeout, so a fast
+    // VT gets max_window commands in flight and a slow one is not flooded
+    // with commands it would drop.
+    //
+    // Commands for the same function and object are sent one at a time, so
+    // a response is never ambiguous: while one is in flight, a newer one for
+    // the same target waits and replaces any older one still waiting (the VT
+    // only needs the latest value). A timed-out command with a newer one
+    // waiting is dropped instead of resent.
+    //
+    // Pure bookkeeping: the owner (VTClient) hands responses to on_response()
+    // and passes a send function to dispatch() and update().
+    class VTCommandQueue {
+      public:
+        static constexpr ObjectID ANY_OBJECT = 0xFFFF;
+
+      private:
+        struct Command {
+            dp::Vector<u8> data;
+            u8 function = 0;
+            ObjectID object = ANY_OBJECT;
+            u32 elapsed_ms = 0; // Since the last attempt
+            u8 attempts = 0;
+        };
+
+        VTCommandQueueConfig config_;
+        dp::Vector<Command> waiting_;
+        dp::Vector<Command> in_flight_;
+        u8 window_ = 1;
+        u8 answered_ = 0; // In time at the current window, towards the next increase
+
+        u32 sent_ = 0;
+        u32 answered_total_ = 0;
+        u32 resent_ = 0;
+        u32 dropped_ = 0;
+        u32 response_ms_ = 0; // Smoothed (1/8 EWMA) response time
+
+      public:
+        VTCommandQueue() = default;
+        explicit VTCommandQueue(VTCommandQueueConfig config) : config_(config) {}
+
+        // ─── Matching keys (ISO 11783-6 Annex F) ─────────────────────────────────
+        // Object a command targets, as its response reports it
+        static ObjectID request_object(const dp::Vector<u8> &data) noexcept {
+            if (data.size() < 3)
+                return ANY_OBJECT;
+            switch (data[0]) {
+            case vt_cmd::CHANGE_ACTIVE_MASK: // [ws id][new mask id], answered with the mask
+                return data.size() >= 5 ? read_id(data, 3) : ANY_OBJECT;
+            case vt_cmd::HIDE_SHOW:
+            case vt_cmd::ENABLE_DISABLE:
+            case vt_cmd::CHANGE_NUMERIC_VALUE:
+            case vt_cmd::CHANGE_STRING_VALUE:
+            case vt_cmd::CHANGE_ATTRIBUTE:
+            case vt_cmd::CHANGE_SIZE:
+            case vt_cmd::CHANGE_BACKGROUND_COLOUR:
+            case vt_cmd::CHANGE_CHILD_LOCATION:
+            case vt_cmd::CHANGE_LIST_ITEM:
+                return read_id(data, 1);
+            default:
+                return ANY_OBJECT;
+            }
+        }
+
+        static ObjectID response_object(const dp::Vector<u8> &data) noexcept {
+            if (data.size() < 3)
+                return ANY_OBJECT;
+            switch (data[0]) {
+            case vt_cmd::CHANGE_STRING_VALUE: // [reserved u16][object id][error]
+                return data.size() >= 5 ? read_id(data, 3) : ANY_OBJECT;
+            case vt_cmd::CHANGE_ACTIVE_MASK: // [new mask id][error]
+            case vt_cmd::HIDE_SHOW:
+            case vt_cmd::ENABLE_DISABLE:
+            case vt_cmd::CHANGE_NUMERIC_VALUE:
+            case vt_cmd::CHANGE_ATTRIBUTE:
+            case vt_cmd::CHANGE_SIZE:
+            case vt_cmd::CHANGE_BACKGROUND_COLOUR:
+            case vt_cmd::CHANGE_CHILD_LOCATION:
+            case vt_cmd::CHANGE_LIST_ITEM:
+                return read_id(data, 1);
+            default:
+                return ANY_OBJECT;
+            }
+        }
+
+        // ─── Queueing ────────────────────────────────────────────────────────────
+        // False when max_queued commands are already waiting
+        bool push(dp::Vector<u8> data) {
+            if (data.empty())
+                return false;
+            Command cmd;
+            cmd.function = data[0];
+            cmd.object = request_object(data);
+            cmd.data = std::move(data);
+
+            if (cmd.object != ANY_OBJECT) {
+                for (auto &w : waiting_) {
+                    if (w.function == cmd.function && w.object == cmd.object) {
+                        w.data = std::move(cmd.data);
+                        return true;
+                    }
+                }
+            }
+            if (waiting_.size() >= config_.max_queued)
+                return false;
+            waiting_.push_back(std::move(cmd));
+            return true;
+        }
+
+        // Send waiting commands while the window has room. send(const
+        // dp::Vector<u8> &) returns false when the bus would not take it; the
+        // command then stays first in line.
+        template <typename Send> void dispatch(Send &&send) {
+            usize i = 0;
+            while (i < waiting_.size() && in_flight_.size() < window_) {
+                if (busy(waiting_[i])) {
+                    ++i;
+                    continue;
+                }
+                if (!send(waiting_[i].data))
+                    return;
+                Command cmd = std::move(waiting_[i]);
+                waiting_.erase(waiting_.begin() + static_cast<isize>(i));
+                cmd.elapsed_ms = 0;
+                cmd.attempts = 1;
+                ++sent_;
+                in_flight_.push_back(std::move(cmd));
+            }
+        }
+
+        // A VT-to-ECU message; true if it answered a command in flight
+        bool on_response(const dp::Vector<u8> &data) {
+            if (data.empty() || in_flight_.empty())
+                return false;
+            ObjectID object = response_object(data);
+            for (usize i = 0; i < in_flight_.size(); ++i) {
+                const Command &cmd = in_flight_[i];
+                if (cmd.function != data[0] || (cmd.object != ANY_OBJECT && cmd.object != object))
+                    continue;
+                response_ms_ = answered_total_ == 0 ? cmd.elapsed_ms : (response_ms_ * 7 + cmd.elapsed_ms) / 8;
+                ++answered_total_;
+                in_flight_.erase(in_flight_.begin() + static_cast<isize>(i));
+                if (++answered_ >= window_) {
+                    answered_ = 0;
+                    if (window_ < config_.max_window)
+                        ++window_;
+                }
+                return true;
+            }
+            return false;
+        }
+
+        // Time out, resend or drop the commands in flight, then dispatch.
+        // on_drop(u8 function, ObjectID object) for every command given up on.
+        template <typename Send, typename Drop> void update(u32 elapsed_ms, Send &&send, Drop &&on_drop) {
+            bool timed_out = false;
+            for (usize i = 0; i < in_flight_.size();) {
+                Command &cmd = in_flight_[i];
+                cmd.elapsed_ms += elapsed_ms;
+                if (cmd.elapsed_ms < config_.timeout_ms) {
+                    ++i;
+                    continue;
+                }
+                timed_out = true;
+                if (cmd.attempts <= config_.retries && !superseded(cmd) && send(cmd.data)) {
+                    ++cmd.attempts;
+                    cmd.elapsed_ms = 0;
+                    ++resent_;
+                    ++i;
+                    continue;
+                }
+                if (!superseded(cmd)) {
+                    ++dropped_;
+                    echo::category("isobus.vt.commands")
+                        .warn("no response to 0x", cmd.function, " for object ", cmd.object);
+                    on_drop(cmd.function, cmd.object);
+                }
+                in_flight_.erase(in_flight_.begin() + static_cast<isize>(i));
+            }
+            if (timed_out) {
+                window_ = window_ > 1 ? static_cast<u8>(window_ / 2) : 1;
+                answered_ = 0;
+            }
+            dispatch(send);
+        }
+
+        template <typename Send> void update(u32 elapsed_ms, Send &&send) {
+            update(elapsed_ms, send, [](u8, ObjectID) {});
+        }
+
+        void clear() {
+            waiting_.clear();
+            in_flight_.clear();
+            window_ = 1;
+            answered_ = 0;
+        }
+
+        // ─── State and statistics ────────────────────────────────────────────────
+        u8 window() const noexcept { return window_; }
+        usize in_flight() const noexcept { return in_flight_.size(); }
+        usize waiting() const noexcept { return waiting_.size(); }
+        bool idle() const noexcept { return waiting_.empty() && in_flight_.empty(); }
+        u32 sent() const noexcept { return sent_; }
+        u32 answered() const noexcept { return answered_total_; }
+        u32 resent() const noexcept { return resent_; }
+        u32 dropped() const noexcept { return dropped_; }
+        u32 response_ms() const noexcept { return response_ms_; }
+        const VTCommandQueueConfig &config() const noexcept { return config_; }
+
+      private:
+        static ObjectID read_id(const dp::Vector<u8> &data, usize at) noexcept {
+            return static_cast<ObjectID>(data[at]) | (static_cast<ObjectID>(data[at + 1]) << 8);
+        }
+
+        // A command for the same target is in flight
+        bool busy(const Command &cmd) const noexcept {
+            for (const auto &f : in_flight_) {
+                if (f.function == cmd.function && (f.object == cmd.object || f.object == ANY_OBJECT))
+                    return true;
+            }
+            return false;
+        }
+
+        // A newer command for the same target is waiting
+        bool superseded(const Command &cmd) const noexcept {
+            if (cmd.object == ANY_OBJECT)
+                return false;
+            for (const auto &w : waiting_) {
+                if (w.function == cmd.function && w.object == cmd.object)
+                    return true;
+            }
+            return false;
+        }
+    };
+
+} // namespace agrobus::isobus::vt
@@ -0,0 +1,122 @@
+#pragma once
+
+#include "objects.hpp"
+#include <agrobus/net/error.hpp>
+#include <agrobus/net/types.hpp>
+#include <datapod/datapod.hpp>
+
+namespace agrobus::isobus::vt {
+    using namespace agrobus::net;
+
+    // ─── One pool in several languages ───────────────────────────────────────────
+    // Translations of a pool usually differ in a few objects (Output Strings,
+    // String Variables). The first language added is the base pool; every
+    // other one keeps only the objects that differ from it or are its own, as
+    // an overlay. compose() puts base and overlay back together at connect
+    // time. Each composed pool serializes differently, so its version label
+    // (hashed from the bytes for a version-first VTClient) is per language as
+    // well, and switching language on a connected client through
+    // VTClient::update_pool() transfers the overlay objects only.
+    class LanguagePools {
+        struct Variant {
+            dp::String language; // Language code, as in the Language command ("en", "de", ...)
+            ObjectPool overlay;  // Empty for the base language
+        };
+
+        ObjectPool base_;
+        dp::Vector<Variant> variants_;
+
+      public:
+        // A language's full pool. It may change objects of the base or add its
+        // own, not leave any out. Adding a language again replaces it; the base
+        // language itself cannot be replaced once others are split from it.
+        Result<void> add(const dp::String &language, const ObjectPool &pool) {
+            if (pool.empty())
+                return Result<void>::err(Error::invalid_state("object pool is empty"));
+            if (variants_.empty()) {
+                base_ = pool;
+                variants_.push_back({language, {}});
+                return {};
+            }
+            if (language == variants_[0].language) {
+                if (variants_.size() > 1)
+                    return Result<void>::err(Error::invalid_state("base language already has overlays"));
+                base_ = pool;
+                return {};
+            }
+            PoolDiff d = base_.diff(pool);
+            if (!d.removed.empty())
+                return Result<void>::err(Error::invalid_state(
+                    "language " + language + " leaves out object " + dp::String(std::to_string(d.removed[0]))));
+            dp::Vector<ObjectID> own = d.changed;
+            own.insert(own.end(), d.added.begin(), d.added.end());
+            ObjectPool overlay = pool.subset(own);
+            for (auto &v : variants_) {
+                if (v.language == language) {
+                    v.overlay = std::move(overlay);
+                    return {};
+                }
+            }
+            variants_.push_back({language, std::move(overlay)});
+            return {};
+        }
+
+        // The pool for `language`; the base language's when there is no such one
+        ObjectPool compose(const dp::String &language) const {
+            const auto *v = find(language);
+            if (!v || v->overlay.empty())
+                return base_;
+            return ObjectPool::overlay(base_, v->overlay);
+        }
+
+        bool contains(const dp::String &language) const noexcept { return find(language) != nullptr; }
+
+        dp::Vector<dp::String> languages() const {
+            dp::Vector<dp::String> out;
+            for (const auto &v : variants_)
+                out.push_back(v.language);
+            return out;
+        }
+
+        const ObjectPool &base() const noexcept { return base_; }
+        const dp::String &base_language() const noexcept {
+            static const dp::String none;
+            return variants_.empty() ? none : variants_[0].language;
+        }
+
+        // Objects `language` keeps apart from the base (nullptr for an unknown language)
+        const ObjectPool *overlay(const dp::String &language) const noexcept {
+            const auto *v = find(language);
+            return v ? &v->overlay : nullptr;
+        }
+
+        usize size() const noexcept { return variants_.size(); }
+        bool empty() const noexcept { return variants_.empty(); }
+
+        // Serialized bytes held: the base once plus the overlays
+        usize stored_size() const noexcept {
+            usize size = base_.serialized_size();
+            for (const auto &v : variants_)
+                size += v.overlay.serialized_size();
+            return size;
+        }
+
+        // Serialized bytes of every language's full pool, for comparison
+        usize composed_size() const {
+            usize size = 0;
+            for (const auto &v : variants_)
+                size += compose(v.language).serialized_size();
+            return size;
+        }
+
+      private:
+        const Variant *find(const dp::String &language) const noexcept {
+            for (const auto &v : variants_) {
+                if (v.language == language)
+                    return &v;
+            }
+            return nullptr;
+        }
+    };
+
+} // namespace agrobus::isobus::vt
@@ -0,0 +1,166 @@
+#pragma once
+
+#include "commands.hpp"
+#include "objects.hpp"
+#include "pool_image.hpp"
+#include <agrobus/net/data_span.hpp>
+#include <agrobus/net/types.hpp>
+#include <datapod/datapod.hpp>
+#include <echo/echo.hpp>
+
+namespace agrobus::isobus::vt {
+    using namespace agrobus::net;
+
+    // ─── Macro object (ISO 11783-6 Annex B.19) ───────────────────────────────────
+    // Body layout:
+    //   [0..1] Number of command bytes to follow (LE)
+    //   [2..]  Commands, each as its ECU to VT message: 8 bytes, except Change
+    //          String Value, which is 5 bytes plus its string
+    struct MacroCommand {
+        u8 function = 0;
+        ObjectID object = 0xFFFF; // Bytes 1..2 of the command
+        u32 value = 0;            // Change Numeric Value: the value; Change String Value: the string length
+        u32 offset = 0;           // Into VTMacroTable::bytes(): the string, or the whole command otherwise
+        u16 size = 0;
+    };
+
+    // ─── Compiled macros of one pool ─────────────────────────────────────────────
+    // Every Macro object decoded once, when the pool arrives, into one array of
+    // MacroCommand (CSR: one offset per macro) over one byte buffer. Running a
+    // macro on an event is then a loop over ready commands, with no parsing.
+    class VTMacroTable {
+        ObjectIndex slots_;     // Macro ID -> slot
+        dp::Vector<u32> start_; // Slot -> first command, then one past the last
+        dp::Vector<MacroCommand> commands_;
+        dp::Vector<u8> bytes_;
+        u32 rejected_ = 0;
+
+      public:
+        // The commands of one macro, valid while the table lives
+        struct Program {
+            const MacroCommand *data = nullptr;
+            u32 count = 0;
+
+            u32 size() const noexcept { return count; }
+            bool empty() const noexcept { return count == 0; }
+            const MacroCommand &operator[](u32 i) const noexcept { return data[i]; }
+            const MacroCommand *begin() const noexcept { return data; }
+            const MacroCommand *end() const noexcept { return data + count; }
+        };
+
+        static VTMacroTable compile(const PoolImage &pool) {
+            VTMacroTable table;
+            pool.for_each([&](const ObjectView &obj) {
+                if (obj.type == ObjectType::Macro)
+                    table.add(obj.id, obj.body);
+            });
+            return table;
+        }
+
+        static VTMacroTable compile(const ObjectPool &pool) {
+            VTMacroTable table;
+            for (const auto &obj : pool.objects()) {
+                if (obj.type == ObjectType::Macro)
+                    table.add(obj.id, DataSpan(obj.body));
+            }
+            return table;
+        }
+
+        // A malformed macro is left out whole (and counted in rejected())
+        bool add(ObjectID id, DataSpan body) {
+            usize first = commands_.size();
+            usize bytes_before = bytes_.size();
+            if (slots_.contains(id) || !decode(body)) {
+                commands_.resize(first);
+                bytes_.resize(bytes_before);
+                ++rejected_;
+                echo::category("isobus.vt.macro").warn("Macro ", id, " rejected");
+                return false;
+            }
+            if (start_.empty())
+                start_.push_back(0);
+            slots_.insert(id, static_cast<u32>(start_.size() - 1));
+            start_.push_back(static_cast<u32>(commands_.size()));
+            return true;
+        }
+
+        dp::Optional<Program> find(ObjectID id) const noexcept {
+            u32 slot = slots_.find(id);
+            if (slot == ObjectIndex::NONE)
+                return dp::nullopt;
+            return Program{commands_.data() + start_[slot], start_[slot + 1] - start_[slot]};
+        }
+
+        bool contains(ObjectID id) const noexcept { return slots_.contains(id); }
+
+        DataSpan bytes(const MacroCommand &cmd) const noexcept {
+            return DataSpan(bytes_.data() + cmd.offset, cmd.size);
+        }
+
+        usize size() const noexcept { return start_.empty() ? 0 : start_.size() - 1; }
+        bool empty() const noexcept { return size() == 0; }
+        usize commands() const noexcept { return commands_.size(); }
+        u32 rejected() const noexcept { return rejected_; }
+
+      private:
+        bool decode(DataSpan body) {
+            if (body.size() < 2)
+                return false;
+            usize len = body.get_u16_le(0);
+            if (len > body.size() - 2)
+                return false;
+            DataSpan cmds = body.subspan(2, len);
+            usize pos = 0;
+            while (pos < cmds.size()) {
+                DataSpan rest = cmds.subspan(pos);
+                MacroCommand cmd;
+                cmd.function = rest[0];
+                if (cmd.function == vt_cmd::CHANGE_STRING_VALUE) {
+                    if (rest.size() < 5)
+                        return false;
+                    u16 chars = rest.get_u16_le(3);
+                    if (chars > rest.size() - 5)
+                        return false;
+                    cmd.object = rest.get_u16_le(1);
+                    cmd.value = chars;
+                    append(cmd, rest.subspan(5, chars));
+                    pos += 5 + chars;
+                    continue;
+                }
+                if (rest.size() < 8)
+                    return false;
+                cmd.object = rest.get_u16_le(1);
+                if (cmd.function == vt_cmd::CHANGE_NUMERIC_VALUE)
+                    cmd.value = rest.get_u32_le(4);
+                append(cmd, rest.subspan(0, 8));
+                pos += 8;
+            }
+            return true;
+        }
+
+        void append(MacroCommand cmd, DataSpan data) {
+            cmd.offset = static_cast<u32>(bytes_.size());
+            cmd.size = static_cast<u16>(data.size());
+            for (usize i = 0; i < data.size(); ++i)
+                bytes_.push_back(data.data()[i]);
+            commands_.push_back(cmd);
+        }
+    };
+
+    // Body of a Macro object running `commands` (each one ECU to VT message)
+    inline dp::Vector<u8> macro_body(const dp::Vector<dp::Vector<u8>> &commands) {
+        usize len = 0;
+        for (const auto &c : commands)
+            len += c.size();
+        dp::Vector<u8> body;
+        body.reserve(2 + len);
+        body.push_back(static_cast<u8>(len & 0xFF));
+        body.push_back(static_cast<u8>((len >> 8) & 0xFF));
+        for (const auto &c : commands) {
+            for (auto b : c)
+                body.push_back(b);
+        }
+        return body;
+    }
+
+} // namespace agrobus::isobus::vt
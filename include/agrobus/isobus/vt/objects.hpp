@@ -1,8 +1,11 @@
 #pragma once
 
 #include <agrobus/net/error.hpp>
+#include <agrobus/net/static_alloc.hpp>
 #include <agrobus/net/types.hpp>
 #include <datapod/datapod.hpp>
+#include <bit>
+#include <cstring>
 #include <initializer_list>
 #include <string>
 
@@ -98,82 +101,498 @@ namespace agrobus::isobus::vt {
             return *this;
         }
 
-        dp::Vector<u8> serialize() const {
-            dp::Vector<u8> data;
+        // Bytes serialize() produces: header, body and children list
+        usize serialized_size() const noexcept {
+            return 5 + body.size() + (children.empty() ? 0 : 2 + children.size() * 2);
+        }
+
+        // Write the serialized object to `out` (serialized_size() bytes); returns the end
+        u8 *serialize_to(u8 *out) const noexcept {
             // Object ID
-            data.push_back(static_cast<u8>(id & 0xFF));
-            data.push_back(static_cast<u8>((id >> 8) & 0xFF));
+            *out++ = static_cast<u8>(id & 0xFF);
+            *out++ = static_cast<u8>((id >> 8) & 0xFF);
             // Object type
-            data.push_back(static_cast<u8>(type));
+            *out++ = static_cast<u8>(type);
             // Calculate body length: body data + children list (2 bytes per child + 2 byte count)
             u16 children_size = children.empty() ? 0 : static_cast<u16>(2 + children.size() * 2);
             u16 body_len = static_cast<u16>(body.size() + children_size);
-            data.push_back(static_cast<u8>(body_len & 0xFF));
-            data.push_back(static_cast<u8>((body_len >> 8) & 0xFF));
+            *out++ = static_cast<u8>(body_len & 0xFF);
+            *out++ = static_cast<u8>((body_len >> 8) & 0xFF);
             // Body data
-            for (auto b : body)
-                data.push_back(b);
+            if (!body.empty()) {
+                std::memcpy(out, body.data(), body.size());
+                out += body.size();
+            }
             // Children list
             if (!children.empty()) {
                 u16 num = static_cast<u16>(children.size());
-                data.push_back(static_cast<u8>(num & 0xFF));
-                data.push_back(static_cast<u8>((num >> 8) & 0xFF));
+                *out++ = static_cast<u8>(num & 0xFF);
+                *out++ = static_cast<u8>((num >> 8) & 0xFF);
                 for (auto child_id : children) {
-                    data.push_back(static_cast<u8>(child_id & 0xFF));
-                    data.push_back(static_cast<u8>((child_id >> 8) & 0xFF));
+                    *out++ = static_cast<u8>(child_id & 0xFF);
+                    *out++ = static_cast<u8>((child_id >> 8) & 0xFF);
                 }
             }
+            return out;
+        }
+
+        dp::Vector<u8> serialize() const {
+            dp::Vector<u8> data(serialized_size());
+            serialize_to(data.data());
             return data;
         }
     };
 
     // ─── Object pool ─────────────────────────────────────────────────────────────
+    // ─── Object ID index ─────────────────────────────────────────────────────────
+    // ObjectID -> position in a pool's object list, paged by the high byte of
+    // the ID so a pool only pays for the ID ranges it uses. Pools only ever
+    // append objects (prune_unreachable() rebuilds the index), so positions
+    // never move.
+    class ObjectIndex {
+        static constexpr usize PAGE = 256;
+        dp::Vector<dp::Vector<u32>> pages_; // position + 1, 0 = absent
+
+      public:
+        static constexpr u32 NONE = 0xFFFFFFFFu;
+
+        u32 find(ObjectID id) const noexcept {
+            usize page = id / PAGE;
+            if (page >= pages_.size() || pages_[page].empty())
+                return NONE;
+            return pages_[page][id % PAGE] - 1;
+        }
+
+        bool contains(ObjectID id) const noexcept { return find(id) != NONE; }
+
+        void insert(ObjectID id, u32 position) {
+            if (pages_.empty())
+                pages_.resize(0x10000 / PAGE);
+            auto &page = pages_[id / PAGE];
+            if (page.empty())
+                page.resize(PAGE, 0);
+            page[id % PAGE] = position + 1;
+        }
+
+        void clear() { pages_.clear(); }
+    };
+
+    // ─── Reverse children index ──────────────────────────────────────────────────
+    // For every object listed as a child, the objects listing it, in CSR form:
+    // one offset per child and one flat array of parent IDs, filled in two
+    // passes over the children lists. Parents come in pool order; a parent
+    // listing a child twice is there twice.
+    class ParentIndex {
+        ObjectIndex slots_;     // Child ID -> slot
+        dp::Vector<u32> start_; // Slot -> first parent in parents_, then one past the last
+        dp::Vector<ObjectID> parents_;
+
+      public:
+        // A view of the parents of one object, valid while the index lives
+        struct Parents {
+            const ObjectID *data = nullptr;
+            u32 count = 0;
+
+            u32 size() const noexcept { return count; }
+            bool empty() const noexcept { return count == 0; }
+            ObjectID operator[](u32 i) const noexcept { return data[i]; }
+            const ObjectID *begin() const noexcept { return data; }
+            const ObjectID *end() const noexcept { return data + count; }
+        };
+
+        // edges(fn) calls fn(parent, child) for every children list entry of
+        // the pool, the same way both times
+        template <typename Edges> static ParentIndex build(Edges &&edges) {
+            ParentIndex index;
+            dp::Vector<u32> counts;
+            edges([&](ObjectID, ObjectID child) {
+                u32 slot = index.slots_.find(child);
+                if (slot == ObjectIndex::NONE) {
+                    slot = static_cast<u32>(counts.size());
+                    index.slots_.insert(child, slot);
+                    counts.push_back(0);
+                }
+                ++counts[slot];
+            });
+            index.start_.resize(counts.size() + 1, 0);
+            for (usize i = 0; i < counts.size(); ++i)
+                index.start_[i + 1] = index.start_[i] + counts[i];
+            index.parents_.resize(index.start_.back());
+            for (usize i = 0; i < counts.size(); ++i)
+                counts[i] = index.start_[i]; // Next free entry of each slot
+            edges([&](ObjectID parent, ObjectID child) {
+                u32 slot = index.slots_.find(child);
+                index.parents_[counts[slot]++] = parent;
+            });
+            return index;
+        }
+
+        Parents parents(ObjectID child) const noexcept {
+            u32 slot = slots_.find(child);
+            if (slot == ObjectIndex::NONE)
+                return {};
+            return Parents{parents_.data() + start_[slot], start_[slot + 1] - start_[slot]};
+        }
+
+        usize edges() const noexcept { return parents_.size(); }
+    };
+
+    // ─── Object dependency graph ─────────────────────────────────────────────────
+    // The children lists of a pool in both directions, by position in the pool:
+    // parent -> children and child -> parents, each in CSR form (one offset
+    // array, one flat entry array), built in two passes over the pool. A
+    // breadth-first walk down from the Working Set then marks every object it
+    // reaches. Building is O(objects + edges); so is everything asked of it.
+    // References to objects missing from the pool are counted, not stored.
+    class PoolGraph {
+        static constexpr u32 NONE = 0xFFFFFFFFu;
+
+        dp::Vector<u32> child_start_;  // Position -> first entry in children_, then one past the last
+        dp::Vector<u32> children_;     // Child positions
+        dp::Vector<u32> parent_start_; // Position -> first entry in parents_, then one past the last
+        dp::Vector<ObjectID> parents_; // Parent IDs, in pool order
+        dp::Vector<u64> reachable_;    // One bit per position
+        dp::Vector<ObjectType> types_;
+        u32 root_ = NONE;
+        u32 working_sets_ = 0;
+        u32 reached_ = 0;
+        u32 dangling_ = 0;
+        ObjectID dangling_parent_ = 0;
+        ObjectID dangling_child_ = 0;
+
+      public:
+        // A view of the child positions of one object, valid while the graph lives
+        struct Children {
+            const u32 *data = nullptr;
+            u32 count = 0;
+
+            u32 size() const noexcept { return count; }
+            bool empty() const noexcept { return count == 0; }
+            u32 operator[](u32 i) const noexcept { return data[i]; }
+            const u32 *begin() const noexcept { return data; }
+            const u32 *end() const noexcept { return data + count; }
+        };
+
+        static PoolGraph build(const dp::Vector<VTObject> &objects, const ObjectIndex &index) {
+            PoolGraph g;
+            u32 n = static_cast<u32>(objects.size());
+            g.types_.resize(n);
+            g.child_start_.resize(n + 1, 0);
+            g.parent_start_.resize(n + 1, 0);
+            for (u32 i = 0; i < n; ++i) {
+                const auto &obj = objects[i];
+                g.types_[i] = obj.type;
+                if (obj.type == ObjectType::WorkingSet && g.working_sets_++ == 0)
+                    g.root_ = i;
+                u32 valid = 0;
+                for (auto child : obj.children) {
+                    u32 c = index.find(child);
+                    if (c == ObjectIndex::NONE) {
+                        if (g.dangling_++ == 0) {
+                            g.dangling_parent_ = obj.id;
+                            g.dangling_child_ = child;
+                        }
+                        continue;
+                    }
+                    ++valid;
+                    ++g.parent_start_[c + 1];
+                }
+                g.child_start_[i + 1] = g.child_start_[i] + valid;
+            }
+            for (u32 i = 0; i < n; ++i)
+                g.parent_start_[i + 1] += g.parent_start_[i];
+
+            g.children_.resize(g.child_start_[n]);
+            g.parents_.resize(g.parent_start_[n]);
+            dp::Vector<u32> next(n); // Next free parent entry of each position
+            for (u32 i = 0; i < n; ++i)
+                next[i] = g.parent_start_[i];
+            u32 out = 0;
+            for (u32 i = 0; i < n; ++i) {
+                for (auto child : objects[i].children) {
+                    u32 c = index.find(child);
+                    if (c == ObjectIndex::NONE)
+                        continue;
+                    g.children_[out++] = c;
+                    g.parents_[next[c]++] = objects[i].id;
+                }
+            }
+
+            dp::Vector<u32> roots;
+            if (g.root_ != NONE)
+                roots.push_back(g.root_);
+            g.reachable_ = g.reach(roots);
+            for (auto word : g.reachable_)
+                g.reached_ += static_cast<u32>(std::popcount(word));
+            return g;
+        }
+
+        // Every position reachable from `roots` through children lists, one bit each
+        dp::Vector<u64> reach(const dp::Vector<u32> &roots) const {
+            dp::Vector<u64> seen((types_.size() + 63) / 64, 0);
+            dp::Vector<u32> queue;
+            for (auto r : roots) {
+                if (!test_and_set(seen, r))
+                    queue.push_back(r);
+            }
+            for (usize i = 0; i < queue.size(); ++i) {
+                for (auto c : children(queue[i])) {
+                    if (!test_and_set(seen, c))
+                        queue.push_back(c);
+                }
+            }
+            return seen;
+        }
+
+        Children children(u32 position) const noexcept {
+            return Children{children_.data() + child_start_[position],
+                            child_start_[position + 1] - child_start_[position]};
+        }
+
+        ParentIndex::Parents parents(u32 position) const noexcept {
+            return ParentIndex::Parents{parents_.data() + parent_start_[position],
+                                        parent_start_[position + 1] - parent_start_[position]};
+        }
+
+        bool reachable(u32 position) const noexcept { return test(reachable_, position); }
+        ObjectType type(u32 position) const noexcept { return types_[position]; }
+
+        usize size() const noexcept { return types_.size(); }
+        usize edges() const noexcept { return children_.size(); }
+        usize reachable_count() const noexcept { return reached_; }
+        usize unreachable_count() const noexcept { return types_.size() - reached_; }
+
+        // Position of the first Working Set object; NONE without one
+        u32 root() const noexcept { return root_; }
+        bool has_root() const noexcept { return root_ != NONE; }
+        u32 working_sets() const noexcept { return working_sets_; }
+
+        // Children list entries naming an object missing from the pool; the first one kept for reporting
+        u32 dangling() const noexcept { return dangling_; }
+        ObjectID dangling_parent() const noexcept { return dangling_parent_; }
+        ObjectID dangling_child() const noexcept { return dangling_child_; }
+
+        static bool test(const dp::Vector<u64> &bits, u32 i) noexcept {
+            return (bits[i / 64] & (u64(1) << (i % 64))) != 0;
+        }
+
+      private:
+        // True if the bit was already set
+        static bool test_and_set(dp::Vector<u64> &bits, u32 i) noexcept {
+            u64 &word = bits[i / 64];
+            u64 bit = u64(1) << (i % 64);
+            bool was = (word & bit) != 0;
+            word |= bit;
+            return was;
+        }
+    };
+
+    // Object types other objects name in their attributes rather than their
+    // children lists (font of a string, variable of a number, soft key mask of
+    // a data mask, ...): unreachable through children says nothing about them
+    inline bool referenced_by_attribute(ObjectType type) noexcept {
+        switch (type) {
+        case ObjectType::SoftKeyMask:
+        case ObjectType::PictureGraphic:
+        case ObjectType::NumberVariable:
+        case ObjectType::StringVariable:
+        case ObjectType::FontAttributes:
+        case ObjectType::LineAttributes:
+        case ObjectType::FillAttributes:
+        case ObjectType::InputAttributes:
+        case ObjectType::Macro:
+        case ObjectType::AuxFunction:
+        case ObjectType::AuxInput:
+        case ObjectType::AuxFunction2:
+        case ObjectType::AuxInput2:
+        case ObjectType::AuxControlDesig:
+        case ObjectType::ColourMap:
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    // Mask object types: what a VT shows as a whole screen or window
+    inline bool is_mask(ObjectType type) noexcept {
+        return type == ObjectType::DataMask || type == ObjectType::AlarmMask || type == ObjectType::SoftKeyMask ||
+               type == ObjectType::WindowMask;
+    }
+
+    // ─── Difference between two pools ────────────────────────────────────────────
+    // By object ID; an object is changed when its type, body or children differ
+    struct PoolDiff {
+        dp::Vector<ObjectID> added;   // Only in the newer pool
+        dp::Vector<ObjectID> removed; // Only in the older pool
+        dp::Vector<ObjectID> changed; // In both, different
+
+        bool empty() const noexcept { return added.empty() && removed.empty() && changed.empty(); }
+        usize size() const noexcept { return added.size() + removed.size() + changed.size(); }
+    };
+
     class ObjectPool {
         dp::Vector<VTObject> objects_;
         dp::String version_label_{}; // Explicit pool identifier
+        ObjectIndex index_;
+        // Built on the first graph() call after the children lists may have changed
+        mutable PoolGraph graph_;
+        mutable bool graph_stale_ = true;
 
       public:
         void set_version_label(dp::String label) { version_label_ = std::move(label); }
         const dp::String &version_label() const noexcept { return version_label_; }
 
         Result<void> add(VTObject obj) {
-            for (const auto &existing : objects_) {
-                if (existing.id == obj.id) {
-                    return Result<void>::err(Error::invalid_state("duplicate object ID"));
-                }
+            if (index_.contains(obj.id)) {
+                return Result<void>::err(Error::invalid_state("duplicate object ID"));
             }
+            if (static_alloc::full(objects_.size(), static_alloc::pool_objects))
+                return Result<void>::err(static_alloc::exhausted("object pool full"));
+            index_.insert(obj.id, static_cast<u32>(objects_.size()));
+            graph_stale_ = graph_stale_ || !obj.children.empty();
             objects_.push_back(std::move(obj));
             return {};
         }
 
+        // Room for `objects` more adds without growing the object list
+        void reserve(usize objects) { objects_.reserve(objects_.size() + objects); }
+
+        // O(1) through the ID index. The returned object's id must not be changed;
+        // its children may be, so the graph is rebuilt on next use.
         dp::Optional<VTObject *> find(ObjectID id) {
-            for (auto &obj : objects_) {
-                if (obj.id == id)
-                    return &obj;
-            }
-            return dp::nullopt;
+            u32 i = index_.find(id);
+            if (i == ObjectIndex::NONE)
+                return dp::nullopt;
+            graph_stale_ = true;
+            return &objects_[i];
         }
 
         dp::Optional<const VTObject *> find(ObjectID id) const {
-            for (const auto &obj : objects_) {
-                if (obj.id == id)
-                    return &obj;
+            u32 i = index_.find(id);
+            if (i == ObjectIndex::NONE)
+                return dp::nullopt;
+            return &objects_[i];
+        }
+
+        bool contains(ObjectID id) const noexcept { return index_.contains(id); }
+
+        // Objects listing `id` as a child, through the pool graph. The view is
+        // valid until the pool is next changed.
+        ParentIndex::Parents parents(ObjectID id) const {
+            u32 i = index_.find(id);
+            if (i == ObjectIndex::NONE)
+                return {};
+            return graph().parents(i);
+        }
+
+        const PoolGraph &graph() const {
+            if (graph_stale_) {
+                graph_ = PoolGraph::build(objects_, index_);
+                graph_stale_ = false;
             }
-            return dp::nullopt;
+            return graph_;
+        }
+
+        // Reachable from the Working Set through children lists
+        bool reachable(ObjectID id) const {
+            u32 i = index_.find(id);
+            return i != ObjectIndex::NONE && graph().reachable(i);
+        }
+
+        // Every mask above `id` in the graph (see is_mask()), nearest first
+        dp::Vector<ObjectID> masks_containing(ObjectID id) const {
+            dp::Vector<ObjectID> masks;
+            u32 start = index_.find(id);
+            if (start == ObjectIndex::NONE)
+                return masks;
+            const auto &g = graph();
+            dp::Vector<u64> seen((objects_.size() + 63) / 64, 0);
+            dp::Vector<u32> queue;
+            queue.push_back(start);
+            seen[start / 64] |= u64(1) << (start % 64);
+            for (usize q = 0; q < queue.size(); ++q) {
+                for (auto parent : g.parents(queue[q])) {
+                    u32 p = index_.find(parent);
+                    if (PoolGraph::test(seen, p))
+                        continue;
+                    seen[p / 64] |= u64(1) << (p % 64);
+                    queue.push_back(p);
+                    if (is_mask(objects_[p].type))
+                        masks.push_back(parent);
+                }
+            }
+            return masks;
+        }
+
+        // Drop the objects nothing uses: not reachable from the Working Set,
+        // nor from an object other objects may name in their attributes (see
+        // referenced_by_attribute()), which is kept along with what it lists.
+        // A pool without a Working Set is left alone. Returns how many went.
+        usize prune_unreachable() {
+            const auto &g = graph();
+            if (!g.has_root() || g.unreachable_count() == 0)
+                return 0;
+            dp::Vector<u32> roots;
+            roots.push_back(g.root());
+            for (u32 i = 0; i < objects_.size(); ++i) {
+                if (referenced_by_attribute(objects_[i].type))
+                    roots.push_back(i);
+            }
+            auto keep = g.reach(roots);
+            dp::Vector<VTObject> kept;
+            kept.reserve(objects_.size());
+            index_.clear();
+            for (u32 i = 0; i < objects_.size(); ++i) {
+                if (!PoolGraph::test(keep, i))
+                    continue;
+                index_.insert(objects_[i].id, static_cast<u32>(kept.size()));
+                kept.push_back(std::move(objects_[i]));
+            }
+            usize removed = objects_.size() - kept.size();
+            objects_ = std::move(kept);
+            graph_stale_ = true;
+            return removed;
+        }
+
+        // The reverse children index by ID, as PoolImage builds it
+        ParentIndex build_parent_index() const {
+            return ParentIndex::build([this](auto &&edge) {
+                for (const auto &obj : objects_) {
+                    for (auto child : obj.children)
+                        edge(obj.id, child);
+                }
+            });
+        }
+
+        // Size of the serialized pool, without serializing it
+        usize serialized_size() const noexcept {
+            usize size = 0;
+            for (const auto &obj : objects_)
+                size += obj.serialized_size();
+            return size;
+        }
+
+        // Append the serialized pool to `out` in one pass: sized once, then
+        // every object is written in place (lets a caller put a command byte
+        // in front without another copy)
+        void serialize_into(dp::Vector<u8> &out) const {
+            usize start = out.size();
+            out.resize(start + serialized_size());
+            u8 *p = out.data() + start;
+            for (const auto &obj : objects_)
+                p = obj.serialize_to(p);
         }
 
         Result<dp::Vector<u8>> serialize() const {
             dp::Vector<u8> data;
-            for (const auto &obj : objects_) {
-                auto bytes = obj.serialize();
-                data.insert(data.end(), bytes.begin(), bytes.end());
-            }
+            serialize_into(data);
             return Result<dp::Vector<u8>>::ok(std::move(data));
         }
 
         // Deserialize a pool from binary data (length-driven parsing)
         static Result<ObjectPool> deserialize(const dp::Vector<u8> &data) {
             ObjectPool pool;
+            pool.objects_.reserve(data.size() / 16); // Typical objects are a dozen bytes or more
             usize offset = 0;
 
             while (offset + 5 <= data.size()) {
@@ -206,49 +625,33 @@ namespace agrobus::isobus::vt {
         }
 
         // ─── Pool validation (ISO 11783-6 §4.6.8) ────────────────────────────────
+        // One pass over the pool graph: O(objects + edges)
         Result<void> validate() const {
-            // Count WorkingSet objects
-            u16 ws_count = 0;
-            for (const auto &obj : objects_) {
-                if (obj.type == ObjectType::WorkingSet)
-                    ws_count++;
-            }
-            if (ws_count == 0)
+            const auto &g = graph();
+            if (g.working_sets() == 0)
                 return Result<void>::err(Error::invalid_state("pool must contain exactly one Working Set object"));
-            if (ws_count > 1)
-                return Result<void>::err(Error::invalid_state(
-                    "pool must contain exactly one Working Set object, found " + dp::String(std::to_string(ws_count))));
+            if (g.working_sets() > 1)
+                return Result<void>::err(
+                    Error::invalid_state("pool must contain exactly one Working Set object, found " +
+                                         dp::String(std::to_string(g.working_sets()))));
 
             // Verify Working Set has at least one active mask (DataMask or AlarmMask child)
-            for (const auto &obj : objects_) {
-                if (obj.type == ObjectType::WorkingSet) {
-                    bool has_mask = false;
-                    for (auto child_id : obj.children) {
-                        auto child = find(child_id);
-                        if (child.has_value()) {
-                            auto child_type = (*child)->type;
-                            if (child_type == ObjectType::DataMask || child_type == ObjectType::AlarmMask) {
-                                has_mask = true;
-                                break;
-                            }
-                        }
-                    }
-                    if (!has_mask)
-                        return Result<void>::err(
-                            Error::invalid_state("Working Set must reference at least one Data Mask or Alarm Mask"));
+            bool has_mask = false;
+            for (auto child : g.children(g.root())) {
+                if (g.type(child) == ObjectType::DataMask || g.type(child) == ObjectType::AlarmMask) {
+                    has_mask = true;
                     break;
                 }
             }
+            if (!has_mask)
+                return Result<void>::err(
+                    Error::invalid_state("Working Set must reference at least one Data Mask or Alarm Mask"));
 
             // Verify no orphan object references (children point to existing objects)
-            for (const auto &obj : objects_) {
-                for (auto child_id : obj.children) {
-                    if (!find(child_id).has_value()) {
-                        return Result<void>::err(Error::invalid_state("object " + dp::String(std::to_string(obj.id)) +
-                                                                      " references non-existent child " +
-                                                                      dp::String(std::to_string(child_id))));
-                    }
-                }
+            if (g.dangling() > 0) {
+                return Result<void>::err(Error::invalid_state(
+                    "object " + dp::String(std::to_string(g.dangling_parent())) + " references non-existent child " +
+                    dp::String(std::to_string(g.dangling_child()))));
             }
 
             return {};
@@ -256,7 +659,62 @@ namespace agrobus::isobus::vt {
 
         usize size() const noexcept { return objects_.size(); }
         bool empty() const noexcept { return objects_.empty(); }
-        void clear() { objects_.clear(); }
+        void clear() {
+            objects_.clear();
+            index_.clear();
+            graph_ = {};
+            graph_stale_ = true;
+        }
+
+        // ─── Pool diff ───────────────────────────────────────────────────────────
+        // What changed from this pool to `newer`, IDs in pool order; one pass
+        // over each pool through the ID indexes
+        PoolDiff diff(const ObjectPool &newer) const {
+            PoolDiff d;
+            for (const auto &obj : objects_) {
+                auto other = newer.find(obj.id);
+                if (!other.has_value())
+                    d.removed.push_back(obj.id);
+                else if (!same_object(obj, **other))
+                    d.changed.push_back(obj.id);
+            }
+            for (const auto &obj : newer.objects_) {
+                if (!contains(obj.id))
+                    d.added.push_back(obj.id);
+            }
+            return d;
+        }
+
+        // The objects of `ids` that are in this pool, in pool order (a partial
+        // Object Pool Transfer)
+        ObjectPool subset(const dp::Vector<ObjectID> &ids) const {
+            ObjectIndex wanted;
+            for (auto id : ids)
+                wanted.insert(id, 0);
+            ObjectPool out;
+            for (const auto &obj : objects_) {
+                if (wanted.contains(obj.id))
+                    out.add(obj);
+            }
+            return out;
+        }
+
+        // `base` with the objects of `patch` replacing (in place) or adding to
+        // its own, as PoolImage::overlay() does for received pools
+        static ObjectPool overlay(const ObjectPool &base, const ObjectPool &patch) {
+            ObjectPool out;
+            out.version_label_ = base.version_label_;
+            out.objects_.reserve(base.size() + patch.size());
+            for (const auto &obj : base.objects_) {
+                auto replaced = patch.find(obj.id);
+                out.add(replaced.has_value() ? **replaced : obj);
+            }
+            for (const auto &obj : patch.objects_) {
+                if (!base.contains(obj.id))
+                    out.add(obj);
+            }
+            return out;
+        }
 
         const dp::Vector<VTObject> &objects() const noexcept { return objects_; }
 
@@ -269,6 +727,19 @@ namespace agrobus::isobus::vt {
             set_version_label(std::move(label));
             return *this;
         }
+
+      private:
+        static bool same_object(const VTObject &a, const VTObject &b) noexcept {
+            if (a.type != b.type || a.body.size() != b.body.size() || a.children.size() != b.children.size())
+                return false;
+            if (!a.body.empty() && std::memcmp(a.body.data(), b.body.data(), a.body.size()) != 0)
+                return false;
+            for (usize i = 0; i < a.children.size(); ++i) {
+                if (a.children[i] != b.children[i])
+                    return false;
+            }
+            return true;
+        }
     };
 
 } // namespace agrobus::isobus::vt
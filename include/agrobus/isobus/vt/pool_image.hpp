@@ -0,0 +1,364 @@
+#pragma once
+
+#include "objects.hpp"
+#include <agrobus/net/data_span.hpp>
+#include <agrobus/net/error.hpp>
+#include <agrobus/net/types.hpp>
+#include <datapod/datapod.hpp>
+#include <memory>
+
+namespace agrobus::isobus::vt {
+    using namespace agrobus::net;
+
+    // ─── Lazily decoded children list ────────────────────────────────────────────
+    // [count u16][count x ObjectID] read straight from the pool bytes
+    class ChildList {
+        const u8 *data_ = nullptr;
+        u16 count_ = 0;
+
+      public:
+        ChildList() = default;
+        ChildList(const u8 *data, u16 count) : data_(data), count_(count) {}
+
+        u16 size() const noexcept { return count_; }
+        bool empty() const noexcept { return count_ == 0; }
+        ObjectID operator[](u16 i) const noexcept {
+            return static_cast<ObjectID>(data_[i * 2]) | (static_cast<ObjectID>(data_[i * 2 + 1]) << 8);
+        }
+
+        dp::Vector<ObjectID> to_vector() const {
+            dp::Vector<ObjectID> out;
+            out.reserve(count_);
+            for (u16 i = 0; i < count_; ++i)
+                out.push_back((*this)[i]);
+            return out;
+        }
+    };
+
+    // ─── One object of a pool image ──────────────────────────────────────────────
+    // Points into the image: valid as long as the PoolImage (or a copy) lives
+    struct ObjectView {
+        ObjectID id = 0;
+        ObjectType type = ObjectType::WorkingSet;
+        DataSpan body;      // Same bytes as VTObject::body
+        ChildList children; // Empty unless the image knows where the list starts
+
+        VTObject to_object() const {
+            VTObject obj;
+            obj.id = id;
+            obj.type = type;
+            obj.body = dp::Vector<u8>(body.begin(), body.end());
+            obj.children = children.to_vector();
+            return obj;
+        }
+    };
+
+    // ─── Arena-backed object pool ────────────────────────────────────────────────
+    // The serialized pool is kept as one byte buffer; objects are small
+    // (offset, length, type) records into it plus the ID index. Loading a pool
+    // costs one pass over the bytes and two allocations, where ObjectPool
+    // allocates a body (and children) vector per object. The buffer is shared
+    // between copies and never modified, so a copy of the image is cheap and
+    // views stay valid while any copy lives. The owner is type-erased: a moved-in
+    // vector, or any other storage (a mapped file) that outlives the views.
+    //
+    // Bodies follow ObjectPool::deserialize: a parsed object's body is every
+    // byte after its header, children list included. Images built from an
+    // ObjectPool know where each children list starts and decode it on demand.
+    class PoolImage {
+        friend class PoolAssembler;
+
+        struct ObjectRef {
+            ObjectID id;
+            ObjectType type;
+            u32 offset;      // First body byte in the arena
+            u16 length;      // Body length from the header
+            u16 children_at; // Body offset of the children list, == length when there is none
+        };
+
+        std::shared_ptr<const void> owner_;
+        const u8 *data_ = nullptr;
+        usize size_ = 0;
+        dp::Vector<ObjectRef> refs_;
+        ObjectIndex index_;
+
+      public:
+        PoolImage() = default;
+
+        // ─── Construction ────────────────────────────────────────────────────────
+        // Takes the bytes over without copying them
+        static Result<PoolImage> parse(dp::Vector<u8> &&data) {
+            auto owned = std::make_shared<const dp::Vector<u8>>(std::move(data));
+            const u8 *bytes = owned->data();
+            usize size = owned->size();
+            return parse(std::shared_ptr<const void>(owned, bytes), bytes, size);
+        }
+
+        static Result<PoolImage> parse(const dp::Vector<u8> &data) { return parse(dp::Vector<u8>(data)); }
+
+        // Bytes owned by `owner`, which must keep [data, data + size) alive and unchanged
+        static Result<PoolImage> parse(std::shared_ptr<const void> owner, const u8 *data, usize size) {
+            PoolImage image = over(std::move(owner), data, size);
+
+            usize offset = 0;
+            while (offset + 5 <= size) {
+                ObjectRef ref;
+                ref.id = static_cast<ObjectID>(data[offset]) | (static_cast<ObjectID>(data[offset + 1]) << 8);
+                ref.type = static_cast<ObjectType>(data[offset + 2]);
+                ref.length = static_cast<u16>(data[offset + 3]) | (static_cast<u16>(data[offset + 4]) << 8);
+                ref.children_at = ref.length;
+                offset += 5;
+                if (offset + ref.length > size)
+                    return Result<PoolImage>::err(
+                        Error(ErrorCode::PoolValidation, "object body extends past pool data"));
+                ref.offset = static_cast<u32>(offset);
+                offset += ref.length;
+
+                auto r = image.push(ref);
+                if (!r.is_ok())
+                    return Result<PoolImage>::err(r.error());
+            }
+            return Result<PoolImage>::ok(std::move(image));
+        }
+
+        // Serialize `pool` into a fresh arena, keeping its children lists addressable
+        static Result<PoolImage> from_pool(const ObjectPool &pool) {
+            auto bytes = pool.serialize();
+            if (!bytes.is_ok())
+                return Result<PoolImage>::err(bytes.error());
+            auto result = parse(std::move(bytes.value()));
+            if (!result.is_ok())
+                return result;
+            PoolImage &image = result.value();
+            const auto &objects = pool.objects();
+            for (usize i = 0; i < objects.size() && i < image.refs_.size(); ++i) {
+                if (!objects[i].children.empty())
+                    image.refs_[i].children_at = static_cast<u16>(objects[i].body.size());
+            }
+            return result;
+        }
+
+        // `base` with the objects of `patch` replacing (in place) or adding to
+        // its own, as a later Object Pool Transfer does on a VT. Both images
+        // must hold serialized pools (from parse() or from_pool()).
+        static Result<PoolImage> overlay(const PoolImage &base, const PoolImage &patch) {
+            dp::Vector<u8> bytes;
+            bytes.reserve(base.size_ + patch.size_);
+            auto append = [&bytes](const PoolImage &image, const ObjectRef &ref) {
+                const u8 *record = image.data_ + ref.offset - 5; // Header and body
+                bytes.insert(bytes.end(), record, record + 5 + ref.length);
+            };
+            for (const auto &ref : base.refs_) {
+                u32 i = patch.index_.find(ref.id);
+                append(i == ObjectIndex::NONE ? base : patch, i == ObjectIndex::NONE ? ref : patch.refs_[i]);
+            }
+            for (const auto &ref : patch.refs_) {
+                if (!base.contains(ref.id))
+                    append(patch, ref);
+            }
+            return parse(std::move(bytes));
+        }
+
+        // Empty image over an arena in another layout (an IOP file); the reader
+        // that knows the layout registers each object with add()
+        static PoolImage over(std::shared_ptr<const void> owner, const u8 *data, usize size) {
+            PoolImage image;
+            image.owner_ = std::move(owner);
+            image.data_ = data;
+            image.size_ = size;
+            image.refs_.reserve(size / 16); // Typical objects are a dozen bytes or more
+            return image;
+        }
+
+        // Register an object whose body is [offset, offset + length) of the arena
+        Result<void> add(ObjectID id, ObjectType type, usize offset, usize length) {
+            if (offset > size_ || length > size_ - offset)
+                return Result<void>::err(Error(ErrorCode::PoolValidation, "object body extends past pool data"));
+            if (length > 0xFFFF)
+                return Result<void>::err(Error(ErrorCode::PoolValidation, "object body longer than 65535 bytes"));
+            ObjectRef ref;
+            ref.id = id;
+            ref.type = type;
+            ref.offset = static_cast<u32>(offset);
+            ref.length = static_cast<u16>(length);
+            ref.children_at = ref.length;
+            return push(ref);
+        }
+
+        // Back to one VTObject per object (copies every body)
+        ObjectPool to_pool() const {
+            ObjectPool pool;
+            for (usize i = 0; i < refs_.size(); ++i)
+                pool.add(view(refs_[i]).to_object());
+            return pool;
+        }
+
+        // ─── Access ──────────────────────────────────────────────────────────────
+        dp::Optional<ObjectView> find(ObjectID id) const {
+            u32 i = index_.find(id);
+            if (i == ObjectIndex::NONE)
+                return dp::nullopt;
+            return view(refs_[i]);
+        }
+
+        bool contains(ObjectID id) const noexcept { return index_.contains(id); }
+
+        // Objects in pool order
+        ObjectView operator[](usize i) const { return view(refs_[i]); }
+
+        template <typename Fn> void for_each(Fn &&fn) const {
+            for (const auto &ref : refs_)
+                fn(view(ref));
+        }
+
+        // Reverse children index over the children lists the image knows (those
+        // of images built by from_pool()). Built per call: keep the result.
+        ParentIndex build_parent_index() const {
+            return ParentIndex::build([this](auto &&edge) {
+                for (const auto &ref : refs_) {
+                    ChildList children = view(ref).children;
+                    for (u16 i = 0; i < children.size(); ++i)
+                        edge(ref.id, children[i]);
+                }
+            });
+        }
+
+        usize size() const noexcept { return refs_.size(); }
+        bool empty() const noexcept { return refs_.empty(); }
+
+        // The arena: the serialized pool, as received, for images from parse()
+        // and from_pool()
+        DataSpan bytes() const noexcept { return DataSpan(data_, size_); }
+
+        void clear() {
+            owner_.reset();
+            data_ = nullptr;
+            size_ = 0;
+            refs_.clear();
+            index_.clear();
+        }
+
+      private:
+        Result<void> push(const ObjectRef &ref) {
+            if (index_.contains(ref.id))
+                return Result<void>::err(Error::invalid_state("duplicate object ID"));
+            index_.insert(ref.id, static_cast<u32>(refs_.size()));
+            refs_.push_back(ref);
+            return {};
+        }
+
+        ObjectView view(const ObjectRef &ref) const noexcept {
+            ObjectView v;
+            v.id = ref.id;
+            v.type = ref.type;
+            const u8 *body = data_ + ref.offset;
+            v.body = DataSpan(body, ref.children_at);
+            if (ref.children_at + 2u <= ref.length) {
+                const u8 *list = body + ref.children_at;
+                u16 count = static_cast<u16>(list[0]) | (static_cast<u16>(list[1]) << 8);
+                u16 room = static_cast<u16>((ref.length - ref.children_at - 2) / 2);
+                v.children = ChildList(list + 2, count < room ? count : room);
+            }
+            return v;
+        }
+    };
+
+    // ─── Pool upload assembled piece by piece ────────────────────────────────────
+    // An upload can arrive in several Object Pool Transfers, or as the chunks
+    // of a streamed ETP transfer. Each piece is appended to one growing arena
+    // and every object is indexed as soon as its last byte is in, so parsing
+    // overlaps the transfer and finish() (at End of Object Pool) only checks
+    // that no object was left incomplete. An object may span pieces. Objects
+    // are kept as arena offsets, so the arena may move while it grows; its
+    // address is fixed once finish() hands it to the image.
+    class PoolAssembler {
+        dp::Vector<u8> bytes_;
+        PoolImage image_;  // Objects indexed so far, no arena attached yet
+        usize parsed_ = 0; // Bytes before this are whole objects
+        Error error_;
+        bool failed_ = false;
+
+      public:
+        // Expected upload size (Get Memory), to grow the arena once
+        void reserve(usize bytes) {
+            bytes_.reserve(bytes);
+            image_.refs_.reserve(bytes / 16);
+        }
+
+        // Copy a piece in; parse() indexes it. Split so the copy can happen
+        // where the piece arrived and the indexing elsewhere.
+        void write(DataSpan piece) { bytes_.insert(bytes_.end(), piece.begin(), piece.end()); }
+
+        // Index every object completed since the last call. A duplicate ID
+        // fails the whole upload.
+        Result<void> parse() {
+            if (failed_)
+                return Result<void>::err(error_);
+            const u8 *data = bytes_.data();
+            usize size = bytes_.size();
+            while (parsed_ + 5 <= size) {
+                const u8 *header = data + parsed_;
+                u16 length = static_cast<u16>(header[3]) | (static_cast<u16>(header[4]) << 8);
+                if (parsed_ + 5 + length > size)
+                    break; // Rest of the object comes with the next piece
+
+                PoolImage::ObjectRef ref;
+                ref.id = static_cast<ObjectID>(header[0]) | (static_cast<ObjectID>(header[1]) << 8);
+                ref.type = static_cast<ObjectType>(header[2]);
+                ref.offset = static_cast<u32>(parsed_ + 5);
+                ref.length = length;
+                ref.children_at = length;
+                auto r = image_.push(ref);
+                if (!r.is_ok()) {
+                    fail(r.error());
+                    return r;
+                }
+                parsed_ += 5 + length;
+            }
+            return {};
+        }
+
+        Result<void> append(DataSpan piece) {
+            write(piece);
+            return parse();
+        }
+
+        // Reject the upload; finish() reports `error`
+        void fail(Error error) {
+            if (!failed_) {
+                failed_ = true;
+                error_ = std::move(error);
+            }
+        }
+
+        // The image of everything appended; the assembler is empty again
+        Result<PoolImage> finish() {
+            if (failed_ || parsed_ != bytes_.size()) {
+                Error error = failed_ ? error_ : Error(ErrorCode::PoolValidation, "pool data ends inside an object");
+                reset();
+                return Result<PoolImage>::err(std::move(error));
+            }
+            auto owned = std::make_shared<const dp::Vector<u8>>(std::move(bytes_));
+            PoolImage image = std::move(image_);
+            image.data_ = owned->data();
+            image.size_ = owned->size();
+            image.owner_ = std::shared_ptr<const void>(owned, owned->data());
+            reset();
+            return Result<PoolImage>::ok(std::move(image));
+        }
+
+        void reset() {
+            bytes_.clear();
+            image_.clear();
+            parsed_ = 0;
+            error_ = Error{};
+            failed_ = false;
+        }
+
+        usize size() const noexcept { return bytes_.size(); }
+        usize objects() const noexcept { return image_.size(); }
+        usize pending() const noexcept { return bytes_.size() - parsed_; } // Of an object not complete yet
+        bool failed() const noexcept { return failed_; }
+    };
+
+} // namespace agrobus::isobus::vt
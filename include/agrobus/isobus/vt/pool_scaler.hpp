@@ -0,0 +1,305 @@
+#pragma once
+
+#include "objects.hpp"
+#include <agrobus/net/error.hpp>
+#include <agrobus/net/iop_parser.hpp>
+#include <agrobus/net/types.hpp>
+#include <cstdio>
+#include <datapod/datapod.hpp>
+#include <memory>
+
+namespace agrobus::isobus::vt {
+    using namespace agrobus::net;
+
+    // ─── VT display geometry ─────────────────────────────────────────────────────
+    // What a pool is drawn for: the data mask side in pixels (Get Hardware, X
+    // pixels; data masks are square) and the soft key designator size (Get
+    // Number of Soft Keys, X and Y dots)
+    struct VTGeometry {
+        u16 data_mask = 480;
+        u8 soft_key_width = 60;
+        u8 soft_key_height = 60;
+
+        bool operator==(const VTGeometry &) const = default;
+    };
+
+    // ─── Pool scaling ────────────────────────────────────────────────────────────
+    namespace scaling {
+        // Offsets of the width and height fields (u16 LE) in an object body
+        // (ISO 11783-6 object layouts); NONE when the type has no such field
+        inline constexpr u8 NONE = 0xFF;
+        struct SizeFields {
+            u8 width = NONE;
+            u8 height = NONE;
+        };
+
+        inline constexpr SizeFields size_fields(ObjectType type) noexcept {
+            switch (type) {
+            case ObjectType::Container:
+            case ObjectType::Button:
+            case ObjectType::InputString:
+            case ObjectType::InputNumber:
+            case ObjectType::InputList:
+            case ObjectType::OutputString:
+            case ObjectType::OutputNumber:
+            case ObjectType::Polygon:
+            case ObjectType::LinearBarGraph:
+            case ObjectType::ArchedBarGraph:
+                return {0, 2};
+            case ObjectType::Line:
+            case ObjectType::Rectangle:
+            case ObjectType::Ellipse:
+                return {2, 4}; // Behind the line attributes
+            case ObjectType::InputBoolean:
+                return {1, NONE}; // Behind the background colour
+            case ObjectType::Meter:
+            case ObjectType::PictureGraphic:
+                return {0, NONE}; // Height follows from the width
+            default:
+                return {};
+            }
+        }
+
+        // num / den of one axis
+        struct Ratio {
+            u32 num = 1;
+            u32 den = 1;
+        };
+
+        inline void scale_field(u8 *body, usize body_size, u8 at, Ratio r) {
+            if (at == NONE || at + 2u > body_size)
+                return;
+            u32 v = static_cast<u32>(body[at]) | (static_cast<u32>(body[at + 1]) << 8);
+            u32 scaled = (v * r.num + r.den / 2) / r.den;
+            if (scaled == 0 && v != 0)
+                scaled = 1; // A visible object stays visible
+            if (scaled > 0xFFFF)
+                scaled = 0xFFFF;
+            body[at] = static_cast<u8>(scaled & 0xFF);
+            body[at + 1] = static_cast<u8>(scaled >> 8);
+        }
+    } // namespace scaling
+
+    // `pool` serialized for a VT of geometry `vt` when it was drawn for
+    // `design`. Objects under a Key (its children, theirs, ...) scale with
+    // the soft key size, keeping their aspect (the smaller of the two
+    // ratios); everything else scales with the data mask. The bytes are
+    // patched in place after one serialize(), so the cost is one pass over
+    // the pool plus the walk below the keys. Fonts are left to the VT's own
+    // font substitution.
+    inline dp::Vector<u8> scale_pool(const ObjectPool &pool, VTGeometry design, VTGeometry vt) {
+        dp::Vector<u8> bytes = pool.serialize().value();
+        scaling::Ratio mask{vt.data_mask, design.data_mask ? design.data_mask : 1u};
+        scaling::Ratio key_w{vt.soft_key_width, design.soft_key_width ? design.soft_key_width : 1u};
+        scaling::Ratio key_h{vt.soft_key_height, design.soft_key_height ? design.soft_key_height : 1u};
+        scaling::Ratio key = key_w.num * key_h.den <= key_h.num * key_w.den ? key_w : key_h;
+
+        const auto &objects = pool.objects();
+        dp::Vector<u8> under_key(objects.size(), 0);
+        dp::Vector<ObjectID> stack;
+        for (const auto &obj : objects) {
+            if (obj.type == ObjectType::Key)
+                stack.insert(stack.end(), obj.children.begin(), obj.children.end());
+        }
+        while (!stack.empty()) {
+            ObjectID id = stack.back();
+            stack.pop_back();
+            auto found = pool.find(id);
+            if (!found.has_value())
+                continue;
+            usize i = static_cast<usize>(*found - objects.data());
+            if (under_key[i])
+                continue;
+            under_key[i] = 1;
+            stack.insert(stack.end(), (*found)->children.begin(), (*found)->children.end());
+        }
+
+        usize at = 0;
+        for (usize i = 0; i < objects.size(); ++i) {
+            const auto &obj = objects[i];
+            scaling::SizeFields fields = scaling::size_fields(obj.type);
+            u8 *body = bytes.data() + at + 5;
+            scaling::Ratio r = under_key[i] ? key : mask;
+            scaling::scale_field(body, obj.body.size(), fields.width, r);
+            scaling::scale_field(body, obj.body.size(), fields.height, r);
+            at += obj.serialized_size();
+        }
+        return bytes;
+    }
+
+    // ─── A pool scaled for one VT geometry ───────────────────────────────────────
+    struct ScaledPool {
+        dp::Vector<u8> bytes; // Serialized, ready for the Object Pool Transfer
+        dp::String label;     // Version label of `bytes` (IOPParser::version_label)
+    };
+
+    // ─── Scaled pool cache ───────────────────────────────────────────────────────
+    // Scaled pools keyed by (pool content hash, design geometry, VT geometry),
+    // so a VT model seen before gets its pool and version label without the
+    // pool being rescaled or rehashed. Pools are held within a byte budget,
+    // the least recently used going first; handed-out pools stay valid after
+    // eviction. save()/load() carry the cache over a key cycle. One cache may
+    // be shared by several VTClients (VTClient::set_scaled_pool_cache).
+    class ScaledPoolCache {
+        struct Entry {
+            u64 pool_hash = 0;
+            VTGeometry design;
+            VTGeometry vt;
+            u32 last_used = 0;
+            std::shared_ptr<const ScaledPool> pool;
+        };
+
+        dp::Vector<Entry> entries_;
+        usize budget_;
+        usize bytes_ = 0;
+        u32 clock_ = 0;
+        u64 hits_ = 0;
+        u64 misses_ = 0;
+
+        static constexpr u32 FILE_MAGIC = 0x53505643; // "CVPS"
+
+      public:
+        static constexpr usize DEFAULT_BUDGET = 4 * 1024 * 1024;
+
+        explicit ScaledPoolCache(usize budget_bytes = DEFAULT_BUDGET) : budget_(budget_bytes) {}
+
+        // The cached pool, or `pool` scaled, labelled and cached now.
+        // `pool_hash` is IOPParser::content_hash of the serialized design pool.
+        std::shared_ptr<const ScaledPool> get(u64 pool_hash, const ObjectPool &pool, VTGeometry design,
+                                              VTGeometry vt) {
+            if (auto hit = find(pool_hash, design, vt))
+                return hit;
+            ++misses_;
+            auto scaled = std::make_shared<ScaledPool>();
+            scaled->bytes = scale_pool(pool, design, vt);
+            scaled->label = IOPParser::version_label(IOPParser::content_hash(scaled->bytes));
+            insert(pool_hash, design, vt, scaled);
+            return scaled;
+        }
+
+        std::shared_ptr<const ScaledPool> find(u64 pool_hash, VTGeometry design, VTGeometry vt) {
+            for (auto &e : entries_) {
+                if (e.pool_hash == pool_hash && e.design == design && e.vt == vt) {
+                    ++hits_;
+                    e.last_used = ++clock_;
+                    return e.pool;
+                }
+            }
+            return nullptr;
+        }
+
+        void insert(u64 pool_hash, VTGeometry design, VTGeometry vt, std::shared_ptr<const ScaledPool> pool) {
+            for (usize i = 0; i < entries_.size(); ++i) {
+                if (entries_[i].pool_hash == pool_hash && entries_[i].design == design && entries_[i].vt == vt) {
+                    remove(i);
+                    break;
+                }
+            }
+            shrink(pool->bytes.size());
+            bytes_ += pool->bytes.size();
+            entries_.push_back(Entry{pool_hash, design, vt, ++clock_, std::move(pool)});
+        }
+
+        // ─── Persistence ─────────────────────────────────────────────────────────
+        // [magic u32] then per pool: [pool hash u64][design 4][vt 4][size u32]
+        // [bytes]; labels are recomputed on load
+        Result<void> save(const dp::String &path) const {
+            FILE *f = std::fopen(path.c_str(), "wb");
+            if (!f)
+                return Result<void>::err(Error(ErrorCode::DriverError, "cannot write scaled pool cache: " + path));
+            dp::Vector<u8> head;
+            put(head, FILE_MAGIC, 4);
+            bool ok = std::fwrite(head.data(), 1, head.size(), f) == head.size();
+            for (const auto &e : entries_) {
+                head.clear();
+                put(head, e.pool_hash, 8);
+                put_geometry(head, e.design);
+                put_geometry(head, e.vt);
+                put(head, e.pool->bytes.size(), 4);
+                ok = ok && std::fwrite(head.data(), 1, head.size(), f) == head.size();
+                ok = ok && std::fwrite(e.pool->bytes.data(), 1, e.pool->bytes.size(), f) == e.pool->bytes.size();
+            }
+            ok = std::fclose(f) == 0 && ok;
+            if (!ok)
+                return Result<void>::err(Error(ErrorCode::DriverError, "short write to scaled pool cache: " + path));
+            return {};
+        }
+
+        // Adds the pools of a file written by save(); a missing file is an
+        // empty cache, a damaged one is read up to the damage
+        Result<void> load(const dp::String &path) {
+            auto data = IOPParser::read_iop_file(path); // Reads any file whole
+            if (!data.is_ok())
+                return {};
+            DataSpan in(data.value());
+            if (in.size() < 4 || in.get_u32_le(0) != FILE_MAGIC)
+                return Result<void>::err(Error(ErrorCode::PoolValidation, "not a scaled pool cache: " + path));
+            usize at = 4;
+            while (at + 20 <= in.size()) {
+                u64 hash = in.get_u64_le(at);
+                VTGeometry design = get_geometry(in, at + 8);
+                VTGeometry vt = get_geometry(in, at + 12);
+                usize size = in.get_u32_le(at + 16);
+                at += 20;
+                if (size > in.size() - at)
+                    return Result<void>::err(Error(ErrorCode::PoolValidation, "truncated scaled pool cache: " + path));
+                auto pool = std::make_shared<ScaledPool>();
+                pool->bytes.assign(in.data() + at, in.data() + at + size);
+                pool->label = IOPParser::version_label(IOPParser::content_hash(pool->bytes));
+                insert(hash, design, vt, std::move(pool));
+                at += size;
+            }
+            return {};
+        }
+
+        void clear() {
+            entries_.clear();
+            bytes_ = 0;
+        }
+
+        usize budget() const noexcept { return budget_; }
+        usize bytes() const noexcept { return bytes_; }
+        usize size() const noexcept { return entries_.size(); }
+        u64 hits() const noexcept { return hits_; }
+        u64 misses() const noexcept { return misses_; }
+
+      private:
+        // Make room for `incoming` bytes; the newest pool is kept even when
+        // it alone is over the budget
+        void shrink(usize incoming) {
+            while (!entries_.empty() && bytes_ + incoming > budget_) {
+                usize oldest = 0;
+                for (usize i = 1; i < entries_.size(); ++i) {
+                    if (entries_[i].last_used < entries_[oldest].last_used)
+                        oldest = i;
+                }
+                remove(oldest);
+            }
+        }
+
+        void remove(usize i) {
+            bytes_ -= entries_[i].pool->bytes.size();
+            entries_.erase(entries_.begin() + static_cast<isize>(i));
+        }
+
+        static void put(dp::Vector<u8> &out, u64 v, u8 bytes) {
+            for (u8 i = 0; i < bytes; ++i)
+                out.push_back(static_cast<u8>(v >> (i * 8)));
+        }
+
+        static void put_geometry(dp::Vector<u8> &out, VTGeometry g) {
+            put(out, g.data_mask, 2);
+            out.push_back(g.soft_key_width);
+            out.push_back(g.soft_key_height);
+        }
+
+        static VTGeometry get_geometry(DataSpan in, usize at) {
+            VTGeometry g;
+            g.data_mask = in.get_u16_le(at);
+            g.soft_key_width = in[at + 2];
+            g.soft_key_height = in[at + 3];
+            return g;
+        }
+    };
+
+} // namespace agrobus::isobus::vt
@@ -0,0 +1,442 @@
+#pragma once
+
+#include "change_journal.hpp"
+#include "objects.hpp"
+#include "pool_image.hpp"
+#include <agrobus/net/data_span.hpp>
+#include <agrobus/net/error.hpp>
+#include <agrobus/net/types.hpp>
+#include <datapod/datapod.hpp>
+#include <cstring>
+
+#if !defined(AGROBUS_SIMD_DISABLED) && defined(__AVX2__)
+#include <immintrin.h>
+#define AGROBUS_PICTURE_AVX2 1
+#elif !defined(AGROBUS_SIMD_DISABLED) && defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define AGROBUS_PICTURE_NEON 1
+#endif
+
+namespace agrobus::isobus::vt {
+    using namespace agrobus::net;
+
+    // ─── Picture Graphic (ISO 11783-6 Annex B.12) ────────────────────────────────
+    // Body layout:
+    //   [0..1]   Width (displayed, LE)
+    //   [2..3]   Actual width (LE)
+    //   [4..5]   Actual height (LE)
+    //   [6]      Format: 0 = monochrome, 1 = 4 bit colour, 2 = 8 bit colour
+    //   [7]      Options: bit 0 transparent, bit 1 flashing, bit 2 run-length encoded
+    //   [8]      Transparency colour
+    //   [9..12]  Raw data length (LE)
+    //   [13]     Number of macros
+    //   [14..]   Raw data, then the macro list
+    // Each row of raw data starts on a byte boundary. Run-length encoded data is
+    // (count, byte) pairs of the packed row bytes.
+    enum class PictureFormat : u8 { Monochrome = 0, Colour4Bit = 1, Colour8Bit = 2 };
+
+    struct DecodedPicture {
+        u16 width = 0; // Displayed width: scaling to it is left to the renderer
+        u16 actual_width = 0;
+        u16 actual_height = 0;
+        PictureFormat format = PictureFormat::Colour8Bit;
+        bool transparent = false;
+        bool flashing = false;
+        u8 transparency_colour = 0;
+        dp::Vector<u8> pixels; // One colour index per pixel, row-major, actual_width x actual_height
+
+        u8 at(u16 x, u16 y) const noexcept { return pixels[usize(y) * actual_width + x]; }
+        usize bytes() const noexcept { return sizeof(DecodedPicture) + pixels.size(); }
+    };
+
+    // ─── Font Attributes (ISO 11783-6 Annex B.14) ────────────────────────────────
+    // Body layout: [0] colour, [1] size, [2] type, [3] style, [4] number of macros
+    struct FontStyle {
+        u8 colour = 0;
+        u8 size = 0;
+        u8 type = 0;
+        u8 style = 0;
+        u16 char_width = 0;  // 0 for a proportional font: only the height is fixed
+        u16 char_height = 0;
+
+        bool proportional() const noexcept { return (size & 0x80) != 0; }
+    };
+
+    namespace picture {
+        inline constexpr usize HEADER = 14;
+
+        // Monochrome byte -> its 8 pixels as indexes 0/1, so a row unpacks with
+        // one table lookup and one 8 byte store per input byte
+        inline const dp::Array<u64, 256> &mono_table() {
+            static const dp::Array<u64, 256> table = [] {
+                dp::Array<u64, 256> t{};
+                for (u32 b = 0; b < 256; ++b) {
+                    u8 px[8];
+                    for (u32 i = 0; i < 8; ++i)
+                        px[i] = static_cast<u8>((b >> (7 - i)) & 1);
+                    std::memcpy(&t[b], px, 8);
+                }
+                return t;
+            }();
+            return table;
+        }
+
+        // One packed row to one index per pixel. With AVX2 monochrome rows
+        // unpack 32 pixels and 4 bit rows 64 pixels per step (16 and 32 with
+        // NEON) unless the build sets AGROBUS_SIMD_DISABLED; the table and the
+        // scalar loop finish the row.
+        inline void unpack_row(PictureFormat format, const u8 *in, u8 *out, u16 width) {
+            switch (format) {
+            case PictureFormat::Monochrome: {
+                const auto &table = mono_table();
+                u32 x = 0;
+#if defined(AGROBUS_PICTURE_AVX2)
+                // Each input byte spread over 8 lanes, tested against its bit, MSB first
+                const __m256i spread = _mm256_setr_epi8(0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1, 2, 2, 2, 2, 2,
+                                                        2, 2, 2, 3, 3, 3, 3, 3, 3, 3, 3);
+                const __m256i bits = _mm256_set1_epi64x(0x0102040810204080);
+                const __m256i one = _mm256_set1_epi8(1);
+                for (; x + 32 <= width; x += 32, in += 4) {
+                    i32 word;
+                    std::memcpy(&word, in, 4);
+                    __m256i v = _mm256_shuffle_epi8(_mm256_set1_epi32(word), spread);
+                    __m256i set = _mm256_cmpeq_epi8(_mm256_and_si256(v, bits), bits);
+                    _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + x), _mm256_and_si256(set, one));
+                }
+#elif defined(AGROBUS_PICTURE_NEON)
+                const uint8x16_t bits = vreinterpretq_u8_u64(vdupq_n_u64(0x0102040810204080));
+                const uint8x16_t one = vdupq_n_u8(1);
+                for (; x + 16 <= width; x += 16, in += 2) {
+                    uint8x16_t v = vcombine_u8(vdup_n_u8(in[0]), vdup_n_u8(in[1]));
+                    vst1q_u8(out + x, vandq_u8(vtstq_u8(v, bits), one));
+                }
+#endif
+                for (; x + 8 <= width; x += 8)
+                    std::memcpy(out + x, &table[*in++], 8);
+                if (x < width) {
+                    u8 px[8];
+                    std::memcpy(px, &table[*in], 8);
+                    std::memcpy(out + x, px, width - x);
+                }
+                break;
+            }
+            case PictureFormat::Colour4Bit: {
+                u32 x = 0;
+#if defined(AGROBUS_PICTURE_AVX2)
+                // High and low nibbles interleave per 128-bit lane; the permutes put the lanes back in order
+                const __m256i low = _mm256_set1_epi8(0x0F);
+                for (; x + 64 <= width; x += 64, in += 32) {
+                    __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(in));
+                    __m256i hi = _mm256_and_si256(_mm256_srli_epi16(v, 4), low);
+                    __m256i lo = _mm256_and_si256(v, low);
+                    __m256i a = _mm256_unpacklo_epi8(hi, lo);
+                    __m256i b = _mm256_unpackhi_epi8(hi, lo);
+                    _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + x), _mm256_permute2x128_si256(a, b, 0x20));
+                    _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + x + 32),
+                                        _mm256_permute2x128_si256(a, b, 0x31));
+                }
+#elif defined(AGROBUS_PICTURE_NEON)
+                const uint8x16_t low = vdupq_n_u8(0x0F);
+                for (; x + 32 <= width; x += 32, in += 16) {
+                    uint8x16_t v = vld1q_u8(in);
+                    uint8x16x2_t px = {{vshrq_n_u8(v, 4), vandq_u8(v, low)}};
+                    vst2q_u8(out + x, px);
+                }
+#endif
+                for (; x + 2 <= width; x += 2, ++in) {
+                    out[x] = *in >> 4;
+                    out[x + 1] = *in & 0x0F;
+                }
+                if (x < width)
+                    out[x] = *in >> 4;
+                break;
+            }
+            case PictureFormat::Colour8Bit:
+                std::memcpy(out, in, width);
+                break;
+            }
+        }
+
+        inline usize row_bytes(PictureFormat format, u16 width) noexcept {
+            switch (format) {
+            case PictureFormat::Monochrome:
+                return (usize(width) + 7) / 8;
+            case PictureFormat::Colour4Bit:
+                return (usize(width) + 1) / 2;
+            default:
+                return width;
+            }
+        }
+
+        // Expand (count, byte) pairs into `out`, `size` bytes exactly. With
+        // AVX2 (NEON) a run of up to 32 (16) bytes is one broadcast store while
+        // there is room for the whole vector; the bytes it writes past the run
+        // are overwritten by the runs after it. Longer runs use memset.
+        inline Result<void> expand_rle(DataSpan raw, u8 *out, usize size) {
+            usize pos = 0;
+            for (usize i = 0; i + 1 < raw.size() && pos < size; i += 2) {
+                usize run = raw.data()[i];
+                u8 value = raw.data()[i + 1];
+                if (run > size - pos)
+                    run = size - pos;
+#if defined(AGROBUS_PICTURE_AVX2)
+                if (run <= 32 && size - pos >= 32) {
+                    _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + pos),
+                                        _mm256_set1_epi8(static_cast<char>(value)));
+                    pos += run;
+                    continue;
+                }
+#elif defined(AGROBUS_PICTURE_NEON)
+                if (run <= 16 && size - pos >= 16) {
+                    vst1q_u8(out + pos, vdupq_n_u8(value));
+                    pos += run;
+                    continue;
+                }
+#endif
+                std::memset(out + pos, value, run);
+                pos += run;
+            }
+            if (pos < size)
+                return Result<void>::err(Error(ErrorCode::PoolValidation, "picture graphic RLE data too short"));
+            return {};
+        }
+    } // namespace picture
+
+    inline Result<DecodedPicture> decode_picture(DataSpan body) {
+        if (body.size() < picture::HEADER)
+            return Result<DecodedPicture>::err(Error(ErrorCode::PoolValidation, "picture graphic body too short"));
+        DecodedPicture pic;
+        pic.width = body.get_u16_le(0);
+        pic.actual_width = body.get_u16_le(2);
+        pic.actual_height = body.get_u16_le(4);
+        u8 format = body[6];
+        u8 options = body[7];
+        pic.transparency_colour = body[8];
+        u32 raw_len = body.get_u32_le(9);
+        if (format > 2)
+            return Result<DecodedPicture>::err(Error(ErrorCode::PoolValidation, "unknown picture graphic format"));
+        if (raw_len > body.size() - picture::HEADER)
+            return Result<DecodedPicture>::err(
+                Error(ErrorCode::PoolValidation, "picture graphic raw data extends past its body"));
+        pic.format = static_cast<PictureFormat>(format);
+        pic.transparent = (options & 0x01) != 0;
+        pic.flashing = (options & 0x02) != 0;
+
+        DataSpan raw = body.subspan(picture::HEADER, raw_len);
+        usize stride = picture::row_bytes(pic.format, pic.actual_width);
+        usize packed_size = stride * pic.actual_height;
+        dp::Vector<u8> expanded;
+        const u8 *packed = raw.data();
+        if (options & 0x04) {
+            expanded.resize(packed_size);
+            if (auto r = picture::expand_rle(raw, expanded.data(), packed_size); !r.is_ok())
+                return Result<DecodedPicture>::err(r.error());
+            packed = expanded.data();
+        } else if (raw.size() < packed_size) {
+            return Result<DecodedPicture>::err(Error(ErrorCode::PoolValidation, "picture graphic raw data too short"));
+        }
+
+        pic.pixels.resize(usize(pic.actual_width) * pic.actual_height);
+        for (u16 y = 0; y < pic.actual_height; ++y)
+            picture::unpack_row(pic.format, packed + y * stride, pic.pixels.data() + usize(y) * pic.actual_width,
+                                pic.actual_width);
+        return Result<DecodedPicture>::ok(std::move(pic));
+    }
+
+    inline Result<FontStyle> decode_font(DataSpan body) {
+        // Character cell of the non-proportional sizes, width and height
+        static constexpr u8 CELLS[15][2] = {{6, 8},    {8, 8},    {8, 12},   {12, 16},  {16, 16},
+                                            {16, 24},  {24, 32},  {32, 32},  {32, 48},  {48, 64},
+                                            {64, 64},  {64, 96},  {96, 128}, {128, 128}, {128, 192}};
+        if (body.size() < 4)
+            return Result<FontStyle>::err(Error(ErrorCode::PoolValidation, "font attributes body too short"));
+        FontStyle font;
+        font.colour = body[0];
+        font.size = body[1];
+        font.type = body[2];
+        font.style = body[3];
+        if (font.proportional()) {
+            font.char_height = font.size & 0x7F;
+        } else if (font.size < 15) {
+            font.char_width = CELLS[font.size][0];
+            font.char_height = CELLS[font.size][1];
+        } else {
+            return Result<FontStyle>::err(Error(ErrorCode::PoolValidation, "unknown font size"));
+        }
+        return Result<FontStyle>::ok(font);
+    }
+
+    // ─── Decoded resource cache ──────────────────────────────────────────────────
+    // Picture Graphic and Font Attributes objects decoded on first use and kept
+    // for the next frames, keyed by (pool version, object ID): a new pool misses
+    // by itself, a changed object is dropped through invalidate(). Pictures are
+    // held within a byte budget, the least recently used going first. An entry
+    // larger than the whole budget is still kept, alone, until the next miss.
+    //
+    // A VTServer client's version is ServerWorkingSet::pool_version; its change
+    // sets come from VTServer::take_changes().
+    class VTResourceCache {
+        struct Entry {
+            u64 key = 0;
+            u32 last_used = 0;
+            bool font = false;
+            DecodedPicture picture;
+            FontStyle font_style;
+
+            usize bytes() const noexcept { return font ? sizeof(Entry) : sizeof(Entry) + picture.pixels.size(); }
+        };
+
+        dp::Vector<Entry> entries_;
+        dp::Map<u64, u32> slots_; // Key -> index into entries_
+        usize budget_;
+        usize bytes_ = 0;
+        u32 clock_ = 0;
+        u64 hits_ = 0;
+        u64 misses_ = 0;
+        u64 evictions_ = 0;
+
+      public:
+        static constexpr usize DEFAULT_BUDGET = 8 * 1024 * 1024;
+
+        explicit VTResourceCache(usize budget_bytes = DEFAULT_BUDGET) : budget_(budget_bytes) {}
+
+        // The decoded picture; valid until the next picture() or font() call
+        template <typename Pool> Result<const DecodedPicture *> picture(u32 version, const Pool &pool, ObjectID id) {
+            if (auto *e = lookup(key(version, id), false))
+                return Result<const DecodedPicture *>::ok(&e->picture);
+            auto body = body_of(pool, id, ObjectType::PictureGraphic);
+            if (!body.is_ok())
+                return Result<const DecodedPicture *>::err(body.error());
+            auto decoded = decode_picture(body.value());
+            if (!decoded.is_ok())
+                return Result<const DecodedPicture *>::err(decoded.error());
+            Entry e;
+            e.picture = std::move(decoded.value());
+            return Result<const DecodedPicture *>::ok(&insert(key(version, id), std::move(e)).picture);
+        }
+
+        template <typename Pool> Result<FontStyle> font(u32 version, const Pool &pool, ObjectID id) {
+            if (auto *e = lookup(key(version, id), true))
+                return Result<FontStyle>::ok(e->font_style);
+            auto body = body_of(pool, id, ObjectType::FontAttributes);
+            if (!body.is_ok())
+                return Result<FontStyle>::err(body.error());
+            auto decoded = decode_font(body.value());
+            if (!decoded.is_ok())
+                return Result<FontStyle>::err(decoded.error());
+            Entry e;
+            e.font = true;
+            e.font_style = decoded.value();
+            return Result<FontStyle>::ok(insert(key(version, id), std::move(e)).font_style);
+        }
+
+        // ─── Invalidation ────────────────────────────────────────────────────────
+        void invalidate(u32 version, ObjectID id) {
+            auto it = slots_.find(key(version, id));
+            if (it != slots_.end())
+                remove(it->second);
+        }
+
+        // Every object a frame changed (a later transfer, Change Attribute, ...)
+        void invalidate(u32 version, const VTChangeSet &changes) {
+            if (slots_.empty())
+                return;
+            for (auto id : changes.changed)
+                invalidate(version, id);
+        }
+
+        // Everything decoded from one pool version (the pool was replaced)
+        void drop_version(u32 version) {
+            for (usize i = entries_.size(); i-- > 0;) {
+                if ((entries_[i].key >> 16) == version)
+                    remove(static_cast<u32>(i));
+            }
+        }
+
+        void clear() {
+            entries_.clear();
+            slots_.clear();
+            bytes_ = 0;
+        }
+
+        void set_budget(usize budget_bytes) {
+            budget_ = budget_bytes;
+            shrink(0);
+        }
+
+        usize budget() const noexcept { return budget_; }
+        usize bytes() const noexcept { return bytes_; }
+        usize size() const noexcept { return entries_.size(); }
+        u64 hits() const noexcept { return hits_; }
+        u64 misses() const noexcept { return misses_; }
+        u64 evictions() const noexcept { return evictions_; }
+
+      private:
+        static u64 key(u32 version, ObjectID id) noexcept { return (u64(version) << 16) | id; }
+
+        static Result<DataSpan> body_of(const PoolImage &pool, ObjectID id, ObjectType type) {
+            auto obj = pool.find(id);
+            if (!obj.has_value() || obj->type != type)
+                return Result<DataSpan>::err(Error::invalid_state("no such resource object"));
+            return Result<DataSpan>::ok(obj->body);
+        }
+
+        static Result<DataSpan> body_of(const ObjectPool &pool, ObjectID id, ObjectType type) {
+            auto obj = pool.find(id);
+            if (!obj.has_value() || (*obj)->type != type)
+                return Result<DataSpan>::err(Error::invalid_state("no such resource object"));
+            return Result<DataSpan>::ok(DataSpan((*obj)->body));
+        }
+
+        Entry *lookup(u64 k, bool font) {
+            auto it = slots_.find(k);
+            if (it == slots_.end() || entries_[it->second].font != font) {
+                ++misses_;
+                return nullptr;
+            }
+            ++hits_;
+            auto &e = entries_[it->second];
+            e.last_used = ++clock_;
+            return &e;
+        }
+
+        Entry &insert(u64 k, Entry e) {
+            auto it = slots_.find(k);
+            if (it != slots_.end())
+                remove(it->second); // Same key, other kind
+            shrink(e.bytes());
+            e.key = k;
+            e.last_used = ++clock_;
+            bytes_ += e.bytes();
+            slots_[k] = static_cast<u32>(entries_.size());
+            entries_.push_back(std::move(e));
+            return entries_.back();
+        }
+
+        // Evict least recently used entries until `incoming` more bytes fit
+        void shrink(usize incoming) {
+            while (!entries_.empty() && bytes_ + incoming > budget_) {
+                u32 oldest = 0;
+                for (u32 i = 1; i < entries_.size(); ++i) {
+                    if (clock_ - entries_[i].last_used > clock_ - entries_[oldest].last_used)
+                        oldest = i;
+                }
+                remove(oldest);
+                ++evictions_;
+            }
+        }
+
+        // Swap with the last entry and pop
+        void remove(u32 i) {
+            bytes_ -= entries_[i].bytes();
+            slots_.erase(slots_.find(entries_[i].key));
+            u32 last = static_cast<u32>(entries_.size() - 1);
+            if (i != last) {
+                entries_[i] = std::move(entries_[last]);
+                slots_[entries_[i].key] = i;
+            }
+            entries_.pop_back();
+        }
+    };
+
+} // namespace agrobus::isobus::vt
@@ -3,12 +3,14 @@
 #include "commands.hpp"
 #include "objects.hpp"
 #include "server_working_set.hpp"
+#include "version_store.hpp"
 #include "working_set.hpp"
 #include <agrobus/net/constants.hpp>
 #include <agrobus/net/control_function.hpp>
 #include <agrobus/net/error.hpp>
 #include <agrobus/net/event.hpp>
 #include <agrobus/net/internal_cf.hpp>
+#include <agrobus/net/memory_budget.hpp>
 #include <agrobus/net/message.hpp>
 #include <agrobus/net/network_manager.hpp>
 #include <agrobus/net/state_machine.hpp>
@@ -20,15 +22,34 @@ namespace agrobus::isobus::vt {
 
     // ─── VT Server state ─────────────────────────────────────────────────────────
     enum class VTServerState { Disconnected, WaitForClientStatus, SendWorkingSetMaster, WaitForPoolUpload, Connected };
+    constexpr usize state_count(VTServerState) { return static_cast<usize>(VTServerState::Connected) + 1; }
 
     // ─── VT Server status message timing ─────────────────────────────────────────
     inline constexpr u32 VT_STATUS_INTERVAL_MS = 1000;
 
+    // ─── Commands a client may queue behind its upload ───────────────────────────
+    inline constexpr usize VT_SERVER_MAX_DEFERRED = 256;
+
     // ─── VT Server configuration ──────────────────────────────────────────────
     struct VTServerConfig {
         u16 screen_width = 480;
         u16 screen_height = 480;
         u16 vt_version = 5;
+        // Get Number of Soft Keys answer: designator size and keys per mask
+        u8 soft_key_width = 60;
+        u8 soft_key_height = 60;
+        u8 virtual_soft_keys = 64;
+        u8 physical_soft_keys = 6;
+        // Take Object Pool Transfers above the TP limit as ETP chunks and index
+        // them while they arrive, instead of after the whole transfer is in.
+        // Streams every ECU to VT ETP transfer of the network.
+        bool stream_pool_transfers = false;
+        // Keep stored pool versions in this file (VTVersionStore), keyed by the
+        // client's NAME, instead of in RAM for as long as the server runs
+        dp::String version_store_path;
+        // Pools, uploads and in-RAM stored versions are charged here; an upload
+        // or version that would not fit is answered "not enough memory"
+        MemoryBudget *memory = nullptr;
 
         VTServerConfig &width(u16 w) {
             screen_width = w;
@@ -47,42 +68,102 @@ namespace agrobus::isobus::vt {
             screen_height = h;
             return *this;
         }
+        VTServerConfig &soft_keys(u8 w, u8 h) {
+            soft_key_width = w;
+            soft_key_height = h;
+            return *this;
+        }
+        VTServerConfig &streamed(bool enable = true) {
+            stream_pool_transfers = enable;
+            return *this;
+        }
+        VTServerConfig &version_store(const dp::String &path) {
+            version_store_path = path;
+            return *this;
+        }
+        VTServerConfig &budget(MemoryBudget *b) {
+            memory = b;
+            return *this;
+        }
     };
 
     // ─── ISO 11783-6 Virtual Terminal Server ─────────────────────────────────────
+    // The VT status message is a periodic timer on the IsoNet timer wheel,
+    // running from IsoNet::update() between start() and stop(). Neither
+    // copyable nor movable: the timer and PGN callbacks hold `this`.
     class VTServer {
         IsoNet &net_;
         InternalCF *cf_;
         StateMachine<VTServerState> state_{VTServerState::Disconnected};
         dp::Vector<ServerWorkingSet> clients_;
-        u32 status_timer_ms_ = 0;
+        static constexpr u16 NO_CLIENT = 0xFFFF;
+        dp::Array<u16, 256> client_slot_; // Address -> index into clients_
+        u32 upload_seq_ = 0;
+        u32 pool_versions_ = 0;
+        TimerId status_timer_ = INVALID_TIMER;
         u16 vt_version_;
         u16 screen_width_;
         u16 screen_height_;
+        u8 soft_key_width_;
+        u8 soft_key_height_;
+        u8 virtual_soft_keys_;
+        u8 physical_soft_keys_;
         Address active_working_set_ = NULL_ADDRESS;
+        bool stream_pool_transfers_;
+        dp::String version_store_path_;
+        VTVersionStore versions_;
+        MemoryCharge memory_;
 
       public:
         VTServer(IsoNet &net, InternalCF *cf, VTServerConfig config = {})
             : net_(net), cf_(cf), vt_version_(config.vt_version), screen_width_(config.screen_width),
-              screen_height_(config.screen_height) {}
+              screen_height_(config.screen_height), soft_key_width_(config.soft_key_width),
+              soft_key_height_(config.soft_key_height), virtual_soft_keys_(config.virtual_soft_keys),
+              physical_soft_keys_(config.physical_soft_keys), stream_pool_transfers_(config.stream_pool_transfers),
+              version_store_path_(std::move(config.version_store_path)), memory_(config.memory) {
+            client_slot_.fill(NO_CLIENT);
+        }
+
+        VTServer(const VTServer &) = delete;
+        VTServer &operator=(const VTServer &) = delete;
+        VTServer(VTServer &&) = delete;
+        VTServer &operator=(VTServer &&) = delete;
+
+        ~VTServer() { net_.timers().cancel(status_timer_); }
 
         Result<void> start() {
+            if (!version_store_path_.empty() && !versions_.is_open()) {
+                if (auto r = versions_.open(version_store_path_); !r.is_ok())
+                    return r;
+            }
             state_.transition(VTServerState::WaitForClientStatus);
             net_.register_pgn_callback(PGN_ECU_TO_VT, [this](const Message &msg) { handle_ecu_message(msg); });
+            if (stream_pool_transfers_)
+                stream_transfers();
+            arm_status();
             echo::category("isobus.vt.server").info("VT Server started");
             return {};
         }
 
         Result<void> stop() {
             state_.transition(VTServerState::Disconnected);
+            net_.timers().cancel(status_timer_);
+            status_timer_ = INVALID_TIMER;
             clients_.clear();
+            client_slot_.fill(NO_CLIENT);
+            memory_.reset();
             echo::category("isobus.vt.server").info("VT Server stopped");
             return {};
         }
 
         VTServerState state() const noexcept { return state_.state(); }
+        const StateMachine<VTServerState> &state_machine() const noexcept { return state_; }
+        // Persistent stored versions (open once start() ran with a version_store path)
+        VTVersionStore &version_store() noexcept { return versions_; }
         u16 screen_width() const noexcept { return screen_width_; }
         u16 screen_height() const noexcept { return screen_height_; }
+        // Bytes of pools, uploads and in-RAM stored versions held for the clients
+        u64 memory_bytes() const noexcept { return memory_.bytes(); }
 
         // ─── Active Working Set management ────────────────────────────────────────
         Address active_working_set() const noexcept { return active_working_set_; }
@@ -162,6 +243,58 @@ namespace agrobus::isobus::vt {
 
         const dp::Vector<ServerWorkingSet> &clients() const noexcept { return clients_; }
 
+        // ─── Rendering ───────────────────────────────────────────────────────────
+        // What the client at `addr` changed since the last call (a frame):
+        // changed objects and the containers and masks above them
+        VTChangeSet take_changes(Address addr) {
+            auto *client = find_client(addr);
+            return client ? client->changes.take() : VTChangeSet{};
+        }
+
+        // Working set of the client at an address (nullptr if it never spoke to us)
+        const ServerWorkingSet *client(Address addr) const noexcept {
+            u16 slot = client_slot_[addr];
+            return slot != NO_CLIENT ? &clients_[slot] : nullptr;
+        }
+
+        // ─── Macros ──────────────────────────────────────────────────────────────
+        // Run Macro object `macro_id` of the client at `addr` (one of its objects'
+        // events fired, or it sent Execute Macro) from the table compiled when
+        // the pool arrived. Value changes apply as the client's own do, without
+        // a response; the commands the server does not model go to
+        // on_macro_command. False if the pool has no such macro.
+        bool execute_macro(Address addr, ObjectID macro_id) {
+            auto *client = find_client(addr);
+            if (!client)
+                return false;
+            auto program = client->macros.find(macro_id);
+            if (!program.has_value())
+                return false;
+            for (const auto &cmd : *program) {
+                switch (cmd.function) {
+                case vt_cmd::CHANGE_NUMERIC_VALUE:
+                    client->changes.mark(cmd.object);
+                    on_numeric_value_change.emit(cmd.object, cmd.value);
+                    break;
+                case vt_cmd::CHANGE_STRING_VALUE: {
+                    DataSpan chars = client->macros.bytes(cmd);
+                    dp::String value;
+                    for (usize i = 0; i < chars.size(); ++i)
+                        value += static_cast<char>(chars.data()[i]);
+                    client->changes.mark(cmd.object);
+                    on_string_value_change.emit(cmd.object, value);
+                    break;
+                }
+                case vt_cmd::EXECUTE_MACRO:
+                    break; // Macros do not nest
+                default:
+                    on_macro_command.emit(addr, client->macros.bytes(cmd));
+                    break;
+                }
+            }
+            return true;
+        }
+
         // ─── Events ──────────────────────────────────────────────────────────────
         Event<ObjectID, u8> on_button_activation;
         Event<ObjectID, u32> on_numeric_value_change;
@@ -172,20 +305,22 @@ namespace agrobus::isobus::vt {
         Event<Address> on_client_connected;
         Event<Address> on_client_disconnected;
         Event<Address, Address> on_active_ws_changed; // (old_addr, new_addr)
+        Event<Address, DataSpan> on_macro_command;    // (client, command bytes) run by a macro
 
         // ─── Update loop ─────────────────────────────────────────────────────────
         void update(u32 elapsed_ms) {
-            if (state_.state() == VTServerState::Disconnected)
-                return;
-
-            status_timer_ms_ += elapsed_ms;
-            if (status_timer_ms_ >= VT_STATUS_INTERVAL_MS) {
-                status_timer_ms_ -= VT_STATUS_INTERVAL_MS;
-                send_vt_status();
-            }
+            ProfileScope profile(net_.update_profiler(), "vt_server");
+            state_.advance(elapsed_ms);
         }
 
       private:
+        // VT status every interval on the network clock, the first one interval after start()
+        void arm_status() {
+            net_.timers().cancel(status_timer_);
+            u32 phase = static_cast<u32>(net_.timers().now_ms() % VT_STATUS_INTERVAL_MS);
+            status_timer_ = net_.timers().schedule_every(VT_STATUS_INTERVAL_MS, phase, [this]() { send_vt_status(); });
+        }
+
         void send_vt_status() {
             dp::Vector<u8> data(8, 0xFF);
             data[0] = vt_cmd::VT_STATUS;
@@ -203,16 +338,31 @@ namespace agrobus::isobus::vt {
             net_.send(PGN_VT_TO_ECU, data, cf_, nullptr, Priority::Default);
         }
 
+        // A client's commands run in the order they came: while its upload is
+        // being indexed they wait in its queue, and the other clients carry on
         void handle_ecu_message(const Message &msg) {
             if (msg.data.empty())
                 return;
+            if (auto *client = find_client(msg.source); client && busy(*client)) {
+                defer(*client, DeferredCommand{DeferredCommand::Kind::Command, msg});
+                return;
+            }
+            run_command(msg);
+        }
 
+        void run_command(const Message &msg) {
             u8 function = msg.data[0];
 
             switch (function) {
             case vt_cmd::GET_MEMORY:
                 handle_get_memory(msg);
                 break;
+            case vt_cmd::GET_HARDWARE:
+                handle_get_hardware(msg);
+                break;
+            case vt_cmd::GET_NUMBER_SOFTKEYS:
+                handle_get_number_soft_keys(msg);
+                break;
             case vt_cmd::OBJECT_POOL_TRANSFER:
                 handle_object_pool_transfer(msg);
                 break;
@@ -240,6 +390,9 @@ namespace agrobus::isobus::vt {
             case vt_cmd::CHANGE_STRING_VALUE:
                 handle_string_value_change(msg);
                 break;
+            case vt_cmd::EXECUTE_MACRO:
+                handle_execute_macro(msg);
+                break;
             default:
                 echo::category("isobus.vt.server")
                     .trace("Unhandled ECU->VT function: 0x", function, " from ", msg.source);
@@ -254,15 +407,25 @@ namespace agrobus::isobus::vt {
         }
 
         void handle_get_memory(const Message &msg) {
-            // Track client
-            ensure_client(msg.source);
+            // Track client; Get Memory starts a new upload, transfers replace the pool again
+            auto &client = ensure_client(msg.source);
+            client.pool_complete = false;
+            restart_upload(client);
+            account_memory();
+            u32 required = msg.data.size() >= 5 ? msg.get_u32_le(1) : 0;
+            bool enough = memory_.fits(required);
+            if (enough && required > 0)
+                client.upload.reserve(required);
 
             // Respond with memory available (addressed to requester)
             dp::Vector<u8> data(8, 0xFF);
             data[0] = vt_cmd::GET_MEMORY_RESPONSE;
             data[1] = vt_version_ & 0xFF;
-            data[2] = 0x00; // Enough memory (0 = sufficient)
+            data[2] = enough ? 0x00 : 0x01; // 0 = may be enough, 1 = not enough memory
             send_to_client(data, msg.source);
+            if (!enough)
+                echo::category("isobus.vt.server")
+                    .warn("Upload of ", required, " bytes from ", msg.source, " refused: memory budget");
 
             if (state_.state() == VTServerState::WaitForClientStatus) {
                 state_.transition(VTServerState::WaitForPoolUpload);
@@ -272,49 +435,234 @@ namespace agrobus::isobus::vt {
             echo::category("isobus.vt.server").debug("Get memory request from ", msg.source);
         }
 
+        // Get Hardware response: boot time, graphic type (2 = 256 colours),
+        // hardware features, data mask X and Y pixels
+        void handle_get_hardware(const Message &msg) {
+            dp::Vector<u8> data(8, 0xFF);
+            data[0] = vt_cmd::GET_HARDWARE;
+            data[2] = 2;
+            data[3] = 0x00;
+            data[4] = static_cast<u8>(screen_width_ & 0xFF);
+            data[5] = static_cast<u8>(screen_width_ >> 8);
+            data[6] = static_cast<u8>(screen_height_ & 0xFF);
+            data[7] = static_cast<u8>(screen_height_ >> 8);
+            send_to_client(data, msg.source);
+        }
+
+        // Get Number of Soft Keys response: [4] X dots, [5] Y dots, [6] virtual
+        // and [7] physical soft keys
+        void handle_get_number_soft_keys(const Message &msg) {
+            dp::Vector<u8> data(8, 0xFF);
+            data[0] = vt_cmd::GET_NUMBER_SOFTKEYS;
+            data[4] = soft_key_width_;
+            data[5] = soft_key_height_;
+            data[6] = virtual_soft_keys_;
+            data[7] = physical_soft_keys_;
+            send_to_client(data, msg.source);
+        }
+
         void handle_object_pool_transfer(const Message &msg) {
             // ISO 11783-6 F.39: Object Pool Transfer
             // [0] = 0x11 (Object Pool Transfer command)
             // [1..N] = pool data bytes
-            auto *client = find_client(msg.source);
-            if (!client) {
-                ensure_client(msg.source);
-                client = find_client(msg.source);
+            auto &client = ensure_client(msg.source);
+            if (msg.data.size() < 2) {
+                echo::category("isobus.vt.server").error("Object Pool Transfer too short from ", msg.source);
+                return;
             }
-            if (!client)
+            add_transfer(client, DataSpan(msg.data.data() + 1, msg.data.size() - 1), true);
+        }
+
+        // ─── Per-client command queue ────────────────────────────────────────────
+        bool busy(const ServerWorkingSet &client) const noexcept {
+            return client.pools_parsing > 0 || !client.deferred.empty();
+        }
+
+        void defer(ServerWorkingSet &client, DeferredCommand cmd) {
+            if (client.deferred.size() >= VT_SERVER_MAX_DEFERRED) {
+                echo::category("isobus.vt.server").warn("Command queue of ", client.client_address, " full: dropped");
+                if (cmd.kind != DeferredCommand::Kind::Command || cmd.msg.data[0] == vt_cmd::OBJECT_POOL_TRANSFER)
+                    client.upload_aborted = true; // The pool would have a hole: End of Object Pool fails
                 return;
+            }
+            if (cmd.kind == DeferredCommand::Kind::Command && cmd.msg.data[0] == vt_cmd::END_OF_POOL)
+                client.end_of_pool_waiting = true;
+            client.deferred.push_back(std::move(cmd));
+        }
 
-            // Strip the command byte and parse the pool data
-            if (msg.data.size() < 2) {
-                echo::category("isobus.vt.server").error("Object Pool Transfer too short from ", msg.source);
+        // Run the queued commands until one sends a transfer off to be indexed.
+        // The client is looked up again each time: running a command may have
+        // grown clients_.
+        void run_deferred(Address addr) {
+            for (auto *client = find_client(addr); client && client->pools_parsing == 0 && !client->deferred.empty();
+                 client = find_client(addr)) {
+                DeferredCommand cmd = std::move(client->deferred.front());
+                client->deferred.erase(client->deferred.begin());
+                switch (cmd.kind) {
+                case DeferredCommand::Kind::Command:
+                    if (cmd.msg.data[0] == vt_cmd::END_OF_POOL)
+                        client->end_of_pool_waiting = false;
+                    run_command(cmd.msg);
+                    break;
+                case DeferredCommand::Kind::Chunk:
+                    add_transfer(*client, DataSpan(cmd.msg.data.data(), cmd.msg.data.size()), false);
+                    break;
+                case DeferredCommand::Kind::Abort:
+                    client->upload_aborted = true;
+                    break;
+                }
+            }
+        }
+
+        // ─── Upload assembly ─────────────────────────────────────────────────────
+        // Every transfer of an upload goes into the client's PoolAssembler. The
+        // bytes are copied in here; indexing a whole transfer runs on the IsoNet
+        // work pool (inline when none is configured), the assembler travelling
+        // with the job. The client's later commands wait in its queue meanwhile,
+        // so the pieces are indexed in order and one at a time per client, while
+        // the uploads of different clients are indexed on the pool in parallel.
+        void restart_upload(ServerWorkingSet &client) {
+            client.pool_seq = ++upload_seq_; // Unique across stop() too: a late parse never lands in a new client
+            client.upload.reset();
+            client.streamed_transfer = false;
+            client.upload_aborted = false;
+        }
+
+        // Only called while the client is not busy()
+        void add_transfer(ServerWorkingSet &client, DataSpan piece, bool offload) {
+            if (!memory_.fits(piece.size())) {
+                echo::category("isobus.vt.server")
+                    .warn("Transfer from ", client.client_address, " dropped: memory budget");
+                client.upload_aborted = true; // End of Object Pool fails
+                return;
+            }
+            client.upload.write(piece);
+            account_memory();
+            if (!offload) {
+                index_upload(client);
                 return;
             }
-            dp::Vector<u8> pool_data(msg.data.begin() + 1, msg.data.end());
 
-            auto result = ObjectPool::deserialize(pool_data);
-            if (result.is_ok()) {
-                client->pool = std::move(result.value());
-                client->pool_uploaded = true;
+            ++client.pools_parsing;
+            u32 seq = client.pool_seq;
+            Address addr = client.client_address;
+            net_.offload(
+                [upload = std::move(client.upload)]() mutable {
+                    upload.parse(); // Errors stay in the assembler until finish()
+                    return std::move(upload);
+                },
+                [this, addr, seq](PoolAssembler upload) { upload_parsed(addr, seq, std::move(upload)); });
+        }
+
+        void index_upload(ServerWorkingSet &client) {
+            auto r = client.upload.parse();
+            if (!r.is_ok())
                 echo::category("isobus.vt.server")
-                    .info("Pool received from addr=", msg.source, ": ", client->pool.size(), " objects");
-            } else {
+                    .error("Pool upload from ", client.client_address, " rejected: ", r.error().message);
+        }
+
+        void upload_parsed(Address addr, u32 seq, PoolAssembler upload) {
+            auto *client = find_client(addr);
+            if (!client || seq != client->pool_seq)
+                return; // The server was stopped meanwhile
+            --client->pools_parsing;
+            client->upload = std::move(upload);
+            if (client->upload.failed())
+                index_upload(*client); // Reports the error
+            run_deferred(addr);
+        }
+
+        // End of Object Pool: the transfers were indexed as they came in, what
+        // is left is checking that the last object is whole
+        void complete_upload(ServerWorkingSet &client) {
+            if (client.upload_aborted)
+                client.upload.fail(Error::transport_aborted("streamed Object Pool Transfer aborted"));
+            usize bytes = client.upload.size();
+            auto result = client.upload.finish();
+            client.upload_aborted = false;
+            PoolImage patch;
+            if (result.is_ok() && client.pool_complete) {
+                // After End of Object Pool a transfer replaces or adds objects
+                patch = result.value();
+                result = PoolImage::overlay(client.pool, patch);
+            }
+            bool ok = result.is_ok() && !result.value().empty();
+            if (ok) {
+                client.pool = std::move(result.value());
+                client.pool_uploaded = true;
+                if (patch.empty()) {
+                    client.changes.set_pool(client.pool);
+                    client.pool_version = ++pool_versions_;
+                } else {
+                    client.changes.patch_pool(client.pool, patch);
+                }
+                client.macros = VTMacroTable::compile(client.pool);
+                echo::category("isobus.vt.server")
+                    .info("Pool received from addr=", client.client_address, ": ", client.pool.size(), " objects, ",
+                          bytes, " bytes");
+            } else if (!result.is_ok()) {
                 echo::category("isobus.vt.server")
-                    .error("Pool deserialization failed from ", msg.source, ": ", result.error().message);
+                    .error("Pool deserialization failed from ", client.client_address, ": ", result.error().message);
+            }
+            account_memory();
+            send_end_of_pool(client, ok);
+        }
+
+        // ETP transfers to the VT arrive as chunks (VTServerConfig::streamed)
+        void stream_transfers() {
+            auto &etp = net_.extended_transport_protocol();
+            etp.set_stream_filter([prev = etp.stream_filter()](PGN pgn, u32 bytes) {
+                return pgn == PGN_ECU_TO_VT || (prev && prev(pgn, bytes));
+            });
+            etp.on_chunk.subscribe([this](TransportSession &session, u32 offset, DataSpan bytes) {
+                handle_transfer_chunk(session, offset, bytes);
+            });
+            etp.on_abort.subscribe([this](TransportSession &session, TransportAbortReason) {
+                if (session.pgn != PGN_ECU_TO_VT || session.direction != TransportDirection::Receive)
+                    return;
+                auto *client = find_client(session.source_address);
+                if (!client || !client->streamed_transfer)
+                    return;
+                client->streamed_transfer = false;
+                if (busy(*client))
+                    defer(*client, DeferredCommand{DeferredCommand::Kind::Abort, {}});
+                else
+                    client->upload_aborted = true;
+            });
+        }
+
+        void handle_transfer_chunk(TransportSession &session, u32 offset, DataSpan bytes) {
+            if (session.pgn != PGN_ECU_TO_VT || session.direction != TransportDirection::Receive || bytes.empty())
+                return;
+            Address addr = session.source_address;
+            auto &client = ensure_client(addr);
+            if (offset == 0) {
+                client.streamed_transfer = bytes[0] == vt_cmd::OBJECT_POOL_TRANSFER;
+                if (!client.streamed_transfer) {
+                    echo::category("isobus.vt.server")
+                        .warn("Streamed message 0x", bytes[0], " from ", addr, " dropped");
+                    return;
+                }
+                bytes = DataSpan(bytes.data() + 1, bytes.size() - 1);
+            }
+            if (!client.streamed_transfer || bytes.empty())
+                return;
+            if (busy(client)) {
+                Message piece(PGN_ECU_TO_VT, Payload(bytes.data(), bytes.size()), addr);
+                defer(client, DeferredCommand{DeferredCommand::Kind::Chunk, std::move(piece)});
+            } else {
+                add_transfer(client, bytes, false); // One window: index right away
             }
         }
 
         void handle_store_version(const Message &msg) {
             // Store Version command: save current pool with version label
-            auto *client = find_client(msg.source);
-            if (!client) {
-                ensure_client(msg.source);
-                client = find_client(msg.source);
-            }
+            auto &client = ensure_client(msg.source);
 
             dp::Vector<u8> response(8, 0xFF);
             response[0] = vt_cmd::STORE_POOL;
 
-            if (!client || !client->pool_uploaded || client->pool.empty()) {
+            if (!client.pool_uploaded || client.pool.empty()) {
                 response[1] = 0x01; // error: no pool
                 send_to_client(response, msg.source);
                 return;
@@ -328,22 +676,31 @@ namespace agrobus::isobus::vt {
                     label += c;
             }
 
-            if (client->store_version(label)) {
+            bool stored;
+            bool room = true;
+            if (auto name = stored_versions_key(msg.source)) {
+                auto r = versions_.store(*name, label, client.pool.bytes());
+                if (!r.is_ok())
+                    echo::category("isobus.vt.server")
+                        .error("Storing version '", label, "' failed: ", r.error().message);
+                stored = r.is_ok();
+            } else {
+                room = memory_.fits(client.pool.bytes().size());
+                stored = room && client.store_version(label);
+                account_memory();
+            }
+            if (stored) {
                 response[1] = 0x00; // success
                 echo::category("isobus.vt.server").info("Stored version '", label, "' for addr=", msg.source);
             } else {
-                response[1] = 0x02; // error: storage failure
+                response[1] = room ? 0x02 : 0x04; // error: storage failure / insufficient memory
             }
             send_to_client(response, msg.source);
         }
 
         void handle_load_version(const Message &msg) {
             // Load Version command: load a previously stored pool
-            auto *client = find_client(msg.source);
-            if (!client) {
-                ensure_client(msg.source);
-                client = find_client(msg.source);
-            }
+            auto &client = ensure_client(msg.source);
 
             dp::Vector<u8> response(8, 0xFF);
             response[0] = vt_cmd::LOAD_POOL;
@@ -356,7 +713,19 @@ namespace agrobus::isobus::vt {
                     label += c;
             }
 
-            if (client && client->load_version(label)) {
+            bool loaded = false;
+            if (auto name = stored_versions_key(msg.source)) {
+                auto image = versions_.load(*name, label);
+                if (image.is_ok()) {
+                    client.use_pool(std::move(image.value()));
+                    loaded = true;
+                }
+            } else {
+                loaded = client.load_version(label);
+            }
+            account_memory();
+            if (loaded) {
+                client.pool_version = ++pool_versions_;
                 response[1] = 0x00; // success
                 if (state_.state() != VTServerState::Connected) {
                     state_.transition(VTServerState::Connected);
@@ -384,7 +753,13 @@ namespace agrobus::isobus::vt {
                     label += c;
             }
 
-            if (client && client->delete_version(label)) {
+            bool deleted;
+            if (auto name = stored_versions_key(msg.source))
+                deleted = versions_.erase(*name, label);
+            else
+                deleted = client && client->delete_version(label);
+            account_memory();
+            if (deleted) {
                 response[1] = 0x00;
                 echo::category("isobus.vt.server").info("Deleted version '", label, "'");
             } else {
@@ -399,12 +774,21 @@ namespace agrobus::isobus::vt {
             dp::Vector<u8> response;
             response.push_back(vt_cmd::GET_VERSIONS_RESPONSE);
 
-            if (client && !client->stored_versions.empty()) {
-                response.push_back(static_cast<u8>(client->stored_versions.size()));
-                for (const auto &ver : client->stored_versions) {
+            dp::Vector<dp::String> labels;
+            if (auto name = stored_versions_key(msg.source)) {
+                for (const auto &ver : versions_.list(*name))
+                    labels.push_back(ver.label);
+            } else if (client) {
+                for (const auto &ver : client->stored_versions)
+                    labels.push_back(ver.label);
+            }
+
+            if (!labels.empty()) {
+                response.push_back(static_cast<u8>(labels.size()));
+                for (const auto &label : labels) {
                     // Each label is exactly 7 bytes (space-padded)
                     for (usize i = 0; i < 7; ++i) {
-                        response.push_back((i < ver.label.size()) ? static_cast<u8>(ver.label[i]) : 0x20);
+                        response.push_back((i < label.size()) ? static_cast<u8>(label[i]) : 0x20);
                     }
                 }
             } else {
@@ -422,19 +806,23 @@ namespace agrobus::isobus::vt {
             if (!client)
                 return;
 
-            // Send END_OF_POOL response
+            complete_upload(*client); // The transfers before it are indexed: it waited in the queue otherwise
+        }
+
+        void send_end_of_pool(ServerWorkingSet &client, bool ok) {
             dp::Vector<u8> data(8, 0xFF);
             data[0] = vt_cmd::END_OF_POOL;
-            if (client->pool_uploaded && !client->pool.empty()) {
+            if (ok && client.pool_uploaded && !client.pool.empty()) {
+                client.pool_complete = true;
                 data[1] = 0x00; // No errors
                 echo::category("isobus.vt.server")
-                    .info("Pool upload complete from ", msg.source, ": ", client->pool.size(), " objects");
+                    .info("Pool upload complete from ", client.client_address, ": ", client.pool.size(), " objects");
             } else {
                 data[1] = 0x01; // Error: pool not received or empty
                 data[2] = 0x02; // Error code: other error
-                echo::category("isobus.vt.server").error("Pool upload failed from ", msg.source);
+                echo::category("isobus.vt.server").error("Pool upload failed from ", client.client_address);
             }
-            send_to_client(data, msg.source);
+            send_to_client(data, client.client_address);
         }
 
         void handle_pool_activate(const Message &msg) {
@@ -473,7 +861,14 @@ namespace agrobus::isobus::vt {
             ObjectID obj_id = static_cast<u16>(msg.data[1]) | (static_cast<u16>(msg.data[2]) << 8);
             u32 value = static_cast<u32>(msg.data[4]) | (static_cast<u32>(msg.data[5]) << 8) |
                         (static_cast<u32>(msg.data[6]) << 16) | (static_cast<u32>(msg.data[7]) << 24);
+            if (auto *client = find_client(msg.source))
+                client->changes.mark(obj_id);
             on_numeric_value_change.emit(obj_id, value);
+
+            // Response: [0xA8][object id][error codes][value]
+            dp::Vector<u8> response(msg.data.begin(), msg.data.begin() + 8);
+            response[3] = 0x00;
+            send_to_client(response, msg.source);
         }
 
         void handle_string_value_change(const Message &msg) {
@@ -485,23 +880,71 @@ namespace agrobus::isobus::vt {
             for (u16 i = 0; i < len && static_cast<usize>(5 + i) < msg.data.size(); ++i) {
                 value += static_cast<char>(msg.data[5 + i]);
             }
+            if (auto *client = find_client(msg.source))
+                client->changes.mark(obj_id);
             on_string_value_change.emit(obj_id, value);
+
+            // Response: [0xB3][reserved u16][object id][error codes]
+            dp::Vector<u8> response(8, 0xFF);
+            response[0] = vt_cmd::CHANGE_STRING_VALUE;
+            response[3] = msg.data[1];
+            response[4] = msg.data[2];
+            response[5] = 0x00;
+            send_to_client(response, msg.source);
         }
 
-        void ensure_client(Address addr) {
-            for (auto &c : clients_) {
-                if (c.client_address == addr)
-                    return;
-            }
-            clients_.push_back({addr, {}, {}, false, false, 0, {}});
+        void handle_execute_macro(const Message &msg) {
+            if (msg.data.size() < 3)
+                return;
+            ObjectID macro_id = static_cast<u16>(msg.data[1]) | (static_cast<u16>(msg.data[2]) << 8);
+            bool ran = execute_macro(msg.source, macro_id);
+
+            // Response: [0xBE][object id][error codes]
+            dp::Vector<u8> response(8, 0xFF);
+            response[0] = vt_cmd::EXECUTE_MACRO;
+            response[1] = msg.data[1];
+            response[2] = msg.data[2];
+            response[3] = ran ? 0x00 : 0x01; // Bit 0: object does not exist or is not a macro
+            send_to_client(response, msg.source);
         }
 
-        ServerWorkingSet *find_client(Address addr) {
-            for (auto &c : clients_) {
-                if (c.client_address == addr)
-                    return &c;
+        // Charge what the clients' pools, uploads and in-RAM versions hold now.
+        // Data already received is charged even past the limit; the checks
+        // before taking more refuse it instead.
+        void account_memory() {
+            u64 held = 0;
+            for (const auto &c : clients_) {
+                held += c.pool.bytes().size() + c.upload.size();
+                for (const auto &v : c.stored_versions)
+                    held += v.pool_data.size();
             }
-            return nullptr;
+            memory_.force(held);
+        }
+
+        // The client's NAME when stored versions go to the version store; a
+        // client whose address claim was not seen keeps them in RAM
+        dp::Optional<Name> stored_versions_key(Address addr) const {
+            if (!versions_.is_open())
+                return dp::nullopt;
+            return net_.names().name_at(cf_->port(), addr);
+        }
+
+        // ─── Client table ────────────────────────────────────────────────────────
+        // Working sets in the order they first spoke, found by address in O(1)
+        ServerWorkingSet &ensure_client(Address addr) {
+            if (auto *c = find_client(addr))
+                return *c;
+            client_slot_[addr] = static_cast<u16>(clients_.size());
+            ServerWorkingSet ws;
+            ws.client_address = addr;
+            ws.pool_seq = ++upload_seq_;
+            clients_.push_back(std::move(ws));
+            return clients_.back();
+        }
+
+        ServerWorkingSet *find_client(Address addr) noexcept {
+            u16 slot = client_slot_[addr];
+            return slot != NO_CLIENT ? &clients_[slot] : nullptr;
         }
     };
 
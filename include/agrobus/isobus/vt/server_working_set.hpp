@@ -1,8 +1,12 @@
 #pragma once
 
+#include "change_journal.hpp"
+#include "macro_table.hpp"
 #include "objects.hpp"
+#include "pool_image.hpp"
 #include "working_set.hpp"
 #include <agrobus/net/constants.hpp>
+#include <agrobus/net/message.hpp>
 #include <agrobus/net/types.hpp>
 #include <datapod/datapod.hpp>
 
@@ -15,16 +19,40 @@ namespace agrobus::isobus::vt {
         dp::Vector<u8> pool_data; // raw serialized pool data
     };
 
+    // ─── Deferred client command ─────────────────────────────────────────────────
+    // Held in the client's queue while its upload is being indexed
+    struct DeferredCommand {
+        enum class Kind : u8 {
+            Command, // An ECU to VT message
+            Chunk,   // Streamed Object Pool Transfer bytes (without the 0x11), in msg.data
+            Abort,   // The streamed transfer broke off
+        };
+        Kind kind = Kind::Command;
+        Message msg;
+    };
+
     // ─── VT Server Working Set ───────────────────────────────────────────────────
     // Tracks a connected client's working set state on the server side.
     struct ServerWorkingSet {
         Address client_address = NULL_ADDRESS;
-        ObjectPool pool;
+        PoolImage pool; // Received pool bytes, objects indexed in place
         WorkingSet working_set;
         bool pool_uploaded = false;
         bool pool_activated = false;
+        bool pool_complete = false;       // End of Object Pool accepted: later transfers patch the pool
+        PoolAssembler upload;             // Transfers since Get Memory / End of Object Pool, indexed on arrival
+        u32 pool_seq = 0;                 // Upload in progress (new at Get Memory); parses of an older one are dropped
+        u32 pools_parsing = 0;            // Transfers still being indexed off the network thread (0 or 1)
+        bool end_of_pool_waiting = false; // End of Object Pool queued in `deferred`
+        bool streamed_transfer = false;   // The ETP transfer being streamed in is an Object Pool Transfer
+        bool upload_aborted = false;      // A streamed transfer broke off: End of Object Pool fails
+        // Commands that arrived while transfers were being indexed, run in order once done
+        dp::Vector<DeferredCommand> deferred;
         u32 last_status_ms = 0;
-        dp::Vector<StoredPoolVersion> stored_versions;
+        VTChangeJournal changes; // Objects changed since the renderer last took them
+        u32 pool_version = 0;    // New whenever the pool is replaced (not patched): keys VTResourceCache
+        VTMacroTable macros;     // The pool's Macro objects, compiled when it arrives
+        dp::Vector<StoredPoolVersion> stored_versions; // Without a VTVersionStore (or the client's NAME)
 
         // Find a stored version by label
         StoredPoolVersion *find_version(const dp::String &label) {
@@ -39,18 +67,17 @@ namespace agrobus::isobus::vt {
         bool store_version(const dp::String &label) {
             if (!pool_uploaded || pool.empty())
                 return false;
-            auto data = pool.serialize();
-            if (!data.is_ok())
-                return false;
+            DataSpan bytes = pool.bytes();
+            dp::Vector<u8> data(bytes.begin(), bytes.end());
 
             // Replace existing or add new
             for (auto &v : stored_versions) {
                 if (v.label == label) {
-                    v.pool_data = std::move(data.value());
+                    v.pool_data = std::move(data);
                     return true;
                 }
             }
-            stored_versions.push_back({label, std::move(data.value())});
+            stored_versions.push_back({label, std::move(data)});
             return true;
         }
 
@@ -59,13 +86,21 @@ namespace agrobus::isobus::vt {
             auto *ver = find_version(label);
             if (!ver)
                 return false;
-            auto result = ObjectPool::deserialize(ver->pool_data);
+            auto result = PoolImage::parse(ver->pool_data);
             if (!result.is_ok())
                 return false;
-            pool = std::move(result.value());
+            use_pool(std::move(result.value()));
+            return true;
+        }
+
+        // Make a stored pool the active one
+        void use_pool(PoolImage image) {
+            pool = std::move(image);
+            changes.set_pool(pool);
+            macros = VTMacroTable::compile(pool);
             pool_uploaded = true;
             pool_activated = true;
-            return true;
+            pool_complete = true;
         }
 
         // Delete a stored version
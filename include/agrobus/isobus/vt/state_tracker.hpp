@@ -6,9 +6,13 @@
 #include <agrobus/net/event.hpp>
 #include <agrobus/net/message.hpp>
 #include <agrobus/net/network_manager.hpp>
+#include <agrobus/net/snapshot.hpp>
 #include <agrobus/net/types.hpp>
 #include <datapod/datapod.hpp>
 #include <echo/echo.hpp>
+#include <atomic>
+#include <cstring>
+#include <memory>
 
 namespace agrobus::isobus::vt {
     using namespace agrobus::net;
@@ -20,6 +24,208 @@ namespace agrobus::isobus::vt {
         u32 value = 0;
     };
 
+    // ─── Tracked VT status (cross-thread copy) ────────────────────────────────────
+    struct VTTrackerStatus {
+        ObjectID active_data_mask = 0xFFFF;
+        ObjectID active_soft_key_mask = 0xFFFF;
+        ObjectID active_alarm_mask = 0xFFFF;
+        u8 vt_busy_code = 0;
+        u8 vt_function_code = 0xFF;
+        Address vt_address = NULL_ADDRESS;
+    };
+
+    // ─── Per-object state table ──────────────────────────────────────────────────
+    // Struct-of-arrays over object IDs, in pages of 256 IDs allocated on first
+    // use: numeric values, visibility / enable / known bitsets, soft key mask
+    // assignments, and (offset, length) of each string in one shared byte
+    // arena. Every lookup is two array indexations.
+    //
+    // Copies share the pages and the arena; the first write to a shared page
+    // (or arena) clones it first. A copy is therefore a cheap, consistent
+    // snapshot: the tracker publishes one to its UI snapshot and keeps writing
+    // without touching what the reader holds.
+    class VTObjectStates {
+      public:
+        static constexpr usize PAGE = 256;
+
+      private:
+        static constexpr usize WORDS = PAGE / 64;
+        using Bits = dp::Array<u64, WORDS>;
+
+        struct Page {
+            dp::Array<u32, PAGE> numeric{};
+            dp::Array<u32, PAGE> string_at{}; // Arena offset
+            dp::Array<u16, PAGE> string_len{};
+            dp::Array<ObjectID, PAGE> soft_key_mask{};
+            Bits numeric_known{};
+            Bits string_known{};
+            Bits visible{};
+            Bits visible_known{};
+            Bits enabled{};
+            Bits enabled_known{};
+            Bits soft_key_known{};
+        };
+
+        dp::Vector<std::shared_ptr<Page>> pages_; // 0x10000 / PAGE slots once anything is set
+        std::shared_ptr<dp::Vector<char>> arena_; // String bytes
+        usize garbage_ = 0;                       // Arena bytes no string points at anymore
+
+      public:
+        // ─── Lookups ─────────────────────────────────────────────────────────────
+        dp::Optional<u32> numeric_value(ObjectID id) const noexcept {
+            const Page *p = page(id);
+            if (!p || !test(p->numeric_known, id))
+                return dp::nullopt;
+            return p->numeric[id % PAGE];
+        }
+
+        dp::Optional<dp::String> string_value(ObjectID id) const {
+            const Page *p = page(id);
+            if (!p || !test(p->string_known, id))
+                return dp::nullopt;
+            usize i = id % PAGE;
+            return dp::String(arena_->data() + p->string_at[i], p->string_len[i]);
+        }
+
+        dp::Optional<bool> is_visible(ObjectID id) const noexcept {
+            const Page *p = page(id);
+            if (!p || !test(p->visible_known, id))
+                return dp::nullopt;
+            return test(p->visible, id);
+        }
+
+        dp::Optional<bool> is_enabled(ObjectID id) const noexcept {
+            const Page *p = page(id);
+            if (!p || !test(p->enabled_known, id))
+                return dp::nullopt;
+            return test(p->enabled, id);
+        }
+
+        dp::Optional<ObjectID> soft_key_mask_for(ObjectID data_mask_id) const noexcept {
+            const Page *p = page(data_mask_id);
+            if (!p || !test(p->soft_key_known, data_mask_id))
+                return dp::nullopt;
+            return p->soft_key_mask[data_mask_id % PAGE];
+        }
+
+        // ─── Updates ─────────────────────────────────────────────────────────────
+        void set_numeric_value(ObjectID id, u32 value) {
+            Page &p = writable(id);
+            p.numeric[id % PAGE] = value;
+            set(p.numeric_known, id, true);
+        }
+
+        void set_visibility(ObjectID id, bool visible) {
+            Page &p = writable(id);
+            set(p.visible, id, visible);
+            set(p.visible_known, id, true);
+        }
+
+        void set_enable_state(ObjectID id, bool enabled) {
+            Page &p = writable(id);
+            set(p.enabled, id, enabled);
+            set(p.enabled_known, id, true);
+        }
+
+        void set_soft_key_mask(ObjectID data_mask_id, ObjectID soft_key_mask_id) {
+            Page &p = writable(data_mask_id);
+            p.soft_key_mask[data_mask_id % PAGE] = soft_key_mask_id;
+            set(p.soft_key_known, data_mask_id, true);
+        }
+
+        // A string no longer than the one it replaces is written over it, a
+        // longer one is appended; the arena is compacted once it is mostly garbage
+        void set_string_value(ObjectID id, const dp::String &value) {
+            usize len = value.size() < 0xFFFF ? value.size() : 0xFFFF;
+            Page &p = writable(id);
+            usize i = id % PAGE;
+            dp::Vector<char> &arena = writable_arena();
+            if (test(p.string_known, id) && len <= p.string_len[i]) {
+                garbage_ += p.string_len[i] - len;
+            } else {
+                if (test(p.string_known, id))
+                    garbage_ += p.string_len[i];
+                p.string_at[i] = static_cast<u32>(arena.size());
+                arena.resize(arena.size() + len);
+            }
+            if (len > 0)
+                std::memcpy(arena.data() + p.string_at[i], value.data(), len);
+            p.string_len[i] = static_cast<u16>(len);
+            set(p.string_known, id, true);
+            if (garbage_ > 4096 && garbage_ * 2 > arena.size())
+                compact();
+        }
+
+        void clear() {
+            pages_.clear();
+            arena_.reset();
+            garbage_ = 0;
+        }
+
+        // Bytes the strings take in the arena, garbage included
+        usize arena_size() const noexcept { return arena_ ? arena_->size() : 0; }
+
+      private:
+        static bool test(const Bits &bits, ObjectID id) noexcept {
+            usize i = id % PAGE;
+            return (bits[i / 64] >> (i % 64)) & 1u;
+        }
+
+        static void set(Bits &bits, ObjectID id, bool on) noexcept {
+            usize i = id % PAGE;
+            u64 mask = u64{1} << (i % 64);
+            bits[i / 64] = on ? (bits[i / 64] | mask) : (bits[i / 64] & ~mask);
+        }
+
+        const Page *page(ObjectID id) const noexcept {
+            usize n = id / PAGE;
+            return n < pages_.size() ? pages_[n].get() : nullptr;
+        }
+
+        // Pages held by another copy are cloned before the first write.
+        // use_count() is 1 only when no copy (and so no other thread) holds it.
+        Page &writable(ObjectID id) {
+            if (pages_.empty())
+                pages_.resize(0x10000 / PAGE);
+            auto &slot = pages_[id / PAGE];
+            if (!slot)
+                slot = std::make_shared<Page>();
+            else if (slot.use_count() > 1)
+                slot = std::make_shared<Page>(*slot);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            return *slot;
+        }
+
+        dp::Vector<char> &writable_arena() {
+            if (!arena_)
+                arena_ = std::make_shared<dp::Vector<char>>();
+            else if (arena_.use_count() > 1)
+                arena_ = std::make_shared<dp::Vector<char>>(*arena_);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            return *arena_;
+        }
+
+        void compact() {
+            auto fresh = std::make_shared<dp::Vector<char>>();
+            fresh->reserve(arena_->size() - garbage_);
+            for (usize n = 0; n < pages_.size(); ++n) {
+                if (!pages_[n])
+                    continue;
+                Page &p = writable(static_cast<ObjectID>(n * PAGE));
+                for (usize i = 0; i < PAGE; ++i) {
+                    if (!test(p.string_known, static_cast<ObjectID>(i)))
+                        continue;
+                    u32 at = static_cast<u32>(fresh->size());
+                    const char *src = arena_->data() + p.string_at[i];
+                    fresh->insert(fresh->end(), src, src + p.string_len[i]);
+                    p.string_at[i] = at;
+                }
+            }
+            arena_ = std::move(fresh);
+            garbage_ = 0;
+        }
+    };
+
     // ─── VT Client State Tracker ──────────────────────────────────────────────────
     // Maintains a local mirror of VT state by observing VT-to-ECU messages.
     // Tracks: active masks, numeric/string values, visibility, enable states,
@@ -31,21 +237,26 @@ namespace agrobus::isobus::vt {
     //   // ... later ...
     //   auto mask = tracker.active_data_mask();
     //   auto val = tracker.numeric_value(obj_id);
+    //
+    // The mask / busy state is also published to status_snapshot() after every
+    // VT message, for readers on other threads, and the per-object table to
+    // objects_snapshot() after every VT message that changed it. The
+    // accessors below read the live table: only from the thread that drives
+    // IsoNet::update(). The manual setters don't publish; call
+    // publish_objects() after a round of them.
     class VTClientStateTracker {
         IsoNet &net_;
         ObjectID active_data_mask_ = 0xFFFF;
         ObjectID active_soft_key_mask_ = 0xFFFF;
         ObjectID active_alarm_mask_ = 0xFFFF;
 
-        dp::Map<ObjectID, u32> numeric_values_;
-        dp::Map<ObjectID, dp::String> string_values_;
-        dp::Map<ObjectID, bool> visibility_;
-        dp::Map<ObjectID, bool> enable_state_;
-        dp::Map<ObjectID, ObjectID> soft_key_mask_assignments_; // data mask -> soft key mask
+        VTObjectStates objects_;
+        Snapshot<VTObjectStates> objects_snapshot_;
 
         u8 vt_busy_code_ = 0;
         u8 vt_function_code_ = 0xFF;
         Address vt_address_ = NULL_ADDRESS;
+        Snapshot<VTTrackerStatus> status_;
 
       public:
         explicit VTClientStateTracker(IsoNet &net) : net_(net) {}
@@ -63,58 +274,43 @@ namespace agrobus::isobus::vt {
         Address vt_address() const noexcept { return vt_address_; }
         u8 vt_busy_code() const noexcept { return vt_busy_code_; }
 
-        dp::Optional<u32> numeric_value(ObjectID id) const {
-            auto it = numeric_values_.find(id);
-            if (it != numeric_values_.end())
-                return it->second;
-            return dp::nullopt;
-        }
-
-        dp::Optional<dp::String> string_value(ObjectID id) const {
-            auto it = string_values_.find(id);
-            if (it != string_values_.end())
-                return it->second;
-            return dp::nullopt;
-        }
+        // Lock-free copy of the fields above, readable from any thread
+        const Snapshot<VTTrackerStatus> &status_snapshot() const noexcept { return status_; }
+        VTTrackerStatus status() const { return status_.load(); }
 
-        dp::Optional<bool> is_visible(ObjectID id) const {
-            auto it = visibility_.find(id);
-            if (it != visibility_.end())
-                return it->second;
-            return dp::nullopt;
+        dp::Optional<u32> numeric_value(ObjectID id) const { return objects_.numeric_value(id); }
+        dp::Optional<dp::String> string_value(ObjectID id) const { return objects_.string_value(id); }
+        dp::Optional<bool> is_visible(ObjectID id) const { return objects_.is_visible(id); }
+        dp::Optional<bool> is_enabled(ObjectID id) const { return objects_.is_enabled(id); }
+        dp::Optional<ObjectID> soft_key_mask_for(ObjectID data_mask_id) const {
+            return objects_.soft_key_mask_for(data_mask_id);
         }
 
-        dp::Optional<bool> is_enabled(ObjectID id) const {
-            auto it = enable_state_.find(id);
-            if (it != enable_state_.end())
-                return it->second;
-            return dp::nullopt;
-        }
+        // The live table, and its last published copy for other threads
+        const VTObjectStates &objects() const noexcept { return objects_; }
+        const Snapshot<VTObjectStates> &objects_snapshot() const noexcept { return objects_snapshot_; }
+        VTObjectStates object_states() const { return objects_snapshot_.load(); }
 
-        dp::Optional<ObjectID> soft_key_mask_for(ObjectID data_mask_id) const {
-            auto it = soft_key_mask_assignments_.find(data_mask_id);
-            if (it != soft_key_mask_assignments_.end())
-                return it->second;
-            return dp::nullopt;
+        // ─── Manual state injection (for testing or initial sync) ─────────────────
+        void set_numeric_value(ObjectID id, u32 value) { objects_.set_numeric_value(id, value); }
+        void set_string_value(ObjectID id, dp::String value) { objects_.set_string_value(id, value); }
+        void set_visibility(ObjectID id, bool visible) { objects_.set_visibility(id, visible); }
+        void set_enable_state(ObjectID id, bool enabled) { objects_.set_enable_state(id, enabled); }
+        void set_soft_key_mask(ObjectID data_mask_id, ObjectID sk_mask_id) {
+            objects_.set_soft_key_mask(data_mask_id, sk_mask_id);
         }
 
-        // ─── Manual state injection (for testing or initial sync) ─────────────────
-        void set_numeric_value(ObjectID id, u32 value) { numeric_values_[id] = value; }
-        void set_string_value(ObjectID id, dp::String value) { string_values_[id] = std::move(value); }
-        void set_visibility(ObjectID id, bool visible) { visibility_[id] = visible; }
-        void set_enable_state(ObjectID id, bool enabled) { enable_state_[id] = enabled; }
+        void publish_objects() { objects_snapshot_.publish(objects_); }
 
         void reset() {
             active_data_mask_ = 0xFFFF;
             active_soft_key_mask_ = 0xFFFF;
             active_alarm_mask_ = 0xFFFF;
-            numeric_values_.clear();
-            string_values_.clear();
-            visibility_.clear();
-            enable_state_.clear();
-            soft_key_mask_assignments_.clear();
+            objects_.clear();
             vt_busy_code_ = 0;
             vt_address_ = NULL_ADDRESS;
+            publish_status();
+            publish_objects();
         }
 
         // ─── Events ──────────────────────────────────────────────────────────────
@@ -153,6 +349,18 @@ namespace agrobus::isobus::vt {
             default:
                 break;
             }
+            publish_status();
+        }
+
+        void publish_status() {
+            VTTrackerStatus s;
+            s.active_data_mask = active_data_mask_;
+            s.active_soft_key_mask = active_soft_key_mask_;
+            s.active_alarm_mask = active_alarm_mask_;
+            s.vt_busy_code = vt_busy_code_;
+            s.vt_function_code = vt_function_code_;
+            s.vt_address = vt_address_;
+            status_.publish(s);
         }
 
         void handle_vt_status(const Message &msg) {
@@ -187,7 +395,8 @@ namespace agrobus::isobus::vt {
             ObjectID id = static_cast<u16>(msg.data[1]) | (static_cast<u16>(msg.data[2]) << 8);
             u32 value = static_cast<u32>(msg.data[4]) | (static_cast<u32>(msg.data[5]) << 8) |
                         (static_cast<u32>(msg.data[6]) << 16) | (static_cast<u32>(msg.data[7]) << 24);
-            numeric_values_[id] = value;
+            objects_.set_numeric_value(id, value);
+            publish_objects();
             on_numeric_value_changed.emit(id, value);
             echo::category("isobus.vt.tracker").trace("numeric: id=", id, " val=", value);
         }
@@ -201,7 +410,8 @@ namespace agrobus::isobus::vt {
             for (u16 i = 0; i < len && static_cast<usize>(5 + i) < msg.data.size(); ++i) {
                 str += static_cast<char>(msg.data[5 + i]);
             }
-            string_values_[id] = str;
+            objects_.set_string_value(id, str);
+            publish_objects();
             on_string_value_changed.emit(id, str);
             echo::category("isobus.vt.tracker").trace("string: id=", id, " val=", str);
         }
@@ -211,7 +421,8 @@ namespace agrobus::isobus::vt {
                 return;
             ObjectID id = static_cast<u16>(msg.data[1]) | (static_cast<u16>(msg.data[2]) << 8);
             bool visible = (msg.data[3] != 0);
-            visibility_[id] = visible;
+            objects_.set_visibility(id, visible);
+            publish_objects();
             on_visibility_changed.emit(id, visible);
             echo::category("isobus.vt.tracker").trace("visibility: id=", id, " vis=", visible);
         }
@@ -221,7 +432,8 @@ namespace agrobus::isobus::vt {
                 return;
             ObjectID id = static_cast<u16>(msg.data[1]) | (static_cast<u16>(msg.data[2]) << 8);
             bool enabled = (msg.data[3] != 0);
-            enable_state_[id] = enabled;
+            objects_.set_enable_state(id, enabled);
+            publish_objects();
             on_enable_state_changed.emit(id, enabled);
             echo::category("isobus.vt.tracker").trace("enable: id=", id, " en=", enabled);
         }
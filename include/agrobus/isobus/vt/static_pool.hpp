@@ -0,0 +1,186 @@
+#pragma once
+
+#include "objects.hpp"
+#include "pool_image.hpp"
+#include <agrobus/net/data_span.hpp>
+#include <agrobus/net/iop_parser.hpp>
+#include <agrobus/net/types.hpp>
+#include <array>
+#include <initializer_list>
+
+namespace agrobus::isobus::vt {
+    using namespace agrobus::net;
+
+    // ─── Compile-time pool errors ────────────────────────────────────────────────
+    // Not constexpr on purpose: reaching one while a pool is built in a
+    // constant expression stops the build, the diagnostic pointing at the
+    // failed check
+    inline void static_pool_error(const char *) {}
+
+    // ─── Index entry of a ROM pool ───────────────────────────────────────────────
+    struct StaticObjectRef {
+        ObjectID id = 0;
+        ObjectType type = ObjectType::WorkingSet;
+        u32 offset = 0;      // First body byte in the pool bytes
+        u16 length = 0;      // Body length from the header, children list included
+        u16 children_at = 0; // Body offset of the children list, == length when there is none
+    };
+
+    // ─── Serialized pool built at compile time ───────────────────────────────────
+    // The bytes ObjectPool::serialize() would produce for the same objects in
+    // the same order, the index sorted by ID and the version label, all as
+    // constant data: a `constexpr` (or `static constexpr`) StaticPool lands in
+    // flash and startup builds nothing. Made by StaticPoolBuilder::finish() or,
+    // trimmed to the exact sizes, by make_static_pool().
+    template <usize Bytes, usize Objects> struct StaticPool {
+        std::array<u8, Bytes> data{};
+        std::array<StaticObjectRef, Objects> index{}; // Sorted by ID
+        usize size = 0;                               // Bytes used
+        usize count = 0;                              // Objects used
+        u64 hash = 0;                                 // IOPParser::content_hash of the bytes
+        std::array<char, 7> label{};                  // IOPParser::version_label of the hash
+
+        constexpr DataSpan bytes() const noexcept { return DataSpan(data.data(), size); }
+        constexpr bool empty() const noexcept { return count == 0; }
+        constexpr bool contains(ObjectID id) const noexcept { return find_ref(id) != nullptr; }
+
+        constexpr const StaticObjectRef *find_ref(ObjectID id) const noexcept {
+            usize lo = 0, hi = count;
+            while (lo < hi) {
+                usize mid = (lo + hi) / 2;
+                if (index[mid].id < id)
+                    lo = mid + 1;
+                else
+                    hi = mid;
+            }
+            return lo < count && index[lo].id == id ? &index[lo] : nullptr;
+        }
+
+        // Same view as PoolImage::find(), straight into the ROM bytes
+        dp::Optional<ObjectView> find(ObjectID id) const {
+            const StaticObjectRef *ref = find_ref(id);
+            if (!ref)
+                return dp::nullopt;
+            ObjectView v;
+            v.id = ref->id;
+            v.type = ref->type;
+            const u8 *body = data.data() + ref->offset;
+            v.body = DataSpan(body, ref->children_at);
+            if (ref->children_at < ref->length) {
+                const u8 *list = body + ref->children_at;
+                v.children = ChildList(list + 2, static_cast<u16>(list[0] | (list[1] << 8)));
+            }
+            return v;
+        }
+
+        dp::String version_label() const { return dp::String(label.data(), label.size()); }
+
+        // For tools that want a PoolImage or an ObjectPool: these allocate,
+        // the ROM bytes are not copied by image()
+        Result<PoolImage> image() const { return PoolImage::parse(nullptr, data.data(), size); }
+        Result<ObjectPool> to_pool() const {
+            return ObjectPool::deserialize(dp::Vector<u8>(data.data(), data.data() + size));
+        }
+    };
+
+    // ─── Compile-time pool builder ───────────────────────────────────────────────
+    // Objects are written in the ObjectPool::serialize() layout as they are
+    // added. `Bytes` and `Objects` are capacities; overrunning one, a
+    // duplicate ID or a body longer than 65535 bytes fails the build.
+    //
+    //   constexpr auto POOL = make_static_pool([] {
+    //       return StaticPoolBuilder<4096, 64>{}
+    //           .add(0, ObjectType::WorkingSet, {...}, {1000})
+    //           .add(1000, ObjectType::DataMask, {...}, {2000, 2001});
+    //   });
+    template <usize Bytes, usize Objects> class StaticPoolBuilder {
+        std::array<u8, Bytes> data_{};
+        std::array<StaticObjectRef, Objects> refs_{}; // Pool order
+        usize size_ = 0;
+        usize count_ = 0;
+
+      public:
+        constexpr StaticPoolBuilder &add(ObjectID id, ObjectType type, std::initializer_list<u8> body,
+                                         std::initializer_list<ObjectID> children = {}) {
+            usize list = children.size() == 0 ? 0 : 2 + children.size() * 2;
+            usize length = body.size() + list;
+            const char *error = nullptr;
+            if (length > 0xFFFF)
+                error = "object body longer than 65535 bytes";
+            else if (size_ + 5 + length > Bytes)
+                error = "static pool byte capacity exceeded";
+            else if (count_ == Objects)
+                error = "static pool object capacity exceeded";
+            for (usize i = 0; i < count_ && !error; ++i) {
+                if (refs_[i].id == id)
+                    error = "duplicate object ID";
+            }
+            if (error) {
+                static_pool_error(error); // At run time the object is left out
+                return *this;
+            }
+
+            StaticObjectRef &ref = refs_[count_++];
+            ref.id = id;
+            ref.type = type;
+            ref.offset = static_cast<u32>(size_ + 5);
+            ref.length = static_cast<u16>(length);
+            ref.children_at = static_cast<u16>(body.size());
+            put(static_cast<u8>(id & 0xFF));
+            put(static_cast<u8>((id >> 8) & 0xFF));
+            put(static_cast<u8>(type));
+            put(static_cast<u8>(length & 0xFF));
+            put(static_cast<u8>((length >> 8) & 0xFF));
+            for (u8 b : body)
+                put(b);
+            if (list > 0) {
+                put(static_cast<u8>(children.size() & 0xFF));
+                put(static_cast<u8>((children.size() >> 8) & 0xFF));
+                for (ObjectID child : children) {
+                    put(static_cast<u8>(child & 0xFF));
+                    put(static_cast<u8>((child >> 8) & 0xFF));
+                }
+            }
+            return *this;
+        }
+
+        constexpr usize size() const noexcept { return size_; }
+        constexpr usize count() const noexcept { return count_; }
+
+        // The pool with capacities B >= size() and O >= count(); the index is
+        // sorted and the version label stamped here
+        template <usize B = Bytes, usize O = Objects> constexpr StaticPool<B, O> finish() const {
+            StaticPool<B, O> pool;
+            if (size_ > B || count_ > O) {
+                static_pool_error("static pool capacity smaller than the pool");
+                return pool;
+            }
+            for (usize i = 0; i < size_; ++i)
+                pool.data[i] = data_[i];
+            pool.size = size_;
+            pool.count = count_;
+            for (usize i = 0; i < count_; ++i) { // Insertion sort: runs once, in the compiler
+                StaticObjectRef ref = refs_[i];
+                usize j = i;
+                for (; j > 0 && pool.index[j - 1].id > ref.id; --j)
+                    pool.index[j] = pool.index[j - 1];
+                pool.index[j] = ref;
+            }
+            pool.hash = IOPParser::content_hash(pool.bytes());
+            for (u8 i = 0; i < 7; ++i)
+                pool.label[i] = static_cast<char>('A' + ((pool.hash >> (i * 4)) & 0x0F));
+            return pool;
+        }
+
+      private:
+        constexpr void put(u8 b) { data_[size_++] = b; }
+    };
+
+    // A captureless lambda returning a StaticPoolBuilder, evaluated once by
+    // the compiler; the pool is trimmed to exactly the bytes and objects used
+    template <typename Build> consteval auto make_static_pool(Build) {
+        constexpr auto builder = Build{}();
+        return builder.template finish<builder.size(), builder.count()>();
+    }
+
+} // namespace agrobus::isobus::vt
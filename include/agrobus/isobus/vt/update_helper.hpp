@@ -20,6 +20,9 @@ namespace agrobus::isobus::vt {
     // - Validates object IDs against the pool before sending
     // - Provides batched update support via begin_batch/end_batch
     // - Type-safe numeric value helpers (scaled, clamped)
+    // - Coalescing: queued updates keep only the last value per (object,
+    //   attribute), in the position of the first
+    // - Optional rate limit per (object, attribute), see with_min_interval()
     //
     // Usage:
     //   VTClientUpdateHelper helper(client, tracker, pool);
@@ -42,6 +45,14 @@ namespace agrobus::isobus::vt {
             ObjectID mask_id = 0;
         };
         dp::Vector<PendingUpdate> pending_;
+        dp::Map<u32, usize> slots_;       // (type, id) -> index in pending_
+        dp::Map<u32, u32> last_sent_ms_; // (type, id) -> now_ms_ of the last send
+        u32 now_ms_ = 0;
+        u32 min_interval_ms_ = 0;
+
+        u32 sent_ = 0;
+        u32 skipped_ = 0;
+        u32 coalesced_ = 0;
 
       public:
         VTClientUpdateHelper(VTClient &client, VTClientStateTracker &tracker, const ObjectPool *pool = nullptr)
@@ -53,24 +64,18 @@ namespace agrobus::isobus::vt {
             return *this;
         }
 
+        // At most one command per (object, attribute) every `ms`. An update that
+        // comes in sooner is held (coalescing with later ones) and sent by
+        // update() once the interval has passed. Active mask changes are never
+        // held. 0 (default) sends every changed value right away.
+        VTClientUpdateHelper &with_min_interval(u32 ms) {
+            min_interval_ms_ = ms;
+            return *this;
+        }
+
         // ─── Numeric value updates ───────────────────────────────────────────────
         Result<void> set_numeric_value(ObjectID id, u32 value) {
-            auto current = tracker_.numeric_value(id);
-            if (current && *current == value) {
-                echo::category("isobus.vt.helper").trace("skip numeric: id=", id, " unchanged");
-                return {};
-            }
-
-            if (batch_mode_) {
-                pending_.push_back({PendingUpdate::Type::Numeric, id, value, {}, false, 0});
-                return {};
-            }
-
-            auto result = client_.change_numeric_value(id, value);
-            if (result.is_ok()) {
-                tracker_.set_numeric_value(id, value);
-            }
-            return result;
+            return submit({PendingUpdate::Type::Numeric, id, value, {}, false, 0});
         }
 
         // Scaled numeric: applies scale factor before sending
@@ -90,22 +95,7 @@ namespace agrobus::isobus::vt {
 
         // ─── String value updates ────────────────────────────────────────────────
         Result<void> set_string_value(ObjectID id, dp::String value) {
-            auto current = tracker_.string_value(id);
-            if (current && *current == value) {
-                echo::category("isobus.vt.helper").trace("skip string: id=", id, " unchanged");
-                return {};
-            }
-
-            if (batch_mode_) {
-                pending_.push_back({PendingUpdate::Type::String, id, 0, std::move(value), false, 0});
-                return {};
-            }
-
-            auto result = client_.change_string_value(id, value);
-            if (result.is_ok()) {
-                tracker_.set_string_value(id, std::move(value));
-            }
-            return result;
+            return submit({PendingUpdate::Type::String, id, 0, std::move(value), false, 0});
         }
 
         // ─── Visibility updates ──────────────────────────────────────────────────
@@ -113,22 +103,7 @@ namespace agrobus::isobus::vt {
         Result<void> hide(ObjectID id) { return set_visibility(id, false); }
 
         Result<void> set_visibility(ObjectID id, bool visible) {
-            auto current = tracker_.is_visible(id);
-            if (current && *current == visible) {
-                echo::category("isobus.vt.helper").trace("skip visibility: id=", id, " unchanged");
-                return {};
-            }
-
-            if (batch_mode_) {
-                pending_.push_back({PendingUpdate::Type::Visibility, id, 0, {}, visible, 0});
-                return {};
-            }
-
-            auto result = client_.hide_show(id, visible);
-            if (result.is_ok()) {
-                tracker_.set_visibility(id, visible);
-            }
-            return result;
+            return submit({PendingUpdate::Type::Visibility, id, 0, {}, visible, 0});
         }
 
         // ─── Enable/disable updates ─────────────────────────────────────────────
@@ -136,31 +111,11 @@ namespace agrobus::isobus::vt {
         Result<void> disable(ObjectID id) { return set_enable(id, false); }
 
         Result<void> set_enable(ObjectID id, bool enabled) {
-            auto current = tracker_.is_enabled(id);
-            if (current && *current == enabled) {
-                echo::category("isobus.vt.helper").trace("skip enable: id=", id, " unchanged");
-                return {};
-            }
-
-            if (batch_mode_) {
-                pending_.push_back({PendingUpdate::Type::Enable, id, 0, {}, enabled, 0});
-                return {};
-            }
-
-            auto result = client_.enable_disable(id, enabled);
-            if (result.is_ok()) {
-                tracker_.set_enable_state(id, enabled);
-            }
-            return result;
+            return submit({PendingUpdate::Type::Enable, id, 0, {}, enabled, 0});
         }
 
         // ─── Active mask ─────────────────────────────────────────────────────────
         Result<void> change_active_mask(ObjectID working_set_id, ObjectID mask_id) {
-            if (tracker_.active_data_mask() == mask_id) {
-                echo::category("isobus.vt.helper").trace("skip mask: already active");
-                return {};
-            }
-
             if (pool_) {
                 auto obj = pool_->find(mask_id);
                 if (!obj) {
@@ -172,72 +127,171 @@ namespace agrobus::isobus::vt {
                 }
             }
 
-            if (batch_mode_) {
-                pending_.push_back({PendingUpdate::Type::ActiveMask, working_set_id, 0, {}, false, mask_id});
-                return {};
-            }
-
-            return client_.change_active_mask(working_set_id, mask_id);
+            return submit({PendingUpdate::Type::ActiveMask, working_set_id, 0, {}, false, mask_id});
         }
 
         // ─── Batch mode ──────────────────────────────────────────────────────────
         // Queues updates and sends them all at once when end_batch() is called.
-        void begin_batch() {
-            batch_mode_ = true;
-            pending_.clear();
-        }
+        // Repeated updates of one attribute within the batch collapse into one
+        // command, and values that end up equal to the tracked state are dropped.
+        void begin_batch() { batch_mode_ = true; }
 
         Result<void> end_batch() {
             batch_mode_ = false;
+            return flush();
+        }
+
+        // Discard everything queued (batched or held by the rate limit) without sending
+        void cancel_batch() {
+            batch_mode_ = false;
+            pending_.clear();
+            slots_.clear();
+        }
+
+        // ─── Rate limit clock ────────────────────────────────────────────────────
+        // Sends the held updates whose interval has passed. Only needed with
+        // with_min_interval(); call it next to VTClient::update().
+        void update(u32 elapsed_ms) {
+            now_ms_ += elapsed_ms;
+            if (!batch_mode_ && !pending_.empty())
+                (void)flush();
+        }
+
+        // Send every queued update that is due; the rest stay queued
+        Result<void> flush() {
             Result<void> last_error;
+            dp::Vector<PendingUpdate> held;
 
             for (auto &update : pending_) {
-                Result<void> result;
-                switch (update.type) {
-                case PendingUpdate::Type::Numeric:
-                    result = client_.change_numeric_value(update.id, update.numeric_val);
-                    if (result.is_ok())
-                        tracker_.set_numeric_value(update.id, update.numeric_val);
-                    break;
-                case PendingUpdate::Type::String:
-                    result = client_.change_string_value(update.id, update.string_val);
-                    if (result.is_ok())
-                        tracker_.set_string_value(update.id, std::move(update.string_val));
-                    break;
-                case PendingUpdate::Type::Visibility:
-                    result = client_.hide_show(update.id, update.bool_val);
-                    if (result.is_ok())
-                        tracker_.set_visibility(update.id, update.bool_val);
-                    break;
-                case PendingUpdate::Type::Enable:
-                    result = client_.enable_disable(update.id, update.bool_val);
-                    if (result.is_ok())
-                        tracker_.set_enable_state(update.id, update.bool_val);
-                    break;
-                case PendingUpdate::Type::ActiveMask:
-                    result = client_.change_active_mask(update.id, update.mask_id);
-                    break;
+                if (!due(update)) {
+                    held.push_back(std::move(update));
+                    continue;
+                }
+                if (unchanged(update)) {
+                    ++skipped_;
+                    continue;
                 }
+                auto result = send(update);
                 if (!result.is_ok()) {
                     last_error = result;
                     echo::category("isobus.vt.helper").warn("batch update failed for id=", update.id);
                 }
             }
-            pending_.clear();
+
+            pending_ = std::move(held);
+            slots_.clear();
+            for (usize i = 0; i < pending_.size(); ++i)
+                slots_[slot_key(pending_[i].type, pending_[i].id)] = i;
 
             if (last_error.is_err())
                 return last_error;
             return {};
         }
 
-        // Discard pending batch without sending
-        void cancel_batch() {
-            batch_mode_ = false;
-            pending_.clear();
-        }
-
         usize pending_count() const noexcept { return pending_.size(); }
         bool is_batching() const noexcept { return batch_mode_; }
+
+        // ─── Statistics ──────────────────────────────────────────────────────────
+        u32 sent_count() const noexcept { return sent_; }           // Commands handed to the client
+        u32 skipped_count() const noexcept { return skipped_; }     // Equal to the tracked state
+        u32 coalesced_count() const noexcept { return coalesced_; } // Overwritten while queued
+
+      private:
+        static u32 slot_key(PendingUpdate::Type type, ObjectID id) noexcept {
+            return (static_cast<u32>(type) << 16) | id;
+        }
+
+        // Queue, coalesce or send right away
+        Result<void> submit(PendingUpdate update) {
+            u32 key = slot_key(update.type, update.id);
+            auto slot = slots_.find(key);
+            if (slot != slots_.end()) {
+                // Even a value equal to the tracked one replaces the queued
+                // value: flush() then drops it instead of sending a stale one
+                pending_[slot->second] = std::move(update);
+                ++coalesced_;
+                return {};
+            }
+
+            if (unchanged(update)) {
+                ++skipped_;
+                echo::category("isobus.vt.helper").trace("skip: id=", update.id, " unchanged");
+                return {};
+            }
+
+            if (batch_mode_ || !due(update)) {
+                slots_[key] = pending_.size();
+                pending_.push_back(std::move(update));
+                return {};
+            }
+            return send(update);
+        }
+
+        bool unchanged(const PendingUpdate &update) const {
+            switch (update.type) {
+            case PendingUpdate::Type::Numeric: {
+                auto current = tracker_.numeric_value(update.id);
+                return current && *current == update.numeric_val;
+            }
+            case PendingUpdate::Type::String: {
+                auto current = tracker_.string_value(update.id);
+                return current && *current == update.string_val;
+            }
+            case PendingUpdate::Type::Visibility: {
+                auto current = tracker_.is_visible(update.id);
+                return current && *current == update.bool_val;
+            }
+            case PendingUpdate::Type::Enable: {
+                auto current = tracker_.is_enabled(update.id);
+                return current && *current == update.bool_val;
+            }
+            case PendingUpdate::Type::ActiveMask:
+                return tracker_.active_data_mask() == update.mask_id;
+            }
+            return false;
+        }
+
+        bool due(const PendingUpdate &update) const {
+            if (min_interval_ms_ == 0 || update.type == PendingUpdate::Type::ActiveMask)
+                return true;
+            auto it = last_sent_ms_.find(slot_key(update.type, update.id));
+            return it == last_sent_ms_.end() || now_ms_ - it->second >= min_interval_ms_;
+        }
+
+        Result<void> send(PendingUpdate &update) {
+            Result<void> result;
+            switch (update.type) {
+            case PendingUpdate::Type::Numeric:
+                result = client_.change_numeric_value(update.id, update.numeric_val);
+                if (result.is_ok())
+                    tracker_.set_numeric_value(update.id, update.numeric_val);
+                break;
+            case PendingUpdate::Type::String:
+                result = client_.change_string_value(update.id, update.string_val);
+                if (result.is_ok())
+                    tracker_.set_string_value(update.id, std::move(update.string_val));
+                break;
+            case PendingUpdate::Type::Visibility:
+                result = client_.hide_show(update.id, update.bool_val);
+                if (result.is_ok())
+                    tracker_.set_visibility(update.id, update.bool_val);
+                break;
+            case PendingUpdate::Type::Enable:
+                result = client_.enable_disable(update.id, update.bool_val);
+                if (result.is_ok())
+                    tracker_.set_enable_state(update.id, update.bool_val);
+                break;
+            case PendingUpdate::Type::ActiveMask:
+                result = client_.change_active_mask(update.id, update.mask_id);
+                break;
+            }
+            if (result.is_ok()) {
+                ++sent_;
+                if (min_interval_ms_ > 0)
+                    last_sent_ms_[slot_key(update.type, update.id)] = now_ms_;
+            }
+            return result;
+        }
     };
 
 } // namespace agrobus::isobus::vt
@@ -0,0 +1,427 @@
+#pragma once
+
+#include "pool_image.hpp"
+#include <agrobus/net/data_span.hpp>
+#include <agrobus/net/error.hpp>
+#include <agrobus/net/name.hpp>
+#include <agrobus/net/types.hpp>
+#include <cstring>
+#include <datapod/datapod.hpp>
+#include <echo/echo.hpp>
+#include <fcntl.h>
+#include <memory>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace agrobus::isobus::vt {
+    using namespace agrobus::net;
+
+    // ─── Version store file layout ───────────────────────────────────────────────
+    // [VersionStoreHeader] then records, each a VersionRecordHeader followed by
+    // `size` pool bytes padded to 8. Records are only ever appended: storing a
+    // label again appends a new record, deleting appends a tombstone, and the
+    // last record for a (NAME, label) wins when the file is read back.
+    inline constexpr char VERSION_STORE_MAGIC[8] = {'A', 'G', 'V', 'T', 'P', 'O', 'O', 'L'};
+    inline constexpr u32 VERSION_RECORD_MAGIC = 0x52565441; // "ATVR"
+    inline constexpr usize VERSION_STORE_LABEL_SIZE = 32;  // Extended version labels (VT v5)
+
+    struct VersionStoreHeader {
+        u8 magic[8];
+        u32 format = 1;
+        u32 reserved = 0;
+    };
+    static_assert(sizeof(VersionStoreHeader) == 16);
+
+    struct VersionRecordHeader {
+        u32 magic = VERSION_RECORD_MAGIC;
+        u32 size = 0;      // Pool bytes following the header
+        u64 name = 0;      // Client NAME
+        u32 checksum = 0;  // FNV-1a over the pool bytes
+        u8 kind = 0;       // 0 = version, 1 = tombstone
+        u8 label_len = 0;
+        u8 reserved[2] = {};
+        char label[VERSION_STORE_LABEL_SIZE] = {};
+    };
+    static_assert(sizeof(VersionRecordHeader) == 56);
+
+    // ─── Persistent store for VT stored pool versions ────────────────────────────
+    // Keeps the pools clients saved with Store Version in one append-only file,
+    // keyed by (client NAME, label), so they survive a VT power cycle. The file
+    // is mapped read-only and load() indexes a pool in place: no read, no copy,
+    // and RAM holds only the pages of the pools in use.
+    //
+    // Copy-on-write: nothing written is ever overwritten. A PoolImage from
+    // load() keeps the mapping (and so the bytes) it was taken from alive,
+    // even after the label is stored again, deleted or compacted away.
+    // Compaction rewrites the live records into a new file and renames it over
+    // the old one; it runs on its own once superseded records take up as
+    // much as the live ones (and the threshold), or when compact() is called.
+    //
+    // A record cut short by a crash is dropped when the file is opened.
+    class VTVersionStore {
+      public:
+        struct Version {
+            dp::String label;
+            u32 size = 0;
+        };
+
+      private:
+        struct Entry {
+            dp::String label;
+            usize offset = 0; // Of the pool bytes in the file
+            u32 size = 0;
+            u32 checksum = 0;
+        };
+
+        // Unmapped with the last PoolImage copy that references it
+        struct Mapping {
+            void *addr;
+            usize size;
+
+            Mapping(void *a, usize s) : addr(a), size(s) {}
+            ~Mapping() { ::munmap(addr, size); }
+            Mapping(const Mapping &) = delete;
+            Mapping &operator=(const Mapping &) = delete;
+        };
+
+        dp::String path_;
+        int fd_ = -1;
+        usize file_size_ = 0;
+        std::shared_ptr<Mapping> map_;
+        dp::Map<u64, dp::Vector<Entry>> index_; // Client NAME -> live versions
+        usize live_bytes_ = 0;
+        usize dead_bytes_ = 0;
+        usize compact_min_bytes_ = 1024 * 1024;
+        bool sync_ = true;
+
+      public:
+        VTVersionStore() = default;
+        ~VTVersionStore() { close(); }
+
+        VTVersionStore(const VTVersionStore &) = delete;
+        VTVersionStore &operator=(const VTVersionStore &) = delete;
+
+        // Open (or create) the store and index the versions in it
+        Result<void> open(const dp::String &path) {
+            close();
+            path_ = path;
+            fd_ = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+            if (fd_ < 0)
+                return Result<void>::err(Error(ErrorCode::DriverError, "cannot open version store: " + path));
+            struct stat st {};
+            if (::fstat(fd_, &st) < 0) {
+                close();
+                return Result<void>::err(Error(ErrorCode::DriverError, "cannot stat version store"));
+            }
+            file_size_ = static_cast<usize>(st.st_size);
+
+            if (file_size_ == 0) {
+                VersionStoreHeader header;
+                std::memcpy(header.magic, VERSION_STORE_MAGIC, 8);
+                if (!append(&header, sizeof(header), nullptr, 0)) {
+                    close();
+                    return Result<void>::err(Error(ErrorCode::DriverError, "cannot write version store"));
+                }
+            }
+            if (auto r = remap(); !r.is_ok()) {
+                close();
+                return r;
+            }
+            const auto *header = reinterpret_cast<const VersionStoreHeader *>(map_->addr);
+            if (file_size_ < sizeof(VersionStoreHeader) || std::memcmp(header->magic, VERSION_STORE_MAGIC, 8) != 0 ||
+                header->format != 1) {
+                close();
+                return Result<void>::err(Error::invalid_state("not a version store: " + path));
+            }
+            load_index();
+            echo::category("isobus.vt.versions")
+                .info("Version store ", path, ": ", versions(), " versions, ", file_size_, " bytes");
+            return {};
+        }
+
+        void close() {
+            map_.reset(); // Images from load() keep their own reference
+            if (fd_ >= 0)
+                ::close(fd_);
+            fd_ = -1;
+            file_size_ = 0;
+            index_.clear();
+            live_bytes_ = 0;
+            dead_bytes_ = 0;
+        }
+
+        bool is_open() const noexcept { return fd_ >= 0; }
+
+        // Compact once superseded bytes reach the live ones and this many bytes
+        void set_compaction_threshold(usize bytes) noexcept { compact_min_bytes_ = bytes; }
+        // fdatasync() after every write (default); off trades durability for speed
+        void set_sync(bool sync) noexcept { sync_ = sync; }
+
+        // ─── Versions ────────────────────────────────────────────────────────────
+        Result<void> store(Name name, const dp::String &label, DataSpan pool) {
+            if (!is_open())
+                return Result<void>::err(Error::invalid_state("version store not open"));
+            if (label.empty() || label.size() > VERSION_STORE_LABEL_SIZE)
+                return Result<void>::err(Error::invalid_state("bad version label"));
+            if (pool.empty() || pool.size() > 0xFFFFFFFFu)
+                return Result<void>::err(Error::invalid_state("bad pool size"));
+
+            VersionRecordHeader rec = record(name, label, 0);
+            rec.size = static_cast<u32>(pool.size());
+            rec.checksum = checksum(pool);
+            usize offset = file_size_ + sizeof(VersionRecordHeader);
+            if (!append(&rec, sizeof(rec), pool.data(), pool.size()))
+                return Result<void>::err(Error(ErrorCode::DriverError, "version store write failed"));
+
+            auto &versions = index_[name.raw];
+            if (Entry *old = find(versions, label)) {
+                retire(*old);
+                *old = Entry{label, offset, rec.size, rec.checksum};
+            } else {
+                versions.push_back(Entry{label, offset, rec.size, rec.checksum});
+            }
+            live_bytes_ += span(rec.size);
+            if (auto r = remap(); !r.is_ok())
+                return r;
+            maybe_compact();
+            return {};
+        }
+
+        // The stored pool, indexed in place over the mapped file
+        Result<PoolImage> load(Name name, const dp::String &label) const {
+            const Entry *e = find(name, label);
+            if (!e)
+                return Result<PoolImage>::err(Error::invalid_state("version not stored: " + label));
+            const u8 *bytes = static_cast<const u8 *>(map_->addr) + e->offset;
+            if (checksum(DataSpan(bytes, e->size)) != e->checksum)
+                return Result<PoolImage>::err(Error(ErrorCode::PoolValidation, "stored version corrupt: " + label));
+            return PoolImage::parse(std::shared_ptr<const void>(map_, map_->addr), bytes, e->size);
+        }
+
+        // False if the version was not stored
+        bool erase(Name name, const dp::String &label) {
+            auto it = index_.find(name.raw);
+            if (it == index_.end() || !is_open())
+                return false;
+            auto &versions = it->second;
+            for (usize i = 0; i < versions.size(); ++i) {
+                if (versions[i].label != label)
+                    continue;
+                VersionRecordHeader rec = record(name, label, 1);
+                if (!append(&rec, sizeof(rec), nullptr, 0))
+                    return false;
+                retire(versions[i]);
+                dead_bytes_ += span(0);
+                versions.erase(versions.begin() + static_cast<isize>(i));
+                if (versions.empty())
+                    index_.erase(it);
+                if (remap().is_ok())
+                    maybe_compact();
+                return true;
+            }
+            return false;
+        }
+
+        bool contains(Name name, const dp::String &label) const { return find(name, label) != nullptr; }
+
+        // Stored versions of a client, in the order first stored
+        dp::Vector<Version> list(Name name) const {
+            dp::Vector<Version> out;
+            auto it = index_.find(name.raw);
+            if (it == index_.end())
+                return out;
+            for (const auto &e : it->second)
+                out.push_back(Version{e.label, e.size});
+            return out;
+        }
+
+        // ─── Compaction ──────────────────────────────────────────────────────────
+        // Rewrite the live records into a new file and switch to it
+        Result<void> compact() {
+            if (!is_open())
+                return Result<void>::err(Error::invalid_state("version store not open"));
+            dp::String tmp = path_ + ".tmp";
+            int fd = ::open(tmp.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+            if (fd < 0)
+                return Result<void>::err(Error(ErrorCode::DriverError, "cannot create " + tmp));
+
+            const u8 *base = static_cast<const u8 *>(map_->addr);
+            bool ok = write_all(fd, base, sizeof(VersionStoreHeader));
+            usize out = sizeof(VersionStoreHeader);
+            dp::Map<u64, dp::Vector<Entry>> index;
+            for (const auto &[name, versions] : index_) {
+                for (const auto &e : versions) {
+                    const u8 *rec = base + e.offset - sizeof(VersionRecordHeader);
+                    usize len = span(e.size);
+                    ok = ok && write_all(fd, rec, len);
+                    index[name].push_back(Entry{e.label, out + sizeof(VersionRecordHeader), e.size, e.checksum});
+                    out += len;
+                }
+            }
+            if (sync_)
+                ok = ok && ::fdatasync(fd) == 0;
+            ok = ::close(fd) == 0 && ok;
+            if (!ok || ::rename(tmp.c_str(), path_.c_str()) != 0) {
+                ::unlink(tmp.c_str());
+                return Result<void>::err(Error(ErrorCode::DriverError, "version store compaction failed"));
+            }
+
+            // The old file lives on for the mappings still referencing it
+            int nfd = ::open(path_.c_str(), O_RDWR | O_CLOEXEC);
+            if (nfd < 0) {
+                close();
+                return Result<void>::err(Error(ErrorCode::DriverError, "cannot reopen version store"));
+            }
+            ::close(fd_);
+            fd_ = nfd;
+            echo::category("isobus.vt.versions").debug("Compacted version store: ", file_size_, " -> ", out, " bytes");
+            file_size_ = out;
+            index_ = std::move(index);
+            dead_bytes_ = 0;
+            return remap();
+        }
+
+        // ─── Statistics ──────────────────────────────────────────────────────────
+        usize versions() const noexcept {
+            usize n = 0;
+            for (const auto &[name, v] : index_)
+                n += v.size();
+            return n;
+        }
+        usize file_size() const noexcept { return file_size_; }
+        usize live_bytes() const noexcept { return live_bytes_; }
+        usize dead_bytes() const noexcept { return dead_bytes_; }
+        const dp::String &path() const noexcept { return path_; }
+
+      private:
+        static usize span(u32 size) noexcept { return sizeof(VersionRecordHeader) + ((size + 7u) & ~usize(7)); }
+
+        static u32 checksum(DataSpan bytes) noexcept {
+            u32 h = 2166136261u;
+            for (u8 b : bytes)
+                h = (h ^ b) * 16777619u;
+            return h;
+        }
+
+        static VersionRecordHeader record(Name name, const dp::String &label, u8 kind) {
+            VersionRecordHeader rec;
+            rec.name = name.raw;
+            rec.kind = kind;
+            rec.label_len = static_cast<u8>(label.size());
+            std::memcpy(rec.label, label.data(), label.size());
+            return rec;
+        }
+
+        static Entry *find(dp::Vector<Entry> &versions, const dp::String &label) {
+            for (auto &e : versions) {
+                if (e.label == label)
+                    return &e;
+            }
+            return nullptr;
+        }
+
+        const Entry *find(Name name, const dp::String &label) const {
+            auto it = index_.find(name.raw);
+            if (it == index_.end())
+                return nullptr;
+            for (const auto &e : it->second) {
+                if (e.label == label)
+                    return &e;
+            }
+            return nullptr;
+        }
+
+        void retire(const Entry &e) noexcept {
+            live_bytes_ -= span(e.size);
+            dead_bytes_ += span(e.size);
+        }
+
+        void maybe_compact() {
+            if (dead_bytes_ >= compact_min_bytes_ && dead_bytes_ >= live_bytes_) {
+                if (auto r = compact(); !r.is_ok())
+                    echo::category("isobus.vt.versions").warn("Compaction failed: ", r.error().message);
+            }
+        }
+
+        // Header, body and padding at the end of the file; undone if short
+        bool append(const void *header, usize header_size, const u8 *body, usize body_size) {
+            static constexpr u8 PAD[8] = {};
+            usize pad = body ? ((body_size + 7u) & ~usize(7)) - body_size : 0;
+            if (::lseek(fd_, static_cast<off_t>(file_size_), SEEK_SET) < 0)
+                return false;
+            bool ok = write_all(fd_, header, header_size) && (!body || write_all(fd_, body, body_size)) &&
+                      write_all(fd_, PAD, pad) && (!sync_ || ::fdatasync(fd_) == 0);
+            if (!ok) {
+                if (::ftruncate(fd_, static_cast<off_t>(file_size_)) != 0)
+                    echo::category("isobus.vt.versions").error("cannot undo a short write to ", path_);
+                return false;
+            }
+            file_size_ += header_size + body_size + pad;
+            return true;
+        }
+
+        static bool write_all(int fd, const void *data, usize size) {
+            const u8 *p = static_cast<const u8 *>(data);
+            while (size > 0) {
+                ssize_t n = ::write(fd, p, size);
+                if (n <= 0)
+                    return false;
+                p += n;
+                size -= static_cast<usize>(n);
+            }
+            return true;
+        }
+
+        // Map the file at its current size; earlier mappings stay with their images
+        Result<void> remap() {
+            void *m = ::mmap(nullptr, file_size_, PROT_READ, MAP_SHARED, fd_, 0);
+            if (m == MAP_FAILED)
+                return Result<void>::err(Error(ErrorCode::DriverError, "mmap failed"));
+            map_ = std::make_shared<Mapping>(m, file_size_);
+            return {};
+        }
+
+        // Replay the records; a torn one at the end is cut off
+        void load_index() {
+            const u8 *base = static_cast<const u8 *>(map_->addr);
+            usize offset = sizeof(VersionStoreHeader);
+            while (offset + sizeof(VersionRecordHeader) <= file_size_) {
+                VersionRecordHeader rec;
+                std::memcpy(&rec, base + offset, sizeof(rec));
+                if (rec.magic != VERSION_RECORD_MAGIC || rec.label_len == 0 ||
+                    rec.label_len > VERSION_STORE_LABEL_SIZE || rec.kind > 1 ||
+                    offset + span(rec.kind == 0 ? rec.size : 0) > file_size_)
+                    break;
+                dp::String label(rec.label, rec.label_len);
+                auto &versions = index_[rec.name];
+                Entry *old = find(versions, label);
+                if (old)
+                    retire(*old);
+                if (rec.kind == 1) {
+                    dead_bytes_ += span(0);
+                    if (old)
+                        versions.erase(versions.begin() + (old - versions.data()));
+                    if (versions.empty())
+                        index_.erase(rec.name);
+                } else if (old) {
+                    *old = Entry{label, offset + sizeof(rec), rec.size, rec.checksum};
+                    live_bytes_ += span(rec.size);
+                } else {
+                    versions.push_back(Entry{label, offset + sizeof(rec), rec.size, rec.checksum});
+                    live_bytes_ += span(rec.size);
+                }
+                offset += span(rec.kind == 0 ? rec.size : 0);
+            }
+            if (offset < file_size_) {
+                echo::category("isobus.vt.versions")
+                    .warn("Dropping ", file_size_ - offset, " bytes of a torn record from ", path_);
+                if (::ftruncate(fd_, static_cast<off_t>(offset)) == 0) {
+                    file_size_ = offset;
+                    remap();
+                }
+            }
+        }
+    };
+
+} // namespace agrobus::isobus::vt
@@ -35,7 +35,7 @@ namespace agrobus::j1939 {
             return data;
         }
 
-        static Acknowledgment decode(const dp::Vector<u8> &data) {
+        static Acknowledgment decode(DataSpan data) {
             Acknowledgment ack;
             if (data.size() >= 8) {
                 ack.control = static_cast<AckControl>(data[0]);
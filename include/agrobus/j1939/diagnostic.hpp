@@ -77,6 +77,85 @@ namespace agrobus::j1939 {
         u8 occurrence_count = 0;
     };
 
+    // SPN (19 bits) and FMI (5 bits) packed the way they sit in a DTC
+    constexpr u32 dtc_key(u32 spn, FMI fmi) noexcept { return ((spn & 0x7FFFF) << 5) | (static_cast<u8>(fmi) & 0x1F); }
+    constexpr u32 dtc_key(const DTC &dtc) noexcept { return dtc_key(dtc.spn, dtc.fmi); }
+    constexpr u32 dtc_key(const PreviouslyActiveDTC &pa) noexcept { return dtc_key(pa.dtc); }
+
+    // ─── SPN/FMI-keyed DTC table ────────────────────────────────────────────────
+    // Entries in a vector (the order they go out in a DM message), with a key
+    // index so set and clear don't scan. The order is insertion order only
+    // until the first erase: an erase moves the last entry into the freed
+    // slot, so it costs one index update, and DM1/DM2 list that entry there
+    // from then on. Entry references and entries() iterators are invalidated
+    // by any change.
+    // revision() changes with every change to the set or a count, so an
+    // encoding cached against it is only rebuilt when there is something new
+    // to send.
+    template <typename T> class DTCTable {
+        dp::Vector<T> entries_;
+        dp::Map<u32, u32> index_; // dtc_key -> position in entries_
+        u32 revision_ = 0;
+
+        // Shared by the const and mutable find()
+        template <typename Self> static auto lookup(Self &self, u32 spn, FMI fmi) -> decltype(&self.entries_[0]) {
+            auto it = self.index_.find(dtc_key(spn, fmi));
+            return it != self.index_.end() ? &self.entries_[it->second] : nullptr;
+        }
+
+      public:
+        const dp::Vector<T> &entries() const noexcept { return entries_; }
+        usize size() const noexcept { return entries_.size(); }
+        bool empty() const noexcept { return entries_.empty(); }
+        u32 revision() const noexcept { return revision_; }
+
+        T *find(u32 spn, FMI fmi) { return lookup(*this, spn, fmi); }
+        const T *find(u32 spn, FMI fmi) const { return lookup(*this, spn, fmi); }
+        bool contains(u32 spn, FMI fmi) const { return find(spn, fmi) != nullptr; }
+
+        // The entry for `entry`'s SPN/FMI: inserted as given when new, otherwise
+        // handed to `update` to merge into the existing one
+        template <typename Update> T &upsert(const T &entry, Update &&update) {
+            ++revision_;
+            u32 key = dtc_key(entry);
+            auto it = index_.find(key);
+            if (it != index_.end()) {
+                update(entries_[it->second]);
+                return entries_[it->second];
+            }
+            index_[key] = static_cast<u32>(entries_.size());
+            entries_.push_back(entry);
+            return entries_.back();
+        }
+
+        dp::Optional<T> erase(u32 spn, FMI fmi) {
+            auto it = index_.find(dtc_key(spn, fmi));
+            if (it == index_.end())
+                return dp::nullopt;
+            u32 pos = it->second;
+            T removed = std::move(entries_[pos]);
+            index_.erase(it);
+            if (pos + 1 < entries_.size()) {
+                entries_[pos] = std::move(entries_.back());
+                index_[dtc_key(entries_[pos])] = pos;
+            }
+            entries_.pop_back();
+            ++revision_;
+            return removed;
+        }
+
+        void clear() {
+            if (entries_.empty())
+                return;
+            entries_.clear();
+            index_.clear();
+            ++revision_;
+        }
+    };
+
+    // Occurrence counts saturate at 126 (127 = not available)
+    constexpr u8 bump_occurrence(u8 count) noexcept { return count < 126 ? count + 1 : 126; }
+
     // ─── Diagnostic lamp status ──────────────────────────────────────────────────
     struct DiagnosticLamps {
         LampStatus malfunction = LampStatus::Off;
@@ -157,7 +236,7 @@ namespace agrobus::j1939 {
             return data;
         }
 
-        static DiagnosticProtocolID decode(const dp::Vector<u8> &data) {
+        static DiagnosticProtocolID decode(DataSpan data) {
             DiagnosticProtocolID id;
             if (!data.empty()) {
                 id.protocols = data[0];
@@ -204,7 +283,7 @@ namespace agrobus::j1939 {
             return data;
         }
 
-        static ProductIdentification decode(const dp::Vector<u8> &data) {
+        static ProductIdentification decode(DataSpan data) {
             ProductIdentification id;
             usize field = 0;
             for (u8 b : data) {
@@ -245,7 +324,7 @@ namespace agrobus::j1939 {
             return data;
         }
 
-        static SoftwareIdentification decode(const dp::Vector<u8> &data) {
+        static SoftwareIdentification decode(DataSpan data) {
             SoftwareIdentification id;
             if (data.empty())
                 return id;
@@ -266,15 +345,26 @@ namespace agrobus::j1939 {
     };
 
     // ─── Diagnostic Protocol (DM1/DM2/DM3/DM11/DM13/DM22) ───────────────────────
+    // The auto-sent DM1 is a periodic timer on the IsoNet timer wheel, so it
+    // goes out from IsoNet::update(); update() here only runs the DM13 suspend
+    // durations. Neither copyable nor movable: the timer and the PGN
+    // callbacks hold `this`.
     class DiagnosticProtocol {
         IsoNet &net_;
         InternalCF *cf_;
-        dp::Vector<DTC> active_dtcs_;
-        dp::Vector<DTC> previous_dtcs_;
-        dp::Vector<PreviouslyActiveDTC> previously_active_dtcs_;
+        DTCTable<DTC> active_dtcs_;
+        DTCTable<DTC> previous_dtcs_;
+        DTCTable<PreviouslyActiveDTC> previously_active_dtcs_;
         DiagnosticLamps lamps_;
+
+        // DM1/DM2/DM3 payloads, rebuilt when their table's revision or the lamps change
+        struct EncodedDM {
+            SharedPayload data;
+            u32 revision = 0;
+        };
+        EncodedDM dm1_cache_, dm2_cache_, dm3_cache_;
         u32 dm1_interval_ms_ = 1000;
-        u32 dm1_timer_ms_ = 0;
+        TimerId dm1_timer_ = INVALID_TIMER;
         bool auto_send_ = false;
         bool dm1_suspended_ = false;
         bool dm2_suspended_ = false;
@@ -289,7 +379,17 @@ namespace agrobus::j1939 {
 
       public:
         DiagnosticProtocol(IsoNet &net, InternalCF *cf, DiagnosticConfig config = {})
-            : net_(net), cf_(cf), dm1_interval_ms_(config.dm1_interval_ms), auto_send_(config.auto_send) {}
+            : net_(net), cf_(cf), dm1_interval_ms_(config.dm1_interval_ms), auto_send_(config.auto_send) {
+            if (auto_send_)
+                arm_dm1();
+        }
+
+        DiagnosticProtocol(const DiagnosticProtocol &) = delete;
+        DiagnosticProtocol &operator=(const DiagnosticProtocol &) = delete;
+        DiagnosticProtocol(DiagnosticProtocol &&) = delete;
+        DiagnosticProtocol &operator=(DiagnosticProtocol &&) = delete;
+
+        ~DiagnosticProtocol() { net_.timers().cancel(dm1_timer_); }
 
         Result<void> initialize() {
             if (!cf_) {
@@ -327,7 +427,7 @@ namespace agrobus::j1939 {
 
         // ─── Previously active DTCs (with occurrence tracking) ───────────────────
         const dp::Vector<PreviouslyActiveDTC> &previously_active_dtcs() const noexcept {
-            return previously_active_dtcs_;
+            return previously_active_dtcs_.entries();
         }
 
         void clear_previously_active_dtcs() {
@@ -337,37 +437,28 @@ namespace agrobus::j1939 {
 
         // ─── DTC management ──────────────────────────────────────────────────────
         Result<void> set_active(DTC dtc) {
-            for (auto &existing : active_dtcs_) {
-                if (existing == dtc) {
-                    existing.occurrence_count = (existing.occurrence_count < 126) ? existing.occurrence_count + 1 : 126;
-                    return {};
-                }
-            }
+            bool added = !active_dtcs_.contains(dtc.spn, dtc.fmi);
             dtc.occurrence_count = 1;
-            active_dtcs_.push_back(dtc);
-            echo::category("isobus.diagnostic").info("DTC set active: spn=", dtc.spn);
+            active_dtcs_.upsert(dtc, [](DTC &existing) {
+                existing.occurrence_count = bump_occurrence(existing.occurrence_count);
+            });
+            if (added)
+                echo::category("isobus.diagnostic").info("DTC set active: spn=", dtc.spn);
             return {};
         }
 
         Result<void> clear_active(u32 spn, FMI fmi) {
-            for (auto it = active_dtcs_.begin(); it != active_dtcs_.end(); ++it) {
-                if (it->spn == spn && it->fmi == fmi) {
-                    previous_dtcs_.push_back(*it);
-                    // Track in previously_active_dtcs_ with occurrence count
-                    track_previously_active(*it);
-                    active_dtcs_.erase(it);
-                    echo::category("isobus.diagnostic").info("DTC cleared: spn=", spn);
-                    return {};
-                }
-            }
-            return Result<void>::err(Error::invalid_state("DTC not found"));
+            auto dtc = active_dtcs_.erase(spn, fmi);
+            if (!dtc)
+                return Result<void>::err(Error::invalid_state("DTC not found"));
+            retire(*dtc);
+            echo::category("isobus.diagnostic").info("DTC cleared: spn=", spn);
+            return {};
         }
 
         Result<void> clear_all_active() {
-            for (auto &dtc : active_dtcs_) {
-                previous_dtcs_.push_back(dtc);
-                track_previously_active(dtc);
-            }
+            for (const auto &dtc : active_dtcs_.entries())
+                retire(dtc);
             active_dtcs_.clear();
             echo::category("isobus.diagnostic").info("all active DTCs cleared");
             return {};
@@ -379,32 +470,44 @@ namespace agrobus::j1939 {
             return {};
         }
 
-        dp::Vector<DTC> active_dtcs() const { return active_dtcs_; }
-        dp::Vector<DTC> previous_dtcs() const { return previous_dtcs_; }
+        const dp::Vector<DTC> &active_dtcs() const noexcept { return active_dtcs_.entries(); }
+        const dp::Vector<DTC> &previous_dtcs() const noexcept { return previous_dtcs_.entries(); }
+
+        const DTC *find_active(u32 spn, FMI fmi) const { return active_dtcs_.find(spn, fmi); }
+        bool is_active(u32 spn, FMI fmi) const { return active_dtcs_.contains(spn, fmi); }
 
         // ─── Suspend state access ─────────────────────────────────────────────────
         bool is_dm1_suspended() const noexcept { return dm1_suspended_; }
         bool is_dm2_suspended() const noexcept { return dm2_suspended_; }
 
         // ─── Lamp control ────────────────────────────────────────────────────────
-        void set_lamps(DiagnosticLamps lamps) { lamps_ = lamps; }
+        void set_lamps(DiagnosticLamps lamps) {
+            auto before = lamps_.encode(), after = lamps.encode();
+            if (before[0] != after[0] || before[1] != after[1])
+                invalidate_encodings();
+            lamps_ = lamps;
+        }
         DiagnosticLamps lamps() const noexcept { return lamps_; }
 
         // ─── Auto-send DM1 ──────────────────────────────────────────────────────
         Result<void> enable_auto_send(u32 interval_ms = 1000) {
             auto_send_ = true;
             dm1_interval_ms_ = interval_ms;
+            arm_dm1();
             echo::category("isobus.diagnostic").debug("auto-send enabled: interval=", interval_ms, "ms");
             return {};
         }
 
         Result<void> disable_auto_send() {
             auto_send_ = false;
+            net_.timers().cancel(dm1_timer_);
+            dm1_timer_ = INVALID_TIMER;
             echo::category("isobus.diagnostic").debug("auto-send disabled");
             return {};
         }
 
         void update(u32 elapsed_ms) {
+            ProfileScope profile(net_.update_profiler(), "diagnostic");
             // DM13 suspend duration tracking: auto-resume when timer expires
             if (dm1_suspended_ && dm1_suspend_remaining_ms_ > 0) {
                 if (elapsed_ms >= dm1_suspend_remaining_ms_) {
@@ -424,40 +527,36 @@ namespace agrobus::j1939 {
                     dm2_suspend_remaining_ms_ -= elapsed_ms;
                 }
             }
-
-            if (auto_send_ && !dm1_suspended_) {
-                dm1_timer_ms_ += elapsed_ms;
-                if (dm1_timer_ms_ >= dm1_interval_ms_) {
-                    dm1_timer_ms_ -= dm1_interval_ms_;
-                    send_dm1();
-                }
-            }
         }
 
         // ─── Manual send ─────────────────────────────────────────────────────────
-        Result<void> send_dm1() {
-            auto data = encode_dtc_message(active_dtcs_);
-            return net_.send(PGN_DM1, data, cf_);
-        }
+        Result<void> send_dm1() { return net_.send_shared(PGN_DM1, dm1_payload(), cf_); }
+
+        // DM2: all previously active DTCs, each with its previously active count
+        Result<void> send_dm2() { return net_.send_shared(PGN_DM2, dm2_payload(), cf_); }
 
-        Result<void> send_dm2() {
-            // DM2: Include ALL previously active DTCs where occurrence_count > 0
-            dp::Vector<DTC> dm2_dtcs;
-            for (const auto &pa : previously_active_dtcs_) {
-                if (pa.occurrence_count > 0) {
+        // DM3: Clear previously active DTCs (response to DM3 request)
+        Result<void> send_dm3() { return net_.send_shared(PGN_DM3, dm3_payload(), cf_); }
+
+        // Encoded DM1/DM2/DM3 as they go out; the same buffer until the DTCs or lamps change
+        SharedPayload dm1_payload() {
+            return cached(dm1_cache_, active_dtcs_.revision(), [this]() { return encode_dtc_message(active_dtcs()); });
+        }
+        SharedPayload dm2_payload() {
+            return cached(dm2_cache_, previously_active_dtcs_.revision(), [this]() {
+                dp::Vector<DTC> dm2_dtcs;
+                dm2_dtcs.reserve(previously_active_dtcs_.size());
+                for (const auto &pa : previously_active_dtcs_.entries()) {
                     DTC dtc = pa.dtc;
                     dtc.occurrence_count = pa.occurrence_count;
                     dm2_dtcs.push_back(dtc);
                 }
-            }
-            auto data = encode_dtc_message(dm2_dtcs);
-            return net_.send(PGN_DM2, data, cf_);
+                return encode_dtc_message(dm2_dtcs);
+            });
         }
-
-        // DM3: Clear previously active DTCs (response to DM3 request)
-        Result<void> send_dm3() {
-            auto data = encode_dtc_message(previous_dtcs_);
-            return net_.send(PGN_DM3, data, cf_);
+        SharedPayload dm3_payload() {
+            return cached(dm3_cache_, previous_dtcs_.revision(),
+                          [this]() { return encode_dtc_message(previous_dtcs()); });
         }
 
         // DM13: Stop/Start broadcast
@@ -529,17 +628,40 @@ namespace agrobus::j1939 {
         Event<const DiagnosticProtocolID &, Address> on_dm5_received;
 
       private:
-        void track_previously_active(const DTC &dtc) {
-            for (auto &pa : previously_active_dtcs_) {
-                if (pa.dtc == dtc) {
-                    pa.occurrence_count = (pa.occurrence_count < 126) ? pa.occurrence_count + 1 : 126;
-                    return;
-                }
-            }
+        // DM1 every interval on the network clock, anchored where auto-send
+        // started; a DM13 suspend skips the beats that fall inside it
+        void arm_dm1() {
+            net_.timers().cancel(dm1_timer_);
+            u32 phase = dm1_interval_ms_ == 0 ? 0 : static_cast<u32>(net_.timers().now_ms() % dm1_interval_ms_);
+            dm1_timer_ = net_.timers().schedule_every(dm1_interval_ms_, phase, [this]() {
+                if (!dm1_suspended_)
+                    send_dm1();
+            });
+        }
+
+        // A DTC leaving the active set: kept in the previous list and counted as previously active
+        void retire(const DTC &dtc) {
+            previous_dtcs_.upsert(dtc, [&](DTC &existing) { existing = dtc; });
             PreviouslyActiveDTC pa;
             pa.dtc = dtc;
             pa.occurrence_count = dtc.occurrence_count > 0 ? dtc.occurrence_count : 1;
-            previously_active_dtcs_.push_back(pa);
+            previously_active_dtcs_.upsert(pa, [](PreviouslyActiveDTC &existing) {
+                existing.occurrence_count = bump_occurrence(existing.occurrence_count);
+            });
+        }
+
+        template <typename Encode> SharedPayload cached(EncodedDM &cache, u32 revision, Encode &&encode) {
+            if (!cache.data || cache.revision != revision) {
+                cache.data = std::make_shared<const dp::Vector<u8>>(encode());
+                cache.revision = revision;
+            }
+            return cache.data;
+        }
+
+        void invalidate_encodings() {
+            dm1_cache_.data.reset();
+            dm2_cache_.data.reset();
+            dm3_cache_.data.reset();
         }
 
         dp::Vector<u8> encode_dtc_message(const dp::Vector<DTC> &dtcs) const {
@@ -670,14 +792,7 @@ namespace agrobus::j1939 {
                 DM22Control response = result.is_ok() ? DM22Control::AckClearActive : DM22Control::NackClearActive;
                 send_dm22_clear(response, spn, fmi, msg.source);
             } else if (control == DM22Control::ClearPreviouslyActive) {
-                bool found = false;
-                for (auto it = previous_dtcs_.begin(); it != previous_dtcs_.end(); ++it) {
-                    if (it->spn == spn && it->fmi == fmi) {
-                        previous_dtcs_.erase(it);
-                        found = true;
-                        break;
-                    }
-                }
+                bool found = previous_dtcs_.erase(spn, fmi).has_value();
                 DM22Control response =
                     found ? DM22Control::AckClearPreviouslyActive : DM22Control::NackClearPreviouslyActive;
                 send_dm22_clear(response, spn, fmi, msg.source);
@@ -706,11 +821,11 @@ namespace agrobus::j1939 {
                 .debug("DM5 from ", msg.source, ": protocols=0x", static_cast<int>(id.protocols));
         }
 
-        dp::Vector<DTC> decode_dtc_message(const dp::Vector<u8> &data) const {
+        dp::Vector<DTC> decode_dtc_message(DataSpan data) const {
             dp::Vector<DTC> dtcs;
             // Skip 2 lamp bytes, then read 4-byte DTCs
             for (usize i = 2; i + 3 < data.size(); i += 4) {
-                DTC dtc = DTC::decode(&data[i]);
+                DTC dtc = DTC::decode(data.data() + i);
                 if (dtc.spn != 0 || static_cast<u8>(dtc.fmi) != 0) {
                     dtcs.push_back(dtc);
                 }
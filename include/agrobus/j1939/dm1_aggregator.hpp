@@ -0,0 +1,217 @@
+#pragma once
+
+#include "diagnostic.hpp"
+#include <agrobus/net/data_span.hpp>
+#include <agrobus/net/event.hpp>
+#include <agrobus/net/message.hpp>
+#include <agrobus/net/network_manager.hpp>
+#include <agrobus/net/types.hpp>
+#include <algorithm>
+#include <cstring>
+#include <datapod/datapod.hpp>
+#include <echo/echo.hpp>
+
+namespace agrobus::j1939 {
+    using namespace agrobus::net;
+
+    // ─── DTC change (one entry of a delta) ──────────────────────────────────────
+    enum class DTCChangeKind : u8 {
+        Added,              // Not in the source's previous DM1
+        Cleared,            // Gone from its DM1, or the source went silent
+        OccurrenceIncreased // Still active, with a higher occurrence count
+    };
+
+    struct DTCChange {
+        Address source = NULL_ADDRESS;
+        DTC dtc; // As last reported (for Cleared: as it was before)
+        DTCChangeKind kind = DTCChangeKind::Added;
+        u8 previous_count = 0; // Occurrence count before an increase
+    };
+
+    // ─── Aggregator configuration ───────────────────────────────────────────────
+    struct DM1AggregatorConfig {
+        u32 timeout_ms = 3000; // A source silent this long has all its DTCs cleared (DM1 goes out every 1 s)
+
+        DM1AggregatorConfig &timeout(u32 ms) {
+            timeout_ms = ms;
+            return *this;
+        }
+    };
+
+    // ─── One ECU's last DM1 ─────────────────────────────────────────────────────
+    struct DM1Source {
+        Address address = NULL_ADDRESS;
+        DiagnosticLamps lamps;
+        DTCTable<DTC> dtcs;
+        dp::Vector<u8> raw; // Last payload as received, to skip unchanged repeats
+        u32 silent_ms = 0;
+    };
+
+    // ─── Bus-wide DM1 aggregation ───────────────────────────────────────────────
+    // Keeps the active DTCs of every ECU on the bus and reports only what
+    // changed. DM1 is taken from the view path, so a BAM-reassembled DM1 is
+    // read straight out of the transport buffer; a payload identical to the
+    // source's previous one (the usual case, once a second) is recognised by
+    // a byte compare and costs no decode at all. Anything else is matched
+    // against the source's SPN/FMI table and turned into one batch of
+    // DTCChange entries for on_changes. A source that stops sending for
+    // timeout_ms has its DTCs reported as cleared and is forgotten.
+    class DM1Aggregator {
+        IsoNet &net_;
+        DM1AggregatorConfig config_;
+        dp::Map<Address, DM1Source> sources_;
+        dp::Vector<DTC> decoded_;   // Scratch, reused across messages
+        dp::Vector<u32> keys_;      // Scratch: sorted keys of decoded_
+        dp::Vector<DTCChange> changes_;
+        usize active_count_ = 0;
+        u32 revision_ = 0;
+        bool initialized_ = false;
+
+      public:
+        explicit DM1Aggregator(IsoNet &net, DM1AggregatorConfig config = {}) : net_(net), config_(config) {}
+        DM1Aggregator(const DM1Aggregator &) = delete;
+        DM1Aggregator &operator=(const DM1Aggregator &) = delete;
+
+        Result<void> initialize() {
+            if (initialized_)
+                return {};
+            auto result = net_.register_pgn_view_callback(PGN_DM1, [this](const MessageView &msg) { handle_dm1(msg); });
+            if (result.is_err())
+                return result;
+            initialized_ = true;
+            return {};
+        }
+
+        void update(u32 elapsed_ms) {
+            dp::Vector<Address> lost;
+            for (auto &[address, src] : sources_) {
+                src.silent_ms += elapsed_ms;
+                if (src.silent_ms >= config_.timeout_ms)
+                    lost.push_back(address);
+            }
+            for (Address address : lost)
+                drop(address);
+        }
+
+        // ─── Merged view ─────────────────────────────────────────────────────────
+        const DM1Source *source(Address address) const {
+            auto it = sources_.find(address);
+            return it != sources_.end() ? &it->second : nullptr;
+        }
+        const dp::Map<Address, DM1Source> &sources() const noexcept { return sources_; }
+
+        // Active DTCs over all sources
+        usize active_count() const noexcept { return active_count_; }
+
+        template <typename Fn> void for_each_active(Fn &&fn) const {
+            for (const auto &[address, src] : sources_)
+                for (const auto &dtc : src.dtcs.entries())
+                    fn(address, dtc);
+        }
+
+        // Changes with every delta, so a reader can tell whether the merged list moved
+        u32 revision() const noexcept { return revision_; }
+
+        // ─── Events ──────────────────────────────────────────────────────────────
+        Event<Address, const dp::Vector<DTCChange> &> on_changes; // One batch per changed DM1
+        Event<Address, const DiagnosticLamps &> on_lamps_changed;
+        Event<Address> on_source_lost; // Timed out (its DTCs were reported cleared first)
+
+      private:
+        void handle_dm1(const MessageView &msg) {
+            if (msg.data.size() < 6)
+                return;
+            bool added = sources_.find(msg.source) == sources_.end();
+            DM1Source &src = sources_[msg.source];
+            src.silent_ms = 0;
+            if (!added && src.raw.size() == msg.data.size() &&
+                std::memcmp(src.raw.data(), msg.data.data(), msg.data.size()) == 0)
+                return;
+            src.address = msg.source;
+            src.raw.assign(msg.data.begin(), msg.data.end());
+
+            DiagnosticLamps lamps = DiagnosticLamps::decode(msg.data.data());
+            auto before = src.lamps.encode(), after = lamps.encode();
+            bool lamps_changed = added ? (after[0] != 0 || after[1] != 0)
+                                       : (before[0] != after[0] || before[1] != after[1]);
+            src.lamps = lamps;
+
+            decode(msg.data);
+            changes_.clear();
+            for (const auto &dtc : decoded_) {
+                DTC *existing = src.dtcs.find(dtc.spn, dtc.fmi);
+                if (!existing) {
+                    src.dtcs.upsert(dtc, [](DTC &) {});
+                    ++active_count_;
+                    changes_.push_back({msg.source, dtc, DTCChangeKind::Added, 0});
+                } else if (dtc.occurrence_count != existing->occurrence_count) {
+                    u8 previous = existing->occurrence_count;
+                    existing->occurrence_count = dtc.occurrence_count;
+                    if (dtc.occurrence_count > previous)
+                        changes_.push_back({msg.source, dtc, DTCChangeKind::OccurrenceIncreased, previous});
+                }
+            }
+            if (src.dtcs.size() > decoded_.size() - duplicates())
+                sweep(src, msg.source);
+
+            if (!changes_.empty()) {
+                ++revision_;
+                on_changes.emit(msg.source, changes_);
+            }
+            if (lamps_changed)
+                on_lamps_changed.emit(msg.source, src.lamps);
+        }
+
+        void drop(Address address) {
+            echo::category("isobus.diagnostic.dm1").debug("DM1 source timed out: ", address);
+            auto it = sources_.find(address);
+            changes_.clear();
+            for (const auto &dtc : it->second.dtcs.entries())
+                changes_.push_back({address, dtc, DTCChangeKind::Cleared, dtc.occurrence_count});
+            active_count_ -= it->second.dtcs.size();
+            sources_.erase(address);
+            if (!changes_.empty()) {
+                ++revision_;
+                on_changes.emit(address, changes_);
+            }
+            on_source_lost.emit(address);
+        }
+
+        // DTCs after the two lamp bytes; the empty-list placeholder (all zero)
+        // and 0xFF padding are not DTCs
+        void decode(DataSpan data) {
+            decoded_.clear();
+            keys_.clear();
+            for (usize i = 2; i + 3 < data.size(); i += 4) {
+                const u8 *p = data.data() + i;
+                if ((p[0] | p[1] | p[2]) == 0 || (p[0] & p[1] & p[2] & p[3]) == 0xFF)
+                    continue;
+                DTC dtc = DTC::decode(p);
+                decoded_.push_back(dtc);
+                keys_.push_back(dtc_key(dtc));
+            }
+            std::sort(keys_.begin(), keys_.end());
+        }
+
+        // The same SPN/FMI listed twice in one DM1 is one table entry
+        usize duplicates() const {
+            usize n = 0;
+            for (usize i = 1; i < keys_.size(); ++i)
+                n += keys_[i] == keys_[i - 1];
+            return n;
+        }
+
+        // Entries no longer in the source's DM1
+        void sweep(DM1Source &src, Address source) {
+            dp::Vector<DTC> gone;
+            for (const auto &dtc : src.dtcs.entries())
+                if (!std::binary_search(keys_.begin(), keys_.end(), dtc_key(dtc)))
+                    gone.push_back(dtc);
+            for (const auto &dtc : gone) {
+                src.dtcs.erase(dtc.spn, dtc.fmi);
+                --active_count_;
+                changes_.push_back({source, dtc, DTCChangeKind::Cleared, dtc.occurrence_count});
+            }
+        }
+    };
+} // namespace agrobus::j1939
@@ -7,6 +7,7 @@
 #include <agrobus/net/message.hpp>
 #include <agrobus/net/network_manager.hpp>
 #include <agrobus/net/types.hpp>
+#include <algorithm>
 #include <datapod/datapod.hpp>
 #include <echo/echo.hpp>
 
@@ -47,7 +48,7 @@ namespace agrobus::j1939 {
             return data;
         }
 
-        static DM14Request decode(const dp::Vector<u8> &data) {
+        static DM14Request decode(DataSpan data) {
             DM14Request msg;
             if (data.size() >= 7) {
                 msg.command = static_cast<DM14Command>(data[0] & 0x07);
@@ -85,7 +86,7 @@ namespace agrobus::j1939 {
             return data;
         }
 
-        static DM15Response decode(const dp::Vector<u8> &data) {
+        static DM15Response decode(DataSpan data) {
             DM15Response msg;
             if (data.size() >= 7) {
                 msg.status = static_cast<DM15Status>(data[0] & 0x07);
@@ -103,28 +104,46 @@ namespace agrobus::j1939 {
 
     // ─── DM16 Binary Data Transfer (PGN 0xD700) ─────────────────────────────────
     // Carries the actual data bytes for memory read/write operations.
-    // May use transport protocol if data exceeds 8 bytes.
+    // Up to 7 bytes fit a single frame; longer blocks go out over TP (up to
+    // 1784 bytes) or ETP, with num_bytes = 0xFF meaning "the rest of the message".
 
     struct DM16Transfer {
-        u8 num_bytes = 0;    // Number of data bytes in this message
-        dp::Vector<u8> data; // Binary data (up to 7 bytes single-frame, more via TP)
+        static constexpr u8 LENGTH_IN_MESSAGE = 0xFF;
+
+        u8 num_bytes = 0;    // Number of data bytes in this message (0xFF: 255 or more)
+        dp::Vector<u8> data; // Binary data
+
+        static DM16Transfer of(DataSpan bytes) {
+            DM16Transfer msg;
+            msg.num_bytes = bytes.size() < LENGTH_IN_MESSAGE ? static_cast<u8>(bytes.size()) : LENGTH_IN_MESSAGE;
+            msg.data.assign(bytes.begin(), bytes.end());
+            return msg;
+        }
 
         dp::Vector<u8> encode() const {
-            dp::Vector<u8> encoded(8, 0xFF);
-            encoded[0] = num_bytes;
-            for (usize i = 0; i < data.size() && i < 7; ++i) {
-                encoded[1 + i] = data[i];
+            if (data.size() <= 7) {
+                dp::Vector<u8> encoded(8, 0xFF);
+                encoded[0] = num_bytes;
+                for (usize i = 0; i < data.size(); ++i) {
+                    encoded[1 + i] = data[i];
+                }
+                return encoded;
             }
+            dp::Vector<u8> encoded;
+            encoded.reserve(1 + data.size());
+            encoded.push_back(num_bytes);
+            encoded.insert(encoded.end(), data.begin(), data.end());
             return encoded;
         }
 
-        static DM16Transfer decode(const dp::Vector<u8> &raw) {
+        static DM16Transfer decode(DataSpan raw) {
             DM16Transfer msg;
             if (!raw.empty()) {
                 msg.num_bytes = raw[0];
-                for (usize i = 1; i < raw.size() && i <= msg.num_bytes; ++i) {
-                    msg.data.push_back(raw[i]);
-                }
+                usize count = raw.size() - 1;
+                if (msg.num_bytes != LENGTH_IN_MESSAGE && msg.num_bytes < count)
+                    count = msg.num_bytes;
+                msg.data.assign(raw.begin() + 1, raw.begin() + 1 + count);
             }
             return msg;
         }
@@ -155,7 +174,7 @@ namespace agrobus::j1939 {
             return data;
         }
 
-        static ECUIdentification decode(const dp::Vector<u8> &data) {
+        static ECUIdentification decode(DataSpan data) {
             ECUIdentification id;
             usize field = 0;
             dp::String current;
@@ -255,4 +274,354 @@ namespace agrobus::j1939 {
         Event<DM16Transfer, Address> on_dm16_transfer;
         Event<ECUIdentification, Address> on_ecu_identification;
     };
+    // ─── Bulk memory transfer ───────────────────────────────────────────────────
+    enum class BulkOp : u8 { Read, Write };
+    enum class BulkState : u8 { Idle, Running, Completed, Failed, Aborted };
+
+    struct BulkTransferConfig {
+        u16 block_size = 1784;          // Bytes per DM14 cycle (1784 + the DM16 count byte fills one TP message)
+        u8 window = 2;                  // DM14 cycles in flight; DM16 blocks still go one at a time
+        u32 response_timeout_ms = 1250; // Per step of a block (DM15, DM16, DM15 Completed)
+        u32 busy_retry_ms = 50;         // Delay before asking again after DM15 Busy
+        u8 max_retries = 3;             // Timeouts tolerated per block before the transfer fails
+        DM14PointerType pointer_type = DM14PointerType::DirectPhysical;
+        u8 key = 0xFF;
+
+        BulkTransferConfig &block(u16 bytes) {
+            block_size = bytes;
+            return *this;
+        }
+        BulkTransferConfig &in_flight(u8 blocks) {
+            window = blocks;
+            return *this;
+        }
+        BulkTransferConfig &timeout(u32 ms) {
+            response_timeout_ms = ms;
+            return *this;
+        }
+        BulkTransferConfig &retries(u8 n) {
+            max_retries = n;
+            return *this;
+        }
+        BulkTransferConfig &pointer(DM14PointerType type) {
+            pointer_type = type;
+            return *this;
+        }
+        BulkTransferConfig &security_key(u8 k) {
+            key = k;
+            return *this;
+        }
+    };
+
+    struct BulkProgress {
+        BulkOp op = BulkOp::Read;
+        Address ecu = NULL_ADDRESS;
+        u32 address = 0;     // Start of the whole range
+        u32 length = 0;      // Bytes in the whole range
+        u32 done = 0;        // Bytes from the start confirmed in order; resume point
+        u32 elapsed_ms = 0;  // Since the transfer (or the resume) started
+        u32 transferred = 0; // Bytes moved since then
+
+        u32 bytes_per_second() const noexcept {
+            return elapsed_ms > 0 ? static_cast<u32>(static_cast<u64>(transferred) * 1000 / elapsed_ms) : 0;
+        }
+        f32 fraction() const noexcept { return length > 0 ? static_cast<f32>(done) / static_cast<f32>(length) : 1.0f; }
+    };
+
+    // ─── Streaming DM14/DM15/DM16 read and write ────────────────────────────────
+    // Drives the DM14 -> DM15 -> DM16 (-> DM15 Completed) cycle block by
+    // block over a whole memory range. Up to `window` blocks are requested at
+    // once, so the handshake for the next block overlaps the DM16 transfer of
+    // the current one; DM16 payloads larger than a frame go out over TP/ETP
+    // through IsoNet. Read data is handed to on_data in address order and is
+    // not kept. A timed-out step re-requests its block; after max_retries, a
+    // DM15 Error or abort(), resume() carries on from progress().done.
+    class BulkMemoryTransfer {
+        enum class Step : u8 { Requested, Busy, Proceed, DataSent, Done };
+
+        struct Block {
+            u32 offset = 0;
+            u16 length = 0;
+            Step step = Step::Requested;
+            u32 timer_ms = 0;
+            u8 retries = 0;
+            dp::Vector<u8> data; // Read: received bytes, held until the blocks before it are done
+        };
+
+        MemoryAccessHandler &handler_;
+        BulkTransferConfig config_;
+        BulkState state_ = BulkState::Idle;
+        BulkProgress progress_;
+        dp::Vector<u8> image_;     // Write source
+        dp::Vector<Block> blocks_; // In flight, by offset
+        u32 next_offset_ = 0;
+        ListenerToken dm15_token_ = INVALID_TOKEN;
+        ListenerToken dm16_token_ = INVALID_TOKEN;
+
+      public:
+        explicit BulkMemoryTransfer(MemoryAccessHandler &handler, BulkTransferConfig config = {})
+            : handler_(handler), config_(config) {
+            dm15_token_ = handler_.on_dm15_response.subscribe(
+                [this](DM15Response resp, Address src) { handle_dm15(resp, src); });
+            dm16_token_ = handler_.on_dm16_transfer.subscribe(
+                [this](DM16Transfer transfer, Address src) { handle_dm16(std::move(transfer), src); });
+        }
+        BulkMemoryTransfer(const BulkMemoryTransfer &) = delete;
+        BulkMemoryTransfer &operator=(const BulkMemoryTransfer &) = delete;
+
+        ~BulkMemoryTransfer() {
+            handler_.on_dm15_response.unsubscribe(dm15_token_);
+            handler_.on_dm16_transfer.unsubscribe(dm16_token_);
+        }
+
+        // Read `length` bytes at `address`, starting `from` bytes in (a resume point saved earlier)
+        Result<void> read(Address ecu, u32 address, u32 length, u32 from = 0) {
+            image_.clear();
+            return start(BulkOp::Read, ecu, address, length, from);
+        }
+
+        // Write `data` at `address`, starting `from` bytes in
+        Result<void> write(Address ecu, u32 address, dp::Vector<u8> data, u32 from = 0) {
+            u32 length = static_cast<u32>(data.size());
+            image_ = std::move(data);
+            return start(BulkOp::Write, ecu, address, length, from);
+        }
+
+        // Stop now; late DM15/DM16 for this transfer are ignored
+        void abort() {
+            if (state_ != BulkState::Running)
+                return;
+            blocks_.clear();
+            state_ = BulkState::Aborted;
+            echo::category("isobus.protocol.dm_memory").info("bulk transfer aborted at ", progress_.done);
+        }
+
+        // Continue a failed or aborted transfer from the last confirmed byte
+        Result<void> resume() {
+            if (state_ != BulkState::Failed && state_ != BulkState::Aborted)
+                return Result<void>::err(Error::invalid_state("nothing to resume"));
+            return start(progress_.op, progress_.ecu, progress_.address, progress_.length, progress_.done);
+        }
+
+        void update(u32 elapsed_ms) {
+            if (state_ != BulkState::Running)
+                return;
+            progress_.elapsed_ms += elapsed_ms;
+            for (auto &block : blocks_) {
+                if (block.step == Step::Done)
+                    continue;
+                if (block.timer_ms > elapsed_ms) {
+                    block.timer_ms -= elapsed_ms;
+                    continue;
+                }
+                if (block.step == Step::Busy) {
+                    request(block);
+                } else if (block.step == Step::Proceed && progress_.op == BulkOp::Write) {
+                    block.timer_ms = config_.response_timeout_ms; // Waiting its turn for DM16, not on the ECU
+                } else if (block.retries < config_.max_retries) {
+                    ++block.retries;
+                    echo::category("isobus.protocol.dm_memory").warn("block timeout, retrying at ", block.offset);
+                    request(block);
+                } else {
+                    fail("block timed out");
+                    return;
+                }
+                if (state_ != BulkState::Running)
+                    return;
+            }
+            pump_write();
+        }
+
+        BulkState state() const noexcept { return state_; }
+        const BulkProgress &progress() const noexcept { return progress_; }
+        const BulkTransferConfig &config() const noexcept { return config_; }
+        void configure(BulkTransferConfig config) { config_ = config; }
+
+        // ─── Events ──────────────────────────────────────────────────────────────
+        Event<u32, DataSpan> on_data;                       // Read: (offset from start, bytes), in order
+        Event<const BulkProgress &> on_progress;            // After every confirmed block
+        Event<BulkState, const BulkProgress &> on_finished; // Completed or Failed
+
+      private:
+        Result<void> start(BulkOp op, Address ecu, u32 address, u32 length, u32 from) {
+            if (state_ == BulkState::Running)
+                return Result<void>::err(Error::invalid_state("transfer in progress"));
+            if (config_.block_size == 0 || config_.window == 0)
+                return Result<void>::err(Error::invalid_state("block size and window must be non-zero"));
+            if (from > length || address + length > 0x1000000)
+                return Result<void>::err(Error::invalid_state("range outside 24-bit address space"));
+            progress_ = {};
+            progress_.op = op;
+            progress_.ecu = ecu;
+            progress_.address = address;
+            progress_.length = length;
+            progress_.done = from;
+            next_offset_ = from;
+            blocks_.clear();
+            state_ = BulkState::Running;
+            echo::category("isobus.protocol.dm_memory")
+                .info(op == BulkOp::Read ? "bulk read " : "bulk write ", length - from, " bytes from ecu ", ecu);
+            fill();
+            finish_if_done();
+            return {};
+        }
+
+        void fill() {
+            while (state_ == BulkState::Running && blocks_.size() < config_.window &&
+                   next_offset_ < progress_.length) {
+                Block block;
+                block.offset = next_offset_;
+                block.length = static_cast<u16>(std::min<u32>(config_.block_size, progress_.length - next_offset_));
+                next_offset_ += block.length;
+                blocks_.push_back(std::move(block));
+                request(blocks_.back());
+            }
+        }
+
+        void request(Block &block) {
+            DM14Request req;
+            req.command = progress_.op == BulkOp::Read ? DM14Command::Read : DM14Command::Write;
+            req.pointer_type = config_.pointer_type;
+            req.address = progress_.address + block.offset;
+            req.length = block.length;
+            req.key = config_.key;
+            block.step = Step::Requested;
+            block.timer_ms = config_.response_timeout_ms;
+            block.data.clear();
+            if (auto result = handler_.send_request(req, progress_.ecu); result.is_err())
+                fail("DM14 not sent");
+        }
+
+        bool writing() const {
+            for (const auto &block : blocks_)
+                if (block.step == Step::DataSent)
+                    return true;
+            return false;
+        }
+
+        // One DM16 at a time: the next block's data goes out once the last was confirmed
+        void pump_write() {
+            if (state_ != BulkState::Running || progress_.op != BulkOp::Write || writing())
+                return;
+            for (auto &block : blocks_) {
+                if (block.step != Step::Proceed)
+                    continue;
+                auto transfer = DM16Transfer::of(DataSpan(image_.data() + block.offset, block.length));
+                auto result = handler_.send_data(transfer, progress_.ecu);
+                if (result.is_ok()) {
+                    block.step = Step::DataSent;
+                    block.timer_ms = config_.response_timeout_ms;
+                } else if (result.error().code != ErrorCode::SessionExists) {
+                    fail("DM16 not sent");
+                }
+                return; // Busy transport session: try again on the next update
+            }
+        }
+
+        Block *oldest(Step step) {
+            for (auto &block : blocks_)
+                if (block.step == step)
+                    return &block;
+            return nullptr;
+        }
+
+        // The block a DM15 answers: the one at the echoed address, else the oldest in `step`
+        Block *match(u32 address, Step step) {
+            for (auto &block : blocks_)
+                if (block.step == step && progress_.address + block.offset == address)
+                    return &block;
+            return oldest(step);
+        }
+
+        void handle_dm15(const DM15Response &resp, Address src) {
+            if (state_ != BulkState::Running || src != progress_.ecu)
+                return;
+            switch (resp.status) {
+            case DM15Status::Proceed:
+                if (Block *block = match(resp.address, Step::Requested)) {
+                    block->step = Step::Proceed;
+                    block->timer_ms = config_.response_timeout_ms;
+                    pump_write();
+                }
+                break;
+            case DM15Status::Busy:
+                if (Block *block = match(resp.address, Step::Requested)) {
+                    block->step = Step::Busy;
+                    block->timer_ms = config_.busy_retry_ms;
+                }
+                break;
+            case DM15Status::Completed:
+                if (progress_.op == BulkOp::Write) {
+                    if (Block *block = match(resp.address, Step::DataSent)) {
+                        block->step = Step::Done;
+                        progress_.transferred += block->length;
+                        advance();
+                        pump_write();
+                    }
+                }
+                break;
+            case DM15Status::Error:
+            case DM15Status::EdcpFault:
+                fail("ECU refused memory access");
+                break;
+            default:
+                break;
+            }
+        }
+
+        // Read data arrives in the order the ECU accepted the requests
+        void handle_dm16(DM16Transfer transfer, Address src) {
+            if (state_ != BulkState::Running || src != progress_.ecu || progress_.op != BulkOp::Read)
+                return;
+            Block *block = oldest(Step::Proceed);
+            if (!block)
+                return;
+            if (transfer.data.size() < block->length) {
+                fail("short DM16 block");
+                return;
+            }
+            transfer.data.resize(block->length);
+            block->data = std::move(transfer.data);
+            block->step = Step::Done;
+            progress_.transferred += block->length;
+            advance();
+        }
+
+        // Release finished blocks from the front, then keep the window full
+        void advance() {
+            usize finished = 0;
+            while (finished < blocks_.size() && blocks_[finished].step == Step::Done) {
+                const Block &block = blocks_[finished];
+                progress_.done = block.offset + block.length;
+                ++finished;
+                if (progress_.op == BulkOp::Read) {
+                    on_data.emit(block.offset, DataSpan(block.data));
+                    if (state_ != BulkState::Running)
+                        return; // Aborted from the listener
+                }
+            }
+            if (finished == 0)
+                return;
+            blocks_.erase(blocks_.begin(), blocks_.begin() + finished);
+            on_progress.emit(progress_);
+            fill();
+            finish_if_done();
+        }
+
+        void finish_if_done() {
+            if (state_ != BulkState::Running || progress_.done < progress_.length)
+                return;
+            state_ = BulkState::Completed;
+            echo::category("isobus.protocol.dm_memory")
+                .info("bulk transfer done: ", progress_.length, " bytes, ", progress_.bytes_per_second(), " B/s");
+            on_finished.emit(state_, progress_);
+        }
+
+        void fail(const char *why) {
+            blocks_.clear();
+            state_ = BulkState::Failed;
+            echo::category("isobus.protocol.dm_memory").error("bulk transfer failed at ", progress_.done, ": ", why);
+            on_finished.emit(state_, progress_);
+        }
+    };
 } // namespace agrobus::j1939
@@ -6,6 +6,7 @@
 #include <agrobus/net/internal_cf.hpp>
 #include <agrobus/net/message.hpp>
 #include <agrobus/net/network_manager.hpp>
+#include <agrobus/net/pgn_codec.hpp>
 #include <agrobus/net/types.hpp>
 #include <datapod/datapod.hpp>
 #include <echo/echo.hpp>
@@ -23,33 +24,17 @@ namespace agrobus::j1939 {
         u8 starter_mode = 0xFF;          // SPN 1675: 4 bits
         u8 source_address = 0xFF;        // SPN 899: source of engine speed
 
-        dp::Vector<u8> encode() const {
-            dp::Vector<u8> data(8, 0xFF);
-            data[0] = static_cast<u8>(engine_torque_percent + 125.0);
-            data[1] = static_cast<u8>(driver_demand_percent + 125.0);
-            data[2] = static_cast<u8>(actual_engine_percent + 125.0);
-            u16 rpm = static_cast<u16>(engine_speed_rpm / 0.125);
-            data[3] = static_cast<u8>(rpm & 0xFF);
-            data[4] = static_cast<u8>((rpm >> 8) & 0xFF);
-            data[5] = source_address;
-            data[6] = (starter_mode & 0x0F);
-            data[7] = 0xFF; // reserved
-            return data;
-        }
-
-        static EEC1 decode(const dp::Vector<u8> &data) {
-            EEC1 msg;
-            if (data.size() >= 8) {
-                msg.engine_torque_percent = static_cast<f64>(data[0]) - 125.0;
-                msg.driver_demand_percent = static_cast<f64>(data[1]) - 125.0;
-                msg.actual_engine_percent = static_cast<f64>(data[2]) - 125.0;
-                u16 rpm = static_cast<u16>(data[3]) | (static_cast<u16>(data[4]) << 8);
-                msg.engine_speed_rpm = rpm * 0.125;
-                msg.source_address = data[5];
-                msg.starter_mode = data[6] & 0x0F;
-            }
-            return msg;
-        }
+        using TorqueField = Field<&EEC1::engine_torque_percent, 0, 8, 1, 1, -125>;
+        using DemandField = Field<&EEC1::driver_demand_percent, 8, 8, 1, 1, -125>;
+        using ActualField = Field<&EEC1::actual_engine_percent, 16, 8, 1, 1, -125>;
+        using SpeedField = Field<&EEC1::engine_speed_rpm, 24, 16, 1, 8>;
+        using SourceField = Field<&EEC1::source_address, 40, 8>;
+        using StarterField = Field<&EEC1::starter_mode, 48, 4>;
+        using Codec =
+            PgnCodec<EEC1, TorqueField, DemandField, ActualField, SpeedField, SourceField, StarterField>;
+
+        dp::Vector<u8> encode() const { return Codec::encode(*this); }
+        static EEC1 decode(DataSpan data) { return Codec::decode(data); }
     };
 
     // ─── Electronic Engine Controller 2 (EEC2, PGN 0x0F003) ─────────────────────
@@ -69,7 +54,7 @@ namespace agrobus::j1939 {
             return data;
         }
 
-        static EEC2 decode(const dp::Vector<u8> &data) {
+        static EEC2 decode(DataSpan data) {
             EEC2 msg;
             if (data.size() >= 4) {
                 msg.accel_pedal_low_idle = data[0] & 0x03;
@@ -104,7 +89,7 @@ namespace agrobus::j1939 {
             return data;
         }
 
-        static EngineTemp1 decode(const dp::Vector<u8> &data) {
+        static EngineTemp1 decode(DataSpan data) {
             EngineTemp1 msg;
             if (data.size() >= 7) {
                 msg.coolant_temp_c = static_cast<f64>(data[0]) - 40.0;
@@ -141,7 +126,7 @@ namespace agrobus::j1939 {
             return data;
         }
 
-        static EngineFluidLP decode(const dp::Vector<u8> &data) {
+        static EngineFluidLP decode(DataSpan data) {
             EngineFluidLP msg;
             if (data.size() >= 7) {
                 msg.fuel_delivery_pressure_kpa = static_cast<f64>(data[0]) * 4.0;
@@ -176,7 +161,7 @@ namespace agrobus::j1939 {
             return data;
         }
 
-        static EngineHours decode(const dp::Vector<u8> &data) {
+        static EngineHours decode(DataSpan data) {
             EngineHours msg;
             if (data.size() >= 8) {
                 u32 hrs = static_cast<u32>(data[0]) | (static_cast<u32>(data[1]) << 8) |
@@ -208,7 +193,7 @@ namespace agrobus::j1939 {
             return data;
         }
 
-        static FuelEconomy decode(const dp::Vector<u8> &data) {
+        static FuelEconomy decode(DataSpan data) {
             FuelEconomy msg;
             if (data.size() >= 5) {
                 u16 rate = static_cast<u16>(data[0]) | (static_cast<u16>(data[1]) << 8);
@@ -237,7 +222,7 @@ namespace agrobus::j1939 {
             return data;
         }
 
-        static EEC3 decode(const dp::Vector<u8> &data) {
+        static EEC3 decode(DataSpan data) {
             EEC3 msg;
             if (data.size() >= 4) {
                 msg.nominal_friction_percent = static_cast<f64>(data[0]) - 125.0;
@@ -268,7 +253,7 @@ namespace agrobus::j1939 {
             return data;
         }
 
-        static TSC1 decode(const dp::Vector<u8> &data) {
+        static TSC1 decode(DataSpan data) {
             TSC1 msg;
             if (data.size() >= 4) {
                 msg.override_mode = static_cast<OverrideControlMode>(data[0] & 0x03);
@@ -302,7 +287,7 @@ namespace agrobus::j1939 {
             return data;
         }
 
-        static VEP1 decode(const dp::Vector<u8> &data) {
+        static VEP1 decode(DataSpan data) {
             VEP1 msg;
             if (data.size() >= 7) {
                 u16 bat = static_cast<u16>(data[0]) | (static_cast<u16>(data[1]) << 8);
@@ -337,7 +322,7 @@ namespace agrobus::j1939 {
             return data;
         }
 
-        static AmbientConditions decode(const dp::Vector<u8> &data) {
+        static AmbientConditions decode(DataSpan data) {
             AmbientConditions msg;
             if (data.size() >= 6) {
                 msg.barometric_pressure_kpa = static_cast<f64>(data[0]) * 0.5;
@@ -371,7 +356,7 @@ namespace agrobus::j1939 {
             return data;
         }
 
-        static DashDisplay decode(const dp::Vector<u8> &data) {
+        static DashDisplay decode(DataSpan data) {
             DashDisplay msg;
             if (data.size() >= 6) {
                 msg.washer_fluid_level = data[0];
@@ -405,7 +390,7 @@ namespace agrobus::j1939 {
             return data;
         }
 
-        static VehiclePosition decode(const dp::Vector<u8> &data) {
+        static VehiclePosition decode(DataSpan data) {
             VehiclePosition msg;
             if (data.size() >= 8) {
                 u32 lat = static_cast<u32>(data[0]) | (static_cast<u32>(data[1]) << 8) |
@@ -439,7 +424,7 @@ namespace agrobus::j1939 {
             return data;
         }
 
-        static FuelConsumption decode(const dp::Vector<u8> &data) {
+        static FuelConsumption decode(DataSpan data) {
             FuelConsumption msg;
             if (data.size() >= 8) {
                 u32 trip = static_cast<u32>(data[0]) | (static_cast<u32>(data[1]) << 8) |
@@ -453,6 +438,193 @@ namespace agrobus::j1939 {
         }
     };
 
+    // ─── Lazy views ──────────────────────────────────────────────────────────────
+    // Read a received frame in place and compute an SPN only when it is asked
+    // for, for consumers that want two or three parameters of a fast PGN.
+    // Each accessor gives what decode() would put in the matching field once
+    // valid() holds; decode() builds the full struct from the same frame.
+    // The view does not own the bytes.
+
+    struct EEC1View {
+        DataSpan data;
+
+        explicit EEC1View(DataSpan d) : data(d) {}
+        bool valid() const noexcept { return data.size() >= EEC1::Codec::MIN_BYTES; }
+
+        f64 engine_torque_percent() const noexcept { return EEC1::Codec::get<EEC1::TorqueField>(data); }
+        f64 driver_demand_percent() const noexcept { return EEC1::Codec::get<EEC1::DemandField>(data); }
+        f64 actual_engine_percent() const noexcept { return EEC1::Codec::get<EEC1::ActualField>(data); }
+        f64 engine_speed_rpm() const noexcept { return EEC1::Codec::get<EEC1::SpeedField>(data); }
+        u8 source_address() const noexcept { return EEC1::Codec::get<EEC1::SourceField>(data); }
+        u8 starter_mode() const noexcept { return EEC1::Codec::get<EEC1::StarterField>(data); }
+
+        EEC1 decode() const { return EEC1::decode(data); }
+    };
+
+    struct EEC2View {
+        DataSpan data;
+
+        explicit EEC2View(DataSpan d) : data(d) {}
+        bool valid() const noexcept { return data.size() >= 4; }
+
+        u8 accel_pedal_position() const noexcept { return data[1]; }
+        f64 engine_load_percent() const noexcept { return static_cast<f64>(data[2]); }
+        u8 accel_pedal_low_idle() const noexcept { return data[0] & 0x03; }
+        u8 accel_pedal_kickdown() const noexcept { return (data[0] >> 2) & 0x03; }
+        u8 road_speed_limit() const noexcept { return data[3]; }
+
+        EEC2 decode() const { return EEC2::decode(data); }
+    };
+
+    struct EngineTemp1View {
+        DataSpan data;
+
+        explicit EngineTemp1View(DataSpan d) : data(d) {}
+        bool valid() const noexcept { return data.size() >= 7; }
+
+        f64 coolant_temp_c() const noexcept { return static_cast<f64>(data[0]) - 40.0; }
+        f64 fuel_temp_c() const noexcept { return static_cast<f64>(data[1]) - 40.0; }
+        f64 oil_temp_c() const noexcept { return data.get_u16_le(2) * 0.03125 - 273.0; }
+        f64 turbo_oil_temp_c() const noexcept { return data.get_u16_le(4) * 0.03125 - 273.0; }
+        f64 intercooler_temp_c() const noexcept { return static_cast<f64>(data[6]) - 40.0; }
+
+        EngineTemp1 decode() const { return EngineTemp1::decode(data); }
+    };
+
+    struct EngineFluidLPView {
+        DataSpan data;
+
+        explicit EngineFluidLPView(DataSpan d) : data(d) {}
+        bool valid() const noexcept { return data.size() >= 7; }
+
+        f64 fuel_delivery_pressure_kpa() const noexcept { return static_cast<f64>(data[0]) * 4.0; }
+        f64 oil_pressure_kpa() const noexcept { return static_cast<f64>(data[1]) * 4.0; }
+        f64 coolant_pressure_kpa() const noexcept { return static_cast<f64>(data[2]) * 2.0; }
+        u8 oil_level_percent() const noexcept { return data[3]; }
+        u8 coolant_level_percent() const noexcept { return data[4]; }
+        f64 crankcase_pressure_kpa() const noexcept { return data.get_u16_le(5) * 0.05 - 250.0; }
+
+        EngineFluidLP decode() const { return EngineFluidLP::decode(data); }
+    };
+
+    struct EngineHoursView {
+        DataSpan data;
+
+        explicit EngineHoursView(DataSpan d) : data(d) {}
+        bool valid() const noexcept { return data.size() >= 8; }
+
+        f64 total_hours() const noexcept { return data.get_u32_le(0) * 0.05; }
+        f64 total_revolutions() const noexcept { return data.get_u32_le(4) * 1000.0; }
+
+        EngineHours decode() const { return EngineHours::decode(data); }
+    };
+
+    struct FuelEconomyView {
+        DataSpan data;
+
+        explicit FuelEconomyView(DataSpan d) : data(d) {}
+        bool valid() const noexcept { return data.size() >= 5; }
+
+        f64 fuel_rate_lph() const noexcept { return data.get_u16_le(0) * 0.05; }
+        f64 instantaneous_lph() const noexcept { return data.get_u16_le(2) / 512.0; }
+        f64 throttle_position() const noexcept { return static_cast<f64>(data[4]) * 0.4; }
+
+        FuelEconomy decode() const { return FuelEconomy::decode(data); }
+    };
+
+    struct EEC3View {
+        DataSpan data;
+
+        explicit EEC3View(DataSpan d) : data(d) {}
+        bool valid() const noexcept { return data.size() >= 4; }
+
+        f64 nominal_friction_percent() const noexcept { return static_cast<f64>(data[0]) - 125.0; }
+        f64 desired_operating_speed_rpm() const noexcept { return data.get_u16_le(1) * 0.125; }
+        u8 operating_speed_asymmetry() const noexcept { return data[3]; }
+
+        EEC3 decode() const { return EEC3::decode(data); }
+    };
+
+    struct TSC1View {
+        DataSpan data;
+
+        explicit TSC1View(DataSpan d) : data(d) {}
+        bool valid() const noexcept { return data.size() >= 4; }
+
+        OverrideControlMode override_mode() const noexcept { return static_cast<OverrideControlMode>(data[0] & 0x03); }
+        f64 requested_speed_rpm() const noexcept { return data.get_u16_le(1) * 0.125; }
+        f64 requested_torque_percent() const noexcept { return static_cast<f64>(data[3]) - 125.0; }
+
+        TSC1 decode() const { return TSC1::decode(data); }
+    };
+
+    struct VEP1View {
+        DataSpan data;
+
+        explicit VEP1View(DataSpan d) : data(d) {}
+        bool valid() const noexcept { return data.size() >= 7; }
+
+        f64 battery_voltage_v() const noexcept { return data.get_u16_le(0) * 0.05; }
+        f64 charging_system_voltage_v() const noexcept { return data.get_u16_le(2) * 0.05; }
+        f64 key_switch_voltage_v() const noexcept { return data.get_u16_le(4) * 0.05; }
+        f64 alternator_current_a() const noexcept { return static_cast<f64>(data[6]) - 125.0; }
+
+        VEP1 decode() const { return VEP1::decode(data); }
+    };
+
+    struct AmbientConditionsView {
+        DataSpan data;
+
+        explicit AmbientConditionsView(DataSpan d) : data(d) {}
+        bool valid() const noexcept { return data.size() >= 6; }
+
+        f64 barometric_pressure_kpa() const noexcept { return static_cast<f64>(data[0]) * 0.5; }
+        f64 ambient_air_temp_c() const noexcept { return data.get_u16_le(1) * 0.03125 - 273.0; }
+        f64 intake_air_temp_c() const noexcept { return static_cast<f64>(data[3]) - 40.0; }
+        f64 road_surface_temp_c() const noexcept { return data.get_u16_le(4) * 0.03125 - 273.0; }
+
+        AmbientConditions decode() const { return AmbientConditions::decode(data); }
+    };
+
+    struct DashDisplayView {
+        DataSpan data;
+
+        explicit DashDisplayView(DataSpan d) : data(d) {}
+        bool valid() const noexcept { return data.size() >= 6; }
+
+        u8 washer_fluid_level() const noexcept { return data[0]; }
+        u8 fuel_level_percent() const noexcept { return data[1]; }
+        f64 fuel_filter_diff_kpa() const noexcept { return static_cast<f64>(data[2]) * 2.0; }
+        f64 oil_filter_diff_kpa() const noexcept { return static_cast<f64>(data[3]) * 0.5; }
+        f64 cargo_ambient_temp_c() const noexcept { return data.get_u16_le(4) * 0.03125 - 273.0; }
+
+        DashDisplay decode() const { return DashDisplay::decode(data); }
+    };
+
+    struct VehiclePositionView {
+        DataSpan data;
+
+        explicit VehiclePositionView(DataSpan d) : data(d) {}
+        bool valid() const noexcept { return data.size() >= 8; }
+
+        f64 latitude_deg() const noexcept { return data.get_u32_le(0) * 1e-7 - 210.0; }
+        f64 longitude_deg() const noexcept { return data.get_u32_le(4) * 1e-7 - 210.0; }
+
+        VehiclePosition decode() const { return VehiclePosition::decode(data); }
+    };
+
+    struct FuelConsumptionView {
+        DataSpan data;
+
+        explicit FuelConsumptionView(DataSpan d) : data(d) {}
+        bool valid() const noexcept { return data.size() >= 8; }
+
+        f64 trip_fuel_l() const noexcept { return data.get_u32_le(0) * 0.5; }
+        f64 total_fuel_l() const noexcept { return data.get_u32_le(4) * 0.5; }
+
+        FuelConsumption decode() const { return FuelConsumption::decode(data); }
+    };
+
     // ─── Component Identification (PGN 0x0FEEB) ──────────────────────────────────
     // Variable-length, asterisk-delimited string: Make*Model*SerialNumber*UnitNumber*
     struct ComponentIdentification {
@@ -478,7 +650,7 @@ namespace agrobus::j1939 {
             return data;
         }
 
-        static ComponentIdentification decode(const dp::Vector<u8> &data) {
+        static ComponentIdentification decode(DataSpan data) {
             ComponentIdentification id;
             usize field = 0;
             for (u8 b : data) {
@@ -521,7 +693,7 @@ namespace agrobus::j1939 {
             return data;
         }
 
-        static VehicleIdentification decode(const dp::Vector<u8> &data) {
+        static VehicleIdentification decode(DataSpan data) {
             VehicleIdentification id;
             for (u8 b : data) {
                 if (b == '*' || b == 0xFF)
@@ -264,26 +264,50 @@ namespace agrobus::j1939 {
     };
 
     // ─── ISO 11783-7 Heartbeat protocol ─────────────────────────────────────────
+    // Sending and peer timeouts are deadlines on the IsoNet timer wheel, so they
+    // advance with IsoNet::update() and cost nothing while idle; a missed peer
+    // is reported from the update() that crosses its deadline. Peers sit in a
+    // slot per source address, so tracking and each received heartbeat are
+    // O(1) however many peers are watched. One protocol serves the port of
+    // its control function; a supervisor on two buses runs one per port.
+    // Neither copyable nor movable: its timers and PGN callback hold `this`,
+    // so keep it where it was constructed (a member, or a unique_ptr).
     class HeartbeatProtocol {
         IsoNet &net_;
         InternalCF *cf_;
         u32 interval_ms_;
-        u32 timer_ms_ = 0;
+        TimerId send_timer_ = INVALID_TIMER;
         HeartbeatSender sender_; // ISO-compliant sequence generator (init=251, then 0-250 rollover)
         bool enabled_ = false;
 
-        // Remote heartbeat tracking
+        // Remote heartbeat tracking, indexed by source address
         struct RemoteHeartbeat {
-            Address address = NULL_ADDRESS;
+            bool tracked = false;
             u8 last_sequence = 0;
             u32 missed_count = 0;
-            u32 timer_ms = 0;
+            TimerId timer = INVALID_TIMER; // Fires after 3 intervals without a heartbeat
         };
-        dp::Vector<RemoteHeartbeat> remotes_;
+        dp::Array<RemoteHeartbeat, 256> remotes_{};
+        usize tracked_count_ = 0;
 
       public:
         HeartbeatProtocol(IsoNet &net, InternalCF *cf, HeartbeatConfig config = {})
-            : net_(net), cf_(cf), interval_ms_(config.interval_ms), enabled_(config.auto_enable) {}
+            : net_(net), cf_(cf), interval_ms_(config.interval_ms), enabled_(config.auto_enable) {
+            if (enabled_)
+                arm_send();
+        }
+
+        HeartbeatProtocol(const HeartbeatProtocol &) = delete;
+        HeartbeatProtocol &operator=(const HeartbeatProtocol &) = delete;
+        HeartbeatProtocol(HeartbeatProtocol &&) = delete;
+        HeartbeatProtocol &operator=(HeartbeatProtocol &&) = delete;
+
+        ~HeartbeatProtocol() {
+            net_.timers().cancel(send_timer_);
+            for (auto &remote : remotes_)
+                if (remote.tracked)
+                    net_.timers().cancel(remote.timer);
+        }
 
         Result<void> initialize() {
             if (!cf_) {
@@ -294,8 +318,17 @@ namespace agrobus::j1939 {
             return {};
         }
 
-        void enable() noexcept { enabled_ = true; }
-        void disable() noexcept { enabled_ = false; }
+        void enable() {
+            if (!enabled_) {
+                enabled_ = true;
+                arm_send();
+            }
+        }
+        void disable() {
+            enabled_ = false;
+            net_.timers().cancel(send_timer_);
+            send_timer_ = INVALID_TIMER;
+        }
         bool is_enabled() const noexcept { return enabled_; }
 
         // Signal sender error (sequence=254) on next heartbeat
@@ -307,59 +340,79 @@ namespace agrobus::j1939 {
         // Reset sender to initial state (will send 251 on next heartbeat)
         void reset_sender() { sender_.reset(); }
 
-        void set_interval(u32 ms) noexcept { interval_ms_ = ms; }
+        void set_interval(u32 ms) {
+            interval_ms_ = ms;
+            if (enabled_)
+                net_.timers().set_period(send_timer_, interval_ms_, anchor_phase());
+        }
         u32 interval() const noexcept { return interval_ms_; }
 
-        void update(u32 elapsed_ms) {
-            if (enabled_) {
-                timer_ms_ += elapsed_ms;
-                if (timer_ms_ >= interval_ms_) {
-                    timer_ms_ -= interval_ms_;
-                    send_heartbeat();
-                }
-            }
-
-            // Check remote heartbeats
-            for (auto &remote : remotes_) {
-                remote.timer_ms += elapsed_ms;
-                if (remote.timer_ms >= interval_ms_ * 3) {
-                    // Missed heartbeat
-                    remote.missed_count++;
-                    remote.timer_ms = 0;
-                    on_heartbeat_missed.emit(remote.address, remote.missed_count);
-                    echo::category("isobus.heartbeat")
-                        .warn("peer timeout: addr=", remote.address, " count=", remote.missed_count);
-                }
-            }
-        }
+        // Does nothing: sending and peer timeouts run from IsoNet::update(), so
+        // a loop that only calls this sends no heartbeats
+        [[deprecated("heartbeat timers run from IsoNet::update(); drop this call")]] void update(u32) {}
 
         // Track a remote device's heartbeat
         Result<void> track(Address address) {
-            for (const auto &r : remotes_) {
-                if (r.address == address)
-                    return {};
-            }
-            remotes_.push_back({address, 0, 0, 0});
+            RemoteHeartbeat &remote = remotes_[address];
+            if (remote.tracked)
+                return {};
+            remote = RemoteHeartbeat{};
+            remote.tracked = true;
+            ++tracked_count_;
+            arm_peer(address);
             echo::category("isobus.heartbeat").debug("tracking peer: addr=", address);
             return {};
         }
 
         Result<void> untrack(Address address) {
-            for (auto it = remotes_.begin(); it != remotes_.end(); ++it) {
-                if (it->address == address) {
-                    remotes_.erase(it);
-                    echo::category("isobus.heartbeat").debug("untracking peer: addr=", address);
-                    return {};
-                }
-            }
-            return Result<void>::err(Error::invalid_state("address not tracked"));
+            RemoteHeartbeat &remote = remotes_[address];
+            if (!remote.tracked)
+                return Result<void>::err(Error::invalid_state("address not tracked"));
+            net_.timers().cancel(remote.timer);
+            remote = RemoteHeartbeat{};
+            --tracked_count_;
+            echo::category("isobus.heartbeat").debug("untracking peer: addr=", address);
+            return {};
         }
 
+        bool is_tracked(Address address) const noexcept { return remotes_[address].tracked; }
+        usize tracked_count() const noexcept { return tracked_count_; }
+
+        // Timeouts since the peer's last heartbeat (0 while it keeps up)
+        u32 missed_count(Address address) const noexcept { return remotes_[address].missed_count; }
+
         // Events
         Event<Address, u8> on_heartbeat_received; // (source, sequence)
         Event<Address, u32> on_heartbeat_missed;  // (source, missed_count)
 
       private:
+        // Periodic wheel timer anchored at enable(): beats stay interval_ms apart
+        // on the network clock however coarse update() is
+        void arm_send() {
+            net_.timers().cancel(send_timer_);
+            send_timer_ = net_.timers().schedule_every(interval_ms_, anchor_phase(), [this]() { send_heartbeat(); });
+        }
+
+        u32 anchor_phase() const noexcept {
+            return interval_ms_ == 0 ? 0 : static_cast<u32>(net_.timers().now_ms() % interval_ms_);
+        }
+
+        void arm_peer(Address address) {
+            RemoteHeartbeat &remote = remotes_[address];
+            net_.timers().cancel(remote.timer);
+            remote.timer = net_.timers().schedule(interval_ms_ * 3, [this, address]() { peer_missed(address); });
+        }
+
+        void peer_missed(Address address) {
+            RemoteHeartbeat &remote = remotes_[address];
+            if (!remote.tracked)
+                return;
+            remote.missed_count++;
+            arm_peer(address);
+            on_heartbeat_missed.emit(address, remote.missed_count);
+            echo::category("isobus.heartbeat").warn("peer timeout: addr=", address, " count=", remote.missed_count);
+        }
+
         void send_heartbeat() {
             dp::Vector<u8> data(8, 0xFF);
             data[0] = sender_.next_sequence();
@@ -368,16 +421,16 @@ namespace agrobus::j1939 {
         }
 
         void handle_heartbeat(const Message &msg) {
+            if (msg.data.empty())
+                return;
             u8 seq = msg.data[0];
             on_heartbeat_received.emit(msg.source, seq);
 
-            for (auto &remote : remotes_) {
-                if (remote.address == msg.source) {
-                    remote.last_sequence = seq;
-                    remote.missed_count = 0;
-                    remote.timer_ms = 0;
-                    return;
-                }
+            RemoteHeartbeat &remote = remotes_[msg.source];
+            if (remote.tracked) {
+                remote.last_sequence = seq;
+                remote.missed_count = 0;
+                net_.timers().reschedule(remote.timer, interval_ms_ * 3);
             }
         }
     };
@@ -31,7 +31,7 @@ namespace agrobus::j1939 {
             return data;
         }
 
-        static MaintainPowerData decode(const dp::Vector<u8> &data) {
+        static MaintainPowerData decode(DataSpan data) {
             MaintainPowerData mpd;
             if (data.size() >= 2) {
                 mpd.key_switch = static_cast<KeySwitchState>(data[0] & 0x03);
@@ -148,16 +148,21 @@ namespace agrobus::j1939 {
         }
 
         // ─── Update (call periodically with elapsed time) ───────────────────────
+        // Maintain-power messages go out through the network directly, so the
+        // sink overload appends nothing; it keeps the call shape of the other
+        // per-tick managers for callers that pass one vector to all of them.
         dp::Vector<Frame> update(u32 elapsed_ms) {
             dp::Vector<Frame> frames;
+            update(elapsed_ms, frames);
+            return frames;
+        }
 
+        void update(u32 elapsed_ms, dp::Vector<Frame> &) {
             if (is_tecu_) {
                 update_tecu(elapsed_ms);
             } else {
                 update_cf(elapsed_ms);
             }
-
-            return frames;
         }
 
         // Events
@@ -1,7 +1,9 @@
 #pragma once
 
 #include "acknowledgment.hpp"
+#include "response_coalescer.hpp"
 #include <agrobus/net/constants.hpp>
+#include <agrobus/net/coro.hpp>
 #include <agrobus/net/error.hpp>
 #include <agrobus/net/event.hpp>
 #include <agrobus/net/frame.hpp>
@@ -11,6 +13,7 @@
 #include <datapod/datapod.hpp>
 #include <echo/echo.hpp>
 #include <functional>
+#include <memory>
 
 namespace agrobus::j1939 {
     using namespace agrobus::net;
@@ -18,6 +21,24 @@ namespace agrobus::j1939 {
     // AckType is a compatibility alias for AckControl
     using AckType = AckControl;
 
+    // ─── Cached response invalidation ───────────────────────────────────────────
+    // Handed out by register_cached_responder(). The owner of the data calls
+    // invalidate() when it changes; the next request encodes it again. Copies
+    // share the same state, so it can be kept wherever the data is set.
+    class ResponseCacheToken {
+        std::shared_ptr<u32> revision_;
+
+      public:
+        ResponseCacheToken() = default;
+        explicit ResponseCacheToken(std::shared_ptr<u32> revision) : revision_(std::move(revision)) {}
+
+        void invalidate() noexcept {
+            if (revision_)
+                ++*revision_;
+        }
+        bool valid() const noexcept { return revision_ != nullptr; }
+    };
+
     // ─── PGN Request/Response protocol ──────────────────────────────────────────
     class PGNRequestProtocol {
         IsoNet &net_;
@@ -26,8 +47,22 @@ namespace agrobus::j1939 {
         // Registered PGN responders
         dp::Map<PGN, std::function<dp::Vector<u8>()>> responders_;
 
+        // Responders whose encoded answer is kept until their token is invalidated
+        struct CachedResponder {
+            std::function<dp::Vector<u8>()> encode;
+            std::shared_ptr<u32> revision;
+            u32 encoded_revision = 0;
+            SharedPayload payload; // Null until the first request
+        };
+        dp::Map<PGN, CachedResponder> cached_;
+        u32 cache_hits_ = 0;
+
+        // Broadcast answers to PDU2 requests, one per PGN per window
+        ResponseCoalescer coalescer_;
+
       public:
-        PGNRequestProtocol(IsoNet &net, InternalCF *cf) : net_(net), cf_(cf) {}
+        PGNRequestProtocol(IsoNet &net, InternalCF *cf, CoalesceConfig coalesce = {})
+            : net_(net), cf_(cf), coalescer_(net.timers(), coalesce) {}
 
         Result<void> initialize() {
             if (!cf_) {
@@ -44,11 +79,48 @@ namespace agrobus::j1939 {
             if (!responder) {
                 return Result<void>::err(Error::invalid_state("null responder"));
             }
+            cached_.erase(pgn);
             responders_[pgn] = std::move(responder);
             echo::category("isobus.protocol.pgn_req").debug("responder registered for pgn=", pgn);
             return {};
         }
 
+        // Register a responder whose answer only changes when the data behind
+        // it does (software ID, ECU ID, product ID): it is encoded on the first
+        // request and the same buffer is sent until the returned token is
+        // invalidated. TP/ETP answers reference the buffer instead of copying
+        // it, so a burst of requests costs one encode. Replaces a plain
+        // responder for the same PGN.
+        Result<ResponseCacheToken> register_cached_responder(PGN pgn, std::function<dp::Vector<u8>()> responder) {
+            if (!responder) {
+                return Result<ResponseCacheToken>::err(Error::invalid_state("null responder"));
+            }
+            responders_.erase(pgn);
+            CachedResponder entry;
+            entry.encode = std::move(responder);
+            entry.revision = std::make_shared<u32>(0);
+            ResponseCacheToken token(entry.revision);
+            cached_[pgn] = std::move(entry);
+            echo::category("isobus.protocol.pgn_req").debug("cached responder registered for pgn=", pgn);
+            return Result<ResponseCacheToken>::ok(std::move(token));
+        }
+
+        // Drop the cached answer for `pgn` (same as invalidating its token)
+        void invalidate(PGN pgn) {
+            auto it = cached_.find(pgn);
+            if (it != cached_.end())
+                it->second.payload.reset();
+        }
+
+        // Requests answered from a cached encoding
+        u32 cache_hits() const noexcept { return cache_hits_; }
+
+        // Coalesce broadcast answers to PDU2 requests: requests for the same
+        // PGN within the window get one answer, and answers of one PGN are at
+        // least min_interval apart. PDU1 answers go to each requester as before.
+        void set_coalescing(CoalesceConfig config) { coalescer_.configure(config); }
+        const ResponseCoalescer &coalescer() const noexcept { return coalescer_; }
+
         // Send a PGN request to a specific destination or broadcast
         Result<void> request(PGN pgn, Address destination = BROADCAST_ADDRESS) {
             dp::Vector<u8> data(3);
@@ -68,6 +140,12 @@ namespace agrobus::j1939 {
             return net_.send(PGN_REQUEST, data, cf_, &dest_cf, Priority::Default);
         }
 
+        // Coroutine form of request(): co_await yields the response, or a
+        // timeout / Error::invalid_pgn when the destination NACKs it
+        Task<Result<Message>> fetch(PGN pgn, Address destination = BROADCAST_ADDRESS, u32 timeout_ms = 1250) {
+            return net_.request(pgn, cf_, destination, timeout_ms);
+        }
+
         // Send an acknowledgment (positive or negative)
         Result<void> send_ack(AckType type, PGN pgn, Address destination) {
             dp::Vector<u8> data(8, 0xFF);
@@ -99,27 +177,62 @@ namespace agrobus::j1939 {
                 .debug("PGN request received: ", requested_pgn, " from ", msg.source);
             on_request_received.emit(requested_pgn, msg.source);
 
-            auto it = responders_.find(requested_pgn);
-            if (it != responders_.end()) {
-                auto response_data = it->second();
-                if (!response_data.empty()) {
-                    // Response goes back to requester if PDU1, or broadcast if PDU2
-                    u8 pf = (requested_pgn >> 8) & 0xFF;
-                    if (pf < 240 && msg.source != BROADCAST_ADDRESS) {
-                        ControlFunction dest_cf;
-                        dest_cf.address = msg.source;
-                        net_.send(requested_pgn, response_data, cf_, &dest_cf, Priority::Default);
-                    } else {
-                        net_.send(requested_pgn, response_data, cf_, nullptr, Priority::Default);
-                    }
-                }
-            } else {
+            bool known = cached_.find(requested_pgn) != cached_.end() ||
+                         responders_.find(requested_pgn) != responders_.end();
+            if (!known) {
                 // Send NACK for unknown PGN (only if addressed to us specifically)
                 if (msg.destination != BROADCAST_ADDRESS) {
                     echo::category("isobus.protocol.pgn_req").debug("NACK: no responder for pgn=", requested_pgn);
                     send_ack(AckControl::NegativeAck, requested_pgn, msg.source);
                 }
+                return;
+            }
+
+            // Response goes back to requester if PDU1, or broadcast if PDU2
+            u8 pf = (requested_pgn >> 8) & 0xFF;
+            if (pf < 240 && msg.source != BROADCAST_ADDRESS) {
+                respond(requested_pgn, msg.source);
+            } else if (coalescer_.enabled()) {
+                coalescer_.submit(requested_pgn,
+                                  [this, requested_pgn]() { respond(requested_pgn, BROADCAST_ADDRESS); });
+            } else {
+                respond(requested_pgn, BROADCAST_ADDRESS);
+            }
+        }
+
+        // Build (or reuse) the answer; the responder is looked up again since
+        // a coalesced answer goes out a while after its request
+        void respond(PGN pgn, Address destination) {
+            SharedPayload response;
+            auto cached = cached_.find(pgn);
+            if (cached != cached_.end()) {
+                response = cached_response(cached->second);
+            } else {
+                auto it = responders_.find(pgn);
+                if (it == responders_.end())
+                    return;
+                response = std::make_shared<const dp::Vector<u8>>(it->second());
+            }
+            if (response->empty())
+                return;
+
+            if (destination != BROADCAST_ADDRESS) {
+                ControlFunction dest_cf;
+                dest_cf.address = destination;
+                net_.send_shared(pgn, std::move(response), cf_, &dest_cf, Priority::Default);
+            } else {
+                net_.send_shared(pgn, std::move(response), cf_, nullptr, Priority::Default);
+            }
+        }
+
+        SharedPayload cached_response(CachedResponder &entry) {
+            if (entry.payload && entry.encoded_revision == *entry.revision) {
+                ++cache_hits_;
+                return entry.payload;
             }
+            entry.payload = std::make_shared<const dp::Vector<u8>>(entry.encode());
+            entry.encoded_revision = *entry.revision;
+            return entry.payload;
         }
 
         void handle_ack(const Message &msg) {
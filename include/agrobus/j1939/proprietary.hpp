@@ -1,5 +1,6 @@
 #pragma once
 
+#include <agrobus/net/delegate.hpp>
 #include <agrobus/net/error.hpp>
 #include <agrobus/net/event.hpp>
 #include <agrobus/net/internal_cf.hpp>
@@ -23,7 +24,7 @@ namespace agrobus::j1939 {
 
     struct ProprietaryMsg {
         PGN pgn = PGN_PROPRIETARY_A;
-        dp::Vector<u8> data;
+        Payload data;
         Address source = NULL_ADDRESS;
         Address destination = BROADCAST_ADDRESS;
 
@@ -35,9 +36,26 @@ namespace agrobus::j1939 {
 
     // ─── Proprietary Message Interface ──────────────────────────────────────────
     // Provides send/receive for manufacturer-proprietary messages.
+    //
+    // Proprietary B goes through one view callback per group extension in use
+    // and a 256-entry table indexed by the GE byte, so a frame reaches its
+    // handler with one array lookup after the PGN dispatch, without a copy.
+    // on_proprietary_b (owning ProprietaryMsg) is only built for GEs passed to
+    // register_proprietary_b and only while it has subscribers.
     class ProprietaryInterface {
+      public:
+        using ProprietaryBHandler = Delegate<void(const MessageView &)>;
+
+      private:
+        static constexpr u8 GE_ROUTED = 0x01; // View callback registered with IsoNet
+        static constexpr u8 GE_EVENT = 0x02;  // Emitted through on_proprietary_b
+
         IsoNet &net_;
         InternalCF *cf_;
+        dp::Array<ProprietaryBHandler, 256> b_handlers_{};
+        dp::Array<u8, 256> b_flags_{};
+        i32 running_ge_ = -1;                           // GE whose handler is being called
+        dp::Optional<ProprietaryBHandler> replacement_; // Set by that handler for its own GE
 
       public:
         ProprietaryInterface(IsoNet &net, InternalCF *cf) : net_(net), cf_(cf) {}
@@ -71,17 +89,29 @@ namespace agrobus::j1939 {
             return {};
         }
 
-        // Register a Proprietary B group extension PGN for reception
+        // Register a Proprietary B group extension PGN for reception (on_proprietary_b)
         Result<void> register_proprietary_b(u8 group_extension) {
-            PGN pgn = PGN_PROPRIETARY_B_BASE + group_extension;
-            return net_.register_pgn_callback(pgn, [this, pgn](const Message &msg) {
-                ProprietaryMsg pmsg;
-                pmsg.pgn = pgn;
-                pmsg.data = msg.data;
-                pmsg.source = msg.source;
-                pmsg.destination = msg.destination;
-                on_proprietary_b.emit(pmsg);
-            });
+            auto result = route(group_extension);
+            if (result.is_ok())
+                b_flags_[group_extension] |= GE_EVENT;
+            return result;
+        }
+
+        // Handler for one group extension, called with the message in place
+        // (valid for the duration of the call). Replaces an earlier handler
+        // for the same GE; a handler may set or clear handlers, its own included.
+        Result<void> set_proprietary_b_handler(u8 group_extension, ProprietaryBHandler handler) {
+            auto result = route(group_extension);
+            if (result.is_ok())
+                store(group_extension, std::move(handler));
+            return result;
+        }
+
+        // The GE stays registered with IsoNet; its frames are dropped here
+        void clear_proprietary_b_handler(u8 group_extension) { store(group_extension, nullptr); }
+
+        bool has_proprietary_b_handler(u8 group_extension) const noexcept {
+            return static_cast<bool>(b_handlers_[group_extension]);
         }
 
         // ─── Send methods ─────────────────────────────────────────────────────────
@@ -108,5 +138,45 @@ namespace agrobus::j1939 {
         Event<const ProprietaryMsg &> on_proprietary_a;
         Event<const ProprietaryMsg &> on_proprietary_a2;
         Event<const ProprietaryMsg &> on_proprietary_b;
+
+      private:
+        Result<void> route(u8 group_extension) {
+            if (b_flags_[group_extension] & GE_ROUTED)
+                return {};
+            auto result = net_.register_pgn_view_callback(PGN_PROPRIETARY_B_BASE + group_extension,
+                                                          [this](const MessageView &msg) { dispatch_b(msg); });
+            if (result.is_ok())
+                b_flags_[group_extension] |= GE_ROUTED;
+            return result;
+        }
+
+        // A handler replacing itself is swapped in once it returns
+        void store(u8 group_extension, ProprietaryBHandler handler) {
+            if (running_ge_ == group_extension)
+                replacement_ = std::move(handler);
+            else
+                b_handlers_[group_extension] = std::move(handler);
+        }
+
+        void dispatch_b(const MessageView &msg) {
+            u8 ge = static_cast<u8>(msg.pgn & 0xFF);
+            if (b_handlers_[ge]) {
+                running_ge_ = ge;
+                b_handlers_[ge](msg);
+                running_ge_ = -1;
+                if (replacement_) {
+                    b_handlers_[ge] = std::move(*replacement_);
+                    replacement_.reset();
+                }
+            }
+            if ((b_flags_[ge] & GE_EVENT) && on_proprietary_b.count() > 0) {
+                ProprietaryMsg pmsg;
+                pmsg.pgn = msg.pgn;
+                pmsg.data = msg.data;
+                pmsg.source = msg.source;
+                pmsg.destination = msg.destination;
+                on_proprietary_b.emit(pmsg);
+            }
+        }
     };
 } // namespace agrobus::j1939
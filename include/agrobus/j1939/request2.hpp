@@ -1,6 +1,8 @@
 #pragma once
 
+#include "response_coalescer.hpp"
 #include <agrobus/net/constants.hpp>
+#include <agrobus/net/coro.hpp>
 #include <agrobus/net/error.hpp>
 #include <agrobus/net/event.hpp>
 #include <agrobus/net/internal_cf.hpp>
@@ -34,7 +36,7 @@ namespace agrobus::j1939 {
             return data;
         }
 
-        static Request2Msg decode(const dp::Vector<u8> &data) {
+        static Request2Msg decode(DataSpan data) {
             Request2Msg msg;
             if (data.size() >= 4) {
                 msg.requested_pgn =
@@ -65,7 +67,7 @@ namespace agrobus::j1939 {
             return out;
         }
 
-        static TransferMsg decode(const dp::Vector<u8> &raw) {
+        static TransferMsg decode(DataSpan raw) {
             TransferMsg msg;
             if (raw.size() >= 3) {
                 msg.original_pgn =
@@ -86,8 +88,12 @@ namespace agrobus::j1939 {
         // Registered responders that support extended identifiers
         dp::Map<PGN, std::function<dp::Vector<u8>(const dp::Vector<u8> &extended_id)>> responders_;
 
+        // Broadcast answers to PDU2 requests, one per (PGN, extended ID) per window
+        ResponseCoalescer coalescer_;
+
       public:
-        Request2Protocol(IsoNet &net, InternalCF *cf) : net_(net), cf_(cf) {}
+        Request2Protocol(IsoNet &net, InternalCF *cf, CoalesceConfig coalesce = {})
+            : net_(net), cf_(cf), coalescer_(net.timers(), coalesce) {}
 
         Result<void> initialize() {
             if (!cf_) {
@@ -108,6 +114,13 @@ namespace agrobus::j1939 {
             return {};
         }
 
+        // Coalesce answers to Request2s for PDU2 PGNs without Transfer: those
+        // with the same PGN and extended ID within the window get one broadcast
+        // answer instead of one per requester. Transfer answers are addressed
+        // and unaffected.
+        void set_coalescing(CoalesceConfig config) { coalescer_.configure(config); }
+        const ResponseCoalescer &coalescer() const noexcept { return coalescer_; }
+
         // Send a Request2 message
         Result<void> request2(PGN pgn, const dp::Vector<u8> &extended_id = {}, bool use_transfer = false,
                               Address destination = BROADCAST_ADDRESS) {
@@ -126,6 +139,21 @@ namespace agrobus::j1939 {
             return net_.send(PGN_REQUEST2, req.encode(), cf_, &dest_cf, Priority::Default);
         }
 
+        // Coroutine form of request2(): co_await yields the responder's message
+        // (the requested PGN, or PGN_TRANSFER when use_transfer is set)
+        Task<Result<Message>> fetch(PGN pgn, dp::Vector<u8> extended_id = {}, bool use_transfer = false,
+                                    Address destination = BROADCAST_ADDRESS, u32 timeout_ms = 1250) {
+            auto reply = net_.receive(MessageFilter{use_transfer ? PGN_TRANSFER : pgn, destination, !use_transfer},
+                                      timeout_ms);
+            auto sent = request2(pgn, extended_id, use_transfer, destination);
+            if (!sent.is_ok())
+                co_return Result<Message>::err(sent.error());
+            auto result = co_await reply;
+            if (result.is_ok() && is_refusal(result.value(), pgn))
+                co_return Result<Message>::err(Error::invalid_pgn(pgn));
+            co_return result;
+        }
+
         // Events
         Event<Request2Msg, Address> on_request2_received;
         Event<TransferMsg, Address> on_transfer_received;
@@ -137,24 +165,46 @@ namespace agrobus::j1939 {
                 .debug("Request2 received: pgn=", req.requested_pgn, " from=", msg.source);
             on_request2_received.emit(req, msg.source);
 
+            if (responders_.find(req.requested_pgn) == responders_.end())
+                return;
+            u8 pf = (req.requested_pgn >> 8) & 0xFF;
+            if (pf >= 240 && !req.use_transfer && coalescer_.enabled()) {
+                u64 key = coalesce_key(req);
+                coalescer_.submit(key, [this, req = std::move(req)]() { respond(req, BROADCAST_ADDRESS); });
+                return;
+            }
+            respond(req, msg.source);
+        }
+
+        void respond(const Request2Msg &req, Address destination) {
             auto it = responders_.find(req.requested_pgn);
-            if (it != responders_.end()) {
-                auto response_data = it->second(req.extended_id);
-                if (!response_data.empty()) {
-                    ControlFunction dest_cf;
-                    dest_cf.address = msg.source;
-                    if (req.use_transfer) {
-                        TransferMsg transfer;
-                        transfer.original_pgn = req.requested_pgn;
-                        transfer.data = std::move(response_data);
-                        net_.send(PGN_TRANSFER, transfer.encode(), cf_, &dest_cf, Priority::Default);
-                    } else {
-                        net_.send(req.requested_pgn, response_data, cf_, &dest_cf, Priority::Default);
-                    }
-                }
+            if (it == responders_.end())
+                return;
+            auto response_data = it->second(req.extended_id);
+            if (response_data.empty())
+                return;
+            ControlFunction dest_cf;
+            dest_cf.address = destination;
+            ControlFunction *dest = destination != BROADCAST_ADDRESS ? &dest_cf : nullptr;
+            if (req.use_transfer) {
+                TransferMsg transfer;
+                transfer.original_pgn = req.requested_pgn;
+                transfer.data = std::move(response_data);
+                net_.send(PGN_TRANSFER, transfer.encode(), cf_, dest, Priority::Default);
+            } else {
+                net_.send(req.requested_pgn, response_data, cf_, dest, Priority::Default);
             }
         }
 
+        // PGN in the low 18 bits, extended ID length in bits 24-25, its bytes from bit 32
+        static u64 coalesce_key(const Request2Msg &req) noexcept {
+            u64 key = req.requested_pgn & 0x3FFFF;
+            key |= static_cast<u64>(req.extended_id.size() & 0x3) << 24;
+            for (usize i = 0; i < req.extended_id.size() && i < 3; ++i)
+                key |= static_cast<u64>(req.extended_id[i]) << (32 + 8 * i);
+            return key;
+        }
+
         void handle_transfer(const Message &msg) {
             auto transfer = TransferMsg::decode(msg.data);
             echo::category("isobus.protocol.request2")
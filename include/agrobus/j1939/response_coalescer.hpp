@@ -0,0 +1,125 @@
+#pragma once
+
+#include <agrobus/net/timer_wheel.hpp>
+#include <agrobus/net/types.hpp>
+#include <datapod/datapod.hpp>
+#include <echo/echo.hpp>
+#include <functional>
+
+namespace agrobus::j1939 {
+    using namespace agrobus::net;
+
+    // ─── Response coalescing configuration ──────────────────────────────────────
+    // Both zero (the default) answers every request as it arrives.
+    struct CoalesceConfig {
+        u32 window_ms = 0;       // Requests arriving within this long share one answer
+        u32 min_interval_ms = 0; // Minimum gap between two answers of the same key
+
+        CoalesceConfig &window(u32 ms) {
+            window_ms = ms;
+            return *this;
+        }
+        CoalesceConfig &min_interval(u32 ms) {
+            min_interval_ms = ms;
+            return *this;
+        }
+
+        bool enabled() const noexcept { return window_ms > 0 || min_interval_ms > 0; }
+    };
+
+    // ─── Per-key response coalescer ─────────────────────────────────────────────
+    // Sits between a request handler and its broadcast answers (PDU2 PGNs go
+    // to everyone, so one answer serves every requester). The first request
+    // for a key arms a timer for the window, or for the rest of the key's
+    // minimum interval if that is longer; requests for the same key arriving
+    // before it fires are absorbed, and the answer is built and sent once when
+    // it does. After a power-up, when every ECU asks for Address Claim or
+    // Software ID at once, the bus sees one BAM per PGN instead of one per
+    // requester. Timers run on IsoNet::timers(), so answers go out from
+    // inside update().
+    class ResponseCoalescer {
+        struct Slot {
+            TimerId timer = INVALID_TIMER;
+            u64 last_sent_ms = 0;
+            bool sent = false;
+            std::function<void()> send;
+        };
+
+        TimerWheel &timers_;
+        CoalesceConfig config_;
+        dp::Map<u64, Slot> slots_;
+        u32 absorbed_ = 0;
+
+      public:
+        explicit ResponseCoalescer(TimerWheel &timers, CoalesceConfig config = {})
+            : timers_(timers), config_(config) {}
+        ResponseCoalescer(const ResponseCoalescer &) = delete;
+        ResponseCoalescer &operator=(const ResponseCoalescer &) = delete;
+
+        ~ResponseCoalescer() { cancel_all(); }
+
+        void configure(CoalesceConfig config) { config_ = config; }
+        const CoalesceConfig &config() const noexcept { return config_; }
+        bool enabled() const noexcept { return config_.enabled(); }
+
+        // Answer a request for `key` through `send`, now or when the key's
+        // timer fires. A request for a key that already has an answer pending
+        // is absorbed and its `send` dropped.
+        void submit(u64 key, std::function<void()> send) {
+            Slot &slot = slots_[key];
+            if (slot.timer != INVALID_TIMER) {
+                ++absorbed_;
+                return;
+            }
+            u32 delay = config_.window_ms;
+            if (slot.sent) {
+                u64 since = timers_.now_ms() - slot.last_sent_ms;
+                if (since < config_.min_interval_ms && config_.min_interval_ms - since > delay)
+                    delay = static_cast<u32>(config_.min_interval_ms - since);
+            }
+            if (delay == 0) {
+                slot.sent = true;
+                slot.last_sent_ms = timers_.now_ms();
+                send();
+                return;
+            }
+            slot.send = std::move(send);
+            slot.timer = timers_.schedule(delay, [this, key]() { fire(key); });
+        }
+
+        bool pending(u64 key) const {
+            auto it = slots_.find(key);
+            return it != slots_.end() && it->second.timer != INVALID_TIMER;
+        }
+
+        // Requests answered by an answer that was already pending
+        u32 absorbed() const noexcept { return absorbed_; }
+
+        // Drop every pending answer
+        void cancel_all() {
+            for (auto &[key, slot] : slots_) {
+                if (slot.timer != INVALID_TIMER)
+                    timers_.cancel(slot.timer);
+                slot.timer = INVALID_TIMER;
+                slot.send = nullptr;
+            }
+        }
+
+      private:
+        void fire(u64 key) {
+            auto it = slots_.find(key);
+            if (it == slots_.end())
+                return;
+            Slot &slot = it->second;
+            slot.timer = INVALID_TIMER;
+            slot.sent = true;
+            slot.last_sent_ms = timers_.now_ms();
+            auto send = std::move(slot.send);
+            slot.send = nullptr;
+            echo::category("isobus.protocol.coalesce").trace("coalesced answer for key=", key);
+            if (send)
+                send();
+        }
+    };
+
+} // namespace agrobus::j1939
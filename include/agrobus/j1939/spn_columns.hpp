@@ -0,0 +1,90 @@
+#pragma once
+
+#include <agrobus/net/capture.hpp>
+#include <agrobus/net/data_span.hpp>
+#include <agrobus/net/identifier.hpp>
+#include <agrobus/net/types.hpp>
+#include <datapod/datapod.hpp>
+#include <utility>
+
+namespace agrobus::j1939 {
+    using namespace agrobus::net;
+
+    // ─── Columnar SPN decoder ───────────────────────────────────────────────────
+    // Batch decode of one single-frame PGN from a replayed log into one column
+    // per SPN, for analysis that wants a few parameters over many frames
+    // rather than one struct per frame. `View` is one of the lazy views
+    // (EEC1View, ETC1View, ...) and each getter is one of its accessors:
+    //
+    //   SpnColumns<EEC1View, &EEC1View::engine_speed_rpm, &EEC1View::actual_engine_percent>
+    //       cols(PGN_EEC1);
+    //   while (reader.next(rec)) cols.add(rec);
+    //   cols.column<0>(); // rpm, one value per accepted frame
+    //
+    // Only the requested SPNs are computed. Frames of another PGN, from
+    // another source (when one is given) or too short for the view are
+    // skipped; row i of every column and of timestamps() is the same frame.
+    template <typename View, auto... Getters> class SpnColumns {
+        static_assert(sizeof...(Getters) > 0, "SpnColumns needs at least one getter");
+
+        PGN pgn_;
+        Address source_;
+        dp::Vector<u64> timestamps_;
+        dp::Array<dp::Vector<f64>, sizeof...(Getters)> columns_;
+
+      public:
+        static constexpr usize COLUMNS = sizeof...(Getters);
+
+        // BROADCAST_ADDRESS takes every source
+        explicit SpnColumns(PGN pgn, Address source = BROADCAST_ADDRESS) : pgn_(pgn), source_(source) {}
+
+        // A captured frame (CaptureReader / CanLogReader); false when skipped
+        bool add(const CaptureRecord &rec) {
+            if (rec.flags & capture_flags::ERROR)
+                return false;
+            Identifier id(rec.can_id);
+            if (id.pgn() != pgn_)
+                return false;
+            return add(rec.timestamp_us, id.source(), DataSpan(rec.data, rec.dlc > 8 ? 8 : rec.dlc));
+        }
+
+        // Payload already matched to the PGN (e.g. from a view callback)
+        bool add(u64 timestamp_us, Address source, DataSpan data) {
+            if (source_ != BROADCAST_ADDRESS && source != source_)
+                return false;
+            View view(data);
+            if (!view.valid())
+                return false;
+            timestamps_.push_back(timestamp_us);
+            append(view, std::make_index_sequence<COLUMNS>{});
+            return true;
+        }
+
+        usize rows() const noexcept { return timestamps_.size(); }
+        const dp::Vector<u64> &timestamps() const noexcept { return timestamps_; }
+
+        template <usize I> const dp::Vector<f64> &column() const noexcept {
+            static_assert(I < COLUMNS, "column index out of range");
+            return columns_[I];
+        }
+        const dp::Vector<f64> &column(usize i) const noexcept { return columns_[i]; }
+
+        void reserve(usize rows) {
+            timestamps_.reserve(rows);
+            for (auto &col : columns_)
+                col.reserve(rows);
+        }
+
+        void clear() {
+            timestamps_.clear();
+            for (auto &col : columns_)
+                col.clear();
+        }
+
+      private:
+        template <usize... I> void append(const View &view, std::index_sequence<I...>) {
+            (columns_[I].push_back(static_cast<f64>((view.*Getters)())), ...);
+        }
+    };
+
+} // namespace agrobus::j1939
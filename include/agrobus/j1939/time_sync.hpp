@@ -0,0 +1,304 @@
+#pragma once
+
+#include <agrobus/net/constants.hpp>
+#include <agrobus/net/event.hpp>
+#include <agrobus/net/message.hpp>
+#include <agrobus/net/network_manager.hpp>
+#include <agrobus/net/types.hpp>
+#include <atomic>
+#include <datapod/datapod.hpp>
+#include <echo/echo.hpp>
+
+namespace agrobus::j1939 {
+    using namespace agrobus::net;
+
+    // ─── Time references, in order of preference ────────────────────────────────
+    enum class TimeSyncSource : u8 {
+        None,
+        TimeDate,   // J1939 PGN 65254, 0.25 s resolution
+        SystemTime, // NMEA 2000 PGN 126992, 0.1 ms
+        GNSS        // NMEA 2000 PGN 129029 date/time of fix, 0.1 ms
+    };
+
+    // ─── Sync configuration ─────────────────────────────────────────────────────
+    struct TimeSyncConfig {
+        bool use_time_date = true;
+        bool use_system_time = true;
+        bool use_gnss = true; // Registers 129029 as a fast packet PGN
+        u32 window = 16;      // Samples in the offset/drift fit
+        u32 step_ms = 2000;   // A sample this far off the estimate restarts the fit
+        u32 source_timeout_ms = 5000; // A preferred source this quiet hands over to a lesser one
+        u32 max_drift_ppm = 500;      // Clamp on the estimated rate difference
+
+        TimeSyncConfig &time_date(bool enable) {
+            use_time_date = enable;
+            return *this;
+        }
+        TimeSyncConfig &system_time(bool enable) {
+            use_system_time = enable;
+            return *this;
+        }
+        TimeSyncConfig &gnss(bool enable) {
+            use_gnss = enable;
+            return *this;
+        }
+        TimeSyncConfig &fit_window(u32 samples) {
+            window = samples < 2 ? 2 : samples;
+            return *this;
+        }
+        TimeSyncConfig &step(u32 ms) {
+            step_ms = ms;
+            return *this;
+        }
+        TimeSyncConfig &source_timeout(u32 ms) {
+            source_timeout_ms = ms;
+            return *this;
+        }
+    };
+
+    // ─── Current mapping local clock -> bus time ────────────────────────────────
+    // bus_us = anchor_bus_us + d + d * drift_ppb / 1e9, d = local_us - anchor_local_us.
+    // Bus time is microseconds since 1970-01-01 UTC.
+    struct BusTimeEstimate {
+        u64 anchor_local_us = 0;
+        u64 anchor_bus_us = 0;
+        i64 drift_ppb = 0; // Bus clock rate relative to ours
+        TimeSyncSource source = TimeSyncSource::None;
+        u32 samples = 0; // In the fit
+
+        u64 at(u64 local_us) const noexcept {
+            i64 d = static_cast<i64>(local_us - anchor_local_us);
+            return anchor_bus_us + static_cast<u64>(d + d * drift_ppb / 1'000'000'000);
+        }
+    };
+
+    // ─── Bus time synchronisation ───────────────────────────────────────────────
+    // Tracks the offset and drift between the local clock that stamps received
+    // frames (IsoNet::rx_time_us(), the steady clock unless a hardware clock is
+    // installed) and the time broadcast on the bus. Every time message is paired
+    // with the RX timestamp of its first frame, and a least-squares line through
+    // the last `window` pairs gives offset and rate; 0.25 s Time/Date samples
+    // are taken at the middle of their quantisation step so the fit is not
+    // biased by it. Only the most precise source heard within
+    // source_timeout_ms is used; switching source or a jump larger than
+    // step_ms (clock set, GNSS first fix) restarts the fit.
+    //
+    // The estimate is published through a seqlock: bus_time_at() and
+    // bus_time_now() may be called from any thread and cost a few loads and a
+    // multiply, so loggers can convert every sample's RX timestamp directly.
+    // Everything else runs on the thread that drives IsoNet::update().
+    class TimeSync {
+        struct Sample {
+            u64 local_us = 0;
+            u64 bus_us = 0;
+        };
+
+        IsoNet &net_;
+        TimeSyncConfig config_;
+        dp::Vector<Sample> samples_; // Ring of up to config_.window
+        usize head_ = 0;
+        TimeSyncSource source_ = TimeSyncSource::None;
+        u64 source_seen_us_ = 0;
+        BusTimeEstimate estimate_;
+        bool initialized_ = false;
+
+        // Published estimate (seqlock)
+        std::atomic<u32> seq_{0};
+        std::atomic<u64> pub_local_{0};
+        std::atomic<u64> pub_bus_{0};
+        std::atomic<i64> pub_drift_{0};
+
+      public:
+        explicit TimeSync(IsoNet &net, TimeSyncConfig config = {}) : net_(net), config_(config) {}
+        TimeSync(const TimeSync &) = delete;
+        TimeSync &operator=(const TimeSync &) = delete;
+
+        Result<void> initialize() {
+            if (initialized_)
+                return {};
+            if (config_.use_time_date) {
+                auto r = net_.register_pgn_view_callback(PGN_TIME_DATE, [this](const MessageView &msg) {
+                    if (auto bus = time_date_us(msg.data))
+                        add_sample(TimeSyncSource::TimeDate, *bus, msg.first_timestamp_us);
+                });
+                if (r.is_err())
+                    return r;
+            }
+            if (config_.use_system_time) {
+                auto r = net_.register_pgn_view_callback(PGN_SYSTEM_TIME, [this](const MessageView &msg) {
+                    if (auto bus = n2k_time_us(msg.data, 2))
+                        add_sample(TimeSyncSource::SystemTime, *bus, msg.first_timestamp_us);
+                });
+                if (r.is_err())
+                    return r;
+            }
+            if (config_.use_gnss) {
+                auto r = net_.register_fast_packet_pgn(PGN_GNSS_POSITION_DATA);
+                if (r.is_err())
+                    return r;
+                r = net_.register_pgn_view_callback(PGN_GNSS_POSITION_DATA, [this](const MessageView &msg) {
+                    if (auto bus = n2k_time_us(msg.data, 1))
+                        add_sample(TimeSyncSource::GNSS, *bus, msg.first_timestamp_us);
+                });
+                if (r.is_err())
+                    return r;
+            }
+            initialized_ = true;
+            echo::category("isobus.timesync").debug("initialized");
+            return {};
+        }
+
+        // A bus time observed at local time `local_us` (same clock as RX
+        // timestamps), for references that do not arrive through IsoNet, e.g.
+        // a serial GNSS receiver. Returns false when the sample was not used.
+        bool add_sample(TimeSyncSource source, u64 bus_us, u64 local_us) {
+            if (source == TimeSyncSource::None)
+                return false;
+            if (source < source_ && local_us - source_seen_us_ < static_cast<u64>(config_.source_timeout_ms) * 1000)
+                return false;
+            if (source != source_) {
+                echo::category("isobus.timesync").debug("time source ", static_cast<u8>(source));
+                restart(source);
+            } else if (estimate_.samples > 0) {
+                i64 error = static_cast<i64>(bus_us - estimate_.at(local_us));
+                if (error > static_cast<i64>(config_.step_ms) * 1000 ||
+                    -error > static_cast<i64>(config_.step_ms) * 1000) {
+                    echo::category("isobus.timesync").debug("time step of ", error, " us");
+                    restart(source);
+                    on_step.emit(error);
+                }
+            }
+            source_seen_us_ = local_us;
+
+            if (samples_.size() < config_.window) {
+                samples_.push_back({local_us, bus_us});
+            } else {
+                samples_[head_] = {local_us, bus_us};
+                head_ = (head_ + 1) % samples_.size();
+            }
+            fit(local_us, bus_us);
+            publish();
+            on_sync.emit(estimate_);
+            return true;
+        }
+
+        // ─── Queries ─────────────────────────────────────────────────────────────
+        bool synced() const noexcept { return seq_.load(std::memory_order_acquire) != 0; }
+        TimeSyncSource source() const noexcept { return source_; }
+        const BusTimeEstimate &estimate() const noexcept { return estimate_; }
+
+        // Bus time (us since the Unix epoch) at a local/RX timestamp; 0 until synced. Any thread.
+        u64 bus_time_at(u64 local_us) const noexcept {
+            BusTimeEstimate e;
+            if (!load(e))
+                return 0;
+            return e.at(local_us);
+        }
+
+        u64 bus_time_now() const noexcept { return bus_time_at(net_.rx_time_us()); }
+
+        // ─── Events ──────────────────────────────────────────────────────────────
+        Event<const BusTimeEstimate &> on_sync; // After every sample used
+        Event<i64> on_step;                     // Bus time jumped by this much (us); fit restarted
+
+        // ─── Decoding ────────────────────────────────────────────────────────────
+        // J1939 Time/Date: seconds and day are 0.25/bit (day as read by
+        // TimeDateInterface), year offset 1985. Middle of the 0.25 s step.
+        static dp::Optional<u64> time_date_us(DataSpan data) {
+            if (data.size() < 6)
+                return dp::nullopt;
+            u8 sec = data[0], min = data[1], hour = data[2], month = data[3], day = data[4] / 4;
+            if (sec >= 240 || min >= 60 || hour >= 24 || month < 1 || month > 12 || day < 1 || day > 31 ||
+                data[5] == 0xFF)
+                return dp::nullopt;
+            i64 days = days_from_civil(1985 + data[5], month, day);
+            u64 s = static_cast<u64>(days) * 86400 + hour * 3600u + min * 60u;
+            return s * 1'000'000 + sec * 250'000u + 125'000u;
+        }
+
+        // NMEA 2000 date (u16 days since 1970) and time of day (u32, 0.1 ms)
+        static dp::Optional<u64> n2k_time_us(DataSpan data, usize offset) {
+            if (data.size() < offset + 6)
+                return dp::nullopt;
+            u16 days = data.get_u16_le(offset);
+            u32 tod = data.get_u32_le(offset + 2);
+            if (days == 0xFFFF || tod >= 864'000'000u)
+                return dp::nullopt;
+            return static_cast<u64>(days) * 86'400'000'000ull + static_cast<u64>(tod) * 100;
+        }
+
+        // Days since 1970-01-01 of a proleptic Gregorian date
+        static constexpr i64 days_from_civil(i64 y, u32 m, u32 d) noexcept {
+            y -= m <= 2;
+            i64 era = (y >= 0 ? y : y - 399) / 400;
+            u32 yoe = static_cast<u32>(y - era * 400);
+            u32 doy = (153 * (m > 2 ? m - 3 : m + 9) + 2) / 5 + d - 1;
+            u32 doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+            return era * 146097 + static_cast<i64>(doe) - 719468;
+        }
+
+      private:
+        void restart(TimeSyncSource source) {
+            source_ = source;
+            samples_.clear();
+            head_ = 0;
+            estimate_.samples = 0;
+        }
+
+        // Least squares of (bus - local) over local, centred on the newest
+        // sample so the doubles stay small
+        void fit(u64 local_ref, u64 bus_ref) {
+            usize n = samples_.size();
+            f64 sx = 0, sy = 0, sxx = 0, sxy = 0;
+            for (const auto &s : samples_) {
+                f64 x = static_cast<f64>(static_cast<i64>(s.local_us - local_ref));
+                f64 y = static_cast<f64>(static_cast<i64>(s.bus_us - bus_ref)) - x;
+                sx += x;
+                sy += y;
+                sxx += x * x;
+                sxy += x * y;
+            }
+            f64 mx = sx / n, my = sy / n;
+            f64 var = sxx - sx * mx;
+            f64 slope = 0;
+            if (n >= 2 && var > 1e12) // At least ~1 s of spread before trusting a rate
+                slope = (sxy - sx * my) / var;
+            f64 limit = config_.max_drift_ppm * 1e-6;
+            slope = slope > limit ? limit : (slope < -limit ? -limit : slope);
+
+            estimate_.anchor_local_us = local_ref;
+            estimate_.anchor_bus_us = bus_ref + static_cast<u64>(static_cast<i64>(my - slope * mx));
+            estimate_.drift_ppb = static_cast<i64>(slope * 1e9);
+            estimate_.source = source_;
+            estimate_.samples = static_cast<u32>(n);
+        }
+
+        void publish() {
+            u32 s = seq_.load(std::memory_order_relaxed);
+            seq_.store(s + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            pub_local_.store(estimate_.anchor_local_us, std::memory_order_relaxed);
+            pub_bus_.store(estimate_.anchor_bus_us, std::memory_order_relaxed);
+            pub_drift_.store(estimate_.drift_ppb, std::memory_order_relaxed);
+            seq_.store(s + 2, std::memory_order_release);
+        }
+
+        bool load(BusTimeEstimate &out) const noexcept {
+            u32 before;
+            u32 after;
+            do {
+                before = seq_.load(std::memory_order_acquire);
+                if (before & 1u) {
+                    after = before + 1; // Writer inside: retry
+                    continue;
+                }
+                out.anchor_local_us = pub_local_.load(std::memory_order_relaxed);
+                out.anchor_bus_us = pub_bus_.load(std::memory_order_relaxed);
+                out.drift_ppb = pub_drift_.load(std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_acquire);
+                after = seq_.load(std::memory_order_relaxed);
+            } while (before != after);
+            return before != 0;
+        }
+    };
+} // namespace agrobus::j1939
@@ -33,7 +33,7 @@ namespace agrobus::j1939 {
             return data;
         }
 
-        static ETC1 decode(const dp::Vector<u8> &data) {
+        static ETC1 decode(DataSpan data) {
             ETC1 msg;
             if (data.size() >= 5) {
                 msg.shift_in_progress = data[0] & 0x03;
@@ -59,7 +59,7 @@ namespace agrobus::j1939 {
             return data;
         }
 
-        static TransmissionOilTemp decode(const dp::Vector<u8> &data) {
+        static TransmissionOilTemp decode(DataSpan data) {
             TransmissionOilTemp msg;
             if (data.size() >= 2) {
                 u16 temp = static_cast<u16>(data[0]) | (static_cast<u16>(data[1]) << 8);
@@ -91,7 +91,7 @@ namespace agrobus::j1939 {
             return data;
         }
 
-        static CruiseControl decode(const dp::Vector<u8> &data) {
+        static CruiseControl decode(DataSpan data) {
             CruiseControl msg;
             if (data.size() >= 5) {
                 u16 speed = static_cast<u16>(data[0]) | (static_cast<u16>(data[1]) << 8);
@@ -107,6 +107,50 @@ namespace agrobus::j1939 {
         }
     };
 
+    // ─── Lazy views ──────────────────────────────────────────────────────────────
+    // Per-SPN accessors over a received frame, as in engine.hpp
+    struct ETC1View {
+        DataSpan data;
+
+        explicit ETC1View(DataSpan d) : data(d) {}
+        bool valid() const noexcept { return data.size() >= 5; }
+
+        u8 shift_in_progress() const noexcept { return data[0] & 0x03; }
+        u8 torque_converter_lockup() const noexcept { return (data[0] >> 2) & 0x03; }
+        f64 output_shaft_speed_rpm() const noexcept { return data.get_u16_le(1) * 0.125; }
+        i8 current_gear() const noexcept { return static_cast<i8>(static_cast<i8>(data[3]) - 125); }
+        i8 selected_gear() const noexcept { return static_cast<i8>(static_cast<i8>(data[4]) - 125); }
+
+        ETC1 decode() const { return ETC1::decode(data); }
+    };
+
+    struct TransmissionOilTempView {
+        DataSpan data;
+
+        explicit TransmissionOilTempView(DataSpan d) : data(d) {}
+        bool valid() const noexcept { return data.size() >= 2; }
+
+        f64 oil_temp_c() const noexcept { return data.get_u16_le(0) * 0.03125 - 273.0; }
+
+        TransmissionOilTemp decode() const { return TransmissionOilTemp::decode(data); }
+    };
+
+    struct CruiseControlView {
+        DataSpan data;
+
+        explicit CruiseControlView(DataSpan d) : data(d) {}
+        bool valid() const noexcept { return data.size() >= 5; }
+
+        f64 wheel_speed_kmh() const noexcept { return data.get_u16_le(0) / 256.0; }
+        u8 cc_active() const noexcept { return data[2] & 0x03; }
+        u8 brake_switch() const noexcept { return (data[2] >> 2) & 0x03; }
+        u8 clutch_switch() const noexcept { return (data[2] >> 4) & 0x03; }
+        u8 park_brake() const noexcept { return (data[2] >> 6) & 0x03; }
+        f64 cc_set_speed_kmh() const noexcept { return data.get_u16_le(3) / 256.0; }
+
+        CruiseControl decode() const { return CruiseControl::decode(data); }
+    };
+
     // ─── J1939 Transmission Interface ──────────────────────────────────────────
     // Handles reception and transmission of J1939 transmission/drivetrain messages.
     class TransmissionInterface {
@@ -4,6 +4,8 @@
 #include <agrobus/net/constants.hpp>
 #include <agrobus/net/error.hpp>
 #include <agrobus/net/frame.hpp>
+#include <agrobus/net/name_table.hpp>
+#include <agrobus/net/timer.hpp>
 #include <datapod/datapod.hpp>
 #include <echo/echo.hpp>
 
@@ -30,12 +32,28 @@ namespace agrobus::net {
         u32 reclaim_delay_timer_ms_ = 0;
         Address reclaim_address_ = NULL_ADDRESS;
 
+        // Bus address map (optional): moving after a lost contest skips
+        // addresses other NAMEs already hold
+        const NameTable *address_map_ = nullptr;
+
+        // Where start() claims; NULL_ADDRESS = the preferred address
+        Address start_address_ = NULL_ADDRESS;
+
       public:
         // rtxd_ms: Random transmit delay in ms (0-153, per ISO 11783-5 §3.4).
         // Caller should provide 0.6 × random_byte (0-255) as the RTxD value.
         explicit AddressClaimer(InternalCF *cf, u32 timeout_ms = ADDRESS_CLAIM_TIMEOUT_MS, u32 rtxd_ms = 0)
             : cf_(cf), timeout_ms_(timeout_ms + rtxd_ms), rtxd_ms_(rtxd_ms) {}
 
+        void set_address_map(const NameTable *map) noexcept { address_map_ = map; }
+
+        // Begin the next start() at `addr` (e.g. the address claimed at the
+        // previous key-on) instead of the preferred address
+        void set_start_address(Address addr) noexcept { start_address_ = addr; }
+        Address start_address() const noexcept {
+            return start_address_ <= MAX_ADDRESS ? start_address_ : cf_->preferred_address();
+        }
+
         // Query whether this CF has attempted an address claim
         bool has_attempted_claim() const noexcept { return attempted_claim_; }
 
@@ -46,7 +64,7 @@ namespace agrobus::net {
         dp::Vector<Frame> start() {
             dp::Vector<Frame> frames;
             echo::category("isobus.network.claim")
-                .debug("starting address claim: preferred=", cf_->preferred_address());
+                .debug("starting address claim: preferred=", cf_->preferred_address(), " start=", start_address());
             cf_->state_machine().transition(ClaimState::SendRequest);
 
             // Mark that we have attempted a claim
@@ -69,16 +87,23 @@ namespace agrobus::net {
             claim_guard_timer_ms_ = 0;
 
             // Send our address claim (DLC=8 guaranteed by make_claim_frame)
-            frames.push_back(make_claim_frame(cf_->preferred_address()));
+            if (start_address_ <= MAX_ADDRESS)
+                cf_->set_address(start_address_);
+            frames.push_back(make_claim_frame(start_address()));
             cf_->state_machine().transition(ClaimState::WaitForContest);
 
             return frames;
         }
 
-        // Process elapsed time, returns frames to send
+        // Process elapsed time, returns frames to send. The overloads taking a
+        // vector append to it instead, so a caller can reuse one buffer per tick.
         dp::Vector<Frame> update(u32 elapsed_ms) {
             dp::Vector<Frame> frames;
+            update(elapsed_ms, frames);
+            return frames;
+        }
 
+        void update(u32 elapsed_ms, dp::Vector<Frame> &frames) {
             // Handle pending re-claim with RTxD delay
             if (reclaim_pending_) {
                 reclaim_delay_timer_ms_ += elapsed_ms;
@@ -92,7 +117,7 @@ namespace agrobus::net {
                     cf_->state_machine().transition(ClaimState::WaitForContest);
                     echo::category("isobus.network.claim").debug("re-claim sent after RTxD: addr=", reclaim_address_);
                 }
-                return frames;
+                return;
             }
 
             if (cf_->claim_state() == ClaimState::WaitForContest) {
@@ -111,16 +136,27 @@ namespace agrobus::net {
                     echo::category("isobus.network.claim").info("Address claimed: ", cf_->address());
                 }
             }
+        }
 
-            return frames;
+        // Time until update() next acts: the RTxD re-claim or the end of the guard window
+        u32 next_deadline_ms() const noexcept {
+            if (reclaim_pending_)
+                return time_left(reclaim_delay_timer_ms_, rtxd_ms_);
+            if (cf_->claim_state() == ClaimState::WaitForContest)
+                return time_left(claim_guard_timer_ms_, timeout_ms_);
+            return NO_DEADLINE;
         }
 
         // Handle incoming address claim from another device
         dp::Vector<Frame> handle_claim(Address claimed_address, Name other_name) {
             dp::Vector<Frame> frames;
+            handle_claim(claimed_address, other_name, frames);
+            return frames;
+        }
 
+        void handle_claim(Address claimed_address, Name other_name, dp::Vector<Frame> &frames) {
             if (claimed_address != cf_->address() && claimed_address != cf_->preferred_address()) {
-                return frames; // Not our address
+                return; // Not our address
             }
 
             if (cf_->name() < other_name) {
@@ -167,8 +203,6 @@ namespace agrobus::net {
                     frames.push_back(make_claim_frame(NULL_ADDRESS));
                 }
             }
-
-            return frames;
         }
 
         // Handle request-for-address-claimed (ISO 11783-5 §4.4.2)
@@ -178,11 +212,15 @@ namespace agrobus::net {
         //   - If not yet attempted: do NOT respond
         dp::Vector<Frame> handle_request_for_claim() {
             dp::Vector<Frame> frames;
+            handle_request_for_claim(frames);
+            return frames;
+        }
 
+        void handle_request_for_claim(dp::Vector<Frame> &frames) {
             if (!attempted_claim_) {
                 // §4.4.2: A CF that has NOT attempted claim SHALL NOT respond
                 echo::category("isobus.network.claim").debug("ignoring request-for-claim: not yet attempted");
-                return frames;
+                return;
             }
 
             if (cf_->claim_state() == ClaimState::Claimed) {
@@ -201,8 +239,6 @@ namespace agrobus::net {
                     .debug("responding to request-for-claim during contest: ", cf_->address());
                 frames.push_back(make_claim_frame(cf_->address()));
             }
-
-            return frames;
         }
 
       private:
@@ -219,6 +255,13 @@ namespace agrobus::net {
         Address find_next_address(Address current) const noexcept {
             // Simple linear search for next available address
             Address next = (current < MAX_ADDRESS) ? current + 1 : 0;
+            if (address_map_) {
+                for (u32 tries = 0; tries < MAX_ADDRESS && (next == cf_->preferred_address() ||
+                                                             address_map_->taken(cf_->port(), next, cf_->name()));
+                     ++tries)
+                    next = (next < MAX_ADDRESS) ? next + 1 : 0;
+                return next;
+            }
             if (next == cf_->preferred_address())
                 ++next;
             return next;
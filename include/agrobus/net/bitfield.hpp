@@ -66,7 +66,7 @@ namespace agrobus::net {
                    (static_cast<u32>(data[3]) << 24);
         }
 
-        inline u64 unpack_u64_le(const u8 *data) noexcept {
+        constexpr u64 unpack_u64_le(const u8 *data) noexcept {
             u64 result = 0;
             for (usize i = 0; i < 8; ++i) {
                 result |= static_cast<u64>(data[i]) << (i * 8);
@@ -86,11 +86,72 @@ namespace agrobus::net {
             data[3] = static_cast<u8>((value >> 24) & 0xFF);
         }
 
-        inline void pack_u64_le(u8 *data, u64 value) noexcept {
+        constexpr void pack_u64_le(u8 *data, u64 value) noexcept {
             for (usize i = 0; i < 8; ++i) {
                 data[i] = static_cast<u8>((value >> (i * 8)) & 0xFF);
             }
         }
 
+        // Up to 8 bytes of a frame as one little-endian word; missing bytes read
+        // as 0xFF (not available), so a short frame decodes its absent fields as N/A
+        constexpr u64 load_le(const u8 *data, usize size) noexcept {
+            u64 word = ~static_cast<u64>(0);
+            usize n = size < 8 ? size : 8;
+            for (usize i = 0; i < n; ++i) {
+                word &= ~(static_cast<u64>(0xFF) << (i * 8));
+                word |= static_cast<u64>(data[i]) << (i * 8);
+            }
+            return word;
+        }
+
+        // Write the low min(size, 8) bytes of a little-endian word
+        constexpr void store_le(u8 *data, usize size, u64 word) noexcept {
+            usize n = size < 8 ? size : 8;
+            for (usize i = 0; i < n; ++i) {
+                data[i] = static_cast<u8>(word >> (i * 8));
+            }
+        }
+
+        // ─── Word-level field access over byte buffers ───────────────────────────
+        // A field of up to 32 bits starting anywhere in a buffer lies within the
+        // 8 bytes from its first byte (7 + 32 < 64), so one little-endian load,
+        // one shift and one mask extract it. Bytes past `size` read as zero.
+        inline constexpr u8 MAX_FIELD_BITS = 32;
+
+        constexpr u64 load_window(const u8 *data, usize size, usize byte_offset) noexcept {
+            if (byte_offset + 8 <= size)
+                return unpack_u64_le(data + byte_offset);
+            u64 word = 0;
+            for (usize i = 0; byte_offset + i < size && i < 8; ++i)
+                word |= static_cast<u64>(data[byte_offset + i]) << (i * 8);
+            return word;
+        }
+
+        constexpr u32 extract_le(const u8 *data, usize size, usize start_bit, u8 length) noexcept {
+            if (length == 0 || length > MAX_FIELD_BITS)
+                return 0;
+            u64 word = load_window(data, size, start_bit / 8);
+            u64 mask = (static_cast<u64>(1) << length) - 1;
+            return static_cast<u32>((word >> (start_bit % 8)) & mask);
+        }
+
+        // Write the low `length` bits of value at start_bit; bits past `size` are dropped
+        constexpr void deposit_le(u8 *data, usize size, usize start_bit, u8 length, u32 value) noexcept {
+            if (length == 0 || length > MAX_FIELD_BITS)
+                return;
+            usize byte = start_bit / 8;
+            u8 shift = static_cast<u8>(start_bit % 8);
+            u64 mask = ((static_cast<u64>(1) << length) - 1) << shift;
+            u64 word = load_window(data, size, byte);
+            word = (word & ~mask) | ((static_cast<u64>(value) << shift) & mask);
+            usize touched = (shift + length + 7) / 8;
+            if (byte + 8 <= size) {
+                pack_u64_le(data + byte, word);
+                return;
+            }
+            for (usize i = 0; i < touched && byte + i < size; ++i)
+                data[byte + i] = static_cast<u8>(word >> (i * 8));
+        }
+
     } // namespace bitfield
 } // namespace agrobus::net
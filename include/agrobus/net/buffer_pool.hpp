@@ -0,0 +1,129 @@
+#pragma once
+
+#include <agrobus/net/static_alloc.hpp>
+#include <agrobus/net/types.hpp>
+#include <datapod/datapod.hpp>
+
+namespace agrobus::net {
+
+    // ─── Size-class buffer pool for transport reassembly ─────────────────────────
+    // Byte buffers are bucketed by capacity: 64 B, 256 B, 1785 B (TP max),
+    // 64 KiB and a "large" class for anything bigger (ETP). Released buffers keep
+    // their capacity and are handed out again by acquire(), so steady-state
+    // transport traffic does not allocate. Each class caches a bounded number of
+    // buffers; surplus buffers are simply freed, which bounds the memory a
+    // misbehaving sender can pin. In the static allocation profile a request
+    // its own class cannot serve borrows a cached buffer of a larger class
+    // before allocating, so a pool reserved with TP-sized buffers covers every
+    // TP session.
+    class BufferPool {
+      public:
+        static constexpr usize NUM_CLASSES = 5;
+        static constexpr usize LARGE_CLASS = NUM_CLASSES - 1;
+        static constexpr usize CLASS_BYTES[LARGE_CLASS] = {64, 256, 1785, 65536};
+
+        struct Stats {
+            u64 hits = 0;      // acquire() served from the cache
+            u64 misses = 0;    // acquire() had to allocate
+            u64 released = 0;  // buffers returned to the cache
+            u64 discarded = 0; // buffers freed because the class was full (or too small)
+        };
+
+      private:
+        dp::Array<dp::Vector<dp::Vector<u8>>, NUM_CLASSES> free_;
+        usize max_per_class_;
+        usize max_large_;
+        Stats stats_;
+
+      public:
+        explicit BufferPool(usize max_per_class = 8, usize max_large = 1)
+            : max_per_class_(max_per_class), max_large_(max_large) {}
+
+        // Size class that serves a request of `size` bytes
+        static constexpr usize class_for(usize size) noexcept {
+            for (usize c = 0; c < LARGE_CLASS; ++c) {
+                if (size <= CLASS_BYTES[c])
+                    return c;
+            }
+            return LARGE_CLASS;
+        }
+
+        // A buffer of exactly `size` bytes, every byte set to `fill`
+        dp::Vector<u8> acquire(usize size, u8 fill = 0xFF) {
+            usize c = class_for(size);
+            auto &list = free_[c];
+            for (usize i = list.size(); i > 0; --i) {
+                if (list[i - 1].capacity() >= size) {
+                    dp::Vector<u8> buf = std::move(list[i - 1]);
+                    list.erase(list.begin() + static_cast<isize>(i - 1));
+                    buf.assign(size, fill);
+                    ++stats_.hits;
+                    return buf;
+                }
+            }
+            if constexpr (static_alloc::enabled) {
+                for (usize larger = c + 1; larger < LARGE_CLASS; ++larger) {
+                    if (!free_[larger].empty()) {
+                        dp::Vector<u8> buf = std::move(free_[larger].back());
+                        free_[larger].pop_back();
+                        buf.assign(size, fill);
+                        ++stats_.hits;
+                        return buf;
+                    }
+                }
+            }
+            ++stats_.misses;
+            dp::Vector<u8> buf;
+            buf.reserve(c == LARGE_CLASS ? size : CLASS_BYTES[c]);
+            buf.assign(size, fill);
+            return buf;
+        }
+
+        // Hand a buffer back (any dp::Vector<u8>; its capacity picks the class)
+        void release(dp::Vector<u8> &&buf) {
+            usize cap = buf.capacity();
+            if (cap < CLASS_BYTES[0]) {
+                if (cap > 0)
+                    ++stats_.discarded;
+                return;
+            }
+            usize c = LARGE_CLASS;
+            if (cap <= CLASS_BYTES[LARGE_CLASS - 1]) {
+                c = 0;
+                while (c + 1 < LARGE_CLASS && CLASS_BYTES[c + 1] <= cap)
+                    ++c;
+            }
+            usize limit = c == LARGE_CLASS ? max_large_ : max_per_class_;
+            if (free_[c].size() >= limit) {
+                ++stats_.discarded;
+                return;
+            }
+            buf.clear();
+            free_[c].push_back(std::move(buf));
+            ++stats_.released;
+        }
+
+        // Pre-allocate `count` buffers of a size class (not LARGE_CLASS)
+        void reserve(usize size_class, usize count) {
+            if (size_class >= LARGE_CLASS)
+                return;
+            while (free_[size_class].size() < count && free_[size_class].size() < max_per_class_) {
+                dp::Vector<u8> buf;
+                buf.reserve(CLASS_BYTES[size_class]);
+                free_[size_class].push_back(std::move(buf));
+            }
+        }
+
+        usize cached(usize size_class) const noexcept {
+            return size_class < NUM_CLASSES ? free_[size_class].size() : 0;
+        }
+
+        const Stats &stats() const noexcept { return stats_; }
+
+        void clear() {
+            for (auto &list : free_)
+                list.clear();
+        }
+    };
+
+} // namespace agrobus::net
@@ -1,35 +1,174 @@
 #pragma once
 
+#include <agrobus/net/frame.hpp>
+#include <agrobus/net/timer.hpp>
 #include <agrobus/net/types.hpp>
 #include <datapod/datapod.hpp>
 
 namespace agrobus::net {
 
+    // ─── Wire bit model ──────────────────────────────────────────────────────────
+    enum class BitModel : u8 {
+        Average,  // Fixed overhead plus ~20% stuff bits (cheap, the historic estimate)
+        Exact,    // Stuff bits counted over the frame's actual ID, DLC, data and CRC
+        WorstCase // Maximum stuff bits for the DLC (for schedulability bounds)
+    };
+
     // ─── Bus load estimation ─────────────────────────────────────────────────────
     class BusLoad {
+      public:
+        static constexpr u32 CAN_BITRATE = 250000; // 250 kbit/s standard ISOBUS
+
+        // Standard CAN frame overhead: SOF(1) + ID(29) + SRR(1) + IDE(1) + RTR(1) +
+        // r0(1) + DLC(4) + DATA(dlc*8) + CRC(15) + CRC_del(1) + ACK(2) + EOF(7) + IFS(3)
+        // Plus ~20% stuff bits on average
+        static constexpr u32 frame_bits(u8 dlc = 8) noexcept {
+            u32 bits = 67 + static_cast<u32>(dlc) * 8;
+            return bits * 120 / 100; // approximate stuff bits
+        }
+
+        // Stuffing covers SOF through the CRC (54 + 8*dlc bits); one stuff bit
+        // per four bits at most after the first five
+        static constexpr u32 frame_bits_worst(u8 dlc = 8) noexcept {
+            u32 stuffed_region = 54 + static_cast<u32>(dlc) * 8;
+            return 67 + static_cast<u32>(dlc) * 8 + (stuffed_region - 1) / 4;
+        }
+
+        // Exact length of an extended data frame on the wire, including the
+        // interframe space: the bit stream from SOF to the end of the CRC is
+        // built from the identifier, DLC and data, the CRC-15 is computed over
+        // it and every run of five equal bits costs one stuff bit
+        static constexpr u32 frame_bits_exact(u32 id, const u8 *data, u8 dlc) noexcept {
+            struct Stream {
+                u32 stuff = 0;
+                u32 run = 0;
+                u8 last = 2;
+                u16 crc = 0;
+
+                constexpr void bit(u8 b, bool into_crc) noexcept {
+                    if (into_crc) {
+                        u8 next = b ^ static_cast<u8>((crc >> 14) & 1);
+                        crc = static_cast<u16>((crc << 1) & 0x7FFF);
+                        if (next)
+                            crc ^= 0x4599;
+                    }
+                    if (b == last) {
+                        ++run;
+                    } else {
+                        last = b;
+                        run = 1;
+                    }
+                    if (run == 5) {
+                        ++stuff;
+                        last = static_cast<u8>(b ^ 1); // The stuff bit starts the next run
+                        run = 1;
+                    }
+                }
+                constexpr void bits(u32 value, u8 count) noexcept {
+                    for (u8 i = count; i > 0; --i)
+                        bit(static_cast<u8>((value >> (i - 1)) & 1), true);
+                }
+            };
+
+            if (dlc > 8)
+                dlc = 8;
+            Stream s;
+            s.bit(0, true);       // SOF
+            s.bits(id >> 18, 11); // Base identifier
+            s.bits(0b11, 2);      // SRR, IDE
+            s.bits(id & 0x3FFFF, 18);
+            s.bits(0, 3); // RTR, r1, r0
+            s.bits(dlc, 4);
+            for (u8 i = 0; i < dlc; ++i)
+                s.bits(data[i], 8);
+            u16 crc = s.crc;
+            for (u8 i = 15; i > 0; --i)
+                s.bit(static_cast<u8>((crc >> (i - 1)) & 1), false);
+            return 67 + static_cast<u32>(dlc) * 8 + s.stuff;
+        }
+
+        // CAN FD extended frame, in bit times of the nominal bitrate. The
+        // arbitration phase (SOF through BRS: 33 bits) and the tail (CRC
+        // delimiter, ACK, EOF, IFS: 13 bits) run at `bitrate`; ESI, DLC, data,
+        // stuff count and CRC-17/21 with their fixed stuff bits run at
+        // `data_bitrate` when the frame switches rate (0 = no switch). Dynamic
+        // stuffing covers arbitration through data: ~20% on average, one per
+        // four bits at worst.
+        static constexpr u32 fd_frame_bits(u8 length, u32 bitrate, u32 data_bitrate, bool worst = false) noexcept {
+            u32 data_bits = static_cast<u32>(length) * 8;
+            u32 crc = length <= 16 ? 17 : 21;
+            u32 arbitration = 33;
+            u32 data_phase = 1 + 4 + data_bits; // ESI, DLC, data
+            u32 stuffed = arbitration + data_phase;
+            u32 stuff = worst ? (stuffed - 1) / 4 : stuffed / 5;
+            u32 arbitration_stuff = stuff * arbitration / stuffed;
+            u32 crc_field = 4 + crc + (4 + crc + 3) / 4; // Stuff count, CRC, fixed stuff bits
+            u32 nominal = arbitration + arbitration_stuff + 13;
+            u32 fast = data_phase + (stuff - arbitration_stuff) + crc_field;
+            if (data_bitrate == 0 || bitrate == 0 || data_bitrate <= bitrate)
+                return nominal + fast;
+            return nominal + static_cast<u32>((static_cast<u64>(fast) * bitrate + data_bitrate - 1) / data_bitrate);
+        }
+
+        static u32 bits(const Frame &frame, BitModel model) noexcept {
+            switch (model) {
+            case BitModel::Exact:
+                return frame_bits_exact(frame.id.raw, frame.data.data(), frame.length);
+            case BitModel::WorstCase:
+                return frame_bits_worst(frame.length);
+            default:
+                return frame_bits(frame.length);
+            }
+        }
+
+      private:
         static constexpr usize WINDOW_SIZE = 100;
         static constexpr u32 SAMPLE_PERIOD_MS = 100;
-        static constexpr u32 CAN_BITRATE = 250000; // 250 kbit/s standard ISOBUS
 
         dp::Array<u32, WINDOW_SIZE> bit_counts_ = {};
         usize write_idx_ = 0;
         u32 current_bits_ = 0;
         u32 timer_ms_ = 0;
         bool filled_ = false;
+        u32 bitrate_ = CAN_BITRATE;
+        u32 data_bitrate_ = 0; // CAN FD data phase, 0 = classic port
+        BitModel model_ = BitModel::Average;
 
       public:
+        BusLoad() = default;
+
+        // Bitrate from the port's CanBusConfig; the model decides what a frame costs
+        explicit BusLoad(u32 bitrate, BitModel model = BitModel::Average) noexcept
+            : bitrate_(bitrate == 0 ? CAN_BITRATE : bitrate), model_(model) {}
+
         void add_frame(u8 dlc = 8) noexcept {
-            // Standard CAN frame overhead: SOF(1) + ID(29) + SRR(1) + IDE(1) + RTR(1) +
-            // r0(1) + DLC(4) + DATA(dlc*8) + CRC(15) + CRC_del(1) + ACK(2) + EOF(7) + IFS(3)
-            // Plus ~20% stuff bits on average
-            u32 bits = 67 + static_cast<u32>(dlc) * 8;
-            bits = bits * 120 / 100; // approximate stuff bits
-            current_bits_ += bits;
+            current_bits_ += model_ == BitModel::WorstCase ? frame_bits_worst(dlc) : frame_bits(dlc);
         }
 
+        void add_frame(const Frame &frame) noexcept { current_bits_ += bits(frame, model_); }
+
+        // FD frames are costed with the FD layout whatever the model (Exact
+        // falls back to the average stuffing estimate)
+        void add_frame(const FdFrame &frame) noexcept {
+            bool brs = (frame.flags & CAN_FD_FLAG_BRS) != 0;
+            current_bits_ +=
+                fd_frame_bits(frame.length, bitrate_, brs ? data_bitrate_ : 0, model_ == BitModel::WorstCase);
+        }
+
+        // Data-phase bitrate of a CAN FD port (e.g. 2 or 5 Mbit/s)
+        void set_data_bitrate(u32 data_bitrate) noexcept { data_bitrate_ = data_bitrate; }
+        u32 data_bitrate() const noexcept { return data_bitrate_; }
+
+        u32 bitrate() const noexcept { return bitrate_; }
+        BitModel model() const noexcept { return model_; }
+
         void update(u32 elapsed_ms) noexcept {
             timer_ms_ += elapsed_ms;
-            if (timer_ms_ >= SAMPLE_PERIOD_MS) {
+            // Catch up on every elapsed sample period (callers may sleep across several)
+            constexpr u32 max_catch_up = SAMPLE_PERIOD_MS * static_cast<u32>(WINDOW_SIZE);
+            if (timer_ms_ > max_catch_up)
+                timer_ms_ = max_catch_up;
+            while (timer_ms_ >= SAMPLE_PERIOD_MS) {
                 timer_ms_ -= SAMPLE_PERIOD_MS;
                 bit_counts_[write_idx_] = current_bits_;
                 write_idx_ = (write_idx_ + 1) % WINDOW_SIZE;
@@ -39,6 +178,12 @@ namespace agrobus::net {
             }
         }
 
+        // Idle sample periods can be caught up later, so only pending bits need a
+        // timely sample
+        u32 next_deadline_ms() const noexcept {
+            return current_bits_ == 0 ? NO_DEADLINE : time_left(timer_ms_, SAMPLE_PERIOD_MS);
+        }
+
         f32 load_percent() const noexcept {
             usize count = filled_ ? WINDOW_SIZE : write_idx_;
             if (count == 0)
@@ -51,7 +196,7 @@ namespace agrobus::net {
 
             f32 window_seconds = static_cast<f32>(count) * static_cast<f32>(SAMPLE_PERIOD_MS) / 1000.0f;
             f32 bits_per_second = static_cast<f32>(total_bits) / window_seconds;
-            return (bits_per_second / static_cast<f32>(CAN_BITRATE)) * 100.0f;
+            return (bits_per_second / static_cast<f32>(bitrate_)) * 100.0f;
         }
 
         void reset() noexcept {
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <agrobus/net/error.hpp>
+#include <agrobus/net/types.hpp>
+#include <datapod/datapod.hpp>
+#include <linux/can.h>
+#include <linux/can/error.h>
+#include <linux/can/raw.h>
+#include <sys/socket.h>
+
+namespace agrobus::net {
+
+    // ─── CAN controller state (ISO 11898-1 fault confinement) ────────────────────
+    enum class CanBusState : u8 {
+        ErrorActive,  // Normal operation
+        ErrorWarning, // An error counter passed 96
+        ErrorPassive, // An error counter passed 127: no active error flags
+        BusOff        // TEC passed 255: the controller is off the bus until restarted
+    };
+
+    // ─── Per-port CAN error statistics ───────────────────────────────────────────
+    // Filled from SocketCAN error frames (CAN_ERR_FLAG), which the driver only
+    // sends on sockets that asked for them (can_errors::enable).
+    struct CanErrorStats {
+        CanBusState state = CanBusState::ErrorActive;
+        u8 tx_error_counter = 0; // TEC/REC as last reported (CAN_ERR_CNT)
+        u8 rx_error_counter = 0;
+        u64 error_frames = 0;
+        u64 bus_off = 0; // Times the controller went bus-off
+        u64 restarts = 0;
+        u64 arbitration_lost = 0;
+        u64 protocol_errors = 0; // Bit, stuff, form and CRC errors
+        u64 no_ack = 0;
+        u64 tx_timeouts = 0;
+        u64 rx_overflows = 0;
+        u64 tx_overflows = 0;
+        u64 transceiver_errors = 0;
+        u64 last_error_us = 0;
+        u64 state_since_us = 0;
+        u64 bus_off_us = 0; // Total time spent bus-off, up to the last recovery
+    };
+
+    namespace can_errors {
+
+        // Error classes worth reporting to the stack
+        inline constexpr can_err_mask_t DEFAULT_MASK = CAN_ERR_TX_TIMEOUT | CAN_ERR_LOSTARB | CAN_ERR_CRTL |
+                                                       CAN_ERR_PROT | CAN_ERR_TRX | CAN_ERR_ACK | CAN_ERR_BUSOFF |
+                                                       CAN_ERR_BUSERROR | CAN_ERR_RESTARTED | CAN_ERR_CNT;
+
+        // Ask the driver for error frames on a CAN_RAW socket. Bus errors
+        // (CAN_ERR_PROT/BUSERROR) also need `ip link set canX type can
+        // berr-reporting on`; a quick restart needs `restart-ms`.
+        inline Result<void> enable(int fd, can_err_mask_t mask = DEFAULT_MASK) {
+            if (::setsockopt(fd, SOL_CAN_RAW, CAN_RAW_ERR_FILTER, &mask, sizeof(mask)) < 0)
+                return Result<void>::err(Error(ErrorCode::DriverError, "CAN_RAW_ERR_FILTER failed"));
+            return {};
+        }
+
+        // Move to `state`, keeping the bus-off count and time; true if it changed
+        inline bool set_state(CanErrorStats &stats, CanBusState state, u64 now_us) noexcept {
+            if (state == stats.state)
+                return false;
+            if (stats.state == CanBusState::BusOff && now_us > stats.state_since_us)
+                stats.bus_off_us += now_us - stats.state_since_us;
+            if (state == CanBusState::BusOff)
+                ++stats.bus_off;
+            stats.state = state;
+            stats.state_since_us = now_us;
+            return true;
+        }
+
+        // Count one error frame (`data` holds its 8 bytes) into `stats`.
+        // Returns true when the controller state changed.
+        inline bool apply(CanErrorStats &stats, u32 can_id, const u8 *data, u64 now_us) noexcept {
+            ++stats.error_frames;
+            stats.last_error_us = now_us;
+            if (can_id & CAN_ERR_TX_TIMEOUT)
+                ++stats.tx_timeouts;
+            if (can_id & CAN_ERR_LOSTARB)
+                ++stats.arbitration_lost;
+            if (can_id & CAN_ERR_PROT)
+                ++stats.protocol_errors;
+            if (can_id & CAN_ERR_ACK)
+                ++stats.no_ack;
+            if (can_id & CAN_ERR_TRX)
+                ++stats.transceiver_errors;
+            if (can_id & CAN_ERR_CNT) {
+                stats.tx_error_counter = data[6];
+                stats.rx_error_counter = data[7];
+            }
+
+            CanBusState next = stats.state;
+            if (can_id & CAN_ERR_CRTL) {
+                u8 ctrl = data[1];
+                if (ctrl & CAN_ERR_CRTL_RX_OVERFLOW)
+                    ++stats.rx_overflows;
+                if (ctrl & CAN_ERR_CRTL_TX_OVERFLOW)
+                    ++stats.tx_overflows;
+                if (ctrl & (CAN_ERR_CRTL_RX_PASSIVE | CAN_ERR_CRTL_TX_PASSIVE))
+                    next = CanBusState::ErrorPassive;
+                else if (ctrl & (CAN_ERR_CRTL_RX_WARNING | CAN_ERR_CRTL_TX_WARNING))
+                    next = CanBusState::ErrorWarning;
+                else if (ctrl & CAN_ERR_CRTL_ACTIVE)
+                    next = CanBusState::ErrorActive;
+            }
+            if (can_id & CAN_ERR_RESTARTED) {
+                ++stats.restarts;
+                next = CanBusState::ErrorActive;
+            }
+            if (can_id & CAN_ERR_BUSOFF)
+                next = CanBusState::BusOff;
+            return set_state(stats, next, now_us);
+        }
+
+    } // namespace can_errors
+
+} // namespace agrobus::net
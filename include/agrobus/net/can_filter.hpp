@@ -0,0 +1,120 @@
+#pragma once
+
+#include <agrobus/net/error.hpp>
+#include <agrobus/net/types.hpp>
+#include <datapod/datapod.hpp>
+#include <linux/can.h>
+
+#ifndef NO_HARDWARE
+#include <linux/can/raw.h>
+#include <sys/socket.h>
+#endif
+
+namespace agrobus::net {
+
+    // ─── Kernel-side CAN acceptance filters ──────────────────────────────────────
+    // Builds a CAN_RAW_FILTER set (struct can_filter) for 29-bit ISOBUS traffic.
+    // Identifier layout: priority [26..28], EDP [25], DP [24], PF [16..23],
+    // PS [8..15], SA [0..7]. Priority is never matched.
+    //   - PDU2 PGN (PF >= 240): match the full 18-bit PGN
+    //   - PDU1 PGN (PF < 240):  match EDP/DP/PF, plus PS against each destination
+    //     (no destinations = any destination)
+    //   - source: match frames sent from an address
+    class CanFilterBuilder {
+        static constexpr u32 PGN_MASK = 0x3FFFFu << 8;
+        static constexpr u32 PDU1_PF_MASK = 0x3FFu << 16;
+        static constexpr u32 PS_MASK = 0xFFu << 8;
+        static constexpr u32 SA_MASK = 0xFFu;
+
+        dp::Vector<can_filter> filters_;
+        bool accept_all_ = false;
+
+      public:
+        // Disable filtering (a single pass-everything extended-frame filter)
+        CanFilterBuilder &accept_all() {
+            accept_all_ = true;
+            return *this;
+        }
+
+        CanFilterBuilder &pgn(PGN pgn, const dp::Vector<Address> &destinations = {}) {
+            u8 pf = static_cast<u8>((pgn >> 8) & 0xFF);
+            if (pf >= 240) {
+                add((pgn & 0x3FFFF) << 8, PGN_MASK);
+                return *this;
+            }
+            u32 id = (pgn & 0x3FF00) << 8;
+            if (destinations.empty()) {
+                add(id, PDU1_PF_MASK);
+                return *this;
+            }
+            for (Address dst : destinations)
+                add(id | (static_cast<u32>(dst) << 8), PDU1_PF_MASK | PS_MASK);
+            return *this;
+        }
+
+        CanFilterBuilder &source(Address src) {
+            add(src, SA_MASK);
+            return *this;
+        }
+
+        bool accepts_all() const noexcept { return accept_all_; }
+
+        dp::Vector<can_filter> build() const {
+            if (accept_all_) {
+                dp::Vector<can_filter> all;
+                all.push_back(can_filter{CAN_EFF_FLAG, CAN_EFF_FLAG | CAN_RTR_FLAG});
+                return all;
+            }
+            return filters_;
+        }
+
+        // True if a frame with this (29-bit) identifier passes the built set
+        static bool matches(const dp::Vector<can_filter> &filters, u32 id) noexcept {
+            u32 can_id = id | CAN_EFF_FLAG;
+            for (const auto &f : filters) {
+                if ((can_id & f.can_mask) == (f.can_id & f.can_mask))
+                    return true;
+            }
+            return false;
+        }
+
+      private:
+        void add(u32 id, u32 mask) {
+            can_filter f{id | CAN_EFF_FLAG, mask | CAN_EFF_FLAG | CAN_RTR_FLAG};
+            for (const auto &e : filters_) {
+                if (e.can_id == f.can_id && e.can_mask == f.can_mask)
+                    return;
+            }
+            filters_.push_back(f);
+        }
+    };
+
+    inline bool same_can_filters(const dp::Vector<can_filter> &a, const dp::Vector<can_filter> &b) noexcept {
+        if (a.size() != b.size())
+            return false;
+        for (usize i = 0; i < a.size(); ++i) {
+            if (a[i].can_id != b[i].can_id || a[i].can_mask != b[i].can_mask)
+                return false;
+        }
+        return true;
+    }
+
+    // Install a filter set on a raw SocketCAN socket
+    inline Result<void> apply_can_filters(int fd, const dp::Vector<can_filter> &filters) {
+#ifdef NO_HARDWARE
+        (void)fd;
+        (void)filters;
+        return Result<void>::err(Error::invalid_state("no hardware support (NO_HARDWARE defined)"));
+#else
+        if (fd < 0) {
+            return Result<void>::err(Error::invalid_state("invalid socket"));
+        }
+        auto size = static_cast<socklen_t>(filters.size() * sizeof(can_filter));
+        if (setsockopt(fd, SOL_CAN_RAW, CAN_RAW_FILTER, filters.empty() ? nullptr : filters.data(), size) != 0) {
+            return Result<void>::err(Error(ErrorCode::DriverError, "setsockopt(CAN_RAW_FILTER) failed"));
+        }
+        return {};
+#endif
+    }
+
+} // namespace agrobus::net
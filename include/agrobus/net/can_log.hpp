@@ -0,0 +1,499 @@
+#pragma once
+
+#include <agrobus/net/capture.hpp>
+#include <agrobus/net/eth_can.hpp>
+#include <agrobus/net/error.hpp>
+#include <agrobus/net/types.hpp>
+#include <cstring>
+#include <echo/echo.hpp>
+#include <fcntl.h>
+#include <string_view>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <wirebit/can/can_endpoint.hpp>
+
+namespace agrobus::net {
+
+    // ─── Log formats ─────────────────────────────────────────────────────────────
+    enum class CanLogFormat : u8 {
+        Unknown,
+        Candump, // candump -l: "(1436509052.249713) can0 18FEF128#0102030405060708"
+        Asc,     // Vector ASCII: "0.015991 1 18FEF128x Rx d 8 01 02 03 04 05 06 07 08"
+        Blf      // Vector binary logging format
+    };
+
+    // ─── CanLogReader: streaming import of field logs ────────────────────────────
+    // Maps a candump, ASC or BLF file and hands out its 29-bit data frames one
+    // at a time as capture records, parsing in place: no allocation per line or
+    // object. Ports come from the candump interface (in order of appearance)
+    // or the ASC/BLF channel (1-based in the file, 0-based here). Standard,
+    // remote, FD and error-event lines are counted in skipped().
+    //
+    // BLF logs keep their objects in log containers. Uncompressed containers
+    // are read; zlib-compressed ones are counted in compressed_skipped() - save
+    // such a log uncompressed (or convert it to ASC) first.
+    //
+    //   CanLogReader log;
+    //   log.open("field.asc");
+    //   log.convert(writer);              // Into a capture for CaptureReplay
+    //   nm.set_endpoint(0, &log.can_endpoint()); // Or straight into the stack
+    //   nm.set_rx_source(0, log.rx_source());
+    class CanLogReader {
+        static constexpr u32 BLF_CONTAINER = 10;
+        static constexpr u32 BLF_CAN_MESSAGE = 1;
+        static constexpr u32 BLF_CAN_MESSAGE2 = 86;
+        static constexpr usize BLF_OBJECT_HEADER = 16;
+        static constexpr usize MAX_INTERFACES = 8;
+
+        int fd_ = -1;
+        const char *map_ = nullptr;
+        usize size_ = 0;
+        usize pos_ = 0;
+        CanLogFormat format_ = CanLogFormat::Unknown;
+
+        // candump interface names (views into the mapping)
+        dp::Array<std::string_view, MAX_INTERFACES> interfaces_{};
+        usize interface_count_ = 0;
+        // ASC "base dec"
+        bool asc_decimal_ = false;
+        // BLF container contents, reused between containers
+        dp::Vector<u8> carry_;
+        usize carry_pos_ = 0;
+
+        u64 frames_ = 0;
+        u64 skipped_ = 0;
+        u64 compressed_skipped_ = 0;
+        u64 last_timestamp_us_ = 0;
+
+        std::shared_ptr<CanTunnelLink<CanLogReader>> link_;
+        wirebit::CanEndpoint can_ep_;
+
+      public:
+        CanLogReader()
+            : link_(std::make_shared<CanTunnelLink<CanLogReader>>(this, "can_log")),
+              can_ep_(std::static_pointer_cast<wirebit::Link>(link_), wirebit::CanConfig{.bitrate = 250000}, 0) {}
+        ~CanLogReader() { close(); }
+
+        CanLogReader(const CanLogReader &) = delete;
+        CanLogReader &operator=(const CanLogReader &) = delete;
+
+        Result<void> open(const dp::String &path) {
+            close();
+            fd_ = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+            if (fd_ < 0)
+                return Result<void>::err(Error(ErrorCode::DriverError, "cannot open log file"));
+            struct stat st {};
+            if (::fstat(fd_, &st) < 0 || st.st_size <= 0) {
+                close();
+                return Result<void>::err(Error::invalid_state("empty log file"));
+            }
+            size_ = static_cast<usize>(st.st_size);
+            void *m = ::mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd_, 0);
+            if (m == MAP_FAILED) {
+                close();
+                return Result<void>::err(Error(ErrorCode::DriverError, "mmap failed"));
+            }
+            ::madvise(m, size_, MADV_SEQUENTIAL);
+            map_ = static_cast<const char *>(m);
+            format_ = detect();
+            if (format_ == CanLogFormat::Unknown) {
+                close();
+                return Result<void>::err(Error::invalid_state("unknown log format"));
+            }
+            rewind();
+            return {};
+        }
+
+        void close() {
+            if (map_)
+                ::munmap(const_cast<char *>(map_), size_);
+            map_ = nullptr;
+            size_ = 0;
+            format_ = CanLogFormat::Unknown;
+            if (fd_ >= 0) {
+                ::close(fd_);
+                fd_ = -1;
+            }
+        }
+
+        void rewind() {
+            pos_ = 0;
+            interface_count_ = 0;
+            asc_decimal_ = false;
+            carry_.clear();
+            carry_pos_ = 0;
+            frames_ = skipped_ = compressed_skipped_ = 0;
+            if (format_ == CanLogFormat::Blf)
+                pos_ = read_u32(map_ + 4); // File header size
+        }
+
+        CanLogFormat format() const noexcept { return format_; }
+
+        // Next data frame; false at the end of the log
+        bool next(CaptureRecord &r) {
+            bool ok = false;
+            switch (format_) {
+            case CanLogFormat::Candump:
+                ok = next_candump(r);
+                break;
+            case CanLogFormat::Asc:
+                ok = next_asc(r);
+                break;
+            case CanLogFormat::Blf:
+                ok = next_blf(r);
+                break;
+            default:
+                break;
+            }
+            if (ok) {
+                ++frames_;
+                last_timestamp_us_ = r.timestamp_us;
+            }
+            return ok;
+        }
+
+        // Append the rest of the log to a capture
+        u64 convert(CaptureWriter &writer) {
+            CaptureRecord r;
+            u64 n = 0;
+            while (next(r)) {
+                can_frame cf = {};
+                cf.can_id = r.can_id;
+                cf.can_dlc = r.dlc;
+                std::memcpy(cf.data, r.data, 8);
+                writer.write(cf, r.timestamp_us, r.port, r.flags);
+                ++n;
+            }
+            return n;
+        }
+
+        // ─── Direct feed ─────────────────────────────────────────────────────────
+        // The log as a receive-only CAN endpoint, played as fast as it is
+        // pulled; pair with set_rx_clock([&] { return log.last_timestamp_us(); })
+        wirebit::CanEndpoint &can_endpoint() noexcept { return can_ep_; }
+
+        std::function<bool(can_frame &)> rx_source() {
+            return [this](can_frame &cf) { return pop_can(cf); };
+        }
+
+        bool pop_can(can_frame &cf) {
+            CaptureRecord r;
+            if (!next(r))
+                return false;
+            cf = {};
+            cf.can_id = r.can_id | CAN_EFF_FLAG;
+            cf.can_dlc = r.dlc;
+            std::memcpy(cf.data, r.data, 8);
+            return true;
+        }
+
+        void send_can(const can_frame &) {} // Receive-only
+        u32 rx_pending() const noexcept { return pos_ < size_ || carry_pos_ < carry_.size() ? 1 : 0; }
+
+        u64 frames() const noexcept { return frames_; }
+        u64 skipped() const noexcept { return skipped_; }
+        u64 compressed_skipped() const noexcept { return compressed_skipped_; }
+        u64 last_timestamp_us() const noexcept { return last_timestamp_us_; }
+
+      private:
+        CanLogFormat detect() const noexcept {
+            if (size_ >= 8 && std::memcmp(map_, "LOGG", 4) == 0)
+                return CanLogFormat::Blf;
+            usize i = 0;
+            while (i < size_ && (map_[i] == ' ' || map_[i] == '\t' || map_[i] == '\r' || map_[i] == '\n'))
+                ++i;
+            if (i < size_ && map_[i] == '(')
+                return CanLogFormat::Candump;
+            if (size_ - i >= 4 && (std::memcmp(map_ + i, "date", 4) == 0 || std::memcmp(map_ + i, "base", 4) == 0))
+                return CanLogFormat::Asc;
+            return CanLogFormat::Unknown;
+        }
+
+        // ─── Text scanning ───────────────────────────────────────────────────────
+        struct Cursor {
+            const char *p;
+            const char *end;
+
+            void skip_space() noexcept {
+                while (p < end && (*p == ' ' || *p == '\t'))
+                    ++p;
+            }
+            std::string_view token() noexcept {
+                skip_space();
+                const char *s = p;
+                while (p < end && *p != ' ' && *p != '\t')
+                    ++p;
+                return {s, static_cast<usize>(p - s)};
+            }
+        };
+
+        // One line without its terminator, advancing past it
+        bool next_line(Cursor &line) noexcept {
+            if (pos_ >= size_)
+                return false;
+            const char *s = map_ + pos_;
+            const char *nl = static_cast<const char *>(std::memchr(s, '\n', size_ - pos_));
+            const char *e = nl ? nl : map_ + size_;
+            pos_ = static_cast<usize>(e - map_) + (nl ? 1 : 0);
+            if (e > s && e[-1] == '\r')
+                --e;
+            line = {s, e};
+            return true;
+        }
+
+        static i32 hex_digit(char c) noexcept {
+            if (c >= '0' && c <= '9')
+                return c - '0';
+            if (c >= 'a' && c <= 'f')
+                return c - 'a' + 10;
+            if (c >= 'A' && c <= 'F')
+                return c - 'A' + 10;
+            return -1;
+        }
+
+        static bool parse_uint(std::string_view s, u32 base, u64 &out) noexcept {
+            if (s.empty())
+                return false;
+            u64 v = 0;
+            for (char c : s) {
+                i32 d = base == 16 ? hex_digit(c) : (c >= '0' && c <= '9' ? c - '0' : -1);
+                if (d < 0)
+                    return false;
+                v = v * base + static_cast<u64>(d);
+            }
+            out = v;
+            return true;
+        }
+
+        // "seconds.fraction" to µs (fraction padded or cut to six digits)
+        static bool parse_seconds(std::string_view s, u64 &us) noexcept {
+            usize dot = s.find('.');
+            u64 whole = 0;
+            if (!parse_uint(s.substr(0, dot), 10, whole))
+                return false;
+            u64 frac = 0;
+            u32 digits = 0;
+            if (dot != std::string_view::npos) {
+                for (usize i = dot + 1; i < s.size() && digits < 6; ++i, ++digits) {
+                    if (s[i] < '0' || s[i] > '9')
+                        return false;
+                    frac = frac * 10 + static_cast<u64>(s[i] - '0');
+                }
+            }
+            for (; digits < 6; ++digits)
+                frac *= 10;
+            us = whole * 1000000 + frac;
+            return true;
+        }
+
+        // ─── candump -l ──────────────────────────────────────────────────────────
+        bool next_candump(CaptureRecord &r) {
+            Cursor line{};
+            while (next_line(line)) {
+                line.skip_space();
+                if (line.p >= line.end || *line.p != '(')
+                    continue;
+                std::string_view ts = line.token();
+                std::string_view iface = line.token();
+                std::string_view frame = line.token();
+                if (ts.size() < 3 || ts.back() != ')' || !parse_seconds(ts.substr(1, ts.size() - 2), r.timestamp_us)) {
+                    ++skipped_;
+                    continue;
+                }
+                usize hash = frame.find('#');
+                u64 id = 0;
+                // Only 29-bit data frames: 8 hex digits, no FD (##) or remote (#R)
+                if (hash != 8 || !parse_uint(frame.substr(0, 8), 16, id) || frame.substr(hash + 1).find('#') == 0 ||
+                    (frame.size() > 9 && (frame[9] == 'R' || frame[9] == 'r'))) {
+                    ++skipped_;
+                    continue;
+                }
+                std::string_view hex = frame.substr(9);
+                if (hex.size() % 2 != 0 || hex.size() > 16) {
+                    ++skipped_;
+                    continue;
+                }
+                r.can_id = static_cast<u32>(id) & CAN_EFF_MASK;
+                r.flags = (id & CAN_ERR_FLAG) ? capture_flags::ERROR : 0;
+                r.port = interface_port(iface);
+                r.dlc = static_cast<u8>(hex.size() / 2);
+                r.reserved = 0;
+                std::memset(r.data, 0, 8);
+                for (u8 i = 0; i < r.dlc; ++i)
+                    r.data[i] = static_cast<u8>(hex_digit(hex[2 * i]) << 4 | hex_digit(hex[2 * i + 1]));
+                return true;
+            }
+            return false;
+        }
+
+        u8 interface_port(std::string_view name) noexcept {
+            for (usize i = 0; i < interface_count_; ++i) {
+                if (interfaces_[i] == name)
+                    return static_cast<u8>(i);
+            }
+            if (interface_count_ == MAX_INTERFACES)
+                return static_cast<u8>(MAX_INTERFACES - 1);
+            interfaces_[interface_count_] = name;
+            return static_cast<u8>(interface_count_++);
+        }
+
+        // ─── Vector ASC ──────────────────────────────────────────────────────────
+        bool next_asc(CaptureRecord &r) {
+            Cursor line{};
+            while (next_line(line)) {
+                std::string_view first = line.token();
+                if (first.empty())
+                    continue;
+                if (first == "base") {
+                    asc_decimal_ = line.token() == "dec";
+                    continue;
+                }
+                if (first[0] < '0' || first[0] > '9')
+                    continue; // date, comments, Begin/End Triggerblock
+                if (!parse_seconds(first, r.timestamp_us))
+                    continue;
+                std::string_view channel = line.token();
+                std::string_view id_tok = line.token();
+                u64 ch = 0;
+                // "1 18FEF128x Rx d 8 ..." - anything else is an event (ErrorFrame, Statistic, CANFD, ...)
+                if (!parse_uint(channel, 10, ch) || id_tok.size() < 2 || id_tok.back() != 'x') {
+                    ++skipped_;
+                    continue;
+                }
+                u64 id = 0;
+                std::string_view dir = line.token();
+                std::string_view type = line.token();
+                u64 dlc = 0;
+                if (!parse_uint(id_tok.substr(0, id_tok.size() - 1), asc_decimal_ ? 10 : 16, id) || type != "d" ||
+                    !parse_uint(line.token(), 10, dlc) || dlc > 8) {
+                    ++skipped_;
+                    continue;
+                }
+                r.can_id = static_cast<u32>(id) & CAN_EFF_MASK;
+                r.port = static_cast<u8>(ch > 0 ? ch - 1 : 0);
+                r.flags = dir == "Tx" ? capture_flags::TX : 0;
+                r.dlc = static_cast<u8>(dlc);
+                r.reserved = 0;
+                std::memset(r.data, 0, 8);
+                bool ok = true;
+                for (u8 i = 0; i < r.dlc && ok; ++i) {
+                    u64 b = 0;
+                    ok = parse_uint(line.token(), asc_decimal_ ? 10 : 16, b) && b <= 0xFF;
+                    r.data[i] = static_cast<u8>(b);
+                }
+                if (!ok) {
+                    ++skipped_;
+                    continue;
+                }
+                return true;
+            }
+            return false;
+        }
+
+        // ─── BLF ─────────────────────────────────────────────────────────────────
+        static u16 read_u16(const void *p) noexcept {
+            u16 v;
+            std::memcpy(&v, p, 2);
+            return v;
+        }
+        static u32 read_u32(const void *p) noexcept {
+            u32 v;
+            std::memcpy(&v, p, 4);
+            return v;
+        }
+        static u64 read_u64(const void *p) noexcept {
+            u64 v;
+            std::memcpy(&v, p, 8);
+            return v;
+        }
+
+        bool next_blf(CaptureRecord &r) {
+            while (true) {
+                // Objects inside the current container contents
+                while (carry_.size() - carry_pos_ >= BLF_OBJECT_HEADER) {
+                    const u8 *obj = carry_.data() + carry_pos_;
+                    if (std::memcmp(obj, "LOBJ", 4) != 0) {
+                        carry_pos_ = carry_.size(); // Lost sync: drop the rest
+                        break;
+                    }
+                    u32 size = read_u32(obj + 8);
+                    if (size < BLF_OBJECT_HEADER || size > carry_.size() - carry_pos_)
+                        break; // Continues in the next container
+                    carry_pos_ += size + size % 4;
+                    if (carry_pos_ > carry_.size())
+                        carry_pos_ = carry_.size();
+                    if (blf_object(obj, size, r))
+                        return true;
+                }
+
+                // Next object in the file
+                if (pos_ + BLF_OBJECT_HEADER > size_)
+                    return false;
+                const u8 *obj = reinterpret_cast<const u8 *>(map_ + pos_);
+                if (std::memcmp(obj, "LOBJ", 4) != 0)
+                    return false;
+                u32 size = read_u32(obj + 8);
+                if (size < BLF_OBJECT_HEADER || size > size_ - pos_)
+                    return false;
+                pos_ += size + size % 4;
+                if (read_u32(obj + 12) != BLF_CONTAINER) {
+                    if (blf_object(obj, size, r))
+                        return true;
+                    continue;
+                }
+                // Container: u16 compression, 6 reserved, u32 uncompressed size, 4 reserved, then the data
+                if (size < BLF_OBJECT_HEADER + 16)
+                    continue;
+                if (read_u16(obj + BLF_OBJECT_HEADER) != 0) {
+                    if (compressed_skipped_++ == 0)
+                        echo::category("isobus.can_log").warn("compressed BLF containers are not supported");
+                    continue;
+                }
+                // Keep the unread tail (an object split across containers) and append
+                usize tail = carry_.size() - carry_pos_;
+                for (usize i = 0; i < tail; ++i)
+                    carry_[i] = carry_[carry_pos_ + i];
+                carry_.resize(tail);
+                carry_pos_ = 0;
+                const u8 *data = obj + BLF_OBJECT_HEADER + 16;
+                usize n = size - BLF_OBJECT_HEADER - 16;
+                carry_.resize(tail + n);
+                std::memcpy(carry_.data() + tail, data, n);
+            }
+        }
+
+        bool blf_object(const u8 *obj, u32 size, CaptureRecord &r) noexcept {
+            u16 header_size = read_u16(obj + 4);
+            u16 header_version = read_u16(obj + 6);
+            u32 type = read_u32(obj + 12);
+            if (type != BLF_CAN_MESSAGE && type != BLF_CAN_MESSAGE2)
+                return false;
+            // Header v1 and v2 both keep flags at 16 and the timestamp at 24
+            if ((header_version != 1 && header_version != 2) || header_size < 32 || size < header_size + 16u) {
+                ++skipped_;
+                return false;
+            }
+            u32 flags = read_u32(obj + 16);
+            u64 ts = read_u64(obj + 24);
+            const u8 *body = obj + header_size;
+            u16 channel = read_u16(body);
+            u8 msg_flags = body[2];
+            u8 dlc = body[3];
+            u32 id = read_u32(body + 4);
+            if (!(id & 0x80000000u) || (msg_flags & 0x80) || dlc > 8) {
+                ++skipped_; // Standard or remote frame
+                return false;
+            }
+            r.timestamp_us = flags == 1 ? ts * 10 : ts / 1000; // 10 µs or 1 ns units
+            r.can_id = id & CAN_EFF_MASK;
+            r.port = static_cast<u8>(channel > 0 ? channel - 1 : 0);
+            r.flags = (msg_flags & 0x01) ? capture_flags::TX : 0;
+            r.dlc = dlc;
+            r.reserved = 0;
+            std::memcpy(r.data, body + 8, 8);
+            return true;
+        }
+    };
+
+} // namespace agrobus::net
@@ -0,0 +1,393 @@
+#pragma once
+
+#include <agrobus/net/error.hpp>
+#include <agrobus/net/eth_can.hpp>
+#include <agrobus/net/frame.hpp>
+#include <agrobus/net/types.hpp>
+#include <chrono>
+#include <cstring>
+#include <echo/echo.hpp>
+#include <fcntl.h>
+#include <functional>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <wirebit/can/can_endpoint.hpp>
+
+namespace agrobus::net {
+
+    // ─── Bus capture format ──────────────────────────────────────────────────────
+    // Append-only and memory-mappable:
+    //   [CaptureFileHeader (32)] [CaptureRecord (24)] × N [block index] [CaptureFooter (16)]
+    // Records have a fixed size, so record i is at a computed offset. The block
+    // index holds the first timestamp of every block_frames records, written by
+    // close(); a capture cut short (power loss) has no footer and the reader
+    // rebuilds the index from the records.
+    inline constexpr u8 CAPTURE_MAGIC[8] = {'A', 'G', 'B', 'C', 'A', 'P', '0', '1'};
+    inline constexpr u8 CAPTURE_INDEX_MAGIC[8] = {'A', 'G', 'B', 'I', 'D', 'X', '0', '1'};
+
+    namespace capture_flags {
+        inline constexpr u8 TX = 0x01;    // Sent by the capturing node
+        inline constexpr u8 ERROR = 0x02; // Error frame
+    } // namespace capture_flags
+
+    struct CaptureFileHeader {
+        u8 magic[8];
+        u32 version = 1;
+        u32 record_size = 24;
+        u32 block_frames = 4096;
+        u32 reserved = 0;
+        u64 start_us = 0; // Host time when the capture started
+    };
+    static_assert(sizeof(CaptureFileHeader) == 32);
+
+    struct CaptureRecord {
+        u64 timestamp_us;
+        u32 can_id; // 29-bit identifier
+        u8 port;
+        u8 flags; // capture_flags
+        u8 dlc;
+        u8 reserved;
+        u8 data[8];
+
+        Frame frame() const noexcept {
+            Frame f;
+            f.id = Identifier(can_id);
+            f.length = dlc > 8 ? 8 : dlc;
+            for (u8 i = 0; i < 8; ++i)
+                f.data[i] = data[i];
+            f.timestamp_us = timestamp_us;
+            return f;
+        }
+    };
+    static_assert(sizeof(CaptureRecord) == 24);
+
+    struct CaptureFooter {
+        u64 blocks;
+        u8 magic[8];
+    };
+    static_assert(sizeof(CaptureFooter) == 16);
+
+    // ─── Capture writer ──────────────────────────────────────────────────────────
+    // Buffers records and writes them out in large chunks; a few hundred
+    // nanoseconds per frame at most. Typical hookup:
+    //   nm.on_frame_received.subscribe([&](const Frame &f, u8 port) { cap.write(f, port); });
+    class CaptureWriter {
+        static constexpr usize BUFFER_RECORDS = 8192;
+
+        int fd_ = -1;
+        CaptureFileHeader header_{};
+        dp::Vector<CaptureRecord> buffer_;
+        dp::Vector<u64> index_;
+        u64 count_ = 0;
+        bool failed_ = false;
+
+      public:
+        CaptureWriter() { buffer_.reserve(BUFFER_RECORDS); }
+        ~CaptureWriter() { close(); }
+
+        CaptureWriter(const CaptureWriter &) = delete;
+        CaptureWriter &operator=(const CaptureWriter &) = delete;
+
+        Result<void> open(const dp::String &path, u32 block_frames = 4096) {
+            close();
+            fd_ = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+            if (fd_ < 0)
+                return Result<void>::err(Error(ErrorCode::DriverError, "cannot create capture file"));
+            header_ = {};
+            std::memcpy(header_.magic, CAPTURE_MAGIC, 8);
+            header_.block_frames = block_frames == 0 ? 1 : block_frames;
+            header_.start_us = static_cast<u64>(std::chrono::duration_cast<std::chrono::microseconds>(
+                                                    std::chrono::steady_clock::now().time_since_epoch())
+                                                    .count());
+            index_.clear();
+            count_ = 0;
+            failed_ = false;
+            write_all(&header_, sizeof(header_));
+            return failed_ ? Result<void>::err(Error(ErrorCode::DriverError, "capture write failed")) : Result<void>{};
+        }
+
+        void write(const Frame &frame, u8 port = 0, u8 flags = 0) {
+            CaptureRecord r;
+            r.timestamp_us = frame.timestamp_us;
+            r.can_id = frame.id.raw;
+            r.port = port;
+            r.flags = flags;
+            r.dlc = frame.length;
+            r.reserved = 0;
+            std::memcpy(r.data, frame.data.data(), 8);
+            append(r);
+        }
+
+        void write(const can_frame &cf, u64 timestamp_us, u8 port = 0, u8 flags = 0) {
+            CaptureRecord r;
+            r.timestamp_us = timestamp_us;
+            r.can_id = cf.can_id & CAN_EFF_MASK;
+            r.port = port;
+            r.flags = flags;
+            r.dlc = cf.can_dlc;
+            r.reserved = 0;
+            std::memcpy(r.data, cf.data, 8);
+            append(r);
+        }
+
+        void flush() {
+            if (fd_ < 0 || buffer_.empty())
+                return;
+            write_all(buffer_.data(), buffer_.size() * sizeof(CaptureRecord));
+            buffer_.clear();
+        }
+
+        // Flush, append the block index and close
+        void close() {
+            if (fd_ < 0)
+                return;
+            flush();
+            write_all(index_.data(), index_.size() * sizeof(u64));
+            CaptureFooter footer{index_.size(), {}};
+            std::memcpy(footer.magic, CAPTURE_INDEX_MAGIC, 8);
+            write_all(&footer, sizeof(footer));
+            ::close(fd_);
+            fd_ = -1;
+        }
+
+        u64 frames() const noexcept { return count_; }
+        bool failed() const noexcept { return failed_; }
+        bool is_open() const noexcept { return fd_ >= 0; }
+
+      private:
+        void append(const CaptureRecord &r) {
+            if (fd_ < 0)
+                return;
+            if (count_ % header_.block_frames == 0)
+                index_.push_back(r.timestamp_us);
+            ++count_;
+            buffer_.push_back(r);
+            if (buffer_.size() >= BUFFER_RECORDS)
+                flush();
+        }
+
+        void write_all(const void *data, usize size) {
+            const u8 *p = static_cast<const u8 *>(data);
+            while (size > 0 && !failed_) {
+                ssize_t n = ::write(fd_, p, size);
+                if (n <= 0) {
+                    failed_ = true;
+                    echo::category("isobus.capture").error("capture write failed");
+                    return;
+                }
+                p += n;
+                size -= static_cast<usize>(n);
+            }
+        }
+    };
+
+    // ─── Capture reader ──────────────────────────────────────────────────────────
+    // Maps a capture file read-only; records are used in place.
+    class CaptureReader {
+        int fd_ = -1;
+        const u8 *map_ = nullptr;
+        usize size_ = 0;
+        const CaptureFileHeader *header_ = nullptr;
+        const CaptureRecord *records_ = nullptr;
+        u64 count_ = 0;
+        dp::Vector<u64> index_; // First timestamp per block
+
+      public:
+        CaptureReader() = default;
+        ~CaptureReader() { close(); }
+
+        CaptureReader(const CaptureReader &) = delete;
+        CaptureReader &operator=(const CaptureReader &) = delete;
+
+        Result<void> open(const dp::String &path) {
+            close();
+            fd_ = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+            if (fd_ < 0)
+                return Result<void>::err(Error(ErrorCode::DriverError, "cannot open capture file"));
+            struct stat st {};
+            if (::fstat(fd_, &st) < 0 || static_cast<usize>(st.st_size) < sizeof(CaptureFileHeader)) {
+                close();
+                return Result<void>::err(Error::invalid_state("not a capture file"));
+            }
+            size_ = static_cast<usize>(st.st_size);
+            void *m = ::mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd_, 0);
+            if (m == MAP_FAILED) {
+                close();
+                return Result<void>::err(Error(ErrorCode::DriverError, "mmap failed"));
+            }
+            map_ = static_cast<const u8 *>(m);
+            ::madvise(m, size_, MADV_SEQUENTIAL);
+            header_ = reinterpret_cast<const CaptureFileHeader *>(map_);
+            if (std::memcmp(header_->magic, CAPTURE_MAGIC, 8) != 0 || header_->record_size != sizeof(CaptureRecord) ||
+                header_->block_frames == 0) {
+                close();
+                return Result<void>::err(Error::invalid_state("not a capture file"));
+            }
+            records_ = reinterpret_cast<const CaptureRecord *>(map_ + sizeof(CaptureFileHeader));
+            load_index();
+            return {};
+        }
+
+        void close() {
+            if (map_)
+                ::munmap(const_cast<u8 *>(map_), size_);
+            map_ = nullptr;
+            header_ = nullptr;
+            records_ = nullptr;
+            count_ = 0;
+            index_.clear();
+            if (fd_ >= 0) {
+                ::close(fd_);
+                fd_ = -1;
+            }
+        }
+
+        u64 size() const noexcept { return count_; }
+        const CaptureRecord &operator[](u64 i) const noexcept { return records_[i]; }
+        const CaptureRecord *begin() const noexcept { return records_; }
+        const CaptureRecord *end() const noexcept { return records_ + count_; }
+        const CaptureFileHeader &header() const noexcept { return *header_; }
+        usize blocks() const noexcept { return index_.size(); }
+
+        // First record at or after `timestamp_us` (binary search over the block
+        // index, then a scan inside one block)
+        u64 seek(u64 timestamp_us) const noexcept {
+            usize lo = 0;
+            usize hi = index_.size();
+            while (lo < hi) {
+                usize mid = (lo + hi) / 2;
+                if (index_[mid] <= timestamp_us)
+                    lo = mid + 1;
+                else
+                    hi = mid;
+            }
+            u64 i = lo == 0 ? 0 : static_cast<u64>(lo - 1) * header_->block_frames;
+            while (i < count_ && records_[i].timestamp_us < timestamp_us)
+                ++i;
+            return i;
+        }
+
+      private:
+        void load_index() {
+            usize body = size_ - sizeof(CaptureFileHeader);
+            if (size_ >= sizeof(CaptureFileHeader) + sizeof(CaptureFooter)) {
+                CaptureFooter footer;
+                std::memcpy(&footer, map_ + size_ - sizeof(CaptureFooter), sizeof(footer));
+                usize tail = sizeof(CaptureFooter) + footer.blocks * sizeof(u64);
+                if (std::memcmp(footer.magic, CAPTURE_INDEX_MAGIC, 8) == 0 && tail <= body &&
+                    (body - tail) % sizeof(CaptureRecord) == 0) {
+                    count_ = (body - tail) / sizeof(CaptureRecord);
+                    index_.resize(footer.blocks);
+                    std::memcpy(index_.data(), map_ + size_ - tail, footer.blocks * sizeof(u64));
+                    return;
+                }
+            }
+            // No footer: the capture was cut short; rebuild from whole records
+            count_ = body / sizeof(CaptureRecord);
+            for (u64 i = 0; i < count_; i += header_->block_frames)
+                index_.push_back(records_[i].timestamp_us);
+        }
+    };
+
+    // ─── Replay endpoint ─────────────────────────────────────────────────────────
+    // Plays a capture back as a CAN endpoint: in real time, N× faster (speed),
+    // or as fast as the consumer pulls (speed 0). The original timestamps are
+    // available for IsoNet::set_rx_clock(), so the stack sees the recorded
+    // timing whatever the pace:
+    //   CaptureReplay replay(reader, 0.0);
+    //   nm.set_endpoint(0, &replay.can_endpoint());
+    //   nm.set_rx_source(0, replay.rx_source());
+    //   nm.set_rx_clock([&] { return replay.last_timestamp_us(); });
+    class CaptureReplay {
+        const CaptureReader &reader_;
+        double speed_;
+        i32 port_ = -1; // Only records of this port; -1 = all
+        u64 next_ = 0;
+        u64 begin_ = 0;
+        u64 wall_start_us_ = 0;
+        bool started_ = false;
+        u64 last_timestamp_us_ = 0;
+        std::function<u64()> clock_;
+
+        std::shared_ptr<CanTunnelLink<CaptureReplay>> link_;
+        wirebit::CanEndpoint can_ep_;
+
+      public:
+        explicit CaptureReplay(const CaptureReader &reader, double speed = 1.0)
+            : reader_(reader), speed_(speed < 0.0 ? 0.0 : speed),
+              link_(std::make_shared<CanTunnelLink<CaptureReplay>>(this, "capture_replay")),
+              can_ep_(std::static_pointer_cast<wirebit::Link>(link_), wirebit::CanConfig{.bitrate = 250000}, 0) {}
+
+        CaptureReplay(const CaptureReplay &) = delete;
+        CaptureReplay &operator=(const CaptureReplay &) = delete;
+
+        wirebit::CanEndpoint &can_endpoint() noexcept { return can_ep_; }
+
+        std::function<bool(can_frame &)> rx_source() {
+            return [this](can_frame &cf) { return pop_can(cf); };
+        }
+
+        // Replay one port of a multi-port capture
+        void only_port(u8 port) noexcept { port_ = port; }
+
+        // Start (again) at `record`; pacing restarts from the next pull
+        void rewind(u64 record = 0) noexcept {
+            next_ = record;
+            begin_ = record;
+            started_ = false;
+        }
+
+        // Wall clock for the pacing (µs; monotonic host clock by default)
+        void set_clock(std::function<u64()> clock) { clock_ = std::move(clock); }
+
+        bool pop_can(can_frame &cf) {
+            while (next_ < reader_.size()) {
+                const CaptureRecord &r = reader_[next_];
+                if (port_ >= 0 && r.port != port_) {
+                    ++next_;
+                    continue;
+                }
+                if (speed_ > 0.0) {
+                    u64 now = now_us();
+                    if (!started_) {
+                        started_ = true;
+                        wall_start_us_ = now;
+                    }
+                    u64 first = reader_[begin_].timestamp_us;
+                    u64 offset = r.timestamp_us > first ? r.timestamp_us - first : 0;
+                    if (static_cast<double>(now - wall_start_us_) * speed_ < static_cast<double>(offset))
+                        return false; // Not due yet
+                }
+                cf = {};
+                cf.can_id = r.can_id | CAN_EFF_FLAG;
+                cf.can_dlc = r.dlc > 8 ? 8 : r.dlc;
+                std::memcpy(cf.data, r.data, 8);
+                last_timestamp_us_ = r.timestamp_us;
+                ++next_;
+                return true;
+            }
+            return false;
+        }
+
+        void send_can(const can_frame &) {} // Replay is receive-only
+        u32 rx_pending() const noexcept {
+            u64 left = reader_.size() - next_;
+            return left > 0xFFFFFFFFu ? 0xFFFFFFFFu : static_cast<u32>(left);
+        }
+
+        bool done() const noexcept { return next_ >= reader_.size(); }
+        u64 position() const noexcept { return next_; }
+        u64 last_timestamp_us() const noexcept { return last_timestamp_us_; }
+
+      private:
+        u64 now_us() const {
+            if (clock_)
+                return clock_();
+            return static_cast<u64>(std::chrono::duration_cast<std::chrono::microseconds>(
+                                        std::chrono::steady_clock::now().time_since_epoch())
+                                        .count());
+        }
+    };
+
+} // namespace agrobus::net
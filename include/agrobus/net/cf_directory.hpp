@@ -0,0 +1,264 @@
+#pragma once
+
+#include "constants.hpp"
+#include "name.hpp"
+#include "partner_cf.hpp"
+#include "types.hpp"
+#include <datapod/datapod.hpp>
+
+namespace agrobus::net {
+
+    // ─── Address / NAME directory of the CFs an IsoNet owns ──────────────────────
+    // Per-port 256-entry tables map a source address to the internal CF holding
+    // it (and the one preferring it) and to the partner bound to it, so the RX
+    // path answers "is this frame from one of our addresses" with one array
+    // index. A NAME hash maps every NAME we know to its CF, and remembers which
+    // partners a claimed NAME matched so partner filters run once per NAME.
+    // Partners are indexed by their compiled NameMatcher: one hash probe per
+    // distinct filter mask finds every partner a NAME satisfies.
+    //
+    // Entries are slot indices into IsoNet's CF slabs. IsoNet re-syncs an
+    // internal CF after every address claimer step and once per update(), which
+    // also picks up addresses set directly on the CF.
+    class CFDirectory {
+      public:
+        static constexpr u16 NONE = 0xFFFF;
+
+        struct Slot {
+            u16 internal = NONE;  // Internal CF currently at this address
+            u16 preferred = NONE; // Internal CF preferring this address
+            u16 partner = NONE;   // Partner CF bound to the NAME claiming it
+        };
+
+        struct Ref {
+            bool internal = false;
+            u16 index = NONE;
+        };
+
+      private:
+        struct Port {
+            dp::Array<Slot, 256> slots{};
+            dp::Map<u64, dp::Vector<u16>> partner_matches; // NAME → partners whose filters it passes
+        };
+
+        struct Placed {
+            u8 port = 0;
+            Address address = NULL_ADDRESS;
+            Address preferred = NULL_ADDRESS;
+            u64 name = 0;
+        };
+
+        // Partners with the same filter mask on a port, keyed by masked value
+        struct PartnerGroup {
+            u8 port = 0;
+            u64 mask = 0;
+            dp::Map<u64, dp::Vector<u16>> by_value;
+        };
+
+        struct PartnerKey {
+            u8 port = 0;
+            NameMatcher matcher;
+            bool indexed = false;
+        };
+
+        dp::Map<u8, Port> ports_;
+        dp::Map<u64, Ref> by_name_;
+        dp::Vector<PartnerGroup> partner_groups_;
+        dp::Vector<PartnerKey> partner_keys_;
+        dp::Vector<Placed> internals_;
+        dp::Vector<Placed> partners_;
+
+      public:
+        // ─── Lookups ─────────────────────────────────────────────────────────────
+        const Slot &at(u8 port, Address addr) const noexcept {
+            static const Slot empty{};
+            auto it = ports_.find(port);
+            return it != ports_.end() ? it->second.slots[addr] : empty;
+        }
+
+        u16 internal_at(u8 port, Address addr) const noexcept { return at(port, addr).internal; }
+        u16 partner_at(u8 port, Address addr) const noexcept { return at(port, addr).partner; }
+
+        // The port of the internal CF using `addr` on any port, if one does
+        dp::Optional<u8> internal_port(Address addr) const noexcept {
+            for (const auto &[port, table] : ports_) {
+                if (table.slots[addr].internal != NONE)
+                    return port;
+            }
+            return dp::nullopt;
+        }
+
+        dp::Optional<Ref> find(Name name) const noexcept {
+            auto it = by_name_.find(name.raw);
+            if (it == by_name_.end())
+                return dp::nullopt;
+            return it->second;
+        }
+
+        // Partners a NAME matched on a port, once remember_matches() recorded it
+        const dp::Vector<u16> *partner_matches(u8 port, Name name) const noexcept {
+            auto it = ports_.find(port);
+            if (it == ports_.end())
+                return nullptr;
+            auto m = it->second.partner_matches.find(name.raw);
+            return m != it->second.partner_matches.end() ? &m->second : nullptr;
+        }
+
+        // Partners (ascending slot order) whose filters `name` passes on a port
+        dp::Vector<u16> match_partners(u8 port, Name name) const {
+            dp::Vector<u16> out;
+            for (const auto &g : partner_groups_) {
+                if (g.port != port)
+                    continue;
+                auto it = g.by_value.find(name.raw & g.mask);
+                if (it == g.by_value.end())
+                    continue;
+                for (u16 index : it->second) {
+                    usize at = out.size();
+                    out.push_back(index);
+                    for (; at > 0 && out[at - 1] > index; --at)
+                        out[at] = out[at - 1];
+                    out[at] = index;
+                }
+            }
+            return out;
+        }
+
+        // ─── Maintenance ─────────────────────────────────────────────────────────
+        // Record where internal CF `index` is now; returns true if anything moved
+        bool sync_internal(u16 index, u8 port, Address addr, Address preferred, Name name) {
+            if (index >= internals_.size())
+                internals_.resize(index + 1, Placed{port, NO_SLOT, NO_SLOT, ~name.raw});
+            Placed &p = internals_[index];
+            if (p.port == port && p.address == addr && p.preferred == preferred && p.name == name.raw)
+                return false;
+
+            clear(p.port, p.address, &Slot::internal, index);
+            clear(p.port, p.preferred, &Slot::preferred, index);
+            forget_name(p.name, Ref{true, index});
+
+            p = Placed{port, addr, preferred, name.raw};
+            Port &table = ports_[port];
+            if (addr <= MAX_ADDRESS)
+                table.slots[addr].internal = index;
+            if (preferred <= MAX_ADDRESS)
+                table.slots[preferred].preferred = index;
+            by_name_[name.raw] = Ref{true, index};
+            return true;
+        }
+
+        // Record that partner `index` is bound to `name` at `addr`
+        void place_partner(u16 index, u8 port, Address addr, Name name) {
+            if (index >= partners_.size())
+                partners_.resize(index + 1, Placed{port, NO_SLOT, NO_SLOT, 0});
+            Placed &p = partners_[index];
+            clear(p.port, p.address, &Slot::partner, index);
+            if (p.name != name.raw)
+                forget_name(p.name, Ref{false, index});
+
+            p = Placed{port, addr, NULL_ADDRESS, name.raw};
+            if (addr <= MAX_ADDRESS)
+                ports_[port].slots[addr].partner = index;
+            auto it = by_name_.find(name.raw);
+            if (it == by_name_.end())
+                by_name_[name.raw] = Ref{false, index}; // An internal CF keeps its NAME
+        }
+
+        // The CF in slot `index` was removed from the IsoNet
+        void remove_internal(u16 index) {
+            if (index >= internals_.size())
+                return;
+            Placed &p = internals_[index];
+            clear(p.port, p.address, &Slot::internal, index);
+            clear(p.port, p.preferred, &Slot::preferred, index);
+            forget_name(p.name, Ref{true, index});
+            p = Placed{p.port, NO_SLOT, NO_SLOT, ~p.name};
+        }
+
+        // A partner was created in slot `index`
+        void add_partner(u16 index, u8 port, NameMatcher matcher) {
+            if (index >= partner_keys_.size())
+                partner_keys_.resize(index + 1);
+            partner_keys_[index] = PartnerKey{port, matcher, matcher.can_match()};
+            forget_matches();
+            if (!matcher.can_match())
+                return;
+            for (auto &g : partner_groups_) {
+                if (g.port == port && g.mask == matcher.mask) {
+                    g.by_value[matcher.value].push_back(index);
+                    return;
+                }
+            }
+            partner_groups_.push_back(PartnerGroup{port, matcher.mask, {}});
+            partner_groups_.back().by_value[matcher.value].push_back(index);
+        }
+
+        void remove_partner(u16 index) {
+            unindex_partner(index);
+            if (index >= partners_.size())
+                return;
+            Placed &p = partners_[index];
+            clear(p.port, p.address, &Slot::partner, index);
+            forget_name(p.name, Ref{false, index});
+            p = Placed{p.port, NO_SLOT, NO_SLOT, 0};
+            forget_matches();
+        }
+
+        void remember_matches(u8 port, Name name, dp::Vector<u16> partners) {
+            ports_[port].partner_matches[name.raw] = std::move(partners);
+        }
+
+        // A new partner was created: every NAME has to be matched again
+        void forget_matches() {
+            for (auto &[port, table] : ports_)
+                table.partner_matches.clear();
+        }
+
+      private:
+        static constexpr Address NO_SLOT = BROADCAST_ADDRESS;
+
+        void clear(u8 port, Address addr, u16 Slot::*field, u16 index) {
+            if (addr > MAX_ADDRESS)
+                return;
+            auto it = ports_.find(port);
+            if (it != ports_.end() && it->second.slots[addr].*field == index)
+                it->second.slots[addr].*field = NONE;
+        }
+
+        void unindex_partner(u16 index) {
+            if (index >= partner_keys_.size() || !partner_keys_[index].indexed)
+                return;
+            PartnerKey &key = partner_keys_[index];
+            key.indexed = false;
+            for (usize g = 0; g < partner_groups_.size(); ++g) {
+                PartnerGroup &group = partner_groups_[g];
+                if (group.port != key.port || group.mask != key.matcher.mask)
+                    continue;
+                auto it = group.by_value.find(key.matcher.value);
+                if (it == group.by_value.end())
+                    return;
+                auto &list = it->second;
+                for (usize i = 0; i < list.size(); ++i) {
+                    if (list[i] == index) {
+                        list.erase(list.begin() + static_cast<std::ptrdiff_t>(i));
+                        break;
+                    }
+                }
+                if (list.empty())
+                    group.by_value.erase(it);
+                if (group.by_value.empty()) {
+                    partner_groups_[g] = std::move(partner_groups_.back());
+                    partner_groups_.pop_back();
+                }
+                return;
+            }
+        }
+
+        void forget_name(u64 name, Ref ref) {
+            auto it = by_name_.find(name);
+            if (it != by_name_.end() && it->second.internal == ref.internal && it->second.index == ref.index)
+                by_name_.erase(it);
+        }
+    };
+
+} // namespace agrobus::net
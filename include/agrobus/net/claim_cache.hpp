@@ -0,0 +1,99 @@
+#pragma once
+
+#include "constants.hpp"
+#include "data_span.hpp"
+#include "name.hpp"
+#include "name_table.hpp"
+#include "types.hpp"
+#include <datapod/datapod.hpp>
+#include <functional>
+
+namespace agrobus::net {
+
+    // ─── Address claim cache (persisted across key cycles) ──────────────────────
+    // What an internal CF ended up with last time: the address it claimed and
+    // the NAMEs it saw on its port. Restored before start_address_claiming(),
+    // the claim starts at the cached address instead of the preferred one, so
+    // a CF that had to move at the previous key-on does not lose the same
+    // contests again (each costing a 250 ms guard window plus RTxD) before
+    // the VT and TC connections can start.
+    //
+    // encode()/decode() give a small versioned blob for whatever storage the
+    // application has (EEPROM, a file); IsoNet hands a fresh cache to the
+    // ClaimStore callback every time one of its CFs completes a claim.
+    struct ClaimCache {
+        struct Peer {
+            Name name;
+            Address address = NULL_ADDRESS;
+        };
+
+        Name name;
+        Address address = NULL_ADDRESS;
+        dp::Vector<Peer> bus;
+
+        static constexpr u8 MAGIC = 0xAC;
+        static constexpr u8 VERSION = 1;
+
+        // The address a claim should start at: the cached one unless the cache
+        // saw another NAME holding it, else `preferred`
+        Address start_address(Name self, Address preferred) const noexcept {
+            if (name != self || address > MAX_ADDRESS)
+                return preferred;
+            for (const auto &p : bus) {
+                if (p.address == address && p.name != self)
+                    return preferred;
+            }
+            return address;
+        }
+
+        // [magic, version, NAME(8), address, peer count, (NAME(8), address) × count]
+        dp::Vector<u8> encode() const {
+            dp::Vector<u8> out;
+            usize peers = bus.size() > 255 ? 255 : bus.size();
+            out.reserve(12 + peers * 9);
+            out.push_back(MAGIC);
+            out.push_back(VERSION);
+            for (u8 b : name.to_bytes())
+                out.push_back(b);
+            out.push_back(address);
+            out.push_back(static_cast<u8>(peers));
+            for (usize i = 0; i < peers; ++i) {
+                for (u8 b : bus[i].name.to_bytes())
+                    out.push_back(b);
+                out.push_back(bus[i].address);
+            }
+            return out;
+        }
+
+        static dp::Optional<ClaimCache> decode(DataSpan data) {
+            if (data.size() < 12 || data[0] != MAGIC || data[1] != VERSION)
+                return dp::nullopt;
+            usize peers = data[11];
+            if (data.size() < 12 + peers * 9)
+                return dp::nullopt;
+            ClaimCache cache;
+            cache.name = Name::from_bytes(data.data() + 2);
+            cache.address = data[10];
+            for (usize i = 0; i < peers; ++i) {
+                const u8 *p = data.data() + 12 + i * 9;
+                cache.bus.push_back(Peer{Name::from_bytes(p), p[8]});
+            }
+            return cache;
+        }
+
+        // Snapshot of `self` at `addr` plus everything else the table has on `port`
+        static ClaimCache capture(const NameTable &table, u8 port, Name self, Address addr) {
+            ClaimCache cache;
+            cache.name = self;
+            cache.address = addr;
+            table.for_each(port, [&](const NameTable::Entry &e) {
+                if (e.name != self)
+                    cache.bus.push_back(Peer{e.name, e.address});
+            });
+            return cache;
+        }
+    };
+
+    using ClaimStore = std::function<void(const ClaimCache &)>;
+
+} // namespace agrobus::net
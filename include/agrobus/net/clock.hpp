@@ -0,0 +1,155 @@
+#pragma once
+
+#include "types.hpp"
+#include <datapod/datapod.hpp>
+#include <chrono>
+#include <functional>
+#include <thread>
+
+namespace agrobus::net {
+
+    // ─── Clock modes ─────────────────────────────────────────────────────────────
+    enum class ClockMode : u8 {
+        RealTime,         // Host monotonic time: tick() sleeps out the step and returns what really elapsed
+        Simulated,        // Exact steps, paced at `speed` × real time (2.0 = twice as fast)
+        AsFastAsPossible, // Exact steps, no sleeping
+    };
+
+    // ─── Clock ───────────────────────────────────────────────────────────────────
+    // The one source of time for an application loop. The stack itself only
+    // sees update(elapsed_ms) deltas, so what makes a run deterministic is
+    // where those deltas come from: tick() hands out the next one. In the
+    // simulated modes every tick is exactly `step_ms` and now_us() moves only
+    // with ticks, so a multi-ECU run (VT pool upload, TC connect) gives the
+    // same result at 1×, 100× or unpaced speed. Give it to IsoNet::set_clock()
+    // so RX timestamps follow the same time.
+    class Clock {
+        using Steady = std::chrono::steady_clock;
+
+        ClockMode mode_;
+        f64 speed_;
+        u64 now_us_ = 0;          // Simulated time
+        Steady::time_point last_; // Real time of the last tick (RealTime, Simulated pacing)
+
+      public:
+        explicit Clock(ClockMode mode = ClockMode::RealTime, f64 speed = 1.0)
+            : mode_(mode), speed_(speed > 0.0 ? speed : 1.0), last_(Steady::now()) {}
+
+        static Clock real_time() { return Clock(ClockMode::RealTime); }
+        static Clock simulated(f64 speed = 1.0) { return Clock(ClockMode::Simulated, speed); }
+        static Clock as_fast_as_possible() { return Clock(ClockMode::AsFastAsPossible); }
+
+        ClockMode mode() const noexcept { return mode_; }
+        f64 speed() const noexcept { return speed_; }
+        bool is_simulated() const noexcept { return mode_ != ClockMode::RealTime; }
+
+        // Microseconds since the clock started (simulated) or host monotonic time
+        u64 now_us() const noexcept {
+            if (is_simulated())
+                return now_us_;
+            return static_cast<u64>(
+                std::chrono::duration_cast<std::chrono::microseconds>(Steady::now().time_since_epoch()).count());
+        }
+
+        u64 now_ms() const noexcept { return now_us() / 1000; }
+
+        // Wait for the next step and return the ms to pass to update(). Real
+        // time returns the time actually elapsed since the previous tick (at
+        // least `step_ms`); the simulated modes return `step_ms` exactly.
+        u32 tick(u32 step_ms) {
+            switch (mode_) {
+            case ClockMode::RealTime: {
+                auto due = last_ + std::chrono::milliseconds(step_ms);
+                std::this_thread::sleep_until(due);
+                auto now = Steady::now();
+                auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - last_).count();
+                // Keep the sub-millisecond remainder for the next tick
+                last_ += std::chrono::milliseconds(elapsed);
+                return static_cast<u32>(elapsed);
+            }
+            case ClockMode::Simulated: {
+                auto wall = std::chrono::duration<f64, std::milli>(static_cast<f64>(step_ms) / speed_);
+                last_ += std::chrono::duration_cast<Steady::duration>(wall);
+                std::this_thread::sleep_until(last_);
+                break;
+            }
+            case ClockMode::AsFastAsPossible:
+                break;
+            }
+            now_us_ += static_cast<u64>(step_ms) * 1000;
+            return step_ms;
+        }
+
+        // Move simulated time by hand (tests); no effect in real time
+        void advance_ms(u32 ms) noexcept {
+            if (is_simulated())
+                now_us_ += static_cast<u64>(ms) * 1000;
+        }
+    };
+
+    // ─── Tick loop ───────────────────────────────────────────────────────────────
+    // Drives everything with an update(elapsed_ms) from one Clock, in the order
+    // added: networks, protocol objects, a LoopbackBus (advance(µs) via
+    // add_us()). One loop per process keeps every ECU of a simulation on the
+    // same time line.
+    //   Clock clock = Clock::as_fast_as_possible();
+    //   TickLoop loop(clock);
+    //   loop.add(nm_a).add(nm_b).add(vt_client).add(tc_client);
+    //   loop.add_us([&](u64 us) { bus.advance(us); });
+    //   loop.run_until([&] { return vt_client.is_connected(); }, 60000);
+    class TickLoop {
+        Clock &clock_;
+        dp::Vector<std::function<void(u32)>> updates_;
+        u32 step_ms_;
+
+      public:
+        explicit TickLoop(Clock &clock, u32 step_ms = 1) : clock_(clock), step_ms_(step_ms == 0 ? 1 : step_ms) {}
+
+        // Anything with update(u32 elapsed_ms); it must outlive the loop
+        template <typename T> TickLoop &add(T &subsystem) {
+            updates_.push_back([&subsystem](u32 ms) { subsystem.update(ms); });
+            return *this;
+        }
+
+        TickLoop &add_fn(std::function<void(u32)> fn) {
+            updates_.push_back(std::move(fn));
+            return *this;
+        }
+
+        // Called with the step in µs (LoopbackBus::advance)
+        TickLoop &add_us(std::function<void(u64)> fn) {
+            updates_.push_back([fn = std::move(fn)](u32 ms) { fn(static_cast<u64>(ms) * 1000); });
+            return *this;
+        }
+
+        Clock &clock() noexcept { return clock_; }
+        u32 step_ms() const noexcept { return step_ms_; }
+
+        // One step: wait for the clock, then update everything
+        u32 step() {
+            u32 elapsed = clock_.tick(step_ms_);
+            for (auto &update : updates_)
+                update(elapsed);
+            return elapsed;
+        }
+
+        // Run for `duration_ms` of clock time
+        void run_for(u64 duration_ms) {
+            u64 ran = 0;
+            while (ran < duration_ms)
+                ran += step();
+        }
+
+        // Run until `done()` or `timeout_ms` of clock time; true if done
+        bool run_until(const std::function<bool()> &done, u64 timeout_ms) {
+            u64 ran = 0;
+            while (!done()) {
+                if (ran >= timeout_ms)
+                    return false;
+                ran += step();
+            }
+            return true;
+        }
+    };
+
+} // namespace agrobus::net
@@ -21,6 +21,7 @@ namespace agrobus::net {
     inline constexpr u32 TP_TIMEOUT_T4_MS = 1050;
     inline constexpr u32 ETP_TIMEOUT_T1_MS = 750;
     inline constexpr u32 TP_BAM_INTER_PACKET_MS = 50; // Min 50ms between BAM DT packets (J1939-21)
+    inline constexpr u32 TP_BAM_MAX_BURST = 8;        // Most BAM DT frames one session releases per update
 
     // ─── Power management constants (ISO 11783-9 §4.6) ──────────────────────────
     inline constexpr u32 POWER_SHUTDOWN_MIN_MS = 2000;    // Minimum 2s after key-off
@@ -29,6 +30,7 @@ namespace agrobus::net {
 
     // ─── Protocol limits ─────────────────────────────────────────────────────────
     inline constexpr u32 CAN_DATA_LENGTH = 8;
+    inline constexpr u32 CAN_FD_DATA_LENGTH = 64; // Single frame on a CAN FD port
     inline constexpr u32 TP_MAX_DATA_LENGTH = 1785;
     inline constexpr u32 ETP_MAX_DATA_LENGTH = 117'440'505;
     inline constexpr u32 TP_BYTES_PER_FRAME = 7;
@@ -0,0 +1,348 @@
+#pragma once
+
+#include "constants.hpp"
+#include "error.hpp"
+#include "message.hpp"
+#include "pgn_defs.hpp"
+#include "session.hpp"
+#include "timer_wheel.hpp"
+#include "types.hpp"
+#include <datapod/datapod.hpp>
+#include <coroutine>
+#include <exception>
+#include <utility>
+
+namespace agrobus::net {
+
+    // ─── Coroutine task ──────────────────────────────────────────────────────────
+    // Return type of request/response flows written as C++20 coroutines:
+    //
+    //   Task<Result<Message>> read_software_id(IsoNet &net, InternalCF *cf, Address ecu) {
+    //       auto reply = co_await net.request(PGN_SOFTWARE_ID, cf, ecu, 1250);
+    //       if (!reply.is_ok())
+    //           co_return reply;
+    //       ...
+    //   }
+    //
+    // A task starts running immediately and runs until its first co_await; it
+    // is resumed from inside IsoNet::update() when the awaited message, transfer
+    // or deadline arrives. Awaiting a task from another task chains them.
+    // Dropping a task that has not finished detaches it: the flow keeps going
+    // and frees itself when it ends. T is the value co_return'ed, normally a
+    // Result; errors are values here, exceptions terminate.
+    template <typename T> class Task {
+      public:
+        struct promise_type;
+        using Handle = std::coroutine_handle<promise_type>;
+
+        struct FinalAwaiter {
+            bool await_ready() const noexcept { return false; }
+            std::coroutine_handle<> await_suspend(Handle h) noexcept {
+                promise_type &p = h.promise();
+                if (p.continuation)
+                    return p.continuation;
+                if (p.detached)
+                    h.destroy();
+                return std::noop_coroutine();
+            }
+            void await_resume() const noexcept {}
+        };
+
+        struct promise_type {
+            dp::Optional<T> value;
+            std::coroutine_handle<> continuation;
+            bool detached = false;
+
+            Task get_return_object() noexcept { return Task(Handle::from_promise(*this)); }
+            std::suspend_never initial_suspend() const noexcept { return {}; }
+            FinalAwaiter final_suspend() const noexcept { return {}; }
+            void return_value(T v) { value.emplace(std::move(v)); }
+            void unhandled_exception() const noexcept { std::terminate(); }
+        };
+
+      private:
+        Handle handle_;
+
+        explicit Task(Handle h) noexcept : handle_(h) {}
+
+      public:
+        Task(Task &&other) noexcept : handle_(std::exchange(other.handle_, {})) {}
+        Task &operator=(Task &&other) noexcept {
+            if (this != &other) {
+                release();
+                handle_ = std::exchange(other.handle_, {});
+            }
+            return *this;
+        }
+        Task(const Task &) = delete;
+        Task &operator=(const Task &) = delete;
+        ~Task() { release(); }
+
+        bool done() const noexcept { return !handle_ || handle_.done(); }
+
+        // The co_return'ed value; only valid once done()
+        T &result() noexcept { return *handle_.promise().value; }
+        const T &result() const noexcept { return *handle_.promise().value; }
+
+        // ─── Awaiting a task from another coroutine ──────────────────────────────
+        bool await_ready() const noexcept { return handle_.done(); }
+        void await_suspend(std::coroutine_handle<> awaiting) noexcept { handle_.promise().continuation = awaiting; }
+        T await_resume() { return std::move(*handle_.promise().value); }
+
+      private:
+        void release() noexcept {
+            if (!handle_)
+                return;
+            if (handle_.done())
+                handle_.destroy();
+            else
+                handle_.promise().detached = true;
+            handle_ = {};
+        }
+    };
+
+    // ─── Message filter for awaited messages ─────────────────────────────────────
+    struct MessageFilter {
+        PGN pgn = 0;
+        Address source = BROADCAST_ADDRESS; // BROADCAST_ADDRESS = any sender
+        bool nack = false;                  // Also accept an Acknowledgment (PGN 0xE800) about `pgn`
+
+        bool matches(const MessageView &view) const noexcept {
+            if (source != BROADCAST_ADDRESS && view.source != source)
+                return false;
+            if (view.pgn == pgn)
+                return true;
+            if (!nack || view.pgn != PGN_ACKNOWLEDGMENT || view.data.size() < 8)
+                return false;
+            PGN acked = static_cast<PGN>(view.data[5]) | (static_cast<PGN>(view.data[6]) << 8) |
+                        (static_cast<PGN>(view.data[7]) << 16);
+            return acked == pgn;
+        }
+    };
+
+    // An Acknowledgment matched by a `nack` filter that refuses the request
+    // (NACK, access denied, cannot respond) rather than answering it
+    inline bool is_refusal(const Message &reply, PGN requested) noexcept {
+        return requested != PGN_ACKNOWLEDGMENT && reply.pgn == PGN_ACKNOWLEDGMENT && !reply.data.empty() &&
+               reply.data[0] != 0x00;
+    }
+
+    // Timeout value that waits without a deadline
+    inline constexpr u32 NO_TIMEOUT = 0;
+
+    // ─── Pending awaits of one IsoNet ────────────────────────────────────────────
+    // Every suspended flow is one node living in its coroutine frame; the table
+    // only keeps pointers to them, so a flow in flight costs a frame and a
+    // vector slot, not a state-machine object. Deadlines run on a TimerWheel
+    // advanced by IsoNet::update(). Matching nodes are unlinked first and
+    // resumed afterwards, so a resumed flow may start new awaits right away.
+    //
+    // Flows still suspended when the IsoNet is destroyed are never resumed.
+    class AwaitTable {
+      public:
+        struct Node {
+            enum class Kind : u8 { Message, Transfer };
+
+            Kind kind = Kind::Message;
+            MessageFilter filter;
+            // Transfer key: our TX session
+            PGN pgn = 0;
+            Address source = NULL_ADDRESS;
+            Address destination = BROADCAST_ADDRESS;
+            u8 port = 0;
+
+            std::coroutine_handle<> handle;
+            TimerId timer = INVALID_TIMER;
+            bool linked = false;
+            bool done = false;
+            dp::Optional<Message> message;
+            Error error;
+        };
+
+      private:
+        TimerWheel timers_;
+        dp::Vector<Node *> nodes_;
+        usize message_nodes_ = 0;
+
+      public:
+        AwaitTable() = default;
+        AwaitTable(const AwaitTable &) = delete;
+        AwaitTable &operator=(const AwaitTable &) = delete;
+
+        void link(Node &node, u32 timeout_ms) {
+            node.linked = true;
+            nodes_.push_back(&node);
+            if (node.kind == Node::Kind::Message)
+                ++message_nodes_;
+            if (timeout_ms != NO_TIMEOUT)
+                node.timer = timers_.schedule(timeout_ms, [this, n = &node]() { expire(*n); });
+        }
+
+        void unlink(Node &node) {
+            if (!node.linked)
+                return;
+            node.linked = false;
+            if (node.timer != INVALID_TIMER) {
+                timers_.cancel(node.timer);
+                node.timer = INVALID_TIMER;
+            }
+            if (node.kind == Node::Kind::Message)
+                --message_nodes_;
+            for (usize i = 0; i < nodes_.size(); ++i) {
+                if (nodes_[i] == &node) {
+                    nodes_[i] = nodes_.back();
+                    nodes_.pop_back();
+                    return;
+                }
+            }
+        }
+
+        // ─── Driven by IsoNet ────────────────────────────────────────────────────
+        bool wants_messages() const noexcept { return message_nodes_ > 0; }
+
+        void offer(const MessageView &view) {
+            dp::Vector<Node *> batch;
+            for (Node *node : nodes_) {
+                if (node->kind == Node::Kind::Message && node->filter.matches(view))
+                    batch.push_back(node);
+            }
+            for (Node *node : batch) {
+                unlink(*node);
+                node->message = view.to_message();
+                node->done = true;
+            }
+            for (Node *node : batch)
+                resume(*node);
+        }
+
+        // A TP/ETP session we sent ended (ok or aborted)
+        void transfer_done(const TransportSession &session, Error error) {
+            if (session.direction != TransportDirection::Transmit)
+                return;
+            for (Node *node : nodes_) {
+                if (node->kind == Node::Kind::Transfer && node->pgn == session.pgn &&
+                    node->source == session.source_address && node->destination == session.destination_address &&
+                    node->port == session.can_port) {
+                    unlink(*node);
+                    node->error = std::move(error);
+                    node->done = true;
+                    resume(*node);
+                    return;
+                }
+            }
+        }
+
+        // End one await with `error` now, as its deadline would
+        void fail(Node &node, Error error) {
+            if (!node.linked)
+                return;
+            unlink(node);
+            node.error = std::move(error);
+            node.done = true;
+            resume(node);
+        }
+
+        void advance(u32 elapsed_ms) { timers_.advance(elapsed_ms); }
+        u32 next_deadline_ms() const noexcept { return timers_.next_deadline_ms(); }
+        TimerWheel &timers() noexcept { return timers_; }
+
+        usize size() const noexcept { return nodes_.size(); }
+
+      private:
+        void expire(Node &node) {
+            node.timer = INVALID_TIMER; // Already fired
+            fail(node, Error::timeout("no response"));
+        }
+
+        static void resume(Node &node) {
+            if (node.handle)
+                node.handle.resume(); // Not yet suspended: await_ready() sees done
+        }
+    };
+
+    // ─── Awaiters ────────────────────────────────────────────────────────────────
+    // Registered when constructed, so a reply that arrives between sending the
+    // request and reaching co_await is not missed. They live in the awaiting
+    // coroutine's frame and must not move.
+
+    // co_await yields Result<Message>: the first matching message or a timeout
+    class MessageAwait {
+        AwaitTable &table_;
+        AwaitTable::Node node_;
+
+      public:
+        MessageAwait(AwaitTable &table, MessageFilter filter, u32 timeout_ms) : table_(table) {
+            node_.kind = AwaitTable::Node::Kind::Message;
+            node_.filter = filter;
+            table_.link(node_, timeout_ms);
+        }
+        MessageAwait(const MessageAwait &) = delete;
+        MessageAwait &operator=(const MessageAwait &) = delete;
+        ~MessageAwait() { table_.unlink(node_); }
+
+        bool await_ready() const noexcept { return node_.done; }
+        void await_suspend(std::coroutine_handle<> h) noexcept { node_.handle = h; }
+        Result<Message> await_resume() {
+            if (node_.message)
+                return Result<Message>::ok(std::move(*node_.message));
+            return Result<Message>::err(node_.error);
+        }
+    };
+
+    // co_await yields Result<void>: our TP/ETP transfer completed or aborted
+    class TransferAwait {
+        AwaitTable &table_;
+        AwaitTable::Node node_;
+
+      public:
+        TransferAwait(AwaitTable &table, PGN pgn, Address source, Address destination, u8 port, u32 timeout_ms)
+            : table_(table) {
+            node_.kind = AwaitTable::Node::Kind::Transfer;
+            node_.pgn = pgn;
+            node_.source = source;
+            node_.destination = destination;
+            node_.port = port;
+            table_.link(node_, timeout_ms);
+        }
+        TransferAwait(const TransferAwait &) = delete;
+        TransferAwait &operator=(const TransferAwait &) = delete;
+        ~TransferAwait() { table_.unlink(node_); }
+
+        // Give up on the transfer: the awaiting flow resumes with `error`
+        void fail(Error error) { table_.fail(node_, std::move(error)); }
+
+        bool await_ready() const noexcept { return node_.done; }
+        void await_suspend(std::coroutine_handle<> h) noexcept { node_.handle = h; }
+        Result<void> await_resume() {
+            if (node_.error.code == ErrorCode::Ok)
+                return {};
+            return Result<void>::err(node_.error);
+        }
+    };
+
+    // co_await suspends for `delay_ms` of IsoNet time
+    class SleepAwait {
+        TimerWheel &timers_;
+        u32 delay_ms_;
+        TimerId timer_ = INVALID_TIMER;
+
+      public:
+        SleepAwait(TimerWheel &timers, u32 delay_ms) : timers_(timers), delay_ms_(delay_ms) {}
+        SleepAwait(const SleepAwait &) = delete;
+        SleepAwait &operator=(const SleepAwait &) = delete;
+        ~SleepAwait() {
+            if (timer_ != INVALID_TIMER)
+                timers_.cancel(timer_);
+        }
+
+        bool await_ready() const noexcept { return delay_ms_ == 0; }
+        void await_suspend(std::coroutine_handle<> h) {
+            timer_ = timers_.schedule(delay_ms_, [this, h]() {
+                timer_ = INVALID_TIMER;
+                h.resume();
+            });
+        }
+        void await_resume() const noexcept {}
+    };
+
+} // namespace agrobus::net
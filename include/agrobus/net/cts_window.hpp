@@ -0,0 +1,99 @@
+#pragma once
+
+#include <agrobus/net/constants.hpp>
+#include <agrobus/net/types.hpp>
+#include <datapod/datapod.hpp>
+
+namespace agrobus::net {
+
+    // ─── CTS window policy (TP/ETP receiver side) ───────────────────────────────
+    struct CtsWindowConfig {
+        bool adaptive = false;                       // false = fixed TP_MAX_PACKETS_PER_CTS windows
+        u8 initial_packets = TP_MAX_PACKETS_PER_CTS; // First window for a sender we know nothing about
+        u8 min_packets = 2;
+        u8 max_packets = 64;               // Upper limit (TP is also capped by the sender's RTS limit)
+        u32 late_gap_ms = 50;              // A DT gap above this marks the window as late
+        f32 high_bus_load_percent = 70.0f; // Shrink windows while the port is busier than this
+        u8 gap_retries = 2;                // CTS re-requests for missing packets per window, 0 = abort on a gap
+    };
+
+    // ─── Adaptive CTS window sizing ─────────────────────────────────────────────
+    // Learns a window size per sender (port, address): doubles it after every
+    // window that completed on time, halves it after a late window, a sequence
+    // error or a timeout, and while the port's bus load is high. The learned
+    // size carries over to the sender's next transfer.
+    class CtsWindowTuner {
+        CtsWindowConfig config_;
+        dp::Map<u16, u8> windows_;  // (port << 8 | sender) -> learned window
+        dp::Map<u8, f32> bus_load_; // Last reported load per port
+
+      public:
+        CtsWindowTuner() = default;
+        explicit CtsWindowTuner(CtsWindowConfig config) : config_(config) {}
+
+        void configure(CtsWindowConfig config) {
+            config_ = config;
+            windows_.clear();
+        }
+        const CtsWindowConfig &config() const noexcept { return config_; }
+        bool adaptive() const noexcept { return config_.adaptive; }
+
+        void set_bus_load(u8 port, f32 percent) { bus_load_[port] = percent; }
+
+        // Window to request in the first CTS of a transfer
+        u8 initial(u8 port, Address sender) const {
+            if (!config_.adaptive)
+                return static_cast<u8>(TP_MAX_PACKETS_PER_CTS);
+            u8 size = window(port, sender);
+            return busy(port) ? shrink(size) : size;
+        }
+
+        // A window from this sender finished; the largest DT gap seen was gap_ms.
+        // Returns the size of the next window (before the protocol's own caps).
+        u8 window_done(u8 port, Address sender, u32 gap_ms) {
+            if (!config_.adaptive)
+                return static_cast<u8>(TP_MAX_PACKETS_PER_CTS);
+            u8 size = window(port, sender);
+            u8 next = (gap_ms > config_.late_gap_ms || busy(port)) ? shrink(size) : grow(size);
+            windows_[key(port, sender)] = next;
+            return next;
+        }
+
+        // Sequence error or timeout on a transfer from this sender
+        void failed(u8 port, Address sender) {
+            if (!config_.adaptive)
+                return;
+            windows_[key(port, sender)] = shrink(window(port, sender));
+        }
+
+        // Learned window for a sender (initial size if none learned yet)
+        u8 window(u8 port, Address sender) const {
+            auto it = windows_.find(key(port, sender));
+            return it != windows_.end() ? it->second : clamp(config_.initial_packets);
+        }
+
+      private:
+        static u16 key(u8 port, Address sender) noexcept {
+            return static_cast<u16>((static_cast<u16>(port) << 8) | sender);
+        }
+
+        bool busy(u8 port) const {
+            auto it = bus_load_.find(port);
+            return it != bus_load_.end() && it->second > config_.high_bus_load_percent;
+        }
+
+        u8 clamp(u32 size) const noexcept {
+            u32 lo = config_.min_packets == 0 ? 1 : config_.min_packets;
+            u32 hi = config_.max_packets < lo ? lo : config_.max_packets;
+            if (size < lo)
+                return static_cast<u8>(lo);
+            if (size > hi)
+                return static_cast<u8>(hi);
+            return static_cast<u8>(size);
+        }
+
+        u8 grow(u8 size) const noexcept { return clamp(static_cast<u32>(size) * 2); }
+        u8 shrink(u8 size) const noexcept { return clamp(size / 2); }
+    };
+
+} // namespace agrobus::net
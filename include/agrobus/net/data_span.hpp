@@ -62,6 +62,11 @@ namespace agrobus::net {
             return bitfield::get_bit(data_[byte_offset], bit);
         }
 
+        // Extract arbitrary bit field (up to 32 bits), same semantics as Message::get_bits
+        constexpr u32 get_bits(usize start_bit, u8 length) const noexcept {
+            return bitfield::extract_le(data_, size_, start_bit, length);
+        }
+
         // Iterator support
         constexpr const u8 *begin() const noexcept { return data_; }
         constexpr const u8 *end() const noexcept { return data_ + size_; }
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <agrobus/net/types.hpp>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace agrobus::net {
+
+    // Inline storage of a Delegate: a lambda capturing `this` plus a few
+    // references or scalars (or a std::function) fits without allocating
+    inline constexpr usize DELEGATE_INLINE_BYTES = 6 * sizeof(void *);
+
+    // ─── Small-buffer callable ──────────────────────────────────────────────────
+    // Type-erased callable like std::function, but callables up to InlineBytes
+    // are stored in place, so subscribing a typical listener never touches the
+    // heap. Larger callables are boxed on the heap, unless AllowHeap is false,
+    // in which case they are rejected at compile time (StaticEvent).
+    template <typename Sig, usize InlineBytes = DELEGATE_INLINE_BYTES, bool AllowHeap = true> class Delegate;
+
+    template <typename R, typename... Args, usize InlineBytes, bool AllowHeap>
+    class Delegate<R(Args...), InlineBytes, AllowHeap> {
+        struct Ops {
+            R (*invoke)(void *, Args...);
+            void (*copy)(const void *, void *);
+            void (*move)(void *, void *);
+            void (*destroy)(void *);
+        };
+
+        template <typename F>
+        static constexpr bool fits_inline = sizeof(F) <= InlineBytes && alignof(F) <= alignof(std::max_align_t) &&
+                                            std::is_nothrow_move_constructible_v<F>;
+
+        template <typename F> struct InlineOps {
+            static R invoke(void *p, Args... args) { return (*static_cast<F *>(p))(std::forward<Args>(args)...); }
+            static void copy(const void *src, void *dst) { ::new (dst) F(*static_cast<const F *>(src)); }
+            static void move(void *src, void *dst) {
+                ::new (dst) F(std::move(*static_cast<F *>(src)));
+                static_cast<F *>(src)->~F();
+            }
+            static void destroy(void *p) { static_cast<F *>(p)->~F(); }
+            static constexpr Ops ops = {&invoke, &copy, &move, &destroy};
+        };
+
+        template <typename F> struct HeapOps {
+            static F *&ptr(void *p) { return *static_cast<F **>(p); }
+            static R invoke(void *p, Args... args) { return (*ptr(p))(std::forward<Args>(args)...); }
+            static void copy(const void *src, void *dst) { ::new (dst) F *(new F(**static_cast<F *const *>(src))); }
+            static void move(void *src, void *dst) { ::new (dst) F *(ptr(src)); }
+            static void destroy(void *p) { delete ptr(p); }
+            static constexpr Ops ops = {&invoke, &copy, &move, &destroy};
+        };
+
+        alignas(std::max_align_t) unsigned char storage_[InlineBytes];
+        const Ops *ops_ = nullptr;
+
+      public:
+        static constexpr usize inline_bytes = InlineBytes;
+
+        Delegate() noexcept = default;
+        Delegate(std::nullptr_t) noexcept {}
+
+        template <typename F, typename D = std::decay_t<F>,
+                  typename = std::enable_if_t<!std::is_same_v<D, Delegate> && std::is_invocable_r_v<R, D &, Args...>>>
+        Delegate(F &&fn) {
+            // Empty std::function / null function pointer -> empty delegate
+            if constexpr (std::is_constructible_v<bool, const D &>) {
+                if (!static_cast<bool>(fn))
+                    return;
+            }
+            if constexpr (fits_inline<D>) {
+                ::new (static_cast<void *>(storage_)) D(std::forward<F>(fn));
+                ops_ = &InlineOps<D>::ops;
+            } else {
+                static_assert(AllowHeap, "callable too large for this delegate's inline storage");
+                ::new (static_cast<void *>(storage_)) D *(new D(std::forward<F>(fn)));
+                ops_ = &HeapOps<D>::ops;
+            }
+        }
+
+        Delegate(const Delegate &other) : ops_(other.ops_) {
+            if (ops_)
+                ops_->copy(other.storage_, storage_);
+        }
+
+        Delegate(Delegate &&other) noexcept : ops_(other.ops_) {
+            if (ops_) {
+                ops_->move(other.storage_, storage_);
+                other.ops_ = nullptr;
+            }
+        }
+
+        Delegate &operator=(const Delegate &other) {
+            if (this != &other) {
+                Delegate tmp(other);
+                *this = std::move(tmp);
+            }
+            return *this;
+        }
+
+        Delegate &operator=(Delegate &&other) noexcept {
+            if (this != &other) {
+                reset();
+                if (other.ops_) {
+                    other.ops_->move(other.storage_, storage_);
+                    ops_ = other.ops_;
+                    other.ops_ = nullptr;
+                }
+            }
+            return *this;
+        }
+
+        ~Delegate() { reset(); }
+
+        void reset() noexcept {
+            if (ops_) {
+                ops_->destroy(storage_);
+                ops_ = nullptr;
+            }
+        }
+
+        explicit operator bool() const noexcept { return ops_ != nullptr; }
+
+        R operator()(Args... args) const {
+            return ops_->invoke(const_cast<unsigned char *>(storage_), std::forward<Args>(args)...);
+        }
+    };
+
+} // namespace agrobus::net
@@ -3,8 +3,10 @@
 #include <agrobus/net/error.hpp>
 #include <agrobus/net/frame.hpp>
 #include <agrobus/net/types.hpp>
+#include <chrono>
 #include <cstring>
 #include <echo/echo.hpp>
+#include <functional>
 #include <wirebit/can/can_endpoint.hpp>
 #include <wirebit/eth/eth_endpoint.hpp>
 
@@ -17,6 +19,126 @@ namespace agrobus::net {
     // Encapsulated CAN frame header (4 bytes ID + 1 byte DLC + up to 8 bytes data)
     inline constexpr usize ETH_CAN_HEADER_SIZE = 5; // 4 bytes CAN ID + 1 byte DLC
     inline constexpr usize ETH_CAN_MAX_FRAME = 13;  // header + 8 data bytes
+    inline constexpr usize ETH_MAX_PAYLOAD = 1500;  // Standard Ethernet MTU
+    inline constexpr usize ETH_HEADER_SIZE = 14;    // dst MAC + src MAC + EtherType
+
+    // ─── CAN record encoding (shared by the Ethernet and UDP tunnels) ───────────
+    // [CAN ID (4, little-endian)] [DLC (1)] [data (DLC)]
+    template <typename Bytes> inline void append_can_record(Bytes &out, const can_frame &cf) {
+        u8 dlc = cf.can_dlc > 8 ? 8 : cf.can_dlc;
+        u32 can_id = cf.can_id & CAN_EFF_MASK;
+        out.push_back(static_cast<u8>(can_id & 0xFF));
+        out.push_back(static_cast<u8>((can_id >> 8) & 0xFF));
+        out.push_back(static_cast<u8>((can_id >> 16) & 0xFF));
+        out.push_back(static_cast<u8>((can_id >> 24) & 0xFF));
+        out.push_back(dlc);
+        for (u8 i = 0; i < dlc; ++i)
+            out.push_back(cf.data[i]);
+    }
+
+    // Call fn(can_frame) for each complete record in [data, data + size)
+    template <typename F> inline void for_each_can_record(const u8 *data, usize size, F &&fn) {
+        usize offset = 0;
+        while (offset + ETH_CAN_HEADER_SIZE <= size) {
+            u32 can_id = static_cast<u32>(data[offset]) | (static_cast<u32>(data[offset + 1]) << 8) |
+                         (static_cast<u32>(data[offset + 2]) << 16) | (static_cast<u32>(data[offset + 3]) << 24);
+            u8 dlc = data[offset + 4];
+            if (dlc > 8)
+                dlc = 8;
+            offset += ETH_CAN_HEADER_SIZE;
+            if (offset + dlc > size)
+                break;
+
+            can_frame cf = {};
+            cf.can_id = can_id | CAN_EFF_FLAG;
+            cf.can_dlc = dlc;
+            for (u8 i = 0; i < dlc; ++i)
+                cf.data[i] = data[offset + i];
+            offset += dlc;
+            fn(cf);
+        }
+    }
+
+    // ─── Received-frame ring ─────────────────────────────────────────────────────
+    // Fixed power-of-two ring of decoded frames, allocated once. Single
+    // threaded: the tunnel's process() pushes, IsoNet pops. Frames arriving
+    // at a full ring are dropped and counted.
+    class CanFrameRing {
+        dp::Vector<can_frame> slots_;
+        u32 mask_ = 0;
+        u32 head_ = 0; // Next to pop
+        u32 tail_ = 0; // Next to push
+        u32 dropped_ = 0;
+
+      public:
+        void configure(u32 frames) {
+            u32 ring = 1;
+            while (ring < frames)
+                ring <<= 1;
+            slots_.assign(ring, can_frame{});
+            mask_ = ring - 1;
+            head_ = tail_ = 0;
+        }
+
+        bool push(const can_frame &cf) noexcept {
+            if (tail_ - head_ > mask_) {
+                ++dropped_;
+                return false;
+            }
+            slots_[tail_ & mask_] = cf;
+            ++tail_;
+            return true;
+        }
+
+        bool pop(can_frame &cf) noexcept {
+            if (head_ == tail_)
+                return false;
+            cf = slots_[head_ & mask_];
+            ++head_;
+            return true;
+        }
+
+        u32 size() const noexcept { return tail_ - head_; }
+        u32 dropped() const noexcept { return dropped_; }
+    };
+
+    // ─── CanEndpoint link over a tunnel ──────────────────────────────────────────
+    // Lets a wirebit::CanEndpoint send through, and receive from, a tunnel
+    // with send_can(can_frame), pop_can(can_frame &) and rx_pending().
+    template <typename Tunnel> class CanTunnelLink : public wirebit::Link {
+        Tunnel *tunnel_;
+        const char *name_;
+
+      public:
+        CanTunnelLink(Tunnel *tunnel, const char *name) : tunnel_(tunnel), name_(name) {}
+
+        wirebit::Result<wirebit::Unit, wirebit::Error> send(const wirebit::Frame &frame) override {
+            // Extract can_frame from the wirebit frame payload
+            if (frame.payload.size() != sizeof(can_frame))
+                return wirebit::Result<wirebit::Unit, wirebit::Error>::err(
+                    wirebit::Error::invalid_argument("Not a CAN frame"));
+
+            can_frame cf;
+            std::memcpy(&cf, frame.payload.data(), sizeof(can_frame));
+            tunnel_->send_can(cf);
+            return wirebit::Result<wirebit::Unit, wirebit::Error>::ok(wirebit::Unit{});
+        }
+
+        wirebit::Result<wirebit::Frame, wirebit::Error> recv() override {
+            can_frame cf;
+            if (!tunnel_->pop_can(cf))
+                return wirebit::Result<wirebit::Frame, wirebit::Error>::err(wirebit::Error::timeout("empty"));
+
+            wirebit::Bytes payload(sizeof(can_frame));
+            std::memcpy(payload.data(), &cf, sizeof(can_frame));
+            return wirebit::Result<wirebit::Frame, wirebit::Error>::ok(
+                wirebit::make_frame(wirebit::FrameType::CAN, std::move(payload), 0, 0));
+        }
+
+        bool can_send() const override { return true; }
+        bool can_recv() const override { return tunnel_->rx_pending() > 0; }
+        wirebit::String name() const override { return name_; }
+    };
 
     // ─── Configuration for Ethernet CAN bridge ──────────────────────────────────
     struct EthCanConfig {
@@ -25,6 +147,17 @@ namespace agrobus::net {
         u32 endpoint_id = 1;
         bool promiscuous = true; // receive all ISOBUS frames
 
+        // TX aggregation: CAN records are packed into one Ethernet frame until
+        // tx_batch_frames are queued, the next one would exceed tx_max_payload,
+        // or the oldest has waited tx_flush_us. 1 = one Ethernet frame per CAN frame.
+        u16 tx_batch_frames = 1;
+        u32 tx_flush_us = 1000;
+        usize tx_max_payload = ETH_MAX_PAYLOAD;
+
+        // Received CAN frames waiting for IsoNet (rounded up to a power of two);
+        // frames arriving at a full ring are dropped and counted
+        u32 rx_ring_frames = 1024;
+
         EthCanConfig &bandwidth(u64 bps) {
             bandwidth_bps = bps;
             return *this;
@@ -41,6 +174,19 @@ namespace agrobus::net {
             mac = addr;
             return *this;
         }
+        EthCanConfig &batch(u16 frames, u32 flush_us = 1000) {
+            tx_batch_frames = frames == 0 ? 1 : frames;
+            tx_flush_us = flush_us;
+            return *this;
+        }
+        EthCanConfig &max_payload(usize bytes) {
+            tx_max_payload = bytes < ETH_CAN_MAX_FRAME ? ETH_CAN_MAX_FRAME : bytes;
+            return *this;
+        }
+        EthCanConfig &rx_ring(u32 frames) {
+            rx_ring_frames = frames;
+            return *this;
+        }
     };
 
     // ─── EthCan: ISOBUS CAN frames encapsulated in Ethernet ────────────────────
@@ -56,53 +202,26 @@ namespace agrobus::net {
     //   EthCan eth(link, {.mac = {...}});
     //   nm.set_endpoint(0, &eth.can_endpoint());
     //   // In main loop:
-    //   eth.process(); // receive Ethernet -> CAN frames
+    //   eth.process(); // receive Ethernet -> CAN frames, flush a due TX batch
+    //
+    // With EthCanConfig::batch(n, flush_us) up to n CAN records share one
+    // Ethernet frame (about 100 fit the standard MTU), cutting the packet rate
+    // on the backbone at high bus load; flush() sends a partial batch at once.
     class EthCan {
         std::shared_ptr<wirebit::Link> link_;
         wirebit::EthEndpoint eth_ep_;
         EthCanConfig config_;
 
-        // Internal CAN frame buffer for IsoNet compatibility
-        dp::Vector<can_frame> rx_can_frames_;
-
-        // CanEndpoint-compatible adapter
-        class EthCanEndpointAdapter : public wirebit::Link {
-            EthCan *parent_;
-
-          public:
-            explicit EthCanEndpointAdapter(EthCan *parent) : parent_(parent) {}
-
-            wirebit::Result<wirebit::Unit, wirebit::Error> send(const wirebit::Frame &frame) override {
-                // Extract can_frame from the wirebit frame payload
-                if (frame.payload.size() != sizeof(can_frame))
-                    return wirebit::Result<wirebit::Unit, wirebit::Error>::err(
-                        wirebit::Error::invalid_argument("Not a CAN frame"));
-
-                can_frame cf;
-                std::memcpy(&cf, frame.payload.data(), sizeof(can_frame));
-                parent_->send_can_via_eth(cf);
-                return wirebit::Result<wirebit::Unit, wirebit::Error>::ok(wirebit::Unit{});
-            }
-
-            wirebit::Result<wirebit::Frame, wirebit::Error> recv() override {
-                if (parent_->rx_can_frames_.empty())
-                    return wirebit::Result<wirebit::Frame, wirebit::Error>::err(wirebit::Error::timeout("empty"));
-
-                can_frame cf = parent_->rx_can_frames_[0];
-                parent_->rx_can_frames_.erase(parent_->rx_can_frames_.begin());
-
-                wirebit::Bytes payload(sizeof(can_frame));
-                std::memcpy(payload.data(), &cf, sizeof(can_frame));
-                return wirebit::Result<wirebit::Frame, wirebit::Error>::ok(
-                    wirebit::make_frame(wirebit::FrameType::CAN, std::move(payload), 0, 0));
-            }
+        // Received CAN frames, drained by the endpoint or rx_source()
+        CanFrameRing rx_ring_;
 
-            bool can_send() const override { return true; }
-            bool can_recv() const override { return !parent_->rx_can_frames_.empty(); }
-            wirebit::String name() const override { return "eth_can_adapter"; }
-        };
+        // Ethernet payload being filled with CAN records (TX aggregation)
+        wirebit::Bytes tx_payload_;
+        u16 tx_records_ = 0;
+        u64 tx_first_us_ = 0; // When the oldest queued record was added
 
-        std::shared_ptr<EthCanEndpointAdapter> adapter_;
+        // CanEndpoint-compatible adapter
+        std::shared_ptr<CanTunnelLink<EthCan>> adapter_;
         wirebit::CanEndpoint can_ep_;
 
       public:
@@ -111,9 +230,11 @@ namespace agrobus::net {
               eth_ep_(link_,
                       wirebit::EthConfig{.bandwidth_bps = config.bandwidth_bps, .promiscuous = config.promiscuous},
                       config.endpoint_id, config.mac),
-              config_(config), adapter_(std::make_shared<EthCanEndpointAdapter>(this)),
+              config_(config), adapter_(std::make_shared<CanTunnelLink<EthCan>>(this, "eth_can_adapter")),
               can_ep_(std::static_pointer_cast<wirebit::Link>(adapter_), wirebit::CanConfig{.bitrate = 250000},
                       config.endpoint_id) {
+            tx_payload_.reserve(config_.tx_max_payload);
+            rx_ring_.configure(config_.rx_ring_frames);
             echo::category("isobus.eth_can").info("EthCan created: MAC=", wirebit::mac_to_string(config.mac).c_str());
         }
 
@@ -123,70 +244,87 @@ namespace agrobus::net {
         // Get the underlying Ethernet endpoint
         wirebit::EthEndpoint &eth_endpoint() noexcept { return eth_ep_; }
 
+        // Direct receive path: pops decoded frames straight from the ring, with
+        // no wirebit::Frame in between. nm.set_rx_source(port, eth.rx_source())
+        std::function<bool(can_frame &)> rx_source() {
+            return [this](can_frame &cf) { return pop_can(cf); };
+        }
+
+        bool pop_can(can_frame &cf) noexcept { return rx_ring_.pop(cf); }
+
+        u32 rx_pending() const noexcept { return rx_ring_.size(); }
+        u32 rx_dropped() const noexcept { return rx_ring_.dropped(); }
+
         // Process received Ethernet frames, extracting encapsulated CAN frames.
         // Call this periodically (e.g., in your main loop before nm.update()).
+        // Also sends a partial TX batch whose flush deadline has passed.
         void process() {
+            if (tx_records_ > 0 && now_us() - tx_first_us_ >= config_.tx_flush_us)
+                flush();
+
             auto result = eth_ep_.recv_eth();
             if (!result.is_ok())
                 return;
+            receive_eth(result.value().data(), result.value().size());
+        }
 
-            auto &eth_frame = result.value();
-
-            // Parse Ethernet header
-            wirebit::MacAddr dst_mac, src_mac;
-            u16 ethertype;
-            wirebit::Bytes payload;
-            auto parse = wirebit::parse_eth_frame(eth_frame, dst_mac, src_mac, ethertype, payload);
-            if (!parse.is_ok())
+        // Decode one received Ethernet frame read by other means, e.g. an
+        // IoRing recv on a raw AF_PACKET socket; other EtherTypes are ignored
+        void receive_eth(const u8 *eth_frame, usize size) {
+            // Decode in place: [dst MAC (6)] [src MAC (6)] [EtherType (2)] [CAN records...]
+            if (size < ETH_HEADER_SIZE)
                 return;
-
+            u16 ethertype = static_cast<u16>((static_cast<u16>(eth_frame[12]) << 8) | eth_frame[13]);
             if (ethertype != ETHERTYPE_ISOBUS)
                 return;
 
-            // Decode encapsulated CAN frames from payload
-            usize offset = 0;
-            while (offset + ETH_CAN_HEADER_SIZE <= payload.size()) {
-                u32 can_id = static_cast<u32>(payload[offset]) | (static_cast<u32>(payload[offset + 1]) << 8) |
-                             (static_cast<u32>(payload[offset + 2]) << 16) |
-                             (static_cast<u32>(payload[offset + 3]) << 24);
-                u8 dlc = payload[offset + 4];
-                if (dlc > 8)
-                    dlc = 8;
-                offset += ETH_CAN_HEADER_SIZE;
-
-                if (offset + dlc > payload.size())
-                    break;
-
-                can_frame cf = {};
-                cf.can_id = can_id | CAN_EFF_FLAG;
-                cf.can_dlc = dlc;
-                for (u8 i = 0; i < dlc; ++i)
-                    cf.data[i] = payload[offset + i];
-                offset += dlc;
-
-                rx_can_frames_.push_back(cf);
-                echo::category("isobus.eth_can").trace("ETH->CAN: id=0x", can_id, " dlc=", dlc);
-            }
+            for_each_can_record(eth_frame + ETH_HEADER_SIZE, size - ETH_HEADER_SIZE, [this](const can_frame &cf) {
+                rx_ring_.push(cf);
+                echo::category("isobus.eth_can")
+                    .trace("ETH->CAN: id=0x", cf.can_id & CAN_EFF_MASK, " dlc=", cf.can_dlc);
+            });
         }
 
-        // Send a CAN frame encapsulated in Ethernet
+        // Send a CAN frame encapsulated in Ethernet (queued into the current
+        // batch when TX aggregation is on)
         void send_can_via_eth(const can_frame &cf) {
-            wirebit::Bytes payload(ETH_CAN_HEADER_SIZE + cf.can_dlc);
-            u32 can_id = cf.can_id & CAN_EFF_MASK;
-            payload[0] = static_cast<u8>(can_id & 0xFF);
-            payload[1] = static_cast<u8>((can_id >> 8) & 0xFF);
-            payload[2] = static_cast<u8>((can_id >> 16) & 0xFF);
-            payload[3] = static_cast<u8>((can_id >> 24) & 0xFF);
-            payload[4] = cf.can_dlc;
-            for (u8 i = 0; i < cf.can_dlc && i < 8; ++i)
-                payload[5 + i] = cf.data[i];
-
-            auto eth_frame = wirebit::make_eth_frame(wirebit::MAC_BROADCAST, config_.mac, ETHERTYPE_ISOBUS, payload);
+            u8 dlc = cf.can_dlc > 8 ? 8 : cf.can_dlc;
+            if (tx_payload_.size() + ETH_CAN_HEADER_SIZE + dlc > config_.tx_max_payload)
+                flush();
+
+            append_can_record(tx_payload_, cf);
+            if (tx_records_++ == 0 && config_.tx_batch_frames > 1)
+                tx_first_us_ = now_us();
+            echo::category("isobus.eth_can").trace("CAN->ETH: id=0x", cf.can_id & CAN_EFF_MASK, " dlc=", dlc);
+
+            if (tx_records_ >= config_.tx_batch_frames)
+                flush();
+        }
+
+        void send_can(const can_frame &cf) { send_can_via_eth(cf); }
+
+        // Send the queued CAN records now, as one Ethernet frame
+        void flush() {
+            if (tx_records_ == 0)
+                return;
+            auto eth_frame =
+                wirebit::make_eth_frame(wirebit::MAC_BROADCAST, config_.mac, ETHERTYPE_ISOBUS, tx_payload_);
             eth_ep_.send_eth(eth_frame);
-            echo::category("isobus.eth_can").trace("CAN->ETH: id=0x", can_id, " dlc=", cf.can_dlc);
+            tx_payload_.clear();
+            tx_records_ = 0;
         }
 
+        // CAN records waiting in the current batch
+        u16 pending_tx() const noexcept { return tx_records_; }
+
         const wirebit::MacAddr &mac() const noexcept { return config_.mac; }
+
+      private:
+        static u64 now_us() {
+            return static_cast<u64>(std::chrono::duration_cast<std::chrono::microseconds>(
+                                        std::chrono::steady_clock::now().time_since_epoch())
+                                        .count());
+        }
     };
 
 } // namespace agrobus::net
@@ -1,12 +1,23 @@
 #pragma once
 
+#include "buffer_pool.hpp"
+#include "cts_window.hpp"
 #include "session.hpp"
+#include "transport_metrics.hpp"
+#include <agrobus/net/data_span.hpp>
 #include <agrobus/net/error.hpp>
 #include <agrobus/net/event.hpp>
 #include <agrobus/net/frame.hpp>
 #include <agrobus/net/identifier.hpp>
+#include <agrobus/net/memory_budget.hpp>
+#include <agrobus/net/static_alloc.hpp>
+#include <agrobus/net/timer.hpp>
+#include <agrobus/net/trace.hpp>
+#include <agrobus/net/transport_limits.hpp>
 #include <datapod/datapod.hpp>
 #include <echo/echo.hpp>
+#include <functional>
+#include <memory>
 
 namespace agrobus::net {
 
@@ -21,78 +32,137 @@ namespace agrobus::net {
 
     // ─── Extended Transport Protocol (>1785 bytes, up to ~117MB) ─────────────────
     class ExtendedTransportProtocol {
+      public:
+        // Decides per incoming RTS (pgn, total bytes) whether to stream it
+        using StreamFilter = std::function<bool(PGN, u32)>;
+
+      private:
         dp::Vector<TransportSession> sessions_;
+        std::shared_ptr<BufferPool> pool_;  // Optional source of session buffers
+        MemoryBudget *budget_ = nullptr;    // Optional limit on session buffer bytes
+        TransportLimits *limits_ = nullptr; // Optional caps on receive sessions per source
+        StreamFilter stream_filter_;
+        CtsWindowTuner cts_window_;               // Receiver-side CTS window sizing
+        dp::Vector<TransportSession *> tx_ready_; // Scratch list for get_pending_data_frames()
+        PortSet paused_ports_;                    // TX backpressure, see pause_port()
+        PortSet held_ports_;                      // Bus-off, see hold_port()
+        TransportMetrics metrics_;
 
       public:
         static constexpr u32 MAX_DATA_LENGTH = ETP_MAX_DATA_LENGTH;
         static constexpr u32 BYTES_PER_FRAME = TP_BYTES_PER_FRAME;
 
+        // The static allocation profile reserves AGROBUS_MAX_TRANSPORT_SESSIONS
+        // sessions and refuses (send error, RTS abort) any beyond them
+        ExtendedTransportProtocol() {
+            if constexpr (static_alloc::enabled) {
+                sessions_.reserve(static_alloc::transport_sessions);
+                tx_ready_.reserve(static_alloc::transport_sessions);
+            }
+        }
+
+        // Take session buffers from (and return them to) a shared pool
+        void set_buffer_pool(std::shared_ptr<BufferPool> pool) noexcept { pool_ = std::move(pool); }
+
+        // Charge session buffers to a budget: a send that does not fit fails
+        // with ErrorCode::NoResources, an RTS is aborted (ResourcesUnavailable)
+        void set_memory_budget(MemoryBudget *budget) noexcept { budget_ = budget; }
+        MemoryBudget *memory_budget() const noexcept { return budget_; }
+
+        // Cap receive sessions per source and overall: an RTS past a cap is
+        // aborted (ResourcesUnavailable), a BAM past one is ignored
+        void set_limits(TransportLimits *limits) noexcept { limits_ = limits; }
+        TransportLimits *limits() const noexcept { return limits_; }
+
+        // CTS window policy for receive (fixed 16 packets by default)
+        void set_cts_window(CtsWindowConfig config) { cts_window_.configure(config); }
+        CtsWindowTuner &cts_window() noexcept { return cts_window_; }
+
+        // Session counters, throughput and CTS latency per port and PGN
+        const TransportMetrics &metrics() const noexcept { return metrics_; }
+        TransportMetrics &metrics() noexcept { return metrics_; }
+
+        // ─── Streaming receive ─────────────────────────────────────────────────
+        // Sessions accepted by the filter are not reassembled: each completed DPO
+        // window is emitted through on_chunk(session, byte offset, bytes) and
+        // only one window (at most 1785 bytes) is buffered. on_complete still
+        // fires at the end, with empty data. Pass nullptr to disable.
+        void set_stream_filter(StreamFilter filter) { stream_filter_ = std::move(filter); }
+        const StreamFilter &stream_filter() const noexcept { return stream_filter_; }
+
+        // Stream every incoming message of at least min_bytes
+        void stream_above(u32 min_bytes) {
+            stream_filter_ = [min_bytes](PGN, u32 total_bytes) { return total_bytes >= min_bytes; };
+        }
+
         Result<dp::Vector<Frame>> send(PGN pgn, const dp::Vector<u8> &data, Address source, Address dest, u8 port = 0,
                                        Priority priority = Priority::Lowest) {
-            if (data.size() > MAX_DATA_LENGTH) {
-                echo::category("isobus.transport.etp")
-                    .error("data exceeds ETP max: size=", data.size(), " max=", MAX_DATA_LENGTH);
-                return Result<dp::Vector<Frame>>::err(Error(ErrorCode::BufferOverflow, "data exceeds ETP max"));
-            }
-            if (data.size() <= TP_MAX_DATA_LENGTH) {
-                return Result<dp::Vector<Frame>>::err(Error::invalid_state("use TP for <= 1785 bytes"));
-            }
-            if (dest == BROADCAST_ADDRESS) {
-                return Result<dp::Vector<Frame>>::err(Error::invalid_state("ETP does not support broadcast"));
+            auto ok = check_send(pgn, data.size(), source, dest, port);
+            if (!ok.is_ok()) {
+                return Result<dp::Vector<Frame>>::err(ok.error());
             }
+            TransportSession session = make_tx_session(pgn, data.size(), source, dest, port, priority);
+            if (!charge(session, static_cast<u32>(data.size())))
+                return Result<dp::Vector<Frame>>::err(Error(ErrorCode::NoResources, "transport memory budget spent"));
+            session.data = take_buffer(data.size());
+            for (usize i = 0; i < data.size(); ++i)
+                session.data[i] = data[i];
+            return begin_send(std::move(session));
+        }
 
-            // Check for existing session by full key
-            for (const auto &s : sessions_) {
-                if (s.source_address == source && s.destination_address == dest && s.pgn == pgn &&
-                    s.direction == TransportDirection::Transmit && s.can_port == port) {
-                    echo::category("isobus.transport.etp")
-                        .error("session already active: pgn=", pgn, " src=", static_cast<u8>(source),
-                               " dst=", static_cast<u8>(dest));
-                    return Result<dp::Vector<Frame>>::err(Error(ErrorCode::SessionExists, "session already active"));
-                }
+        // Zero-copy send: DT frames are built straight from *data, which the
+        // session holds until it completes or aborts (pool/DDOP uploads)
+        Result<dp::Vector<Frame>> send_shared(PGN pgn, SharedPayload data, Address source, Address dest, u8 port = 0,
+                                              Priority priority = Priority::Lowest) {
+            if (!data) {
+                return Result<dp::Vector<Frame>>::err(Error::invalid_state("null payload"));
             }
-
-            dp::Vector<Frame> frames;
-            TransportSession session;
-            session.direction = TransportDirection::Transmit;
-            session.state = SessionState::WaitingForCTS;
-            session.pgn = pgn;
-            session.data = data;
-            session.total_bytes = static_cast<u32>(data.size());
-            session.source_address = source;
-            session.destination_address = dest;
-            session.can_port = port;
-            session.priority = priority;
-
-            frames.push_back(make_rts(session));
-            sessions_.push_back(std::move(session));
-
-            echo::category("isobus.transport.etp").debug("ETP RTS sent: pgn=", pgn, " bytes=", data.size());
-            return Result<dp::Vector<Frame>>::ok(std::move(frames));
+            auto ok = check_send(pgn, data->size(), source, dest, port);
+            if (!ok.is_ok()) {
+                return Result<dp::Vector<Frame>>::err(ok.error());
+            }
+            TransportSession session = make_tx_session(pgn, data->size(), source, dest, port, priority);
+            session.shared_data = std::move(data);
+            return begin_send(std::move(session));
         }
 
+        // The frames to send are appended to a caller-owned vector that can be
+        // reused from call to call; the overloads returning a vector wrap these.
         dp::Vector<Frame> process_frame(const Frame &frame, u8 port = 0) {
             dp::Vector<Frame> responses;
-            PGN pgn = frame.pgn();
+            process_frame(frame, frame.header(), port, responses);
+            return responses;
+        }
+
+        // With the identifier already decoded by the caller
+        void process_frame(const Frame &frame, const FrameHeader &hdr, u8 port, dp::Vector<Frame> &responses) {
+            PGN pgn = hdr.pgn;
 
             if (pgn == PGN_ETP_CM) {
                 echo::category("isobus.transport.etp")
-                    .trace("ETP CM frame received: src=", static_cast<u8>(frame.source()), " ctrl=", frame.data[0]);
-                responses = handle_cm(frame, port);
+                    .trace("ETP CM frame received: src=", static_cast<u8>(hdr.source), " ctrl=", frame.data[0]);
+                handle_cm(frame, hdr, port, responses);
             } else if (pgn == PGN_ETP_DT) {
                 echo::category("isobus.transport.etp")
-                    .trace("ETP DT frame received: src=", static_cast<u8>(frame.source()), " seq=", frame.data[0]);
-                responses = handle_dt(frame, port);
+                    .trace("ETP DT frame received: src=", static_cast<u8>(hdr.source), " seq=", frame.data[0]);
+                handle_dt(frame, hdr, port, responses);
             }
-
-            return responses;
         }
 
         dp::Vector<Frame> update(u32 elapsed_ms) {
             dp::Vector<Frame> frames;
+            update(elapsed_ms, frames);
+            return frames;
+        }
 
+        void update(u32 elapsed_ms, dp::Vector<Frame> &frames) {
             for (auto it = sessions_.begin(); it != sessions_.end();) {
+                if (port_held(it->can_port)) {
+                    ++it;
+                    continue;
+                }
                 it->timer_ms += elapsed_ms;
+                it->age_ms += elapsed_ms;
 
                 bool timed_out = false;
                 if (it->state == SessionState::WaitingForCTS || it->state == SessionState::WaitingForData ||
@@ -100,48 +170,108 @@ namespace agrobus::net {
                     timed_out = it->timer_ms >= ETP_TIMEOUT_T1_MS;
                 }
 
+                // The sender went quiet part way through a DPO group: its tail was lost
+                if (timed_out && it->direction == TransportDirection::Receive && it->last_sequence > 0 &&
+                    !it->awaiting_resend &&
+                    request_missing(*it, static_cast<u8>(it->last_sequence + 1), it->can_port, frames)) {
+                    ++it;
+                    continue;
+                }
+
                 if (timed_out) {
                     echo::category("isobus.transport.etp").warn("ETP timeout: pgn=", it->pgn);
+                    if (it->direction == TransportDirection::Receive)
+                        cts_window_.failed(it->can_port, it->source_address);
                     it->state = SessionState::Aborted;
-                    on_abort.emit(*it, TransportAbortReason::Timeout);
+                    notify_abort(*it, TransportAbortReason::Timeout);
                     frames.push_back(make_abort(*it, TransportAbortReason::Timeout));
+                    recycle(*it);
                     it = sessions_.erase(it);
                     continue;
                 }
 
                 ++it;
             }
+        }
 
-            return frames;
+        // ─── TX backpressure ─────────────────────────────────────────────────────
+        // While a port is paused no DT frames are generated for its sessions; they
+        // keep their place in the CTS window and resume once the port's transmit
+        // queue drains, instead of handing frames to a driver that drops them.
+        void pause_port(u8 port, bool paused) { paused_ports_.set(port, paused); }
+        bool port_paused(u8 port) const noexcept { return paused_ports_.contains(port); }
+
+        // ─── Bus-off hold ────────────────────────────────────────────────────────
+        // The timers of a held port's sessions stand still, so a controller that
+        // is bus-off for a moment neither times out nor aborts them. IsoNet
+        // holds a port (and pauses it) while it is bus-off.
+        void hold_port(u8 port, bool held) { held_ports_.set(port, held); }
+        bool port_held(u8 port) const noexcept { return held_ports_.contains(port); }
+
+        // Time until update() next has work: pending data or a timeout
+        u32 next_deadline_ms() const noexcept {
+            u32 next = NO_DEADLINE;
+            for (const auto &s : sessions_) {
+                if (port_held(s.can_port))
+                    continue;
+                if (s.state == SessionState::SendingData && s.direction == TransportDirection::Transmit) {
+                    if (!port_paused(s.can_port))
+                        next = 0;
+                } else if (s.state == SessionState::WaitingForCTS || s.state == SessionState::WaitingForData ||
+                           s.state == SessionState::WaitingForEndOfMsg) {
+                    next = earliest(next, time_left(s.timer_ms, ETP_TIMEOUT_T1_MS));
+                }
+            }
+            return next;
         }
 
+        // DPO + DT frames for every session inside a CTS window. Sessions to
+        // different destinations are interleaved: all DPOs first, then one DT per
+        // session per round.
         dp::Vector<Frame> get_pending_data_frames() {
             dp::Vector<Frame> frames;
+            get_pending_data_frames(frames);
+            return frames;
+        }
+
+        void get_pending_data_frames(dp::Vector<Frame> &frames) {
+            tx_ready_.clear();
             for (auto &session : sessions_) {
-                if (session.state == SessionState::SendingData && session.direction == TransportDirection::Transmit) {
-                    // Send DPO first
+                if (session.state == SessionState::SendingData && session.direction == TransportDirection::Transmit &&
+                    !port_paused(session.can_port)) {
                     frames.push_back(make_dpo(session));
-                    // Then data packets (sequence resets per DPO group)
-                    auto data_frames = generate_data_frames(session, session.packets_to_send);
-                    for (auto &f : data_frames)
-                        frames.push_back(std::move(f));
-
-                    if (session.bytes_transferred >= session.total_bytes) {
-                        // All data sent, wait for EOMA
-                        session.state = SessionState::WaitingForEndOfMsg;
-                        session.timer_ms = 0;
-                    } else {
-                        // Window complete, wait for next CTS
-                        session.state = SessionState::WaitingForCTS;
-                        session.timer_ms = 0;
-                    }
+                    session.last_sequence = 0; // Sequence restarts per DPO group
+                    tx_ready_.push_back(&session);
                 }
             }
-            return frames;
+            if (tx_ready_.empty())
+                return;
+
+            bool any = true;
+            while (any) {
+                any = false;
+                for (auto *session : tx_ready_) {
+                    if (session->packets_to_send == 0)
+                        continue;
+                    generate_data_frames(*session, 1, frames);
+                    --session->packets_to_send;
+                    if (session->bytes_transferred >= session->total_bytes)
+                        session->packets_to_send = 0;
+                    any = any || session->packets_to_send > 0;
+                }
+            }
+
+            for (auto *session : tx_ready_) {
+                // All data sent: wait for EOMA; otherwise window complete, wait for next CTS
+                session->state = session->bytes_transferred >= session->total_bytes ? SessionState::WaitingForEndOfMsg
+                                                                                     : SessionState::WaitingForCTS;
+                session->timer_ms = 0;
+            }
         }
 
         Event<TransportSession &> on_complete;
         Event<TransportSession &, TransportAbortReason> on_abort;
+        Event<TransportSession &, u32, DataSpan> on_chunk; // Streaming RX: (session, byte offset, bytes)
 
       private:
         Frame make_rts(const TransportSession &s) const noexcept {
@@ -220,17 +350,72 @@ namespace agrobus::net {
             return f;
         }
 
-        dp::Vector<Frame> generate_data_frames(TransportSession &session, u8 count) {
+        Result<void> check_send(PGN pgn, usize size, Address source, Address dest, u8 port) {
+            if (size > MAX_DATA_LENGTH) {
+                echo::category("isobus.transport.etp")
+                    .error("data exceeds ETP max: size=", size, " max=", MAX_DATA_LENGTH);
+                return Result<void>::err(Error(ErrorCode::BufferOverflow, "data exceeds ETP max"));
+            }
+            if (size <= TP_MAX_DATA_LENGTH) {
+                return Result<void>::err(Error::invalid_state("use TP for <= 1785 bytes"));
+            }
+            if (dest == BROADCAST_ADDRESS) {
+                return Result<void>::err(Error::invalid_state("ETP does not support broadcast"));
+            }
+
+            if (static_alloc::full(sessions_.size(), static_alloc::transport_sessions)) {
+                echo::category("isobus.transport.etp").error("session table full: pgn=", pgn);
+                return Result<void>::err(Error(ErrorCode::NoResources, "session table full"));
+            }
+
+            // Check for existing session by full key
+            for (const auto &s : sessions_) {
+                if (s.source_address == source && s.destination_address == dest && s.pgn == pgn &&
+                    s.direction == TransportDirection::Transmit && s.can_port == port) {
+                    echo::category("isobus.transport.etp")
+                        .error("session already active: pgn=", pgn, " src=", static_cast<u8>(source),
+                               " dst=", static_cast<u8>(dest));
+                    return Result<void>::err(Error(ErrorCode::SessionExists, "session already active"));
+                }
+            }
+            return {};
+        }
+
+        static TransportSession make_tx_session(PGN pgn, usize size, Address source, Address dest, u8 port,
+                                                Priority priority) {
+            TransportSession session;
+            session.direction = TransportDirection::Transmit;
+            session.state = SessionState::WaitingForCTS;
+            session.pgn = pgn;
+            session.total_bytes = static_cast<u32>(size);
+            session.source_address = source;
+            session.destination_address = dest;
+            session.can_port = port;
+            session.priority = priority;
+            return session;
+        }
+
+        Result<dp::Vector<Frame>> begin_send(TransportSession &&session) {
             dp::Vector<Frame> frames;
+            frames.push_back(make_rts(session));
+            echo::category("isobus.transport.etp")
+                .debug("ETP RTS sent: pgn=", session.pgn, " bytes=", session.total_bytes);
+            metrics_.started(session.can_port, session.pgn);
+            sessions_.push_back(std::move(session));
+            return Result<dp::Vector<Frame>>::ok(std::move(frames));
+        }
+
+        void generate_data_frames(TransportSession &session, u8 count, dp::Vector<Frame> &frames) {
+            const u8 *payload = session.payload();
             for (u8 i = 0; i < count && session.bytes_transferred < session.total_bytes; ++i) {
                 Frame f;
                 f.id = Identifier::encode(Priority::Lowest, PGN_ETP_DT, session.source_address,
                                           session.destination_address);
-                f.data[0] = i + 1; // Sequence number (1-based, resets per DPO group)
+                f.data[0] = ++session.last_sequence; // 1-based, resets per DPO group
 
                 for (u8 j = 0; j < 7; ++j) {
                     u32 idx = session.bytes_transferred + j;
-                    f.data[j + 1] = (idx < session.total_bytes) ? session.data[idx] : 0xFF;
+                    f.data[j + 1] = (idx < session.total_bytes) ? payload[idx] : 0xFF;
                 }
                 f.length = 8;
 
@@ -241,23 +426,75 @@ namespace agrobus::net {
 
                 frames.push_back(f);
             }
-            return frames;
+        }
+
+        void notify_complete(TransportSession &session) {
+            metrics_.completed(session.can_port, session.pgn, session.total_bytes, session.age_ms);
+            on_complete.emit(session);
+        }
+
+        void notify_abort(TransportSession &session, TransportAbortReason reason) {
+            metrics_.aborted(session.can_port, session.pgn, reason);
+            on_abort.emit(session, reason);
         }
 
         void erase_session(TransportSession *session) {
             for (auto it = sessions_.begin(); it != sessions_.end(); ++it) {
                 if (&(*it) == session) {
+                    recycle(*it);
                     sessions_.erase(it);
                     return;
                 }
             }
         }
 
-        dp::Vector<Frame> handle_cm(const Frame &frame, u8 port) {
-            dp::Vector<Frame> responses;
+        dp::Vector<u8> take_buffer(usize size) {
+            if (pool_)
+                return pool_->acquire(size);
+            return dp::Vector<u8>(size, 0xFF);
+        }
+
+        // Charge `bytes` of buffer for the session; false if the budget is spent
+        bool charge(TransportSession &session, u32 bytes) {
+            if (!budget_)
+                return true;
+            if (!budget_->charge(bytes).is_ok())
+                return false;
+            session.budget_bytes = bytes;
+            return true;
+        }
+
+        // Reserve a receive session against the limits; false if a cap is reached
+        bool admit(TransportSession &session, u32 bytes) {
+            if (!limits_)
+                return true;
+            if (!limits_->admit(session.can_port, session.source_address, bytes))
+                return false;
+            session.limit_bytes = bytes;
+            return true;
+        }
+
+        void unadmit(TransportSession &session) noexcept {
+            if (limits_ && session.limit_bytes > 0)
+                limits_->release(session.can_port, session.source_address, session.limit_bytes);
+            session.limit_bytes = 0;
+        }
+
+        // Return the session's buffer to the pool (no-op if it was moved out),
+        // its bytes to the budget and its reservation to the limits
+        void recycle(TransportSession &session) {
+            if (pool_)
+                pool_->release(std::move(session.data));
+            if (budget_ && session.budget_bytes > 0)
+                budget_->release(session.budget_bytes);
+            session.budget_bytes = 0;
+            unadmit(session);
+        }
+
+        void handle_cm(const Frame &frame, const FrameHeader &hdr, u8 port, dp::Vector<Frame> &responses) {
             u8 control_byte = frame.data[0];
-            Address src = frame.source();
-            Address dst = frame.destination();
+            Address src = hdr.source;
+            Address dst = hdr.destination;
 
             PGN cm_pgn = static_cast<u32>(frame.data[5]) | (static_cast<u32>(frame.data[6]) << 8) |
                          (static_cast<u32>(frame.data[7]) << 16);
@@ -266,6 +503,15 @@ namespace agrobus::net {
             case etp_cm::RTS: {
                 u32 msg_size = static_cast<u32>(frame.data[1]) | (static_cast<u32>(frame.data[2]) << 8) |
                                (static_cast<u32>(frame.data[3]) << 16) | (static_cast<u32>(frame.data[4]) << 24);
+                if (static_alloc::full(sessions_.size(), static_alloc::transport_sessions)) {
+                    echo::category("isobus.transport.etp").warn("RTS rejected, session table full: pgn=", cm_pgn);
+                    TransportSession tmp;
+                    tmp.source_address = dst;
+                    tmp.destination_address = src;
+                    tmp.pgn = cm_pgn;
+                    responses.push_back(make_abort(tmp, TransportAbortReason::ResourcesUnavailable));
+                    break;
+                }
 
                 TransportSession session;
                 session.direction = TransportDirection::Receive;
@@ -275,15 +521,41 @@ namespace agrobus::net {
                 session.source_address = src;
                 session.destination_address = dst;
                 session.can_port = port;
-                session.priority = frame.priority();
-                session.data.resize(msg_size, 0xFF);
+                session.priority = hdr.priority;
+                session.streaming = stream_filter_ && stream_filter_(cm_pgn, msg_size);
+                // A streaming session only ever buffers one window (<= 255 packets)
+                u32 buffer_bytes = session.streaming ? TP_MAX_DATA_LENGTH : msg_size;
+                if (!admit(session, buffer_bytes)) {
+                    echo::category("isobus.transport.etp")
+                        .warn("RTS rejected, transport limits reached: pgn=", cm_pgn, " source=", src);
+                    TransportSession tmp;
+                    tmp.source_address = dst;
+                    tmp.destination_address = src;
+                    tmp.pgn = cm_pgn;
+                    responses.push_back(make_abort(tmp, TransportAbortReason::ResourcesUnavailable));
+                    break;
+                }
+                if (!charge(session, buffer_bytes)) {
+                    echo::category("isobus.transport.etp").warn("RTS rejected, memory budget spent: pgn=", cm_pgn);
+                    unadmit(session);
+                    TransportSession tmp;
+                    tmp.source_address = dst;
+                    tmp.destination_address = src;
+                    tmp.pgn = cm_pgn;
+                    responses.push_back(make_abort(tmp, TransportAbortReason::ResourcesUnavailable));
+                    break;
+                }
+                session.data = take_buffer(buffer_bytes);
+                session.first_timestamp_us = frame.timestamp_us;
+                session.last_timestamp_us = frame.timestamp_us;
 
                 // Send CTS: request first window of packets
-                u8 packets = TP_MAX_PACKETS_PER_CTS;
+                u8 packets = cts_window_.initial(port, src);
                 u32 next_pkt = 1;
                 session.cts_window_size = packets;
                 responses.push_back(make_cts(dst, src, packets, next_pkt, cm_pgn));
 
+                metrics_.started(port, cm_pgn);
                 sessions_.push_back(std::move(session));
                 echo::category("isobus.transport.etp").debug("ETP RTS received: pgn=", cm_pgn, " bytes=", msg_size);
                 break;
@@ -295,12 +567,21 @@ namespace agrobus::net {
 
                 for (auto &s : sessions_) {
                     if (s.direction == TransportDirection::Transmit && s.source_address == dst &&
-                        s.destination_address == src && s.pgn == cm_pgn && s.state == SessionState::WaitingForCTS &&
-                        s.can_port == port) {
+                        s.destination_address == src && s.pgn == cm_pgn && s.can_port == port &&
+                        // After the last window a receiver may still ask for lost packets
+                        (s.state == SessionState::WaitingForCTS || s.state == SessionState::WaitingForEndOfMsg)) {
+                        // Time since the RTS or the end of our last window
+                        metrics_.cts_round_trip(port, cm_pgn, s.timer_ms);
                         if (num_packets == 0) {
                             // CTS hold
                             s.timer_ms = 0;
                         } else {
+                            // Receiver asked again for packets it was already sent
+                            u32 sent = (s.bytes_transferred + 6) / 7;
+                            if (next_pkt >= 1 && next_pkt <= sent) {
+                                u32 again = sent - next_pkt + 1;
+                                metrics_.retransmits(port, cm_pgn, again < num_packets ? again : num_packets);
+                            }
                             s.state = SessionState::SendingData;
                             s.packets_to_send = num_packets;
                             // Resume at the packet offset specified by CTS
@@ -326,6 +607,7 @@ namespace agrobus::net {
                         s.dpo_packet_offset = packet_offset;
                         s.cts_window_size = num_packets;
                         s.last_sequence = 0; // Reset sequence counter for new DPO group
+                        s.awaiting_resend = false;
                         s.timer_ms = 0;
                         echo::category("isobus.transport.etp")
                             .debug("ETP DPO: offset=", packet_offset, " packets=", num_packets);
@@ -339,7 +621,8 @@ namespace agrobus::net {
                     if (it->direction == TransportDirection::Transmit && it->source_address == dst &&
                         it->destination_address == src && it->pgn == cm_pgn && it->can_port == port) {
                         it->state = SessionState::Complete;
-                        on_complete.emit(*it);
+                        notify_complete(*it);
+                        recycle(*it);
                         sessions_.erase(it);
                         echo::category("isobus.transport.etp").debug("ETP complete");
                         break;
@@ -356,7 +639,8 @@ namespace agrobus::net {
                         echo::category("isobus.transport.etp")
                             .warn("ETP abort received: pgn=", cm_pgn, " reason=", static_cast<u8>(reason));
                         it->state = SessionState::Aborted;
-                        on_abort.emit(*it, reason);
+                        notify_abort(*it, reason);
+                        recycle(*it);
                         sessions_.erase(it);
                         break;
                     }
@@ -364,13 +648,36 @@ namespace agrobus::net {
                 break;
             }
             }
-            return responses;
         }
 
-        dp::Vector<Frame> handle_dt(const Frame &frame, u8 port) {
-            dp::Vector<Frame> responses;
-            Address src = frame.source();
-            Address dst = frame.destination();
+        // A DT went missing: CTS for the rest of the DPO group starting at `next`,
+        // so one lost frame costs a round trip instead of the whole transfer.
+        // False once the window has used up its retries.
+        bool request_missing(TransportSession &session, u8 next, u8 port, dp::Vector<Frame> &responses) {
+            if (session.gap_requests >= cts_window_.config().gap_retries)
+                return false;
+            ++session.gap_requests;
+            cts_window_.failed(port, session.source_address);
+            if (session.streaming && next > 1) {
+                // The resend opens a new DPO group; hand out what arrived before the gap
+                u32 window_offset = session.dpo_packet_offset * 7;
+                on_chunk.emit(session, window_offset,
+                              DataSpan(session.data.data(), (static_cast<u32>(next) - 1) * 7));
+            }
+            u32 next_pkt = session.dpo_packet_offset + next;
+            u8 count = session.cts_window_size >= next ? static_cast<u8>(session.cts_window_size - next + 1) : 1;
+            session.awaiting_resend = true;
+            session.timer_ms = 0;
+            responses.push_back(
+                make_cts(session.destination_address, session.source_address, count, next_pkt, session.pgn));
+            echo::category("isobus.transport.etp")
+                .debug("DT gap: pgn=", session.pgn, " asking again from ", next_pkt, " packets=", count);
+            return true;
+        }
+
+        void handle_dt(const Frame &frame, const FrameHeader &hdr, u8 port, dp::Vector<Frame> &responses) {
+            Address src = hdr.source;
+            Address dst = hdr.destination;
             u8 seq = frame.data[0]; // Sequence within current DPO group
 
             // Find RX session
@@ -383,24 +690,35 @@ namespace agrobus::net {
                 }
             }
             if (!session) {
-                return responses;
+                return;
             }
 
             // Validate sequence (within DPO group, 1-based)
             u8 expected_seq = session->last_sequence + 1;
             if (seq != expected_seq) {
-                echo::category("isobus.transport.etp").warn("ETP bad seq=", seq, " expected=", expected_seq);
+                // Rest of the window that was in flight when the gap was found; the
+                // sender's next DPO starts the resend
+                if (session->awaiting_resend)
+                    return;
+                AGROBUS_TRACE_WARN(TraceEvent::EtpBadSequence, session->pgn, seq, expected_seq);
+                if (seq > expected_seq && request_missing(*session, expected_seq, port, responses))
+                    return;
+                cts_window_.failed(port, src);
                 responses.push_back(make_abort(*session, TransportAbortReason::BadSequence));
                 session->state = SessionState::Aborted;
-                on_abort.emit(*session, TransportAbortReason::BadSequence);
+                notify_abort(*session, TransportAbortReason::BadSequence);
                 erase_session(session);
-                return responses;
+                return;
             }
 
             // Calculate byte offset using DPO packet offset
             u32 byte_offset = (session->dpo_packet_offset + static_cast<u32>(seq) - 1) * 7;
+            u32 window_offset = session->dpo_packet_offset * 7;
+            u32 base = session->streaming ? window_offset : 0;
             for (u8 i = 0; i < 7 && (byte_offset + i) < session->total_bytes; ++i) {
-                session->data[byte_offset + i] = frame.data[i + 1];
+                u32 idx = byte_offset + i - base;
+                if (idx < session->data.size())
+                    session->data[idx] = frame.data[i + 1];
             }
             u32 end = byte_offset + 7;
             if (end > session->total_bytes) {
@@ -408,28 +726,41 @@ namespace agrobus::net {
             }
             session->bytes_transferred = end;
             session->last_sequence = seq;
+            if (session->timer_ms > session->window_gap_ms)
+                session->window_gap_ms = session->timer_ms;
             session->timer_ms = 0;
+            session->last_timestamp_us = frame.timestamp_us;
+
+            bool window_done = session->bytes_transferred >= session->total_bytes || seq >= session->cts_window_size;
+            u8 next_window = 0;
+            if (window_done) {
+                next_window = cts_window_.window_done(port, src, session->window_gap_ms);
+                session->window_gap_ms = 0;
+                if (session->streaming)
+                    on_chunk.emit(*session, window_offset, DataSpan(session->data.data(), end - window_offset));
+            }
 
             if (session->bytes_transferred >= session->total_bytes) {
                 // Complete - send EOMA
                 session->state = SessionState::Complete;
+                if (session->streaming)
+                    session->data.clear(); // Everything was delivered through on_chunk
                 responses.push_back(make_eoma(session->destination_address, session->source_address,
                                               session->total_bytes, session->pgn));
-                on_complete.emit(*session);
+                notify_complete(*session);
                 erase_session(session);
                 echo::category("isobus.transport.etp").debug("ETP RX complete");
             } else if (seq >= session->cts_window_size) {
                 // Window exhausted - send next CTS
+                session->gap_requests = 0;
                 u32 next_pkt = session->dpo_packet_offset + seq + 1;
                 u32 remaining_packets = (session->total_bytes - session->bytes_transferred + 6) / 7;
-                u8 next_count = (remaining_packets < TP_MAX_PACKETS_PER_CTS) ? static_cast<u8>(remaining_packets)
-                                                                             : TP_MAX_PACKETS_PER_CTS;
+                u8 next_count =
+                    (remaining_packets < next_window) ? static_cast<u8>(remaining_packets) : next_window;
                 responses.push_back(make_cts(session->destination_address, session->source_address, next_count,
                                              next_pkt, session->pgn));
                 session->cts_window_size = next_count;
             }
-
-            return responses;
         }
     };
 } // namespace agrobus::net
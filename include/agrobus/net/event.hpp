@@ -1,5 +1,8 @@
 #pragma once
 
+#include <agrobus/net/delegate.hpp>
+#include <agrobus/net/error.hpp>
+#include <agrobus/net/static_alloc.hpp>
 #include <agrobus/net/types.hpp>
 #include <datapod/datapod.hpp>
 #include <functional>
@@ -13,34 +16,58 @@ namespace agrobus::net {
     // ─── Type-safe event dispatcher ──────────────────────────────────────────────
     // Supports:
     //   - subscribe/unsubscribe with tokens
-    //   - safe removal during dispatch (deferred)
+    //   - safe removal during dispatch (deferred, swept only when one happened)
     //   - operator+= for convenience
+    // Listeners are Delegates, so a typical lambda is stored without allocating.
+    // In the static allocation profile the listener list is reserved for
+    // AGROBUS_MAX_EVENT_LISTENERS on the first subscribe and never grows past
+    // it: subscribe() returns INVALID_TOKEN and try_subscribe() an error.
     template <typename... Args> class Event {
+      public:
+        using Callback = Delegate<void(Args...)>;
+
+      private:
         struct Listener {
             ListenerToken token = 0;
-            std::function<void(Args...)> fn;
+            Callback fn;
             bool pending_remove = false;
         };
 
         dp::Vector<Listener> listeners_;
         ListenerToken next_token_ = 1;
-        bool dispatching_ = false;
+        u32 depth_ = 0;     // Nested emit() calls in progress
+        bool dirty_ = false; // A removal was deferred during dispatch
 
       public:
         // Subscribe and get a token for later removal
-        ListenerToken subscribe(std::function<void(Args...)> fn) {
+        ListenerToken subscribe(Callback fn) {
+            if constexpr (static_alloc::enabled) {
+                if (listeners_.capacity() < static_alloc::event_listeners)
+                    listeners_.reserve(static_alloc::event_listeners);
+                if (static_alloc::full(listeners_.size(), static_alloc::event_listeners))
+                    return INVALID_TOKEN;
+            }
             ListenerToken token = next_token_++;
             listeners_.push_back({token, std::move(fn), false});
             return token;
         }
 
+        // subscribe() that reports a full listener list
+        Result<ListenerToken> try_subscribe(Callback fn) {
+            ListenerToken token = subscribe(std::move(fn));
+            if (token == INVALID_TOKEN)
+                return Result<ListenerToken>::err(static_alloc::exhausted("event listeners full"));
+            return Result<ListenerToken>::ok(token);
+        }
+
         // Remove a listener by token
         bool unsubscribe(ListenerToken token) {
             for (auto it = listeners_.begin(); it != listeners_.end(); ++it) {
-                if (it->token == token) {
-                    if (dispatching_) {
+                if (it->token == token && !it->pending_remove) {
+                    if (depth_ > 0) {
                         // Defer removal until dispatch is complete
                         it->pending_remove = true;
+                        dirty_ = true;
                     } else {
                         listeners_.erase(it);
                     }
@@ -51,15 +78,44 @@ namespace agrobus::net {
         }
 
         void emit(Args... args) {
-            dispatching_ = true;
-            for (auto &listener : listeners_) {
+            ++depth_;
+            // Indexed: listeners subscribed during dispatch may grow the vector
+            // and only see the next emit()
+            for (usize i = 0, n = listeners_.size(); i < n; ++i) {
+                Listener &listener = listeners_[i];
                 if (!listener.pending_remove && listener.fn) {
                     listener.fn(args...);
                 }
             }
-            dispatching_ = false;
+            if (--depth_ == 0 && dirty_)
+                sweep();
+        }
+
+        dp::usize count() const noexcept {
+            dp::usize active = 0;
+            for (const auto &l : listeners_) {
+                if (!l.pending_remove)
+                    active++;
+            }
+            return active;
+        }
+
+        void clear() {
+            if (depth_ == 0) {
+                listeners_.clear();
+                return;
+            }
+            for (auto &l : listeners_)
+                l.pending_remove = true;
+            dirty_ = true;
+        }
 
-            // Clean up deferred removals
+        ListenerToken operator+=(Callback fn) { return subscribe(std::move(fn)); }
+
+      private:
+        // Drop listeners whose removal was deferred
+        void sweep() {
+            dirty_ = false;
             for (auto it = listeners_.begin(); it != listeners_.end();) {
                 if (it->pending_remove) {
                     it = listeners_.erase(it);
@@ -68,18 +124,111 @@ namespace agrobus::net {
                 }
             }
         }
+    };
+
+    // ─── Fixed-capacity event ────────────────────────────────────────────────────
+    // Same interface as Event, for targets that must not allocate at all:
+    // listener slots are a dp::Array of N, delegates are inline-only (a
+    // callable that does not fit is a compile error) and subscribe() returns
+    // INVALID_TOKEN once all slots are taken.
+    template <usize N, typename... Args> class StaticEvent {
+      public:
+        using Callback = Delegate<void(Args...), DELEGATE_INLINE_BYTES, false>;
+        static constexpr usize capacity = N;
+
+      private:
+        struct Listener {
+            ListenerToken token = INVALID_TOKEN; // INVALID_TOKEN = free slot
+            Callback fn;
+            bool pending_remove = false;
+        };
+
+        dp::Array<Listener, N> listeners_ = {};
+        ListenerToken next_token_ = 1;
+        u32 depth_ = 0;
+        bool dirty_ = false;
+
+      public:
+        ListenerToken subscribe(Callback fn) {
+            for (auto &l : listeners_) {
+                if (l.token == INVALID_TOKEN) {
+                    l.token = next_token_++;
+                    if (next_token_ == INVALID_TOKEN)
+                        next_token_ = 1;
+                    l.fn = std::move(fn);
+                    l.pending_remove = false;
+                    return l.token;
+                }
+            }
+            return INVALID_TOKEN;
+        }
+
+        bool unsubscribe(ListenerToken token) {
+            if (token == INVALID_TOKEN)
+                return false;
+            for (auto &l : listeners_) {
+                if (l.token == token && !l.pending_remove) {
+                    if (depth_ > 0) {
+                        l.pending_remove = true;
+                        dirty_ = true;
+                    } else {
+                        release(l);
+                    }
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        // Slots are filled lowest-first, so listeners run in subscription order
+        // unless a slot was freed and reused
+        void emit(Args... args) {
+            ++depth_;
+            for (auto &l : listeners_) {
+                if (l.token != INVALID_TOKEN && !l.pending_remove && l.fn)
+                    l.fn(args...);
+            }
+            if (--depth_ == 0 && dirty_)
+                sweep();
+        }
 
         dp::usize count() const noexcept {
             dp::usize active = 0;
             for (const auto &l : listeners_) {
-                if (!l.pending_remove)
+                if (l.token != INVALID_TOKEN && !l.pending_remove)
                     active++;
             }
             return active;
         }
 
-        void clear() { listeners_.clear(); }
+        void clear() {
+            for (auto &l : listeners_) {
+                if (l.token == INVALID_TOKEN)
+                    continue;
+                if (depth_ > 0) {
+                    l.pending_remove = true;
+                    dirty_ = true;
+                } else {
+                    release(l);
+                }
+            }
+        }
+
+        ListenerToken operator+=(Callback fn) { return subscribe(std::move(fn)); }
 
-        ListenerToken operator+=(std::function<void(Args...)> fn) { return subscribe(std::move(fn)); }
+      private:
+        static void release(Listener &l) {
+            l.token = INVALID_TOKEN;
+            l.fn.reset();
+            l.pending_remove = false;
+        }
+
+        void sweep() {
+            dirty_ = false;
+            for (auto &l : listeners_) {
+                if (l.token != INVALID_TOKEN && l.pending_remove)
+                    release(l);
+            }
+        }
     };
 } // namespace agrobus::net
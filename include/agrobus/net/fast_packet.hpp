@@ -1,39 +1,142 @@
 #pragma once
 
 #include "session.hpp"
+#include "transport_metrics.hpp"
 #include <agrobus/net/error.hpp>
 #include <agrobus/net/event.hpp>
 #include <agrobus/net/frame.hpp>
 #include <agrobus/net/identifier.hpp>
+#include <agrobus/net/timer.hpp>
 #include <agrobus/net/message.hpp>
+#include <agrobus/net/trace.hpp>
 #include <datapod/datapod.hpp>
 #include <echo/echo.hpp>
 
 namespace agrobus::net {
 
+    // ─── Fast packet PGN registry ────────────────────────────────────────────────
+    // Set of PGNs that use fast packet on this network. PGNs in the NMEA 2000
+    // fast-packet range (0x1F000-0x1FFFF) live in a 4096-bit bitset, so the
+    // per-frame check is a shift and a mask; any other PGN goes to a small
+    // overflow list that is normally empty.
+    class FastPacketRegistry {
+        static constexpr PGN RANGE_FIRST = 0x1F000;
+        static constexpr PGN RANGE_SIZE = 0x1000;
+
+        dp::Array<u64, RANGE_SIZE / 64> bits_ = {};
+        dp::Vector<PGN> overflow_;
+        usize count_ = 0;
+
+      public:
+        // Returns false if the PGN was already registered
+        bool add(PGN pgn) {
+            if (contains(pgn))
+                return false;
+            if (in_range(pgn)) {
+                PGN i = pgn - RANGE_FIRST;
+                bits_[i >> 6] |= u64{1} << (i & 63);
+            } else {
+                overflow_.push_back(pgn);
+            }
+            ++count_;
+            return true;
+        }
+
+        bool contains(PGN pgn) const noexcept {
+            if (in_range(pgn)) {
+                PGN i = pgn - RANGE_FIRST;
+                return (bits_[i >> 6] >> (i & 63)) & 1;
+            }
+            for (PGN p : overflow_) {
+                if (p == pgn)
+                    return true;
+            }
+            return false;
+        }
+
+        usize size() const noexcept { return count_; }
+        bool empty() const noexcept { return count_ == 0; }
+
+        // Call fn(PGN) for every registered PGN
+        template <typename Fn> void for_each(Fn &&fn) const {
+            for (PGN i = 0; i < RANGE_SIZE; ++i) {
+                if ((bits_[i >> 6] >> (i & 63)) & 1)
+                    fn(RANGE_FIRST + i);
+            }
+            for (PGN p : overflow_)
+                fn(p);
+        }
+
+      private:
+        static constexpr bool in_range(PGN pgn) noexcept { return pgn >= RANGE_FIRST && pgn < RANGE_FIRST + RANGE_SIZE; }
+    };
+
     // ─── NMEA2000 Fast Packet Protocol ──────────────────────────────────────────
     // Used for messages 9-223 bytes on NMEA2000 networks
     // First frame: [seq_counter:3|frame_counter:5][total_bytes][6 data bytes]
     // Subsequent:  [seq_counter:3|frame_counter:5][7 data bytes]
+    //
+    // Reassembly uses a fixed table of slots keyed on (source, PGN, sequence
+    // counter), each with an inline 223-byte buffer, so receiving never
+    // allocates and the state has a fixed size. When every slot is busy a new
+    // first frame evicts the least recently active reassembly.
     class FastPacketProtocol {
         struct FastPacketSession {
+            dp::Array<u8, FAST_PACKET_MAX_DATA> data;
             PGN pgn = 0;
-            dp::Vector<u8> data;
             u32 total_bytes = 0;
             u32 bytes_received = 0;
             u8 source_address = NULL_ADDRESS;
             u8 sequence_counter = 0;
             u8 expected_frame = 0;
+            u8 can_port = 0;
             u32 timer_ms = 0;
+            u32 last_active = 0; // Activity stamp for LRU eviction
+            u64 first_timestamp_us = 0;
+            u64 last_timestamp_us = 0;
         };
 
-        dp::Vector<FastPacketSession> rx_sessions_;
+        static constexpr u32 FREE = 0xFFFFFFFF;
+        static constexpr u32 SOURCE_PGN_MASK = 0x03FFFFFF; // Key bits without the sequence counter
+
+        dp::Vector<FastPacketSession> rx_slots_;
+        dp::Vector<u32> rx_keys_; // Slot key or FREE, scanned densely
+        usize rx_active_ = 0;
+        u32 activity_ = 0;
+        u64 evictions_ = 0;
+        TransportMetrics metrics_;
+        dp::Array<u8, 6> single_ = {}; // Payload of a first frame that completes on its own
         u8 tx_sequence_counter_ = 0;
 
       public:
         static constexpr u32 MAX_DATA_LENGTH = FAST_PACKET_MAX_DATA;
         static constexpr u32 FIRST_FRAME_DATA = 6;
         static constexpr u32 SUBSEQUENT_FRAME_DATA = 7;
+        static constexpr usize DEFAULT_RX_SLOTS = 32;
+
+        // rx_slots bounds concurrent reassemblies (allocated once)
+        explicit FastPacketProtocol(usize rx_slots = DEFAULT_RX_SLOTS) {
+            if (rx_slots == 0)
+                rx_slots = 1;
+            rx_slots_.resize(rx_slots);
+            rx_keys_.resize(rx_slots, FREE);
+        }
+
+        static constexpr u32 make_key(Address src, PGN pgn, u8 seq_counter) noexcept {
+            return (static_cast<u32>(seq_counter & 0x07) << 26) | ((pgn & 0x3FFFF) << 8) | static_cast<u32>(src);
+        }
+
+        usize rx_capacity() const noexcept { return rx_slots_.size(); }
+        usize rx_active() const noexcept { return rx_active_; }
+        u64 rx_evictions() const noexcept { return evictions_; }
+
+        // Reassembly counters per port and PGN (evictions count as ResourcesUnavailable)
+        const TransportMetrics &metrics() const noexcept { return metrics_; }
+        TransportMetrics &metrics() noexcept { return metrics_; }
+
+        // Sequence counter (0-7) for the next outgoing message; shared with
+        // callers that segment into their own frames
+        u8 next_tx_sequence() noexcept { return tx_sequence_counter_++ & 0x07; }
 
         // ─── Send a fast packet message ─────────────────────────────────────────
         Result<dp::Vector<Frame>> send(PGN pgn, const dp::Vector<u8> &data, Address source) {
@@ -45,7 +148,7 @@ namespace agrobus::net {
             }
 
             dp::Vector<Frame> frames;
-            u8 seq = (tx_sequence_counter_++ & 0x07) << 5;
+            u8 seq = next_tx_sequence() << 5;
             u8 total_frames = 1 + static_cast<u8>((data.size() - FIRST_FRAME_DATA + SUBSEQUENT_FRAME_DATA - 1) /
                                                   SUBSEQUENT_FRAME_DATA);
 
@@ -77,113 +180,202 @@ namespace agrobus::net {
                 offset += SUBSEQUENT_FRAME_DATA;
             }
 
-            echo::category("isobus.transport.fp").debug("Fast packet sent: pgn=", pgn, " bytes=", data.size());
+            AGROBUS_TRACE_DEBUG(TraceEvent::FastPacketSent, pgn, data.size(), source);
             return Result<dp::Vector<Frame>>::ok(std::move(frames));
         }
 
         // ─── Process incoming frame ──────────────────────────────────────────────
-        dp::Optional<Message> process_frame(const Frame &frame) {
+        // Returns a view of the completed message; it stays valid until the next
+        // call to process_frame_view() / process_frame(). `port` only labels metrics.
+        dp::Optional<MessageView> process_frame_view(const Frame &frame, u8 port = 0) {
+            return process_frame_view(frame, frame.header(), port);
+        }
+
+        // With the identifier already decoded by the caller
+        dp::Optional<MessageView> process_frame_view(const Frame &frame, const FrameHeader &hdr, u8 port) {
             u8 frame_counter = frame.data[0] & 0x1F;
             u8 seq_counter = (frame.data[0] >> 5) & 0x07;
-            Address src = frame.source();
-            PGN pgn = frame.pgn();
+            Address src = hdr.source;
+            PGN pgn = hdr.pgn;
+            u32 key = make_key(src, pgn, seq_counter);
+            ++activity_;
 
             if (frame_counter == 0) {
                 // First frame of a new fast packet
                 u8 total_bytes = frame.data[1];
+                if (total_bytes > MAX_DATA_LENGTH)
+                    total_bytes = static_cast<u8>(MAX_DATA_LENGTH);
+
+                // A new first frame replaces any reassembly for the same source/pgn
+                remove_session(key);
+
+                u8 copy_len =
+                    (total_bytes < FIRST_FRAME_DATA) ? static_cast<u8>(total_bytes) : static_cast<u8>(FIRST_FRAME_DATA);
+                if (copy_len >= total_bytes) {
+                    // Single-frame fast packet (unlikely but possible)
+                    metrics_.started(port, pgn);
+                    metrics_.completed(port, pgn, copy_len, 0);
+                    for (u8 i = 0; i < copy_len; ++i)
+                        single_[i] = frame.data[i + 2];
+                    MessageView view(pgn, DataSpan(single_.data(), copy_len), src, BROADCAST_ADDRESS, Priority::Default,
+                                     frame.timestamp_us);
+                    return view;
+                }
 
-                FastPacketSession session;
+                usize slot = claim_slot();
+                rx_keys_[slot] = key;
+                ++rx_active_;
+                FastPacketSession &session = rx_slots_[slot];
                 session.pgn = pgn;
                 session.total_bytes = total_bytes;
                 session.source_address = src;
                 session.sequence_counter = seq_counter;
                 session.expected_frame = 1;
-                session.data.resize(total_bytes, 0xFF);
-
-                u8 copy_len =
-                    (total_bytes < FIRST_FRAME_DATA) ? static_cast<u8>(total_bytes) : static_cast<u8>(FIRST_FRAME_DATA);
-                for (u8 i = 0; i < copy_len; ++i) {
+                session.can_port = port;
+                session.timer_ms = 0;
+                session.last_active = activity_;
+                session.first_timestamp_us = frame.timestamp_us;
+                session.last_timestamp_us = frame.timestamp_us;
+                for (u8 i = 0; i < copy_len; ++i)
                     session.data[i] = frame.data[i + 2];
-                }
+                for (u32 i = copy_len; i < total_bytes; ++i)
+                    session.data[i] = 0xFF;
                 session.bytes_received = copy_len;
-
-                if (session.bytes_received >= session.total_bytes) {
-                    // Single-frame fast packet (unlikely but possible)
-                    return make_message(session);
-                }
-
-                // Remove any existing session for same source/pgn
-                remove_session(src, pgn);
-                rx_sessions_.push_back(std::move(session));
+                metrics_.started(port, pgn);
                 return dp::nullopt;
             }
 
             // Subsequent frame
-            for (auto it = rx_sessions_.begin(); it != rx_sessions_.end(); ++it) {
-                if (it->source_address == src && it->pgn == pgn && it->sequence_counter == seq_counter) {
-                    if (frame_counter != it->expected_frame) {
-                        // Bad sequence - discard
-                        echo::category("isobus.transport.fp")
-                            .warn("Bad sequence: expected=", it->expected_frame, " got=", frame_counter);
-                        rx_sessions_.erase(it);
-                        return dp::nullopt;
-                    }
-
-                    usize offset = FIRST_FRAME_DATA + (frame_counter - 1) * SUBSEQUENT_FRAME_DATA;
-                    for (u8 i = 0; i < 7 && (offset + i) < it->total_bytes; ++i) {
-                        it->data[offset + i] = frame.data[i + 1];
-                    }
-                    it->bytes_received = static_cast<u32>(offset + 7);
-                    if (it->bytes_received > it->total_bytes) {
-                        it->bytes_received = it->total_bytes;
-                    }
-                    it->expected_frame++;
-                    it->timer_ms = 0;
-
-                    if (it->bytes_received >= it->total_bytes) {
-                        auto msg = make_message(*it);
-                        rx_sessions_.erase(it);
-                        return msg;
-                    }
-                    return dp::nullopt;
-                }
+            usize slot = find_slot(key);
+            if (slot == rx_slots_.size())
+                return dp::nullopt;
+            FastPacketSession &session = rx_slots_[slot];
+            if (frame_counter != session.expected_frame) {
+                // Bad sequence - discard
+                AGROBUS_TRACE_WARN(TraceEvent::FastPacketBadSequence, session.pgn, frame_counter,
+                                   session.expected_frame);
+                drop_slot(slot, TransportAbortReason::BadSequence);
+                return dp::nullopt;
             }
 
+            usize offset = FIRST_FRAME_DATA + (frame_counter - 1) * SUBSEQUENT_FRAME_DATA;
+            for (u8 i = 0; i < 7 && (offset + i) < session.total_bytes; ++i) {
+                session.data[offset + i] = frame.data[i + 1];
+            }
+            session.bytes_received = static_cast<u32>(offset + 7);
+            if (session.bytes_received > session.total_bytes) {
+                session.bytes_received = session.total_bytes;
+            }
+            session.expected_frame++;
+            session.timer_ms = 0;
+            session.last_active = activity_;
+            session.last_timestamp_us = frame.timestamp_us;
+
+            if (session.bytes_received >= session.total_bytes) {
+                // The slot is released but its buffer is untouched until reused,
+                // which cannot happen before the next call
+                u64 span_us = session.last_timestamp_us > session.first_timestamp_us
+                                  ? session.last_timestamp_us - session.first_timestamp_us
+                                  : 0;
+                metrics_.completed(session.can_port, session.pgn, session.total_bytes, static_cast<u32>(span_us / 1000));
+                free_slot(slot);
+                return make_view(session);
+            }
             return dp::nullopt;
         }
 
+        dp::Optional<Message> process_frame(const Frame &frame, u8 port = 0) {
+            auto view = process_frame_view(frame, port);
+            if (!view.has_value())
+                return dp::nullopt;
+            return view->to_message();
+        }
+
         void update(u32 elapsed_ms) {
-            for (auto it = rx_sessions_.begin(); it != rx_sessions_.end();) {
-                it->timer_ms += elapsed_ms;
-                if (it->timer_ms >= TP_TIMEOUT_T1_MS) {
-                    echo::category("isobus.transport.fp").warn("Fast packet timeout: pgn=", it->pgn);
-                    it = rx_sessions_.erase(it);
-                } else {
-                    ++it;
+            if (rx_active_ == 0)
+                return;
+            for (usize i = 0; i < rx_slots_.size(); ++i) {
+                if (rx_keys_[i] == FREE)
+                    continue;
+                auto &s = rx_slots_[i];
+                s.timer_ms += elapsed_ms;
+                if (s.timer_ms >= TP_TIMEOUT_T1_MS) {
+                    echo::category("isobus.transport.fp").warn("Fast packet timeout: pgn=", s.pgn);
+                    drop_slot(i, TransportAbortReason::Timeout);
                 }
             }
         }
 
+        // Time until the oldest incomplete reassembly times out
+        u32 next_deadline_ms() const noexcept {
+            u32 next = NO_DEADLINE;
+            if (rx_active_ == 0)
+                return next;
+            for (usize i = 0; i < rx_slots_.size(); ++i) {
+                if (rx_keys_[i] != FREE)
+                    next = earliest(next, time_left(rx_slots_[i].timer_ms, TP_TIMEOUT_T1_MS));
+            }
+            return next;
+        }
+
         Event<const Message &> on_message;
 
       private:
-        void remove_session(Address src, PGN pgn) {
-            for (auto it = rx_sessions_.begin(); it != rx_sessions_.end(); ++it) {
-                if (it->source_address == src && it->pgn == pgn) {
-                    rx_sessions_.erase(it);
+        usize find_slot(u32 key) const noexcept {
+            for (usize i = 0; i < rx_keys_.size(); ++i) {
+                if (rx_keys_[i] == key)
+                    return i;
+            }
+            return rx_keys_.size();
+        }
+
+        // Drop a reassembly for the same source and PGN (any sequence counter)
+        void remove_session(u32 key) {
+            if (rx_active_ == 0)
+                return;
+            for (usize i = 0; i < rx_keys_.size(); ++i) {
+                if (rx_keys_[i] != FREE && (rx_keys_[i] & SOURCE_PGN_MASK) == (key & SOURCE_PGN_MASK)) {
+                    drop_slot(i, TransportAbortReason::AlreadyInSession);
                     return;
                 }
             }
         }
 
-        Message make_message(const FastPacketSession &session) const {
-            Message msg;
-            msg.pgn = session.pgn;
-            msg.source = session.source_address;
-            msg.destination = BROADCAST_ADDRESS;
-            msg.priority = Priority::Default;
-            msg.data = session.data;
-            return msg;
+        // A free slot, evicting the least recently active reassembly if needed
+        usize claim_slot() {
+            usize oldest = 0;
+            for (usize i = 0; i < rx_keys_.size(); ++i) {
+                if (rx_keys_[i] == FREE)
+                    return i;
+                if (activity_ - rx_slots_[i].last_active > activity_ - rx_slots_[oldest].last_active)
+                    oldest = i;
+            }
+            echo::category("isobus.transport.fp").debug("Fast packet table full, evicting pgn=", rx_slots_[oldest].pgn);
+            ++evictions_;
+            drop_slot(oldest, TransportAbortReason::ResourcesUnavailable);
+            return oldest;
+        }
+
+        // Free an unfinished reassembly, counting it as aborted
+        void drop_slot(usize slot, TransportAbortReason reason) {
+            if (rx_keys_[slot] == FREE)
+                return;
+            metrics_.aborted(rx_slots_[slot].can_port, rx_slots_[slot].pgn, reason);
+            free_slot(slot);
+        }
+
+        void free_slot(usize slot) noexcept {
+            if (rx_keys_[slot] == FREE)
+                return;
+            rx_keys_[slot] = FREE;
+            --rx_active_;
+        }
+
+        MessageView make_view(const FastPacketSession &session) const {
+            MessageView view(session.pgn, DataSpan(session.data.data(), session.total_bytes), session.source_address,
+                             BROADCAST_ADDRESS, Priority::Default, session.last_timestamp_us);
+            view.first_timestamp_us = session.first_timestamp_us;
+            return view;
         }
     };
 } // namespace agrobus::net
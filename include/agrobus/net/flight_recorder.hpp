@@ -0,0 +1,227 @@
+#pragma once
+
+#include "capture.hpp"
+#include "error.hpp"
+#include "event.hpp"
+#include "frame.hpp"
+#include "policy.hpp"
+#include "types.hpp"
+#include <algorithm>
+#include <datapod/datapod.hpp>
+#include <echo/echo.hpp>
+#include <string>
+
+namespace agrobus::net {
+
+    // ─── What froze the recorder ─────────────────────────────────────────────────
+    enum class FlightTrigger : u8 {
+        Manual,           // freeze() from the application
+        SafetyState,      // SafetyPolicy state change (watch())
+        TransportAbort,   // TP or ETP session aborted, either direction
+        AddressViolation, // Another device used one of our claimed addresses
+        DiagnosticLamp    // A DM1 turned a lamp on
+    };
+
+    inline const char *flight_trigger_name(FlightTrigger t) noexcept {
+        switch (t) {
+        case FlightTrigger::Manual:
+            return "manual";
+        case FlightTrigger::SafetyState:
+            return "safety state";
+        case FlightTrigger::TransportAbort:
+            return "transport abort";
+        case FlightTrigger::AddressViolation:
+            return "address violation";
+        case FlightTrigger::DiagnosticLamp:
+            return "diagnostic lamp";
+        }
+        return "unknown";
+    }
+
+    struct FlightFreeze {
+        FlightTrigger trigger = FlightTrigger::Manual;
+        Address source = NULL_ADDRESS; // The node involved, when there is one
+        u64 timestamp_us = 0;          // Newest frame in the recorder at the freeze
+        u32 sequence = 0;              // Freezes so far, this one included
+    };
+
+    // ─── Flight Recorder Config ──────────────────────────────────────────────────
+    struct FlightRecorderConfig {
+        u8 num_ports = 1;
+        u32 frames_per_port = 4096; // Ring size; 24 bytes a frame
+        u32 window_ms = 10000;      // Frames older than this before the newest are left out of a snapshot
+        dp::String dump_prefix;     // Freezes are written to <prefix><sequence>.cap; empty = kept in memory
+
+        FlightRecorderConfig &ports(u8 n) {
+            num_ports = n == 0 ? 1 : n;
+            return *this;
+        }
+        FlightRecorderConfig &frames(u32 n) {
+            frames_per_port = n == 0 ? 1 : n;
+            return *this;
+        }
+        FlightRecorderConfig &window(u32 ms) {
+            window_ms = ms;
+            return *this;
+        }
+        FlightRecorderConfig &dump_to(dp::String prefix) {
+            dump_prefix = std::move(prefix);
+            return *this;
+        }
+    };
+
+    // ─── Bus flight recorder ─────────────────────────────────────────────────────
+    // A black box of the last frames of every port, sent and received, kept in
+    // one ring per port allocated up front: recording a frame is a 24-byte copy
+    // and no I/O, so it can run for the life of the ECU where a capture file
+    // cannot. A trigger freezes the rings, so the frames leading up to a fault
+    // stay as they were while the bus goes on. With a dump prefix the freeze is
+    // written out as a capture file (capture.hpp) and recording resumes;
+    // without one the rings stay frozen for snapshot() or dump() until thaw().
+    //
+    // IsoNet keeps one with NetworkConfig::flight_recorder() and freezes it on
+    // TP/ETP aborts, address violations and DM1 lamps; watch() adds a
+    // SafetyPolicy. Frames are CAN 2.0: FD frames over 8 bytes are not kept.
+    class FlightRecorder {
+        FlightRecorderConfig config_;
+        dp::Vector<CaptureRecord> records_; // num_ports rings of frames_per_port
+        dp::Vector<u32> heads_;             // Per port: next slot
+        dp::Vector<u32> counts_;            // Per port: frames held
+        dp::Array<bool, 256> lamp_on_{};    // Per source: a lamp was on in its last DM1
+        FlightFreeze last_;
+        u64 newest_us_ = 0;
+        u64 recorded_ = 0;
+        u32 sequence_ = 0;
+        bool frozen_ = false;
+
+      public:
+        explicit FlightRecorder(FlightRecorderConfig config = {}) : config_(std::move(config)) {
+            if (config_.num_ports == 0)
+                config_.num_ports = 1;
+            if (config_.frames_per_port == 0)
+                config_.frames_per_port = 1;
+            records_.resize(static_cast<usize>(config_.num_ports) * config_.frames_per_port);
+            heads_.resize(config_.num_ports, 0);
+            counts_.resize(config_.num_ports, 0);
+        }
+
+        const FlightRecorderConfig &config() const noexcept { return config_; }
+
+        // ─── Recording ───────────────────────────────────────────────────────────
+        // `flags` are capture_flags; ignored while frozen
+        void record(const Frame &frame, u8 port, u8 flags, u64 timestamp_us) noexcept {
+            if (frozen_ || port >= config_.num_ports)
+                return;
+            CaptureRecord &r = records_[static_cast<usize>(port) * config_.frames_per_port + heads_[port]];
+            r.timestamp_us = timestamp_us;
+            r.can_id = frame.id.raw;
+            r.port = port;
+            r.flags = flags;
+            r.dlc = frame.length;
+            r.reserved = 0;
+            std::memcpy(r.data, frame.data.data(), 8);
+            if (++heads_[port] == config_.frames_per_port)
+                heads_[port] = 0;
+            if (counts_[port] < config_.frames_per_port)
+                ++counts_[port];
+            if (timestamp_us > newest_us_)
+                newest_us_ = timestamp_us;
+            ++recorded_;
+        }
+
+        u64 recorded() const noexcept { return recorded_; }
+        u32 held(u8 port) const noexcept { return port < config_.num_ports ? counts_[port] : 0; }
+
+        // ─── Triggers ────────────────────────────────────────────────────────────
+        // Stop recording and keep what the rings hold; false if already frozen
+        bool freeze(FlightTrigger trigger, Address source = NULL_ADDRESS) {
+            if (frozen_)
+                return false;
+            frozen_ = true;
+            last_ = FlightFreeze{trigger, source, newest_us_, ++sequence_};
+            echo::category("isobus.recorder")
+                .warn("frozen by ", flight_trigger_name(trigger), " (source ", static_cast<u32>(source), ")");
+            on_freeze.emit(last_);
+            if (!config_.dump_prefix.empty() && frozen_) {
+                dp::String path = config_.dump_prefix + dp::String(std::to_string(last_.sequence)) + ".cap";
+                if (dump(path).is_ok())
+                    thaw();
+            }
+            return true;
+        }
+
+        // A DM1's first byte (lamp status) from `source`: freezes when a lamp
+        // comes on, not again while it stays on
+        void lamps(Address source, u8 lamp_status) {
+            bool on = false;
+            for (u8 shift = 0; shift < 8; shift += 2)
+                on = on || ((lamp_status >> shift) & 0x03) == 0x01;
+            bool was = lamp_on_[source];
+            lamp_on_[source] = on;
+            if (on && !was)
+                freeze(FlightTrigger::DiagnosticLamp, source);
+        }
+
+        // Freeze on every state change of `policy`, which must outlive the
+        // subscription (unsubscribe with the token)
+        ListenerToken watch(SafetyPolicy &policy) {
+            return policy.on_state_change.subscribe(
+                [this](SafeState, SafeState) { freeze(FlightTrigger::SafetyState); });
+        }
+
+        // Record again; what was held is overwritten as new frames come in
+        void thaw() noexcept { frozen_ = false; }
+
+        // Empty the rings
+        void clear() noexcept {
+            std::fill(heads_.begin(), heads_.end(), 0u);
+            std::fill(counts_.begin(), counts_.end(), 0u);
+            newest_us_ = 0;
+        }
+
+        bool frozen() const noexcept { return frozen_; }
+        const FlightFreeze &last_freeze() const noexcept { return last_; }
+        u32 freezes() const noexcept { return sequence_; }
+
+        Event<const FlightFreeze &> on_freeze; // Before the dump, with the rings frozen
+
+        // ─── Readout ─────────────────────────────────────────────────────────────
+        // Frames of every port within the window, oldest first
+        dp::Vector<CaptureRecord> snapshot() const {
+            u64 window_us = static_cast<u64>(config_.window_ms) * 1000;
+            u64 from_us = config_.window_ms == 0 || newest_us_ < window_us ? 0 : newest_us_ - window_us;
+            dp::Vector<CaptureRecord> out;
+            for (u8 port = 0; port < config_.num_ports; ++port) {
+                const CaptureRecord *ring = records_.data() + static_cast<usize>(port) * config_.frames_per_port;
+                u32 start = (heads_[port] + config_.frames_per_port - counts_[port]) % config_.frames_per_port;
+                for (u32 i = 0; i < counts_[port]; ++i) {
+                    const CaptureRecord &r = ring[(start + i) % config_.frames_per_port];
+                    if (r.timestamp_us >= from_us)
+                        out.push_back(r);
+                }
+            }
+            // Each port's run is already in order
+            std::stable_sort(out.begin(), out.end(), [](const CaptureRecord &a, const CaptureRecord &b) {
+                return a.timestamp_us < b.timestamp_us;
+            });
+            return out;
+        }
+
+        // snapshot() as a capture file
+        Result<void> dump(const dp::String &path) const {
+            CaptureWriter writer;
+            auto opened = writer.open(path);
+            if (!opened.is_ok())
+                return opened;
+            auto frames = snapshot();
+            for (const auto &r : frames)
+                writer.write(r.frame(), r.port, r.flags);
+            writer.close();
+            if (writer.failed())
+                return Result<void>::err(Error(ErrorCode::DriverError, "flight recorder dump failed"));
+            echo::category("isobus.recorder").info("dumped ", frames.size(), " frames to ", path);
+            return {};
+        }
+    };
+
+} // namespace agrobus::net
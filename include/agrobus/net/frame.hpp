@@ -1,22 +1,43 @@
 #pragma once
 
+#include "bitfield.hpp"
+#include "constants.hpp"
 #include "identifier.hpp"
 #include "types.hpp"
 #include <datapod/datapod.hpp>
 
 namespace agrobus::net {
 
+    // ─── Decoded identifier fields ───────────────────────────────────────────────
+    // What the receive path needs from every identifier, decoded once when a
+    // frame enters IsoNet::process_frame and handed on to the address check,
+    // TP/ETP and fast packet instead of being re-derived at each step.
+    struct FrameHeader {
+        PGN pgn = 0;
+        Address source = NULL_ADDRESS;
+        Address destination = BROADCAST_ADDRESS;
+        Priority priority = Priority::Default;
+
+        static constexpr FrameHeader decode(Identifier id) noexcept {
+            return {id.pgn(), id.source(), id.destination(), id.priority()};
+        }
+    };
+
     // ─── CAN Frame (8-byte physical frame) ──────────────────────────────────────
+    // The first 16 bytes lay out like Linux `struct can_frame` (id, dlc, three
+    // reserved bytes, 8-aligned data), so IsoNet converts with one memcpy and
+    // the EFF flag. `id` never carries the flag bits.
     struct Frame {
         Identifier id;
-        dp::Array<u8, 8> data = {};
         u8 length = 8;
+        dp::Array<u8, 3> can_reserved = {}; // can_frame __pad, __res0, len8_dlc
+        dp::Array<u8, 8> data = {};
         u64 timestamp_us = 0;
 
         constexpr Frame() = default;
 
         constexpr Frame(Identifier identifier, dp::Array<u8, 8> payload, u8 len = 8)
-            : id(identifier), data(payload), length(len) {}
+            : id(identifier), length(len), data(payload) {}
 
         static Frame from_message(Priority prio, PGN pgn, Address src, Address dst, const u8 *payload,
                                   u8 len = 8) noexcept {
@@ -32,6 +53,17 @@ namespace agrobus::net {
             return f;
         }
 
+        // Bit fields over the payload, same semantics as Message::get_bits/set_bits.
+        // set_bits writes anywhere in the 8 data bytes and leaves length alone.
+        constexpr u32 get_bits(usize start_bit, u8 bits) const noexcept {
+            return bitfield::extract_le(data.data(), length > 8 ? 8 : length, start_bit, bits);
+        }
+
+        constexpr void set_bits(usize start_bit, u8 bits, u32 value) noexcept {
+            bitfield::deposit_le(data.data(), data.size(), start_bit, bits, value);
+        }
+
+        constexpr FrameHeader header() const noexcept { return FrameHeader::decode(id); }
         constexpr PGN pgn() const noexcept { return id.pgn(); }
         constexpr Address source() const noexcept { return id.source(); }
         constexpr Address destination() const noexcept { return id.destination(); }
@@ -39,4 +71,90 @@ namespace agrobus::net {
         constexpr bool is_broadcast() const noexcept { return id.is_broadcast(); }
     };
 
+    // ─── CAN FD data length codes (ISO 11898-1) ─────────────────────────────────
+    // DLC 0-8 are the byte count; 9-15 stand for 12, 16, 20, 24, 32, 48 and 64.
+    inline constexpr u8 CAN_FD_MAX_DLC = 15;
+
+    constexpr u8 can_dlc_to_length(u8 dlc) noexcept {
+        constexpr u8 lengths[16] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 12, 16, 20, 24, 32, 48, 64};
+        return lengths[dlc & 0x0F];
+    }
+
+    // Smallest DLC that holds `length` bytes (64 and above map to 15)
+    constexpr u8 can_length_to_dlc(usize length) noexcept {
+        if (length <= 8)
+            return static_cast<u8>(length);
+        if (length <= 24)
+            return static_cast<u8>(8 + (length - 5) / 4);
+        if (length <= 32)
+            return 13;
+        return length <= 48 ? 14 : 15;
+    }
+
+    // Payload length an FD frame carrying `length` bytes goes out with
+    constexpr u8 can_fd_padded_length(usize length) noexcept { return can_dlc_to_length(can_length_to_dlc(length)); }
+
+    // canfd_frame flags
+    inline constexpr u8 CAN_FD_FLAG_BRS = 0x01; // Data phase at the data bitrate
+    inline constexpr u8 CAN_FD_FLAG_ESI = 0x02; // Transmitter is error passive
+    inline constexpr u8 CAN_FD_FLAG_FDF = 0x04; // FD frame (set by newer kernels)
+
+    // ─── CAN FD Frame (up to 64-byte physical frame) ────────────────────────────
+    // Lays out like Linux `struct canfd_frame` (id, len, flags, two reserved
+    // bytes, 8-aligned data), as Frame does can_frame. `length` is always a
+    // valid FD length; from_message() pads the bytes in between with 0xFF.
+    struct FdFrame {
+        Identifier id;
+        u8 length = 0;
+        u8 flags = CAN_FD_FLAG_BRS;
+        dp::Array<u8, 2> can_reserved = {}; // canfd_frame __res0, __res1
+        dp::Array<u8, CAN_FD_DATA_LENGTH> data = {};
+        u64 timestamp_us = 0;
+
+        static FdFrame from_message(Priority prio, PGN pgn, Address src, Address dst, const u8 *payload,
+                                    usize len) noexcept {
+            FdFrame f;
+            f.id = Identifier::encode(prio, pgn, src, dst);
+            if (len > CAN_FD_DATA_LENGTH)
+                len = CAN_FD_DATA_LENGTH;
+            f.length = can_fd_padded_length(len);
+            for (usize i = 0; i < len; ++i)
+                f.data[i] = payload[i];
+            for (usize i = len; i < f.length; ++i)
+                f.data[i] = 0xFF;
+            return f;
+        }
+
+        // Classic frame with the same identifier and payload (length <= 8)
+        static FdFrame from_frame(const Frame &frame) noexcept {
+            FdFrame f;
+            f.id = frame.id;
+            f.length = frame.length > 8 ? 8 : frame.length;
+            f.flags = 0;
+            for (u8 i = 0; i < f.length; ++i)
+                f.data[i] = frame.data[i];
+            f.timestamp_us = frame.timestamp_us;
+            return f;
+        }
+
+        bool fits_classic() const noexcept { return length <= CAN_DATA_LENGTH; }
+
+        Frame to_classic() const noexcept {
+            Frame f;
+            f.id = id;
+            f.length = length > 8 ? 8 : length;
+            for (u8 i = 0; i < f.length; ++i)
+                f.data[i] = data[i];
+            f.timestamp_us = timestamp_us;
+            return f;
+        }
+
+        constexpr u8 dlc() const noexcept { return can_length_to_dlc(length); }
+        constexpr FrameHeader header() const noexcept { return FrameHeader::decode(id); }
+        constexpr PGN pgn() const noexcept { return id.pgn(); }
+        constexpr Address source() const noexcept { return id.source(); }
+        constexpr Address destination() const noexcept { return id.destination(); }
+        constexpr Priority priority() const noexcept { return id.priority(); }
+    };
+
 } // namespace agrobus::net
@@ -0,0 +1,583 @@
+#pragma once
+
+#include <agrobus/net/error.hpp>
+#include <agrobus/net/types.hpp>
+#include <atomic>
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <datapod/datapod.hpp>
+#include <echo/echo.hpp>
+#include <functional>
+#include <linux/can.h>
+#include <linux/io_uring.h>
+#include <linux/time_types.h>
+#include <memory>
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace agrobus::net {
+
+    struct IoRingConfig {
+        u32 entries = 256;           // Submission queue size (the completion queue is twice that)
+        u16 source_buffers = 64;     // Buffers provided to each recv source, a power of two
+        u32 can_queue_frames = 1024; // Per add_can() source
+
+        IoRingConfig &queue_entries(u32 n) {
+            entries = n;
+            return *this;
+        }
+        IoRingConfig &buffers(u16 per_source) {
+            source_buffers = per_source;
+            return *this;
+        }
+        IoRingConfig &can_queue(u32 frames) {
+            can_queue_frames = frames;
+            return *this;
+        }
+    };
+
+    // ─── IoRing: one io_uring reactor for the stack's descriptors ────────────────
+    // Reads from every registered descriptor are io_uring submissions on one
+    // ring, so a single thread serves several buses, the Ethernet tunnel, a
+    // GNSS receiver and the file server's disk, and each run() is one
+    // io_uring_enter() however many descriptors are busy.
+    //
+    //   add_recv()  socket (CAN_RAW, AF_PACKET, UDP): one multishot recv into
+    //               kernel-picked buffers, one completion per datagram
+    //   add_read()  stream (serial TTY, pipe): one read in flight at a time
+    //   add_can()   CAN_RAW socket into a frame queue drained by IsoNet
+    //   read_at()   one positioned read (file server read-ahead)
+    //
+    // Handlers run inside run() on the calling thread; the buffer they are
+    // given is only valid during the call. A read that finds nothing waiting
+    // (EAGAIN on an O_NONBLOCK descriptor) waits for POLLIN and is re-armed,
+    // as is a recv that ran out of buffers. Needs Linux 6.0 (multishot recv
+    // with provided buffer rings). Not thread-safe: owned by the thread that
+    // calls run(), like IsoNet.
+    //
+    // Usage:
+    //   IoRing ring;
+    //   ring.open();
+    //   nm.set_rx_source(0, ring.can_rx(ring.add_can(can_fd).value()));
+    //   ring.add_read(tty_fd, 256, [&](const u8 *d, usize n) { gnss.feed(d, n); });
+    //   ring.add_recv(packet_fd, 1514, [&](const u8 *d, usize n) { eth.receive_eth(d, n); });
+    //   while (running) {
+    //       ring.run(nm.next_deadline_ms());
+    //       nm.update(elapsed_ms);
+    //   }
+    class IoRing {
+      public:
+        using Handler = std::function<void(const u8 *, usize)>;
+        using ReadDone = std::function<void(i64)>; // Bytes read, or -errno
+
+      private:
+        // Frames of an add_can() source, until IsoNet drains them
+        struct CanQueue {
+            dp::Vector<canfd_frame> slots;
+            u32 head = 0;
+            u32 count = 0;
+            u64 dropped = 0;
+
+            void push(const u8 *data, usize len) {
+                if (count == slots.size()) {
+                    ++dropped;
+                    return;
+                }
+                canfd_frame &cf = slots[(head + count) % slots.size()];
+                std::memset(&cf, 0, sizeof(cf));
+                std::memcpy(&cf, data, len < sizeof(cf) ? len : sizeof(cf));
+                if (len == CAN_MTU)
+                    cf.flags = 0; // can_frame leaves these bytes as padding
+                ++count;
+            }
+
+            bool pop(canfd_frame &cf) {
+                if (count == 0)
+                    return false;
+                cf = slots[head];
+                head = static_cast<u32>((head + 1) % slots.size());
+                --count;
+                return true;
+            }
+        };
+
+        enum class State : u8 { Idle, Armed, Polling, Done };
+        struct Source {
+            int fd = -1;
+            bool multishot = false;                // recv into provided buffers, else one read at a time
+            u32 size = 0;                          // Buffer size: largest datagram, or read chunk
+            u16 buffers = 0;                       // Provided buffers (multishot)
+            u16 buf_tail = 0;                      // Our copy of the provided ring's tail
+            io_uring_buf_ring *buf_ring = nullptr; // Page-aligned, shared with the kernel
+            usize buf_ring_bytes = 0;
+            dp::Vector<u8> data;
+            Handler handler;
+            std::shared_ptr<CanQueue> frames; // add_can() only
+            State state = State::Idle;
+            u64 bytes = 0;
+        };
+
+        // user_data: operation in the top byte, source or read id below
+        static constexpr u64 OP_SOURCE = 1;
+        static constexpr u64 OP_POLL = 2;
+        static constexpr u64 OP_FILE = 3;
+        static constexpr u64 OP_CANCEL = 4;
+        static u64 tag(u64 op, u64 id) noexcept { return (op << 56) | id; }
+
+        IoRingConfig config_;
+        int ring_fd_ = -1;
+        void *sq_map_ = nullptr;
+        usize sq_map_bytes_ = 0;
+        void *cq_map_ = nullptr;
+        usize cq_map_bytes_ = 0;
+        io_uring_sqe *sqes_ = nullptr;
+        usize sqes_bytes_ = 0;
+        u32 *sq_head_ = nullptr;
+        u32 *sq_tail_ = nullptr;
+        u32 *sq_array_ = nullptr;
+        u32 sq_mask_ = 0;
+        u32 sq_entries_ = 0;
+        u32 sq_local_tail_ = 0; // SQEs filled, published to the kernel on enter()
+        u32 *cq_head_ = nullptr;
+        u32 *cq_tail_ = nullptr;
+        io_uring_cqe *cqes_ = nullptr;
+        u32 cq_mask_ = 0;
+
+        dp::Vector<std::unique_ptr<Source>> sources_; // Index = id = provided buffer group
+        dp::Map<u64, ReadDone> reads_;                // read_at() in flight
+        u64 next_read_ = 1;
+        bool closing_ = false;
+
+        u64 enters_ = 0;
+        u64 completions_ = 0;
+        u64 rearms_ = 0; // Reads re-armed after running out of buffers or data
+        u64 errors_ = 0;
+
+      public:
+        IoRing() = default;
+        explicit IoRing(IoRingConfig config) : config_(config) {}
+        ~IoRing() { close(); }
+
+        // The kernel holds pointers into the sources
+        IoRing(const IoRing &) = delete;
+        IoRing &operator=(const IoRing &) = delete;
+
+        Result<void> open() {
+            if (ring_fd_ >= 0)
+                return {};
+            io_uring_params p{};
+            p.flags = IORING_SETUP_CQSIZE | IORING_SETUP_CLAMP;
+            p.cq_entries = config_.entries * 2;
+            int fd = static_cast<int>(::syscall(__NR_io_uring_setup, config_.entries, &p));
+            if (fd < 0)
+                return Result<void>::err(Error::driver_error("io_uring_setup failed: " + dp::String(strerror(errno))));
+            if (!(p.features & IORING_FEAT_EXT_ARG) || !(p.features & IORING_FEAT_NODROP)) {
+                ::close(fd);
+                return Result<void>::err(Error::driver_error("io_uring too old"));
+            }
+            ring_fd_ = fd;
+
+            sq_map_bytes_ = p.sq_off.array + p.sq_entries * sizeof(u32);
+            cq_map_bytes_ = p.cq_off.cqes + p.cq_entries * sizeof(io_uring_cqe);
+            bool single = (p.features & IORING_FEAT_SINGLE_MMAP) != 0;
+            if (single && cq_map_bytes_ > sq_map_bytes_)
+                sq_map_bytes_ = cq_map_bytes_;
+            sq_map_ = map(sq_map_bytes_, IORING_OFF_SQ_RING);
+            cq_map_ = single ? sq_map_ : map(cq_map_bytes_, IORING_OFF_CQ_RING);
+            sqes_bytes_ = p.sq_entries * sizeof(io_uring_sqe);
+            void *sqes = map(sqes_bytes_, IORING_OFF_SQES);
+            if (!sq_map_ || !cq_map_ || !sqes) {
+                if (sqes)
+                    ::munmap(sqes, sqes_bytes_);
+                unmap();
+                ::close(ring_fd_);
+                ring_fd_ = -1;
+                return Result<void>::err(Error::driver_error("io_uring mmap failed"));
+            }
+            sqes_ = static_cast<io_uring_sqe *>(sqes);
+
+            auto *sq = static_cast<u8 *>(sq_map_);
+            sq_head_ = reinterpret_cast<u32 *>(sq + p.sq_off.head);
+            sq_tail_ = reinterpret_cast<u32 *>(sq + p.sq_off.tail);
+            sq_array_ = reinterpret_cast<u32 *>(sq + p.sq_off.array);
+            sq_mask_ = *reinterpret_cast<u32 *>(sq + p.sq_off.ring_mask);
+            sq_entries_ = p.sq_entries;
+            sq_local_tail_ = *sq_tail_;
+            auto *cq = static_cast<u8 *>(cq_map_);
+            cq_head_ = reinterpret_cast<u32 *>(cq + p.cq_off.head);
+            cq_tail_ = reinterpret_cast<u32 *>(cq + p.cq_off.tail);
+            cqes_ = reinterpret_cast<io_uring_cqe *>(cq + p.cq_off.cqes);
+            cq_mask_ = *reinterpret_cast<u32 *>(cq + p.cq_off.ring_mask);
+            closing_ = false;
+            echo::category("isobus.io_ring").info("io_uring open: ", p.sq_entries, " entries");
+            return {};
+        }
+
+        // Cancels everything in flight and waits for the kernel to let go of
+        // the buffers (read_at() callbacks get -ECANCELED or their result)
+        void close() {
+            if (ring_fd_ < 0)
+                return;
+            closing_ = true;
+            if (io_uring_sqe *sqe = next_sqe()) {
+                sqe->opcode = IORING_OP_ASYNC_CANCEL;
+                sqe->fd = -1;
+                sqe->cancel_flags = IORING_ASYNC_CANCEL_ANY;
+                sqe->user_data = tag(OP_CANCEL, 0);
+            }
+            for (int i = 0; i < 100 && busy(); ++i) {
+                enter(1, 10);
+                reap();
+            }
+            for (auto &s : sources_) {
+                if (s->buf_ring)
+                    ::munmap(s->buf_ring, s->buf_ring_bytes);
+            }
+            sources_.clear();
+            reads_.clear();
+            ::munmap(sqes_, sqes_bytes_);
+            unmap();
+            ::close(ring_fd_);
+            ring_fd_ = -1;
+        }
+
+        bool is_open() const noexcept { return ring_fd_ >= 0; }
+
+        // ─── Sources ─────────────────────────────────────────────────────────────
+        // Datagram socket: `handler` gets each datagram of up to max_size bytes
+        Result<u16> add_recv(int fd, u32 max_size, Handler handler) {
+            return add_source(fd, true, max_size, std::move(handler));
+        }
+
+        // Byte stream (TTY, pipe): `handler` gets whatever each read returned,
+        // up to chunk bytes. Open TTYs blocking, or let EAGAIN go through poll.
+        Result<u16> add_read(int fd, u32 chunk, Handler handler) {
+            return add_source(fd, false, chunk, std::move(handler));
+        }
+
+        // CAN_RAW socket (with or without CAN_RAW_FD_FRAMES) read into a queue
+        // of config().can_queue_frames frames; drain it with can_rx()/fd_rx()
+        Result<u16> add_can(int fd) {
+            auto frames = std::make_shared<CanQueue>();
+            frames->slots.resize(config_.can_queue_frames > 0 ? config_.can_queue_frames : 1);
+            auto id = add_source(fd, true, CANFD_MTU, [frames](const u8 *data, usize len) { frames->push(data, len); });
+            if (id.is_ok())
+                sources_[id.value()]->frames = std::move(frames);
+            return id;
+        }
+
+        // IsoNet::set_rx_source hook: classic frames of an add_can() source
+        // (FD frames over 8 bytes are skipped, use fd_rx() for those)
+        std::function<bool(can_frame &)> can_rx(u16 id) {
+            std::shared_ptr<CanQueue> frames = queue(id);
+            return [frames](can_frame &cf) {
+                canfd_frame f;
+                while (frames && frames->pop(f)) {
+                    if (f.len > CAN_MAX_DLEN)
+                        continue;
+                    std::memcpy(&cf, &f, sizeof(can_frame));
+                    return true;
+                }
+                return false;
+            };
+        }
+
+        // IsoNet::set_fd_port receive hook for an add_can() source
+        std::function<bool(canfd_frame &)> fd_rx(u16 id) {
+            std::shared_ptr<CanQueue> frames = queue(id);
+            return [frames](canfd_frame &cf) { return frames && frames->pop(cf); };
+        }
+
+        // Frames lost to a full queue (add_can() sources)
+        u64 can_dropped(u16 id) const noexcept {
+            return id < sources_.size() && sources_[id]->frames ? sources_[id]->frames->dropped : 0;
+        }
+
+        u64 bytes_received(u16 id) const noexcept { return id < sources_.size() ? sources_[id]->bytes : 0; }
+
+        // False once the source hit end of file or an error and is no longer read
+        bool active(u16 id) const noexcept { return id < sources_.size() && sources_[id]->state != State::Done; }
+
+        // ─── Positioned reads ────────────────────────────────────────────────────
+        // `dest` must stay valid until `done` runs (from a later run()). False
+        // when the submission queue is full even after submitting it.
+        bool read_at(int fd, u64 offset, u8 *dest, u32 len, ReadDone done) {
+            if (ring_fd_ < 0 || closing_)
+                return false;
+            io_uring_sqe *sqe = next_sqe();
+            if (!sqe)
+                return false;
+            u64 id = next_read_++;
+            sqe->opcode = IORING_OP_READ;
+            sqe->fd = fd;
+            sqe->addr = reinterpret_cast<u64>(dest);
+            sqe->len = len;
+            sqe->off = offset;
+            sqe->user_data = tag(OP_FILE, id);
+            reads_[id] = std::move(done);
+            return true;
+        }
+
+        usize reads_in_flight() const noexcept { return reads_.size(); }
+
+        // ─── Reactor ─────────────────────────────────────────────────────────────
+        // Submit what is queued and handle what completed, waiting up to
+        // wait_ms for the first completion when there is none yet. Returns
+        // the number of completions handled.
+        usize run(u32 wait_ms = 0) {
+            if (ring_fd_ < 0)
+                return 0;
+            arm_idle();
+            usize n = reap();
+            if (n == 0 && wait_ms > 0)
+                enter(1, wait_ms);
+            else if (pending() > 0)
+                enter(0, 0);
+            n += reap();
+            arm_idle();
+            if (pending() > 0)
+                enter(0, 0);
+            return n;
+        }
+
+        // ─── Statistics ──────────────────────────────────────────────────────────
+        const IoRingConfig &config() const noexcept { return config_; }
+        u64 enters() const noexcept { return enters_; } // io_uring_enter() calls
+        u64 completions() const noexcept { return completions_; }
+        u64 rearms() const noexcept { return rearms_; }
+        u64 errors() const noexcept { return errors_; }
+
+      private:
+        void *map(usize bytes, u64 offset) {
+            void *p = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_,
+                             static_cast<off_t>(offset));
+            return p == MAP_FAILED ? nullptr : p;
+        }
+
+        void unmap() {
+            if (cq_map_ && cq_map_ != sq_map_)
+                ::munmap(cq_map_, cq_map_bytes_);
+            if (sq_map_)
+                ::munmap(sq_map_, sq_map_bytes_);
+            sq_map_ = nullptr;
+            cq_map_ = nullptr;
+        }
+
+        std::shared_ptr<CanQueue> queue(u16 id) const {
+            return id < sources_.size() ? sources_[id]->frames : nullptr;
+        }
+
+        Result<u16> add_source(int fd, bool multishot, u32 size, Handler handler) {
+            if (ring_fd_ < 0)
+                return Result<u16>::err(Error::invalid_state("io_uring not open"));
+            if (fd < 0 || size == 0 || sources_.size() > 0xFFFF)
+                return Result<u16>::err(Error::invalid_state("bad io_uring source"));
+            auto s = std::make_unique<Source>();
+            s->fd = fd;
+            s->multishot = multishot;
+            s->size = size;
+            s->handler = std::move(handler);
+            u16 id = static_cast<u16>(sources_.size());
+            if (multishot) {
+                u16 count = config_.source_buffers;
+                if (count == 0 || (count & (count - 1)) != 0)
+                    return Result<u16>::err(Error::invalid_state("source_buffers must be a power of two"));
+                s->buffers = count;
+                s->data.resize(static_cast<usize>(count) * size);
+                s->buf_ring_bytes = count * sizeof(io_uring_buf);
+                void *ring = ::mmap(nullptr, s->buf_ring_bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS,
+                                    -1, 0);
+                if (ring == MAP_FAILED)
+                    return Result<u16>::err(Error::driver_error("buffer ring mmap failed"));
+                s->buf_ring = static_cast<io_uring_buf_ring *>(ring);
+                io_uring_buf_reg reg{};
+                reg.ring_addr = reinterpret_cast<u64>(ring);
+                reg.ring_entries = count;
+                reg.bgid = id;
+                if (::syscall(__NR_io_uring_register, ring_fd_, IORING_REGISTER_PBUF_RING, &reg, 1) < 0) {
+                    ::munmap(ring, s->buf_ring_bytes);
+                    return Result<u16>::err(
+                        Error::driver_error("buffer ring register failed: " + dp::String(strerror(errno))));
+                }
+                for (u16 bid = 0; bid < count; ++bid)
+                    provide(*s, bid);
+            } else {
+                s->data.resize(size);
+            }
+            sources_.push_back(std::move(s));
+            echo::category("isobus.io_ring").debug("source ", id, " fd ", fd, multishot ? " recv" : " read");
+            return Result<u16>::ok(id);
+        }
+
+        // Hand buffer `bid` (back) to the kernel. Entries are indexed from the
+        // ring's start: the header's flex-array wrapper moves `bufs` by 8 bytes in C++.
+        static void provide(Source &s, u16 bid) noexcept {
+            io_uring_buf &b = reinterpret_cast<io_uring_buf *>(s.buf_ring)[s.buf_tail & (s.buffers - 1)];
+            b.addr = reinterpret_cast<u64>(s.data.data() + static_cast<usize>(bid) * s.size);
+            b.len = s.size;
+            b.bid = bid;
+            ++s.buf_tail;
+            std::atomic_ref<u16>(s.buf_ring->tail).store(s.buf_tail, std::memory_order_release);
+        }
+
+        io_uring_sqe *next_sqe() {
+            if (std::atomic_ref<u32>(*sq_head_).load(std::memory_order_acquire) + sq_entries_ == sq_local_tail_) {
+                enter(0, 0);
+                if (std::atomic_ref<u32>(*sq_head_).load(std::memory_order_acquire) + sq_entries_ == sq_local_tail_)
+                    return nullptr;
+            }
+            u32 idx = sq_local_tail_ & sq_mask_;
+            io_uring_sqe *sqe = &sqes_[idx];
+            std::memset(sqe, 0, sizeof(*sqe));
+            sq_array_[idx] = idx;
+            ++sq_local_tail_;
+            return sqe;
+        }
+
+        u32 pending() const noexcept {
+            return sq_local_tail_ - std::atomic_ref<u32>(*sq_head_).load(std::memory_order_acquire);
+        }
+
+        // Submit the filled SQEs; with min_complete, wait up to wait_ms for completions
+        void enter(u32 min_complete, u32 wait_ms) {
+            std::atomic_ref<u32>(*sq_tail_).store(sq_local_tail_, std::memory_order_release);
+            u32 flags = 0;
+            io_uring_getevents_arg arg{};
+            __kernel_timespec ts{};
+            if (min_complete > 0) {
+                flags = IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG;
+                ts.tv_sec = wait_ms / 1000;
+                ts.tv_nsec = static_cast<long long>(wait_ms % 1000) * 1000000;
+                arg.sigmask_sz = _NSIG / 8;
+                arg.ts = reinterpret_cast<u64>(&ts);
+            }
+            ++enters_;
+            long r = ::syscall(__NR_io_uring_enter, ring_fd_, pending(), min_complete, flags,
+                               min_complete > 0 ? &arg : nullptr, min_complete > 0 ? sizeof(arg) : 0);
+            if (r < 0 && errno != ETIME && errno != EINTR && errno != EBUSY && errno != EAGAIN) {
+                ++errors_;
+                echo::category("isobus.io_ring").warn("io_uring_enter failed: ", strerror(errno));
+            }
+        }
+
+        usize reap() {
+            usize n = 0;
+            u32 head = *cq_head_;
+            while (head != std::atomic_ref<u32>(*cq_tail_).load(std::memory_order_acquire)) {
+                io_uring_cqe cqe = cqes_[head & cq_mask_];
+                std::atomic_ref<u32>(*cq_head_).store(++head, std::memory_order_release);
+                complete(cqe);
+                ++n;
+            }
+            completions_ += n;
+            return n;
+        }
+
+        void complete(const io_uring_cqe &cqe) {
+            u64 op = cqe.user_data >> 56;
+            u64 id = cqe.user_data & ((u64{1} << 56) - 1);
+            if (op == OP_FILE) {
+                auto it = reads_.find(id);
+                if (it == reads_.end())
+                    return;
+                ReadDone done = std::move(it->second);
+                reads_.erase(it);
+                if (done)
+                    done(cqe.res);
+                return;
+            }
+            if ((op != OP_SOURCE && op != OP_POLL) || id >= sources_.size())
+                return;
+            Source &s = *sources_[id];
+            if (op == OP_POLL) {
+                s.state = closing_ ? State::Done : State::Idle;
+                return;
+            }
+
+            if (cqe.res > 0 && !s.multishot) {
+                deliver(s, s.data.data(), static_cast<usize>(cqe.res));
+            } else if (cqe.res > 0 && (cqe.flags & IORING_CQE_F_BUFFER)) {
+                u16 bid = static_cast<u16>(cqe.flags >> IORING_CQE_BUFFER_SHIFT);
+                deliver(s, s.data.data() + static_cast<usize>(bid) * s.size, static_cast<usize>(cqe.res));
+                provide(s, bid);
+            }
+            if (s.multishot && (cqe.flags & IORING_CQE_F_MORE))
+                return; // Still armed
+
+            if (closing_ || cqe.res == -ECANCELED) {
+                s.state = State::Done;
+            } else if (cqe.res > 0 || cqe.res == -ENOBUFS || cqe.res == -EINTR) {
+                s.state = State::Idle; // Read the next chunk, or recv again with the buffers given back
+                if (cqe.res < 0)
+                    ++rearms_;
+            } else if (cqe.res == -EAGAIN) {
+                ++rearms_;
+                wait_readable(s, static_cast<u16>(id));
+            } else {
+                s.state = State::Done; // End of file, or an error
+                if (cqe.res < 0) {
+                    ++errors_;
+                    echo::category("isobus.io_ring").warn("source ", id, " stopped: ", strerror(-cqe.res));
+                }
+            }
+        }
+
+        void deliver(Source &s, const u8 *data, usize len) {
+            s.bytes += len;
+            if (!closing_ && s.handler)
+                s.handler(data, len);
+        }
+
+        void wait_readable(Source &s, u16 id) {
+            io_uring_sqe *sqe = next_sqe();
+            if (!sqe) {
+                s.state = State::Idle;
+                return;
+            }
+            sqe->opcode = IORING_OP_POLL_ADD;
+            sqe->fd = s.fd;
+            sqe->poll32_events = POLLIN;
+            sqe->user_data = tag(OP_POLL, id);
+            s.state = State::Polling;
+        }
+
+        void arm_idle() {
+            for (usize id = 0; id < sources_.size(); ++id) {
+                Source &s = *sources_[id];
+                if (s.state != State::Idle)
+                    continue;
+                io_uring_sqe *sqe = next_sqe();
+                if (!sqe)
+                    return;
+                sqe->fd = s.fd;
+                sqe->user_data = tag(OP_SOURCE, id);
+                if (s.multishot) {
+                    sqe->opcode = IORING_OP_RECV;
+                    sqe->ioprio = IORING_RECV_MULTISHOT;
+                    sqe->flags = IOSQE_BUFFER_SELECT;
+                    sqe->buf_group = static_cast<u16>(id);
+                } else {
+                    sqe->opcode = IORING_OP_READ;
+                    sqe->addr = reinterpret_cast<u64>(s.data.data());
+                    sqe->len = s.size;
+                    sqe->off = ~u64{0}; // Current position: streams are not seekable
+                }
+                s.state = State::Armed;
+            }
+        }
+
+        bool busy() const noexcept {
+            if (!reads_.empty())
+                return true;
+            for (const auto &s : sources_) {
+                if (s->state == State::Armed || s->state == State::Polling)
+                    return true;
+            }
+            return false;
+        }
+    };
+
+} // namespace agrobus::net
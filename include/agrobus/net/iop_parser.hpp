@@ -7,14 +7,81 @@
 #endif
 
 #include <agrobus/isobus/vt/objects.hpp>
+#include <agrobus/isobus/vt/pool_image.hpp>
+#include <agrobus/net/data_span.hpp>
 #include <agrobus/net/error.hpp>
 #include <agrobus/net/types.hpp>
+#include <agrobus/net/work_pool.hpp>
 #include <datapod/datapod.hpp>
 #include <echo/echo.hpp>
+#include <fcntl.h>
+#include <memory>
+#include <cstring>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 namespace agrobus::net {
     namespace vt = agrobus::isobus::vt;
 
+    // ─── IOP loading checks ──────────────────────────────────────────────────────
+    enum class IOPCheck : u8 {
+        Strict, // A truncated object or a duplicate ID fails the load
+        Lazy,   // Load what parses (like parse_iop_data), leave validation to the caller
+    };
+
+    // ─── Cached version label of an IOP file ─────────────────────────────────────
+    // Kept next to the IOP (<path>.ver) so a connect can pick between Load
+    // Version and a full upload without hashing the pool again. The file's
+    // size and modification time identify the content it was computed from.
+    struct IOPVersionStamp {
+        u64 size = 0;
+        i64 mtime_ns = 0;
+        u64 hash = 0;
+        dp::String label;
+
+        static constexpr u8 MAGIC = 0x1B;
+        static constexpr u8 VERSION = 1;
+
+        // [magic, version, size(8), mtime_ns(8), hash(8), label length, label]
+        dp::Vector<u8> encode() const {
+            dp::Vector<u8> out;
+            out.reserve(27 + label.size());
+            out.push_back(MAGIC);
+            out.push_back(VERSION);
+            for (u64 v : {size, static_cast<u64>(mtime_ns), hash}) {
+                for (u8 i = 0; i < 8; ++i)
+                    out.push_back(static_cast<u8>(v >> (i * 8)));
+            }
+            out.push_back(static_cast<u8>(label.size()));
+            for (char c : label)
+                out.push_back(static_cast<u8>(c));
+            return out;
+        }
+
+        static dp::Optional<IOPVersionStamp> decode(DataSpan data) {
+            if (data.size() < 27 || data[0] != MAGIC || data[1] != VERSION || data.size() != 27u + data[26])
+                return dp::nullopt;
+            IOPVersionStamp stamp;
+            stamp.size = data.get_u64_le(2);
+            stamp.mtime_ns = static_cast<i64>(data.get_u64_le(10));
+            stamp.hash = data.get_u64_le(18);
+            for (usize i = 27; i < data.size(); ++i)
+                stamp.label += static_cast<char>(data[i]);
+            return stamp;
+        }
+    };
+
+    // ─── One object of an IOP file ───────────────────────────────────────────────
+    // Where IOPParser::prescan() found it; the body is width, height and the
+    // object-specific data, the same bytes parse_iop_data() copies
+    struct IOPObjectSpan {
+        vt::ObjectID id = 0;
+        vt::ObjectType type = vt::ObjectType::WorkingSet;
+        u32 offset = 0; // First body byte
+        u32 length = 0;
+    };
+
     // ─── IOP (ISOBUS Object Pool) File Parser ───────────────────────────────────
     // Parses standard ISOBUS Object Pool binary files for loading VT object pools.
     // IOP files contain serialized VT objects per ISO 11783-6 Annex B.
@@ -49,69 +116,239 @@ namespace agrobus::net {
             return Result<dp::Vector<u8>>::ok(std::move(data));
         }
 
-        // Parse object pool data into structured ObjectPool
-        static Result<vt::ObjectPool> parse_iop_data(const dp::Vector<u8> &data) {
-            vt::ObjectPool pool;
-            usize offset = 0;
+        // ─── Zero-copy loading ───────────────────────────────────────────────────
+        // Map an IOP file read-only and index its objects in place: no read into
+        // a buffer, no copy per object. Pages come from the page cache on first
+        // access, so an ECU holding several language or version pools only pays
+        // RAM for the ones it touches. The mapping lives as long as the image or
+        // any copy of it; the file must not be truncated meanwhile.
+        static Result<vt::PoolImage> map_iop_file(const dp::String &filepath, IOPCheck check = IOPCheck::Strict) {
+            int fd = ::open(filepath.c_str(), O_RDONLY | O_CLOEXEC);
+            if (fd < 0) {
+                return Result<vt::PoolImage>::err(
+                    Error(ErrorCode::DriverError, "Failed to open IOP file: " + filepath));
+            }
+            struct stat st {};
+            if (::fstat(fd, &st) < 0 || st.st_size <= 0) {
+                ::close(fd);
+                return Result<vt::PoolImage>::err(Error(ErrorCode::DriverError, "Empty IOP file"));
+            }
+            usize size = static_cast<usize>(st.st_size);
+            void *m = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+            ::close(fd); // The mapping keeps the file referenced
+            if (m == MAP_FAILED)
+                return Result<vt::PoolImage>::err(Error(ErrorCode::DriverError, "mmap failed"));
+            ::madvise(m, size, MADV_WILLNEED);
 
-            while (offset + 7 <= data.size()) {
-                vt::VTObject obj;
+            auto mapping = std::make_shared<Mapping>(m, size);
+            const u8 *data = static_cast<const u8 *>(m);
+            echo::category("isobus.util.iop").info("Mapped IOP file: ", filepath, " (", size, " bytes)");
+            return parse_iop_image(std::move(mapping), data, size, check);
+        }
 
-                // Object ID (2 bytes, little-endian)
-                obj.id = static_cast<u16>(data[offset]) | (static_cast<u16>(data[offset + 1]) << 8);
-                offset += 2;
+        // Same over bytes already in memory, taken over without a copy
+        static Result<vt::PoolImage> parse_iop_image(dp::Vector<u8> &&data, IOPCheck check = IOPCheck::Strict) {
+            auto owned = std::make_shared<const dp::Vector<u8>>(std::move(data));
+            const u8 *bytes = owned->data();
+            usize size = owned->size();
+            return parse_iop_image(std::shared_ptr<const void>(owned, bytes), bytes, size, check);
+        }
 
-                // Object type (1 byte)
-                obj.type = static_cast<vt::ObjectType>(data[offset]);
-                offset += 1;
+        // Index the IOP objects in [data, data + size), kept alive by `owner`.
+        // Bodies are the same bytes parse_iop_data copies: width, height and
+        // the object-specific data.
+        static Result<vt::PoolImage> parse_iop_image(std::shared_ptr<const void> owner, const u8 *data, usize size,
+                                                     IOPCheck check = IOPCheck::Strict) {
+            auto spans = prescan(data, size, check);
+            if (!spans.is_ok())
+                return Result<vt::PoolImage>::err(spans.error());
+            auto image = vt::PoolImage::over(std::move(owner), data, size);
+            for (const auto &span : spans.value()) {
+                auto result = image.add(span.id, span.type, span.offset, span.length);
+                if (!result.is_ok()) {
+                    if (check == IOPCheck::Strict)
+                        return Result<vt::PoolImage>::err(result.error());
+                    echo::category("isobus.util.iop").warn("Skipped object ", span.id, ": ", result.error().message);
+                }
+            }
 
-                // Width (2 bytes) + Height (2 bytes) stored as first 4 bytes of body
-                obj.body.push_back(data[offset]);
-                obj.body.push_back(data[offset + 1]);
-                offset += 2;
+            echo::category("isobus.util.iop").info("Indexed ", image.size(), " objects from IOP data");
+            return Result<vt::PoolImage>::ok(std::move(image));
+        }
 
-                obj.body.push_back(data[offset]);
-                obj.body.push_back(data[offset + 1]);
-                offset += 2;
+        // ─── Object boundary prescan ─────────────────────────────────────────────
+        // An object's length depends on its type and, for strings and macros,
+        // on a length field, so finding the objects is one sequential walk.
+        // The walk only reads those fields and records the spans, without
+        // touching or copying the bodies; whatever decodes the objects can
+        // then split them across threads. A truncated last object is an error
+        // with Strict, and ends the list with Lazy.
+        static Result<dp::Vector<IOPObjectSpan>> prescan(const u8 *data, usize size,
+                                                         IOPCheck check = IOPCheck::Strict) {
+            dp::Vector<IOPObjectSpan> spans;
+            spans.reserve(size / 16); // Typical objects are a dozen bytes or more
+            usize offset = 0;
+            while (offset + 7 <= size) {
+                IOPObjectSpan span;
+                span.id = static_cast<vt::ObjectID>(data[offset] | (data[offset + 1] << 8));
+                span.type = static_cast<vt::ObjectType>(data[offset + 2]);
+                span.offset = static_cast<u32>(offset + 3);
+                offset += 7; // ID, type, width and height
 
-                // Object-specific data length depends on type
-                usize obj_data_len = get_object_data_length(obj.type, data, offset);
-                if (offset + obj_data_len > data.size()) {
-                    echo::category("isobus.util.iop").warn("Truncated object at offset ", offset, " id=", obj.id);
+                usize obj_data_len = get_object_data_length(span.type, data, size, offset);
+                if (offset + obj_data_len > size) {
+                    if (check == IOPCheck::Strict)
+                        return Result<dp::Vector<IOPObjectSpan>>::err(Error(
+                            ErrorCode::PoolValidation, "truncated IOP object " + dp::String(std::to_string(span.id))));
+                    echo::category("isobus.util.iop").warn("Truncated object at offset ", offset, " id=", span.id);
                     break;
                 }
-
-                for (usize i = 0; i < obj_data_len; ++i) {
-                    obj.body.push_back(data[offset + i]);
-                }
                 offset += obj_data_len;
+                span.length = static_cast<u32>(offset - span.offset);
+                spans.push_back(span);
+            }
+            if (check == IOPCheck::Strict && offset != size)
+                return Result<dp::Vector<IOPObjectSpan>>::err(
+                    Error(ErrorCode::PoolValidation, "trailing bytes after last IOP object"));
+            return Result<dp::Vector<IOPObjectSpan>>::ok(std::move(spans));
+        }
 
-                auto result = pool.add(std::move(obj));
-                if (!result.is_ok()) {
-                    echo::category("isobus.util.iop").warn("Duplicate object ID: ", obj.id);
+        // Parse object pool data into structured ObjectPool. With `threads`
+        // > 1 (0 = one per core) the objects found by prescan() are copied
+        // out on that many threads; only the ID index is built on the calling
+        // thread, in file order, so duplicates resolve as in a serial parse.
+        static Result<vt::ObjectPool> parse_iop_data(const dp::Vector<u8> &data, u32 threads = 1) {
+            constexpr usize MIN_OBJECTS_PER_THREAD = 4096; // Below that a thread costs more than it saves
+            auto spans = prescan(data.data(), data.size(), IOPCheck::Lazy).value();
+
+            dp::Vector<vt::VTObject> objects(spans.size());
+            parallel_ranges(spans.size(), threads, MIN_OBJECTS_PER_THREAD, [&](usize begin, usize end) {
+                for (usize i = begin; i < end; ++i) {
+                    const IOPObjectSpan &span = spans[i];
+                    vt::VTObject &obj = objects[i];
+                    obj.id = span.id;
+                    obj.type = span.type;
+                    obj.body.assign(data.data() + span.offset, data.data() + span.offset + span.length);
                 }
+            });
+
+            vt::ObjectPool pool;
+            pool.reserve(objects.size());
+            for (auto &obj : objects) {
+                vt::ObjectID id = obj.id;
+                if (!pool.add(std::move(obj)).is_ok())
+                    echo::category("isobus.util.iop").warn("Duplicate object ID: ", id);
             }
 
             echo::category("isobus.util.iop").info("Parsed ", pool.size(), " objects from IOP data");
             return Result<vt::ObjectPool>::ok(std::move(pool));
         }
 
-        // Generate a version hash string from object pool data
-        static Result<dp::String> hash_to_version(const dp::Vector<u8> &data) {
-            // Simple FNV-1a hash for version identification
-            u32 hash = 2166136261u;
-            for (auto b : data) {
-                hash ^= b;
-                hash *= 16777619u;
+        // ─── Version labels ──────────────────────────────────────────────────────
+        // XXH64 (seed 0) of the pool: four independent 64-bit lanes over 32-byte
+        // stripes, so the compiler keeps them in registers side by side, at
+        // several GB/s on one core where FNV-1a does one multiply per byte.
+        // constexpr so StaticPool can stamp ROM pools at compile time; the
+        // little-endian reads compile to plain loads. There is no AVX2/NEON
+        // path as in geo_kernels.hpp: the lanes are 64x64-bit multiplies, which
+        // neither has (AVX-512 does), and building them from 32-bit multiplies
+        // costs more than the scalar lanes save.
+        static constexpr u64 content_hash(DataSpan data) noexcept {
+            constexpr u64 P1 = 0x9E3779B185EBCA87ULL;
+            constexpr u64 P2 = 0xC2B2AE3D27D4EB4FULL;
+            constexpr u64 P3 = 0x165667B19E3779F9ULL;
+            constexpr u64 P4 = 0x85EBCA77C2B2AE63ULL;
+            constexpr u64 P5 = 0x27D4EB2F165667C5ULL;
+            auto rotl = [](u64 x, int r) { return (x << r) | (x >> (64 - r)); };
+            auto round = [&](u64 acc, u64 input) { return rotl(acc + input * P2, 31) * P1; };
+            auto merge = [&](u64 acc, u64 v) { return (acc ^ round(0, v)) * P1 + P4; };
+            auto read32 = [](const u8 *p) {
+                return static_cast<u32>(p[0]) | (static_cast<u32>(p[1]) << 8) | (static_cast<u32>(p[2]) << 16) |
+                       (static_cast<u32>(p[3]) << 24);
+            };
+            auto read64 = [&](const u8 *p) {
+                return static_cast<u64>(read32(p)) | (static_cast<u64>(read32(p + 4)) << 32);
+            };
+
+            const u8 *p = data.data();
+            const u8 *end = p + data.size();
+            u64 h = 0;
+            if (data.size() >= 32) {
+                u64 v1 = P1 + P2, v2 = P2, v3 = 0, v4 = 0 - P1;
+                for (; p + 32 <= end; p += 32) {
+                    v1 = round(v1, read64(p));
+                    v2 = round(v2, read64(p + 8));
+                    v3 = round(v3, read64(p + 16));
+                    v4 = round(v4, read64(p + 24));
+                }
+                h = rotl(v1, 1) + rotl(v2, 7) + rotl(v3, 12) + rotl(v4, 18);
+                h = merge(merge(merge(merge(h, v1), v2), v3), v4);
+            } else {
+                h = P5;
+            }
+            h += data.size();
+            for (; p + 8 <= end; p += 8)
+                h = rotl(h ^ round(0, read64(p)), 27) * P1 + P4;
+            if (p + 4 <= end) {
+                h = rotl(h ^ (static_cast<u64>(read32(p)) * P1), 23) * P2 + P3;
+                p += 4;
             }
+            for (; p < end; ++p)
+                h = rotl(h ^ (*p * P5), 11) * P1;
+            h ^= h >> 33;
+            h *= P2;
+            h ^= h >> 29;
+            h *= P3;
+            h ^= h >> 32;
+            return h;
+        }
 
-            // Convert to 7-character version string (ISO 11783-6 version label)
+        // 7-character version label (ISO 11783-6) of a content hash
+        static dp::String version_label(u64 hash) {
             dp::String version;
             for (u8 i = 0; i < 7; ++i) {
                 u8 ch = static_cast<u8>((hash >> (i * 4)) & 0x0F);
                 version += static_cast<char>('A' + ch);
             }
-            return Result<dp::String>::ok(version);
+            return version;
+        }
+
+        // Generate a version hash string from object pool data
+        static Result<dp::String> hash_to_version(DataSpan data) {
+            return Result<dp::String>::ok(version_label(content_hash(data)));
+        }
+
+        // Version label of an IOP file through its <path>.ver stamp: the file is
+        // only hashed when the stamp is missing or its size or mtime changed,
+        // and the stamp is then rewritten (best effort, a read-only directory
+        // just means hashing every time)
+        static Result<dp::String> file_version(const dp::String &filepath) {
+            struct stat st {};
+            if (::stat(filepath.c_str(), &st) < 0 || st.st_size <= 0) {
+                return Result<dp::String>::err(
+                    Error(ErrorCode::DriverError, "Failed to open IOP file: " + filepath));
+            }
+            u64 size = static_cast<u64>(st.st_size);
+            i64 mtime_ns = static_cast<i64>(st.st_mtim.tv_sec) * 1000000000LL + st.st_mtim.tv_nsec;
+            dp::String stamp_path = filepath + ".ver";
+
+            auto stored = read_stamp(stamp_path);
+            if (stored.has_value() && stored->size == size && stored->mtime_ns == mtime_ns) {
+                echo::category("isobus.util.iop").debug("Version of ", filepath, " from stamp: ", stored->label);
+                return Result<dp::String>::ok(stored->label);
+            }
+
+            auto image = map_iop_file(filepath, IOPCheck::Lazy);
+            if (!image.is_ok())
+                return Result<dp::String>::err(image.error());
+            IOPVersionStamp stamp;
+            stamp.size = size;
+            stamp.mtime_ns = mtime_ns;
+            stamp.hash = content_hash(image.value().bytes());
+            stamp.label = version_label(stamp.hash);
+            if (!write_stamp(stamp_path, stamp))
+                echo::category("isobus.util.iop").warn("Cannot write version stamp ", stamp_path);
+            return Result<dp::String>::ok(stamp.label);
         }
 
         // Validate IOP structure without fully parsing
@@ -128,7 +365,7 @@ namespace agrobus::net {
                 auto type = static_cast<vt::ObjectType>(data[offset + 2]);
                 offset += 7;
 
-                usize obj_len = get_object_data_length(type, data, offset);
+                usize obj_len = get_object_data_length(type, data.data(), data.size(), offset);
                 if (offset + obj_len > data.size()) {
                     echo::category("isobus.util.iop").warn("Validation failed: truncated at object ", object_count);
                     return Result<bool>::ok(false);
@@ -142,8 +379,45 @@ namespace agrobus::net {
         }
 
       private:
+        static dp::Optional<IOPVersionStamp> read_stamp(const dp::String &path) {
+            FILE *f = fopen(path.c_str(), "rb");
+            if (!f)
+                return dp::nullopt;
+            dp::Array<u8, 27 + 255> buf{};
+            usize n = fread(buf.data(), 1, buf.size(), f);
+            fclose(f);
+            return IOPVersionStamp::decode(DataSpan(buf.data(), n));
+        }
+
+        // Written to a temporary and renamed, so a reader never sees half a stamp
+        static bool write_stamp(const dp::String &path, const IOPVersionStamp &stamp) {
+            dp::String tmp = path + ".tmp";
+            FILE *f = fopen(tmp.c_str(), "wb");
+            if (!f)
+                return false;
+            auto bytes = stamp.encode();
+            bool ok = fwrite(bytes.data(), 1, bytes.size(), f) == bytes.size();
+            ok = fclose(f) == 0 && ok;
+            if (!ok || ::rename(tmp.c_str(), path.c_str()) != 0) {
+                ::unlink(tmp.c_str());
+                return false;
+            }
+            return true;
+        }
+
+        // Unmapped with the last PoolImage copy that references it
+        struct Mapping {
+            void *addr;
+            usize size;
+
+            Mapping(void *a, usize s) : addr(a), size(s) {}
+            ~Mapping() { ::munmap(addr, size); }
+            Mapping(const Mapping &) = delete;
+            Mapping &operator=(const Mapping &) = delete;
+        };
+
         // Estimate object-specific data length based on type
-        static usize get_object_data_length(vt::ObjectType type, const dp::Vector<u8> &data, usize offset) {
+        static usize get_object_data_length(vt::ObjectType type, const u8 *data, usize size, usize offset) {
             switch (type) {
             case vt::ObjectType::WorkingSet:
                 return 4; // background_color(1) + selectable(1) + active_mask(2)
@@ -158,7 +432,7 @@ namespace agrobus::net {
             case vt::ObjectType::InputNumber:
                 return 16; // Multiple fields
             case vt::ObjectType::OutputString:
-                if (offset + 2 <= data.size()) {
+                if (offset + 2 <= size) {
                     u16 str_len = static_cast<u16>(data[offset]) | (static_cast<u16>(data[offset + 1]) << 8);
                     return 2 + str_len + 4; // len + string + other attrs
                 }
@@ -168,7 +442,7 @@ namespace agrobus::net {
             case vt::ObjectType::NumberVariable:
                 return 4; // value (4 bytes)
             case vt::ObjectType::StringVariable:
-                if (offset + 2 <= data.size()) {
+                if (offset + 2 <= size) {
                     u16 str_len = static_cast<u16>(data[offset]) | (static_cast<u16>(data[offset + 1]) << 8);
                     return 2 + str_len;
                 }
@@ -180,7 +454,7 @@ namespace agrobus::net {
             case vt::ObjectType::FillAttributes:
                 return 5; // type(1) + color(1) + pattern(2) + ...
             case vt::ObjectType::Macro:
-                if (offset + 1 <= data.size()) {
+                if (offset + 1 <= size) {
                     return 1 + data[offset]; // num_commands + commands
                 }
                 return 1;
@@ -0,0 +1,233 @@
+#pragma once
+
+#include "constants.hpp"
+#include "data_span.hpp"
+#include "types.hpp"
+#include <agrobus/net/bitfield.hpp>
+#include <datapod/datapod.hpp>
+#include <atomic>
+
+namespace agrobus::net {
+
+    // Age reported for a (PGN, source) that was never received
+    inline constexpr u32 NEVER_SEEN = 0xFFFFFFFFu;
+
+    // ─── One cached value ────────────────────────────────────────────────────────
+    struct LastValue {
+        PGN pgn = 0;
+        Address source = NULL_ADDRESS;
+        u8 length = 0;
+        dp::Array<u8, 8> data = {};
+        u64 timestamp_us = 0; // Frame RX time
+        u64 rx_ms = 0;        // IsoNet clock (TimerWheel::now_ms()) when it was stored
+        u32 updates = 0;      // Values stored into this slot so far
+
+        DataSpan bytes() const noexcept { return DataSpan(data.data(), length); }
+    };
+
+    // ─── Last-value cache keyed by (PGN, source) ─────────────────────────────────
+    // Fixed, open-addressed slots holding the latest payload of each tracked
+    // single-frame PGN per sender, so consumers that only want "the current
+    // wheel speed" read it here instead of keeping their own copy in a callback.
+    //
+    // IsoNet is the only writer (from the thread that drives update()); any
+    // thread may read. Every slot is a seqlock: the writer bumps the sequence to
+    // odd, writes, and bumps it to even; a reader retries until it saw the same
+    // even sequence before and after copying. Slots are claimed on first
+    // receipt and never move, so a lookup is a hash and a short probe.
+    class LastValueCache {
+      public:
+        static constexpr usize SLOTS = 64; // Power of two
+        static constexpr usize MAX_TRACKED = 32;
+
+      private:
+        struct Slot {
+            std::atomic<u32> key{0}; // (pgn << 8 | source) + 1, 0 = free
+            std::atomic<u32> seq{0}; // Odd while being written; seq / 2 = updates
+            std::atomic<u64> word{0};
+            std::atomic<u64> timestamp_us{0};
+            std::atomic<u64> rx_ms{0};
+            std::atomic<u8> length{0};
+        };
+
+        dp::Array<Slot, SLOTS> slots_;
+        dp::Array<PGN, MAX_TRACKED> tracked_ = {};
+        usize tracked_count_ = 0;
+        std::atomic<u64> now_ms_{0};
+        u64 dropped_ = 0; // Stores that found every slot taken
+
+      public:
+        LastValueCache() = default;
+        LastValueCache(const LastValueCache &) = delete;
+        LastValueCache &operator=(const LastValueCache &) = delete;
+
+        // ─── Writer side (IsoNet thread) ─────────────────────────────────────────
+        // Cache this PGN from every sender; returns false when the tracked list is full
+        bool track(PGN pgn) {
+            if (tracked(pgn))
+                return true;
+            if (tracked_count_ == MAX_TRACKED)
+                return false;
+            tracked_[tracked_count_++] = pgn;
+            return true;
+        }
+
+        void untrack(PGN pgn) {
+            for (usize i = 0; i < tracked_count_; ++i) {
+                if (tracked_[i] == pgn) {
+                    tracked_[i] = tracked_[--tracked_count_];
+                    return;
+                }
+            }
+        }
+
+        bool tracked(PGN pgn) const noexcept {
+            for (usize i = 0; i < tracked_count_; ++i) {
+                if (tracked_[i] == pgn)
+                    return true;
+            }
+            return false;
+        }
+
+        bool empty_tracking() const noexcept { return tracked_count_ == 0; }
+
+        // Store a payload (up to 8 bytes; longer transfers are not cached)
+        bool store(PGN pgn, Address source, DataSpan data, u64 timestamp_us) {
+            if (data.size() > 8)
+                return false;
+            Slot *slot = claim(make_key(pgn, source));
+            if (!slot) {
+                ++dropped_;
+                return false;
+            }
+            u32 s = slot->seq.load(std::memory_order_relaxed);
+            slot->seq.store(s + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            slot->word.store(bitfield::load_le(data.data(), data.size()), std::memory_order_relaxed);
+            slot->length.store(static_cast<u8>(data.size()), std::memory_order_relaxed);
+            slot->timestamp_us.store(timestamp_us, std::memory_order_relaxed);
+            slot->rx_ms.store(now_ms_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            slot->seq.store(s + 2, std::memory_order_release);
+            return true;
+        }
+
+        // Advance the clock ages are measured against (IsoNet does this every update)
+        void set_now(u64 now_ms) noexcept { now_ms_.store(now_ms, std::memory_order_relaxed); }
+
+        u64 dropped() const noexcept { return dropped_; }
+
+        // ─── Reader side (any thread) ────────────────────────────────────────────
+        u64 now_ms() const noexcept { return now_ms_.load(std::memory_order_relaxed); }
+
+        // Consistent copy of the latest value; false if none was received yet
+        bool read(PGN pgn, Address source, LastValue &out) const noexcept {
+            const Slot *slot = find(make_key(pgn, source));
+            if (!slot)
+                return false;
+            u32 before;
+            u32 after;
+            u64 word = 0;
+            do {
+                before = slot->seq.load(std::memory_order_acquire);
+                if (before & 1u) {
+                    after = before + 1; // Writer inside: retry
+                    continue;
+                }
+                word = slot->word.load(std::memory_order_relaxed);
+                out.length = slot->length.load(std::memory_order_relaxed);
+                out.timestamp_us = slot->timestamp_us.load(std::memory_order_relaxed);
+                out.rx_ms = slot->rx_ms.load(std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_acquire);
+                after = slot->seq.load(std::memory_order_relaxed);
+            } while (before != after);
+            if (before == 0)
+                return false;
+            out.pgn = pgn;
+            out.source = source;
+            out.updates = before / 2;
+            bitfield::pack_u64_le(out.data.data(), word);
+            return true;
+        }
+
+        dp::Optional<LastValue> get(PGN pgn, Address source) const noexcept {
+            LastValue v;
+            if (!read(pgn, source, v))
+                return dp::nullopt;
+            return v;
+        }
+
+        // Milliseconds since the value was stored, NEVER_SEEN if it never was.
+        // BROADCAST_ADDRESS as source means "from any sender" (the freshest one).
+        u32 age_ms(PGN pgn, Address source) const noexcept {
+            u64 now = now_ms();
+            u64 best = NEVER_SEEN;
+            if (source == BROADCAST_ADDRESS) {
+                for (const auto &slot : slots_) {
+                    u32 key = slot.key.load(std::memory_order_acquire);
+                    if (key == 0 || ((key - 1) >> 8) != pgn)
+                        continue;
+                    u64 age = age_of(slot, now);
+                    best = age < best ? age : best;
+                }
+                return static_cast<u32>(best);
+            }
+            const Slot *slot = find(make_key(pgn, source));
+            return slot ? static_cast<u32>(age_of(*slot, now)) : NEVER_SEEN;
+        }
+
+        bool fresh(PGN pgn, Address source, u32 max_age_ms) const noexcept {
+            return age_ms(pgn, source) <= max_age_ms;
+        }
+
+        usize size() const noexcept {
+            usize n = 0;
+            for (const auto &slot : slots_) {
+                if (slot.key.load(std::memory_order_relaxed) != 0)
+                    ++n;
+            }
+            return n;
+        }
+
+      private:
+        static constexpr u32 make_key(PGN pgn, Address source) noexcept {
+            return ((static_cast<u32>(pgn) & 0x3FFFF) << 8 | source) + 1;
+        }
+
+        static constexpr usize home(u32 key) noexcept { return (key * 0x9E3779B1u >> 16) & (SLOTS - 1); }
+
+        static u64 age_of(const Slot &slot, u64 now) noexcept {
+            if (slot.seq.load(std::memory_order_acquire) == 0)
+                return NEVER_SEEN;
+            u64 at = slot.rx_ms.load(std::memory_order_relaxed);
+            u64 age = now > at ? now - at : 0;
+            return age < NEVER_SEEN ? age : NEVER_SEEN - 1;
+        }
+
+        const Slot *find(u32 key) const noexcept {
+            usize i = home(key);
+            for (usize n = 0; n < SLOTS; ++n, i = (i + 1) & (SLOTS - 1)) {
+                u32 k = slots_[i].key.load(std::memory_order_acquire);
+                if (k == key)
+                    return &slots_[i];
+                if (k == 0)
+                    return nullptr;
+            }
+            return nullptr;
+        }
+
+        Slot *claim(u32 key) noexcept {
+            usize i = home(key);
+            for (usize n = 0; n < SLOTS; ++n, i = (i + 1) & (SLOTS - 1)) {
+                u32 k = slots_[i].key.load(std::memory_order_relaxed);
+                if (k == key)
+                    return &slots_[i];
+                if (k == 0) {
+                    slots_[i].key.store(key, std::memory_order_release);
+                    return &slots_[i];
+                }
+            }
+            return nullptr;
+        }
+    };
+
+} // namespace agrobus::net
@@ -0,0 +1,233 @@
+#pragma once
+
+#include "event.hpp"
+#include "types.hpp"
+#include <datapod/datapod.hpp>
+#include <memory>
+#include <time.h>
+
+namespace agrobus::net {
+
+    // ─── Clock ───────────────────────────────────────────────────────────────────
+    // Monotonic nanoseconds. CLOCK_MONOTONIC is served from the vDSO (no
+    // syscall, a few tens of ns); a TSC or driver clock can be installed on
+    // the LatencyMonitor instead.
+    using LatencyClock = u64 (*)();
+
+    inline u64 monotonic_ns() noexcept {
+        timespec ts;
+        ::clock_gettime(CLOCK_MONOTONIC, &ts);
+        return static_cast<u64>(ts.tv_sec) * 1000000000ULL + static_cast<u64>(ts.tv_nsec);
+    }
+
+    // ─── Summary of one histogram ────────────────────────────────────────────────
+    struct LatencySummary {
+        u64 count = 0;
+        u64 min_ns = 0;
+        u64 p50_ns = 0;
+        u64 p90_ns = 0;
+        u64 p99_ns = 0;
+        u64 max_ns = 0;
+        f64 mean_ns = 0.0;
+    };
+
+    // ─── Log-linear latency histogram ────────────────────────────────────────────
+    // HDR-style: values below 2 * SUB_BUCKETS are exact, above that every power
+    // of two is split into SUB_BUCKETS equal buckets, so a recorded value is
+    // off by at most 1/SUB_BUCKETS (~6%) at any magnitude. Covers 0 to ~18
+    // minutes in ns with a fixed array; recording is a bit scan and one add.
+    class LatencyHistogram {
+      public:
+        static constexpr u32 SUB_BITS = 4;
+        static constexpr u32 SUB_BUCKETS = 1u << SUB_BITS;
+        static constexpr u32 MAX_BIT = 40; // Values are clamped below 2^40 ns
+        static constexpr u32 BUCKETS = (MAX_BIT - SUB_BITS + 1) * SUB_BUCKETS;
+
+      private:
+        dp::Array<u64, BUCKETS> counts_ = {};
+        u64 count_ = 0;
+        u64 sum_ = 0;
+        u64 min_ = 0;
+        u64 max_ = 0;
+
+      public:
+        static constexpr u32 bucket_of(u64 value) noexcept {
+            if (value >= (1ULL << MAX_BIT))
+                value = (1ULL << MAX_BIT) - 1;
+            if (value < SUB_BUCKETS)
+                return static_cast<u32>(value);
+            u32 msb = 63 - static_cast<u32>(__builtin_clzll(value));
+            u32 shift = msb - SUB_BITS;
+            return (msb - SUB_BITS + 1) * SUB_BUCKETS + static_cast<u32>((value >> shift) & (SUB_BUCKETS - 1));
+        }
+
+        // Smallest value that lands in `bucket`
+        static constexpr u64 bucket_low(u32 bucket) noexcept {
+            if (bucket < SUB_BUCKETS)
+                return bucket;
+            u32 octave = bucket / SUB_BUCKETS - 1; // msb - SUB_BITS
+            u64 sub = bucket % SUB_BUCKETS;
+            return (static_cast<u64>(SUB_BUCKETS) | sub) << octave;
+        }
+
+        // Largest value that lands in `bucket`
+        static constexpr u64 bucket_high(u32 bucket) noexcept {
+            return bucket + 1 < BUCKETS ? bucket_low(bucket + 1) - 1 : (1ULL << MAX_BIT) - 1;
+        }
+
+        void record(u64 ns) noexcept {
+            ++counts_[bucket_of(ns)];
+            if (count_ == 0 || ns < min_)
+                min_ = ns;
+            if (ns > max_)
+                max_ = ns;
+            ++count_;
+            sum_ += ns;
+        }
+
+        void merge(const LatencyHistogram &other) noexcept {
+            if (other.count_ == 0)
+                return;
+            for (u32 i = 0; i < BUCKETS; ++i)
+                counts_[i] += other.counts_[i];
+            if (count_ == 0 || other.min_ < min_)
+                min_ = other.min_;
+            if (other.max_ > max_)
+                max_ = other.max_;
+            count_ += other.count_;
+            sum_ += other.sum_;
+        }
+
+        void reset() noexcept { *this = LatencyHistogram{}; }
+
+        u64 count() const noexcept { return count_; }
+        u64 min() const noexcept { return min_; }
+        u64 max() const noexcept { return max_; }
+        f64 mean() const noexcept { return count_ == 0 ? 0.0 : static_cast<f64>(sum_) / static_cast<f64>(count_); }
+
+        // Upper bound of the bucket holding the p-th percentile (0..100),
+        // clamped to the largest value seen
+        u64 percentile(f64 p) const noexcept {
+            if (count_ == 0)
+                return 0;
+            u64 rank = static_cast<u64>(p / 100.0 * static_cast<f64>(count_) + 0.5);
+            if (rank == 0)
+                rank = 1;
+            if (rank > count_)
+                rank = count_;
+            u64 seen = 0;
+            for (u32 i = 0; i < BUCKETS; ++i) {
+                seen += counts_[i];
+                if (seen >= rank) {
+                    u64 high = bucket_high(i);
+                    return high < max_ ? high : max_;
+                }
+            }
+            return max_;
+        }
+
+        // Samples above `ns` (bucket resolution)
+        u64 count_above(u64 ns) const noexcept {
+            u64 n = 0;
+            for (u32 i = bucket_of(ns) + 1; i < BUCKETS; ++i)
+                n += counts_[i];
+            return n;
+        }
+
+        LatencySummary summary() const noexcept {
+            return LatencySummary{count_, min_, percentile(50.0), percentile(90.0), percentile(99.0), max_, mean()};
+        }
+
+        // Export: fn(u64 low_ns, u64 high_ns, u64 count) for every non-empty bucket
+        template <typename Fn> void for_each_bucket(Fn &&fn) const {
+            for (u32 i = 0; i < BUCKETS; ++i) {
+                if (counts_[i] > 0)
+                    fn(bucket_low(i), bucket_high(i), counts_[i]);
+            }
+        }
+    };
+
+    // ─── What a sample measures ──────────────────────────────────────────────────
+    enum class LatencyKind : u8 {
+        Receive, // Frame RX timestamp (last frame of a transfer) to the end of its callbacks
+        Handler, // Time spent in the callbacks of one message
+        Send,    // send() until the endpoint accepted the last frame (TP/ETP: session complete)
+    };
+
+    inline constexpr usize LATENCY_KINDS = 3;
+
+    // ─── Latency monitor ─────────────────────────────────────────────────────────
+    // One histogram per (PGN, kind) plus a total per kind. IsoNet records into
+    // it from the thread that drives update() when NetworkConfig::latency() is
+    // set; read it from the same thread. With a budget set, every sample above
+    // it is counted and reported through on_over_budget, which is where a
+    // handler breaking the control loop's deadline shows up.
+    class LatencyMonitor {
+        using Set = dp::Array<LatencyHistogram, LATENCY_KINDS>;
+
+        dp::Map<PGN, std::unique_ptr<Set>> pgns_; // Histograms are a few KB: one allocation per PGN
+        Set total_;
+        dp::Array<u64, LATENCY_KINDS> over_budget_ = {};
+        u64 budget_ns_ = 0;
+        LatencyClock clock_ = &monotonic_ns;
+
+      public:
+        LatencyMonitor() = default;
+        explicit LatencyMonitor(u64 budget_ns) : budget_ns_(budget_ns) {}
+
+        LatencyMonitor(const LatencyMonitor &) = delete;
+        LatencyMonitor &operator=(const LatencyMonitor &) = delete;
+
+        // ─── Clock and budget ────────────────────────────────────────────────────
+        void set_clock(LatencyClock clock) noexcept { clock_ = clock ? clock : &monotonic_ns; }
+        u64 now_ns() const noexcept { return clock_(); }
+
+        void set_budget_ns(u64 ns) noexcept { budget_ns_ = ns; }
+        u64 budget_ns() const noexcept { return budget_ns_; }
+        u64 over_budget(LatencyKind kind) const noexcept { return over_budget_[static_cast<usize>(kind)]; }
+
+        // ─── Recording ───────────────────────────────────────────────────────────
+        void record(LatencyKind kind, PGN pgn, u64 ns) {
+            usize k = static_cast<usize>(kind);
+            auto &set = pgns_[pgn];
+            if (!set)
+                set = std::make_unique<Set>();
+            (*set)[k].record(ns);
+            total_[k].record(ns);
+            if (budget_ns_ > 0 && ns > budget_ns_) {
+                ++over_budget_[k];
+                on_over_budget.emit(kind, pgn, ns);
+            }
+        }
+
+        void reset() {
+            pgns_.clear();
+            for (auto &h : total_)
+                h.reset();
+            over_budget_ = {};
+        }
+
+        // ─── Queries and export ──────────────────────────────────────────────────
+        const LatencyHistogram &total(LatencyKind kind) const noexcept { return total_[static_cast<usize>(kind)]; }
+
+        // Null if nothing of that PGN was measured yet
+        const LatencyHistogram *histogram(LatencyKind kind, PGN pgn) const noexcept {
+            auto it = pgns_.find(pgn);
+            return it != pgns_.end() ? &(*it->second)[static_cast<usize>(kind)] : nullptr;
+        }
+
+        // fn(PGN, LatencyKind, const LatencyHistogram &) for every non-empty histogram
+        template <typename Fn> void for_each(Fn &&fn) const {
+            for (const auto &[pgn, set] : pgns_) {
+                for (usize k = 0; k < LATENCY_KINDS; ++k) {
+                    if ((*set)[k].count() > 0)
+                        fn(pgn, static_cast<LatencyKind>(k), (*set)[k]);
+                }
+            }
+        }
+
+        // (kind, pgn, ns) of every sample above the budget
+        Event<LatencyKind, PGN, u64> on_over_budget;
+    };
+
+} // namespace agrobus::net
@@ -0,0 +1,381 @@
+#pragma once
+
+#include <agrobus/net/bus_load.hpp>
+#include <agrobus/net/can_bus_config.hpp>
+#include <agrobus/net/latency.hpp>
+#include <agrobus/net/loopback_bus.hpp>
+#include <agrobus/net/network_manager.hpp>
+#include <agrobus/net/types.hpp>
+#include <datapod/datapod.hpp>
+#include <cstring>
+#include <memory>
+#include <time.h>
+
+namespace agrobus::net {
+
+    // ─── Generated traffic kinds ─────────────────────────────────────────────────
+    enum class LoadKind : u8 {
+        Periodic,   // Single-frame broadcast PGNs
+        Bam,        // TP broadcast
+        Tp,         // TP RTS/CTS to the network under test
+        Etp,        // ETP to the network under test
+        FastPacket, // NMEA 2000 fast packet broadcast
+        Dm1,        // Active DTCs; BAM once they no longer fit one frame
+    };
+
+    inline constexpr usize LOAD_KINDS = 6;
+
+    // PGNs the virtual ECUs use
+    inline constexpr PGN LOAD_PGN_PERIODIC = 0xFF10;     // + 0..15, one per periodic slot
+    inline constexpr PGN LOAD_PGN_BAM = 0xFF20;          // Proprietary B
+    inline constexpr PGN LOAD_PGN_DIRECT = 0xEF00;       // Proprietary A: TP and ETP to the target
+    inline constexpr PGN LOAD_PGN_FAST_PACKET = 0x1F805; // GNSS position data
+    inline constexpr PGN LOAD_PGN_BACKGROUND = 0xFF30;   // Filler frames
+
+    // ─── Load configuration ──────────────────────────────────────────────────────
+    // Rates are per virtual ECU; an interval of 0 turns that traffic off. The
+    // ECUs' schedules are spread evenly over each interval so the bus sees a
+    // steady mix rather than lockstep bursts, except for claim storms.
+    struct LoadConfig {
+        u32 ecus = 40;
+        u32 bitrate = ISO_CAN_BITRATE;
+        f32 background_percent = 30.0f; // Extra single frames filling this share of the bus
+        u32 periodic_pgns = 2;           // Per ECU, at periodic_interval_ms each
+        u32 periodic_interval_ms = 500;
+        u32 bam_interval_ms = 0;
+        u32 bam_bytes = 100;
+        u32 tp_interval_ms = 0; // Needs a target CF, as does ETP
+        u32 tp_bytes = 200;
+        u32 etp_interval_ms = 0;
+        u32 etp_bytes = 4000;
+        u32 fast_packet_interval_ms = 0;
+        u32 fast_packet_bytes = 43;
+        u32 dm1_interval_ms = 1000;
+        u32 dm1_dtcs = 1;
+        u32 claim_storm_interval_ms = 0; // A global request for address claims: every CF answers at once
+        u32 settle_ms = 2000;            // Quiet time at the end of run() for transfers in flight
+        Address first_address = 0x10;    // ECU i claims first_address + i
+
+        LoadConfig &count(u32 n) {
+            ecus = n;
+            return *this;
+        }
+        LoadConfig &bus(u32 bps, f32 background = 30.0f) {
+            bitrate = bps;
+            background_percent = background;
+            return *this;
+        }
+        LoadConfig &periodic(u32 pgns, u32 interval_ms) {
+            periodic_pgns = pgns > 16 ? 16 : pgns;
+            periodic_interval_ms = interval_ms;
+            return *this;
+        }
+        LoadConfig &bam(u32 interval_ms, u32 bytes = 100) {
+            bam_interval_ms = interval_ms;
+            bam_bytes = bytes;
+            return *this;
+        }
+        LoadConfig &tp(u32 interval_ms, u32 bytes = 200) {
+            tp_interval_ms = interval_ms;
+            tp_bytes = bytes;
+            return *this;
+        }
+        LoadConfig &etp(u32 interval_ms, u32 bytes = 4000) {
+            etp_interval_ms = interval_ms;
+            etp_bytes = bytes;
+            return *this;
+        }
+        LoadConfig &fast_packet(u32 interval_ms, u32 bytes = 43) {
+            fast_packet_interval_ms = interval_ms;
+            fast_packet_bytes = bytes;
+            return *this;
+        }
+        LoadConfig &dm1(u32 interval_ms, u32 dtcs = 1) {
+            dm1_interval_ms = interval_ms;
+            dm1_dtcs = dtcs;
+            return *this;
+        }
+        LoadConfig &claim_storms(u32 interval_ms) {
+            claim_storm_interval_ms = interval_ms;
+            return *this;
+        }
+    };
+
+    // ─── Load report ─────────────────────────────────────────────────────────────
+    struct LoadKindStats {
+        u64 sent = 0;     // Messages the virtual ECUs handed to their stack
+        u64 received = 0; // Messages delivered to the network under test
+        f64 drop_rate() const noexcept {
+            return sent == 0 || received >= sent ? 0.0 : static_cast<f64>(sent - received) / static_cast<f64>(sent);
+        }
+    };
+
+    struct LoadReport {
+        u64 sim_ms = 0;
+        u64 bus_frames = 0;
+        f64 bus_load_percent = 0.0;
+        u64 frames_received = 0; // By the network under test
+        u64 ring_drops = 0;      // Frames lost before the network under test drained them
+        u64 claims_received = 0;
+        dp::Array<LoadKindStats, LOAD_KINDS> kinds = {};
+        LatencySummary latency; // Simulated time from send() to the callback under test
+        u64 cpu_ns = 0;         // Thread CPU time spent in the update() under test
+        f64 cpu_ns_per_frame = 0.0;
+
+        const LoadKindStats &operator[](LoadKind kind) const noexcept { return kinds[static_cast<usize>(kind)]; }
+
+        f64 drop_rate() const noexcept {
+            u64 sent = 0, received = 0;
+            for (const auto &k : kinds) {
+                sent += k.sent;
+                received += k.received < k.sent ? k.received : k.sent;
+            }
+            return sent == 0 ? 0.0 : static_cast<f64>(sent - received) / static_cast<f64>(sent);
+        }
+    };
+
+    // ─── Load generator ──────────────────────────────────────────────────────────
+    // Puts the network under test on a timed LoopbackBus with `ecus` virtual
+    // ECUs (each a full IsoNet with one CF, so TP/ETP handshakes are real) and
+    // a background sender, then scripts their traffic in simulated time. Every
+    // generated message carries its kind and send time, so the callbacks
+    // installed on the network under test count deliveries and latency; its
+    // update() runs under a thread CPU clock. Nothing filters on the loopback
+    // bus, so the virtual ECUs run with foreign_transport_filter(), and so
+    // should the network under test.
+    //   IsoNet dut(NetworkConfig{}.fast_packet(true).foreign_transport_filter());
+    //   auto *cf = dut.create_internal(name, 0, 0x80).value();
+    //   dut.start_address_claiming();
+    //   LoadGenerator gen(dut, cf, LoadConfig{}.bam(500).tp(1000).claim_storms(5000));
+    //   LoadReport report = gen.run(30000);
+    // `target` may be null: destination-specific TP/ETP traffic is then off.
+    class LoadGenerator {
+        struct Ecu {
+            std::unique_ptr<IsoNet> net;
+            InternalCF *cf = nullptr;
+            u32 index = 0;
+        };
+
+        IsoNet &dut_;
+        InternalCF *target_;
+        LoadConfig config_;
+        LoopbackBus bus_;
+        LoopbackBus::Node *dut_node_ = nullptr;
+        LoopbackBus::Node *filler_ = nullptr;
+        dp::Vector<Ecu> ecus_;
+        u64 now_ms_ = 0;
+        f64 background_credit_ = 0.0;
+        u8 background_seq_ = 0;
+        LoadReport report_;
+        LatencyHistogram latency_;
+        dp::Vector<u8> payload_;
+
+      public:
+        LoadGenerator(IsoNet &dut, InternalCF *target, LoadConfig config = {})
+            : dut_(dut), target_(target), config_(config), bus_(LoopbackConfig{}.timed(config.bitrate)) {
+            dut_node_ = &bus_.attach(dut_);
+            filler_ = &bus_.add_node();
+            for (u32 i = 0; i < config_.ecus; ++i)
+                add_ecu(i);
+            observe();
+        }
+
+        LoadGenerator(const LoadGenerator &) = delete;
+        LoadGenerator &operator=(const LoadGenerator &) = delete;
+
+        // Generate traffic for `duration_ms`, then let it settle; the report
+        // covers every run() so far
+        LoadReport run(u64 duration_ms) {
+            u64 end = now_ms_ + duration_ms;
+            while (now_ms_ < end)
+                step(true);
+            for (u32 i = 0; i < config_.settle_ms; ++i)
+                step(false);
+            return report();
+        }
+
+        LoadReport report() const {
+            LoadReport r = report_;
+            r.sim_ms = now_ms_;
+            r.bus_frames = bus_.frames();
+            if (now_ms_ > 0 && config_.bitrate > 0)
+                r.bus_load_percent = static_cast<f64>(bus_.bits()) * 100000.0 /
+                                     (static_cast<f64>(now_ms_) * static_cast<f64>(config_.bitrate));
+            r.ring_drops = dut_node_->dropped();
+            r.latency = latency_.summary();
+            r.cpu_ns_per_frame =
+                r.frames_received > 0 ? static_cast<f64>(r.cpu_ns) / static_cast<f64>(r.frames_received) : 0.0;
+            return r;
+        }
+
+        LoopbackBus &bus() noexcept { return bus_; }
+        usize ecus() const noexcept { return ecus_.size(); }
+        IsoNet &ecu(usize i) noexcept { return *ecus_[i].net; }
+
+      private:
+        void add_ecu(u32 i) {
+            Ecu ecu;
+            ecu.net = std::make_unique<IsoNet>(
+                NetworkConfig{}.bus_load(false).fast_packet(true).foreign_transport_filter());
+            ecu.net->register_fast_packet_pgn(LOAD_PGN_FAST_PACKET);
+            bus_.attach(*ecu.net);
+            Name name = Name::build().set_identity_number(0x10000 + i).set_self_configurable(true);
+            ecu.cf = ecu.net->create_internal(name, 0, static_cast<Address>(config_.first_address + i)).value();
+            ecu.net->start_address_claiming(); // All at once: the power-up claim storm
+            ecu.index = i;
+            ecus_.push_back(std::move(ecu));
+        }
+
+        // Callbacks on the network under test
+        void observe() {
+            dut_.register_fast_packet_pgn(LOAD_PGN_FAST_PACKET);
+            auto count = [this](const Message &msg) {
+                if (msg.data.size() < 5)
+                    return;
+                u8 kind = msg.data[0];
+                if (kind >= LOAD_KINDS)
+                    return;
+                ++report_.kinds[kind].received;
+                u32 sent_us = static_cast<u32>(msg.data[1]) | static_cast<u32>(msg.data[2]) << 8 |
+                              static_cast<u32>(msg.data[3]) << 16 | static_cast<u32>(msg.data[4]) << 24;
+                u32 now_us = static_cast<u32>(bus_.now_us());
+                latency_.record(static_cast<u64>(now_us - sent_us) * 1000);
+            };
+            for (u32 i = 0; i < config_.periodic_pgns; ++i)
+                dut_.register_pgn_callback(LOAD_PGN_PERIODIC + i, count);
+            dut_.register_pgn_callback(LOAD_PGN_BAM, count);
+            dut_.register_pgn_callback(LOAD_PGN_DIRECT, count);
+            dut_.register_pgn_callback(LOAD_PGN_FAST_PACKET, count);
+            dut_.register_pgn_callback(PGN_DM1, [this](const Message &) {
+                ++report_.kinds[static_cast<usize>(LoadKind::Dm1)].received;
+            });
+            dut_.on_frame_received.subscribe([this](const Frame &frame, u8) {
+                ++report_.frames_received;
+                if (frame.pgn() == PGN_ADDRESS_CLAIMED)
+                    ++report_.claims_received;
+            });
+        }
+
+        void step(bool generate) {
+            if (generate) {
+                background();
+                u32 storm = config_.claim_storm_interval_ms;
+                if (storm > 0 && now_ms_ > 0 && now_ms_ % storm == 0)
+                    claim_storm();
+                for (auto &ecu : ecus_)
+                    traffic(ecu);
+            }
+            for (auto &ecu : ecus_)
+                ecu.net->update(1);
+            timespec start, end;
+            ::clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+            dut_.update(1);
+            ::clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+            report_.cpu_ns +=
+                static_cast<u64>((end.tv_sec - start.tv_sec) * 1000000000LL + (end.tv_nsec - start.tv_nsec));
+            bus_.advance(1000);
+            ++now_ms_;
+        }
+
+        // ECU i sends i/ecus of the way into each interval
+        bool due(u32 interval_ms, const Ecu &ecu, u32 offset_ms = 0) const noexcept {
+            if (interval_ms == 0)
+                return false;
+            u64 phase = static_cast<u64>(ecu.index) * interval_ms / config_.ecus + offset_ms;
+            return (now_ms_ + phase) % interval_ms == 0;
+        }
+
+        void traffic(Ecu &ecu) {
+            if (ecu.cf->claim_state() != ClaimState::Claimed)
+                return;
+            for (u32 i = 0; i < config_.periodic_pgns; ++i) {
+                if (due(config_.periodic_interval_ms, ecu, i))
+                    send(ecu, LoadKind::Periodic, LOAD_PGN_PERIODIC + i, 8, nullptr);
+            }
+            if (due(config_.bam_interval_ms, ecu) && !broadcasting(ecu))
+                send(ecu, LoadKind::Bam, LOAD_PGN_BAM, config_.bam_bytes, nullptr);
+            if (due(config_.fast_packet_interval_ms, ecu))
+                send(ecu, LoadKind::FastPacket, LOAD_PGN_FAST_PACKET, config_.fast_packet_bytes, nullptr);
+            if (target_ && target_->cf().address_valid()) {
+                ControlFunction dest;
+                dest.address = target_->address();
+                if (due(config_.tp_interval_ms, ecu))
+                    send(ecu, LoadKind::Tp, LOAD_PGN_DIRECT, config_.tp_bytes, &dest);
+                if (due(config_.etp_interval_ms, ecu))
+                    send(ecu, LoadKind::Etp, LOAD_PGN_DIRECT, config_.etp_bytes, &dest);
+            }
+            if (due(config_.dm1_interval_ms, ecu, config_.dm1_interval_ms / 2))
+                dm1(ecu);
+        }
+
+        // A source has one BAM at a time: a second one would replace the first
+        // at every receiver
+        static bool broadcasting(Ecu &ecu) {
+            for (const auto *s : ecu.net->transport_protocol().active_sessions()) {
+                if (s->direction == TransportDirection::Transmit && s->destination_address == BROADCAST_ADDRESS)
+                    return true;
+            }
+            return false;
+        }
+
+        void send(Ecu &ecu, LoadKind kind, PGN pgn, u32 bytes, ControlFunction *dest) {
+            payload_.assign(bytes < 8 ? 8 : bytes, static_cast<u8>(ecu.cf->address()));
+            u32 now_us = static_cast<u32>(bus_.now_us());
+            payload_[0] = static_cast<u8>(kind);
+            std::memcpy(payload_.data() + 1, &now_us, 4);
+            if (ecu.net->send(pgn, payload_, ecu.cf, dest).is_ok())
+                ++report_.kinds[static_cast<usize>(kind)].sent;
+        }
+
+        // Lamp status, then one 4-byte DTC per fault
+        void dm1(Ecu &ecu) {
+            u32 dtcs = config_.dm1_dtcs == 0 ? 1 : config_.dm1_dtcs;
+            payload_.assign(2 + 4 * dtcs, 0);
+            payload_[0] = 0x04; // Amber warning lamp on
+            for (u32 i = 0; i < dtcs; ++i) {
+                u32 spn = 100 + i;
+                payload_[2 + 4 * i] = static_cast<u8>(spn);
+                payload_[3 + 4 * i] = static_cast<u8>(spn >> 8);
+                payload_[4 + 4 * i] = static_cast<u8>(((spn >> 11) & 0xE0) | 3); // FMI 3
+                payload_[5 + 4 * i] = 1;                                        // Occurrence count
+            }
+            if (payload_.size() < 8)
+                payload_.resize(8, 0xFF);
+            else if (payload_.size() > 8 && broadcasting(ecu))
+                return;
+            if (ecu.net->send(PGN_DM1, payload_, ecu.cf).is_ok())
+                ++report_.kinds[static_cast<usize>(LoadKind::Dm1)].sent;
+        }
+
+        // Single frames from addresses no ECU claims, at the configured share
+        void background() {
+            if (config_.background_percent <= 0.0f || config_.bitrate == 0)
+                return;
+            background_credit_ += static_cast<f64>(config_.background_percent) / 100.0 *
+                                  static_cast<f64>(config_.bitrate) / 1000.0 / BusLoad::frame_bits(8);
+            while (background_credit_ >= 1.0) {
+                background_credit_ -= 1.0;
+                can_frame cf{};
+                Address src = static_cast<Address>(0xF0 + (background_seq_ & 0x07));
+                cf.can_id = Identifier::encode(Priority::Lowest, LOAD_PGN_BACKGROUND, src, BROADCAST_ADDRESS).raw |
+                            CAN_EFF_FLAG;
+                cf.can_dlc = 8;
+                std::memset(cf.data, background_seq_++, 8);
+                filler_->send_can(cf);
+            }
+        }
+
+        // Request for Address Claimed to global: every CF on the bus answers
+        void claim_storm() {
+            can_frame cf{};
+            cf.can_id = Identifier::encode(Priority::Default, PGN_REQUEST, NULL_ADDRESS, BROADCAST_ADDRESS).raw |
+                        CAN_EFF_FLAG;
+            cf.can_dlc = 3;
+            cf.data[0] = static_cast<u8>(PGN_ADDRESS_CLAIMED & 0xFF);
+            cf.data[1] = static_cast<u8>((PGN_ADDRESS_CLAIMED >> 8) & 0xFF);
+            cf.data[2] = static_cast<u8>((PGN_ADDRESS_CLAIMED >> 16) & 0xFF);
+            filler_->send_can(cf);
+        }
+    };
+
+} // namespace agrobus::net
@@ -0,0 +1,266 @@
+#pragma once
+
+#include <agrobus/net/bus_load.hpp>
+#include <agrobus/net/eth_can.hpp>
+#include <agrobus/net/network_manager.hpp>
+#include <agrobus/net/types.hpp>
+#include <memory>
+#include <wirebit/can/can_endpoint.hpp>
+
+namespace agrobus::net {
+
+    // ─── Loopback bus configuration ──────────────────────────────────────────────
+    struct LoopbackConfig {
+        u32 bitrate = 0;           // 0: ideal bus, frames arrive the moment they are sent
+        bool arbitration = true;   // Timed bus: lowest identifier wins among waiting frames
+        u32 rx_ring_frames = 4096; // Per node
+        // Wire time of a frame on a timed bus
+        BitModel bit_model = BitModel::Average;
+
+        LoopbackConfig &timed(u32 bps) {
+            bitrate = bps;
+            return *this;
+        }
+        LoopbackConfig &fifo() {
+            arbitration = false;
+            return *this;
+        }
+        LoopbackConfig &wire_bits(BitModel model) {
+            bit_model = model;
+            return *this;
+        }
+        LoopbackConfig &rx_ring(u32 frames) {
+            rx_ring_frames = frames;
+            return *this;
+        }
+    };
+
+    // ─── LoopbackBus: in-process CAN bus ─────────────────────────────────────────
+    // Connects any number of IsoNets in one process through memory: no sockets,
+    // no syscalls, so what is measured is the stack alone. Every node sees the
+    // frames of every other node, like on a real bus.
+    //
+    // Ideal (bitrate 0): a sent frame is in the other nodes' rings before
+    // send returns. Timed: frames wait for the simulated bus and occupy it for
+    // their wire time; when it frees up the lowest identifier among each
+    // node's oldest waiting frame goes next (or the oldest, with fifo()).
+    // Simulated time only moves with advance(), so a VT pool upload or DDOP
+    // transfer reports how long it would take on the wire, however fast the
+    // host is. Received frames carry the simulated time.
+    //
+    // Single-threaded: update the nodes and the bus from one loop.
+    //   LoopbackBus bus(LoopbackConfig{}.timed(250000));
+    //   bus.attach(nm_a);
+    //   bus.attach(nm_b);
+    //   while (!done) { nm_a.update(1); nm_b.update(1); bus.advance(1000); }
+    class LoopbackBus {
+      public:
+        class Node {
+            struct Slot {
+                can_frame cf;
+                u64 timestamp_us;
+            };
+
+            LoopbackBus *bus_;
+            u16 id_;
+            dp::Vector<Slot> ring_;
+            u32 mask_ = 0;
+            u32 head_ = 0;
+            u32 tail_ = 0;
+            u64 dropped_ = 0;
+            u64 last_timestamp_us_ = 0;
+            std::shared_ptr<CanTunnelLink<Node>> link_;
+            wirebit::CanEndpoint can_ep_;
+
+          public:
+            Node(LoopbackBus *bus, u16 id, u32 ring_frames)
+                : bus_(bus), id_(id), link_(std::make_shared<CanTunnelLink<Node>>(this, "loopback")),
+                  can_ep_(std::static_pointer_cast<wirebit::Link>(link_), wirebit::CanConfig{.bitrate = 250000}, id) {
+                u32 ring = 1;
+                while (ring < ring_frames)
+                    ring <<= 1;
+                ring_.resize(ring);
+                mask_ = ring - 1;
+            }
+
+            Node(const Node &) = delete;
+            Node &operator=(const Node &) = delete;
+
+            wirebit::CanEndpoint &can_endpoint() noexcept { return can_ep_; }
+
+            std::function<bool(can_frame &)> rx_source() {
+                return [this](can_frame &cf) { return pop_can(cf); };
+            }
+
+            void send_can(const can_frame &cf) { bus_->submit(cf, id_); }
+
+            bool pop_can(can_frame &cf) noexcept {
+                if (head_ == tail_)
+                    return false;
+                const Slot &s = ring_[head_ & mask_];
+                cf = s.cf;
+                last_timestamp_us_ = s.timestamp_us;
+                ++head_;
+                return true;
+            }
+
+            u32 rx_pending() const noexcept { return tail_ - head_; }
+            u64 dropped() const noexcept { return dropped_; } // Ring full
+            u64 last_timestamp_us() const noexcept { return last_timestamp_us_; }
+            u16 id() const noexcept { return id_; }
+
+          private:
+            friend class LoopbackBus;
+
+            void deliver(const can_frame &cf, u64 timestamp_us) noexcept {
+                if (tail_ - head_ > mask_) {
+                    ++dropped_;
+                    return;
+                }
+                ring_[tail_ & mask_] = Slot{cf, timestamp_us};
+                ++tail_;
+            }
+        };
+
+      private:
+        struct Waiting {
+            can_frame cf;
+            u16 sender;
+            u64 queued_ns;
+        };
+
+        LoopbackConfig config_;
+        dp::Vector<std::unique_ptr<Node>> nodes_;
+        dp::Vector<Waiting> waiting_;
+        dp::Vector<u8> contending_; // Per node: its oldest waiting frame was seen
+        u64 now_ns_ = 0;
+        u64 bus_free_ns_ = 0; // End of the frame on the wire
+        u64 frames_ = 0;
+        u64 bits_ = 0;
+
+      public:
+        explicit LoopbackBus(LoopbackConfig config = {}) : config_(std::move(config)) {}
+
+        // Nodes hold a pointer back here
+        LoopbackBus(const LoopbackBus &) = delete;
+        LoopbackBus &operator=(const LoopbackBus &) = delete;
+
+        // ─── Nodes ───────────────────────────────────────────────────────────────
+        Node &add_node() {
+            nodes_.push_back(std::make_unique<Node>(this, static_cast<u16>(nodes_.size() + 1), config_.rx_ring_frames));
+            return *nodes_.back();
+        }
+
+        // Add a node and make it `port` of `nm`; on a timed bus the network's RX
+        // timestamps follow simulated time
+        Node &attach(IsoNet &nm, u8 port = 0) {
+            Node &node = add_node();
+            nm.set_endpoint(port, &node.can_endpoint());
+            nm.set_rx_source(port, node.rx_source());
+            if (config_.bitrate > 0)
+                nm.set_rx_clock([&node] { return node.last_timestamp_us(); });
+            return node;
+        }
+
+        usize nodes() const noexcept { return nodes_.size(); }
+
+        // ─── Simulated time ──────────────────────────────────────────────────────
+        // Move simulated time forward, putting on the wire whatever fits
+        void advance(u64 us) {
+            now_ns_ += us * 1000;
+            schedule(now_ns_);
+        }
+
+        // Run the bus until nothing waits; returns the simulated time then (µs)
+        u64 drain() {
+            schedule(~u64{0});
+            if (bus_free_ns_ > now_ns_)
+                now_ns_ = bus_free_ns_;
+            return now_us();
+        }
+
+        u64 now_us() const noexcept { return now_ns_ / 1000; }
+        usize waiting() const noexcept { return waiting_.size(); }
+
+        // ─── Statistics ──────────────────────────────────────────────────────────
+        u64 frames() const noexcept { return frames_; } // On the wire
+        u64 bits() const noexcept { return bits_; }
+
+        // Wire time of one frame on this bus (ns)
+        u64 frame_ns(u8 dlc) const noexcept { return bits_to_ns(BusLoad::frame_bits(dlc)); }
+
+        u64 frame_ns(const can_frame &cf) const noexcept { return bits_to_ns(frame_bits(cf)); }
+
+      private:
+        u64 bits_to_ns(u32 bits) const noexcept {
+            return config_.bitrate > 0 ? static_cast<u64>(bits) * 1000000000ULL / config_.bitrate : 0;
+        }
+
+        u32 frame_bits(const can_frame &cf) const noexcept {
+            switch (config_.bit_model) {
+            case BitModel::Exact:
+                return BusLoad::frame_bits_exact(cf.can_id & CAN_EFF_MASK, cf.data, cf.can_dlc);
+            case BitModel::WorstCase:
+                return BusLoad::frame_bits_worst(cf.can_dlc);
+            default:
+                return BusLoad::frame_bits(cf.can_dlc);
+            }
+        }
+
+        void submit(const can_frame &cf, u16 sender) {
+            if (config_.bitrate == 0) {
+                transmit(cf, sender, now_us());
+                return;
+            }
+            waiting_.push_back(Waiting{cf, sender, now_ns_});
+        }
+
+        void transmit(const can_frame &cf, u16 sender, u64 timestamp_us) {
+            ++frames_;
+            bits_ += frame_bits(cf);
+            for (auto &node : nodes_) {
+                if (node->id() != sender)
+                    node->deliver(cf, timestamp_us);
+            }
+        }
+
+        // Put frames on the wire until one would end after `until_ns`
+        void schedule(u64 until_ns) {
+            while (!waiting_.empty()) {
+                // The bus frees up, or the first frame arrives at an idle bus
+                u64 earliest = waiting_[0].queued_ns;
+                for (const auto &w : waiting_)
+                    earliest = w.queued_ns < earliest ? w.queued_ns : earliest;
+                u64 start = bus_free_ns_ > earliest ? bus_free_ns_ : earliest;
+
+                // Arbitration among the oldest frame of every node ready by then:
+                // a node's own frames leave in order, as from a controller's TX
+                // queue. waiting_ is in submission order, so without arbitration
+                // the first ready frame goes.
+                usize pick = waiting_.size();
+                contending_.assign(nodes_.size() + 1, 0);
+                for (usize i = 0; i < waiting_.size(); ++i) {
+                    if (contending_[waiting_[i].sender]++ > 0 || waiting_[i].queued_ns > start)
+                        continue;
+                    if (pick == waiting_.size())
+                        pick = i;
+                    else if (!config_.arbitration)
+                        break;
+                    else if ((waiting_[i].cf.can_id & CAN_EFF_MASK) < (waiting_[pick].cf.can_id & CAN_EFF_MASK))
+                        pick = i;
+                }
+
+                u64 end = start + frame_ns(waiting_[pick].cf);
+                if (end > until_ns)
+                    return;
+                Waiting w = waiting_[pick];
+                for (usize i = pick; i + 1 < waiting_.size(); ++i)
+                    waiting_[i] = waiting_[i + 1];
+                waiting_.pop_back();
+                bus_free_ns_ = end;
+                transmit(w.cf, w.sender, end / 1000);
+            }
+        }
+    };
+
+} // namespace agrobus::net
@@ -0,0 +1,233 @@
+#pragma once
+
+#include <agrobus/net/error.hpp>
+#include <agrobus/net/types.hpp>
+#include <atomic>
+#include <datapod/datapod.hpp>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <utility>
+
+namespace agrobus::net {
+
+    // ─── Memory usage of one budget ──────────────────────────────────────────────
+    struct MemoryUsage {
+        u64 live = 0;     // Bytes charged now
+        u64 peak = 0;     // Highest live since creation or reset_peak()
+        u64 limit = 0;    // 0 = unlimited
+        u64 rejected = 0; // Charges refused for exceeding the limit
+    };
+
+    // ─── Named memory budget ─────────────────────────────────────────────────────
+    // The bytes a subsystem holds for its peers (TP/ETP session buffers, VT
+    // pools and stored versions, DDOPs, file-server write buffers), charged
+    // when the subsystem takes them on and released when it lets go. A charge
+    // that would take live usage past the limit is refused, and the subsystem
+    // turns the request that needed it down through the protocol (abort,
+    // "not enough memory") instead of growing. Counters are atomic: usage()
+    // can be read from any thread.
+    class MemoryBudget {
+        dp::String name_;
+        std::atomic<u64> limit_;
+        std::atomic<u64> live_{0};
+        std::atomic<u64> peak_{0};
+        std::atomic<u64> rejected_{0};
+
+      public:
+        explicit MemoryBudget(dp::String name, u64 limit = 0) : name_(std::move(name)), limit_(limit) {}
+
+        MemoryBudget(const MemoryBudget &) = delete;
+        MemoryBudget &operator=(const MemoryBudget &) = delete;
+
+        const dp::String &name() const noexcept { return name_; }
+        u64 limit() const noexcept { return limit_.load(std::memory_order_relaxed); }
+        // A lower limit does not take back what is charged; it refuses charges until usage drops
+        void set_limit(u64 limit) noexcept { limit_.store(limit, std::memory_order_relaxed); }
+
+        bool fits(u64 bytes) const noexcept {
+            u64 limit = this->limit();
+            u64 live = live_.load(std::memory_order_relaxed);
+            return limit == 0 || (live <= limit && bytes <= limit - live);
+        }
+
+        // Charge `bytes`, or refuse with ErrorCode::NoResources if they do not fit
+        Result<void> charge(u64 bytes) {
+            u64 live = live_.load(std::memory_order_relaxed);
+            do {
+                u64 limit = this->limit();
+                if (limit != 0 && (live > limit || bytes > limit - live)) {
+                    rejected_.fetch_add(1, std::memory_order_relaxed);
+                    return Result<void>::err(Error(ErrorCode::NoResources, "memory budget exceeded: " + name_));
+                }
+            } while (!live_.compare_exchange_weak(live, live + bytes, std::memory_order_relaxed));
+            raise_peak(live + bytes);
+            return {};
+        }
+
+        // Charge bytes that are already held, past the limit if need be
+        void force(u64 bytes) noexcept { raise_peak(live_.fetch_add(bytes, std::memory_order_relaxed) + bytes); }
+
+        void release(u64 bytes) noexcept {
+            u64 live = live_.load(std::memory_order_relaxed);
+            while (!live_.compare_exchange_weak(live, live > bytes ? live - bytes : 0, std::memory_order_relaxed)) {
+            }
+        }
+
+        u64 live() const noexcept { return live_.load(std::memory_order_relaxed); }
+        u64 peak() const noexcept { return peak_.load(std::memory_order_relaxed); }
+        MemoryUsage usage() const noexcept {
+            return {live(), peak(), limit(), rejected_.load(std::memory_order_relaxed)};
+        }
+        void reset_peak() noexcept { peak_.store(live(), std::memory_order_relaxed); }
+
+      private:
+        void raise_peak(u64 live) noexcept {
+            u64 peak = peak_.load(std::memory_order_relaxed);
+            while (live > peak && !peak_.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {
+            }
+        }
+    };
+
+    // ─── Charge held against a budget ────────────────────────────────────────────
+    // The bytes one owner has charged (a server's pools, an open file's buffer);
+    // resize() moves the charge to a new size, release happens on destruction.
+    // Without a budget every resize succeeds and nothing is counted.
+    class MemoryCharge {
+        MemoryBudget *budget_ = nullptr;
+        u64 bytes_ = 0;
+
+      public:
+        MemoryCharge() = default;
+        explicit MemoryCharge(MemoryBudget *budget) noexcept : budget_(budget) {}
+        MemoryCharge(MemoryCharge &&other) noexcept
+            : budget_(other.budget_), bytes_(std::exchange(other.bytes_, 0)) {}
+        MemoryCharge &operator=(MemoryCharge &&other) noexcept {
+            if (this != &other) {
+                reset();
+                budget_ = other.budget_;
+                bytes_ = std::exchange(other.bytes_, 0);
+            }
+            return *this;
+        }
+        MemoryCharge(const MemoryCharge &) = delete;
+        MemoryCharge &operator=(const MemoryCharge &) = delete;
+        ~MemoryCharge() { reset(); }
+
+        // Grow or shrink the charge to `bytes`; growing past the budget fails
+        // and leaves the charge as it was
+        Result<void> resize(u64 bytes) {
+            if (budget_ && bytes > bytes_) {
+                if (auto r = budget_->charge(bytes - bytes_); !r.is_ok())
+                    return r;
+            } else if (budget_ && bytes < bytes_) {
+                budget_->release(bytes_ - bytes);
+            }
+            bytes_ = bytes;
+            return {};
+        }
+
+        // Move the charge to `bytes` already held, past the budget if need be
+        void force(u64 bytes) noexcept {
+            if (budget_ && bytes > bytes_)
+                budget_->force(bytes - bytes_);
+            else if (budget_ && bytes < bytes_)
+                budget_->release(bytes_ - bytes);
+            bytes_ = bytes;
+        }
+
+        // Whether `bytes` more would fit
+        bool fits(u64 bytes) const noexcept { return !budget_ || budget_->fits(bytes); }
+
+        void reset() noexcept {
+            if (budget_ && bytes_ > 0)
+                budget_->release(bytes_);
+            bytes_ = 0;
+        }
+
+        u64 bytes() const noexcept { return bytes_; }
+        MemoryBudget *budget() const noexcept { return budget_; }
+    };
+
+    // ─── Budgeted memory resource ────────────────────────────────────────────────
+    // std::pmr resource that charges every allocation to a budget before
+    // handing it to the upstream resource, for application containers that
+    // should count against the same arena as a subsystem. Over the budget,
+    // allocate() throws std::bad_alloc like an exhausted arena.
+    class BudgetResource : public std::pmr::memory_resource {
+        MemoryBudget &budget_;
+        std::pmr::memory_resource *upstream_;
+
+      public:
+        explicit BudgetResource(MemoryBudget &budget,
+                                std::pmr::memory_resource *upstream = std::pmr::get_default_resource()) noexcept
+            : budget_(budget), upstream_(upstream) {}
+
+        MemoryBudget &budget() const noexcept { return budget_; }
+
+      private:
+        void *do_allocate(std::size_t bytes, std::size_t alignment) override {
+            if (!budget_.charge(bytes).is_ok())
+                throw std::bad_alloc();
+            try {
+                return upstream_->allocate(bytes, alignment);
+            } catch (...) {
+                budget_.release(bytes);
+                throw;
+            }
+        }
+
+        void do_deallocate(void *p, std::size_t bytes, std::size_t alignment) override {
+            upstream_->deallocate(p, bytes, alignment);
+            budget_.release(bytes);
+        }
+
+        bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override { return this == &other; }
+    };
+
+    // ─── Memory budgets of a process ─────────────────────────────────────────────
+    // Owns the named budgets handed to IsoNet (NetworkConfig::transport_memory),
+    // VTServer, TaskControllerServer and FileServer, and reports them together.
+    // Budgets never move: the references get() returns stay valid.
+    class MemoryBudgets {
+        dp::Vector<std::unique_ptr<MemoryBudget>> budgets_;
+
+      public:
+        // The budget called `name`, created with `limit` the first time
+        MemoryBudget &get(const dp::String &name, u64 limit = 0) {
+            if (auto *b = find(name))
+                return *b;
+            budgets_.push_back(std::make_unique<MemoryBudget>(name, limit));
+            return *budgets_.back();
+        }
+
+        MemoryBudget *find(const dp::String &name) const noexcept {
+            for (const auto &b : budgets_) {
+                if (b->name() == name)
+                    return b.get();
+            }
+            return nullptr;
+        }
+
+        usize size() const noexcept { return budgets_.size(); }
+        MemoryBudget &at(usize i) const noexcept { return *budgets_[i]; }
+
+        // Sum over all budgets (limit: 0 if any of them is unlimited)
+        MemoryUsage total() const noexcept {
+            MemoryUsage sum;
+            bool unlimited = false;
+            for (const auto &b : budgets_) {
+                MemoryUsage u = b->usage();
+                sum.live += u.live;
+                sum.peak += u.peak;
+                sum.limit += u.limit;
+                sum.rejected += u.rejected;
+                unlimited = unlimited || u.limit == 0;
+            }
+            if (unlimited)
+                sum.limit = 0;
+            return sum;
+        }
+    };
+
+} // namespace agrobus::net
@@ -1,6 +1,8 @@
 #pragma once
 
 #include "constants.hpp"
+#include "data_span.hpp"
+#include "payload.hpp"
 #include "types.hpp"
 #include <datapod/datapod.hpp>
 
@@ -9,15 +11,16 @@ namespace agrobus::net {
     // ─── CAN Message (arbitrary length, decoded from TP/ETP or single frame) ────
     struct Message {
         PGN pgn = 0;
-        dp::Vector<u8> data;
+        Payload data; // Inline up to PAYLOAD_INLINE_BYTES, heap beyond
         Address source = NULL_ADDRESS;
         Address destination = BROADCAST_ADDRESS;
         Priority priority = Priority::Default;
-        u64 timestamp_us = 0;
+        u64 timestamp_us = 0;       // RX time of the last frame (the only frame for single-frame messages)
+        u64 first_timestamp_us = 0; // RX time of the first frame of a multi-frame transfer
 
         Message() = default;
 
-        Message(PGN p, dp::Vector<u8> d, Address src, Address dst = BROADCAST_ADDRESS,
+        Message(PGN p, Payload d, Address src, Address dst = BROADCAST_ADDRESS,
                 Priority prio = Priority::Default)
             : pgn(p), data(std::move(d)), source(src), destination(dst), priority(prio) {}
 
@@ -57,20 +60,9 @@ namespace agrobus::net {
             return (data[byte_offset] >> bit) & 0x01;
         }
 
-        // Extract arbitrary bit field (up to 32 bits)
+        // Extract arbitrary bit field (up to 32 bits, LSB first); bits past the end read as 0
         u32 get_bits(usize start_bit, u8 length) const noexcept {
-            if (length == 0 || length > 32)
-                return 0;
-            u32 result = 0;
-            for (u8 i = 0; i < length; ++i) {
-                usize bit_pos = start_bit + i;
-                usize byte_idx = bit_pos / 8;
-                u8 bit_idx = bit_pos % 8;
-                if (byte_idx < data.size()) {
-                    result |= static_cast<u32>((data[byte_idx] >> bit_idx) & 0x01) << i;
-                }
-            }
-            return result;
+            return bitfield::extract_le(data.data(), data.size(), start_bit, length);
         }
 
         bool is_broadcast() const noexcept { return destination == BROADCAST_ADDRESS; }
@@ -99,6 +91,64 @@ namespace agrobus::net {
             data[offset + 2] = static_cast<u8>((val >> 16) & 0xFF);
             data[offset + 3] = static_cast<u8>((val >> 24) & 0xFF);
         }
+
+        // Counterpart of get_bits (up to 32 bits); grows the payload with 0xFF as needed
+        void set_bits(usize start_bit, u8 length, u32 value) {
+            if (length == 0 || length > bitfield::MAX_FIELD_BITS)
+                return;
+            usize end = (start_bit + length + 7) / 8;
+            if (end > data.size())
+                data.resize(end, 0xFF);
+            bitfield::deposit_le(data.data(), data.size(), start_bit, length, value);
+        }
+    };
+
+    // ─── Non-owning message view (zero-copy receive path) ───────────────────────
+    // Points at a frame payload or a completed transport buffer. Only valid for
+    // the duration of the callback it is passed to; call to_message() to keep it.
+    struct MessageView {
+        PGN pgn = 0;
+        DataSpan data;
+        Address source = NULL_ADDRESS;
+        Address destination = BROADCAST_ADDRESS;
+        Priority priority = Priority::Default;
+        u64 timestamp_us = 0;
+        u64 first_timestamp_us = 0;
+
+        MessageView() = default;
+
+        MessageView(PGN p, DataSpan d, Address src, Address dst = BROADCAST_ADDRESS,
+                    Priority prio = Priority::Default, u64 ts = 0)
+            : pgn(p), data(d), source(src), destination(dst), priority(prio), timestamp_us(ts), first_timestamp_us(ts) {}
+
+        MessageView(const Message &msg)
+            : pgn(msg.pgn), data(msg.data), source(msg.source), destination(msg.destination), priority(msg.priority),
+              timestamp_us(msg.timestamp_us), first_timestamp_us(msg.first_timestamp_us) {}
+
+        // ─── Data extraction helpers (mirror Message) ────────────────────────────
+        u8 get_u8(usize offset) const noexcept { return data.get_u8(offset); }
+        u16 get_u16_le(usize offset) const noexcept { return data.get_u16_le(offset); }
+        u32 get_u32_le(usize offset) const noexcept { return data.get_u32_le(offset); }
+        u64 get_u64_le(usize offset) const noexcept { return data.get_u64_le(offset); }
+        bool get_bit(usize byte_offset, u8 bit) const noexcept { return data.get_bit(byte_offset, bit); }
+        u32 get_bits(usize start_bit, u8 length) const noexcept { return data.get_bits(start_bit, length); }
+
+        bool is_broadcast() const noexcept { return destination == BROADCAST_ADDRESS; }
+
+        usize size() const noexcept { return data.size(); }
+
+        // Materialize an owning copy
+        Message to_message() const {
+            Message msg;
+            msg.pgn = pgn;
+            msg.source = source;
+            msg.destination = destination;
+            msg.priority = priority;
+            msg.timestamp_us = timestamp_us;
+            msg.first_timestamp_us = first_timestamp_us;
+            msg.data.assign(data.begin(), data.end());
+            return msg;
+        }
     };
 
 } // namespace agrobus::net
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <agrobus/net/types.hpp>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace agrobus::net {
+
+    // ─── Lock-free multi-producer / single-consumer queue ────────────────────────
+    // Bounded, fixed capacity (rounded up to a power of two), allocated once.
+    // Every slot carries a sequence number: a producer claims the next
+    // position with one compare-and-swap on the tail, moves its value in and
+    // publishes it by advancing the slot's sequence; the consumer takes slots
+    // in order as they are published. No producer waits for another beyond a
+    // retried CAS, and a push into a full queue is refused and counted in
+    // dropped(). Any thread calls try_push(), one thread calls try_pop().
+    template <typename T> class MpscQueue {
+        static constexpr usize CACHE_LINE = 64;
+
+        struct Slot {
+            std::atomic<usize> seq{0}; // == position: free; == position + 1: holds a value
+            T value{};
+        };
+
+        std::unique_ptr<Slot[]> slots_;
+        usize mask_ = 0;
+        alignas(CACHE_LINE) std::atomic<usize> tail_{0}; // Next position to claim (producers)
+        alignas(CACHE_LINE) usize head_ = 0;             // Next position to pop (consumer-owned)
+        alignas(CACHE_LINE) std::atomic<u64> dropped_{0};
+
+      public:
+        explicit MpscQueue(usize capacity) {
+            usize cap = 2;
+            while (cap < capacity)
+                cap <<= 1;
+            slots_ = std::make_unique<Slot[]>(cap);
+            for (usize i = 0; i < cap; ++i)
+                slots_[i].seq.store(i, std::memory_order_relaxed);
+            mask_ = cap - 1;
+        }
+
+        MpscQueue(const MpscQueue &) = delete;
+        MpscQueue &operator=(const MpscQueue &) = delete;
+
+        // Producer side, any thread; `value` is left untouched when refused
+        bool try_push(T &&value) noexcept(std::is_nothrow_move_assignable_v<T>) {
+            usize pos = tail_.load(std::memory_order_relaxed);
+            Slot *slot;
+            while (true) {
+                slot = &slots_[pos & mask_];
+                usize seq = slot->seq.load(std::memory_order_acquire);
+                auto diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos);
+                if (diff == 0) {
+                    if (tail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                        break;
+                } else if (diff < 0) {
+                    dropped_.fetch_add(1, std::memory_order_relaxed);
+                    return false; // Not popped yet a lap ago: full
+                } else {
+                    pos = tail_.load(std::memory_order_relaxed);
+                }
+            }
+            slot->value = std::move(value);
+            slot->seq.store(pos + 1, std::memory_order_release);
+            return true;
+        }
+
+        // Consumer side
+        bool try_pop(T &out) noexcept(std::is_nothrow_move_assignable_v<T>) {
+            Slot &slot = slots_[head_ & mask_];
+            if (slot.seq.load(std::memory_order_acquire) != head_ + 1)
+                return false;
+            out = std::move(slot.value);
+            slot.value = T{};
+            slot.seq.store(head_ + mask_ + 1, std::memory_order_release);
+            ++head_;
+            return true;
+        }
+
+        usize capacity() const noexcept { return mask_ + 1; }
+
+        // Consumer side: claimed positions, some possibly still being written
+        usize size() const noexcept {
+            usize tail = tail_.load(std::memory_order_acquire);
+            return tail > head_ ? tail - head_ : 0;
+        }
+        bool empty() const noexcept { return size() == 0; }
+
+        u64 dropped() const noexcept { return dropped_.load(std::memory_order_relaxed); }
+    };
+
+} // namespace agrobus::net
@@ -0,0 +1,209 @@
+#pragma once
+
+#include <agrobus/net/data_span.hpp>
+#include <agrobus/net/error.hpp>
+#include <agrobus/net/frame.hpp>
+#include <agrobus/net/pgn_defs.hpp>
+#include <agrobus/net/types.hpp>
+#include <datapod/datapod.hpp>
+
+namespace agrobus::net {
+
+    // ─── J1939-22 multi-PG (CAN FD) ──────────────────────────────────────────────
+    // Several contained parameter groups (C-PGs) share one FD frame sent with
+    // PGN_MULTI_PG. Each C-PG starts with a 4-byte header:
+    //   bytes 0-2 (little-endian): C-PGN (bits 0-17), trailer format (18-20),
+    //                              type of service (21-23)
+    //   byte 3:                    payload length
+    // A header with type of service 0 ends the list; the rest of the frame is
+    // zero padding. The frame's destination applies to PDU1 C-PGs.
+    inline constexpr usize MULTI_PG_HEADER_SIZE = 4;
+    inline constexpr usize MULTI_PG_MAX_PAYLOAD = CAN_FD_DATA_LENGTH - MULTI_PG_HEADER_SIZE;
+    inline constexpr u8 MULTI_PG_TOS_END = 0;
+    inline constexpr u8 MULTI_PG_TOS_STANDARD = 2; // No assurance data
+    inline constexpr u8 MULTI_PG_TF_NONE = 0;      // No trailer
+
+    struct ContainedPG {
+        PGN pgn = 0;
+        u8 service = MULTI_PG_TOS_STANDARD;
+        u8 trailer = MULTI_PG_TF_NONE;
+        DataSpan data;
+    };
+
+    namespace multi_pg {
+
+        // Write one C-PG at `out`; `out` must have MULTI_PG_HEADER_SIZE + len bytes
+        inline void encode(u8 *out, PGN pgn, const u8 *data, usize len, u8 service = MULTI_PG_TOS_STANDARD,
+                           u8 trailer = MULTI_PG_TF_NONE) noexcept {
+            u32 header = (pgn & 0x3FFFF) | (static_cast<u32>(trailer & 0x07) << 18) |
+                         (static_cast<u32>(service & 0x07) << 21);
+            out[0] = static_cast<u8>(header);
+            out[1] = static_cast<u8>(header >> 8);
+            out[2] = static_cast<u8>(header >> 16);
+            out[3] = static_cast<u8>(len);
+            for (usize i = 0; i < len; ++i)
+                out[MULTI_PG_HEADER_SIZE + i] = data[i];
+        }
+
+        // Call fn(const ContainedPG &) for every C-PG of a multi-PG payload.
+        // Returns false if a C-PG runs past the end (those before it were seen).
+        template <typename Fn> bool decode(const u8 *data, usize len, Fn &&fn) {
+            usize pos = 0;
+            while (pos + MULTI_PG_HEADER_SIZE <= len) {
+                u32 header = static_cast<u32>(data[pos]) | (static_cast<u32>(data[pos + 1]) << 8) |
+                             (static_cast<u32>(data[pos + 2]) << 16);
+                ContainedPG pg;
+                pg.service = static_cast<u8>((header >> 21) & 0x07);
+                if (pg.service == MULTI_PG_TOS_END)
+                    return true;
+                pg.pgn = header & 0x3FFFF;
+                pg.trailer = static_cast<u8>((header >> 18) & 0x07);
+                usize size = data[pos + 3];
+                pos += MULTI_PG_HEADER_SIZE;
+                if (pos + size > len)
+                    return false;
+                pg.data = DataSpan(data + pos, size);
+                fn(pg);
+                pos += size;
+            }
+            return true;
+        }
+
+    } // namespace multi_pg
+
+    // ─── Multi-PG packer ─────────────────────────────────────────────────────────
+    // Holds small PGs of one source for up to their own max delay and packs
+    // those going to the same destination on the same port into shared FD
+    // frames. A frame leaves when its earliest PG is due; PGs due later ride
+    // along while there is room, taken in deadline order, so a 100 ms periodic
+    // set collapses into a few frames per period instead of one each.
+    class MultiPgPacker {
+      public:
+        struct Packed {
+            u8 port = 0;
+            FdFrame frame;
+        };
+
+      private:
+        struct Pending {
+            PGN pgn = 0;
+            Priority priority = Priority::Default;
+            u64 due_ms = 0;
+            u8 length = 0;
+            dp::Array<u8, MULTI_PG_MAX_PAYLOAD> data = {};
+        };
+        struct Group {
+            u8 port = 0;
+            Address source = NULL_ADDRESS;
+            Address destination = BROADCAST_ADDRESS;
+            dp::Vector<Pending> pending; // Kept in deadline order
+        };
+
+        dp::Vector<Group> groups_;
+        u64 frames_ = 0;
+        u64 pgs_ = 0;
+
+      public:
+        // Queue a PG that must leave by now_ms + max_delay_ms. A PG already
+        // queued for the same group is replaced (the newer value wins).
+        Result<void> submit(u8 port, Address source, Address destination, PGN pgn, DataSpan data,
+                            Priority priority, u64 now_ms, u32 max_delay_ms) {
+            if (data.size() > MULTI_PG_MAX_PAYLOAD)
+                return Result<void>::err(Error::invalid_state("PG too long for multi-PG"));
+            Group &g = group(port, source, destination);
+            for (usize i = 0; i < g.pending.size(); ++i) {
+                if (g.pending[i].pgn == pgn) {
+                    g.pending.erase(g.pending.begin() + static_cast<std::ptrdiff_t>(i));
+                    break;
+                }
+            }
+            Pending p;
+            p.pgn = pgn;
+            p.priority = priority;
+            p.due_ms = now_ms + max_delay_ms;
+            p.length = static_cast<u8>(data.size());
+            for (usize i = 0; i < data.size(); ++i)
+                p.data[i] = data[i];
+            usize at = g.pending.size();
+            while (at > 0 && g.pending[at - 1].due_ms > p.due_ms)
+                --at;
+            g.pending.insert(g.pending.begin() + static_cast<std::ptrdiff_t>(at), p);
+            return {};
+        }
+
+        // Append a frame for every group whose earliest PG is due at now_ms
+        void collect(u64 now_ms, dp::Vector<Packed> &out) {
+            for (auto &g : groups_) {
+                while (!g.pending.empty() && g.pending.front().due_ms <= now_ms)
+                    out.push_back(pack(g));
+            }
+        }
+
+        // Everything queued, due or not
+        void flush(dp::Vector<Packed> &out) {
+            for (auto &g : groups_) {
+                while (!g.pending.empty())
+                    out.push_back(pack(g));
+            }
+        }
+
+        // Earliest due time over all groups, u64 max when nothing is queued
+        u64 next_due_ms() const noexcept {
+            u64 next = ~static_cast<u64>(0);
+            for (const auto &g : groups_) {
+                if (!g.pending.empty() && g.pending.front().due_ms < next)
+                    next = g.pending.front().due_ms;
+            }
+            return next;
+        }
+
+        usize pending() const noexcept {
+            usize n = 0;
+            for (const auto &g : groups_)
+                n += g.pending.size();
+            return n;
+        }
+
+        u64 frames_sent() const noexcept { return frames_; }
+        u64 pgs_sent() const noexcept { return pgs_; }
+
+      private:
+        Group &group(u8 port, Address source, Address destination) {
+            for (auto &g : groups_) {
+                if (g.port == port && g.source == source && g.destination == destination)
+                    return g;
+            }
+            groups_.push_back(Group{port, source, destination, {}});
+            return groups_.back();
+        }
+
+        // One frame from the front of the deadline order, first fit after that
+        Packed pack(Group &g) {
+            Packed p;
+            p.port = g.port;
+            usize used = 0;
+            u8 best = static_cast<u8>(Priority::Lowest);
+            for (usize i = 0; i < g.pending.size();) {
+                const Pending &pg = g.pending[i];
+                usize size = MULTI_PG_HEADER_SIZE + pg.length;
+                if (used + size > CAN_FD_DATA_LENGTH) {
+                    ++i;
+                    continue;
+                }
+                multi_pg::encode(p.frame.data.data() + used, pg.pgn, pg.data.data(), pg.length);
+                used += size;
+                if (static_cast<u8>(pg.priority) < best)
+                    best = static_cast<u8>(pg.priority);
+                ++pgs_;
+                g.pending.erase(g.pending.begin() + static_cast<std::ptrdiff_t>(i));
+            }
+            p.frame.length = can_fd_padded_length(used);
+            for (usize i = used; i < p.frame.length; ++i)
+                p.frame.data[i] = 0x00; // An all-zero header ends the list
+            p.frame.id = Identifier::encode(static_cast<Priority>(best), PGN_MULTI_PG, g.source, g.destination);
+            ++frames_;
+            return p;
+        }
+    };
+
+} // namespace agrobus::net
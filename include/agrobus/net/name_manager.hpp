@@ -55,7 +55,7 @@ namespace agrobus::net {
             return data;
         }
 
-        static NameManagementMsg decode(const dp::Vector<u8> &data) {
+        static NameManagementMsg decode(DataSpan data) {
             NameManagementMsg msg;
             if (data.size() >= 9) {
                 msg.mode = static_cast<NameMgmtMode>(data[0]);
@@ -100,6 +100,9 @@ namespace agrobus::net {
             if (name.identity_number() != cf_->name().identity_number()) {
                 return Result<void>::err(Error::invalid_state("identity_number must not change"));
             }
+            if (conflicts(name)) {
+                return Result<void>::err(Error::invalid_state("NAME already claimed on the bus"));
+            }
             pending_name_ = name;
             has_pending_ = true;
             echo::category("isobus.network.name_mgr").debug("pending NAME set");
@@ -149,7 +152,7 @@ namespace agrobus::net {
                 if (result.is_ok()) {
                     send_ack(msg.source);
                 } else {
-                    send_nack(msg.source, NameNackReason::InvalidItems);
+                    send_nack(msg.source, conflicts(name) ? NameNackReason::Conflict : NameNackReason::InvalidItems);
                 }
                 break;
             }
@@ -189,6 +192,11 @@ namespace agrobus::net {
         Event<Address> on_commanded_address; // Emitted when address change is commanded
 
       private:
+        // Another CF on the bus already uses this NAME (per the IsoNet NAME table)
+        bool conflicts(Name name) const noexcept {
+            return name != cf_->name() && net_.names().address_of(cf_->port(), name).has_value();
+        }
+
         void handle_commanded_address(const Message &msg) {
             // Commanded Address message: 9 bytes (8 NAME + 1 new address)
             if (msg.data.size() < 9)
@@ -0,0 +1,122 @@
+#pragma once
+
+#include "constants.hpp"
+#include "name.hpp"
+#include "types.hpp"
+#include <datapod/datapod.hpp>
+
+namespace agrobus::net {
+
+    // ─── Bus-wide NAME table (ISO 11783-5 address map) ───────────────────────────
+    // Who claimed which address, per port, as seen in address claims (ours
+    // included). Both directions are O(1): address → NAME through a 256-entry
+    // array, NAME → address through a hash. A claim that takes an address from
+    // another NAME evicts that NAME; a cannot-claim (source 0xFE) removes it.
+    //
+    // IsoNet fills it from each received batch of claims before running the
+    // contests, so a CF that has to move picks an address that is free with
+    // respect to the whole burst.
+    class NameTable {
+      public:
+        struct Entry {
+            Name name;
+            Address address = NULL_ADDRESS;
+            u64 timestamp_us = 0; // When the claim was received
+        };
+
+      private:
+        struct Port {
+            dp::Array<Entry, 256> by_address{};
+            dp::Array<bool, 256> used{};
+            dp::Map<u64, Address> by_name;
+        };
+
+        dp::Map<u8, Port> ports_;
+
+      public:
+        // Record `name` at `addr`; returns the NAME it displaced, if any
+        dp::Optional<Name> claim(u8 port, Name name, Address addr, u64 timestamp_us = 0) {
+            if (addr > MAX_ADDRESS) {
+                release(port, name);
+                return dp::nullopt;
+            }
+            Port &p = ports_[port];
+            auto it = p.by_name.find(name.raw);
+            if (it != p.by_name.end() && it->second != addr)
+                p.used[it->second] = false;
+
+            dp::Optional<Name> displaced;
+            if (p.used[addr] && p.by_address[addr].name != name) {
+                displaced = p.by_address[addr].name;
+                p.by_name.erase(displaced->raw);
+            }
+            p.by_address[addr] = Entry{name, addr, timestamp_us};
+            p.used[addr] = true;
+            p.by_name[name.raw] = addr;
+            return displaced;
+        }
+
+        // Forget a NAME (cannot claim, or our CF was removed)
+        bool release(u8 port, Name name) {
+            auto pit = ports_.find(port);
+            if (pit == ports_.end())
+                return false;
+            auto it = pit->second.by_name.find(name.raw);
+            if (it == pit->second.by_name.end())
+                return false;
+            pit->second.used[it->second] = false;
+            pit->second.by_name.erase(it);
+            return true;
+        }
+
+        void clear(u8 port) { ports_.erase(port); }
+
+        // ─── Lookups ─────────────────────────────────────────────────────────────
+        const Entry *at(u8 port, Address addr) const noexcept {
+            auto it = ports_.find(port);
+            if (it == ports_.end() || !it->second.used[addr])
+                return nullptr;
+            return &it->second.by_address[addr];
+        }
+
+        dp::Optional<Name> name_at(u8 port, Address addr) const noexcept {
+            const Entry *e = at(port, addr);
+            if (!e)
+                return dp::nullopt;
+            return e->name;
+        }
+
+        dp::Optional<Address> address_of(u8 port, Name name) const noexcept {
+            auto it = ports_.find(port);
+            if (it == ports_.end())
+                return dp::nullopt;
+            auto n = it->second.by_name.find(name.raw);
+            if (n == it->second.by_name.end())
+                return dp::nullopt;
+            return n->second;
+        }
+
+        // True if a NAME other than `self` holds `addr`
+        bool taken(u8 port, Address addr, Name self) const noexcept {
+            const Entry *e = at(port, addr);
+            return e && e->name != self;
+        }
+
+        usize size(u8 port) const noexcept {
+            auto it = ports_.find(port);
+            return it != ports_.end() ? it->second.by_name.size() : 0;
+        }
+
+        // Visit the claimed addresses of a port in address order
+        template <typename F> void for_each(u8 port, F &&fn) const {
+            auto it = ports_.find(port);
+            if (it == ports_.end())
+                return;
+            for (usize a = 0; a <= MAX_ADDRESS; ++a) {
+                if (it->second.used[a])
+                    fn(it->second.by_address[a]);
+            }
+        }
+    };
+
+} // namespace agrobus::net
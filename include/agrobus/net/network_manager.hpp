@@ -2,21 +2,60 @@
 
 #include "address_claimer.hpp"
 #include "bus_load.hpp"
+#include "can_bus_config.hpp"
+#include "can_errors.hpp"
+#include "can_filter.hpp"
+#include "cf_directory.hpp"
+#include "claim_cache.hpp"
 #include "control_function.hpp"
 #include "internal_cf.hpp"
 #include "partner_cf.hpp"
+#include <agrobus/net/clock.hpp>
+#include <agrobus/net/coro.hpp>
 #include <agrobus/net/error.hpp>
 #include <agrobus/net/etp.hpp>
 #include <agrobus/net/event.hpp>
 #include <agrobus/net/fast_packet.hpp>
+#include <agrobus/net/flight_recorder.hpp>
 #include <agrobus/net/frame.hpp>
+#include <agrobus/net/latency.hpp>
+#include <agrobus/net/last_value.hpp>
+#include <agrobus/net/memory_budget.hpp>
 #include <agrobus/net/message.hpp>
+#include <agrobus/net/mpsc_queue.hpp>
+#include <agrobus/net/multi_pg.hpp>
+#include <agrobus/net/name_table.hpp>
+#include <agrobus/net/pgn_dispatch.hpp>
+#include <agrobus/net/shared_message.hpp>
+#include <agrobus/net/slab.hpp>
+#include <agrobus/net/spsc_ring.hpp>
+#include <agrobus/net/static_alloc.hpp>
+#include <agrobus/net/timer_wheel.hpp>
 #include <agrobus/net/tp.hpp>
+#include <agrobus/net/trace.hpp>
+#include <agrobus/net/traffic_profile.hpp>
+#include <agrobus/net/tx_queue.hpp>
+#include <agrobus/net/update_profiler.hpp>
+#include <agrobus/net/work_pool.hpp>
 #include <datapod/datapod.hpp>
 #include <echo/echo.hpp>
 #include <wirebit/can/can_endpoint.hpp>
 #include <wirebit/can/socketcan_link.hpp>
 
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstring>
+#include <future>
+#include <memory>
+#include <thread>
+#include <type_traits>
+
+#include <linux/can.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
 namespace agrobus::net {
 
     // ─── Network configuration ──────────────────────────────────────────────────
@@ -25,6 +64,32 @@ namespace agrobus::net {
         u32 address_claim_timeout_ms = ADDRESS_CLAIM_TIMEOUT_MS;
         bool enable_bus_load = true;
         bool enable_fast_packet = false; // Enable NMEA2000 fast packet for known PGNs
+        u16 rx_batch_size = 32;          // Frames pulled from an endpoint before processing them as a batch
+        f32 tx_max_load_percent = 0.0f;  // Per-port TX token bucket (share of bitrate), 0 = unlimited
+        Priority tx_urgent_priority = Priority::Normal; // Frames at or above this priority bypass the bucket
+        u32 tx_queue_frames = 1024;      // Frames a port may hold (scheduler or busy driver), 0 = unbounded
+        u32 tx_backpressure_frames = 64; // TP/ETP pause a port with this many frames pending, 0 = never
+        bool rx_thread = false;        // One reader thread per endpoint, update() only drains its ring
+        u32 rx_ring_frames = 1024;     // Ring capacity per endpoint in threaded mode
+        u32 rx_thread_idle_us = 200;   // Reader back-off when the endpoint has nothing to read
+        CtsWindowConfig cts_window;    // TP/ETP receive window policy (fixed 16 packets unless adaptive)
+        u32 work_threads = 0;          // WorkPool threads for offload(), 0 = offloaded work runs inline
+        u32 bitrate = ISO_CAN_BITRATE; // Bus load and TX token bucket reference
+        // What a frame costs in bus load and TX tokens
+        BitModel bit_model = BitModel::Average;
+        u32 profile_streams = 0; // TrafficProfiler stream slots, 0 = profiler off
+        bool enable_latency = false; // LatencyMonitor histograms (receive, handler, send)
+        u32 latency_budget_us = 0;   // Samples above this are counted and reported, 0 = no budget
+        MemoryBudget *transport_memory = nullptr; // TP/ETP session buffers are charged here, nullptr = unlimited
+        TransportLimitsConfig transport_limits;   // TP/BAM/ETP receive sessions per source and overall
+        bool local_delivery = false; // Messages between our own CFs skip the bus
+        bool local_mirror = false;   // ...and single frames among them still go out for bus monitors
+        u32 bus_off_hold_ms = 2000;  // TP/ETP timers stand still this long on a bus-off port
+        bool drop_foreign_transport = false; // Ignore TP/ETP addressed to CFs we do not hold
+        bool enable_flight_recorder = false; // Last frames of every port in memory, frozen on faults
+        u32 submit_slots = 0;                // Sends queued from other threads (submit()), 0 = off
+        u32 submit_timeout_ms = 60000;       // A submit_async() transfer fails when not done by then
+        FlightRecorderConfig flight_recorder_config;
 
         // Fluent API
         NetworkConfig &ports(u8 n) {
@@ -43,14 +108,129 @@ namespace agrobus::net {
             enable_fast_packet = enable;
             return *this;
         }
+        NetworkConfig &rx_batch(u16 frames) {
+            rx_batch_size = frames == 0 ? 1 : frames;
+            return *this;
+        }
+        NetworkConfig &tx_load_limit(f32 percent) {
+            tx_max_load_percent = percent;
+            return *this;
+        }
+        NetworkConfig &tx_urgent(Priority prio) {
+            tx_urgent_priority = prio;
+            return *this;
+        }
+        // Frames refused by the driver (ENOBUFS) stay queued and are retried;
+        // transport sessions stop producing data while pause_at frames wait
+        NetworkConfig &tx_backlog(u32 limit, u32 pause_at = 64) {
+            tx_queue_frames = limit;
+            tx_backpressure_frames = pause_at;
+            return *this;
+        }
+        NetworkConfig &threaded_rx(bool enable, u32 ring_frames = 1024) {
+            rx_thread = enable;
+            rx_ring_frames = ring_frames == 0 ? 1 : ring_frames;
+            return *this;
+        }
+        NetworkConfig &work_pool(u32 threads) {
+            work_threads = threads;
+            return *this;
+        }
+        // Bitrate of the physical bus
+        NetworkConfig &can_bus(const CanBusConfig &bus) {
+            bitrate = bus.bitrate;
+            return *this;
+        }
+        // BitModel::Exact counts each frame's real stuff bits, so bus load and
+        // the TX token bucket follow true wire time
+        NetworkConfig &wire_bits(BitModel model) {
+            bit_model = model;
+            return *this;
+        }
+        // Per (port, PGN, source) traffic counters; see traffic_profile()
+        NetworkConfig &profile(u32 streams = 1024) {
+            profile_streams = streams;
+            return *this;
+        }
+        // Receive-to-callback, handler and send latency per PGN; see latency()
+        NetworkConfig &latency(bool enable = true, u32 budget_us = 0) {
+            enable_latency = enable;
+            latency_budget_us = budget_us;
+            return *this;
+        }
+        NetworkConfig &adaptive_cts(u8 max_packets = 64) {
+            cts_window.adaptive = true;
+            cts_window.max_packets = max_packets;
+            return *this;
+        }
+        // A TP/ETP receiver that misses a DT asks again from the missing packet
+        // this many times per window before aborting the transfer
+        NetworkConfig &transport_gap_retries(u8 retries) {
+            cts_window.gap_retries = retries;
+            return *this;
+        }
+        // Sessions whose buffers would take the budget past its limit are refused
+        NetworkConfig &transport_budget(MemoryBudget *budget) {
+            transport_memory = budget;
+            return *this;
+        }
+        // A source announcing more sessions or bytes than its share is turned
+        // away at RTS/BAM time, before anything is allocated
+        NetworkConfig &transport_caps(const TransportLimitsConfig &limits) {
+            transport_limits = limits;
+            return *this;
+        }
+        // Destination-specific messages from one internal CF to another on the
+        // same port are handed over in the next update() instead of going
+        // through the bus and TP/ETP. With mirror, single-frame ones are also
+        // written to the bus so a monitor sees them.
+        NetworkConfig &local(bool enable = true, bool mirror = false) {
+            local_delivery = enable;
+            local_mirror = mirror;
+            return *this;
+        }
+        // How long transport sessions on a bus-off port wait for the controller
+        // to come back before their timeouts run again
+        NetworkConfig &bus_off_hold(u32 ms) {
+            bus_off_hold_ms = ms;
+            return *this;
+        }
+        // Destination-specific TP/ETP frames for an address with no internal CF
+        // here are dropped before the transport layer sees them. A CAN filter
+        // does this on a socket; set it where nothing filters, such as several
+        // IsoNets on one LoopbackBus. Off, they reach the transport protocols
+        // (and views) as before, which monitors and NIUs rely on.
+        NetworkConfig &foreign_transport_filter(bool enable = true) {
+            drop_foreign_transport = enable;
+            return *this;
+        }
+        // Keep the last frames of every port in a preallocated ring, frozen
+        // on a TP/ETP abort, an address violation or a DM1 lamp; see
+        // flight_recorder(). The port count follows ports().
+        NetworkConfig &flight_recorder(FlightRecorderConfig recorder = {}) {
+            enable_flight_recorder = true;
+            flight_recorder_config = std::move(recorder);
+            return *this;
+        }
+        // Lock-free queue for submit() from any thread, drained by update()
+        NetworkConfig &submit_queue(u32 slots = 1024, u32 timeout_ms = 60000) {
+            submit_slots = slots;
+            submit_timeout_ms = timeout_ms;
+            return *this;
+        }
     };
 
     // ─── IsoNet: ISOBUS network layer (requires wirebit CAN endpoint) ──────────
     class IsoNet {
         NetworkConfig config_;
-        dp::Vector<InternalCF> internal_cfs_;
-        dp::Vector<PartnerCF> partner_cfs_;
-        dp::Vector<AddressClaimer> claimers_;
+        // CFs live in slabs: their addresses never move, so claimers (and the
+        // components given an InternalCF*) keep valid pointers while CFs are
+        // added and removed at runtime. claimers_ is indexed by internal slot.
+        Slab<InternalCF> internal_cfs_;
+        Slab<PartnerCF> partner_cfs_;
+        dp::Vector<dp::Optional<AddressClaimer>> claimers_;
+        // Address / NAME index over the CFs above, for the per-frame lookups
+        CFDirectory directory_;
         dp::Map<u8, wirebit::CanEndpoint *> endpoints_;
         dp::Map<u8, BusLoad> bus_loads_;
 
@@ -58,56 +238,502 @@ namespace agrobus::net {
         dp::Optional<wirebit::SocketCanLink> default_link_;
         dp::Optional<wirebit::CanEndpoint> default_endpoint_;
 
+        // Receive session caps shared by TP and ETP (heap: the protocols keep its address)
+        std::unique_ptr<TransportLimits> transport_limits_ = std::make_unique<TransportLimits>();
+
         // Transport protocol instances
         TransportProtocol tp_;
         ExtendedTransportProtocol etp_;
         FastPacketProtocol fast_packet_;
-
-        // PGN callback registry
-        dp::Map<PGN, dp::Vector<std::function<void(const Message &)>>> pgn_callbacks_;
-
-        // Fast packet PGNs (NMEA2000 PGNs that use fast packet)
-        dp::Vector<PGN> fast_packet_pgns_;
+        // Frames produced by the tick (update) and the receive path, reused so
+        // neither allocates once they reach their working size
+        dp::Vector<Frame> tick_frames_;
+        dp::Vector<Frame> rx_frames_;
+
+        // PGN callback registry (compiled lazily into an O(1) lookup table)
+        PGNDispatchTable pgn_dispatch_;
+        PGNViewDispatchTable view_dispatch_;
+        // Compile-time router (set_static_router), consulted before the tables
+        bool (*static_dispatch_)(const MessageView &) = nullptr;
+        dp::Vector<PGN> static_pgns_;
+
+        // Reassembly buffers shared by TP and ETP; completed message buffers are
+        // returned here after dispatch
+        std::shared_ptr<BufferPool> buffer_pool_ = std::make_shared<BufferPool>();
+        // Buffers of shared payloads released on other threads, on their way back
+        std::shared_ptr<BufferReturns> buffer_returns_ = std::make_shared<BufferReturns>();
+
+        // Fast packet PGNs (NMEA2000 PGNs that use fast packet). IsoNet is the
+        // single reassembly service: interfaces register their PGNs here.
+        FastPacketRegistry fast_packet_pgns_;
+
+        // Shared deadlines of the protocol objects built on this network
+        // (heartbeat, periodic tasks); advanced once per update()
+        TimerWheel timers_;
+
+        // Latest value of each tracked single-frame PGN per sender; on the heap
+        // so readers on other threads keep a stable address when IsoNet moves
+        std::unique_ptr<LastValueCache> last_values_ = std::make_unique<LastValueCache>();
+
+        // Coroutine flows suspended on a message, a transfer or a deadline
+        std::unique_ptr<AwaitTable> awaits_ = std::make_unique<AwaitTable>();
+
+        // Bus-wide address map; claimers consult it when they have to move
+        std::unique_ptr<NameTable> names_ = std::make_unique<NameTable>();
+
+        // Address claims of the RX batch being processed (see process_claims)
+        struct PendingClaim {
+            Frame frame;
+            u8 port = 0;
+        };
+        dp::Vector<PendingClaim> pending_claims_;
+        dp::Vector<PendingClaim> claim_batch_;
+
+        // Receives a ClaimCache whenever an internal CF completes a claim
+        ClaimStore claim_store_;
+
+        // Reusable receive batch (sized once from config, never reallocated)
+        dp::Vector<Frame> rx_batch_;
+
+        // Per-port transmit scheduling: frames produced during update() are coalesced
+        // into priority lanes and written out by a single flush at the end, subject
+        // to the port's token bucket and the per-PGN rate limits. A CAN FD port
+        // queues everything in fd_queue, so FD and classic frames keep one order.
+        struct TxPort {
+            TxQueue queue;
+            FdTxQueue fd_queue;
+            TxTokenBucket bucket;
+
+            void push(const Frame &frame, bool fd_port) {
+                if (fd_port)
+                    fd_queue.push(FdFrame::from_frame(frame));
+                else
+                    queue.push(frame);
+            }
+            usize size() const noexcept { return queue.size() + fd_queue.size(); }
+            bool empty() const noexcept { return queue.empty() && fd_queue.empty(); }
+            void clear() noexcept {
+                queue.clear();
+                fd_queue.clear();
+            }
+        };
+        dp::Map<u8, TxPort> tx_ports_;
+        TxRateLimiter tx_rate_limiter_;
+        bool in_update_ = false;
+        u32 tx_dropped_ = 0;
+        u32 tx_retries_ = 0;
+
+        // CAN error frames counted per port, and the ports now bus-off with how
+        // long their transport sessions have been held
+        dp::Map<u8, CanErrorStats> can_errors_;
+        struct BusOffPort {
+            u8 port = 0;
+            u32 held_ms = 0;
+        };
+        dp::Vector<BusOffPort> bus_off_ports_;
+
+        // RX timestamp source (µs); empty = monotonic host clock at drain time
+        std::function<u64()> rx_clock_;
+
+        // eventfd shared by all reader threads (owned; moves with IsoNet). Declared
+        // before the workers so it outlives them.
+        struct WakeFd {
+            int fd = -1;
+            WakeFd() = default;
+            WakeFd(const WakeFd &) = delete;
+            WakeFd &operator=(const WakeFd &) = delete;
+            WakeFd(WakeFd &&o) noexcept : fd(o.fd) { o.fd = -1; }
+            WakeFd &operator=(WakeFd &&o) noexcept {
+                if (this != &o) {
+                    reset();
+                    fd = o.fd;
+                    o.fd = -1;
+                }
+                return *this;
+            }
+            ~WakeFd() { reset(); }
+            void reset() noexcept {
+                if (fd >= 0)
+                    ::close(fd);
+                fd = -1;
+            }
+        };
+        WakeFd wake_fd_;
+        // Time up to which wait() has handed out elapsed ms (unset before the first wait)
+        dp::Optional<std::chrono::steady_clock::time_point> wait_accounted_;
+
+        // Threaded RX: a reader thread per endpoint decodes and timestamps frames
+        // into an SPSC ring; poll() drains the ring instead of the endpoint. The
+        // endpoint must allow recv from the reader while update() sends (SocketCAN does).
+        // Workers are self-contained (the thread never touches IsoNet) and join on
+        // destruction, so IsoNet stays movable.
+        struct RxWorker {
+            wirebit::CanEndpoint *ep;
+            SpscRing<Frame> ring;
+            std::function<u64()> clock;
+            u32 idle_us;
+            int notify_fd; // Signalled after every burst of frames pushed into the ring
+            std::atomic<bool> running{true};
+            std::thread thread;
+
+            RxWorker(wirebit::CanEndpoint *endpoint, usize capacity, std::function<u64()> clk, u32 idle, int fd)
+                : ep(endpoint), ring(capacity), clock(std::move(clk)), idle_us(idle), notify_fd(fd) {}
+
+            ~RxWorker() { stop(); }
+
+            void stop() {
+                running.store(false, std::memory_order_release);
+                if (thread.joinable())
+                    thread.join();
+            }
+        };
+        dp::Map<u8, std::unique_ptr<RxWorker>> rx_workers_;
+
+        // Ports read from an RxSource instead of their endpoint (set_rx_source)
+        dp::Map<u8, std::function<bool(can_frame &)>> rx_sources_;
+
+        // CAN FD ports (set_fd_port): written and read as canfd_frame
+        struct FdPort {
+            std::function<bool(const canfd_frame &)> tx;
+            std::function<bool(canfd_frame &)> rx;
+            u32 data_bitrate = 0;
+        };
+        dp::Map<u8, FdPort> fd_ports_;
+        MultiPgPacker packer_; // send_packed() PGs waiting to share an FD frame
+        // Messages between internal CFs (NetworkConfig::local), delivered in update()
+        struct LocalMessage {
+            Message msg;
+            u8 port = 0;
+        };
+        dp::Vector<LocalMessage> local_queue_;
+        dp::Vector<LocalMessage> local_batch_;
+        dp::Vector<MultiPgPacker::Packed> packed_frames_;
+
+        // Traffic profiler (NetworkConfig::profile), null when off
+        std::unique_ptr<TrafficProfiler> profiler_;
+        // Bus flight recorder (NetworkConfig::flight_recorder), null when off
+        std::unique_ptr<FlightRecorder> recorder_;
+
+        // Latency instrumentation (NetworkConfig::latency), null when off. A
+        // send() remembers its last frame (or its TP/ETP session) with the time
+        // it was called; the sample is taken when the endpoint accepts that
+        // frame or the session completes.
+        std::unique_ptr<LatencyMonitor> latency_;
+        // Update time profiler (set_update_profiler), null when off, and its slots
+        UpdateProfiler *update_profiler_ = nullptr;
+        u16 profile_update_ = UpdateProfiler::NO_SLOT;
+        u16 profile_dispatch_ = UpdateProfiler::NO_SLOT;
+        u16 profile_timers_ = UpdateProfiler::NO_SLOT;
+        // Pending send() marks in a fixed ring, oldest first. A mark closed out
+        // of order stays as a dead slot until the marks before it are gone.
+        struct TxMark {
+            u8 port = 0;
+            bool live = false;
+            u32 id = 0;
+            dp::Array<u8, 8> data{};
+            u64 start_ns = 0;
+        };
+        static constexpr usize MAX_TX_MARKS = 256; // Frames that never went out are forgotten beyond this
+        dp::Array<TxMark, MAX_TX_MARKS> tx_marks_{};
+        usize tx_mark_head_ = 0;  // Oldest slot
+        usize tx_mark_count_ = 0; // Slots in use from the head, dead ones included
+        dp::Map<u64, u64> tx_session_marks_; // (pgn, source, destination) -> start
+
+        // Worker threads for offload(); signals wake_fd_ for every finished job
+        std::unique_ptr<WorkPool> work_pool_;
+
+        // Sends from other threads (NetworkConfig::submit_queue), null when off.
+        // The payload is moved in by the producer and handed to send() as is.
+        struct SubmittedSend {
+            PGN pgn = 0;
+            dp::Vector<u8> data;
+            InternalCF *source = nullptr;
+            Address destination = BROADCAST_ADDRESS;
+            Priority priority = Priority::Default;
+            std::unique_ptr<std::promise<Result<void>>> done; // submit_async() only
+        };
+        std::unique_ptr<MpscQueue<SubmittedSend>> submits_;
+        // Transfers submit_async() flows are waiting on; ~IsoNet fails them
+        dp::Vector<TransferAwait *> submit_waits_;
+
+        // Kernel filter tracking: the last set reported per port, plus the inputs
+        // that are not covered by a registration call (claimed addresses and
+        // catch-all on_message listeners)
+        dp::Map<u8, dp::Vector<can_filter>> can_filters_reported_;
+        dp::Vector<Address> filter_addresses_;
+        bool filter_catch_all_ = false;
+        bool can_filters_dirty_ = true;
 
       public:
         explicit IsoNet(NetworkConfig config = {}) : config_(config) {
+            if (config_.rx_batch_size == 0)
+                config_.rx_batch_size = 1;
+            rx_batch_.resize(config_.rx_batch_size);
+
+            if (config_.work_threads > 0) {
+                wake_fd_.fd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+                work_pool_ = std::make_unique<WorkPool>(config_.work_threads, wake_fd_.fd);
+            }
+            if (config_.submit_slots > 0) {
+                if (wake_fd_.fd < 0)
+                    wake_fd_.fd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+                submits_ = std::make_unique<MpscQueue<SubmittedSend>>(config_.submit_slots);
+            }
+
             for (u8 i = 0; i < config_.num_ports; ++i) {
                 if (config_.enable_bus_load) {
-                    bus_loads_[i] = BusLoad{};
+                    port_load(i);
                 }
             }
 
+            if (config_.profile_streams > 0)
+                profiler_ = std::make_unique<TrafficProfiler>(config_.profile_streams, config_.num_ports,
+                                                              config_.bitrate, config_.bit_model);
+            if (config_.enable_latency)
+                latency_ = std::make_unique<LatencyMonitor>(static_cast<u64>(config_.latency_budget_us) * 1000);
+            if (config_.enable_flight_recorder)
+                recorder_ = std::make_unique<FlightRecorder>(
+                    FlightRecorderConfig(config_.flight_recorder_config).ports(config_.num_ports));
+
+            if constexpr (static_alloc::enabled) {
+                // Every TP session's buffer up front; CFs and claimers at capacity
+                buffer_pool_ = std::make_shared<BufferPool>(static_alloc::transport_sessions, 1);
+                buffer_pool_->reserve(BufferPool::class_for(TP_MAX_DATA_LENGTH), static_alloc::transport_sessions);
+                claimers_.reserve(static_alloc::internal_cfs);
+            }
+
+            tp_.set_buffer_pool(buffer_pool_);
+            etp_.set_buffer_pool(buffer_pool_);
+            tp_.set_memory_budget(config_.transport_memory);
+            etp_.set_memory_budget(config_.transport_memory);
+            transport_limits_->configure(config_.transport_limits);
+            tp_.set_limits(transport_limits_.get());
+            etp_.set_limits(transport_limits_.get());
+            tp_.set_cts_window(config_.cts_window);
+            etp_.set_cts_window(config_.cts_window);
+
             // Subscribe to transport completion events
             tp_.on_complete.subscribe([this](TransportSession &session) { handle_transport_complete(session); });
             etp_.on_complete.subscribe([this](TransportSession &session) { handle_transport_complete(session); });
+            tp_.on_abort.subscribe([this](TransportSession &session, TransportAbortReason) {
+                awaits_->transfer_done(session, Error::transport_aborted("TP transfer aborted"));
+                if (latency_)
+                    tx_session_marks_.erase(session_key(session));
+                if (recorder_)
+                    recorder_->freeze(FlightTrigger::TransportAbort, remote_of(session));
+            });
+            etp_.on_abort.subscribe([this](TransportSession &session, TransportAbortReason) {
+                awaits_->transfer_done(session, Error::transport_aborted("ETP transfer aborted"));
+                if (latency_)
+                    tx_session_marks_.erase(session_key(session));
+                if (recorder_)
+                    recorder_->freeze(FlightTrigger::TransportAbort, remote_of(session));
+            });
+        }
+
+        // submit_async() transfers still running end with an error, so their
+        // futures become ready and their flows free themselves
+        ~IsoNet() {
+            while (!submit_waits_.empty())
+                submit_waits_.back()->fail(Error(ErrorCode::NotConnected, "network shut down"));
         }
 
+        IsoNet(IsoNet &&) = default;
+        IsoNet &operator=(IsoNet &&) = default;
+
         // ─── Device management ───────────────────────────────────────────────────
         Result<InternalCF *> create_internal(Name name, u8 port, Address preferred = NULL_ADDRESS) {
-            internal_cfs_.emplace_back(name, port, preferred);
-            auto *cf = &internal_cfs_.back();
-            claimers_.emplace_back(cf, config_.address_claim_timeout_ms);
+            if (static_alloc::full(internal_cfs_.size(), static_alloc::internal_cfs))
+                return Result<InternalCF *>::err(static_alloc::exhausted("internal CFs full"));
+            SlabHandle h = internal_cfs_.emplace(name, port, preferred);
+            u32 index = Slab<InternalCF>::index_of(h);
+            auto *cf = internal_cfs_.get(h);
+            if (claimers_.size() <= index)
+                claimers_.resize(index + 1);
+            claimers_[index].emplace(cf, config_.address_claim_timeout_ms);
+            claimers_[index]->set_address_map(names_.get());
+            sync_directory(index);
+            can_filters_dirty_ = true;
             echo::category("isobus.network").info("Internal CF created on port ", port);
             return Result<InternalCF *>::ok(cf);
         }
 
         Result<PartnerCF *> create_partner(u8 port, dp::Vector<NameFilter> filters) {
-            partner_cfs_.emplace_back(port, std::move(filters));
-            auto *cf = &partner_cfs_.back();
+            if (static_alloc::full(partner_cfs_.size(), static_alloc::partner_cfs))
+                return Result<PartnerCF *>::err(static_alloc::exhausted("partner CFs full"));
+            SlabHandle h = partner_cfs_.emplace(port, std::move(filters));
+            auto *cf = partner_cfs_.get(h);
+            directory_.add_partner(static_cast<u16>(Slab<PartnerCF>::index_of(h)), port, cf->matcher());
             echo::category("isobus.network").info("Partner CF created on port ", port);
             return Result<PartnerCF *>::ok(cf);
         }
 
+        // Take a CF off the network at runtime (e.g. an implement unplugged from
+        // a gateway). It stops claiming and answering; pointers to it dangle
+        // afterwards, handles resolve to nullptr. Other CFs are not touched.
+        Result<void> remove_internal(InternalCF *cf) {
+            SlabHandle h = internal_cfs_.handle_of(cf);
+            if (h == INVALID_HANDLE)
+                return Result<void>::err(Error::invalid_state("not an internal CF of this network"));
+            u32 index = Slab<InternalCF>::index_of(h);
+            cf->set_state(CFState::Offline);
+            on_cf_state_change.emit(&cf->cf(), CFState::Offline);
+            directory_.remove_internal(static_cast<u16>(index));
+            claimers_[index].reset();
+            names_->release(cf->port(), cf->name());
+            internal_cfs_.erase(h);
+            can_filters_dirty_ = true;
+            echo::category("isobus.network").info("Internal CF removed from slot ", index);
+            return {};
+        }
+
+        Result<void> remove_partner(PartnerCF *cf) {
+            SlabHandle h = partner_cfs_.handle_of(cf);
+            if (h == INVALID_HANDLE)
+                return Result<void>::err(Error::invalid_state("not a partner CF of this network"));
+            directory_.remove_partner(static_cast<u16>(Slab<PartnerCF>::index_of(h)));
+            partner_cfs_.erase(h);
+            echo::category("isobus.network").info("Partner CF removed");
+            return {};
+        }
+
+        // Generation-checked handles: resolve to nullptr once the CF was removed,
+        // even if a new CF took its slot
+        SlabHandle handle(const InternalCF *cf) const noexcept { return internal_cfs_.handle_of(cf); }
+        SlabHandle handle(const PartnerCF *cf) const noexcept { return partner_cfs_.handle_of(cf); }
+        InternalCF *internal(SlabHandle h) noexcept { return internal_cfs_.get(h); }
+        PartnerCF *partner(SlabHandle h) noexcept { return partner_cfs_.get(h); }
+
         // ─── Endpoint registration ────────────────────────────────────────────────
         Result<void> set_endpoint(u8 port, wirebit::CanEndpoint *ep) {
             if (!ep) {
                 return Result<void>::err(Error::invalid_state("null endpoint"));
             }
+            stop_rx_worker(port);
             endpoints_[port] = ep;
+            if (rx_sources_.find(port) == rx_sources_.end())
+                start_rx_worker(port, ep);
+            can_filters_dirty_ = true;
             echo::category("isobus.network").debug("endpoint set on port ", port);
             return {};
         }
 
+        // Receive a port's frames from `source` instead of its endpoint, which
+        // keeps sending. For adapters that already hold decoded can_frames
+        // (EthCan::rx_source()): skips the wirebit::Frame round trip through
+        // CanEndpoint. An empty source goes back to the endpoint.
+        using RxSource = std::function<bool(can_frame &)>;
+        void set_rx_source(u8 port, RxSource source) {
+            stop_rx_worker(port);
+            if (source) {
+                rx_sources_[port] = std::move(source);
+                return;
+            }
+            rx_sources_.erase(port);
+            auto it = endpoints_.find(port);
+            if (it != endpoints_.end() && it->second)
+                start_rx_worker(port, it->second);
+        }
+
+        // ─── CAN FD ports ─────────────────────────────────────────────────────────
+        // A port whose traffic goes through `tx`/`rx` as canfd_frame (see
+        // SocketCanFd). Messages of up to 64 bytes leave as one FD frame instead
+        // of a TP session; longer ones still use TP/ETP. Classic frames go out
+        // through `tx` too unless the port also has an endpoint. `data_bitrate`
+        // is the data phase rate used for bus load.
+        using FdTxSink = std::function<bool(const canfd_frame &)>;
+        using FdRxSource = std::function<bool(canfd_frame &)>;
+        Result<void> set_fd_port(u8 port, FdTxSink tx, FdRxSource rx = {}, u32 data_bitrate = 2000000) {
+            if (!tx) {
+                return Result<void>::err(Error::invalid_state("null FD sink"));
+            }
+            fd_ports_[port] = FdPort{std::move(tx), std::move(rx), data_bitrate};
+            port_load(port).set_data_bitrate(data_bitrate);
+            auto it = tx_ports_.find(port);
+            if (it != tx_ports_.end() && !it->second.queue.empty()) {
+                TxPort &p = it->second;
+                p.queue.flush([&](const Frame &f) {
+                    p.fd_queue.push(FdFrame::from_frame(f));
+                    return true;
+                });
+            }
+            echo::category("isobus.network").debug("CAN FD set on port ", port, ", data bitrate ", data_bitrate);
+            return {};
+        }
+
+        // Queued classic frames move back to the endpoint's queue; queued FD
+        // frames have no way out any more and count as dropped
+        void clear_fd_port(u8 port) {
+            fd_ports_.erase(port);
+            port_load(port).set_data_bitrate(0);
+            auto it = tx_ports_.find(port);
+            if (it != tx_ports_.end() && !it->second.fd_queue.empty()) {
+                TxPort &p = it->second;
+                p.fd_queue.flush([&](const FdFrame &f) {
+                    if (!classic_format(f)) {
+                        ++tx_dropped_;
+                        return false;
+                    }
+                    p.queue.push(f.to_classic());
+                    return true;
+                });
+            }
+        }
+
+        bool is_fd_port(u8 port) const noexcept { return fd_ports_.find(port) != fd_ports_.end(); }
+
+        // Largest message sent as a single frame on `port`
+        usize max_single_frame(u8 port) const noexcept {
+            return is_fd_port(port) ? CAN_FD_DATA_LENGTH : CAN_DATA_LENGTH;
+        }
+
+        // An FD frame goes through the port's TX queue like send_frame(): in
+        // order with the frames already waiting, held while the port is
+        // bus-off, and retried by later updates when the sink refuses it
+        Result<void> send_fd_frame(const FdFrame &frame, u8 port = 0) {
+            if (!is_fd_port(port)) {
+                return Result<void>::err(Error::not_connected());
+            }
+            if (in_update_)
+                return queue_fd_frame(frame, port);
+            auto it = tx_ports_.find(port);
+            if ((it == tx_ports_.end() || it->second.empty()) && !bus_off(port)) {
+                auto result = write_fd_frame(frame, port);
+                if (result.is_ok() || result.error().code != ErrorCode::DriverError)
+                    return result;
+                ++tx_retries_;
+                return queue_fd_frame(frame, port);
+            }
+            auto result = queue_fd_frame(frame, port);
+            if (result.is_ok())
+                flush_tx(0);
+            return result;
+        }
+
+        // Send a small PG packed with others of the same source and destination
+        // into a J1939-22 multi-PG frame. It leaves within max_delay_ms, with
+        // the next update() after it is due. Off an FD port, or above
+        // MULTI_PG_MAX_PAYLOAD bytes, this is send().
+        Result<void> send_packed(PGN pgn, const dp::Vector<u8> &data, InternalCF *source,
+                                 ControlFunction *dest = nullptr, Priority priority = Priority::Default,
+                                 u32 max_delay_ms = 0) {
+            if (!source || !source->cf().address_valid()) {
+                return Result<void>::err(Error::not_connected());
+            }
+            Address dst_addr = dest ? dest->address : BROADCAST_ADDRESS;
+            if (!is_fd_port(source->port()) || data.size() > MULTI_PG_MAX_PAYLOAD ||
+                is_local(source->port(), dst_addr)) {
+                return send(pgn, data, source, dest, priority);
+            }
+            return packer_.submit(source->port(), source->address(), dst_addr, pgn, DataSpan(data), priority,
+                                  timers_.now_ms(), max_delay_ms);
+        }
+
+        const MultiPgPacker &packer() const noexcept { return packer_; }
+
+        // Messages handed between internal CFs and not yet delivered
+        usize local_pending() const noexcept { return local_queue_.size(); }
+
         // Create and own a default vcan0 endpoint on port 0
         Result<void> set_default_endpoint(const wirebit::SocketCanConfig &config = {}) {
 #ifdef NO_HARDWARE
@@ -117,11 +743,13 @@ namespace agrobus::net {
             if (!link_result.is_ok()) {
                 return Result<void>::err(Error(ErrorCode::DriverError, "failed to create SocketCAN link"));
             }
+            stop_rx_worker(0);
             default_link_.emplace(std::move(link_result.value()));
             auto link_ptr =
                 std::shared_ptr<wirebit::Link>(&(*default_link_), [](wirebit::Link *) {}); // non-owning shared_ptr
             default_endpoint_.emplace(link_ptr, wirebit::CanConfig{.bitrate = 250000}, 0);
             endpoints_[0] = &(*default_endpoint_);
+            start_rx_worker(0, &(*default_endpoint_));
             echo::category("isobus.network").info("default endpoint set: ", config.interface_name.c_str());
             return {};
 #endif
@@ -132,21 +760,50 @@ namespace agrobus::net {
             if (!callback) {
                 return Result<void>::err(Error::invalid_state("null callback"));
             }
-            pgn_callbacks_[pgn].push_back(std::move(callback));
+            pgn_dispatch_.add(pgn, std::move(callback));
+            can_filters_dirty_ = true;
+            return {};
+        }
+
+        // Zero-copy variant: the view points into the received frame or transport
+        // buffer and is only valid for the duration of the callback.
+        Result<void> register_pgn_view_callback(PGN pgn, std::function<void(const MessageView &)> callback) {
+            if (!callback) {
+                return Result<void>::err(Error::invalid_state("null callback"));
+            }
+            view_dispatch_.add(pgn, std::move(callback));
+            can_filters_dirty_ = true;
             return {};
         }
 
+        // ─── Static routing ──────────────────────────────────────────────────────
+        // Route the PGNs of a StaticRouter through its compiled dispatch. A PGN
+        // the router handles is delivered to it alone: the callback tables are
+        // not consulted for it (on_message and awaits still see it).
+        template <typename Router> void set_static_router() {
+            static_dispatch_ = &Router::dispatch;
+            static_pgns_.clear();
+            Router::for_each_pgn([this](PGN pgn) { static_pgns_.push_back(pgn); });
+            can_filters_dirty_ = true;
+        }
+
+        void clear_static_router() {
+            static_dispatch_ = nullptr;
+            static_pgns_.clear();
+            can_filters_dirty_ = true;
+        }
+
         // ─── Fast packet PGN registration ─────────────────────────────────────────
         // Register PGNs that should use NMEA2000 fast packet protocol for multi-frame
         Result<void> register_fast_packet_pgn(PGN pgn) {
-            for (auto p : fast_packet_pgns_) {
-                if (p == pgn)
-                    return {};
-            }
-            fast_packet_pgns_.push_back(pgn);
+            if (fast_packet_pgns_.add(pgn))
+                can_filters_dirty_ = true;
             return {};
         }
 
+        // PGNs reassembled by the shared fast packet service
+        const FastPacketRegistry &fast_packet_pgns() const noexcept { return fast_packet_pgns_; }
+
         // ─── Message sending (auto-selects transport) ──────────────────────────────
         Result<void> send(PGN pgn, const dp::Vector<u8> &data, InternalCF *source, ControlFunction *dest = nullptr,
                           Priority priority = Priority::Default) {
@@ -157,6 +814,12 @@ namespace agrobus::net {
             Address src_addr = source->address();
             Address dst_addr = dest ? dest->address : BROADCAST_ADDRESS;
 
+            if (is_local(source->port(), dst_addr)) {
+                queue_local(pgn, data, src_addr, dst_addr, source->port(), priority);
+                if (!config_.local_mirror || data.size() > CAN_DATA_LENGTH)
+                    return {};
+            }
+
             if (data.size() <= CAN_DATA_LENGTH) {
                 return send_single_frame(pgn, data, src_addr, dst_addr, priority);
             }
@@ -167,15 +830,25 @@ namespace agrobus::net {
                 if (!result.is_ok()) {
                     return Result<void>::err(result.error());
                 }
+                if (latency_ && !result.value().empty())
+                    mark_tx(result.value().back(), source->port());
                 return send_frames(result.value(), source->port());
             }
 
+            // One FD frame for up to 64 bytes on a CAN FD port
+            if (data.size() <= CAN_FD_DATA_LENGTH && is_fd_port(source->port())) {
+                return send_fd_frame(
+                    FdFrame::from_message(priority, pgn, src_addr, dst_addr, data.data(), data.size()),
+                    source->port());
+            }
+
             // Use TP for 9-1785 bytes
             if (data.size() <= TP_MAX_DATA_LENGTH) {
                 auto result = tp_.send(pgn, data, src_addr, dst_addr, source->port(), priority);
                 if (!result.is_ok()) {
                     return Result<void>::err(result.error());
                 }
+                mark_tx_session(pgn, src_addr, dst_addr);
                 return send_frames(result.value(), source->port());
             }
 
@@ -187,101 +860,487 @@ namespace agrobus::net {
             if (!result.is_ok()) {
                 return Result<void>::err(result.error());
             }
+            mark_tx_session(pgn, src_addr, dst_addr);
             return send_frames(result.value(), source->port());
         }
 
-        Result<void> send_frame(const Frame &frame) { return send_frame(frame, 0); }
-
-        Result<void> send_frame(const Frame &frame, u8 port) {
-            auto it = endpoints_.find(port);
-            if (it == endpoints_.end() || !it->second) {
+        // Zero-copy variant for large payloads (VT object pools, DDOPs): TP/ETP
+        // sessions reference *data instead of copying it and release it when the
+        // transfer ends. Payloads that fit a single frame or fast packet are sent
+        // as with send().
+        Result<void> send_shared(PGN pgn, SharedPayload data, InternalCF *source, ControlFunction *dest = nullptr,
+                                 Priority priority = Priority::Default) {
+            if (!data) {
+                return Result<void>::err(Error::invalid_state("null payload"));
+            }
+            if (!source || !source->cf().address_valid()) {
                 return Result<void>::err(Error::not_connected());
             }
-            can_frame cf = to_can_frame(frame);
-            auto result = it->second->send_can(cf);
-            if (result.is_ok()) {
-                if (config_.enable_bus_load) {
-                    bus_loads_[port].add_frame(frame.length);
+
+            Address src_addr = source->address();
+            Address dst_addr = dest ? dest->address : BROADCAST_ADDRESS;
+
+            if (sent_without_session(pgn, data->size(), source->port(), dst_addr)) {
+                return send(pgn, *data, source, dest, priority);
+            }
+
+            if (data->size() <= TP_MAX_DATA_LENGTH) {
+                auto result = tp_.send_shared(pgn, std::move(data), src_addr, dst_addr, source->port(), priority);
+                if (!result.is_ok()) {
+                    return Result<void>::err(result.error());
                 }
-                return {};
+                mark_tx_session(pgn, src_addr, dst_addr);
+                return send_frames(result.value(), source->port());
             }
-            return Result<void>::err(Error(ErrorCode::DriverError, "send_can failed"));
-        }
 
-        // ─── Main update loop ────────────────────────────────────────────────────
-        void update(u32 elapsed_ms = 0) {
-            // Read from all endpoints
-            for (auto &[port, ep] : endpoints_) {
-                if (!ep)
-                    continue;
+            if (dst_addr == BROADCAST_ADDRESS) {
+                return Result<void>::err(Error::invalid_state("ETP does not support broadcast"));
+            }
+            auto result = etp_.send_shared(pgn, std::move(data), src_addr, dst_addr, source->port(), priority);
+            if (!result.is_ok()) {
+                return Result<void>::err(result.error());
+            }
+            mark_tx_session(pgn, src_addr, dst_addr);
+            return send_frames(result.value(), source->port());
+        }
 
-                while (true) {
-                    can_frame cf;
-                    auto result = ep->recv_can(cf);
-                    if (!result.is_ok())
-                        break;
+        // Frames already encoded by the caller (e.g. the N2K send templates),
+        // queued together and written by one TX flush: inside update() with the
+        // end-of-update flush, otherwise right away.
+        Result<void> send_batch(const Frame *frames, usize count, InternalCF *source) {
+            if (!source || !source->cf().address_valid()) {
+                return Result<void>::err(Error::not_connected());
+            }
+            if (count == 0)
+                return {};
+            u8 port = source->port();
+            if (!in_update_) {
+                auto it = endpoints_.find(port);
+                if ((it == endpoints_.end() || !it->second) && !is_fd_port(port))
+                    return Result<void>::err(Error::not_connected());
+            }
+            if (latency_)
+                mark_tx(frames[count - 1], port);
+            TxPort &tx = tx_port(port);
+            bool fd_port = is_fd_port(port);
+            for (usize i = 0; i < count; ++i)
+                tx.push(frames[i], fd_port);
+            if (!in_update_)
+                flush_tx(0);
+            return {};
+        }
 
-                    Frame frame = from_can_frame(cf);
-                    process_frame(frame, port);
+        Result<void> send_frame(const Frame &frame) { return send_frame(frame, 0); }
 
-                    if (config_.enable_bus_load) {
-                        bus_loads_[port].add_frame(frame.length);
-                    }
-                }
+        // Outside update() a frame is written at once unless older frames of the
+        // port are still waiting; a frame the driver refuses joins them and is
+        // retried by later updates instead of being lost.
+        Result<void> send_frame(const Frame &frame, u8 port) {
+            if (in_update_)
+                return queue_frame(frame, port);
+            auto it = tx_ports_.find(port);
+            if ((it == tx_ports_.end() || it->second.empty()) && !bus_off(port)) {
+                auto result = write_frame(frame, port);
+                if (result.is_ok() || result.error().code != ErrorCode::DriverError)
+                    return result;
+                ++tx_retries_;
+                return queue_frame(frame, port);
             }
+            auto result = queue_frame(frame, port);
+            if (result.is_ok())
+                flush_tx(0);
+            return result;
+        }
 
-            // Update transport protocols and send any generated frames
-            {
-                auto tp_frames = tp_.update(elapsed_ms);
-                send_transport_frames(tp_frames);
+        // ─── Cut-through ─────────────────────────────────────────────────────────
+        // Write a frame straight to a port's endpoint, even from inside update():
+        // no TX queue, token bucket or rate limit. For bridges passing on traffic
+        // that was already scheduled on its own bus (see on_frame_received).
+        Result<void> forward_frame(const Frame &frame, u8 port = 0) { return write_frame(frame, port); }
+
+        // ─── RX timestamps ──────────────────────────────────────────────────────
+        // Every received frame is stamped in Frame::timestamp_us as it is drained
+        // from its endpoint. By default this is the host monotonic clock; install a
+        // driver/hardware time source here to get tighter timestamps. Multi-frame
+        // messages carry the first and last frame times (Message::first_timestamp_us
+        // and Message::timestamp_us).
+        void set_rx_clock(std::function<u64()> clock) { rx_clock_ = std::move(clock); }
+
+        // Stamp frames from an application Clock, so a simulated run carries
+        // simulated time; `clock` must outlive the network
+        void set_clock(const Clock &clock) { rx_clock_ = [&clock] { return clock.now_us(); }; }
+
+        u64 rx_time_us() const { return rx_clock_ ? rx_clock_() : host_time_us(); }
+
+        static u64 host_time_us() {
+            return static_cast<u64>(std::chrono::duration_cast<std::chrono::microseconds>(
+                                        std::chrono::steady_clock::now().time_since_epoch())
+                                        .count());
+        }
 
-                auto tp_data_frames = tp_.get_pending_data_frames();
-                send_transport_frames(tp_data_frames);
+        // ─── TX scheduling ─────────────────────────────────────────────────────
+        // At most one frame of `pgn` per `min_interval_ms`; excess frames stay queued
+        // (in order) until the interval has elapsed. Applies to queued traffic only.
+        void set_tx_rate_limit(PGN pgn, u32 min_interval_ms) { tx_rate_limiter_.set_limit(pgn, min_interval_ms); }
+        void clear_tx_rate_limit(PGN pgn) { tx_rate_limiter_.remove_limit(pgn); }
 
-                auto etp_frames = etp_.update(elapsed_ms);
-                send_transport_frames(etp_frames);
+        // ─── Main update loop ────────────────────────────────────────────────────
+        void update(u32 elapsed_ms = 0) {
+            bool outermost = !in_update_;
+            ProfileScope profile(outermost ? update_profiler_ : nullptr, profile_update_);
+            in_update_ = true;
+
+            poll(elapsed_ms);
+
+            if (outermost) {
+                in_update_ = false;
+                flush_tx(elapsed_ms);
+                buffer_returns_->drain(*buffer_pool_);
+                if (on_can_filters_changed.count() > 0)
+                    refresh_can_filters();
+            }
+        }
 
-                auto etp_data_frames = etp_.get_pending_data_frames();
-                send_transport_frames(etp_data_frames);
+        // ─── Event-driven scheduling ──────────────────────────────────────────────
+        // Instead of ticking update() at a fixed rate, sleep until the next frame or
+        // the next timer:
+        //     while (running) nm.update(nm.wait(100));
+        // next_deadline_ms() is the time until update() has timer work (TP/ETP/fast
+        // packet timeouts and pacing, address claim, timers(), bus load sampling,
+        // held TX frames); 0 = call update() now, NO_DEADLINE = nothing scheduled.
+        u32 next_deadline_ms() const noexcept {
+            u32 next = earliest(tp_.next_deadline_ms(), etp_.next_deadline_ms());
+            next = earliest(next, fast_packet_.next_deadline_ms());
+            next = earliest(next, timers_.next_deadline_ms());
+            next = earliest(next, awaits_->next_deadline_ms());
+            if (!local_queue_.empty())
+                return 0;
+            if (packer_.pending() > 0) {
+                u64 due = packer_.next_due_ms();
+                u64 now = timers_.now_ms();
+                next = earliest(next, due > now ? static_cast<u32>(due - now) : 0);
+            }
+            if (work_pool_ && work_pool_->has_completions())
+                return 0;
+            if (submits_ && !submits_->empty())
+                return 0;
+            for (const auto &claimer : claimers_) {
+                if (claimer)
+                    next = earliest(next, claimer->next_deadline_ms());
+            }
+            if (config_.enable_bus_load) {
+                for (const auto &[port, bl] : bus_loads_)
+                    next = earliest(next, bl.next_deadline_ms());
+            }
+            for (const auto &[port, tx] : tx_ports_) {
+                if (!tx.empty() && !bus_off(port))
+                    next = earliest(next, 1); // held back by the scheduler or a busy driver, retry next ms
+            }
+            for (const auto &b : bus_off_ports_) {
+                if (b.held_ms < config_.bus_off_hold_ms)
+                    next = earliest(next, config_.bus_off_hold_ms - b.held_ms);
+            }
+            for (const auto &[port, worker] : rx_workers_) {
+                if (!worker->ring.empty())
+                    return 0;
+            }
+            return next;
+        }
 
-                fast_packet_.update(elapsed_ms);
+        // Readable when a reader thread queued frames or offloaded work finished
+        // (threaded_rx or a work pool, else -1).
+        // Add it to an epoll/poll set next to the application's own descriptors.
+        int wait_fd() const noexcept { return wake_fd_.fd; }
+
+        // Block until frames arrive or the next deadline, at most max_wait_ms.
+        // `extra_fd` (e.g. the SocketCAN socket when not threaded) also wakes the
+        // wait. Returns the whole ms elapsed since the time the previous wait()
+        // accounted for, ready to pass to update(): the fraction of a ms left
+        // over is carried into the next call, so a loop woken more than once a
+        // ms still moves the timers at wall-clock rate.
+        u32 wait(u32 max_wait_ms, int extra_fd = -1) {
+            u32 timeout = earliest(next_deadline_ms(), max_wait_ms);
+            if (!wait_accounted_)
+                wait_accounted_ = std::chrono::steady_clock::now();
+            if (timeout > 0) {
+                pollfd fds[2];
+                nfds_t n = 0;
+                if (wake_fd_.fd >= 0)
+                    fds[n++] = pollfd{wake_fd_.fd, POLLIN, 0};
+                if (extra_fd >= 0)
+                    fds[n++] = pollfd{extra_fd, POLLIN, 0};
+                if (n > 0)
+                    ::poll(fds, n, static_cast<int>(timeout));
+                else
+                    std::this_thread::sleep_for(std::chrono::milliseconds(timeout));
             }
+            auto whole = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() -
+                                                                               *wait_accounted_);
+            *wait_accounted_ += whole;
+            return static_cast<u32>(whole.count());
+        }
 
-            // Update address claimers
-            for (auto &claimer : claimers_) {
-                auto frames = claimer.update(elapsed_ms);
-                for (const auto &f : frames) {
-                    send_frame(f);
+        // ─── Kernel CAN filters ──────────────────────────────────────────────────
+        // Acceptance filter set for a port, covering every frame IsoNet would act
+        // on: registered PGN callbacks, fast packet PGNs, TP/ETP, requests and
+        // address claims (to our addresses or global), plus anything sent from our
+        // own addresses (address violation detection). A catch-all on_message
+        // listener disables filtering. Install it with apply_can_filters(); the set
+        // is re-announced through on_can_filters_changed whenever it changes.
+        dp::Vector<can_filter> can_filters(u8 port) {
+            CanFilterBuilder builder;
+            if (on_message.count() > 0)
+                return builder.accept_all().build();
+
+            dp::Vector<Address> dests;
+            for (const auto &icf : internal_cfs_) {
+                if (icf.port() == port && icf.cf().address_valid()) {
+                    dests.push_back(icf.address());
+                    builder.source(icf.address());
                 }
             }
+            dests.push_back(BROADCAST_ADDRESS);
+
+            builder.pgn(PGN_ADDRESS_CLAIMED);
+            builder.pgn(PGN_REQUEST, dests);
+            builder.pgn(PGN_TP_CM, dests).pgn(PGN_TP_DT, dests);
+            builder.pgn(PGN_ETP_CM, dests).pgn(PGN_ETP_DT, dests);
+            fast_packet_pgns_.for_each([&](PGN pgn) { builder.pgn(pgn, dests); });
+            pgn_dispatch_.for_each_pgn([&](PGN pgn) { builder.pgn(pgn, dests); });
+            view_dispatch_.for_each_pgn([&](PGN pgn) { builder.pgn(pgn, dests); });
+            for (PGN pgn : static_pgns_)
+                builder.pgn(pgn, dests);
+            return builder.build();
+        }
 
-            // Update bus load
-            if (config_.enable_bus_load) {
-                for (auto &[port, bl] : bus_loads_) {
-                    bl.update(elapsed_ms);
-                }
+        // Frames waiting in the TX queue of a port (held back by the scheduler, or
+        // produced by the update() currently running)
+        usize tx_pending(u8 port) const noexcept {
+            auto it = tx_ports_.find(port);
+            return it != tx_ports_.end() ? it->second.size() : 0;
+        }
+
+        // Frames dropped (no endpoint on the port at flush time, or the port's
+        // queue was full)
+        u32 tx_dropped() const noexcept { return tx_dropped_; }
+
+        // Writes the driver refused; the frame stayed queued for the next flush
+        u32 tx_retries() const noexcept { return tx_retries_; }
+
+        // ─── CAN error state ─────────────────────────────────────────────────────
+        // Error frames (ask the socket for them with can_errors::enable) are
+        // counted per port and never reach the stack. A bus-off port stops: its
+        // TX queue keeps what is sent meanwhile, TP/ETP sessions on it generate
+        // nothing and their timers stand still for bus_off_hold_ms. When the
+        // controller restarts (a restart error frame, or any frame received) the
+        // port resumes and our claimed CFs on it announce their addresses again.
+        const CanErrorStats *can_errors(u8 port) const noexcept {
+            auto it = can_errors_.find(port);
+            return it != can_errors_.end() ? &it->second : nullptr;
+        }
+
+        CanBusState bus_state(u8 port) const noexcept {
+            auto it = can_errors_.find(port);
+            return it != can_errors_.end() ? it->second.state : CanBusState::ErrorActive;
+        }
+
+        bool bus_off(u8 port) const noexcept {
+            for (const auto &b : bus_off_ports_) {
+                if (b.port == port)
+                    return true;
             }
+            return false;
         }
 
+        // ─── Threaded RX ─────────────────────────────────────────────────────────
+        // Stop and join all reader threads; ports fall back to polling in update().
+        // Reader threads stamp frames with the rx clock that was installed when
+        // their endpoint was set, calling it from the reader thread.
+        void stop_rx_threads() { rx_workers_.clear(); }
+
+        bool rx_threaded(u8 port) const noexcept { return rx_workers_.find(port) != rx_workers_.end(); }
+
         // ─── Start address claiming ──────────────────────────────────────────────
         Result<void> start_address_claiming() {
-            if (claimers_.empty()) {
+            if (internal_cfs_.empty()) {
                 return Result<void>::err(Error::invalid_state("no control functions registered"));
             }
-            for (auto &claimer : claimers_) {
-                auto frames = claimer.start();
+            for (usize i = 0; i < claimers_.size(); ++i) {
+                if (!claimers_[i])
+                    continue;
+                auto frames = claimers_[i]->start();
                 for (const auto &f : frames) {
                     send_frame(f);
                 }
+                record_claims(*internal_cfs_.at(static_cast<u32>(i)), frames);
             }
+            sync_directory();
             echo::category("isobus.network").debug("address claiming started");
             return {};
         }
 
+        // ─── Claim cache ─────────────────────────────────────────────────────────
+        // Persist what the claim ended with (see ClaimCache) and feed it back at
+        // the next key-on, before start_address_claiming().
+        void set_claim_store(ClaimStore store) { claim_store_ = std::move(store); }
+
+        Result<void> restore_claim(InternalCF *cf, const ClaimCache &cache) {
+            SlabHandle h = internal_cfs_.handle_of(cf);
+            if (h == INVALID_HANDLE)
+                return Result<void>::err(Error::invalid_state("not an internal CF of this network"));
+            if (cache.name != cf->name())
+                return Result<void>::err(Error::invalid_state("claim cache is for another NAME"));
+            Address start = cache.start_address(cf->name(), cf->preferred_address());
+            claimers_[Slab<InternalCF>::index_of(h)]->set_start_address(start);
+            echo::category("isobus.network.claim").debug("claim cache restored: start=", start);
+            return {};
+        }
+
         // ─── Transport access (for advanced usage) ────────────────────────────────
         TransportProtocol &transport_protocol() noexcept { return tp_; }
         ExtendedTransportProtocol &extended_transport_protocol() noexcept { return etp_; }
         FastPacketProtocol &fast_packet_protocol() noexcept { return fast_packet_; }
+        BufferPool &buffer_pool() noexcept { return *buffer_pool_; }
+        // Receive session caps and what each source holds now
+        TransportLimits &transport_limits() noexcept { return *transport_limits_; }
+
+        // Transport metrics (TP, ETP, fast packet) for a scraper or periodic log
+        const TransportMetrics &tp_metrics() const noexcept { return tp_.metrics(); }
+        const TransportMetrics &etp_metrics() const noexcept { return etp_.metrics(); }
+        const TransportMetrics &fast_packet_metrics() const noexcept { return fast_packet_.metrics(); }
+
+        // Timer wheel for components: schedule a deadline instead of counting
+        // elapsed time in their own update(). Callbacks run inside update().
+        TimerWheel &timers() noexcept { return timers_; }
+        const TimerWheel &timers() const noexcept { return timers_; }
+
+        // Last-value cache: track(pgn) once, then read the newest payload and its
+        // age per (PGN, source) from any thread without subscribing
+        LastValueCache &last_values() noexcept { return *last_values_; }
+        const LastValueCache &last_values() const noexcept { return *last_values_; }
+
+        // ─── Coroutine flows ─────────────────────────────────────────────────────
+        // Awaitables for request/response flows written as Task<> coroutines; the
+        // flows are resumed from inside update(). The IsoNet must outlive (and not
+        // move under) the flows awaiting it. A timeout of NO_TIMEOUT waits forever.
+
+        // Next message of `pgn` (from `source`, BROADCAST_ADDRESS = anyone)
+        MessageAwait receive(PGN pgn, Address source = BROADCAST_ADDRESS, u32 timeout_ms = NO_TIMEOUT) {
+            return MessageAwait(*awaits_, MessageFilter{pgn, source}, timeout_ms);
+        }
+
+        MessageAwait receive(MessageFilter filter, u32 timeout_ms = NO_TIMEOUT) {
+            return MessageAwait(*awaits_, filter, timeout_ms);
+        }
+
+        SleepAwait sleep(u32 delay_ms) { return SleepAwait(awaits_->timers(), delay_ms); }
+
+        // Request `pgn` from `destination` and wait for the answer. A NACK (or
+        // access denied / cannot respond) ends the flow with Error::invalid_pgn.
+        Task<Result<Message>> request(PGN pgn, InternalCF *source, Address destination = BROADCAST_ADDRESS,
+                                      u32 timeout_ms = 1250) {
+            MessageAwait reply(*awaits_, MessageFilter{pgn, destination, true}, timeout_ms);
+            dp::Vector<u8> data = {static_cast<u8>(pgn & 0xFF), static_cast<u8>((pgn >> 8) & 0xFF),
+                                   static_cast<u8>((pgn >> 16) & 0xFF)};
+            ControlFunction dest_cf;
+            dest_cf.address = destination;
+            auto sent = send(PGN_REQUEST, data, source, destination == BROADCAST_ADDRESS ? nullptr : &dest_cf);
+            if (!sent.is_ok())
+                co_return Result<Message>::err(sent.error());
+
+            auto result = co_await reply;
+            if (result.is_ok() && is_refusal(result.value(), pgn))
+                co_return Result<Message>::err(Error::invalid_pgn(pgn));
+            co_return result;
+        }
+
+        // send(), then wait until a TP/ETP transfer has been acknowledged (or
+        // aborted). Single frames (FD frames on an FD port), fast packets and
+        // local deliveries complete once queued. `data`
+        // is copied before the first suspension.
+        Task<Result<void>> send_and_wait(PGN pgn, const dp::Vector<u8> &data, InternalCF *source,
+                                         ControlFunction *dest = nullptr, u32 timeout_ms = NO_TIMEOUT,
+                                         Priority priority = Priority::Default) {
+            if (!source || !source->cf().address_valid())
+                co_return Result<void>::err(Error::not_connected());
+            Address dst_addr = dest ? dest->address : BROADCAST_ADDRESS;
+            TransferAwait done(*awaits_, pgn, source->address(), dst_addr, source->port(), timeout_ms);
+            auto sent = send(pgn, data, source, dest, priority);
+            if (!sent.is_ok())
+                co_return sent;
+            if (sent_without_session(pgn, data.size(), source->port(), dst_addr))
+                co_return Result<void>{};
+            co_return co_await done;
+        }
+
+        // ─── Sending from other threads ──────────────────────────────────────────
+        // Thread-safe (NetworkConfig::submit_queue). Control, UI and logging
+        // threads queue a send without a lock or a copy of the payload; the
+        // next update() passes it to send() on the network thread, before the
+        // transport tick, and wait_fd() wakes a waiting loop. An error here
+        // means the queue is full (or off); errors of the send itself are only
+        // seen through submit_async(). `source` must stay alive until then.
+        Result<void> submit(PGN pgn, dp::Vector<u8> data, InternalCF *source, Address destination = BROADCAST_ADDRESS,
+                            Priority priority = Priority::Default) {
+            SubmittedSend s{pgn, std::move(data), source, destination, priority, nullptr};
+            return enqueue(std::move(s));
+        }
+
+        // submit(), with a future that becomes ready as send_and_wait() returns:
+        // once queued for a single frame, once acknowledged (or aborted) for a
+        // TP/ETP transfer. A refused submit is ready at once with the error. A
+        // transfer not done within NetworkConfig::submit_timeout_ms, or still
+        // running when the IsoNet is destroyed, makes it ready with an error.
+        std::future<Result<void>> submit_async(PGN pgn, dp::Vector<u8> data, InternalCF *source,
+                                               Address destination = BROADCAST_ADDRESS,
+                                               Priority priority = Priority::Default) {
+            auto done = std::make_unique<std::promise<Result<void>>>();
+            std::future<Result<void>> future = done->get_future();
+            std::promise<Result<void>> *promise = done.get();
+            SubmittedSend s{pgn, std::move(data), source, destination, priority, std::move(done)};
+            auto queued = enqueue(std::move(s));
+            if (!queued.is_ok())
+                promise->set_value(queued); // Still owned by `s`, which was not taken
+            return future;
+        }
+
+        // Submits refused because the queue was full
+        u64 submits_dropped() const noexcept { return submits_ ? submits_->dropped() : 0; }
+
+        // ─── Offloaded work ──────────────────────────────────────────────────────
+        // Run `work()` on the WorkPool (NetworkConfig::work_pool) and `done(result)`
+        // back on the network thread during a later update(), so handlers can
+        // parse large payloads without stalling frame processing and still send
+        // their response from the right context. Without a pool both run inline.
+        // Both callables must be copyable and must not touch IsoNet from work().
+        template <typename Work, typename Done> void offload(Work work, Done done) {
+            using R = std::invoke_result_t<Work &>;
+            if (!work_pool_) {
+                if constexpr (std::is_void_v<R>) {
+                    work();
+                    done();
+                } else {
+                    done(work());
+                }
+                return;
+            }
+            WorkPool *pool = work_pool_.get();
+            pool->submit([pool, work = std::move(work), done = std::move(done)]() mutable {
+                if constexpr (std::is_void_v<R>) {
+                    work();
+                    pool->complete(std::move(done));
+                } else {
+                    auto result = std::make_shared<R>(work());
+                    pool->complete([done = std::move(done), result]() mutable { done(std::move(*result)); });
+                }
+            });
+        }
+
+        // The pool behind offload(), null when work runs inline
+        WorkPool *work_pool() noexcept { return work_pool_.get(); }
+
+        // Flows currently suspended on a message or transfer
+        usize pending_awaits() const noexcept { return awaits_->size(); }
 
         // ─── Diagnostics ─────────────────────────────────────────────────────────
         f32 bus_load(u8 port) const noexcept {
@@ -291,6 +1350,50 @@ namespace agrobus::net {
             return 0.0f;
         }
 
+        // Who uses the bus: received and sent frames per (port, PGN, source);
+        // null unless NetworkConfig::profile() was set
+        const TrafficProfiler *traffic_profile() const noexcept { return profiler_.get(); }
+
+        void reset_traffic_profile() {
+            if (profiler_)
+                profiler_->reset();
+        }
+
+        // The last frames sent and received on every port; null unless
+        // NetworkConfig::flight_recorder() was set. freeze() it from the
+        // application or watch() a SafetyPolicy for more triggers.
+        FlightRecorder *flight_recorder() noexcept { return recorder_.get(); }
+        const FlightRecorder *flight_recorder() const noexcept { return recorder_.get(); }
+
+        // Latency histograms per PGN (receive to end of callbacks, handler time,
+        // send to accepted); null unless NetworkConfig::latency() was set.
+        // Subscribe to on_over_budget or install a cheaper clock here.
+        LatencyMonitor *latency() noexcept { return latency_.get(); }
+        const LatencyMonitor *latency() const noexcept { return latency_.get(); }
+
+        // ─── Update profiling ────────────────────────────────────────────────────
+        // Time update() ("isonet"), the callbacks of each message ("dispatch",
+        // part of "isonet") and timer callbacks such as heartbeats ("timers")
+        // into `profiler`. Protocols built on this IsoNet (VTClient,
+        // TaskControllerClient, DiagnosticProtocol...) time their own update()
+        // into it too. nullptr = off.
+        void set_update_profiler(UpdateProfiler *profiler) {
+            update_profiler_ = profiler;
+            if (!profiler)
+                return;
+            profile_update_ = profiler->slot("isonet");
+            profile_dispatch_ = profiler->slot("dispatch");
+            profile_timers_ = profiler->slot("timers");
+        }
+
+        UpdateProfiler *update_profiler() const noexcept { return update_profiler_; }
+
+        // Frames lost because the RX ring of a threaded port was full
+        u64 rx_dropped(u8 port) const noexcept {
+            auto it = rx_workers_.find(port);
+            return it != rx_workers_.end() ? it->second->ring.dropped() : 0;
+        }
+
         dp::Vector<ControlFunction *> control_functions() {
             dp::Vector<ControlFunction *> cfs;
             for (auto &icf : internal_cfs_)
@@ -300,8 +1403,34 @@ namespace agrobus::net {
             return cfs;
         }
 
-        dp::Vector<InternalCF> &internal_cfs() noexcept { return internal_cfs_; }
-        dp::Vector<PartnerCF> &partner_cfs() noexcept { return partner_cfs_; }
+        Slab<InternalCF> &internal_cfs() noexcept { return internal_cfs_; }
+        Slab<PartnerCF> &partner_cfs() noexcept { return partner_cfs_; }
+
+        // Our internal CF, else the partner bound, at an address (nullptr if neither)
+        ControlFunction *cf_at(u8 port, Address addr) {
+            if (addr > MAX_ADDRESS)
+                return nullptr;
+            const auto &slot = directory_.at(port, addr);
+            if (slot.internal != CFDirectory::NONE)
+                return &internal_cfs_.at(slot.internal)->cf();
+            if (slot.partner != CFDirectory::NONE)
+                return &partner_cfs_.at(slot.partner)->cf();
+            return nullptr;
+        }
+
+        // Internal or bound partner CF with this NAME (nullptr if none)
+        ControlFunction *find_cf(Name name) {
+            auto ref = directory_.find(name);
+            if (!ref)
+                return nullptr;
+            return ref->internal ? &internal_cfs_.at(ref->index)->cf() : &partner_cfs_.at(ref->index)->cf();
+        }
+
+        const CFDirectory &directory() const noexcept { return directory_; }
+
+        // Every NAME claimed on the bus (ours included): who is at an address,
+        // where a NAME is
+        const NameTable &names() const noexcept { return *names_; }
 
         // ─── Test injection ──────────────────────────────────────────────────────
         // Inject a message directly into the PGN callback dispatch (for unit testing)
@@ -309,17 +1438,418 @@ namespace agrobus::net {
 
         // ─── Events ──────────────────────────────────────────────────────────────
         Event<const Message &> on_message;
+        // Every received message as an immutable, refcounted SharedMessage to
+        // keep or hand to other threads: TP/ETP payloads are adopted from the
+        // reassembly buffer, others copied once into a BufferPool buffer
+        Event<const SharedMessage &> on_shared_message;
         Event<ControlFunction *, CFState> on_cf_state_change;
         Event<Address> on_address_violation; // Emitted when another device uses our claimed address
+        Event<u8> on_names_changed;           // NAME table of a port updated by a batch of claims
+        Event<u8, const dp::Vector<can_filter> &> on_can_filters_changed; // (port, new filter set)
+        // Every received frame as it is drained, before the batch it came in is
+        // processed: a bridge forwards from here without waiting on handlers
+        Event<const Frame &, u8> on_frame_received;
+        Event<u8, CanBusState> on_bus_state; // (port, new controller state) from its error frames
 
       private:
-        Result<void> send_single_frame(PGN pgn, const dp::Vector<u8> &data, Address src, Address dst, Priority prio) {
-            dp::Array<u8, 8> frame_data = {};
-            for (usize i = 0; i < data.size() && i < 8; ++i) {
-                frame_data[i] = data[i];
+        Result<void> write_frame(const Frame &frame, u8 port) {
+            auto it = endpoints_.find(port);
+            wirebit::CanEndpoint *ep = (it != endpoints_.end()) ? it->second : nullptr;
+            auto fit = fd_ports_.find(port);
+            const FdPort *fd = fit != fd_ports_.end() ? &fit->second : nullptr;
+            if (!ep && !fd) {
+                return Result<void>::err(Error::not_connected());
             }
-            for (usize i = data.size(); i < 8; ++i) {
-                frame_data[i] = 0xFF;
+            if (write_classic(ep, fd, frame)) {
+                if (config_.enable_bus_load) {
+                    port_load(port).add_frame(frame);
+                }
+                if (profiler_)
+                    profiler_->record(frame, port, rx_time_us());
+                if (recorder_)
+                    recorder_->record(frame, port, capture_flags::TX, rx_time_us());
+                if (tx_mark_count_ > 0)
+                    tx_accepted(frame, port);
+                return {};
+            }
+            return Result<void>::err(Error(ErrorCode::DriverError, "send_can failed"));
+        }
+
+        Result<void> write_fd_frame(const FdFrame &frame, u8 port) {
+            auto it = fd_ports_.find(port);
+            if (it == fd_ports_.end()) {
+                return Result<void>::err(Error::not_connected());
+            }
+            auto eit = endpoints_.find(port);
+            wirebit::CanEndpoint *ep = (eit != endpoints_.end()) ? eit->second : nullptr;
+            if (!write_fd(ep, it->second, frame)) {
+                return Result<void>::err(Error(ErrorCode::DriverError, "FD send failed"));
+            }
+            fd_frame_sent(frame, port, config_.enable_bus_load ? &port_load(port) : nullptr);
+            return {};
+        }
+
+        // Accounting for a frame an FD port accepted. Classic-format frames are
+        // counted as write_frame() counts them; an FD frame is recorded with its
+        // first 8 data bytes, as capture records hold no more.
+        void fd_frame_sent(const FdFrame &frame, u8 port, BusLoad *bl) {
+            if (!classic_format(frame)) {
+                if (bl)
+                    bl->add_frame(frame);
+                if (recorder_)
+                    recorder_->record(frame.to_classic(), port, capture_flags::TX, rx_time_us());
+                return;
+            }
+            Frame classic = frame.to_classic();
+            if (bl)
+                bl->add_frame(classic);
+            if (profiler_)
+                profiler_->record(classic, port, rx_time_us());
+            if (recorder_)
+                recorder_->record(classic, port, capture_flags::TX, rx_time_us());
+            if (tx_mark_count_ > 0)
+                tx_accepted(classic, port);
+        }
+
+        // Multi-PG frames whose earliest PG is due (timers ran first, so PGs
+        // submitted by periodic senders this update with no delay go now).
+        // They join the port's TX queue and leave with the end-of-update
+        // flush, behind frames already waiting and not while bus-off.
+        void send_packed_frames() {
+            if (packer_.pending() == 0)
+                return;
+            packed_frames_.clear();
+            packer_.collect(timers_.now_ms(), packed_frames_);
+            for (const auto &p : packed_frames_)
+                send_fd_frame(p.frame, p.port);
+        }
+
+        // send() hands `size` bytes over without a TP/ETP session: a classic or
+        // FD single frame, a fast packet or a local delivery
+        bool sent_without_session(PGN pgn, usize size, u8 port, Address dst) const noexcept {
+            return is_local(port, dst) || size <= max_single_frame(port) ||
+                   (is_fast_packet_pgn(pgn) && size <= FAST_PACKET_MAX_DATA);
+        }
+
+        // ─── Local delivery ──────────────────────────────────────────────────────
+        bool is_local(u8 port, Address dst) const noexcept {
+            return config_.local_delivery && dst != BROADCAST_ADDRESS &&
+                   directory_.internal_at(port, dst) != CFDirectory::NONE;
+        }
+
+        void queue_local(PGN pgn, const dp::Vector<u8> &data, Address src, Address dst, u8 port, Priority prio) {
+            LocalMessage local;
+            local.msg = Message(pgn, Payload(data.data(), data.size()), src, dst, prio);
+            local.msg.timestamp_us = rx_time_us();
+            local.msg.first_timestamp_us = local.msg.timestamp_us;
+            local.port = port;
+            local_queue_.push_back(std::move(local));
+        }
+
+        // Dispatch what was queued before this call; messages sent by the
+        // handlers wait for the next update, so two CFs answering each other
+        // cannot keep one update() busy
+        void deliver_local() {
+            if (local_queue_.empty())
+                return;
+            local_batch_.clear();
+            local_batch_.swap(local_queue_);
+            for (const auto &local : local_batch_) {
+                dispatch_message(local.msg);
+                if (local.msg.data.size() > CAN_DATA_LENGTH) {
+                    // Wake a sender awaiting the transfer it would have made
+                    TransportSession done;
+                    done.direction = TransportDirection::Transmit;
+                    done.pgn = local.msg.pgn;
+                    done.source_address = local.msg.source;
+                    done.destination_address = local.msg.destination;
+                    done.can_port = local.port;
+                    awaits_->transfer_done(done, Error{});
+                }
+            }
+            local_batch_.clear();
+        }
+
+        // Classic frame through the endpoint, or the FD sink of an FD-only port
+        static bool write_classic(wirebit::CanEndpoint *ep, const FdPort *fd, const Frame &frame) {
+            if (ep)
+                return ep->send_can(to_can_frame(frame)).is_ok();
+            return fd->tx(to_canfd_frame(frame));
+        }
+
+        // Frame of an FD port's queue: classic-format ones as write_classic()
+        // writes them, FD ones through the FD sink
+        static bool write_fd(wirebit::CanEndpoint *ep, const FdPort &fd, const FdFrame &frame) {
+            if (classic_format(frame))
+                return write_classic(ep, &fd, frame.to_classic());
+            return fd.tx(to_canfd_frame(frame));
+        }
+
+        // Classic frame carried in an FdFrame (FdFrame::from_frame, or a short
+        // frame without bitrate switch), classified as poll_fd_ports() does
+        static bool classic_format(const FdFrame &frame) noexcept {
+            return frame.fits_classic() && (frame.flags & CAN_FD_FLAG_BRS) == 0;
+        }
+
+        Result<void> queue_frame(const Frame &frame, u8 port) {
+            TxPort &tx = tx_port(port);
+            if (config_.tx_queue_frames != 0 && tx.size() >= config_.tx_queue_frames) {
+                ++tx_dropped_;
+                return Result<void>::err(Error(ErrorCode::NoResources, "TX queue full"));
+            }
+            tx.push(frame, is_fd_port(port));
+            return {};
+        }
+
+        Result<void> queue_fd_frame(const FdFrame &frame, u8 port) {
+            TxPort &tx = tx_port(port);
+            if (config_.tx_queue_frames != 0 && tx.size() >= config_.tx_queue_frames) {
+                ++tx_dropped_;
+                return Result<void>::err(Error(ErrorCode::NoResources, "TX queue full"));
+            }
+            tx.fd_queue.push(frame);
+            return {};
+        }
+
+        // Transport sessions stop generating data frames for a port whose queue is
+        // backed up or whose controller is bus-off, and pick up again once it has
+        // drained below the threshold
+        void apply_tx_backpressure() {
+            if (config_.tx_backpressure_frames == 0 && bus_off_ports_.empty())
+                return;
+            u32 pause_at = config_.tx_backpressure_frames;
+            for (const auto &[port, tx] : tx_ports_) {
+                bool paused = (pause_at != 0 && tx.size() >= pause_at) || bus_off(port);
+                tp_.pause_port(port, paused);
+                etp_.pause_port(port, paused);
+            }
+        }
+
+        TxPort &tx_port(u8 port) {
+            auto it = tx_ports_.find(port);
+            if (it != tx_ports_.end())
+                return it->second;
+            TxPort &p = tx_ports_[port];
+            p.bucket.configure(config_.tx_max_load_percent, config_.bitrate, 100, config_.bit_model);
+            return p;
+        }
+
+        BusLoad &port_load(u8 port) {
+            auto it = bus_loads_.find(port);
+            if (it != bus_loads_.end())
+                return it->second;
+            return bus_loads_[port] = BusLoad(config_.bitrate, config_.bit_model);
+        }
+
+        // Write queued frames: one endpoint and bus-load lookup per port. Urgent
+        // priorities always go out (and may put the bucket into debt); lower
+        // priorities stop at the first frame the bucket cannot pay for. A write the
+        // driver refuses (ENOBUFS) ends the port's flush; that frame and the rest
+        // stay queued in order for the next one. Bus-off ports keep their queue.
+        // An FD port flushes its fd_queue the same way, FD frames costed at the
+        // port's data bitrate.
+        void flush_tx(u32 elapsed_ms) {
+            tx_rate_limiter_.advance(elapsed_ms);
+            u8 urgent = static_cast<u8>(config_.tx_urgent_priority);
+
+            for (auto &[port, tx] : tx_ports_) {
+                tx.bucket.refill(elapsed_ms);
+                if (tx.empty() || bus_off(port))
+                    continue;
+
+                auto it = endpoints_.find(port);
+                wirebit::CanEndpoint *ep = (it != endpoints_.end()) ? it->second : nullptr;
+                auto fit = fd_ports_.find(port);
+                const FdPort *fd = fit != fd_ports_.end() ? &fit->second : nullptr;
+                if (!ep && !fd) {
+                    tx_dropped_ += static_cast<u32>(tx.size());
+                    tx.clear();
+                    continue;
+                }
+
+                BusLoad *bl = config_.enable_bus_load ? &port_load(port) : nullptr;
+                auto admit = [&](const Frame &f) {
+                    PGN pgn = f.pgn();
+                    if (!tx_rate_limiter_.ready(pgn))
+                        return TxAdmit::Hold;
+                    if (static_cast<u8>(f.priority()) <= urgent) {
+                        tx.bucket.force_consume(f);
+                    } else if (!tx.bucket.try_consume(f)) {
+                        return TxAdmit::Stop;
+                    }
+                    return TxAdmit::Send;
+                };
+                tx.queue.flush_until_busy(
+                    [&](const Frame &f) {
+                        if (!write_classic(ep, fd, f)) {
+                            ++tx_retries_;
+                            return false;
+                        }
+                        tx_rate_limiter_.mark_sent(f.pgn());
+                        if (bl)
+                            bl->add_frame(f);
+                        if (profiler_)
+                            profiler_->record(f, port, rx_time_us());
+                        if (recorder_)
+                            recorder_->record(f, port, capture_flags::TX, rx_time_us());
+                        if (tx_mark_count_ > 0)
+                            tx_accepted(f, port);
+                        return true;
+                    },
+                    admit);
+                if (!fd || tx.fd_queue.empty())
+                    continue;
+                tx.fd_queue.flush_until_busy(
+                    [&](const FdFrame &f) {
+                        if (!write_fd(ep, *fd, f)) {
+                            ++tx_retries_;
+                            return false;
+                        }
+                        tx_rate_limiter_.mark_sent(f.pgn());
+                        fd_frame_sent(f, port, bl);
+                        return true;
+                    },
+                    [&](const FdFrame &f) {
+                        if (classic_format(f))
+                            return admit(f.to_classic());
+                        if (!tx_rate_limiter_.ready(f.pgn()))
+                            return TxAdmit::Hold;
+                        if (static_cast<u8>(f.priority()) <= urgent) {
+                            tx.bucket.force_consume(f, fd->data_bitrate);
+                        } else if (!tx.bucket.try_consume(f, fd->data_bitrate)) {
+                            return TxAdmit::Stop;
+                        }
+                        return TxAdmit::Send;
+                    });
+            }
+        }
+
+        void poll(u32 elapsed_ms) {
+            // Re-arm the wake fd before draining; frames pushed after this point
+            // signal it again
+            if (wake_fd_.fd >= 0) {
+                u64 counter;
+                (void)!::read(wake_fd_.fd, &counter, sizeof(counter));
+            }
+
+            // Pick up addresses set on a CF directly since the last update
+            sync_directory();
+
+            // Read from all endpoints: drain into the batch buffer, then process the
+            // whole batch in one pass so the receive loop stays tight.
+            for (auto &[port, ep] : endpoints_) {
+                if (!ep)
+                    continue;
+
+                BusLoad *bl = nullptr;
+                if (config_.enable_bus_load) {
+                    bl = &port_load(port);
+                }
+
+                auto wit = rx_workers_.find(port);
+                RxWorker *worker = wit != rx_workers_.end() ? wit->second.get() : nullptr;
+                auto sit = rx_sources_.find(port);
+                auto *source = sit != rx_sources_.end() ? &sit->second : nullptr;
+
+                while (true) {
+                    usize count = 0;
+                    if (worker)
+                        count = drain_ring(worker->ring, port);
+                    else if (source)
+                        count = receive_batch(*source, port);
+                    else
+                        count = receive_batch([ep](can_frame &cf) { return ep->recv_can(cf).is_ok(); }, port);
+                    if (count > 0 && !bus_off_ports_.empty() && bus_off(port))
+                        restarted(port, rx_batch_[0].timestamp_us); // Receiving again: the controller is back
+                    if (on_frame_received.count() > 0) {
+                        for (usize i = 0; i < count; ++i)
+                            on_frame_received.emit(rx_batch_[i], port);
+                    }
+                    for (usize i = 0; i < count; ++i) {
+                        process_frame(rx_batch_[i], port);
+                    }
+                    process_claims();
+                    if (bl) {
+                        for (usize i = 0; i < count; ++i) {
+                            bl->add_frame(rx_batch_[i]);
+                        }
+                    }
+                    if (profiler_) {
+                        for (usize i = 0; i < count; ++i)
+                            profiler_->record(rx_batch_[i], port, rx_batch_[i].timestamp_us);
+                    }
+                    if (count < rx_batch_.size())
+                        break;
+                }
+            }
+            poll_fd_ports();
+            deliver_local();
+
+            // Continuations of offloaded work, on this thread like any callback
+            if (work_pool_)
+                work_pool_->drain();
+            // Sends from other threads start before the transport tick below
+            if (submits_)
+                drain_submits();
+
+            // Update transport protocols and send any generated frames
+            {
+                tick_frames_.clear();
+                hold_bus_off(elapsed_ms);
+                apply_tx_backpressure();
+                tp_.update(elapsed_ms, tick_frames_);
+                tp_.get_pending_data_frames(tick_frames_);
+                etp_.update(elapsed_ms, tick_frames_);
+                etp_.get_pending_data_frames(tick_frames_);
+                send_transport_frames(tick_frames_);
+
+                fast_packet_.update(elapsed_ms);
+            }
+
+            // Update address claimers
+            for (usize i = 0; i < claimers_.size(); ++i) {
+                if (!claimers_[i])
+                    continue;
+                const InternalCF &icf = *internal_cfs_.at(static_cast<u32>(i));
+                ClaimState before = icf.claim_state();
+                tick_frames_.clear();
+                claimers_[i]->update(elapsed_ms, tick_frames_);
+                for (const auto &f : tick_frames_) {
+                    send_frame(f);
+                }
+                record_claims(icf, tick_frames_);
+                if (claim_store_ && before != ClaimState::Claimed && icf.claim_state() == ClaimState::Claimed)
+                    claim_store_(ClaimCache::capture(*names_, icf.port(), icf.name(), icf.address()));
+            }
+            sync_directory();
+
+            {
+                ProfileScope profile(update_profiler_, profile_timers_);
+                timers_.advance(elapsed_ms);
+            }
+            send_packed_frames();
+            last_values_->set_now(timers_.now_ms());
+            awaits_->advance(elapsed_ms);
+
+            // Update bus load
+            if (config_.enable_bus_load) {
+                for (auto &[port, bl] : bus_loads_) {
+                    bl.update(elapsed_ms);
+                    if (config_.cts_window.adaptive) {
+                        tp_.cts_window().set_bus_load(port, bl.load_percent());
+                        etp_.cts_window().set_bus_load(port, bl.load_percent());
+                    }
+                }
+            }
+        }
+
+        Result<void> send_single_frame(PGN pgn, const dp::Vector<u8> &data, Address src, Address dst, Priority prio) {
+            dp::Array<u8, 8> frame_data = {};
+            for (usize i = 0; i < data.size() && i < 8; ++i) {
+                frame_data[i] = data[i];
+            }
+            for (usize i = data.size(); i < 8; ++i) {
+                frame_data[i] = 0xFF;
             }
 
             Frame frame;
@@ -327,6 +1857,8 @@ namespace agrobus::net {
             frame.data = frame_data;
             frame.length = 8;
 
+            if (latency_)
+                mark_tx(frame, 0);
             return send_frame(frame);
         }
 
@@ -347,66 +1879,105 @@ namespace agrobus::net {
         }
 
         bool is_fast_packet_pgn(PGN pgn) const noexcept {
-            if (!config_.enable_fast_packet)
-                return false;
-            for (auto p : fast_packet_pgns_) {
-                if (p == pgn)
-                    return true;
-            }
-            return false;
+            return config_.enable_fast_packet && fast_packet_pgns_.contains(pgn);
         }
 
         void process_frame(const Frame &frame, u8 port) {
-            PGN pgn = frame.pgn();
-
-            // Check for address claim messages
+            AGROBUS_TRACE(TraceEvent::FrameRx, port, frame.id.raw, frame.length);
+            if (recorder_)
+                recorder_->record(frame, port, 0, frame.timestamp_us);
+            // Identifier fields are decoded once here and passed down
+            const FrameHeader hdr = frame.header();
+            PGN pgn = hdr.pgn;
+
+            // Address claims are collected and handled per batch
             if (pgn == PGN_ADDRESS_CLAIMED) {
-                handle_address_claim(frame, port);
+                pending_claims_.push_back(PendingClaim{frame, port});
                 return;
             }
 
             // Address violation detection (ISO 11783-5 Section 4.4.4.3):
             // If we receive a non-address-claim message from our own claimed address,
             // re-assert our claim and emit a violation event.
-            check_address_violation(frame, port);
+            check_address_violation(hdr.source, port);
+
+            // Request for Address Claimed (ISO 11783-5 Section 4.4.2): still dispatched to
+            // PGN_REQUEST callbacks, but the claims are answered here
+            if (pgn == PGN_REQUEST && frame.length >= 3 && frame.data[0] == (PGN_ADDRESS_CLAIMED & 0xFF) &&
+                frame.data[1] == ((PGN_ADDRESS_CLAIMED >> 8) & 0xFF) && frame.data[2] == 0)
+                answer_claim_request(hdr.destination, port);
+
+            // Connection-mode transfers between other CFs (foreign_transport_filter)
+            bool transport = pgn == PGN_TP_CM || pgn == PGN_TP_DT || pgn == PGN_ETP_CM || pgn == PGN_ETP_DT;
+            if (transport && config_.drop_foreign_transport && hdr.destination != BROADCAST_ADDRESS &&
+                directory_.internal_at(port, hdr.destination) == CFDirectory::NONE)
+                return;
 
             // Route transport protocol frames
             if (pgn == PGN_TP_CM || pgn == PGN_TP_DT) {
-                auto responses = tp_.process_frame(frame, port);
-                send_frames_best_effort(responses, port);
+                rx_frames_.clear();
+                tp_.process_frame(frame, hdr, port, rx_frames_);
+                send_frames_best_effort(rx_frames_, port);
                 return;
             }
 
             if (pgn == PGN_ETP_CM || pgn == PGN_ETP_DT) {
-                auto responses = etp_.process_frame(frame, port);
-                send_frames_best_effort(responses, port);
+                rx_frames_.clear();
+                etp_.process_frame(frame, hdr, port, rx_frames_);
+                send_frames_best_effort(rx_frames_, port);
                 return;
             }
 
             // Check if this is a fast packet PGN
             if (is_fast_packet_pgn(pgn)) {
-                auto msg = fast_packet_.process_frame(frame);
-                if (msg.has_value()) {
-                    dispatch_message(msg.value());
+                auto view = fast_packet_.process_frame_view(frame, hdr, port);
+                if (view.has_value()) {
+                    dispatch_view(view.value());
                 }
                 return;
             }
 
-            // Convert single-frame to message and dispatch
-            Message msg;
-            msg.pgn = pgn;
-            msg.source = frame.source();
-            msg.destination = frame.destination();
-            msg.priority = frame.priority();
-            msg.timestamp_us = frame.timestamp_us;
-            msg.data.assign(frame.data.begin(), frame.data.begin() + frame.length);
-
-            dispatch_message(msg);
+            // Single frame: dispatch a view straight over the frame payload
+            dispatch_view(MessageView(pgn, DataSpan(frame.data.data(), frame.length), hdr.source, hdr.destination,
+                                      hdr.priority, frame.timestamp_us));
         }
 
         void handle_transport_complete(TransportSession &session) {
             if (session.direction != TransportDirection::Receive) {
-                return; // Only dispatch received messages
+                awaits_->transfer_done(session, Error{}); // Ours went out: wake the sender
+                if (latency_)
+                    tx_session_done(session);
+                return;
+            }
+            if (session.streaming) {
+                return; // Payload already went out through ETP on_chunk
+            }
+
+            AGROBUS_TRACE_DEBUG(TraceEvent::TransportComplete, session.pgn, session.data.size(),
+                                session.source_address);
+
+            ProfileScope profile(update_profiler_, profile_dispatch_);
+            u64 start_ns = latency_ ? latency_->now_ns() : 0;
+            MessageView view(session.pgn, DataSpan(session.data), session.source_address,
+                             session.destination_address, session.priority, session.last_timestamp_us);
+            view.first_timestamp_us = session.first_timestamp_us;
+            if (recorder_)
+                watch_lamps(view); // DM1 with more than one DTC
+            if (route_static(view)) {
+                share(view, std::move(session.data));
+                if (latency_)
+                    dispatched(session.pgn, session.last_timestamp_us, start_ns);
+                return;
+            }
+            view_dispatch_.dispatch(view);
+            if (awaits_->wants_messages())
+                awaits_->offer(view);
+
+            if (!has_listener(session.pgn)) {
+                share(view, std::move(session.data));
+                if (latency_)
+                    dispatched(session.pgn, session.last_timestamp_us, start_ns);
+                return;
             }
 
             Message msg;
@@ -414,11 +1985,13 @@ namespace agrobus::net {
             msg.source = session.source_address;
             msg.destination = session.destination_address;
             msg.priority = session.priority;
+            msg.timestamp_us = session.last_timestamp_us;
+            msg.first_timestamp_us = session.first_timestamp_us;
             msg.data = std::move(session.data);
-
-            echo::category("isobus.network").debug("Transport complete: pgn=", msg.pgn, " bytes=", msg.data.size());
-
-            dispatch_message(msg);
+            dispatch_owned(msg);
+            share(view, msg.data.take());
+            if (latency_)
+                dispatched(msg.pgn, msg.timestamp_us, start_ns);
         }
 
         // Send transport-generated frames, routing to the correct port
@@ -431,34 +2004,103 @@ namespace agrobus::net {
 
         // Find the port for a given source address (from our internal CFs)
         u8 port_for_address(Address addr) const {
-            for (const auto &icf : internal_cfs_) {
-                if (icf.address() == addr) {
-                    return icf.port();
-                }
-            }
-            return 0;
+            auto port = directory_.internal_port(addr);
+            return port ? *port : 0;
         }
 
-        void check_address_violation(const Frame &frame, u8 port) {
-            Address src = frame.source();
-            if (src == NULL_ADDRESS || src == BROADCAST_ADDRESS)
+        // Runs for every received frame: one table index decides
+        void check_address_violation(Address src, u8 port) {
+            u16 i = directory_.internal_at(port, src);
+            if (i == CFDirectory::NONE || internal_cfs_.at(i)->claim_state() != ClaimState::Claimed)
                 return;
 
-            for (usize i = 0; i < internal_cfs_.size(); ++i) {
-                if (internal_cfs_[i].port() == port && internal_cfs_[i].claim_state() == ClaimState::Claimed &&
-                    internal_cfs_[i].address() == src) {
-                    // Another device is using our claimed address - re-assert
-                    echo::category("isobus.network").warn("address violation detected: SA=", src);
-                    auto frames = claimers_[i].handle_request_for_claim();
-                    for (const auto &f : frames) {
-                        send_frame(f, port);
-                    }
-                    on_address_violation.emit(src);
-                    return;
-                }
+            // Another device is using our claimed address - re-assert
+            echo::category("isobus.network").warn("address violation detected: SA=", src);
+            rx_frames_.clear();
+            claimers_[i]->handle_request_for_claim(rx_frames_);
+            for (const auto &f : rx_frames_) {
+                send_frame(f, port);
+            }
+            on_address_violation.emit(src);
+            if (recorder_)
+                recorder_->freeze(FlightTrigger::AddressViolation, src);
+        }
+
+        void sync_directory(u32 i) {
+            const InternalCF &icf = *internal_cfs_.at(i);
+            directory_.sync_internal(static_cast<u16>(i), icf.port(), icf.address(), icf.preferred_address(),
+                                     icf.name());
+        }
+
+        void sync_directory() {
+            for (auto it = internal_cfs_.begin(); it != internal_cfs_.end(); ++it)
+                sync_directory(it.index());
+        }
+
+        // Every internal CF on `port` answers a global request; only the addressed
+        // one answers a destination-specific request
+        void answer_claim_request(Address dest, u8 port) {
+            for (auto it = internal_cfs_.begin(); it != internal_cfs_.end(); ++it) {
+                if (it->port() != port || !claimers_[it.index()])
+                    continue;
+                if (dest != BROADCAST_ADDRESS && it->address() != dest)
+                    continue;
+                rx_frames_.clear();
+                claimers_[it.index()]->handle_request_for_claim(rx_frames_);
+                for (const auto &f : rx_frames_)
+                    send_frame(f, port);
+                record_claims(*it, rx_frames_);
+            }
+        }
+
+        // Let internal CF `i` contest a claim; it may move to another address
+        void contest_claim(u16 i, Address claimed_addr, Name claimed_name, u8 port) {
+            rx_frames_.clear();
+            claimers_[i]->handle_claim(claimed_addr, claimed_name, rx_frames_);
+            for (const auto &f : rx_frames_) {
+                send_frame(f, port);
+            }
+            const InternalCF &icf = *internal_cfs_.at(i);
+            if (rx_frames_.empty())
+                names_->release(icf.port(), icf.name()); // Yielded, re-claims after RTxD
+            record_claims(icf, rx_frames_);
+            sync_directory(i);
+        }
+
+        // Our own claims are not looped back: mirror them into the NAME table
+        void record_claims(const InternalCF &icf, const dp::Vector<Frame> &frames) {
+            for (const auto &f : frames) {
+                if (f.pgn() == PGN_ADDRESS_CLAIMED)
+                    names_->claim(icf.port(), icf.name(), f.source(), rx_time_us());
             }
         }
 
+        // A power-up burst brings tens of claims per batch. The NAME table takes
+        // the whole batch first, so a CF that loses a contest moves to an address
+        // nobody in the burst claimed; then contests and partner matching run
+        // claim by claim and on_names_changed fires once per port.
+        void process_claims() {
+            if (pending_claims_.empty())
+                return;
+            claim_batch_.swap(pending_claims_); // Callbacks may poll again
+            for (const auto &c : claim_batch_)
+                names_->claim(c.port, Name::from_bytes(c.frame.data.data()), c.frame.source(), c.frame.timestamp_us);
+            for (const auto &c : claim_batch_)
+                handle_address_claim(c.frame, c.port);
+
+            dp::Vector<u8> ports;
+            for (const auto &c : claim_batch_) {
+                bool seen = false;
+                for (u8 p : ports)
+                    seen = seen || p == c.port;
+                if (!seen)
+                    ports.push_back(c.port);
+            }
+            claim_batch_.clear();
+            for (u8 p : ports)
+                on_names_changed.emit(p);
+        }
+
         void handle_address_claim(const Frame &frame, u8 port) {
             Name claimed_name = Name::from_bytes(frame.data.data());
             Address claimed_addr = frame.source();
@@ -466,61 +2108,553 @@ namespace agrobus::net {
             echo::category("isobus.network.claim")
                 .debug("Address claim received: addr=", claimed_addr, " name=", claimed_name.raw);
 
-            // Notify our address claimers
-            for (usize i = 0; i < claimers_.size(); ++i) {
-                if (internal_cfs_[i].port() == port) {
-                    auto frames = claimers_[i].handle_claim(claimed_addr, claimed_name);
-                    for (const auto &f : frames) {
-                        send_frame(f, port);
-                    }
-                }
+            // Notify the claimers holding or preferring the claimed address
+            if (claimed_addr <= MAX_ADDRESS) {
+                CFDirectory::Slot slot = directory_.at(port, claimed_addr);
+                if (slot.internal != CFDirectory::NONE)
+                    contest_claim(slot.internal, claimed_addr, claimed_name, port);
+                if (slot.preferred != CFDirectory::NONE && slot.preferred != slot.internal)
+                    contest_claim(slot.preferred, claimed_addr, claimed_name, port);
             }
 
-            // Check partner matching
-            for (auto &partner : partner_cfs_) {
-                if (partner.port() == port && partner.matches_name(claimed_name)) {
-                    partner.set_name(claimed_name);
-                    partner.set_address(claimed_addr);
-                    partner.set_state(CFState::Online);
-                    partner.on_partner_found.emit(claimed_addr);
-                    on_cf_state_change.emit(&partner.cf(), CFState::Online);
-                }
+            // Partners come from the matcher index once per NAME; later claims reuse it
+            const dp::Vector<u16> *known = directory_.partner_matches(port, claimed_name);
+            dp::Vector<u16> matched;
+            if (known) {
+                matched = *known;
+            } else {
+                matched = directory_.match_partners(port, claimed_name);
+                directory_.remember_matches(port, claimed_name, matched);
+            }
+
+            for (u16 i : matched) {
+                auto *found = partner_cfs_.at(i);
+                if (!found)
+                    continue; // Removed by an earlier callback
+                auto &partner = *found;
+                partner.set_name(claimed_name);
+                partner.set_address(claimed_addr);
+                partner.set_state(CFState::Online);
+                directory_.place_partner(i, port, claimed_addr, claimed_name);
+                partner.on_partner_found.emit(claimed_addr);
+                on_cf_state_change.emit(&partner.cf(), CFState::Online);
             }
         }
 
+        // True if an owning-Message consumer exists for this PGN
+        bool has_listener(PGN pgn) { return on_message.count() > 0 || pgn_dispatch_.has_handlers(pgn); }
+
         void dispatch_message(const Message &msg) {
-            on_message.emit(msg);
+            ProfileScope profile(update_profiler_, profile_dispatch_);
+            if (latency_) {
+                u64 start_ns = latency_->now_ns();
+                deliver_message(msg);
+                dispatched(msg.pgn, msg.timestamp_us, start_ns);
+                return;
+            }
+            deliver_message(msg);
+        }
+
+        void deliver_message(const Message &msg) {
+            MessageView view(msg);
+            remember(view);
+            if (!route_static(view)) {
+                dispatch_owned(msg);
+                view_dispatch_.dispatch(view);
+                if (awaits_->wants_messages())
+                    awaits_->offer(view);
+            }
+            share(view);
+        }
+
+        // Zero-copy path: view callbacks first, then materialize a Message only if
+        // someone needs one (unhandled PGNs exit here without allocating).
+        void dispatch_view(const MessageView &view) {
+            ProfileScope profile(update_profiler_, profile_dispatch_);
+            if (recorder_)
+                watch_lamps(view);
+            if (latency_) {
+                u64 start_ns = latency_->now_ns();
+                deliver_view(view);
+                dispatched(view.pgn, view.timestamp_us, start_ns);
+                return;
+            }
+            deliver_view(view);
+        }
+
+        void deliver_view(const MessageView &view) {
+            remember(view);
+            if (!route_static(view)) {
+                view_dispatch_.dispatch(view);
+                if (awaits_->wants_messages())
+                    awaits_->offer(view);
+                if (has_listener(view.pgn))
+                    dispatch_owned(view.to_message());
+            }
+            share(view);
+        }
+
+        // on_shared_message: `bytes` (the view's own) adopted, or back to the pool
+        void share(const MessageView &view, dp::Vector<u8> &&bytes) {
+            if (on_shared_message.count() == 0) {
+                buffer_pool_->release(std::move(bytes));
+                return;
+            }
+            on_shared_message.emit(SharedMessage(view, adopt_payload(std::move(bytes), buffer_returns_)));
+        }
+
+        // on_shared_message with the view's bytes copied once
+        void share(const MessageView &view) {
+            if (on_shared_message.count() > 0)
+                on_shared_message.emit(
+                    SharedMessage(view, copy_payload(view.data, *buffer_pool_, buffer_returns_)));
+        }
+
+        // The static router's share of delivery; true if it owned the PGN
+        bool route_static(const MessageView &view) {
+            if (!static_dispatch_ || !static_dispatch_(view))
+                return false;
+            if (awaits_->wants_messages())
+                awaits_->offer(view);
+            if (on_message.count() > 0)
+                on_message.emit(view.to_message());
+            return true;
+        }
+
+        // ─── Latency samples ─────────────────────────────────────────────────────
+        // A message's callbacks finished: handler time, and the time since its
+        // (last) frame was received when it carries an RX timestamp
+        void dispatched(PGN pgn, u64 rx_us, u64 start_ns) {
+            latency_->record(LatencyKind::Handler, pgn, latency_->now_ns() - start_ns);
+            if (rx_us > 0) {
+                u64 now_us = rx_time_us();
+                latency_->record(LatencyKind::Receive, pgn, now_us > rx_us ? (now_us - rx_us) * 1000 : 0);
+            }
+        }
 
-            auto it = pgn_callbacks_.find(msg.pgn);
-            if (it != pgn_callbacks_.end()) {
-                for (auto &cb : it->second) {
-                    cb(msg);
+        static constexpr u64 session_key(PGN pgn, Address src, Address dst) noexcept {
+            return static_cast<u64>(pgn) << 16 | static_cast<u64>(src) << 8 | dst;
+        }
+
+        static constexpr u64 session_key(const TransportSession &session) noexcept {
+            return session_key(session.pgn, session.source_address, session.destination_address);
+        }
+
+        Result<void> enqueue(SubmittedSend &&s) {
+            if (!submits_)
+                return Result<void>::err(Error::invalid_state("submit queue not configured"));
+            if (!submits_->try_push(std::move(s)))
+                return Result<void>::err(Error::buffer_overflow());
+            if (wake_fd_.fd >= 0) {
+                u64 one = 1;
+                (void)!::write(wake_fd_.fd, &one, sizeof(one));
+            }
+            return {};
+        }
+
+        // At most one queue's worth per update, so busy producers cannot hold it
+        void drain_submits() {
+            SubmittedSend s;
+            for (usize n = submits_->capacity(); n > 0 && submits_->try_pop(s); --n) {
+                if (s.done) {
+                    (void)complete_submit(std::move(s)); // Detached until the transfer ends
+                    continue;
                 }
+                ControlFunction to;
+                to.address = s.destination;
+                auto sent = send(s.pgn, s.data, s.source, &to, s.priority);
+                if (!sent.is_ok())
+                    echo::category("isobus.network")
+                        .warn("submitted PGN ", s.pgn, " not sent: ", sent.error().message);
+            }
+        }
+
+        // send_and_wait() with the transfer wait listed in submit_waits_ while
+        // it is suspended, so ~IsoNet can end it
+        Task<Result<void>> complete_submit(SubmittedSend s) {
+            if (!s.source || !s.source->cf().address_valid()) {
+                auto refused = Result<void>::err(Error::not_connected());
+                s.done->set_value(refused);
+                co_return refused;
+            }
+            ControlFunction to;
+            to.address = s.destination;
+            TransferAwait done(*awaits_, s.pgn, s.source->address(), s.destination, s.source->port(),
+                               config_.submit_timeout_ms);
+            auto result = send(s.pgn, s.data, s.source, &to, s.priority);
+            if (result.is_ok() && !sent_without_session(s.pgn, s.data.size(), s.source->port(), s.destination)) {
+                submit_waits_.push_back(&done);
+                result = co_await done;
+                for (usize i = 0; i < submit_waits_.size(); ++i) {
+                    if (submit_waits_[i] == &done) {
+                        submit_waits_[i] = submit_waits_.back();
+                        submit_waits_.pop_back();
+                        break;
+                    }
+                }
+            }
+            s.done->set_value(result);
+            co_return result;
+        }
+
+        // The other end of a session
+        static constexpr Address remote_of(const TransportSession &session) noexcept {
+            return session.direction == TransportDirection::Receive ? session.source_address
+                                                                    : session.destination_address;
+        }
+
+        void watch_lamps(const MessageView &view) {
+            if (view.pgn == PGN_DM1 && !view.data.empty())
+                recorder_->lamps(view.source, view.data.get_u8(0));
+        }
+
+        void mark_tx(const Frame &last, u8 port) {
+            if (tx_mark_count_ == MAX_TX_MARKS) {
+                tx_mark_head_ = (tx_mark_head_ + 1) % MAX_TX_MARKS; // Forget the oldest
+                --tx_mark_count_;
+                drop_dead_marks();
+            }
+            tx_marks_[(tx_mark_head_ + tx_mark_count_) % MAX_TX_MARKS] =
+                TxMark{port, true, last.id.raw, last.data, latency_->now_ns()};
+            ++tx_mark_count_;
+        }
+
+        void drop_dead_marks() {
+            while (tx_mark_count_ > 0 && !tx_marks_[tx_mark_head_].live) {
+                tx_mark_head_ = (tx_mark_head_ + 1) % MAX_TX_MARKS;
+                --tx_mark_count_;
+            }
+        }
+
+        void mark_tx_session(PGN pgn, Address src, Address dst) {
+            if (latency_)
+                tx_session_marks_[session_key(pgn, src, dst)] = latency_->now_ns();
+        }
+
+        // A frame reached the endpoint: closes the oldest send() it was the last frame of
+        void tx_accepted(const Frame &frame, u8 port) {
+            for (usize i = 0; i < tx_mark_count_; ++i) {
+                TxMark &m = tx_marks_[(tx_mark_head_ + i) % MAX_TX_MARKS];
+                if (!m.live || m.port != port || m.id != frame.id.raw || m.data != frame.data)
+                    continue;
+                latency_->record(LatencyKind::Send, frame.pgn(), latency_->now_ns() - m.start_ns);
+                m.live = false;
+                drop_dead_marks();
+                return;
             }
         }
 
+        void tx_session_done(const TransportSession &session) {
+            auto it = tx_session_marks_.find(session_key(session));
+            if (it == tx_session_marks_.end())
+                return;
+            latency_->record(LatencyKind::Send, session.pgn, latency_->now_ns() - it->second);
+            tx_session_marks_.erase(it);
+        }
+
+        // Feed the last-value cache before any callback sees the message
+        void remember(const MessageView &view) {
+            if (!last_values_->empty_tracking() && last_values_->tracked(view.pgn))
+                last_values_->store(view.pgn, view.source, view.data, view.timestamp_us);
+        }
+
+        void dispatch_owned(const Message &msg) {
+            on_message.emit(msg);
+            pgn_dispatch_.dispatch(msg);
+        }
+
         // ─── Frame conversion helpers ─────────────────────────────────────────────
+        // Frame starts with the can_frame layout: conversion is one 16-byte copy
+        static_assert(std::is_trivially_copyable_v<Frame>);
+        static_assert(offsetof(Frame, id) == offsetof(can_frame, can_id));
+        static_assert(offsetof(Frame, length) == offsetof(can_frame, can_dlc));
+        static_assert(offsetof(Frame, data) == offsetof(can_frame, data));
+        static_assert(sizeof(can_frame) == 16 && sizeof(Frame) >= sizeof(can_frame));
+
         static can_frame to_can_frame(const Frame &frame) {
-            can_frame cf = {};
-            cf.can_id = frame.id.raw | CAN_EFF_FLAG;
-            cf.can_dlc = frame.length;
-            for (u8 i = 0; i < frame.length && i < 8; ++i) {
-                cf.data[i] = frame.data[i];
-            }
+            can_frame cf;
+            std::memcpy(&cf, &frame, sizeof(can_frame));
+            cf.can_id |= CAN_EFF_FLAG;
             return cf;
         }
 
-        static Frame from_can_frame(const can_frame &cf) {
-            Frame frame;
-            frame.id = Identifier(cf.can_id & CAN_EFF_MASK);
-            frame.length = cf.can_dlc > 8 ? 8 : cf.can_dlc;
-            for (u8 i = 0; i < frame.length; ++i) {
-                frame.data[i] = cf.data[i];
+        // FdFrame starts with the canfd_frame layout in the same way
+        static_assert(std::is_trivially_copyable_v<FdFrame>);
+        static_assert(offsetof(FdFrame, length) == offsetof(canfd_frame, len));
+        static_assert(offsetof(FdFrame, flags) == offsetof(canfd_frame, flags));
+        static_assert(offsetof(FdFrame, data) == offsetof(canfd_frame, data));
+        static_assert(sizeof(canfd_frame) == 72 && sizeof(FdFrame) >= sizeof(canfd_frame));
+
+        static canfd_frame to_canfd_frame(const FdFrame &frame) {
+            canfd_frame cf;
+            std::memcpy(&cf, &frame, sizeof(canfd_frame));
+            cf.can_id |= CAN_EFF_FLAG;
+            return cf;
+        }
+
+        // Classic frame for an FD-only port: the can_frame prefix, no FD flags
+        static canfd_frame to_canfd_frame(const Frame &frame) {
+            canfd_frame cf{};
+            std::memcpy(&cf, &frame, sizeof(can_frame));
+            cf.can_id |= CAN_EFF_FLAG;
+            cf.flags = 0;
+            return cf;
+        }
+
+        // Drain every FD port's source. Frames of up to 8 bytes take the
+        // classic path (TP, claims, fast packet); longer ones are single-frame
+        // messages and are dispatched as a view over the FD payload; multi-PG
+        // frames are unpacked into their contained PGs.
+        void poll_fd_ports() {
+            for (auto &[port, fd] : fd_ports_) {
+                if (!fd.rx)
+                    continue;
+                BusLoad *bl = config_.enable_bus_load ? &port_load(port) : nullptr;
+                canfd_frame cf;
+                usize count = 0;
+                while (fd.rx(cf)) {
+                    if (cf.can_id & CAN_ERR_FLAG) {
+                        handle_can_error(port, cf.can_id & CAN_ERR_MASK, cf.data, rx_time_us());
+                        continue;
+                    }
+                    if (!bus_off_ports_.empty() && bus_off(port))
+                        restarted(port, rx_time_us());
+                    FdFrame f;
+                    std::memcpy(&f, &cf, sizeof(canfd_frame));
+                    f.id.raw &= CAN_EFF_MASK;
+                    if (f.length > CAN_FD_DATA_LENGTH)
+                        f.length = CAN_FD_DATA_LENGTH;
+                    f.timestamp_us = rx_time_us();
+                    bool classic = f.fits_classic() && (f.flags & CAN_FD_FLAG_BRS) == 0;
+                    if (bl) {
+                        if (classic)
+                            bl->add_frame(f.to_classic());
+                        else
+                            bl->add_frame(f);
+                    }
+                    if (f.pgn() == PGN_MULTI_PG) {
+                        receive_multi_pg(f, port);
+                    } else if (f.fits_classic()) {
+                        Frame frame = f.to_classic();
+                        if (frame.length < 8)
+                            std::memset(frame.data.data() + frame.length, 0xFF, 8 - frame.length);
+                        if (on_frame_received.count() > 0)
+                            on_frame_received.emit(frame, port);
+                        process_frame(frame, port);
+                    } else {
+                        AGROBUS_TRACE(TraceEvent::FrameRx, port, f.id.raw, f.length);
+                        const FrameHeader hdr = f.header();
+                        check_address_violation(hdr.source, port);
+                        dispatch_view(MessageView(hdr.pgn, DataSpan(f.data.data(), f.length), hdr.source,
+                                                  hdr.destination, hdr.priority, f.timestamp_us));
+                    }
+                    // Claims are handled per batch, as on the endpoint path
+                    if (++count == rx_batch_.size()) {
+                        process_claims();
+                        count = 0;
+                    }
+                }
+                process_claims();
+            }
+        }
+
+        // Each C-PG is dispatched as if it had its own frame: the multi-PG
+        // frame's source, priority and timestamp, its destination for PDU1 PGNs
+        void receive_multi_pg(const FdFrame &f, u8 port) {
+            const FrameHeader hdr = f.header();
+            AGROBUS_TRACE(TraceEvent::FrameRx, port, f.id.raw, f.length);
+            check_address_violation(hdr.source, port);
+            multi_pg::decode(f.data.data(), f.length, [&](const ContainedPG &pg) {
+                if (pg.service != MULTI_PG_TOS_STANDARD || pg.trailer != MULTI_PG_TF_NONE)
+                    return; // Assurance data and trailers are not supported
+                bool pdu1 = ((pg.pgn >> 8) & 0xFF) < 0xF0;
+                PGN pgn = pdu1 ? (pg.pgn & 0x3FF00) : pg.pgn;
+                Address dst = pdu1 ? hdr.destination : BROADCAST_ADDRESS;
+                dispatch_view(MessageView(pgn, pg.data, hdr.source, dst, hdr.priority, f.timestamp_us));
+            });
+        }
+
+        // Decode in place (used by the batch receive path to fill reusable slots;
+        // the caller stamps timestamp_us). Bytes past a short DLC read as 0xFF.
+        // Error frames keep CAN_ERR_FLAG so the receive paths can set them apart.
+        static void decode_can_frame(const can_frame &cf, Frame &frame) noexcept {
+            std::memcpy(&frame, &cf, sizeof(can_frame));
+            frame.id.raw &= (cf.can_id & CAN_ERR_FLAG) ? (CAN_ERR_FLAG | CAN_ERR_MASK) : CAN_EFF_MASK;
+            if (frame.length < 8)
+                std::memset(frame.data.data() + frame.length, 0xFF, 8 - frame.length);
+            else
+                frame.length = 8;
+        }
+
+        // Pull up to rx_batch_.size() frames from an endpoint or RxSource
+        // (`pull(cf)` false = nothing more). Returns the count; error frames are
+        // counted for the port and left out.
+        template <typename Pull> usize receive_batch(Pull &&pull, u8 port) {
+            usize count = 0;
+            can_frame cf;
+            while (count < rx_batch_.size()) {
+                if (!pull(cf))
+                    break;
+                Frame &frame = rx_batch_[count];
+                decode_can_frame(cf, frame);
+                frame.timestamp_us = rx_time_us();
+                if (cf.can_id & CAN_ERR_FLAG)
+                    handle_can_error(port, cf.can_id & CAN_ERR_MASK, frame.data.data(), frame.timestamp_us);
+                else
+                    ++count;
+            }
+            return count;
+        }
+
+        // ─── Bus-off handling ────────────────────────────────────────────────────
+        void handle_can_error(u8 port, u32 can_id, const u8 *data, u64 now_us) {
+            CanErrorStats &stats = can_errors_[port];
+            if (can_errors::apply(stats, can_id, data, now_us))
+                bus_state_changed(port, stats.state);
+        }
+
+        void restarted(u8 port, u64 now_us) {
+            if (can_errors::set_state(can_errors_[port], CanBusState::ErrorActive, now_us))
+                bus_state_changed(port, CanBusState::ErrorActive);
+        }
+
+        void bus_state_changed(u8 port, CanBusState state) {
+            bool off = state == CanBusState::BusOff;
+            if (off && !bus_off(port)) {
+                echo::category("isobus.network").warn("bus-off on port ", port);
+                bus_off_ports_.push_back(BusOffPort{port, 0});
+                tx_port(port); // So apply_tx_backpressure() keeps the port paused
+                tp_.pause_port(port, true);
+                etp_.pause_port(port, true);
+                tp_.hold_port(port, true);
+                etp_.hold_port(port, true);
+            } else if (!off && bus_off(port)) {
+                echo::category("isobus.network").info("port ", port, " back from bus-off");
+                for (usize i = 0; i < bus_off_ports_.size(); ++i) {
+                    if (bus_off_ports_[i].port == port) {
+                        bus_off_ports_.erase(bus_off_ports_.begin() + static_cast<std::ptrdiff_t>(i));
+                        break;
+                    }
+                }
+                tp_.hold_port(port, false);
+                etp_.hold_port(port, false);
+                tp_.pause_port(port, false);
+                etp_.pause_port(port, false);
+                apply_tx_backpressure();
+                reannounce_claims(port);
+            }
+            on_bus_state.emit(port, state);
+        }
+
+        // Sessions held past bus_off_hold_ms run their timeouts again, so a bus
+        // that stays down ends them the usual way
+        void hold_bus_off(u32 elapsed_ms) {
+            for (auto &b : bus_off_ports_) {
+                if (b.held_ms >= config_.bus_off_hold_ms)
+                    continue;
+                b.held_ms += elapsed_ms;
+                if (b.held_ms >= config_.bus_off_hold_ms) {
+                    tp_.hold_port(b.port, false);
+                    etp_.hold_port(b.port, false);
+                }
             }
-            for (u8 i = frame.length; i < 8; ++i) {
-                frame.data[i] = 0xFF;
+        }
+
+        // Others may have claimed our addresses while we were off the bus
+        void reannounce_claims(u8 port) {
+            for (auto it = internal_cfs_.begin(); it != internal_cfs_.end(); ++it) {
+                if (it->port() != port || it->claim_state() != ClaimState::Claimed || !claimers_[it.index()])
+                    continue;
+                rx_frames_.clear();
+                claimers_[it.index()]->handle_request_for_claim(rx_frames_);
+                for (const auto &f : rx_frames_)
+                    send_frame(f, port);
+                record_claims(*it, rx_frames_);
+            }
+        }
+
+        // Re-announce filter sets whose inputs changed since the last update
+        void refresh_can_filters() {
+            bool catch_all = on_message.count() > 0;
+            bool changed = can_filters_dirty_ || catch_all != filter_catch_all_ ||
+                           filter_addresses_.size() != internal_cfs_.size();
+            usize n = 0;
+            for (auto it = internal_cfs_.begin(); !changed && it != internal_cfs_.end(); ++it)
+                changed = filter_addresses_[n++] != it->address();
+            if (!changed)
+                return;
+
+            can_filters_dirty_ = false;
+            filter_catch_all_ = catch_all;
+            filter_addresses_.clear();
+            for (const auto &icf : internal_cfs_)
+                filter_addresses_.push_back(icf.address());
+
+            for (auto &[port, ep] : endpoints_) {
+                auto filters = can_filters(port);
+                auto &reported = can_filters_reported_[port];
+                if (same_can_filters(reported, filters) && !reported.empty())
+                    continue;
+                reported = filters;
+                echo::category("isobus.network").debug("CAN filters updated on port ", port, ": ", filters.size());
+                on_can_filters_changed.emit(port, reported);
+            }
+        }
+
+        // Pull up to rx_batch_.size() frames from a reader thread's ring
+        usize drain_ring(SpscRing<Frame> &ring, u8 port) {
+            usize count = 0;
+            while (count < rx_batch_.size() && ring.try_pop(rx_batch_[count])) {
+                Frame &frame = rx_batch_[count];
+                if (frame.id.raw & CAN_ERR_FLAG)
+                    handle_can_error(port, frame.id.raw & CAN_ERR_MASK, frame.data.data(), frame.timestamp_us);
+                else
+                    ++count;
+            }
+            return count;
+        }
+
+        void start_rx_worker(u8 port, wirebit::CanEndpoint *ep) {
+            if (!config_.rx_thread)
+                return;
+            if (wake_fd_.fd < 0)
+                wake_fd_.fd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+            std::function<u64()> clock = rx_clock_ ? rx_clock_ : std::function<u64()>(&IsoNet::host_time_us);
+            auto worker = std::make_unique<RxWorker>(ep, config_.rx_ring_frames, std::move(clock),
+                                                     config_.rx_thread_idle_us, wake_fd_.fd);
+            RxWorker *w = worker.get();
+            w->thread = std::thread([w]() { rx_thread_main(*w); });
+            rx_workers_[port] = std::move(worker);
+            echo::category("isobus.network").debug("rx thread started on port ", port);
+        }
+
+        void stop_rx_worker(u8 port) {
+            auto it = rx_workers_.find(port);
+            if (it == rx_workers_.end())
+                return;
+            rx_workers_.erase(it);
+        }
+
+        static void rx_thread_main(RxWorker &w) {
+            can_frame cf;
+            Frame frame;
+            bool pushed = false;
+            while (w.running.load(std::memory_order_acquire)) {
+                auto result = w.ep->recv_can(cf);
+                if (!result.is_ok()) {
+                    // End of burst: wake a waiting update loop once
+                    if (pushed && w.notify_fd >= 0) {
+                        u64 one = 1;
+                        (void)!::write(w.notify_fd, &one, sizeof(one));
+                    }
+                    pushed = false;
+                    std::this_thread::sleep_for(std::chrono::microseconds(w.idle_us));
+                    continue;
+                }
+                decode_can_frame(cf, frame);
+                frame.timestamp_us = w.clock();
+                pushed |= w.ring.try_push(frame);
             }
-            return frame;
         }
     };
 } // namespace agrobus::net
@@ -7,32 +7,18 @@
 #include <agrobus/net/identifier.hpp>
 #include <agrobus/net/message.hpp>
 #include <agrobus/net/network_manager.hpp>
+#include <agrobus/net/niu_filter.hpp>
 #include <agrobus/net/state_machine.hpp>
+#include <agrobus/net/tp.hpp>
 #include <agrobus/net/types.hpp>
 #include <datapod/datapod.hpp>
 #include <echo/echo.hpp>
 
 namespace agrobus::net {
 
-    // ─── Forward policy ──────────────────────────────────────────────────────────
-    enum class ForwardPolicy : u8 {
-        Allow,  // Forward this PGN
-        Block,  // Block this PGN
-        Monitor // Forward but also emit event
-    };
-
-    // ─── Filter rule ─────────────────────────────────────────────────────────────
-    struct FilterRule {
-        PGN pgn;
-        ForwardPolicy policy = ForwardPolicy::Allow;
-        bool bidirectional = true; // applies both directions if true
-    };
-
     // ─── NIU state ───────────────────────────────────────────────────────────────
     enum class NIUState : u8 { Inactive, Active, Error };
-
-    // ─── Side identifier ─────────────────────────────────────────────────────────
-    enum class Side : u8 { Tractor, Implement };
+    constexpr usize state_count(NIUState) { return static_cast<usize>(NIUState::Error) + 1; }
 
     // ─── NIU Network Message Function Codes (ISO 11783-4, Section 6.5) ──────────
     enum class NIUFunction : u8 {
@@ -94,7 +80,7 @@ namespace agrobus::net {
             return data;
         }
 
-        static NIUNetworkMsg decode(const dp::Vector<u8> &data) {
+        static NIUNetworkMsg decode(DataSpan data) {
             NIUNetworkMsg msg;
             if (data.size() < 2)
                 return msg;
@@ -133,6 +119,10 @@ namespace agrobus::net {
         dp::String name = "NIU";
         bool forward_global_by_default = true;   // forward broadcast PGNs not in filter
         bool forward_specific_by_default = true; // forward destination-specific PGNs not in filter
+        bool frame_events = true;                // per-frame on_forwarded/on_blocked/on_monitored
+        bool cut_through = false;                // bridge straight from the networks' RX path
+        bool store_and_forward = false;          // relay TP sessions instead of their frames
+        bool learn_addresses = false;            // keep unicast on the side its destination lives on
 
         NIUConfig &set_name(dp::String n) {
             name = std::move(n);
@@ -146,6 +136,24 @@ namespace agrobus::net {
             forward_specific_by_default = allow;
             return *this;
         }
+        // Off for a pure router at line rate: only the counters are kept, and
+        // Monitor rules forward like Allow
+        NIUConfig &events(bool enable) {
+            frame_events = enable;
+            return *this;
+        }
+        NIUConfig &cut_through_mode(bool enable) {
+            cut_through = enable;
+            return *this;
+        }
+        NIUConfig &transport_mode(bool store_forward) {
+            store_and_forward = store_forward;
+            return *this;
+        }
+        NIUConfig &address_learning(bool enable) {
+            learn_addresses = enable;
+            return *this;
+        }
     };
 
     // ─── Network Interconnect Unit (ISO 11783-4) ─────────────────────────────────
@@ -154,20 +162,44 @@ namespace agrobus::net {
         IsoNet *tractor_net_ = nullptr;
         IsoNet *implement_net_ = nullptr;
         dp::Vector<FilterRule> filters_;
+        NIUFilterTable table_;
+        bool table_dirty_ = true; // filters_ changed since the last compile
         NIUConfig config_;
         StateMachine<NIUState> state_{NIUState::Inactive};
         u32 forwarded_count_ = 0;
         u32 blocked_count_ = 0;
+        u32 kept_local_count_ = 0;
+        ListenerToken tractor_tap_ = INVALID_TOKEN;
+        ListenerToken implement_tap_ = INVALID_TOKEN;
+
+        // Store-and-forward: one transport endpoint per side (see bridge_transport)
+        TransportProtocol tractor_tp_;
+        TransportProtocol implement_tp_;
+
+        // Address learning: which side each source address was last seen on
+        // (0 = not seen, else 1 + Side), like a switch's MAC table
+        dp::Array<u8, 256> learned_ = {};
 
       public:
-        explicit NIU(NIUConfig config = {}) : config_(std::move(config)) {}
+        explicit NIU(NIUConfig config = {}) : config_(std::move(config)) {
+            tractor_tp_.on_complete.subscribe([this](TransportSession &s) { relay(s, Side::Tractor); });
+            implement_tp_.on_complete.subscribe([this](TransportSession &s) { relay(s, Side::Implement); });
+        }
+        ~NIU() { remove_taps(); }
+
+        // The RX taps of cut-through mode point back here
+        NIU(const NIU &) = delete;
+        NIU &operator=(const NIU &) = delete;
 
         // ─── Attach networks ─────────────────────────────────────────────────────
         Result<void> attach_tractor(IsoNet *net) {
             if (!net) {
                 return Result<void>::err(Error::invalid_state("null tractor network"));
             }
+            remove_taps();
             tractor_net_ = net;
+            if (state_.is(NIUState::Active))
+                install_taps();
             echo::category("isobus.niu").debug("tractor network attached");
             return {};
         }
@@ -176,7 +208,10 @@ namespace agrobus::net {
             if (!net) {
                 return Result<void>::err(Error::invalid_state("null implement network"));
             }
+            remove_taps();
             implement_net_ = net;
+            if (state_.is(NIUState::Active))
+                install_taps();
             echo::category("isobus.niu").debug("implement network attached");
             return {};
         }
@@ -184,25 +219,34 @@ namespace agrobus::net {
         // ─── Filter management ───────────────────────────────────────────────────
         NIU &add_filter(FilterRule rule) {
             filters_.push_back(std::move(rule));
+            table_dirty_ = true;
             return *this;
         }
 
         NIU &allow_pgn(PGN pgn, bool bidirectional = true) {
             filters_.push_back(FilterRule{pgn, ForwardPolicy::Allow, bidirectional});
+            table_dirty_ = true;
             return *this;
         }
 
         NIU &block_pgn(PGN pgn, bool bidirectional = true) {
             filters_.push_back(FilterRule{pgn, ForwardPolicy::Block, bidirectional});
+            table_dirty_ = true;
             return *this;
         }
 
         NIU &monitor_pgn(PGN pgn, bool bidirectional = true) {
             filters_.push_back(FilterRule{pgn, ForwardPolicy::Monitor, bidirectional});
+            table_dirty_ = true;
             return *this;
         }
 
-        void clear_filters() { filters_.clear(); }
+        void clear_filters() {
+            filters_.clear();
+            table_dirty_ = true;
+        }
+
+        const dp::Vector<FilterRule> &filters() const noexcept { return filters_; }
 
         // ─── Start/stop ──────────────────────────────────────────────────────────
         Result<void> start() {
@@ -211,11 +255,14 @@ namespace agrobus::net {
                 return Result<void>::err(Error::invalid_state("both networks must be attached before starting"));
             }
             state_.transition(NIUState::Active);
+            forget_addresses();
+            install_taps();
             echo::category("isobus.niu").info("NIU '", config_.name, "' started");
             return {};
         }
 
         void stop() {
+            remove_taps();
             state_.transition(NIUState::Inactive);
             echo::category("isobus.niu").info("NIU '", config_.name, "' stopped");
         }
@@ -227,10 +274,39 @@ namespace agrobus::net {
         // Called when a frame arrives on the implement side
         void process_implement_frame(const Frame &frame) { process_frame(frame, Side::Implement); }
 
+        // ─── Transport translation ───────────────────────────────────────────────
+        // Drives the relayed sessions of store-and-forward mode: timeouts, BAM
+        // pacing and the DT windows granted by the receivers. Call it from the
+        // same loop that updates the two networks.
+        void update(u32 elapsed_ms) {
+            state_.advance(elapsed_ms);
+            if (!config_.store_and_forward || !state_.is(NIUState::Active))
+                return;
+            for (Side side : {Side::Tractor, Side::Implement}) {
+                TransportProtocol &tp = transport(side);
+                transmit(tp.update(elapsed_ms), side);
+                transmit(tp.get_pending_data_frames(), side);
+            }
+        }
+
         // ─── Statistics ──────────────────────────────────────────────────────────
         u32 forwarded() const noexcept { return forwarded_count_; }
         u32 blocked() const noexcept { return blocked_count_; }
+        // Destination-specific frames not forwarded because the destination is on their own side
+        u32 kept_local() const noexcept { return kept_local_count_; }
         NIUState state() const noexcept { return state_.state(); }
+        const StateMachine<NIUState> &state_machine() const noexcept { return state_; }
+
+        // ─── Address learning ────────────────────────────────────────────────────
+        // Side an address was last claimed or heard from, if learning is on
+        dp::Optional<Side> learned_side(Address addr) const noexcept {
+            if (learned_[addr] == 0)
+                return dp::nullopt;
+            return static_cast<Side>(learned_[addr] - 1);
+        }
+
+        // Flood unicast again until the addresses are heard from anew
+        void forget_addresses() noexcept { learned_.fill(0); }
 
         // ─── NIU Network Message handling (PGN 0xED00) ──────────────────────────
         void handle_niu_message(const Message &msg) {
@@ -243,12 +319,14 @@ namespace agrobus::net {
             switch (niu_msg.function) {
             case NIUFunction::AddFilterEntry:
                 filters_.push_back(FilterRule{niu_msg.filter_pgn, ForwardPolicy::Allow, true});
+                table_dirty_ = true;
                 on_niu_message.emit(niu_msg, msg.source);
                 break;
             case NIUFunction::DeleteFilterEntry:
                 for (auto it = filters_.begin(); it != filters_.end(); ++it) {
                     if (it->pgn == niu_msg.filter_pgn) {
                         filters_.erase(it);
+                        table_dirty_ = true;
                         break;
                     }
                 }
@@ -256,6 +334,7 @@ namespace agrobus::net {
                 break;
             case NIUFunction::DeleteAllEntries:
                 filters_.clear();
+                table_dirty_ = true;
                 on_niu_message.emit(niu_msg, msg.source);
                 break;
             case NIUFunction::SetFilterMode:
@@ -279,9 +358,10 @@ namespace agrobus::net {
         }
 
         // ─── Events ──────────────────────────────────────────────────────────────
-        Event<Frame, Side> on_forwarded;              // frame, which side it came from
-        Event<Frame, Side> on_blocked;                // frame, which side it came from
-        Event<Frame, Side> on_monitored;              // frame forwarded but also reported
+        // The frame events are not raised when NIUConfig::frame_events is off
+        Event<const Frame &, Side> on_forwarded;      // frame, which side it came from
+        Event<const Frame &, Side> on_blocked;        // frame, which side it came from
+        Event<const Frame &, Side> on_monitored;      // frame forwarded but also reported
         Event<NIUNetworkMsg, Address> on_niu_message; // NIU protocol messages
 
       private:
@@ -290,19 +370,41 @@ namespace agrobus::net {
                 return;
             }
 
+            if (table_dirty_) {
+                table_.compile(filters_);
+                table_dirty_ = false;
+            }
+
+            learn(frame, origin);
+
             PGN pgn = frame.pgn();
-            ForwardPolicy policy = resolve_policy(pgn, frame.is_broadcast(), origin);
+            if (config_.store_and_forward && (pgn == PGN_TP_CM || pgn == PGN_TP_DT)) {
+                bridge_transport(frame, origin);
+                return;
+            }
+
+            if (!frame.is_broadcast() && is_local(frame.destination(), origin)) {
+                ++kept_local_count_;
+                return;
+            }
+
+            ForwardPolicy policy =
+                resolve_policy(pgn, frame.source(), frame.destination(), frame.is_broadcast(), origin);
+            if (!config_.frame_events && policy == ForwardPolicy::Monitor)
+                policy = ForwardPolicy::Allow;
 
             switch (policy) {
             case ForwardPolicy::Allow:
                 forward(frame, origin);
                 ++forwarded_count_;
-                on_forwarded.emit(frame, origin);
+                if (config_.frame_events)
+                    on_forwarded.emit(frame, origin);
                 break;
 
             case ForwardPolicy::Block:
                 ++blocked_count_;
-                on_blocked.emit(frame, origin);
+                if (config_.frame_events)
+                    on_blocked.emit(frame, origin);
                 echo::category("isobus.niu")
                     .debug("blocked PGN ", pgn, " from ", origin == Side::Tractor ? "tractor" : "implement");
                 break;
@@ -318,17 +420,9 @@ namespace agrobus::net {
             }
         }
 
-        ForwardPolicy resolve_policy(PGN pgn, bool is_broadcast, Side origin) const {
-            // Search filters for a matching rule
-            for (const auto &rule : filters_) {
-                if (rule.pgn != pgn) {
-                    continue;
-                }
-                // If bidirectional, always match; otherwise only match tractor-originated
-                if (rule.bidirectional || origin == Side::Tractor) {
-                    return rule.policy;
-                }
-            }
+        ForwardPolicy resolve_policy(PGN pgn, Address src, Address dst, bool is_broadcast, Side origin) const {
+            if (const FilterRule *rule = table_.match(origin, pgn, src, dst))
+                return rule->policy;
 
             // No explicit rule found: apply default policy
             if (is_broadcast) {
@@ -337,11 +431,110 @@ namespace agrobus::net {
             return config_.forward_specific_by_default ? ForwardPolicy::Allow : ForwardPolicy::Block;
         }
 
+        // Every frame's source address is heard on `origin`, address claims
+        // included, so an address that is claimed again on the other side
+        // moves with it. NULL (cannot claim) and global sources are skipped.
+        void learn(const Frame &frame, Side origin) noexcept {
+            if (!config_.learn_addresses)
+                return;
+            Address src = frame.source();
+            if (src <= MAX_ADDRESS)
+                learned_[src] = static_cast<u8>(1 + static_cast<u8>(origin));
+        }
+
+        // Unknown destinations are flooded, as a switch does
+        bool is_local(Address dst, Side origin) const noexcept {
+            return config_.learn_addresses && learned_[dst] == 1 + static_cast<u8>(origin);
+        }
+
         void forward(const Frame &frame, Side origin) {
-            IsoNet *target = (origin == Side::Tractor) ? implement_net_ : tractor_net_;
+            transmit(frame, origin == Side::Tractor ? Side::Implement : Side::Tractor);
+        }
+
+        IsoNet *net(Side side) const noexcept { return side == Side::Tractor ? tractor_net_ : implement_net_; }
+        TransportProtocol &transport(Side side) noexcept { return side == Side::Tractor ? tractor_tp_ : implement_tp_; }
+
+        void transmit(const Frame &frame, Side side) {
+            IsoNet *target = net(side);
             if (target) {
-                target->send_frame(frame);
+                if (config_.cut_through)
+                    target->forward_frame(frame);
+                else
+                    target->send_frame(frame);
             }
         }
+
+        void transmit(const dp::Vector<Frame> &frames, Side side) {
+            for (const auto &f : frames)
+                transmit(f, side);
+        }
+
+        // Store-and-forward: a TP session that crosses the NIU is received by
+        // this side's transport endpoint, which answers the sender with its own
+        // CTS windows, and is sent again as a new session on the other side once
+        // complete (relay). Each bus then runs at its own speed and the sender
+        // sees local CTS timing. Sessions between two nodes of the same side
+        // are left to them; the filter applies to the PGN being transported.
+        void bridge_transport(const Frame &frame, Side origin) {
+            if (frame.pgn() == PGN_TP_CM && (frame.data[0] == tp_cm::RTS || frame.data[0] == tp_cm::BAM)) {
+                PGN pgn = static_cast<PGN>(frame.data[5]) | (static_cast<PGN>(frame.data[6]) << 8) |
+                          (static_cast<PGN>(frame.data[7]) << 16);
+                Address dst = frame.destination();
+                bool broadcast = dst == BROADCAST_ADDRESS;
+                if (!broadcast && (net(origin)->names().at(0, dst) || is_local(dst, origin))) {
+                    ++kept_local_count_;
+                    return;
+                }
+                if (resolve_policy(pgn, frame.source(), dst, broadcast, origin) == ForwardPolicy::Block) {
+                    ++blocked_count_;
+                    if (config_.frame_events)
+                        on_blocked.emit(frame, origin);
+                    echo::category("isobus.niu").debug("blocked TP session PGN ", pgn);
+                    return;
+                }
+            }
+            TransportProtocol &tp = transport(origin);
+            transmit(tp.process_frame(frame), origin);
+            transmit(tp.get_pending_data_frames(), origin);
+        }
+
+        // A session received on `origin` is complete: send it on the other side
+        void relay(TransportSession &s, Side origin) {
+            if (s.direction != TransportDirection::Receive)
+                return;
+            Side target = origin == Side::Tractor ? Side::Implement : Side::Tractor;
+            s.data.resize(s.total_bytes);
+            auto payload = std::make_shared<const dp::Vector<u8>>(std::move(s.data));
+            auto frames =
+                transport(target).send_shared(s.pgn, payload, s.source_address, s.destination_address, 0, s.priority);
+            if (!frames.is_ok()) {
+                echo::category("isobus.niu").warn("TP relay failed: pgn=", s.pgn, " to ", s.destination_address);
+                return;
+            }
+            ++forwarded_count_;
+            transmit(frames.value(), target);
+        }
+
+        // Cut-through: take frames as each network drains them and write the
+        // passed ones straight to the other endpoint, ahead of that network's
+        // own protocol processing and its TX queue
+        void install_taps() {
+            remove_taps();
+            if (!config_.cut_through || !tractor_net_ || !implement_net_)
+                return;
+            tractor_tap_ = tractor_net_->on_frame_received.subscribe(
+                [this](const Frame &frame, u8) { process_frame(frame, Side::Tractor); });
+            implement_tap_ = implement_net_->on_frame_received.subscribe(
+                [this](const Frame &frame, u8) { process_frame(frame, Side::Implement); });
+        }
+
+        void remove_taps() {
+            if (tractor_tap_ != INVALID_TOKEN && tractor_net_)
+                tractor_net_->on_frame_received.unsubscribe(tractor_tap_);
+            if (implement_tap_ != INVALID_TOKEN && implement_net_)
+                implement_net_->on_frame_received.unsubscribe(implement_tap_);
+            tractor_tap_ = INVALID_TOKEN;
+            implement_tap_ = INVALID_TOKEN;
+        }
     };
 } // namespace agrobus::net
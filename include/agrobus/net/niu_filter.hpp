@@ -0,0 +1,147 @@
+#pragma once
+
+#include <agrobus/net/constants.hpp>
+#include <agrobus/net/types.hpp>
+#include <bit>
+#include <datapod/datapod.hpp>
+
+namespace agrobus::net {
+
+    // ─── Forward policy ──────────────────────────────────────────────────────────
+    enum class ForwardPolicy : u8 {
+        Allow,  // Forward this PGN
+        Block,  // Block this PGN
+        Monitor // Forward but also emit event
+    };
+
+    // ─── Filter rule ─────────────────────────────────────────────────────────────
+    struct FilterRule {
+        PGN pgn;
+        ForwardPolicy policy = ForwardPolicy::Allow;
+        bool bidirectional = true;          // applies both directions if true
+        Address source = BROADCAST_ADDRESS; // only frames from this sender (0xFF: any)
+        Address destination = NULL_ADDRESS; // only frames to this address (0xFE: any)
+
+        constexpr bool applies(Address src, Address dst) const noexcept {
+            return (source == BROADCAST_ADDRESS || source == src) &&
+                   (destination == NULL_ADDRESS || destination == dst);
+        }
+    };
+
+    // ─── Side identifier ─────────────────────────────────────────────────────────
+    enum class Side : u8 { Tractor, Implement };
+
+    // ─── Compiled filter table ───────────────────────────────────────────────────
+    // The NIU's rule list compiled into a two-level bitmap over the 18-bit PGN
+    // space, one per side. Level one has a bit per block of 64 PGNs (4096
+    // blocks, 64 words); level two keeps one word per populated block, with a
+    // bit per PGN. Ranks (popcount over the lower bits plus a prefix count)
+    // turn the bits into indices, so a lookup is two bit tests and two
+    // popcounts no matter how many rules there are, and a table with a few
+    // hundred rules stays in a handful of cache lines.
+    //
+    // Each PGN with rules keeps them in list order; the first one whose
+    // source/destination qualifiers match the frame decides, like the linear
+    // search it replaces. No match means "use the defaults".
+    class NIUFilterTable {
+        static constexpr u32 PGN_MASK = 0x3FFFF;
+        static constexpr u32 TOP_WORDS = (PGN_MASK + 1) / 64 / 64;
+
+        struct Entry {
+            u32 first = 0; // Into rules
+            u32 count = 0;
+        };
+
+        struct SideTable {
+            dp::Array<u64, TOP_WORDS> top{};      // Bit per 64-PGN block with rules
+            dp::Array<u32, TOP_WORDS> top_rank{}; // Populated blocks in earlier words
+            dp::Vector<u64> blocks;               // Bit per PGN, one word per populated block
+            dp::Vector<u32> block_rank;           // Entries in earlier blocks
+            dp::Vector<Entry> entries;            // One per PGN with rules, ascending PGN
+            dp::Vector<FilterRule> rules;         // Grouped by PGN, list order within
+
+            void clear() {
+                top.fill(0);
+                top_rank.fill(0);
+                blocks.clear();
+                block_rank.clear();
+                entries.clear();
+                rules.clear();
+            }
+        };
+
+        dp::Array<SideTable, 2> sides_;
+
+      public:
+        // Rebuild both sides from the rule list (a one-way rule only applies
+        // to frames coming from the tractor side)
+        void compile(const dp::Vector<FilterRule> &rules) {
+            for (u32 s = 0; s < 2; ++s) {
+                SideTable &t = sides_[s];
+                t.clear();
+                for (const auto &rule : rules) {
+                    if (rule.pgn > PGN_MASK || (!rule.bidirectional && s != static_cast<u32>(Side::Tractor)))
+                        continue;
+                    // Stable insert by PGN
+                    usize at = t.rules.size();
+                    t.rules.push_back(rule);
+                    while (at > 0 && t.rules[at - 1].pgn > rule.pgn) {
+                        t.rules[at] = t.rules[at - 1];
+                        --at;
+                    }
+                    t.rules[at] = rule;
+                }
+
+                for (u32 i = 0; i < t.rules.size(); ++i) {
+                    PGN pgn = t.rules[i].pgn;
+                    if (i > 0 && t.rules[i - 1].pgn == pgn) {
+                        ++t.entries.back().count;
+                        continue;
+                    }
+                    u32 block = pgn >> 6;
+                    u64 block_bit = 1ULL << (block & 63);
+                    if (!(t.top[block >> 6] & block_bit)) {
+                        t.top[block >> 6] |= block_bit;
+                        t.blocks.push_back(0);
+                        t.block_rank.push_back(static_cast<u32>(t.entries.size()));
+                    }
+                    t.blocks.back() |= 1ULL << (pgn & 63);
+                    t.entries.push_back(Entry{i, 1});
+                }
+
+                u32 rank = 0;
+                for (u32 w = 0; w < TOP_WORDS; ++w) {
+                    t.top_rank[w] = rank;
+                    rank += static_cast<u32>(std::popcount(t.top[w]));
+                }
+            }
+        }
+
+        // First rule for a frame of `pgn` from `src` to `dst` arriving on `origin`
+        const FilterRule *match(Side origin, PGN pgn, Address src, Address dst) const noexcept {
+            const SideTable &t = sides_[static_cast<u8>(origin)];
+            if (pgn > PGN_MASK || t.entries.empty())
+                return nullptr;
+            u32 block = pgn >> 6;
+            u64 top = t.top[block >> 6];
+            u64 block_bit = 1ULL << (block & 63);
+            if (!(top & block_bit))
+                return nullptr;
+            u32 bi = t.top_rank[block >> 6] + static_cast<u32>(std::popcount(top & (block_bit - 1)));
+            u64 word = t.blocks[bi];
+            u64 pgn_bit = 1ULL << (pgn & 63);
+            if (!(word & pgn_bit))
+                return nullptr;
+            const Entry &e = t.entries[t.block_rank[bi] + static_cast<u32>(std::popcount(word & (pgn_bit - 1)))];
+            for (u32 i = e.first; i < e.first + e.count; ++i) {
+                if (t.rules[i].applies(src, dst))
+                    return &t.rules[i];
+            }
+            return nullptr;
+        }
+
+        // PGNs with at least one rule on a side
+        usize size(Side origin) const noexcept { return sides_[static_cast<u8>(origin)].entries.size(); }
+    };
+
+} // namespace agrobus::net
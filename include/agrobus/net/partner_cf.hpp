@@ -43,15 +43,95 @@ namespace agrobus::net {
             }
             return false;
         }
+
+        // Bits of the raw 64-bit NAME this filter tests, and where they start
+        static constexpr u64 field_mask(NameFilterField field) noexcept {
+            switch (field) {
+            case NameFilterField::IdentityNumber:
+                return 0x1FFFFFULL;
+            case NameFilterField::ManufacturerCode:
+                return 0x7FFULL << 21;
+            case NameFilterField::ECUInstance:
+                return 0x07ULL << 32;
+            case NameFilterField::FunctionInstance:
+                return 0x1FULL << 35;
+            case NameFilterField::FunctionCode:
+                return 0xFFULL << 40;
+            case NameFilterField::DeviceClass:
+                return 0x7FULL << 49;
+            case NameFilterField::DeviceClassInstance:
+                return 0x0FULL << 56;
+            case NameFilterField::IndustryGroup:
+                return 0x07ULL << 60;
+            }
+            return 0;
+        }
+
+        // `value` as matches() compares it (narrowed to the accessor's type)
+        constexpr u64 compared_value() const noexcept {
+            switch (field) {
+            case NameFilterField::IdentityNumber:
+                return value;
+            case NameFilterField::ManufacturerCode:
+                return static_cast<u16>(value);
+            default:
+                return static_cast<u8>(value);
+            }
+        }
+
+        static constexpr u32 field_shift(NameFilterField field) noexcept {
+            u64 mask = field_mask(field);
+            u32 shift = 0;
+            while (mask != 0 && (mask & 1) == 0) {
+                mask >>= 1;
+                ++shift;
+            }
+            return shift;
+        }
+    };
+
+    // ─── Compiled NAME filter set ────────────────────────────────────────────────
+    // A filter set is an AND over NAME fields, and every field sits at a fixed
+    // place in the raw 64-bit NAME, so the whole set folds into one (mask,
+    // value) pair: matching is one AND and a compare. Two filters that demand
+    // different values of one field can never match; they compile to mask 0,
+    // value 1. The empty set matches every NAME.
+    struct NameMatcher {
+        u64 mask = 0;
+        u64 value = 0;
+
+        static constexpr NameMatcher compile(const dp::Vector<NameFilter> &filters) noexcept {
+            NameMatcher m;
+            for (const auto &f : filters) {
+                u64 field = NameFilter::field_mask(f.field);
+                u32 shift = NameFilter::field_shift(f.field);
+                if (f.compared_value() > (field >> shift))
+                    return never(); // Wider than the field: no NAME carries it
+                u64 want = f.compared_value() << shift;
+                if ((m.mask & field) != 0 && (m.value & field) != want)
+                    return never();
+                m.mask |= field;
+                m.value |= want;
+            }
+            return m;
+        }
+
+        static constexpr NameMatcher never() noexcept { return NameMatcher{0, 1}; }
+
+        constexpr bool matches(Name name) const noexcept { return (name.raw & mask) == value; }
+        constexpr bool can_match() const noexcept { return (value & ~mask) == 0; }
+        constexpr bool operator==(const NameMatcher &o) const noexcept { return mask == o.mask && value == o.value; }
     };
 
     // ─── Partner control function (external ECU we track) ────────────────────────
     class PartnerCF {
         ControlFunction cf_;
         dp::Vector<NameFilter> filters_;
+        NameMatcher matcher_;
 
       public:
-        PartnerCF(u8 port, dp::Vector<NameFilter> filters) : filters_(std::move(filters)) {
+        PartnerCF(u8 port, dp::Vector<NameFilter> filters)
+            : filters_(std::move(filters)), matcher_(NameMatcher::compile(filters_)) {
             cf_.can_port = port;
             cf_.type = CFType::Partnered;
         }
@@ -62,18 +142,13 @@ namespace agrobus::net {
         Address address() const noexcept { return cf_.address; }
         u8 port() const noexcept { return cf_.can_port; }
         const dp::Vector<NameFilter> &filters() const noexcept { return filters_; }
+        const NameMatcher &matcher() const noexcept { return matcher_; }
 
         void set_address(Address addr) noexcept { cf_.address = addr; }
         void set_name(Name name) noexcept { cf_.name = name; }
         void set_state(CFState state) noexcept { cf_.state = state; }
 
-        bool matches_name(const Name &name) const noexcept {
-            for (const auto &filter : filters_) {
-                if (!filter.matches(name))
-                    return false;
-            }
-            return true;
-        }
+        bool matches_name(const Name &name) const noexcept { return matcher_.matches(name); }
 
         // Events
         Event<Address> on_partner_found;
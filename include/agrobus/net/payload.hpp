@@ -0,0 +1,240 @@
+#pragma once
+
+#include "data_span.hpp"
+#include "types.hpp"
+#include <datapod/datapod.hpp>
+#include <initializer_list>
+#include <utility>
+
+namespace agrobus::net {
+
+    // Bytes a Payload holds without allocating: every single CAN frame, plus the
+    // short TP / fast packet messages (address claims, DM1 with one DTC, ...)
+    inline constexpr usize PAYLOAD_INLINE_BYTES = 16;
+
+    // ─── Message payload with inline storage ────────────────────────────────────
+    // Byte vector that keeps up to PAYLOAD_INLINE_BYTES in place and spills to a
+    // dp::Vector<u8> beyond that. A dp::Vector moved in (a completed TP/ETP
+    // buffer) is adopted as the heap store without copying, and take() hands it
+    // back, so transport buffers still cycle through the BufferPool.
+    //
+    // The interface is the subset of dp::Vector<u8> the tree uses on
+    // Message::data; it converts implicitly to DataSpan for decoders.
+    class Payload {
+      public:
+        static constexpr usize INLINE_CAPACITY = PAYLOAD_INLINE_BYTES;
+
+      private:
+        dp::Array<u8, INLINE_CAPACITY> inline_;
+        dp::Vector<u8> heap_;
+        u32 size_ = 0; // Inline byte count (heap_ tracks its own)
+        bool on_heap_ = false;
+
+      public:
+        Payload() noexcept = default;
+        Payload(std::initializer_list<u8> bytes) { assign(bytes.begin(), bytes.end()); }
+        Payload(usize count, u8 value) { assign(count, value); }
+        explicit Payload(usize count) { assign(count, 0); }
+        Payload(const u8 *bytes, usize count) { assign(bytes, bytes + count); }
+        Payload(DataSpan bytes) { assign(bytes.begin(), bytes.end()); }
+        Payload(const dp::Vector<u8> &vec) { assign(vec.begin(), vec.end()); }
+        Payload(dp::Vector<u8> &&vec) noexcept : heap_(std::move(vec)), on_heap_(true) {}
+
+        Payload(const Payload &other) { assign(other.begin(), other.end()); }
+
+        Payload(Payload &&other) noexcept
+            : inline_(other.inline_), heap_(std::move(other.heap_)), size_(other.size_), on_heap_(other.on_heap_) {
+            other.size_ = 0;
+            other.on_heap_ = false;
+        }
+
+        Payload &operator=(const Payload &other) {
+            if (this != &other)
+                assign(other.begin(), other.end());
+            return *this;
+        }
+
+        Payload &operator=(Payload &&other) noexcept {
+            if (this != &other) {
+                inline_ = other.inline_;
+                heap_ = std::move(other.heap_);
+                size_ = other.size_;
+                on_heap_ = other.on_heap_;
+                other.heap_.clear();
+                other.size_ = 0;
+                other.on_heap_ = false;
+            }
+            return *this;
+        }
+
+        Payload &operator=(std::initializer_list<u8> bytes) {
+            assign(bytes.begin(), bytes.end());
+            return *this;
+        }
+
+        Payload &operator=(const dp::Vector<u8> &vec) {
+            assign(vec.begin(), vec.end());
+            return *this;
+        }
+
+        Payload &operator=(dp::Vector<u8> &&vec) noexcept {
+            heap_ = std::move(vec);
+            size_ = 0;
+            on_heap_ = true;
+            return *this;
+        }
+
+        // ─── Access ──────────────────────────────────────────────────────────────
+        usize size() const noexcept { return on_heap_ ? heap_.size() : size_; }
+        bool empty() const noexcept { return size() == 0; }
+        usize capacity() const noexcept { return on_heap_ ? heap_.capacity() : INLINE_CAPACITY; }
+        bool is_inline() const noexcept { return !on_heap_; }
+
+        u8 *data() noexcept { return on_heap_ ? heap_.data() : inline_.data(); }
+        const u8 *data() const noexcept { return on_heap_ ? heap_.data() : inline_.data(); }
+
+        u8 &operator[](usize i) noexcept { return data()[i]; }
+        const u8 &operator[](usize i) const noexcept { return data()[i]; }
+
+        u8 &front() noexcept { return data()[0]; }
+        const u8 &front() const noexcept { return data()[0]; }
+        u8 &back() noexcept { return data()[size() - 1]; }
+        const u8 &back() const noexcept { return data()[size() - 1]; }
+
+        u8 *begin() noexcept { return data(); }
+        u8 *end() noexcept { return data() + size(); }
+        const u8 *begin() const noexcept { return data(); }
+        const u8 *end() const noexcept { return data() + size(); }
+
+        operator DataSpan() const noexcept { return DataSpan(data(), size()); }
+
+        // Copying conversion, so code that stores msg.data in a dp::Vector keeps
+        // compiling; decoders should take a DataSpan instead
+        operator dp::Vector<u8>() const { return to_vector(); }
+
+        // ─── Modification ────────────────────────────────────────────────────────
+        void clear() noexcept {
+            heap_.clear();
+            size_ = 0;
+            on_heap_ = false;
+        }
+
+        void reserve(usize count) {
+            if (count > capacity())
+                spill(count);
+            else if (on_heap_)
+                heap_.reserve(count);
+        }
+
+        void resize(usize count, u8 value = 0) {
+            if (on_heap_) {
+                heap_.resize(count, value);
+                return;
+            }
+            if (count > INLINE_CAPACITY) {
+                spill(count);
+                heap_.resize(count, value);
+                return;
+            }
+            for (usize i = size_; i < count; ++i)
+                inline_[i] = value;
+            size_ = static_cast<u32>(count);
+        }
+
+        void push_back(u8 value) {
+            if (on_heap_) {
+                heap_.push_back(value);
+                return;
+            }
+            if (size_ == INLINE_CAPACITY) {
+                spill(INLINE_CAPACITY * 2);
+                heap_.push_back(value);
+                return;
+            }
+            inline_[size_++] = value;
+        }
+
+        void pop_back() noexcept {
+            if (on_heap_)
+                heap_.pop_back();
+            else if (size_ > 0)
+                --size_;
+        }
+
+        template <typename It> void assign(It first, It last) {
+            usize count = static_cast<usize>(last - first);
+            if (on_heap_ || count > INLINE_CAPACITY) {
+                size_ = 0;
+                on_heap_ = true;
+                heap_.assign(first, last);
+                return;
+            }
+            for (usize i = 0; i < count; ++i, ++first)
+                inline_[i] = static_cast<u8>(*first);
+            size_ = static_cast<u32>(count);
+        }
+
+        void assign(usize count, u8 value) {
+            clear();
+            resize(count, value);
+        }
+
+        void assign(std::initializer_list<u8> bytes) { assign(bytes.begin(), bytes.end()); }
+
+        // Append [first, last) at the end
+        template <typename It> void append(It first, It last) {
+            usize at = size();
+            usize count = static_cast<usize>(last - first);
+            resize(at + count);
+            u8 *out = data() + at;
+            for (usize i = 0; i < count; ++i, ++first)
+                out[i] = static_cast<u8>(*first);
+        }
+
+        // ─── Conversion ──────────────────────────────────────────────────────────
+        dp::Vector<u8> to_vector() const { return dp::Vector<u8>(begin(), end()); }
+
+        // Move the bytes out as a dp::Vector (the adopted buffer when there is
+        // one, so it can go back to a BufferPool); leaves the payload empty
+        dp::Vector<u8> take() {
+            dp::Vector<u8> out = on_heap_ ? std::move(heap_) : to_vector();
+            clear();
+            return out;
+        }
+
+        friend bool operator==(const Payload &a, const Payload &b) noexcept { return equal(a, b.data(), b.size()); }
+        friend bool operator==(const Payload &a, const dp::Vector<u8> &b) noexcept {
+            return equal(a, b.data(), b.size());
+        }
+        friend bool operator==(const dp::Vector<u8> &a, const Payload &b) noexcept {
+            return equal(b, a.data(), a.size());
+        }
+        friend bool operator!=(const Payload &a, const Payload &b) noexcept { return !(a == b); }
+        friend bool operator!=(const Payload &a, const dp::Vector<u8> &b) noexcept { return !(a == b); }
+        friend bool operator!=(const dp::Vector<u8> &a, const Payload &b) noexcept { return !(a == b); }
+
+      private:
+        // Move the inline bytes to the heap store with room for `count`
+        void spill(usize count) {
+            if (on_heap_)
+                return;
+            heap_.clear();
+            heap_.reserve(count);
+            heap_.assign(inline_.data(), inline_.data() + size_);
+            size_ = 0;
+            on_heap_ = true;
+        }
+
+        static bool equal(const Payload &a, const u8 *b, usize n) noexcept {
+            if (a.size() != n)
+                return false;
+            const u8 *p = a.data();
+            for (usize i = 0; i < n; ++i) {
+                if (p[i] != b[i])
+                    return false;
+            }
+            return true;
+        }
+    };
+
+} // namespace agrobus::net
@@ -0,0 +1,165 @@
+#pragma once
+
+#include "network_manager.hpp"
+#include <agrobus/net/types.hpp>
+#include <datapod/datapod.hpp>
+#include <echo/echo.hpp>
+#include <functional>
+
+namespace agrobus::net {
+
+    // ─── Periodic PGN broadcasts of one control function ────────────────────────
+    // Each PGN is a periodic timer on the IsoNet timer wheel, anchored to the
+    // network's clock: it goes out at phase + k * period however coarse the
+    // update() ticks are, so 100 ms messages neither drift nor bunch up. PGNs
+    // added with AUTO_PHASE are spread across their period (0, 1/2, 1/4, 3/4,
+    // 1/8, ... of it for each further PGN of the same period), so an ECU's
+    // periodic traffic does not burst onto the bus at the same instant.
+    class PeriodicSender {
+      public:
+        // Fill the payload for this period; return false to skip sending.
+        // Runs inside IsoNet::update() and must not add or remove PGNs.
+        using Producer = std::function<bool(dp::Vector<u8> &)>;
+        static constexpr u32 AUTO_PHASE = 0xFFFFFFFFu;
+
+      private:
+        struct Entry {
+            PGN pgn = 0;
+            u32 period_ms = 0;
+            u32 phase_ms = 0;
+            Priority priority = Priority::Default;
+            ControlFunction *destination = nullptr;
+            Producer producer;
+            TimerId timer = INVALID_TIMER;
+        };
+
+        IsoNet &net_;
+        InternalCF *cf_;
+        dp::Vector<Entry> entries_;
+        dp::Vector<u8> payload_; // Reused for every send
+        u64 sent_ = 0;
+        bool packed_ = false;
+        u32 pack_delay_ms_ = 0;
+
+      public:
+        PeriodicSender(IsoNet &net, InternalCF *cf) : net_(net), cf_(cf) {}
+
+        // Timer callbacks point at this object
+        PeriodicSender(const PeriodicSender &) = delete;
+        PeriodicSender &operator=(const PeriodicSender &) = delete;
+
+        ~PeriodicSender() { clear(); }
+
+        // Send `pgn` every period_ms (replaces an existing entry for the PGN).
+        // Returns the phase used.
+        u32 add(PGN pgn, u32 period_ms, Producer producer, Priority priority = Priority::Default,
+                u32 phase_ms = AUTO_PHASE, ControlFunction *destination = nullptr) {
+            remove(pgn);
+            if (period_ms == 0)
+                period_ms = 1;
+            if (phase_ms == AUTO_PHASE)
+                phase_ms = spread_phase(period_ms, count_period(period_ms));
+            Entry entry;
+            entry.pgn = pgn;
+            entry.period_ms = period_ms;
+            entry.phase_ms = phase_ms % period_ms;
+            entry.priority = priority;
+            entry.destination = destination;
+            entry.producer = std::move(producer);
+            entry.timer = net_.timers().schedule_every(period_ms, entry.phase_ms, [this, pgn]() { fire(pgn); });
+            entries_.push_back(std::move(entry));
+            echo::category("isobus.periodic")
+                .debug("periodic pgn=", pgn, " period=", period_ms, "ms phase=", entries_.back().phase_ms, "ms");
+            return entries_.back().phase_ms;
+        }
+
+        bool remove(PGN pgn) {
+            for (auto it = entries_.begin(); it != entries_.end(); ++it) {
+                if (it->pgn == pgn) {
+                    net_.timers().cancel(it->timer);
+                    entries_.erase(it);
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        // New period (and phase) for a PGN; the schedule is re-anchored
+        bool set_period(PGN pgn, u32 period_ms, u32 phase_ms = 0) {
+            Entry *e = find(pgn);
+            if (!e)
+                return false;
+            e->period_ms = period_ms == 0 ? 1 : period_ms;
+            e->phase_ms = phase_ms % e->period_ms;
+            return net_.timers().set_period(e->timer, e->period_ms, e->phase_ms);
+        }
+
+        dp::Optional<u32> phase(PGN pgn) const {
+            for (const auto &e : entries_) {
+                if (e.pgn == pgn)
+                    return e.phase_ms;
+            }
+            return dp::nullopt;
+        }
+
+        // On a CAN FD port, send through IsoNet::send_packed so PGs of this CF
+        // that fall due within max_delay_ms of each other share multi-PG frames
+        void set_packing(bool enable, u32 max_delay_ms = 0) noexcept {
+            packed_ = enable;
+            pack_delay_ms_ = max_delay_ms;
+        }
+
+        usize size() const noexcept { return entries_.size(); }
+        u64 sent() const noexcept { return sent_; }
+
+        void clear() {
+            for (auto &e : entries_)
+                net_.timers().cancel(e.timer);
+            entries_.clear();
+        }
+
+        // k-th element of the base-2 van der Corput sequence, scaled to the period
+        static u32 spread_phase(u32 period_ms, u32 k) noexcept {
+            u64 num = 0;
+            u64 den = 1;
+            for (; k != 0; k >>= 1) {
+                num = num * 2 + (k & 1);
+                den *= 2;
+            }
+            return static_cast<u32>(static_cast<u64>(period_ms) * num / den);
+        }
+
+      private:
+        Entry *find(PGN pgn) {
+            for (auto &e : entries_) {
+                if (e.pgn == pgn)
+                    return &e;
+            }
+            return nullptr;
+        }
+
+        u32 count_period(u32 period_ms) const noexcept {
+            u32 n = 0;
+            for (const auto &e : entries_) {
+                if (e.period_ms == period_ms)
+                    ++n;
+            }
+            return n;
+        }
+
+        void fire(PGN pgn) {
+            Entry *e = find(pgn);
+            if (!e || !e->producer)
+                return;
+            payload_.clear();
+            if (!e->producer(payload_))
+                return;
+            auto result = packed_
+                              ? net_.send_packed(e->pgn, payload_, cf_, e->destination, e->priority, pack_delay_ms_)
+                              : net_.send(e->pgn, payload_, cf_, e->destination, e->priority);
+            if (result.is_ok())
+                ++sent_;
+        }
+    };
+
+} // namespace agrobus::net
@@ -0,0 +1,204 @@
+#pragma once
+
+#include <agrobus/net/bitfield.hpp>
+#include <agrobus/net/data_span.hpp>
+#include <agrobus/net/types.hpp>
+#include <datapod/datapod.hpp>
+#include <type_traits>
+
+namespace agrobus::net {
+
+    namespace codec {
+
+        template <typename T> struct MemberTraits;
+        template <typename C, typename T> struct MemberTraits<T C::*> {
+            using Owner = C;
+            using Value = T;
+        };
+
+    } // namespace codec
+
+    // ─── SPN field descriptor ────────────────────────────────────────────────────
+    // One parameter of a single-frame PGN: the struct member it maps to, its
+    // position in the 64-bit little-endian frame word, and the J1939 resolution
+    // and offset (physical = raw * ScaleNum / ScaleDen + Offset). The scale is a
+    // ratio so descriptors stay integer template arguments (0.001 m/s = 1/1000,
+    // 0.125 rpm = 1/8, 0.4 % = 2/5).
+    //
+    // Floating members are rounded to the nearest raw step and clamped to the
+    // field; bool, enum and plain integer members are copied raw unless a scale
+    // or offset is given.
+    template <auto Member, u8 StartBit, u8 Length, i64 ScaleNum = 1, i64 ScaleDen = 1, i64 Offset = 0> struct Field {
+        using Owner = typename codec::MemberTraits<decltype(Member)>::Owner;
+        using Value = typename codec::MemberTraits<decltype(Member)>::Value;
+
+        static_assert(Length >= 1 && Length <= 32, "SPN fields are 1..32 bits");
+        static_assert(StartBit + Length <= 64, "field does not fit an 8-byte frame");
+        static_assert(ScaleNum > 0 && ScaleDen > 0, "scale must be positive");
+
+        static constexpr auto MEMBER = Member;
+        static constexpr u64 MASK = (static_cast<u64>(1) << Length) - 1;
+        static constexpr u8 END_BYTE = static_cast<u8>((StartBit + Length + 7) / 8);
+        static constexpr u8 REQUIRED_BYTES = END_BYTE; // Counted by PgnCodec::MIN_BYTES
+        static constexpr bool TRAILING = false;
+        static constexpr bool SCALED = ScaleNum != 1 || ScaleDen != 1 || Offset != 0;
+
+        static constexpr u64 extract(u64 word) noexcept { return (word >> StartBit) & MASK; }
+        static constexpr u64 deposit(u64 word, u64 raw) noexcept {
+            return (word & ~(MASK << StartBit)) | ((raw & MASK) << StartBit);
+        }
+
+        static constexpr Value to_value(u64 raw) noexcept {
+            if constexpr (std::is_same_v<Value, bool>) {
+                return raw != 0;
+            } else if constexpr (std::is_enum_v<Value>) {
+                return static_cast<Value>(raw);
+            } else if constexpr (std::is_floating_point_v<Value>) {
+                constexpr f64 scale = static_cast<f64>(ScaleNum) / static_cast<f64>(ScaleDen);
+                return static_cast<Value>(static_cast<f64>(raw) * scale + static_cast<f64>(Offset));
+            } else if constexpr (SCALED) {
+                return static_cast<Value>(static_cast<i64>(raw) * ScaleNum / ScaleDen + Offset);
+            } else {
+                return static_cast<Value>(raw);
+            }
+        }
+
+        static constexpr u64 to_raw(Value value) noexcept {
+            if constexpr (std::is_same_v<Value, bool>) {
+                return value ? 1 : 0;
+            } else if constexpr (std::is_enum_v<Value>) {
+                return static_cast<u64>(value) & MASK;
+            } else if constexpr (std::is_floating_point_v<Value>) {
+                constexpr f64 scale = static_cast<f64>(ScaleNum) / static_cast<f64>(ScaleDen);
+                f64 x = (static_cast<f64>(value) - static_cast<f64>(Offset)) / scale + 0.5;
+                x = x < 0.0 ? 0.0 : x;
+                x = x > static_cast<f64>(MASK) ? static_cast<f64>(MASK) : x;
+                return static_cast<u64>(x);
+            } else if constexpr (SCALED) {
+                i64 r = (static_cast<i64>(value) - Offset) * ScaleDen / ScaleNum;
+                r = r < 0 ? 0 : r;
+                return static_cast<u64>(r) > MASK ? MASK : static_cast<u64>(r);
+            } else {
+                return static_cast<u64>(value) & MASK;
+            }
+        }
+
+        static constexpr void decode(u64 word, Owner &msg) noexcept { msg.*Member = to_value(extract(word)); }
+        static constexpr u64 encode(const Owner &msg, u64 word) noexcept { return deposit(word, to_raw(msg.*Member)); }
+    };
+
+    // ─── Trailing field ───────────────────────────────────────────────────────────
+    // A field a later revision appended: MIN_BYTES does not count it, and a
+    // frame that ends before it leaves the member at its default rather than
+    // reading the missing bytes as all ones.
+    //
+    //   Trailing<Field<&TractorFacilities::aux_valve_exit_code, 32, 1>>
+    template <typename F> struct Trailing : F {
+        static constexpr u8 REQUIRED_BYTES = 0;
+        static constexpr bool TRAILING = true;
+    };
+
+    // ─── Fixed bits ──────────────────────────────────────────────────────────────
+    // Bits a layout always sends with one value, for the messages that send
+    // reserved bits as zero instead of the usual ones. Skipped on decode and
+    // not counted by MIN_BYTES.
+    template <u8 StartBit, u8 Length, u64 Value = 0> struct Fixed {
+        using Owner = void;
+
+        static_assert(Length >= 1 && Length <= 32, "fixed bits are 1..32 bits");
+        static_assert(StartBit + Length <= 64, "fixed bits do not fit an 8-byte frame");
+
+        static constexpr u64 MASK = (static_cast<u64>(1) << Length) - 1;
+        static constexpr u8 END_BYTE = 0;
+        static constexpr u8 REQUIRED_BYTES = 0;
+        static constexpr bool TRAILING = false;
+
+        template <typename Msg> static constexpr void decode(u64, Msg &) noexcept {}
+        template <typename Msg> static constexpr u64 encode(const Msg &, u64 word) noexcept {
+            return (word & ~(MASK << StartBit)) | ((Value & MASK) << StartBit);
+        }
+    };
+
+    // ─── Single-frame PGN codec ──────────────────────────────────────────────────
+    // Generated from a message struct's field table. The whole frame is one u64:
+    // decode loads it once and shifts/masks every field out, encode starts from
+    // all-ones (every unlisted bit reads "not available") and deposits each field.
+    // Nothing allocates except the dp::Vector form of encode().
+    //
+    //   struct PTOStatus {
+    //       f64 shaft_speed_rpm = 0.0;
+    //       u8 engagement = 3;
+    //       using Codec = PgnCodec<PTOStatus, Field<&PTOStatus::shaft_speed_rpm, 0, 16, 1, 8>,
+    //                              Field<&PTOStatus::engagement, 16, 2>>;
+    //   };
+    template <typename Msg, typename... Fields> struct PgnCodec {
+        static_assert(sizeof...(Fields) > 0, "a codec needs at least one field");
+        static_assert(((std::is_same_v<typename Fields::Owner, Msg> || std::is_void_v<typename Fields::Owner>) && ...),
+                      "field belongs to another message");
+
+        // Frames shorter than this decode to a default-constructed message
+        static constexpr usize MIN_BYTES = [] {
+            usize n = 0;
+            ((n = Fields::REQUIRED_BYTES > n ? Fields::REQUIRED_BYTES : n), ...);
+            return n;
+        }();
+
+        // Calls fn(F{}) for every descriptor in table order (tests, tooling)
+        template <typename Fn> static constexpr void for_each_field(Fn &&fn) { (fn(Fields{}), ...); }
+
+        static constexpr u64 pack(const Msg &msg) noexcept {
+            u64 word = ~static_cast<u64>(0);
+            ((word = Fields::encode(msg, word)), ...);
+            return word;
+        }
+
+        static constexpr Msg unpack(u64 word) noexcept {
+            Msg msg{};
+            (Fields::decode(word, msg), ...);
+            return msg;
+        }
+
+        static constexpr Msg decode(const u8 *data, usize size) noexcept {
+            if (size < MIN_BYTES)
+                return Msg{};
+            Msg msg = unpack(bitfield::load_le(data, size));
+            if (size < 8)
+                (drop_missing<Fields>(msg, size), ...);
+            return msg;
+        }
+
+        static Msg decode(DataSpan data) noexcept { return decode(data.data(), data.size()); }
+
+        // One field without decoding the rest (what decode() would give it)
+        template <typename F> static constexpr typename F::Value get(const u8 *data, usize size) noexcept {
+            if (size < MIN_BYTES || (F::TRAILING && F::END_BYTE > size))
+                return Msg{}.*F::MEMBER;
+            return F::to_value(F::extract(bitfield::load_le(data, size)));
+        }
+
+        template <typename F> static typename F::Value get(DataSpan data) noexcept {
+            return get<F>(data.data(), data.size());
+        }
+
+        static dp::Array<u8, 8> encode_array(const Msg &msg) noexcept {
+            dp::Array<u8, 8> out{};
+            bitfield::store_le(out.data(), out.size(), pack(msg));
+            return out;
+        }
+
+        static dp::Vector<u8> encode(const Msg &msg) {
+            dp::Vector<u8> out(8, 0xFF);
+            bitfield::store_le(out.data(), out.size(), pack(msg));
+            return out;
+        }
+
+      private:
+        template <typename F> static constexpr void drop_missing(Msg &msg, usize size) noexcept {
+            if constexpr (F::TRAILING) {
+                if (F::END_BYTE > size)
+                    msg.*F::MEMBER = Msg{}.*F::MEMBER;
+            }
+        }
+    };
+
+} // namespace agrobus::net
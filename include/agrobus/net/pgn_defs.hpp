@@ -22,6 +22,7 @@ namespace agrobus::net {
     inline constexpr PGN PGN_ACKNOWLEDGMENT = 0xE800;
     inline constexpr PGN PGN_REQUEST2 = 0xC900; // Request2 (ISO 11783-3)
     inline constexpr PGN PGN_TRANSFER = 0xCA00; // Transfer PGN (ISO 11783-3)
+    inline constexpr PGN PGN_MULTI_PG = 0x2500; // Multi-PG, CAN FD only (J1939-22)
 
     // ─── Proprietary Messages (ISO 11783-3, Section 5.4.6) ─────────────────────
     inline constexpr PGN PGN_PROPRIETARY_A = 0xEF00;      // Destination-specific, up to 1785 bytes
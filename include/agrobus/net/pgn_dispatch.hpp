@@ -0,0 +1,191 @@
+#pragma once
+
+#include <agrobus/net/message.hpp>
+#include <agrobus/net/types.hpp>
+#include <datapod/datapod.hpp>
+#include <functional>
+
+namespace agrobus::net {
+
+    // ─── Compiled PGN → callback dispatch table ──────────────────────────────────
+    // Registrations are collected in a pending list and compiled lazily into a
+    // flat, PGN-sorted handler array plus an open-addressing hash index. Lookups
+    // are O(1) on average; a miss (nobody listens to the PGN) terminates on the
+    // first empty slot, so unhandled traffic can be rejected before a Message is
+    // ever built. Handlers added while a dispatch is running take effect on the
+    // next dispatch, so callbacks may register further callbacks safely.
+    // MsgT is Message (owning) or MessageView (zero-copy); it must expose `pgn`.
+    template <typename MsgT> class BasicPGNDispatchTable {
+      public:
+        using Callback = std::function<void(const MsgT &)>;
+
+      private:
+        struct Entry {
+            PGN pgn = 0;
+            Callback fn;
+        };
+
+        struct Slot {
+            PGN pgn = 0;
+            u32 first = 0;
+            u32 count = 0; // 0 = empty slot
+        };
+
+        static constexpr usize MIN_SLOTS = 16;
+
+        dp::Vector<Entry> entries_; // Sorted by PGN, registration order within a PGN
+        dp::Vector<Entry> pending_; // Not yet compiled into entries_/slots_
+        dp::Vector<Slot> slots_;    // Power-of-two sized, load factor <= 0.5
+        u32 shift_ = 32;            // Fibonacci hashing: take the top log2(slots) bits
+        usize pgn_count_ = 0;
+        u32 dispatch_depth_ = 0;
+
+      public:
+        // Register a callback for a PGN (compiled on next lookup)
+        void add(PGN pgn, Callback fn) { pending_.push_back({pgn, std::move(fn)}); }
+
+        // True if at least one callback is registered for this PGN
+        bool has_handlers(PGN pgn) {
+            compile();
+            return find_slot(pgn) != nullptr;
+        }
+
+        // Invoke all callbacks registered for msg.pgn. Returns the number invoked.
+        usize dispatch(const MsgT &msg) {
+            compile();
+            const Slot *slot = find_slot(msg.pgn);
+            if (!slot)
+                return 0;
+
+            ++dispatch_depth_;
+            u32 end = slot->first + slot->count;
+            for (u32 i = slot->first; i < end; ++i) {
+                if (entries_[i].fn)
+                    entries_[i].fn(msg);
+            }
+            --dispatch_depth_;
+            return slot->count;
+        }
+
+        usize pgn_count() {
+            compile();
+            return pgn_count_;
+        }
+
+        // Call fn(PGN) once for every PGN with at least one handler, in ascending order
+        template <typename Fn> void for_each_pgn(Fn &&fn) {
+            compile();
+            for (usize i = 0; i < entries_.size(); ++i) {
+                if (i == 0 || entries_[i].pgn != entries_[i - 1].pgn)
+                    fn(entries_[i].pgn);
+            }
+        }
+
+        usize handler_count() const noexcept { return entries_.size() + pending_.size(); }
+
+        void clear() {
+            if (dispatch_depth_ > 0)
+                return;
+            entries_.clear();
+            pending_.clear();
+            slots_.clear();
+            shift_ = 32;
+            pgn_count_ = 0;
+        }
+
+      private:
+        usize home_slot(PGN pgn) const noexcept { return static_cast<u32>(pgn * 2654435761u) >> shift_; }
+
+        const Slot *find_slot(PGN pgn) const noexcept {
+            if (slots_.empty())
+                return nullptr;
+            usize mask = slots_.size() - 1;
+            usize idx = home_slot(pgn);
+            while (slots_[idx].count != 0) {
+                if (slots_[idx].pgn == pgn)
+                    return &slots_[idx];
+                idx = (idx + 1) & mask;
+            }
+            return nullptr;
+        }
+
+        // Merge pending registrations and rebuild the hash index
+        void compile() {
+            if (pending_.empty() || dispatch_depth_ > 0)
+                return;
+
+            // Insertion sort keeps registration order stable within a PGN; registration
+            // is a startup-time operation, so simplicity beats asymptotics here.
+            for (auto &p : pending_) {
+                usize pos = entries_.size();
+                while (pos > 0 && entries_[pos - 1].pgn > p.pgn)
+                    --pos;
+                entries_.insert(entries_.begin() + static_cast<isize>(pos), std::move(p));
+            }
+            pending_.clear();
+
+            pgn_count_ = 0;
+            for (usize i = 0; i < entries_.size(); ++i) {
+                if (i == 0 || entries_[i].pgn != entries_[i - 1].pgn)
+                    ++pgn_count_;
+            }
+
+            usize capacity = MIN_SLOTS;
+            u32 bits = 4;
+            while (capacity < pgn_count_ * 2) {
+                capacity <<= 1;
+                ++bits;
+            }
+            slots_.assign(capacity, Slot{});
+            shift_ = 32 - bits;
+
+            usize mask = capacity - 1;
+            for (usize i = 0; i < entries_.size();) {
+                usize j = i;
+                while (j < entries_.size() && entries_[j].pgn == entries_[i].pgn)
+                    ++j;
+                usize idx = home_slot(entries_[i].pgn);
+                while (slots_[idx].count != 0)
+                    idx = (idx + 1) & mask;
+                slots_[idx] = Slot{entries_[i].pgn, static_cast<u32>(i), static_cast<u32>(j - i)};
+                i = j;
+            }
+        }
+    };
+
+    using PGNDispatchTable = BasicPGNDispatchTable<Message>;
+    using PGNViewDispatchTable = BasicPGNDispatchTable<MessageView>;
+
+    // ─── Compile-time PGN router ─────────────────────────────────────────────────
+    // For firmware whose PGNs are fixed at build time. Each Handler binds a PGN
+    // to a function (pointer or captureless lambda) taking const MessageView &;
+    // dispatch() is a chain of comparisons against constants, which the
+    // optimizer turns into a switch with the handlers inlined. No map lookup,
+    // no std::function. Several handlers may share a PGN; they run in list order.
+    //
+    //   void on_speed(const MessageView &m);
+    //   using Router = StaticRouter<Handler<PGN_WHEEL_SPEED, &on_speed>,
+    //                               Handler<PGN_HEARTBEAT, [](const MessageView &) { ... }>>;
+    //   nm.set_static_router<Router>();
+    template <PGN P, auto Fn> struct Handler {
+        static constexpr PGN pgn = P;
+        static void call(const MessageView &msg) { Fn(msg); }
+    };
+
+    template <typename... Handlers> struct StaticRouter {
+        static constexpr usize size = sizeof...(Handlers);
+        static constexpr PGN pgns[size == 0 ? 1 : size] = {Handlers::pgn...};
+
+        static constexpr bool handles(PGN pgn) noexcept { return ((pgn == Handlers::pgn) || ...); }
+
+        // Run the handlers for msg.pgn; false if the router has none
+        static bool dispatch(const MessageView &msg) {
+            bool hit = false;
+            ((msg.pgn == Handlers::pgn ? (Handlers::call(msg), hit = true) : false), ...);
+            return hit;
+        }
+
+        template <typename Fn> static void for_each_pgn(Fn &&fn) { (fn(Handlers::pgn), ...); }
+    };
+
+} // namespace agrobus::net
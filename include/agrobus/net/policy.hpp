@@ -2,8 +2,11 @@
 
 #include <agrobus/net/error.hpp>
 #include <agrobus/net/event.hpp>
+#include <agrobus/net/last_value.hpp>
 #include <agrobus/net/state_machine.hpp>
+#include <agrobus/net/timer.hpp>
 #include <agrobus/net/types.hpp>
+#include <algorithm>
 #include <datapod/datapod.hpp>
 #include <echo/echo.hpp>
 
@@ -26,13 +29,36 @@ namespace agrobus::net {
     };
 
     // ─── Freshness requirement for a data source ─────────────────────────────────
+    // A source is either reported alive by name (report_alive()) or, when pgn is
+    // set, read from the IsoNet last-value cache passed to use_cache().
     struct FreshnessRequirement {
+        static constexpr PGN NO_PGN = 0xFFFFFFFFu;
+
         dp::String source_name;
         u32 max_age_ms = 500;     // Max allowed age before Degraded
         u32 escalation_ms = 2000; // Time in Degraded before escalating to Emergency
         DegradedAction action = DegradedAction::HoldLast;
+        PGN pgn = NO_PGN;                   // Cached PGN to watch
+        Address source = BROADCAST_ADDRESS; // Its sender, BROADCAST_ADDRESS = any
+
+        static FreshnessRequirement for_pgn(dp::String name, PGN pgn, Address source, u32 max_age_ms,
+                                            u32 escalation_ms = 2000,
+                                            DegradedAction action = DegradedAction::HoldLast) {
+            FreshnessRequirement req;
+            req.source_name = std::move(name);
+            req.max_age_ms = max_age_ms;
+            req.escalation_ms = escalation_ms;
+            req.action = action;
+            req.pgn = pgn;
+            req.source = source;
+            return req;
+        }
     };
 
+    // Index of a requirement, from SafetyPolicy::watch()
+    using FreshnessHandle = u32;
+    inline constexpr FreshnessHandle INVALID_FRESHNESS = 0xFFFFFFFFu;
+
     // ─── Safety configuration ────────────────────────────────────────────────────
     struct SafetyConfig {
         u32 heartbeat_timeout_ms = 500;
@@ -61,27 +87,71 @@ namespace agrobus::net {
     // ─── Safety Policy Manager ───────────────────────────────────────────────────
     // Monitors data source freshness and escalates through safety states:
     //   Normal -> Degraded -> Emergency -> Shutdown
+    // Hot handlers report through the handle from watch(), a plain store. In
+    // Normal, update() only looks at the requirements once the earliest
+    // deadline found by the previous look is reached (reports only ever push
+    // deadlines later), so any number of fresh sources cost one compare per
+    // tick. Degraded checks every tick for escalation and recovery.
     class SafetyPolicy {
+        struct Watched {
+            FreshnessRequirement req;
+            u32 last_seen_ms = 0; // report_alive() time; for PGN sources, when watching (re)started
+        };
+
         SafetyConfig config_;
         StateMachine<SafeState> state_{SafeState::Normal};
-        dp::Vector<FreshnessRequirement> requirements_;
-        dp::Map<dp::String, u32> last_seen_ms_; // source -> last timestamp
+        dp::Vector<Watched> requirements_;
+        const LastValueCache *cache_ = nullptr;
         u32 current_time_ms_ = 0;
         u32 degraded_since_ms_ = 0;
+        u32 next_check_ms_ = NO_DEADLINE; // No requirement can be stale before this
 
       public:
         explicit SafetyPolicy(SafetyConfig config = {}) : config_(std::move(config)) {}
 
         // ─── Freshness requirements ──────────────────────────────────────────────
         SafetyPolicy &require_freshness(FreshnessRequirement req) {
-            last_seen_ms_[req.source_name] = 0;
-            requirements_.push_back(std::move(req));
-            echo::category("isobus.safety").debug("freshness requirement added: ", requirements_.back().source_name);
+            watch(std::move(req));
+            return *this;
+        }
+
+        // Add a requirement and get the handle to report it alive with
+        FreshnessHandle watch(FreshnessRequirement req) {
+            FreshnessHandle handle = static_cast<FreshnessHandle>(requirements_.size());
+            requirements_.push_back(Watched{std::move(req), current_time_ms_});
+            const Watched &w = requirements_.back();
+            next_check_ms_ = std::min(next_check_ms_, stale_at(w));
+            echo::category("isobus.safety").debug("freshness requirement added: ", w.req.source_name);
+            return handle;
+        }
+
+        // Handle of the first requirement named `source` (resolve once, outside hot paths)
+        FreshnessHandle handle(const dp::String &source) const {
+            for (usize i = 0; i < requirements_.size(); ++i) {
+                if (requirements_[i].req.source_name == source)
+                    return static_cast<FreshnessHandle>(i);
+            }
+            return INVALID_FRESHNESS;
+        }
+
+        // Cache that PGN requirements are checked against (IsoNet::last_values())
+        SafetyPolicy &use_cache(const LastValueCache &cache) {
+            cache_ = &cache;
             return *this;
         }
 
         // ─── Report that a source is alive ───────────────────────────────────────
-        void report_alive(const dp::String &source) { last_seen_ms_[source] = current_time_ms_; }
+        void report_alive(FreshnessHandle handle) noexcept {
+            if (handle < requirements_.size())
+                requirements_[handle].last_seen_ms = current_time_ms_;
+        }
+
+        void report_alive(const dp::String &source) {
+            for (auto &w : requirements_) {
+                if (w.req.source_name == source)
+                    w.last_seen_ms = current_time_ms_;
+            }
+        }
 
         // ─── Periodic update (call every tick) ───────────────────────────────────
         void update(u32 elapsed_ms) {
@@ -98,18 +168,20 @@ namespace agrobus::net {
                 return;
             }
 
+            // Nothing can have gone stale yet
+            if (state_.is(SafeState::Normal) && current_time_ms_ < next_check_ms_) {
+                return;
+            }
+
             // Check freshness of all required sources
             bool any_stale = false;
-            for (const auto &req : requirements_) {
-                auto it = last_seen_ms_.find(req.source_name);
-                if (it == last_seen_ms_.end()) {
-                    // Source never seen - considered stale
-                    any_stale = true;
-                    continue;
-                }
-
-                u32 age = current_time_ms_ - it->second;
-                if (age > req.max_age_ms) {
+            next_check_ms_ = NO_DEADLINE;
+            for (const auto &w : requirements_) {
+                const FreshnessRequirement &req = w.req;
+                u32 age = age_of(w);
+                if (age <= req.max_age_ms) {
+                    next_check_ms_ = std::min(next_check_ms_, current_time_ms_ + (req.max_age_ms - age) + 1);
+                } else {
                     any_stale = true;
 
                     // Transition to Degraded if currently Normal
@@ -163,8 +235,10 @@ namespace agrobus::net {
                 echo::category("isobus.safety").info("reset to Normal from state ", static_cast<u8>(prev));
             }
             // Reset freshness timestamps to current time
-            for (auto &[source, ts] : last_seen_ms_) {
-                ts = current_time_ms_;
+            next_check_ms_ = NO_DEADLINE;
+            for (auto &w : requirements_) {
+                w.last_seen_ms = current_time_ms_;
+                next_check_ms_ = std::min(next_check_ms_, stale_at(w));
             }
         }
 
@@ -173,24 +247,25 @@ namespace agrobus::net {
         bool is_safe() const noexcept { return state_.state() == SafeState::Normal; }
         bool is_degraded() const noexcept { return state_.state() == SafeState::Degraded; }
 
+        // Time until update() has anything to check (0 = every tick, NO_DEADLINE = nothing watched)
+        u32 next_deadline_ms() const noexcept {
+            if (!state_.is(SafeState::Normal))
+                return state_.is(SafeState::Degraded) ? 0 : NO_DEADLINE;
+            if (next_check_ms_ == NO_DEADLINE)
+                return NO_DEADLINE;
+            return next_check_ms_ > current_time_ms_ ? next_check_ms_ - current_time_ms_ : 0;
+        }
+
         DegradedAction current_action() const noexcept {
             if (state_.is(SafeState::Normal)) {
                 return config_.default_action; // not really applicable in Normal
             }
             // Find the stale source with the most severe action
             DegradedAction worst = config_.default_action;
-            for (const auto &req : requirements_) {
-                auto it = last_seen_ms_.find(req.source_name);
-                if (it == last_seen_ms_.end()) {
-                    if (static_cast<u8>(req.action) > static_cast<u8>(worst)) {
-                        worst = req.action;
-                    }
-                    continue;
-                }
-                u32 age = current_time_ms_ - it->second;
-                if (age > req.max_age_ms) {
-                    if (static_cast<u8>(req.action) > static_cast<u8>(worst)) {
-                        worst = req.action;
+            for (const auto &w : requirements_) {
+                if (age_of(w) > w.req.max_age_ms) {
+                    if (static_cast<u8>(w.req.action) > static_cast<u8>(worst)) {
+                        worst = w.req.action;
                     }
                 }
             }
@@ -201,5 +276,21 @@ namespace agrobus::net {
         Event<SafeState, SafeState> on_state_change; // old, new
         Event<dp::String> on_source_timeout;         // which source timed out
         Event<dp::String> on_emergency;              // reason
+
+      private:
+        // Earliest time `w` can be stale, counting from its last report
+        u32 stale_at(const Watched &w) const noexcept { return w.last_seen_ms + w.req.max_age_ms + 1; }
+
+        // Named sources age from their last report_alive(). PGN sources age from
+        // their last receipt in the cache, but never more than the time since
+        // watching (re)started, so they get the same grace period at startup
+        // and after reset_to_normal().
+        u32 age_of(const Watched &w) const noexcept {
+            u32 since_reset = current_time_ms_ - w.last_seen_ms;
+            if (w.req.pgn == FreshnessRequirement::NO_PGN)
+                return since_reset;
+            u32 cached = cache_ ? cache_->age_ms(w.req.pgn, w.req.source) : NEVER_SEEN;
+            return cached < since_reset ? cached : since_reset;
+        }
     };
 } // namespace agrobus::net
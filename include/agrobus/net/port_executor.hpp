@@ -0,0 +1,208 @@
+#pragma once
+
+#include "network_manager.hpp"
+#include <agrobus/net/error.hpp>
+#include <agrobus/net/types.hpp>
+#include <atomic>
+#include <chrono>
+#include <datapod/datapod.hpp>
+#include <echo/echo.hpp>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace agrobus::net {
+
+    // ─── Per-port sharded executor ───────────────────────────────────────────────
+    // Runs one IsoNet per CAN port, each on its own worker thread, so receive,
+    // TP/ETP reassembly and address claiming of independent buses scale with
+    // cores. A shard's callbacks run on that shard's thread. Work crosses shards
+    // only through explicit handoff:
+    //   - post(port, task): run task(IsoNet &) on the shard's thread before its
+    //     next update (e.g. forward a message received on another port)
+    //   - defer(fn): queue fn for the owner thread, run by drain()
+    // Configure shards (CFs, callbacks) before start(), or via post() afterwards.
+    class PortExecutor {
+      public:
+        using Task = std::function<void(IsoNet &)>;
+
+      private:
+        struct Shard {
+            u8 port;
+            std::unique_ptr<IsoNet> net;
+            std::mutex mutex;
+            dp::Vector<Task> tasks;
+            dp::Vector<Task> running_tasks;
+            std::atomic<bool> running{false};
+            std::thread thread;
+
+            Shard(u8 p, NetworkConfig cfg) : port(p), net(std::make_unique<IsoNet>(cfg)) {}
+
+            ~Shard() { stop(); }
+
+            void stop() {
+                running.store(false, std::memory_order_release);
+                if (thread.joinable())
+                    thread.join();
+            }
+
+            // Run queued tasks; called on the thread that owns `net`
+            void run_tasks() {
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    running_tasks.swap(tasks);
+                }
+                for (auto &t : running_tasks)
+                    t(*net);
+                running_tasks.clear();
+            }
+        };
+
+        NetworkConfig shard_config_;
+        dp::Vector<std::unique_ptr<Shard>> shards_;
+        std::mutex deferred_mutex_;
+        dp::Vector<std::function<void()>> deferred_;
+        dp::Vector<std::function<void()>> running_deferred_;
+        bool started_ = false;
+
+      public:
+        explicit PortExecutor(NetworkConfig shard_config = {}) : shard_config_(shard_config) {
+            shard_config_.num_ports = 1;
+        }
+
+        ~PortExecutor() { stop(); }
+
+        PortExecutor(const PortExecutor &) = delete;
+        PortExecutor &operator=(const PortExecutor &) = delete;
+
+        // ─── Shard management ─────────────────────────────────────────────────────
+        // Create the shard for a port and attach its endpoint. The shard's IsoNet
+        // keeps the real port number, so CFs are created on `port` as usual.
+        Result<IsoNet *> add_port(u8 port, wirebit::CanEndpoint *ep) {
+            if (started_) {
+                return Result<IsoNet *>::err(Error::invalid_state("executor already started"));
+            }
+            if (find(port)) {
+                return Result<IsoNet *>::err(Error::invalid_state("port already sharded"));
+            }
+            auto shard = std::make_unique<Shard>(port, shard_config_);
+            auto res = shard->net->set_endpoint(port, ep);
+            if (!res.is_ok()) {
+                return Result<IsoNet *>::err(res.error());
+            }
+            IsoNet *net = shard->net.get();
+            shards_.push_back(std::move(shard));
+            echo::category("isobus.executor").debug("shard added for port ", port);
+            return Result<IsoNet *>::ok(net);
+        }
+
+        IsoNet *shard(u8 port) noexcept {
+            Shard *s = find(port);
+            return s ? s->net.get() : nullptr;
+        }
+
+        usize shard_count() const noexcept { return shards_.size(); }
+        bool started() const noexcept { return started_; }
+
+        // ─── Threads ──────────────────────────────────────────────────────────────
+        // One worker per shard, calling IsoNet::update() every tick_ms with the
+        // measured elapsed time.
+        Result<void> start(u32 tick_ms = 1) {
+            if (started_) {
+                return Result<void>::err(Error::invalid_state("executor already started"));
+            }
+            if (shards_.empty()) {
+                return Result<void>::err(Error::invalid_state("no ports"));
+            }
+            for (auto &s : shards_) {
+                Shard *shard = s.get();
+                shard->running.store(true, std::memory_order_release);
+                shard->thread = std::thread([shard, tick_ms]() { worker_main(*shard, tick_ms); });
+            }
+            started_ = true;
+            echo::category("isobus.executor").info("started ", shards_.size(), " shard threads");
+            return {};
+        }
+
+        void stop() {
+            for (auto &s : shards_)
+                s->stop();
+            started_ = false;
+        }
+
+        // Single-threaded step: run posted tasks and update every shard on the
+        // caller's thread (deterministic; only valid while not started)
+        void update(u32 elapsed_ms = 0) {
+            if (started_)
+                return;
+            for (auto &s : shards_) {
+                s->run_tasks();
+                s->net->update(elapsed_ms);
+            }
+        }
+
+        // ─── Cross-shard handoff ──────────────────────────────────────────────────
+        // Thread-safe. Runs task on the shard's thread before its next update.
+        Result<void> post(u8 port, Task task) {
+            if (!task) {
+                return Result<void>::err(Error::invalid_state("null task"));
+            }
+            Shard *s = find(port);
+            if (!s) {
+                return Result<void>::err(Error::invalid_state("no shard for port"));
+            }
+            std::lock_guard<std::mutex> lock(s->mutex);
+            s->tasks.push_back(std::move(task));
+            return {};
+        }
+
+        // Thread-safe. Queue fn to run on the owner thread in drain().
+        void defer(std::function<void()> fn) {
+            if (!fn)
+                return;
+            std::lock_guard<std::mutex> lock(deferred_mutex_);
+            deferred_.push_back(std::move(fn));
+        }
+
+        // Run deferred callbacks on the calling thread. Returns the number run.
+        usize drain() {
+            {
+                std::lock_guard<std::mutex> lock(deferred_mutex_);
+                running_deferred_.swap(deferred_);
+            }
+            usize n = running_deferred_.size();
+            for (auto &fn : running_deferred_)
+                fn();
+            running_deferred_.clear();
+            return n;
+        }
+
+      private:
+        Shard *find(u8 port) noexcept {
+            for (auto &s : shards_) {
+                if (s->port == port)
+                    return s.get();
+            }
+            return nullptr;
+        }
+
+        static void worker_main(Shard &shard, u32 tick_ms) {
+            using clock = std::chrono::steady_clock;
+            auto last = clock::now();
+            u64 carry_us = 0;
+            while (shard.running.load(std::memory_order_acquire)) {
+                auto now = clock::now();
+                carry_us += static_cast<u64>(std::chrono::duration_cast<std::chrono::microseconds>(now - last).count());
+                last = now;
+                u32 elapsed_ms = static_cast<u32>(carry_us / 1000);
+                carry_us %= 1000;
+
+                shard.run_tasks();
+                shard.net->update(elapsed_ms);
+                std::this_thread::sleep_for(std::chrono::milliseconds(tick_ms));
+            }
+        }
+    };
+
+} // namespace agrobus::net
@@ -0,0 +1,138 @@
+#pragma once
+
+#include "data_span.hpp"
+#include "event.hpp"
+#include "frame.hpp"
+#include "identifier.hpp"
+#include "internal_cf.hpp"
+#include "latency.hpp"
+#include "network_manager.hpp"
+#include "types.hpp"
+#include <datapod/datapod.hpp>
+
+namespace agrobus::net {
+
+    // ─── Send confirmation ───────────────────────────────────────────────────────
+    struct RealtimeSend {
+        u32 sequence = 0;      // 1 for the first frame of the channel
+        u64 requested_ns = 0;  // send() called
+        u64 written_ns = 0;    // Endpoint accepted the frame
+    };
+
+    // ─── Real-time single-frame command channel ──────────────────────────────────
+    // One PGN from one control function, for closed-loop commands (auto-steer
+    // curvature at 100 Hz) that must not wait behind the rest of the traffic.
+    // The frame is encoded once and edited in place through payload(); the
+    // identifier is only rebuilt when our address changes. send() writes it
+    // straight to the port's endpoint (IsoNet::forward_frame): no TX queue, no
+    // token bucket and no allocation, from inside update() as well, so the
+    // frame leaves when the control loop asks and not at the next TX flush.
+    //
+    // Every send is timestamped on the channel clock (monotonic_ns unless
+    // replaced) and confirmed through on_sent. With a period set, the distance
+    // of each send interval from the period goes into the jitter histogram;
+    // the time the endpoint took to accept the frame goes into write_latency.
+    class RealtimeChannel {
+        IsoNet &net_;
+        InternalCF *cf_;
+        PGN pgn_;
+        Priority priority_;
+        Address destination_ = BROADCAST_ADDRESS;
+        Frame frame_;
+        Address encoded_source_ = NULL_ADDRESS; // Source address frame_.id was built for
+        LatencyClock clock_ = &monotonic_ns;
+        u64 period_ns_ = 0;
+        u64 last_ns_ = 0;
+        u32 sequence_ = 0;
+        u64 failed_ = 0;
+        LatencyHistogram jitter_;
+        LatencyHistogram write_;
+
+      public:
+        RealtimeChannel(IsoNet &net, InternalCF *cf, PGN pgn, Priority priority = Priority::Normal,
+                        u32 period_ms = 0)
+            : net_(net), cf_(cf), pgn_(pgn), priority_(priority), period_ns_(static_cast<u64>(period_ms) * 1000000) {
+            frame_.data.fill(0xFF);
+        }
+
+        RealtimeChannel(const RealtimeChannel &) = delete;
+        RealtimeChannel &operator=(const RealtimeChannel &) = delete;
+
+        // ─── Setup ───────────────────────────────────────────────────────────────
+        void set_destination(Address dst) {
+            destination_ = dst;
+            encoded_source_ = NULL_ADDRESS;
+        }
+        void set_priority(Priority priority) {
+            priority_ = priority;
+            encoded_source_ = NULL_ADDRESS;
+        }
+        void set_period_ms(u32 period_ms) {
+            period_ns_ = static_cast<u64>(period_ms) * 1000000;
+            last_ns_ = 0;
+        }
+        void set_clock(LatencyClock clock) { clock_ = clock ? clock : &monotonic_ns; }
+
+        PGN pgn() const noexcept { return pgn_; }
+        Priority priority() const noexcept { return priority_; }
+
+        // ─── Sending ─────────────────────────────────────────────────────────────
+        // The 8 data bytes of the frame; they keep their value between sends
+        u8 *payload() noexcept { return frame_.data.data(); }
+        DataSpan data() const noexcept { return DataSpan(frame_.data.data(), frame_.length); }
+
+        // Send the frame as it is now
+        Result<void> send() {
+            if (!cf_ || !cf_->cf().address_valid()) {
+                ++failed_;
+                return Result<void>::err(Error::not_connected());
+            }
+            Address source = cf_->address();
+            if (source != encoded_source_) {
+                frame_.id = Identifier::encode(priority_, pgn_, source, destination_);
+                encoded_source_ = source;
+            }
+            u64 requested = clock_();
+            auto result = net_.forward_frame(frame_, cf_->port());
+            u64 written = clock_();
+            if (result.is_err()) {
+                ++failed_;
+                return result;
+            }
+            write_.record(written - requested);
+            if (period_ns_ != 0 && last_ns_ != 0) {
+                u64 interval = requested - last_ns_;
+                jitter_.record(interval > period_ns_ ? interval - period_ns_ : period_ns_ - interval);
+            }
+            last_ns_ = requested;
+            on_sent.emit(RealtimeSend{++sequence_, requested, written});
+            return {};
+        }
+
+        // Replace the data (up to 8 bytes, the rest 0xFF) and send
+        Result<void> send(DataSpan bytes) {
+            usize n = bytes.size() > 8 ? 8 : bytes.size();
+            for (usize i = 0; i < 8; ++i)
+                frame_.data[i] = i < n ? bytes[i] : 0xFF;
+            return send();
+        }
+
+        // ─── Statistics ──────────────────────────────────────────────────────────
+        u32 sent() const noexcept { return sequence_; }
+        u64 failed() const noexcept { return failed_; }
+        const LatencyHistogram &jitter() const noexcept { return jitter_; }
+        const LatencyHistogram &write_latency() const noexcept { return write_; }
+
+        // Sequence numbers keep counting
+        void reset_stats() {
+            jitter_.reset();
+            write_.reset();
+            failed_ = 0;
+            last_ns_ = 0;
+        }
+
+        // ─── Events ──────────────────────────────────────────────────────────────
+        Event<const RealtimeSend &> on_sent;
+    };
+
+} // namespace agrobus::net
@@ -1,6 +1,9 @@
 #pragma once
 
 #include "timer.hpp"
+#include "timer_wheel.hpp"
+#include <agrobus/net/error.hpp>
+#include <agrobus/net/static_alloc.hpp>
 #include <agrobus/net/types.hpp>
 #include <datapod/datapod.hpp>
 #include <functional>
@@ -9,85 +12,133 @@ namespace agrobus::net {
 
     // ─── Periodic task scheduler ──────────────────────────────────────────────────
     // Lightweight scheduling mechanism for periodic messages and retries.
-    // Similar in spirit to AgIsoStack++'s ProcessingFlags.
+    // Similar in spirit to AgIsoStack++'s ProcessingFlags. Each enabled task
+    // is a periodic timer on a TimerWheel, so update() only touches due tasks.
+    // Tasks fire at phase + k * interval on the scheduler's own clock, so a
+    // coarse or uneven update() never makes them drift; give tasks with the
+    // same interval different phases to keep them from firing together.
+    // In the static allocation profile the task list, the wheel and the due
+    // list are reserved for AGROBUS_MAX_SCHEDULER_TASKS up front and try_add()
+    // fails once it is reached.
 
     struct PeriodicTask {
         dp::String name;
         u32 interval_ms = 0;
-        u32 elapsed_ms = 0;
+        u32 phase_ms = 0;
         bool enabled = true;
         u8 max_retries = 0; // 0 = unlimited
         u8 retry_count = 0;
         std::function<bool()> callback; // Returns true if task completed, false to retry
-
-        bool due() const noexcept { return enabled && elapsed_ms >= interval_ms; }
+        TimerId timer = INVALID_TIMER;
     };
 
     class Scheduler {
         dp::Vector<PeriodicTask> tasks_;
+        TimerWheel wheel_; // Tag = task index
+        dp::Vector<u32> due_;
 
       public:
-        Scheduler() = default;
+        Scheduler() {
+            if constexpr (static_alloc::enabled) {
+                tasks_.reserve(static_alloc::scheduler_tasks);
+                wheel_.reserve(static_alloc::scheduler_tasks);
+                due_.reserve(static_alloc::scheduler_tasks);
+            }
+        }
+
+        // add() that reports a full task list in the static allocation profile
+        Result<usize> try_add(dp::String name, u32 interval_ms, std::function<bool()> callback, u8 max_retries = 0,
+                              u32 phase_ms = 0) {
+            if (static_alloc::full(tasks_.size(), static_alloc::scheduler_tasks))
+                return Result<usize>::err(static_alloc::exhausted("scheduler tasks full"));
+            return Result<usize>::ok(add(std::move(name), interval_ms, std::move(callback), max_retries, phase_ms));
+        }
 
         // Add a periodic task. Returns the task index.
-        usize add(dp::String name, u32 interval_ms, std::function<bool()> callback, u8 max_retries = 0) {
+        usize add(dp::String name, u32 interval_ms, std::function<bool()> callback, u8 max_retries = 0,
+                  u32 phase_ms = 0) {
             PeriodicTask task;
             task.name = std::move(name);
             task.interval_ms = interval_ms;
+            task.phase_ms = phase_ms;
             task.callback = std::move(callback);
             task.max_retries = max_retries;
             tasks_.push_back(std::move(task));
+            arm(tasks_.size() - 1);
             return tasks_.size() - 1;
         }
 
         // Enable/disable a task by index
         void enable(usize index, bool enabled = true) {
             if (index < tasks_.size()) {
-                tasks_[index].enabled = enabled;
+                auto &task = tasks_[index];
+                task.enabled = enabled;
+                wheel_.cancel(task.timer);
+                task.timer = INVALID_TIMER;
                 if (enabled) {
-                    tasks_[index].elapsed_ms = 0;
-                    tasks_[index].retry_count = 0;
+                    task.retry_count = 0;
+                    arm(index);
                 }
             }
         }
 
         void disable(usize index) { enable(index, false); }
 
-        // Set a flag to immediately trigger a task on next update
+        // Set a flag to immediately trigger a task on next update (the task's
+        // schedule is re-anchored to that moment)
         void trigger(usize index) {
+            if (index < tasks_.size() && tasks_[index].enabled)
+                wheel_.reschedule(tasks_[index].timer, 0);
+        }
+
+        // Move a task to a new phase within its interval
+        void set_phase(usize index, u32 phase_ms) {
             if (index < tasks_.size()) {
-                tasks_[index].elapsed_ms = tasks_[index].interval_ms;
+                tasks_[index].phase_ms = phase_ms;
+                wheel_.set_period(tasks_[index].timer, tasks_[index].interval_ms, phase_ms);
             }
         }
 
-        // Update all tasks
+        // Run the tasks that came due. A task fires at most once per update;
+        // deadlines a long update skipped over are dropped, not replayed.
         void update(u32 elapsed_ms) {
-            for (auto &task : tasks_) {
-                if (!task.enabled)
+            due_.clear();
+            wheel_.advance(elapsed_ms, [this](TimerId, u32 index) { due_.push_back(index); });
+            for (u32 index : due_) {
+                if (!tasks_[index].enabled)
                     continue;
-
-                task.elapsed_ms += elapsed_ms;
-                if (task.due()) {
-                    task.elapsed_ms = 0;
-                    if (task.callback) {
-                        bool completed = task.callback();
-                        if (!completed) {
-                            task.retry_count++;
-                            if (task.max_retries > 0 && task.retry_count >= task.max_retries) {
-                                task.enabled = false;
-                            }
-                        } else {
-                            task.retry_count = 0;
-                        }
+                // The callback may add tasks, so re-index afterwards
+                bool completed = !tasks_[index].callback || tasks_[index].callback();
+                auto &task = tasks_[index];
+                if (!completed) {
+                    task.retry_count++;
+                    if (task.max_retries > 0 && task.retry_count >= task.max_retries) {
+                        task.enabled = false;
+                        wheel_.cancel(task.timer);
+                        task.timer = INVALID_TIMER;
                     }
+                } else {
+                    task.retry_count = 0;
                 }
             }
         }
 
+        // Time until the next enabled task is due
+        u32 next_deadline_ms() const noexcept { return wheel_.next_deadline_ms(); }
+
         usize count() const noexcept { return tasks_.size(); }
         bool is_enabled(usize index) const noexcept { return index < tasks_.size() && tasks_[index].enabled; }
 
-        void clear() { tasks_.clear(); }
+        void clear() {
+            tasks_.clear();
+            wheel_.clear();
+        }
+
+      private:
+        void arm(usize index) {
+            auto &task = tasks_[index];
+            task.timer = wheel_.schedule_every_tag(task.interval_ms, task.phase_ms, static_cast<u32>(index));
+        }
     };
 
     // ─── Processing flags (bit-based task triggering) ─────────────────────────────
@@ -4,6 +4,7 @@
 #include <agrobus/net/control_function.hpp>
 #include <agrobus/net/types.hpp>
 #include <datapod/datapod.hpp>
+#include <memory>
 
 namespace agrobus::net {
 
@@ -36,12 +37,45 @@ namespace agrobus::net {
         Aborted
     };
 
+    // ─── Caller-owned transmit payload ───────────────────────────────────────────
+    // Handed to send_shared(): the session reads DT slices straight from it and
+    // keeps it alive until the session ends, so large uploads are never copied.
+    using SharedPayload = std::shared_ptr<const dp::Vector<u8>>;
+
+    // ─── Port set ────────────────────────────────────────────────────────────────
+    // The few CAN ports a transport engine has been told to pause or hold
+    class PortSet {
+        dp::Vector<u8> ports_;
+
+      public:
+        void set(u8 port, bool member) {
+            for (usize i = 0; i < ports_.size(); ++i) {
+                if (ports_[i] == port) {
+                    if (!member)
+                        ports_.erase(ports_.begin() + static_cast<std::ptrdiff_t>(i));
+                    return;
+                }
+            }
+            if (member)
+                ports_.push_back(port);
+        }
+
+        bool contains(u8 port) const noexcept {
+            for (u8 p : ports_) {
+                if (p == port)
+                    return true;
+            }
+            return false;
+        }
+    };
+
     // ─── Transport session ───────────────────────────────────────────────────────
     struct TransportSession {
         TransportDirection direction = TransportDirection::Receive;
         SessionState state = SessionState::None;
         PGN pgn = 0;
         dp::Vector<u8> data;
+        SharedPayload shared_data; // TX only: referenced instead of copied into `data`
         u32 total_bytes = 0;
         u32 bytes_transferred = 0;
         u8 source_address = NULL_ADDRESS;
@@ -58,12 +92,30 @@ namespace agrobus::net {
         // CTS windowing (receiver-side tracking)
         u8 cts_window_start = 1;
         u8 cts_window_size = 0;
+        u32 window_gap_ms = 0;        // Largest DT gap in the current window (adaptive CTS)
+        u8 gap_requests = 0;          // CTS re-requests for missing packets in the current window
+        bool awaiting_resend = false; // Rest of the window after a gap is dropped until the resend
 
         // ETP: DPO packet offset for current window
         u32 dpo_packet_offset = 0;
 
+        // ETP RX streaming: `data` holds only the current DPO window, which is
+        // handed out through on_chunk instead of reassembling the whole message
+        bool streaming = false;
+
         // Timing
         u32 timer_ms = 0;
+        u32 age_ms = 0; // Since the session opened (transport metrics)
+
+        u32 budget_bytes = 0; // Buffer bytes charged to the transport MemoryBudget
+        u32 limit_bytes = 0;  // Bytes reserved in the TransportLimits (receive sessions)
+
+        // RX timestamps (µs) of the first (RTS/BAM) and most recent frame of the session
+        u64 first_timestamp_us = 0;
+        u64 last_timestamp_us = 0;
+
+        // Bytes being transferred (the shared payload when sending zero-copy)
+        const u8 *payload() const noexcept { return shared_data ? shared_data->data() : data.data(); }
 
         f32 progress() const noexcept {
             if (total_bytes == 0)
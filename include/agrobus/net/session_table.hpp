@@ -0,0 +1,168 @@
+#pragma once
+
+#include "session.hpp"
+#include <agrobus/net/types.hpp>
+#include <datapod/datapod.hpp>
+
+namespace agrobus::net {
+
+    // ─── Fixed-capacity transport session table ─────────────────────────────────
+    // Sessions live in a slot array allocated once, so a TransportSession never
+    // moves while it is open (pointers stay valid until erase). A linear-probing
+    // index keyed by (direction, port, source, destination) makes per-frame
+    // lookup independent of how many sessions are open; erase uses backward-shift
+    // deletion, so the index never accumulates tombstones. Iteration via at(i)
+    // follows insertion order, which keeps timer processing deterministic.
+    class TransportSessionTable {
+      public:
+        static constexpr usize DEFAULT_CAPACITY = 64;
+
+      private:
+        static constexpr u16 EMPTY = 0xFFFF;
+
+        dp::Vector<TransportSession> slots_;
+        dp::Vector<bool> used_;
+        dp::Vector<u16> free_;  // Free slot stack
+        dp::Vector<u16> order_; // Occupied slots in insertion order
+        dp::Vector<u16> index_; // Slot number or EMPTY, power-of-two sized
+        u32 shift_ = 32;
+
+      public:
+        explicit TransportSessionTable(usize capacity = DEFAULT_CAPACITY) {
+            if (capacity == 0)
+                capacity = 1;
+            if (capacity >= EMPTY)
+                capacity = EMPTY - 1;
+            slots_.resize(capacity);
+            used_.resize(capacity, false);
+            free_.reserve(capacity);
+            for (usize i = capacity; i > 0; --i)
+                free_.push_back(static_cast<u16>(i - 1));
+            order_.reserve(capacity);
+
+            usize buckets = 2;
+            u32 bits = 1;
+            while (buckets < capacity * 2) {
+                buckets <<= 1;
+                ++bits;
+            }
+            index_.resize(buckets, EMPTY);
+            shift_ = 32 - bits;
+        }
+
+        static constexpr u32 make_key(TransportDirection dir, u8 port, Address src, Address dst) noexcept {
+            return (static_cast<u32>(dir == TransportDirection::Transmit) << 24) | (static_cast<u32>(port) << 16) |
+                   (static_cast<u32>(src) << 8) | static_cast<u32>(dst);
+        }
+
+        static u32 key_of(const TransportSession &s) noexcept {
+            return make_key(s.direction, s.can_port, s.source_address, s.destination_address);
+        }
+
+        usize size() const noexcept { return order_.size(); }
+        usize capacity() const noexcept { return slots_.size(); }
+        bool empty() const noexcept { return order_.empty(); }
+        bool full() const noexcept { return free_.empty(); }
+
+        // Move a session into a free slot. Returns nullptr when the table is full.
+        TransportSession *insert(TransportSession &&session) {
+            if (free_.empty())
+                return nullptr;
+            u16 slot = free_.back();
+            free_.pop_back();
+            slots_[slot] = std::move(session);
+            used_[slot] = true;
+            order_.push_back(slot);
+
+            usize mask = index_.size() - 1;
+            usize pos = home(key_of(slots_[slot]));
+            while (index_[pos] != EMPTY)
+                pos = (pos + 1) & mask;
+            index_[pos] = slot;
+            return &slots_[slot];
+        }
+
+        // First session with this key for which pred(const TransportSession &) holds
+        template <typename Pred>
+        TransportSession *find_if(TransportDirection dir, u8 port, Address src, Address dst, Pred &&pred) {
+            u32 key = make_key(dir, port, src, dst);
+            usize mask = index_.size() - 1;
+            for (usize pos = home(key); index_[pos] != EMPTY; pos = (pos + 1) & mask) {
+                TransportSession &s = slots_[index_[pos]];
+                if (key_of(s) == key && pred(s))
+                    return &s;
+            }
+            return nullptr;
+        }
+
+        TransportSession *find(TransportDirection dir, u8 port, Address src, Address dst) {
+            return find_if(dir, port, src, dst, [](const TransportSession &) { return true; });
+        }
+
+        // i-th open session in insertion order
+        TransportSession &at(usize i) noexcept { return slots_[order_[i]]; }
+        const TransportSession &at(usize i) const noexcept { return slots_[order_[i]]; }
+
+        void erase(TransportSession *session) {
+            if (!session || session < slots_.data() || session >= slots_.data() + slots_.size())
+                return;
+            u16 slot = static_cast<u16>(session - slots_.data());
+            if (!used_[slot])
+                return;
+            for (usize i = 0; i < order_.size(); ++i) {
+                if (order_[i] == slot) {
+                    order_.erase(order_.begin() + static_cast<isize>(i));
+                    break;
+                }
+            }
+            release(slot);
+        }
+
+        // Erase the i-th open session (insertion order); the next one moves to i
+        void erase_at(usize i) {
+            u16 slot = order_[i];
+            order_.erase(order_.begin() + static_cast<isize>(i));
+            release(slot);
+        }
+
+        void clear() {
+            while (!order_.empty())
+                erase_at(order_.size() - 1);
+        }
+
+      private:
+        usize home(u32 key) const noexcept { return static_cast<u32>(key * 2654435761u) >> shift_; }
+
+        void release(u16 slot) {
+            unlink(slot);
+            slots_[slot] = TransportSession{};
+            used_[slot] = false;
+            free_.push_back(slot);
+        }
+
+        // Remove a slot from the index with backward-shift deletion
+        void unlink(u16 slot) {
+            usize mask = index_.size() - 1;
+            usize pos = home(key_of(slots_[slot]));
+            while (index_[pos] != slot) {
+                if (index_[pos] == EMPTY)
+                    return;
+                pos = (pos + 1) & mask;
+            }
+            usize hole = pos;
+            usize next = (hole + 1) & mask;
+            while (index_[next] != EMPTY) {
+                usize h = home(key_of(slots_[index_[next]]));
+                // Move the entry back if its home is not within (hole, next]
+                bool in_range = hole <= next ? (h > hole && h <= next) : (h > hole || h <= next);
+                if (!in_range) {
+                    index_[hole] = index_[next];
+                    hole = next;
+                }
+                next = (next + 1) & mask;
+            }
+            index_[hole] = EMPTY;
+        }
+    };
+
+} // namespace agrobus::net
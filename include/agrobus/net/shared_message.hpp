@@ -0,0 +1,111 @@
+#pragma once
+
+#include "buffer_pool.hpp"
+#include "data_span.hpp"
+#include "message.hpp"
+#include "session.hpp"
+#include "types.hpp"
+#include <cstring>
+#include <datapod/datapod.hpp>
+#include <memory>
+#include <mutex>
+
+namespace agrobus::net {
+
+    // ─── Buffers handed back from any thread ─────────────────────────────────────
+    // BufferPool belongs to the network thread. A shared payload may die on a
+    // consumer's thread, so its bytes come back here, under a lock, and
+    // IsoNet::update() moves them into the pool.
+    class BufferReturns {
+        std::mutex mutex_;
+        dp::Vector<dp::Vector<u8>> returned_;
+
+      public:
+        void push(dp::Vector<u8> &&buf) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            returned_.push_back(std::move(buf));
+        }
+
+        // Buffers moved into `pool`
+        usize drain(BufferPool &pool) {
+            dp::Vector<dp::Vector<u8>> batch;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (returned_.empty())
+                    return 0;
+                batch.swap(returned_);
+            }
+            for (auto &buf : batch)
+                pool.release(std::move(buf));
+            return batch.size();
+        }
+    };
+
+    // ─── Immutable refcounted payload ────────────────────────────────────────────
+    // A received payload as the SharedPayload that send_shared() takes: bytes
+    // written once and never again, shared by every holder. Copying it bumps
+    // an atomic count, so a logger, UI and telemetry thread each keep a pool
+    // or DDOP without copying its bytes, and a gateway sends it on as it is.
+    // The buffer and its count live in one allocation; a buffer adopted with
+    // `returns` goes back to the BufferPool it came from when the last holder
+    // lets go, on whatever thread that is.
+    namespace detail {
+        struct SharedBlock {
+            dp::Vector<u8> bytes;
+            std::weak_ptr<BufferReturns> returns;
+
+            SharedBlock(dp::Vector<u8> &&b, std::weak_ptr<BufferReturns> r)
+                : bytes(std::move(b)), returns(std::move(r)) {}
+            ~SharedBlock() {
+                if (auto r = returns.lock())
+                    r->push(std::move(bytes));
+            }
+        };
+    } // namespace detail
+
+    // Takes over `bytes`
+    inline SharedPayload adopt_payload(dp::Vector<u8> &&bytes, std::weak_ptr<BufferReturns> returns = {}) {
+        auto block = std::make_shared<detail::SharedBlock>(std::move(bytes), std::move(returns));
+        const dp::Vector<u8> *at = &block->bytes;
+        return SharedPayload(std::move(block), at);
+    }
+
+    // A copy of `bytes` in a buffer from `pool`
+    inline SharedPayload copy_payload(DataSpan bytes, BufferPool &pool, std::weak_ptr<BufferReturns> returns = {}) {
+        dp::Vector<u8> buf = pool.acquire(bytes.size());
+        if (!bytes.empty())
+            std::memcpy(buf.data(), bytes.data(), bytes.size());
+        return adopt_payload(std::move(buf), std::move(returns));
+    }
+
+    // ─── Shared message ──────────────────────────────────────────────────────────
+    // A received message whose payload can be kept and passed between threads
+    // for the price of a refcount (IsoNet::on_shared_message)
+    struct SharedMessage {
+        PGN pgn = 0;
+        SharedPayload data;
+        Address source = NULL_ADDRESS;
+        Address destination = BROADCAST_ADDRESS;
+        Priority priority = Priority::Default;
+        u64 timestamp_us = 0;
+        u64 first_timestamp_us = 0;
+
+        SharedMessage() = default;
+        SharedMessage(const MessageView &view, SharedPayload payload)
+            : pgn(view.pgn), data(std::move(payload)), source(view.source), destination(view.destination),
+              priority(view.priority), timestamp_us(view.timestamp_us), first_timestamp_us(view.first_timestamp_us) {}
+
+        DataSpan bytes() const noexcept { return data ? DataSpan(*data) : DataSpan(); }
+
+        // Decoders taking a view read the shared bytes in place
+        MessageView view() const {
+            MessageView v(pgn, bytes(), source, destination, priority, timestamp_us);
+            v.first_timestamp_us = first_timestamp_us;
+            return v;
+        }
+
+        usize size() const noexcept { return data ? data->size() : 0; }
+        bool is_broadcast() const noexcept { return destination == BROADCAST_ADDRESS; }
+    };
+
+} // namespace agrobus::net
@@ -0,0 +1,297 @@
+#pragma once
+
+#include <agrobus/net/error.hpp>
+#include <agrobus/net/eth_can.hpp>
+#include <agrobus/net/types.hpp>
+#include <atomic>
+#include <chrono>
+#include <echo/echo.hpp>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+#include <wirebit/can/can_endpoint.hpp>
+
+namespace agrobus::net {
+
+    // ─── Shared-memory bus configuration ─────────────────────────────────────────
+    struct ShmBusConfig {
+        dp::String name = "/agrobus_bus0"; // POSIX shm object
+        u32 capacity = 65536;              // Frames in the ring (rounded up to a power of two)
+        bool create = true;                // Create the segment if it does not exist yet
+        bool unlink_on_close = false;      // Remove the segment when this process closes it
+
+        ShmBusConfig &segment(dp::String n) {
+            name = std::move(n);
+            return *this;
+        }
+        ShmBusConfig &frames(u32 n) {
+            capacity = n;
+            return *this;
+        }
+        ShmBusConfig &attach_only() {
+            create = false;
+            return *this;
+        }
+        ShmBusConfig &owner(bool unlink) {
+            unlink_on_close = unlink;
+            return *this;
+        }
+    };
+
+    // ─── ShmBus: multi-process CAN bus in shared memory ──────────────────────────
+    // One ring of timestamped frames in a POSIX shm segment that any number of
+    // processes on the host attach to as a CAN endpoint: a single SocketCAN
+    // reader publishes the bus once and the VT renderer, TC logger and control
+    // process all read it without their own sockets or copies through the
+    // kernel. Every attached process can also send.
+    //
+    // Writers reserve a slot with one fetch_add and publish it by storing its
+    // sequence number; readers keep a private cursor and validate each slot
+    // seqlock-style, so nobody takes a lock and a slow reader never blocks a
+    // writer. A reader that falls a whole ring behind skips ahead and counts
+    // the frames it lost. Frames a process sent itself are not delivered back
+    // to it, as on a CAN socket.
+    //
+    // Usage:
+    //   ShmBus bus;
+    //   if (bus.open(ShmBusConfig{}.segment("/tractor_bus")).is_ok()) {
+    //       nm.set_endpoint(0, &bus.can_endpoint());
+    //       nm.set_rx_source(0, bus.rx_source());
+    //       nm.set_rx_clock([&] { return bus.last_timestamp_us(); }); // Publisher's timestamps
+    //   }
+    class ShmBus {
+        static constexpr u32 MAGIC = 0x41475342; // "AGSB"
+        static constexpr u32 VERSION = 1;
+
+        struct Slot {
+            std::atomic<u64> seq; // Position + 1 once published, 0 while being written
+            u64 timestamp_us;
+            u32 can_id;
+            u16 writer;
+            u8 dlc;
+            u8 flags;
+            u8 data[8];
+        };
+        static_assert(sizeof(Slot) == 32);
+        static_assert(std::atomic<u64>::is_always_lock_free);
+
+        struct alignas(64) Header {
+            std::atomic<u32> magic;
+            u32 version;
+            u32 capacity;
+            std::atomic<u32> next_writer;
+            alignas(64) std::atomic<u64> write_seq; // Next position to reserve
+        };
+
+        ShmBusConfig config_;
+        int fd_ = -1;
+        void *map_ = nullptr;
+        usize map_size_ = 0;
+        Header *header_ = nullptr;
+        Slot *slots_ = nullptr;
+        u64 mask_ = 0;
+        u16 writer_id_ = 0;
+
+        u64 cursor_ = 0; // Next position to read
+        u64 lost_ = 0;
+        u64 last_timestamp_us_ = 0;
+
+        std::shared_ptr<CanTunnelLink<ShmBus>> link_;
+        wirebit::CanEndpoint can_ep_;
+
+      public:
+        ShmBus()
+            : link_(std::make_shared<CanTunnelLink<ShmBus>>(this, "shm_bus")),
+              can_ep_(std::static_pointer_cast<wirebit::Link>(link_), wirebit::CanConfig{.bitrate = 250000}, 0) {}
+
+        ~ShmBus() { close(); }
+
+        // The CAN endpoint points back here
+        ShmBus(const ShmBus &) = delete;
+        ShmBus &operator=(const ShmBus &) = delete;
+
+        // ─── Attach ──────────────────────────────────────────────────────────────
+        // Map the segment, creating it when allowed. Reading starts at the
+        // current end of the ring.
+        Result<void> open(ShmBusConfig config = {}) {
+            close();
+            config_ = std::move(config);
+            u32 capacity = 1;
+            while (capacity < config_.capacity)
+                capacity <<= 1;
+
+            bool created = false;
+            if (config_.create) {
+                fd_ = ::shm_open(config_.name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0660);
+                created = fd_ >= 0;
+            }
+            if (fd_ < 0)
+                fd_ = ::shm_open(config_.name.c_str(), O_RDWR, 0);
+            if (fd_ < 0)
+                return Result<void>::err(Error(ErrorCode::DriverError, "shm_open failed"));
+
+            if (created) {
+                map_size_ = sizeof(Header) + static_cast<usize>(capacity) * sizeof(Slot);
+                if (::ftruncate(fd_, static_cast<off_t>(map_size_)) < 0) {
+                    close();
+                    return Result<void>::err(Error(ErrorCode::DriverError, "ftruncate failed"));
+                }
+            } else {
+                // Wait briefly for the creator to size and initialize the segment
+                struct stat st {};
+                for (u32 tries = 0; tries < 100; ++tries) {
+                    if (::fstat(fd_, &st) == 0 && static_cast<usize>(st.st_size) > sizeof(Header))
+                        break;
+                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                }
+                map_size_ = static_cast<usize>(st.st_size);
+                if (map_size_ <= sizeof(Header)) {
+                    close();
+                    return Result<void>::err(Error::invalid_state("shm segment not initialized"));
+                }
+            }
+
+            map_ = ::mmap(nullptr, map_size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+            if (map_ == MAP_FAILED) {
+                map_ = nullptr;
+                close();
+                return Result<void>::err(Error(ErrorCode::DriverError, "mmap failed"));
+            }
+            header_ = static_cast<Header *>(map_);
+            slots_ = reinterpret_cast<Slot *>(static_cast<u8 *>(map_) + sizeof(Header));
+
+            if (created) {
+                header_->version = VERSION;
+                header_->capacity = capacity;
+                header_->next_writer.store(1, std::memory_order_relaxed);
+                header_->write_seq.store(0, std::memory_order_relaxed);
+                for (u32 i = 0; i < capacity; ++i)
+                    slots_[i].seq.store(0, std::memory_order_relaxed);
+                header_->magic.store(MAGIC, std::memory_order_release);
+            } else {
+                for (u32 tries = 0; tries < 100 && header_->magic.load(std::memory_order_acquire) != MAGIC; ++tries)
+                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                if (header_->magic.load(std::memory_order_acquire) != MAGIC || header_->version != VERSION ||
+                    sizeof(Header) + static_cast<usize>(header_->capacity) * sizeof(Slot) > map_size_) {
+                    close();
+                    return Result<void>::err(Error::invalid_state("not an agrobus shm bus"));
+                }
+            }
+
+            mask_ = header_->capacity - 1;
+            writer_id_ = static_cast<u16>(header_->next_writer.fetch_add(1, std::memory_order_relaxed));
+            cursor_ = header_->write_seq.load(std::memory_order_acquire);
+            echo::category("isobus.shm_bus")
+                .info(created ? "created " : "attached ", config_.name.c_str(), " frames=", header_->capacity);
+            return {};
+        }
+
+        void close() {
+            if (map_)
+                ::munmap(map_, map_size_);
+            map_ = nullptr;
+            header_ = nullptr;
+            slots_ = nullptr;
+            if (fd_ >= 0) {
+                ::close(fd_);
+                fd_ = -1;
+                if (config_.unlink_on_close)
+                    ::shm_unlink(config_.name.c_str());
+            }
+        }
+
+        bool is_open() const noexcept { return header_ != nullptr; }
+
+        // Get the CAN endpoint (pass to IsoNet::set_endpoint)
+        wirebit::CanEndpoint &can_endpoint() noexcept { return can_ep_; }
+
+        // Direct receive path (IsoNet::set_rx_source)
+        std::function<bool(can_frame &)> rx_source() {
+            return [this](can_frame &cf) { return pop_can(cf); };
+        }
+
+        // ─── Publish ─────────────────────────────────────────────────────────────
+        bool publish(const can_frame &cf, u64 timestamp_us, u8 flags = 0) noexcept {
+            if (!header_)
+                return false;
+            u64 pos = header_->write_seq.fetch_add(1, std::memory_order_acq_rel);
+            Slot &slot = slots_[pos & mask_];
+            slot.seq.store(0, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            slot.timestamp_us = timestamp_us;
+            slot.can_id = cf.can_id;
+            slot.writer = writer_id_;
+            slot.dlc = cf.can_dlc > 8 ? 8 : cf.can_dlc;
+            slot.flags = flags;
+            for (u8 i = 0; i < 8; ++i)
+                slot.data[i] = cf.data[i];
+            slot.seq.store(pos + 1, std::memory_order_release);
+            return true;
+        }
+
+        void send_can(const can_frame &cf) { publish(cf, now_us()); }
+
+        // ─── Consume ─────────────────────────────────────────────────────────────
+        // Next frame from another process; false when caught up
+        bool pop_can(can_frame &cf) noexcept {
+            if (!header_)
+                return false;
+            while (true) {
+                Slot &slot = slots_[cursor_ & mask_];
+                u64 want = cursor_ + 1;
+                u64 seq = slot.seq.load(std::memory_order_acquire);
+                if (seq == want) {
+                    u64 ts = slot.timestamp_us;
+                    u16 writer = slot.writer;
+                    cf = {};
+                    cf.can_id = slot.can_id;
+                    cf.can_dlc = slot.dlc;
+                    for (u8 i = 0; i < 8; ++i)
+                        cf.data[i] = slot.data[i];
+                    std::atomic_thread_fence(std::memory_order_acquire);
+                    if (slot.seq.load(std::memory_order_relaxed) == want) {
+                        ++cursor_;
+                        if (writer == writer_id_)
+                            continue;
+                        last_timestamp_us_ = ts;
+                        return true;
+                    }
+                } else if (seq < want && header_->write_seq.load(std::memory_order_acquire) - cursor_ <= mask_) {
+                    return false; // Not published yet
+                }
+                // Lapped by the writers: restart one ring behind the head
+                u64 head = header_->write_seq.load(std::memory_order_acquire);
+                u64 restart = head > mask_ ? head - mask_ : 0;
+                if (restart > cursor_) {
+                    lost_ += restart - cursor_;
+                    cursor_ = restart;
+                } else if (seq < want) {
+                    return false;
+                }
+            }
+        }
+
+        u32 rx_pending() const noexcept {
+            if (!header_)
+                return 0;
+            u64 behind = header_->write_seq.load(std::memory_order_acquire) - cursor_;
+            return behind > 0xFFFFFFFFu ? 0xFFFFFFFFu : static_cast<u32>(behind);
+        }
+
+        // ─── Statistics ──────────────────────────────────────────────────────────
+        u64 lost() const noexcept { return lost_; }             // Overwritten before this process read them
+        u64 last_timestamp_us() const noexcept { return last_timestamp_us_; } // Of the last frame popped
+        u16 writer_id() const noexcept { return writer_id_; }
+        u32 capacity() const noexcept { return header_ ? header_->capacity : 0; }
+
+      private:
+        static u64 now_us() {
+            return static_cast<u64>(std::chrono::duration_cast<std::chrono::microseconds>(
+                                        std::chrono::steady_clock::now().time_since_epoch())
+                                        .count());
+        }
+    };
+
+} // namespace agrobus::net
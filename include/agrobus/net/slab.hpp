@@ -0,0 +1,186 @@
+#pragma once
+
+#include <agrobus/net/types.hpp>
+#include <datapod/datapod.hpp>
+#include <memory>
+#include <new>
+#include <utility>
+
+namespace agrobus::net {
+
+    // ─── Slab handle ─────────────────────────────────────────────────────────────
+    // Slot index plus a generation (same layout as TimerId): a handle kept after
+    // its element was erased resolves to nullptr instead of to whatever reused
+    // the slot
+    using SlabHandle = u64;
+    inline constexpr SlabHandle INVALID_HANDLE = 0;
+
+    // ─── Slab with stable element addresses ──────────────────────────────────────
+    // Elements live in fixed-size chunks that are never reallocated, so a T* (or
+    // a pointer into one, e.g. an AddressClaimer's InternalCF*) stays valid until
+    // that element is erased, however many are added later. Erased slots are
+    // reused; iteration visits live elements in slot order.
+    template <typename T, usize CHUNK = 16> class Slab {
+        struct Slot {
+            alignas(T) unsigned char storage[sizeof(T)];
+            u32 generation = 1;
+            bool live = false;
+
+            T *get() noexcept { return std::launder(reinterpret_cast<T *>(storage)); }
+            const T *get() const noexcept { return std::launder(reinterpret_cast<const T *>(storage)); }
+        };
+
+        dp::Vector<std::unique_ptr<Slot[]>> chunks_;
+        dp::Vector<u32> free_;
+        u32 slots_ = 0; // Slots handed out so far (high-water mark)
+        usize size_ = 0;
+
+      public:
+        Slab() = default;
+        Slab(Slab &&other) noexcept
+            : chunks_(std::move(other.chunks_)), free_(std::move(other.free_)),
+              slots_(std::exchange(other.slots_, 0)), size_(std::exchange(other.size_, 0)) {}
+        Slab &operator=(Slab &&other) noexcept {
+            if (this != &other) {
+                clear();
+                chunks_ = std::move(other.chunks_);
+                free_ = std::move(other.free_);
+                slots_ = std::exchange(other.slots_, 0);
+                size_ = std::exchange(other.size_, 0);
+            }
+            return *this;
+        }
+        Slab(const Slab &) = delete;
+        Slab &operator=(const Slab &) = delete;
+        ~Slab() { clear(); }
+
+        template <typename... Args> SlabHandle emplace(Args &&...args) {
+            u32 index;
+            if (!free_.empty()) {
+                index = free_.back();
+                free_.pop_back();
+            } else {
+                if (slots_ == chunks_.size() * CHUNK)
+                    chunks_.push_back(std::unique_ptr<Slot[]>(new Slot[CHUNK]));
+                index = slots_++;
+            }
+            Slot &s = slot(index);
+            ::new (static_cast<void *>(s.storage)) T(std::forward<Args>(args)...);
+            s.live = true;
+            ++size_;
+            return handle(index, s.generation);
+        }
+
+        bool erase(SlabHandle h) {
+            u32 index = lookup(h);
+            if (index == NIL)
+                return false;
+            Slot &s = slot(index);
+            s.get()->~T();
+            s.live = false;
+            if (++s.generation == 0)
+                s.generation = 1;
+            free_.push_back(index);
+            --size_;
+            return true;
+        }
+
+        void clear() {
+            for (u32 i = 0; i < slots_; ++i) {
+                Slot &s = slot(i);
+                if (s.live) {
+                    s.get()->~T();
+                    s.live = false;
+                }
+            }
+            chunks_.clear();
+            free_.clear();
+            slots_ = 0;
+            size_ = 0;
+        }
+
+        // ─── Access ──────────────────────────────────────────────────────────────
+        T *get(SlabHandle h) noexcept {
+            u32 index = lookup(h);
+            return index == NIL ? nullptr : slot(index).get();
+        }
+        const T *get(SlabHandle h) const noexcept {
+            u32 index = lookup(h);
+            return index == NIL ? nullptr : slot(index).get();
+        }
+
+        // Element in slot `index`, nullptr if the slot is free
+        T *at(u32 index) noexcept { return index < slots_ && slot(index).live ? slot(index).get() : nullptr; }
+        const T *at(u32 index) const noexcept {
+            return index < slots_ && slot(index).live ? slot(index).get() : nullptr;
+        }
+
+        // Handle of an element of this slab (INVALID_HANDLE for anything else)
+        SlabHandle handle_of(const T *element) const noexcept {
+            for (usize c = 0; c < chunks_.size(); ++c) {
+                const Slot *first = &chunks_[c][0];
+                for (usize k = 0; k < CHUNK; ++k) {
+                    if (first[k].live && first[k].get() == element)
+                        return handle(static_cast<u32>(c * CHUNK + k), first[k].generation);
+                }
+            }
+            return INVALID_HANDLE;
+        }
+
+        static u32 index_of(SlabHandle h) noexcept { return static_cast<u32>(h & 0xFFFFFFFFu); }
+
+        usize size() const noexcept { return size_; }
+        bool empty() const noexcept { return size_ == 0; }
+        u32 slots() const noexcept { return slots_; }
+
+        // ─── Iteration over live elements ────────────────────────────────────────
+        template <typename S, typename V> class Iter {
+            S *slab_;
+            u32 index_;
+
+            void skip() noexcept {
+                while (index_ < slab_->slots_ && !slab_->slot(index_).live)
+                    ++index_;
+            }
+
+          public:
+            Iter(S *slab, u32 index) noexcept : slab_(slab), index_(index) { skip(); }
+            V &operator*() const noexcept { return *slab_->slot(index_).get(); }
+            V *operator->() const noexcept { return slab_->slot(index_).get(); }
+            Iter &operator++() noexcept {
+                ++index_;
+                skip();
+                return *this;
+            }
+            bool operator==(const Iter &o) const noexcept { return index_ == o.index_; }
+            bool operator!=(const Iter &o) const noexcept { return index_ != o.index_; }
+            u32 index() const noexcept { return index_; }
+        };
+        using iterator = Iter<Slab, T>;
+        using const_iterator = Iter<const Slab, const T>;
+
+        iterator begin() noexcept { return iterator(this, 0); }
+        iterator end() noexcept { return iterator(this, slots_); }
+        const_iterator begin() const noexcept { return const_iterator(this, 0); }
+        const_iterator end() const noexcept { return const_iterator(this, slots_); }
+
+      private:
+        static constexpr u32 NIL = 0xFFFFFFFFu;
+
+        Slot &slot(u32 index) noexcept { return chunks_[index / CHUNK][index % CHUNK]; }
+        const Slot &slot(u32 index) const noexcept { return chunks_[index / CHUNK][index % CHUNK]; }
+
+        static SlabHandle handle(u32 index, u32 generation) noexcept {
+            return (static_cast<u64>(generation) << 32) | index;
+        }
+
+        u32 lookup(SlabHandle h) const noexcept {
+            u32 index = index_of(h);
+            if (h == INVALID_HANDLE || index >= slots_)
+                return NIL;
+            const Slot &s = slot(index);
+            return s.live && s.generation == static_cast<u32>(h >> 32) ? index : NIL;
+        }
+    };
+
+} // namespace agrobus::net
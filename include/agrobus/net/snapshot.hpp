@@ -0,0 +1,117 @@
+#pragma once
+
+#include "types.hpp"
+#include <datapod/datapod.hpp>
+#include <atomic>
+#include <cstring>
+#include <type_traits>
+
+namespace agrobus::net {
+
+    // ─── Cross-thread snapshot of decoded state ──────────────────────────────────
+    // One writer (the thread driving IsoNet::update()) publishes whole values;
+    // any number of readers on other threads copy the latest one without taking
+    // a lock and without ever stalling the writer.
+    //
+    // Trivially copyable values are kept as a seqlock over relaxed atomic words:
+    // publish() bumps the sequence to odd, stores the words and bumps it to even;
+    // load() retries until it copied under the same even sequence. Anything else
+    // falls back to a copy under a short spin flag, which the writer only holds
+    // for the duration of one assignment.
+    //
+    //   Snapshot<GNSSPosition> position;           // owner: position.publish(pos)
+    //   GNSSPosition p = position.load();          // GUI thread
+    //   if (position.version() != seen) { ... }    // cheap change check
+    template <typename T> class Snapshot {
+        static constexpr bool SEQLOCK = std::is_trivially_copyable_v<T>;
+        static constexpr usize WORDS = (sizeof(T) + 7) / 8;
+
+        struct Words {
+            dp::Array<std::atomic<u64>, WORDS> words{};
+        };
+        struct Guarded {
+            mutable std::atomic_flag busy = ATOMIC_FLAG_INIT;
+            T value{};
+        };
+
+        std::atomic<u32> seq_{0}; // Odd while publishing; seq / 2 = publishes so far
+        std::conditional_t<SEQLOCK, Words, Guarded> store_;
+
+      public:
+        Snapshot() { publish_initial(T{}); }
+        explicit Snapshot(const T &initial) { publish_initial(initial); }
+        Snapshot(const Snapshot &) = delete;
+        Snapshot &operator=(const Snapshot &) = delete;
+
+        // ─── Writer side ─────────────────────────────────────────────────────────
+        void publish(const T &value) noexcept(SEQLOCK || std::is_nothrow_copy_assignable_v<T>) {
+            u32 s = seq_.load(std::memory_order_relaxed);
+            seq_.store(s + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            if constexpr (SEQLOCK) {
+                dp::Array<u64, WORDS> buf{};
+                std::memcpy(buf.data(), &value, sizeof(T));
+                for (usize i = 0; i < WORDS; ++i)
+                    store_.words[i].store(buf[i], std::memory_order_relaxed);
+            } else {
+                lock();
+                store_.value = value;
+                unlock();
+            }
+            seq_.store(s + 2, std::memory_order_release);
+        }
+
+        // ─── Reader side (any thread) ────────────────────────────────────────────
+        T load() const {
+            T out;
+            read(out);
+            return out;
+        }
+
+        // Copy the latest value into `out`; returns the version it was taken at
+        u32 read(T &out) const {
+            if constexpr (SEQLOCK) {
+                dp::Array<u64, WORDS> buf{};
+                u32 before;
+                u32 after;
+                do {
+                    before = seq_.load(std::memory_order_acquire);
+                    if (before & 1u) {
+                        after = before + 1; // Writer inside: retry
+                        continue;
+                    }
+                    for (usize i = 0; i < WORDS; ++i)
+                        buf[i] = store_.words[i].load(std::memory_order_relaxed);
+                    std::atomic_thread_fence(std::memory_order_acquire);
+                    after = seq_.load(std::memory_order_relaxed);
+                } while (before != after);
+                std::memcpy(&out, buf.data(), sizeof(T));
+                return before / 2;
+            } else {
+                lock();
+                u32 s = seq_.load(std::memory_order_relaxed);
+                out = store_.value;
+                unlock();
+                return s / 2;
+            }
+        }
+
+        // Number of publish() calls so far (0: still the initial value)
+        u32 version() const noexcept { return seq_.load(std::memory_order_acquire) / 2; }
+
+        static constexpr bool lock_free() noexcept { return SEQLOCK; }
+
+      private:
+        void publish_initial(const T &value) {
+            publish(value);
+            seq_.store(0, std::memory_order_release);
+        }
+
+        void lock() const noexcept {
+            while (store_.busy.test_and_set(std::memory_order_acquire)) {
+            }
+        }
+        void unlock() const noexcept { store_.busy.clear(std::memory_order_release); }
+    };
+
+} // namespace agrobus::net
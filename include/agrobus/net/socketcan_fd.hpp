@@ -0,0 +1,110 @@
+#pragma once
+
+#include <agrobus/net/error.hpp>
+#include <agrobus/net/frame.hpp>
+#include <agrobus/net/types.hpp>
+#include <cerrno>
+#include <cstring>
+#include <echo/echo.hpp>
+#include <functional>
+#include <linux/can.h>
+#include <linux/can/raw.h>
+#include <net/if.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace agrobus::net {
+
+    // ─── SocketCanFd: raw SocketCAN socket with CAN FD frames ────────────────────
+    // wirebit::CanEndpoint carries can_frame only. This socket is opened with
+    // CAN_RAW_FD_FRAMES, so it reads and writes canfd_frame (classic frames
+    // arrive with len <= 8 and no FD flag) and plugs into IsoNet::set_fd_port.
+    // The interface must be configured for FD beforehand, e.g.
+    //   ip link set can0 type can bitrate 250000 dbitrate 2000000 fd on
+    //
+    // Usage:
+    //   SocketCanFd fd;
+    //   if (fd.open("can0").is_ok())
+    //       nm.set_fd_port(0, fd.tx_sink(), fd.rx_source(), 2000000);
+    class SocketCanFd {
+        int fd_ = -1;
+        u32 tx_errors_ = 0;
+
+      public:
+        SocketCanFd() = default;
+        ~SocketCanFd() { close(); }
+
+        // The sink and source returned below point back here
+        SocketCanFd(const SocketCanFd &) = delete;
+        SocketCanFd &operator=(const SocketCanFd &) = delete;
+
+        Result<void> open(const char *interface_name) {
+            close();
+            fd_ = ::socket(PF_CAN, SOCK_RAW | SOCK_NONBLOCK | SOCK_CLOEXEC, CAN_RAW);
+            if (fd_ < 0)
+                return Result<void>::err(Error(ErrorCode::DriverError, "CAN socket failed"));
+
+            int on = 1;
+            if (::setsockopt(fd_, SOL_CAN_RAW, CAN_RAW_FD_FRAMES, &on, sizeof(on)) < 0) {
+                close();
+                return Result<void>::err(Error(ErrorCode::DriverError, "CAN FD frames not supported"));
+            }
+
+            sockaddr_can addr{};
+            addr.can_family = AF_CAN;
+            addr.can_ifindex = static_cast<int>(::if_nametoindex(interface_name));
+            if (addr.can_ifindex == 0 || ::bind(fd_, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) < 0) {
+                close();
+                return Result<void>::err(Error(ErrorCode::DriverError, "CAN bind failed"));
+            }
+            echo::category("isobus.socketcan_fd").info("SocketCanFd open: ", interface_name);
+            return {};
+        }
+
+        void close() {
+            if (fd_ >= 0) {
+                ::close(fd_);
+                fd_ = -1;
+            }
+        }
+
+        bool is_open() const noexcept { return fd_ >= 0; }
+        int fd() const noexcept { return fd_; }
+        u32 tx_errors() const noexcept { return tx_errors_; }
+
+        // Frames of 8 bytes or less without FD flags go out as classic frames
+        bool send(const canfd_frame &cf) {
+            if (fd_ < 0)
+                return false;
+            bool classic = cf.len <= CAN_MAX_DLEN && (cf.flags & (CANFD_BRS | CANFD_ESI)) == 0;
+            usize size = classic ? CAN_MTU : CANFD_MTU;
+            if (::write(fd_, &cf, size) != static_cast<ssize_t>(size)) {
+                ++tx_errors_;
+                return false;
+            }
+            return true;
+        }
+
+        // Non-blocking; false when nothing is waiting
+        bool recv(canfd_frame &cf) {
+            if (fd_ < 0)
+                return false;
+            ssize_t n = ::read(fd_, &cf, CANFD_MTU);
+            if (n == static_cast<ssize_t>(CAN_MTU)) {
+                cf.flags = 0; // can_frame leaves these bytes as padding
+                return true;
+            }
+            return n == static_cast<ssize_t>(CANFD_MTU);
+        }
+
+        // ─── IsoNet hooks ────────────────────────────────────────────────────────
+        std::function<bool(const canfd_frame &)> tx_sink() {
+            return [this](const canfd_frame &cf) { return send(cf); };
+        }
+
+        std::function<bool(canfd_frame &)> rx_source() {
+            return [this](canfd_frame &cf) { return recv(cf); };
+        }
+    };
+
+} // namespace agrobus::net
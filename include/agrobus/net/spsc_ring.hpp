@@ -0,0 +1,67 @@
+#pragma once
+
+#include <agrobus/net/types.hpp>
+#include <atomic>
+#include <datapod/datapod.hpp>
+
+namespace agrobus::net {
+
+    // ─── Lock-free single-producer / single-consumer ring ───────────────────────
+    // Fixed capacity (rounded up to a power of two), allocated once. The producer
+    // thread only calls try_push(), the consumer thread only calls try_pop().
+    // A push into a full ring is refused and counted in dropped().
+    template <typename T> class SpscRing {
+        static constexpr usize CACHE_LINE = 64;
+
+        dp::Vector<T> buf_;
+        usize mask_ = 0;
+        alignas(CACHE_LINE) std::atomic<usize> head_{0}; // Next slot to pop (consumer-owned)
+        alignas(CACHE_LINE) std::atomic<usize> tail_{0}; // Next slot to push (producer-owned)
+        alignas(CACHE_LINE) std::atomic<u64> dropped_{0};
+
+      public:
+        explicit SpscRing(usize capacity) {
+            usize cap = 2;
+            while (cap < capacity)
+                cap <<= 1;
+            buf_.resize(cap);
+            mask_ = cap - 1;
+        }
+
+        SpscRing(const SpscRing &) = delete;
+        SpscRing &operator=(const SpscRing &) = delete;
+
+        // Producer side
+        bool try_push(const T &value) noexcept {
+            usize tail = tail_.load(std::memory_order_relaxed);
+            if (tail - head_.load(std::memory_order_acquire) > mask_) {
+                dropped_.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            buf_[tail & mask_] = value;
+            tail_.store(tail + 1, std::memory_order_release);
+            return true;
+        }
+
+        // Consumer side
+        bool try_pop(T &out) noexcept {
+            usize head = head_.load(std::memory_order_relaxed);
+            if (head == tail_.load(std::memory_order_acquire))
+                return false;
+            out = buf_[head & mask_];
+            head_.store(head + 1, std::memory_order_release);
+            return true;
+        }
+
+        usize capacity() const noexcept { return mask_ + 1; }
+
+        // Approximate when called while the other side is active
+        usize size() const noexcept {
+            return tail_.load(std::memory_order_acquire) - head_.load(std::memory_order_acquire);
+        }
+        bool empty() const noexcept { return size() == 0; }
+
+        u64 dropped() const noexcept { return dropped_.load(std::memory_order_relaxed); }
+    };
+
+} // namespace agrobus::net
@@ -1,14 +1,53 @@
 #pragma once
 
 #include "event.hpp"
+#include <agrobus/net/types.hpp>
+#include <datapod/datapod.hpp>
 
 namespace agrobus::net {
 
+    // ─── State count ─────────────────────────────────────────────────────────────
+    // An enum opts in to transition timing with a constexpr state_count()
+    // overload next to it, found by argument-dependent lookup:
+    //   constexpr usize state_count(VTState) { return static_cast<usize>(VTState::Connected) + 1; }
+    // Other enums get a state machine without timing and without its arrays.
+    template <typename StateEnum>
+    concept CountedStates = requires { requires state_count(StateEnum{}) > 0; };
+
+    template <typename StateEnum> consteval usize state_count_of() {
+        if constexpr (CountedStates<StateEnum>)
+            return state_count(StateEnum{});
+        else
+            return 0;
+    }
+
+    // Time and entries of one state, for StateMachine::summary()
+    template <typename StateEnum> struct StateTime {
+        StateEnum state;
+        u64 time_ms = 0; // Time spent in the state, the current stay included
+        u32 entries = 0; // Transitions into the state
+    };
+
     // ─── Generic state machine template ─────────────────────────────────────────
+    // With a state count, the machine also keeps the time spent in each state
+    // and the number of each transition, in fixed arrays sized from the enum.
+    // Time moves with advance(), called by the owner's update() with the same
+    // elapsed milliseconds, so a client's connect shows where it waited
+    // without any application code. set_timing(false) stops the recording.
     template <typename StateEnum> class StateMachine {
+        static constexpr usize STATES = state_count_of<StateEnum>();
+
         StateEnum state_;
+        dp::Array<u64, STATES> time_ms_{};             // Per state
+        dp::Array<u32, STATES * STATES> transitions_{}; // [from * STATES + to]
+        u32 in_state_ms_ = 0;                           // Time in the current state
+        bool timing_ = true;
+
+        static constexpr usize index(StateEnum s) noexcept { return static_cast<usize>(s); }
 
       public:
+        static constexpr bool TIMED = STATES > 0;
+
         explicit StateMachine(StateEnum initial) : state_(initial) {}
 
         StateEnum state() const noexcept { return state_; }
@@ -17,6 +56,11 @@ namespace agrobus::net {
             if (new_state != state_) {
                 StateEnum old = state_;
                 state_ = new_state;
+                if constexpr (TIMED) {
+                    if (timing_ && index(old) < STATES && index(new_state) < STATES)
+                        ++transitions_[index(old) * STATES + index(new_state)];
+                }
+                in_state_ms_ = 0;
                 on_transition.emit(old, new_state);
             }
         }
@@ -24,5 +68,66 @@ namespace agrobus::net {
         bool is(StateEnum s) const noexcept { return state_ == s; }
 
         Event<StateEnum, StateEnum> on_transition; // (from, to)
+
+        // ─── Timing ──────────────────────────────────────────────────────────────
+        // Time passes in the current state
+        void advance(u32 elapsed_ms) noexcept {
+            in_state_ms_ += elapsed_ms;
+            if constexpr (TIMED) {
+                if (timing_ && index(state_) < STATES)
+                    time_ms_[index(state_)] += elapsed_ms;
+            }
+        }
+
+        u32 time_in_state() const noexcept { return in_state_ms_; }
+
+        void set_timing(bool on) noexcept { timing_ = on; }
+        bool timing() const noexcept { return TIMED && timing_; }
+
+        void reset_timing() noexcept {
+            time_ms_ = {};
+            transitions_ = {};
+        }
+
+        u64 time_in(StateEnum s) const noexcept {
+            if constexpr (TIMED)
+                return index(s) < STATES ? time_ms_[index(s)] : 0;
+            return 0;
+        }
+
+        u32 transitions(StateEnum from, StateEnum to) const noexcept {
+            if constexpr (TIMED) {
+                if (index(from) < STATES && index(to) < STATES)
+                    return transitions_[index(from) * STATES + index(to)];
+            }
+            return 0;
+        }
+
+        u32 entries(StateEnum s) const noexcept {
+            u32 n = 0;
+            if constexpr (TIMED) {
+                for (usize from = 0; from < STATES && index(s) < STATES; ++from)
+                    n += transitions_[from * STATES + index(s)];
+            }
+            return n;
+        }
+
+        // States visited or timed, longest first
+        dp::Vector<StateTime<StateEnum>> summary() const {
+            dp::Vector<StateTime<StateEnum>> out;
+            if constexpr (TIMED) {
+                for (usize s = 0; s < STATES; ++s) {
+                    auto state = static_cast<StateEnum>(s);
+                    StateTime<StateEnum> t{state, time_ms_[s], entries(state)};
+                    if (t.time_ms == 0 && t.entries == 0)
+                        continue;
+                    usize at = out.size();
+                    while (at > 0 && out[at - 1].time_ms < t.time_ms)
+                        --at;
+                    out.insert(out.begin() + static_cast<std::ptrdiff_t>(at), t);
+                }
+            }
+            return out;
+        }
     };
 } // namespace agrobus::net
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <agrobus/net/error.hpp>
+#include <agrobus/net/types.hpp>
+
+// ─── Static allocation profile ───────────────────────────────────────────────
+// -DAGROBUS_STATIC_ALLOC=1 (CMake: AGROBUS_STATIC_ALLOC, Makefile: STATIC=1)
+// gives the long-lived tables a compile-time capacity. Their storage is
+// reserved when the owner is constructed, so an ECU that builds its network,
+// object pools and tasks at startup does not grow them afterwards; going past
+// a capacity fails with ErrorCode::NoResources instead of reallocating.
+// Every capacity can be overridden with its own -D.
+#ifndef AGROBUS_STATIC_ALLOC
+#define AGROBUS_STATIC_ALLOC 0
+#endif
+
+#ifndef AGROBUS_MAX_EVENT_LISTENERS
+#define AGROBUS_MAX_EVENT_LISTENERS 16
+#endif
+#ifndef AGROBUS_MAX_INTERNAL_CFS
+#define AGROBUS_MAX_INTERNAL_CFS 8
+#endif
+#ifndef AGROBUS_MAX_PARTNER_CFS
+#define AGROBUS_MAX_PARTNER_CFS 32
+#endif
+#ifndef AGROBUS_MAX_TRANSPORT_SESSIONS
+#define AGROBUS_MAX_TRANSPORT_SESSIONS 16
+#endif
+#ifndef AGROBUS_MAX_SCHEDULER_TASKS
+#define AGROBUS_MAX_SCHEDULER_TASKS 32
+#endif
+#ifndef AGROBUS_MAX_POOL_OBJECTS
+#define AGROBUS_MAX_POOL_OBJECTS 1024
+#endif
+#ifndef AGROBUS_MAX_DDOP_OBJECTS
+#define AGROBUS_MAX_DDOP_OBJECTS 512
+#endif
+
+namespace agrobus::net::static_alloc {
+
+    inline constexpr bool enabled = AGROBUS_STATIC_ALLOC != 0;
+
+    inline constexpr usize event_listeners = AGROBUS_MAX_EVENT_LISTENERS;
+    inline constexpr usize internal_cfs = AGROBUS_MAX_INTERNAL_CFS;
+    inline constexpr usize partner_cfs = AGROBUS_MAX_PARTNER_CFS;
+    inline constexpr usize transport_sessions = AGROBUS_MAX_TRANSPORT_SESSIONS; // Per TP and per ETP
+    inline constexpr usize scheduler_tasks = AGROBUS_MAX_SCHEDULER_TASKS;
+    inline constexpr usize pool_objects = AGROBUS_MAX_POOL_OBJECTS;
+    inline constexpr usize ddop_objects = AGROBUS_MAX_DDOP_OBJECTS;
+
+    // True when one more element would exceed `capacity` in this profile
+    inline constexpr bool full(usize size, usize capacity) noexcept { return enabled && size >= capacity; }
+
+    inline Error exhausted(const char *what) { return Error(ErrorCode::NoResources, what); }
+
+} // namespace agrobus::net::static_alloc
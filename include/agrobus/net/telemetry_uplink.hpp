@@ -0,0 +1,596 @@
+#pragma once
+
+#include "bitfield.hpp"
+#include "data_span.hpp"
+#include "error.hpp"
+#include "last_value.hpp"
+#include "traffic_profile.hpp"
+#include "types.hpp"
+#include <algorithm>
+#include <cstring>
+#include <datapod/datapod.hpp>
+#include <echo/echo.hpp>
+#include <functional>
+
+namespace agrobus::net {
+
+    // ─── Uplink packet format ────────────────────────────────────────────────────
+    //   [magic u8] [flags u8] [sequence u16 LE] [base_ms varint] [block]
+    // The block, LZ-compressed when that makes it smaller (uplink_flags::COMPRESSED,
+    // then prefixed with its raw size as a varint), is
+    //   [traffic streams varint] [port, PGN, source, frames, bytes varints] × n
+    //   [dt_ms, channel, zigzag delta varints] × samples, to the end
+    // Sample times are relative to the previous sample, the first to base_ms.
+    // A delta is against the channel's previous value in the stream; a
+    // keyframe packet starts every channel from 0 with its current value, so
+    // a receiver that lost packets is right again from the next keyframe.
+    inline constexpr u8 UPLINK_MAGIC = 0xA5;
+
+    namespace uplink_flags {
+        inline constexpr u8 KEYFRAME = 0x01;
+        inline constexpr u8 COMPRESSED = 0x02;
+    } // namespace uplink_flags
+
+    namespace uplink {
+        inline void put_varint(dp::Vector<u8> &out, u64 v) {
+            while (v >= 0x80) {
+                out.push_back(static_cast<u8>(v | 0x80));
+                v >>= 7;
+            }
+            out.push_back(static_cast<u8>(v));
+        }
+
+        inline u64 zigzag(i64 v) noexcept { return (static_cast<u64>(v) << 1) ^ static_cast<u64>(v >> 63); }
+        inline i64 unzigzag(u64 v) noexcept { return static_cast<i64>(v >> 1) ^ -static_cast<i64>(v & 1); }
+
+        // False when the varint runs past `end`
+        inline bool get_varint(const u8 *&p, const u8 *end, u64 &out) noexcept {
+            out = 0;
+            for (u32 shift = 0; shift < 64; shift += 7) {
+                if (p >= end)
+                    return false;
+                u8 b = *p++;
+                out |= static_cast<u64>(b & 0x7F) << shift;
+                if (!(b & 0x80))
+                    return true;
+            }
+            return false;
+        }
+
+        // ─── Block compression ───────────────────────────────────────────────────
+        // LZ77 in the LZ4 block layout, with varint length extensions:
+        //   [token: literals << 4 | (match - 4)] [literals] [offset u16 LE]
+        // and a last sequence of literals only. One hash probe per position
+        // finds repeats such as a channel's recurring (dt, channel, delta)
+        // triple; no entropy coding, so a block compresses in microseconds.
+        class BlockCompressor {
+            static constexpr usize HASH_BITS = 12;
+            static constexpr usize MIN_MATCH = 4;
+            static constexpr usize MAX_OFFSET = 0xFFFF;
+
+            dp::Array<u32, (1u << HASH_BITS)> table_{}; // Position + 1 of the last 4 bytes with this hash
+
+            static u32 read32(const u8 *p) noexcept {
+                u32 v;
+                std::memcpy(&v, p, 4);
+                return v;
+            }
+            static usize hash(u32 v) noexcept { return (v * 2654435761u) >> (32 - HASH_BITS); }
+
+            static void sequence(dp::Vector<u8> &out, const u8 *lit, usize lit_len, usize offset, usize match_len) {
+                usize m = match_len >= MIN_MATCH ? match_len - MIN_MATCH : 0;
+                out.push_back(static_cast<u8>((lit_len < 15 ? lit_len : 15) << 4 | (m < 15 ? m : 15)));
+                if (lit_len >= 15)
+                    put_varint(out, lit_len - 15);
+                out.insert(out.end(), lit, lit + lit_len);
+                if (match_len == 0)
+                    return;
+                out.push_back(static_cast<u8>(offset));
+                out.push_back(static_cast<u8>(offset >> 8));
+                if (m >= 15)
+                    put_varint(out, m - 15);
+            }
+
+          public:
+            // Appends the compressed form of `in` to `out`
+            void compress(DataSpan in, dp::Vector<u8> &out) {
+                table_ = {};
+                const u8 *src = in.data();
+                usize n = in.size();
+                usize anchor = 0;
+                usize i = 0;
+                while (i + MIN_MATCH <= n) {
+                    u32 v = read32(src + i);
+                    usize h = hash(v);
+                    usize cand = table_[h];
+                    table_[h] = static_cast<u32>(i + 1);
+                    if (cand == 0 || i - (cand - 1) > MAX_OFFSET || read32(src + cand - 1) != v) {
+                        ++i;
+                        continue;
+                    }
+                    usize from = cand - 1;
+                    usize len = MIN_MATCH;
+                    while (i + len < n && src[from + len] == src[i + len])
+                        ++len;
+                    sequence(out, src + anchor, i - anchor, i - from, len);
+                    i += len;
+                    anchor = i;
+                }
+                sequence(out, src + anchor, n - anchor, 0, 0);
+            }
+
+            // Appends the `raw_size` bytes of a compressed block to `out`
+            static Result<void> decompress(DataSpan in, usize raw_size, dp::Vector<u8> &out) {
+                const u8 *p = in.data();
+                const u8 *end = p + in.size();
+                usize start = out.size();
+                auto corrupt = [] { return Result<void>::err(Error(ErrorCode::InvalidData, "corrupt uplink block")); };
+                while (p < end) {
+                    u8 token = *p++;
+                    u64 lit = token >> 4;
+                    u64 extra = 0;
+                    if (lit == 15 && !get_varint(p, end, extra))
+                        return corrupt();
+                    lit += extra;
+                    if (lit > static_cast<u64>(end - p) || out.size() - start + lit > raw_size)
+                        return corrupt();
+                    out.insert(out.end(), p, p + lit);
+                    p += lit;
+                    if (p == end)
+                        break;
+                    if (end - p < 2)
+                        return corrupt();
+                    usize offset = static_cast<usize>(p[0]) | static_cast<usize>(p[1]) << 8;
+                    p += 2;
+                    u64 len = token & 0x0F;
+                    extra = 0;
+                    if (len == 15 && !get_varint(p, end, extra))
+                        return corrupt();
+                    len += extra + MIN_MATCH;
+                    if (offset == 0 || offset > out.size() - start || out.size() - start + len > raw_size)
+                        return corrupt();
+                    usize from = out.size() - offset;
+                    for (u64 k = 0; k < len; ++k) {
+                        u8 b = out[from + k]; // Overlapping copies repeat the run
+                        out.push_back(b);
+                    }
+                }
+                if (out.size() - start != raw_size)
+                    return corrupt();
+                return {};
+            }
+        };
+    } // namespace uplink
+
+    // ─── Telemetry Uplink Config ─────────────────────────────────────────────────
+    struct TelemetryUplinkConfig {
+        u32 batch_ms = 10000;        // A packet goes out at least this often while it has samples
+        u32 packet_bytes = 1024;     // ...or once its block reaches this size
+        u16 keyframe_every = 30;     // Packets between keyframes; 0 = only the first and after a failed send
+        u32 stale_ms = 3000;         // Cached values older than this are not sampled
+        u32 traffic_ms = 60000;      // Traffic summary period, 0 = none
+        u16 traffic_streams = 16;    // Busiest (port, PGN, source) streams per summary
+        bool compress_blocks = true; // LZ per block, kept when smaller
+
+        TelemetryUplinkConfig &batch(u32 ms, u32 bytes = 1024) {
+            batch_ms = ms;
+            packet_bytes = bytes;
+            return *this;
+        }
+        TelemetryUplinkConfig &keyframes(u16 every) {
+            keyframe_every = every;
+            return *this;
+        }
+        TelemetryUplinkConfig &stale(u32 ms) {
+            stale_ms = ms;
+            return *this;
+        }
+        TelemetryUplinkConfig &traffic(u32 ms, u16 streams = 16) {
+            traffic_ms = ms;
+            traffic_streams = streams;
+            return *this;
+        }
+        TelemetryUplinkConfig &compress(bool enable) {
+            compress_blocks = enable;
+            return *this;
+        }
+    };
+
+    // Sent and saved bytes, for sizing a data plan
+    struct UplinkStats {
+        u64 packets = 0;
+        u64 bytes = 0;         // Packets as sent
+        u64 raw_bytes = 0;     // Their blocks before compression
+        u64 samples = 0;       // Changed values sent
+        u64 unchanged = 0;     // Samples that matched the last value sent and cost nothing
+        u64 send_failures = 0; // Packets the sink refused; the next one is a keyframe
+    };
+
+    // ─── Telemetry uplink ────────────────────────────────────────────────────────
+    // Sends what a telematics box needs to know about the bus, not the bus:
+    // chosen SPNs read from IsoNet's last-value cache (or any other value,
+    // such as a TC process data DDI) at their own rates, and a periodic
+    // summary of the busiest streams from the traffic profiler. A value goes
+    // out only when it changed, as a varint delta; packets are batched and
+    // compressed in blocks. A 100 ms SPN that changes every other sample
+    // costs a few bytes a second instead of the ~16 bytes per frame of
+    // forwarding raw frames.
+    //
+    //   TelemetryUplink up(nm.last_values(), nm.traffic_profile());
+    //   up.add_spn(0xF004, 0x00, 24, 16, 1000);  // EEC1 engine speed at 1 Hz
+    //   up.add([&]() -> dp::Optional<i64> {      // A TC process data value every 5 s
+    //       auto *c = tc.client(0x80);
+    //       return c ? c->values.get(0, ddi) : dp::nullopt;
+    //   }, 5000);
+    //   up.set_sink([&](DataSpan packet) { return modem.send(packet); });
+    //   ... up.update(elapsed_ms) from the network loop
+    //
+    // The cache and profiler belong to the IsoNet thread; call update() there.
+    class TelemetryUplink {
+      public:
+        using Sampler = std::function<dp::Optional<i64>()>;
+        using Sink = std::function<bool(DataSpan)>;
+
+      private:
+        struct Channel {
+            Sampler sample;
+            u32 period_ms = 0;
+            u32 timer_ms = 0;
+            u32 deadband = 0;
+            i64 sent = 0;   // Last value in the stream
+            i64 latest = 0; // Last value sampled
+            bool has_sent = false;
+            bool has_latest = false;
+        };
+
+        LastValueCache *cache_;
+        const TrafficProfiler *profiler_;
+        TelemetryUplinkConfig config_;
+        Sink sink_;
+        dp::Vector<Channel> channels_;
+        dp::Map<u64, TrafficStats> reported_; // Counters at the last summary, per stream
+
+        dp::Vector<u8> samples_; // Block being filled
+        dp::Vector<u8> block_;
+        dp::Vector<u8> packet_;
+        uplink::BlockCompressor compressor_;
+        u64 clock_ms_ = 0;
+        u64 base_ms_ = 0; // Time of the packet's first sample
+        u64 last_sample_ms_ = 0;
+        u32 batch_timer_ms_ = 0;
+        u32 traffic_timer_ms_ = 0;
+        u16 sequence_ = 0;
+        u16 since_keyframe_ = 0;
+        bool open_ = false; // samples_ belongs to a started packet
+        bool keyframe_ = false;
+        bool need_keyframe_ = true;
+        bool traffic_due_ = false;
+        UplinkStats stats_;
+
+      public:
+        explicit TelemetryUplink(LastValueCache &cache, const TrafficProfiler *profiler = nullptr,
+                                 TelemetryUplinkConfig config = {})
+            : cache_(&cache), profiler_(profiler), config_(config) {}
+
+        void set_sink(Sink sink) { sink_ = std::move(sink); }
+
+        // ─── Channels ────────────────────────────────────────────────────────────
+        // Any value, sampled every `period_ms`; a change within `deadband` of the
+        // last one sent is not sent. Returns the channel number in the stream.
+        u16 add(Sampler sample, u32 period_ms, u32 deadband = 0) {
+            Channel ch;
+            ch.sample = std::move(sample);
+            ch.period_ms = period_ms == 0 ? 1 : period_ms;
+            ch.timer_ms = ch.period_ms; // First sample on the next update
+            ch.deadband = deadband;
+            channels_.push_back(std::move(ch));
+            return static_cast<u16>(channels_.size() - 1);
+        }
+
+        // The raw bits of an SPN: `bits` (up to 32) from `start_bit` of the
+        // cached single-frame PGN from `source`. All ones (not available) and
+        // stale values are skipped. The PGN is tracked in the cache.
+        Result<u16> add_spn(PGN pgn, Address source, u16 start_bit, u8 bits, u32 period_ms, u32 deadband = 0) {
+            if (bits == 0 || bits > bitfield::MAX_FIELD_BITS || start_bit + bits > 64)
+                return Result<u16>::err(Error(ErrorCode::InvalidData, "SPN outside a single frame"));
+            if (!cache_->track(pgn))
+                return Result<u16>::err(Error(ErrorCode::NoResources, "last-value cache tracks too many PGNs"));
+            LastValueCache *cache = cache_;
+            u32 stale = config_.stale_ms;
+            return add(
+                [cache, pgn, source, start_bit, bits, stale]() -> dp::Optional<i64> {
+                    LastValue v;
+                    if (!cache->read(pgn, source, v) || (stale != 0 && cache->age_ms(pgn, source) > stale))
+                        return dp::nullopt;
+                    u32 raw = bitfield::extract_le(v.data.data(), v.length, start_bit, bits);
+                    u32 all = bits == 32 ? 0xFFFFFFFFu : (1u << bits) - 1;
+                    if (start_bit + bits > v.length * 8u || raw == all)
+                        return dp::nullopt;
+                    return static_cast<i64>(raw);
+                },
+                period_ms, deadband);
+        }
+
+        usize channels() const noexcept { return channels_.size(); }
+
+        // Last value sampled on a channel
+        dp::Optional<i64> latest(u16 channel) const {
+            if (channel >= channels_.size() || !channels_[channel].has_latest)
+                return dp::nullopt;
+            return channels_[channel].latest;
+        }
+
+        const UplinkStats &stats() const noexcept { return stats_; }
+        u64 now_ms() const noexcept { return clock_ms_; }
+
+        // ─── Driving ─────────────────────────────────────────────────────────────
+        void update(u32 elapsed_ms) {
+            clock_ms_ += elapsed_ms;
+            for (usize i = 0; i < channels_.size(); ++i) {
+                Channel &ch = channels_[i];
+                ch.timer_ms += elapsed_ms;
+                if (ch.timer_ms < ch.period_ms)
+                    continue;
+                ch.timer_ms %= ch.period_ms;
+                sample(static_cast<u16>(i));
+            }
+
+            if (profiler_ && config_.traffic_ms != 0) {
+                traffic_timer_ms_ += elapsed_ms;
+                if (traffic_timer_ms_ >= config_.traffic_ms) {
+                    traffic_timer_ms_ = 0;
+                    traffic_due_ = true;
+                    start_packet();
+                }
+            }
+
+            if (open_) {
+                batch_timer_ms_ += elapsed_ms;
+                if (batch_timer_ms_ >= config_.batch_ms || samples_.size() >= config_.packet_bytes)
+                    flush();
+            }
+        }
+
+        // Send what is batched now
+        void flush() {
+            if (!open_)
+                return;
+            block_.clear();
+            encode_traffic();
+            block_.insert(block_.end(), samples_.begin(), samples_.end());
+
+            packet_.clear();
+            packet_.push_back(UPLINK_MAGIC);
+            usize flags_at = packet_.size();
+            packet_.push_back(keyframe_ ? uplink_flags::KEYFRAME : 0);
+            packet_.push_back(static_cast<u8>(sequence_));
+            packet_.push_back(static_cast<u8>(sequence_ >> 8));
+            uplink::put_varint(packet_, base_ms_);
+            usize header = packet_.size();
+            if (config_.compress_blocks) {
+                uplink::put_varint(packet_, block_.size());
+                compressor_.compress(DataSpan(block_.data(), block_.size()), packet_);
+                if (packet_.size() - header < block_.size())
+                    packet_[flags_at] |= uplink_flags::COMPRESSED;
+                else
+                    packet_.resize(header);
+            }
+            if (!(packet_[flags_at] & uplink_flags::COMPRESSED))
+                packet_.insert(packet_.end(), block_.begin(), block_.end());
+
+            ++sequence_;
+            samples_.clear();
+            open_ = false;
+            batch_timer_ms_ = 0;
+            stats_.raw_bytes += block_.size();
+            if (sink_ && sink_(DataSpan(packet_.data(), packet_.size()))) {
+                ++stats_.packets;
+                stats_.bytes += packet_.size();
+                return;
+            }
+            // The receiver missed these deltas: start over from absolute values
+            ++stats_.send_failures;
+            need_keyframe_ = true;
+            echo::category("isobus.uplink").warn("uplink packet ", sequence_ - 1, " not sent");
+        }
+
+      private:
+        void sample(u16 index) {
+            Channel &ch = channels_[index];
+            dp::Optional<i64> value = ch.sample();
+            if (!value)
+                return;
+            ch.latest = *value;
+            ch.has_latest = true;
+            i64 change = ch.has_sent ? ch.latest - ch.sent : 0;
+            if (ch.has_sent && (change < 0 ? -change : change) <= static_cast<i64>(ch.deadband)) {
+                ++stats_.unchanged;
+                return;
+            }
+            bool opened = open_;
+            start_packet();
+            if (opened || !keyframe_) // A keyframe just started already carries it
+                append(index, ch);
+        }
+
+        // A keyframe opens with every channel's current value, from 0
+        void start_packet() {
+            if (open_)
+                return;
+            open_ = true;
+            base_ms_ = clock_ms_;
+            last_sample_ms_ = clock_ms_;
+            keyframe_ = need_keyframe_ || (config_.keyframe_every != 0 && since_keyframe_ >= config_.keyframe_every);
+            if (!keyframe_) {
+                ++since_keyframe_;
+                return;
+            }
+            need_keyframe_ = false;
+            since_keyframe_ = 0;
+            for (usize i = 0; i < channels_.size(); ++i) {
+                Channel &ch = channels_[i];
+                ch.has_sent = false;
+                ch.sent = 0;
+                if (ch.has_latest)
+                    append(static_cast<u16>(i), ch);
+            }
+        }
+
+        void append(u16 index, Channel &ch) {
+            uplink::put_varint(samples_, clock_ms_ - last_sample_ms_);
+            uplink::put_varint(samples_, index);
+            uplink::put_varint(samples_, uplink::zigzag(ch.latest - ch.sent));
+            last_sample_ms_ = clock_ms_;
+            ch.sent = ch.latest;
+            ch.has_sent = true;
+            ++stats_.samples;
+        }
+
+        // Frames and bytes of the busiest streams since the last summary
+        void encode_traffic() {
+            if (!traffic_due_ || !profiler_) {
+                uplink::put_varint(block_, 0);
+                return;
+            }
+            traffic_due_ = false;
+            dp::Vector<TrafficEntry> changed;
+            profiler_->for_each([&](const TrafficEntry &e) {
+                u64 key = static_cast<u64>(e.port) << 40 | static_cast<u64>(e.pgn) << 8 | e.source;
+                TrafficStats &before = reported_[key];
+                if (e.stats.frames > before.frames) {
+                    TrafficEntry delta = e;
+                    delta.stats.frames = e.stats.frames - before.frames;
+                    delta.stats.bytes = e.stats.bytes - before.bytes;
+                    changed.push_back(delta);
+                }
+                before = e.stats;
+            });
+            std::sort(changed.begin(), changed.end(), [](const TrafficEntry &a, const TrafficEntry &b) {
+                return a.stats.frames > b.stats.frames;
+            });
+            if (changed.size() > config_.traffic_streams)
+                changed.resize(config_.traffic_streams);
+            uplink::put_varint(block_, changed.size());
+            for (const auto &e : changed) {
+                uplink::put_varint(block_, e.port);
+                uplink::put_varint(block_, e.pgn);
+                uplink::put_varint(block_, e.source);
+                uplink::put_varint(block_, e.stats.frames);
+                uplink::put_varint(block_, e.stats.bytes);
+            }
+        }
+    };
+
+    // ─── Receiving end ───────────────────────────────────────────────────────────
+    struct UplinkSample {
+        u64 time_ms = 0; // Uplink clock
+        u16 channel = 0;
+        i64 value = 0;
+    };
+
+    struct UplinkTraffic {
+        u8 port = 0;
+        PGN pgn = 0;
+        Address source = NULL_ADDRESS;
+        u64 frames = 0; // Since the previous summary
+        u64 bytes = 0;
+    };
+
+    struct UplinkPacket {
+        u16 sequence = 0;
+        bool keyframe = false;
+        dp::Vector<UplinkSample> samples;
+        dp::Vector<UplinkTraffic> traffic;
+    };
+
+    // Rebuilds channel values from uplink packets, in order. After a lost
+    // packet deltas are meaningless, so samples are held back until the
+    // next keyframe (traffic summaries still come through).
+    class TelemetryDecoder {
+        dp::Vector<i64> values_;
+        dp::Vector<u8> block_;
+        u16 next_sequence_ = 0;
+        bool synced_ = false;
+        u64 lost_ = 0;
+
+      public:
+        Result<UplinkPacket> decode(DataSpan packet) {
+            auto corrupt = [] { return Result<UplinkPacket>::err(Error(ErrorCode::InvalidData, "bad uplink packet")); };
+            if (packet.size() < 4 || packet[0] != UPLINK_MAGIC)
+                return corrupt();
+            UplinkPacket out;
+            u8 flags = packet[1];
+            out.sequence = static_cast<u16>(packet[2] | packet[3] << 8);
+            out.keyframe = (flags & uplink_flags::KEYFRAME) != 0;
+            const u8 *p = packet.data() + 4;
+            const u8 *end = packet.data() + packet.size();
+            u64 base_ms = 0;
+            if (!uplink::get_varint(p, end, base_ms))
+                return corrupt();
+
+            block_.clear();
+            if (flags & uplink_flags::COMPRESSED) {
+                u64 raw = 0;
+                if (!uplink::get_varint(p, end, raw))
+                    return corrupt();
+                auto r = uplink::BlockCompressor::decompress(DataSpan(p, static_cast<usize>(end - p)), raw, block_);
+                if (!r.is_ok())
+                    return Result<UplinkPacket>::err(r.error());
+            } else {
+                block_.insert(block_.end(), p, end);
+            }
+
+            if (synced_ && out.sequence != next_sequence_)
+                lost_ += static_cast<u16>(out.sequence - next_sequence_);
+            if (out.keyframe) {
+                synced_ = true;
+                std::fill(values_.begin(), values_.end(), 0);
+            } else if (out.sequence != next_sequence_) {
+                synced_ = false;
+            }
+            next_sequence_ = static_cast<u16>(out.sequence + 1);
+
+            p = block_.data();
+            end = block_.data() + block_.size();
+            u64 streams = 0;
+            if (!uplink::get_varint(p, end, streams))
+                return corrupt();
+            for (u64 i = 0; i < streams; ++i) {
+                u64 f[5];
+                for (auto &v : f) {
+                    if (!uplink::get_varint(p, end, v))
+                        return corrupt();
+                }
+                out.traffic.push_back(UplinkTraffic{static_cast<u8>(f[0]), static_cast<PGN>(f[1]),
+                                                    static_cast<Address>(f[2]), f[3], f[4]});
+            }
+            u64 time = base_ms;
+            while (p < end) {
+                u64 dt = 0;
+                u64 channel = 0;
+                u64 delta = 0;
+                if (!uplink::get_varint(p, end, dt) || !uplink::get_varint(p, end, channel) ||
+                    !uplink::get_varint(p, end, delta) || channel > 0xFFFF)
+                    return corrupt();
+                time += dt;
+                if (!synced_)
+                    continue;
+                if (values_.size() <= channel)
+                    values_.resize(channel + 1, 0);
+                values_[channel] += uplink::unzigzag(delta);
+                out.samples.push_back(UplinkSample{time, static_cast<u16>(channel), values_[channel]});
+            }
+            return out;
+        }
+
+        bool synced() const noexcept { return synced_; }
+        u64 lost() const noexcept { return lost_; } // Packets missing from the sequence
+
+        dp::Optional<i64> value(u16 channel) const {
+            if (!synced_ || channel >= values_.size())
+                return dp::nullopt;
+            return values_[channel];
+        }
+    };
+
+} // namespace agrobus::net
@@ -5,6 +5,18 @@
 
 namespace agrobus::net {
 
+    // ─── Deadline helpers ─────────────────────────────────────────────────────────
+    // Components report the time until their next timer event so an event-driven
+    // caller can sleep instead of ticking. NO_DEADLINE = nothing scheduled.
+    inline constexpr u32 NO_DEADLINE = 0xFFFFFFFFu;
+
+    // Time left until `elapsed` reaches `threshold` (0 when already due)
+    constexpr u32 time_left(u32 elapsed, u32 threshold) noexcept {
+        return elapsed >= threshold ? 0 : threshold - elapsed;
+    }
+
+    constexpr u32 earliest(u32 a, u32 b) noexcept { return a < b ? a : b; }
+
     // ─── Timer utility for periodic operations ───────────────────────────────────
     class Timer {
         u32 interval_ms_ = 0;
@@ -0,0 +1,338 @@
+#pragma once
+
+#include "delegate.hpp"
+#include "timer.hpp"
+#include <agrobus/net/types.hpp>
+#include <datapod/datapod.hpp>
+
+namespace agrobus::net {
+
+    // ─── Timer handle ────────────────────────────────────────────────────────────
+    // Slot index plus a generation, so a stale handle never cancels a timer
+    // that reused the slot
+    using TimerId = u64;
+    inline constexpr TimerId INVALID_TIMER = 0;
+
+    // ─── Hierarchical timer wheel (1 ms resolution) ──────────────────────────────
+    // Four levels of 64 buckets cover 64 ms, 4 s, 4.4 min and 4.7 h; later
+    // deadlines wait in an overflow list. A timer sits in the coarsest bucket
+    // that still separates it from "now" and is cascaded one level down each
+    // time the wheel reaches that bucket, so advancing costs O(elapsed ticks +
+    // expired timers) no matter how many timers are armed, and an empty wheel
+    // costs nothing.
+    //
+    // Periodic timers are anchored to the wheel's absolute clock: they fire at
+    // phase, phase + period, phase + 2 * period, ... whatever the tick size, so
+    // overshoot is never lost, and giving timers of the same period different
+    // phases spreads them across the period. A coarse advance() that passes
+    // several deadlines fires a periodic timer once and skips the rest rather
+    // than bursting.
+    class TimerWheel {
+      public:
+        using Callback = Delegate<void()>;
+        static constexpr u32 LEVEL_BITS = 6;
+        static constexpr u32 SLOTS = 1u << LEVEL_BITS;
+        static constexpr u32 LEVELS = 4;
+
+      private:
+        static constexpr u32 NIL = 0xFFFFFFFFu;
+        static constexpr u32 SLOT_MASK = SLOTS - 1;
+        static constexpr u32 DUE_BUCKET = LEVELS * SLOTS; // Scheduled with no delay
+        static constexpr u32 OVERFLOW_BUCKET = DUE_BUCKET + 1;
+        static constexpr u32 NUM_BUCKETS = OVERFLOW_BUCKET + 1;
+
+        struct Node {
+            u64 deadline = 0;
+            Callback fn;
+            u32 tag = 0;    // Handed to advance()'s visitor for timers without a callback
+            u32 period = 0; // 0 = one-shot
+            u32 generation = 1;
+            u32 prev = NIL;
+            u32 next = NIL;
+            u32 bucket = NIL; // NIL = not armed
+        };
+
+        dp::Vector<Node> nodes_;
+        dp::Vector<u32> free_;
+        dp::Array<u32, NUM_BUCKETS> heads_;
+        u64 now_ = 0;
+        u64 target_ = 0; // Clock value the running advance() ends at
+        usize armed_ = 0;
+
+      public:
+        TimerWheel() { heads_.fill(NIL); }
+
+        // Run fn once, delay_ms from now (0 = on the next advance(), even advance(0))
+        TimerId schedule(u32 delay_ms, Callback fn) { return arm(delay_ms, std::move(fn), 0); }
+
+        // A timer without a callback: advance(elapsed, visitor) reports its tag
+        TimerId schedule_tag(u32 delay_ms, u32 tag) { return arm(delay_ms, Callback{}, tag); }
+
+        // Run fn at every clock value t > now with t % period == phase % period
+        TimerId schedule_every(u32 period_ms, u32 phase_ms, Callback fn) {
+            return arm_every(period_ms, phase_ms, std::move(fn), 0);
+        }
+
+        TimerId schedule_every_tag(u32 period_ms, u32 phase_ms, u32 tag) {
+            return arm_every(period_ms, phase_ms, Callback{}, tag);
+        }
+
+        // Change the period of a periodic timer; the next deadline is re-anchored
+        // to the new period and phase
+        bool set_period(TimerId id, u32 period_ms, u32 phase_ms) {
+            u32 index = lookup(id);
+            if (index == NIL || nodes_[index].period == 0)
+                return false;
+            unlink(index);
+            nodes_[index].period = period_ms == 0 ? 1 : period_ms;
+            nodes_[index].deadline = next_aligned(nodes_[index].period, phase_ms);
+            link(index, bucket_for(nodes_[index].deadline));
+            return true;
+        }
+
+        bool cancel(TimerId id) {
+            u32 index = lookup(id);
+            if (index == NIL)
+                return false;
+            unlink(index);
+            release(index);
+            return true;
+        }
+
+        // Move an armed timer to a new deadline, keeping its callback and handle
+        bool reschedule(TimerId id, u32 delay_ms) {
+            u32 index = lookup(id);
+            if (index == NIL)
+                return false;
+            unlink(index);
+            nodes_[index].deadline = now_ + delay_ms;
+            link(index, delay_ms == 0 ? DUE_BUCKET : bucket_for(nodes_[index].deadline));
+            return true;
+        }
+
+        bool armed(TimerId id) const noexcept { return lookup(id) != NIL; }
+
+        u32 remaining_ms(TimerId id) const noexcept {
+            u32 index = lookup(id);
+            if (index == NIL || nodes_[index].deadline <= now_)
+                return 0;
+            u64 left = nodes_[index].deadline - now_;
+            return left >= NO_DEADLINE ? NO_DEADLINE - 1 : static_cast<u32>(left);
+        }
+
+        void advance(u32 elapsed_ms) {
+            advance(elapsed_ms, [](TimerId, u32) {});
+        }
+
+        // Advance the clock, firing every timer whose deadline passed in
+        // deadline order. Callback timers run their callback; tag timers are
+        // passed to expired(TimerId, u32 tag). Both may arm or cancel timers.
+        template <typename Visitor> void advance(u32 elapsed_ms, Visitor &&expired) {
+            target_ = now_ + elapsed_ms;
+            fire_bucket(DUE_BUCKET, expired);
+            if (armed_ == 0) {
+                now_ += elapsed_ms;
+                return;
+            }
+            for (u32 t = 0; t < elapsed_ms; ++t) {
+                ++now_;
+                if ((now_ & SLOT_MASK) == 0)
+                    cascade();
+                fire_bucket(static_cast<u32>(now_ & SLOT_MASK), expired);
+                if (armed_ == 0) {
+                    now_ += elapsed_ms - t - 1;
+                    return;
+                }
+            }
+        }
+
+        // Time until the next timer (exact for the next 64 ms, otherwise the next
+        // cascade, which is never later than the timer itself)
+        u32 next_deadline_ms() const noexcept {
+            if (armed_ == 0)
+                return NO_DEADLINE;
+            if (heads_[DUE_BUCKET] != NIL)
+                return 0;
+            for (u32 level = 0; level < LEVELS; ++level) {
+                u32 shift = level * LEVEL_BITS;
+                u32 pos = static_cast<u32>((now_ >> shift) & SLOT_MASK);
+                for (u32 slot = pos + 1; slot < SLOTS; ++slot) {
+                    if (heads_[level * SLOTS + slot] != NIL) {
+                        u64 at = ((now_ >> (shift + LEVEL_BITS)) << (shift + LEVEL_BITS)) |
+                                 (static_cast<u64>(slot) << shift);
+                        return clamp_ms(at - now_);
+                    }
+                }
+            }
+            // Only the overflow list: wake at the next top-level wrap
+            u32 span = LEVELS * LEVEL_BITS;
+            u64 wrap = ((now_ >> span) + 1) << span;
+            return clamp_ms(wrap - now_);
+        }
+
+        u64 now_ms() const noexcept { return now_; }
+        usize size() const noexcept { return armed_; }
+        bool empty() const noexcept { return armed_ == 0; }
+
+        // Room for `timers` armed at once without reallocating
+        void reserve(usize timers) {
+            nodes_.reserve(timers);
+            free_.reserve(timers);
+        }
+
+        void clear() {
+            for (u32 i = 0; i < nodes_.size(); ++i) {
+                if (nodes_[i].bucket != NIL) {
+                    unlink(i);
+                    release(i);
+                }
+            }
+        }
+
+      private:
+        static u32 clamp_ms(u64 ms) noexcept { return ms >= NO_DEADLINE ? NO_DEADLINE - 1 : static_cast<u32>(ms); }
+
+        TimerId arm(u32 delay_ms, Callback &&fn, u32 tag) {
+            u32 index;
+            if (!free_.empty()) {
+                index = free_.back();
+                free_.pop_back();
+            } else {
+                index = static_cast<u32>(nodes_.size());
+                nodes_.push_back(Node{});
+            }
+            Node &n = nodes_[index];
+            n.deadline = now_ + delay_ms;
+            n.fn = std::move(fn);
+            n.tag = tag;
+            n.period = 0;
+            link(index, delay_ms == 0 ? DUE_BUCKET : bucket_for(n.deadline));
+            ++armed_;
+            return (static_cast<u64>(n.generation) << 32) | index;
+        }
+
+        TimerId arm_every(u32 period_ms, u32 phase_ms, Callback &&fn, u32 tag) {
+            u32 period = period_ms == 0 ? 1 : period_ms;
+            u64 first = next_aligned(period, phase_ms);
+            TimerId id = arm(static_cast<u32>(first - now_), std::move(fn), tag);
+            nodes_[static_cast<u32>(id & 0xFFFFFFFFu)].period = period;
+            return id;
+        }
+
+        // First clock value after now that is congruent to phase (mod period)
+        u64 next_aligned(u32 period, u32 phase_ms) const noexcept {
+            u64 at = now_ - now_ % period + phase_ms % period;
+            return at <= now_ ? at + period : at;
+        }
+
+        u32 lookup(TimerId id) const noexcept {
+            u32 index = static_cast<u32>(id & 0xFFFFFFFFu);
+            u32 generation = static_cast<u32>(id >> 32);
+            if (id == INVALID_TIMER || index >= nodes_.size())
+                return NIL;
+            const Node &n = nodes_[index];
+            return (n.generation == generation && n.bucket != NIL) ? index : NIL;
+        }
+
+        // Bucket for a future deadline: the finest level whose higher digits
+        // match the current time
+        u32 bucket_for(u64 deadline) const noexcept {
+            for (u32 level = 0; level < LEVELS; ++level) {
+                u32 shift = level * LEVEL_BITS;
+                if ((deadline >> (shift + LEVEL_BITS)) == (now_ >> (shift + LEVEL_BITS)))
+                    return level * SLOTS + static_cast<u32>((deadline >> shift) & SLOT_MASK);
+            }
+            return OVERFLOW_BUCKET;
+        }
+
+        void link(u32 index, u32 bucket) noexcept {
+            Node &n = nodes_[index];
+            n.bucket = bucket;
+            n.prev = NIL;
+            n.next = heads_[bucket];
+            if (n.next != NIL)
+                nodes_[n.next].prev = index;
+            heads_[bucket] = index;
+        }
+
+        void unlink(u32 index) noexcept {
+            Node &n = nodes_[index];
+            if (n.prev != NIL)
+                nodes_[n.prev].next = n.next;
+            else
+                heads_[n.bucket] = n.next;
+            if (n.next != NIL)
+                nodes_[n.next].prev = n.prev;
+            n.prev = NIL;
+            n.next = NIL;
+            n.bucket = NIL;
+        }
+
+        void release(u32 index) {
+            Node &n = nodes_[index];
+            n.fn.reset();
+            ++n.generation;
+            if (n.generation == 0)
+                n.generation = 1;
+            free_.push_back(index);
+            --armed_;
+        }
+
+        // The wheel just reached a multiple of 64 ms: move the buckets whose
+        // time has come down a level, coarsest first so nothing lands in a
+        // bucket that was already emptied this tick
+        void cascade() {
+            u32 depth = 1;
+            while (depth < LEVELS && ((now_ >> (depth * LEVEL_BITS)) & SLOT_MASK) == 0)
+                ++depth;
+            if (depth == LEVELS)
+                redistribute(OVERFLOW_BUCKET); // Full wrap of the top level
+            for (u32 level = depth < LEVELS ? depth : LEVELS - 1; level >= 1; --level)
+                redistribute(level * SLOTS + static_cast<u32>((now_ >> (level * LEVEL_BITS)) & SLOT_MASK));
+        }
+
+        void redistribute(u32 bucket) {
+            u32 index = heads_[bucket];
+            heads_[bucket] = NIL;
+            while (index != NIL) {
+                u32 next = nodes_[index].next;
+                link(index, bucket_for(nodes_[index].deadline));
+                index = next;
+            }
+        }
+
+        template <typename Visitor> void fire_bucket(u32 bucket, Visitor &expired) {
+            while (heads_[bucket] != NIL) {
+                u32 index = heads_[bucket];
+                Node &n = nodes_[index];
+                TimerId id = (static_cast<u64>(n.generation) << 32) | index;
+                // Take the callback out before running it: it may arm timers
+                // (growing nodes_). A one-shot is freed first, so it sees its own
+                // handle as expired; a periodic timer is already re-armed.
+                Callback fn = std::move(n.fn);
+                u32 tag = n.tag;
+                u32 period = n.period;
+                unlink(index);
+                if (period == 0) {
+                    release(index);
+                } else {
+                    u64 next = n.deadline + period;
+                    if (next <= target_)
+                        next += ((target_ - next) / period + 1) * period; // Skip, don't burst
+                    n.deadline = next;
+                    link(index, bucket_for(next));
+                }
+                if (fn)
+                    fn();
+                else
+                    expired(id, tag);
+                if (period != 0 && fn) {
+                    u32 still = lookup(id);
+                    if (still != NIL && !nodes_[still].fn)
+                        nodes_[still].fn = std::move(fn);
+                }
+            }
+        }
+    };
+
+} // namespace agrobus::net
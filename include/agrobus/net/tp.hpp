@@ -1,12 +1,22 @@
 #pragma once
 
+#include "buffer_pool.hpp"
+#include "cts_window.hpp"
 #include "session.hpp"
+#include "session_table.hpp"
+#include "transport_metrics.hpp"
 #include <agrobus/net/error.hpp>
 #include <agrobus/net/event.hpp>
 #include <agrobus/net/frame.hpp>
 #include <agrobus/net/identifier.hpp>
+#include <agrobus/net/memory_budget.hpp>
+#include <agrobus/net/static_alloc.hpp>
+#include <agrobus/net/timer.hpp>
+#include <agrobus/net/trace.hpp>
+#include <agrobus/net/transport_limits.hpp>
 #include <datapod/datapod.hpp>
 #include <echo/echo.hpp>
+#include <memory>
 
 namespace agrobus::net {
 
@@ -58,105 +68,138 @@ namespace agrobus::net {
 
     // ─── Transport Protocol (8-1785 bytes) ───────────────────────────────────────
     class TransportProtocol {
-        dp::Vector<TransportSession> sessions_;
+        TransportSessionTable sessions_;
         dp::Vector<TPTimerSession> timer_sessions_;
+        std::shared_ptr<BufferPool> pool_;  // Optional source of session buffers
+        MemoryBudget *budget_ = nullptr;    // Optional limit on session buffer bytes
+        TransportLimits *limits_ = nullptr; // Optional caps on receive sessions per source
+        CtsWindowTuner cts_window_;         // Receiver-side CTS window sizing
+        u32 bam_interval_ms_ = TP_BAM_INTER_PACKET_MS;
+        dp::Vector<TransportSession *> tx_ready_; // Scratch list for get_pending_data_frames()
+        PortSet paused_ports_;                    // TX backpressure, see pause_port()
+        PortSet held_ports_;                      // Bus-off, see hold_port()
+        u32 bam_max_burst_ = TP_BAM_MAX_BURST;
+        TransportMetrics metrics_;
 
       public:
         static constexpr u32 MAX_DATA_LENGTH = TP_MAX_DATA_LENGTH;
         static constexpr u32 BYTES_PER_FRAME = TP_BYTES_PER_FRAME;
 
+        // max_sessions bounds concurrent TX + RX sessions (the table is allocated once)
+        // AGROBUS_MAX_TRANSPORT_SESSIONS in the static allocation profile
+        static constexpr usize DEFAULT_SESSIONS =
+            static_alloc::enabled ? static_alloc::transport_sessions : TransportSessionTable::DEFAULT_CAPACITY;
+
+        explicit TransportProtocol(usize max_sessions = DEFAULT_SESSIONS)
+            : sessions_(max_sessions) {}
+
+        // Take session buffers from (and return them to) a shared pool
+        void set_buffer_pool(std::shared_ptr<BufferPool> pool) noexcept { pool_ = std::move(pool); }
+
+        // Charge session buffers to a budget: a send that does not fit fails
+        // with ErrorCode::NoResources, an RTS is aborted (ResourcesUnavailable)
+        void set_memory_budget(MemoryBudget *budget) noexcept { budget_ = budget; }
+        MemoryBudget *memory_budget() const noexcept { return budget_; }
+
+        // Cap receive sessions per source and overall: an RTS past a cap is
+        // aborted (ResourcesUnavailable), a BAM past one is ignored
+        void set_limits(TransportLimits *limits) noexcept { limits_ = limits; }
+        TransportLimits *limits() const noexcept { return limits_; }
+
+        // CTS window policy for connection-mode receive (fixed 16 packets by default)
+        void set_cts_window(CtsWindowConfig config) { cts_window_.configure(config); }
+        CtsWindowTuner &cts_window() noexcept { return cts_window_; }
+
+        // Session counters, throughput and CTS latency per port and PGN
+        const TransportMetrics &metrics() const noexcept { return metrics_; }
+        TransportMetrics &metrics() noexcept { return metrics_; }
+
         // ─── Initiate a send ─────────────────────────────────────────────────────
         Result<dp::Vector<Frame>> send(PGN pgn, const dp::Vector<u8> &data, Address source, Address dest, u8 port = 0,
                                        Priority priority = Priority::Lowest) {
-            if (data.size() > MAX_DATA_LENGTH) {
-                echo::category("isobus.transport.tp")
-                    .error("data exceeds TP max: size=", data.size(), " max=", MAX_DATA_LENGTH);
-                return Result<dp::Vector<Frame>>::err(Error(ErrorCode::BufferOverflow, "data exceeds TP max"));
-            }
-            if (data.size() <= CAN_DATA_LENGTH) {
-                return Result<dp::Vector<Frame>>::err(Error::invalid_state("use single frame for <= 8 bytes"));
+            auto ok = check_send(pgn, data.size(), source, dest, port);
+            if (!ok.is_ok()) {
+                return Result<dp::Vector<Frame>>::err(ok.error());
             }
+            TransportSession session = make_tx_session(pgn, data.size(), source, dest, port, priority);
+            if (!charge(session, static_cast<u32>(data.size())))
+                return Result<dp::Vector<Frame>>::err(Error(ErrorCode::NoResources, "transport memory budget spent"));
+            session.data = take_buffer(data.size());
+            for (usize i = 0; i < data.size(); ++i)
+                session.data[i] = data[i];
+            return begin_send(std::move(session));
+        }
 
-            // Check for existing session - key by (src, dst, pgn, direction, port)
-            for (const auto &s : sessions_) {
-                if (s.source_address == source && s.destination_address == dest && s.pgn == pgn &&
-                    s.direction == TransportDirection::Transmit && s.can_port == port) {
-                    echo::category("isobus.transport.tp")
-                        .error("session already active: pgn=", pgn, " src=", static_cast<u8>(source),
-                               " dst=", static_cast<u8>(dest));
-                    return Result<dp::Vector<Frame>>::err(Error(ErrorCode::SessionExists, "session already active"));
-                }
+        // Zero-copy send: DT frames are built straight from *data, which the
+        // session holds until it completes or aborts
+        Result<dp::Vector<Frame>> send_shared(PGN pgn, SharedPayload data, Address source, Address dest, u8 port = 0,
+                                              Priority priority = Priority::Lowest) {
+            if (!data) {
+                return Result<dp::Vector<Frame>>::err(Error::invalid_state("null payload"));
             }
-
-            dp::Vector<Frame> frames;
-            TransportSession session;
-            session.direction = TransportDirection::Transmit;
-            session.pgn = pgn;
-            session.data = data;
-            session.total_bytes = static_cast<u32>(data.size());
-            session.source_address = source;
-            session.destination_address = dest;
-            session.can_port = port;
-            session.priority = priority;
-
-            if (dest == BROADCAST_ADDRESS) {
-                // BAM mode
-                session.state = SessionState::SendingData;
-                frames.push_back(make_bam(session));
-                echo::category("isobus.transport.tp").debug("BAM started: pgn=", pgn, " bytes=", data.size());
-            } else {
-                // Connection mode - send RTS
-                session.state = SessionState::WaitingForCTS;
-                frames.push_back(make_rts(session));
-                echo::category("isobus.transport.tp").debug("RTS sent: pgn=", pgn, " bytes=", data.size());
+            auto ok = check_send(pgn, data->size(), source, dest, port);
+            if (!ok.is_ok()) {
+                return Result<dp::Vector<Frame>>::err(ok.error());
             }
-
-            sessions_.push_back(std::move(session));
-            return Result<dp::Vector<Frame>>::ok(std::move(frames));
+            TransportSession session = make_tx_session(pgn, data->size(), source, dest, port, priority);
+            session.shared_data = std::move(data);
+            return begin_send(std::move(session));
         }
 
         // ─── Process incoming frame ──────────────────────────────────────────────
+        // The frames to send are appended to a caller-owned vector that can be
+        // reused from call to call; the overloads returning a vector wrap these.
         dp::Vector<Frame> process_frame(const Frame &frame, u8 port = 0) {
             dp::Vector<Frame> responses;
-            PGN pgn = frame.pgn();
+            process_frame(frame, frame.header(), port, responses);
+            return responses;
+        }
+
+        // With the identifier already decoded by the caller
+        void process_frame(const Frame &frame, const FrameHeader &hdr, u8 port, dp::Vector<Frame> &responses) {
+            PGN pgn = hdr.pgn;
 
             if (pgn == PGN_TP_CM) {
                 echo::category("isobus.transport.tp")
-                    .trace("CM frame received: src=", static_cast<u8>(frame.source()), " ctrl=", frame.data[0]);
-                responses = handle_cm(frame, port);
+                    .trace("CM frame received: src=", static_cast<u8>(hdr.source), " ctrl=", frame.data[0]);
+                handle_cm(frame, hdr, port, responses);
             } else if (pgn == PGN_TP_DT) {
                 echo::category("isobus.transport.tp")
-                    .trace("DT frame received: src=", static_cast<u8>(frame.source()), " seq=", frame.data[0]);
-                responses = handle_dt(frame, port);
+                    .trace("DT frame received: src=", static_cast<u8>(hdr.source), " seq=", frame.data[0]);
+                handle_dt(frame, hdr, port, responses);
             }
-
-            return responses;
         }
 
         // ─── Update timers ───────────────────────────────────────────────────────
         dp::Vector<Frame> update(u32 elapsed_ms) {
             dp::Vector<Frame> frames;
+            update(elapsed_ms, frames);
+            return frames;
+        }
 
-            for (auto it = sessions_.begin(); it != sessions_.end();) {
+        void update(u32 elapsed_ms, dp::Vector<Frame> &frames) {
+            for (usize i = 0; i < sessions_.size();) {
+                TransportSession *it = &sessions_.at(i);
+                if (port_held(it->can_port)) {
+                    ++i;
+                    continue;
+                }
                 it->timer_ms += elapsed_ms;
+                it->age_ms += elapsed_ms;
 
-                // Generate data frames for BAM (one per update, per J1939 timing)
+                // BAM pacing: elapsed time accrues and releases one DT per interval;
+                // the frames themselves are emitted round-robin after this loop
                 if (it->is_broadcast() && it->state == SessionState::SendingData &&
                     it->direction == TransportDirection::Transmit) {
-                    // BAM inter-packet delay: 50-200ms per J1939-21
-                    if (it->timer_ms >= TP_BAM_INTER_PACKET_MS) {
-                        it->timer_ms = 0;
-                        auto data_frames = generate_data_frames(*it, 1);
-                        for (auto &f : data_frames)
-                            frames.push_back(std::move(f));
-
-                        if (it->bytes_transferred >= it->total_bytes) {
-                            it->state = SessionState::Complete;
-                            on_complete.emit(*it);
-                            it = sessions_.erase(it);
-                            continue;
-                        }
+                    u32 due = it->timer_ms / bam_interval_ms_;
+                    if (due > bam_max_burst_) {
+                        // Caller stalled: don't try to catch up with a flood of frames
+                        due = bam_max_burst_;
+                        it->timer_ms %= bam_interval_ms_;
+                    } else {
+                        it->timer_ms -= due * bam_interval_ms_;
                     }
+                    it->packets_to_send = static_cast<u8>(due);
                 }
 
                 // Timeout checking
@@ -179,51 +222,136 @@ namespace agrobus::net {
                     break;
                 }
 
+                // The sender went quiet part way through a window: its tail was lost
+                if (timed_out && it->direction == TransportDirection::Receive && !it->is_broadcast() &&
+                    it->last_sequence >= it->cts_window_start &&
+                    request_missing(*it, static_cast<u8>(it->last_sequence + 1), it->can_port, frames)) {
+                    ++i;
+                    continue;
+                }
+
                 if (timed_out) {
                     echo::category("isobus.transport.tp").warn("Session timeout: pgn=", it->pgn);
+                    if (it->direction == TransportDirection::Receive && !it->is_broadcast())
+                        cts_window_.failed(it->can_port, it->source_address);
                     it->state = SessionState::Aborted;
-                    on_abort.emit(*it, TransportAbortReason::Timeout);
+                    notify_abort(*it, TransportAbortReason::Timeout);
                     if (!it->is_broadcast()) {
                         frames.push_back(make_abort(*it, TransportAbortReason::Timeout));
                     }
-                    it = sessions_.erase(it);
+                    recycle(*it);
+                    sessions_.erase_at(i);
                     continue;
                 }
 
-                ++it;
+                ++i;
             }
 
-            return frames;
+            emit_bam_frames(frames);
+        }
+
+        // ─── BAM pacing ──────────────────────────────────────────────────────────
+        // Time between BAM DT frames (J1939-21 allows 50-200 ms; some ISO 11783
+        // receivers accept less) and the most frames one session may release in a
+        // single update() when the caller ticks slower than the interval.
+        void set_bam_pacing(u32 interval_ms, u32 max_burst = TP_BAM_MAX_BURST) noexcept {
+            bam_interval_ms_ = interval_ms == 0 ? 1 : (interval_ms > 200 ? 200 : interval_ms);
+            bam_max_burst_ = max_burst == 0 ? 1 : (max_burst > 255 ? 255 : max_burst);
+        }
+        u32 bam_interval_ms() const noexcept { return bam_interval_ms_; }
+
+        // ─── TX backpressure ─────────────────────────────────────────────────────
+        // While a port is paused no DT frames are generated for its sessions; they
+        // keep their place in the CTS window and resume once the port's transmit
+        // queue drains, instead of handing frames to a driver that drops them.
+        void pause_port(u8 port, bool paused) { paused_ports_.set(port, paused); }
+        bool port_paused(u8 port) const noexcept { return paused_ports_.contains(port); }
+
+        // ─── Bus-off hold ────────────────────────────────────────────────────────
+        // The timers of a held port's sessions stand still, so a controller that
+        // is bus-off for a moment neither times out nor aborts them. IsoNet
+        // holds a port (and pauses it) while it is bus-off.
+        void hold_port(u8 port, bool held) { held_ports_.set(port, held); }
+        bool port_held(u8 port) const noexcept { return held_ports_.contains(port); }
+
+        // Time until update() next has work: a BAM packet to send or a timeout
+        u32 next_deadline_ms() const noexcept {
+            u32 next = NO_DEADLINE;
+            for (usize i = 0; i < sessions_.size(); ++i) {
+                const TransportSession &s = sessions_.at(i);
+                if (port_held(s.can_port))
+                    continue;
+                switch (s.state) {
+                case SessionState::SendingData:
+                    if (s.direction == TransportDirection::Transmit)
+                        if (s.is_broadcast())
+                            next = earliest(next, time_left(s.timer_ms, bam_interval_ms_));
+                        else if (!port_paused(s.can_port))
+                            next = 0;
+                    break;
+                case SessionState::WaitingForCTS:
+                case SessionState::WaitingForEndOfMsg:
+                    next = earliest(next, time_left(s.timer_ms, TP_TIMEOUT_T3_MS));
+                    break;
+                case SessionState::WaitingForData:
+                case SessionState::ReceivingData:
+                    next = earliest(next, time_left(s.timer_ms, TP_TIMEOUT_T1_MS));
+                    break;
+                default:
+                    break;
+                }
+            }
+            return next;
         }
 
         // ─── Get next data frames for CM sessions ────────────────────────────────
+        // DT frames for every connection-mode session inside a CTS window. Sessions
+        // to different destinations are interleaved one frame per round, so a long
+        // transfer never holds the bus while another one waits.
         dp::Vector<Frame> get_pending_data_frames() {
             dp::Vector<Frame> frames;
-            for (auto &session : sessions_) {
+            get_pending_data_frames(frames);
+            return frames;
+        }
+
+        void get_pending_data_frames(dp::Vector<Frame> &frames) {
+            tx_ready_.clear();
+            for (usize i = 0; i < sessions_.size(); ++i) {
+                TransportSession &session = sessions_.at(i);
                 if (session.state == SessionState::SendingData && session.direction == TransportDirection::Transmit &&
-                    !session.is_broadcast()) {
-                    auto data_frames = generate_data_frames(session, session.packets_to_send);
-                    for (auto &f : data_frames)
-                        frames.push_back(std::move(f));
-
-                    if (session.bytes_transferred >= session.total_bytes) {
-                        // All data sent, wait for EOMA
-                        session.state = SessionState::WaitingForEndOfMsg;
-                        session.timer_ms = 0;
-                    } else {
-                        // Window complete, wait for next CTS
-                        session.state = SessionState::WaitingForCTS;
-                        session.timer_ms = 0;
-                    }
+                    !session.is_broadcast() && !port_paused(session.can_port)) {
+                    tx_ready_.push_back(&session);
                 }
             }
-            return frames;
+            if (tx_ready_.empty())
+                return;
+
+            bool any = true;
+            while (any) {
+                any = false;
+                for (auto *session : tx_ready_) {
+                    if (session->packets_to_send == 0)
+                        continue;
+                    generate_data_frames(*session, 1, frames);
+                    --session->packets_to_send;
+                    if (session->bytes_transferred >= session->total_bytes)
+                        session->packets_to_send = 0;
+                    any = any || session->packets_to_send > 0;
+                }
+            }
+
+            for (auto *session : tx_ready_) {
+                // All data sent: wait for EOMA; otherwise window complete, wait for next CTS
+                session->state = session->bytes_transferred >= session->total_bytes ? SessionState::WaitingForEndOfMsg
+                                                                                     : SessionState::WaitingForCTS;
+                session->timer_ms = 0;
+            }
         }
 
         dp::Vector<TransportSession *> active_sessions() {
             dp::Vector<TransportSession *> result;
-            for (auto &s : sessions_)
-                result.push_back(&s);
+            for (usize i = 0; i < sessions_.size(); ++i)
+                result.push_back(&sessions_.at(i));
             return result;
         }
 
@@ -260,7 +388,11 @@ namespace agrobus::net {
         // ─── Update timer sessions with elapsed time ───────────────────────────
         dp::Vector<Frame> update_sessions(u32 elapsed_ms) {
             dp::Vector<Frame> frames;
+            update_sessions(elapsed_ms, frames);
+            return frames;
+        }
 
+        void update_sessions(u32 elapsed_ms, dp::Vector<Frame> &frames) {
             for (auto it = timer_sessions_.begin(); it != timer_sessions_.end();) {
                 // Skip non-active sessions
                 if (!it->is_active()) {
@@ -330,8 +462,6 @@ namespace agrobus::net {
 
                 ++it;
             }
-
-            return frames;
         }
 
         // Reset activity timer for a tracked session
@@ -436,8 +566,100 @@ namespace agrobus::net {
             return f;
         }
 
-        dp::Vector<Frame> generate_data_frames(TransportSession &session, u8 count) {
+        Result<void> check_send(PGN pgn, usize size, Address source, Address dest, u8 port) {
+            if (size > MAX_DATA_LENGTH) {
+                echo::category("isobus.transport.tp")
+                    .error("data exceeds TP max: size=", size, " max=", MAX_DATA_LENGTH);
+                return Result<void>::err(Error(ErrorCode::BufferOverflow, "data exceeds TP max"));
+            }
+            if (size <= CAN_DATA_LENGTH) {
+                return Result<void>::err(Error::invalid_state("use single frame for <= 8 bytes"));
+            }
+
+            // Check for existing session - key by (src, dst, pgn, direction, port)
+            if (find_session(source, dest, pgn, TransportDirection::Transmit, port)) {
+                echo::category("isobus.transport.tp")
+                    .error("session already active: pgn=", pgn, " src=", static_cast<u8>(source),
+                           " dst=", static_cast<u8>(dest));
+                return Result<void>::err(Error(ErrorCode::SessionExists, "session already active"));
+            }
+            if (sessions_.full()) {
+                echo::category("isobus.transport.tp").error("session table full: pgn=", pgn);
+                return Result<void>::err(Error(ErrorCode::NoResources, "session table full"));
+            }
+            return {};
+        }
+
+        static TransportSession make_tx_session(PGN pgn, usize size, Address source, Address dest, u8 port,
+                                                Priority priority) {
+            TransportSession session;
+            session.direction = TransportDirection::Transmit;
+            session.pgn = pgn;
+            session.total_bytes = static_cast<u32>(size);
+            session.source_address = source;
+            session.destination_address = dest;
+            session.can_port = port;
+            session.priority = priority;
+            return session;
+        }
+
+        Result<dp::Vector<Frame>> begin_send(TransportSession &&session) {
             dp::Vector<Frame> frames;
+            if (session.is_broadcast()) {
+                // BAM mode
+                session.state = SessionState::SendingData;
+                frames.push_back(make_bam(session));
+                echo::category("isobus.transport.tp")
+                    .debug("BAM started: pgn=", session.pgn, " bytes=", session.total_bytes);
+            } else {
+                // Connection mode - send RTS
+                session.state = SessionState::WaitingForCTS;
+                frames.push_back(make_rts(session));
+                echo::category("isobus.transport.tp")
+                    .debug("RTS sent: pgn=", session.pgn, " bytes=", session.total_bytes);
+            }
+
+            metrics_.started(session.can_port, session.pgn);
+            sessions_.insert(std::move(session));
+            return Result<dp::Vector<Frame>>::ok(std::move(frames));
+        }
+
+        // Emit the DT frames released by update(), one per BAM session per round so
+        // concurrent broadcasts from different sources interleave on the bus
+        void emit_bam_frames(dp::Vector<Frame> &frames) {
+            bool any = true;
+            while (any) {
+                any = false;
+                for (usize i = 0; i < sessions_.size(); ++i) {
+                    TransportSession &s = sessions_.at(i);
+                    if (!s.is_broadcast() || s.direction != TransportDirection::Transmit ||
+                        s.state != SessionState::SendingData || s.packets_to_send == 0)
+                        continue;
+                    generate_data_frames(s, 1, frames);
+                    --s.packets_to_send;
+                    if (s.bytes_transferred >= s.total_bytes) {
+                        s.state = SessionState::Complete;
+                        s.packets_to_send = 0;
+                    }
+                    any = any || s.packets_to_send > 0;
+                }
+            }
+
+            for (usize i = 0; i < sessions_.size();) {
+                TransportSession &s = sessions_.at(i);
+                if (s.is_broadcast() && s.direction == TransportDirection::Transmit &&
+                    s.state == SessionState::Complete) {
+                    notify_complete(s);
+                    recycle(s);
+                    sessions_.erase_at(i);
+                    continue;
+                }
+                ++i;
+            }
+        }
+
+        void generate_data_frames(TransportSession &session, u8 count, dp::Vector<Frame> &frames) {
+            const u8 *payload = session.payload();
             for (u8 i = 0; i < count && session.bytes_transferred < session.total_bytes; ++i) {
                 Frame f;
                 f.id = Identifier::encode(Priority::Lowest, PGN_TP_DT, session.source_address,
@@ -447,7 +669,7 @@ namespace agrobus::net {
 
                 for (u8 j = 0; j < 7; ++j) {
                     u32 idx = session.bytes_transferred + j;
-                    f.data[j + 1] = (idx < session.total_bytes) ? session.data[idx] : 0xFF;
+                    f.data[j + 1] = (idx < session.total_bytes) ? payload[idx] : 0xFF;
                 }
                 f.length = 8;
 
@@ -458,49 +680,88 @@ namespace agrobus::net {
 
                 frames.push_back(f);
             }
-            return frames;
         }
 
         // Find a session by full key (src, dst, pgn, direction, port)
         TransportSession *find_session(Address src, Address dst, PGN pgn, TransportDirection dir, u8 port) {
-            for (auto &s : sessions_) {
-                if (s.source_address == src && s.destination_address == dst && s.pgn == pgn && s.direction == dir &&
-                    s.can_port == port) {
-                    return &s;
-                }
-            }
-            return nullptr;
+            return sessions_.find_if(dir, port, src, dst, [pgn](const TransportSession &s) { return s.pgn == pgn; });
         }
 
-        // Find an RX session matching a DT frame source
+        // Find an RX session matching a DT frame: the connection-mode session to
+        // this destination, else a BAM from the same source
         TransportSession *find_rx_session(Address src, Address dst, u8 port) {
-            for (auto &s : sessions_) {
-                if (s.direction == TransportDirection::Receive && s.source_address == src && s.can_port == port &&
-                    (s.state == SessionState::WaitingForData || s.state == SessionState::ReceivingData)) {
-                    // For connection-mode, also match destination
-                    if (!s.is_broadcast() && s.destination_address != dst) {
-                        continue;
-                    }
-                    return &s;
-                }
-            }
-            return nullptr;
+            auto receiving = [](const TransportSession &s) {
+                return s.state == SessionState::WaitingForData || s.state == SessionState::ReceivingData;
+            };
+            if (auto *s = sessions_.find_if(TransportDirection::Receive, port, src, dst, receiving))
+                return s;
+            if (dst == BROADCAST_ADDRESS)
+                return nullptr;
+            return sessions_.find_if(TransportDirection::Receive, port, src, BROADCAST_ADDRESS, receiving);
+        }
+
+        void notify_complete(TransportSession &session) {
+            metrics_.completed(session.can_port, session.pgn, session.total_bytes, session.age_ms);
+            on_complete.emit(session);
+        }
+
+        void notify_abort(TransportSession &session, TransportAbortReason reason) {
+            metrics_.aborted(session.can_port, session.pgn, reason);
+            on_abort.emit(session, reason);
         }
 
         void erase_session(TransportSession *session) {
-            for (auto it = sessions_.begin(); it != sessions_.end(); ++it) {
-                if (&(*it) == session) {
-                    sessions_.erase(it);
-                    return;
-                }
-            }
+            recycle(*session);
+            sessions_.erase(session);
         }
 
-        dp::Vector<Frame> handle_cm(const Frame &frame, u8 port) {
-            dp::Vector<Frame> responses;
+        dp::Vector<u8> take_buffer(usize size) {
+            if (pool_)
+                return pool_->acquire(size);
+            return dp::Vector<u8>(size, 0xFF);
+        }
+
+        // Charge `bytes` of buffer for the session; false if the budget is spent
+        bool charge(TransportSession &session, u32 bytes) {
+            if (!budget_)
+                return true;
+            if (!budget_->charge(bytes).is_ok())
+                return false;
+            session.budget_bytes = bytes;
+            return true;
+        }
+
+        // Reserve a receive session against the limits; false if a cap is reached
+        bool admit(TransportSession &session, u32 bytes) {
+            if (!limits_)
+                return true;
+            if (!limits_->admit(session.can_port, session.source_address, bytes))
+                return false;
+            session.limit_bytes = bytes;
+            return true;
+        }
+
+        void unadmit(TransportSession &session) noexcept {
+            if (limits_ && session.limit_bytes > 0)
+                limits_->release(session.can_port, session.source_address, session.limit_bytes);
+            session.limit_bytes = 0;
+        }
+
+        // Return the session's buffer to the pool (no-op if it was moved out),
+        // its bytes to the budget and its reservation to the limits
+        void recycle(TransportSession &session) {
+            if (pool_)
+                pool_->release(std::move(session.data));
+            if (budget_ && session.budget_bytes > 0)
+                budget_->release(session.budget_bytes);
+            session.budget_bytes = 0;
+            unadmit(session);
+        }
+
+        void handle_cm(const Frame &frame, const FrameHeader &hdr, u8 port, dp::Vector<Frame> &responses) {
             u8 control_byte = frame.data[0];
-            Address src = frame.source();
-            Address dst = frame.destination();
+            Address src = hdr.source;
+            Address dst = hdr.destination;
 
             PGN cm_pgn = static_cast<u32>(frame.data[5]) | (static_cast<u32>(frame.data[6]) << 8) |
                          (static_cast<u32>(frame.data[7]) << 16);
@@ -521,6 +782,15 @@ namespace agrobus::net {
                     responses.push_back(make_abort(tmp, TransportAbortReason::AlreadyInSession));
                     break;
                 }
+                if (sessions_.full()) {
+                    echo::category("isobus.transport.tp").warn("RTS rejected, session table full: pgn=", cm_pgn);
+                    TransportSession tmp;
+                    tmp.source_address = dst;
+                    tmp.destination_address = src;
+                    tmp.pgn = cm_pgn;
+                    responses.push_back(make_abort(tmp, TransportAbortReason::ResourcesUnavailable));
+                    break;
+                }
 
                 TransportSession session;
                 session.direction = TransportDirection::Receive;
@@ -530,18 +800,45 @@ namespace agrobus::net {
                 session.source_address = src;
                 session.destination_address = dst;
                 session.can_port = port;
-                session.priority = frame.priority();
-                session.max_packets_per_cts =
-                    max_per_cts > TP_MAX_PACKETS_PER_CTS ? TP_MAX_PACKETS_PER_CTS : max_per_cts;
-                session.data.resize(msg_size, 0xFF);
+                session.priority = hdr.priority;
+                // The sender's limit from the RTS; fixed windows never exceed 16 packets
+                session.max_packets_per_cts = (!cts_window_.adaptive() && max_per_cts > TP_MAX_PACKETS_PER_CTS)
+                                                  ? static_cast<u8>(TP_MAX_PACKETS_PER_CTS)
+                                                  : max_per_cts;
+                if (!admit(session, msg_size)) {
+                    echo::category("isobus.transport.tp")
+                        .warn("RTS rejected, transport limits reached: pgn=", cm_pgn, " source=", src);
+                    TransportSession tmp;
+                    tmp.source_address = dst;
+                    tmp.destination_address = src;
+                    tmp.pgn = cm_pgn;
+                    responses.push_back(make_abort(tmp, TransportAbortReason::ResourcesUnavailable));
+                    break;
+                }
+                if (!charge(session, msg_size)) {
+                    echo::category("isobus.transport.tp").warn("RTS rejected, memory budget spent: pgn=", cm_pgn);
+                    unadmit(session);
+                    TransportSession tmp;
+                    tmp.source_address = dst;
+                    tmp.destination_address = src;
+                    tmp.pgn = cm_pgn;
+                    responses.push_back(make_abort(tmp, TransportAbortReason::ResourcesUnavailable));
+                    break;
+                }
+                session.data = take_buffer(msg_size);
                 session.cts_window_start = 1; // First packet expected
+                session.first_timestamp_us = frame.timestamp_us;
+                session.last_timestamp_us = frame.timestamp_us;
 
-                u8 cts_count =
-                    (total_packets < session.max_packets_per_cts) ? total_packets : session.max_packets_per_cts;
+                u8 window = cts_window_.initial(port, src);
+                if (window > session.max_packets_per_cts)
+                    window = session.max_packets_per_cts;
+                u8 cts_count = (total_packets < window) ? total_packets : window;
                 session.cts_window_size = cts_count;
                 responses.push_back(make_cts(dst, src, cts_count, 1, cm_pgn));
 
-                sessions_.push_back(std::move(session));
+                metrics_.started(port, cm_pgn);
+                sessions_.insert(std::move(session));
                 echo::category("isobus.transport.tp").debug("RTS received: pgn=", cm_pgn, " bytes=", msg_size);
                 break;
             }
@@ -549,59 +846,75 @@ namespace agrobus::net {
                 u8 num_packets = frame.data[1];
                 u8 next_seq = frame.data[2];
 
-                for (auto &s : sessions_) {
-                    if (s.direction == TransportDirection::Transmit && s.source_address == dst &&
-                        s.destination_address == src && s.pgn == cm_pgn && s.state == SessionState::WaitingForCTS &&
-                        s.can_port == port) {
-                        if (num_packets == 0) {
-                            // CTS hold: receiver is busy, stay in WaitingForCTS
-                            s.timer_ms = 0;
-                        } else {
-                            // Validate CTS parameters per ISO 11783-3
-                            u32 remaining_packets = s.total_packets() - (next_seq - 1);
-                            if (next_seq == 0 || next_seq > s.total_packets()) {
-                                // Invalid next_seq - abort
-                                echo::category("isobus.transport.tp")
-                                    .warn("CTS invalid next_seq=", next_seq, " total_packets=", s.total_packets());
-                                s.state = SessionState::Aborted;
-                                on_abort.emit(s, TransportAbortReason::BadSequence);
-                                responses.push_back(make_abort(s, TransportAbortReason::BadSequence));
-                                erase_session(&s);
-                                break;
-                            }
-                            // Clamp num_packets to remaining data
-                            u8 clamped_packets =
-                                (num_packets > remaining_packets) ? static_cast<u8>(remaining_packets) : num_packets;
-                            s.state = SessionState::SendingData;
-                            s.packets_to_send = clamped_packets;
-                            // Set bytes_transferred to match the requested next_seq
-                            s.bytes_transferred = static_cast<u32>(next_seq - 1) * 7;
-                            s.last_sequence = next_seq - 1;
-                            s.timer_ms = 0;
-                        }
+                // After the last window a receiver may still ask for lost packets
+                auto *sp = sessions_.find_if(TransportDirection::Transmit, port, dst, src,
+                                             [cm_pgn](const TransportSession &t) {
+                                                 return t.pgn == cm_pgn &&
+                                                        (t.state == SessionState::WaitingForCTS ||
+                                                         t.state == SessionState::WaitingForEndOfMsg);
+                                             });
+                if (!sp)
+                    break;
+                auto &s = *sp;
+                // Time since the RTS or the end of our last window
+                metrics_.cts_round_trip(port, cm_pgn, s.timer_ms);
+                if (num_packets == 0) {
+                    // CTS hold: receiver is busy, stay in WaitingForCTS
+                    s.timer_ms = 0;
+                } else {
+                    // Validate CTS parameters per ISO 11783-3
+                    u32 remaining_packets = s.total_packets() - (next_seq - 1);
+                    if (next_seq == 0 || next_seq > s.total_packets()) {
+                        // Invalid next_seq - abort
                         echo::category("isobus.transport.tp")
-                            .debug("CTS received: packets=", num_packets, " next_seq=", next_seq);
+                            .warn("CTS invalid next_seq=", next_seq, " total_packets=", s.total_packets());
+                        s.state = SessionState::Aborted;
+                        notify_abort(s, TransportAbortReason::BadSequence);
+                        responses.push_back(make_abort(s, TransportAbortReason::BadSequence));
+                        erase_session(&s);
                         break;
                     }
+                    // Clamp num_packets to remaining data
+                    u8 clamped_packets =
+                        (num_packets > remaining_packets) ? static_cast<u8>(remaining_packets) : num_packets;
+                    // Receiver asked again for packets it was already sent
+                    if (next_seq <= s.last_sequence) {
+                        u32 again = static_cast<u32>(s.last_sequence - next_seq) + 1;
+                        metrics_.retransmits(port, cm_pgn, again < clamped_packets ? again : clamped_packets);
+                    }
+                    s.state = SessionState::SendingData;
+                    s.packets_to_send = clamped_packets;
+                    // Set bytes_transferred to match the requested next_seq
+                    s.bytes_transferred = static_cast<u32>(next_seq - 1) * 7;
+                    s.last_sequence = next_seq - 1;
+                    s.timer_ms = 0;
                 }
+                echo::category("isobus.transport.tp").debug("CTS received: packets=", num_packets, " next_seq=", next_seq);
                 break;
             }
             case tp_cm::EOMA: {
-                for (auto it = sessions_.begin(); it != sessions_.end(); ++it) {
-                    if (it->direction == TransportDirection::Transmit && it->source_address == dst &&
-                        it->destination_address == src && it->pgn == cm_pgn && it->can_port == port) {
-                        it->state = SessionState::Complete;
-                        on_complete.emit(*it);
-                        sessions_.erase(it);
-                        echo::category("isobus.transport.tp").debug("EOMA received - session complete");
-                        break;
-                    }
+                auto *s = find_session(dst, src, cm_pgn, TransportDirection::Transmit, port);
+                if (s) {
+                    s->state = SessionState::Complete;
+                    notify_complete(*s);
+                    erase_session(s);
+                    echo::category("isobus.transport.tp").debug("EOMA received - session complete");
                 }
                 break;
             }
             case tp_cm::BAM: {
                 u16 msg_size = static_cast<u16>(frame.data[1]) | (static_cast<u16>(frame.data[2]) << 8);
 
+                // A new BAM from a source replaces its previous, unfinished one
+                if (auto *old = sessions_.find(TransportDirection::Receive, port, src, BROADCAST_ADDRESS)) {
+                    echo::category("isobus.transport.tp").debug("BAM restarted by sender: pgn=", old->pgn);
+                    erase_session(old);
+                }
+                if (sessions_.full()) {
+                    echo::category("isobus.transport.tp").warn("BAM dropped, session table full: pgn=", cm_pgn);
+                    break;
+                }
+
                 TransportSession session;
                 session.direction = TransportDirection::Receive;
                 session.state = SessionState::ReceivingData;
@@ -610,68 +923,115 @@ namespace agrobus::net {
                 session.source_address = src;
                 session.destination_address = BROADCAST_ADDRESS;
                 session.can_port = port;
-                session.priority = frame.priority();
-                session.data.resize(msg_size, 0xFF);
+                session.priority = hdr.priority;
+                if (!admit(session, msg_size)) {
+                    echo::category("isobus.transport.tp")
+                        .warn("BAM dropped, transport limits reached: pgn=", cm_pgn, " source=", src);
+                    break;
+                }
+                if (!charge(session, msg_size)) {
+                    echo::category("isobus.transport.tp").warn("BAM dropped, memory budget spent: pgn=", cm_pgn);
+                    unadmit(session);
+                    break;
+                }
+                session.data = take_buffer(msg_size);
+                session.first_timestamp_us = frame.timestamp_us;
+                session.last_timestamp_us = frame.timestamp_us;
 
-                sessions_.push_back(std::move(session));
+                metrics_.started(port, cm_pgn);
+                sessions_.insert(std::move(session));
                 echo::category("isobus.transport.tp").debug("BAM received: pgn=", cm_pgn, " bytes=", msg_size);
                 break;
             }
             case tp_cm::ABORT: {
                 TransportAbortReason reason = static_cast<TransportAbortReason>(frame.data[1]);
-                for (auto it = sessions_.begin(); it != sessions_.end(); ++it) {
-                    if (it->pgn == cm_pgn && it->can_port == port &&
-                        ((it->source_address == dst && it->destination_address == src) ||
-                         (it->source_address == src && it->destination_address == dst))) {
-                        it->state = SessionState::Aborted;
-                        on_abort.emit(*it, reason);
-                        sessions_.erase(it);
-                        echo::category("isobus.transport.tp").warn("Abort received: reason=", static_cast<u8>(reason));
-                        break;
-                    }
+                // Our TX to the sender, the sender's TX to us, then the unusual pairings
+                TransportSession *s = find_session(dst, src, cm_pgn, TransportDirection::Transmit, port);
+                if (!s)
+                    s = find_session(src, dst, cm_pgn, TransportDirection::Receive, port);
+                if (!s)
+                    s = find_session(src, dst, cm_pgn, TransportDirection::Transmit, port);
+                if (!s)
+                    s = find_session(dst, src, cm_pgn, TransportDirection::Receive, port);
+                if (s) {
+                    s->state = SessionState::Aborted;
+                    notify_abort(*s, reason);
+                    erase_session(s);
+                    echo::category("isobus.transport.tp").warn("Abort received: reason=", static_cast<u8>(reason));
                 }
                 break;
             }
             }
+        }
 
-            return responses;
+        // A DT went missing: CTS for the rest of the window starting at `next`,
+        // so one lost frame costs a round trip instead of the whole transfer.
+        // False once the window has used up its retries.
+        bool request_missing(TransportSession &session, u8 next, u8 port, dp::Vector<Frame> &responses) {
+            if (session.gap_requests >= cts_window_.config().gap_retries)
+                return false;
+            ++session.gap_requests;
+            cts_window_.failed(port, session.source_address);
+            u32 window_end = static_cast<u32>(session.cts_window_start) + session.cts_window_size;
+            u32 count = window_end > next ? window_end - next : 1;
+            u32 remaining_packets = session.total_packets() - (static_cast<u32>(next) - 1);
+            if (count > remaining_packets)
+                count = remaining_packets;
+            session.cts_window_start = next;
+            session.cts_window_size = static_cast<u8>(count);
+            session.awaiting_resend = true;
+            session.timer_ms = 0;
+            responses.push_back(make_cts(session.destination_address, session.source_address,
+                                         static_cast<u8>(count), next, session.pgn));
+            echo::category("isobus.transport.tp")
+                .debug("DT gap: pgn=", session.pgn, " asking again from ", next, " packets=", count);
+            return true;
         }
 
-        dp::Vector<Frame> handle_dt(const Frame &frame, u8 port) {
-            dp::Vector<Frame> responses;
-            Address src = frame.source();
-            Address dst = frame.destination();
+        void handle_dt(const Frame &frame, const FrameHeader &hdr, u8 port, dp::Vector<Frame> &responses) {
+            Address src = hdr.source;
+            Address dst = hdr.destination;
             u8 seq = frame.data[0];
 
             auto *session = find_rx_session(src, dst, port);
             if (!session) {
-                return responses;
+                return;
             }
 
             // Validate sequence number
             u8 expected_seq = session->last_sequence + 1;
+            if (session->awaiting_resend) {
+                // Rest of the window that was in flight when the gap was found
+                if (seq != expected_seq)
+                    return;
+                session->awaiting_resend = false;
+            }
             if (seq != expected_seq) {
                 if (seq <= session->last_sequence && seq != 0) {
                     // Duplicate - abort with reason
-                    echo::category("isobus.transport.tp").warn("Duplicate DT seq=", seq, " expected=", expected_seq);
+                    AGROBUS_TRACE_WARN(TraceEvent::TpDuplicateDt, session->pgn, seq, expected_seq);
                     if (!session->is_broadcast()) {
+                        cts_window_.failed(port, src);
                         responses.push_back(make_abort(*session, TransportAbortReason::DuplicateSequence));
                     }
                     session->state = SessionState::Aborted;
-                    on_abort.emit(*session, TransportAbortReason::DuplicateSequence);
+                    notify_abort(*session, TransportAbortReason::DuplicateSequence);
                     erase_session(session);
-                    return responses;
+                    return;
                 }
                 if (seq > expected_seq) {
-                    // Out of order - abort
-                    echo::category("isobus.transport.tp").warn("Out-of-order DT seq=", seq, " expected=", expected_seq);
+                    // Out of order: ask for the missing packets, abort once the retries are spent
+                    AGROBUS_TRACE_WARN(TraceEvent::TpOutOfOrderDt, session->pgn, seq, expected_seq);
+                    if (!session->is_broadcast() && request_missing(*session, expected_seq, port, responses))
+                        return;
                     if (!session->is_broadcast()) {
+                        cts_window_.failed(port, src);
                         responses.push_back(make_abort(*session, TransportAbortReason::BadSequence));
                     }
                     session->state = SessionState::Aborted;
-                    on_abort.emit(*session, TransportAbortReason::BadSequence);
+                    notify_abort(*session, TransportAbortReason::BadSequence);
                     erase_session(session);
-                    return responses;
+                    return;
                 }
             }
 
@@ -685,38 +1045,43 @@ namespace agrobus::net {
                 session->bytes_transferred = session->total_bytes;
             }
             session->last_sequence = seq;
+            if (session->timer_ms > session->window_gap_ms)
+                session->window_gap_ms = session->timer_ms;
             session->timer_ms = 0;
+            session->last_timestamp_us = frame.timestamp_us;
 
             // Check if complete
             if (session->bytes_transferred >= session->total_bytes) {
                 session->state = SessionState::Complete;
 
                 if (!session->is_broadcast()) {
+                    cts_window_.window_done(port, src, session->window_gap_ms);
                     responses.push_back(make_eoma(session->destination_address, session->source_address,
                                                   session->total_bytes, static_cast<u8>(session->total_packets()),
                                                   session->pgn));
                 }
 
-                on_complete.emit(*session);
-                erase_session(session);
+                notify_complete(*session);
                 echo::category("isobus.transport.tp").debug("Session complete: pgn=", session->pgn);
+                erase_session(session);
             } else if (!session->is_broadcast()) {
                 // Check if CTS window is exhausted
                 u8 packets_in_window = seq - (session->cts_window_start - 1);
                 if (packets_in_window >= session->cts_window_size) {
-                    // Send next CTS
+                    // Send next CTS, sized from how this window went
+                    u8 window = cts_window_.window_done(port, src, session->window_gap_ms);
+                    if (window > session->max_packets_per_cts)
+                        window = session->max_packets_per_cts;
+                    session->window_gap_ms = 0;
+                    session->gap_requests = 0;
                     u32 remaining_packets = session->total_packets() - seq;
-                    u8 next_count = (remaining_packets < session->max_packets_per_cts)
-                                        ? static_cast<u8>(remaining_packets)
-                                        : session->max_packets_per_cts;
+                    u8 next_count = (remaining_packets < window) ? static_cast<u8>(remaining_packets) : window;
                     session->cts_window_start = seq + 1;
                     session->cts_window_size = next_count;
                     responses.push_back(make_cts(session->destination_address, session->source_address, next_count,
                                                  seq + 1, session->pgn));
                 }
             }
-
-            return responses;
         }
     };
 } // namespace agrobus::net
@@ -0,0 +1,165 @@
+#pragma once
+
+#include "latency.hpp"
+#include "types.hpp"
+#include <datapod/datapod.hpp>
+#include <atomic>
+#include <mutex>
+
+// ─── Build-time trace level ──────────────────────────────────────────────────
+// 0 = off (default): every AGROBUS_TRACE_* site compiles to nothing, its
+// arguments are not evaluated. 1 = warnings (protocol errors), 2 = debug
+// (per-message events), 3 = trace (per-frame events). Set with
+// -DAGROBUS_TRACE_LEVEL=N (CMake: AGROBUS_TRACE_LEVEL, Makefile: TRACE=N).
+#ifndef AGROBUS_TRACE_LEVEL
+#define AGROBUS_TRACE_LEVEL 0
+#endif
+
+#define AGROBUS_TRACE_AT(level, event, ...)                                                                         \
+    do {                                                                                                               \
+        if constexpr ((level) <= AGROBUS_TRACE_LEVEL)                                                                  \
+            ::agrobus::net::trace::emit((level), (event), __VA_ARGS__);                                                \
+    } while (0)
+
+#define AGROBUS_TRACE_WARN(event, ...) AGROBUS_TRACE_AT(1, event, __VA_ARGS__)
+#define AGROBUS_TRACE_DEBUG(event, ...) AGROBUS_TRACE_AT(2, event, __VA_ARGS__)
+#define AGROBUS_TRACE(event, ...) AGROBUS_TRACE_AT(3, event, __VA_ARGS__)
+
+namespace agrobus::net {
+
+    // ─── Trace events ────────────────────────────────────────────────────────────
+    // Arguments a, b, c of each event are listed next to it
+    enum class TraceEvent : u16 {
+        FrameRx,                // port, can id, length
+        TransportComplete,      // pgn, bytes, source
+        TpDuplicateDt,          // pgn, sequence, expected
+        TpOutOfOrderDt,         // pgn, sequence, expected
+        EtpBadSequence,         // pgn, sequence, expected
+        FastPacketSent,         // pgn, bytes, source
+        FastPacketBadSequence,  // pgn, frame counter, expected
+        User = 0x8000,          // First id free for applications
+    };
+
+    inline const char *trace_event_name(TraceEvent event) noexcept {
+        switch (event) {
+        case TraceEvent::FrameRx:
+            return "frame_rx";
+        case TraceEvent::TransportComplete:
+            return "transport_complete";
+        case TraceEvent::TpDuplicateDt:
+            return "tp_duplicate_dt";
+        case TraceEvent::TpOutOfOrderDt:
+            return "tp_out_of_order_dt";
+        case TraceEvent::EtpBadSequence:
+            return "etp_bad_sequence";
+        case TraceEvent::FastPacketSent:
+            return "fast_packet_sent";
+        case TraceEvent::FastPacketBadSequence:
+            return "fast_packet_bad_sequence";
+        default:
+            return "user";
+        }
+    }
+
+    // ─── One trace record (32 bytes) ─────────────────────────────────────────────
+    struct TraceRecord {
+        u64 timestamp_ns = 0; // monotonic_ns()
+        TraceEvent event = TraceEvent::FrameRx;
+        u8 level = 0;
+        u8 reserved = 0;
+        u32 a = 0;
+        u64 b = 0;
+        u64 c = 0;
+    };
+    static_assert(sizeof(TraceRecord) == 32);
+
+    // ─── Per-thread trace ring ───────────────────────────────────────────────────
+    // Single writer (the owning thread) overwriting the oldest record; no lock,
+    // no allocation after construction. snapshot() may run on any thread: it
+    // copies the newest records and drops those the writer lapped meanwhile.
+    class TraceRing {
+      public:
+        static constexpr u32 CAPACITY = 4096; // Records, power of two
+
+      private:
+        dp::Array<TraceRecord, CAPACITY> records_;
+        std::atomic<u64> head_{0}; // Records ever written
+        u32 thread_index_;
+
+      public:
+        explicit TraceRing(u32 thread_index) : thread_index_(thread_index) {}
+
+        TraceRing(const TraceRing &) = delete;
+        TraceRing &operator=(const TraceRing &) = delete;
+
+        void push(const TraceRecord &r) noexcept {
+            u64 h = head_.load(std::memory_order_relaxed);
+            records_[h & (CAPACITY - 1)] = r;
+            head_.store(h + 1, std::memory_order_release);
+        }
+
+        // Oldest first; at most CAPACITY records
+        dp::Vector<TraceRecord> snapshot() const {
+            u64 end = head_.load(std::memory_order_acquire);
+            u64 begin = end > CAPACITY ? end - CAPACITY : 0;
+            dp::Vector<TraceRecord> out;
+            out.reserve(static_cast<usize>(end - begin));
+            for (u64 i = begin; i < end; ++i)
+                out.push_back(records_[i & (CAPACITY - 1)]);
+            // Whatever the writer overwrote while we copied is not trustworthy
+            u64 now = head_.load(std::memory_order_acquire);
+            u64 lapped = now > CAPACITY ? now - CAPACITY : 0;
+            if (lapped > begin) {
+                usize drop = static_cast<usize>(lapped - begin < out.size() ? lapped - begin : out.size());
+                out.erase(out.begin(), out.begin() + static_cast<isize>(drop));
+            }
+            return out;
+        }
+
+        u64 written() const noexcept { return head_.load(std::memory_order_relaxed); }
+        u32 thread_index() const noexcept { return thread_index_; }
+        void clear() noexcept { head_.store(0, std::memory_order_release); }
+    };
+
+    namespace trace {
+
+        // Every thread that traced gets a ring, registered here for collection.
+        // Rings live until process exit so a dump still sees exited threads.
+        struct Registry {
+            std::mutex mutex;
+            dp::Vector<TraceRing *> rings;
+
+            static Registry &instance() {
+                static Registry registry;
+                return registry;
+            }
+        };
+
+        inline TraceRing &ring() {
+            thread_local TraceRing *ring = [] {
+                Registry &reg = Registry::instance();
+                std::lock_guard<std::mutex> lock(reg.mutex);
+                auto *r = new TraceRing(static_cast<u32>(reg.rings.size()));
+                reg.rings.push_back(r);
+                return r;
+            }();
+            return *ring;
+        }
+
+        inline void emit(u8 level, TraceEvent event, u64 a = 0, u64 b = 0, u64 c = 0) noexcept {
+            ring().push(TraceRecord{monotonic_ns(), event, level, 0, static_cast<u32>(a), b, c});
+        }
+
+        // fn(const TraceRing &) for the ring of every thread that traced so far
+        template <typename Fn> void for_each_ring(Fn &&fn) {
+            Registry &reg = Registry::instance();
+            std::lock_guard<std::mutex> lock(reg.mutex);
+            for (const TraceRing *r : reg.rings)
+                fn(*r);
+        }
+
+        inline constexpr bool enabled(u8 level) noexcept { return level <= AGROBUS_TRACE_LEVEL; }
+
+    } // namespace trace
+
+} // namespace agrobus::net
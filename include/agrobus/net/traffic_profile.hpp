@@ -0,0 +1,272 @@
+#pragma once
+
+#include "bus_load.hpp"
+#include "frame.hpp"
+#include "types.hpp"
+#include <datapod/datapod.hpp>
+#include <cmath>
+
+namespace agrobus::net {
+
+    // ─── Traffic counters of one stream ──────────────────────────────────────────
+    struct TrafficStats {
+        u64 frames = 0;
+        u64 bytes = 0;
+        u64 bits = 0; // On the wire, under the profiler's bit model
+        u64 first_us = 0;
+        u64 last_us = 0;
+
+        // Inter-arrival time; a periodic PGN shows its period as the mean and
+        // its scheduling noise as the jitter. Plain sums keep recording free of
+        // divisions, the moments are derived when read.
+        u64 intervals = 0;
+        u64 interval_sum_us = 0;
+        f64 interval_sq_sum = 0.0;
+        u64 interval_min_us = 0;
+        u64 interval_max_us = 0;
+
+        f64 interval_mean_us() const noexcept {
+            return intervals == 0 ? 0.0 : static_cast<f64>(interval_sum_us) / static_cast<f64>(intervals);
+        }
+
+        // Standard deviation of the inter-arrival time
+        f64 jitter_us() const noexcept {
+            if (intervals < 2)
+                return 0.0;
+            f64 mean = interval_mean_us();
+            f64 var = interval_sq_sum / static_cast<f64>(intervals) - mean * mean;
+            return var > 0.0 ? std::sqrt(var) : 0.0;
+        }
+
+        void record(u8 length, u32 wire_bits, u64 timestamp_us) noexcept {
+            if (frames > 0) {
+                u64 dt = timestamp_us > last_us ? timestamp_us - last_us : 0;
+                ++intervals;
+                interval_sum_us += dt;
+                interval_sq_sum += static_cast<f64>(dt) * static_cast<f64>(dt);
+                if (intervals == 1 || dt < interval_min_us)
+                    interval_min_us = dt;
+                if (dt > interval_max_us)
+                    interval_max_us = dt;
+            } else {
+                first_us = timestamp_us;
+            }
+            ++frames;
+            bytes += length;
+            bits += wire_bits;
+            last_us = timestamp_us;
+        }
+    };
+
+    // ─── One (port, PGN, source) stream ──────────────────────────────────────────
+    struct TrafficEntry {
+        u8 port = 0;
+        PGN pgn = 0;
+        Address source = NULL_ADDRESS;
+        TrafficStats stats;
+    };
+
+    enum class TrafficOrder : u8 { Bits, Frames, Bytes };
+
+    // ─── Traffic profiler ────────────────────────────────────────────────────────
+    // Answers "who is using the bus": frame, byte and wire-bit counters with
+    // inter-arrival statistics per (port, PGN, source address), per source and
+    // per port. Everything is sized up front: sources are an array indexed by
+    // address, streams an open-addressed table probed from a hash of the key.
+    // Recording a frame is a probe and a few increments, so the profiler can
+    // stay on in production. Streams beyond the table capacity still count in
+    // the source and port totals (and in overflow()).
+    //
+    // Not thread-safe; IsoNet records and reads it on the thread that drives
+    // update(). Ports 0..MAX_PORTS-1 are profiled.
+    class TrafficProfiler {
+      public:
+        static constexpr u8 MAX_PORTS = 32;
+        static constexpr u32 MAX_PROBE = 16; // A full neighbourhood counts as overflow
+
+      private:
+        struct Slot {
+            u32 key = 0; // (pgn << 13 | port << 8 | source) + 1, 0 = free
+            TrafficStats stats;
+        };
+
+        struct Port {
+            dp::Array<TrafficStats, 256> sources = {};
+            TrafficStats total;
+        };
+
+        dp::Vector<Slot> slots_;
+        u32 mask_ = 0;
+        usize used_ = 0;
+        dp::Vector<Port> ports_;
+        u32 bitrate_;
+        BitModel model_;
+        u64 overflow_ = 0;
+        u64 start_us_ = 0;
+        u64 last_us_ = 0;
+        bool started_ = false;
+
+      public:
+        // `streams` is rounded up to a power of two; the table is probed
+        // linearly, so give it headroom over the streams expected on the bus
+        explicit TrafficProfiler(u32 streams = 1024, u8 ports = 1, u32 bitrate = BusLoad::CAN_BITRATE,
+                                 BitModel model = BitModel::Average)
+            : bitrate_(bitrate == 0 ? BusLoad::CAN_BITRATE : bitrate), model_(model) {
+            u32 size = 1;
+            while (size < streams)
+                size <<= 1;
+            slots_.resize(size);
+            mask_ = size - 1;
+            ports_.resize(ports == 0 ? 1 : (ports > MAX_PORTS ? MAX_PORTS : ports));
+        }
+
+        // ─── Recording ───────────────────────────────────────────────────────────
+        void record(const Frame &frame, u8 port, u64 timestamp_us) {
+            if (port >= MAX_PORTS)
+                return;
+            if (port >= ports_.size())
+                ports_.resize(port + 1);
+            if (!started_) {
+                start_us_ = timestamp_us;
+                started_ = true;
+            }
+            last_us_ = timestamp_us;
+
+            u32 wire_bits = BusLoad::bits(frame, model_);
+            Address source = frame.source();
+            Port &p = ports_[port];
+            p.total.record(frame.length, wire_bits, timestamp_us);
+            p.sources[source].record(frame.length, wire_bits, timestamp_us);
+
+            Slot *slot = claim(make_key(port, frame.pgn(), source));
+            if (!slot) {
+                ++overflow_;
+                return;
+            }
+            slot->stats.record(frame.length, wire_bits, timestamp_us);
+        }
+
+        void reset() {
+            for (auto &slot : slots_)
+                slot = Slot{};
+            for (auto &p : ports_)
+                p = Port{};
+            used_ = 0;
+            overflow_ = 0;
+            started_ = false;
+            start_us_ = 0;
+            last_us_ = 0;
+        }
+
+        // ─── Queries ─────────────────────────────────────────────────────────────
+        const TrafficStats *find(u8 port, PGN pgn, Address source) const noexcept {
+            if (port >= MAX_PORTS)
+                return nullptr;
+            u32 key = make_key(port, pgn, source);
+            u32 i = home(key);
+            for (u32 n = 0; n <= mask_ && n < MAX_PROBE; ++n, i = (i + 1) & mask_) {
+                if (slots_[i].key == key)
+                    return &slots_[i].stats;
+                if (slots_[i].key == 0)
+                    return nullptr;
+            }
+            return nullptr;
+        }
+
+        TrafficStats source(u8 port, Address sa) const noexcept {
+            return port < ports_.size() ? ports_[port].sources[sa] : TrafficStats{};
+        }
+
+        TrafficStats total(u8 port) const noexcept { return port < ports_.size() ? ports_[port].total : TrafficStats{}; }
+
+        // Share of the bus a stream took over the profiled time span (percent)
+        f32 load_percent(const TrafficStats &stats) const noexcept {
+            u64 span = span_us();
+            if (span == 0)
+                return 0.0f;
+            return static_cast<f32>(static_cast<f64>(stats.bits) * 1e8 / (static_cast<f64>(bitrate_) * span));
+        }
+
+        // The `n` busiest streams, busiest first
+        dp::Vector<TrafficEntry> top(usize n, TrafficOrder order = TrafficOrder::Bits) const {
+            dp::Vector<TrafficEntry> out;
+            if (n == 0)
+                return out;
+            for (const auto &slot : slots_) {
+                if (slot.key == 0)
+                    continue;
+                u64 value = weight(slot.stats, order);
+                if (out.size() == n && value <= weight(out.back().stats, order))
+                    continue;
+                if (out.size() < n)
+                    out.push_back(entry_of(slot));
+                else
+                    out.back() = entry_of(slot);
+                // Insertion into the sorted window
+                for (usize i = out.size() - 1; i > 0 && weight(out[i - 1].stats, order) < value; --i) {
+                    TrafficEntry tmp = out[i - 1];
+                    out[i - 1] = out[i];
+                    out[i] = tmp;
+                }
+            }
+            return out;
+        }
+
+        // fn(const TrafficEntry &) for every stream seen, in table order
+        template <typename Fn> void for_each(Fn &&fn) const {
+            for (const auto &slot : slots_) {
+                if (slot.key != 0)
+                    fn(entry_of(slot));
+            }
+        }
+
+        usize streams() const noexcept { return used_; }
+        usize capacity() const noexcept { return slots_.size(); }
+        u64 overflow() const noexcept { return overflow_; } // Frames with no stream slot left
+        u64 span_us() const noexcept { return last_us_ - start_us_; }
+        u32 bitrate() const noexcept { return bitrate_; }
+
+      private:
+        static constexpr u32 make_key(u8 port, PGN pgn, Address source) noexcept {
+            return ((static_cast<u32>(pgn) & 0x3FFFF) << 13 | static_cast<u32>(port & 0x1F) << 8 | source) + 1;
+        }
+
+        u32 home(u32 key) const noexcept { return (key * 0x9E3779B1u >> 12) & mask_; }
+
+        static u64 weight(const TrafficStats &s, TrafficOrder order) noexcept {
+            switch (order) {
+            case TrafficOrder::Frames:
+                return s.frames;
+            case TrafficOrder::Bytes:
+                return s.bytes;
+            default:
+                return s.bits;
+            }
+        }
+
+        static TrafficEntry entry_of(const Slot &slot) noexcept {
+            u32 key = slot.key - 1;
+            TrafficEntry e;
+            e.pgn = key >> 13;
+            e.port = static_cast<u8>((key >> 8) & 0x1F);
+            e.source = static_cast<Address>(key & 0xFF);
+            e.stats = slot.stats;
+            return e;
+        }
+
+        Slot *claim(u32 key) noexcept {
+            u32 i = home(key);
+            for (u32 n = 0; n <= mask_ && n < MAX_PROBE; ++n, i = (i + 1) & mask_) {
+                if (slots_[i].key == key)
+                    return &slots_[i];
+                if (slots_[i].key == 0) {
+                    slots_[i].key = key;
+                    ++used_;
+                    return &slots_[i];
+                }
+            }
+            return nullptr;
+        }
+    };
+
+} // namespace agrobus::net
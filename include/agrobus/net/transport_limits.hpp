@@ -0,0 +1,101 @@
+#pragma once
+
+#include <agrobus/net/types.hpp>
+#include <datapod/datapod.hpp>
+
+namespace agrobus::net {
+
+    // ─── Receive session caps ────────────────────────────────────────────────────
+    // Limits on what senders may make us hold. Bytes are what a session commits
+    // when its RTS/BAM is accepted (the announced size, or one window for a
+    // streaming ETP session). 0 = no limit.
+    struct TransportLimitsConfig {
+        u32 max_sessions = 0;            // Concurrent TP/BAM/ETP receive sessions overall
+        u64 max_bytes = 0;               // Bytes committed by all receive sessions
+        u32 max_sessions_per_source = 0; // Per (port, source address)
+        u64 max_bytes_per_source = 0;
+
+        bool limited() const noexcept {
+            return max_sessions != 0 || max_bytes != 0 || max_sessions_per_source != 0 || max_bytes_per_source != 0;
+        }
+    };
+
+    struct TransportUsage {
+        u32 sessions = 0;
+        u64 bytes = 0;
+    };
+
+    // ─── Receive session admission ───────────────────────────────────────────────
+    // Shared by TP and ETP so a source's sessions count against the same caps
+    // whichever protocol it uses. An RTS or BAM that would go past a cap is
+    // refused (RTS with a ResourcesUnavailable abort, BAM ignored); what an
+    // admitted session reserved is given back when it ends, however it ends.
+    // Owned by the network thread, like the protocols using it.
+    class TransportLimits {
+        TransportLimitsConfig config_;
+        dp::Map<u16, TransportUsage> sources_; // (port << 8 | source) -> usage
+        TransportUsage total_;
+        u64 rejected_ = 0;
+
+        static u16 key(u8 port, Address source) noexcept { return static_cast<u16>((port << 8) | source); }
+
+      public:
+        TransportLimits() = default;
+        explicit TransportLimits(TransportLimitsConfig config) : config_(config) {}
+
+        // New caps apply to the next admission; live sessions are left alone
+        void configure(TransportLimitsConfig config) noexcept { config_ = config; }
+        const TransportLimitsConfig &config() const noexcept { return config_; }
+
+        // Reserve a session of `bytes` for `source`, or refuse it
+        bool admit(u8 port, Address source, u64 bytes) {
+            TransportUsage &src = sources_[key(port, source)];
+            if (!fits(total_, bytes, config_.max_sessions, config_.max_bytes) ||
+                !fits(src, bytes, config_.max_sessions_per_source, config_.max_bytes_per_source)) {
+                if (src.sessions == 0)
+                    sources_.erase(key(port, source));
+                ++rejected_;
+                return false;
+            }
+            ++src.sessions;
+            src.bytes += bytes;
+            ++total_.sessions;
+            total_.bytes += bytes;
+            return true;
+        }
+
+        void release(u8 port, Address source, u64 bytes) noexcept {
+            auto it = sources_.find(key(port, source));
+            if (it == sources_.end())
+                return;
+            take(it->second, bytes);
+            take(total_, bytes);
+            if (it->second.sessions == 0)
+                sources_.erase(it);
+        }
+
+        TransportUsage total() const noexcept { return total_; }
+
+        TransportUsage source(u8 port, Address source) const {
+            auto it = sources_.find(key(port, source));
+            return it != sources_.end() ? it->second : TransportUsage{};
+        }
+
+        // Sessions refused since creation
+        u64 rejected() const noexcept { return rejected_; }
+
+      private:
+        static bool fits(const TransportUsage &usage, u64 bytes, u32 max_sessions, u64 max_bytes) noexcept {
+            if (max_sessions != 0 && usage.sessions >= max_sessions)
+                return false;
+            return max_bytes == 0 || (usage.bytes <= max_bytes && bytes <= max_bytes - usage.bytes);
+        }
+
+        static void take(TransportUsage &usage, u64 bytes) noexcept {
+            if (usage.sessions > 0)
+                --usage.sessions;
+            usage.bytes = usage.bytes > bytes ? usage.bytes - bytes : 0;
+        }
+    };
+
+} // namespace agrobus::net
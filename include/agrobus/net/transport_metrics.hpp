@@ -0,0 +1,134 @@
+#pragma once
+
+#include "session.hpp"
+#include <agrobus/net/types.hpp>
+#include <datapod/datapod.hpp>
+
+namespace agrobus::net {
+
+    // ─── Transport counters ──────────────────────────────────────────────────────
+    struct TransportCounters {
+        static constexpr usize NUM_REASONS = 10; // TransportAbortReason values 0..9
+
+        u64 started = 0;
+        u64 completed = 0;
+        u64 aborted = 0;
+        dp::Array<u64, NUM_REASONS> aborted_by_reason = {}; // Index = TransportAbortReason
+        u64 bytes = 0;       // Payload bytes of completed sessions
+        u64 retransmits = 0; // Packets a receiver asked for again (CTS behind what was sent)
+
+        // Session duration, first CM frame to completion (RTS -> EOMA, BAM -> last DT)
+        u64 duration_ms_sum = 0;
+        u32 duration_ms_max = 0;
+
+        // CTS round trip: window sent (or RTS) until the receiver's next CTS
+        u64 cts_rtt_samples = 0;
+        u64 cts_rtt_ms_sum = 0;
+        u32 cts_rtt_ms_max = 0;
+
+        u64 aborts(TransportAbortReason reason) const noexcept {
+            usize i = static_cast<usize>(reason);
+            return i < NUM_REASONS ? aborted_by_reason[i] : 0;
+        }
+
+        // Completed payload bytes per second of session time
+        f64 bytes_per_second() const noexcept {
+            return duration_ms_sum == 0 ? 0.0 : static_cast<f64>(bytes) * 1000.0 / static_cast<f64>(duration_ms_sum);
+        }
+
+        f64 mean_duration_ms() const noexcept {
+            return completed == 0 ? 0.0 : static_cast<f64>(duration_ms_sum) / static_cast<f64>(completed);
+        }
+
+        f64 mean_cts_rtt_ms() const noexcept {
+            return cts_rtt_samples == 0 ? 0.0 : static_cast<f64>(cts_rtt_ms_sum) / static_cast<f64>(cts_rtt_samples);
+        }
+    };
+
+    // ─── Transport metrics (pull API) ────────────────────────────────────────────
+    // Totals plus per-port and per-PGN breakdowns, recorded by TP, ETP and fast
+    // packet as sessions progress. Recording is a handful of integer updates
+    // and takes no lock; like the protocol itself, read it from the thread that
+    // drives update() (PortExecutor::post() hands a scrape to a shard's thread).
+    class TransportMetrics {
+        TransportCounters total_;
+        dp::Map<u8, TransportCounters> ports_;
+        dp::Map<PGN, TransportCounters> pgns_;
+
+      public:
+        const TransportCounters &total() const noexcept { return total_; }
+
+        TransportCounters port(u8 port) const {
+            auto it = ports_.find(port);
+            return it != ports_.end() ? it->second : TransportCounters{};
+        }
+
+        TransportCounters pgn(PGN pgn) const {
+            auto it = pgns_.find(pgn);
+            return it != pgns_.end() ? it->second : TransportCounters{};
+        }
+
+        // fn(u8 port, const TransportCounters &)
+        template <typename Fn> void for_each_port(Fn &&fn) const {
+            for (const auto &[port, c] : ports_)
+                fn(port, c);
+        }
+
+        // fn(PGN pgn, const TransportCounters &)
+        template <typename Fn> void for_each_pgn(Fn &&fn) const {
+            for (const auto &[pgn, c] : pgns_)
+                fn(pgn, c);
+        }
+
+        void reset() {
+            total_ = {};
+            ports_.clear();
+            pgns_.clear();
+        }
+
+        // ─── Recording ───────────────────────────────────────────────────────────
+        void started(u8 port, PGN pgn) {
+            apply(port, pgn, [](TransportCounters &c) { ++c.started; });
+        }
+
+        void completed(u8 port, PGN pgn, u32 bytes, u32 duration_ms) {
+            apply(port, pgn, [&](TransportCounters &c) {
+                ++c.completed;
+                c.bytes += bytes;
+                c.duration_ms_sum += duration_ms;
+                if (duration_ms > c.duration_ms_max)
+                    c.duration_ms_max = duration_ms;
+            });
+        }
+
+        void aborted(u8 port, PGN pgn, TransportAbortReason reason) {
+            usize i = static_cast<usize>(reason);
+            apply(port, pgn, [&](TransportCounters &c) {
+                ++c.aborted;
+                if (i < TransportCounters::NUM_REASONS)
+                    ++c.aborted_by_reason[i];
+            });
+        }
+
+        void cts_round_trip(u8 port, PGN pgn, u32 ms) {
+            apply(port, pgn, [&](TransportCounters &c) {
+                ++c.cts_rtt_samples;
+                c.cts_rtt_ms_sum += ms;
+                if (ms > c.cts_rtt_ms_max)
+                    c.cts_rtt_ms_max = ms;
+            });
+        }
+
+        void retransmits(u8 port, PGN pgn, u32 packets) {
+            apply(port, pgn, [&](TransportCounters &c) { c.retransmits += packets; });
+        }
+
+      private:
+        template <typename Fn> void apply(u8 port, PGN pgn, Fn &&fn) {
+            fn(total_);
+            fn(ports_[port]);
+            fn(pgns_[pgn]);
+        }
+    };
+
+} // namespace agrobus::net
@@ -0,0 +1,253 @@
+#pragma once
+
+#include <agrobus/net/bus_load.hpp>
+#include <agrobus/net/frame.hpp>
+#include <agrobus/net/types.hpp>
+#include <datapod/datapod.hpp>
+
+namespace agrobus::net {
+
+    // ─── Admission decision for a queued frame ───────────────────────────────────
+    enum class TxAdmit : u8 {
+        Send, // Write now
+        Hold, // Keep queued, continue with the next frame
+        Stop  // Keep this and every remaining frame queued
+    };
+
+    // ─── Per-port transmit queue ─────────────────────────────────────────────────
+    // Frames are collected into one lane per CAN priority (0-7) and written out
+    // in a single flush, highest priority first. Within a lane order is FIFO, so
+    // TP/ETP data packets of one session keep their sequence. Lane storage is
+    // reused between flushes; steady-state operation does not allocate.
+    template <typename F> class BasicTxQueue {
+        static constexpr usize NUM_LANES = 8;
+
+        dp::Array<dp::Vector<F>, NUM_LANES> lanes_;
+        usize size_ = 0;
+
+      public:
+        void push(const F &frame) {
+            lanes_[static_cast<u8>(frame.priority()) & 0x07].push_back(frame);
+            ++size_;
+        }
+
+        usize size() const noexcept { return size_; }
+        bool empty() const noexcept { return size_ == 0; }
+
+        usize lane_size(Priority prio) const noexcept { return lanes_[static_cast<u8>(prio) & 0x07].size(); }
+
+        // Hand every queued frame to `send` (bool(const F &)) in priority order.
+        // Returns the number of frames for which `send` reported success.
+        template <typename SendFn> usize flush(SendFn &&send) {
+            return flush(send, [](const F &) { return TxAdmit::Send; });
+        }
+
+        // Scheduled flush: `admit` (TxAdmit(const F &)) decides per frame whether
+        // it goes out now or stays queued for the next flush. Held frames keep their
+        // relative order. Returns the number of frames `send` accepted.
+        template <typename SendFn, typename AdmitFn> usize flush(SendFn &&send, AdmitFn &&admit) {
+            return flush_lanes(send, admit, false);
+        }
+
+        // Scheduled flush that treats a failed write as backpressure: the frame
+        // `send` rejected stays queued, and so does everything after it, since a
+        // driver that is out of buffers fails the rest the same way. The next
+        // flush retries from there in the original order.
+        template <typename SendFn, typename AdmitFn> usize flush_until_busy(SendFn &&send, AdmitFn &&admit) {
+            return flush_lanes(send, admit, true);
+        }
+
+        void clear() noexcept {
+            for (auto &lane : lanes_)
+                lane.clear();
+            size_ = 0;
+        }
+
+      private:
+        template <typename SendFn, typename AdmitFn> usize flush_lanes(SendFn &send, AdmitFn &admit, bool keep_failed) {
+            usize sent = 0;
+            bool stopped = false;
+            for (auto &lane : lanes_) {
+                usize keep = 0;
+                for (usize i = 0; i < lane.size(); ++i) {
+                    TxAdmit decision = stopped ? TxAdmit::Stop : admit(lane[i]);
+                    if (decision == TxAdmit::Stop)
+                        stopped = true;
+                    if (decision == TxAdmit::Send) {
+                        if (send(lane[i])) {
+                            ++sent;
+                            continue;
+                        }
+                        if (!keep_failed)
+                            continue;
+                        stopped = true;
+                    }
+                    if (keep != i)
+                        lane[keep] = lane[i];
+                    ++keep;
+                }
+                size_ -= lane.size() - keep;
+                lane.resize(keep);
+            }
+            return sent;
+        }
+    };
+
+    using TxQueue = BasicTxQueue<Frame>;
+    // A CAN FD port queues FdFrame, its classic frames included, so both kinds
+    // share the lanes and keep their order
+    using FdTxQueue = BasicTxQueue<FdFrame>;
+
+    // ─── Token bucket in CAN bits ────────────────────────────────────────────────
+    // Limits the share of the bus this node may occupy. Cost of a frame follows
+    // the BusLoad bit model so the limit matches the reported bus load.
+    class TxTokenBucket {
+        u32 rate_bps_ = 0; // 0 = unlimited
+        u32 bitrate_ = BusLoad::CAN_BITRATE;
+        i64 capacity_bits_ = 0;
+        i64 tokens_ = 0;
+        BitModel model_ = BitModel::Average;
+
+      public:
+        TxTokenBucket() = default;
+
+        // max_load_percent of bitrate, bursts up to burst_ms worth of tokens
+        TxTokenBucket(f32 max_load_percent, u32 bitrate = BusLoad::CAN_BITRATE, u32 burst_ms = 100,
+                      BitModel model = BitModel::Average) {
+            configure(max_load_percent, bitrate, burst_ms, model);
+        }
+
+        void configure(f32 max_load_percent, u32 bitrate = BusLoad::CAN_BITRATE, u32 burst_ms = 100,
+                       BitModel model = BitModel::Average) noexcept {
+            model_ = model;
+            bitrate_ = bitrate == 0 ? BusLoad::CAN_BITRATE : bitrate;
+            if (max_load_percent <= 0.0f || max_load_percent >= 100.0f) {
+                rate_bps_ = 0;
+                return;
+            }
+            rate_bps_ = static_cast<u32>(static_cast<f32>(bitrate) * max_load_percent / 100.0f);
+            capacity_bits_ = static_cast<i64>(rate_bps_) * burst_ms / 1000;
+            if (capacity_bits_ < BusLoad::frame_bits_worst(8))
+                capacity_bits_ = BusLoad::frame_bits_worst(8);
+            tokens_ = capacity_bits_;
+        }
+
+        bool limited() const noexcept { return rate_bps_ != 0; }
+        i64 tokens() const noexcept { return tokens_; }
+
+        void refill(u32 elapsed_ms) noexcept {
+            if (!limited())
+                return;
+            tokens_ += static_cast<i64>(rate_bps_) * elapsed_ms / 1000;
+            if (tokens_ > capacity_bits_)
+                tokens_ = capacity_bits_;
+        }
+
+        // Take tokens for a frame; fails (without taking) if the bucket is short
+        bool try_consume(u8 dlc) noexcept { return try_take(BusLoad::frame_bits(dlc)); }
+
+        // Same, with the frame's wire time under the configured bit model
+        bool try_consume(const Frame &frame) noexcept {
+            return !limited() || try_take(BusLoad::bits(frame, model_));
+        }
+
+        // Take tokens unconditionally (urgent traffic may run the bucket into debt)
+        void force_consume(u8 dlc) noexcept {
+            if (limited())
+                tokens_ -= BusLoad::frame_bits(dlc);
+        }
+
+        void force_consume(const Frame &frame) noexcept {
+            if (limited())
+                tokens_ -= BusLoad::bits(frame, model_);
+        }
+
+        // FD frames cost their FD wire time, with the data phase at
+        // `data_bitrate` when they switch rate (as BusLoad::add_frame)
+        bool try_consume(const FdFrame &frame, u32 data_bitrate) noexcept {
+            return !limited() || try_take(fd_bits(frame, data_bitrate));
+        }
+
+        void force_consume(const FdFrame &frame, u32 data_bitrate) noexcept {
+            if (limited())
+                tokens_ -= fd_bits(frame, data_bitrate);
+        }
+
+      private:
+        i64 fd_bits(const FdFrame &frame, u32 data_bitrate) const noexcept {
+            bool brs = (frame.flags & CAN_FD_FLAG_BRS) != 0;
+            return BusLoad::fd_frame_bits(frame.length, bitrate_, brs ? data_bitrate : 0,
+                                          model_ == BitModel::WorstCase);
+        }
+
+        bool try_take(i64 cost) noexcept {
+            if (!limited())
+                return true;
+            if (tokens_ < cost)
+                return false;
+            tokens_ -= cost;
+            return true;
+        }
+    };
+
+    // ─── Minimum interval between frames of one PGN ──────────────────────────────
+    class TxRateLimiter {
+        struct Limit {
+            PGN pgn = 0;
+            u32 min_interval_ms = 0;
+            u32 since_last_ms = 0;
+            bool sent_once = false;
+        };
+        dp::Vector<Limit> limits_;
+
+      public:
+        void set_limit(PGN pgn, u32 min_interval_ms) {
+            for (auto &l : limits_) {
+                if (l.pgn == pgn) {
+                    l.min_interval_ms = min_interval_ms;
+                    return;
+                }
+            }
+            limits_.push_back({pgn, min_interval_ms, 0, false});
+        }
+
+        void remove_limit(PGN pgn) {
+            for (auto it = limits_.begin(); it != limits_.end(); ++it) {
+                if (it->pgn == pgn) {
+                    limits_.erase(it);
+                    return;
+                }
+            }
+        }
+
+        bool empty() const noexcept { return limits_.empty(); }
+
+        void advance(u32 elapsed_ms) noexcept {
+            for (auto &l : limits_) {
+                if (l.since_last_ms < l.min_interval_ms)
+                    l.since_last_ms += elapsed_ms;
+            }
+        }
+
+        // True if a frame of this PGN may go out now
+        bool ready(PGN pgn) const noexcept {
+            for (const auto &l : limits_) {
+                if (l.pgn == pgn)
+                    return !l.sent_once || l.since_last_ms >= l.min_interval_ms;
+            }
+            return true;
+        }
+
+        // Record that a frame of this PGN went out
+        void mark_sent(PGN pgn) noexcept {
+            for (auto &l : limits_) {
+                if (l.pgn == pgn) {
+                    l.sent_once = true;
+                    l.since_last_ms = 0;
+                    return;
+                }
+            }
+        }
+    };
+
+} // namespace agrobus::net
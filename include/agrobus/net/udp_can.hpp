@@ -0,0 +1,340 @@
+#pragma once
+
+#include <agrobus/net/error.hpp>
+#include <agrobus/net/eth_can.hpp>
+#include <agrobus/net/types.hpp>
+#include <arpa/inet.h>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <echo/echo.hpp>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <wirebit/can/can_endpoint.hpp>
+
+namespace agrobus::net {
+
+    // ─── CAN-over-UDP datagram header ────────────────────────────────────────────
+    // [magic 'I' 'C'] [version] [record count] [sequence (4, little-endian)] [CAN records...]
+    // The records are the EthCan encoding. Every sender numbers its datagrams;
+    // receivers count the gaps as lost datagrams.
+    inline constexpr u8 UDP_CAN_MAGIC_0 = 'I';
+    inline constexpr u8 UDP_CAN_MAGIC_1 = 'C';
+    inline constexpr u8 UDP_CAN_VERSION = 1;
+    inline constexpr usize UDP_CAN_HEADER_SIZE = 8;
+    inline constexpr usize UDP_CAN_MAX_DATAGRAM = 1472; // 1500 MTU - IPv4 - UDP
+
+    // ─── Configuration for the UDP CAN tunnel ───────────────────────────────────
+    struct UdpCanConfig {
+        dp::String address = "239.255.11.78"; // Multicast group, or a unicast peer
+        u16 port = 11783;
+        dp::String interface = "0.0.0.0"; // Local interface for multicast
+        u8 ttl = 1;                        // Multicast hops
+        bool loopback = true;              // Receive our own multicast on this host
+        bool receive = true;               // Bind and join; false = send-only feed
+
+        // TX aggregation, as in EthCanConfig
+        u16 tx_batch_frames = 100;
+        u32 tx_flush_us = 1000;
+        usize tx_max_payload = UDP_CAN_MAX_DATAGRAM;
+
+        u16 mmsg_batch = 32;       // Datagrams per sendmmsg()/recvmmsg()
+        u32 rx_ring_frames = 4096; // Decoded frames waiting for IsoNet
+
+        UdpCanConfig &group(dp::String addr, u16 p) {
+            address = std::move(addr);
+            port = p;
+            return *this;
+        }
+        UdpCanConfig &via(dp::String local_interface) {
+            interface = std::move(local_interface);
+            return *this;
+        }
+        UdpCanConfig &hops(u8 t) {
+            ttl = t;
+            return *this;
+        }
+        UdpCanConfig &send_only() {
+            receive = false;
+            return *this;
+        }
+        UdpCanConfig &batch(u16 frames, u32 flush_us = 1000) {
+            tx_batch_frames = frames == 0 ? 1 : frames;
+            tx_flush_us = flush_us;
+            return *this;
+        }
+        UdpCanConfig &mmsg(u16 datagrams) {
+            mmsg_batch = datagrams == 0 ? 1 : datagrams;
+            return *this;
+        }
+        UdpCanConfig &rx_ring(u32 frames) {
+            rx_ring_frames = frames;
+            return *this;
+        }
+    };
+
+    // ─── UdpCan: CAN frames over UDP unicast/multicast ──────────────────────────
+    // The EthCan record format in UDP datagrams, so processes without raw
+    // sockets or L2 adjacency (cab PC, cloud uplink) can take a bus feed; with
+    // a multicast group one bus reader feeds any number of consumers.
+    // Datagrams leave in sendmmsg() batches and arrive through recvmmsg().
+    //
+    // Usage:
+    //   UdpCan udp(UdpCanConfig{}.group("239.255.11.78", 11783));
+    //   if (udp.open().is_ok()) {
+    //       nm.set_endpoint(0, &udp.can_endpoint());
+    //       nm.set_rx_source(0, udp.rx_source());
+    //   }
+    //   // In main loop:
+    //   udp.process(); // receive datagrams, send due TX batches
+    class UdpCan {
+        UdpCanConfig config_;
+        int fd_ = -1;
+        sockaddr_in dest_{};
+
+        // TX: datagrams being filled; sent together by flush()
+        dp::Vector<dp::Vector<u8>> tx_dgrams_;
+        u16 tx_count_ = 0;   // Finished datagrams waiting for sendmmsg()
+        u16 tx_records_ = 0; // Records in tx_dgrams_[tx_count_]
+        u64 tx_first_us_ = 0;
+        u32 tx_sequence_ = 0;
+        u32 tx_errors_ = 0;
+
+        // RX: one buffer per datagram of a recvmmsg() batch
+        dp::Vector<u8> rx_buf_;
+        dp::Vector<iovec> rx_iov_;
+        dp::Vector<mmsghdr> rx_msgs_;
+        dp::Vector<sockaddr_in> rx_from_;
+        CanFrameRing rx_ring_;
+
+        // Next expected sequence per sender (address << 16 | port)
+        dp::Map<u64, u32> rx_expected_;
+        u64 rx_datagrams_ = 0;
+        u64 rx_lost_ = 0;
+
+        std::shared_ptr<CanTunnelLink<UdpCan>> link_;
+        wirebit::CanEndpoint can_ep_;
+
+      public:
+        explicit UdpCan(UdpCanConfig config = {})
+            : config_(std::move(config)), link_(std::make_shared<CanTunnelLink<UdpCan>>(this, "udp_can")),
+              can_ep_(std::static_pointer_cast<wirebit::Link>(link_), wirebit::CanConfig{.bitrate = 250000}, 0) {
+            tx_dgrams_.resize(config_.mmsg_batch);
+            for (auto &d : tx_dgrams_)
+                d.reserve(config_.tx_max_payload);
+            rx_buf_.resize(static_cast<usize>(config_.mmsg_batch) * UDP_CAN_MAX_DATAGRAM);
+            rx_iov_.resize(config_.mmsg_batch);
+            rx_msgs_.resize(config_.mmsg_batch);
+            rx_from_.resize(config_.mmsg_batch);
+            rx_ring_.configure(config_.rx_ring_frames);
+        }
+
+        ~UdpCan() { close(); }
+
+        // The CAN endpoint points back here
+        UdpCan(const UdpCan &) = delete;
+        UdpCan &operator=(const UdpCan &) = delete;
+
+        // ─── Socket setup ────────────────────────────────────────────────────────
+        Result<void> open() {
+            close();
+            dest_ = {};
+            dest_.sin_family = AF_INET;
+            dest_.sin_port = htons(config_.port);
+            if (::inet_pton(AF_INET, config_.address.c_str(), &dest_.sin_addr) != 1)
+                return Result<void>::err(Error::invalid_state("bad UDP address"));
+            in_addr local{};
+            if (::inet_pton(AF_INET, config_.interface.c_str(), &local) != 1)
+                return Result<void>::err(Error::invalid_state("bad interface address"));
+
+            fd_ = ::socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+            if (fd_ < 0)
+                return Result<void>::err(Error(ErrorCode::DriverError, "UDP socket failed"));
+
+            bool multicast = IN_MULTICAST(ntohl(dest_.sin_addr.s_addr));
+            int one = 1;
+            ::setsockopt(fd_, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+            if (multicast) {
+                int ttl = config_.ttl;
+                int loop = config_.loopback ? 1 : 0;
+                ::setsockopt(fd_, IPPROTO_IP, IP_MULTICAST_TTL, &ttl, sizeof(ttl));
+                ::setsockopt(fd_, IPPROTO_IP, IP_MULTICAST_LOOP, &loop, sizeof(loop));
+                ::setsockopt(fd_, IPPROTO_IP, IP_MULTICAST_IF, &local, sizeof(local));
+            }
+
+            if (config_.receive) {
+                sockaddr_in bind_addr{};
+                bind_addr.sin_family = AF_INET;
+                bind_addr.sin_port = htons(config_.port);
+                bind_addr.sin_addr.s_addr = multicast ? dest_.sin_addr.s_addr : htonl(INADDR_ANY);
+                if (::bind(fd_, reinterpret_cast<sockaddr *>(&bind_addr), sizeof(bind_addr)) < 0) {
+                    close();
+                    return Result<void>::err(Error(ErrorCode::DriverError, "UDP bind failed"));
+                }
+                if (multicast) {
+                    ip_mreq mreq{};
+                    mreq.imr_multiaddr = dest_.sin_addr;
+                    mreq.imr_interface = local;
+                    if (::setsockopt(fd_, IPPROTO_IP, IP_ADD_MEMBERSHIP, &mreq, sizeof(mreq)) < 0) {
+                        close();
+                        return Result<void>::err(Error(ErrorCode::DriverError, "multicast join failed"));
+                    }
+                }
+            }
+            echo::category("isobus.udp_can")
+                .info("UdpCan open: ", config_.address.c_str(), ":", config_.port, multicast ? " (multicast)" : "");
+            return {};
+        }
+
+        void close() {
+            if (fd_ >= 0) {
+                flush();
+                ::close(fd_);
+                fd_ = -1;
+            }
+        }
+
+        bool is_open() const noexcept { return fd_ >= 0; }
+
+        // Get the CAN endpoint (pass to IsoNet::set_endpoint)
+        wirebit::CanEndpoint &can_endpoint() noexcept { return can_ep_; }
+
+        // Direct receive path (IsoNet::set_rx_source)
+        std::function<bool(can_frame &)> rx_source() {
+            return [this](can_frame &cf) { return rx_ring_.pop(cf); };
+        }
+
+        // ─── Receive ─────────────────────────────────────────────────────────────
+        // Drain the socket in recvmmsg() batches and decode the records; also
+        // sends a partial TX batch whose flush deadline has passed
+        void process() {
+            if (tx_records_ > 0 && now_us() - tx_first_us_ >= config_.tx_flush_us)
+                flush();
+            if (fd_ < 0 || !config_.receive)
+                return;
+
+            while (true) {
+                for (usize i = 0; i < rx_msgs_.size(); ++i) {
+                    rx_iov_[i].iov_base = rx_buf_.data() + i * UDP_CAN_MAX_DATAGRAM;
+                    rx_iov_[i].iov_len = UDP_CAN_MAX_DATAGRAM;
+                    rx_msgs_[i] = {};
+                    rx_msgs_[i].msg_hdr.msg_iov = &rx_iov_[i];
+                    rx_msgs_[i].msg_hdr.msg_iovlen = 1;
+                    rx_msgs_[i].msg_hdr.msg_name = &rx_from_[i];
+                    rx_msgs_[i].msg_hdr.msg_namelen = sizeof(sockaddr_in);
+                }
+                int n = ::recvmmsg(fd_, rx_msgs_.data(), static_cast<unsigned>(rx_msgs_.size()), MSG_DONTWAIT,
+                                   nullptr);
+                if (n <= 0)
+                    return;
+                for (int i = 0; i < n; ++i)
+                    decode_datagram(rx_buf_.data() + static_cast<usize>(i) * UDP_CAN_MAX_DATAGRAM, rx_msgs_[i].msg_len,
+                                    rx_from_[i]);
+                if (static_cast<usize>(n) < rx_msgs_.size())
+                    return;
+            }
+        }
+
+        // ─── Transmit ────────────────────────────────────────────────────────────
+        void send_can(const can_frame &cf) {
+            usize record = ETH_CAN_HEADER_SIZE + (cf.can_dlc > 8 ? 8 : cf.can_dlc);
+            if (tx_records_ > 0 && tx_dgrams_[tx_count_].size() + record > config_.tx_max_payload)
+                finish_datagram();
+            auto &d = tx_dgrams_[tx_count_];
+            if (tx_records_ == 0) {
+                d.clear();
+                d.resize(UDP_CAN_HEADER_SIZE);
+                tx_first_us_ = now_us();
+            }
+            append_can_record(d, cf);
+            ++tx_records_;
+            if (tx_records_ >= config_.tx_batch_frames || tx_records_ == 255)
+                finish_datagram();
+        }
+
+        // Send every queued datagram now (one sendmmsg() call per batch)
+        void flush() {
+            if (tx_records_ > 0)
+                seal_datagram();
+            if (tx_count_ == 0)
+                return;
+            if (fd_ >= 0) {
+                dp::Vector<iovec> iov(tx_count_);
+                dp::Vector<mmsghdr> msgs(tx_count_);
+                for (u16 i = 0; i < tx_count_; ++i) {
+                    iov[i].iov_base = tx_dgrams_[i].data();
+                    iov[i].iov_len = tx_dgrams_[i].size();
+                    msgs[i] = {};
+                    msgs[i].msg_hdr.msg_iov = &iov[i];
+                    msgs[i].msg_hdr.msg_iovlen = 1;
+                    msgs[i].msg_hdr.msg_name = &dest_;
+                    msgs[i].msg_hdr.msg_namelen = sizeof(dest_);
+                }
+                int sent = ::sendmmsg(fd_, msgs.data(), tx_count_, MSG_DONTWAIT);
+                if (sent < static_cast<int>(tx_count_))
+                    tx_errors_ += tx_count_ - (sent < 0 ? 0 : static_cast<u32>(sent));
+            } else {
+                tx_errors_ += tx_count_;
+            }
+            tx_count_ = 0;
+        }
+
+        // ─── Statistics ──────────────────────────────────────────────────────────
+        u64 datagrams_received() const noexcept { return rx_datagrams_; }
+        u64 datagrams_lost() const noexcept { return rx_lost_; } // Sequence gaps, all senders
+        u32 send_errors() const noexcept { return tx_errors_; }
+        u32 rx_dropped() const noexcept { return rx_ring_.dropped(); }
+        u32 rx_pending() const noexcept { return rx_ring_.size(); }
+        bool pop_can(can_frame &cf) noexcept { return rx_ring_.pop(cf); }
+
+      private:
+        // Write the header of the datagram being filled
+        void seal_datagram() {
+            auto &d = tx_dgrams_[tx_count_];
+            d[0] = UDP_CAN_MAGIC_0;
+            d[1] = UDP_CAN_MAGIC_1;
+            d[2] = UDP_CAN_VERSION;
+            d[3] = static_cast<u8>(tx_records_);
+            for (u8 i = 0; i < 4; ++i)
+                d[4 + i] = static_cast<u8>(tx_sequence_ >> (8 * i));
+            ++tx_sequence_;
+            ++tx_count_;
+            tx_records_ = 0;
+        }
+
+        void finish_datagram() {
+            seal_datagram();
+            if (tx_count_ >= tx_dgrams_.size())
+                flush();
+        }
+
+        void decode_datagram(const u8 *data, usize size, const sockaddr_in &from) {
+            if (size < UDP_CAN_HEADER_SIZE || data[0] != UDP_CAN_MAGIC_0 || data[1] != UDP_CAN_MAGIC_1 ||
+                data[2] != UDP_CAN_VERSION)
+                return;
+            ++rx_datagrams_;
+            u32 seq = static_cast<u32>(data[4]) | (static_cast<u32>(data[5]) << 8) |
+                      (static_cast<u32>(data[6]) << 16) | (static_cast<u32>(data[7]) << 24);
+            u64 sender = (static_cast<u64>(ntohl(from.sin_addr.s_addr)) << 16) | ntohs(from.sin_port);
+            auto it = rx_expected_.find(sender);
+            if (it != rx_expected_.end()) {
+                u32 gap = seq - it->second;
+                if (gap < 0x80000000u) // Ahead of the expected one; behind = late duplicate
+                    rx_lost_ += gap;
+                else
+                    return;
+            }
+            rx_expected_[sender] = seq + 1;
+            for_each_can_record(data + UDP_CAN_HEADER_SIZE, size - UDP_CAN_HEADER_SIZE,
+                                [this](const can_frame &cf) { rx_ring_.push(cf); });
+        }
+
+        static u64 now_us() {
+            return static_cast<u64>(std::chrono::duration_cast<std::chrono::microseconds>(
+                                        std::chrono::steady_clock::now().time_since_epoch())
+                                        .count());
+        }
+    };
+
+} // namespace agrobus::net
@@ -0,0 +1,166 @@
+#pragma once
+
+#include "event.hpp"
+#include "latency.hpp"
+#include "types.hpp"
+#include <datapod/datapod.hpp>
+#include <cstring>
+#include <memory>
+
+namespace agrobus::net {
+
+    // ─── Summary of one subsystem ────────────────────────────────────────────────
+    struct SubsystemProfile {
+        const char *name = nullptr;
+        u64 count = 0; // Scopes recorded
+        u64 min_ns = 0;
+        f64 mean_ns = 0.0;
+        u64 p99_ns = 0;
+        u64 max_ns = 0;
+        u64 budget_ns = 0; // 0 = no budget
+        u64 overruns = 0;  // Scopes that took longer than the budget
+    };
+
+    // ─── Update time profiler ────────────────────────────────────────────────────
+    // Where an application tick goes: every subsystem's update() (and IsoNet's
+    // callback dispatch and timers) runs in a ProfileScope that records its
+    // duration under the subsystem's name. Slots are fixed (MAX_SUBSYSTEMS, a
+    // LatencyHistogram each, allocated when a name is first seen), so recording
+    // is two clock reads and a histogram add; cheap enough to leave on. Install
+    // it with IsoNet::set_update_profiler() and wrap the application's own tick:
+    //     ProfileScope tick(&profiler, "tick");
+    // Single-threaded: record and read from the thread driving update().
+    class UpdateProfiler {
+      public:
+        static constexpr usize MAX_SUBSYSTEMS = 32;
+        static constexpr u16 NO_SLOT = 0xFFFF;
+
+      private:
+        struct Slot {
+            const char *name = nullptr;
+            u64 budget_ns = 0;
+            u64 overruns = 0;
+            std::unique_ptr<LatencyHistogram> histogram;
+        };
+        dp::Array<Slot, MAX_SUBSYSTEMS> slots_;
+        u16 used_ = 0;
+        u64 default_budget_ns_ = 0;
+        LatencyClock clock_ = &monotonic_ns;
+
+      public:
+        UpdateProfiler() = default;
+        // `budget_ns` applies to every subsystem without a budget of its own
+        explicit UpdateProfiler(u64 budget_ns) : default_budget_ns_(budget_ns) {}
+
+        UpdateProfiler(const UpdateProfiler &) = delete;
+        UpdateProfiler &operator=(const UpdateProfiler &) = delete;
+
+        void set_clock(LatencyClock clock) noexcept { clock_ = clock ? clock : &monotonic_ns; }
+        u64 now_ns() const noexcept { return clock_(); }
+
+        // ─── Subsystems ──────────────────────────────────────────────────────────
+        // Slot of `name`, registering it on first use; NO_SLOT once all slots are
+        // taken. Names are compared by pointer first: pass string literals.
+        u16 slot(const char *name) {
+            for (u16 i = 0; i < used_; ++i) {
+                if (slots_[i].name == name)
+                    return i;
+            }
+            for (u16 i = 0; i < used_; ++i) {
+                if (std::strcmp(slots_[i].name, name) == 0)
+                    return i;
+            }
+            if (used_ == MAX_SUBSYSTEMS)
+                return NO_SLOT;
+            Slot &s = slots_[used_];
+            s.name = name;
+            s.budget_ns = default_budget_ns_;
+            s.histogram = std::make_unique<LatencyHistogram>();
+            return used_++;
+        }
+
+        void set_budget(const char *name, u64 budget_ns) {
+            u16 i = slot(name);
+            if (i != NO_SLOT)
+                slots_[i].budget_ns = budget_ns;
+        }
+
+        usize size() const noexcept { return used_; }
+
+        // ─── Recording ───────────────────────────────────────────────────────────
+        void record(u16 slot, u64 ns) {
+            if (slot >= used_)
+                return;
+            Slot &s = slots_[slot];
+            s.histogram->record(ns);
+            if (s.budget_ns > 0 && ns > s.budget_ns) {
+                ++s.overruns;
+                on_overrun.emit(s.name, ns);
+            }
+        }
+
+        // ─── Reading ─────────────────────────────────────────────────────────────
+        SubsystemProfile profile(u16 slot) const noexcept {
+            if (slot >= used_)
+                return {};
+            const Slot &s = slots_[slot];
+            const LatencyHistogram &h = *s.histogram;
+            return SubsystemProfile{s.name, h.count(), h.min(), h.mean(), h.percentile(99.0), h.max(), s.budget_ns,
+                                    s.overruns};
+        }
+
+        // Empty profile for a name never recorded
+        SubsystemProfile profile(const char *name) const noexcept {
+            for (u16 i = 0; i < used_; ++i) {
+                if (std::strcmp(slots_[i].name, name) == 0)
+                    return profile(i);
+            }
+            return {};
+        }
+
+        // fn(const SubsystemProfile &) for every subsystem, in registration order
+        template <typename Fn> void for_each(Fn &&fn) const {
+            for (u16 i = 0; i < used_; ++i)
+                fn(profile(i));
+        }
+
+        // Clear the samples and overrun counts; names and budgets stay
+        void reset() noexcept {
+            for (u16 i = 0; i < used_; ++i) {
+                slots_[i].histogram->reset();
+                slots_[i].overruns = 0;
+            }
+        }
+
+        // (subsystem, ns) for every scope past its budget
+        Event<const char *, u64> on_overrun;
+    };
+
+    // ─── Profiling scope ─────────────────────────────────────────────────────────
+    // Times the enclosing block into `profiler` (null = off: one branch)
+    class ProfileScope {
+        UpdateProfiler *profiler_;
+        u16 slot_ = UpdateProfiler::NO_SLOT;
+        u64 start_ns_ = 0;
+
+      public:
+        ProfileScope(UpdateProfiler *profiler, u16 slot) : profiler_(profiler), slot_(slot) {
+            if (profiler_)
+                start_ns_ = profiler_->now_ns();
+        }
+        ProfileScope(UpdateProfiler *profiler, const char *name) : profiler_(profiler) {
+            if (profiler_) {
+                slot_ = profiler_->slot(name);
+                start_ns_ = profiler_->now_ns();
+            }
+        }
+        ~ProfileScope() {
+            if (profiler_)
+                profiler_->record(slot_, profiler_->now_ns() - start_ns_);
+        }
+
+        ProfileScope(const ProfileScope &) = delete;
+        ProfileScope &operator=(const ProfileScope &) = delete;
+    };
+
+} // namespace agrobus::net
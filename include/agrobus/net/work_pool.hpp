@@ -0,0 +1,206 @@
+#pragma once
+
+#include "types.hpp"
+#include <datapod/datapod.hpp>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unistd.h>
+
+namespace agrobus::net {
+
+    // ─── Work-stealing pool for heavy protocol work ──────────────────────────────
+    // Callbacks run on the network thread inside IsoNet::update(); anything that
+    // takes milliseconds (parsing an uploaded object pool, DDOP conversion)
+    // stalls frame processing. Such work is submitted here instead and its
+    // continuation is handed back to the network thread:
+    //
+    //   net.offload([bytes] { return ObjectPool::deserialize(bytes); },
+    //               [this, addr](Result<ObjectPool> pool) { ... send the response ... });
+    //
+    // Each worker owns a deque: it pops its newest job and, when idle, steals
+    // the oldest job of another worker. Submissions are spread round-robin.
+    // Continuations queue up until the owner calls drain() (IsoNet does this
+    // every update); `notify_fd` (an eventfd) is signalled for each one so a
+    // blocked IsoNet::wait() returns.
+    class WorkPool {
+      public:
+        using Job = std::function<void()>;
+
+      private:
+        struct Worker {
+            std::mutex mutex;
+            std::deque<Job> jobs;
+            std::thread thread;
+        };
+
+        dp::Vector<std::unique_ptr<Worker>> workers_;
+        std::mutex idle_mutex_;
+        std::condition_variable idle_cv_;
+        std::atomic<usize> queued_{0};
+        std::atomic<bool> running_{true};
+        std::atomic<u32> next_{0};
+
+        std::mutex done_mutex_;
+        dp::Vector<Job> done_;
+        dp::Vector<Job> running_done_;
+        std::atomic<usize> done_count_{0};
+        int notify_fd_ = -1;
+
+      public:
+        explicit WorkPool(u32 threads, int notify_fd = -1) : notify_fd_(notify_fd) {
+            if (threads == 0)
+                threads = 1;
+            for (u32 i = 0; i < threads; ++i)
+                workers_.push_back(std::make_unique<Worker>());
+            for (u32 i = 0; i < threads; ++i)
+                workers_[i]->thread = std::thread([this, i]() { run(i); });
+        }
+
+        ~WorkPool() { stop(); }
+
+        WorkPool(const WorkPool &) = delete;
+        WorkPool &operator=(const WorkPool &) = delete;
+
+        // Join the workers; jobs not started yet are dropped
+        void stop() {
+            {
+                std::lock_guard<std::mutex> lock(idle_mutex_);
+                running_.store(false, std::memory_order_release);
+            }
+            idle_cv_.notify_all();
+            for (auto &w : workers_) {
+                if (w->thread.joinable())
+                    w->thread.join();
+            }
+        }
+
+        u32 threads() const noexcept { return static_cast<u32>(workers_.size()); }
+
+        // ─── Any thread ──────────────────────────────────────────────────────────
+        void submit(Job job) {
+            u32 at = next_.fetch_add(1, std::memory_order_relaxed) % threads();
+            {
+                std::lock_guard<std::mutex> lock(workers_[at]->mutex);
+                workers_[at]->jobs.push_back(std::move(job));
+                // Counted while the deque is locked, so a worker that takes the
+                // job always finds the count already raised
+                std::lock_guard<std::mutex> idle(idle_mutex_);
+                queued_.fetch_add(1, std::memory_order_release);
+            }
+            idle_cv_.notify_one();
+        }
+
+        // Queue a continuation for the owner thread (called from jobs)
+        void complete(Job done) {
+            {
+                std::lock_guard<std::mutex> lock(done_mutex_);
+                done_.push_back(std::move(done));
+            }
+            done_count_.fetch_add(1, std::memory_order_release);
+            if (notify_fd_ >= 0) {
+                u64 one = 1;
+                (void)!::write(notify_fd_, &one, sizeof(one));
+            }
+        }
+
+        usize pending() const noexcept { return queued_.load(std::memory_order_acquire); }
+        bool has_completions() const noexcept { return done_count_.load(std::memory_order_acquire) > 0; }
+
+        // ─── Owner thread ────────────────────────────────────────────────────────
+        // Run the continuations that arrived so far; returns how many ran
+        usize drain() {
+            if (!has_completions())
+                return 0;
+            {
+                std::lock_guard<std::mutex> lock(done_mutex_);
+                running_done_.swap(done_);
+            }
+            done_count_.fetch_sub(running_done_.size(), std::memory_order_acq_rel);
+            for (auto &fn : running_done_)
+                fn();
+            usize n = running_done_.size();
+            running_done_.clear();
+            return n;
+        }
+
+      private:
+        // Own newest job first (still warm in cache), else the oldest of a peer
+        bool take(u32 self, Job &out) {
+            {
+                Worker &w = *workers_[self];
+                std::lock_guard<std::mutex> lock(w.mutex);
+                if (!w.jobs.empty()) {
+                    out = std::move(w.jobs.back());
+                    w.jobs.pop_back();
+                    return true;
+                }
+            }
+            for (u32 k = 1; k < threads(); ++k) {
+                Worker &victim = *workers_[(self + k) % threads()];
+                std::lock_guard<std::mutex> lock(victim.mutex);
+                if (!victim.jobs.empty()) {
+                    out = std::move(victim.jobs.front());
+                    victim.jobs.pop_front();
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        void run(u32 self) {
+            Job job;
+            while (true) {
+                {
+                    std::unique_lock<std::mutex> lock(idle_mutex_);
+                    idle_cv_.wait(lock, [this]() {
+                        return !running_.load(std::memory_order_acquire) ||
+                               queued_.load(std::memory_order_acquire) > 0;
+                    });
+                    if (!running_.load(std::memory_order_acquire))
+                        return;
+                }
+                if (!take(self, job))
+                    continue; // Another worker got it first
+                queued_.fetch_sub(1, std::memory_order_acq_rel);
+                job();
+                job = nullptr;
+            }
+        }
+    };
+
+    // ─── Fork-join over index ranges ─────────────────────────────────────────────
+    // Calls fn(begin, end) for up to `threads` (0 = one per core) slices of
+    // [0, n), none smaller than `min_per_thread`; the calling thread takes the
+    // first slice and returns once every slice is done. For one-off batch work
+    // (converting a log, parsing a pool file) where a WorkPool would sit idle
+    // afterwards.
+    template <typename Fn> void parallel_ranges(usize n, u32 threads, usize min_per_thread, Fn &&fn) {
+        if (threads == 0)
+            threads = std::thread::hardware_concurrency() ? std::thread::hardware_concurrency() : 1;
+        usize useful = min_per_thread > 0 ? (n + min_per_thread - 1) / min_per_thread : n;
+        if (threads > useful)
+            threads = static_cast<u32>(useful ? useful : 1);
+        if (threads <= 1) {
+            fn(usize{0}, n);
+            return;
+        }
+        usize per = (n + threads - 1) / threads;
+        dp::Vector<std::thread> workers;
+        workers.reserve(threads - 1);
+        for (u32 t = 1; t < threads; ++t) {
+            usize begin = t * per;
+            usize end = begin + per < n ? begin + per : n;
+            if (begin < end)
+                workers.emplace_back([&fn, begin, end]() { fn(begin, end); });
+        }
+        fn(usize{0}, per < n ? per : n);
+        for (auto &w : workers)
+            w.join();
+    }
+
+} // namespace agrobus::net
@@ -21,22 +21,42 @@ namespace agrobus::net {
         Name member_name; // 8-byte NAME of the member CF
     };
 
+    // A working set announced by another master
+    struct RemoteWorkingSet {
+        Address master = NULL_ADDRESS;
+        u8 announced_size = 0;  // Set size from the master message, master included
+        dp::Vector<Name> members; // Member NAMEs received since that message
+
+        bool complete() const noexcept { return members.size() + 1 >= announced_size; }
+    };
+
     // ─── Working Set Manager ────────────────────────────────────────────────────
-    // Handles broadcasting and receiving of working set announcements.
+    // Handles broadcasting and receiving of working set announcements. One
+    // manager per internal CF can be shared by its VT, TC and file clients
+    // (set_working_set_manager()): each calls announce() before talking to its
+    // server, and the set is announced once rather than once per client.
     class WorkingSetManager {
         IsoNet &net_;
         InternalCF *cf_;
-        dp::Vector<Name> members_;                       // member NAMEs (excluding master)
-        dp::Map<Address, dp::Vector<Name>> remote_sets_; // remote working sets
+        dp::Vector<Name> members_; // member NAMEs (excluding master)
+
+        // Remote working sets, indexed by master address
+        static constexpr u8 NO_SET = 0xFF;
+        dp::Vector<RemoteWorkingSet> remote_sets_;
+        dp::Array<u8, 256> remote_index_;
 
         // ISO 11783-7 Section 10.2: 100ms minimum between member messages
         static constexpr u32 MEMBER_MSG_INTERVAL_MS = 100;
-        dp::Vector<Name> pending_members_; // queued member messages to send
+        u32 member_interval_ms_ = MEMBER_MSG_INTERVAL_MS;
+        dp::Vector<Frame> burst_; // Master then member frames of the last announcement
+        usize next_frame_ = 0;    // First frame of burst_ not sent yet
         u32 member_timer_ms_ = 0;
         bool broadcasting_ = false;
+        bool announced_ = false;
+        Address announced_address_ = NULL_ADDRESS;
 
       public:
-        WorkingSetManager(IsoNet &net, InternalCF *cf) : net_(net), cf_(cf) {}
+        WorkingSetManager(IsoNet &net, InternalCF *cf) : net_(net), cf_(cf) { remote_index_.fill(NO_SET); }
 
         Result<void> initialize() {
             if (!cf_) {
@@ -48,65 +68,94 @@ namespace agrobus::net {
             return {};
         }
 
+        InternalCF *control_function() const noexcept { return cf_; }
+
         // ─── Local working set management ────────────────────────────────────────
+        // A changed set is announced again on the next announce()
         Result<void> add_member(Name member_name) {
             members_.push_back(member_name);
+            announced_ = false;
             return {};
         }
 
-        void clear_members() { members_.clear(); }
+        void clear_members() {
+            members_.clear();
+            announced_ = false;
+        }
         const dp::Vector<Name> &members() const noexcept { return members_; }
         usize set_size() const noexcept { return members_.size() + 1; } // +1 for master
 
+        // Spacing between member messages; 0 sends master and members as one burst
+        void set_member_interval(u32 ms) noexcept { member_interval_ms_ = ms; }
+        u32 member_interval() const noexcept { return member_interval_ms_; }
+
         // ─── Broadcast working set ───────────────────────────────────────────────
-        // Call this to announce the working set. Sends the master message immediately,
-        // then queues member messages with 100ms spacing per ISO 11783-7 Section 10.2.
-        // Call update() periodically to send queued member messages.
+        // Call this to announce the working set. All frames are encoded up front;
+        // the master message goes out immediately and the member messages follow
+        // with the member interval (100ms per ISO 11783-7 Section 10.2) from
+        // update(), or in the same TX flush when the interval is 0.
         Result<void> broadcast_working_set() {
             if (!cf_) {
                 return Result<void>::err(Error::invalid_state("control function not set"));
             }
 
-            // Send Working Set Master message: Byte 1 = total set size (master + members)
-            dp::Vector<u8> master_data(8, 0xFF);
+            Address src = cf_->address();
+            burst_.clear();
+            // Working Set Master message: Byte 1 = total set size (master + members)
+            dp::Array<u8, 8> master_data;
+            master_data.fill(0xFF);
             master_data[0] = static_cast<u8>(set_size());
-            auto result = net_.send(PGN_WORKING_SET_MASTER, master_data, cf_);
+            burst_.push_back(Frame::from_message(Priority::Default, PGN_WORKING_SET_MASTER, src, BROADCAST_ADDRESS,
+                                                 master_data.data()));
+            for (const auto &member : members_) {
+                auto mbytes = member.to_bytes();
+                burst_.push_back(Frame::from_message(Priority::Default, PGN_WORKING_SET_MEMBER, src,
+                                                     BROADCAST_ADDRESS, mbytes.data()));
+            }
+
+            usize now = member_interval_ms_ == 0 ? burst_.size() : 1;
+            auto result = net_.send_batch(burst_.data(), now, cf_);
             if (!result.is_ok())
                 return result;
 
-            // Queue member messages for timed sending (100ms spacing)
-            pending_members_ = members_;
+            next_frame_ = now;
             member_timer_ms_ = 0;
-            broadcasting_ = !pending_members_.empty();
+            broadcasting_ = next_frame_ < burst_.size();
+            announced_ = true;
+            announced_address_ = src;
 
             echo::category("isobus.network.working_set")
-                .debug("broadcast working set: size=", set_size(), " members queued=", pending_members_.size());
+                .debug("broadcast working set: size=", set_size(), " members queued=", burst_.size() - next_frame_);
             return {};
         }
 
+        // Announce unless the current set was already announced from the current
+        // address: the call every client sharing this manager makes on connect
+        Result<void> announce() {
+            if (announced_ && cf_ && announced_address_ == cf_->address())
+                return {};
+            return broadcast_working_set();
+        }
+
+        bool is_announced() const noexcept { return announced_; }
+
         // ─── Periodic update ───────────────────────────────────────────────────────
-        // Sends queued member messages with 100ms spacing per ISO 11783-7 Section 10.2.
+        // Sends queued member messages with the member interval.
         void update(u32 elapsed_ms) {
-            if (!broadcasting_ || pending_members_.empty())
+            if (!broadcasting_)
                 return;
 
             member_timer_ms_ += elapsed_ms;
-            if (member_timer_ms_ >= MEMBER_MSG_INTERVAL_MS) {
-                member_timer_ms_ -= MEMBER_MSG_INTERVAL_MS;
+            if (member_timer_ms_ >= member_interval_ms_) {
+                member_timer_ms_ -= member_interval_ms_;
 
                 // Send next member message
-                const Name &member = pending_members_.front();
-                dp::Vector<u8> member_data(8, 0xFF);
-                auto mbytes = member.to_bytes();
-                for (usize i = 0; i < 8; ++i) {
-                    member_data[i] = mbytes[i];
-                }
-                net_.send(PGN_WORKING_SET_MEMBER, member_data, cf_);
+                net_.send_batch(&burst_[next_frame_], 1, cf_);
+                ++next_frame_;
                 echo::category("isobus.network.working_set")
-                    .debug("sent member message, remaining=", pending_members_.size() - 1);
+                    .debug("sent member message, remaining=", burst_.size() - next_frame_);
 
-                pending_members_.erase(pending_members_.begin());
-                if (pending_members_.empty()) {
+                if (next_frame_ >= burst_.size()) {
                     broadcasting_ = false;
                     echo::category("isobus.network.working_set").debug("broadcast complete");
                 }
@@ -116,12 +165,16 @@ namespace agrobus::net {
         bool is_broadcasting() const noexcept { return broadcasting_; }
 
         // ─── Query remote working sets ───────────────────────────────────────────
-        const dp::Map<Address, dp::Vector<Name>> &remote_sets() const noexcept { return remote_sets_; }
+        const dp::Vector<RemoteWorkingSet> &remote_sets() const noexcept { return remote_sets_; }
+
+        const RemoteWorkingSet *find_remote_set(Address master_addr) const noexcept {
+            u8 slot = remote_index_[master_addr];
+            return slot == NO_SET ? nullptr : &remote_sets_[slot];
+        }
 
         dp::Optional<dp::Vector<Name>> get_remote_set(Address master_addr) const {
-            auto it = remote_sets_.find(master_addr);
-            if (it != remote_sets_.end()) {
-                return it->second;
+            if (const auto *set = find_remote_set(master_addr)) {
+                return set->members;
             }
             return dp::nullopt;
         }
@@ -131,11 +184,22 @@ namespace agrobus::net {
         Event<Address, Name> on_member_received; // master address, member NAME
 
       private:
+        RemoteWorkingSet &remote_set(Address master_addr) {
+            u8 &slot = remote_index_[master_addr];
+            if (slot == NO_SET) {
+                slot = static_cast<u8>(remote_sets_.size());
+                remote_sets_.push_back({master_addr, 0, {}});
+            }
+            return remote_sets_[slot];
+        }
+
         void handle_master(const Message &msg) {
-            if (msg.data.empty())
+            if (msg.data.empty() || msg.source >= NULL_ADDRESS)
                 return;
-            u8 announced_size = msg.data[0];  // Total members (including master)
-            remote_sets_[msg.source].clear(); // new announcement resets the set
+            u8 announced_size = msg.data[0]; // Total members (including master)
+            auto &set = remote_set(msg.source);
+            set.announced_size = announced_size;
+            set.members.clear(); // new announcement resets the set
             // Use the master's NAME from the network manager for the event
             Name master_name; // Will be resolved by address claim
             on_master_received.emit(msg.source, master_name);
@@ -143,13 +207,14 @@ namespace agrobus::net {
         }
 
         void handle_member(const Message &msg) {
-            if (msg.data.size() < 8)
+            if (msg.data.size() < 8 || msg.source >= NULL_ADDRESS)
                 return;
             Name member_name = Name::from_bytes(msg.data.data());
-            remote_sets_[msg.source].push_back(member_name);
+            auto &set = remote_set(msg.source);
+            set.members.push_back(member_name);
             on_member_received.emit(msg.source, member_name);
             echo::category("isobus.network.working_set")
-                .debug("member from SA=", msg.source, " count=", remote_sets_[msg.source].size());
+                .debug("member from SA=", msg.source, " count=", set.members.size());
         }
     };
 } // namespace agrobus::net
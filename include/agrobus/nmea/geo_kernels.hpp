@@ -0,0 +1,192 @@
+#pragma once
+
+#include <agrobus/net/types.hpp>
+#include <agrobus/net/work_pool.hpp>
+#include <array>
+#include <cmath>
+#include <datapod/datapod.hpp>
+
+#if !defined(AGROBUS_SIMD_DISABLED) && defined(__AVX2__) && defined(__FMA__)
+#include <immintrin.h>
+#define AGROBUS_GEO_AVX2 1
+#elif !defined(AGROBUS_SIMD_DISABLED) && defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define AGROBUS_GEO_NEON 1
+#endif
+
+namespace agrobus::nmea {
+    using namespace agrobus::net;
+
+    // ─── WGS84 ellipsoid ────────────────────────────────────────────────────────
+    inline constexpr f64 WGS84_A = 6378137.0;
+    inline constexpr f64 WGS84_F = 1.0 / 298.257223563;
+    inline constexpr f64 WGS84_E2 = WGS84_F * (2.0 - WGS84_F);
+
+    // Points converted per pass; the scratch arrays live on the stack
+    inline constexpr usize GEO_KERNEL_CHUNK = 256;
+
+    // ─── Local tangent frame ────────────────────────────────────────────────────
+    // Origin in ECEF and the rotation into east/north/up, computed once per
+    // reference point instead of once per converted position.
+    struct LocalFrame {
+        f64 x0 = 0.0, y0 = 0.0, z0 = 0.0;
+        f64 sin_lat = 0.0, cos_lat = 1.0, sin_lon = 0.0, cos_lon = 1.0;
+
+        static LocalFrame at(f64 lat_deg, f64 lon_deg, f64 alt_m) noexcept {
+            LocalFrame f;
+            f64 lat = lat_deg * M_PI / 180.0;
+            f64 lon = lon_deg * M_PI / 180.0;
+            f.sin_lat = std::sin(lat);
+            f.cos_lat = std::cos(lat);
+            f.sin_lon = std::sin(lon);
+            f.cos_lon = std::cos(lon);
+            f64 n = WGS84_A / std::sqrt(1.0 - WGS84_E2 * f.sin_lat * f.sin_lat);
+            f.x0 = (n + alt_m) * f.cos_lat * f.cos_lon;
+            f.y0 = (n + alt_m) * f.cos_lat * f.sin_lon;
+            f.z0 = (n * (1.0 - WGS84_E2) + alt_m) * f.sin_lat;
+            return f;
+        }
+
+        static LocalFrame at(const dp::Geo &ref) noexcept { return at(ref.latitude, ref.longitude, ref.altitude); }
+    };
+
+    namespace geo_detail {
+        // ECEF from per-point sines and cosines: the part left once the trig is done
+        inline void ecef_from_trig(const f64 *slat, const f64 *clat, const f64 *slon, const f64 *clon, const f64 *alt,
+                                   usize n, f64 *x, f64 *y, f64 *z) noexcept {
+            usize i = 0;
+#if defined(AGROBUS_GEO_AVX2)
+            const __m256d one = _mm256_set1_pd(1.0);
+            const __m256d a = _mm256_set1_pd(WGS84_A);
+            const __m256d e2 = _mm256_set1_pd(WGS84_E2);
+            const __m256d polar = _mm256_set1_pd(1.0 - WGS84_E2);
+            for (; i + 4 <= n; i += 4) {
+                __m256d s = _mm256_loadu_pd(slat + i);
+                __m256d h = _mm256_loadu_pd(alt + i);
+                __m256d rn = _mm256_div_pd(a, _mm256_sqrt_pd(_mm256_fnmadd_pd(e2, _mm256_mul_pd(s, s), one)));
+                __m256d r = _mm256_mul_pd(_mm256_add_pd(rn, h), _mm256_loadu_pd(clat + i));
+                _mm256_storeu_pd(x + i, _mm256_mul_pd(r, _mm256_loadu_pd(clon + i)));
+                _mm256_storeu_pd(y + i, _mm256_mul_pd(r, _mm256_loadu_pd(slon + i)));
+                _mm256_storeu_pd(z + i, _mm256_mul_pd(_mm256_fmadd_pd(rn, polar, h), s));
+            }
+#elif defined(AGROBUS_GEO_NEON)
+            const float64x2_t one = vdupq_n_f64(1.0);
+            const float64x2_t a = vdupq_n_f64(WGS84_A);
+            const float64x2_t e2 = vdupq_n_f64(WGS84_E2);
+            const float64x2_t polar = vdupq_n_f64(1.0 - WGS84_E2);
+            for (; i + 2 <= n; i += 2) {
+                float64x2_t s = vld1q_f64(slat + i);
+                float64x2_t h = vld1q_f64(alt + i);
+                float64x2_t rn = vdivq_f64(a, vsqrtq_f64(vfmsq_f64(one, e2, vmulq_f64(s, s))));
+                float64x2_t r = vmulq_f64(vaddq_f64(rn, h), vld1q_f64(clat + i));
+                vst1q_f64(x + i, vmulq_f64(r, vld1q_f64(clon + i)));
+                vst1q_f64(y + i, vmulq_f64(r, vld1q_f64(slon + i)));
+                vst1q_f64(z + i, vmulq_f64(vfmaq_f64(h, rn, polar), s));
+            }
+#endif
+            for (; i < n; ++i) {
+                f64 rn = WGS84_A / std::sqrt(1.0 - WGS84_E2 * slat[i] * slat[i]);
+                f64 r = (rn + alt[i]) * clat[i];
+                x[i] = r * clon[i];
+                y[i] = r * slon[i];
+                z[i] = (rn * (1.0 - WGS84_E2) + alt[i]) * slat[i];
+            }
+        }
+
+        // Translate to the frame origin and rotate into east/north/up
+        inline void rotate_enu(const LocalFrame &f, const f64 *x, const f64 *y, const f64 *z, usize n, f64 *east,
+                               f64 *north, f64 *up) noexcept {
+            const f64 ne_x = -f.sin_lat * f.cos_lon, ne_y = -f.sin_lat * f.sin_lon;
+            const f64 nu_x = f.cos_lat * f.cos_lon, nu_y = f.cos_lat * f.sin_lon;
+            usize i = 0;
+#if defined(AGROBUS_GEO_AVX2)
+            const __m256d x0 = _mm256_set1_pd(f.x0), y0 = _mm256_set1_pd(f.y0), z0 = _mm256_set1_pd(f.z0);
+            const __m256d ex = _mm256_set1_pd(-f.sin_lon), ey = _mm256_set1_pd(f.cos_lon);
+            const __m256d nx = _mm256_set1_pd(ne_x), ny = _mm256_set1_pd(ne_y), nz = _mm256_set1_pd(f.cos_lat);
+            const __m256d ux = _mm256_set1_pd(nu_x), uy = _mm256_set1_pd(nu_y), uz = _mm256_set1_pd(f.sin_lat);
+            for (; i + 4 <= n; i += 4) {
+                __m256d dx = _mm256_sub_pd(_mm256_loadu_pd(x + i), x0);
+                __m256d dy = _mm256_sub_pd(_mm256_loadu_pd(y + i), y0);
+                __m256d dz = _mm256_sub_pd(_mm256_loadu_pd(z + i), z0);
+                _mm256_storeu_pd(east + i, _mm256_fmadd_pd(ex, dx, _mm256_mul_pd(ey, dy)));
+                _mm256_storeu_pd(north + i, _mm256_fmadd_pd(nx, dx, _mm256_fmadd_pd(ny, dy, _mm256_mul_pd(nz, dz))));
+                _mm256_storeu_pd(up + i, _mm256_fmadd_pd(ux, dx, _mm256_fmadd_pd(uy, dy, _mm256_mul_pd(uz, dz))));
+            }
+#elif defined(AGROBUS_GEO_NEON)
+            const float64x2_t x0 = vdupq_n_f64(f.x0), y0 = vdupq_n_f64(f.y0), z0 = vdupq_n_f64(f.z0);
+            for (; i + 2 <= n; i += 2) {
+                float64x2_t dx = vsubq_f64(vld1q_f64(x + i), x0);
+                float64x2_t dy = vsubq_f64(vld1q_f64(y + i), y0);
+                float64x2_t dz = vsubq_f64(vld1q_f64(z + i), z0);
+                vst1q_f64(east + i, vfmaq_n_f64(vmulq_n_f64(dy, f.cos_lon), dx, -f.sin_lon));
+                vst1q_f64(north + i,
+                          vfmaq_n_f64(vfmaq_n_f64(vmulq_n_f64(dz, f.cos_lat), dy, ne_y), dx, ne_x));
+                vst1q_f64(up + i, vfmaq_n_f64(vfmaq_n_f64(vmulq_n_f64(dz, f.sin_lat), dy, nu_y), dx, nu_x));
+            }
+#endif
+            for (; i < n; ++i) {
+                f64 dx = x[i] - f.x0, dy = y[i] - f.y0, dz = z[i] - f.z0;
+                east[i] = -f.sin_lon * dx + f.cos_lon * dy;
+                north[i] = ne_x * dx + ne_y * dy + f.cos_lat * dz;
+                up[i] = nu_x * dx + nu_y * dy + f.sin_lat * dz;
+            }
+        }
+
+        // Slices of at least 16 chunks: below that a thread costs more than it saves
+        template <typename Fn> void parallel_ranges(usize n, u32 threads, Fn &&fn) {
+            net::parallel_ranges(n, threads, 16 * GEO_KERNEL_CHUNK, std::forward<Fn>(fn));
+        }
+    } // namespace geo_detail
+
+    // ─── Batch kernels ──────────────────────────────────────────────────────────
+    // Structure-of-arrays in, caller-supplied arrays out, nothing allocated.
+    // The trigonometry per point is scalar; everything after it runs four
+    // points per instruction with AVX2/FMA (two with NEON) unless the build
+    // sets AGROBUS_SIMD_DISABLED.
+
+    // Geodetic degrees/metres to ECEF metres
+    inline void wgs_to_ecef(const f64 *lat_deg, const f64 *lon_deg, const f64 *alt_m, usize n, f64 *x, f64 *y,
+                            f64 *z) noexcept {
+        std::array<f64, GEO_KERNEL_CHUNK> slat, clat, slon, clon;
+        for (usize base = 0; base < n; base += GEO_KERNEL_CHUNK) {
+            usize m = n - base < GEO_KERNEL_CHUNK ? n - base : GEO_KERNEL_CHUNK;
+            for (usize i = 0; i < m; ++i) {
+                f64 lat = lat_deg[base + i] * M_PI / 180.0;
+                f64 lon = lon_deg[base + i] * M_PI / 180.0;
+                slat[i] = std::sin(lat);
+                clat[i] = std::cos(lat);
+                slon[i] = std::sin(lon);
+                clon[i] = std::cos(lon);
+            }
+            geo_detail::ecef_from_trig(slat.data(), clat.data(), slon.data(), clon.data(), alt_m + base, m, x + base,
+                                       y + base, z + base);
+        }
+    }
+
+    // ECEF metres to east/north/up metres in `frame`
+    inline void ecef_to_enu(const LocalFrame &frame, const f64 *x, const f64 *y, const f64 *z, usize n, f64 *east,
+                            f64 *north, f64 *up) noexcept {
+        geo_detail::rotate_enu(frame, x, y, z, n, east, north, up);
+    }
+
+    // Geodetic to east/north/up, one chunk at a time through stack scratch
+    inline void wgs_to_enu(const LocalFrame &frame, const f64 *lat_deg, const f64 *lon_deg, const f64 *alt_m, usize n,
+                           f64 *east, f64 *north, f64 *up) noexcept {
+        std::array<f64, GEO_KERNEL_CHUNK> x, y, z;
+        for (usize base = 0; base < n; base += GEO_KERNEL_CHUNK) {
+            usize m = n - base < GEO_KERNEL_CHUNK ? n - base : GEO_KERNEL_CHUNK;
+            wgs_to_ecef(lat_deg + base, lon_deg + base, alt_m + base, m, x.data(), y.data(), z.data());
+            geo_detail::rotate_enu(frame, x.data(), y.data(), z.data(), m, east + base, north + base, up + base);
+        }
+    }
+
+    // Same, split across `threads` (0 = one per core) for long logs
+    inline void wgs_to_enu(const LocalFrame &frame, const f64 *lat_deg, const f64 *lon_deg, const f64 *alt_m, usize n,
+                           f64 *east, f64 *north, f64 *up, u32 threads) {
+        geo_detail::parallel_ranges(n, threads, [&](usize begin, usize end) {
+            wgs_to_enu(frame, lat_deg + begin, lon_deg + begin, alt_m + begin, end - begin, east + begin,
+                       north + begin, up + begin);
+        });
+    }
+
+} // namespace agrobus::nmea
@@ -0,0 +1,225 @@
+#pragma once
+
+#include "definitions.hpp"
+#include "position.hpp"
+#include <agrobus/net/types.hpp>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <datapod/datapod.hpp>
+
+namespace agrobus::nmea {
+    using namespace agrobus::net;
+
+    // ─── Binary GNSS protocols ──────────────────────────────────────────────────
+    // Receivers mix binary frames into the NMEA stream on the same port. Every
+    // sync byte below has its high bit set, which NMEA-0183 text never does.
+    enum class GNSSBinaryProtocol : u8 { UBX, RTCM3 };
+
+    inline constexpr u8 UBX_SYNC_1 = 0xB5;
+    inline constexpr u8 UBX_SYNC_2 = 0x62;
+    inline constexpr u8 UBX_CLASS_NAV = 0x01;
+    inline constexpr u8 UBX_NAV_DOP = 0x04;
+    inline constexpr u8 UBX_NAV_PVT = 0x07;
+    inline constexpr usize UBX_NAV_PVT_LENGTH = 92;
+    inline constexpr usize UBX_NAV_DOP_LENGTH = 18;
+    inline constexpr u8 RTCM3_PREAMBLE = 0xD3;
+
+    // The largest RTCM3 frame: 3-byte header, 1023-byte message, 24-bit CRC
+    inline constexpr usize GNSS_BINARY_MAX_FRAME = 3 + 1023 + 3;
+
+    namespace binary_detail {
+        template <typename T> inline T get_le(const u8 *p) noexcept {
+            using U = std::make_unsigned_t<T>;
+            U v = 0;
+            for (usize i = 0; i < sizeof(T); ++i)
+                v |= static_cast<U>(static_cast<U>(p[i]) << (8 * i));
+            return static_cast<T>(v);
+        }
+
+        inline constexpr std::array<u32, 256> CRC24Q_TABLE = [] {
+            std::array<u32, 256> table{};
+            for (u32 i = 0; i < 256; ++i) {
+                u32 crc = i << 16;
+                for (u32 bit = 0; bit < 8; ++bit)
+                    crc = (crc & 0x800000) ? ((crc << 1) ^ 0x864CFB) : (crc << 1);
+                table[i] = crc & 0xFFFFFF;
+            }
+            return table;
+        }();
+    } // namespace binary_detail
+
+    // 8-bit Fletcher over class, id, length and payload
+    inline u16 ubx_checksum(const u8 *data, usize size) noexcept {
+        u8 a = 0, b = 0;
+        for (usize i = 0; i < size; ++i) {
+            a = static_cast<u8>(a + data[i]);
+            b = static_cast<u8>(b + a);
+        }
+        return static_cast<u16>(a | (b << 8));
+    }
+
+    inline u32 crc24q(const u8 *data, usize size) noexcept {
+        u32 crc = 0;
+        for (usize i = 0; i < size; ++i)
+            crc = ((crc << 8) & 0xFFFFFF) ^ binary_detail::CRC24Q_TABLE[((crc >> 16) ^ data[i]) & 0xFF];
+        return crc;
+    }
+
+    // ─── UBX decoders ───────────────────────────────────────────────────────────
+    // UBX-NAV-PVT: the complete navigation solution in one message
+    inline bool decode_ubx_nav_pvt(const u8 *payload, usize size, GNSSPosition &pos) noexcept {
+        using binary_detail::get_le;
+        if (size < UBX_NAV_PVT_LENGTH)
+            return false;
+
+        u8 fix = payload[20];
+        u8 flags = payload[21];
+        bool fix_ok = (flags & 0x01) != 0;
+        u8 carrier = static_cast<u8>((flags >> 6) & 0x03);
+        if (!fix_ok || fix == 0 || fix == 5) { // No fix, or time only
+            pos.fix_type = GNSSFixType::NoFix;
+            return true;
+        }
+        if (carrier == 2)
+            pos.fix_type = GNSSFixType::RTKFixed;
+        else if (carrier == 1)
+            pos.fix_type = GNSSFixType::RTKFloat;
+        else if (flags & 0x02)
+            pos.fix_type = GNSSFixType::DGNSSFix;
+        else if (fix == 1)
+            pos.fix_type = GNSSFixType::DeadReckon;
+        else
+            pos.fix_type = GNSSFixType::GNSSFix;
+
+        f64 lon = get_le<i32>(payload + 24) * 1e-7;
+        f64 lat = get_le<i32>(payload + 28) * 1e-7;
+        f64 height = get_le<i32>(payload + 32) * 1e-3; // Above the ellipsoid
+        f64 msl = get_le<i32>(payload + 36) * 1e-3;
+        pos.wgs = concord::earth::WGS(lat, lon, msl);
+        pos.geoidal_separation_m = height - msl;
+        pos.satellites_used = payload[23];
+
+        pos.speed_mps = get_le<i32>(payload + 60) * 1e-3;
+        pos.cog_rad = get_le<i32>(payload + 64) * 1e-5 * M_PI / 180.0;
+        if (flags & 0x20) // Vehicle heading valid
+            pos.heading_rad = get_le<i32>(payload + 84) * 1e-5 * M_PI / 180.0;
+        pos.pdop = get_le<u16>(payload + 76) * 0.01;
+        return true;
+    }
+
+    // UBX-NAV-DOP: dilution of precision
+    inline bool decode_ubx_nav_dop(const u8 *payload, usize size, GNSSPosition &pos) noexcept {
+        using binary_detail::get_le;
+        if (size < UBX_NAV_DOP_LENGTH)
+            return false;
+        pos.pdop = get_le<u16>(payload + 6) * 0.01;
+        pos.vdop = get_le<u16>(payload + 10) * 0.01;
+        pos.hdop = get_le<u16>(payload + 12) * 0.01;
+        return true;
+    }
+
+    // ─── Binary frame reader ────────────────────────────────────────────────────
+    // Frames UBX and RTCM3 out of a byte stream into a fixed buffer. feed()
+    // consumes bytes up to the end of the current frame and returns how many it
+    // took, so the caller can hand the text that follows back to the NMEA
+    // reader. A false sync is given back unconsumed; frames too long for the
+    // buffer (large raw-measurement UBX messages) are counted and skipped.
+    class GNSSBinaryReader {
+        dp::Array<u8, GNSS_BINARY_MAX_FRAME> frame_{};
+        usize len_ = 0;
+        usize need_ = 0; // Header length until the header is in, then the frame length
+        bool header_done_ = false;
+        GNSSBinaryProtocol protocol_ = GNSSBinaryProtocol::UBX;
+        u32 frames_ = 0;
+        u32 checksum_errors_ = 0;
+        u32 oversized_ = 0;
+
+      public:
+        static bool is_sync(u8 b) noexcept { return b == UBX_SYNC_1 || b == RTCM3_PREAMBLE; }
+
+        // A frame has started and needs more bytes
+        bool active() const noexcept { return len_ > 0; }
+
+        // `on_frame(protocol, frame, size)` sees the whole frame, sync to checksum
+        template <typename Fn> usize feed(const u8 *data, usize size, Fn &&on_frame) {
+            usize i = 0;
+            while (i < size) {
+                if (len_ == 0) {
+                    if (!is_sync(data[i]))
+                        return i;
+                    protocol_ = data[i] == UBX_SYNC_1 ? GNSSBinaryProtocol::UBX : GNSSBinaryProtocol::RTCM3;
+                    need_ = protocol_ == GNSSBinaryProtocol::UBX ? 6 : 3;
+                    header_done_ = false;
+                    frame_[len_++] = data[i++];
+                    continue;
+                }
+                if (len_ == 1 && !second_byte_ok(data[i])) {
+                    len_ = 0;
+                    return i;
+                }
+
+                usize take = need_ - len_ < size - i ? need_ - len_ : size - i;
+                std::memcpy(frame_.data() + len_, data + i, take);
+                len_ += take;
+                i += take;
+                if (len_ < need_)
+                    return i;
+
+                if (!header_done_) {
+                    header_done_ = true;
+                    need_ = frame_length();
+                    if (need_ > frame_.size()) {
+                        ++oversized_;
+                        len_ = 0;
+                        return i;
+                    }
+                    continue;
+                }
+                finish(on_frame);
+                return i;
+            }
+            return i;
+        }
+
+        void reset() noexcept { len_ = 0; }
+
+        u32 frames() const noexcept { return frames_; }
+        u32 checksum_errors() const noexcept { return checksum_errors_; }
+        u32 oversized() const noexcept { return oversized_; }
+
+      private:
+        bool second_byte_ok(u8 b) const noexcept {
+            if (protocol_ == GNSSBinaryProtocol::UBX)
+                return b == UBX_SYNC_2;
+            return (b & 0xFC) == 0; // Six reserved bits ahead of the length
+        }
+
+        usize frame_length() const noexcept {
+            if (protocol_ == GNSSBinaryProtocol::UBX)
+                return 6 + binary_detail::get_le<u16>(frame_.data() + 4) + 2;
+            return 3 + (static_cast<usize>(frame_[1] & 0x03) << 8 | frame_[2]) + 3;
+        }
+
+        template <typename Fn> void finish(Fn &on_frame) {
+            usize size = len_;
+            len_ = 0;
+            bool valid = false;
+            if (protocol_ == GNSSBinaryProtocol::UBX) {
+                u16 sum = binary_detail::get_le<u16>(frame_.data() + size - 2);
+                valid = ubx_checksum(frame_.data() + 2, size - 4) == sum;
+            } else {
+                u32 crc = static_cast<u32>(frame_[size - 3]) << 16 | static_cast<u32>(frame_[size - 2]) << 8 |
+                          frame_[size - 1];
+                valid = crc24q(frame_.data(), size - 3) == crc;
+            }
+            if (!valid) {
+                ++checksum_errors_;
+                return;
+            }
+            ++frames_;
+            on_frame(protocol_, static_cast<const u8 *>(frame_.data()), size);
+        }
+    };
+
+} // namespace agrobus::nmea
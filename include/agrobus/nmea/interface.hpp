@@ -1,12 +1,16 @@
 #pragma once
 
 #include "definitions.hpp"
+#include "n2k_decode.hpp"
+#include "n2k_template.hpp"
 #include "position.hpp"
+#include "position_fusion.hpp"
 #include <agrobus/net/constants.hpp>
 #include <agrobus/net/event.hpp>
 #include <agrobus/net/fast_packet.hpp>
 #include <agrobus/net/message.hpp>
 #include <agrobus/net/network_manager.hpp>
+#include <agrobus/net/snapshot.hpp>
 #include <datapod/datapod.hpp>
 #include <echo/echo.hpp>
 
@@ -36,6 +40,7 @@ namespace agrobus::nmea {
         bool listen_rudder = false;
         bool listen_system_time = false;
         bool listen_heading = false;
+        PositionFusionConfig fusion_config;
 
         NMEAConfig &rapid_position(bool enable) {
             listen_rapid_position = enable;
@@ -121,6 +126,10 @@ namespace agrobus::nmea {
             listen_heading = enable;
             return *this;
         }
+        NMEAConfig &fusion(PositionFusionConfig config) {
+            fusion_config = config;
+            return *this;
+        }
         NMEAConfig &all(bool enable = true) {
             listen_rapid_position = listen_cog_sog = listen_attitude = listen_rate_of_turn = listen_position_detail =
                 listen_gnss_dops = listen_magnetic_variation = listen_wind = listen_temperature = listen_humidity =
@@ -136,84 +145,36 @@ namespace agrobus::nmea {
         IsoNet &net_;
         InternalCF *cf_;
         NMEAConfig config_;
-        FastPacketProtocol fast_packet_;
         dp::Optional<GNSSPosition> latest_position_;
+        Snapshot<GNSSPosition> position_snapshot_;
+        PositionFusion fusion_;
+
+        // Pre-encoded GNSS output, rewritten field by field (see publish_gnss)
+        struct GNSSTemplates {
+            N2KSendTemplate position_data{PGN_GNSS_POSITION_DATA, 43};
+            N2KSendTemplate position_rapid{PGN_GNSS_POSITION_RAPID, 8};
+            N2KSendTemplate cog_sog{PGN_GNSS_COG_SOG_RAPID, 8};
+            N2KSendTemplate heading{PGN_HEADING_TRACK, 8};
+            N2KSendTemplate dops{PGN_GNSS_DOPs, 8};
+        } gnss_tx_;
+        dp::Array<Frame, n2k_frame_count(43) + 4> tx_frames_{};
 
       public:
-        NMEAInterface(IsoNet &net, InternalCF *cf, NMEAConfig config = {}) : net_(net), cf_(cf), config_(config) {}
+        NMEAInterface(IsoNet &net, InternalCF *cf, NMEAConfig config = {})
+            : net_(net), cf_(cf), config_(config), fusion_(config.fusion_config) {}
 
         Result<void> initialize() {
             if (!cf_) {
                 return Result<void>::err(Error::invalid_state("control function not set"));
             }
-            // Single-frame PGNs (8 bytes)
-            if (config_.listen_rapid_position) {
-                net_.register_pgn_callback(PGN_GNSS_POSITION_RAPID,
-                                           [this](const Message &msg) { handle_position_rapid(msg); });
-            }
-            if (config_.listen_cog_sog) {
-                net_.register_pgn_callback(PGN_GNSS_COG_SOG_RAPID, [this](const Message &msg) { handle_cog_sog(msg); });
-            }
-            if (config_.listen_attitude) {
-                net_.register_pgn_callback(PGN_ATTITUDE, [this](const Message &msg) { handle_attitude(msg); });
-            }
-            if (config_.listen_rate_of_turn) {
-                net_.register_pgn_callback(PGN_RATE_OF_TURN, [this](const Message &msg) { handle_rate_of_turn(msg); });
-            }
-            // Fast Packet PGNs (>8 bytes, reassembled by transport)
-            if (config_.listen_position_detail) {
-                net_.register_pgn_callback(PGN_GNSS_POSITION_DATA,
-                                           [this](const Message &msg) { handle_position_detail(msg); });
-            }
-            if (config_.listen_wind) {
-                net_.register_pgn_callback(PGN_WIND_DATA, [this](const Message &msg) { handle_wind(msg); });
-            }
-            if (config_.listen_temperature) {
-                net_.register_pgn_callback(PGN_TEMPERATURE, [this](const Message &msg) { handle_temperature(msg); });
-            }
-            if (config_.listen_engine) {
-                net_.register_pgn_callback(PGN_ENGINE_PARAMS_RAPID, [this](const Message &msg) { handle_engine(msg); });
-            }
-            if (config_.listen_depth) {
-                net_.register_pgn_callback(PGN_WATER_DEPTH, [this](const Message &msg) { handle_depth(msg); });
-            }
-            if (config_.listen_system_time) {
-                net_.register_pgn_callback(PGN_SYSTEM_TIME, [this](const Message &msg) { handle_system_time(msg); });
-            }
-            if (config_.listen_heading) {
-                net_.register_pgn_callback(PGN_HEADING_TRACK, [this](const Message &msg) { handle_heading(msg); });
-            }
-            if (config_.listen_gnss_dops) {
-                net_.register_pgn_callback(PGN_GNSS_DOPs, [this](const Message &msg) { handle_gnss_dops(msg); });
-            }
-            if (config_.listen_magnetic_variation) {
-                net_.register_pgn_callback(PGN_MAGNETIC_VARIATION,
-                                           [this](const Message &msg) { handle_magnetic_variation(msg); });
-            }
-            if (config_.listen_humidity) {
-                net_.register_pgn_callback(PGN_HUMIDITY, [this](const Message &msg) { handle_humidity(msg); });
-            }
-            if (config_.listen_pressure) {
-                net_.register_pgn_callback(PGN_PRESSURE, [this](const Message &msg) { handle_pressure(msg); });
-            }
-            if (config_.listen_outside_environmental) {
-                net_.register_pgn_callback(PGN_OUTSIDE_ENVIRONMENTAL,
-                                           [this](const Message &msg) { handle_outside_environmental(msg); });
-            }
-            if (config_.listen_fluid_level) {
-                net_.register_pgn_callback(PGN_FLUID_LEVEL, [this](const Message &msg) { handle_fluid_level(msg); });
-            }
-            if (config_.listen_battery) {
-                net_.register_pgn_callback(PGN_BATTERY_STATUS, [this](const Message &msg) { handle_battery(msg); });
-            }
-            if (config_.listen_speed_water) {
-                net_.register_pgn_callback(PGN_SPEED_WATER, [this](const Message &msg) { handle_speed_water(msg); });
-            }
-            if (config_.listen_xte) {
-                net_.register_pgn_callback(PGN_XTE, [this](const Message &msg) { handle_xte(msg); });
-            }
-            if (config_.listen_rudder) {
-                net_.register_pgn_callback(PGN_RUDDER, [this](const Message &msg) { handle_rudder(msg); });
+            for (const auto &route : routes()) {
+                if (!(config_.*route.enabled))
+                    continue;
+                // Fast packet PGNs are reassembled once by IsoNet's shared service
+                if (route.fast_packet)
+                    net_.register_fast_packet_pgn(route.pgn);
+                auto handler = route.handler;
+                net_.register_pgn_callback(route.pgn, [this, handler](const Message &msg) { (this->*handler)(msg); });
             }
             echo::category("isobus.nmea").debug("initialized");
             return {};
@@ -221,40 +182,60 @@ namespace agrobus::nmea {
 
         dp::Optional<GNSSPosition> latest_position() const noexcept { return latest_position_; }
 
+        // Latest merged position for readers on other threads; version() == 0
+        // until the first position was received
+        const Snapshot<GNSSPosition> &position_snapshot() const noexcept { return position_snapshot_; }
+
+        // Position at a receive-clock time, interpolated between fixes or
+        // extrapolated from the newest one with the latest motion
+        dp::Optional<GNSSPosition> position_at(u64 t_us) const { return fusion_.position_at(t_us); }
+        const PositionFusion &fusion() const noexcept { return fusion_; }
+
         // Send position (if we are a GNSS source)
         Result<void> send_position(const GNSSPosition &pos) {
             echo::category("isobus.nmea").debug("sending position");
-            // PGN 129025 - Position Rapid Update (8 bytes, single frame)
-            dp::Vector<u8> data(8, 0xFF);
-            i32 lat_raw = static_cast<i32>(pos.wgs.latitude / LAT_LON_RESOLUTION);
-            i32 lon_raw = static_cast<i32>(pos.wgs.longitude / LAT_LON_RESOLUTION);
-            data[0] = static_cast<u8>(lat_raw & 0xFF);
-            data[1] = static_cast<u8>((lat_raw >> 8) & 0xFF);
-            data[2] = static_cast<u8>((lat_raw >> 16) & 0xFF);
-            data[3] = static_cast<u8>((lat_raw >> 24) & 0xFF);
-            data[4] = static_cast<u8>(lon_raw & 0xFF);
-            data[5] = static_cast<u8>((lon_raw >> 8) & 0xFF);
-            data[6] = static_cast<u8>((lon_raw >> 16) & 0xFF);
-            data[7] = static_cast<u8>((lon_raw >> 24) & 0xFF);
-            return net_.send(PGN_GNSS_POSITION_RAPID, data, cf_);
+            encode_position_rapid(pos);
+            return send_templates({&gnss_tx_.position_rapid});
         }
 
         Result<void> send_cog_sog(f64 cog_rad, f64 sog_mps) {
             echo::category("isobus.nmea").debug("sending cog/sog");
-            dp::Vector<u8> data(8, 0xFF);
-            // SID
-            data[0] = 0xFF;
-            // COG reference (true = 0)
-            data[1] = 0x00;
-            // COG
-            u16 cog_raw = static_cast<u16>(cog_rad / COG_RESOLUTION);
-            data[2] = static_cast<u8>(cog_raw & 0xFF);
-            data[3] = static_cast<u8>((cog_raw >> 8) & 0xFF);
-            // SOG
-            u16 sog_raw = static_cast<u16>(sog_mps / SPEED_RESOLUTION);
-            data[4] = static_cast<u8>(sog_raw & 0xFF);
-            data[5] = static_cast<u8>((sog_raw >> 8) & 0xFF);
-            return net_.send(PGN_GNSS_COG_SOG_RAPID, data, cf_);
+            encode_cog_sog(cog_rad, sog_mps);
+            return send_templates({&gnss_tx_.cog_sog});
+        }
+
+        // ─── GNSS publishing ──────────────────────────────────────────────────────
+        // One tick of a GNSS source: 129029, 129025, 129026, 127250 (with a
+        // heading) and 129539 (with a DOP) from `pos`, all queued as a single
+        // TX batch. 129029 goes out as fast packet whether or not it is
+        // registered on this network.
+        Result<void> publish_gnss(const GNSSPosition &pos, u8 sid = 0xFF) {
+            N2KSendTemplate *batch[5];
+            usize n = 0;
+            encode_position_data(pos, sid);
+            batch[n++] = &gnss_tx_.position_data;
+            encode_position_rapid(pos);
+            batch[n++] = &gnss_tx_.position_rapid;
+            if (pos.cog_rad || pos.speed_mps) {
+                encode_cog_sog(pos.cog_rad, pos.speed_mps, sid);
+                batch[n++] = &gnss_tx_.cog_sog;
+            }
+            if (pos.heading_rad) {
+                encode_heading(*pos.heading_rad, 0.0, 0.0, sid);
+                batch[n++] = &gnss_tx_.heading;
+            }
+            if (pos.hdop || pos.vdop) {
+                auto &dops = gnss_tx_.dops;
+                GNSSDOPMode actual = pos.vdop ? GNSSDOPMode::Mode3D : GNSSDOPMode::Mode2D;
+                dops.set<u8>(0, sid);
+                dops.set<u8>(1, static_cast<u8>(0xC0 | (static_cast<u8>(actual) << 3) |
+                                                static_cast<u8>(GNSSDOPMode::Auto)));
+                dops.set_scaled<i16>(2, pos.hdop, DOP_RESOLUTION);
+                dops.set_scaled<i16>(4, pos.vdop, DOP_RESOLUTION);
+                dops.set<i16>(6, 0x7FFF); // TDOP
+                batch[n++] = &gnss_tx_.dops;
+            }
+            return send_templates(batch, n);
         }
 
         // ─── Additional send methods ──────────────────────────────────────────────
@@ -310,19 +291,8 @@ namespace agrobus::nmea {
         }
 
         Result<void> send_heading(f64 heading_rad, f64 deviation_rad = 0.0, f64 variation_rad = 0.0) {
-            dp::Vector<u8> data(8, 0xFF);
-            data[0] = 0xFF; // SID
-            u16 heading_raw = static_cast<u16>(heading_rad / HEADING_RESOLUTION);
-            data[1] = static_cast<u8>(heading_raw & 0xFF);
-            data[2] = static_cast<u8>((heading_raw >> 8) & 0xFF);
-            i16 dev_raw = static_cast<i16>(deviation_rad / HEADING_RESOLUTION);
-            data[3] = static_cast<u8>(static_cast<u16>(dev_raw) & 0xFF);
-            data[4] = static_cast<u8>((static_cast<u16>(dev_raw) >> 8) & 0xFF);
-            i16 var_raw = static_cast<i16>(variation_rad / HEADING_RESOLUTION);
-            data[5] = static_cast<u8>(static_cast<u16>(var_raw) & 0xFF);
-            data[6] = static_cast<u8>((static_cast<u16>(var_raw) >> 8) & 0xFF);
-            data[7] = 0x00; // Reference: magnetic
-            return net_.send(PGN_HEADING_TRACK, data, cf_);
+            encode_heading(heading_rad, deviation_rad, variation_rad);
+            return send_templates({&gnss_tx_.heading});
         }
 
         Result<void> send_system_time(const SystemTimeData &time) {
@@ -472,6 +442,124 @@ namespace agrobus::nmea {
         Event<const OutsideEnvironmentalData &> on_outside_environmental;
 
       private:
+        // ─── Dispatch table ───────────────────────────────────────────────────────
+        // One row per listen_* flag. Messages with a fixed layout decode through
+        // N2KLayout straight into their struct; the ones that merge into the
+        // cached position keep a handler of their own.
+        struct Route {
+            bool NMEAConfig::*enabled;
+            PGN pgn;
+            void (NMEAInterface::*handler)(const Message &);
+            bool fast_packet = false;
+        };
+
+        static const dp::Array<Route, 21> &routes() {
+            static const dp::Array<Route, 21> table = {{
+                {&NMEAConfig::listen_rapid_position, PGN_GNSS_POSITION_RAPID, &NMEAInterface::handle_position_rapid},
+                {&NMEAConfig::listen_cog_sog, PGN_GNSS_COG_SOG_RAPID, &NMEAInterface::handle_cog_sog},
+                {&NMEAConfig::listen_attitude, PGN_ATTITUDE, &NMEAInterface::handle_attitude},
+                {&NMEAConfig::listen_rate_of_turn, PGN_RATE_OF_TURN, &NMEAInterface::handle_rate_of_turn},
+                {&NMEAConfig::listen_position_detail, PGN_GNSS_POSITION_DATA, &NMEAInterface::handle_position_detail,
+                 true},
+                {&NMEAConfig::listen_heading, PGN_HEADING_TRACK, &NMEAInterface::handle_heading},
+                {&NMEAConfig::listen_gnss_dops, PGN_GNSS_DOPs, &NMEAInterface::handle_gnss_dops},
+                {&NMEAConfig::listen_magnetic_variation, PGN_MAGNETIC_VARIATION,
+                 &NMEAInterface::handle_magnetic_variation},
+                decoded<WindData, &NMEAInterface::on_wind>(&NMEAConfig::listen_wind),
+                decoded<TemperatureData, &NMEAInterface::on_temperature>(&NMEAConfig::listen_temperature),
+                decoded<EngineData, &NMEAInterface::on_engine>(&NMEAConfig::listen_engine),
+                decoded<WaterDepthData, &NMEAInterface::on_depth>(&NMEAConfig::listen_depth),
+                decoded<SystemTimeData, &NMEAInterface::on_system_time>(&NMEAConfig::listen_system_time),
+                decoded<HumidityData, &NMEAInterface::on_humidity>(&NMEAConfig::listen_humidity),
+                decoded<PressureData, &NMEAInterface::on_pressure>(&NMEAConfig::listen_pressure),
+                decoded<OutsideEnvironmentalData, &NMEAInterface::on_outside_environmental>(
+                    &NMEAConfig::listen_outside_environmental),
+                decoded<FluidLevelData, &NMEAInterface::on_fluid_level>(&NMEAConfig::listen_fluid_level),
+                decoded<BatteryStatusData, &NMEAInterface::on_battery>(&NMEAConfig::listen_battery),
+                decoded<SpeedWaterData, &NMEAInterface::on_speed_water>(&NMEAConfig::listen_speed_water),
+                decoded<XTEData, &NMEAInterface::on_xte>(&NMEAConfig::listen_xte),
+                decoded<RudderData, &NMEAInterface::on_rudder>(&NMEAConfig::listen_rudder),
+            }};
+            return table;
+        }
+
+        template <typename T, Event<const T &> NMEAInterface::*E> static Route decoded(bool NMEAConfig::*enabled) {
+            return {enabled, N2KLayout<T>::pgn, &NMEAInterface::emit_decoded<T, E>};
+        }
+
+        template <typename T, Event<const T &> NMEAInterface::*E> void emit_decoded(const Message &msg) {
+            T out;
+            if (decode_n2k(msg.data, out))
+                (this->*E).emit(out);
+        }
+
+        // ─── GNSS template encoding ───────────────────────────────────────────────
+        void encode_position_rapid(const GNSSPosition &pos) {
+            gnss_tx_.position_rapid.set<i32>(0, static_cast<i32>(pos.wgs.latitude / LAT_LON_RESOLUTION));
+            gnss_tx_.position_rapid.set<i32>(4, static_cast<i32>(pos.wgs.longitude / LAT_LON_RESOLUTION));
+        }
+
+        void encode_cog_sog(const dp::Optional<f64> &cog_rad, const dp::Optional<f64> &sog_mps, u8 sid = 0xFF) {
+            auto &cog_sog = gnss_tx_.cog_sog;
+            cog_sog.set<u8>(0, sid);
+            cog_sog.set<u8>(1, 0xFC); // COG reference: true
+            cog_sog.set_scaled<u16>(2, cog_rad, COG_RESOLUTION);
+            cog_sog.set_scaled<u16>(4, sog_mps, SPEED_RESOLUTION);
+        }
+
+        void encode_heading(f64 heading_rad, f64 deviation_rad, f64 variation_rad, u8 sid = 0xFF) {
+            auto &heading = gnss_tx_.heading;
+            heading.set<u8>(0, sid);
+            heading.set<u16>(1, static_cast<u16>(heading_rad / HEADING_RESOLUTION));
+            heading.set<i16>(3, static_cast<i16>(deviation_rad / HEADING_RESOLUTION));
+            heading.set<i16>(5, static_cast<i16>(variation_rad / HEADING_RESOLUTION));
+            heading.set<u8>(7, 0x00); // Reference: magnetic
+        }
+
+        // PGN 129029 layout as read by handle_position_detail; date and time unavailable
+        void encode_position_data(const GNSSPosition &pos, u8 sid) {
+            auto &data = gnss_tx_.position_data;
+            data.set<u8>(0, sid);
+            data.set<i64>(7, static_cast<i64>(pos.wgs.latitude * 1e16));
+            data.set<i64>(15, static_cast<i64>(pos.wgs.longitude * 1e16));
+            if (pos.altitude_m)
+                data.set<i64>(23, static_cast<i64>(*pos.altitude_m * 1e6));
+            else
+                data.set<i64>(23, 0x7FFFFFFFFFFFFFFFLL);
+            data.set<u8>(31, static_cast<u8>((static_cast<u8>(pos.fix_type) << 4) |
+                                             (static_cast<u8>(pos.gnss_system) & 0x0F)));
+            data.set<u8>(32, 0xFC); // Integrity: no checking
+            data.set<u8>(33, pos.satellites_used);
+            data.set_scaled<i16>(34, pos.hdop, 0.01);
+            data.set_scaled<i16>(36, pos.pdop, 0.01);
+            data.set_scaled<i32>(38, pos.geoidal_separation_m, 0.01);
+            data.set<u8>(42, 0); // Reference stations
+        }
+
+        Result<void> send_templates(std::initializer_list<N2KSendTemplate *> templates) {
+            return send_templates(templates.begin(), templates.size());
+        }
+
+        // Stamp and stack the templates' frames, then hand them to IsoNet as one batch
+        Result<void> send_templates(N2KSendTemplate *const *templates, usize count) {
+            if (!cf_ || !cf_->cf().address_valid())
+                return Result<void>::err(Error::not_connected());
+            usize n = 0;
+            for (usize i = 0; i < count; ++i) {
+                N2KSendTemplate *tpl = templates[i];
+                u8 seq = tpl->fast_packet() ? net_.fast_packet_protocol().next_tx_sequence() : 0;
+                const Frame *frames = tpl->frames(cf_->address(), seq);
+                for (usize f = 0; f < tpl->frame_count() && n < tx_frames_.size(); ++f)
+                    tx_frames_[n++] = frames[f];
+            }
+            return net_.send_batch(tx_frames_.data(), n, cf_);
+        }
+
+        void publish_position() {
+            if (latest_position_)
+                position_snapshot_.publish(*latest_position_);
+        }
+
         void handle_position_rapid(const Message &msg) {
             if (msg.data.size() < 8)
                 return;
@@ -487,6 +575,7 @@ namespace agrobus::nmea {
                                           static_cast<f64>(lon_raw) * LAT_LON_RESOLUTION);
             pos.timestamp_us = msg.timestamp_us;
             pos.fix_type = GNSSFixType::GNSSFix; // Assume fix if we got data
+            fusion_.add_fix(pos);
 
             if (latest_position_) {
                 // Preserve fields not in this message
@@ -498,6 +587,7 @@ namespace agrobus::nmea {
             }
 
             latest_position_ = pos;
+            publish_position();
             on_position.emit(pos);
             echo::category("isobus.nmea").trace("Position: ", pos.wgs.latitude, ", ", pos.wgs.longitude);
         }
@@ -512,15 +602,18 @@ namespace agrobus::nmea {
             if (cog_raw != 0xFFFF) {
                 f64 cog = static_cast<f64>(cog_raw) * COG_RESOLUTION;
                 on_cog.emit(cog);
+                fusion_.add_course(cog, msg.timestamp_us);
                 if (latest_position_)
                     latest_position_->cog_rad = cog;
             }
             if (sog_raw != 0xFFFF) {
                 f64 sog = static_cast<f64>(sog_raw) * SPEED_RESOLUTION;
                 on_sog.emit(sog);
+                fusion_.add_speed(sog, msg.timestamp_us);
                 if (latest_position_)
                     latest_position_->speed_mps = sog;
             }
+            publish_position();
         }
 
         void handle_attitude(const Message &msg) {
@@ -534,12 +627,15 @@ namespace agrobus::nmea {
             f64 yaw = static_cast<f64>(yaw_raw) * HEADING_RESOLUTION;
             f64 pitch = static_cast<f64>(pitch_raw) * HEADING_RESOLUTION;
             f64 roll = static_cast<f64>(roll_raw) * HEADING_RESOLUTION;
+            if (yaw_raw != 0x7FFF)
+                fusion_.add_heading(yaw, msg.timestamp_us);
 
             if (latest_position_) {
                 latest_position_->heading_rad = yaw;
                 latest_position_->pitch_rad = pitch;
                 latest_position_->roll_rad = roll;
             }
+            publish_position();
 
             on_attitude.emit(yaw, pitch, roll);
         }
@@ -550,67 +646,11 @@ namespace agrobus::nmea {
             i32 rot_raw = static_cast<i32>(msg.get_u32_le(1));
             if (rot_raw != static_cast<i32>(0x7FFFFFFF)) {
                 f64 rot = static_cast<f64>(rot_raw) * ROT_RESOLUTION;
+                fusion_.add_yaw_rate(rot, msg.timestamp_us);
                 if (latest_position_)
                     latest_position_->rate_of_turn_rps = rot;
             }
-        }
-
-        void handle_wind(const Message &msg) {
-            if (msg.data.size() < 6)
-                return;
-            WindData wind;
-            wind.sid = msg.data[0];
-            u16 speed_raw = msg.get_u16_le(1);
-            u16 dir_raw = msg.get_u16_le(3);
-            wind.reference = static_cast<WindReference>(msg.data[5]);
-            if (speed_raw != 0xFFFF)
-                wind.speed_mps = static_cast<f64>(speed_raw) * WIND_SPEED_RESOLUTION;
-            if (dir_raw != 0xFFFF)
-                wind.direction_rad = static_cast<f64>(dir_raw) * WIND_DIR_RESOLUTION;
-            on_wind.emit(wind);
-            echo::category("isobus.nmea").trace("wind: ", wind.speed_mps, " m/s dir=", wind.direction_rad);
-        }
-
-        void handle_temperature(const Message &msg) {
-            if (msg.data.size() < 5)
-                return;
-            TemperatureData temp;
-            temp.sid = msg.data[0];
-            temp.instance = msg.data[1];
-            temp.source = static_cast<TemperatureSource>(msg.data[2]);
-            u16 temp_raw = msg.get_u16_le(3);
-            if (temp_raw != 0xFFFF)
-                temp.actual_k = static_cast<f64>(temp_raw) * TEMPERATURE_RESOLUTION;
-            on_temperature.emit(temp);
-        }
-
-        void handle_engine(const Message &msg) {
-            if (msg.data.size() < 6)
-                return;
-            EngineData engine;
-            engine.instance = msg.data[0];
-            u16 rpm_raw = msg.get_u16_le(1);
-            u16 boost_raw = msg.get_u16_le(3);
-            if (rpm_raw != 0xFFFF)
-                engine.rpm = static_cast<f64>(rpm_raw) * RPM_RESOLUTION;
-            if (boost_raw != 0xFFFF)
-                engine.boost_pressure_pa = static_cast<f64>(boost_raw) * PRESSURE_RESOLUTION;
-            engine.tilt_trim = static_cast<i8>(msg.data[5]);
-            on_engine.emit(engine);
-            echo::category("isobus.nmea").trace("engine: rpm=", engine.rpm);
-        }
-
-        void handle_depth(const Message &msg) {
-            if (msg.data.size() < 7)
-                return;
-            WaterDepthData depth;
-            depth.sid = msg.data[0];
-            u32 depth_raw = msg.get_u32_le(1);
-            i16 offset_raw = static_cast<i16>(msg.get_u16_le(5));
-            if (depth_raw != 0xFFFFFFFF)
-                depth.depth_m = static_cast<f64>(depth_raw) * DEPTH_RESOLUTION;
-            depth.offset_m = static_cast<f64>(offset_raw) * DEPTH_RESOLUTION;
-            on_depth.emit(depth);
+            publish_position();
         }
 
         void handle_heading(const Message &msg) {
@@ -619,42 +659,19 @@ namespace agrobus::nmea {
             u16 heading_raw = msg.get_u16_le(1);
             if (heading_raw != 0xFFFF) {
                 f64 heading = static_cast<f64>(heading_raw) * HEADING_RESOLUTION;
+                fusion_.add_heading(heading, msg.timestamp_us);
                 if (latest_position_)
                     latest_position_->heading_rad = heading;
+                publish_position();
                 on_heading.emit(heading);
             }
         }
 
-        void handle_system_time(const Message &msg) {
-            if (msg.data.size() < 8)
-                return;
-            SystemTimeData time;
-            time.sid = msg.data[0];
-            time.source = static_cast<TimeSource>(msg.data[1]);
-            time.days_since_epoch = msg.get_u16_le(2);
-            u32 secs_raw = msg.get_u32_le(4);
-            if (secs_raw != 0xFFFFFFFF)
-                time.seconds_since_midnight = static_cast<f64>(secs_raw) / 10000.0;
-            on_system_time.emit(time);
-        }
-
         // PGN 129539 - GNSS DOPs (8 bytes)
         void handle_gnss_dops(const Message &msg) {
-            if (msg.data.size() < 8)
-                return;
             GNSSDOPData dops;
-            dops.sid = msg.data[0];
-            dops.desired_mode = static_cast<GNSSDOPMode>((msg.data[1]) & 0x07);
-            dops.actual_mode = static_cast<GNSSDOPMode>((msg.data[1] >> 3) & 0x07);
-            i16 hdop_raw = static_cast<i16>(msg.get_u16_le(2));
-            i16 vdop_raw = static_cast<i16>(msg.get_u16_le(4));
-            i16 tdop_raw = static_cast<i16>(msg.get_u16_le(6));
-            if (hdop_raw != static_cast<i16>(0x7FFF))
-                dops.hdop = static_cast<f64>(hdop_raw) * DOP_RESOLUTION;
-            if (vdop_raw != static_cast<i16>(0x7FFF))
-                dops.vdop = static_cast<f64>(vdop_raw) * DOP_RESOLUTION;
-            if (tdop_raw != static_cast<i16>(0x7FFF))
-                dops.tdop = static_cast<f64>(tdop_raw) * DOP_RESOLUTION;
+            if (!decode_n2k(msg.data, dops))
+                return;
             // Update cached position
             if (latest_position_) {
                 if (dops.hdop > 0.0)
@@ -662,6 +679,7 @@ namespace agrobus::nmea {
                 if (dops.vdop > 0.0)
                     latest_position_->vdop = dops.vdop;
             }
+            publish_position();
             on_gnss_dops.emit(dops);
         }
 
@@ -678,132 +696,6 @@ namespace agrobus::nmea {
             }
         }
 
-        // PGN 127245 - Rudder (8 bytes)
-        void handle_rudder(const Message &msg) {
-            if (msg.data.size() < 6)
-                return;
-            RudderData rudder;
-            rudder.instance = msg.data[0];
-            rudder.direction = static_cast<RudderDirection>((msg.data[1]) & 0x07);
-            i16 angle_raw = static_cast<i16>(msg.get_u16_le(2));
-            i16 order_raw = static_cast<i16>(msg.get_u16_le(4));
-            if (angle_raw != static_cast<i16>(0x7FFF))
-                rudder.position_rad = static_cast<f64>(angle_raw) * HEADING_RESOLUTION;
-            if (order_raw != static_cast<i16>(0x7FFF))
-                rudder.angle_order_rad = static_cast<f64>(order_raw) * HEADING_RESOLUTION;
-            on_rudder.emit(rudder);
-        }
-
-        // PGN 127505 - Fluid Level (8 bytes)
-        void handle_fluid_level(const Message &msg) {
-            if (msg.data.size() < 7)
-                return;
-            FluidLevelData fluid;
-            fluid.instance = msg.data[0] & 0x0F;
-            fluid.type = static_cast<FluidType>(msg.data[0] >> 4);
-            u16 level_raw = msg.get_u16_le(1);
-            if (level_raw != 0xFFFF)
-                fluid.level_pct = static_cast<f64>(level_raw) * FLUID_LEVEL_RESOLUTION;
-            u32 capacity_raw = msg.get_u32_le(3);
-            if (capacity_raw != 0xFFFFFFFF)
-                fluid.capacity_l = static_cast<f64>(capacity_raw) * FLUID_CAPACITY_RESOLUTION;
-            on_fluid_level.emit(fluid);
-        }
-
-        // PGN 127508 - Battery Status (8 bytes)
-        void handle_battery(const Message &msg) {
-            if (msg.data.size() < 8)
-                return;
-            BatteryStatusData bat;
-            bat.instance = msg.data[0];
-            u16 voltage_raw = msg.get_u16_le(1);
-            i16 current_raw = static_cast<i16>(msg.get_u16_le(3));
-            if (voltage_raw != 0xFFFF)
-                bat.voltage = static_cast<f64>(voltage_raw) * VOLTAGE_RESOLUTION;
-            if (current_raw != static_cast<i16>(0x7FFF))
-                bat.current_a = static_cast<f64>(current_raw) * CURRENT_RESOLUTION;
-            on_battery.emit(bat);
-        }
-
-        // PGN 128259 - Speed, Water Referenced (8 bytes)
-        void handle_speed_water(const Message &msg) {
-            if (msg.data.size() < 6)
-                return;
-            SpeedWaterData spd;
-            spd.sid = msg.data[0];
-            u16 water_raw = msg.get_u16_le(1);
-            u16 ground_raw = msg.get_u16_le(3);
-            spd.reference = static_cast<SpeedWaterRefType>(msg.data[5]);
-            if (water_raw != 0xFFFF)
-                spd.water_speed_mps = static_cast<f64>(water_raw) * SPEED_RESOLUTION;
-            if (ground_raw != 0xFFFF)
-                spd.ground_speed_mps = static_cast<f64>(ground_raw) * SPEED_RESOLUTION;
-            on_speed_water.emit(spd);
-        }
-
-        // PGN 129283 - Cross Track Error (8 bytes)
-        void handle_xte(const Message &msg) {
-            if (msg.data.size() < 6)
-                return;
-            XTEData xte;
-            xte.sid = msg.data[0];
-            xte.mode = static_cast<XTEMode>(msg.data[1] & 0x0F);
-            xte.navigation_terminated = (msg.data[1] & 0x40) != 0;
-            i32 xte_raw = static_cast<i32>(msg.get_u32_le(2));
-            if (xte_raw != static_cast<i32>(0x7FFFFFFF))
-                xte.xte_m = static_cast<f64>(xte_raw) * XTE_RESOLUTION;
-            on_xte.emit(xte);
-        }
-
-        // PGN 130313 - Humidity (8 bytes)
-        void handle_humidity(const Message &msg) {
-            if (msg.data.size() < 7)
-                return;
-            HumidityData hum;
-            hum.sid = msg.data[0];
-            hum.instance = msg.data[1];
-            hum.source = static_cast<HumiditySource>(msg.data[2]);
-            u16 actual_raw = msg.get_u16_le(3);
-            u16 set_raw = msg.get_u16_le(5);
-            if (actual_raw != 0xFFFF)
-                hum.actual_pct = static_cast<f64>(actual_raw) * HUMIDITY_RESOLUTION;
-            if (set_raw != 0xFFFF)
-                hum.set_pct = static_cast<f64>(set_raw) * HUMIDITY_RESOLUTION;
-            on_humidity.emit(hum);
-        }
-
-        // PGN 130314 - Pressure (8 bytes)
-        void handle_pressure(const Message &msg) {
-            if (msg.data.size() < 7)
-                return;
-            PressureData pres;
-            pres.sid = msg.data[0];
-            pres.instance = msg.data[1];
-            pres.source = static_cast<PressureSource>(msg.data[2]);
-            u32 pressure_raw = msg.get_u32_le(3);
-            if (pressure_raw != 0xFFFFFFFF)
-                pres.pressure_pa = static_cast<f64>(pressure_raw) * PRESSURE_RESOLUTION;
-            on_pressure.emit(pres);
-        }
-
-        // PGN 130310 - Outside Environmental (8 bytes)
-        void handle_outside_environmental(const Message &msg) {
-            if (msg.data.size() < 7)
-                return;
-            OutsideEnvironmentalData env;
-            env.sid = msg.data[0];
-            u16 water_temp_raw = msg.get_u16_le(1);
-            u16 air_temp_raw = msg.get_u16_le(3);
-            u16 pressure_raw = msg.get_u16_le(5);
-            if (water_temp_raw != 0xFFFF)
-                env.water_temperature_k = static_cast<f64>(water_temp_raw) * TEMPERATURE_RESOLUTION;
-            if (air_temp_raw != 0xFFFF)
-                env.outside_temperature_k = static_cast<f64>(air_temp_raw) * TEMPERATURE_RESOLUTION;
-            if (pressure_raw != 0xFFFF)
-                env.atmospheric_pressure_pa = static_cast<f64>(pressure_raw) * PRESSURE_RESOLUTION;
-            on_outside_environmental.emit(env);
-        }
-
         // PGN 129029 - GNSS Position Data (Fast Packet, 43+ bytes)
         // Format: SID(1) + Days(2) + Seconds(4) + Lat(8) + Lon(8) + Alt(8) +
         //         Type(1) + Method(1) + Integrity(1) + NumSVs(1) + HDOP(2) + PDOP(2) + ...
@@ -818,7 +710,8 @@ namespace agrobus::nmea {
             i64 lat_raw = 0;
             for (u8 i = 0; i < 8; ++i)
                 lat_raw |= static_cast<i64>(msg.data[7 + i]) << (i * 8);
-            if (lat_raw != static_cast<i64>(0x7FFFFFFFFFFFFFFFLL)) {
+            bool has_lat_lon = lat_raw != static_cast<i64>(0x7FFFFFFFFFFFFFFFLL);
+            if (has_lat_lon) {
                 f64 lat = static_cast<f64>(lat_raw) * 1e-16;
                 // Longitude at offset 15: i64, 1e-16 degrees
                 i64 lon_raw = 0;
@@ -853,6 +746,8 @@ namespace agrobus::nmea {
             i16 pdop_raw = static_cast<i16>(msg.data[36]) | (static_cast<i16>(msg.data[37]) << 8);
             if (pdop_raw != static_cast<i16>(0x7FFF))
                 pos.pdop = static_cast<f64>(pdop_raw) * 0.01;
+            if (has_lat_lon)
+                fusion_.add_fix(pos);
 
             // Preserve heading/speed from other messages
             if (latest_position_) {
@@ -862,6 +757,7 @@ namespace agrobus::nmea {
             }
 
             latest_position_ = pos;
+            publish_position();
             on_position.emit(pos);
             echo::category("isobus.nmea")
                 .debug("GNSS detail: fix=", static_cast<u8>(pos.fix_type), " sats=", pos.satellites_used);
@@ -0,0 +1,329 @@
+#pragma once
+
+#include "definitions.hpp"
+#include <agrobus/net/data_span.hpp>
+#include <agrobus/net/pgn_defs.hpp>
+#include <agrobus/net/types.hpp>
+#include <array>
+#include <datapod/datapod.hpp>
+#include <limits>
+#include <string_view>
+#include <type_traits>
+
+namespace agrobus::nmea {
+    using namespace agrobus::net;
+
+    // ─── Field descriptors ──────────────────────────────────────────────────────
+    // One little-endian bit field of a single-frame N2K message and the struct
+    // member it lands in. Scaled fields skip the "not available" raw value
+    // (all ones, or the largest positive value when signed), leaving the
+    // member at its default; plain fields are always stored.
+    template <typename T> struct N2KField {
+        const char *name;
+        u16 bit_offset;
+        u8 bits;
+        bool is_signed;
+        f64 scale;
+        bool skip_unavailable;
+        void (*store)(T &, f64);
+    };
+
+    namespace n2k_detail {
+        template <typename M> struct member_of;
+        template <typename C, typename V> struct member_of<V C::*> {
+            using owner = C;
+            using value = V;
+        };
+
+        template <auto Member> using owner_t = typename member_of<decltype(Member)>::owner;
+
+        template <auto Member> void store(owner_t<Member> &out, f64 v) {
+            using V = typename member_of<decltype(Member)>::value;
+            if constexpr (std::is_enum_v<V>)
+                out.*Member = static_cast<V>(static_cast<std::underlying_type_t<V>>(v));
+            else if constexpr (std::is_same_v<V, bool>)
+                out.*Member = v != 0.0;
+            else
+                out.*Member = static_cast<V>(v);
+        }
+
+        // Raw field value as f64, false when the sender marked it unavailable
+        template <typename T> inline bool value(const u8 *data, const N2KField<T> &f, f64 &out) noexcept {
+            usize first = f.bit_offset / 8;
+            u8 shift = static_cast<u8>(f.bit_offset % 8);
+            usize bytes = (shift + f.bits + 7) / 8;
+            u64 acc = 0;
+            for (usize i = 0; i < bytes; ++i)
+                acc |= static_cast<u64>(data[first + i]) << (8 * i);
+            u64 mask = f.bits >= 64 ? ~0ULL : (1ULL << f.bits) - 1;
+            u64 raw = (acc >> shift) & mask;
+            if (!f.is_signed) {
+                if (f.skip_unavailable && raw == mask)
+                    return false;
+                out = static_cast<f64>(raw) * f.scale;
+                return true;
+            }
+            if (f.skip_unavailable && raw == (mask >> 1))
+                return false;
+            u64 sign = 1ULL << (f.bits - 1);
+            i64 v = static_cast<i64>((raw ^ sign) - sign);
+            out = static_cast<f64>(v) * f.scale;
+            return true;
+        }
+
+        template <typename T, usize N>
+        constexpr bool fits(const std::array<N2KField<T>, N> &fields, usize size) noexcept {
+            for (const auto &f : fields)
+                if (f.bit_offset + f.bits > size * 8 || f.bits == 0 || f.bits > 32)
+                    return false;
+            return true;
+        }
+    } // namespace n2k_detail
+
+    // Scaled value at `byte`, e.g. n2k_value<&WindData::speed_mps>("speed_mps", 1, 16, false, 0.01)
+    template <auto Member>
+    constexpr N2KField<n2k_detail::owner_t<Member>> n2k_value(const char *name, u16 byte, u8 bits, bool is_signed,
+                                                              f64 scale, bool skip_unavailable = true) noexcept {
+        return {name, static_cast<u16>(byte * 8), bits, is_signed, scale, skip_unavailable, &n2k_detail::store<Member>};
+    }
+
+    // Bits stored as they are: ids, instances, enums, flags
+    template <auto Member>
+    constexpr N2KField<n2k_detail::owner_t<Member>> n2k_raw(const char *name, u16 byte, u8 bits = 8, u8 shift = 0,
+                                                            bool is_signed = false) noexcept {
+        return {name, static_cast<u16>(byte * 8 + shift), bits, is_signed, 1.0, false, &n2k_detail::store<Member>};
+    }
+
+    // ─── Message layouts ────────────────────────────────────────────────────────
+    // N2KLayout<T> names the PGN, the shortest valid payload and the fields
+    // of each message that decodes into a definitions.hpp struct.
+    template <typename T> struct N2KLayout;
+
+    template <> struct N2KLayout<WindData> {
+        static constexpr PGN pgn = PGN_WIND_DATA;
+        static constexpr usize min_size = 6;
+        static constexpr std::array fields = {
+            n2k_raw<&WindData::sid>("sid", 0),
+            n2k_value<&WindData::speed_mps>("speed_mps", 1, 16, false, WIND_SPEED_RESOLUTION),
+            n2k_value<&WindData::direction_rad>("direction_rad", 3, 16, false, WIND_DIR_RESOLUTION),
+            n2k_raw<&WindData::reference>("reference", 5),
+        };
+    };
+
+    template <> struct N2KLayout<TemperatureData> {
+        static constexpr PGN pgn = PGN_TEMPERATURE;
+        static constexpr usize min_size = 5;
+        static constexpr std::array fields = {
+            n2k_raw<&TemperatureData::sid>("sid", 0),
+            n2k_raw<&TemperatureData::instance>("instance", 1),
+            n2k_raw<&TemperatureData::source>("source", 2),
+            n2k_value<&TemperatureData::actual_k>("actual_k", 3, 16, false, TEMPERATURE_RESOLUTION),
+        };
+    };
+
+    template <> struct N2KLayout<EngineData> {
+        static constexpr PGN pgn = PGN_ENGINE_PARAMS_RAPID;
+        static constexpr usize min_size = 6;
+        static constexpr std::array fields = {
+            n2k_raw<&EngineData::instance>("instance", 0),
+            n2k_value<&EngineData::rpm>("rpm", 1, 16, false, RPM_RESOLUTION),
+            n2k_value<&EngineData::boost_pressure_pa>("boost_pressure_pa", 3, 16, false, PRESSURE_RESOLUTION),
+            n2k_raw<&EngineData::tilt_trim>("tilt_trim", 5, 8, 0, true),
+        };
+    };
+
+    template <> struct N2KLayout<WaterDepthData> {
+        static constexpr PGN pgn = PGN_WATER_DEPTH;
+        static constexpr usize min_size = 7;
+        static constexpr std::array fields = {
+            n2k_raw<&WaterDepthData::sid>("sid", 0),
+            n2k_value<&WaterDepthData::depth_m>("depth_m", 1, 32, false, DEPTH_RESOLUTION),
+            n2k_value<&WaterDepthData::offset_m>("offset_m", 5, 16, true, DEPTH_RESOLUTION, false),
+        };
+    };
+
+    template <> struct N2KLayout<SystemTimeData> {
+        static constexpr PGN pgn = PGN_SYSTEM_TIME;
+        static constexpr usize min_size = 8;
+        static constexpr std::array fields = {
+            n2k_raw<&SystemTimeData::sid>("sid", 0),
+            n2k_raw<&SystemTimeData::source>("source", 1),
+            n2k_raw<&SystemTimeData::days_since_epoch>("days_since_epoch", 2, 16),
+            n2k_value<&SystemTimeData::seconds_since_midnight>("seconds_since_midnight", 4, 32, false, 1e-4),
+        };
+    };
+
+    template <> struct N2KLayout<GNSSDOPData> {
+        static constexpr PGN pgn = PGN_GNSS_DOPs;
+        static constexpr usize min_size = 8;
+        static constexpr std::array fields = {
+            n2k_raw<&GNSSDOPData::sid>("sid", 0),
+            n2k_raw<&GNSSDOPData::desired_mode>("desired_mode", 1, 3),
+            n2k_raw<&GNSSDOPData::actual_mode>("actual_mode", 1, 3, 3),
+            n2k_value<&GNSSDOPData::hdop>("hdop", 2, 16, true, DOP_RESOLUTION),
+            n2k_value<&GNSSDOPData::vdop>("vdop", 4, 16, true, DOP_RESOLUTION),
+            n2k_value<&GNSSDOPData::tdop>("tdop", 6, 16, true, DOP_RESOLUTION),
+        };
+    };
+
+    template <> struct N2KLayout<RudderData> {
+        static constexpr PGN pgn = PGN_RUDDER;
+        static constexpr usize min_size = 6;
+        static constexpr std::array fields = {
+            n2k_raw<&RudderData::instance>("instance", 0),
+            n2k_raw<&RudderData::direction>("direction", 1, 3),
+            n2k_value<&RudderData::position_rad>("position_rad", 2, 16, true, HEADING_RESOLUTION),
+            n2k_value<&RudderData::angle_order_rad>("angle_order_rad", 4, 16, true, HEADING_RESOLUTION),
+        };
+    };
+
+    template <> struct N2KLayout<FluidLevelData> {
+        static constexpr PGN pgn = PGN_FLUID_LEVEL;
+        static constexpr usize min_size = 7;
+        static constexpr std::array fields = {
+            n2k_raw<&FluidLevelData::instance>("instance", 0, 4),
+            n2k_raw<&FluidLevelData::type>("type", 0, 4, 4),
+            n2k_value<&FluidLevelData::level_pct>("level_pct", 1, 16, false, FLUID_LEVEL_RESOLUTION),
+            n2k_value<&FluidLevelData::capacity_l>("capacity_l", 3, 32, false, FLUID_CAPACITY_RESOLUTION),
+        };
+    };
+
+    template <> struct N2KLayout<BatteryStatusData> {
+        static constexpr PGN pgn = PGN_BATTERY_STATUS;
+        static constexpr usize min_size = 8;
+        static constexpr std::array fields = {
+            n2k_raw<&BatteryStatusData::instance>("instance", 0),
+            n2k_value<&BatteryStatusData::voltage>("voltage", 1, 16, false, VOLTAGE_RESOLUTION),
+            n2k_value<&BatteryStatusData::current_a>("current_a", 3, 16, true, CURRENT_RESOLUTION),
+        };
+    };
+
+    template <> struct N2KLayout<SpeedWaterData> {
+        static constexpr PGN pgn = PGN_SPEED_WATER;
+        static constexpr usize min_size = 6;
+        static constexpr std::array fields = {
+            n2k_raw<&SpeedWaterData::sid>("sid", 0),
+            n2k_value<&SpeedWaterData::water_speed_mps>("water_speed_mps", 1, 16, false, SPEED_RESOLUTION),
+            n2k_value<&SpeedWaterData::ground_speed_mps>("ground_speed_mps", 3, 16, false, SPEED_RESOLUTION),
+            n2k_raw<&SpeedWaterData::reference>("reference", 5),
+        };
+    };
+
+    template <> struct N2KLayout<XTEData> {
+        static constexpr PGN pgn = PGN_XTE;
+        static constexpr usize min_size = 6;
+        static constexpr std::array fields = {
+            n2k_raw<&XTEData::sid>("sid", 0),
+            n2k_raw<&XTEData::mode>("mode", 1, 4),
+            n2k_raw<&XTEData::navigation_terminated>("navigation_terminated", 1, 1, 6),
+            n2k_value<&XTEData::xte_m>("xte_m", 2, 32, true, XTE_RESOLUTION),
+        };
+    };
+
+    template <> struct N2KLayout<HumidityData> {
+        static constexpr PGN pgn = PGN_HUMIDITY;
+        static constexpr usize min_size = 7;
+        static constexpr std::array fields = {
+            n2k_raw<&HumidityData::sid>("sid", 0),
+            n2k_raw<&HumidityData::instance>("instance", 1),
+            n2k_raw<&HumidityData::source>("source", 2),
+            n2k_value<&HumidityData::actual_pct>("actual_pct", 3, 16, false, HUMIDITY_RESOLUTION),
+            n2k_value<&HumidityData::set_pct>("set_pct", 5, 16, false, HUMIDITY_RESOLUTION),
+        };
+    };
+
+    template <> struct N2KLayout<PressureData> {
+        static constexpr PGN pgn = PGN_PRESSURE;
+        static constexpr usize min_size = 7;
+        static constexpr std::array fields = {
+            n2k_raw<&PressureData::sid>("sid", 0),
+            n2k_raw<&PressureData::instance>("instance", 1),
+            n2k_raw<&PressureData::source>("source", 2),
+            n2k_value<&PressureData::pressure_pa>("pressure_pa", 3, 32, false, PRESSURE_RESOLUTION),
+        };
+    };
+
+    template <> struct N2KLayout<OutsideEnvironmentalData> {
+        static constexpr PGN pgn = PGN_OUTSIDE_ENVIRONMENTAL;
+        static constexpr usize min_size = 7;
+        static constexpr std::array fields = {
+            n2k_raw<&OutsideEnvironmentalData::sid>("sid", 0),
+            n2k_value<&OutsideEnvironmentalData::water_temperature_k>("water_temperature_k", 1, 16, false,
+                                                                      TEMPERATURE_RESOLUTION),
+            n2k_value<&OutsideEnvironmentalData::outside_temperature_k>("outside_temperature_k", 3, 16, false,
+                                                                        TEMPERATURE_RESOLUTION),
+            n2k_value<&OutsideEnvironmentalData::atmospheric_pressure_pa>("atmospheric_pressure_pa", 5, 16, false,
+                                                                          PRESSURE_RESOLUTION),
+        };
+    };
+
+    // ─── Decoding ───────────────────────────────────────────────────────────────
+    // Fills `out` from one message; false when the payload is too short
+    template <typename T> bool decode_n2k(DataSpan data, T &out) noexcept {
+        using Layout = N2KLayout<T>;
+        static_assert(n2k_detail::fits(Layout::fields, Layout::min_size), "N2K field outside the minimum payload");
+        if (data.size() < Layout::min_size)
+            return false;
+        for (const auto &field : Layout::fields) {
+            f64 v = 0.0;
+            if (n2k_detail::value(data.data(), field, v))
+                field.store(out, v);
+        }
+        return true;
+    }
+
+    // ─── Batch decoding ─────────────────────────────────────────────────────────
+    // A captured log of one message type as one column per field, in layout
+    // order, for analytics. Unavailable values are NaN.
+    template <typename T> struct N2KColumns {
+        static constexpr usize FIELDS = N2KLayout<T>::fields.size();
+
+        dp::Vector<u64> timestamp_us;
+        dp::Vector<Address> source;
+        dp::Array<dp::Vector<f64>, FIELDS> values;
+
+        usize size() const noexcept { return timestamp_us.size(); }
+
+        const dp::Vector<f64> *column(std::string_view name) const noexcept {
+            for (usize i = 0; i < FIELDS; ++i)
+                if (name == N2KLayout<T>::fields[i].name)
+                    return &values[i];
+            return nullptr;
+        }
+
+        void reserve(usize rows) {
+            timestamp_us.reserve(rows);
+            source.reserve(rows);
+            for (auto &col : values)
+                col.reserve(rows);
+        }
+
+        void clear() {
+            timestamp_us.clear();
+            source.clear();
+            for (auto &col : values)
+                col.clear();
+        }
+    };
+
+    // Appends every well-formed message of T's PGN in `log` (any range of
+    // Message or MessageView); returns the rows added
+    template <typename T, typename Log> usize decode_n2k_batch(const Log &log, N2KColumns<T> &out) {
+        using Layout = N2KLayout<T>;
+        usize added = 0;
+        for (const auto &msg : log) {
+            if (msg.pgn != Layout::pgn || msg.data.size() < Layout::min_size)
+                continue;
+            out.timestamp_us.push_back(msg.timestamp_us);
+            out.source.push_back(msg.source);
+            for (usize i = 0; i < N2KColumns<T>::FIELDS; ++i) {
+                f64 v = std::numeric_limits<f64>::quiet_NaN();
+                n2k_detail::value(msg.data.data(), Layout::fields[i], v);
+                out.values[i].push_back(v);
+            }
+            ++added;
+        }
+        return added;
+    }
+
+} // namespace agrobus::nmea
@@ -0,0 +1,284 @@
+#pragma once
+
+#include "n2k_management.hpp"
+#include <agrobus/net/data_span.hpp>
+#include <agrobus/net/event.hpp>
+#include <agrobus/net/name.hpp>
+#include <agrobus/net/name_table.hpp>
+#include <agrobus/net/network_manager.hpp>
+#include <agrobus/net/types.hpp>
+#include <datapod/datapod.hpp>
+#include <echo/echo.hpp>
+#include <functional>
+
+namespace agrobus::nmea {
+    using namespace agrobus::net;
+
+    // ─── Inventory entry ────────────────────────────────────────────────────────
+    struct N2KDevice {
+        Name name;
+        Address address = NULL_ADDRESS; // Last address seen claimed by `name`
+        dp::Optional<N2KProductInfo> product;
+        dp::Optional<N2KConfigInfo> config;
+        dp::Optional<N2KHeartbeat> heartbeat;
+        u64 heartbeat_us = 0; // Receive time of the last heartbeat
+        bool online = false;  // Holds its address in the NAME table right now
+    };
+
+    using N2KInventoryStore = std::function<void(const dp::Vector<u8> &)>;
+
+    // ─── Bus-wide device inventory ──────────────────────────────────────────────
+    // Product, config and heartbeat of every device, kept per NAME so the data
+    // follows a device that moves to another address. Requests only go out
+    // when the NAME table of our port changes, and only for NAMEs the cache
+    // has no product or config info for, through N2KManagement's paced scan
+    // (product info first, then config info); readers use the cache and
+    // never cause bus traffic. encode()/restore() persist the cache in the
+    // application's storage, and the store callback gets a fresh blob
+    // whenever product, config or addresses change (not on heartbeats).
+    //
+    // Starting a refresh replaces a scan the application started itself.
+    class N2KInventory {
+        IsoNet &net_;
+        N2KManagement &mgmt_;
+        InternalCF *cf_;
+        dp::Map<u64, N2KDevice> devices_;
+        dp::Vector<Address> config_wanted_; // Scanned once the product scan is done
+        N2KInventoryStore store_;
+        ListenerToken names_token_ = INVALID_TOKEN;
+        ListenerToken product_token_ = INVALID_TOKEN;
+        ListenerToken config_token_ = INVALID_TOKEN;
+        ListenerToken heartbeat_token_ = INVALID_TOKEN;
+        ListenerToken scan_token_ = INVALID_TOKEN;
+
+      public:
+        static constexpr u8 MAGIC = 0xA7;
+        static constexpr u8 VERSION = 1;
+
+        N2KInventory(IsoNet &net, N2KManagement &mgmt, InternalCF *cf) : net_(net), mgmt_(mgmt), cf_(cf) {}
+        N2KInventory(const N2KInventory &) = delete;
+        N2KInventory &operator=(const N2KInventory &) = delete;
+
+        ~N2KInventory() {
+            net_.on_names_changed.unsubscribe(names_token_);
+            mgmt_.on_product_info_received.unsubscribe(product_token_);
+            mgmt_.on_config_info_received.unsubscribe(config_token_);
+            mgmt_.on_heartbeat_received.unsubscribe(heartbeat_token_);
+            mgmt_.on_scan_complete.unsubscribe(scan_token_);
+        }
+
+        Result<void> initialize() {
+            if (!cf_) {
+                return Result<void>::err(Error::invalid_state("control function not set"));
+            }
+            names_token_ = net_.on_names_changed.subscribe([this](u8 port) {
+                if (port == cf_->port())
+                    refresh();
+            });
+            product_token_ = mgmt_.on_product_info_received.subscribe(
+                [this](N2KProductInfo info, Address src) {
+                    if (N2KDevice *dev = device_at(src)) {
+                        dev->product = std::move(info);
+                        changed(*dev);
+                    }
+                });
+            config_token_ = mgmt_.on_config_info_received.subscribe([this](N2KConfigInfo info, Address src) {
+                if (N2KDevice *dev = device_at(src)) {
+                    dev->config = std::move(info);
+                    changed(*dev);
+                }
+            });
+            heartbeat_token_ = mgmt_.on_heartbeat_received.subscribe([this](N2KHeartbeat hb, Address src) {
+                if (N2KDevice *dev = device_at(src)) {
+                    dev->heartbeat = hb;
+                    dev->heartbeat_us = net_.rx_time_us();
+                    on_device_updated.emit(*dev);
+                }
+            });
+            scan_token_ = mgmt_.on_scan_complete.subscribe([this]() {
+                if (!config_wanted_.empty())
+                    (void)mgmt_.scan(PGN_CONFIG_INFO, std::move(config_wanted_));
+                config_wanted_.clear();
+            });
+            return {};
+        }
+
+        // Match the cache against the NAME table now (also done on every change)
+        void refresh() {
+            dp::Vector<Address> want_product;
+            config_wanted_.clear();
+            bool moved = false;
+            for (auto &[raw, dev] : devices_)
+                dev.online = false;
+            net_.names().for_each(cf_->port(), [&](const NameTable::Entry &e) {
+                if (e.address == cf_->address())
+                    return;
+                N2KDevice &dev = devices_[e.name.raw];
+                if (dev.name != e.name || dev.address != e.address)
+                    moved = true;
+                dev.name = e.name;
+                dev.address = e.address;
+                dev.online = true;
+                if (!dev.product)
+                    want_product.push_back(e.address);
+                if (!dev.config)
+                    config_wanted_.push_back(e.address);
+            });
+            if (moved)
+                persist();
+            if (!want_product.empty()) {
+                echo::category("isobus.nmea.inventory").debug(want_product.size(), " devices without product info");
+                (void)mgmt_.scan(PGN_PRODUCT_INFO, std::move(want_product));
+            } else if (!config_wanted_.empty()) {
+                (void)mgmt_.scan(PGN_CONFIG_INFO, std::move(config_wanted_));
+                config_wanted_.clear();
+            }
+        }
+
+        // ─── Queries (no bus traffic) ───────────────────────────────────────────
+        const dp::Map<u64, N2KDevice> &devices() const noexcept { return devices_; }
+        usize size() const noexcept { return devices_.size(); }
+
+        const N2KDevice *find(Name name) const {
+            auto it = devices_.find(name.raw);
+            return it != devices_.end() ? &it->second : nullptr;
+        }
+
+        // The device holding `addr` on our port right now
+        const N2KDevice *at(Address addr) const {
+            auto name = net_.names().name_at(cf_->port(), addr);
+            return name ? find(*name) : nullptr;
+        }
+
+        // ─── Persistence ────────────────────────────────────────────────────────
+        void set_store(N2KInventoryStore store) { store_ = std::move(store); }
+
+        // [magic, version, count(2), per device: NAME(8), address, flags,
+        //  (length(2), product) if flags & 1, (length(2), config) if flags & 2,
+        //  heartbeat(8) if flags & 4]
+        dp::Vector<u8> encode() const {
+            dp::Vector<u8> out;
+            usize count = devices_.size() > 0xFFFF ? 0xFFFF : devices_.size();
+            out.push_back(MAGIC);
+            out.push_back(VERSION);
+            out.push_back(static_cast<u8>(count & 0xFF));
+            out.push_back(static_cast<u8>((count >> 8) & 0xFF));
+            usize n = 0;
+            for (const auto &[raw, dev] : devices_) {
+                if (n++ == count)
+                    break;
+                for (u8 b : dev.name.to_bytes())
+                    out.push_back(b);
+                out.push_back(dev.address);
+                out.push_back(static_cast<u8>((dev.product ? 1 : 0) | (dev.config ? 2 : 0) | (dev.heartbeat ? 4 : 0)));
+                if (dev.product)
+                    append_block(out, dev.product->encode());
+                if (dev.config)
+                    append_block(out, dev.config->encode());
+                if (dev.heartbeat) {
+                    for (u8 b : dev.heartbeat->encode())
+                        out.push_back(b);
+                }
+            }
+            return out;
+        }
+
+        // Replace the cache with a blob from encode(); every device starts
+        // offline until the NAME table shows it. False (cache unchanged) on a
+        // blob that does not parse.
+        bool restore(DataSpan data) {
+            if (data.size() < 4 || data[0] != MAGIC || data[1] != VERSION)
+                return false;
+            usize count = static_cast<usize>(data[2]) | (static_cast<usize>(data[3]) << 8);
+            usize pos = 4;
+            dp::Map<u64, N2KDevice> devices;
+            for (usize i = 0; i < count; ++i) {
+                if (pos + 10 > data.size())
+                    return false;
+                N2KDevice dev;
+                dev.name = Name::from_bytes(data.data() + pos);
+                dev.address = data[pos + 8];
+                u8 flags = data[pos + 9];
+                pos += 10;
+                if (flags & 1) {
+                    auto block = read_block(data, pos);
+                    if (!block)
+                        return false;
+                    auto product = N2KProductInfo::decode(*block);
+                    if (!product.is_ok())
+                        return false;
+                    dev.product = std::move(product.value());
+                }
+                if (flags & 2) {
+                    auto block = read_block(data, pos);
+                    if (!block)
+                        return false;
+                    auto config = N2KConfigInfo::decode(*block);
+                    if (!config.is_ok())
+                        return false;
+                    dev.config = std::move(config.value());
+                }
+                if (flags & 4) {
+                    if (pos + 8 > data.size())
+                        return false;
+                    dev.heartbeat = N2KHeartbeat::decode(DataSpan(data.data() + pos, 8));
+                    pos += 8;
+                }
+                devices[dev.name.raw] = std::move(dev);
+            }
+            devices_ = std::move(devices);
+            return true;
+        }
+
+        void clear() { devices_.clear(); }
+
+        // ─── Events ─────────────────────────────────────────────────────────────
+        Event<const N2KDevice &> on_device_updated;
+
+      private:
+        N2KDevice *device_at(Address addr) {
+            auto name = net_.names().name_at(cf_->port(), addr);
+            if (!name)
+                return nullptr;
+            auto it = devices_.find(name->raw);
+            if (it == devices_.end()) {
+                // Answer from a device that claimed after the last refresh
+                N2KDevice &dev = devices_[name->raw];
+                dev.name = *name;
+                dev.address = addr;
+                dev.online = true;
+                return &dev;
+            }
+            return &it->second;
+        }
+
+        void changed(const N2KDevice &dev) {
+            on_device_updated.emit(dev);
+            persist();
+        }
+
+        void persist() {
+            if (store_)
+                store_(encode());
+        }
+
+        static void append_block(dp::Vector<u8> &out, const dp::Vector<u8> &block) {
+            usize len = block.size() > 0xFFFF ? 0xFFFF : block.size();
+            out.push_back(static_cast<u8>(len & 0xFF));
+            out.push_back(static_cast<u8>((len >> 8) & 0xFF));
+            out.insert(out.end(), block.begin(), block.begin() + static_cast<std::ptrdiff_t>(len));
+        }
+
+        static dp::Optional<DataSpan> read_block(DataSpan data, usize &pos) {
+            if (pos + 2 > data.size())
+                return dp::nullopt;
+            usize len = static_cast<usize>(data[pos]) | (static_cast<usize>(data[pos + 1]) << 8);
+            if (pos + 2 + len > data.size())
+                return dp::nullopt;
+            DataSpan block(data.data() + pos + 2, len);
+            pos += 2 + len;
+            return block;
+        }
+    };
+
+} // namespace agrobus::nmea
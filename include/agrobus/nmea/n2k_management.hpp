@@ -6,6 +6,7 @@
 #include <agrobus/net/internal_cf.hpp>
 #include <agrobus/net/message.hpp>
 #include <agrobus/net/network_manager.hpp>
+#include <agrobus/net/timer_wheel.hpp>
 #include <agrobus/net/types.hpp>
 #include <datapod/datapod.hpp>
 #include <echo/echo.hpp>
@@ -80,7 +81,7 @@ namespace agrobus::nmea {
             return data;
         }
 
-        static Result<N2KProductInfo> decode(const dp::Vector<u8> &data) {
+        static Result<N2KProductInfo> decode(DataSpan data) {
             // Minimum size: 2+2+32+40+24+32+1+1 = 134
             if (data.size() < 134) {
                 return Result<N2KProductInfo>::err(Error(ErrorCode::InvalidData, "product info too short"));
@@ -184,7 +185,7 @@ namespace agrobus::nmea {
             return data;
         }
 
-        static Result<N2KConfigInfo> decode(const dp::Vector<u8> &data) {
+        static Result<N2KConfigInfo> decode(DataSpan data) {
             if (data.size() < 6) {
                 return Result<N2KConfigInfo>::err(Error(ErrorCode::InvalidData, "config info too short"));
             }
@@ -268,7 +269,7 @@ namespace agrobus::nmea {
             return data;
         }
 
-        static N2KHeartbeat decode(const dp::Vector<u8> &data) {
+        static N2KHeartbeat decode(DataSpan data) {
             N2KHeartbeat hb;
 
             if (data.size() >= 2) {
@@ -297,6 +298,8 @@ namespace agrobus::nmea {
         N2KProductInfo product_info;
         N2KConfigInfo config_info;
         u32 heartbeat_interval_ms = 60000;
+        u32 scan_interval_ms = 50; // Gap between two requests of a bus scan
+        u8 scan_max_pending = 8;   // Scan requests in flight at once
 
         N2KManagementConfig &product(N2KProductInfo p) {
             product_info = std::move(p);
@@ -310,12 +313,18 @@ namespace agrobus::nmea {
             heartbeat_interval_ms = ms;
             return *this;
         }
+        N2KManagementConfig &scan_pacing(u32 interval_ms, u8 max_pending) {
+            scan_interval_ms = interval_ms;
+            scan_max_pending = max_pending == 0 ? 1 : max_pending;
+            return *this;
+        }
     };
 
     // ─── NMEA2000 Request Timeout (Appendix A/B) ──────────────────────────────
     inline constexpr u32 N2K_REQUEST_TIMEOUT_MS = 5000;
 
     // ─── Pending request tracking ──────────────────────────────────────────────
+    // Snapshot of one outstanding request (see N2KManagement::pending_requests)
     struct PendingRequest {
         PGN pgn = 0;
         Address destination = 0xFF;
@@ -324,17 +333,56 @@ namespace agrobus::nmea {
     };
 
     // ─── NMEA2000 Network Management handler ───────────────────────────────────
+    // The heartbeat and the bus scan pacing are timers on the IsoNet timer
+    // wheel and run from IsoNet::update(); update() here only expires
+    // unanswered requests. Neither copyable nor movable: the timers and PGN
+    // callbacks hold `this`.
     class N2KManagement {
         IsoNet &net_;
         InternalCF *cf_;
         N2KManagementConfig config_;
-        u32 heartbeat_timer_ms_ = 0;
+        TimerId heartbeat_timer_ = INVALID_TIMER;
         u8 heartbeat_seq_ = 0;
-        dp::Vector<PendingRequest> pending_requests_;
+
+        // One outstanding request per destination (requests to a device are
+        // sequenced), so the table is indexed by address and each slot records
+        // the PGN it waits for: lookups by (PGN, destination) are one array
+        // access. Timeouts live in a timer wheel tagged with the destination.
+        struct PendingSlot {
+            PGN pgn = 0;
+            TimerId timer = INVALID_TIMER;
+            bool scan = false; // Issued by a bus scan
+        };
+        dp::Array<PendingSlot, 256> pending_{};
+        usize pending_count_ = 0;
+        usize scan_pending_ = 0;
+        TimerWheel timeouts_;
+
+        // Bus scan: destinations still to request, issued one per scan interval
+        PGN scan_pgn_ = 0;
+        dp::Vector<Address> scan_queue_;
+        usize scan_next_ = 0;
+        TimerId scan_timer_ = INVALID_TIMER;
+        bool scanning_ = false;
 
       public:
         N2KManagement(IsoNet &net, InternalCF *cf, N2KManagementConfig config = {})
-            : net_(net), cf_(cf), config_(std::move(config)) {}
+            : net_(net), cf_(cf), config_(std::move(config)) {
+            // Heartbeats every interval on the network clock from construction
+            u32 interval = config_.heartbeat_interval_ms;
+            u32 phase = interval == 0 ? 0 : static_cast<u32>(net_.timers().now_ms() % interval);
+            heartbeat_timer_ = net_.timers().schedule_every(interval, phase, [this]() { send_heartbeat(); });
+        }
+
+        N2KManagement(const N2KManagement &) = delete;
+        N2KManagement &operator=(const N2KManagement &) = delete;
+        N2KManagement(N2KManagement &&) = delete;
+        N2KManagement &operator=(N2KManagement &&) = delete;
+
+        ~N2KManagement() {
+            net_.timers().cancel(heartbeat_timer_);
+            net_.timers().cancel(scan_timer_);
+        }
 
         Result<void> initialize() {
             if (!cf_) {
@@ -374,28 +422,8 @@ namespace agrobus::nmea {
         }
 
         void update(u32 elapsed_ms) {
-            heartbeat_timer_ms_ += elapsed_ms;
-            if (heartbeat_timer_ms_ >= config_.heartbeat_interval_ms) {
-                heartbeat_timer_ms_ -= config_.heartbeat_interval_ms;
-                send_heartbeat();
-            }
-
-            // Age pending requests and check for timeouts
-            for (auto it = pending_requests_.begin(); it != pending_requests_.end();) {
-                if (it->active) {
-                    it->elapsed_ms += elapsed_ms;
-                    if (it->elapsed_ms >= N2K_REQUEST_TIMEOUT_MS) {
-                        echo::category("isobus.nmea.n2k_mgmt")
-                            .warn("request timeout: PGN=", it->pgn, " dest=", it->destination);
-                        PGN pgn = it->pgn;
-                        Address dest = it->destination;
-                        it = pending_requests_.erase(it);
-                        on_request_timeout.emit(pgn, dest);
-                        continue;
-                    }
-                }
-                ++it;
-            }
+            ProfileScope profile(net_.update_profiler(), "n2k_management");
+            timeouts_.advance(elapsed_ms, [this](TimerId, u32 dest) { expire(static_cast<Address>(dest)); });
         }
 
         // ─── Send responses ─────────────────────────────────────────────────────
@@ -428,52 +456,49 @@ namespace agrobus::nmea {
 
         // ─── Destination-specific requests (NMEA2000 Appendix A/B) ─────────────
 
-        Result<void> request_product_info(Address target) {
-            if (has_pending_request_to(target)) {
-                return Result<void>::err(Error::invalid_state("request already pending to destination"));
-            }
-            echo::category("isobus.nmea.n2k_mgmt").debug("requesting product info from ", target);
-
-            PendingRequest req;
-            req.pgn = PGN_PRODUCT_INFO;
-            req.destination = target;
-            req.elapsed_ms = 0;
-            req.active = true;
-            pending_requests_.push_back(req);
-
-            // Send ISO request (PGN_REQUEST) for product info, destination-specific
-            dp::Vector<u8> data(3, 0);
-            data[0] = static_cast<u8>(PGN_PRODUCT_INFO & 0xFF);
-            data[1] = static_cast<u8>((PGN_PRODUCT_INFO >> 8) & 0xFF);
-            data[2] = static_cast<u8>((PGN_PRODUCT_INFO >> 16) & 0xFF);
-            ControlFunction dest_cf;
-            dest_cf.address = target;
-            return net_.send(PGN_REQUEST, data, cf_, &dest_cf, Priority::Default);
+        Result<void> request_product_info(Address target) { return request(PGN_PRODUCT_INFO, target); }
+
+        Result<void> request_config_info(Address target) { return request(PGN_CONFIG_INFO, target); }
+
+        // ─── Bus scan ───────────────────────────────────────────────────────────
+        // Request `pgn` (product or config info) from every address claimed on
+        // our port, or from `targets`. Requests go out one per scan_interval_ms
+        // with at most scan_max_pending unanswered, so a scan of a full bus
+        // stays a trickle instead of a burst; on_scan_complete fires when the
+        // last one is answered or timed out. A new scan replaces a running one.
+        Result<void> scan_bus(PGN pgn = PGN_PRODUCT_INFO) {
+            dp::Vector<Address> targets;
+            net_.names().for_each(cf_->port(), [&](const NameTable::Entry &e) {
+                if (e.address != cf_->address())
+                    targets.push_back(e.address);
+            });
+            return scan(pgn, std::move(targets));
         }
 
-        Result<void> request_config_info(Address target) {
-            if (has_pending_request_to(target)) {
-                return Result<void>::err(Error::invalid_state("request already pending to destination"));
+        Result<void> scan(PGN pgn, dp::Vector<Address> targets) {
+            if (pgn != PGN_PRODUCT_INFO && pgn != PGN_CONFIG_INFO) {
+                return Result<void>::err(Error::invalid_state("scan supports product and config info only"));
             }
-            echo::category("isobus.nmea.n2k_mgmt").debug("requesting config info from ", target);
-
-            PendingRequest req;
-            req.pgn = PGN_CONFIG_INFO;
-            req.destination = target;
-            req.elapsed_ms = 0;
-            req.active = true;
-            pending_requests_.push_back(req);
+            echo::category("isobus.nmea.n2k_mgmt").debug("scanning ", targets.size(), " devices for PGN ", pgn);
+            scan_pgn_ = pgn;
+            scan_queue_ = std::move(targets);
+            scan_next_ = 0;
+            scanning_ = true;
+            arm_scan(0); // First request on the next update
+            return {};
+        }
 
-            // Send ISO request (PGN_REQUEST) for config info, destination-specific
-            dp::Vector<u8> data(3, 0);
-            data[0] = static_cast<u8>(PGN_CONFIG_INFO & 0xFF);
-            data[1] = static_cast<u8>((PGN_CONFIG_INFO >> 8) & 0xFF);
-            data[2] = static_cast<u8>((PGN_CONFIG_INFO >> 16) & 0xFF);
-            ControlFunction dest_cf;
-            dest_cf.address = target;
-            return net_.send(PGN_REQUEST, data, cf_, &dest_cf, Priority::Default);
+        void cancel_scan() {
+            scan_queue_.clear();
+            scan_next_ = 0;
+            scanning_ = false;
+            net_.timers().cancel(scan_timer_);
+            scan_timer_ = INVALID_TIMER;
         }
 
+        bool scanning() const noexcept { return scanning_; }
+        usize scan_remaining() const noexcept { return scan_queue_.size() - scan_next_ + scan_pending_; }
+
         // ─── Runtime setters ────────────────────────────────────────────────────
 
         void set_product_info(N2KProductInfo info) { config_.product_info = std::move(info); }
@@ -486,15 +511,26 @@ namespace agrobus::nmea {
         const N2KConfigInfo &config_info() const noexcept { return config_.config_info; }
         u32 heartbeat_interval() const noexcept { return config_.heartbeat_interval_ms; }
         u8 heartbeat_sequence() const noexcept { return heartbeat_seq_; }
-        const dp::Vector<PendingRequest> &pending_requests() const noexcept { return pending_requests_; }
+        usize pending_count() const noexcept { return pending_count_; }
+
+        // Outstanding requests in address order (built on each call, for diagnostics)
+        dp::Vector<PendingRequest> pending_requests() const {
+            dp::Vector<PendingRequest> out;
+            out.reserve(pending_count_);
+            for (usize a = 0; a < pending_.size() && out.size() < pending_count_; ++a) {
+                const PendingSlot &slot = pending_[a];
+                if (slot.timer == INVALID_TIMER)
+                    continue;
+                u32 left = timeouts_.remaining_ms(slot.timer);
+                out.push_back(PendingRequest{slot.pgn, static_cast<Address>(a), N2K_REQUEST_TIMEOUT_MS - left, true});
+            }
+            return out;
+        }
 
-        bool has_pending_request_to(Address dest) const noexcept {
-            for (const auto &r : pending_requests_) {
-                if (r.active && r.destination == dest) {
-                    return true;
-                }
-            }
-            return false;
+        bool has_pending_request_to(Address dest) const noexcept { return pending_[dest].timer != INVALID_TIMER; }
+
+        bool has_pending_request(PGN pgn, Address dest) const noexcept {
+            return pending_[dest].timer != INVALID_TIMER && pending_[dest].pgn == pgn;
         }
 
         // ─── Events ─────────────────────────────────────────────────────────────
@@ -505,14 +541,87 @@ namespace agrobus::nmea {
         Event<Address> on_product_info_requested;
         Event<Address> on_config_info_requested;
         Event<PGN, Address> on_request_timeout;
+        Event<> on_scan_complete;
 
       private:
+        Result<void> request(PGN pgn, Address target, bool from_scan = false) {
+            if (has_pending_request_to(target)) {
+                return Result<void>::err(Error::invalid_state("request already pending to destination"));
+            }
+            echo::category("isobus.nmea.n2k_mgmt")
+                .debug("requesting ", pgn == PGN_PRODUCT_INFO ? "product" : "config", " info from ", target);
+
+            PendingSlot &slot = pending_[target];
+            slot.pgn = pgn;
+            slot.scan = from_scan;
+            slot.timer = timeouts_.schedule_tag(N2K_REQUEST_TIMEOUT_MS, target);
+            ++pending_count_;
+            if (from_scan)
+                ++scan_pending_;
+
+            // Send ISO request (PGN_REQUEST), destination-specific
+            dp::Vector<u8> data(3, 0);
+            data[0] = static_cast<u8>(pgn & 0xFF);
+            data[1] = static_cast<u8>((pgn >> 8) & 0xFF);
+            data[2] = static_cast<u8>((pgn >> 16) & 0xFF);
+            ControlFunction dest_cf;
+            dest_cf.address = target;
+            return net_.send(PGN_REQUEST, data, cf_, &dest_cf, Priority::Default);
+        }
+
         void clear_pending_request(PGN pgn, Address source) {
-            for (auto it = pending_requests_.begin(); it != pending_requests_.end(); ++it) {
-                if (it->active && it->pgn == pgn && it->destination == source) {
-                    pending_requests_.erase(it);
-                    return;
-                }
+            if (has_pending_request(pgn, source)) {
+                timeouts_.cancel(pending_[source].timer);
+                release(source);
+            }
+        }
+
+        void expire(Address dest) {
+            PGN pgn = pending_[dest].pgn;
+            echo::category("isobus.nmea.n2k_mgmt").warn("request timeout: PGN=", pgn, " dest=", dest);
+            release(dest);
+            on_request_timeout.emit(pgn, dest);
+        }
+
+        void release(Address dest) {
+            PendingSlot &slot = pending_[dest];
+            if (slot.scan)
+                --scan_pending_;
+            slot = PendingSlot{};
+            --pending_count_;
+            finish_scan();
+            // A scan throttled by scan_max_pending goes on with the next update
+            if (scanning_ && scan_timer_ == INVALID_TIMER && scan_next_ < scan_queue_.size())
+                arm_scan(0);
+        }
+
+        void arm_scan(u32 delay_ms) {
+            net_.timers().cancel(scan_timer_);
+            scan_timer_ = net_.timers().schedule(delay_ms, [this]() { pace_scan(); });
+        }
+
+        // One request per scan interval. With scan_max_pending unanswered the
+        // timer stays off, so no time is banked; release() restarts it.
+        void pace_scan() {
+            scan_timer_ = INVALID_TIMER; // One-shot, already spent
+            if (scanning_ && scan_next_ < scan_queue_.size() && scan_pending_ < config_.scan_max_pending) {
+                Address target = scan_queue_[scan_next_++];
+                // A device with a request of its own still outstanding is skipped
+                if (!has_pending_request_to(target))
+                    (void)request(scan_pgn_, target, true);
+                if (scan_next_ < scan_queue_.size())
+                    arm_scan(config_.scan_interval_ms);
+            }
+            finish_scan();
+        }
+
+        void finish_scan() {
+            if (scanning_ && scan_next_ >= scan_queue_.size() && scan_pending_ == 0) {
+                scanning_ = false;
+                scan_queue_.clear();
+                scan_next_ = 0;
+                echo::category("isobus.nmea.n2k_mgmt").debug("scan complete");
+                on_scan_complete.emit();
             }
         }
     };
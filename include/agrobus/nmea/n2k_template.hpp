@@ -0,0 +1,123 @@
+#pragma once
+
+#include "definitions.hpp"
+#include <agrobus/net/constants.hpp>
+#include <agrobus/net/frame.hpp>
+#include <agrobus/net/identifier.hpp>
+#include <agrobus/net/types.hpp>
+#include <datapod/datapod.hpp>
+#include <limits>
+#include <type_traits>
+
+namespace agrobus::nmea {
+    using namespace agrobus::net;
+
+    // Frames a payload of `size` bytes goes out in: one single frame, or fast
+    // packet with 6 bytes in the first frame and 7 in each one after
+    constexpr usize n2k_frame_count(usize size) noexcept {
+        return size <= CAN_DATA_LENGTH ? 1 : 1 + (size - 6 + 6) / 7;
+    }
+
+    // ─── N2K send template ──────────────────────────────────────────────────────
+    // A PGN that is sent over and over (GNSS at 10 Hz) kept pre-encoded as the
+    // CAN frames it goes out in. Setters write a field's bytes straight into
+    // the frame that carries them, so an unchanged field costs a compare and a
+    // changed one a few byte stores; nothing is built or segmented per send.
+    // Payloads over 8 bytes use the fast packet layout (first frame: sequence
+    // and length then 6 bytes, then 7 bytes per frame); the sequence counter is
+    // passed in by the sender so it stays shared with FastPacketProtocol.
+    class N2KSendTemplate {
+      public:
+        static constexpr usize MAX_FRAMES = n2k_frame_count(FAST_PACKET_MAX_DATA);
+
+      private:
+        PGN pgn_ = 0;
+        Priority priority_ = Priority::Default;
+        Address source_ = NULL_ADDRESS;
+        u8 size_ = 0;
+        u8 frame_count_ = 0;
+        dp::Array<Frame, MAX_FRAMES> frames_{};
+
+      public:
+        N2KSendTemplate() = default;
+
+        // All data bytes start as 0xFF (not available); `size` is clamped to the fast packet maximum
+        N2KSendTemplate(PGN pgn, usize size, Priority priority = Priority::Default)
+            : pgn_(pgn), priority_(priority),
+              size_(static_cast<u8>(size > FAST_PACKET_MAX_DATA ? FAST_PACKET_MAX_DATA : size)) {
+            frame_count_ = static_cast<u8>(n2k_frame_count(size_));
+            for (usize i = 0; i < frame_count_; ++i) {
+                frames_[i].data.fill(0xFF);
+                frames_[i].length = 8;
+            }
+            if (fast_packet())
+                frames_[0].data[1] = size_;
+            address(NULL_ADDRESS);
+        }
+
+        PGN pgn() const noexcept { return pgn_; }
+        usize size() const noexcept { return size_; }
+        usize frame_count() const noexcept { return frame_count_; }
+        bool fast_packet() const noexcept { return size_ > CAN_DATA_LENGTH; }
+
+        // ─── Field access (payload offsets, little endian) ───────────────────────
+        u8 &byte(usize offset) noexcept {
+            if (!fast_packet())
+                return frames_[0].data[offset];
+            if (offset < 6)
+                return frames_[0].data[offset + 2];
+            offset -= 6;
+            return frames_[1 + offset / 7].data[1 + offset % 7];
+        }
+        u8 byte(usize offset) const noexcept { return const_cast<N2KSendTemplate *>(this)->byte(offset); }
+
+        // Returns whether any byte changed
+        template <typename T> bool set(usize offset, T value) noexcept {
+            static_assert(std::is_integral_v<T> || std::is_enum_v<T>);
+            using I = typename std::conditional_t<std::is_enum_v<T>, std::underlying_type<T>,
+                                                  std::type_identity<T>>::type;
+            using U = std::make_unsigned_t<I>;
+            U raw = static_cast<U>(value);
+            bool changed = false;
+            for (usize i = 0; i < sizeof(U) && offset + i < size_; ++i) {
+                u8 b = static_cast<u8>(raw >> (8 * i));
+                u8 &slot = byte(offset + i);
+                if (slot != b) {
+                    slot = b;
+                    changed = true;
+                }
+            }
+            return changed;
+        }
+
+        // Scaled value, or the type's "not available" pattern when absent
+        template <typename T> bool set_scaled(usize offset, const dp::Optional<f64> &value, f64 resolution) noexcept {
+            if (!value)
+                return set(offset, std::numeric_limits<T>::max());
+            return set(offset, static_cast<T>(*value / resolution));
+        }
+
+        // ─── Frames ──────────────────────────────────────────────────────────────
+        // Stamp the source address (when it changed) and, for fast packet, the
+        // sequence counter; the frames are then ready to send as they are
+        const Frame *frames(Address source, u8 sequence = 0) noexcept {
+            if (source != source_)
+                address(source);
+            if (fast_packet()) {
+                u8 seq = static_cast<u8>((sequence & 0x07) << 5);
+                for (usize i = 0; i < frame_count_; ++i)
+                    frames_[i].data[0] = static_cast<u8>(seq | i);
+            }
+            return frames_.data();
+        }
+
+      private:
+        void address(Address source) noexcept {
+            source_ = source;
+            Identifier id = Identifier::encode(priority_, pgn_, source, BROADCAST_ADDRESS);
+            for (usize i = 0; i < frame_count_; ++i)
+                frames_[i].id = id;
+        }
+    };
+
+} // namespace agrobus::nmea
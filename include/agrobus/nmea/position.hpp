@@ -1,6 +1,7 @@
 #pragma once
 
 #include "definitions.hpp"
+#include "geo_kernels.hpp"
 #include <agrobus/net/types.hpp>
 #include <concord/concord.hpp>
 #include <datapod/datapod.hpp>
@@ -71,6 +72,52 @@ namespace agrobus::nmea {
             }
             return results;
         }
+
+        // ─── Kernel-backed conversions into caller buffers ────────────────────────
+        // Each output array holds positions.size() values. The batch runs
+        // through the geo_kernels.hpp SIMD kernels; `threads` > 1 (0 = one per
+        // core) splits a long log across cores.
+        void to_ecf_batch(f64 *x, f64 *y, f64 *z) const {
+            for_chunks(0, positions.size(), [&](usize base, usize m, const f64 *lat, const f64 *lon, const f64 *alt) {
+                wgs_to_ecef(lat, lon, alt, m, x + base, y + base, z + base);
+            });
+        }
+
+        void to_enu_batch(const dp::Geo &ref, f64 *east, f64 *north, f64 *up, u32 threads = 1) const {
+            LocalFrame frame = LocalFrame::at(ref);
+            geo_detail::parallel_ranges(positions.size(), threads, [&](usize begin, usize end) {
+                for_chunks(begin, end, [&](usize base, usize m, const f64 *lat, const f64 *lon, const f64 *alt) {
+                    wgs_to_enu(frame, lat, lon, alt, m, east + base, north + base, up + base);
+                });
+            });
+        }
+
+        void to_ned_batch(const dp::Geo &ref, f64 *north, f64 *east, f64 *down, u32 threads = 1) const {
+            LocalFrame frame = LocalFrame::at(ref);
+            geo_detail::parallel_ranges(positions.size(), threads, [&](usize begin, usize end) {
+                for_chunks(begin, end, [&](usize base, usize m, const f64 *lat, const f64 *lon, const f64 *alt) {
+                    wgs_to_enu(frame, lat, lon, alt, m, east + base, north + base, down + base);
+                    for (usize i = 0; i < m; ++i)
+                        down[base + i] = -down[base + i];
+                });
+            });
+        }
+
+      private:
+        // Gathers [begin, end) into structure-of-arrays chunks for the kernels
+        template <typename Fn> void for_chunks(usize begin, usize end, Fn &&fn) const {
+            std::array<f64, GEO_KERNEL_CHUNK> lat, lon, alt;
+            for (usize base = begin; base < end; base += GEO_KERNEL_CHUNK) {
+                usize m = end - base < GEO_KERNEL_CHUNK ? end - base : GEO_KERNEL_CHUNK;
+                for (usize i = 0; i < m; ++i) {
+                    const auto &w = positions[base + i].wgs;
+                    lat[i] = w.latitude;
+                    lon[i] = w.longitude;
+                    alt[i] = w.altitude;
+                }
+                fn(base, m, lat.data(), lon.data(), alt.data());
+            }
+        }
     };
 
 } // namespace agrobus::nmea
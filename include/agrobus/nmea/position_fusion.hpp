@@ -0,0 +1,226 @@
+#pragma once
+
+#include "geo_kernels.hpp"
+#include "position.hpp"
+#include <agrobus/net/types.hpp>
+#include <cmath>
+#include <datapod/datapod.hpp>
+
+namespace agrobus::nmea {
+    using namespace agrobus::net;
+
+    // ─── Position fusion configuration ──────────────────────────────────────────
+    struct PositionFusionConfig {
+        u64 max_extrapolation_us = 500000; // Queries further past the newest fix have no answer
+        u64 max_motion_age_us = 1000000;   // Older COG/SOG/heading/yaw rate is not extrapolated with
+
+        PositionFusionConfig &max_extrapolation(u32 ms) {
+            max_extrapolation_us = static_cast<u64>(ms) * 1000;
+            return *this;
+        }
+        PositionFusionConfig &max_motion_age(u32 ms) {
+            max_motion_age_us = static_cast<u64>(ms) * 1000;
+            return *this;
+        }
+    };
+
+    // ─── Latency-compensated position ───────────────────────────────────────────
+    // Position fixes and motion (course, speed, heading, yaw rate) arrive in
+    // separate messages at different rates, each stamped with its receive
+    // time. Fixes go into a small ring together with the motion in effect
+    // when they arrived; position_at(t) interpolates between the two fixes
+    // around `t`, or projects the newest fix forward along a constant turn
+    // rate arc with the latest motion. The ring is a fixed size, so a query
+    // costs the same however long the fusion has run.
+    class PositionFusion {
+      public:
+        static constexpr usize HISTORY = 16;
+
+      private:
+        struct Motion {
+            f64 value = 0.0;
+            u64 at_us = 0;
+            bool valid = false;
+        };
+
+        PositionFusionConfig config_;
+        dp::Array<GNSSPosition, HISTORY> ring_{};
+        usize head_ = 0; // Next slot to write
+        usize count_ = 0;
+        Motion cog_, sog_, heading_, yaw_rate_;
+
+      public:
+        explicit PositionFusion(PositionFusionConfig config = {}) : config_(config) {}
+
+        // ─── Inputs (receive time in microseconds) ───────────────────────────────
+        // A fix; its own course/speed/heading/yaw rate count as motion updates
+        void add_fix(const GNSSPosition &pos) {
+            u64 t = pos.timestamp_us;
+            if (count_ > 0 && t < newest().timestamp_us)
+                return; // Out of order
+            if (pos.cog_rad)
+                set(cog_, *pos.cog_rad, t);
+            if (pos.speed_mps)
+                set(sog_, *pos.speed_mps, t);
+            if (pos.heading_rad)
+                set(heading_, *pos.heading_rad, t);
+            if (pos.rate_of_turn_rps)
+                set(yaw_rate_, *pos.rate_of_turn_rps, t);
+
+            GNSSPosition &slot = ring_[head_];
+            slot = pos;
+            slot.cog_rad = current(cog_, t);
+            slot.speed_mps = current(sog_, t);
+            slot.heading_rad = current(heading_, t);
+            slot.rate_of_turn_rps = current(yaw_rate_, t);
+            head_ = (head_ + 1) % HISTORY;
+            if (count_ < HISTORY)
+                ++count_;
+        }
+
+        void add_course(f64 cog_rad, u64 t_us) { set(cog_, cog_rad, t_us); }
+        void add_speed(f64 sog_mps, u64 t_us) { set(sog_, sog_mps, t_us); }
+        void add_heading(f64 heading_rad, u64 t_us) { set(heading_, heading_rad, t_us); }
+        void add_yaw_rate(f64 rate_rps, u64 t_us) { set(yaw_rate_, rate_rps, t_us); }
+
+        void clear() {
+            count_ = head_ = 0;
+            cog_ = sog_ = heading_ = yaw_rate_ = Motion{};
+        }
+
+        // ─── Queries ─────────────────────────────────────────────────────────────
+        usize size() const noexcept { return count_; }
+        bool empty() const noexcept { return count_ == 0; }
+
+        dp::Optional<GNSSPosition> latest() const {
+            if (empty())
+                return dp::nullopt;
+            return newest();
+        }
+
+        // Position at `t_us`: nullopt before the oldest kept fix or further
+        // than max_extrapolation past the newest. timestamp_us of the result is `t_us`.
+        dp::Optional<GNSSPosition> position_at(u64 t_us) const {
+            if (empty())
+                return dp::nullopt;
+            const GNSSPosition &last = newest();
+            if (t_us >= last.timestamp_us) {
+                if (t_us - last.timestamp_us > config_.max_extrapolation_us)
+                    return dp::nullopt;
+                return extrapolate(last, t_us);
+            }
+            // Newest to oldest: the first fix at or before t_us and the one after it
+            for (usize i = 1; i < count_; ++i) {
+                const GNSSPosition &before = at(i);
+                if (before.timestamp_us <= t_us)
+                    return interpolate(before, at(i - 1), t_us);
+            }
+            return dp::nullopt;
+        }
+
+      private:
+        static void set(Motion &m, f64 value, u64 t_us) {
+            if (m.valid && t_us < m.at_us)
+                return;
+            m = Motion{value, t_us, true};
+        }
+
+        dp::Optional<f64> current(const Motion &m, u64 t_us) const {
+            if (!m.valid || (t_us > m.at_us && t_us - m.at_us > config_.max_motion_age_us))
+                return dp::nullopt;
+            return m.value;
+        }
+
+        // Signed time from `from_us` to `to_us`
+        static f64 seconds(u64 from_us, u64 to_us) {
+            return (static_cast<f64>(to_us) - static_cast<f64>(from_us)) * 1e-6;
+        }
+
+        // i-th newest fix, 0 = newest
+        const GNSSPosition &at(usize i) const { return ring_[(head_ + HISTORY - 1 - i) % HISTORY]; }
+        const GNSSPosition &newest() const { return at(0); }
+
+        static f64 wrap_angle(f64 a) {
+            a = std::fmod(a, 2.0 * M_PI);
+            return a < 0.0 ? a + 2.0 * M_PI : a;
+        }
+
+        // Shortest way from a to b
+        static f64 angle_delta(f64 a, f64 b) {
+            f64 d = std::fmod(b - a + M_PI, 2.0 * M_PI);
+            return (d < 0.0 ? d + 2.0 * M_PI : d) - M_PI;
+        }
+
+        static dp::Optional<f64> lerp_angle(const dp::Optional<f64> &a, const dp::Optional<f64> &b, f64 k) {
+            if (a && b)
+                return wrap_angle(*a + angle_delta(*a, *b) * k);
+            return b ? b : a;
+        }
+
+        static GNSSPosition interpolate(const GNSSPosition &a, const GNSSPosition &b, u64 t_us) {
+            f64 span = static_cast<f64>(b.timestamp_us - a.timestamp_us);
+            f64 k = span > 0.0 ? static_cast<f64>(t_us - a.timestamp_us) / span : 1.0;
+            GNSSPosition out = k < 0.5 ? a : b;
+            out.wgs = concord::earth::WGS(a.wgs.latitude + (b.wgs.latitude - a.wgs.latitude) * k,
+                                          a.wgs.longitude + (b.wgs.longitude - a.wgs.longitude) * k,
+                                          a.wgs.altitude + (b.wgs.altitude - a.wgs.altitude) * k);
+            out.cog_rad = lerp_angle(a.cog_rad, b.cog_rad, k);
+            out.heading_rad = lerp_angle(a.heading_rad, b.heading_rad, k);
+            if (a.speed_mps && b.speed_mps)
+                out.speed_mps = *a.speed_mps + (*b.speed_mps - *a.speed_mps) * k;
+            out.timestamp_us = t_us;
+            return out;
+        }
+
+        // Yaw rate as reported, else from the course change over the last two fixes
+        f64 yaw_rate(u64 t_us) const {
+            if (auto rate = current(yaw_rate_, t_us))
+                return *rate;
+            if (count_ < 2 || !at(0).cog_rad || !at(1).cog_rad)
+                return 0.0;
+            f64 dt = static_cast<f64>(at(0).timestamp_us - at(1).timestamp_us) * 1e-6;
+            return dt > 0.0 ? angle_delta(*at(1).cog_rad, *at(0).cog_rad) / dt : 0.0;
+        }
+
+        GNSSPosition extrapolate(const GNSSPosition &last, u64 t_us) const {
+            GNSSPosition out = last;
+            out.timestamp_us = t_us;
+            f64 dt = static_cast<f64>(t_us - last.timestamp_us) * 1e-6;
+            f64 rate = yaw_rate(t_us);
+            if (auto heading = current(heading_, t_us))
+                out.heading_rad = wrap_angle(*heading + rate * seconds(heading_.at_us, t_us));
+            // Course over ground, else heading for a vehicle without crab
+            const Motion &course = current(cog_, t_us) ? cog_ : heading_;
+            auto speed = current(sog_, t_us);
+            if (!current(course, t_us) || !speed || dt <= 0.0)
+                return out;
+
+            // Constant turn rate and speed from the fix, with the course turned to the fix time
+            f64 c0 = course.value + rate * seconds(course.at_us, last.timestamp_us);
+            f64 c1 = c0 + rate * dt;
+            f64 north, east;
+            if (std::abs(rate) < 1e-6) {
+                north = *speed * dt * std::cos(c0);
+                east = *speed * dt * std::sin(c0);
+            } else {
+                north = *speed / rate * (std::sin(c1) - std::sin(c0));
+                east = *speed / rate * (std::cos(c0) - std::cos(c1));
+            }
+
+            // Metres to degrees with the WGS84 radii of curvature at the fix
+            f64 lat = last.wgs.latitude * M_PI / 180.0;
+            f64 s = std::sin(lat);
+            f64 w = 1.0 - WGS84_E2 * s * s;
+            f64 prime = WGS84_A / std::sqrt(w);
+            f64 meridian = prime * (1.0 - WGS84_E2) / w;
+            out.wgs = concord::earth::WGS(last.wgs.latitude + north / meridian * 180.0 / M_PI,
+                                          last.wgs.longitude + east / (prime * std::cos(lat)) * 180.0 / M_PI,
+                                          last.wgs.altitude);
+            out.cog_rad = wrap_angle(c1);
+            out.speed_mps = *speed;
+            out.rate_of_turn_rps = rate;
+            return out;
+        }
+    };
+
+} // namespace agrobus::nmea
@@ -0,0 +1,243 @@
+#pragma once
+
+#include <agrobus/net/types.hpp>
+#include <bit>
+#include <charconv>
+#include <cstring>
+#include <datapod/datapod.hpp>
+#include <echo/echo.hpp>
+#include <string_view>
+
+#if !defined(AGROBUS_SIMD_DISABLED) && defined(__AVX2__)
+#include <immintrin.h>
+#define AGROBUS_NMEA_AVX2 1
+#elif !defined(AGROBUS_SIMD_DISABLED) && defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define AGROBUS_NMEA_NEON 1
+#endif
+
+namespace agrobus::nmea {
+    using namespace agrobus::net;
+
+    // ─── NMEA-0183 sentence framing ─────────────────────────────────────────────
+    // Standard sentences are at most 82 characters; proprietary ones run longer.
+    inline constexpr usize NMEA_MAX_SENTENCE = 128;
+    inline constexpr usize NMEA_MAX_FIELDS = 40;
+
+    namespace sentence_detail {
+        inline u64 load8(const char *p) noexcept {
+            u64 v;
+            std::memcpy(&v, p, sizeof(v));
+            return v;
+        }
+
+        // Non-zero when any byte of `v` equals `c` (high bit set in that lane)
+        inline u64 has_byte(u64 v, u8 c) noexcept {
+            u64 x = v ^ (0x0101010101010101ULL * c);
+            return (x - 0x0101010101010101ULL) & ~x & 0x8080808080808080ULL;
+        }
+    } // namespace sentence_detail
+
+    // Position of the first CR or LF in [p, p + n), or n. A serial read hands
+    // over several sentences at once: 32 bytes are tested per step with AVX2
+    // (16 with NEON) unless the build sets AGROBUS_SIMD_DISABLED, then eight
+    // per word, and the matching word is walked byte by byte.
+    inline usize find_line_end(const char *p, usize n) noexcept {
+        usize i = 0;
+#if defined(AGROBUS_NMEA_AVX2)
+        const __m256i lf = _mm256_set1_epi8('\n');
+        const __m256i cr = _mm256_set1_epi8('\r');
+        for (; i + 32 <= n; i += 32) {
+            __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p + i));
+            u32 mask = static_cast<u32>(
+                _mm256_movemask_epi8(_mm256_or_si256(_mm256_cmpeq_epi8(v, lf), _mm256_cmpeq_epi8(v, cr))));
+            if (mask != 0)
+                return i + static_cast<usize>(std::countr_zero(mask));
+        }
+#elif defined(AGROBUS_NMEA_NEON)
+        const uint8x16_t lf = vdupq_n_u8('\n');
+        const uint8x16_t cr = vdupq_n_u8('\r');
+        for (; i + 16 <= n; i += 16) {
+            uint8x16_t v = vld1q_u8(reinterpret_cast<const u8 *>(p + i));
+            if (vmaxvq_u8(vorrq_u8(vceqq_u8(v, lf), vceqq_u8(v, cr))) != 0)
+                break;
+        }
+#endif
+        for (; i + 8 <= n; i += 8) {
+            u64 v = sentence_detail::load8(p + i);
+            if (sentence_detail::has_byte(v, '\n') | sentence_detail::has_byte(v, '\r'))
+                break;
+        }
+        for (; i < n; ++i)
+            if (p[i] == '\n' || p[i] == '\r')
+                return i;
+        return n;
+    }
+
+    // XOR of all bytes, 32 at a time with AVX2 (16 with NEON), then folded
+    // eight at a time
+    inline u8 nmea_checksum(std::string_view s) noexcept {
+        const char *p = s.data();
+        usize n = s.size();
+        u64 acc = 0;
+        usize i = 0;
+#if defined(AGROBUS_NMEA_AVX2)
+        if (n >= 32) {
+            __m256i x = _mm256_setzero_si256();
+            for (; i + 32 <= n; i += 32)
+                x = _mm256_xor_si256(x, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p + i)));
+            __m128i h = _mm_xor_si128(_mm256_castsi256_si128(x), _mm256_extracti128_si256(x, 1));
+            acc = static_cast<u64>(_mm_cvtsi128_si64(h)) ^ static_cast<u64>(_mm_extract_epi64(h, 1));
+        }
+#elif defined(AGROBUS_NMEA_NEON)
+        if (n >= 16) {
+            uint8x16_t x = vdupq_n_u8(0);
+            for (; i + 16 <= n; i += 16)
+                x = veorq_u8(x, vld1q_u8(reinterpret_cast<const u8 *>(p + i)));
+            uint64x2_t h = vreinterpretq_u64_u8(x);
+            acc = vgetq_lane_u64(h, 0) ^ vgetq_lane_u64(h, 1);
+        }
+#endif
+        for (; i + 8 <= n; i += 8)
+            acc ^= sentence_detail::load8(p + i);
+        acc ^= acc >> 32;
+        acc ^= acc >> 16;
+        acc ^= acc >> 8;
+        u8 sum = static_cast<u8>(acc);
+        for (; i < n; ++i)
+            sum ^= static_cast<u8>(p[i]);
+        return sum;
+    }
+
+    // ─── Field parsing ──────────────────────────────────────────────────────────
+    // Empty or malformed fields leave `out` untouched and return false.
+    inline bool parse_field(std::string_view field, f64 &out) noexcept {
+        if (field.empty())
+            return false;
+        f64 v;
+        auto [end, ec] = std::from_chars(field.data(), field.data() + field.size(), v);
+        if (ec != std::errc{})
+            return false;
+        out = v;
+        return true;
+    }
+
+    inline bool parse_field(std::string_view field, u32 &out) noexcept {
+        if (field.empty())
+            return false;
+        u32 v;
+        auto [end, ec] = std::from_chars(field.data(), field.data() + field.size(), v);
+        if (ec != std::errc{})
+            return false;
+        out = v;
+        return true;
+    }
+
+    // ─── Tokenized sentence ─────────────────────────────────────────────────────
+    // Views into the reader's line buffer: valid until the next feed().
+    // Field 0 is the address ("GPGGA"); fields past the end read as empty.
+    class NMEASentence {
+        dp::Array<std::string_view, NMEA_MAX_FIELDS> fields_{};
+        usize count_ = 0;
+
+      public:
+        // `body` is the text between '$' and '*'
+        explicit NMEASentence(std::string_view body) noexcept {
+            usize start = 0;
+            while (count_ < NMEA_MAX_FIELDS) {
+                usize comma = body.find(',', start);
+                if (comma == std::string_view::npos) {
+                    fields_[count_++] = body.substr(start);
+                    break;
+                }
+                fields_[count_++] = body.substr(start, comma - start);
+                start = comma + 1;
+            }
+        }
+
+        usize size() const noexcept { return count_; }
+        std::string_view operator[](usize i) const noexcept { return i < count_ ? fields_[i] : std::string_view{}; }
+
+        // Sentence formatter without the two-letter talker ID ("GGA")
+        std::string_view type() const noexcept {
+            std::string_view addr = fields_[0];
+            return addr.size() == 5 ? addr.substr(2) : std::string_view{};
+        }
+        std::string_view talker() const noexcept { return fields_[0].substr(0, 2); }
+    };
+
+    // ─── Line reader ────────────────────────────────────────────────────────────
+    // Frames sentences out of a byte stream into a fixed buffer and hands each
+    // checksum-verified one to the callback. Nothing allocates; a line longer
+    // than NMEA_MAX_SENTENCE is dropped up to its terminator.
+    class NMEALineReader {
+        dp::Array<char, NMEA_MAX_SENTENCE> line_{};
+        usize len_ = 0;
+        bool overflow_ = false;
+        u32 sentences_ = 0;
+        u32 checksum_errors_ = 0;
+        u32 overflows_ = 0;
+
+      public:
+        template <typename Fn> void feed(const u8 *data, usize size, Fn &&on_sentence) {
+            const char *p = reinterpret_cast<const char *>(data);
+            while (size > 0) {
+                usize n = find_line_end(p, size);
+                append(p, n);
+                if (n == size)
+                    return;
+                finish_line(on_sentence);
+                p += n + 1;
+                size -= n + 1;
+            }
+        }
+
+        void reset() noexcept {
+            len_ = 0;
+            overflow_ = false;
+        }
+
+        u32 sentences() const noexcept { return sentences_; }
+        u32 checksum_errors() const noexcept { return checksum_errors_; }
+        u32 overflows() const noexcept { return overflows_; }
+
+      private:
+        void append(const char *p, usize n) noexcept {
+            if (overflow_)
+                return;
+            if (len_ + n > line_.size()) {
+                overflow_ = true;
+                ++overflows_;
+                return;
+            }
+            std::memcpy(line_.data() + len_, p, n);
+            len_ += n;
+        }
+
+        template <typename Fn> void finish_line(Fn &on_sentence) {
+            std::string_view line(line_.data(), len_);
+            bool dropped = overflow_;
+            reset();
+            if (dropped || line.size() < 6 || line[0] != '$')
+                return;
+
+            std::string_view body = line.substr(1);
+            usize star = body.find('*');
+            if (star != std::string_view::npos) {
+                if (star + 2 < body.size()) {
+                    u32 expected = 0;
+                    auto [end, ec] = std::from_chars(body.data() + star + 1, body.data() + star + 3, expected, 16);
+                    if (ec != std::errc{} || nmea_checksum(body.substr(0, star)) != expected) {
+                        ++checksum_errors_;
+                        echo::category("isobus.nmea.serial").warn("Checksum mismatch: ", dp::String(line));
+                        return;
+                    }
+                }
+                body = body.substr(0, star);
+            }
+            ++sentences_;
+            on_sentence(NMEASentence(body));
+        }
+    };
+
+} // namespace agrobus::nmea
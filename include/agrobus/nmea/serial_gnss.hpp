@@ -1,13 +1,14 @@
 #pragma once
 
 #include "definitions.hpp"
+#include "gnss_binary.hpp"
 #include "position.hpp"
+#include "sentence.hpp"
 #include <agrobus/net/error.hpp>
 #include <agrobus/net/event.hpp>
 #include <agrobus/net/types.hpp>
+#include <cmath>
 #include <concord/concord.hpp>
-#include <cstdlib>
-#include <cstring>
 #include <datapod/datapod.hpp>
 #include <echo/echo.hpp>
 #include <wirebit/serial/serial_endpoint.hpp>
@@ -42,10 +43,15 @@ namespace agrobus::nmea {
 
     // ─── Serial GNSS Interface ──────────────────────────────────────────────────
     // Reads NMEA-0183 sentences from a wirebit::SerialEndpoint (UART/PTY) and
-    // parses them into GNSSPosition updates.
+    // parses them into GNSSPosition updates. Sentences are framed in a fixed
+    // buffer and tokenized in place, so steady-state parsing does not allocate.
     //
     // Supported sentences: $GxGGA, $GxRMC, $GxVTG, $GxGSA
     //
+    // Binary frames on the same port are told apart by their sync byte: UBX
+    // NAV-PVT and NAV-DOP fill the position directly, and RTCM3 frames pass
+    // through on on_rtcm (e.g. to forward corrections or log them).
+    //
     // Usage:
     //   auto pty = wirebit::PtyLink::create();
     //   auto link = std::make_shared<wirebit::PtyLink>(std::move(pty.value()));
@@ -55,7 +61,8 @@ namespace agrobus::nmea {
     //   gnss.update(); // call periodically
     class SerialGNSS {
         wirebit::SerialEndpoint &serial_;
-        dp::String line_buffer_;
+        NMEALineReader reader_;
+        GNSSBinaryReader binary_;
         GNSSPosition latest_;
 
       public:
@@ -66,18 +73,31 @@ namespace agrobus::nmea {
             auto result = serial_.recv();
             if (!result.is_ok())
                 return;
+            feed(result.value().data(), result.value().size());
+        }
 
-            auto &data = result.value();
-            for (usize i = 0; i < data.size(); ++i) {
-                char c = static_cast<char>(data[i]);
-                if (c == '\n' || c == '\r') {
-                    if (!line_buffer_.empty()) {
-                        parse_sentence(line_buffer_);
-                        line_buffer_.clear();
-                    }
-                } else {
-                    line_buffer_ += c;
+        // Parses raw receiver bytes; sentences and frames may span calls
+        void feed(const u8 *data, usize size) {
+            auto on_sentence = [this](const NMEASentence &s) { parse_sentence(s); };
+            auto on_frame = [this](GNSSBinaryProtocol protocol, const u8 *frame, usize len) {
+                parse_frame(protocol, frame, len);
+            };
+            usize i = 0;
+            while (i < size) {
+                if (!binary_.active()) {
+                    usize text = i;
+                    while (text < size && data[text] < 0x80)
+                        ++text;
+                    if (text > i)
+                        reader_.feed(data + i, text - i, on_sentence);
+                    i = text;
+                    if (i == size)
+                        return;
                 }
+                usize used = binary_.feed(data + i, size - i, on_frame);
+                if (used == 0 && !binary_.active() && !GNSSBinaryReader::is_sync(data[i]) && data[i] >= 0x80)
+                    used = 1; // Line noise
+                i += used;
             }
         }
 
@@ -87,103 +107,84 @@ namespace agrobus::nmea {
             return dp::nullopt;
         }
 
+        const NMEALineReader &reader() const noexcept { return reader_; }
+        const GNSSBinaryReader &binary_reader() const noexcept { return binary_; }
+
         // Events
         Event<const GNSSPosition &> on_position;
         Event<f64> on_cog; // Course over ground (radians)
         Event<f64> on_sog; // Speed over ground (m/s)
+        Event<const u8 *, usize> on_rtcm; // Whole RTCM3 frame, valid during the call
 
       private:
-        void parse_sentence(const dp::String &sentence) {
-            if (sentence.size() < 6 || sentence[0] != '$')
-                return;
-
-            // Verify checksum if present
-            auto star = sentence.find('*');
-            if (star != dp::String::npos && star + 2 < sentence.size()) {
-                u8 computed = 0;
-                for (usize i = 1; i < star; ++i)
-                    computed ^= static_cast<u8>(sentence[i]);
-                u8 expected = static_cast<u8>(std::strtol(sentence.c_str() + star + 1, nullptr, 16));
-                if (computed != expected) {
-                    echo::category("isobus.nmea.serial").warn("Checksum mismatch: ", sentence);
-                    return;
-                }
-            }
-
-            // Extract sentence type (skip talker ID: $GP, $GN, $GL, etc.)
-            dp::String type = sentence.substr(3, 3);
+        void parse_sentence(const NMEASentence &s) {
+            // Sentence type without the talker ID ($GP, $GN, $GL, etc.)
+            std::string_view type = s.type();
 
             if (type == "GGA")
-                parse_gga(sentence);
+                parse_gga(s);
             else if (type == "RMC")
-                parse_rmc(sentence);
+                parse_rmc(s);
             else if (type == "VTG")
-                parse_vtg(sentence);
+                parse_vtg(s);
             else if (type == "GSA")
-                parse_gsa(sentence);
+                parse_gsa(s);
         }
 
-        // Split NMEA sentence into fields
-        static dp::Vector<dp::String> split_fields(const dp::String &sentence) {
-            dp::Vector<dp::String> fields;
-            dp::String current;
-            for (usize i = 0; i < sentence.size(); ++i) {
-                char c = sentence[i];
-                if (c == ',' || c == '*') {
-                    fields.push_back(current);
-                    current.clear();
-                    if (c == '*')
-                        break;
-                } else {
-                    current += c;
-                }
+        void parse_frame(GNSSBinaryProtocol protocol, const u8 *frame, usize len) {
+            if (protocol == GNSSBinaryProtocol::RTCM3) {
+                on_rtcm.emit(frame, len);
+                return;
+            }
+            const u8 *payload = frame + 6;
+            usize size = len - 8;
+            if (frame[2] != UBX_CLASS_NAV)
+                return;
+            if (frame[3] == UBX_NAV_DOP) {
+                decode_ubx_nav_dop(payload, size, latest_);
+            } else if (frame[3] == UBX_NAV_PVT && decode_ubx_nav_pvt(payload, size, latest_) && latest_.has_fix()) {
+                on_position.emit(latest_);
+                on_sog.emit(*latest_.speed_mps);
+                on_cog.emit(*latest_.cog_rad);
+                echo::category("isobus.nmea.serial")
+                    .trace("NAV-PVT: ", latest_.wgs.latitude, ", ", latest_.wgs.longitude,
+                           " sats=", latest_.satellites_used);
             }
-            if (!current.empty())
-                fields.push_back(current);
-            return fields;
         }
 
-        static f64 parse_lat(const dp::String &value, const dp::String &dir) {
-            if (value.empty())
+        // Format: DDMM.MMMMM (latitude) or DDDMM.MMMMM (longitude)
+        static f64 parse_coordinate(std::string_view value, std::string_view dir, char negative) {
+            f64 raw = 0.0;
+            if (!parse_field(value, raw))
                 return 0.0;
-            // Format: DDMM.MMMMM
-            f64 raw = std::atof(value.c_str());
             i32 degrees = static_cast<i32>(raw / 100.0);
             f64 minutes = raw - (degrees * 100.0);
             f64 result = degrees + minutes / 60.0;
-            if (dir == "S")
+            if (dir.size() == 1 && dir[0] == negative)
                 result = -result;
             return result;
         }
 
-        static f64 parse_lon(const dp::String &value, const dp::String &dir) {
-            if (value.empty())
-                return 0.0;
-            // Format: DDDMM.MMMMM
-            f64 raw = std::atof(value.c_str());
-            i32 degrees = static_cast<i32>(raw / 100.0);
-            f64 minutes = raw - (degrees * 100.0);
-            f64 result = degrees + minutes / 60.0;
-            if (dir == "W")
-                result = -result;
-            return result;
-        }
+        static f64 parse_lat(std::string_view value, std::string_view dir) { return parse_coordinate(value, dir, 'S'); }
+        static f64 parse_lon(std::string_view value, std::string_view dir) { return parse_coordinate(value, dir, 'W'); }
 
         // $GxGGA - Global Positioning System Fix Data
-        void parse_gga(const dp::String &sentence) {
-            auto fields = split_fields(sentence);
+        void parse_gga(const NMEASentence &fields) {
             if (fields.size() < 15)
                 return;
 
             // Field 6: Fix quality
-            u8 quality = fields[6].empty() ? 0 : static_cast<u8>(std::atoi(fields[6].c_str()));
+            u32 quality = 0;
+            parse_field(fields[6], quality);
             if (quality == 0) {
                 latest_.fix_type = GNSSFixType::NoFix;
                 return;
             }
 
-            latest_.wgs = concord::earth::WGS(parse_lat(fields[2], fields[3]), parse_lon(fields[4], fields[5]),
-                                              fields[9].empty() ? 0.0 : std::atof(fields[9].c_str()));
+            f64 altitude = 0.0;
+            parse_field(fields[9], altitude);
+            latest_.wgs =
+                concord::earth::WGS(parse_lat(fields[2], fields[3]), parse_lon(fields[4], fields[5]), altitude);
 
             switch (quality) {
             case 1:
@@ -203,11 +204,14 @@ namespace agrobus::nmea {
                 break;
             }
 
-            latest_.satellites_used = fields[7].empty() ? 0 : static_cast<u8>(std::atoi(fields[7].c_str()));
-            if (!fields[8].empty())
-                latest_.hdop = std::atof(fields[8].c_str());
-            if (!fields[11].empty())
-                latest_.geoidal_separation_m = std::atof(fields[11].c_str());
+            u32 satellites = 0;
+            parse_field(fields[7], satellites);
+            latest_.satellites_used = static_cast<u8>(satellites);
+            f64 value = 0.0;
+            if (parse_field(fields[8], value))
+                latest_.hdop = value;
+            if (parse_field(fields[11], value))
+                latest_.geoidal_separation_m = value;
 
             on_position.emit(latest_);
             echo::category("isobus.nmea.serial")
@@ -216,8 +220,7 @@ namespace agrobus::nmea {
         }
 
         // $GxRMC - Recommended Minimum Navigation Information
-        void parse_rmc(const dp::String &sentence) {
-            auto fields = split_fields(sentence);
+        void parse_rmc(const NMEASentence &fields) {
             if (fields.size() < 12)
                 return;
 
@@ -229,15 +232,15 @@ namespace agrobus::nmea {
                                               latest_.wgs.altitude);
 
             // Speed over ground (knots -> m/s)
-            if (!fields[7].empty()) {
-                f64 speed_knots = std::atof(fields[7].c_str());
+            f64 speed_knots = 0.0;
+            if (parse_field(fields[7], speed_knots)) {
                 latest_.speed_mps = speed_knots * 0.514444;
                 on_sog.emit(*latest_.speed_mps);
             }
 
             // Course over ground (degrees -> radians)
-            if (!fields[8].empty()) {
-                f64 cog_deg = std::atof(fields[8].c_str());
+            f64 cog_deg = 0.0;
+            if (parse_field(fields[8], cog_deg)) {
                 latest_.cog_rad = cog_deg * M_PI / 180.0;
                 on_cog.emit(*latest_.cog_rad);
             }
@@ -250,46 +253,46 @@ namespace agrobus::nmea {
         }
 
         // $GxVTG - Track Made Good and Ground Speed
-        void parse_vtg(const dp::String &sentence) {
-            auto fields = split_fields(sentence);
+        void parse_vtg(const NMEASentence &fields) {
             if (fields.size() < 9)
                 return;
 
             // True track (degrees -> radians)
-            if (!fields[1].empty()) {
-                f64 track_deg = std::atof(fields[1].c_str());
+            f64 track_deg = 0.0;
+            if (parse_field(fields[1], track_deg)) {
                 latest_.cog_rad = track_deg * M_PI / 180.0;
                 on_cog.emit(*latest_.cog_rad);
             }
 
             // Speed in km/h -> m/s
-            if (!fields[7].empty()) {
-                f64 speed_kmh = std::atof(fields[7].c_str());
+            f64 speed_kmh = 0.0;
+            if (parse_field(fields[7], speed_kmh)) {
                 latest_.speed_mps = speed_kmh / 3.6;
                 on_sog.emit(*latest_.speed_mps);
             }
         }
 
         // $GxGSA - GNSS DOP and Active Satellites
-        void parse_gsa(const dp::String &sentence) {
-            auto fields = split_fields(sentence);
+        void parse_gsa(const NMEASentence &fields) {
             if (fields.size() < 18)
                 return;
 
             // Field 2: Fix type (1=no fix, 2=2D, 3=3D)
-            u8 fix = fields[2].empty() ? 1 : static_cast<u8>(std::atoi(fields[2].c_str()));
+            u32 fix = 1;
+            parse_field(fields[2], fix);
             if (fix == 1) {
                 latest_.fix_type = GNSSFixType::NoFix;
             } else if (fix >= 2 && latest_.fix_type == GNSSFixType::NoFix) {
                 latest_.fix_type = GNSSFixType::GNSSFix;
             }
 
-            if (!fields[15].empty())
-                latest_.pdop = std::atof(fields[15].c_str());
-            if (!fields[16].empty())
-                latest_.hdop = std::atof(fields[16].c_str());
-            if (!fields[17].empty())
-                latest_.vdop = std::atof(fields[17].c_str());
+            f64 value = 0.0;
+            if (parse_field(fields[15], value))
+                latest_.pdop = value;
+            if (parse_field(fields[16], value))
+                latest_.hdop = value;
+            if (parse_field(fields[17], value))
+                latest_.vdop = value;
         }
     };
 
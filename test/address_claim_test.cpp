@@ -2,6 +2,8 @@
 #include <agrobus/net/address_claimer.hpp>
 #include <agrobus/net/internal_cf.hpp>
 #include <agrobus/net/constants.hpp>
+#include <agrobus/net/loopback_bus.hpp>
+#include <agrobus/net/network_manager.hpp>
 
 using namespace agrobus::net;
 
@@ -36,6 +38,17 @@ TEST_CASE("Address claim state machine") {
         claimer.update(100); // Less than 250ms
         CHECK(cf.claim_state() == ClaimState::WaitForContest);
     }
+
+    SUBCASE("next deadline tracks the guard window") {
+        CHECK(claimer.next_deadline_ms() == NO_DEADLINE);
+        claimer.start();
+        u32 full = claimer.next_deadline_ms();
+        CHECK(full >= ADDRESS_CLAIM_TIMEOUT_MS);
+        claimer.update(100);
+        CHECK(claimer.next_deadline_ms() == full - 100);
+        claimer.update(full);
+        CHECK(claimer.next_deadline_ms() == NO_DEADLINE);
+    }
 }
 
 TEST_CASE("Address claim conflict resolution") {
@@ -133,3 +146,51 @@ TEST_CASE("Address claim re-claim with RTxD delay") {
         CHECK(cf.address() != 0x28);
     }
 }
+
+TEST_CASE("IsoNet answers Request for Address Claimed") {
+    LoopbackBus bus;
+    IsoNet nm_a;
+    IsoNet nm_b;
+    bus.attach(nm_a);
+    bus.attach(nm_b);
+    auto &monitor = bus.add_node();
+    nm_a.create_internal(Name::build().set_identity_number(1).set_self_configurable(true), 0, 0x28);
+    nm_a.create_internal(Name::build().set_identity_number(2).set_self_configurable(true), 0, 0x29);
+    nm_b.create_internal(Name::build().set_identity_number(3).set_self_configurable(true), 0, 0x30);
+    nm_a.start_address_claiming();
+    nm_b.start_address_claiming();
+    for (u32 ms = 0; ms < 400; ++ms) {
+        nm_a.update(1);
+        nm_b.update(1);
+    }
+    can_frame cf;
+    while (monitor.pop_can(cf)) {
+    }
+
+    auto request = [&](Address dest) {
+        can_frame req = {};
+        req.can_id = Identifier::encode(Priority::Default, PGN_REQUEST, NULL_ADDRESS, dest).raw | CAN_EFF_FLAG;
+        req.can_dlc = 3;
+        req.data[0] = static_cast<u8>(PGN_ADDRESS_CLAIMED & 0xFF);
+        req.data[1] = static_cast<u8>(PGN_ADDRESS_CLAIMED >> 8);
+        monitor.send_can(req);
+        nm_a.update(1);
+        nm_b.update(1);
+        dp::Vector<Address> claimed;
+        while (monitor.pop_can(cf)) {
+            Identifier id(cf.can_id & CAN_EFF_MASK);
+            if (id.pgn() == PGN_ADDRESS_CLAIMED)
+                claimed.push_back(id.source());
+        }
+        return claimed;
+    };
+
+    // Global: every claimed CF answers
+    CHECK(request(BROADCAST_ADDRESS).size() == 3);
+
+    // Destination-specific: only the addressed CF
+    auto one = request(0x29);
+    REQUIRE(one.size() == 1);
+    CHECK(one[0] == 0x29);
+    CHECK(request(0x55).empty());
+}
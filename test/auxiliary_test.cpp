@@ -83,3 +83,58 @@ TEST_CASE("AuxNInterface - function management") {
         CHECK(func->state == AuxFunctionState::Variable);
     }
 }
+
+TEST_CASE("AuxNInterface - edge-triggered state and batched status") {
+    LoopbackBus bus;
+    IsoNet joystick_net;
+    IsoNet implement_net;
+    auto *joystick_cf = joystick_net.create_internal(Name::build().set_identity_number(1), 0, 0x20).value();
+    auto *implement_cf = implement_net.create_internal(Name::build().set_identity_number(2), 0, 0x80).value();
+    bus.attach(joystick_net);
+    bus.attach(implement_net);
+    joystick_net.start_address_claiming();
+    implement_net.start_address_claiming();
+    for (u32 i = 0; i < 60; ++i) {
+        joystick_net.update(5);
+        implement_net.update(5);
+    }
+
+    AuxNInterface joystick(joystick_net, joystick_cf, AuxConfig{}.auto_send(true).interval(20));
+    AuxNInterface implement(implement_net, implement_cf);
+    REQUIRE(implement.initialize().is_ok());
+    u32 events = 0;
+    implement.on_function_changed.subscribe([&](const AuxNFunction &) { ++events; });
+
+    for (u8 f = 0; f < 24; ++f)
+        joystick.set_function(f, AuxFunctionType::Type2, 1000);
+    CHECK(joystick.changes_pending());
+
+    SUBCASE("update sends the changed functions in one pass") {
+        joystick.update(20);
+        CHECK_FALSE(joystick.changes_pending());
+        implement_net.update(5);
+        CHECK(implement.functions().size() == 24);
+        CHECK(events == 24);
+
+        // Same values again: nothing marked, nothing sent
+        for (u8 f = 0; f < 24; ++f)
+            joystick.set_function(f, AuxFunctionType::Type2, 1000);
+        CHECK_FALSE(joystick.changes_pending());
+
+        joystick.set_function(7, AuxFunctionType::Type2, 2000);
+        joystick.update(10);
+        CHECK(joystick.changes_pending()); // Not before the interval
+        joystick.update(10);
+        implement_net.update(5);
+        CHECK(events == 25);
+        CHECK(implement.get_function(7)->setpoint == 2000);
+    }
+
+    SUBCASE("repeated inputs raise no event") {
+        REQUIRE(joystick.send_changed().is_ok());
+        implement_net.update(5);
+        REQUIRE(joystick.send_status(3).is_ok());
+        implement_net.update(5);
+        CHECK(events == 24);
+    }
+}
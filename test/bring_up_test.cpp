@@ -0,0 +1,171 @@
+#include <doctest/doctest.h>
+#include <agrobus/isobus/bring_up.hpp>
+#include <agrobus/isobus/tc/server.hpp>
+#include <agrobus/isobus/vt/server.hpp>
+#include <agrobus/net/loopback_bus.hpp>
+
+using namespace agrobus::net;
+using namespace agrobus::isobus;
+
+namespace {
+    // A service connecting after `ready_after` updates, or failing instead
+    struct FakeService {
+        u32 connects = 0;
+        u32 polls = 0;
+        u32 ready_after = 1;
+        bool fail = false;
+
+        usize add(BringUp &bring_up, dp::String name) {
+            return bring_up.add(
+                std::move(name),
+                [this] {
+                    ++connects;
+                    polls = 0;
+                    return Result<void>{};
+                },
+                [this] { return !fail && ++polls > ready_after; }, [this] { return fail; });
+        }
+    };
+
+    struct Ecu {
+        IsoNet nm;
+        InternalCF *cf;
+        explicit Ecu(u32 identity, Address address)
+            : cf(nm.create_internal(Name::build().set_identity_number(identity), 0, address).value()) {}
+    };
+} // namespace
+
+TEST_CASE("BringUp - services start together once the address is claimed") {
+    Ecu ecu(1, 0x80);
+    BringUp bring_up(ecu.cf, nullptr, BringUpConfig{}.retry(100).attempts(2));
+    FakeService vt, tc, fs;
+    vt.ready_after = 3;
+    tc.ready_after = 1;
+    fs.fail = true;
+    vt.add(bring_up, "VT");
+    tc.add(bring_up, "TC");
+    fs.add(bring_up, "FS");
+    u32 failed = 0;
+    bring_up.on_service_failed.subscribe([&](const ServiceReport &r) { failed += r.name == "FS" ? 1 : 0; });
+
+    bring_up.key_on();
+    bring_up.update(10);
+    CHECK_FALSE(bring_up.claimed());
+    CHECK(vt.connects == 0);
+
+    REQUIRE(ecu.nm.start_address_claiming().is_ok());
+    for (u32 i = 0; i < 60 && ecu.cf->claim_state() != ClaimState::Claimed; ++i)
+        ecu.nm.update(5);
+    REQUIRE(ecu.cf->claim_state() == ClaimState::Claimed);
+    bring_up.update(300);
+    CHECK(bring_up.claimed_ms() == 310);
+    CHECK(vt.connects == 1);
+    CHECK(tc.connects == 1);
+    CHECK(fs.connects == 1);
+    CHECK(bring_up.report(0).started_ms == 310);
+    CHECK(bring_up.report(1).started_ms == 310);
+
+    bring_up.update(10);
+    CHECK(bring_up.report(1).status == ServiceStatus::Operational);
+    CHECK(bring_up.report(1).operational_ms == 320);
+    CHECK(bring_up.report(0).status == ServiceStatus::Connecting);
+    CHECK(bring_up.report(2).status == ServiceStatus::Waiting);
+
+    for (u32 i = 0; i < 20; ++i)
+        bring_up.update(10);
+    CHECK(bring_up.report(0).operational_ms == 340);
+    CHECK(fs.connects == 2); // Retried once after 100 ms
+    CHECK(bring_up.report(2).status == ServiceStatus::Failed);
+    CHECK(failed == 1);
+    CHECK_FALSE(bring_up.operational());
+
+    SUBCASE("key_on starts over") {
+        fs.fail = false;
+        bring_up.key_on();
+        CHECK(bring_up.report(0).status == ServiceStatus::Waiting);
+        CHECK(bring_up.report(0).name == "VT");
+        u32 operational = 0;
+        bring_up.on_operational.subscribe([&](u32 ms) { operational = ms; });
+        for (u32 i = 0; i < 5; ++i)
+            bring_up.update(10);
+        CHECK(bring_up.operational());
+        CHECK(bring_up.operational_ms() == 40);
+        CHECK(operational == 40);
+        CHECK(bring_up.report(2).attempts == 1);
+    }
+}
+
+TEST_CASE("BringUp - VT, TC and file clients reach their servers together") {
+    LoopbackBus bus;
+    Ecu vt_ecu(1, 0x26);
+    Ecu tc_ecu(2, 0xF7);
+    Ecu fs_ecu(3, 0xAA);
+    Ecu ecu(4, 0x80);
+    for (auto *e : {&vt_ecu, &tc_ecu, &fs_ecu, &ecu}) {
+        bus.attach(e->nm);
+        REQUIRE(e->nm.start_address_claiming().is_ok());
+    }
+    vt::VTServer vt_server(vt_ecu.nm, vt_ecu.cf);
+    tc::TaskControllerServer tc_server(tc_ecu.nm, tc_ecu.cf);
+    FileServer fs_server(fs_ecu.nm, fs_ecu.cf);
+    REQUIRE(vt_server.start().is_ok());
+    REQUIRE(tc_server.start().is_ok());
+    REQUIRE(fs_server.initialize().is_ok());
+
+    vt::VTClient vt_client(ecu.nm, ecu.cf);
+    vt::ObjectPool pool;
+    pool.add(vt::VTObject().set_id(0).set_type(vt::ObjectType::WorkingSet).set_body({0xC8, 0x00, 0xC8, 0x00}));
+    for (u16 id = 1; id < 40; ++id)
+        pool.add(vt::VTObject().set_id(id).set_type(vt::ObjectType::DataMask).set_body({0x00}));
+    vt_client.set_object_pool(pool);
+
+    tc::TaskControllerClient tc_client(ecu.nm, ecu.cf);
+    tc::DDOP ddop;
+    tc::DeviceObject device;
+    device.id = 1;
+    device.designator = "Seeder";
+    ddop.add_device(device);
+    tc::DeviceElement root;
+    root.id = 2;
+    root.type = tc::DeviceElementType::Device;
+    root.parent_id = 1;
+    ddop.add_element(root);
+    tc_client.set_ddop(std::move(ddop));
+
+    FileClient fs_client(ecu.nm, ecu.cf);
+    REQUIRE(fs_client.initialize().is_ok());
+
+    WorkingSetManager ws(ecu.nm, ecu.cf);
+    REQUIRE(ws.initialize().is_ok());
+    BringUp bring_up(ecu.cf, &ws);
+    bring_up.add(vt_client);
+    bring_up.add(tc_client);
+    bring_up.add(fs_client);
+
+    u32 masters = 0;
+    tc_ecu.nm.register_pgn_callback(PGN_WORKING_SET_MASTER, [&](const Message &) { ++masters; });
+
+    bring_up.key_on();
+    for (u32 i = 0; i < 4000 && !bring_up.operational(); ++i) {
+        for (auto *e : {&vt_ecu, &tc_ecu, &fs_ecu, &ecu})
+            e->nm.update(5);
+        vt_server.update(5);
+        tc_server.update(5);
+        fs_server.update(5);
+        vt_client.update(5);
+        tc_client.update(5);
+        fs_client.update(5);
+        ws.update(5);
+        bring_up.update(5);
+    }
+    REQUIRE(bring_up.operational());
+    CHECK(vt_client.state() == vt::VTState::Connected);
+    CHECK(tc_client.state() == tc::TCState::Connected);
+    CHECK(fs_client.status_source() == 0xAA);
+    CHECK(masters == 1); // One announcement for all three clients
+    for (usize i = 0; i < bring_up.size(); ++i) {
+        CHECK(bring_up.report(i).started_ms == bring_up.claimed_ms());
+        CHECK(bring_up.report(i).attempts == 1);
+        CHECK(bring_up.report(i).operational_ms <= bring_up.operational_ms());
+    }
+}
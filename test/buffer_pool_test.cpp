@@ -0,0 +1,73 @@
+#include <doctest/doctest.h>
+#include <agrobus/net/buffer_pool.hpp>
+
+using namespace agrobus::net;
+
+TEST_CASE("BufferPool size classes") {
+    CHECK(BufferPool::class_for(1) == 0);
+    CHECK(BufferPool::class_for(64) == 0);
+    CHECK(BufferPool::class_for(65) == 1);
+    CHECK(BufferPool::class_for(1785) == 2);
+    CHECK(BufferPool::class_for(1786) == 3);
+    CHECK(BufferPool::class_for(65536) == 3);
+    CHECK(BufferPool::class_for(65537) == BufferPool::LARGE_CLASS);
+}
+
+TEST_CASE("BufferPool acquire fills and release recycles") {
+    BufferPool pool;
+    auto buf = pool.acquire(100);
+    CHECK(buf.size() == 100);
+    CHECK(buf.capacity() >= 256);
+    CHECK(buf[0] == 0xFF);
+    CHECK(buf[99] == 0xFF);
+    CHECK(pool.stats().misses == 1);
+
+    const u8 *storage = buf.data();
+    buf[0] = 0x12;
+    pool.release(std::move(buf));
+    CHECK(pool.cached(1) == 1);
+
+    auto again = pool.acquire(200, 0x00);
+    CHECK(again.data() == storage); // same allocation handed back
+    CHECK(again.size() == 200);
+    CHECK(again[0] == 0x00);
+    CHECK(pool.stats().hits == 1);
+    CHECK(pool.cached(1) == 0);
+}
+
+TEST_CASE("BufferPool bounds each class") {
+    BufferPool pool(2, 1);
+    for (int i = 0; i < 4; ++i)
+        pool.release(dp::Vector<u8>(64));
+    CHECK(pool.cached(0) == 2);
+    CHECK(pool.stats().discarded == 2);
+
+    pool.release(dp::Vector<u8>(100000));
+    pool.release(dp::Vector<u8>(100000));
+    CHECK(pool.cached(BufferPool::LARGE_CLASS) == 1);
+
+    // Too small to be worth caching
+    pool.release(dp::Vector<u8>(8));
+    CHECK(pool.cached(0) == 2);
+}
+
+TEST_CASE("BufferPool large class serves any buffer with enough capacity") {
+    BufferPool pool;
+    pool.release(dp::Vector<u8>(200000));
+    auto small = pool.acquire(70000);
+    CHECK(pool.stats().hits == 1);
+    CHECK(small.size() == 70000);
+
+    auto big = pool.acquire(300000);
+    CHECK(pool.stats().misses == 1);
+    CHECK(big.size() == 300000);
+}
+
+TEST_CASE("BufferPool reserve pre-allocates") {
+    BufferPool pool(4);
+    pool.reserve(2, 3);
+    CHECK(pool.cached(2) == 3);
+    auto buf = pool.acquire(1785);
+    CHECK(pool.stats().hits == 1);
+    CHECK(pool.stats().misses == 0);
+}
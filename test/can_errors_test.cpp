@@ -0,0 +1,41 @@
+#include <doctest/doctest.h>
+#include <agrobus/net/can_errors.hpp>
+
+using namespace agrobus::net;
+
+TEST_CASE("can_errors::apply counts error classes and follows the controller state") {
+    CanErrorStats stats;
+    u8 data[8] = {};
+
+    // Bus error with counters: no state change yet
+    data[6] = 40;
+    data[7] = 3;
+    CHECK_FALSE(can_errors::apply(stats, CAN_ERR_PROT | CAN_ERR_BUSERROR | CAN_ERR_CNT, data, 100));
+    CHECK(stats.protocol_errors == 1);
+    CHECK(stats.tx_error_counter == 40);
+    CHECK(stats.rx_error_counter == 3);
+
+    data[1] = CAN_ERR_CRTL_TX_WARNING;
+    CHECK(can_errors::apply(stats, CAN_ERR_CRTL, data, 200));
+    CHECK(stats.state == CanBusState::ErrorWarning);
+    data[1] = CAN_ERR_CRTL_TX_PASSIVE | CAN_ERR_CRTL_RX_OVERFLOW;
+    CHECK(can_errors::apply(stats, CAN_ERR_CRTL, data, 300));
+    CHECK(stats.state == CanBusState::ErrorPassive);
+    CHECK(stats.rx_overflows == 1);
+
+    data[1] = 0;
+    CHECK(can_errors::apply(stats, CAN_ERR_BUSOFF | CAN_ERR_ACK, data, 1000));
+    CHECK(stats.state == CanBusState::BusOff);
+    CHECK(stats.bus_off == 1);
+    CHECK(stats.no_ack == 1);
+    CHECK_FALSE(can_errors::apply(stats, CAN_ERR_BUSOFF, data, 1100)); // Still off
+    CHECK(stats.bus_off == 1);
+
+    CHECK(can_errors::apply(stats, CAN_ERR_RESTARTED, data, 4000));
+    CHECK(stats.state == CanBusState::ErrorActive);
+    CHECK(stats.restarts == 1);
+    CHECK(stats.bus_off_us == 3000);
+    CHECK(stats.state_since_us == 4000);
+    CHECK(stats.error_frames == 6);
+    CHECK(stats.last_error_us == 4000);
+}
@@ -0,0 +1,199 @@
+#include <doctest/doctest.h>
+#include <agrobus/net/bus_load.hpp>
+#include <agrobus/net/frame.hpp>
+#include <agrobus/net/network_manager.hpp>
+#include <cstddef>
+#include <deque>
+#include <linux/can.h>
+
+using namespace agrobus::net;
+
+TEST_CASE("CAN FD data length codes") {
+    CHECK(can_dlc_to_length(8) == 8);
+    CHECK(can_dlc_to_length(9) == 12);
+    CHECK(can_dlc_to_length(13) == 32);
+    CHECK(can_dlc_to_length(CAN_FD_MAX_DLC) == 64);
+
+    for (u8 dlc = 0; dlc <= CAN_FD_MAX_DLC; ++dlc)
+        CHECK(can_length_to_dlc(can_dlc_to_length(dlc)) == dlc);
+    CHECK(can_fd_padded_length(9) == 12);
+    CHECK(can_fd_padded_length(17) == 20);
+    CHECK(can_fd_padded_length(33) == 48);
+    CHECK(can_fd_padded_length(49) == 64);
+}
+
+TEST_CASE("FdFrame pads to an FD length and lays out like canfd_frame") {
+    static_assert(offsetof(FdFrame, length) == offsetof(canfd_frame, len));
+    static_assert(offsetof(FdFrame, flags) == offsetof(canfd_frame, flags));
+    static_assert(offsetof(FdFrame, data) == offsetof(canfd_frame, data));
+
+    dp::Array<u8, 30> payload;
+    for (usize i = 0; i < payload.size(); ++i)
+        payload[i] = static_cast<u8>(i);
+    auto f = FdFrame::from_message(Priority::Default, 0xEF00, 0x28, 0x26, payload.data(), payload.size());
+    CHECK(f.length == 32);
+    CHECK(f.dlc() == 13);
+    CHECK(f.data[29] == 29);
+    CHECK(f.data[30] == 0xFF);
+    CHECK(f.data[31] == 0xFF);
+    CHECK(f.header().destination == 0x26);
+    CHECK_FALSE(f.fits_classic());
+}
+
+TEST_CASE("BusLoad costs FD frames with the data phase at the data bitrate") {
+    u32 slow = BusLoad::fd_frame_bits(64, 250000, 0);
+    u32 fast = BusLoad::fd_frame_bits(64, 250000, 2000000);
+    CHECK(fast < slow);
+    // Eight classic frames carry the same 64 bytes in far more bus time
+    CHECK(fast < BusLoad::frame_bits(8));
+    CHECK(BusLoad::fd_frame_bits(64, 250000, 2000000, true) > fast);
+
+    BusLoad fd(250000);
+    fd.set_data_bitrate(2000000);
+    BusLoad classic(250000);
+    FdFrame f;
+    f.length = 64;
+    for (int i = 0; i < 10; ++i) {
+        fd.add_frame(f);
+        for (int j = 0; j < 8; ++j)
+            classic.add_frame(Frame{});
+    }
+    fd.update(100);
+    classic.update(100);
+    CHECK(fd.load_percent() < classic.load_percent() / 4.0f);
+}
+
+TEST_CASE("IsoNet sends single FD frames up to 64 bytes on an FD port") {
+    IsoNet nm;
+    dp::Vector<canfd_frame> sent;
+    std::deque<canfd_frame> incoming;
+    REQUIRE(nm.set_fd_port(
+                  0, [&](const canfd_frame &cf) { sent.push_back(cf); return true; },
+                  [&](canfd_frame &cf) {
+                      if (incoming.empty())
+                          return false;
+                      cf = incoming.front();
+                      incoming.pop_front();
+                      return true;
+                  })
+                .is_ok());
+    CHECK(nm.max_single_frame(0) == CAN_FD_DATA_LENGTH);
+    auto *cf = nm.create_internal(Name::build().set_identity_number(1), 0, 0x28).value();
+
+    SUBCASE("up to 64 bytes is one frame") {
+        dp::Vector<u8> data(40, 0x5A);
+        REQUIRE(nm.send(0xEF00, data, cf).is_ok());
+        REQUIRE(sent.size() == 1);
+        CHECK(sent[0].len == 48);
+        CHECK((sent[0].flags & CANFD_BRS) != 0);
+        CHECK((sent[0].can_id & CAN_EFF_FLAG) != 0);
+        CHECK(sent[0].data[39] == 0x5A);
+        CHECK(sent[0].data[40] == 0xFF);
+    }
+
+    SUBCASE("classic frames use the FD sink without FD flags") {
+        dp::Vector<u8> data(4, 0x11);
+        REQUIRE(nm.send(0xEF00, data, cf).is_ok());
+        REQUIRE(sent.size() == 1);
+        CHECK(sent[0].len == 8);
+        CHECK(sent[0].flags == 0);
+    }
+
+    SUBCASE("send_and_wait completes with the FD frame") {
+        ControlFunction dest;
+        dest.address = 0x30;
+        usize before = sent.size();
+        Task<Result<void>> single = nm.send_and_wait(0xEF00, dp::Vector<u8>(40, 0x5A), cf, &dest, 1000);
+        REQUIRE(single.done()); // No TP session to wait for
+        CHECK(single.result().is_ok());
+        nm.update(10);
+        REQUIRE(sent.size() == before + 1);
+        CHECK(sent.back().len == 48);
+    }
+
+    SUBCASE("longer messages still use TP") {
+        dp::Vector<u8> data(100, 0x22);
+        REQUIRE(nm.send(0xEF00, data, cf).is_ok());
+        REQUIRE_FALSE(sent.empty());
+        CHECK(Identifier(sent[0].can_id & CAN_EFF_MASK).pgn() == PGN_TP_CM);
+    }
+
+    SUBCASE("received FD frames dispatch as one message") {
+        usize got = 0;
+        nm.register_pgn_callback(0xEF00, [&](const Message &msg) {
+            ++got;
+            CHECK(msg.data.size() == 20);
+            CHECK(msg.source == 0x30);
+        });
+        dp::Array<u8, 20> payload;
+        payload.fill(0x33);
+        auto f = FdFrame::from_message(Priority::Default, 0xEF00, 0x30, 0x28, payload.data(), payload.size());
+        canfd_frame wire{};
+        std::memcpy(&wire, &f, sizeof(canfd_frame));
+        wire.can_id |= CAN_EFF_FLAG;
+        incoming.push_back(wire);
+        nm.update(10);
+        CHECK(got == 1);
+    }
+}
+
+TEST_CASE("IsoNet queues FD frames behind the port's waiting frames") {
+    IsoNet nm(NetworkConfig{}.flight_recorder());
+    dp::Vector<canfd_frame> sent;
+    std::deque<canfd_frame> incoming;
+    bool accept = false;
+    REQUIRE(nm.set_fd_port(
+                  0,
+                  [&](const canfd_frame &cf) {
+                      if (accept)
+                          sent.push_back(cf);
+                      return accept;
+                  },
+                  [&](canfd_frame &cf) {
+                      if (incoming.empty())
+                          return false;
+                      cf = incoming.front();
+                      incoming.pop_front();
+                      return true;
+                  })
+                .is_ok());
+    auto *cf = nm.create_internal(Name::build().set_identity_number(1), 0, 0x28).value();
+
+    // The sink refuses: the classic frame waits, and the FD frame waits behind it
+    REQUIRE(nm.send(0xEF00, dp::Vector<u8>(4, 0x11), cf).is_ok());
+    REQUIRE(nm.send(0xEF00, dp::Vector<u8>(40, 0x5A), cf).is_ok());
+    CHECK(nm.tx_pending(0) == 2);
+    CHECK(nm.tx_retries() >= 2);
+    accept = true;
+    nm.update(1);
+    CHECK(nm.tx_pending(0) == 0);
+    REQUIRE(sent.size() == 2);
+    CHECK(sent[0].len == 8);
+    CHECK(sent[0].flags == 0);
+    CHECK(sent[1].len == 48);
+
+    usize recorded = 0;
+    for (const auto &r : nm.flight_recorder()->snapshot())
+        recorded += (r.flags == capture_flags::TX && r.frame().pgn() == 0xEF00) ? 1 : 0;
+    CHECK(recorded == 2);
+
+    // A bus-off port holds FD frames until the controller restarts
+    canfd_frame err{};
+    err.can_id = CAN_ERR_FLAG | CAN_ERR_BUSOFF;
+    err.len = CAN_ERR_DLC;
+    incoming.push_back(err);
+    nm.update(1);
+    REQUIRE(nm.bus_off(0));
+    REQUIRE(nm.send(0xEF00, dp::Vector<u8>(40, 0x5A), cf).is_ok());
+    nm.update(10);
+    CHECK(sent.size() == 2);
+    CHECK(nm.tx_pending(0) == 1);
+
+    err.can_id = CAN_ERR_FLAG | CAN_ERR_RESTARTED;
+    incoming.push_back(err);
+    nm.update(1);
+    CHECK_FALSE(nm.bus_off(0));
+    CHECK(nm.tx_pending(0) == 0);
+    REQUIRE(sent.size() == 3);
+    CHECK(sent[2].len == 48);
+}
@@ -0,0 +1,68 @@
+#include <doctest/doctest.h>
+#include <agrobus/net/can_filter.hpp>
+#include <agrobus/net/constants.hpp>
+#include <agrobus/net/network_manager.hpp>
+
+using namespace agrobus::net;
+
+static u32 id_of(Priority prio, PGN pgn, Address src, Address dst) {
+    return Identifier::encode(prio, pgn, src, dst).raw;
+}
+
+TEST_CASE("CanFilterBuilder PDU2 PGN matches any priority and source") {
+    auto filters = CanFilterBuilder{}.pgn(PGN_VEHICLE_SPEED).build();
+    REQUIRE(filters.size() == 1);
+    CHECK(CanFilterBuilder::matches(filters, id_of(Priority::Default, PGN_VEHICLE_SPEED, 0x30, BROADCAST_ADDRESS)));
+    CHECK(CanFilterBuilder::matches(filters, id_of(Priority::Highest, PGN_VEHICLE_SPEED, 0x80, BROADCAST_ADDRESS)));
+    CHECK_FALSE(CanFilterBuilder::matches(filters, id_of(Priority::Default, PGN_DM1, 0x30, BROADCAST_ADDRESS)));
+}
+
+TEST_CASE("CanFilterBuilder PDU1 PGN matches listed destinations only") {
+    dp::Vector<Address> dests = {0x28, BROADCAST_ADDRESS};
+    auto filters = CanFilterBuilder{}.pgn(PGN_TP_CM, dests).build();
+    CHECK(filters.size() == 2);
+    CHECK(CanFilterBuilder::matches(filters, id_of(Priority::Lowest, PGN_TP_CM, 0x30, 0x28)));
+    CHECK(CanFilterBuilder::matches(filters, id_of(Priority::Lowest, PGN_TP_CM, 0x30, BROADCAST_ADDRESS)));
+    CHECK_FALSE(CanFilterBuilder::matches(filters, id_of(Priority::Lowest, PGN_TP_CM, 0x30, 0x26)));
+
+    SUBCASE("no destinations accepts every destination") {
+        auto any = CanFilterBuilder{}.pgn(PGN_TP_CM).build();
+        CHECK(CanFilterBuilder::matches(any, id_of(Priority::Lowest, PGN_TP_CM, 0x30, 0x26)));
+    }
+}
+
+TEST_CASE("CanFilterBuilder deduplicates and supports accept_all") {
+    auto filters = CanFilterBuilder{}.pgn(PGN_DM1).pgn(PGN_DM1).source(0x28).source(0x28).build();
+    CHECK(filters.size() == 2);
+
+    auto all = CanFilterBuilder{}.pgn(PGN_DM1).accept_all().build();
+    REQUIRE(all.size() == 1);
+    CHECK(CanFilterBuilder::matches(all, id_of(Priority::Default, 0xFF00, 0x01, BROADCAST_ADDRESS)));
+}
+
+TEST_CASE("IsoNet can_filters covers registrations and protocol traffic") {
+    IsoNet nm;
+    Name name;
+    name.set_identity_number(1);
+    nm.create_internal(name, 0, 0x28);
+    nm.register_pgn_callback(PGN_VEHICLE_SPEED, [](const Message &) {});
+    nm.register_pgn_view_callback(0xE600, [](const MessageView &) {});
+
+    auto filters = nm.can_filters(0);
+    CHECK(CanFilterBuilder::matches(filters, id_of(Priority::Default, PGN_VEHICLE_SPEED, 0x30, BROADCAST_ADDRESS)));
+    CHECK(CanFilterBuilder::matches(filters, id_of(Priority::Default, 0xE600, 0x26, 0x28)));
+    CHECK_FALSE(CanFilterBuilder::matches(filters, id_of(Priority::Default, 0xE600, 0x26, 0x29)));
+    CHECK(CanFilterBuilder::matches(filters, id_of(Priority::Default, PGN_ADDRESS_CLAIMED, 0x80, BROADCAST_ADDRESS)));
+    CHECK(CanFilterBuilder::matches(filters, id_of(Priority::Lowest, PGN_TP_DT, 0x30, 0x28)));
+    CHECK(CanFilterBuilder::matches(filters, id_of(Priority::Default, PGN_REQUEST, 0x30, BROADCAST_ADDRESS)));
+    // Anything from our own address (violation detection)
+    CHECK(CanFilterBuilder::matches(filters, id_of(Priority::Default, 0xFF42, 0x28, BROADCAST_ADDRESS)));
+    // Unhandled traffic is dropped in the kernel
+    CHECK_FALSE(CanFilterBuilder::matches(filters, id_of(Priority::Default, PGN_DM1, 0x30, BROADCAST_ADDRESS)));
+
+    SUBCASE("catch-all listener disables filtering") {
+        nm.on_message.subscribe([](const Message &) {});
+        auto all = nm.can_filters(0);
+        CHECK(CanFilterBuilder::matches(all, id_of(Priority::Default, PGN_DM1, 0x30, BROADCAST_ADDRESS)));
+    }
+}
@@ -0,0 +1,216 @@
+#include <doctest/doctest.h>
+#include <agrobus/net/can_log.hpp>
+#include <agrobus/net/network_manager.hpp>
+#include <cstdio>
+
+using namespace agrobus::net;
+
+namespace {
+
+    void write_file(const char *path, const void *data, usize size) {
+        FILE *f = std::fopen(path, "wb");
+        REQUIRE(f);
+        std::fwrite(data, 1, size, f);
+        std::fclose(f);
+    }
+
+    void write_text(const char *path, const char *text) { write_file(path, text, std::strlen(text)); }
+
+    template <typename T> void put(dp::Vector<u8> &out, T v) {
+        u8 b[sizeof(T)];
+        std::memcpy(b, &v, sizeof(T));
+        for (u8 c : b)
+            out.push_back(c);
+    }
+
+    // BLF CAN_MESSAGE object with a v1 header and a 1 ns timestamp
+    dp::Vector<u8> blf_can(u64 ts_ns, u16 channel, u32 id, u8 first) {
+        dp::Vector<u8> o;
+        for (char c : {'L', 'O', 'B', 'J'})
+            o.push_back(static_cast<u8>(c));
+        put<u16>(o, 32);
+        put<u16>(o, 1);
+        put<u32>(o, 32 + 16);
+        put<u32>(o, 1);
+        put<u32>(o, 2); // 1 ns units
+        put<u16>(o, 0);
+        put<u16>(o, 0);
+        put<u64>(o, ts_ns);
+        put<u16>(o, channel);
+        o.push_back(0);
+        o.push_back(8);
+        put<u32>(o, id);
+        for (u8 i = 0; i < 8; ++i)
+            o.push_back(static_cast<u8>(first + i));
+        return o;
+    }
+
+    dp::Vector<u8> blf_container(const u8 *data, usize n, u16 compression = 0) {
+        dp::Vector<u8> o;
+        for (char c : {'L', 'O', 'B', 'J'})
+            o.push_back(static_cast<u8>(c));
+        put<u16>(o, 16);
+        put<u16>(o, 1);
+        put<u32>(o, static_cast<u32>(32 + n));
+        put<u32>(o, 10);
+        put<u16>(o, compression);
+        put<u16>(o, 0);
+        put<u32>(o, 0);
+        put<u32>(o, static_cast<u32>(n));
+        put<u32>(o, 0);
+        for (usize i = 0; i < n; ++i)
+            o.push_back(data[i]);
+        while (o.size() % 4)
+            o.push_back(0);
+        return o;
+    }
+
+} // namespace
+
+TEST_CASE("CanLogReader parses candump -l logs") {
+    const char *path = "/tmp/agrobus_log_test.log";
+    write_text(path, "(1436509052.249713) can0 18FEF128#0102030405060708\n"
+                     "(1436509052.250000) can1 0CF00400#11223344\r\n"
+                     "(1436509052.250100) can0 123#DEADBEEF\n"
+                     "(1436509052.250200) can0 18FEF128#R\n"
+                     "(1436509052.250300) can0 18FEF128##1AABB\n"
+                     "(1436509052.3) can0 18EAFF28#00EE00");
+    CanLogReader log;
+    REQUIRE(log.open(path).is_ok());
+    CHECK(log.format() == CanLogFormat::Candump);
+
+    CaptureRecord r;
+    REQUIRE(log.next(r));
+    CHECK(r.timestamp_us == 1436509052249713ULL);
+    CHECK(r.can_id == 0x18FEF128u);
+    CHECK(r.port == 0);
+    CHECK(r.dlc == 8);
+    CHECK(r.data[7] == 0x08);
+    REQUIRE(log.next(r));
+    CHECK(r.port == 1);
+    CHECK(r.dlc == 4);
+    CHECK(r.data[3] == 0x44);
+    REQUIRE(log.next(r));
+    CHECK(r.timestamp_us == 1436509052300000ULL);
+    CHECK(r.can_id == 0x18EAFF28u);
+    CHECK(r.port == 0);
+    CHECK(r.dlc == 3);
+    CHECK_FALSE(log.next(r));
+    CHECK(log.frames() == 3);
+    CHECK(log.skipped() == 3); // Standard, remote and FD
+}
+
+TEST_CASE("CanLogReader parses Vector ASC logs") {
+    const char *path = "/tmp/agrobus_log_test.asc";
+    write_text(path, "date Mon Sep 14 10:00:00.000 am 2026\n"
+                     "base hex  timestamps absolute\n"
+                     "// version 13.0.0\n"
+                     "Begin Triggerblock Mon Sep 14 10:00:00.000 am 2026\n"
+                     "   0.000000 Start of measurement\n"
+                     "   0.015991 1  18FEF128x       Rx   d 8 01 02 03 04 05 06 07 08  Length = 0 BitCount = 0\n"
+                     "   0.016500 2  0CF00400x       Tx   d 2 AA BB\n"
+                     "   0.017000 1  123             Rx   d 1 00\n"
+                     "   0.018000 1  ErrorFrame\n"
+                     "End TriggerBlock\n");
+    CanLogReader log;
+    REQUIRE(log.open(path).is_ok());
+    CHECK(log.format() == CanLogFormat::Asc);
+
+    CaptureRecord r;
+    REQUIRE(log.next(r));
+    CHECK(r.timestamp_us == 15991);
+    CHECK(r.can_id == 0x18FEF128u);
+    CHECK(r.port == 0);
+    CHECK(r.flags == 0);
+    CHECK(r.data[0] == 0x01);
+    REQUIRE(log.next(r));
+    CHECK(r.port == 1);
+    CHECK(r.flags == capture_flags::TX);
+    CHECK(r.dlc == 2);
+    CHECK(r.data[1] == 0xBB);
+    CHECK_FALSE(log.next(r));
+    CHECK(log.skipped() == 3);
+}
+
+TEST_CASE("CanLogReader reads uncompressed BLF containers") {
+    dp::Vector<u8> file;
+    for (char c : {'L', 'O', 'G', 'G'})
+        file.push_back(static_cast<u8>(c));
+    put<u32>(file, 144);
+    file.resize(144, 0);
+
+    auto a = blf_can(1000000, 1, 0x98FEF128, 0x10); // Extended flag in bit 31
+    auto b = blf_can(2000000, 2, 0x8CF00400, 0x20);
+    auto c = blf_can(3000000, 1, 0x123, 0x30); // Standard
+    dp::Vector<u8> stream;
+    for (auto *o : {&a, &b, &c})
+        for (u8 x : *o)
+            stream.push_back(x);
+    // Second object split across two containers, one compressed container in between
+    usize split = a.size() + 20;
+    for (u8 x : blf_container(stream.data(), split))
+        file.push_back(x);
+    for (u8 x : blf_container(stream.data(), 8, 2))
+        file.push_back(x);
+    for (u8 x : blf_container(stream.data() + split, stream.size() - split))
+        file.push_back(x);
+    // And one object outside any container
+    for (u8 x : blf_can(4000000, 3, 0x98EAFF28, 0x40))
+        file.push_back(x);
+
+    const char *path = "/tmp/agrobus_log_test.blf";
+    write_file(path, file.data(), file.size());
+    CanLogReader log;
+    REQUIRE(log.open(path).is_ok());
+    CHECK(log.format() == CanLogFormat::Blf);
+
+    CaptureRecord r;
+    REQUIRE(log.next(r));
+    CHECK(r.timestamp_us == 1000);
+    CHECK(r.can_id == 0x18FEF128u);
+    CHECK(r.port == 0);
+    CHECK(r.data[0] == 0x10);
+    REQUIRE(log.next(r));
+    CHECK(r.timestamp_us == 2000);
+    CHECK(r.can_id == 0x0CF00400u);
+    CHECK(r.port == 1);
+    CHECK(r.data[7] == 0x27);
+    REQUIRE(log.next(r));
+    CHECK(r.timestamp_us == 4000);
+    CHECK(r.port == 2);
+    CHECK_FALSE(log.next(r));
+    CHECK(log.skipped() == 1);
+    CHECK(log.compressed_skipped() == 1);
+}
+
+TEST_CASE("A log converts into a capture and feeds IsoNet") {
+    const char *path = "/tmp/agrobus_log_feed.log";
+    write_text(path, "(10.000100) can0 18FEF128#0000000000000000\n"
+                     "(10.000200) can0 18FEF128#0100000000000000\n"
+                     "(10.000300) can0 18FEF128#0200000000000000\n");
+    CanLogReader log;
+    REQUIRE(log.open(path).is_ok());
+    {
+        CaptureWriter writer;
+        REQUIRE(writer.open("/tmp/agrobus_log_feed.agcap").is_ok());
+        CHECK(log.convert(writer) == 3);
+    }
+    CaptureReader capture;
+    REQUIRE(capture.open("/tmp/agrobus_log_feed.agcap").is_ok());
+    REQUIRE(capture.size() == 3);
+    CHECK(capture[2].timestamp_us == 10000300);
+
+    log.rewind();
+    IsoNet nm;
+    nm.set_endpoint(0, &log.can_endpoint());
+    nm.set_rx_source(0, log.rx_source());
+    nm.set_rx_clock([&] { return log.last_timestamp_us(); });
+    u32 received = 0;
+    nm.on_frame_received.subscribe([&](const Frame &f, u8) {
+        CHECK(f.data[0] == received);
+        CHECK(f.timestamp_us == 10000100 + received * 100);
+        ++received;
+    });
+    nm.update(0);
+    CHECK(received == 3);
+}
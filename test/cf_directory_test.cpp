@@ -0,0 +1,149 @@
+#include <doctest/doctest.h>
+#include <agrobus/net/cf_directory.hpp>
+#include <agrobus/net/network_manager.hpp>
+#include <wirebit/can/can_endpoint.hpp>
+#include <wirebit/can/socketcan_link.hpp>
+
+using namespace agrobus::net;
+
+namespace {
+
+    // Two IsoNets on one vcan interface
+    struct Pair {
+        std::shared_ptr<wirebit::SocketCanLink> link_a;
+        std::shared_ptr<wirebit::SocketCanLink> link_b;
+        wirebit::CanEndpoint ep_a;
+        wirebit::CanEndpoint ep_b;
+        IsoNet nm_a;
+        IsoNet nm_b;
+
+        Pair()
+            : link_a(std::make_shared<wirebit::SocketCanLink>(
+                  wirebit::SocketCanLink::create(
+                      {.interface_name = "vcan_cfdir", .create_if_missing = true, .destroy_on_close = true})
+                      .value())),
+              link_b(std::make_shared<wirebit::SocketCanLink>(wirebit::SocketCanLink::attach("vcan_cfdir").value())),
+              ep_a(link_a, wirebit::CanConfig{}, 1), ep_b(link_b, wirebit::CanConfig{}, 2) {
+            nm_a.set_endpoint(0, &ep_a);
+            nm_b.set_endpoint(0, &ep_b);
+        }
+
+        void tick(u32 elapsed_ms = 10) {
+            nm_a.update(elapsed_ms);
+            nm_b.update(elapsed_ms);
+            nm_a.update(0);
+            nm_b.update(0);
+        }
+    };
+
+} // namespace
+
+TEST_CASE("CFDirectory follows internal CFs and partner bindings") {
+    CFDirectory dir;
+    Name ours = Name::build().set_identity_number(1);
+    Name theirs = Name::build().set_identity_number(2);
+
+    CHECK(dir.sync_internal(0, 0, 0x28, 0x28, ours));
+    CHECK_FALSE(dir.sync_internal(0, 0, 0x28, 0x28, ours));
+    CHECK(dir.internal_at(0, 0x28) == 0);
+    CHECK(dir.at(0, 0x28).preferred == 0);
+    CHECK(dir.internal_at(1, 0x28) == CFDirectory::NONE);
+    CHECK(dir.internal_port(0x28).value() == 0);
+    CHECK(dir.find(ours)->internal);
+
+    // Lost the contest and moved on: the preferred slot stays
+    CHECK(dir.sync_internal(0, 0, 0x29, 0x28, ours));
+    CHECK(dir.internal_at(0, 0x28) == CFDirectory::NONE);
+    CHECK(dir.internal_at(0, 0x29) == 0);
+    CHECK(dir.at(0, 0x28).preferred == 0);
+
+    dir.place_partner(3, 0, 0x80, theirs);
+    CHECK(dir.partner_at(0, 0x80) == 3);
+    dir.place_partner(3, 0, 0x81, theirs);
+    CHECK(dir.partner_at(0, 0x80) == CFDirectory::NONE);
+    CHECK(dir.partner_at(0, 0x81) == 3);
+    CHECK(dir.find(theirs)->index == 3);
+    CHECK_FALSE(dir.find(Name::build().set_identity_number(9)));
+
+    dir.remember_matches(0, theirs, {3});
+    REQUIRE(dir.partner_matches(0, theirs) != nullptr);
+    CHECK(dir.partner_matches(0, theirs)->size() == 1);
+    dir.forget_matches();
+    CHECK(dir.partner_matches(0, theirs) == nullptr);
+}
+
+TEST_CASE("IsoNet looks up CFs by address and NAME") {
+    IsoNet nm;
+    Name name = Name::build().set_identity_number(7);
+    auto *cf = nm.create_internal(name, 0, 0x28).value();
+    CHECK(nm.cf_at(0, 0x28) == &cf->cf());
+    CHECK(nm.find_cf(name) == &cf->cf());
+
+    // Addresses set on the CF directly show up after the next update
+    cf->set_address(0x40);
+    nm.update(0);
+    CHECK(nm.cf_at(0, 0x28) == nullptr);
+    CHECK(nm.cf_at(0, 0x40) == &cf->cf());
+    CHECK(nm.cf_at(0, NULL_ADDRESS) == nullptr);
+}
+
+TEST_CASE("Claims bind partners and violations hit the address table") {
+    Pair pair;
+    Name name_a = Name::build().set_identity_number(1).set_function_code(130);
+    Name name_b = Name::build().set_identity_number(2).set_function_code(30).set_self_configurable(true);
+    auto *cf_a = pair.nm_a.create_internal(name_a, 0, 0x28).value();
+    pair.nm_b.create_internal(name_b, 0, 0x30);
+
+    dp::Vector<NameFilter> filters = {{NameFilterField::FunctionCode, 130}};
+    auto *partner = pair.nm_b.create_partner(0, std::move(filters)).value();
+    u32 found = 0;
+    partner->on_partner_found.subscribe([&](Address) { ++found; });
+
+    pair.nm_a.start_address_claiming();
+    pair.nm_b.start_address_claiming();
+    for (i32 i = 0; i < 40; ++i)
+        pair.tick();
+    REQUIRE(cf_a->claim_state() == ClaimState::Claimed);
+    CHECK(found == 1);
+    CHECK(partner->address() == 0x28);
+    CHECK(pair.nm_b.cf_at(0, 0x28) == &partner->cf());
+    CHECK(pair.nm_b.find_cf(name_a) == &partner->cf());
+
+    // A's claim again (request for claim answered): the cached match is reused
+    pair.nm_a.send_frame(Frame::from_message(Priority::Default, PGN_ADDRESS_CLAIMED, 0x28, BROADCAST_ADDRESS,
+                                             name_a.to_bytes().data(), 8));
+    pair.tick();
+    CHECK(found == 2);
+    CHECK(pair.nm_b.directory().partner_matches(0, name_a) != nullptr);
+
+    // B transmits from A's claimed address: A re-asserts its claim
+    Address violated = NULL_ADDRESS;
+    pair.nm_a.on_address_violation.subscribe([&](Address a) { violated = a; });
+    pair.nm_b.send_frame(Frame::from_message(Priority::Default, 0xFEF1, 0x28, BROADCAST_ADDRESS, nullptr, 0));
+    pair.tick();
+    CHECK(violated == 0x28);
+}
+
+TEST_CASE("CFDirectory indexes partners by compiled filters") {
+    CFDirectory dir;
+    dir.add_partner(2, 0, NameMatcher::compile({{NameFilterField::FunctionCode, 130}}));
+    dp::Vector<NameFilter> tc_filters = {{NameFilterField::FunctionCode, 130}, {NameFilterField::IndustryGroup, 2}};
+    dir.add_partner(0, 0, NameMatcher::compile(tc_filters));
+    dir.add_partner(1, 0, NameMatcher::compile({{NameFilterField::FunctionCode, 29}}));
+    dir.add_partner(3, 1, NameMatcher::compile({{NameFilterField::FunctionCode, 130}}));
+    dp::Vector<NameFilter> impossible = {{NameFilterField::FunctionCode, 1}, {NameFilterField::FunctionCode, 2}};
+    dir.add_partner(4, 0, NameMatcher::compile(impossible));
+
+    Name tc = Name::build().set_function_code(130).set_industry_group(2);
+    auto hits = dir.match_partners(0, tc);
+    REQUIRE(hits.size() == 2);
+    CHECK(hits[0] == 0); // Slot order across mask groups
+    CHECK(hits[1] == 2);
+    CHECK(dir.match_partners(0, Name::build().set_function_code(130)).size() == 1);
+    CHECK(dir.match_partners(1, tc).size() == 1);
+
+    dir.remove_partner(2);
+    hits = dir.match_partners(0, tc);
+    REQUIRE(hits.size() == 1);
+    CHECK(hits[0] == 0);
+}
@@ -0,0 +1,78 @@
+#include <doctest/doctest.h>
+#include <agrobus/net/claim_cache.hpp>
+#include <agrobus/net/network_manager.hpp>
+
+using namespace agrobus::net;
+
+TEST_CASE("ClaimCache round-trips through its blob") {
+    ClaimCache cache;
+    cache.name = Name::build().set_identity_number(42).set_function_code(130);
+    cache.address = 0x91;
+    cache.bus.push_back({Name::build().set_identity_number(1), 0x26});
+    cache.bus.push_back({Name::build().set_identity_number(2), 0x80});
+
+    auto blob = cache.encode();
+    CHECK(blob.size() == 12 + 2 * 9);
+    auto back = ClaimCache::decode(blob);
+    REQUIRE(back);
+    CHECK(back->name == cache.name);
+    CHECK(back->address == 0x91);
+    REQUIRE(back->bus.size() == 2);
+    CHECK(back->bus[1].name == Name::build().set_identity_number(2));
+    CHECK(back->bus[1].address == 0x80);
+
+    // Truncated or foreign blobs are rejected
+    blob.pop_back();
+    CHECK_FALSE(ClaimCache::decode(blob));
+    dp::Vector<u8> junk(20, 0x00);
+    CHECK_FALSE(ClaimCache::decode(junk));
+
+    // Start where we ended, unless the cache saw someone else there
+    CHECK(cache.start_address(cache.name, 0x80) == 0x91);
+    CHECK(cache.start_address(Name::build().set_identity_number(7), 0x80) == 0x80);
+    cache.bus.push_back({Name::build().set_identity_number(3), 0x91});
+    CHECK(cache.start_address(cache.name, 0x80) == 0x80);
+}
+
+TEST_CASE("A restored claim starts at the cached address") {
+    Name name = Name::build().set_identity_number(42).set_self_configurable(true);
+    ClaimCache previous;
+    previous.name = name;
+    previous.address = 0x91; // Had to move off 0x80 last time
+
+    dp::Vector<u8> stored;
+    {
+        IsoNet nm;
+        u32 stores = 0;
+        nm.set_claim_store([&](const ClaimCache &cache) {
+            stored = cache.encode();
+            ++stores;
+        });
+        auto *cf = nm.create_internal(name, 0, 0x80).value();
+        REQUIRE(nm.restore_claim(cf, previous).is_ok());
+        REQUIRE(nm.start_address_claiming().is_ok());
+        CHECK(cf->address() == 0x91);
+        CHECK(nm.cf_at(0, 0x91) == &cf->cf());
+
+        nm.update(300);
+        CHECK(cf->claim_state() == ClaimState::Claimed);
+        CHECK(cf->address() == 0x91);
+        CHECK(stores == 1);
+        nm.update(300);
+        CHECK(stores == 1); // Only when a claim completes
+    }
+
+    // Next key-on: feed the stored blob back
+    IsoNet nm;
+    auto *cf = nm.create_internal(name, 0, 0x80).value();
+    auto cache = ClaimCache::decode(stored);
+    REQUIRE(cache);
+    CHECK(cache->address == 0x91);
+    REQUIRE(nm.restore_claim(cf, *cache).is_ok());
+    REQUIRE(nm.start_address_claiming().is_ok());
+    CHECK(cf->address() == 0x91);
+
+    // A cache of another CF is refused
+    auto *other = nm.create_internal(Name::build().set_identity_number(43), 0, 0x81).value();
+    CHECK_FALSE(nm.restore_claim(other, *cache).is_ok());
+}
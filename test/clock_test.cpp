@@ -0,0 +1,83 @@
+#include <doctest/doctest.h>
+#include <agrobus/net/clock.hpp>
+#include <agrobus/net/loopback_bus.hpp>
+#include <chrono>
+
+using namespace agrobus::net;
+
+TEST_CASE("Simulated clocks hand out exact steps") {
+    Clock fast = Clock::as_fast_as_possible();
+    CHECK(fast.is_simulated());
+    CHECK(fast.now_us() == 0);
+    CHECK(fast.tick(10) == 10);
+    CHECK(fast.tick(5) == 5);
+    CHECK(fast.now_ms() == 15);
+    fast.advance_ms(100);
+    CHECK(fast.now_us() == 115000);
+
+    // 100× real time: 200 ms of clock time in about 2 ms of wall time
+    Clock paced = Clock::simulated(100.0);
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < 20; ++i)
+        CHECK(paced.tick(10) == 10);
+    auto wall = std::chrono::steady_clock::now() - start;
+    CHECK(paced.now_ms() == 200);
+    CHECK(wall >= std::chrono::microseconds(1900));
+    CHECK(wall < std::chrono::milliseconds(150));
+
+    Clock real = Clock::real_time();
+    CHECK_FALSE(real.is_simulated());
+    CHECK(real.tick(2) >= 2);
+    real.advance_ms(1000); // No effect
+}
+
+TEST_CASE("TickLoop drives subsystems from one clock") {
+    struct Counter {
+        u64 total = 0;
+        u32 calls = 0;
+        void update(u32 ms) {
+            total += ms;
+            ++calls;
+        }
+    } counter;
+    Clock clock = Clock::as_fast_as_possible();
+    TickLoop loop(clock, 5);
+    u64 us = 0;
+    loop.add(counter).add_us([&](u64 step_us) { us += step_us; });
+    loop.run_for(100);
+    CHECK(counter.calls == 20);
+    CHECK(counter.total == 100);
+    CHECK(us == 100000);
+    CHECK(clock.now_ms() == 100);
+
+    CHECK(loop.run_until([&] { return counter.total >= 150; }, 1000));
+    CHECK(clock.now_ms() == 150);
+    CHECK_FALSE(loop.run_until([] { return false; }, 20));
+    CHECK(clock.now_ms() == 170);
+}
+
+TEST_CASE("A simulated multi-ECU run is the same at any speed") {
+    auto run = [](Clock clock) {
+        LoopbackBus bus(LoopbackConfig{}.timed(250000));
+        IsoNet a;
+        IsoNet b;
+        bus.attach(a);
+        bus.attach(b);
+        auto *cf_a = a.create_internal(Name::build().set_identity_number(1), 0, 0x28).value();
+        auto *cf_b = b.create_internal(Name::build().set_identity_number(2), 0, 0x30).value();
+        a.start_address_claiming();
+        b.start_address_claiming();
+
+        TickLoop loop(clock);
+        loop.add(a).add(b).add_us([&](u64 us) { bus.advance(us); });
+        bool claimed = loop.run_until(
+            [&] { return cf_a->claim_state() == ClaimState::Claimed && cf_b->claim_state() == ClaimState::Claimed; },
+            5000);
+        CHECK(claimed);
+        return std::make_pair(clock.now_ms(), bus.frames());
+    };
+    auto fast = run(Clock::as_fast_as_possible());
+    auto paced = run(Clock::simulated(1000.0));
+    CHECK(fast == paced);
+    CHECK(fast.first >= ADDRESS_CLAIM_TIMEOUT_MS);
+}
@@ -75,3 +75,53 @@ TEST_CASE("PartnerCF matching") {
         CHECK(!partner.matches_name(name));
     }
 }
+
+TEST_CASE("NameMatcher agrees with the filters it was compiled from") {
+    const NameFilterField fields[] = {
+        NameFilterField::IdentityNumber, NameFilterField::ManufacturerCode, NameFilterField::ECUInstance,
+        NameFilterField::FunctionInstance, NameFilterField::FunctionCode, NameFilterField::DeviceClass,
+        NameFilterField::DeviceClassInstance, NameFilterField::IndustryGroup
+    };
+
+    SUBCASE("one AND and compare per NAME") {
+        u64 seed = 0x9E3779B97F4A7C15ULL;
+        auto next = [&]() {
+            seed ^= seed << 13;
+            seed ^= seed >> 7;
+            seed ^= seed << 17;
+            return seed;
+        };
+        for (u32 round = 0; round < 2000; ++round) {
+            Name name(next());
+            dp::Vector<NameFilter> filters;
+            for (u32 k = 0; k < 1 + round % 4; ++k) {
+                NameFilterField field = fields[next() % 8];
+                // Half the time take the NAME's own value so matches happen
+                u32 own = static_cast<u32>((name.raw & NameFilter::field_mask(field)) >>
+                                           NameFilter::field_shift(field));
+                filters.push_back({field, (next() & 1) ? own : static_cast<u32>(next() % 300)});
+            }
+            bool expected = true;
+            for (const auto &f : filters)
+                expected = expected && f.matches(name);
+            CHECK(NameMatcher::compile(filters).matches(name) == expected);
+        }
+    }
+
+    SUBCASE("contradicting and out-of-range filters never match") {
+        Name name;
+        name.set_function_code(100);
+        dp::Vector<NameFilter> both = {{NameFilterField::FunctionCode, 100}, {NameFilterField::FunctionCode, 101}};
+        CHECK_FALSE(NameMatcher::compile(both).can_match());
+        CHECK_FALSE(NameMatcher::compile(both).matches(name));
+
+        dp::Vector<NameFilter> wide = {{NameFilterField::ECUInstance, 9}};
+        CHECK_FALSE(NameMatcher::compile(wide).matches(Name(~0ULL)));
+    }
+
+    SUBCASE("no filters match everything") {
+        NameMatcher any = NameMatcher::compile({});
+        CHECK(any.mask == 0);
+        CHECK(any.matches(Name(0x1234)));
+    }
+}
@@ -0,0 +1,173 @@
+#include <doctest/doctest.h>
+#include <agrobus/j1939/pgn_request.hpp>
+#include <agrobus/net/coro.hpp>
+#include <agrobus/net/network_manager.hpp>
+#include <wirebit/can/can_endpoint.hpp>
+#include <wirebit/can/socketcan_link.hpp>
+
+using namespace agrobus::net;
+using agrobus::j1939::PGNRequestProtocol;
+
+namespace {
+
+    // Two IsoNets on one vcan interface
+    struct Pair {
+        std::shared_ptr<wirebit::SocketCanLink> link_a;
+        std::shared_ptr<wirebit::SocketCanLink> link_b;
+        wirebit::CanEndpoint ep_a;
+        wirebit::CanEndpoint ep_b;
+        IsoNet nm_a;
+        IsoNet nm_b;
+        InternalCF *cf_a = nullptr;
+        InternalCF *cf_b = nullptr;
+
+        Pair()
+            : link_a(std::make_shared<wirebit::SocketCanLink>(
+                  wirebit::SocketCanLink::create(
+                      {.interface_name = "vcan_coro", .create_if_missing = true, .destroy_on_close = true})
+                      .value())),
+              link_b(std::make_shared<wirebit::SocketCanLink>(wirebit::SocketCanLink::attach("vcan_coro").value())),
+              ep_a(link_a, wirebit::CanConfig{}, 1), ep_b(link_b, wirebit::CanConfig{}, 2) {
+            nm_a.set_endpoint(0, &ep_a);
+            nm_b.set_endpoint(0, &ep_b);
+            cf_a = nm_a.create_internal(Name::build().set_identity_number(1).set_manufacturer_code(100), 0, 0x28)
+                       .value();
+            cf_b = nm_b.create_internal(Name::build().set_identity_number(2).set_manufacturer_code(200), 0, 0x30)
+                       .value();
+        }
+
+        void tick(u32 elapsed_ms = 10) {
+            nm_a.update(elapsed_ms);
+            nm_b.update(elapsed_ms);
+            nm_a.update(0);
+            nm_b.update(0);
+        }
+    };
+
+} // namespace
+
+TEST_CASE("Task flows resume on messages and time out") {
+    IsoNet nm;
+    auto wait_speed = [&](Address source) -> Task<Result<Message>> {
+        co_return co_await nm.receive(0xFE48, source, 100);
+    };
+
+    Task<Result<Message>> from_80 = wait_speed(0x80);
+    Task<Result<Message>> from_81 = wait_speed(0x81);
+    CHECK_FALSE(from_80.done());
+    CHECK(nm.pending_awaits() == 2);
+
+    nm.inject_message(Message(0xFE48, {0x88, 0x13}, 0x80));
+    REQUIRE(from_80.done());
+    REQUIRE(from_80.result().is_ok());
+    CHECK(from_80.result().value().get_u16_le(0) == 5000);
+    CHECK_FALSE(from_81.done());
+
+    nm.update(99);
+    CHECK_FALSE(from_81.done());
+    nm.update(1);
+    REQUIRE(from_81.done());
+    CHECK_FALSE(from_81.result().is_ok());
+    CHECK(from_81.result().error().code == ErrorCode::Timeout);
+    CHECK(nm.pending_awaits() == 0);
+}
+
+TEST_CASE("Task flows sleep, chain and run many at once") {
+    IsoNet nm;
+    dp::Vector<u64> woke;
+    auto ticker = [&]() -> Task<Result<void>> {
+        for (u32 i = 0; i < 3; ++i) {
+            co_await nm.sleep(50);
+            woke.push_back(nm.timers().now_ms());
+        }
+        co_return Result<void>{};
+    };
+    auto outer = [&]() -> Task<Result<u32>> {
+        auto r = co_await ticker();
+        if (!r.is_ok())
+            co_return Result<u32>::err(r.error());
+        co_return Result<u32>::ok(static_cast<u32>(woke.size()));
+    };
+
+    Task<Result<u32>> chained = outer();
+    nm.update(30);
+    nm.update(30);
+    nm.update(90);
+    REQUIRE(chained.done());
+    CHECK(chained.result().value() == 3);
+    REQUIRE(woke.size() == 3);
+    CHECK(woke[2] == 150);
+
+    // One suspended frame per flow, no per-flow state machine
+    u32 finished = 0;
+    auto one = [&](Address source) -> Task<Result<void>> {
+        auto m = co_await nm.receive(0xFEF1, source);
+        if (m.is_ok())
+            ++finished;
+        co_return Result<void>{};
+    };
+    dp::Vector<Task<Result<void>>> flows;
+    for (u32 i = 0; i < 200; ++i)
+        flows.push_back(one(static_cast<Address>(i)));
+    CHECK(nm.pending_awaits() == 200);
+    for (u32 i = 0; i < 200; ++i)
+        nm.inject_message(Message(0xFEF1, {0x00}, static_cast<Address>(i)));
+    CHECK(finished == 200);
+    CHECK(nm.pending_awaits() == 0);
+
+    // Dropped tasks keep running detached
+    {
+        auto detached = one(0x42);
+    }
+    nm.inject_message(Message(0xFEF1, {0x00}, 0x42));
+    CHECK(finished == 201);
+}
+
+TEST_CASE("co_await request() between two nodes") {
+    Pair pair;
+    PGNRequestProtocol responder(pair.nm_b, pair.cf_b);
+    responder.initialize();
+    responder.register_responder(0xFEDA, []() { return dp::Vector<u8>{1, 2, 3, 4, 5, 6, 7, 8}; });
+
+    PGNRequestProtocol requester(pair.nm_a, pair.cf_a);
+    requester.initialize();
+
+    Task<Result<Message>> answered = requester.fetch(0xFEDA, 0x30, 500);
+    Task<Result<Message>> refused = requester.fetch(0xFEDB, 0x30, 500);
+    for (i32 i = 0; i < 20 && !(answered.done() && refused.done()); ++i)
+        pair.tick();
+
+    REQUIRE(answered.done());
+    REQUIRE(answered.result().is_ok());
+    CHECK(answered.result().value().source == 0x30);
+    CHECK(answered.result().value().data.size() == 8);
+    CHECK(answered.result().value().data[7] == 8);
+
+    REQUIRE(refused.done());
+    CHECK_FALSE(refused.result().is_ok());
+    CHECK(refused.result().error().code == ErrorCode::InvalidPGN);
+}
+
+TEST_CASE("co_await send_and_wait() completes with the TP transfer") {
+    Pair pair;
+    dp::Vector<u8> received;
+    pair.nm_b.register_pgn_callback(0xEF00, [&](const Message &msg) { received = msg.data; });
+
+    dp::Vector<u8> payload(100);
+    for (usize i = 0; i < payload.size(); ++i)
+        payload[i] = static_cast<u8>(i);
+    ControlFunction dest;
+    dest.address = 0x30;
+    Task<Result<void>> transfer = pair.nm_a.send_and_wait(0xEF00, payload, pair.cf_a, &dest, 5000);
+    CHECK_FALSE(transfer.done());
+
+    for (i32 i = 0; i < 100 && !transfer.done(); ++i)
+        pair.tick();
+    REQUIRE(transfer.done());
+    CHECK(transfer.result().is_ok());
+    CHECK(received.size() == 100);
+
+    // Single frames complete as soon as they are queued
+    Task<Result<void>> single = pair.nm_a.send_and_wait(0xEF00, {1, 2, 3}, pair.cf_a, &dest);
+    CHECK(single.done());
+}
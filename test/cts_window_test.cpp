@@ -0,0 +1,59 @@
+#include <doctest/doctest.h>
+#include <agrobus/net/cts_window.hpp>
+
+using namespace agrobus::net;
+
+namespace {
+    CtsWindowConfig adaptive_config() {
+        CtsWindowConfig cfg;
+        cfg.adaptive = true;
+        cfg.initial_packets = 16;
+        cfg.min_packets = 2;
+        cfg.max_packets = 64;
+        cfg.late_gap_ms = 50;
+        return cfg;
+    }
+} // namespace
+
+TEST_CASE("CtsWindowTuner fixed mode keeps 16 packet windows") {
+    CtsWindowTuner tuner;
+    CHECK_FALSE(tuner.adaptive());
+    CHECK(tuner.initial(0, 0x28) == TP_MAX_PACKETS_PER_CTS);
+    CHECK(tuner.window_done(0, 0x28, 0) == TP_MAX_PACKETS_PER_CTS);
+    tuner.failed(0, 0x28);
+    CHECK(tuner.initial(0, 0x28) == TP_MAX_PACKETS_PER_CTS);
+}
+
+TEST_CASE("CtsWindowTuner grows on clean windows up to the limit") {
+    CtsWindowTuner tuner(adaptive_config());
+    CHECK(tuner.initial(0, 0x28) == 16);
+    CHECK(tuner.window_done(0, 0x28, 5) == 32);
+    CHECK(tuner.window_done(0, 0x28, 5) == 64);
+    CHECK(tuner.window_done(0, 0x28, 5) == 64); // capped
+    CHECK(tuner.initial(0, 0x28) == 64);        // remembered for the next transfer
+    CHECK(tuner.initial(0, 0x29) == 16);        // per sender
+    CHECK(tuner.initial(1, 0x28) == 16);        // per port
+}
+
+TEST_CASE("CtsWindowTuner shrinks on late windows, failures and bus load") {
+    CtsWindowTuner tuner(adaptive_config());
+
+    SUBCASE("late window") { CHECK(tuner.window_done(0, 0x28, 80) == 8); }
+
+    SUBCASE("failure") {
+        tuner.failed(0, 0x28);
+        CHECK(tuner.initial(0, 0x28) == 8);
+        tuner.failed(0, 0x28);
+        tuner.failed(0, 0x28);
+        tuner.failed(0, 0x28);
+        CHECK(tuner.initial(0, 0x28) == 2); // floor
+    }
+
+    SUBCASE("high bus load") {
+        tuner.set_bus_load(0, 85.0f);
+        CHECK(tuner.initial(0, 0x28) == 8);
+        CHECK(tuner.window_done(0, 0x28, 0) == 8);
+        tuner.set_bus_load(0, 20.0f);
+        CHECK(tuner.window_done(0, 0x28, 0) == 16);
+    }
+}
@@ -1,5 +1,6 @@
 #include <doctest/doctest.h>
 #include <agrobus/j1939/diagnostic.hpp>
+#include <agrobus/net/loopback_bus.hpp>
 
 using namespace agrobus::j1939;
 
@@ -210,3 +211,119 @@ TEST_CASE("DM13 suspend duration tracking") {
         CHECK(!diag.is_dm1_suspended());
     }
 }
+
+TEST_CASE("DTCTable indexes by SPN/FMI and fills an erased slot with the last entry") {
+    DTCTable<DTC> table;
+    for (u32 spn = 1; spn <= 250; ++spn)
+        table.upsert(DTC{spn, FMI::VoltageLow, 1}, [](DTC &d) { ++d.occurrence_count; });
+    table.upsert(DTC{100, FMI::VoltageHigh, 1}, [](DTC &) {});
+    REQUIRE(table.size() == 251);
+    CHECK(table.find(100, FMI::VoltageLow) != table.find(100, FMI::VoltageHigh));
+    CHECK(table.find(251, FMI::VoltageLow) == nullptr);
+
+    u32 revision = table.revision();
+    table.upsert(DTC{7, FMI::VoltageLow, 1}, [](DTC &d) { ++d.occurrence_count; });
+    CHECK(table.find(7, FMI::VoltageLow)->occurrence_count == 2);
+    CHECK(table.revision() != revision);
+
+    // Erase moves the last entry into the gap; everything else stays put
+    REQUIRE(table.erase(3, FMI::VoltageLow).has_value());
+    CHECK_FALSE(table.erase(3, FMI::VoltageLow).has_value());
+    REQUIRE(table.size() == 250);
+    CHECK(table.find(100, FMI::VoltageHigh) == &table.entries()[2]);
+    CHECK(table.entries()[3].spn == 4);
+    CHECK(table.find(250, FMI::VoltageLow) == &table.entries().back());
+    REQUIRE(table.erase(250, FMI::VoltageLow).has_value()); // The last one itself
+    CHECK(table.size() == 249);
+    CHECK(table.find(249, FMI::VoltageLow) == &table.entries().back());
+
+    const auto &view = table;
+    CHECK(view.find(100, FMI::VoltageHigh) == &view.entries()[2]);
+    CHECK(view.find(3, FMI::VoltageLow) == nullptr);
+
+    CHECK(dtc_key(DTC{0x7FFFF, FMI::ConditionExists, 0}) == 0xFFFFFF);
+}
+
+TEST_CASE("DiagnosticProtocol caches DM1/DM2 encodings until the DTCs change") {
+    IsoNet nm;
+    auto *cf = nm.create_internal(Name::build().set_identity_number(1), 0, 0x28).value();
+    DiagnosticProtocol diag(nm, cf);
+
+    auto empty = diag.dm1_payload();
+    REQUIRE(empty->size() == 8);
+    CHECK(diag.dm1_payload() == empty); // Same buffer
+
+    for (u32 spn = 1; spn <= 200; ++spn)
+        diag.set_active({spn, FMI::AboveNormal, 0});
+    auto dm1 = diag.dm1_payload();
+    CHECK(dm1 != empty);
+    CHECK(dm1->size() == 2 + 200 * 4);
+    CHECK(diag.dm1_payload() == dm1);
+    CHECK(diag.is_active(150, FMI::AboveNormal));
+    CHECK(diag.find_active(150, FMI::AboveNormal)->occurrence_count == 1);
+
+    // A repeated set bumps the count, which is part of the encoding
+    diag.set_active({150, FMI::AboveNormal, 0});
+    auto bumped = diag.dm1_payload();
+    CHECK(bumped != dm1);
+    CHECK((*bumped)[2 + 149 * 4 + 3] == 2);
+
+    // Lamps are part of it too, but setting the same lamps again is not a change
+    DiagnosticLamps lamps;
+    lamps.amber_warning = LampStatus::On;
+    diag.set_lamps(lamps);
+    auto lit = diag.dm1_payload();
+    CHECK(lit != bumped);
+    diag.set_lamps(lamps);
+    CHECK(diag.dm1_payload() == lit);
+
+    // Clearing twice counts twice as previously active, listed once
+    REQUIRE(diag.clear_active(150, FMI::AboveNormal).is_ok());
+    diag.set_active({150, FMI::AboveNormal, 0});
+    REQUIRE(diag.clear_active(150, FMI::AboveNormal).is_ok());
+    CHECK(diag.active_dtcs().size() == 199);
+    CHECK(diag.previous_dtcs().size() == 1);
+    REQUIRE(diag.previously_active_dtcs().size() == 1);
+    CHECK(diag.previously_active_dtcs()[0].occurrence_count == 3);
+    auto dm2 = diag.dm2_payload();
+    CHECK((*dm2)[5] == 3);
+    CHECK(diag.dm2_payload() == dm2);
+    CHECK(diag.clear_active(150, FMI::AboveNormal).is_err());
+}
+
+TEST_CASE("DiagnosticProtocol auto-sends DM1 from the IsoNet timer wheel") {
+    LoopbackBus bus;
+    IsoNet ecu, tool;
+    auto *cf = ecu.create_internal(Name::build().set_identity_number(1), 0, 0x28).value();
+    tool.create_internal(Name::build().set_identity_number(2), 0, 0x30);
+    bus.attach(ecu);
+    bus.attach(tool);
+    REQUIRE(ecu.start_address_claiming().is_ok());
+    REQUIRE(tool.start_address_claiming().is_ok());
+    auto run = [&](u32 steps, u32 ms) {
+        for (u32 i = 0; i < steps; ++i) {
+            ecu.update(ms);
+            tool.update(ms);
+        }
+    };
+    run(40, 10);
+    REQUIRE(cf->claim_state() == ClaimState::Claimed);
+
+    u32 dm1s = 0;
+    tool.register_pgn_callback(PGN_DM1, [&](const Message &msg) {
+        if (msg.source == 0x28)
+            ++dm1s;
+    });
+    usize before = ecu.timers().size();
+    DiagnosticProtocol diag(ecu, cf, DiagnosticConfig{}.interval(100).enable_auto_send());
+    CHECK(ecu.timers().size() == before + 1);
+
+    // No diag.update() here: the network sends DM1 every 100 ms
+    run(10, 25);
+    CHECK(dm1s == 2);
+
+    diag.disable_auto_send();
+    CHECK(ecu.timers().size() == before);
+    run(10, 25);
+    CHECK(dm1s == 2);
+}
@@ -0,0 +1,139 @@
+#include <doctest/doctest.h>
+#include <agrobus/j1939/dm1_aggregator.hpp>
+#include <agrobus/net/loopback_bus.hpp>
+#include <memory>
+
+using namespace agrobus::j1939;
+
+namespace {
+    // A cab display aggregating DM1 from two ECUs on one loopback bus
+    struct Bus {
+        IsoNet display, engine, hitch;
+        InternalCF *display_cf = nullptr, *engine_cf = nullptr, *hitch_cf = nullptr;
+        std::unique_ptr<DiagnosticProtocol> engine_diag, hitch_diag;
+        LoopbackBus bus;
+
+        Bus() {
+            display_cf = display.create_internal(Name::build().set_identity_number(1), 0, 0x28).value();
+            engine_cf = engine.create_internal(Name::build().set_identity_number(2), 0, 0x00).value();
+            hitch_cf = hitch.create_internal(Name::build().set_identity_number(3), 0, 0x90).value();
+            bus.attach(display);
+            bus.attach(engine);
+            bus.attach(hitch);
+            REQUIRE(display.start_address_claiming().is_ok());
+            REQUIRE(engine.start_address_claiming().is_ok());
+            REQUIRE(hitch.start_address_claiming().is_ok());
+            run(40);
+            engine_diag = std::make_unique<DiagnosticProtocol>(engine, engine_cf);
+            hitch_diag = std::make_unique<DiagnosticProtocol>(hitch, hitch_cf);
+        }
+
+        void run(u32 steps, u32 ms = 10) {
+            for (u32 i = 0; i < steps; ++i) {
+                display.update(ms);
+                engine.update(ms);
+                hitch.update(ms);
+            }
+        }
+    };
+} // namespace
+
+TEST_CASE("DM1Aggregator reports only DTC deltas per source") {
+    Bus b;
+    DM1Aggregator agg(b.display);
+    REQUIRE(agg.initialize().is_ok());
+
+    dp::Vector<DTCChange> seen;
+    agg.on_changes.subscribe([&](Address, const dp::Vector<DTCChange> &changes) {
+        for (const auto &c : changes)
+            seen.push_back(c);
+    });
+
+    // Multi-DTC DM1 goes out over BAM
+    for (u32 spn = 100; spn < 110; ++spn)
+        b.engine_diag->set_active({spn, FMI::AboveNormal, 0});
+    b.hitch_diag->set_active({520, FMI::VoltageLow, 0});
+    REQUIRE(b.engine_diag->send_dm1().is_ok());
+    REQUIRE(b.hitch_diag->send_dm1().is_ok());
+    b.run(100);
+
+    REQUIRE(seen.size() == 11);
+    CHECK(agg.active_count() == 11);
+    CHECK(agg.sources().size() == 2);
+    REQUIRE(agg.source(0x00) != nullptr);
+    CHECK(agg.source(0x00)->dtcs.size() == 10);
+    CHECK(agg.source(0x90)->dtcs.contains(520, FMI::VoltageLow));
+    for (const auto &c : seen)
+        CHECK(c.kind == DTCChangeKind::Added);
+
+    // The same DM1 again is no change
+    seen.clear();
+    u32 revision = agg.revision();
+    REQUIRE(b.engine_diag->send_dm1().is_ok());
+    b.run(100);
+    CHECK(seen.empty());
+    CHECK(agg.revision() == revision);
+
+    // One cleared, one repeated
+    REQUIRE(b.engine_diag->clear_active(103, FMI::AboveNormal).is_ok());
+    b.engine_diag->set_active({107, FMI::AboveNormal, 0});
+    REQUIRE(b.engine_diag->send_dm1().is_ok());
+    b.run(100);
+    REQUIRE(seen.size() == 2);
+    CHECK(seen[0].kind == DTCChangeKind::OccurrenceIncreased);
+    CHECK(seen[0].dtc.spn == 107);
+    CHECK(seen[0].previous_count == 1);
+    CHECK(seen[0].dtc.occurrence_count == 2);
+    CHECK(seen[1].kind == DTCChangeKind::Cleared);
+    CHECK(seen[1].dtc.spn == 103);
+    CHECK(agg.active_count() == 10);
+
+    usize merged = 0;
+    agg.for_each_active([&](Address, const DTC &) { ++merged; });
+    CHECK(merged == 10);
+}
+
+TEST_CASE("DM1Aggregator tracks lamps and forgets silent sources") {
+    Bus b;
+    DM1Aggregator agg(b.display, DM1AggregatorConfig{}.timeout(500));
+    REQUIRE(agg.initialize().is_ok());
+
+    u32 lamp_events = 0;
+    dp::Vector<Address> lost;
+    dp::Vector<DTCChange> seen;
+    agg.on_lamps_changed.subscribe([&](Address, const DiagnosticLamps &) { ++lamp_events; });
+    agg.on_source_lost.subscribe([&](Address a) { lost.push_back(a); });
+    agg.on_changes.subscribe([&](Address, const dp::Vector<DTCChange> &changes) {
+        for (const auto &c : changes)
+            seen.push_back(c);
+    });
+
+    // No DTCs and lamps off: known source, nothing to report
+    REQUIRE(b.hitch_diag->send_dm1().is_ok());
+    b.run(10);
+    CHECK(agg.source(0x90) != nullptr);
+    CHECK(lamp_events == 0);
+    CHECK(seen.empty());
+
+    DiagnosticLamps lamps;
+    lamps.amber_warning = LampStatus::On;
+    b.hitch_diag->set_lamps(lamps);
+    b.hitch_diag->set_active({520, FMI::VoltageLow, 0});
+    REQUIRE(b.hitch_diag->send_dm1().is_ok());
+    b.run(10);
+    CHECK(lamp_events == 1);
+    CHECK(agg.source(0x90)->lamps.amber_warning == LampStatus::On);
+    REQUIRE(seen.size() == 1);
+
+    // Silence past the timeout clears its DTCs
+    seen.clear();
+    agg.update(400);
+    CHECK(lost.empty());
+    agg.update(200);
+    REQUIRE(lost.size() == 1);
+    CHECK(lost[0] == 0x90);
+    REQUIRE(seen.size() == 1);
+    CHECK(seen[0].kind == DTCChangeKind::Cleared);
+    CHECK(agg.source(0x90) == nullptr);
+    CHECK(agg.active_count() == 0);
+}
@@ -0,0 +1,188 @@
+#include <doctest/doctest.h>
+#include <agrobus/j1939/dm_memory.hpp>
+#include <agrobus/net/loopback_bus.hpp>
+#include <memory>
+
+using namespace agrobus::j1939;
+
+namespace {
+    // An ECU serving DM14 one request at a time (Busy while it has one) and a service tool
+    struct Bus {
+        IsoNet tool, ecu;
+        InternalCF *tool_cf = nullptr, *ecu_cf = nullptr;
+        std::unique_ptr<MemoryAccessHandler> tool_mem, ecu_mem;
+        LoopbackBus bus;
+
+        dp::Vector<u8> memory;
+        dp::Optional<DM14Request> pending; // Accepted, DM16 not done yet
+        bool read_queued = false;
+        bool silent = false;
+        u32 busy_replies = 0;
+
+        Bus() : memory(64 * 1024) {
+            for (usize i = 0; i < memory.size(); ++i)
+                memory[i] = static_cast<u8>(i * 7 + (i >> 8));
+            tool_cf = tool.create_internal(Name::build().set_identity_number(1), 0, 0xF9).value();
+            ecu_cf = ecu.create_internal(Name::build().set_identity_number(2), 0, 0x00).value();
+            bus.attach(tool);
+            bus.attach(ecu);
+            REQUIRE(tool.start_address_claiming().is_ok());
+            REQUIRE(ecu.start_address_claiming().is_ok());
+            run(40);
+
+            tool_mem = std::make_unique<MemoryAccessHandler>(tool, tool_cf);
+            ecu_mem = std::make_unique<MemoryAccessHandler>(ecu, ecu_cf);
+            REQUIRE(tool_mem->initialize().is_ok());
+            REQUIRE(ecu_mem->initialize().is_ok());
+
+            ecu_mem->on_dm14_request.subscribe([this](DM14Request req, Address src) {
+                if (silent)
+                    return;
+                DM15Response resp;
+                resp.address = req.address;
+                resp.length = req.length;
+                if (pending) {
+                    ++busy_replies;
+                    resp.status = DM15Status::Busy;
+                } else {
+                    pending = req;
+                    read_queued = req.command == DM14Command::Read;
+                }
+                ecu_mem->send_response(resp, src);
+            });
+            ecu_mem->on_dm16_transfer.subscribe([this](DM16Transfer transfer, Address src) {
+                if (!pending || pending->command != DM14Command::Write)
+                    return;
+                for (usize i = 0; i < transfer.data.size(); ++i)
+                    memory[pending->address + i] = transfer.data[i];
+                DM15Response done;
+                done.status = DM15Status::Completed;
+                done.address = pending->address;
+                done.length = pending->length;
+                pending.reset();
+                ecu_mem->send_response(done, src);
+            });
+        }
+
+        void run(u32 steps, BulkMemoryTransfer *xfer = nullptr, u32 ms = 5) {
+            for (u32 i = 0; i < steps; ++i) {
+                tool.update(ms);
+                ecu.update(ms);
+                if (xfer)
+                    xfer->update(ms);
+                if (read_queued) {
+                    auto bytes = DataSpan(memory.data() + pending->address, pending->length);
+                    if (ecu_mem->send_data(DM16Transfer::of(bytes), tool_cf->address()).is_ok()) {
+                        read_queued = false;
+                        pending.reset();
+                    }
+                }
+            }
+        }
+
+        void run_until_done(BulkMemoryTransfer &xfer, u32 max_steps = 20000) {
+            for (u32 i = 0; i < max_steps && xfer.state() == BulkState::Running; ++i)
+                run(1, &xfer);
+        }
+    };
+} // namespace
+
+TEST_CASE("DM16Transfer encodes long blocks for TP") {
+    dp::Vector<u8> bytes(300, 0xA5);
+    auto transfer = DM16Transfer::of(DataSpan(bytes));
+    CHECK(transfer.num_bytes == DM16Transfer::LENGTH_IN_MESSAGE);
+    auto encoded = transfer.encode();
+    REQUIRE(encoded.size() == 301);
+    CHECK(DM16Transfer::decode(DataSpan(encoded)).data.size() == 300);
+
+    auto small = DM16Transfer::of(DataSpan(bytes.data(), 3)).encode();
+    REQUIRE(small.size() == 8);
+    CHECK(small[0] == 3);
+    CHECK(small[4] == 0xFF);
+    CHECK(DM16Transfer::decode(DataSpan(small)).data.size() == 3);
+}
+
+TEST_CASE("BulkMemoryTransfer reads a range in order through a window") {
+    Bus b;
+    BulkMemoryTransfer xfer(*b.tool_mem, BulkTransferConfig{}.block(1000).in_flight(2));
+
+    dp::Vector<u8> received;
+    u32 progress_events = 0;
+    BulkState finished = BulkState::Idle;
+    xfer.on_data.subscribe([&](u32 offset, DataSpan bytes) {
+        CHECK(offset == received.size());
+        received.insert(received.end(), bytes.begin(), bytes.end());
+    });
+    xfer.on_progress.subscribe([&](const BulkProgress &) { ++progress_events; });
+    xfer.on_finished.subscribe([&](BulkState state, const BulkProgress &) { finished = state; });
+
+    REQUIRE(xfer.read(0x00, 0x1000, 9500).is_ok());
+    CHECK(xfer.read(0x00, 0, 10).is_err()); // One at a time
+    b.run_until_done(xfer);
+
+    REQUIRE(finished == BulkState::Completed);
+    CHECK(progress_events == 10);
+    CHECK(xfer.progress().done == 9500);
+    CHECK(xfer.progress().bytes_per_second() > 0);
+    REQUIRE(received.size() == 9500);
+    bool same = true;
+    for (usize i = 0; i < received.size(); ++i)
+        same = same && received[i] == b.memory[0x1000 + i];
+    CHECK(same);
+}
+
+TEST_CASE("BulkMemoryTransfer writes, aborts and resumes from the confirmed offset") {
+    Bus b;
+    BulkMemoryTransfer xfer(*b.tool_mem, BulkTransferConfig{}.block(2000).in_flight(2));
+
+    dp::Vector<u8> image(12000);
+    for (usize i = 0; i < image.size(); ++i)
+        image[i] = static_cast<u8>(0xFF - (i & 0x7F));
+
+    u32 confirmed = 0;
+    xfer.on_progress.subscribe([&](const BulkProgress &p) {
+        confirmed = p.done;
+        if (p.done >= 4000 && xfer.state() == BulkState::Running)
+            xfer.abort();
+    });
+    REQUIRE(xfer.write(0x00, 0x2000, image).is_ok());
+    b.run_until_done(xfer);
+    REQUIRE(xfer.state() == BulkState::Aborted);
+    CHECK(confirmed == 4000);
+    CHECK(xfer.progress().done == 4000);
+
+    // Let the ECU finish whatever it had accepted
+    b.run(400);
+    b.pending.reset();
+
+    REQUIRE(xfer.resume().is_ok());
+    b.run_until_done(xfer);
+    REQUIRE(xfer.state() == BulkState::Completed);
+    CHECK(xfer.progress().done == 12000);
+    bool same = true;
+    for (usize i = 0; i < image.size(); ++i)
+        same = same && b.memory[0x2000 + i] == image[i];
+    CHECK(same);
+    CHECK(b.busy_replies > 0); // The second block in the window was turned away at least once
+}
+
+TEST_CASE("BulkMemoryTransfer fails after retries and resumes when the ECU answers again") {
+    Bus b;
+    BulkMemoryTransfer xfer(*b.tool_mem, BulkTransferConfig{}.block(512).timeout(200).retries(2));
+
+    BulkState finished = BulkState::Idle;
+    xfer.on_finished.subscribe([&](BulkState state, const BulkProgress &) { finished = state; });
+
+    b.silent = true;
+    REQUIRE(xfer.read(0x00, 0, 2048).is_ok());
+    b.run_until_done(xfer);
+    CHECK(finished == BulkState::Failed);
+    CHECK(xfer.progress().done == 0);
+
+    b.silent = false;
+    b.pending.reset();
+    REQUIRE(xfer.resume().is_ok());
+    b.run_until_done(xfer);
+    CHECK(finished == BulkState::Completed);
+    CHECK(xfer.progress().done == 2048);
+}
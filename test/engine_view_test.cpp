@@ -0,0 +1,124 @@
+#include <doctest/doctest.h>
+#include <agrobus/j1939/engine.hpp>
+#include <agrobus/j1939/spn_columns.hpp>
+#include <agrobus/j1939/transmission.hpp>
+
+using namespace agrobus::j1939;
+
+TEST_CASE("Lazy views agree with decode") {
+    SUBCASE("EEC1") {
+        EEC1 msg;
+        msg.engine_speed_rpm = 1850.5;
+        msg.actual_engine_percent = 63.0;
+        msg.driver_demand_percent = 70.0;
+        msg.starter_mode = 3;
+        auto bytes = msg.encode();
+        EEC1View view(bytes);
+        REQUIRE(view.valid());
+        auto full = EEC1::decode(bytes);
+        CHECK(view.engine_speed_rpm() == full.engine_speed_rpm);
+        CHECK(view.actual_engine_percent() == full.actual_engine_percent);
+        CHECK(view.driver_demand_percent() == full.driver_demand_percent);
+        CHECK(view.engine_torque_percent() == full.engine_torque_percent);
+        CHECK(view.source_address() == full.source_address);
+        CHECK(view.starter_mode() == 3);
+    }
+
+    SUBCASE("EngineTemp1") {
+        EngineTemp1 msg;
+        msg.coolant_temp_c = 88.0;
+        msg.oil_temp_c = 101.5;
+        auto bytes = msg.encode();
+        EngineTemp1View view(bytes);
+        auto full = view.decode();
+        CHECK(view.coolant_temp_c() == full.coolant_temp_c);
+        CHECK(view.oil_temp_c() == full.oil_temp_c);
+        CHECK(view.turbo_oil_temp_c() == full.turbo_oil_temp_c);
+    }
+
+    SUBCASE("FuelEconomy, VEP1 and AmbientConditions") {
+        FuelEconomy fuel;
+        fuel.fuel_rate_lph = 24.35;
+        fuel.throttle_position = 40.0;
+        auto fb = fuel.encode();
+        CHECK(FuelEconomyView(fb).fuel_rate_lph() == FuelEconomy::decode(fb).fuel_rate_lph);
+        CHECK(FuelEconomyView(fb).throttle_position() == FuelEconomy::decode(fb).throttle_position);
+
+        VEP1 vep;
+        vep.battery_voltage_v = 13.8;
+        auto vb = vep.encode();
+        CHECK(VEP1View(vb).battery_voltage_v() == VEP1::decode(vb).battery_voltage_v);
+        CHECK(VEP1View(vb).alternator_current_a() == VEP1::decode(vb).alternator_current_a);
+
+        AmbientConditions amb;
+        amb.ambient_air_temp_c = 21.5;
+        amb.barometric_pressure_kpa = 99.0;
+        auto ab = amb.encode();
+        CHECK(AmbientConditionsView(ab).ambient_air_temp_c() == AmbientConditions::decode(ab).ambient_air_temp_c);
+        CHECK(AmbientConditionsView(ab).barometric_pressure_kpa() ==
+              AmbientConditions::decode(ab).barometric_pressure_kpa);
+    }
+
+    SUBCASE("ETC1 and CruiseControl") {
+        ETC1 etc;
+        etc.current_gear = 4;
+        etc.selected_gear = -1;
+        etc.output_shaft_speed_rpm = 1200.0;
+        auto eb = etc.encode();
+        ETC1View ev(eb);
+        CHECK(ev.current_gear() == 4);
+        CHECK(ev.selected_gear() == -1);
+        CHECK(ev.output_shaft_speed_rpm() == ETC1::decode(eb).output_shaft_speed_rpm);
+
+        CruiseControl cc;
+        cc.wheel_speed_kmh = 12.5;
+        cc.park_brake = 1;
+        auto cb = cc.encode();
+        CruiseControlView cv(cb);
+        CHECK(cv.wheel_speed_kmh() == doctest::Approx(12.5));
+        CHECK(cv.park_brake() == 1);
+    }
+
+    SUBCASE("short frames are not valid") {
+        dp::Vector<u8> three(3, 0x00);
+        CHECK_FALSE(EEC1View(three).valid());
+        CHECK_FALSE(EEC2View(three).valid());
+        CHECK_FALSE(EngineHoursView(three).valid());
+        CHECK(EEC1::Codec::get<EEC1::SpeedField>(DataSpan(three)) == EEC1{}.engine_speed_rpm);
+    }
+}
+
+TEST_CASE("SpnColumns decodes chosen SPNs from captured frames") {
+    auto record = [](u64 ts, Address src, PGN pgn, const dp::Vector<u8> &bytes) {
+        CaptureRecord rec{};
+        rec.timestamp_us = ts;
+        rec.can_id = (3u << 26) | (pgn << 8) | src;
+        rec.dlc = static_cast<u8>(bytes.size());
+        for (usize i = 0; i < bytes.size() && i < 8; ++i)
+            rec.data[i] = bytes[i];
+        return rec;
+    };
+
+    SpnColumns<EEC1View, &EEC1View::engine_speed_rpm, &EEC1View::actual_engine_percent> cols(PGN_EEC1, 0x00);
+    cols.reserve(8);
+    for (u32 i = 0; i < 5; ++i) {
+        EEC1 msg;
+        msg.engine_speed_rpm = 1000.0 + 100.0 * i;
+        msg.actual_engine_percent = 10.0 * i;
+        CHECK(cols.add(record(1000 * i, 0x00, PGN_EEC1, msg.encode())));
+    }
+    EEC1 other;
+    CHECK_FALSE(cols.add(record(9000, 0x01, PGN_EEC1, other.encode())));        // Other engine
+    CHECK_FALSE(cols.add(record(9000, 0x00, PGN_TRANSMISSION_1, other.encode()))); // Other PGN
+    CHECK_FALSE(cols.add(record(9000, 0x00, PGN_EEC1, dp::Vector<u8>(4, 0x00))));  // Too short
+
+    REQUIRE(cols.rows() == 5);
+    CHECK(cols.timestamps()[4] == 4000);
+    CHECK(cols.column<0>()[0] == 1000.0);
+    CHECK(cols.column<0>()[4] == 1400.0);
+    CHECK(cols.column(1)[3] == 30.0);
+
+    cols.clear();
+    CHECK(cols.rows() == 0);
+    CHECK(cols.column<1>().empty());
+}
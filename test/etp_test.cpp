@@ -72,3 +72,183 @@ TEST_CASE("ETP RTS message format") {
               (static_cast<u32>(rts.data[7]) << 16);
     CHECK(pgn == 0xFECA);
 }
+
+TEST_CASE("ETP zero-copy send holds the payload until the session ends") {
+    ExtendedTransportProtocol etp;
+    auto payload = std::make_shared<dp::Vector<u8>>(2000, 0x5A);
+
+    auto result = etp.send_shared(0xFECA, payload, 0x28, 0x30);
+    REQUIRE(result.is_ok());
+    CHECK(result.value()[0].data[0] == etp_cm::RTS);
+    CHECK(payload.use_count() == 2);
+    CHECK(etp.send_shared(0xFECA, payload, 0x28, 0x30).is_err()); // same session key
+
+    etp.update(ETP_TIMEOUT_T1_MS + 1);
+    CHECK(payload.use_count() == 1);
+}
+
+namespace {
+    // Feed a complete ETP transfer (RTS, then DPO + DT per window) from 0x28 to 0x30
+    void feed_etp_transfer(ExtendedTransportProtocol &etp, const dp::Vector<u8> &payload, u8 window) {
+        u32 size = static_cast<u32>(payload.size());
+        Frame rts;
+        rts.id = Identifier::encode(Priority::Lowest, PGN_ETP_CM, 0x28, 0x30);
+        rts.data = {etp_cm::RTS, static_cast<u8>(size & 0xFF), static_cast<u8>((size >> 8) & 0xFF),
+                    static_cast<u8>((size >> 16) & 0xFF), 0x00, 0xCA, 0xFE, 0x00};
+        etp.process_frame(rts);
+
+        u32 total_packets = (size + 6) / 7;
+        for (u32 offset = 0; offset < total_packets; offset += window) {
+            u8 count = static_cast<u8>((total_packets - offset) < window ? (total_packets - offset) : window);
+            Frame dpo;
+            dpo.id = Identifier::encode(Priority::Lowest, PGN_ETP_CM, 0x28, 0x30);
+            dpo.data = {etp_cm::DPO, count, static_cast<u8>(offset & 0xFF), static_cast<u8>((offset >> 8) & 0xFF),
+                        static_cast<u8>((offset >> 16) & 0xFF), 0xCA, 0xFE, 0x00};
+            etp.process_frame(dpo);
+            for (u8 seq = 1; seq <= count; ++seq) {
+                Frame dt;
+                dt.id = Identifier::encode(Priority::Lowest, PGN_ETP_DT, 0x28, 0x30);
+                dt.data[0] = seq;
+                for (u8 j = 0; j < 7; ++j) {
+                    u32 idx = (offset + seq - 1) * 7 + j;
+                    dt.data[j + 1] = idx < size ? payload[idx] : 0xFF;
+                }
+                etp.process_frame(dt);
+            }
+        }
+    }
+} // namespace
+
+TEST_CASE("ETP streaming receive emits each window as a chunk") {
+    ExtendedTransportProtocol etp;
+    etp.stream_above(2000);
+
+    dp::Vector<u8> payload(3000);
+    for (usize i = 0; i < payload.size(); ++i)
+        payload[i] = static_cast<u8>(i * 7);
+
+    dp::Vector<u8> received;
+    usize chunks = 0;
+    etp.on_chunk.subscribe([&](TransportSession &session, u32 offset, DataSpan bytes) {
+        CHECK(session.streaming);
+        CHECK(offset == received.size()); // In order, no gaps
+        CHECK(bytes.size() <= 16 * 7);
+        for (usize i = 0; i < bytes.size(); ++i)
+            received.push_back(bytes[i]);
+        ++chunks;
+    });
+    bool completed = false;
+    etp.on_complete.subscribe([&](TransportSession &session) {
+        completed = true;
+        CHECK(session.data.empty());
+    });
+
+    feed_etp_transfer(etp, payload, 16);
+
+    CHECK(completed);
+    CHECK(chunks == (429 + 15) / 16);
+    REQUIRE(received.size() == payload.size());
+    bool same = true;
+    for (usize i = 0; i < payload.size(); ++i)
+        same = same && received[i] == payload[i];
+    CHECK(same);
+}
+
+TEST_CASE("ETP below the stream threshold reassembles the whole message") {
+    ExtendedTransportProtocol etp;
+    etp.stream_above(10000);
+
+    dp::Vector<u8> payload(3000, 0x42);
+    usize chunks = 0;
+    etp.on_chunk.subscribe([&](TransportSession &, u32, DataSpan) { ++chunks; });
+    usize received = 0;
+    etp.on_complete.subscribe([&](TransportSession &session) { received = session.data.size(); });
+
+    feed_etp_transfer(etp, payload, 16);
+
+    CHECK(chunks == 0);
+    CHECK(received == 3000);
+}
+
+TEST_CASE("ETP interleaves sessions and numbers DT frames per DPO group") {
+    ExtendedTransportProtocol etp;
+    dp::Vector<u8> a(2000, 0x11), b(2000, 0x22);
+    REQUIRE(etp.send(0xCB00, a, 0x28, 0x30).is_ok());
+    REQUIRE(etp.send(0xE700, b, 0x28, 0x26).is_ok());
+
+    auto cts = [&](Address from, u8 packets, PGN pgn) {
+        Frame f;
+        f.id = Identifier::encode(Priority::Lowest, PGN_ETP_CM, from, 0x28);
+        f.data = {etp_cm::CTS, packets, 1, 0, 0, static_cast<u8>(pgn & 0xFF), static_cast<u8>((pgn >> 8) & 0xFF),
+                  static_cast<u8>((pgn >> 16) & 0xFF)};
+        etp.process_frame(f);
+    };
+    cts(0x30, 3, 0xCB00);
+    cts(0x26, 3, 0xE700);
+
+    auto frames = etp.get_pending_data_frames();
+    REQUIRE(frames.size() == 8);
+    CHECK(frames[0].data[0] == etp_cm::DPO);
+    CHECK(frames[1].data[0] == etp_cm::DPO);
+    for (usize i = 2; i < 8; ++i) {
+        CHECK(frames[i].pgn() == PGN_ETP_DT);
+        CHECK(frames[i].destination() == (i % 2 == 0 ? 0x30 : 0x26));
+        CHECK(frames[i].data[0] == (i - 2) / 2 + 1);
+    }
+}
+
+TEST_CASE("ETP asks again for a lost DT instead of restarting the transfer") {
+    ExtendedTransportProtocol tx, rx;
+    dp::Vector<u8> payload(2000);
+    for (usize i = 0; i < payload.size(); ++i)
+        payload[i] = static_cast<u8>(i * 5);
+
+    dp::Vector<u8> got;
+    bool aborted = false;
+    rx.on_abort.subscribe([&](TransportSession &, TransportAbortReason) { aborted = true; });
+    tx.on_abort.subscribe([&](TransportSession &, TransportAbortReason) { aborted = true; });
+
+    auto run = [&] {
+        bool lost = false;
+        dp::Vector<Frame> to_rx = tx.send(0xCB00, payload, 0x28, 0x30).value();
+        for (int round = 0; round < 100 && !to_rx.empty(); ++round) {
+            dp::Vector<Frame> to_tx;
+            for (const auto &f : to_rx) {
+                // Packet 5 of the second window goes missing once
+                if (!lost && f.pgn() == PGN_ETP_DT && f.data[0] == 5 && round == 2) {
+                    lost = true;
+                    continue;
+                }
+                for (const auto &r : rx.process_frame(f))
+                    to_tx.push_back(r);
+            }
+            to_rx.clear();
+            for (const auto &f : to_tx) {
+                for (const auto &r : tx.process_frame(f))
+                    to_rx.push_back(r);
+            }
+            tx.get_pending_data_frames(to_rx);
+        }
+        return lost;
+    };
+
+    SUBCASE("reassembled") {
+        rx.on_complete.subscribe([&](TransportSession &s) { got = s.data; });
+        CHECK(run());
+        CHECK_FALSE(aborted);
+        CHECK(got == payload);
+    }
+
+    SUBCASE("streamed") {
+        rx.stream_above(1000);
+        rx.on_chunk.subscribe([&](TransportSession &, u32 offset, DataSpan bytes) {
+            CHECK(offset == got.size()); // The part before the gap is handed out first
+            for (usize i = 0; i < bytes.size(); ++i)
+                got.push_back(bytes[i]);
+        });
+        CHECK(run());
+        CHECK_FALSE(aborted);
+        CHECK(got == payload);
+    }
+}
+
@@ -67,3 +67,106 @@ TEST_CASE("Event subscribe/emit") {
         CHECK(val == 7);
     }
 }
+
+TEST_CASE("Event deferred removal and nested dispatch") {
+    SUBCASE("unsubscribe during dispatch") {
+        Event<i32> event;
+        i32 calls = 0;
+        ListenerToken self = INVALID_TOKEN;
+        self = event.subscribe([&](i32) {
+            ++calls;
+            event.unsubscribe(self);
+        });
+        event.subscribe([&](i32) { ++calls; });
+        event.emit(1);
+        CHECK(calls == 2);
+        CHECK(event.count() == 1);
+        event.emit(2);
+        CHECK(calls == 3);
+    }
+
+    SUBCASE("clear and re-emit from a listener") {
+        Event<i32> event;
+        i32 outer = 0;
+        i32 inner = 0;
+        event.subscribe([&](i32 v) {
+            ++outer;
+            if (v == 1)
+                event.emit(2); // Nested dispatch
+            else
+                event.clear();
+        });
+        event.subscribe([&](i32) { ++inner; });
+        event.emit(1);
+        CHECK(outer == 2);
+        CHECK(inner == 0); // Cleared by the nested emit before reaching it
+        CHECK(event.count() == 0);
+    }
+
+    SUBCASE("listeners added during dispatch run from the next emit") {
+        Event<> event;
+        i32 added = 0;
+        event.subscribe([&]() {
+            if (added == 0)
+                event.subscribe([&]() { ++added; });
+        });
+        event.emit();
+        CHECK(added == 0);
+        event.emit();
+        CHECK(added == 1);
+    }
+}
+
+TEST_CASE("Delegate storage") {
+    SUBCASE("small callables are stored inline and copy/move") {
+        i32 hits = 0;
+        Delegate<void(i32)> d = [&hits](i32 v) { hits += v; };
+        Delegate<void(i32)> copy = d;
+        Delegate<void(i32)> moved = std::move(d);
+        CHECK_FALSE(static_cast<bool>(d));
+        copy(2);
+        moved(3);
+        CHECK(hits == 5);
+    }
+
+    SUBCASE("large callables fall back to the heap") {
+        dp::Array<u64, 16> big = {};
+        big[15] = 7;
+        Delegate<u64()> d = [big]() { return big[15]; };
+        Delegate<u64()> copy = d;
+        CHECK(d() == 7);
+        CHECK(copy() == 7);
+    }
+
+    SUBCASE("empty std::function makes an empty delegate") {
+        std::function<void()> empty;
+        Delegate<void()> d = empty;
+        CHECK_FALSE(static_cast<bool>(d));
+        Event<> event;
+        event.subscribe(empty);
+        event.emit(); // Skipped, not called
+        CHECK(event.count() == 1);
+    }
+}
+
+TEST_CASE("StaticEvent fixed listener slots") {
+    StaticEvent<2, i32> event;
+    i32 sum = 0;
+    auto a = event.subscribe([&](i32 v) { sum += v; });
+    auto b = event.subscribe([&](i32 v) { sum += v * 10; });
+    CHECK(a != INVALID_TOKEN);
+    CHECK(b != INVALID_TOKEN);
+    CHECK(event.subscribe([](i32) {}) == INVALID_TOKEN); // Full
+    event.emit(1);
+    CHECK(sum == 11);
+
+    CHECK(event.unsubscribe(a));
+    CHECK(event.count() == 1);
+    CHECK(event.subscribe([&](i32 v) { sum += v * 100; }) != INVALID_TOKEN); // Slot reused
+    sum = 0;
+    event.emit(1);
+    CHECK(sum == 110);
+
+    event.clear();
+    CHECK(event.count() == 0);
+}
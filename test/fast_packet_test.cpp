@@ -62,6 +62,26 @@ TEST_CASE("Fast Packet receive") {
     }
 }
 
+TEST_CASE("Fast Packet receive carries first and last frame timestamps") {
+    FastPacketProtocol fp;
+    dp::Vector<u8> original(20, 0x11);
+    auto result = fp.send(PGN_GNSS_POSITION, original, 0x30);
+    REQUIRE(result.is_ok());
+    auto frames = result.value();
+    REQUIRE(frames.size() == 3);
+
+    FastPacketProtocol fp_rx;
+    dp::Optional<Message> msg;
+    for (usize i = 0; i < frames.size(); ++i) {
+        frames[i].timestamp_us = 5000 + i * 100;
+        msg = fp_rx.process_frame(frames[i]);
+    }
+
+    REQUIRE(msg.has_value());
+    CHECK(msg->first_timestamp_us == 5000);
+    CHECK(msg->timestamp_us == 5200);
+}
+
 TEST_CASE("Fast Packet bad sequence") {
     FastPacketProtocol fp;
 
@@ -86,3 +106,75 @@ TEST_CASE("Fast Packet bad sequence") {
     msg = fp.process_frame(f2);
     CHECK(!msg.has_value()); // Should be discarded
 }
+
+TEST_CASE("Fast Packet reassembly table is bounded with LRU eviction") {
+    FastPacketProtocol fp_tx;
+    FastPacketProtocol fp_rx(4);
+    CHECK(fp_rx.rx_capacity() == 4);
+
+    dp::Vector<u8> data(20, 0x5A);
+    dp::Vector<dp::Vector<Frame>> transfers;
+    for (u8 src = 0x30; src < 0x36; ++src)
+        transfers.push_back(fp_tx.send(PGN_GNSS_POSITION, data, src).value());
+
+    // First frames from 6 senders: the 2 least recently active are evicted
+    for (auto &t : transfers)
+        CHECK_FALSE(fp_rx.process_frame(t[0]).has_value());
+    CHECK(fp_rx.rx_active() == 4);
+    CHECK(fp_rx.rx_evictions() == 2);
+
+    usize completed = 0;
+    for (auto &t : transfers) {
+        for (usize i = 1; i < t.size(); ++i) {
+            if (fp_rx.process_frame(t[i]).has_value())
+                ++completed;
+        }
+    }
+    CHECK(completed == 4); // 0x30 and 0x31 were evicted
+    CHECK(fp_rx.rx_active() == 0);
+
+    const auto &m = fp_rx.metrics().total();
+    CHECK(m.started == 6);
+    CHECK(m.completed == 4);
+    CHECK(m.bytes == 80);
+    CHECK(m.aborts(TransportAbortReason::ResourcesUnavailable) == 2);
+}
+
+TEST_CASE("Fast Packet view path reassembles without a Message") {
+    FastPacketProtocol fp;
+    dp::Vector<u8> original(30);
+    for (usize i = 0; i < original.size(); ++i)
+        original[i] = static_cast<u8>(i + 1);
+    auto frames = fp.send(PGN_GNSS_POSITION, original, 0x30).value();
+
+    FastPacketProtocol fp_rx;
+    dp::Optional<MessageView> view;
+    for (const auto &f : frames)
+        view = fp_rx.process_frame_view(f);
+
+    REQUIRE(view.has_value());
+    CHECK(view->source == 0x30);
+    REQUIRE(view->size() == 30);
+    CHECK(view->data[0] == 1);
+    CHECK(view->data[29] == 30);
+}
+
+TEST_CASE("FastPacketRegistry lookup") {
+    FastPacketRegistry reg;
+    CHECK(reg.empty());
+    CHECK(reg.add(PGN_GNSS_POSITION_DATA));
+    CHECK_FALSE(reg.add(PGN_GNSS_POSITION_DATA));
+    CHECK(reg.add(0x0EF00)); // Outside the NMEA 2000 fast packet range
+    CHECK(reg.size() == 2);
+
+    CHECK(reg.contains(PGN_GNSS_POSITION_DATA));
+    CHECK(reg.contains(0x0EF00));
+    CHECK_FALSE(reg.contains(PGN_GNSS_POSITION_DATA + 1));
+    CHECK_FALSE(reg.contains(0x1F000 - 1));
+
+    dp::Vector<PGN> seen;
+    reg.for_each([&](PGN pgn) { seen.push_back(pgn); });
+    REQUIRE(seen.size() == 2);
+    CHECK(seen[0] == PGN_GNSS_POSITION_DATA);
+    CHECK(seen[1] == 0x0EF00);
+}
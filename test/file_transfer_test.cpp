@@ -91,3 +91,68 @@ TEST_CASE("FileClient - state management") {
         CHECK_FALSE(opened);
     }
 }
+
+// ─── Read path over a loopback bus ────────────────────────────────────────────
+#include <agrobus/net/loopback_bus.hpp>
+
+TEST_CASE("FileServer - reads share the stored file") {
+    LoopbackBus bus;
+    IsoNet nm_fs;
+    IsoNet nm_ecu;
+    auto* fs_cf = nm_fs.create_internal(Name::build().set_identity_number(1), 0, 0xAA).value();
+    auto* ecu_cf = nm_ecu.create_internal(Name::build().set_identity_number(2), 0, 0x80).value();
+    bus.attach(nm_fs);
+    bus.attach(nm_ecu);
+    REQUIRE(nm_fs.start_address_claiming().is_ok());
+    REQUIRE(nm_ecu.start_address_claiming().is_ok());
+
+    FileServer server(nm_fs, fs_cf);
+    REQUIRE(server.initialize().is_ok());
+    dp::Vector<u8> image(5000);
+    for (usize i = 0; i < image.size(); ++i)
+        image[i] = static_cast<u8>(i * 31);
+    REQUIRE(server.add_file("fw.bin", image).is_ok());
+
+    dp::Vector<dp::Vector<u8>> responses;
+    nm_ecu.register_pgn_callback(PGN_FILE_SERVER_TO_CLIENT, [&](const Message& msg) {
+        if (msg.data[0] != static_cast<u8>(FileOperation::GetServerStatus))
+            responses.push_back(msg.data);
+    });
+    auto run = [&](u32 steps) {
+        for (u32 i = 0; i < steps; ++i) {
+            nm_fs.update(5);
+            nm_ecu.update(5);
+        }
+    };
+    auto request = [&](dp::Vector<u8> data) {
+        ControlFunction fs;
+        fs.address = fs_cf->address();
+        REQUIRE(nm_ecu.send(PGN_FILE_CLIENT_TO_SERVER, data, ecu_cf, &fs).is_ok());
+        run(400);
+    };
+    run(60); // Address claims
+
+    dp::Vector<u8> open = {static_cast<u8>(FileOperation::OpenFile), 6, 'f', 'w', '.', 'b', 'i', 'n'};
+    request(open);
+    REQUIRE(responses.size() == 1);
+    REQUIRE(responses[0][1] == static_cast<u8>(FileTransferError::NoError));
+    u8 handle = responses[0][2];
+    CHECK(server.file_content("fw.bin").use_count() == 3); // Server, handle, this call
+
+    // 1500 bytes over TP, then the 3500 left over ETP
+    request({static_cast<u8>(FileOperation::ReadData), handle, 0xDC, 0x05, 0xFF, 0xFF, 0xFF, 0xFF});
+    request({static_cast<u8>(FileOperation::ReadData), handle, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF});
+    request({static_cast<u8>(FileOperation::ReadData), handle, 0x10, 0x00, 0xFF, 0xFF, 0xFF, 0xFF});
+    REQUIRE(responses.size() == 4);
+    CHECK(responses[1].size() == 4 + 1500);
+    CHECK(responses[2].size() == 4 + 3500);
+    CHECK((responses[2][2] | (responses[2][3] << 8)) == 3500);
+    bool same = true;
+    for (usize i = 0; i < 1500; ++i)
+        same &= responses[1][4 + i] == image[i];
+    for (usize i = 0; i < 3500; ++i)
+        same &= responses[2][4 + i] == image[1500 + i];
+    CHECK(same);
+    CHECK(responses[3][1] == static_cast<u8>(FileTransferError::EndOfFile));
+    CHECK(responses[3].size() == 8);
+}
@@ -0,0 +1,166 @@
+#include <doctest/doctest.h>
+#include <agrobus/net/flight_recorder.hpp>
+#include <agrobus/net/loopback_bus.hpp>
+#include <agrobus/net/network_manager.hpp>
+
+using namespace agrobus::net;
+
+namespace {
+
+    Frame make_frame(u32 i, Address source = 0x28) {
+        u8 payload[8] = {static_cast<u8>(i), static_cast<u8>(i >> 8), 0, 0, 0, 0, 0, 0};
+        return Frame::from_message(Priority::Default, 0xFEF1, source, BROADCAST_ADDRESS, payload, 8);
+    }
+
+    struct Pair {
+        LoopbackBus bus;
+        IsoNet a{NetworkConfig{}.flight_recorder()};
+        IsoNet b{NetworkConfig{}.foreign_transport_filter()}; // Leaves a's TP to an absent CF unanswered
+        InternalCF *cf_a = nullptr;
+        InternalCF *cf_b = nullptr;
+
+        Pair() {
+            cf_a = a.create_internal(Name::build().set_identity_number(1), 0, 0x28).value();
+            cf_b = b.create_internal(Name::build().set_identity_number(2), 0, 0x30).value();
+            bus.attach(a);
+            bus.attach(b);
+            a.start_address_claiming();
+            b.start_address_claiming();
+            run(60);
+        }
+
+        void run(u32 steps) {
+            for (u32 i = 0; i < steps; ++i) {
+                a.update(10);
+                b.update(10);
+            }
+        }
+    };
+
+} // namespace
+
+TEST_CASE("FlightRecorder - rings keep the last frames of each port") {
+    FlightRecorder rec(FlightRecorderConfig{}.ports(2).frames(4).window(1));
+    for (u32 i = 0; i < 6; ++i)
+        rec.record(make_frame(i), 0, 0, 1000 + i * 100);
+    rec.record(make_frame(100), 1, capture_flags::TX, 1250);
+    rec.record(make_frame(101), 2, 0, 1300); // No such port
+    CHECK(rec.recorded() == 7);
+    CHECK(rec.held(0) == 4);
+    CHECK(rec.held(1) == 1);
+
+    auto frames = rec.snapshot();
+    REQUIRE(frames.size() == 5);
+    CHECK(frames[0].data[0] == 2); // 0 and 1 overwritten
+    CHECK(frames[0].timestamp_us == 1200);
+    CHECK(frames[1].port == 1); // Merged by time
+    CHECK(frames[1].flags == capture_flags::TX);
+    CHECK(frames[4].data[0] == 5);
+
+    // Frozen rings stop recording
+    FlightFreeze seen;
+    rec.on_freeze.subscribe([&](const FlightFreeze &f) { seen = f; });
+    CHECK(rec.freeze(FlightTrigger::Manual));
+    CHECK_FALSE(rec.freeze(FlightTrigger::Manual));
+    CHECK(seen.sequence == 1);
+    CHECK(seen.timestamp_us == 1500);
+    rec.record(make_frame(6), 0, 0, 2400);
+    CHECK(rec.snapshot().size() == 5);
+
+    // The window leaves old frames out
+    rec.thaw();
+    rec.record(make_frame(6), 0, 0, 2400);
+    auto recent = rec.snapshot();
+    REQUIRE(recent.size() == 3);
+    CHECK(recent[0].timestamp_us == 1400);
+    CHECK(recent[2].data[0] == 6);
+}
+
+TEST_CASE("FlightRecorder - lamps and a safety policy freeze it") {
+    FlightRecorder rec;
+    rec.lamps(0x10, 0x00);
+    CHECK_FALSE(rec.frozen());
+    rec.lamps(0x10, 0x04); // Red stop lamp on
+    REQUIRE(rec.frozen());
+    CHECK(rec.last_freeze().trigger == FlightTrigger::DiagnosticLamp);
+    CHECK(rec.last_freeze().source == 0x10);
+    rec.thaw();
+    rec.lamps(0x10, 0x04); // Still on: no new freeze
+    CHECK_FALSE(rec.frozen());
+    rec.lamps(0x10, 0xFF); // Not available is not on
+    rec.lamps(0x10, 0x04);
+    CHECK(rec.frozen());
+    rec.thaw();
+
+    SafetyPolicy policy;
+    rec.watch(policy);
+    policy.trigger_emergency("test");
+    CHECK(rec.frozen());
+    CHECK(rec.last_freeze().trigger == FlightTrigger::SafetyState);
+    CHECK(rec.freezes() == 3);
+}
+
+TEST_CASE("FlightRecorder - a dump is a capture file") {
+    const char *prefix = "/tmp/agrobus_flight_test_";
+    FlightRecorder rec(FlightRecorderConfig{}.frames(8).dump_to(prefix));
+    for (u32 i = 0; i < 10; ++i)
+        rec.record(make_frame(i), 0, i % 2 ? capture_flags::TX : 0, 5000 + i);
+    CHECK(rec.freeze(FlightTrigger::Manual));
+    CHECK_FALSE(rec.frozen()); // Written out, recording again
+
+    CaptureReader reader;
+    REQUIRE(reader.open("/tmp/agrobus_flight_test_1.cap").is_ok());
+    REQUIRE(reader.size() == 8);
+    CHECK(reader[0].data[0] == 2);
+    CHECK(reader[1].flags == capture_flags::TX);
+    CHECK(reader[7].timestamp_us == 5009);
+}
+
+TEST_CASE("IsoNet - the flight recorder holds both directions and freezes on faults") {
+    Pair p;
+    FlightRecorder *rec = p.a.flight_recorder();
+    REQUIRE(rec != nullptr);
+    CHECK(p.b.flight_recorder() == nullptr);
+    REQUIRE(p.cf_a->claim_state() == ClaimState::Claimed);
+
+    REQUIRE(p.a.send(0xFEF1, dp::Vector<u8>{1, 2, 3, 4, 5, 6, 7, 8}, p.cf_a).is_ok());
+    REQUIRE(p.b.send(0xFEF2, dp::Vector<u8>{8, 7, 6, 5, 4, 3, 2, 1}, p.cf_b).is_ok());
+    p.run(2);
+    auto frames = rec->snapshot();
+    bool sent = false, received = false;
+    for (const auto &r : frames) {
+        Frame f = r.frame();
+        sent = sent || (f.pgn() == 0xFEF1 && r.flags == capture_flags::TX);
+        received = received || (f.pgn() == 0xFEF2 && r.flags == 0 && f.source() == 0x30);
+    }
+    CHECK(sent);
+    CHECK(received);
+
+    // Address violation: the offending frame is the last one kept
+    p.b.send_frame(make_frame(0, 0x28));
+    p.run(1);
+    REQUIRE(rec->frozen());
+    CHECK(rec->last_freeze().trigger == FlightTrigger::AddressViolation);
+    CHECK(rec->last_freeze().source == 0x28);
+    CHECK(rec->snapshot().back().frame().source() == 0x28);
+    rec->thaw();
+
+    // DM1 with the amber warning lamp on
+    u8 dm1[8] = {0x10, 0x00, 0, 0, 0, 0, 0xFF, 0xFF};
+    p.b.send_frame(Frame::from_message(Priority::Default, PGN_DM1, 0x30, BROADCAST_ADDRESS, dm1, 8));
+    p.run(1);
+    REQUIRE(rec->frozen());
+    CHECK(rec->last_freeze().trigger == FlightTrigger::DiagnosticLamp);
+    CHECK(rec->last_freeze().source == 0x30);
+    rec->thaw();
+
+    // TP session nobody answers
+    ControlFunction absent;
+    absent.address = 0x55;
+    REQUIRE(p.a.send(0xEF00, dp::Vector<u8>(100, 0xAA), p.cf_a, &absent).is_ok());
+    p.run(200);
+    REQUIRE(rec->frozen());
+    CHECK(rec->last_freeze().trigger == FlightTrigger::TransportAbort);
+    CHECK(rec->last_freeze().source == 0x55);
+    CHECK(rec->freezes() == 3);
+}
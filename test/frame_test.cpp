@@ -1,6 +1,9 @@
 #include <doctest/doctest.h>
 #include <agrobus/net/frame.hpp>
 #include <agrobus/net/constants.hpp>
+#include <cstddef>
+#include <cstring>
+#include <linux/can.h>
 
 using namespace agrobus::net;
 
@@ -36,3 +39,31 @@ TEST_CASE("Frame construction") {
         CHECK(f.priority() == Priority::High);
     }
 }
+
+TEST_CASE("Frame header and can_frame layout") {
+    SUBCASE("header decodes the identifier once") {
+        Frame f;
+        f.id = Identifier::encode(Priority::High, PGN_REQUEST, 0x10, 0x20);
+        FrameHeader h = f.header();
+        CHECK(h.pgn == PGN_REQUEST);
+        CHECK(h.source == 0x10);
+        CHECK(h.destination == 0x20);
+        CHECK(h.priority == Priority::High);
+
+        f.id = Identifier::encode(Priority::Default, PGN_VEHICLE_SPEED, 0x28);
+        CHECK(f.header().destination == BROADCAST_ADDRESS);
+    }
+
+    SUBCASE("the first 16 bytes are a can_frame") {
+        CHECK(offsetof(Frame, length) == offsetof(can_frame, can_dlc));
+        CHECK(offsetof(Frame, data) == offsetof(can_frame, data));
+
+        u8 payload[] = {1, 2, 3, 4, 5, 6, 7, 8};
+        Frame f = Frame::from_message(Priority::Default, PGN_VEHICLE_SPEED, 0x28, BROADCAST_ADDRESS, payload);
+        can_frame cf;
+        std::memcpy(&cf, &f, sizeof(can_frame));
+        CHECK(cf.can_id == f.id.raw);
+        CHECK(cf.can_dlc == 8);
+        CHECK(cf.data[7] == 8);
+    }
+}
@@ -0,0 +1,149 @@
+#include <doctest/doctest.h>
+#include <agrobus/isobus/file_transfer.hpp>
+#include <agrobus/isobus/fs/io_worker.hpp>
+#include <agrobus/net/loopback_bus.hpp>
+#include <chrono>
+#include <cstdio>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+
+using namespace agrobus::net;
+using namespace agrobus::isobus;
+using namespace agrobus::isobus::fs;
+
+namespace {
+    const char *ROOT = "/tmp/agrobus_fs_io_worker_test";
+
+    dp::String file_path(const char *name) { return dp::String(ROOT) + "/" + name; }
+
+    dp::Vector<u8> pattern(usize n, u8 seed) {
+        dp::Vector<u8> out(n);
+        for (usize i = 0; i < n; ++i)
+            out[i] = static_cast<u8>(i * 13 + seed);
+        return out;
+    }
+
+    void write_file(const char *name, const dp::Vector<u8> &bytes) {
+        ::mkdir(ROOT, 0755);
+        FILE *f = std::fopen(file_path(name).c_str(), "wb");
+        REQUIRE(f != nullptr);
+        std::fwrite(bytes.data(), 1, bytes.size(), f);
+        std::fclose(f);
+    }
+} // namespace
+
+TEST_CASE("ReadWorker reads on its own thread") {
+    write_file("plain.bin", pattern(10000, 3));
+    int fd = ::open(file_path("plain.bin").c_str(), O_RDONLY);
+    REQUIRE(fd >= 0);
+
+    ReadWorker worker(2);
+    worker.start();
+    dp::Vector<u8> a(4000), b(4000);
+    CHECK(worker.submit({1, fd, 0, 4000, a.data()}));
+    CHECK(worker.submit({2, fd, 8000, 4000, b.data()})); // Runs past the end
+    CHECK_FALSE(worker.submit({3, fd, 0, 1, a.data()})); // Capacity reached
+    CHECK(worker.in_flight() == 2);
+
+    dp::Vector<i64> results(3, -2);
+    for (u32 i = 0; i < 1000 && worker.in_flight() > 0; ++i) {
+        worker.poll([&](const ReadJob &job) { results[job.id] = job.result; });
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+    worker.stop();
+    ::close(fd);
+    CHECK(results[1] == 4000);
+    CHECK(results[2] == 2000);
+    CHECK(a[3999] == static_cast<u8>(3999 * 13 + 3));
+    CHECK(b[0] == static_cast<u8>(8000 * 13 + 3));
+    std::remove(file_path("plain.bin").c_str());
+}
+
+TEST_CASE("FileServer reads ahead for several clients at once") {
+    const usize SIZE = 20000;
+    write_file("a.bin", pattern(SIZE, 1));
+    write_file("b.bin", pattern(SIZE, 2));
+
+    LoopbackBus bus;
+    IsoNet nm_fs, nm_a, nm_b;
+    auto *fs_cf = nm_fs.create_internal(Name::build().set_identity_number(1), 0, 0xAA).value();
+    auto *a_cf = nm_a.create_internal(Name::build().set_identity_number(2), 0, 0x80).value();
+    auto *b_cf = nm_b.create_internal(Name::build().set_identity_number(3), 0, 0x81).value();
+    bus.attach(nm_fs);
+    bus.attach(nm_a);
+    bus.attach(nm_b);
+    REQUIRE(nm_fs.start_address_claiming().is_ok());
+    REQUIRE(nm_a.start_address_claiming().is_ok());
+    REQUIRE(nm_b.start_address_claiming().is_ok());
+
+    FileServer server(nm_fs, fs_cf, FileServerConfig{}.path(ROOT).read_ahead(4096));
+    REQUIRE(server.initialize().is_ok());
+    REQUIRE(server.mount(FileStorageConfig{}.page_size(512).cache(4)).is_ok());
+
+    dp::Vector<dp::Vector<u8>> got_a, got_b;
+    // Every node sees every frame: keep the responses addressed to each client
+    auto collect = [](dp::Vector<dp::Vector<u8>> &out, Address self) {
+        return [&out, self](const Message &msg) {
+            if (msg.destination == self && msg.data[0] != static_cast<u8>(FileOperation::GetServerStatus))
+                out.push_back(msg.data);
+        };
+    };
+    nm_a.register_pgn_callback(PGN_FILE_SERVER_TO_CLIENT, collect(got_a, 0x80));
+    nm_b.register_pgn_callback(PGN_FILE_SERVER_TO_CLIENT, collect(got_b, 0x81));
+    auto step = [&]() {
+        nm_fs.update(5);
+        nm_a.update(5);
+        nm_b.update(5);
+        server.update(5);
+    };
+    auto send = [&](IsoNet &nm, InternalCF *cf, dp::Vector<u8> data) {
+        ControlFunction fs;
+        fs.address = fs_cf->address();
+        REQUIRE(nm.send(PGN_FILE_CLIENT_TO_SERVER, data, cf, &fs).is_ok());
+    };
+    auto wait = [&](usize a, usize b) {
+        for (u32 i = 0; i < 4000 && (got_a.size() < a || got_b.size() < b); ++i) {
+            step();
+            std::this_thread::sleep_for(std::chrono::microseconds(20));
+        }
+        REQUIRE(got_a.size() == a);
+        REQUIRE(got_b.size() == b);
+    };
+    for (u32 i = 0; i < 60; ++i)
+        step();
+
+    send(nm_a, a_cf, {static_cast<u8>(FileOperation::OpenFile), 5, 'a', '.', 'b', 'i', 'n'});
+    send(nm_b, b_cf, {static_cast<u8>(FileOperation::OpenFile), 5, 'b', '.', 'b', 'i', 'n'});
+    wait(1, 1);
+    u8 ha = got_a[0][2];
+    u8 hb = got_b[0][2];
+    CHECK(server.clients().is_connected(0x80));
+    CHECK(server.clients().is_connected(0x81));
+
+    // Both clients stream their file in 1000-byte reads, requests interleaved
+    dp::Vector<u8> file_a, file_b;
+    for (u32 n = 0; n < SIZE / 1000; ++n) {
+        send(nm_a, a_cf, {static_cast<u8>(FileOperation::ReadData), ha, 0xE8, 0x03, 0xFF, 0xFF, 0xFF, 0xFF});
+        send(nm_b, b_cf, {static_cast<u8>(FileOperation::ReadData), hb, 0xE8, 0x03, 0xFF, 0xFF, 0xFF, 0xFF});
+        wait(n + 2, n + 2);
+        REQUIRE(got_a.back().size() == 4 + 1000);
+        REQUIRE(got_b.back().size() == 4 + 1000);
+        file_a.insert(file_a.end(), got_a.back().begin() + 4, got_a.back().end());
+        file_b.insert(file_b.end(), got_b.back().begin() + 4, got_b.back().end());
+    }
+    CHECK(file_a == pattern(SIZE, 1));
+    CHECK(file_b == pattern(SIZE, 2));
+    // Most reads come out of the buffer the reader thread filled beforehand
+    CHECK(server.read_ahead_hits() > server.read_ahead_misses());
+
+    send(nm_a, a_cf, {static_cast<u8>(FileOperation::ReadData), ha, 0x10, 0x00, 0xFF, 0xFF, 0xFF, 0xFF});
+    send(nm_b, b_cf, {static_cast<u8>(FileOperation::CloseFile), hb, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF});
+    wait(SIZE / 1000 + 2, SIZE / 1000 + 2);
+    CHECK(got_a.back()[1] == static_cast<u8>(FileTransferError::EndOfFile));
+    CHECK(got_b.back()[1] == static_cast<u8>(FileTransferError::NoError));
+
+    std::remove(file_path("a.bin").c_str());
+    std::remove(file_path("b.bin").c_str());
+}
@@ -0,0 +1,164 @@
+#include <doctest/doctest.h>
+#include <agrobus/isobus/file_transfer.hpp>
+#include <agrobus/isobus/fs/send_queue.hpp>
+#include <agrobus/net/loopback_bus.hpp>
+
+using namespace agrobus::net;
+using namespace agrobus::isobus;
+using namespace agrobus::isobus::fs;
+
+namespace {
+    dp::Vector<u8> pattern(usize n, u8 seed) {
+        dp::Vector<u8> out(n);
+        for (usize i = 0; i < n; ++i)
+            out[i] = static_cast<u8>(i * 11 + seed);
+        return out;
+    }
+
+    struct Bench {
+        LoopbackBus bus;
+        IsoNet nm_fs;
+        IsoNet nm_ecu;
+        InternalCF *fs_cf = nullptr;
+        InternalCF *ecu_cf = nullptr;
+
+        Bench() {
+            fs_cf = nm_fs.create_internal(Name::build().set_identity_number(1), 0, 0xAA).value();
+            ecu_cf = nm_ecu.create_internal(Name::build().set_identity_number(2), 0, 0x80).value();
+            bus.attach(nm_fs);
+            bus.attach(nm_ecu);
+            REQUIRE(nm_fs.start_address_claiming().is_ok());
+            REQUIRE(nm_ecu.start_address_claiming().is_ok());
+            step(60);
+        }
+
+        void step(u32 n = 1) {
+            for (u32 i = 0; i < n; ++i) {
+                nm_fs.update(5);
+                nm_ecu.update(5);
+            }
+        }
+    };
+
+    // Steps of 5 ms until `done`, with server and client updated in each
+    template <typename Done> u32 run_until(Bench &b, FileServer &server, FileClient &client, Done done) {
+        u32 steps = 0;
+        while (!done() && steps < 20000) {
+            b.step();
+            server.update(5);
+            client.update(5);
+            ++steps;
+        }
+        return steps;
+    }
+
+    // Opens `name`, then reads `length` bytes with the given client settings
+    u32 timed_read(FileClientConfig config, usize length, dp::Vector<u8> &out, u8 *peak = nullptr) {
+        Bench b;
+        FileServer server(b.nm_fs, b.fs_cf);
+        REQUIRE(server.initialize().is_ok());
+        REQUIRE(server.add_file("big.bin", pattern(length, 3)).is_ok());
+
+        ControlFunction fs;
+        fs.address = b.fs_cf->address();
+        FileClient client(b.nm_ecu, b.ecu_cf, &fs, config);
+        REQUIRE(client.initialize().is_ok());
+        u8 handle = 0;
+        client.on_file_opened.subscribe([&](u8 h) { handle = h; });
+        bool complete = false;
+        client.on_read_chunk.subscribe([&](u32 offset, dp::Vector<u8> bytes) {
+            CHECK(offset == out.size());
+            out.insert(out.end(), bytes.begin(), bytes.end());
+        });
+        client.on_transfer_complete.subscribe([&](u32) { complete = true; });
+
+        REQUIRE(client.request_open("big.bin").is_ok());
+        run_until(b, server, client, [&]() { return handle != 0; });
+        REQUIRE(handle != 0);
+
+        REQUIRE(client.read_file(handle, static_cast<u32>(length + 100)).is_ok());
+        u8 most = 0;
+        u32 steps = run_until(b, server, client, [&]() {
+            most = client.outstanding() > most ? client.outstanding() : most;
+            return complete;
+        });
+        CHECK(complete);
+        CHECK_FALSE(client.is_transfer_active());
+        if (peak)
+            *peak = most;
+        return steps;
+    }
+} // namespace
+
+TEST_CASE("SendQueue keeps multi-packet messages to a peer in order") {
+    Bench b;
+    SendQueue queue(b.nm_fs, PGN_FILE_SERVER_TO_CLIENT, b.fs_cf);
+    dp::Vector<dp::Vector<u8>> got;
+    b.nm_ecu.register_pgn_callback(PGN_FILE_SERVER_TO_CLIENT, [&](const Message &msg) { got.push_back(msg.data); });
+
+    REQUIRE(queue.send(std::make_shared<const dp::Vector<u8>>(pattern(100, 1)), 0x80).is_ok());
+    REQUIRE(queue.send(std::make_shared<const dp::Vector<u8>>(pattern(200, 2)), 0x80).is_ok());
+    REQUIRE(queue.send(dp::Vector<u8>(8, 0x33), 0x80).is_ok()); // Would overtake
+    CHECK(queue.busy(0x80));
+    CHECK(queue.queued(0x80) == 2);
+
+    for (u32 i = 0; i < 400 && got.size() < 3; ++i) {
+        b.step();
+        queue.update();
+    }
+    REQUIRE(got.size() == 3);
+    CHECK(got[0] == pattern(100, 1));
+    CHECK(got[1] == pattern(200, 2));
+    CHECK(got[2] == dp::Vector<u8>(8, 0x33));
+    CHECK_FALSE(queue.busy(0x80));
+}
+
+TEST_CASE("FileClient pipelines reads") {
+    const usize SIZE = 20000;
+    dp::Vector<u8> one, four, etp;
+    u8 peak = 0;
+    u32 serial = timed_read(FileClientConfig{}, SIZE, one);
+    u32 pipelined = timed_read(FileClientConfig{}.pipeline(4), SIZE, four, &peak);
+    CHECK(one == pattern(SIZE, 3));
+    CHECK(four == pattern(SIZE, 3));
+    CHECK(peak == 4);
+    // The loopback bus has no latency to hide, but pipelining must never cost time
+    CHECK(pipelined <= serial);
+
+    // Chunks above the TP limit travel over ETP, with fewer connection setups
+    u32 big = timed_read(FileClientConfig{}.pipeline(2).chunk(8000), SIZE, etp);
+    CHECK(etp == pattern(SIZE, 3));
+    CHECK(big < serial);
+}
+
+TEST_CASE("FileClient pipelines writes") {
+    Bench b;
+    FileServer server(b.nm_fs, b.fs_cf);
+    REQUIRE(server.initialize().is_ok());
+    REQUIRE(server.add_file("log.bin").is_ok());
+    dp::Vector<u8> stored;
+    server.on_file_write_complete.subscribe([&](dp::String, dp::Vector<u8> data, Address) { stored = data; });
+
+    ControlFunction fs;
+    fs.address = b.fs_cf->address();
+    FileClient client(b.nm_ecu, b.ecu_cf, &fs, FileClientConfig{}.pipeline(3).chunk(1000));
+    REQUIRE(client.initialize().is_ok());
+    u8 handle = 0;
+    client.on_file_opened.subscribe([&](u8 h) { handle = h; });
+    u32 written = 0;
+    client.on_transfer_complete.subscribe([&](u32 n) { written = n; });
+
+    REQUIRE(client.request_open("log.bin").is_ok());
+    run_until(b, server, client, [&]() { return handle != 0; });
+    REQUIRE(handle != 0);
+
+    REQUIRE(client.write_file(handle, pattern(5500, 9)).is_ok());
+    CHECK(client.outstanding() == 3);
+    CHECK(client.request_list().is_err()); // Busy with the transfer
+    run_until(b, server, client, [&]() { return written != 0; });
+    CHECK(written == 5500);
+
+    REQUIRE(client.request_close(handle).is_ok());
+    run_until(b, server, client, [&]() { return !stored.empty(); });
+    CHECK(stored == pattern(5500, 9));
+}
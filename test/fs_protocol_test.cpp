@@ -488,3 +488,24 @@ TEST_CASE("Constants have expected values") {
     CHECK(FS_NACK_INVALID_ACCESS == 0x02);
     CHECK(FS_NACK_VOLUME_BUSY == 0x03);
 }
+
+TEST_CASE("ConnectionManager finds clients by address after removals") {
+    ConnectionManager mgr(8);
+    for (Address a = 0x10; a < 0x15; ++a)
+        mgr.connect(a, a);
+    mgr.increment_open_files(0x14);
+
+    mgr.disconnect(0x11); // 0x14 moves into its place
+    CHECK_FALSE(mgr.is_connected(0x11));
+    REQUIRE(mgr.is_connected(0x14));
+    CHECK(mgr.get_connection(0x14).value().open_file_count == 1);
+    CHECK(mgr.get_connection(0x14).value().last_activity_ms == 0x14);
+
+    mgr.record_activity(0x10, 6000);
+    auto timed_out = mgr.update(6000 + 0x14);
+    CHECK(timed_out.size() == 3);
+    CHECK(mgr.active_client_count() == 1);
+    CHECK(mgr.is_connected(0x10));
+    CHECK_FALSE(mgr.is_connected(0x14));
+    CHECK(mgr.get_connection(0x10).value().client_address == 0x10);
+}
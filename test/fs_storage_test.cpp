@@ -0,0 +1,254 @@
+#include <doctest/doctest.h>
+#include <agrobus/isobus/file_transfer.hpp>
+#include <agrobus/isobus/fs/storage.hpp>
+#include <agrobus/net/loopback_bus.hpp>
+#include <cstdio>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace agrobus::net;
+using namespace agrobus::isobus;
+using namespace agrobus::isobus::fs;
+
+namespace {
+    const char *ROOT = "/tmp/agrobus_fs_storage_test";
+
+    dp::String file_path(const char *name) { return dp::String(ROOT) + "/" + name; }
+
+    void write_file(const char *name, const dp::Vector<u8> &bytes) {
+        ::mkdir(ROOT, 0755);
+        FILE *f = std::fopen(file_path(name).c_str(), "wb");
+        REQUIRE(f != nullptr);
+        std::fwrite(bytes.data(), 1, bytes.size(), f);
+        std::fclose(f);
+    }
+
+    dp::Vector<u8> read_file(const char *name) {
+        dp::Vector<u8> out;
+        FILE *f = std::fopen(file_path(name).c_str(), "rb");
+        if (!f)
+            return out;
+        u8 buf[4096];
+        usize n;
+        while ((n = std::fread(buf, 1, sizeof(buf), f)) > 0) {
+            for (usize i = 0; i < n; ++i)
+                out.push_back(buf[i]);
+        }
+        std::fclose(f);
+        return out;
+    }
+
+    dp::Vector<u8> pattern(usize n, u8 seed) {
+        dp::Vector<u8> out(n);
+        for (usize i = 0; i < n; ++i)
+            out[i] = static_cast<u8>(i * 7 + seed);
+        return out;
+    }
+} // namespace
+
+TEST_CASE("FileStorage reads and writes through a bounded page cache") {
+    const usize size = 20000;
+    write_file("data.bin", pattern(size, 1));
+
+    // 8 pages of 256 bytes: the file is ~80 pages, so pages are evicted
+    FileStorage storage(ROOT, FileStorageConfig{}.page_size(256).cache(8));
+    CHECK(storage.cache_bytes() == 2048);
+    auto listed = storage.list();
+    REQUIRE(listed.is_ok());
+    bool found = false;
+    for (const auto &f : listed.value())
+        found |= f.name == "data.bin" && f.size_bytes == size;
+    CHECK(found);
+
+    auto opened = storage.open("data.bin");
+    REQUIRE(opened.is_ok());
+    u32 h = opened.value();
+    CHECK(storage.size(h) == size);
+
+    SUBCASE("reads cross pages and stop at the end") {
+        dp::Vector<u8> buf(1000);
+        auto read = storage.read(h, 19500, buf.data(), buf.size());
+        REQUIRE(read.is_ok());
+        CHECK(read.value() == 500);
+        bool same = true;
+        for (usize i = 0; i < 500; ++i)
+            same &= buf[i] == static_cast<u8>((19500 + i) * 7 + 1);
+        CHECK(same);
+        CHECK(storage.read(h, size, buf.data(), 10).value() == 0);
+
+        usize misses = storage.misses();
+        REQUIRE(storage.read(h, 19600, buf.data(), 10).is_ok());
+        CHECK(storage.misses() == misses); // Still cached
+    }
+
+    SUBCASE("writes go back on eviction and on close") {
+        auto update = pattern(3000, 9);
+        REQUIRE(storage.write(h, 100, update.data(), update.size()).value() == update.size());
+        CHECK(storage.writebacks() > 0); // 12 dirty pages do not fit in 8
+        auto tail = pattern(500, 3);
+        REQUIRE(storage.write(h, size, tail.data(), tail.size()).is_ok());
+        CHECK(storage.size(h) == size + 500);
+        REQUIRE(storage.close(h).is_ok());
+        CHECK_FALSE(storage.is_open(h));
+
+        auto disk = read_file("data.bin");
+        REQUIRE(disk.size() == size + 500);
+        auto original = pattern(size, 1);
+        bool same = true;
+        for (usize i = 0; i < disk.size(); ++i) {
+            u8 want = i < 100 ? original[i] : i < 3100 ? update[i - 100] : i < size ? original[i] : tail[i - size];
+            same &= disk[i] == want;
+        }
+        CHECK(same);
+    }
+
+    CHECK(storage.open("../etc/passwd").is_err());
+    CHECK(storage.open("missing.bin").is_err());
+    std::remove(file_path("data.bin").c_str());
+}
+
+TEST_CASE("FileServer serves mounted storage") {
+    write_file("task.xml", pattern(3000, 5));
+
+    LoopbackBus bus;
+    IsoNet nm_fs;
+    IsoNet nm_ecu;
+    auto *fs_cf = nm_fs.create_internal(Name::build().set_identity_number(1), 0, 0xAA).value();
+    auto *ecu_cf = nm_ecu.create_internal(Name::build().set_identity_number(2), 0, 0x80).value();
+    bus.attach(nm_fs);
+    bus.attach(nm_ecu);
+    REQUIRE(nm_fs.start_address_claiming().is_ok());
+    REQUIRE(nm_ecu.start_address_claiming().is_ok());
+
+    FileServer server(nm_fs, fs_cf, FileServerConfig{}.path(ROOT));
+    REQUIRE(server.initialize().is_ok());
+    REQUIRE(server.mount(FileStorageConfig{}.page_size(512).cache(4)).is_ok());
+    CHECK(server.mounted());
+    bool listed = false;
+    for (const auto &f : server.files())
+        listed |= f.name == "task.xml" && f.size_bytes == 3000;
+    CHECK(listed);
+
+    dp::Vector<dp::Vector<u8>> responses;
+    nm_ecu.register_pgn_callback(PGN_FILE_SERVER_TO_CLIENT, [&](const Message &msg) {
+        if (msg.data[0] != static_cast<u8>(FileOperation::GetServerStatus))
+            responses.push_back(msg.data);
+    });
+    u64 stored = 0;
+    server.on_file_stored.subscribe([&](dp::String, u64 size, Address) { stored = size; });
+    auto request = [&](dp::Vector<u8> data) {
+        ControlFunction fs;
+        fs.address = fs_cf->address();
+        REQUIRE(nm_ecu.send(PGN_FILE_CLIENT_TO_SERVER, data, ecu_cf, &fs).is_ok());
+        for (u32 i = 0; i < 400; ++i) {
+            nm_fs.update(5);
+            nm_ecu.update(5);
+        }
+    };
+    for (u32 i = 0; i < 60; ++i) {
+        nm_fs.update(5);
+        nm_ecu.update(5);
+    }
+
+    request({static_cast<u8>(FileOperation::OpenFile), 8, 't', 'a', 's', 'k', '.', 'x', 'm', 'l'});
+    REQUIRE(responses.size() == 1);
+    REQUIRE(responses[0][1] == static_cast<u8>(FileTransferError::NoError));
+    u8 handle = responses[0][2];
+
+    request({static_cast<u8>(FileOperation::ReadData), handle, 0xD0, 0x07, 0xFF, 0xFF, 0xFF, 0xFF}); // 2000 bytes
+    REQUIRE(responses.size() == 2);
+    REQUIRE(responses[1].size() == 4 + 2000);
+    bool same = true;
+    for (usize i = 0; i < 2000; ++i)
+        same &= responses[1][4 + i] == static_cast<u8>(i * 7 + 5);
+    CHECK(same);
+
+    // Overwrite four bytes where the read stopped
+    request({static_cast<u8>(FileOperation::WriteData), handle, 4, 0, 'E', 'N', 'D', '!'});
+    REQUIRE(responses.size() == 3);
+    CHECK(responses[2][1] == static_cast<u8>(FileTransferError::NoError));
+    request({static_cast<u8>(FileOperation::CloseFile), handle, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF});
+    REQUIRE(responses.size() == 4);
+    CHECK(responses[3][1] == static_cast<u8>(FileTransferError::NoError));
+    CHECK(stored == 3000);
+
+    auto disk = read_file("task.xml");
+    REQUIRE(disk.size() == 3000);
+    CHECK(disk[2000] == 'E');
+    CHECK(disk[2003] == '!');
+    CHECK(disk[2004] == static_cast<u8>(2004 * 7 + 5));
+    std::remove(file_path("task.xml").c_str());
+}
+
+TEST_CASE("FileServer listing follows the storage directory") {
+    ::mkdir(ROOT, 0755);
+    write_file("one.txt", pattern(10, 1));
+
+    LoopbackBus bus;
+    IsoNet nm_fs;
+    IsoNet nm_ecu;
+    auto *fs_cf = nm_fs.create_internal(Name::build().set_identity_number(1), 0, 0xAA).value();
+    auto *ecu_cf = nm_ecu.create_internal(Name::build().set_identity_number(2), 0, 0x80).value();
+    bus.attach(nm_fs);
+    bus.attach(nm_ecu);
+    REQUIRE(nm_fs.start_address_claiming().is_ok());
+    REQUIRE(nm_ecu.start_address_claiming().is_ok());
+
+    FileServer server(nm_fs, fs_cf, FileServerConfig{}.path(ROOT));
+    REQUIRE(server.initialize().is_ok());
+    REQUIRE(server.mount().is_ok());
+
+    dp::Vector<dp::Vector<u8>> responses;
+    nm_ecu.register_pgn_callback(PGN_FILE_SERVER_TO_CLIENT, [&](const Message &msg) {
+        if (msg.data[0] != static_cast<u8>(FileOperation::GetServerStatus))
+            responses.push_back(msg.data);
+    });
+    auto run = [&](u32 steps) {
+        for (u32 i = 0; i < steps; ++i) {
+            nm_fs.update(5);
+            nm_ecu.update(5);
+            server.update(5);
+        }
+    };
+    auto request = [&](dp::Vector<u8> data) {
+        ControlFunction fs;
+        fs.address = fs_cf->address();
+        REQUIRE(nm_ecu.send(PGN_FILE_CLIENT_TO_SERVER, data, ecu_cf, &fs).is_ok());
+        run(100);
+    };
+    auto listed = [&](const char *name) {
+        request({static_cast<u8>(FileOperation::List), 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF});
+        const auto &r = responses.back();
+        usize at = 3;
+        for (u8 i = 0; i < r[2]; ++i) {
+            dp::String n(r.begin() + at + 1, r.begin() + at + 1 + r[at]);
+            if (n == name)
+                return true;
+            at += 1 + r[at];
+        }
+        return false;
+    };
+    run(60);
+
+    CHECK(listed("one.txt"));
+    REQUIRE(server.add_file("mem.bin", {1, 2, 3}).is_ok());
+    CHECK(listed("mem.bin"));
+
+    // The volume is the file system's own
+    request({static_cast<u8>(FileOperation::GetVolumeInfo), 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF});
+    CHECK(server.volume().total_bytes != 1024 * 1024);
+
+#ifdef __linux__
+    // Files changed behind the server's back
+    write_file("two.txt", pattern(1234, 2));
+    std::remove(file_path("one.txt").c_str());
+    run(10);
+    CHECK(listed("two.txt"));
+    CHECK_FALSE(listed("one.txt"));
+    request({static_cast<u8>(FileOperation::GetAttributes), 7, 't', 'w', 'o', '.', 't', 'x', 't'});
+    CHECK(responses.back()[1] == static_cast<u8>(FileTransferError::NoError));
+    CHECK((responses.back()[3] | (responses.back()[4] << 8)) == 1234);
+#endif
+    std::remove(file_path("one.txt").c_str());
+    std::remove(file_path("two.txt").c_str());
+}
@@ -192,3 +192,37 @@ TEST_CASE("ControlFunctionFunctionalities - serialization") {
     CHECK(data[5] == 2);  // generation
     CHECK(data[6] == 0x00);  // no options
 }
+
+TEST_CASE("ControlFunctionFunctionalities - cached payload follows changes") {
+    IsoNet nm;
+    auto* cf = nm.create_internal(Name::build().set_identity_number(1), 0, 0x28).value();
+    ControlFunctionFunctionalities func(nm, cf);
+    func.with_ut_working_set(3).with_tc_basic_client(4).with_file_server_client(2);
+
+    const auto* first = &func.encoded();
+    CHECK(func.encoded()[0] == 4);
+    CHECK(&func.encoded() == first);
+
+    // Option changes reach the next encoding
+    func.set_minimum_control_function_option_state(MinimumControlFunctionOptions::SupportOfHeartbeatConsumer, true);
+    CHECK(func.encoded()[3] == 0x08);
+
+    // Removing from the middle keeps the others reachable by enum
+    func.set_functionality_is_supported(Functionality::UniversalTerminalWorkingSet, 0, false);
+    CHECK_FALSE(func.get_functionality_is_supported(Functionality::UniversalTerminalWorkingSet));
+    CHECK(func.get_functionality_generation(Functionality::TaskControllerBasicClient) == 4);
+    CHECK(func.get_functionality_generation(Functionality::FileServerClient) == 2);
+
+    auto data = func.serialize();
+    REQUIRE(data.size() == 10);
+    CHECK(data[0] == 3);
+    CHECK(data[4] == static_cast<u8>(Functionality::TaskControllerBasicClient));
+    CHECK(data[7] == static_cast<u8>(Functionality::FileServerClient));
+    CHECK(data[8] == 2);
+
+    // Re-adding appends it at the end
+    func.set_functionality_is_supported(Functionality::UniversalTerminalWorkingSet, 4, true);
+    CHECK(func.encoded()[0] == 4);
+    CHECK(func.encoded()[10] == static_cast<u8>(Functionality::UniversalTerminalWorkingSet));
+    CHECK(func.get_functionality_generation(Functionality::UniversalTerminalWorkingSet) == 4);
+}
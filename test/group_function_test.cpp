@@ -0,0 +1,124 @@
+#include <doctest/doctest.h>
+#include <agrobus/isobus/group_function.hpp>
+
+using namespace agrobus::net;
+using namespace agrobus::isobus;
+
+TEST_CASE("GroupFunctionView reads the header and parameters in place") {
+    dp::Vector<u8> data = {0x01, 0x00, 0xEF, 0x00, 0x11, 0x22, 0xFF, 0xFF};
+    GroupFunctionView gf(data, 0x30);
+    CHECK(gf.valid());
+    CHECK(gf.function_type == GroupFunctionType::Command);
+    CHECK(gf.pgn == 0xEF00);
+    CHECK(gf.source == 0x30);
+    CHECK(gf.parameters.data() == data.data() + 4);
+    CHECK(gf.parameters.size() == 4);
+
+    auto msg = gf.decode();
+    CHECK(msg.target_pgn == 0xEF00);
+    REQUIRE(msg.parameters.size() == 2);
+    CHECK(msg.parameters[1] == 0x22);
+
+    dp::Vector<u8> short_data = {0x01, 0x00};
+    CHECK_FALSE(GroupFunctionView(short_data).valid());
+}
+
+TEST_CASE("GroupFunctionParams encode and read back a batch") {
+    dp::Vector<GroupFunctionParam> params = {{1, 100}, {7, 0xFFFFFFFF}, {9, 0x01020304}};
+    auto bytes = GroupFunctionParams::encode(params);
+    CHECK(bytes.size() == 1 + 3 * GroupFunctionParams::ENTRY_BYTES);
+
+    GroupFunctionParams view(bytes);
+    REQUIRE(view.size() == 3);
+    CHECK(view[0].index == 1);
+    CHECK(view[0].value == 100);
+    CHECK(view[1].value == 0xFFFFFFFF);
+    CHECK(view[2].index == 9);
+    CHECK(view[2].value == 0x01020304);
+
+    // A count larger than the bytes hold is clamped
+    bytes[0] = 10;
+    CHECK(GroupFunctionParams(bytes).size() == 3);
+
+    // Long parameter lists are encoded multi-packet instead of truncated
+    GroupFunctionMsg msg;
+    msg.target_pgn = 0xEF00;
+    msg.parameters = GroupFunctionParams::encode(params);
+    auto encoded = msg.encode();
+    CHECK(encoded.size() == 4 + msg.parameters.size());
+    CHECK(GroupFunctionView(encoded).params().size() == 3);
+}
+
+TEST_CASE("GroupFunctionHandler routes by target PGN") {
+    IsoNet nm;
+    auto* cf = nm.create_internal(Name::build().set_identity_number(1), 0, 0x28).value();
+    GroupFunctionHandler handler(nm, cf);
+    REQUIRE(handler.initialize().is_ok());
+
+    usize legacy_calls = 0;
+    usize view_calls = 0;
+    handler.register_handler(0xEF00, [&](const GroupFunctionMsg& gf) -> Result<dp::Vector<u8>> {
+        ++legacy_calls;
+        CHECK(gf.parameters.size() == 1);
+        return dp::Vector<u8>{};
+    });
+    handler.register_view_handler(0xEF01, [&](const GroupFunctionView& gf) {
+        ++view_calls;
+        CHECK(gf.source == 0x30);
+    });
+
+    handler.handle_message(Message(PGN_ACKNOWLEDGMENT, {0x01, 0x00, 0xEF, 0x00, 0x05, 0xFF, 0xFF, 0xFF}, 0x30));
+    handler.handle_message(Message(PGN_ACKNOWLEDGMENT, {0x01, 0x01, 0xEF, 0x00, 0xFF, 0xFF, 0xFF, 0xFF}, 0x30));
+    handler.handle_message(Message(PGN_ACKNOWLEDGMENT, {0x01, 0x02, 0xEF, 0x00, 0xFF, 0xFF, 0xFF, 0xFF}, 0x30));
+    CHECK(legacy_calls == 1);
+    CHECK(view_calls == 1);
+    CHECK(handler.has_handler(0xEF00));
+    CHECK_FALSE(handler.has_handler(0xEF02));
+
+    // Registering again replaces the handler
+    handler.register_view_handler(0xEF00, [&](const GroupFunctionView&) { ++view_calls; });
+    handler.handle_message(Message(PGN_ACKNOWLEDGMENT, {0x01, 0x00, 0xEF, 0x00, 0x05, 0xFF, 0xFF, 0xFF}, 0x30));
+    CHECK(legacy_calls == 1);
+    CHECK(view_calls == 2);
+}
+
+TEST_CASE("GroupFunctionHandler sets many parameters through one batch call") {
+    IsoNet nm;
+    auto* cf = nm.create_internal(Name::build().set_identity_number(1), 0, 0x28).value();
+    GroupFunctionHandler handler(nm, cf);
+
+    dp::Array<u32, 16> store{};
+    usize calls = 0;
+    handler.register_batch_handler(
+        0xEF00, [&](GroupFunctionType type, const GroupFunctionParams& params, dp::Vector<GroupFunctionParam>& out) {
+            ++calls;
+            GroupFunctionError err = GroupFunctionError::NoError;
+            params.for_each([&](GroupFunctionParam p) {
+                if (p.index >= store.size()) {
+                    err = GroupFunctionError::InvalidParameter;
+                } else if (type == GroupFunctionType::Command) {
+                    store[p.index] = p.value;
+                } else {
+                    out.push_back({p.index, store[p.index]});
+                }
+            });
+            return err;
+        });
+
+    GroupFunctionMsg cmd;
+    cmd.function_type = GroupFunctionType::Command;
+    cmd.target_pgn = 0xEF00;
+    cmd.parameters = GroupFunctionParams::encode({{1, 10}, {2, 20}, {3, 30}});
+    handler.handle_message(Message(PGN_ACKNOWLEDGMENT, cmd.encode(), 0x30));
+    CHECK(calls == 1);
+    CHECK(store[1] == 10);
+    CHECK(store[2] == 20);
+    CHECK(store[3] == 30);
+
+    GroupFunctionMsg read;
+    read.function_type = GroupFunctionType::Request;
+    read.target_pgn = 0xEF00;
+    read.parameters = GroupFunctionParams::encode({{2}, {3}});
+    handler.handle_message(Message(PGN_ACKNOWLEDGMENT, read.encode(), 0x30));
+    CHECK(calls == 2);
+}
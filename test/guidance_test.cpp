@@ -1,5 +1,7 @@
 #include <doctest/doctest.h>
 #include <agrobus/isobus/guidance.hpp>
+#include <agrobus/isobus/implement/guidance.hpp>
+#include <agrobus/net/loopback_bus.hpp>
 
 using namespace agrobus::isobus;
 
@@ -25,3 +27,61 @@ TEST_CASE("GuidanceInterface creation") {
     CHECK(!gi.latest_machine().has_value());
     CHECK(!gi.latest_system().has_value());
 }
+
+namespace {
+    u64 fake_ns = 0;
+    u64 fake_clock() { return fake_ns; }
+} // namespace
+
+TEST_CASE("Curvature commands through the real-time channel") {
+    using agrobus::isobus::implement::CurvatureCommand;
+    using agrobus::isobus::implement::GuidanceCurvatureInterface;
+
+    IsoNet steer_net, guide_net;
+    auto *steer_cf = steer_net.create_internal(Name::build().set_identity_number(1), 0, 0x13).value();
+    auto *guide_cf = guide_net.create_internal(Name::build().set_identity_number(2), 0, 0x1C).value();
+    LoopbackBus bus;
+    bus.attach(steer_net);
+    bus.attach(guide_net);
+    REQUIRE(steer_net.start_address_claiming().is_ok());
+    REQUIRE(guide_net.start_address_claiming().is_ok());
+    for (u32 i = 0; i < 40; ++i) {
+        steer_net.update(10);
+        guide_net.update(10);
+    }
+
+    GuidanceCurvatureInterface steering(steer_net, steer_cf);
+    GuidanceCurvatureInterface guidance(guide_net, guide_cf);
+    REQUIRE(steering.initialize().is_ok());
+    REQUIRE(guidance.initialize().is_ok());
+
+    dp::Vector<f64> received;
+    steering.on_curvature_command.subscribe([&](CurvatureCommand cmd, Address) { received.push_back(cmd.curvature); });
+    u32 confirmed = 0;
+    guidance.curvature_channel().on_sent.subscribe([&](const RealtimeSend &s) {
+        ++confirmed;
+        CHECK(s.sequence == confirmed);
+        CHECK(s.written_ns >= s.requested_ns);
+    });
+
+    auto &channel = guidance.curvature_channel();
+    channel.set_clock(&fake_clock);
+    channel.set_period_ms(10);
+    // 10 ms loop with +-200 us of scheduling noise
+    const u64 offsets_us[] = {0, 10200, 19900, 30000, 40100};
+    for (u64 t : offsets_us) {
+        fake_ns = 1'000'000'000ull + t * 1000;
+        CurvatureCommand cmd;
+        cmd.curvature = 12.5;
+        REQUIRE(guidance.send_curvature_realtime(cmd).is_ok());
+    }
+    steer_net.update(1);
+
+    CHECK(channel.sent() == 5);
+    CHECK(confirmed == 5);
+    CHECK(channel.failed() == 0);
+    CHECK(channel.jitter().count() == 4);
+    CHECK(channel.jitter().max() == 300'000); // Intervals 10.2, 9.7, 10.1, 10.1 ms
+    REQUIRE(received.size() == 5);
+    CHECK(received[0] == doctest::Approx(12.5));
+}
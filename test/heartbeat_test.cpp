@@ -38,9 +38,47 @@ TEST_CASE("HeartbeatProtocol") {
             miss_count = count;
         });
 
-        // Update for 3x interval without receiving heartbeat
-        hb.update(301);
+        // Update for 3x interval without receiving heartbeat (timers run on IsoNet)
+        nm.update(301);
         CHECK(missed);
         CHECK(miss_count == 1);
+        nm.update(300);
+        CHECK(miss_count == 2);
+    }
+
+    SUBCASE("send deadline lives on the IsoNet timer wheel") {
+        usize before = nm.timers().size();
+        hb.enable();
+        CHECK(nm.timers().size() == before + 1);
+        CHECK(nm.next_deadline_ms() <= 100);
+        nm.update(250);
+        CHECK(nm.timers().size() == before + 1); // Re-armed after each send
+        hb.disable();
+        CHECK(nm.timers().size() == before);
+    }
+
+    SUBCASE("hundreds of peers indexed by address") {
+        for (u32 a = 0; a < 240; ++a)
+            CHECK(hb.track(static_cast<Address>(a)).is_ok());
+        CHECK(hb.track(0x10).is_ok()); // Tracking twice is one peer
+        CHECK(hb.tracked_count() == 240);
+        CHECK(hb.is_tracked(0x10));
+        CHECK(!hb.is_tracked(0xF5));
+
+        CHECK(hb.untrack(0x10).is_ok());
+        CHECK(hb.untrack(0x10).is_err());
+        CHECK(hb.tracked_count() == 239);
+
+        u32 missed = 0;
+        hb.on_heartbeat_missed.subscribe([&](Address a, u32) {
+            CHECK(a != 0x10);
+            ++missed;
+        });
+        nm.update(299);
+        CHECK(missed == 0);
+        nm.update(1); // Reported from the update that reaches the deadline
+        CHECK(missed == 239);
+        CHECK(hb.missed_count(0x20) == 1);
+        CHECK(hb.missed_count(0x10) == 0);
     }
 }
@@ -0,0 +1,129 @@
+#include <doctest/doctest.h>
+#include <agrobus/isobus/implement/aux_valve_status.hpp>
+#include <agrobus/isobus/implement/drive_strategy.hpp>
+#include <agrobus/isobus/implement/lighting.hpp>
+#include <agrobus/isobus/implement/machine_speed_cmd.hpp>
+#include <agrobus/isobus/implement/tractor_commands.hpp>
+#include <agrobus/isobus/implement/tractor_facilities.hpp>
+#include <type_traits>
+
+using namespace agrobus::isobus::implement;
+
+namespace {
+
+    // Every raw value of every field in the table survives unpack -> pack, and
+    // no two fields of a message share a bit
+    template <typename Msg> void check_table(const char *name) {
+        using Codec = typename Msg::Codec;
+        CAPTURE(name);
+        u64 covered = 0;
+        u64 overlaps = 0;
+        u64 mismatches = 0;
+        Codec::for_each_field([&](auto field) {
+            using F = decltype(field);
+            if constexpr (!std::is_void_v<typename F::Owner>) {
+                u64 bits = F::deposit(0, F::MASK);
+                overlaps |= covered & bits;
+                covered |= bits;
+                for (u64 raw = 0; raw <= F::MASK; ++raw) {
+                    u64 word = F::deposit(~static_cast<u64>(0), raw);
+                    if (F::extract(Codec::pack(Codec::unpack(word))) != raw)
+                        ++mismatches;
+                }
+            }
+        });
+        CHECK(covered != 0);
+        CHECK(overlaps == 0);
+        CHECK(mismatches == 0);
+    }
+
+    using Frame8 = dp::Array<u8, 8>;
+
+    void check_bytes(const dp::Vector<u8> &encoded, const Frame8 &expected) {
+        REQUIRE(encoded.size() == 8);
+        for (usize i = 0; i < 8; ++i) {
+            CAPTURE(i);
+            CHECK(encoded[i] == expected[i]);
+        }
+    }
+
+    // Layouts are integer transforms, usable at compile time
+    static_assert(HitchCommandMsg::Codec::MIN_BYTES == 5);
+    static_assert(TractorFacilities::Codec::MIN_BYTES == 4);
+    static_assert(LightingState::Codec::unpack(0xFFFFFFFFFFFFFF01ull).left_turn == LightState::On);
+    static_assert(PTOCommandMsg::Codec::pack(PTOCommandMsg{}) == 0xFFFFFF00FFFFFFFFull);
+
+} // namespace
+
+TEST_CASE("Implement message tables round-trip every field value") {
+    check_table<HitchCommandMsg>("HitchCommandMsg");
+    check_table<PTOCommandMsg>("PTOCommandMsg");
+    check_table<AuxValveCommandMsg>("AuxValveCommandMsg");
+    check_table<TractorControlModeMsg>("TractorControlModeMsg");
+    check_table<TractorFacilities>("TractorFacilities");
+    check_table<LightingState>("LightingState");
+    check_table<DriveStrategyCmd>("DriveStrategyCmd");
+    check_table<GuidanceSystemCmd>("GuidanceSystemCmd");
+    check_table<HitchPTOCombinedCmd>("HitchPTOCombinedCmd");
+    check_table<HitchRollPitchCmd>("HitchRollPitchCmd");
+    check_table<MachineSelectedSpeedMsg>("MachineSelectedSpeedMsg");
+    check_table<MachineSpeedCommandMsg>("MachineSpeedCommandMsg");
+    check_table<AuxValveFlowMsg>("AuxValveFlowMsg");
+}
+
+TEST_CASE("Implement message tables keep the hand-written wire bytes") {
+    check_bytes(HitchCommandMsg{}.encode(), {0xFF, 0xFF, 0xFF, 0xFF, 0x00, 0xFF, 0xFF, 0xFF});
+
+    TractorFacilities facilities;
+    facilities.set_class1_all();
+    facilities.front_pto_exit_code = true;
+    check_bytes(facilities.encode(), {0x3F, 0x00, 0x00, 0x00, 0xE0, 0xFF, 0xFF, 0xFF});
+
+    MachineSelectedSpeedMsg speed;
+    speed.speed_raw = 1000;
+    speed.direction = MachineDirection::Forward;
+    speed.source = SpeedSource::GroundBased;
+    speed.limit_status = SpeedExitCode::NotLimited;
+    check_bytes(speed.encode(), {0xE8, 0x03, 0xFF, 0xFF, 0xC4, 0xFF, 0xFF, 0xFF});
+
+    AuxValveFlowMsg flow;
+    flow.extend_flow_percent = 125;
+    flow.retract_flow_percent = 0;
+    flow.state = ValveState::Extending;
+    flow.limit_status = ValveLimitStatus::NotLimited;
+    flow.fail_safe = ValveFailSafe::Float;
+    check_bytes(flow.encode(), {0x7D, 0x00, 0xA1, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF});
+
+    GuidanceSystemCmd guidance; // 0 1/km = (0 + 8032) * 4 = 0x7D80
+    check_bytes(guidance.encode(), {0x80, 0x7D, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF});
+
+    HitchPTOCombinedCmd combined;
+    combined.hitch_cmd = 2;
+    combined.pto_cmd = 1;
+    check_bytes(combined.encode(), {0xFF, 0xFF, 0xFF, 0xFF, 0x06, 0xFF, 0xFF, 0xFF});
+
+    MachineSpeedCommandMsg command;
+    command.target_speed_raw = 2500;
+    command.set_direction(MachineDirection::Reverse);
+    check_bytes(command.encode(), {0xC4, 0x09, 0xFD, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF});
+}
+
+TEST_CASE("Trailing fields default when a shorter frame leaves them out") {
+    const u8 v1[] = {0xFF, 0xFF, 0xFF, 0xFF}; // Four-byte response without the v2 front bits
+    auto f = TractorFacilities::Codec::decode(v1, sizeof(v1));
+    CHECK(f.rear_hitch_position);
+    CHECK(f.aux_valve_limit_status);
+    CHECK_FALSE(f.aux_valve_exit_code);
+    CHECK_FALSE(f.front_pto_exit_code);
+    CHECK_FALSE(TractorFacilities::Codec::get<Trailing<Field<&TractorFacilities::front_pto_exit_code, 37, 1>>>(
+        v1, sizeof(v1)));
+
+    const u8 v2[] = {0x00, 0x00, 0x00, 0x00, 0x21};
+    f = TractorFacilities::Codec::decode(v2, sizeof(v2));
+    CHECK(f.aux_valve_exit_code);
+    CHECK(f.front_pto_exit_code);
+    CHECK_FALSE(f.front_hitch_limit_status);
+
+    const u8 short_frame[] = {0xFF, 0xFF, 0xFF};
+    CHECK_FALSE(TractorFacilities::Codec::decode(short_frame, sizeof(short_frame)).rear_hitch_position);
+}
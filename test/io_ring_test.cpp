@@ -0,0 +1,123 @@
+#include <doctest/doctest.h>
+#include <agrobus/isobus/fs/io_worker.hpp>
+#include <agrobus/net/io_ring.hpp>
+#include <cstdio>
+#include <fcntl.h>
+#include <string>
+#include <sys/socket.h>
+#include <unistd.h>
+
+using namespace agrobus::net;
+
+TEST_CASE("IoRing receives CAN frames in order through buffer refills") {
+    IoRing ring(IoRingConfig{}.buffers(16));
+    REQUIRE(ring.open().is_ok());
+    // A datagram socket pair stands in for a CAN_RAW socket: one can_frame per datagram
+    int sv[2];
+    REQUIRE(::socketpair(AF_UNIX, SOCK_SEQPACKET | SOCK_NONBLOCK, 0, sv) == 0);
+    auto id = ring.add_can(sv[0]);
+    REQUIRE(id.is_ok());
+    auto rx = ring.can_rx(id.value());
+    ring.run();
+
+    // More frames than provided buffers: the recv is re-armed once they are given back
+    for (u32 i = 0; i < 50; ++i) {
+        can_frame cf{};
+        cf.can_id = i | CAN_EFF_FLAG;
+        cf.can_dlc = 8;
+        cf.data[0] = static_cast<u8>(i);
+        REQUIRE(::write(sv[1], &cf, sizeof(cf)) == static_cast<ssize_t>(sizeof(cf)));
+    }
+    u32 got = 0;
+    can_frame cf;
+    for (int i = 0; i < 50 && got < 50; ++i) {
+        ring.run(10);
+        while (rx(cf)) {
+            CHECK((cf.can_id & CAN_EFF_MASK) == got);
+            CHECK(cf.data[0] == got);
+            ++got;
+        }
+    }
+    CHECK(got == 50);
+    CHECK(ring.can_dropped(id.value()) == 0);
+    CHECK(ring.bytes_received(id.value()) == 50 * sizeof(can_frame));
+    ::close(sv[1]);
+    ring.close();
+    ::close(sv[0]);
+}
+
+TEST_CASE("IoRing reads a non-blocking stream and stops at end of file") {
+    IoRing ring;
+    REQUIRE(ring.open().is_ok());
+    int p[2];
+    REQUIRE(::pipe2(p, O_NONBLOCK) == 0);
+    std::string text;
+    auto id = ring.add_read(p[0], 64, [&](const u8 *data, usize n) {
+        text.append(reinterpret_cast<const char *>(data), n);
+    });
+    REQUIRE(id.is_ok());
+    ring.run(); // Nothing there yet: EAGAIN, then a wait for POLLIN
+
+    REQUIRE(::write(p[1], "$GPGGA,1\r\n", 10) == 10);
+    for (int i = 0; i < 50 && text.size() < 10; ++i)
+        ring.run(10);
+    REQUIRE(::write(p[1], "$GPRMC", 6) == 6);
+    for (int i = 0; i < 50 && text.size() < 16; ++i)
+        ring.run(10);
+    CHECK(text == "$GPGGA,1\r\n$GPRMC");
+
+    ::close(p[1]);
+    for (int i = 0; i < 50 && ring.active(id.value()); ++i)
+        ring.run(10);
+    CHECK_FALSE(ring.active(id.value()));
+    ring.close();
+    ::close(p[0]);
+}
+
+TEST_CASE("RingReader serves ReadWorker jobs from an IoRing") {
+    char path[] = "/tmp/agrobus_io_ring_XXXXXX";
+    int fd = ::mkstemp(path);
+    REQUIRE(fd >= 0);
+    dp::Vector<u8> content(4096);
+    for (usize i = 0; i < content.size(); ++i)
+        content[i] = static_cast<u8>(i * 7);
+    REQUIRE(::write(fd, content.data(), content.size()) == static_cast<ssize_t>(content.size()));
+
+    IoRing ring;
+    REQUIRE(ring.open().is_ok());
+    agrobus::isobus::fs::RingReader reader(ring, 2);
+    dp::Vector<u8> a(100), b(100);
+    agrobus::isobus::fs::ReadJob job;
+    job.id = 1;
+    job.fd = fd;
+    job.offset = 1000;
+    job.len = 100;
+    job.dest = a.data();
+    REQUIRE(reader.submit(job));
+    job.id = 2;
+    job.offset = 4050; // Runs past the end: a short read
+    job.dest = b.data();
+    REQUIRE(reader.submit(job));
+    job.id = 3;
+    CHECK_FALSE(reader.submit(job)); // At capacity
+
+    dp::Vector<agrobus::isobus::fs::ReadJob> done;
+    for (int i = 0; i < 50 && done.size() < 2; ++i) {
+        ring.run(10);
+        reader.poll([&](const agrobus::isobus::fs::ReadJob &j) { done.push_back(j); });
+    }
+    REQUIRE(done.size() == 2);
+    CHECK(reader.in_flight() == 0);
+    for (const auto &j : done) {
+        if (j.id == 1) {
+            CHECK(j.result == 100);
+            CHECK(a[0] == content[1000]);
+            CHECK(a[99] == content[1099]);
+        } else {
+            CHECK(j.result == 46);
+            CHECK(b[45] == content[4095]);
+        }
+    }
+    ::close(fd);
+    ::unlink(path);
+}
@@ -1,5 +1,7 @@
 #include <doctest/doctest.h>
 #include <agrobus/net/iop_parser.hpp>
+#include <cstring>
+#include <sys/stat.h>
 
 using namespace agrobus::net;
 using namespace agrobus::isobus::vt;
@@ -20,6 +22,15 @@ TEST_CASE("IOPParser - hash_to_version") {
     CHECK(result.value() != result3.value());
 }
 
+TEST_CASE("IOPParser - content_hash is XXH64") {
+    auto hash = [](const char *text) {
+        return IOPParser::content_hash(DataSpan(reinterpret_cast<const u8 *>(text), std::strlen(text)));
+    };
+    CHECK(hash("") == 0xEF46DB3751D8E999ULL);
+    CHECK(hash("abc") == 0x44BC2CF5AD770999ULL);
+    CHECK(hash("Nobody inspects the spammish repetition") == 0xFBCEA83C8A378BF1ULL);
+}
+
 TEST_CASE("IOPParser - validate empty data") {
     dp::Vector<u8> empty;
     auto result = IOPParser::validate(empty);
@@ -93,3 +104,174 @@ TEST_CASE("IOPParser - read_iop_file nonexistent") {
     auto result = IOPParser::read_iop_file("/nonexistent/path/test.iop");
     CHECK_FALSE(result.is_ok());
 }
+
+namespace {
+    // WorkingSet (ID 1), NumberVariable (ID 2), OutputString (ID 3, "hi")
+    dp::Vector<u8> sample_iop() {
+        return {0x01, 0x00, 0x00, 0xC8, 0x00, 0xC8, 0x00, 0x00, 0x01, 0x02, 0x00,                   // WorkingSet
+                0x02, 0x00, 0x15, 0x00, 0x00, 0x00, 0x00, 0x2A, 0x00, 0x00, 0x00,                   // NumberVariable
+                0x03, 0x00, 0x0B, 0x10, 0x00, 0x08, 0x00, 0x02, 0x00, 'h', 'i', 0x00, 0x00, 0x00, 0x00}; // OutputString
+    }
+
+    const char *write_iop(const char *path, const dp::Vector<u8> &data) {
+        FILE *f = fopen(path, "wb");
+        REQUIRE(f != nullptr);
+        fwrite(data.data(), 1, data.size(), f);
+        fclose(f);
+        return path;
+    }
+} // namespace
+
+TEST_CASE("IOPParser - parse_iop_image matches parse_iop_data") {
+    auto data = sample_iop();
+    auto pool = IOPParser::parse_iop_data(data).value();
+    auto image = IOPParser::parse_iop_image(dp::Vector<u8>(data)).value();
+    REQUIRE(image.size() == pool.size());
+    REQUIRE(image.size() == 3);
+    for (const auto &obj : pool.objects()) {
+        auto view = image.find(obj.id);
+        REQUIRE(view.has_value());
+        CHECK(view->type == obj.type);
+        CHECK(view->to_object().body == obj.body);
+    }
+}
+
+TEST_CASE("IOPParser - map_iop_file") {
+    const char *path = write_iop("/tmp/agrobus_iop_map_test.iop", sample_iop());
+
+    auto image = IOPParser::map_iop_file(path);
+    REQUIRE(image.is_ok());
+    CHECK(image.value().size() == 3);
+    auto str = image.value().find(3);
+    REQUIRE(str.has_value());
+    CHECK(str->type == ObjectType::OutputString);
+    CHECK(str->body[6] == 'h');
+
+    // Views stay valid in a copy after the original is gone
+    vt::PoolImage copy = image.value();
+    image.value().clear();
+    CHECK(copy.find(2)->body[4] == 0x2A);
+
+    CHECK_FALSE(IOPParser::map_iop_file("/nonexistent/path/test.iop").is_ok());
+    std::remove(path);
+}
+
+TEST_CASE("IOPParser - strict and lazy checks") {
+    auto data = sample_iop();
+    data.resize(data.size() - 3); // Cut into the OutputString
+
+    CHECK_FALSE(IOPParser::parse_iop_image(dp::Vector<u8>(data)).is_ok());
+    auto lazy = IOPParser::parse_iop_image(dp::Vector<u8>(data), IOPCheck::Lazy);
+    REQUIRE(lazy.is_ok());
+    CHECK(lazy.value().size() == 2);
+    CHECK_FALSE(lazy.value().contains(3));
+
+    auto twice = sample_iop();
+    auto again = sample_iop();
+    twice.insert(twice.end(), again.begin(), again.end());
+    CHECK_FALSE(IOPParser::parse_iop_image(dp::Vector<u8>(twice)).is_ok());
+    auto dup = IOPParser::parse_iop_image(dp::Vector<u8>(twice), IOPCheck::Lazy);
+    REQUIRE(dup.is_ok());
+    CHECK(dup.value().size() == 3);
+}
+
+TEST_CASE("IOPParser - prescan finds the object spans") {
+    auto data = sample_iop();
+    auto spans = IOPParser::prescan(data.data(), data.size());
+    REQUIRE(spans.is_ok());
+    REQUIRE(spans.value().size() == 3);
+    CHECK(spans.value()[0].id == 1);
+    CHECK(spans.value()[0].offset == 3);
+    CHECK(spans.value()[0].length == 8);
+    CHECK(spans.value()[2].type == ObjectType::OutputString);
+    CHECK(spans.value()[2].offset + spans.value()[2].length == data.size());
+
+    data.resize(data.size() - 3);
+    CHECK_FALSE(IOPParser::prescan(data.data(), data.size()).is_ok());
+    auto lazy = IOPParser::prescan(data.data(), data.size(), IOPCheck::Lazy);
+    REQUIRE(lazy.is_ok());
+    CHECK(lazy.value().size() == 2);
+}
+
+TEST_CASE("IOPParser - threaded parse_iop_data matches the serial one") {
+    // Enough objects for several threads, with a duplicate ID near the end
+    dp::Vector<u8> data;
+    for (u32 i = 0; i < 20000; ++i) {
+        auto one = sample_iop();
+        one[22] = static_cast<u8>(i);
+        one[23] = static_cast<u8>(0x10 + (i >> 8));
+        data.insert(data.end(), one.begin() + 22, one.end()); // OutputString, ID 0x1000 + i
+    }
+    data.insert(data.end(), data.begin(), data.begin() + 15); // ID 0x1000 again
+
+    auto serial = IOPParser::parse_iop_data(data).value();
+    auto parallel = IOPParser::parse_iop_data(data, 4).value();
+    REQUIRE(serial.size() == 20000);
+    REQUIRE(parallel.size() == serial.size());
+    for (usize i = 0; i < serial.size(); ++i) {
+        CHECK(parallel.objects()[i].id == serial.objects()[i].id);
+        CHECK(parallel.objects()[i].body == serial.objects()[i].body);
+    }
+}
+
+TEST_CASE("IOPParser - file_version stamp") {
+    const char *path = write_iop("/tmp/agrobus_iop_version_test.iop", sample_iop());
+    dp::String stamp_path = dp::String(path) + ".ver";
+    std::remove(stamp_path.c_str());
+
+    auto first = IOPParser::file_version(path);
+    REQUIRE(first.is_ok());
+    CHECK(first.value() == IOPParser::hash_to_version(sample_iop()).value());
+    struct stat st {};
+    REQUIRE(::stat(stamp_path.c_str(), &st) == 0);
+
+    SUBCASE("served from the stamp while the file is unchanged") {
+        // Forge the stored label: only a stamp hit can return it
+        auto stamp = IOPVersionStamp::decode(IOPParser::read_iop_file(stamp_path).value()).value();
+        stamp.label = "CACHED!";
+        auto bytes = stamp.encode();
+        FILE *f = fopen(stamp_path.c_str(), "wb");
+        fwrite(bytes.data(), 1, bytes.size(), f);
+        fclose(f);
+        CHECK(IOPParser::file_version(path).value() == "CACHED!");
+    }
+
+    SUBCASE("rehashed when the content changes") {
+        auto data = sample_iop();
+        data[7] = 0x05; // Different background colour, same size
+        write_iop(path, data);
+        // Same second on coarse-mtime filesystems: make sure the stamp is stale
+        auto stamp = IOPVersionStamp::decode(IOPParser::read_iop_file(stamp_path).value()).value();
+        stamp.mtime_ns -= 1;
+        auto bytes = stamp.encode();
+        FILE *f = fopen(stamp_path.c_str(), "wb");
+        fwrite(bytes.data(), 1, bytes.size(), f);
+        fclose(f);
+        auto second = IOPParser::file_version(path);
+        REQUIRE(second.is_ok());
+        CHECK(second.value() == IOPParser::hash_to_version(data).value());
+        CHECK(second.value() != first.value());
+    }
+
+    CHECK_FALSE(IOPParser::file_version("/nonexistent/path/test.iop").is_ok());
+    std::remove(stamp_path.c_str());
+    std::remove(path);
+}
+
+TEST_CASE("IOPVersionStamp - encode and decode") {
+    IOPVersionStamp stamp;
+    stamp.size = 123456;
+    stamp.mtime_ns = 1700000000123456789LL;
+    stamp.hash = 0x0123456789ABCDEFULL;
+    stamp.label = "ABCDEFG";
+    auto bytes = stamp.encode();
+    auto back = IOPVersionStamp::decode(bytes);
+    REQUIRE(back.has_value());
+    CHECK(back->size == stamp.size);
+    CHECK(back->mtime_ns == stamp.mtime_ns);
+    CHECK(back->hash == stamp.hash);
+    CHECK(back->label == stamp.label);
+
+    bytes.pop_back();
+    CHECK_FALSE(IOPVersionStamp::decode(bytes).has_value());
+}
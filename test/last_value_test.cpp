@@ -0,0 +1,136 @@
+#include <doctest/doctest.h>
+#include <agrobus/net/last_value.hpp>
+#include <agrobus/net/network_manager.hpp>
+#include <agrobus/net/policy.hpp>
+#include <thread>
+
+using namespace agrobus::net;
+
+TEST_CASE("LastValueCache stores the latest value per PGN and source") {
+    LastValueCache cache;
+    const u8 a[] = {0x01, 0x02, 0x03};
+    const u8 b[] = {0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18};
+
+    CHECK_FALSE(cache.get(0xFE48, 0x80).has_value());
+    CHECK(cache.age_ms(0xFE48, 0x80) == NEVER_SEEN);
+
+    cache.set_now(100);
+    CHECK(cache.store(0xFE48, 0x80, DataSpan(a, sizeof(a)), 5000));
+    cache.set_now(150);
+    CHECK(cache.store(0xFE48, 0x81, DataSpan(b, sizeof(b)), 6000));
+
+    auto v = cache.get(0xFE48, 0x80);
+    REQUIRE(v.has_value());
+    CHECK(v->length == 3);
+    CHECK(v->bytes().get_u8(2) == 0x03);
+    CHECK(v->timestamp_us == 5000);
+    CHECK(v->rx_ms == 100);
+    CHECK(v->updates == 1);
+    CHECK(cache.age_ms(0xFE48, 0x80) == 50);
+    CHECK(cache.age_ms(0xFE48, 0x81) == 0);
+    CHECK(cache.age_ms(0xFE48, BROADCAST_ADDRESS) == 0); // freshest sender
+    CHECK(cache.size() == 2);
+
+    cache.set_now(200);
+    CHECK(cache.store(0xFE48, 0x80, DataSpan(b, sizeof(b)), 7000));
+    v = cache.get(0xFE48, 0x80);
+    REQUIRE(v.has_value());
+    CHECK(v->updates == 2);
+    CHECK(v->bytes().get_u64_le(0) == 0x1817161514131211ull);
+    CHECK(cache.fresh(0xFE48, 0x80, 0));
+
+    // Longer than one frame: not cached
+    dp::Vector<u8> big(20, 0xAA);
+    CHECK_FALSE(cache.store(0xFECA, 0x80, DataSpan(big), 0));
+}
+
+TEST_CASE("LastValueCache reports full slots") {
+    LastValueCache cache;
+    const u8 d[] = {0x00};
+    for (u32 i = 0; i < LastValueCache::SLOTS; ++i)
+        CHECK(cache.store(0xFF00 + i, 0x10, DataSpan(d, 1), 0));
+    CHECK_FALSE(cache.store(0xEF00, 0x10, DataSpan(d, 1), 0));
+    CHECK(cache.dropped() == 1);
+    for (u32 i = 0; i < LastValueCache::SLOTS; ++i)
+        CHECK(cache.get(0xFF00 + i, 0x10).has_value());
+}
+
+TEST_CASE("LastValueCache readers never see a torn value") {
+    LastValueCache cache;
+    std::atomic<bool> done{false};
+    std::atomic<u32> torn{0};
+
+    std::thread reader([&]() {
+        LastValue v;
+        while (!done.load(std::memory_order_acquire)) {
+            if (!cache.read(0xFE48, 0x80, v))
+                continue;
+            // The writer fills all 8 bytes with the same counter
+            for (usize i = 1; i < 8; ++i) {
+                if (v.data[i] != v.data[0])
+                    torn.fetch_add(1);
+            }
+        }
+    });
+
+    u8 frame[8];
+    for (u32 n = 0; n < 200000; ++n) {
+        for (auto &byte : frame)
+            byte = static_cast<u8>(n);
+        cache.store(0xFE48, 0x80, DataSpan(frame, 8), n);
+    }
+    done.store(true, std::memory_order_release);
+    reader.join();
+    CHECK(torn.load() == 0);
+}
+
+TEST_CASE("IsoNet fills the last-value cache for tracked PGNs") {
+    IsoNet nm;
+    CHECK(nm.last_values().track(0xFE48));
+
+    Message speed(0xFE48, {0x88, 0x13, 0x00, 0x00, 0x00, 0x00, 0xFF, 0xF4}, 0x80);
+    Message other(0xFE49, {0x01}, 0x80);
+    nm.inject_message(speed);
+    nm.inject_message(other);
+
+    auto v = nm.last_values().get(0xFE48, 0x80);
+    REQUIRE(v.has_value());
+    CHECK(v->bytes().get_u16_le(0) == 5000);
+    CHECK_FALSE(nm.last_values().get(0xFE49, 0x80).has_value());
+
+    nm.update(120);
+    CHECK(nm.last_values().age_ms(0xFE48, 0x80) == 120);
+}
+
+TEST_CASE("SafetyPolicy checks PGN freshness through the cache") {
+    IsoNet nm;
+    nm.last_values().track(0xFE48);
+
+    SafetyPolicy policy;
+    policy.use_cache(nm.last_values());
+    policy.require_freshness(FreshnessRequirement::for_pgn("wheel speed", 0xFE48, BROADCAST_ADDRESS, 300, 1000));
+
+    Message speed(0xFE48, {0x88, 0x13, 0x00, 0x00, 0x00, 0x00, 0xFF, 0xF4}, 0x80);
+
+    // Grace period after registration, like named sources
+    nm.update(200);
+    policy.update(200);
+    CHECK(policy.is_safe());
+
+    for (u32 i = 0; i < 5; ++i) {
+        nm.inject_message(speed);
+        nm.update(100);
+        policy.update(100);
+        CHECK(policy.is_safe());
+    }
+
+    // Speed stops: Degraded once older than 300 ms
+    nm.update(400);
+    policy.update(400);
+    CHECK(policy.is_degraded());
+
+    nm.inject_message(speed);
+    nm.update(10);
+    policy.update(10);
+    CHECK(policy.is_safe());
+}
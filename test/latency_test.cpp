@@ -0,0 +1,146 @@
+#include <doctest/doctest.h>
+#include <agrobus/net/latency.hpp>
+#include <agrobus/net/loopback_bus.hpp>
+
+using namespace agrobus::net;
+
+static u64 fake_ns = 0;
+static u64 fake_clock() { return fake_ns; }
+
+TEST_CASE("LatencyHistogram buckets") {
+    SUBCASE("small values are exact, large ones within 1/16") {
+        for (u64 v : {0ull, 1ull, 15ull, 16ull, 31ull}) {
+            u32 b = LatencyHistogram::bucket_of(v);
+            CHECK(LatencyHistogram::bucket_low(b) == v);
+            CHECK(LatencyHistogram::bucket_high(b) == v);
+        }
+        for (u64 v : {32ull, 1000ull, 123456ull, 5000000ull, 987654321ull}) {
+            u32 b = LatencyHistogram::bucket_of(v);
+            CHECK(LatencyHistogram::bucket_low(b) <= v);
+            CHECK(LatencyHistogram::bucket_high(b) >= v);
+            CHECK(LatencyHistogram::bucket_high(b) - LatencyHistogram::bucket_low(b) <= v / 16);
+        }
+        CHECK(LatencyHistogram::bucket_of(~0ull) == LatencyHistogram::BUCKETS - 1);
+    }
+
+    SUBCASE("percentiles and summary") {
+        LatencyHistogram h;
+        for (u64 i = 1; i <= 1000; ++i)
+            h.record(i * 1000); // 1 µs .. 1 ms
+        CHECK(h.count() == 1000);
+        CHECK(h.min() == 1000);
+        CHECK(h.max() == 1000000);
+        CHECK(h.mean() == doctest::Approx(500500.0));
+        CHECK(h.percentile(50) == doctest::Approx(500000.0).epsilon(0.07));
+        CHECK(h.percentile(99) == doctest::Approx(990000.0).epsilon(0.07));
+        CHECK(h.percentile(100) == 1000000);
+        // Bucket resolution: samples sharing the threshold's bucket are not counted
+        CHECK(h.count_above(900000) <= 100);
+        CHECK(h.count_above(900000) >= 100 - 1000 / 16);
+
+        LatencySummary s = h.summary();
+        CHECK(s.count == 1000);
+        CHECK(s.p90_ns >= 900000);
+
+        u64 exported = 0;
+        h.for_each_bucket([&](u64 lo, u64 hi, u64 n) {
+            CHECK(lo <= hi);
+            exported += n;
+        });
+        CHECK(exported == 1000);
+
+        LatencyHistogram other;
+        other.record(5);
+        h.merge(other);
+        CHECK(h.count() == 1001);
+        CHECK(h.min() == 5);
+        h.reset();
+        CHECK(h.count() == 0);
+    }
+}
+
+TEST_CASE("LatencyMonitor per PGN and budget") {
+    LatencyMonitor m(5000000); // 5 ms
+    u32 alarms = 0;
+    m.on_over_budget.subscribe([&](LatencyKind kind, PGN pgn, u64 ns) {
+        CHECK(kind == LatencyKind::Handler);
+        CHECK(pgn == 0xFEF1);
+        CHECK(ns == 6000000);
+        ++alarms;
+    });
+    m.record(LatencyKind::Handler, 0xFEF1, 1000);
+    m.record(LatencyKind::Handler, 0xFEF1, 6000000);
+    m.record(LatencyKind::Receive, 0xFEF2, 2000);
+
+    CHECK(alarms == 1);
+    CHECK(m.over_budget(LatencyKind::Handler) == 1);
+    REQUIRE(m.histogram(LatencyKind::Handler, 0xFEF1) != nullptr);
+    CHECK(m.histogram(LatencyKind::Handler, 0xFEF1)->count() == 2);
+    CHECK(m.histogram(LatencyKind::Handler, 0xFEF3) == nullptr);
+    CHECK(m.total(LatencyKind::Receive).count() == 1);
+
+    usize histograms = 0;
+    m.for_each([&](PGN, LatencyKind, const LatencyHistogram &) { ++histograms; });
+    CHECK(histograms == 2);
+
+    m.reset();
+    CHECK(m.total(LatencyKind::Handler).count() == 0);
+}
+
+TEST_CASE("IsoNet measures handler, receive and send latency") {
+    LoopbackBus bus;
+    IsoNet a(NetworkConfig{}.latency(true, 5000));
+    IsoNet b;
+    bus.attach(a);
+    bus.attach(b);
+    auto *cf_a = a.create_internal(Name::build().set_identity_number(1), 0, 0x28).value();
+    auto *cf_b = b.create_internal(Name::build().set_identity_number(2), 0, 0x30).value();
+    a.start_address_claiming();
+    b.start_address_claiming();
+    for (int i = 0; i < 5; ++i) {
+        a.update(100);
+        b.update(100);
+    }
+    REQUIRE(a.latency() != nullptr);
+    CHECK(b.latency() == nullptr);
+    a.latency()->set_clock(&fake_clock);
+
+    // A slow handler: the fake clock moves 7 ms inside it
+    a.register_pgn_callback(0xFEF1, [](const Message &) { fake_ns += 7000000; });
+    b.send(0xFEF1, dp::Vector<u8>{1, 2, 3, 4, 5, 6, 7, 8}, cf_b);
+    a.update(1);
+    const LatencyHistogram *handler = a.latency()->histogram(LatencyKind::Handler, 0xFEF1);
+    REQUIRE(handler != nullptr);
+    CHECK(handler->count() == 1);
+    CHECK(handler->max() == 7000000);
+    CHECK(a.latency()->over_budget(LatencyKind::Handler) == 1);
+    CHECK(a.latency()->histogram(LatencyKind::Receive, 0xFEF1)->count() == 1);
+
+    // Single frame outside update(): accepted at once
+    CHECK(a.send(0xFEF2, dp::Vector<u8>{1, 2, 3}, cf_a).is_ok());
+    REQUIRE(a.latency()->histogram(LatencyKind::Send, 0xFEF2) != nullptr);
+    CHECK(a.latency()->histogram(LatencyKind::Send, 0xFEF2)->count() == 1);
+
+    // TP broadcast: sampled when the session completes
+    dp::Vector<u8> big(100, 0x5A);
+    CHECK(a.send(0xFEF3, big, cf_a).is_ok());
+    for (int i = 0; i < 100; ++i) {
+        a.update(60);
+        b.update(60);
+    }
+    REQUIRE(a.latency()->histogram(LatencyKind::Send, 0xFEF3) != nullptr);
+    CHECK(a.latency()->histogram(LatencyKind::Send, 0xFEF3)->count() == 1);
+
+    // Sends queued inside update() close when flushed; past the ring's 256
+    // pending marks the oldest are forgotten
+    a.register_pgn_callback(0xFEF4, [&](const Message &) {
+        for (u16 i = 0; i < 300; ++i)
+            a.send(0xFEF5, dp::Vector<u8>{static_cast<u8>(i), static_cast<u8>(i >> 8)}, cf_a);
+    });
+    b.send(0xFEF4, dp::Vector<u8>{1}, cf_b);
+    a.update(1);
+    REQUIRE(a.latency()->histogram(LatencyKind::Send, 0xFEF5) != nullptr);
+    CHECK(a.latency()->histogram(LatencyKind::Send, 0xFEF5)->count() == 256);
+    CHECK(a.send(0xFEF5, dp::Vector<u8>{0xAA}, cf_a).is_ok()); // The ring is empty again
+    CHECK(a.latency()->histogram(LatencyKind::Send, 0xFEF5)->count() == 257);
+}
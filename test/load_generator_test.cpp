@@ -0,0 +1,51 @@
+#include <doctest/doctest.h>
+#include <agrobus/net/load_generator.hpp>
+
+using namespace agrobus::net;
+
+TEST_CASE("LoadGenerator drives virtual ECUs against the network under test") {
+    IsoNet dut(NetworkConfig{}.fast_packet(true).foreign_transport_filter());
+    auto *target =
+        dut.create_internal(Name::build().set_identity_number(1).set_self_configurable(true), 0, 0x80).value();
+    dut.start_address_claiming();
+
+    LoadGenerator gen(dut, target,
+                      LoadConfig{}
+                          .count(8)
+                          .bus(250000, 20.0f)
+                          .periodic(2, 100)
+                          .bam(1000, 60)
+                          .tp(1000, 120)
+                          .etp(6000, 1800)
+                          .fast_packet(500, 43)
+                          .dm1(1000, 3)
+                          .claim_storms(1000));
+    REQUIRE(gen.ecus() == 8);
+    LoadReport report = gen.run(3000);
+
+    CHECK(report.sim_ms == 3000 + LoadConfig{}.settle_ms);
+    for (usize k = 0; k < LOAD_KINDS; ++k) {
+        CHECK(report.kinds[k].sent > 0);
+        CHECK(report.kinds[k].received == report.kinds[k].sent);
+    }
+    CHECK(report.drop_rate() == 0.0);
+    CHECK(report.ring_drops == 0);
+    // Every ECU answers both storms on top of the power-up claims
+    CHECK(report.claims_received >= 8 * 3);
+    CHECK(report.bus_load_percent > 20.0);
+    CHECK(report.bus_load_percent < 100.0);
+    CHECK(report.latency.count > 0);
+    CHECK(report.latency.p50_ns >= gen.bus().frame_ns(8));
+    CHECK(report.frames_received > 0);
+    CHECK(report.cpu_ns > 0);
+}
+
+TEST_CASE("LoadGenerator skips destination-specific traffic without a target") {
+    IsoNet dut(NetworkConfig{}.foreign_transport_filter());
+    LoadGenerator gen(dut, nullptr, LoadConfig{}.count(2).bus(250000, 0.0f).tp(500));
+    LoadReport report = gen.run(1000);
+    // Broadcasts still reach a network with no CF of its own
+    CHECK(report[LoadKind::Tp].sent == 0);
+    CHECK(report[LoadKind::Periodic].sent > 0);
+    CHECK(report[LoadKind::Periodic].drop_rate() == 0.0);
+}
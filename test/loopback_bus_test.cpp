@@ -0,0 +1,121 @@
+#include <doctest/doctest.h>
+#include <agrobus/net/loopback_bus.hpp>
+
+using namespace agrobus::net;
+
+namespace {
+
+    can_frame make_can(u32 id, u8 first) {
+        can_frame cf = {};
+        cf.can_id = id | CAN_EFF_FLAG;
+        cf.can_dlc = 8;
+        for (u8 i = 0; i < 8; ++i)
+            cf.data[i] = static_cast<u8>(first + i);
+        return cf;
+    }
+
+} // namespace
+
+TEST_CASE("An ideal loopback bus delivers to every other node at once") {
+    LoopbackBus bus;
+    auto &a = bus.add_node();
+    auto &b = bus.add_node();
+    auto &c = bus.add_node();
+
+    a.send_can(make_can(0x18FEF128, 1));
+    can_frame cf;
+    CHECK_FALSE(a.pop_can(cf)); // Not back to the sender
+    for (auto *node : {&b, &c}) {
+        REQUIRE(node->pop_can(cf));
+        CHECK((cf.can_id & CAN_EFF_MASK) == 0x18FEF128u);
+        CHECK(cf.data[0] == 1);
+        CHECK_FALSE(node->pop_can(cf));
+    }
+    CHECK(bus.frames() == 1);
+}
+
+TEST_CASE("A timed loopback bus spends wire time and arbitrates by identifier") {
+    LoopbackBus bus(LoopbackConfig{}.timed(250000));
+    auto &a = bus.add_node();
+    auto &b = bus.add_node();
+    auto &rx = bus.add_node();
+
+    a.send_can(make_can(0x18FEF128, 1));
+    b.send_can(make_can(0x0CF00430, 2)); // Higher priority
+    a.send_can(make_can(0x18FEF228, 3));
+    CHECK(bus.waiting() == 3);
+
+    u64 frame_us = bus.frame_ns(8) / 1000;
+    CHECK(frame_us == 628); // 157 bits at 250 kbit/s
+    can_frame cf;
+    bus.advance(frame_us - 1);
+    CHECK_FALSE(rx.pop_can(cf));
+    bus.advance(1);
+    REQUIRE(rx.pop_can(cf));
+    CHECK((cf.can_id & CAN_EFF_MASK) == 0x0CF00430u); // Won arbitration
+    CHECK(rx.last_timestamp_us() == frame_us);
+
+    CHECK(bus.drain() == 3 * frame_us);
+    REQUIRE(rx.pop_can(cf));
+    CHECK(cf.data[0] == 1);
+    REQUIRE(rx.pop_can(cf));
+    CHECK(cf.data[0] == 3);
+    CHECK(rx.last_timestamp_us() == 3 * frame_us);
+    CHECK(bus.frames() == 3);
+}
+
+TEST_CASE("IsoNets exchange a TP transfer over a timed loopback bus") {
+    LoopbackBus bus(LoopbackConfig{}.timed(250000));
+    IsoNet nm_a;
+    IsoNet nm_b;
+    bus.attach(nm_a);
+    bus.attach(nm_b);
+    auto *cf_a = nm_a.create_internal(Name::build().set_identity_number(1), 0, 0x28).value();
+    nm_b.create_internal(Name::build().set_identity_number(2), 0, 0x30).value();
+
+    dp::Vector<u8> received;
+    u64 first_us = 0;
+    u64 last_us = 0;
+    nm_b.register_pgn_callback(PGN_ECU_TO_VT, [&](const Message &msg) {
+        received = msg.data;
+        first_us = msg.first_timestamp_us;
+        last_us = msg.timestamp_us;
+    });
+
+    dp::Vector<u8> payload(1000);
+    for (usize i = 0; i < payload.size(); ++i)
+        payload[i] = static_cast<u8>(i * 3);
+    ControlFunction dest;
+    dest.address = 0x30;
+    REQUIRE(nm_a.send(PGN_ECU_TO_VT, payload, cf_a, &dest).is_ok());
+
+    for (u32 ms = 0; ms < 2000 && received.empty(); ++ms) {
+        nm_a.update(1);
+        nm_b.update(1);
+        bus.advance(1000);
+    }
+    REQUIRE(received.size() == 1000);
+    CHECK(received[999] == static_cast<u8>(999 * 3));
+    // 143 DT frames alone need about 90 ms of wire time at 250 kbit/s
+    CHECK(last_us - first_us >= 143 * bus.frame_ns(8) / 1000);
+    CHECK(bus.frames() >= 145);
+}
+
+TEST_CASE("A timed loopback bus sends each node's frames in order") {
+    LoopbackBus bus(LoopbackConfig{}.timed(250000));
+    auto &a = bus.add_node();
+    auto &b = bus.add_node();
+    auto &rx = bus.add_node();
+
+    // a's second frame would win arbitration, but a controller sends its own queue in order
+    a.send_can(make_can(0x18FEF128, 1));
+    a.send_can(make_can(0x0CF00428, 2));
+    b.send_can(make_can(0x14FEF330, 3));
+    bus.drain();
+
+    can_frame cf;
+    for (u8 first : {3, 1, 2}) {
+        REQUIRE(rx.pop_can(cf));
+        CHECK(cf.data[0] == first);
+    }
+}
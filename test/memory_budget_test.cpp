@@ -0,0 +1,162 @@
+#include <doctest/doctest.h>
+#include <agrobus/isobus/vt/server.hpp>
+#include <agrobus/net/memory_budget.hpp>
+#include <agrobus/net/tp.hpp>
+#include <memory_resource>
+#include <vector>
+
+using namespace agrobus::net;
+
+TEST_CASE("MemoryBudget charges up to its limit and keeps the peak") {
+    MemoryBudget budget("tp", 100);
+    CHECK(budget.charge(60).is_ok());
+    CHECK(budget.fits(40));
+    CHECK_FALSE(budget.fits(41));
+    auto over = budget.charge(41);
+    REQUIRE(over.is_err());
+    CHECK(over.error().code == ErrorCode::NoResources);
+    budget.release(50);
+    CHECK(budget.charge(30).is_ok());
+
+    auto u = budget.usage();
+    CHECK(u.live == 40);
+    CHECK(u.peak == 60);
+    CHECK(u.limit == 100);
+    CHECK(u.rejected == 1);
+    budget.reset_peak();
+    CHECK(budget.peak() == 40);
+
+    MemoryBudget unlimited("any");
+    CHECK(unlimited.charge(1ull << 40).is_ok());
+}
+
+TEST_CASE("MemoryCharge follows its owner's size and releases on destruction") {
+    MemoryBudget budget("vt", 100);
+    {
+        MemoryCharge charge(&budget);
+        CHECK(charge.resize(70).is_ok());
+        CHECK(charge.resize(120).is_err()); // Unchanged on failure
+        CHECK(charge.bytes() == 70);
+        CHECK(charge.resize(20).is_ok());
+        CHECK(budget.live() == 20);
+        charge.force(150); // Already held: charged past the limit
+        CHECK(budget.live() == 150);
+        CHECK_FALSE(charge.fits(1));
+
+        MemoryCharge moved = std::move(charge);
+        CHECK(charge.bytes() == 0);
+        CHECK(moved.bytes() == 150);
+    }
+    CHECK(budget.live() == 0);
+    CHECK(budget.peak() == 150);
+
+    MemoryCharge none;
+    CHECK(none.resize(1u << 30).is_ok());
+}
+
+TEST_CASE("MemoryBudgets name budgets and BudgetResource charges pmr containers") {
+    MemoryBudgets budgets;
+    MemoryBudget &tp = budgets.get("transport", 4096);
+    CHECK(&budgets.get("transport") == &tp);
+    CHECK(budgets.find("vt") == nullptr);
+    budgets.get("vt", 1024);
+    CHECK(budgets.size() == 2);
+
+    BudgetResource resource(budgets.get("vt"));
+    {
+        std::pmr::vector<u8> bytes(&resource);
+        bytes.reserve(512);
+        CHECK(budgets.get("vt").live() >= 512);
+        CHECK_THROWS_AS(bytes.reserve(4096), std::bad_alloc);
+        CHECK(bytes.capacity() >= 512);
+    }
+    CHECK(budgets.get("vt").live() == 0);
+    CHECK(budgets.total().limit == 4096 + 1024);
+    CHECK(budgets.total().rejected == 1);
+}
+
+TEST_CASE("Transport sessions over the budget are refused") {
+    MemoryBudget budget("transport", 30);
+    TransportProtocol tp;
+    tp.set_memory_budget(&budget);
+
+    // RTS for 20 bytes from 0x30: accepted and charged
+    Frame rts;
+    rts.id = Identifier::encode(Priority::Lowest, PGN_TP_CM, 0x30, 0x28);
+    rts.data = {tp_cm::RTS, 20, 0x00, 3, 0xFF, 0xCA, 0xFE, 0x00};
+    auto out = tp.process_frame(rts);
+    REQUIRE(out.size() == 1);
+    CHECK(out[0].data[0] == tp_cm::CTS);
+    CHECK(budget.live() == 20);
+
+    // A second one from 0x31 would not fit: aborted, nothing charged
+    rts.id = Identifier::encode(Priority::Lowest, PGN_TP_CM, 0x31, 0x28);
+    out = tp.process_frame(rts);
+    REQUIRE(out.size() == 1);
+    CHECK(out[0].data[0] == tp_cm::ABORT);
+    CHECK(out[0].data[1] == static_cast<u8>(TransportAbortReason::ResourcesUnavailable));
+    CHECK(out[0].destination() == 0x31);
+    CHECK(budget.live() == 20);
+
+    dp::Vector<u8> data(20, 0x11);
+    auto send = tp.send(0xEF00, data, 0x28, 0x40);
+    REQUIRE(send.is_err());
+    CHECK(send.error().code == ErrorCode::NoResources);
+
+    // The first transfer completes and gives its bytes back
+    usize completed = 0;
+    tp.on_complete.subscribe([&](TransportSession &) { ++completed; });
+    for (u8 seq = 1; seq <= 3; ++seq) {
+        Frame dt;
+        dt.id = Identifier::encode(Priority::Lowest, PGN_TP_DT, 0x30, 0x28);
+        dt.data[0] = seq;
+        tp.process_frame(dt);
+    }
+    CHECK(completed == 1);
+    CHECK(budget.live() == 0);
+    CHECK(budget.peak() == 20);
+}
+
+TEST_CASE("VTServer charges pools to its budget and drops uploads that do not fit") {
+    using namespace agrobus::isobus::vt;
+    ObjectPool pool;
+    pool.add(VTObject().set_id(0).set_type(ObjectType::WorkingSet).set_body({0xC8, 0x00, 0xC8, 0x00}));
+    pool.add(VTObject().set_id(1).set_type(ObjectType::DataMask).set_body({0x00}));
+    auto bytes = pool.serialize().value();
+    auto transfer = [&] {
+        dp::Vector<u8> data;
+        data.push_back(vt_cmd::OBJECT_POOL_TRANSFER);
+        data.insert(data.end(), bytes.begin(), bytes.end());
+        return Message(PGN_ECU_TO_VT, data, 0x80, 0x10);
+    };
+    Message get_memory(PGN_ECU_TO_VT, {vt_cmd::GET_MEMORY, 0xFF, 0, 0, 0, 0xFF, 0xFF, 0xFF}, 0x80, 0x10);
+    Message end_of_pool(PGN_ECU_TO_VT, {vt_cmd::END_OF_POOL, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF}, 0x80, 0x10);
+
+    IsoNet nm;
+    auto *cf = nm.create_internal(Name::build().set_identity_number(1), 0, 0x10).value();
+
+    SUBCASE("within the budget") {
+        MemoryBudget budget("vt", 1024);
+        VTServer server(nm, cf, VTServerConfig{}.budget(&budget));
+        server.start();
+        nm.inject_message(get_memory);
+        nm.inject_message(transfer());
+        nm.inject_message(end_of_pool);
+        REQUIRE(server.clients()[0].pool_uploaded);
+        CHECK(server.memory_bytes() == bytes.size());
+        CHECK(budget.live() == bytes.size());
+        server.stop();
+        CHECK(budget.live() == 0);
+    }
+
+    SUBCASE("over the budget") {
+        MemoryBudget budget("vt", bytes.size() - 1);
+        VTServer server(nm, cf, VTServerConfig{}.budget(&budget));
+        server.start();
+        nm.inject_message(get_memory);
+        nm.inject_message(transfer());
+        nm.inject_message(end_of_pool);
+        CHECK_FALSE(server.clients()[0].pool_uploaded);
+        CHECK(budget.live() == 0);
+    }
+}
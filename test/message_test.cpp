@@ -1,4 +1,5 @@
 #include <doctest/doctest.h>
+#include <agrobus/net/frame.hpp>
 #include <agrobus/net/message.hpp>
 
 using namespace agrobus::net;
@@ -84,3 +85,157 @@ TEST_CASE("Message construction") {
     CHECK(msg.data.size() == 3);
     CHECK(msg.priority == Priority::Default);
 }
+
+TEST_CASE("MessageView mirrors Message helpers") {
+    Message msg;
+    msg.pgn = 0xFEF1;
+    msg.source = 0x30;
+    msg.data = {0x12, 0x34, 0x56, 0x78, 0x9A, 0xBC, 0xDE, 0xF0};
+
+    MessageView view(msg);
+    CHECK(view.pgn == msg.pgn);
+    CHECK(view.source == 0x30);
+    CHECK(view.size() == 8);
+    CHECK(view.data.data() == msg.data.data()); // no copy
+
+    CHECK(view.get_u8(0) == msg.get_u8(0));
+    CHECK(view.get_u8(8) == 0xFF);
+    CHECK(view.get_u16_le(2) == msg.get_u16_le(2));
+    CHECK(view.get_u32_le(4) == msg.get_u32_le(4));
+    CHECK(view.get_u64_le(0) == msg.get_u64_le(0));
+    CHECK(view.get_bit(0, 1) == msg.get_bit(0, 1));
+    CHECK(view.get_bits(4, 12) == msg.get_bits(4, 12));
+    CHECK(view.get_bits(60, 8) == msg.get_bits(60, 8)); // straddles the end
+
+    SUBCASE("to_message copies") {
+        Message copy = view.to_message();
+        CHECK(copy.pgn == msg.pgn);
+        CHECK(copy.data == msg.data);
+        CHECK(copy.data.data() != msg.data.data());
+    }
+
+    SUBCASE("view over raw frame payload") {
+        dp::Array<u8, 8> payload = {0x01, 0x02, 0x03, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+        MessageView short_view(0xEA00, DataSpan(payload.data(), 3), 0x28);
+        CHECK(short_view.size() == 3);
+        CHECK(short_view.get_u16_le(1) == 0x0302);
+        CHECK(short_view.get_u16_le(2) == 0xFFFF); // out of bounds
+        CHECK(short_view.is_broadcast());
+    }
+}
+
+TEST_CASE("Message bit fields match a bit-by-bit reference") {
+    // The old one-bit-at-a-time extraction
+    auto reference = [](const dp::Vector<u8> &d, usize start_bit, u8 length) {
+        u32 result = 0;
+        for (u8 i = 0; i < length; ++i) {
+            usize pos = start_bit + i;
+            if (pos / 8 < d.size())
+                result |= static_cast<u32>((d[pos / 8] >> (pos % 8)) & 0x01) << i;
+        }
+        return result;
+    };
+
+    Message msg;
+    for (u8 i = 0; i < 13; ++i)
+        msg.data.push_back(static_cast<u8>(i * 37 + 11));
+
+    for (usize start = 0; start < 110; start += 3) {
+        for (u8 len = 1; len <= 32; ++len) {
+            CAPTURE(start);
+            CAPTURE(len);
+            REQUIRE(msg.get_bits(start, len) == reference(msg.data, start, len));
+            REQUIRE(DataSpan(msg.data).get_bits(start, len) == msg.get_bits(start, len));
+        }
+    }
+    CHECK(msg.get_bits(0, 0) == 0);
+    CHECK(msg.get_bits(0, 33) == 0);
+}
+
+TEST_CASE("Message set_bits") {
+    Message msg;
+    msg.data = {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
+
+    msg.set_bits(4, 12, 0xABC);
+    CHECK(msg.data[0] == 0xC0);
+    CHECK(msg.data[1] == 0xAB);
+    CHECK(msg.get_bits(4, 12) == 0xABC);
+
+    // Extra bits of the value are masked off; neighbours are untouched
+    msg.set_bits(17, 3, 0xFF);
+    CHECK(msg.data[2] == 0x0E);
+    CHECK(msg.data[1] == 0xAB);
+
+    // Writing past the end grows the payload with 0xFF, like set_u8
+    msg.set_bits(70, 20, 0x12345);
+    CHECK(msg.size() == 12);
+    CHECK(msg.get_bits(70, 20) == 0x12345);
+    CHECK((msg.data[11] & 0xFC) == 0xFC); // fill above the field survives
+}
+
+TEST_CASE("Frame bit fields") {
+    Frame f;
+    f.set_bits(0, 16, 0x1234);
+    f.set_bits(58, 2, 1);
+    CHECK(f.data[0] == 0x34);
+    CHECK(f.data[1] == 0x12);
+    CHECK(f.get_bits(0, 16) == 0x1234);
+    CHECK(f.get_bits(58, 2) == 1);
+
+    f.length = 2;
+    CHECK(f.get_bits(8, 16) == 0x12); // bytes past the DLC read as zero
+}
+
+TEST_CASE("Message payload storage") {
+    SUBCASE("single frames stay inline") {
+        Message msg;
+        msg.data = {0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08};
+        CHECK(msg.data.is_inline());
+        msg.set_u32_le(12, 0xAABBCCDD); // grows to 16 bytes, still inline
+        CHECK(msg.size() == 16);
+        CHECK(msg.data.is_inline());
+        CHECK(msg.get_u32_le(12) == 0xAABBCCDD);
+        CHECK(msg.get_u8(9) == 0xFF);
+    }
+
+    SUBCASE("spills to the heap past the inline capacity") {
+        Payload p;
+        for (u32 i = 0; i < 40; ++i)
+            p.push_back(static_cast<u8>(i));
+        CHECK_FALSE(p.is_inline());
+        REQUIRE(p.size() == 40);
+        for (u32 i = 0; i < 40; ++i)
+            CHECK(p[i] == i);
+        p.clear();
+        CHECK(p.is_inline());
+        CHECK(p.empty());
+    }
+
+    SUBCASE("adopts and hands back a transport buffer") {
+        dp::Vector<u8> buffer(100, 0x5A);
+        const u8 *storage = buffer.data();
+        Message msg;
+        msg.data = std::move(buffer);
+        CHECK(msg.data.data() == storage); // no copy
+        CHECK(msg.get_u8(99) == 0x5A);
+        dp::Vector<u8> back = msg.data.take();
+        CHECK(back.data() == storage);
+        CHECK(msg.data.empty());
+    }
+
+    SUBCASE("copies, moves and comparisons") {
+        Message a(0xFEF1, {0x10, 0x20, 0x30}, 0x28);
+        Message b = a;
+        CHECK(b.data == a.data);
+        CHECK(b.data.data() != a.data.data());
+        CHECK(a.data == dp::Vector<u8>{0x10, 0x20, 0x30});
+
+        Message c = std::move(b);
+        CHECK(c.data.size() == 3);
+        CHECK(b.data.empty());
+
+        dp::Vector<u8> copy = c.data; // copying conversion for existing dp::Vector users
+        CHECK(copy.size() == 3);
+        CHECK(DataSpan(c.data).get_u16_le(1) == 0x3020);
+    }
+}
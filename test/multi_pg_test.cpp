@@ -0,0 +1,159 @@
+#include <doctest/doctest.h>
+#include <agrobus/net/multi_pg.hpp>
+#include <agrobus/net/network_manager.hpp>
+#include <deque>
+#include <linux/can.h>
+
+using namespace agrobus::net;
+
+TEST_CASE("Multi-PG C-PGs round-trip through encode and decode") {
+    dp::Array<u8, 64> buf = {};
+    const u8 a[] = {1, 2, 3};
+    const u8 b[] = {9, 8, 7, 6, 5, 4, 3, 2};
+    multi_pg::encode(buf.data(), 0xFEF1, a, sizeof(a));
+    multi_pg::encode(buf.data() + MULTI_PG_HEADER_SIZE + sizeof(a), 0xEF00, b, sizeof(b));
+
+    dp::Vector<ContainedPG> seen;
+    CHECK(multi_pg::decode(buf.data(), 24, [&](const ContainedPG &pg) { seen.push_back(pg); }));
+    REQUIRE(seen.size() == 2);
+    CHECK(seen[0].pgn == 0xFEF1);
+    CHECK(seen[0].data.size() == 3);
+    CHECK(seen[1].pgn == 0xEF00);
+    CHECK(seen[1].data[7] == 2);
+    CHECK(seen[1].service == MULTI_PG_TOS_STANDARD);
+
+    // A length running past the frame stops decoding
+    buf[3] = 200;
+    CHECK_FALSE(multi_pg::decode(buf.data(), 24, [](const ContainedPG &) {}));
+}
+
+TEST_CASE("MultiPgPacker groups PGs by deadline into shared frames") {
+    MultiPgPacker packer;
+    dp::Vector<u8> small(8, 0x11);
+    dp::Vector<u8> big(40, 0x22);
+    REQUIRE(packer.submit(0, 0x28, BROADCAST_ADDRESS, 0xFEF1, small, Priority::Default, 0, 10).is_ok());
+    REQUIRE(packer.submit(0, 0x28, BROADCAST_ADDRESS, 0xFEF2, small, Priority::High, 0, 50).is_ok());
+    REQUIRE(packer.submit(0, 0x28, BROADCAST_ADDRESS, 0xFEF3, big, Priority::Default, 0, 60).is_ok());
+    REQUIRE(packer.submit(0, 0x29, BROADCAST_ADDRESS, 0xFEF4, small, Priority::Default, 0, 100).is_ok());
+    CHECK(packer.submit(0, 0x28, BROADCAST_ADDRESS, 0xFEF5, dp::Vector<u8>(61, 0), Priority::Default, 0, 0)
+              .is_err());
+
+    dp::Vector<MultiPgPacker::Packed> out;
+    packer.collect(5, out);
+    CHECK(out.empty());
+
+    // 0xFEF1 is due: 0xFEF2 rides along, 0xFEF3 does not fit behind them
+    packer.collect(10, out);
+    REQUIRE(out.size() == 1);
+    CHECK(out[0].frame.pgn() == PGN_MULTI_PG);
+    CHECK(out[0].frame.source() == 0x28);
+    CHECK(out[0].frame.priority() == Priority::High);
+    CHECK(out[0].frame.length == 24);
+    dp::Vector<PGN> pgns;
+    multi_pg::decode(out[0].frame.data.data(), out[0].frame.length, [&](const ContainedPG &pg) {
+        pgns.push_back(pg.pgn);
+    });
+    REQUIRE(pgns.size() == 2);
+    CHECK(pgns[0] == 0xFEF1);
+    CHECK(pgns[1] == 0xFEF2);
+    CHECK(packer.pending() == 2);
+    CHECK(packer.next_due_ms() == 60);
+
+    out.clear();
+    packer.flush(out);
+    CHECK(out.size() == 2); // One per source
+    CHECK(packer.pgs_sent() == 4);
+    CHECK(packer.frames_sent() == 3);
+}
+
+TEST_CASE("IsoNet packs send_packed PGs on an FD port and unpacks received ones") {
+    IsoNet nm;
+    dp::Vector<canfd_frame> sent;
+    std::deque<canfd_frame> incoming;
+    REQUIRE(nm.set_fd_port(
+                  0, [&](const canfd_frame &cf) { sent.push_back(cf); return true; },
+                  [&](canfd_frame &cf) {
+                      if (incoming.empty())
+                          return false;
+                      cf = incoming.front();
+                      incoming.pop_front();
+                      return true;
+                  })
+                .is_ok());
+    auto *cf = nm.create_internal(Name::build().set_identity_number(1), 0, 0x28).value();
+
+    dp::Vector<u8> data(8, 0x44);
+    REQUIRE(nm.send_packed(0xFEF1, data, cf, nullptr, Priority::Default, 0).is_ok());
+    REQUIRE(nm.send_packed(0xFEF2, data, cf, nullptr, Priority::Default, 20).is_ok());
+    REQUIRE(nm.send_packed(0xFEF3, data, cf, nullptr, Priority::Default, 20).is_ok());
+    CHECK(sent.empty());
+    nm.update(1);
+    REQUIRE(sent.size() == 1);
+    CHECK(sent[0].len == 48); // 3 x (4 + 8) bytes, padded
+    CHECK(nm.packer().pending() == 0);
+
+    // Loop the frame back in as if another node (0x30) had sent it
+    canfd_frame wire = sent[0];
+    wire.can_id = (wire.can_id & ~0xFFu) | 0x30;
+    incoming.push_back(wire);
+    dp::Vector<PGN> got;
+    for (PGN pgn : {PGN{0xFEF1}, PGN{0xFEF2}, PGN{0xFEF3}}) {
+        nm.register_pgn_callback(pgn, [&](const Message &msg) {
+            CHECK(msg.source == 0x30);
+            CHECK(msg.data.size() == 8);
+            got.push_back(msg.pgn);
+        });
+    }
+    nm.update(1);
+    CHECK(got.size() == 3);
+}
+
+TEST_CASE("IsoNet queues packed frames the sink refuses and holds them while bus-off") {
+    IsoNet nm;
+    dp::Vector<canfd_frame> sent;
+    std::deque<canfd_frame> incoming;
+    bool accept = false;
+    REQUIRE(nm.set_fd_port(
+                  0,
+                  [&](const canfd_frame &cf) {
+                      if (accept)
+                          sent.push_back(cf);
+                      return accept;
+                  },
+                  [&](canfd_frame &cf) {
+                      if (incoming.empty())
+                          return false;
+                      cf = incoming.front();
+                      incoming.pop_front();
+                      return true;
+                  })
+                .is_ok());
+    auto *cf = nm.create_internal(Name::build().set_identity_number(1), 0, 0x28).value();
+    dp::Vector<u8> data(8, 0x44);
+
+    REQUIRE(nm.send_packed(0xFEF1, data, cf, nullptr, Priority::Default, 0).is_ok());
+    nm.update(1);
+    CHECK(sent.empty());
+    CHECK(nm.tx_pending(0) == 1);
+    accept = true;
+    nm.update(1);
+    REQUIRE(sent.size() == 1);
+    CHECK(Identifier(sent[0].can_id & CAN_EFF_MASK).pgn() == PGN_MULTI_PG);
+    CHECK(nm.tx_pending(0) == 0);
+
+    canfd_frame err{};
+    err.can_id = CAN_ERR_FLAG | CAN_ERR_BUSOFF;
+    err.len = CAN_ERR_DLC;
+    incoming.push_back(err);
+    nm.update(1);
+    REQUIRE(nm.bus_off(0));
+    REQUIRE(nm.send_packed(0xFEF2, data, cf, nullptr, Priority::Default, 0).is_ok());
+    nm.update(1);
+    CHECK(sent.size() == 1);
+    CHECK(nm.tx_pending(0) == 1);
+
+    err.can_id = CAN_ERR_FLAG | CAN_ERR_RESTARTED;
+    incoming.push_back(err);
+    nm.update(1);
+    CHECK(sent.size() == 2);
+}
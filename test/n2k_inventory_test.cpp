@@ -0,0 +1,126 @@
+#include <doctest/doctest.h>
+#include <agrobus/net/loopback_bus.hpp>
+#include <agrobus/nmea/n2k_inventory.hpp>
+#include <memory>
+
+using namespace agrobus::nmea;
+
+namespace {
+    // A node with N2K management that answers product and config info requests
+    struct Node {
+        IsoNet net{NetworkConfig{}.fast_packet(true)};
+        InternalCF *cf = nullptr;
+        std::unique_ptr<N2KManagement> mgmt;
+        u32 requests = 0;
+
+        Node(u32 identity, Address addr) {
+            cf = net.create_internal(Name::build().set_identity_number(identity), 0, addr).value();
+            N2KProductInfo product;
+            product.product_code = static_cast<u16>(identity);
+            product.model_id = "Node";
+            N2KConfigInfo config;
+            config.installation_desc1 = "Port engine room";
+            mgmt = std::make_unique<N2KManagement>(net, cf, N2KManagementConfig{}.product(product).config(config));
+            REQUIRE(mgmt->initialize().is_ok());
+            net.register_pgn_callback(PGN_REQUEST, [this](const Message &msg) {
+                if (msg.destination != cf->address() || msg.data.size() < 3)
+                    return;
+                ++requests;
+                PGN pgn = static_cast<PGN>(msg.data[0]) | (static_cast<PGN>(msg.data[1]) << 8) |
+                          (static_cast<PGN>(msg.data[2]) << 16);
+                if (pgn == PGN_PRODUCT_INFO)
+                    mgmt->send_product_info();
+                else if (pgn == PGN_CONFIG_INFO)
+                    mgmt->send_config_info(msg.source);
+            });
+        }
+    };
+
+    void run(Node &a, Node &b, u32 steps) {
+        for (u32 i = 0; i < steps; ++i) {
+            a.net.update(5);
+            b.net.update(5);
+            a.mgmt->update(5);
+            b.mgmt->update(5);
+        }
+    }
+} // namespace
+
+TEST_CASE("N2KInventory fills from a scan and restores without traffic") {
+    dp::Vector<u8> blob;
+    Name device_name;
+
+    {
+        Node dashboard(1, 0x28), device(2, 0x30);
+        device_name = device.cf->name();
+        N2KInventory inventory(dashboard.net, *dashboard.mgmt, dashboard.cf);
+        REQUIRE(inventory.initialize().is_ok());
+        u32 stores = 0;
+        inventory.set_store([&](const dp::Vector<u8> &data) {
+            blob = data;
+            ++stores;
+        });
+
+        LoopbackBus bus;
+        bus.attach(dashboard.net);
+        bus.attach(device.net);
+        REQUIRE(dashboard.net.start_address_claiming().is_ok());
+        REQUIRE(device.net.start_address_claiming().is_ok());
+        run(dashboard, device, 200);
+
+        const N2KDevice *dev = inventory.find(device_name);
+        REQUIRE(dev != nullptr);
+        CHECK(dev->online);
+        CHECK(dev->address == 0x30);
+        REQUIRE(dev->product.has_value());
+        CHECK(dev->product->product_code == 2);
+        CHECK(dev->product->model_id == "Node");
+        REQUIRE(dev->config.has_value());
+        CHECK(dev->config->installation_desc1 == "Port engine room");
+        CHECK(inventory.at(0x30) == dev);
+        CHECK(inventory.at(0x31) == nullptr);
+        CHECK(device.requests == 2);
+        CHECK(stores >= 2);
+
+        device.mgmt->send_heartbeat();
+        run(dashboard, device, 4);
+        CHECK(dev->heartbeat.has_value());
+
+        // Reading the cache is free
+        u32 before = device.requests;
+        for (u32 i = 0; i < 10; ++i)
+            CHECK(inventory.find(device_name)->product.has_value());
+        run(dashboard, device, 20);
+        CHECK(device.requests == before);
+
+        // Heartbeats don't trigger the store; saving at shutdown keeps the last one
+        CHECK(blob.size() < inventory.encode().size());
+        blob = inventory.encode();
+    }
+
+    // Next key-on: the restored cache already knows the device
+    Node dashboard(1, 0x28), device(2, 0x30);
+    N2KInventory inventory(dashboard.net, *dashboard.mgmt, dashboard.cf);
+    REQUIRE(inventory.initialize().is_ok());
+    REQUIRE(inventory.restore(DataSpan(blob.data(), blob.size())));
+    REQUIRE(inventory.size() == 1);
+    CHECK_FALSE(inventory.find(device_name)->online);
+    CHECK(inventory.find(device_name)->heartbeat.has_value());
+
+    LoopbackBus bus;
+    bus.attach(dashboard.net);
+    bus.attach(device.net);
+    REQUIRE(dashboard.net.start_address_claiming().is_ok());
+    REQUIRE(device.net.start_address_claiming().is_ok());
+    run(dashboard, device, 200);
+
+    CHECK(inventory.find(device_name)->online);
+    CHECK(inventory.find(device_name)->config->installation_desc1 == "Port engine room");
+    CHECK(device.requests == 0);
+    CHECK_FALSE(dashboard.mgmt->scanning());
+
+    CHECK_FALSE(inventory.restore(DataSpan(blob.data(), 3)));
+    blob.resize(blob.size() - 1);
+    CHECK_FALSE(inventory.restore(DataSpan(blob.data(), blob.size())));
+    CHECK(inventory.size() == 1); // Unchanged on a bad blob
+}
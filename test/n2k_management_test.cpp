@@ -191,30 +191,30 @@ TEST_CASE("N2KManagement heartbeat timing") {
             hb_received = true;
         });
 
-        mgmt.update(500); // Only 500ms elapsed
+        nm.update(500); // Only 500ms elapsed (heartbeats run on the IsoNet timer wheel)
         // Heartbeat not triggered yet via event (would need loopback)
         CHECK(mgmt.heartbeat_sequence() == 0);
     }
 
     SUBCASE("heartbeat sent after interval") {
-        mgmt.update(1000); // Exactly 1000ms
+        nm.update(1000); // Exactly 1000ms
         CHECK(mgmt.heartbeat_sequence() == 1);
     }
 
     SUBCASE("multiple heartbeats increment sequence") {
-        mgmt.update(1000);
+        nm.update(1000);
         CHECK(mgmt.heartbeat_sequence() == 1);
 
-        mgmt.update(1000);
+        nm.update(1000);
         CHECK(mgmt.heartbeat_sequence() == 2);
 
-        mgmt.update(1000);
+        nm.update(1000);
         CHECK(mgmt.heartbeat_sequence() == 3);
     }
 
     SUBCASE("sequence wraps at 16") {
         for (int i = 0; i < 16; ++i) {
-            mgmt.update(1000);
+            nm.update(1000);
         }
         // After 16 increments, should wrap (counter & 0x0F)
         CHECK(mgmt.heartbeat_sequence() == 0);
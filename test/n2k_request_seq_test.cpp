@@ -59,7 +59,7 @@ struct N2KSetup {
     InternalCF *cf = nullptr;
     N2KManagement *mgmt = nullptr;
 
-    N2KSetup()
+    explicit N2KSetup(N2KManagementConfig config = {})
         : dut_link(std::make_shared<wirebit::SocketCanLink>(
               wirebit::SocketCanLink::create({.interface_name = "vcan_n2k_req", .create_if_missing = true, .destroy_on_close = true}).value())),
           harness_link(std::make_shared<wirebit::SocketCanLink>(
@@ -69,7 +69,7 @@ struct N2KSetup {
           nm(NetworkConfig{}.fast_packet(false)) {
         nm.set_endpoint(0, &dut_ep);
         cf = nm.create_internal(Name::build().set_identity_number(1).set_manufacturer_code(100), 0, 0x28).value();
-        mgmt = new N2KManagement(nm, cf);
+        mgmt = new N2KManagement(nm, cf, config);
         mgmt->initialize();
     }
 
@@ -193,3 +193,77 @@ TEST_CASE("N2KManagement - request sequencing: on_request_timeout event fires")
     auto r2 = setup.mgmt->request_product_info(0x30);
     CHECK(r2.is_ok());
 }
+
+TEST_CASE("N2KManagement - request sequencing: pending table keyed by PGN and destination") {
+    N2KSetup setup;
+
+    CHECK(setup.mgmt->request_product_info(0x30).is_ok());
+    CHECK(setup.mgmt->has_pending_request(PGN_PRODUCT_INFO, 0x30));
+    CHECK_FALSE(setup.mgmt->has_pending_request(PGN_CONFIG_INFO, 0x30));
+
+    // A config info response does not answer a product info request
+    setup.inject_config_info_from(0x30);
+    CHECK(setup.mgmt->has_pending_request_to(0x30));
+
+    setup.mgmt->update(1200);
+    auto pending = setup.mgmt->pending_requests();
+    REQUIRE(pending.size() == 1);
+    CHECK(pending[0].pgn == PGN_PRODUCT_INFO);
+    CHECK(pending[0].destination == 0x30);
+    CHECK(pending[0].elapsed_ms == 1200);
+    CHECK(setup.mgmt->pending_count() == 1);
+}
+
+TEST_CASE("N2KManagement - request sequencing: paced bus scan") {
+    N2KSetup setup(N2KManagementConfig{}.scan_pacing(50, 4));
+
+    dp::Vector<Address> targets;
+    for (Address a = 0x30; a < 0x40; ++a)
+        targets.push_back(a);
+    bool complete = false;
+    u32 timeouts = 0;
+    setup.mgmt->on_scan_complete.subscribe([&]() { complete = true; });
+    setup.mgmt->on_request_timeout.subscribe([&](PGN, Address) { ++timeouts; });
+
+    // A device already being asked is skipped by the scan
+    CHECK(setup.mgmt->request_config_info(0x33).is_ok());
+    CHECK(setup.mgmt->scan(PGN_HEARTBEAT_N2K, targets).is_err());
+    REQUIRE(setup.mgmt->scan(PGN_PRODUCT_INFO, targets).is_ok());
+    CHECK(setup.mgmt->scanning());
+    CHECK(setup.mgmt->scan_remaining() == 16);
+
+    // The scan paces itself on the IsoNet timer wheel; update() expires requests
+    auto step = [&](u32 ms) {
+        setup.nm.update(ms);
+        setup.mgmt->update(ms);
+    };
+
+    // One request per interval at most
+    step(0);
+    CHECK(setup.mgmt->has_pending_request(PGN_PRODUCT_INFO, 0x30));
+    CHECK(setup.mgmt->pending_count() == 2);
+    step(20);
+    CHECK(setup.mgmt->pending_count() == 2);
+    step(30);
+    CHECK(setup.mgmt->pending_count() == 3);
+    for (u32 i = 0; i < 6; ++i)
+        step(50);
+    CHECK(setup.mgmt->pending_count() == 5); // Four scan requests in flight plus our own
+    CHECK(setup.mgmt->has_pending_request(PGN_CONFIG_INFO, 0x33));
+    CHECK(setup.mgmt->has_pending_request(PGN_PRODUCT_INFO, 0x34));
+    CHECK_FALSE(setup.mgmt->has_pending_request_to(0x35));
+
+    // An answer makes room for the next one, sent from the same network update
+    setup.inject_product_info_from(0x31);
+    CHECK(setup.mgmt->pending_count() == 5);
+    CHECK(setup.mgmt->has_pending_request(PGN_PRODUCT_INFO, 0x35));
+    CHECK_FALSE(complete);
+
+    for (u32 i = 0; i < 600 && !complete; ++i)
+        step(50);
+    CHECK(complete);
+    CHECK_FALSE(setup.mgmt->scanning());
+    CHECK(setup.mgmt->scan_remaining() == 0);
+    CHECK(timeouts == 15); // 14 unanswered scan requests and the config request to 0x33
+    CHECK(setup.mgmt->pending_count() == 0);
+}
@@ -0,0 +1,117 @@
+#include <doctest/doctest.h>
+#include <agrobus/net/name_manager.hpp>
+#include <agrobus/net/name_table.hpp>
+#include <agrobus/net/network_manager.hpp>
+#include <wirebit/can/can_endpoint.hpp>
+#include <wirebit/can/socketcan_link.hpp>
+
+using namespace agrobus::net;
+
+namespace {
+
+    // Two IsoNets on one vcan interface
+    struct Pair {
+        std::shared_ptr<wirebit::SocketCanLink> link_a;
+        std::shared_ptr<wirebit::SocketCanLink> link_b;
+        wirebit::CanEndpoint ep_a;
+        wirebit::CanEndpoint ep_b;
+        IsoNet nm_a;
+        IsoNet nm_b;
+
+        Pair()
+            : link_a(std::make_shared<wirebit::SocketCanLink>(
+                  wirebit::SocketCanLink::create(
+                      {.interface_name = "vcan_names", .create_if_missing = true, .destroy_on_close = true})
+                      .value())),
+              link_b(std::make_shared<wirebit::SocketCanLink>(wirebit::SocketCanLink::attach("vcan_names").value())),
+              ep_a(link_a, wirebit::CanConfig{}, 1), ep_b(link_b, wirebit::CanConfig{}, 2),
+              nm_a(NetworkConfig{}.rx_batch(64)) {
+            nm_a.set_endpoint(0, &ep_a);
+            nm_b.set_endpoint(0, &ep_b);
+        }
+    };
+
+    Frame claim_frame(Name name, Address addr) {
+        auto bytes = name.to_bytes();
+        return Frame::from_message(Priority::Default, PGN_ADDRESS_CLAIMED, addr, BROADCAST_ADDRESS, bytes.data(), 8);
+    }
+
+} // namespace
+
+TEST_CASE("NameTable maps addresses and NAMEs both ways") {
+    NameTable table;
+    Name a = Name::build().set_identity_number(1);
+    Name b = Name::build().set_identity_number(2);
+
+    CHECK_FALSE(table.claim(0, a, 0x80, 100));
+    CHECK(table.name_at(0, 0x80).value() == a);
+    CHECK(table.address_of(0, a).value() == 0x80);
+    CHECK(table.at(0, 0x80)->timestamp_us == 100);
+    CHECK_FALSE(table.name_at(1, 0x80));
+
+    // Moving frees the old address
+    table.claim(0, a, 0x81);
+    CHECK_FALSE(table.name_at(0, 0x80));
+    CHECK(table.address_of(0, a).value() == 0x81);
+
+    // Taking an address evicts its holder
+    auto displaced = table.claim(0, b, 0x81);
+    REQUIRE(displaced);
+    CHECK(*displaced == a);
+    CHECK_FALSE(table.address_of(0, a));
+    CHECK(table.taken(0, 0x81, a));
+    CHECK_FALSE(table.taken(0, 0x81, b));
+
+    // Cannot claim removes the NAME
+    table.claim(0, b, NULL_ADDRESS);
+    CHECK(table.size(0) == 0);
+}
+
+TEST_CASE("A claim burst is handled as one batch") {
+    Pair pair;
+    // Highest possible NAME: loses every contest
+    Name ours = Name(0xFFFFFFFFFFFFFFF0ULL);
+    auto *cf = pair.nm_a.create_internal(ours, 0, 0x80).value();
+    REQUIRE(pair.nm_a.start_address_claiming().is_ok());
+    pair.nm_a.update(300);
+    REQUIRE(cf->claim_state() == ClaimState::Claimed);
+    CHECK(pair.nm_a.names().name_at(0, 0x80).value() == ours);
+
+    u32 batches = 0;
+    pair.nm_a.on_names_changed.subscribe([&](u8 port) {
+        CHECK(port == 0);
+        ++batches;
+    });
+
+    // 16 ECUs power up and claim 0x80..0x8F
+    for (u32 i = 0; i < 16; ++i)
+        pair.nm_b.send_frame(claim_frame(Name::build().set_identity_number(1000 + i), static_cast<Address>(0x80 + i)));
+    pair.nm_b.update(0);
+    pair.nm_a.update(0);
+
+    CHECK(batches == 1);
+    CHECK(pair.nm_a.names().size(0) == 17);
+    CHECK(pair.nm_a.names().address_of(0, Name::build().set_identity_number(1007)).value() == 0x87);
+
+    // Lost 0x80 and skipped every address the burst took
+    CHECK(cf->address() == 0x90);
+    CHECK(pair.nm_a.names().name_at(0, 0x90).value() == ours);
+    CHECK(pair.nm_a.names().name_at(0, 0x80).value() == Name::build().set_identity_number(1000));
+}
+
+TEST_CASE("Pending NAMEs that are already on the bus are refused") {
+    Pair pair;
+    Name ours = Name::build().set_identity_number(5).set_function_code(1);
+    auto *cf = pair.nm_a.create_internal(ours, 0, 0x28).value();
+    NameManager mgr(pair.nm_a, cf);
+    mgr.initialize();
+
+    Name clash = Name::build().set_identity_number(5).set_function_code(2);
+    pair.nm_b.send_frame(claim_frame(clash, 0x40));
+    pair.nm_b.update(0);
+    pair.nm_a.update(0);
+    REQUIRE(pair.nm_a.names().address_of(0, clash));
+
+    CHECK_FALSE(mgr.set_pending(clash).is_ok());
+    CHECK(mgr.set_pending(Name::build().set_identity_number(5).set_function_code(3)).is_ok());
+}
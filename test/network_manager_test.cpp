@@ -1,5 +1,6 @@
 #include <doctest/doctest.h>
 #include <agrobus/net/network_manager.hpp>
+#include <linux/can.h>
 
 using namespace agrobus::net;
 
@@ -76,3 +77,41 @@ TEST_CASE("Control functions list") {
     auto cfs = nm.control_functions();
     CHECK(cfs.size() == 2);
 }
+
+TEST_CASE("IsoNet delivers messages between its own CFs without the bus") {
+    IsoNet nm(NetworkConfig{}.local(true, true));
+    dp::Vector<canfd_frame> wire;
+    REQUIRE(nm.set_fd_port(0, [&](const canfd_frame &cf) {
+                  wire.push_back(cf);
+                  return true;
+              }).is_ok());
+    auto *server = nm.create_internal(Name::build().set_identity_number(1), 0, 0x80).value();
+    auto *client = nm.create_internal(Name::build().set_identity_number(2), 0, 0x81).value();
+
+    dp::Vector<Message> got;
+    nm.register_pgn_callback(0xCB00, [&](const Message &msg) { got.push_back(msg); });
+
+    // A DDOP-sized transfer: no TP session, nothing on the wire
+    dp::Vector<u8> ddop(1500, 0x5A);
+    REQUIRE(nm.send(0xCB00, ddop, client, &server->cf()).is_ok());
+    CHECK(wire.empty());
+    CHECK(nm.local_pending() == 1);
+    CHECK(nm.next_deadline_ms() == 0);
+    nm.update(0);
+    REQUIRE(got.size() == 1);
+    CHECK(got[0].data.size() == 1500);
+    CHECK(got[0].source == 0x81);
+    CHECK(got[0].destination == 0x80);
+
+    // Single frames are mirrored for bus monitors
+    dp::Vector<u8> status(8, 0x01);
+    REQUIRE(nm.send(0xCB00, status, server, &client->cf()).is_ok());
+    CHECK(wire.size() == 1);
+    nm.update(0);
+    CHECK(got.size() == 2);
+
+    // Broadcasts still go out on the bus only
+    REQUIRE(nm.send(0xCB00, status, server).is_ok());
+    CHECK(nm.local_pending() == 0);
+    CHECK(wire.size() == 2);
+}
@@ -2,6 +2,8 @@
 #include <agrobus/net/constants.hpp>
 #include <agrobus/net/frame.hpp>
 #include <agrobus/net/niu.hpp>
+#include <wirebit/can/can_endpoint.hpp>
+#include <wirebit/can/socketcan_link.hpp>
 
 using namespace agrobus::net;
 
@@ -11,6 +13,44 @@ static Frame make_frame(PGN pgn, Address src = 0x28, Address dst = BROADCAST_ADD
     return Frame::from_message(Priority::Default, pgn, src, dst, payload, 8);
 }
 
+namespace {
+
+    // One vcan bus: the NIU's endpoint and another node's
+    struct Bus {
+        std::shared_ptr<wirebit::SocketCanLink> niu_link;
+        std::shared_ptr<wirebit::SocketCanLink> node_link;
+        wirebit::CanEndpoint niu_ep;
+        wirebit::CanEndpoint node_ep;
+
+        explicit Bus(const char *ifname)
+            : niu_link(std::make_shared<wirebit::SocketCanLink>(
+                  wirebit::SocketCanLink::create(
+                      {.interface_name = ifname, .create_if_missing = true, .destroy_on_close = true})
+                      .value())),
+              node_link(std::make_shared<wirebit::SocketCanLink>(wirebit::SocketCanLink::attach(ifname).value())),
+              niu_ep(niu_link, wirebit::CanConfig{}, 1), node_ep(node_link, wirebit::CanConfig{}, 2) {}
+
+        // Next frame the other node sees
+        dp::Optional<Frame> recv() {
+            can_frame cf;
+            if (!node_ep.recv_can(cf).is_ok())
+                return dp::nullopt;
+            Frame f;
+            f.id = Identifier(cf.can_id & CAN_EFF_MASK);
+            f.length = cf.can_dlc;
+            for (u8 i = 0; i < 8; ++i)
+                f.data[i] = cf.data[i];
+            return f;
+        }
+    };
+
+    Frame cm_frame(Address src, Address dst, u8 b0, u8 b1, u8 b2, u8 b3, u8 b4, PGN pgn) {
+        u8 d[8] = {b0, b1, b2, b3, b4, static_cast<u8>(pgn), static_cast<u8>(pgn >> 8), static_cast<u8>(pgn >> 16)};
+        return Frame::from_message(Priority::Lowest, PGN_TP_CM, src, dst, d, 8);
+    }
+
+} // namespace
+
 TEST_CASE("NIU construction and configuration") {
     SUBCASE("default configuration") {
         NIU niu;
@@ -296,3 +336,239 @@ TEST_CASE("NIU unidirectional filter") {
         CHECK(niu.blocked() == 0);
     }
 }
+
+TEST_CASE("NIUFilterTable compiles rules into a PGN bitmap") {
+    dp::Vector<FilterRule> rules;
+    rules.push_back({PGN_DM1, ForwardPolicy::Block});
+    rules.push_back({PGN_GROUND_SPEED, ForwardPolicy::Monitor, false});
+    rules.push_back({0x3FFFF, ForwardPolicy::Block});
+    rules.push_back({0x00000, ForwardPolicy::Allow});
+    // Sender-qualified rule ahead of a catch-all for the same PGN
+    FilterRule from_tecu{PGN_VEHICLE_SPEED, ForwardPolicy::Allow};
+    from_tecu.source = 0x26;
+    rules.push_back(from_tecu);
+    rules.push_back({PGN_VEHICLE_SPEED, ForwardPolicy::Block});
+
+    NIUFilterTable table;
+    table.compile(rules);
+    CHECK(table.size(Side::Tractor) == 5);
+    CHECK(table.size(Side::Implement) == 4);
+
+    REQUIRE(table.match(Side::Tractor, PGN_DM1, 0x80, BROADCAST_ADDRESS));
+    CHECK(table.match(Side::Tractor, PGN_DM1, 0x80, BROADCAST_ADDRESS)->policy == ForwardPolicy::Block);
+    CHECK(table.match(Side::Tractor, 0x3FFFF, 0x80, BROADCAST_ADDRESS)->policy == ForwardPolicy::Block);
+    CHECK(table.match(Side::Tractor, 0x00000, 0x80, BROADCAST_ADDRESS)->policy == ForwardPolicy::Allow);
+    CHECK(table.match(Side::Tractor, PGN_DM1 + 1, 0x80, BROADCAST_ADDRESS) == nullptr);
+    CHECK(table.match(Side::Tractor, 0x40000, 0x80, BROADCAST_ADDRESS) == nullptr);
+
+    // One-way rules only exist on the tractor side
+    CHECK(table.match(Side::Tractor, PGN_GROUND_SPEED, 0x80, BROADCAST_ADDRESS) != nullptr);
+    CHECK(table.match(Side::Implement, PGN_GROUND_SPEED, 0x80, BROADCAST_ADDRESS) == nullptr);
+
+    // First matching rule in list order wins
+    CHECK(table.match(Side::Tractor, PGN_VEHICLE_SPEED, 0x26, BROADCAST_ADDRESS)->policy == ForwardPolicy::Allow);
+    CHECK(table.match(Side::Tractor, PGN_VEHICLE_SPEED, 0x27, BROADCAST_ADDRESS)->policy == ForwardPolicy::Block);
+}
+
+TEST_CASE("NIU address-qualified filters") {
+    NIU niu(NIUConfig{}.specific_default(false));
+    IsoNet tractor_net;
+    IsoNet implement_net;
+    niu.attach_tractor(&tractor_net);
+    niu.attach_implement(&implement_net);
+    niu.start();
+
+    // Only requests to the TECU pass
+    FilterRule to_tecu{PGN_REQUEST, ForwardPolicy::Allow};
+    to_tecu.destination = 0x26;
+    niu.add_filter(to_tecu);
+
+    niu.process_implement_frame(make_frame(PGN_REQUEST, 0x80, 0x26));
+    CHECK(niu.forwarded() == 1);
+    niu.process_implement_frame(make_frame(PGN_REQUEST, 0x80, 0x27));
+    CHECK(niu.blocked() == 1);
+
+    // Filters added after the first frame take effect
+    niu.block_pgn(PGN_VEHICLE_SPEED);
+    niu.process_tractor_frame(make_frame(PGN_VEHICLE_SPEED));
+    CHECK(niu.blocked() == 2);
+    niu.clear_filters();
+    niu.process_tractor_frame(make_frame(PGN_VEHICLE_SPEED));
+    CHECK(niu.forwarded() == 2);
+}
+
+TEST_CASE("NIU without frame events") {
+    NIU niu(NIUConfig{}.events(false));
+    IsoNet tractor_net;
+    IsoNet implement_net;
+    niu.attach_tractor(&tractor_net);
+    niu.attach_implement(&implement_net);
+    niu.start();
+    niu.monitor_pgn(PGN_GROUND_SPEED).block_pgn(PGN_DM1);
+
+    u32 events = 0;
+    niu.on_forwarded.subscribe([&](const Frame &, Side) { ++events; });
+    niu.on_blocked.subscribe([&](const Frame &, Side) { ++events; });
+    niu.on_monitored.subscribe([&](const Frame &, Side) { ++events; });
+
+    niu.process_tractor_frame(make_frame(PGN_GROUND_SPEED));
+    niu.process_tractor_frame(make_frame(PGN_DM1));
+    niu.process_tractor_frame(make_frame(PGN_VEHICLE_SPEED));
+    CHECK(events == 0);
+    CHECK(niu.forwarded() == 2);
+    CHECK(niu.blocked() == 1);
+}
+
+TEST_CASE("NIU cut-through forwards ahead of protocol processing") {
+    Bus tractor_bus("vcan_niu_t");
+    Bus implement_bus("vcan_niu_i");
+    IsoNet tractor_net;
+    IsoNet implement_net;
+    tractor_net.set_endpoint(0, &tractor_bus.niu_ep);
+    implement_net.set_endpoint(0, &implement_bus.niu_ep);
+
+    NIU niu(NIUConfig{}.cut_through_mode(true));
+    niu.attach_tractor(&tractor_net);
+    niu.attach_implement(&implement_net);
+    niu.block_pgn(PGN_DM1);
+    REQUIRE(niu.start().is_ok());
+
+    // By the time the tractor side handles the frame it is already on the implement bus
+    u32 handled = 0;
+    bool already_forwarded = false;
+    tractor_net.on_message.subscribe([&](const Message &msg) {
+        if (msg.pgn != PGN_VEHICLE_SPEED)
+            return;
+        ++handled;
+        can_frame cf;
+        already_forwarded = implement_bus.node_ep.recv_can(cf).is_ok();
+    });
+
+    Frame speed = make_frame(PGN_VEHICLE_SPEED);
+    can_frame out = {};
+    out.can_id = speed.id.raw | CAN_EFF_FLAG;
+    out.can_dlc = 8;
+    REQUIRE(tractor_bus.node_ep.send_can(out).is_ok());
+    Frame dm1 = make_frame(PGN_DM1);
+    out.can_id = dm1.id.raw | CAN_EFF_FLAG;
+    REQUIRE(tractor_bus.node_ep.send_can(out).is_ok());
+    tractor_net.update(0);
+
+    CHECK(handled == 1);
+    CHECK(already_forwarded);
+    CHECK(niu.forwarded() == 1);
+    CHECK(niu.blocked() == 1);
+    can_frame cf;
+    CHECK_FALSE(implement_bus.node_ep.recv_can(cf).is_ok());
+
+    // Stopped: no more bridging
+    niu.stop();
+    out.can_id = speed.id.raw | CAN_EFF_FLAG;
+    REQUIRE(tractor_bus.node_ep.send_can(out).is_ok());
+    tractor_net.update(0);
+    CHECK(niu.forwarded() == 1);
+}
+
+TEST_CASE("NIU relays TP sessions store-and-forward") {
+    Bus tractor_bus("vcan_niu_t");
+    Bus implement_bus("vcan_niu_i");
+    IsoNet tractor_net;
+    IsoNet implement_net;
+    tractor_net.set_endpoint(0, &tractor_bus.niu_ep);
+    implement_net.set_endpoint(0, &implement_bus.niu_ep);
+
+    NIU niu(NIUConfig{}.transport_mode(true));
+    niu.attach_tractor(&tractor_net);
+    niu.attach_implement(&implement_net);
+    REQUIRE(niu.start().is_ok());
+
+    // 0x28 on the tractor bus sends 20 bytes of PGN 0xEF00 to 0x90 on the implement bus
+    const PGN pgn = 0xEF00;
+    niu.process_tractor_frame(cm_frame(0x28, 0x90, tp_cm::RTS, 20, 0, 3, 16, pgn));
+    auto cts = tractor_bus.recv();
+    REQUIRE(cts);
+    CHECK(cts->pgn() == PGN_TP_CM);
+    CHECK(cts->source() == 0x90); // Answered on the tractor bus by the NIU
+    CHECK(cts->data[0] == tp_cm::CTS);
+    CHECK(cts->data[1] == 3);
+    CHECK_FALSE(implement_bus.recv());
+
+    for (u8 seq = 1; seq <= 3; ++seq) {
+        u8 d[8] = {seq, 0, 0, 0, 0, 0, 0, 0};
+        for (u8 i = 1; i < 8; ++i)
+            d[i] = static_cast<u8>((seq - 1) * 7 + i);
+        niu.process_tractor_frame(Frame::from_message(Priority::Lowest, PGN_TP_DT, 0x28, 0x90, d, 8));
+    }
+    auto eoma = tractor_bus.recv();
+    REQUIRE(eoma);
+    CHECK(eoma->data[0] == tp_cm::EOMA);
+
+    // Complete on the tractor side: a new session starts on the implement side
+    auto rts = implement_bus.recv();
+    REQUIRE(rts);
+    CHECK(rts->data[0] == tp_cm::RTS);
+    CHECK(rts->source() == 0x28);
+    CHECK(rts->destination() == 0x90);
+    CHECK(rts->data[1] == 20);
+
+    niu.process_implement_frame(cm_frame(0x90, 0x28, tp_cm::CTS, 3, 1, 0xFF, 0xFF, pgn));
+    niu.update(0);
+    dp::Vector<u8> relayed;
+    while (auto dt = implement_bus.recv()) {
+        if (dt->pgn() != PGN_TP_DT)
+            continue;
+        for (u8 i = 1; i < 8; ++i)
+            relayed.push_back(dt->data[i]);
+    }
+    REQUIRE(relayed.size() == 21);
+    for (u8 i = 0; i < 20; ++i)
+        CHECK(relayed[i] == i + 1);
+    CHECK(niu.forwarded() == 1);
+
+    // The filter applies to the transported PGN
+    niu.block_pgn(0xFE00);
+    niu.process_tractor_frame(cm_frame(0x28, BROADCAST_ADDRESS, tp_cm::BAM, 20, 0, 3, 0xFF, 0xFE00));
+    CHECK(niu.blocked() == 1);
+    CHECK_FALSE(implement_bus.recv());
+}
+
+TEST_CASE("NIU address learning keeps unicast on its destination's side") {
+    NIU niu(NIUConfig{}.address_learning(true));
+    IsoNet tractor_net;
+    IsoNet implement_net;
+    niu.attach_tractor(&tractor_net);
+    niu.attach_implement(&implement_net);
+    niu.start();
+
+    // Nothing learned yet: unicast is flooded
+    niu.process_tractor_frame(make_frame(PGN_REQUEST, 0x28, 0x30));
+    CHECK(niu.forwarded() == 1);
+    CHECK(niu.learned_side(0x28) == Side::Tractor);
+    CHECK_FALSE(niu.learned_side(0x30).has_value());
+
+    // 0x30 claims on the tractor side: requests to it stay there
+    niu.process_tractor_frame(make_frame(PGN_ADDRESS_CLAIMED, 0x30));
+    CHECK(niu.forwarded() == 2); // The claim itself is broadcast
+    niu.process_tractor_frame(make_frame(PGN_REQUEST, 0x28, 0x30));
+    CHECK(niu.forwarded() == 2);
+    CHECK(niu.kept_local() == 1);
+
+    // From the implement side they cross, as do broadcasts
+    niu.process_implement_frame(make_frame(PGN_REQUEST, 0x40, 0x30));
+    niu.process_tractor_frame(make_frame(PGN_VEHICLE_SPEED, 0x30));
+    CHECK(niu.forwarded() == 4);
+
+    // The address is claimed again on the implement side and moves with it
+    niu.process_implement_frame(make_frame(PGN_ADDRESS_CLAIMED, 0x30));
+    CHECK(niu.learned_side(0x30) == Side::Implement);
+    niu.process_tractor_frame(make_frame(PGN_REQUEST, 0x28, 0x30));
+    CHECK(niu.forwarded() == 6);
+
+    // A cannot-claim from NULL teaches nothing
+    niu.process_implement_frame(make_frame(PGN_ADDRESS_CLAIMED, NULL_ADDRESS));
+    CHECK_FALSE(niu.learned_side(NULL_ADDRESS).has_value());
+
+    niu.forget_addresses();
+    niu.process_implement_frame(make_frame(PGN_REQUEST, 0x40, 0x28));
+    CHECK(niu.kept_local() == 1);
+}
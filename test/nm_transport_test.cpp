@@ -119,6 +119,37 @@ TEST_CASE("IsoNet - send auto-selects transport based on size") {
     }
 }
 
+TEST_CASE("IsoNet - send_shared keeps large payloads by reference") {
+    TestSetup setup;
+    ControlFunction dest_cf;
+    dest_cf.address = 0x30;
+
+    SUBCASE("single frame payload is sent directly") {
+        auto data = std::make_shared<dp::Vector<u8>>(8, 0xAA);
+        CHECK(setup.nm.send_shared(PGN_HEARTBEAT, data, setup.cf).is_ok());
+        CHECK(setup.captured().size() == 1);
+        CHECK(data.use_count() == 1);
+    }
+
+    SUBCASE("TP session references the payload") {
+        auto data = std::make_shared<dp::Vector<u8>>(100, 0xCC);
+        CHECK(setup.nm.send_shared(PGN_VT_TO_ECU, data, setup.cf, &dest_cf).is_ok());
+        auto frames = setup.captured();
+        REQUIRE(frames.size() == 1);
+        CHECK(frames[0].data[0] == tp_cm::RTS);
+        CHECK(data.use_count() == 2);
+    }
+
+    SUBCASE("ETP session references the payload") {
+        auto data = std::make_shared<dp::Vector<u8>>(4000, 0xEE);
+        CHECK(setup.nm.send_shared(PGN_VT_TO_ECU, data, setup.cf, &dest_cf).is_ok());
+        auto frames = setup.captured();
+        REQUIRE(frames.size() == 1);
+        CHECK(frames[0].pgn() == PGN_ETP_CM);
+        CHECK(data.use_count() == 2);
+    }
+}
+
 TEST_CASE("IsoNet - TP BAM receive via process_frame") {
     TestSetup setup;
 
@@ -435,3 +466,45 @@ TEST_CASE("IsoNet - transport protocol accessor") {
     (void)etp;
     (void)fp;
 }
+
+TEST_CASE("IsoNet - foreign_transport_filter leaves other CFs' TP transfers alone") {
+    LoopbackBus bus;
+    IsoNet nm_a;
+    IsoNet nm_b;
+    IsoNet nm_c(NetworkConfig{}.foreign_transport_filter());
+    IsoNet nm_d; // Filter off: the transfer still reaches its transport layer
+    bus.attach(nm_a);
+    bus.attach(nm_b);
+    bus.attach(nm_c);
+    bus.attach(nm_d);
+    auto *cf_a = nm_a.create_internal(Name::build().set_identity_number(1), 0, 0x28).value();
+    nm_b.create_internal(Name::build().set_identity_number(2), 0, 0x30);
+    nm_c.create_internal(Name::build().set_identity_number(3), 0, 0x38);
+    nm_d.create_internal(Name::build().set_identity_number(4), 0, 0x40);
+    IsoNet *nets[] = {&nm_a, &nm_b, &nm_c, &nm_d};
+    for (auto *nm : nets)
+        nm->start_address_claiming();
+    for (u32 ms = 0; ms < 400; ++ms) {
+        for (auto *nm : nets)
+            nm->update(1);
+    }
+
+    dp::Vector<u8> received;
+    nm_b.register_pgn_callback(0xEF00, [&](const Message &msg) { received = msg.data; });
+    ControlFunction dest;
+    dest.address = 0x30;
+    REQUIRE(nm_a.send(0xEF00, dp::Vector<u8>(100, 0x5A), cf_a, &dest).is_ok());
+    // An unfiltered stack opens a session for the RTS to 0x30 (and answers it as
+    // 0x30); a filtered one never sees it
+    bool c_saw_session = false;
+    bool d_saw_session = false;
+    for (u32 ms = 0; ms < 1000 && received.empty(); ++ms) {
+        for (auto *nm : nets)
+            nm->update(1);
+        c_saw_session = c_saw_session || !nm_c.transport_protocol().active_sessions().empty();
+        d_saw_session = d_saw_session || !nm_d.transport_protocol().active_sessions().empty();
+    }
+    CHECK(received.size() == 100);
+    CHECK_FALSE(c_saw_session);
+    CHECK(d_saw_session);
+}
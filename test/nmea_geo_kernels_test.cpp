@@ -0,0 +1,90 @@
+#include <doctest/doctest.h>
+#include <agrobus/nmea/geo_kernels.hpp>
+#include <agrobus/nmea/position.hpp>
+#include <cmath>
+
+using namespace agrobus::nmea;
+
+namespace {
+    // A field-sized track around the reference, odd length to cover the scalar tail
+    GNSSBatch track(usize n) {
+        GNSSBatch batch;
+        for (usize i = 0; i < n; ++i) {
+            GNSSPosition pos;
+            f64 t = static_cast<f64>(i);
+            pos.wgs = concord::earth::WGS(48.0 + 0.01 * std::sin(t * 0.01), 11.0 + 0.01 * std::cos(t * 0.013),
+                                          500.0 + std::fmod(t, 7.0));
+            batch.positions.push_back(pos);
+        }
+        return batch;
+    }
+} // namespace
+
+TEST_CASE("Geo kernels match the per-point conversions") {
+    const usize N = 1003;
+    GNSSBatch batch = track(N);
+    dp::Geo ref{48.0, 11.0, 500.0};
+
+    dp::Vector<f64> x(N), y(N), z(N);
+    batch.to_ecf_batch(x.data(), y.data(), z.data());
+    dp::Vector<f64> e(N), n(N), u(N);
+    batch.to_enu_batch(ref, e.data(), n.data(), u.data());
+    dp::Vector<f64> nn(N), ne(N), nd(N);
+    batch.to_ned_batch(ref, nn.data(), ne.data(), nd.data());
+
+    auto ecf = batch.to_ecf_batch();
+    auto enu = batch.to_enu_batch(ref);
+    for (usize i = 0; i < N; i += 97) {
+        CHECK(x[i] == doctest::Approx(ecf[i].x).epsilon(1e-9));
+        CHECK(y[i] == doctest::Approx(ecf[i].y).epsilon(1e-9));
+        CHECK(z[i] == doctest::Approx(ecf[i].z).epsilon(1e-9));
+        CHECK(std::abs(e[i] - enu[i].east()) < 1e-3);
+        CHECK(std::abs(n[i] - enu[i].north()) < 1e-3);
+        CHECK(std::abs(u[i] - enu[i].up()) < 1e-3);
+        CHECK(nn[i] == n[i]);
+        CHECK(ne[i] == e[i]);
+        CHECK(nd[i] == -u[i]);
+    }
+    // The last point exercises the scalar tail
+    CHECK(std::abs(e[N - 1] - enu[N - 1].east()) < 1e-3);
+}
+
+TEST_CASE("Geo kernels on raw arrays") {
+    f64 lat[] = {0.0, 90.0, 48.0};
+    f64 lon[] = {0.0, 0.0, 11.0};
+    f64 alt[] = {0.0, 0.0, 500.0};
+    f64 x[3], y[3], z[3];
+    wgs_to_ecef(lat, lon, alt, 3, x, y, z);
+    CHECK(x[0] == doctest::Approx(WGS84_A));
+    CHECK(std::abs(y[0]) < 1e-9);
+    CHECK(z[1] == doctest::Approx(6356752.314245));
+
+    f64 e[3], n[3], u[3];
+    LocalFrame frame = LocalFrame::at(48.0, 11.0, 500.0);
+    wgs_to_enu(frame, lat, lon, alt, 3, e, n, u);
+    CHECK(std::abs(e[2]) < 1e-6);
+    CHECK(std::abs(n[2]) < 1e-6);
+    CHECK(std::abs(u[2]) < 1e-6);
+}
+
+TEST_CASE("Parallel batch conversion matches the serial one") {
+    const usize N = 40000;
+    GNSSBatch batch = track(N);
+    dp::Geo ref{48.0, 11.0, 500.0};
+    dp::Vector<f64> e1(N), n1(N), u1(N), e4(N), n4(N), u4(N);
+    batch.to_enu_batch(ref, e1.data(), n1.data(), u1.data());
+    batch.to_enu_batch(ref, e4.data(), n4.data(), u4.data(), 4);
+    CHECK(e1 == e4);
+    CHECK(n1 == n4);
+    CHECK(u1 == u4);
+
+    dp::Vector<f64> lat(N), lon(N), alt(N), e(N), n(N), u(N);
+    for (usize i = 0; i < N; ++i) {
+        lat[i] = batch.positions[i].wgs.latitude;
+        lon[i] = batch.positions[i].wgs.longitude;
+        alt[i] = batch.positions[i].wgs.altitude;
+    }
+    wgs_to_enu(LocalFrame::at(ref), lat.data(), lon.data(), alt.data(), N, e.data(), n.data(), u.data(), 0);
+    CHECK(e == e1);
+    CHECK(u == u1);
+}
@@ -0,0 +1,127 @@
+#include <doctest/doctest.h>
+#include <agrobus/nmea/gnss_binary.hpp>
+
+using namespace agrobus::nmea;
+
+namespace {
+    void put_le(dp::Vector<u8> &v, usize at, u64 value, usize bytes) {
+        for (usize i = 0; i < bytes; ++i)
+            v[at + i] = static_cast<u8>(value >> (8 * i));
+    }
+
+    dp::Vector<u8> ubx_frame(u8 cls, u8 id, const dp::Vector<u8> &payload) {
+        dp::Vector<u8> f = {UBX_SYNC_1, UBX_SYNC_2, cls, id, static_cast<u8>(payload.size()),
+                            static_cast<u8>(payload.size() >> 8)};
+        f.insert(f.end(), payload.begin(), payload.end());
+        u16 sum = ubx_checksum(f.data() + 2, f.size() - 2);
+        f.push_back(static_cast<u8>(sum));
+        f.push_back(static_cast<u8>(sum >> 8));
+        return f;
+    }
+
+    dp::Vector<u8> nav_pvt() {
+        dp::Vector<u8> p(UBX_NAV_PVT_LENGTH, 0);
+        p[20] = 3;                                        // 3D fix
+        p[21] = 0x01 | 0x02 | (2 << 6);                   // Fix OK, differential, carrier fixed
+        p[23] = 17;                                       // Satellites
+        put_le(p, 24, static_cast<u32>(115183333), 4);    // lon 11.5183333
+        put_le(p, 28, static_cast<u32>(481173000), 4);    // lat 48.1173
+        put_le(p, 32, 592300, 4);                         // 592.3 m above the ellipsoid
+        put_le(p, 36, 545400, 4);                         // 545.4 m above MSL
+        put_le(p, 60, 2500, 4);                           // 2.5 m/s
+        put_le(p, 64, 9000000, 4);                        // 90 degrees
+        put_le(p, 76, 130, 2);                            // PDOP 1.3
+        return p;
+    }
+
+    struct Frames {
+        dp::Vector<GNSSBinaryProtocol> protocols;
+        dp::Vector<dp::Vector<u8>> frames;
+
+        auto sink() {
+            return [this](GNSSBinaryProtocol p, const u8 *data, usize len) {
+                protocols.push_back(p);
+                frames.push_back(dp::Vector<u8>(data, data + len));
+            };
+        }
+    };
+} // namespace
+
+TEST_CASE("Binary GNSS checksums") {
+    const char *check = "123456789";
+    CHECK(crc24q(reinterpret_cast<const u8 *>(check), 9) == 0xCDE703);
+    u8 ack[] = {0x05, 0x01, 0x02, 0x00, 0x06, 0x01};
+    CHECK(ubx_checksum(ack, sizeof(ack)) == (0x0F | (0x38 << 8)));
+}
+
+TEST_CASE("UBX-NAV-PVT fills a GNSSPosition") {
+    GNSSPosition pos;
+    auto p = nav_pvt();
+    REQUIRE(decode_ubx_nav_pvt(p.data(), p.size(), pos));
+    CHECK(pos.fix_type == GNSSFixType::RTKFixed);
+    CHECK(pos.satellites_used == 17);
+    CHECK(pos.wgs.latitude == doctest::Approx(48.1173));
+    CHECK(pos.wgs.longitude == doctest::Approx(11.5183333));
+    CHECK(pos.wgs.altitude == doctest::Approx(545.4));
+    CHECK(*pos.geoidal_separation_m == doctest::Approx(46.9));
+    CHECK(*pos.speed_mps == doctest::Approx(2.5));
+    CHECK(*pos.cog_rad == doctest::Approx(M_PI / 2));
+    CHECK(*pos.pdop == doctest::Approx(1.3));
+    CHECK_FALSE(pos.heading_rad.has_value());
+
+    p[21] = 0x00; // Fix not OK
+    REQUIRE(decode_ubx_nav_pvt(p.data(), p.size(), pos));
+    CHECK_FALSE(pos.has_fix());
+    CHECK_FALSE(decode_ubx_nav_pvt(p.data(), 40, pos)); // Truncated
+}
+
+TEST_CASE("GNSSBinaryReader frames UBX and RTCM3") {
+    auto ubx = ubx_frame(UBX_CLASS_NAV, UBX_NAV_PVT, nav_pvt());
+    dp::Vector<u8> rtcm = {RTCM3_PREAMBLE, 0x00, 0x04, 0x3E, 0xD0, 0x00, 0x01};
+    u32 crc = crc24q(rtcm.data(), rtcm.size());
+    rtcm.push_back(static_cast<u8>(crc >> 16));
+    rtcm.push_back(static_cast<u8>(crc >> 8));
+    rtcm.push_back(static_cast<u8>(crc));
+
+    dp::Vector<u8> stream = ubx;
+    stream.insert(stream.end(), rtcm.begin(), rtcm.end());
+    stream.push_back('$'); // Text follows
+
+    SUBCASE("whole stream") {
+        GNSSBinaryReader reader;
+        Frames got;
+        usize used = reader.feed(stream.data(), stream.size(), got.sink());
+        CHECK(used == ubx.size());
+        used += reader.feed(stream.data() + used, stream.size() - used, got.sink());
+        CHECK(used == stream.size() - 1);
+        CHECK(reader.feed(stream.data() + used, 1, got.sink()) == 0); // Not a sync byte
+        REQUIRE(got.frames.size() == 2);
+        CHECK(got.protocols[0] == GNSSBinaryProtocol::UBX);
+        CHECK(got.frames[0] == ubx);
+        CHECK(got.protocols[1] == GNSSBinaryProtocol::RTCM3);
+        CHECK(got.frames[1] == rtcm);
+    }
+
+    SUBCASE("byte at a time") {
+        GNSSBinaryReader reader;
+        Frames got;
+        for (usize i = 0; i + 1 < stream.size(); ++i)
+            CHECK(reader.feed(stream.data() + i, 1, got.sink()) == 1);
+        CHECK_FALSE(reader.active());
+        CHECK(got.frames.size() == 2);
+        CHECK(reader.frames() == 2);
+    }
+
+    SUBCASE("false sync and corrupt frames") {
+        GNSSBinaryReader reader;
+        Frames got;
+        u8 noise[] = {UBX_SYNC_1, 'G'};
+        CHECK(reader.feed(noise, 2, got.sink()) == 1); // 'G' is handed back
+        CHECK_FALSE(reader.active());
+
+        ubx[20] ^= 0xFF;
+        CHECK(reader.feed(ubx.data(), ubx.size(), got.sink()) == ubx.size());
+        CHECK(got.frames.empty());
+        CHECK(reader.checksum_errors() == 1);
+    }
+}
@@ -15,6 +15,22 @@ TEST_CASE("NMEAInterface construction") {
     CHECK(!nmea_if.latest_position().has_value());
 }
 
+TEST_CASE("NMEAInterface registers fast packet PGNs with the shared service") {
+    IsoNet nm(NetworkConfig{}.fast_packet(true));
+    Name name;
+    auto* cf = nm.create_internal(name, 0, 0x28).value();
+
+    NMEAInterface nmea_if(nm, cf, NMEAConfig{}.position_detail(true));
+    nmea_if.initialize();
+    CHECK(nm.fast_packet_pgns().contains(PGN_GNSS_POSITION_DATA));
+    CHECK_FALSE(nm.fast_packet_pgns().contains(PGN_GNSS_POSITION_RAPID));
+
+    // A second interface on the same network does not duplicate the registration
+    NMEAInterface second(nm, cf, NMEAConfig{}.position_detail(true));
+    second.initialize();
+    CHECK(nm.fast_packet_pgns().size() == 1);
+}
+
 TEST_CASE("NMEAInterface event subscription") {
     IsoNet nm;
     Name name;
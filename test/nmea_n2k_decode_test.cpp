@@ -0,0 +1,132 @@
+#include <doctest/doctest.h>
+#include <agrobus/nmea/interface.hpp>
+#include <agrobus/nmea/n2k_decode.hpp>
+#include <agrobus/net/loopback_bus.hpp>
+#include <cmath>
+
+using namespace agrobus::nmea;
+
+namespace {
+    Message message(PGN pgn, std::initializer_list<u8> bytes, u64 ts = 0, Address src = 0x20) {
+        Message msg(pgn, Payload(bytes), src);
+        msg.timestamp_us = ts;
+        return msg;
+    }
+} // namespace
+
+TEST_CASE("decode_n2k fills fixed structs from the layout table") {
+    SUBCASE("wind") {
+        WindData wind;
+        // SID 7, 5.00 m/s, 1.5708 rad, apparent
+        auto msg = message(PGN_WIND_DATA, {7, 0xF4, 0x01, 0x5C, 0x3D, 2, 0xFF, 0xFF});
+        REQUIRE(decode_n2k(msg.data, wind));
+        CHECK(wind.sid == 7);
+        CHECK(wind.speed_mps == doctest::Approx(5.0));
+        CHECK(wind.direction_rad == doctest::Approx(1.5708));
+        CHECK(wind.reference == static_cast<WindReference>(2));
+    }
+
+    SUBCASE("unavailable values keep the default") {
+        WindData wind;
+        auto msg = message(PGN_WIND_DATA, {1, 0xFF, 0xFF, 0xFF, 0xFF, 0});
+        REQUIRE(decode_n2k(msg.data, wind));
+        CHECK(wind.speed_mps == 0.0);
+        CHECK(wind.direction_rad == 0.0);
+        CHECK_FALSE(decode_n2k(DataSpan(msg.data.data(), 5), wind)); // Too short
+    }
+
+    SUBCASE("signed fields and sub-byte fields") {
+        XTEData xte;
+        // Mode 2, navigation terminated, -1.50 m
+        auto msg = message(PGN_XTE, {3, 0x42, 0x6A, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF});
+        REQUIRE(decode_n2k(msg.data, xte));
+        CHECK(xte.mode == static_cast<XTEMode>(2));
+        CHECK(xte.navigation_terminated);
+        CHECK(xte.xte_m == doctest::Approx(-1.5));
+
+        FluidLevelData fluid;
+        auto level = message(PGN_FLUID_LEVEL, {0x13, 0x88, 0x13, 0x64, 0x00, 0x00, 0x00, 0xFF});
+        REQUIRE(decode_n2k(level.data, fluid));
+        CHECK(fluid.instance == 3);
+        CHECK(fluid.type == static_cast<FluidType>(1));
+        CHECK(fluid.level_pct == doctest::Approx(20.0));
+        CHECK(fluid.capacity_l == doctest::Approx(10.0));
+
+        EngineData engine;
+        auto rapid = message(PGN_ENGINE_PARAMS_RAPID, {0, 0x40, 0x1F, 0xFF, 0xFF, 0xFB, 0xFF, 0xFF});
+        REQUIRE(decode_n2k(rapid.data, engine));
+        CHECK(engine.rpm == doctest::Approx(2000.0));
+        CHECK(engine.boost_pressure_pa == 0.0);
+        CHECK(engine.tilt_trim == -5);
+    }
+}
+
+TEST_CASE("NMEAInterface dispatches decoded messages") {
+    IsoNet net;
+    auto *cf = net.create_internal(Name::build().set_identity_number(1), 0, 0x28).value();
+    NMEAInterface nmea(net, cf, NMEAConfig{}.all());
+    REQUIRE(nmea.initialize().is_ok());
+
+    IsoNet sender;
+    auto *tx = sender.create_internal(Name::build().set_identity_number(2), 0, 0x29).value();
+    LoopbackBus bus;
+    bus.attach(net);
+    bus.attach(sender);
+    REQUIRE(net.start_address_claiming().is_ok());
+    REQUIRE(sender.start_address_claiming().is_ok());
+    for (u32 i = 0; i < 60; ++i) {
+        net.update(5);
+        sender.update(5);
+    }
+
+    dp::Optional<BatteryStatusData> battery;
+    dp::Optional<GNSSDOPData> dops;
+    nmea.on_battery.subscribe([&](const BatteryStatusData &b) { battery = b; });
+    nmea.on_gnss_dops.subscribe([&](const GNSSDOPData &d) { dops = d; });
+
+    REQUIRE(sender.send(PGN_BATTERY_STATUS, {1, 0xB0, 0x04, 0x9C, 0xFF, 0xFF, 0xFF, 0xFF}, tx).is_ok());
+    REQUIRE(sender.send(PGN_GNSS_DOPs, {0, 0x12, 0x64, 0x00, 0xC8, 0x00, 0xFF, 0x7F}, tx).is_ok());
+    for (u32 i = 0; i < 4; ++i) {
+        sender.update(5);
+        net.update(5);
+    }
+    REQUIRE(battery.has_value());
+    CHECK(battery->instance == 1);
+    CHECK(battery->voltage == doctest::Approx(12.0));
+    CHECK(battery->current_a == doctest::Approx(-10.0));
+    REQUIRE(dops.has_value());
+    CHECK(dops->desired_mode == static_cast<GNSSDOPMode>(2));
+    CHECK(dops->actual_mode == static_cast<GNSSDOPMode>(2));
+    CHECK(dops->hdop == doctest::Approx(1.0));
+    CHECK(dops->vdop == doctest::Approx(2.0));
+    CHECK(dops->tdop == 0.0); // Unavailable
+}
+
+TEST_CASE("decode_n2k_batch produces one column per field") {
+    dp::Vector<Message> log = {
+        message(PGN_WIND_DATA, {0, 0x64, 0x00, 0x10, 0x27, 2}, 100, 0x20),
+        message(PGN_TEMPERATURE, {0, 0, 0, 0x10, 0x27}, 150),
+        message(PGN_WIND_DATA, {1, 0xC8, 0x00, 0xFF, 0xFF, 2}, 200, 0x21),
+        message(PGN_WIND_DATA, {2, 0x00}, 250), // Truncated
+    };
+    N2KColumns<WindData> cols;
+    CHECK(decode_n2k_batch(log, cols) == 2);
+    REQUIRE(cols.size() == 2);
+    CHECK(cols.timestamp_us[1] == 200);
+    CHECK(cols.source[1] == 0x21);
+
+    auto *speed = cols.column("speed_mps");
+    auto *dir = cols.column("direction_rad");
+    REQUIRE(speed != nullptr);
+    REQUIRE(dir != nullptr);
+    CHECK(cols.column("nope") == nullptr);
+    CHECK((*speed)[0] == doctest::Approx(1.0));
+    CHECK((*speed)[1] == doctest::Approx(2.0));
+    CHECK((*dir)[0] == doctest::Approx(1.0));
+    CHECK(std::isnan((*dir)[1]));
+    CHECK(cols.values[0][1] == 1); // SID
+
+    N2KColumns<TemperatureData> temps;
+    CHECK(decode_n2k_batch(log, temps) == 1);
+    CHECK((*temps.column("actual_k"))[0] == doctest::Approx(100.0));
+}
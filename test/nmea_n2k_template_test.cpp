@@ -0,0 +1,127 @@
+#include <doctest/doctest.h>
+#include <agrobus/nmea/interface.hpp>
+#include <agrobus/nmea/n2k_template.hpp>
+#include <agrobus/net/fast_packet.hpp>
+#include <agrobus/net/loopback_bus.hpp>
+
+using namespace agrobus::nmea;
+
+TEST_CASE("N2KSendTemplate writes fields into the fast packet frames") {
+    N2KSendTemplate tpl(PGN_GNSS_POSITION_DATA, 43);
+    REQUIRE(tpl.fast_packet());
+    REQUIRE(tpl.frame_count() == 7);
+    CHECK(N2KSendTemplate::MAX_FRAMES == 32);
+    CHECK(n2k_frame_count(8) == 1);
+    CHECK(n2k_frame_count(9) == 2);
+    CHECK(n2k_frame_count(13) == 2);
+    CHECK(n2k_frame_count(14) == 3);
+
+    // Offset 7 is the second byte of frame 1, an i64 spans into frame 2
+    CHECK(tpl.set<i64>(7, 0x0102030405060708LL));
+    CHECK_FALSE(tpl.set<i64>(7, 0x0102030405060708LL)); // Unchanged
+    CHECK(tpl.byte(7) == 0x08);
+    CHECK(tpl.byte(14) == 0x01);
+    CHECK(tpl.set<u8>(0, 3));
+    CHECK(tpl.set_scaled<i16>(34, dp::nullopt, 0.01));
+    CHECK(tpl.byte(34) == 0xFF);
+    CHECK(tpl.byte(35) == 0x7F);
+
+    const Frame *frames = tpl.frames(0x42, 5);
+    CHECK(frames[0].data[0] == (5 << 5));
+    CHECK(frames[0].data[1] == 43);
+    CHECK(frames[0].data[2] == 3);
+    CHECK(frames[1].data[0] == ((5 << 5) | 1));
+    CHECK(frames[1].data[2] == 0x08);
+    CHECK(frames[6].source() == 0x42);
+    CHECK(frames[6].pgn() == PGN_GNSS_POSITION_DATA);
+
+    // Reassembles to the same payload
+    FastPacketProtocol fp;
+    dp::Optional<Message> msg;
+    for (usize i = 0; i < tpl.frame_count(); ++i)
+        msg = fp.process_frame(frames[i]);
+    REQUIRE(msg.has_value());
+    REQUIRE(msg->data.size() == 43);
+    for (usize i = 0; i < 43; ++i)
+        CHECK(msg->data[i] == tpl.byte(i));
+
+    N2KSendTemplate single(PGN_GNSS_POSITION_RAPID, 8);
+    CHECK_FALSE(single.fast_packet());
+    single.set<i32>(4, -1);
+    CHECK(single.frames(0x42)[0].data[7] == 0xFF);
+    CHECK(single.frames(0x42)[0].data[0] == 0xFF);
+}
+
+TEST_CASE("NMEAInterface publishes a GNSS tick as one batch") {
+    IsoNet gateway;
+    auto *gw_cf = gateway.create_internal(Name::build().set_identity_number(1), 0, 0x28).value();
+    NMEAInterface publisher(gateway, gw_cf);
+    REQUIRE(publisher.initialize().is_ok());
+
+    IsoNet plotter(NetworkConfig{}.fast_packet(true));
+    auto *rx_cf = plotter.create_internal(Name::build().set_identity_number(2), 0, 0x29).value();
+    NMEAInterface listener(plotter, rx_cf, NMEAConfig{}.all());
+    REQUIRE(listener.initialize().is_ok());
+
+    GNSSPosition pos;
+    pos.wgs = concord::earth::WGS(48.123, 11.456);
+    pos.altitude_m = 512.25;
+    pos.fix_type = GNSSFixType::RTKFixed;
+    pos.satellites_used = 14;
+    pos.hdop = 0.8;
+    pos.vdop = 1.2;
+    pos.cog_rad = 1.0;
+    pos.speed_mps = 3.5;
+    pos.heading_rad = 1.1;
+    CHECK(publisher.publish_gnss(pos).is_err()); // No address yet
+
+    LoopbackBus bus;
+    bus.attach(gateway);
+    bus.attach(plotter);
+    REQUIRE(gateway.start_address_claiming().is_ok());
+    REQUIRE(plotter.start_address_claiming().is_ok());
+    for (u32 i = 0; i < 60; ++i) {
+        gateway.update(5);
+        plotter.update(5);
+    }
+
+    usize positions = 0;
+    dp::Optional<GNSSPosition> detail;
+    dp::Optional<GNSSDOPData> dops;
+    dp::Optional<f64> heading, sog;
+    listener.on_position.subscribe([&](const GNSSPosition &p) {
+        ++positions;
+        if (p.altitude_m) // 129029
+            detail = p;
+    });
+    listener.on_gnss_dops.subscribe([&](const GNSSDOPData &d) { dops = d; });
+    listener.on_heading.subscribe([&](f64 h) { heading = h; });
+    listener.on_sog.subscribe([&](f64 s) { sog = s; });
+
+    for (u8 tick = 0; tick < 3; ++tick) {
+        pos.wgs = concord::earth::WGS(48.123 + tick * 1e-5, 11.456);
+        REQUIRE(publisher.publish_gnss(pos, tick).is_ok());
+        for (u32 i = 0; i < 4; ++i) {
+            gateway.update(5);
+            plotter.update(5);
+        }
+    }
+
+    // Rapid update and position data each tick
+    CHECK(positions == 6);
+    REQUIRE(detail.has_value());
+    CHECK(detail->wgs.latitude == doctest::Approx(48.12302));
+    CHECK(detail->wgs.longitude == doctest::Approx(11.456));
+    CHECK(*detail->altitude_m == doctest::Approx(512.25));
+    CHECK(detail->fix_type == GNSSFixType::RTKFixed);
+    CHECK(detail->satellites_used == 14);
+    CHECK(*detail->hdop == doctest::Approx(0.8));
+    REQUIRE(dops.has_value());
+    CHECK(dops->sid == 2);
+    CHECK(dops->actual_mode == GNSSDOPMode::Mode3D);
+    CHECK(dops->vdop == doctest::Approx(1.2));
+    REQUIRE(heading.has_value());
+    CHECK(*heading == doctest::Approx(1.1).epsilon(1e-3));
+    REQUIRE(sog.has_value());
+    CHECK(*sog == doctest::Approx(3.5));
+}
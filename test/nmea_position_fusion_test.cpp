@@ -0,0 +1,134 @@
+#include <doctest/doctest.h>
+#include <agrobus/nmea/interface.hpp>
+#include <agrobus/nmea/position_fusion.hpp>
+#include <cmath>
+
+using namespace agrobus::nmea;
+
+namespace {
+    GNSSPosition fix(f64 lat, f64 lon, u64 t_us) {
+        GNSSPosition pos;
+        pos.wgs = concord::earth::WGS(lat, lon, 100.0);
+        pos.fix_type = GNSSFixType::RTKFixed;
+        pos.timestamp_us = t_us;
+        return pos;
+    }
+
+    Message message(PGN pgn, std::initializer_list<u8> bytes, u64 ts) {
+        Message msg(pgn, Payload(bytes), 0x20);
+        msg.timestamp_us = ts;
+        return msg;
+    }
+
+    // Metres between two positions in the local frame of `a`
+    f64 distance(const GNSSPosition &a, const GNSSPosition &b) {
+        auto enu = b.to_enu(dp::Geo{a.wgs.latitude, a.wgs.longitude, a.wgs.altitude});
+        return std::hypot(enu.east(), enu.north());
+    }
+} // namespace
+
+TEST_CASE("PositionFusion interpolates between fixes") {
+    PositionFusion fusion;
+    CHECK_FALSE(fusion.position_at(0).has_value());
+
+    GNSSPosition a = fix(48.0, 11.0, 1000000);
+    a.cog_rad = 6.2;
+    a.speed_mps = 2.0;
+    GNSSPosition b = fix(48.0002, 11.0004, 1200000);
+    b.cog_rad = 0.2;
+    b.speed_mps = 4.0;
+    fusion.add_fix(a);
+    fusion.add_fix(b);
+    REQUIRE(fusion.size() == 2);
+
+    auto mid = fusion.position_at(1050000);
+    REQUIRE(mid.has_value());
+    CHECK(mid->timestamp_us == 1050000);
+    CHECK(mid->wgs.latitude == doctest::Approx(48.00005));
+    CHECK(mid->wgs.longitude == doctest::Approx(11.0001));
+    CHECK(*mid->speed_mps == doctest::Approx(2.5));
+    // Across north, not the long way round
+    CHECK(*mid->cog_rad == doctest::Approx(std::fmod(6.2 + (0.2 + 2.0 * M_PI - 6.2) * 0.25, 2.0 * M_PI)));
+
+    CHECK(fusion.position_at(1000000)->wgs.latitude == doctest::Approx(48.0));
+    CHECK_FALSE(fusion.position_at(999999).has_value()); // Before the oldest fix
+
+    // Out of order fixes are dropped
+    fusion.add_fix(fix(47.0, 10.0, 1100000));
+    CHECK(fusion.size() == 2);
+}
+
+TEST_CASE("PositionFusion extrapolates along a straight line and an arc") {
+    PositionFusion fusion(PositionFusionConfig{}.max_extrapolation(1000));
+    fusion.add_fix(fix(48.0, 11.0, 0));
+    fusion.add_course(M_PI / 2.0, 0); // East
+    fusion.add_speed(10.0, 0);
+
+    auto ahead = fusion.position_at(500000);
+    REQUIRE(ahead.has_value());
+    CHECK(ahead->wgs.latitude == doctest::Approx(48.0).epsilon(1e-9));
+    CHECK(ahead->wgs.longitude > 11.0);
+    CHECK(distance(*fusion.latest(), *ahead) == doctest::Approx(5.0).epsilon(1e-3));
+    CHECK_FALSE(fusion.position_at(1000001).has_value()); // Past the extrapolation limit
+
+    // Quarter turn at 10 m/s over one second: chord of a circle with r = 20/pi
+    fusion.add_yaw_rate(M_PI / 2.0, 0);
+    auto arc = fusion.position_at(1000000);
+    REQUIRE(arc.has_value());
+    f64 r = 10.0 / (M_PI / 2.0);
+    CHECK(distance(*fusion.latest(), *arc) == doctest::Approx(r * std::sqrt(2.0)).epsilon(1e-3));
+    CHECK(*arc->cog_rad == doctest::Approx(M_PI));
+    CHECK(arc->wgs.latitude < 48.0); // Turned south
+
+    // Motion older than the limit is not used
+    PositionFusion stale(PositionFusionConfig{}.max_motion_age(100));
+    stale.add_fix(fix(48.0, 11.0, 200000));
+    stale.add_course(0.0, 0);
+    stale.add_speed(10.0, 0);
+    CHECK(stale.position_at(300000)->wgs.latitude == 48.0);
+}
+
+TEST_CASE("PositionFusion derives the turn rate from the course history") {
+    PositionFusion fusion;
+    GNSSPosition a = fix(48.0, 11.0, 0);
+    a.cog_rad = 0.0;
+    a.speed_mps = 5.0;
+    GNSSPosition b = fix(48.00001, 11.0, 200000);
+    b.cog_rad = 0.1;
+    b.speed_mps = 5.0;
+    fusion.add_fix(a);
+    fusion.add_fix(b);
+
+    auto ahead = fusion.position_at(400000);
+    REQUIRE(ahead.has_value());
+    CHECK(*ahead->rate_of_turn_rps == doctest::Approx(0.5));
+    CHECK(*ahead->cog_rad == doctest::Approx(0.2));
+
+    fusion.clear();
+    CHECK(fusion.empty());
+}
+
+TEST_CASE("NMEAInterface feeds the fusion from received messages") {
+    IsoNet net;
+    auto *cf = net.create_internal(Name::build().set_identity_number(1), 0, 0x28).value();
+    NMEAInterface nmea(net, cf, NMEAConfig{}.heading(true));
+    REQUIRE(nmea.initialize().is_ok());
+
+    // 48.0, 11.0 in 1e-7 degrees at t = 1 s
+    i32 lat = 480000000, lon = 110000000;
+    auto rapid = message(PGN_GNSS_POSITION_RAPID,
+                         {static_cast<u8>(lat), static_cast<u8>(lat >> 8), static_cast<u8>(lat >> 16),
+                          static_cast<u8>(lat >> 24), static_cast<u8>(lon), static_cast<u8>(lon >> 8),
+                          static_cast<u8>(lon >> 16), static_cast<u8>(lon >> 24)},
+                         1000000);
+    // COG 0 rad (north), SOG 10.00 m/s
+    auto cog_sog = message(PGN_GNSS_COG_SOG_RAPID, {0, 0xFC, 0x00, 0x00, 0xE8, 0x03, 0xFF, 0xFF}, 1000000);
+    net.inject_message(rapid);
+    net.inject_message(cog_sog);
+
+    REQUIRE(nmea.fusion().size() == 1);
+    auto ahead = nmea.position_at(1200000);
+    REQUIRE(ahead.has_value());
+    CHECK(ahead->wgs.latitude > 48.0);
+    CHECK(distance(*nmea.fusion().latest(), *ahead) == doctest::Approx(2.0).epsilon(1e-2));
+}
@@ -0,0 +1,116 @@
+#include <doctest/doctest.h>
+#include <agrobus/nmea/sentence.hpp>
+#include <string>
+
+using namespace agrobus::nmea;
+
+namespace {
+    const char *GGA = "$GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,*47\r\n";
+
+    dp::Vector<std::string> feed_all(NMEALineReader &reader, std::string_view text, usize chunk) {
+        dp::Vector<std::string> types;
+        const u8 *p = reinterpret_cast<const u8 *>(text.data());
+        for (usize i = 0; i < text.size(); i += chunk) {
+            usize n = text.size() - i < chunk ? text.size() - i : chunk;
+            reader.feed(p + i, n, [&](const NMEASentence &s) { types.push_back(std::string(s.type())); });
+        }
+        return types;
+    }
+} // namespace
+
+TEST_CASE("NMEA checksum and line scanning") {
+    std::string_view body = "GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,";
+    u8 slow = 0;
+    for (char c : body)
+        slow ^= static_cast<u8>(c);
+    CHECK(nmea_checksum(body) == slow);
+    CHECK(nmea_checksum(body) == 0x47);
+    CHECK(nmea_checksum("") == 0);
+
+    std::string_view text = "0123456789abcdef\r\n";
+    CHECK(find_line_end(text.data(), text.size()) == 16);
+    CHECK(find_line_end(text.data(), 16) == 16);
+    CHECK(find_line_end("ab\ncd", 5) == 2);
+
+    SUBCASE("every length and terminator position") {
+        // Lengths and positions on both sides of the vector and word steps
+        std::string buf(100, 'A');
+        for (usize i = 0; i < buf.size(); ++i)
+            buf[i] = static_cast<char>('!' + (i * 7) % 90);
+        for (usize n = 0; n <= buf.size(); ++n) {
+            CAPTURE(n);
+            u8 sum = 0;
+            for (usize i = 0; i < n; ++i)
+                sum ^= static_cast<u8>(buf[i]);
+            CHECK(nmea_checksum(std::string_view(buf.data(), n)) == sum);
+            CHECK(find_line_end(buf.data(), n) == n);
+        }
+        for (usize at = 0; at < buf.size(); ++at) {
+            CAPTURE(at);
+            std::string line = buf;
+            line[at] = at % 2 == 0 ? '\n' : '\r';
+            CHECK(find_line_end(line.data(), line.size()) == at);
+        }
+    }
+}
+
+TEST_CASE("NMEASentence tokenizes in place") {
+    NMEALineReader reader;
+    u32 calls = 0;
+    reader.feed(reinterpret_cast<const u8 *>(GGA), std::char_traits<char>::length(GGA), [&](const NMEASentence &s) {
+        ++calls;
+        CHECK(s.talker() == "GP");
+        CHECK(s.type() == "GGA");
+        CHECK(s.size() == 15);
+        CHECK(s[2] == "4807.038");
+        CHECK(s[14] == "");
+        CHECK(s[30] == ""); // Past the end
+
+        f64 alt = 0.0;
+        CHECK(parse_field(s[9], alt));
+        CHECK(alt == doctest::Approx(545.4));
+        u32 sats = 0;
+        CHECK(parse_field(s[7], sats));
+        CHECK(sats == 8);
+        CHECK_FALSE(parse_field(s[13], alt)); // Empty field leaves the value alone
+        CHECK(alt == doctest::Approx(545.4));
+    });
+    CHECK(calls == 1);
+    CHECK(reader.sentences() == 1);
+}
+
+TEST_CASE("NMEALineReader frames sentences across reads") {
+    std::string text = std::string(GGA) + "$GPVTG,054.7,T,034.4,M,005.5,N,010.2,K*48\r\n" + GGA;
+
+    SUBCASE("byte at a time") {
+        NMEALineReader reader;
+        auto types = feed_all(reader, text, 1);
+        REQUIRE(types.size() == 3);
+        CHECK(types[0] == "GGA");
+        CHECK(types[1] == "VTG");
+        CHECK(types[2] == "GGA");
+    }
+
+    SUBCASE("odd chunks") {
+        NMEALineReader reader;
+        CHECK(feed_all(reader, text, 13).size() == 3);
+    }
+
+    SUBCASE("bad checksum and oversized lines are dropped") {
+        NMEALineReader reader;
+        std::string bad = "$GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,*48\r\n";
+        std::string longline = "$GPXXX," + std::string(200, '1') + "\r\n";
+        auto types = feed_all(reader, bad + longline + GGA, 7);
+        REQUIRE(types.size() == 1);
+        CHECK(types[0] == "GGA");
+        CHECK(reader.checksum_errors() == 1);
+        CHECK(reader.overflows() == 1);
+    }
+
+    SUBCASE("sentences without a checksum pass") {
+        NMEALineReader reader;
+        auto types = feed_all(reader, "$GPRMC,1,A\n!AIVDM,x\n", 64);
+        REQUIRE(types.size() == 1);
+        CHECK(types[0] == "RMC");
+    }
+}
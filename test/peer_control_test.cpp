@@ -156,3 +156,92 @@ TEST_CASE("PeerControlInterface - events") {
     pc.remove_assignment(7, 70);
     CHECK(removed);
 }
+
+// ─── Value forwarding over a loopback bus ─────────────────────────────────────
+#include <agrobus/net/loopback_bus.hpp>
+
+TEST_CASE("PeerControlInterface - forwards values to the destination") {
+    LoopbackBus bus;
+    IsoNet nm_src;
+    IsoNet nm_dst;
+    auto* src_cf = nm_src.create_internal(Name::build().set_identity_number(1), 0, 0x81).value();
+    auto* dst_cf = nm_dst.create_internal(Name::build().set_identity_number(2), 0, 0x82).value();
+    bus.attach(nm_src);
+    bus.attach(nm_dst);
+    REQUIRE(nm_src.start_address_claiming().is_ok());
+    REQUIRE(nm_dst.start_address_claiming().is_ok());
+
+    PeerControlInterface pc(nm_src, src_cf, PeerForwardConfig{}.repeat(100).min_interval(20));
+    PeerControlAssignment a;
+    a.from(1, 0x0043).to(4, 0x0001).destination(0x82);
+    REQUIRE(pc.add_assignment(a).is_ok());
+
+    dp::Vector<i32> received;
+    nm_dst.register_pgn_callback(PGN_TC_TO_ECU, [&](const Message& msg) {
+        CHECK((msg.data[0] & 0x0F) == static_cast<u8>(ProcessDataCommands::Value));
+        CHECK(((msg.data[0] >> 4) | (msg.data[1] << 4)) == 4);
+        CHECK((msg.data[2] | (msg.data[3] << 8)) == 0x0001);
+        received.push_back(static_cast<i32>(msg.data[4] | (msg.data[5] << 8) | (msg.data[6] << 16) |
+                                            (static_cast<u32>(msg.data[7]) << 24)));
+    });
+    auto run = [&](u32 steps, u32 ms = 5) {
+        for (u32 i = 0; i < steps; ++i) {
+            pc.update(ms);
+            nm_src.update(ms);
+            nm_dst.update(ms);
+        }
+    };
+    run(60); // Address claims
+
+    CHECK_FALSE(pc.forward(1, 0x0043, 10)); // Not active yet
+    REQUIRE(pc.activate_assignment(1, 0x0043, true).is_ok());
+    CHECK(pc.active_count() == 1);
+
+    SUBCASE("changes go out at once, repeats on the timer") {
+        CHECK(pc.forward(1, 0x0043, 500));
+        CHECK(pc.forwarded() == 1); // Sent inside forward()
+        run(2);
+        REQUIRE(received.size() == 1);
+        CHECK(received[0] == 500);
+
+        CHECK(pc.forward(1, 0x0043, 500)); // Unchanged: nothing new
+        CHECK(pc.forwarded() == 1);
+        run(20); // 100 ms: one repeat
+        CHECK(pc.forwarded() == 2);
+        CHECK(received.back() == 500);
+    }
+
+    SUBCASE("changes inside the minimum interval collapse to the latest") {
+        pc.forward(1, 0x0043, 1);
+        pc.forward(1, 0x0043, 2);
+        pc.forward(1, 0x0043, 3);
+        CHECK(pc.forwarded() == 1);
+        CHECK(*pc.forwarded_value(1, 0x0043) == 3);
+        run(4); // 20 ms
+        CHECK(pc.forwarded() == 2);
+        run(2);
+        REQUIRE(received.size() == 2);
+        CHECK(received[0] == 1);
+        CHECK(received[1] == 3);
+    }
+
+    SUBCASE("source values reported to the TC are forwarded") {
+        REQUIRE(pc.remove_assignment(1, 0x0043).is_ok());
+        CHECK(pc.active_count() == 0);
+        a.source(0x82).active = true; // The destination node plays the source ECU too
+        REQUIRE(pc.add_assignment(a).is_ok());
+        REQUIRE(pc.listen().is_ok());
+
+        dp::Vector<u8> value(8, 0xFF);
+        value[0] = static_cast<u8>(ProcessDataCommands::Value) | (1 << 4);
+        value[1] = 0;
+        value[2] = 0x43;
+        value[3] = 0x00;
+        value[4] = 77;
+        value[5] = value[6] = value[7] = 0;
+        REQUIRE(nm_dst.send(PGN_ECU_TO_TC, value, dst_cf).is_ok());
+        run(4);
+        CHECK(pc.forwarded() == 1);
+        CHECK(*pc.forwarded_value(1, 0x0043) == 77);
+    }
+}
@@ -0,0 +1,75 @@
+#include <doctest/doctest.h>
+#include <agrobus/net/periodic_sender.hpp>
+#include <agrobus/net/scheduler.hpp>
+
+using namespace agrobus::net;
+
+TEST_CASE("Scheduler keeps the overshoot of coarse updates") {
+    Scheduler sched;
+    dp::Vector<u32> stamps;
+    u32 now = 0;
+    sched.add("status", 100, [&]() {
+        stamps.push_back(now);
+        return true;
+    });
+    for (u32 i = 0; i < 10; ++i) {
+        now += 70;
+        sched.update(70);
+    }
+    // Old behaviour reset on fire (140, 280, 420, 560, 700); anchored fires at
+    // the first update after each 100 ms boundary
+    REQUIRE(stamps.size() == 7);
+    CHECK(stamps[0] == 140);
+    CHECK(stamps[1] == 210);
+    CHECK(stamps[6] == 700);
+}
+
+TEST_CASE("Scheduler phase offsets") {
+    Scheduler sched;
+    i32 a = 0;
+    i32 b = 0;
+    sched.add("a", 100, [&]() { return ++a, true; });
+    sched.add("b", 100, [&]() { return ++b, true; }, 0, 50);
+    sched.update(60);
+    CHECK(a == 0);
+    CHECK(b == 1);
+    sched.update(40);
+    CHECK(a == 1);
+    CHECK(b == 1);
+}
+
+TEST_CASE("PeriodicSender spreads PGNs of one period across it") {
+    CHECK(PeriodicSender::spread_phase(100, 0) == 0);
+    CHECK(PeriodicSender::spread_phase(100, 1) == 50);
+    CHECK(PeriodicSender::spread_phase(100, 2) == 25);
+    CHECK(PeriodicSender::spread_phase(100, 3) == 75);
+    CHECK(PeriodicSender::spread_phase(100, 4) == 12);
+
+    IsoNet nm;
+    auto *cf = nm.create_internal(Name{}, 0, 0x28).value();
+    PeriodicSender periodic(nm, cf);
+    u32 produced = 0;
+    auto producer = [&](dp::Vector<u8> &data) {
+        ++produced;
+        data.assign(8, 0xFF);
+        return true;
+    };
+    CHECK(periodic.add(0xFE48, 100, producer) == 0);
+    CHECK(periodic.add(0xFE49, 100, producer) == 50);
+    CHECK(periodic.add(0xFE4A, 100, producer) == 25);
+    CHECK(periodic.add(0xFEF1, 1000, producer) == 0); // Own period, own sequence
+    CHECK(periodic.add(0xFE4B, 100, producer, Priority::Default, 10) == 10);
+    CHECK(periodic.phase(0xFE49).value() == 50);
+    CHECK(periodic.size() == 5);
+    CHECK(nm.timers().size() == 5);
+
+    nm.update(30); // Phases 10 and 25 are due
+    CHECK(produced == 2);
+    nm.update(70); // 50 and 100 (phase 0)
+    CHECK(produced == 4);
+
+    CHECK(periodic.remove(0xFE49));
+    CHECK_FALSE(periodic.phase(0xFE49).has_value());
+    periodic.clear();
+    CHECK(nm.timers().empty());
+}
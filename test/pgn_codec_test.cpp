@@ -0,0 +1,160 @@
+#include <doctest/doctest.h>
+#include <agrobus/isobus/implement/speed_distance.hpp>
+#include <agrobus/j1939/engine.hpp>
+
+using namespace agrobus::net;
+using agrobus::isobus::implement::ExitReasonCode;
+using agrobus::isobus::implement::HitchStatus;
+using agrobus::isobus::implement::LimitStatus;
+using agrobus::isobus::implement::MachineDirection;
+using agrobus::isobus::implement::PTOStatus;
+using agrobus::isobus::implement::WheelBasedSpeedDist;
+using agrobus::j1939::EEC1;
+
+namespace {
+
+    struct Sample {
+        f64 speed = 0.0;
+        u8 mode = 0;
+        bool flag = false;
+    };
+
+    using SampleCodec = PgnCodec<Sample, Field<&Sample::speed, 8, 16, 1, 8, -100>, Field<&Sample::mode, 24, 4>,
+                                 Field<&Sample::flag, 28, 1>>;
+
+    // Encoding is a pure integer transform, usable at compile time
+    static_assert(SampleCodec::MIN_BYTES == 4);
+    static_assert(SampleCodec::pack(Sample{}) == 0xFFFFFFFFE00320FFull);
+    static_assert(SampleCodec::unpack(0xFFFFFFFFF5000800ull).mode == 5);
+
+    using Frame8 = dp::Array<u8, 8>;
+
+    // One row per reference frame: encode(value) must give exactly these bytes
+    // and decode(bytes) must give a value that re-encodes to them
+    struct Row {
+        const char *name;
+        Frame8 bytes;
+        Frame8 (*encode)();
+        Frame8 (*roundtrip)(const Frame8 &);
+    };
+
+    template <typename Msg> Frame8 roundtrip(const Frame8 &bytes) {
+        return Msg::Codec::encode_array(Msg::decode(DataSpan(bytes)));
+    }
+
+    const Row TABLE[] = {
+        {"WheelBasedSpeedDist",
+         {0xD2, 0x04, 0x40, 0xE2, 0x01, 0x00, 0x2D, 0xF4},
+         [] {
+             WheelBasedSpeedDist m;
+             m.speed_mps = 1.234; // 1234 raw, not truncated to 1233
+             m.distance_m = 123.456;
+             m.max_power_time_min = 45;
+             m.direction = MachineDirection::Forward;
+             m.start_stop_state = 1;
+             return WheelBasedSpeedDist::Codec::encode_array(m);
+         },
+         &roundtrip<WheelBasedSpeedDist>},
+        {"EEC1",
+         {0xAF, 0x7D, 0x73, 0x80, 0x3E, 0x00, 0xF3, 0xFF},
+         [] {
+             EEC1 m;
+             m.engine_torque_percent = 50.0;
+             m.driver_demand_percent = 0.0;
+             m.actual_engine_percent = -10.0;
+             m.engine_speed_rpm = 2000.0;
+             m.source_address = 0x00;
+             m.starter_mode = 3;
+             return EEC1::Codec::encode_array(m);
+         },
+         &roundtrip<EEC1>},
+        {"HitchStatus",
+         {0xC8, 0x91, 0xFA, 0x7D, 0xFF, 0xFF, 0xFF, 0xFF},
+         [] {
+             HitchStatus m;
+             m.position_percent = 200;
+             m.in_work_indication = 1;
+             m.limit_status = LimitStatus::NotLimited;
+             m.exit_code = ExitReasonCode::OperatorCmd;
+             m.draft_force_n = 2500.0; // (2500 + 320000) / 10 = 32250
+             return HitchStatus::Codec::encode_array(m);
+         },
+         &roundtrip<HitchStatus>},
+        {"PTOStatus",
+         {0x40, 0x1F, 0x95, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF},
+         [] {
+             PTOStatus m;
+             m.shaft_speed_rpm = 1000.0;
+             m.engagement = 1;
+             m.economy_mode = 1;
+             m.limit_status = LimitStatus::OperatorLimited;
+             m.exit_code = ExitReasonCode::SystemCmd;
+             return PTOStatus::Codec::encode_array(m);
+         },
+         &roundtrip<PTOStatus>},
+    };
+
+} // namespace
+
+TEST_CASE("PgnCodec reference frames") {
+    for (const Row &row : TABLE) {
+        CAPTURE(row.name);
+        Frame8 encoded = row.encode();
+        for (usize i = 0; i < 8; ++i) {
+            CAPTURE(i);
+            CHECK(encoded[i] == row.bytes[i]);
+        }
+        Frame8 again = row.roundtrip(row.bytes);
+        for (usize i = 0; i < 8; ++i) {
+            CAPTURE(i);
+            CHECK(again[i] == row.bytes[i]);
+        }
+    }
+}
+
+TEST_CASE("PgnCodec decodes physical values") {
+    auto wbs = WheelBasedSpeedDist::decode(DataSpan(TABLE[0].bytes));
+    CHECK(wbs.speed_mps == doctest::Approx(1.234));
+    CHECK(wbs.distance_m == doctest::Approx(123.456));
+    CHECK(wbs.direction == MachineDirection::Forward);
+    CHECK(wbs.start_stop_state == 1);
+
+    auto eec1 = EEC1::decode(DataSpan(TABLE[1].bytes));
+    CHECK(eec1.engine_torque_percent == doctest::Approx(50.0));
+    CHECK(eec1.actual_engine_percent == doctest::Approx(-10.0));
+    CHECK(eec1.engine_speed_rpm == doctest::Approx(2000.0));
+    CHECK(eec1.starter_mode == 3);
+
+    auto pto = PTOStatus::decode(DataSpan(TABLE[3].bytes));
+    CHECK(pto.shaft_speed_rpm == doctest::Approx(1000.0));
+    CHECK(pto.exit_code == ExitReasonCode::SystemCmd);
+}
+
+TEST_CASE("PgnCodec short frames and out-of-range values") {
+    // Shorter than the last field: default message, as before
+    const u8 three[] = {0x40, 0x1F, 0x95};
+    auto hitch = HitchStatus::Codec::decode(three, sizeof(three));
+    CHECK(hitch.position_percent == 0xFF);
+    CHECK(hitch.limit_status == LimitStatus::NotAvailable);
+    auto pto = PTOStatus::Codec::decode(three, sizeof(three));
+    CHECK(pto.engagement == 1);
+
+    // Physical values outside the field clamp instead of wrapping
+    PTOStatus fast;
+    fast.shaft_speed_rpm = 1.0e6;
+    CHECK(Field<&PTOStatus::shaft_speed_rpm, 0, 16, 1, 8>::to_raw(fast.shaft_speed_rpm) == 0xFFFF);
+    EEC1 low;
+    low.engine_torque_percent = -200.0;
+    CHECK(EEC1::Codec::encode_array(low)[0] == 0x00);
+}
+
+TEST_CASE("PgnCodec vector encode matches the message encode") {
+    EEC1 m;
+    m.engine_speed_rpm = 812.5;
+    auto v = m.encode();
+    REQUIRE(v.size() == 8);
+    CHECK(v[3] == 0x64);
+    CHECK(v[4] == 0x19);
+    CHECK(v[7] == 0xFF);
+    CHECK(EEC1::decode(v).engine_speed_rpm == doctest::Approx(812.5));
+}
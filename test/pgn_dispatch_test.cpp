@@ -0,0 +1,130 @@
+#include <doctest/doctest.h>
+#include <agrobus/net/network_manager.hpp>
+#include <agrobus/net/pgn_dispatch.hpp>
+
+using namespace agrobus::net;
+
+static Message make_msg(PGN pgn) {
+    Message msg;
+    msg.pgn = pgn;
+    msg.data = {0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08};
+    return msg;
+}
+
+TEST_CASE("PGNDispatchTable lookup") {
+    PGNDispatchTable table;
+
+    SUBCASE("empty table has no handlers") {
+        CHECK_FALSE(table.has_handlers(PGN_VEHICLE_SPEED));
+        CHECK(table.dispatch(make_msg(PGN_VEHICLE_SPEED)) == 0);
+        CHECK(table.pgn_count() == 0);
+    }
+
+    SUBCASE("handlers fire in registration order") {
+        dp::Vector<i32> order;
+        table.add(PGN_VEHICLE_SPEED, [&](const Message &) { order.push_back(1); });
+        table.add(PGN_ADDRESS_CLAIMED, [&](const Message &) { order.push_back(99); });
+        table.add(PGN_VEHICLE_SPEED, [&](const Message &) { order.push_back(2); });
+
+        CHECK(table.pgn_count() == 2);
+        CHECK(table.dispatch(make_msg(PGN_VEHICLE_SPEED)) == 2);
+        REQUIRE(order.size() == 2);
+        CHECK(order[0] == 1);
+        CHECK(order[1] == 2);
+    }
+
+    SUBCASE("unregistered PGN misses") {
+        table.add(PGN_VEHICLE_SPEED, [](const Message &) {});
+        CHECK(table.has_handlers(PGN_VEHICLE_SPEED));
+        CHECK_FALSE(table.has_handlers(PGN_ADDRESS_CLAIMED));
+    }
+
+    SUBCASE("many PGNs grow the index") {
+        u32 hits = 0;
+        for (PGN p = 0xFF00; p < 0xFF00 + 100; ++p) {
+            table.add(p, [&](const Message &) { ++hits; });
+        }
+        CHECK(table.pgn_count() == 100);
+        for (PGN p = 0xFF00; p < 0xFF00 + 100; ++p) {
+            table.dispatch(make_msg(p));
+        }
+        CHECK(hits == 100);
+        CHECK_FALSE(table.has_handlers(0xFF00 + 100));
+    }
+
+    SUBCASE("registration during dispatch is deferred") {
+        u32 inner_calls = 0;
+        table.add(PGN_VEHICLE_SPEED, [&](const Message &) {
+            table.add(PGN_VEHICLE_SPEED, [&](const Message &) { ++inner_calls; });
+        });
+
+        CHECK(table.dispatch(make_msg(PGN_VEHICLE_SPEED)) == 1);
+        CHECK(inner_calls == 0);
+        CHECK(table.dispatch(make_msg(PGN_VEHICLE_SPEED)) == 2);
+        CHECK(inner_calls == 1);
+    }
+}
+
+TEST_CASE("IsoNet dispatches through the compiled table") {
+    IsoNet nm;
+    u32 speed_calls = 0;
+    u32 dm1_calls = 0;
+    nm.register_pgn_callback(PGN_VEHICLE_SPEED, [&](const Message &) { ++speed_calls; });
+    nm.register_pgn_callback(PGN_DM1, [&](const Message &) { ++dm1_calls; });
+
+    nm.inject_message(make_msg(PGN_VEHICLE_SPEED));
+    nm.inject_message(make_msg(PGN_VEHICLE_SPEED));
+    nm.inject_message(make_msg(PGN_DM1));
+    nm.inject_message(make_msg(0xFF42)); // unhandled
+
+    CHECK(speed_calls == 2);
+    CHECK(dm1_calls == 1);
+
+    SUBCASE("callback registered after first dispatch is picked up") {
+        u32 late = 0;
+        nm.register_pgn_callback(0xFF42, [&](const Message &) { ++late; });
+        nm.inject_message(make_msg(0xFF42));
+        CHECK(late == 1);
+    }
+}
+
+namespace {
+    int static_hits = 0;
+    PGN static_last = 0;
+    void on_static(const MessageView &m) {
+        ++static_hits;
+        static_last = m.pgn;
+    }
+} // namespace
+
+TEST_CASE("StaticRouter dispatches its PGNs and owns them in IsoNet") {
+    using Router = StaticRouter<Handler<0xFEF1, &on_static>, Handler<0xFEF2, &on_static>,
+                                Handler<0xFEF2, [](const MessageView &) { static_hits += 10; }>>;
+    static_assert(Router::size == 3);
+    static_assert(Router::handles(0xFEF2));
+    static_assert(!Router::handles(0xFEF3));
+
+    static_hits = 0;
+    CHECK(Router::dispatch(MessageView(make_msg(0xFEF2))));
+    CHECK(static_hits == 11); // Both handlers of the PGN, in list order
+    CHECK(static_last == 0xFEF2);
+    CHECK_FALSE(Router::dispatch(MessageView(make_msg(0xFEF3))));
+
+    IsoNet nm;
+    nm.set_static_router<Router>();
+    int dynamic_hits = 0;
+    nm.register_pgn_callback(0xFEF1, [&](const Message &) { ++dynamic_hits; });
+    nm.register_pgn_callback(0xFEF3, [&](const Message &) { ++dynamic_hits; });
+
+    static_hits = 0;
+    nm.inject_message(make_msg(0xFEF1));
+    CHECK(static_hits == 1);
+    CHECK(dynamic_hits == 0); // The router owns 0xFEF1
+    nm.inject_message(make_msg(0xFEF3));
+    CHECK(dynamic_hits == 1);
+
+    nm.clear_static_router();
+    nm.inject_message(make_msg(0xFEF1));
+    CHECK(static_hits == 1);
+    CHECK(dynamic_hits == 2);
+}
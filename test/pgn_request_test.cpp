@@ -1,5 +1,6 @@
 #include <doctest/doctest.h>
 #include <agrobus/j1939/pgn_request.hpp>
+#include <agrobus/net/loopback_bus.hpp>
 
 using namespace agrobus::j1939;
 
@@ -31,3 +32,74 @@ TEST_CASE("PGNRequestProtocol") {
         CHECK(!received);
     }
 }
+
+TEST_CASE("PGNRequestProtocol cached responder encodes once per invalidation") {
+    IsoNet ecu, tool;
+    auto *ecu_cf = ecu.create_internal(Name::build().set_identity_number(1), 0, 0x28).value();
+    auto *tool_cf = tool.create_internal(Name::build().set_identity_number(2), 0, 0x29).value();
+    PGNRequestProtocol responder(ecu, ecu_cf);
+    PGNRequestProtocol requester(tool, tool_cf);
+    REQUIRE(responder.initialize().is_ok());
+    REQUIRE(requester.initialize().is_ok());
+
+    LoopbackBus bus;
+    bus.attach(ecu);
+    bus.attach(tool);
+    REQUIRE(ecu.start_address_claiming().is_ok());
+    REQUIRE(tool.start_address_claiming().is_ok());
+    auto run = [&](u32 steps) {
+        for (u32 i = 0; i < steps; ++i) {
+            ecu.update(10);
+            tool.update(10);
+        }
+    };
+    run(40);
+
+    // Software ID: multi-packet, goes out as a BAM
+    dp::Vector<u8> software(20, 'A');
+    u32 encodes = 0;
+    auto token = responder.register_cached_responder(PGN_SOFTWARE_ID, [&]() {
+        ++encodes;
+        return software;
+    });
+    REQUIRE(token.is_ok());
+    CHECK(token.value().valid());
+    CHECK(responder.register_cached_responder(PGN_ECU_IDENTIFICATION, nullptr).is_err());
+
+    dp::Vector<dp::Vector<u8>> answers;
+    tool.register_pgn_callback(PGN_SOFTWARE_ID, [&](const Message &msg) { answers.push_back(msg.data); });
+
+    for (u32 i = 0; i < 3; ++i) {
+        REQUIRE(requester.request(PGN_SOFTWARE_ID, 0x28).is_ok());
+        run(30);
+    }
+    REQUIRE(answers.size() == 3);
+    CHECK(encodes == 1);
+    CHECK(responder.cache_hits() == 2);
+    CHECK(answers[2] == software);
+
+    // The data changed: the next request encodes it again
+    software[0] = 'B';
+    token.value().invalidate();
+    REQUIRE(requester.request(PGN_SOFTWARE_ID, 0x28).is_ok());
+    run(30);
+    REQUIRE(answers.size() == 4);
+    CHECK(encodes == 2);
+    CHECK(answers[3][0] == 'B');
+
+    responder.invalidate(PGN_SOFTWARE_ID);
+    REQUIRE(requester.request(PGN_SOFTWARE_ID, 0x28).is_ok());
+    run(30);
+    CHECK(encodes == 3);
+
+    // A plain responder replaces the cached one
+    u32 plain = 0;
+    responder.register_responder(PGN_SOFTWARE_ID, [&]() {
+        ++plain;
+        return software;
+    });
+    REQUIRE(requester.request(PGN_SOFTWARE_ID, 0x28).is_ok());
+    run(30);
+    CHECK(plain == 1);
+    CHECK(encodes == 3);
+}
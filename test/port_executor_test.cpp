@@ -0,0 +1,143 @@
+#include <doctest/doctest.h>
+#include <agrobus/net/port_executor.hpp>
+#include <agrobus/net/constants.hpp>
+#include <wirebit/can/can_endpoint.hpp>
+#include <wirebit/link.hpp>
+#include <chrono>
+#include <cstring>
+#include <mutex>
+#include <thread>
+
+using namespace agrobus::net;
+
+// Thread-safe in-memory link
+class QueueLink : public wirebit::Link {
+    mutable std::mutex mutex_;
+    dp::Vector<wirebit::Frame> rx_queue_;
+    usize tx_count_ = 0;
+
+public:
+    wirebit::Result<wirebit::Unit, wirebit::Error> send(const wirebit::Frame&) override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ++tx_count_;
+        return wirebit::Result<wirebit::Unit, wirebit::Error>::ok(wirebit::Unit{});
+    }
+
+    wirebit::Result<wirebit::Frame, wirebit::Error> recv() override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (rx_queue_.empty())
+            return wirebit::Result<wirebit::Frame, wirebit::Error>::err(wirebit::Error::timeout("empty"));
+        wirebit::Frame f = std::move(rx_queue_[0]);
+        rx_queue_.erase(rx_queue_.begin());
+        return wirebit::Result<wirebit::Frame, wirebit::Error>::ok(std::move(f));
+    }
+
+    bool can_send() const override { return true; }
+    bool can_recv() const override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return !rx_queue_.empty();
+    }
+    wirebit::String name() const override { return "queue_link"; }
+
+    void inject(const Frame& frame) {
+        can_frame cf = {};
+        cf.can_id = frame.id.raw | CAN_EFF_FLAG;
+        cf.can_dlc = frame.length;
+        for (u8 i = 0; i < frame.length; ++i)
+            cf.data[i] = frame.data[i];
+        wirebit::Bytes payload(sizeof(can_frame));
+        std::memcpy(payload.data(), &cf, sizeof(can_frame));
+        std::lock_guard<std::mutex> lock(mutex_);
+        rx_queue_.push_back(wirebit::make_frame(wirebit::FrameType::CAN, std::move(payload), 0, 0));
+    }
+
+    usize tx_count() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return tx_count_;
+    }
+};
+
+static Frame speed_frame(u8 tag) {
+    Frame f;
+    f.id = Identifier::encode(Priority::Default, PGN_VEHICLE_SPEED, 0x30, BROADCAST_ADDRESS);
+    f.data[0] = tag;
+    return f;
+}
+
+TEST_CASE("PortExecutor creates one shard per port") {
+    auto link0 = std::make_shared<QueueLink>();
+    auto link1 = std::make_shared<QueueLink>();
+    wirebit::CanEndpoint ep0(link0, wirebit::CanConfig{}, 1);
+    wirebit::CanEndpoint ep1(link1, wirebit::CanConfig{}, 2);
+
+    PortExecutor exec;
+    CHECK(exec.add_port(0, &ep0).is_ok());
+    CHECK(exec.add_port(1, &ep1).is_ok());
+    CHECK(exec.add_port(1, &ep1).is_err());
+    CHECK(exec.shard_count() == 2);
+    CHECK(exec.shard(0) != exec.shard(1));
+    CHECK(exec.shard(2) == nullptr);
+    CHECK(exec.post(2, [](IsoNet &) {}).is_err());
+}
+
+TEST_CASE("PortExecutor hands messages across shards") {
+    auto link0 = std::make_shared<QueueLink>();
+    auto link1 = std::make_shared<QueueLink>();
+    wirebit::CanEndpoint ep0(link0, wirebit::CanConfig{}, 1);
+    wirebit::CanEndpoint ep1(link1, wirebit::CanConfig{}, 2);
+
+    PortExecutor exec;
+    IsoNet *net0 = exec.add_port(0, &ep0).value();
+    IsoNet *net1 = exec.add_port(1, &ep1).value();
+
+    // Port 0 traffic is forwarded onto port 1 by the port 1 shard
+    net0->register_pgn_callback(PGN_VEHICLE_SPEED, [&](const Message &msg) {
+        Frame fwd;
+        fwd.id = Identifier::encode(msg.priority, msg.pgn, msg.source, BROADCAST_ADDRESS);
+        for (usize i = 0; i < msg.data.size() && i < 8; ++i)
+            fwd.data[i] = msg.data[i];
+        exec.post(1, [fwd](IsoNet &net) { net.send_frame(fwd, 1); });
+    });
+
+    dp::Vector<u8> seen;
+    net1->register_pgn_view_callback(PGN_VEHICLE_SPEED, [&](const MessageView &view) {
+        u8 tag = view.get_u8(0);
+        exec.defer([&, tag]() { seen.push_back(tag); });
+    });
+
+    SUBCASE("single-threaded step") {
+        link0->inject(speed_frame(1));
+        exec.update(1); // port 0 receives, posts to port 1
+        exec.update(1); // port 1 runs the task and sends
+        CHECK(link1->tx_count() == 1);
+
+        link1->inject(speed_frame(9));
+        exec.update(1);
+        CHECK(exec.drain() == 1);
+        REQUIRE(seen.size() == 1);
+        CHECK(seen[0] == 9);
+    }
+
+    SUBCASE("worker threads") {
+        REQUIRE(exec.start(1).is_ok());
+        CHECK(exec.add_port(2, &ep0).is_err());
+
+        for (u8 i = 0; i < 20; ++i) {
+            link0->inject(speed_frame(i));
+            link1->inject(speed_frame(100 + i));
+        }
+
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while ((seen.size() < 20 || link1->tx_count() < 20) && std::chrono::steady_clock::now() < deadline) {
+            exec.drain();
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        exec.stop();
+        exec.drain();
+
+        CHECK(link1->tx_count() == 20);
+        REQUIRE(seen.size() == 20);
+        for (u8 i = 0; i < 20; ++i)
+            CHECK(seen[i] == 100 + i);
+    }
+}
@@ -0,0 +1,80 @@
+#include <doctest/doctest.h>
+#include <agrobus/j1939/proprietary.hpp>
+#include <agrobus/net/loopback_bus.hpp>
+
+using namespace agrobus::j1939;
+
+namespace {
+    struct Bus {
+        IsoNet tractor, implement;
+        InternalCF *tractor_cf = nullptr, *implement_cf = nullptr;
+        LoopbackBus bus;
+
+        Bus() {
+            tractor_cf = tractor.create_internal(Name::build().set_identity_number(1), 0, 0x80).value();
+            implement_cf = implement.create_internal(Name::build().set_identity_number(2), 0, 0x81).value();
+            bus.attach(tractor);
+            bus.attach(implement);
+            REQUIRE(tractor.start_address_claiming().is_ok());
+            REQUIRE(implement.start_address_claiming().is_ok());
+            run(40);
+        }
+
+        void run(u32 steps) {
+            for (u32 i = 0; i < steps; ++i) {
+                tractor.update(10);
+                implement.update(10);
+            }
+        }
+    };
+} // namespace
+
+TEST_CASE("Proprietary B handlers are routed by group extension") {
+    Bus b;
+    ProprietaryInterface tx(b.tractor, b.tractor_cf);
+    ProprietaryInterface rx(b.implement, b.implement_cf);
+    REQUIRE(tx.initialize().is_ok());
+    REQUIRE(rx.initialize().is_ok());
+
+    u32 valve_a = 0, valve_b = 0, events = 0;
+    u8 last = 0;
+    REQUIRE(rx.set_proprietary_b_handler(0x10, [&](const MessageView &msg) {
+                  ++valve_a;
+                  last = msg.data[0];
+              }).is_ok());
+    REQUIRE(rx.set_proprietary_b_handler(0x20, [&](const MessageView &) { ++valve_b; }).is_ok());
+    REQUIRE(rx.register_proprietary_b(0x20).is_ok());
+    rx.on_proprietary_b.subscribe([&](const ProprietaryMsg &msg) {
+        ++events;
+        CHECK(msg.group_extension() == 0x20);
+    });
+    CHECK(rx.has_proprietary_b_handler(0x10));
+    CHECK_FALSE(rx.has_proprietary_b_handler(0x30));
+
+    REQUIRE(tx.send_proprietary_b(0x10, {0x42, 1, 2, 3, 4, 5, 6, 7}).is_ok());
+    REQUIRE(tx.send_proprietary_b(0x20, {0, 0, 0, 0, 0, 0, 0, 0}).is_ok());
+    REQUIRE(tx.send_proprietary_b(0x30, {0, 0, 0, 0, 0, 0, 0, 0}).is_ok());
+    b.run(5);
+    CHECK(valve_a == 1);
+    CHECK(last == 0x42);
+    CHECK(valve_b == 1);
+    CHECK(events == 1); // Only the GE registered for the event
+
+    // A handler that replaces itself keeps running until it returns
+    u32 second = 0;
+    REQUIRE(rx.set_proprietary_b_handler(0x10, [&](const MessageView &) {
+                  ++valve_a;
+                  (void)rx.set_proprietary_b_handler(0x10, [&](const MessageView &) { ++second; });
+              }).is_ok());
+    REQUIRE(tx.send_proprietary_b(0x10, {0, 0, 0, 0, 0, 0, 0, 0}).is_ok());
+    b.run(5);
+    REQUIRE(tx.send_proprietary_b(0x10, {0, 0, 0, 0, 0, 0, 0, 0}).is_ok());
+    b.run(5);
+    CHECK(valve_a == 2);
+    CHECK(second == 1);
+
+    rx.clear_proprietary_b_handler(0x10);
+    REQUIRE(tx.send_proprietary_b(0x10, {0, 0, 0, 0, 0, 0, 0, 0}).is_ok());
+    b.run(5);
+    CHECK(second == 1);
+}
@@ -0,0 +1,154 @@
+#include <doctest/doctest.h>
+#include <agrobus/j1939/pgn_request.hpp>
+#include <agrobus/j1939/request2.hpp>
+#include <agrobus/net/loopback_bus.hpp>
+#include <memory>
+
+using namespace agrobus::j1939;
+
+namespace {
+    // One ECU answering and two tools asking, all on one loopback bus
+    struct Bus {
+        IsoNet ecu, tool_a, tool_b;
+        InternalCF *ecu_cf = nullptr, *a_cf = nullptr, *b_cf = nullptr;
+        LoopbackBus bus;
+
+        Bus() {
+            ecu_cf = ecu.create_internal(Name::build().set_identity_number(1), 0, 0x28).value();
+            a_cf = tool_a.create_internal(Name::build().set_identity_number(2), 0, 0x29).value();
+            b_cf = tool_b.create_internal(Name::build().set_identity_number(3), 0, 0x2A).value();
+            bus.attach(ecu);
+            bus.attach(tool_a);
+            bus.attach(tool_b);
+            REQUIRE(ecu.start_address_claiming().is_ok());
+            REQUIRE(tool_a.start_address_claiming().is_ok());
+            REQUIRE(tool_b.start_address_claiming().is_ok());
+            run(40);
+        }
+
+        void run(u32 steps, u32 ms = 10) {
+            for (u32 i = 0; i < steps; ++i) {
+                ecu.update(ms);
+                tool_a.update(ms);
+                tool_b.update(ms);
+            }
+        }
+    };
+} // namespace
+
+TEST_CASE("ResponseCoalescer merges requests within the window and paces answers") {
+    TimerWheel timers;
+    ResponseCoalescer coalescer(timers, CoalesceConfig{}.window(20).min_interval(100));
+    u32 sent = 0;
+    auto send = [&]() { ++sent; };
+
+    coalescer.submit(1, send);
+    coalescer.submit(1, send);
+    coalescer.submit(2, send);
+    CHECK(coalescer.pending(1));
+    CHECK(coalescer.absorbed() == 1);
+    timers.advance(19);
+    CHECK(sent == 0);
+    timers.advance(1);
+    CHECK(sent == 2);
+    CHECK_FALSE(coalescer.pending(1));
+
+    // Next request for key 1 waits for the rest of the minimum interval
+    timers.advance(30);
+    coalescer.submit(1, send);
+    timers.advance(69);
+    CHECK(sent == 2);
+    timers.advance(1);
+    CHECK(sent == 3);
+
+    // Disabled: answered on the spot
+    coalescer.configure({});
+    CHECK_FALSE(coalescer.enabled());
+    coalescer.submit(1, send);
+    CHECK(sent == 4);
+
+    coalescer.configure(CoalesceConfig{}.window(10));
+    coalescer.submit(3, send);
+    coalescer.cancel_all();
+    timers.advance(20);
+    CHECK(sent == 4);
+}
+
+TEST_CASE("PGNRequestProtocol sends one broadcast answer for a request storm") {
+    Bus bus;
+    PGNRequestProtocol responder(bus.ecu, bus.ecu_cf, CoalesceConfig{}.window(10).min_interval(200));
+    PGNRequestProtocol req_a(bus.tool_a, bus.a_cf), req_b(bus.tool_b, bus.b_cf);
+    REQUIRE(responder.initialize().is_ok());
+    REQUIRE(req_a.initialize().is_ok());
+    REQUIRE(req_b.initialize().is_ok());
+
+    u32 encodes = 0;
+    responder.register_responder(PGN_SOFTWARE_ID, [&]() {
+        ++encodes;
+        return dp::Vector<u8>(30, 'S'); // Multi-packet: a BAM per answer
+    });
+    u32 answers = 0;
+    bus.tool_a.register_pgn_callback(PGN_SOFTWARE_ID, [&](const Message &) { ++answers; });
+
+    // Both tools ask within the same few ms, each twice
+    REQUIRE(req_a.request(PGN_SOFTWARE_ID).is_ok());
+    REQUIRE(req_b.request(PGN_SOFTWARE_ID, 0x28).is_ok());
+    bus.run(1, 2);
+    REQUIRE(req_a.request(PGN_SOFTWARE_ID, 0x28).is_ok());
+    REQUIRE(req_b.request(PGN_SOFTWARE_ID).is_ok());
+    bus.run(60);
+    CHECK(encodes == 1);
+    CHECK(answers == 1);
+    CHECK(responder.coalescer().absorbed() == 3);
+
+    // Asked again right after: held back to the minimum interval, then one answer
+    REQUIRE(req_a.request(PGN_SOFTWARE_ID).is_ok());
+    bus.run(60);
+    CHECK(encodes == 2);
+    CHECK(answers == 2);
+
+    // Unknown PGNs are still NACKed without waiting
+    bool nack = false;
+    req_a.on_ack_received.subscribe([&](const Acknowledgment &ack) {
+        nack = ack.control == AckControl::NegativeAck && ack.acknowledged_pgn == PGN_PRODUCT_IDENTIFICATION;
+    });
+    REQUIRE(req_a.request(PGN_PRODUCT_IDENTIFICATION, 0x28).is_ok());
+    bus.run(2);
+    CHECK(nack);
+}
+
+TEST_CASE("Request2Protocol coalesces per PGN and extended ID") {
+    Bus bus;
+    Request2Protocol responder(bus.ecu, bus.ecu_cf);
+    responder.set_coalescing(CoalesceConfig{}.window(10));
+    Request2Protocol req_a(bus.tool_a, bus.a_cf), req_b(bus.tool_b, bus.b_cf);
+    REQUIRE(responder.initialize().is_ok());
+    REQUIRE(req_a.initialize().is_ok());
+    REQUIRE(req_b.initialize().is_ok());
+
+    dp::Vector<u8> ids;
+    responder.register_responder(PGN_SOFTWARE_ID, [&](const dp::Vector<u8> &ext) {
+        u8 id = ext.empty() ? 0 : ext[0];
+        ids.push_back(id);
+        return dp::Vector<u8>(8, id);
+    });
+    u32 at_b = 0;
+    bus.tool_b.register_pgn_callback(PGN_SOFTWARE_ID, [&](const Message &) { ++at_b; });
+
+    REQUIRE(req_a.request2(PGN_SOFTWARE_ID, {1}, false, 0x28).is_ok());
+    REQUIRE(req_b.request2(PGN_SOFTWARE_ID, {1}, false, 0x28).is_ok());
+    REQUIRE(req_b.request2(PGN_SOFTWARE_ID, {2}, false, 0x28).is_ok());
+    bus.run(5);
+    REQUIRE(ids.size() == 2); // One per extended ID
+    CHECK(responder.coalescer().absorbed() == 1);
+    CHECK(at_b == 2); // Broadcast: tool B also sees the answer tool A asked for
+
+    // Transfer answers go to each requester
+    u32 transfers = 0;
+    bus.tool_a.register_pgn_callback(PGN_TRANSFER, [&](const Message &msg) { transfers += msg.destination == 0x29; });
+    bus.tool_b.register_pgn_callback(PGN_TRANSFER, [&](const Message &msg) { transfers += msg.destination == 0x2A; });
+    REQUIRE(req_a.request2(PGN_SOFTWARE_ID, {1}, true, 0x28).is_ok());
+    REQUIRE(req_b.request2(PGN_SOFTWARE_ID, {1}, true, 0x28).is_ok());
+    bus.run(10);
+    CHECK(transfers == 2);
+}
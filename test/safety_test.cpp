@@ -275,3 +275,36 @@ TEST_CASE("SafetyPolicy emergency is sticky") {
     policy.reset_to_normal();
     CHECK(policy.is_safe());
 }
+
+TEST_CASE("SafetyPolicy handles and deadline-gated checks") {
+    SafetyPolicy policy;
+    dp::Vector<FreshnessHandle> handles;
+    for (u32 i = 0; i < 40; ++i)
+        handles.push_back(policy.watch(FreshnessRequirement{"src" + dp::String(std::to_string(i)), 500 + i * 10}));
+    CHECK(handles[7] == 7);
+    CHECK(policy.handle("src7") == 7);
+    CHECK(policy.handle("missing") == INVALID_FRESHNESS);
+    CHECK(policy.next_deadline_ms() == 501);
+
+    // Reports push deadlines out; the first look happens at the old earliest deadline
+    policy.update(400);
+    for (auto h : handles)
+        policy.report_alive(h);
+    CHECK(policy.next_deadline_ms() == 101);
+    policy.update(101);
+    CHECK(policy.is_safe());
+    CHECK(policy.next_deadline_ms() == 400); // Re-evaluated from the reports at 400
+
+    policy.update(399);
+    CHECK(policy.is_safe());
+    policy.report_alive(INVALID_FRESHNESS); // Ignored
+    for (usize i = 1; i < handles.size(); ++i)
+        policy.report_alive(handles[i]);
+    policy.update(1);
+    CHECK(policy.is_degraded());
+    CHECK(policy.next_deadline_ms() == 0);
+
+    policy.report_alive(handles[0]);
+    policy.update(1);
+    CHECK(policy.is_safe());
+}
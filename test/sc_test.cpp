@@ -272,12 +272,19 @@ TEST_CASE("SCMaster: periodic status") {
     auto env = make_test_env();
     SCMaster master(env.nm, env.cf, SCMasterConfig{}.status_interval(50));
     master.add_step({1, "step", 100, false});
+    usize before = env.nm.timers().size();
     master.start();
 
-    // Status should be sent periodically during Ready state
-    // This won't error since cf has no endpoint, but the send path is exercised
-    master.update(60); // Should trigger one status send
+    // The status timer lives on the IsoNet timer wheel while the sequence runs
+    // (cf has no endpoint, but the send path is exercised)
+    CHECK(env.nm.timers().size() == before + 1);
+    CHECK(env.nm.next_deadline_ms() <= 50);
+    env.nm.update(60);
     CHECK(master.state() == SCState::Ready);
+    CHECK(env.nm.timers().size() == before + 1);
+
+    REQUIRE(master.abort().is_ok());
+    CHECK(env.nm.timers().size() == before);
 }
 
 // ─── Client state transitions ─────────────────────────────────────────────────
@@ -444,7 +451,8 @@ TEST_CASE("SCMaster + SCClient: integrated state flow") {
         master.start();
         CHECK(master.state() == SCState::Ready);
 
-        // Master sends status on update
+        // The periodic status goes out from the network's update
+        nm.update(60);
         master.update(60);
         CHECK(master.state() == SCState::Ready);
     }
@@ -506,3 +514,66 @@ TEST_CASE("SCMaster: update in terminal states") {
         CHECK(master.state() == SCState::Error);
     }
 }
+
+// ─── Event-driven sequence over a loopback bus ────────────────────────────────
+#include <agrobus/net/loopback_bus.hpp>
+
+TEST_CASE("SCMaster: steps advance from client status without update") {
+    LoopbackBus bus;
+    IsoNet nm_master;
+    IsoNet nm_a;
+    IsoNet nm_b;
+    auto *master_cf = nm_master.create_internal(Name::build().set_identity_number(1), 0, 0x28).value();
+    auto *a_cf = nm_a.create_internal(Name::build().set_identity_number(2), 0, 0x30).value();
+    auto *b_cf = nm_b.create_internal(Name::build().set_identity_number(3), 0, 0x31).value();
+    bus.attach(nm_master);
+    bus.attach(nm_a);
+    bus.attach(nm_b);
+    REQUIRE(nm_master.start_address_claiming().is_ok());
+    REQUIRE(nm_a.start_address_claiming().is_ok());
+    REQUIRE(nm_b.start_address_claiming().is_ok());
+
+    // Periodic status far off: anything the clients see comes from a change
+    SCMaster master(nm_master, master_cf, SCMasterConfig{}.status_interval(10000).active_timeout(10000));
+    SCClient client_a(nm_a, a_cf, SCClientConfig{}.min_spacing(10));
+    SCClient client_b(nm_b, b_cf, SCClientConfig{}.min_spacing(10));
+    REQUIRE(master.initialize().is_ok());
+    REQUIRE(client_a.initialize().is_ok());
+    REQUIRE(client_b.initialize().is_ok());
+    master.add_step({1, "lower", 0, false});
+    master.add_step({2, "fold", 0, false});
+
+    auto run = [&](u32 steps) {
+        for (u32 i = 0; i < steps; ++i) {
+            nm_master.update(5);
+            nm_a.update(5);
+            nm_b.update(5);
+            client_a.update(5);
+            client_b.update(5);
+        }
+    };
+    run(60); // Address claims
+
+    REQUIRE(master.start().is_ok());
+    run(3);
+    CHECK(client_a.state() == SCState::Active);
+    REQUIRE(master.state() == SCState::Active);
+    run(4); // Client spacing
+    REQUIRE(master.timings().size() == 2);
+    CHECK(master.timings()[0].step_id == 1);
+    CHECK(master.timings()[0].acks == 2);
+    CHECK(master.timings()[0].first_ack_us >= master.timings()[0].started_us);
+    CHECK(master.timings()[0].last_ack_us >= master.timings()[0].first_ack_us);
+
+    REQUIRE(master.step_completed(1).is_ok());
+    CHECK(master.timings()[0].completed_us != 0);
+    CHECK(master.timings()[0].duration_us() >= master.timings()[0].ack_latency_us());
+    REQUIRE(master.current_timing() != nullptr);
+    CHECK(master.current_timing()->step_id == 2);
+    run(6);
+    CHECK(master.timings()[1].acks == 2);
+
+    REQUIRE(master.step_completed(2).is_ok());
+    CHECK(master.state() == SCState::Complete);
+    CHECK(master.timings()[1].completed_us >= master.timings()[1].started_us);
+}
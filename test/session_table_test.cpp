@@ -0,0 +1,99 @@
+#include <doctest/doctest.h>
+#include <agrobus/net/session_table.hpp>
+
+using namespace agrobus::net;
+
+static TransportSession make_session(Address src, Address dst, PGN pgn, u8 port = 0,
+                                     TransportDirection dir = TransportDirection::Receive) {
+    TransportSession s;
+    s.direction = dir;
+    s.source_address = src;
+    s.destination_address = dst;
+    s.pgn = pgn;
+    s.can_port = port;
+    return s;
+}
+
+TEST_CASE("TransportSessionTable insert and find by key") {
+    TransportSessionTable table(8);
+    CHECK(table.capacity() == 8);
+    CHECK(table.empty());
+
+    auto *a = table.insert(make_session(0x30, 0x28, 0xFECA));
+    auto *b = table.insert(make_session(0x31, BROADCAST_ADDRESS, 0xFECB, 1));
+    REQUIRE(a != nullptr);
+    REQUIRE(b != nullptr);
+    CHECK(table.size() == 2);
+
+    CHECK(table.find(TransportDirection::Receive, 0, 0x30, 0x28) == a);
+    CHECK(table.find(TransportDirection::Receive, 1, 0x31, BROADCAST_ADDRESS) == b);
+    CHECK(table.find(TransportDirection::Transmit, 0, 0x30, 0x28) == nullptr);
+    CHECK(table.find(TransportDirection::Receive, 1, 0x30, 0x28) == nullptr);
+}
+
+TEST_CASE("TransportSessionTable keeps slots stable across erase") {
+    TransportSessionTable table(16);
+    dp::Vector<TransportSession *> ptrs;
+    for (u8 i = 0; i < 10; ++i)
+        ptrs.push_back(table.insert(make_session(static_cast<Address>(0x40 + i), BROADCAST_ADDRESS, 0xFE00 + i)));
+
+    table.erase(ptrs[3]);
+    table.erase(ptrs[7]);
+    CHECK(table.size() == 8);
+
+    for (u8 i = 0; i < 10; ++i) {
+        auto *found = table.find(TransportDirection::Receive, 0, static_cast<Address>(0x40 + i), BROADCAST_ADDRESS);
+        if (i == 3 || i == 7) {
+            CHECK(found == nullptr);
+        } else {
+            CHECK(found == ptrs[i]);
+            CHECK(found->pgn == 0xFE00u + i);
+        }
+    }
+
+    // Iteration keeps insertion order
+    CHECK(table.at(0).pgn == 0xFE00);
+    CHECK(table.at(3).pgn == 0xFE04);
+}
+
+TEST_CASE("TransportSessionTable filters sessions with the same key") {
+    TransportSessionTable table(4);
+    table.insert(make_session(0x28, 0x30, 0xE000, 0, TransportDirection::Transmit));
+    auto *second = table.insert(make_session(0x28, 0x30, 0xE100, 0, TransportDirection::Transmit));
+
+    auto *found = table.find_if(TransportDirection::Transmit, 0, 0x28, 0x30,
+                                [](const TransportSession &s) { return s.pgn == 0xE100; });
+    CHECK(found == second);
+}
+
+TEST_CASE("TransportSessionTable refuses inserts when full and reuses freed slots") {
+    TransportSessionTable table(2);
+    auto *a = table.insert(make_session(0x01, 0xFF, 1));
+    table.insert(make_session(0x02, 0xFF, 2));
+    CHECK(table.full());
+    CHECK(table.insert(make_session(0x03, 0xFF, 3)) == nullptr);
+
+    table.erase(a);
+    auto *c = table.insert(make_session(0x03, 0xFF, 3));
+    CHECK(c != nullptr);
+    CHECK(table.find(TransportDirection::Receive, 0, 0x03, 0xFF) == c);
+    CHECK(table.find(TransportDirection::Receive, 0, 0x02, 0xFF) != nullptr);
+}
+
+TEST_CASE("TransportSessionTable survives heavy churn") {
+    TransportSessionTable table(32);
+    for (u32 round = 0; round < 200; ++round) {
+        for (u8 i = 0; i < 32; ++i)
+            REQUIRE(table.insert(make_session(i, static_cast<Address>(round & 0xFF), round)) != nullptr);
+        CHECK(table.full());
+        for (u8 i = 0; i < 32; i += 2)
+            table.erase(table.find(TransportDirection::Receive, 0, i, static_cast<Address>(round & 0xFF)));
+        for (u8 i = 1; i < 32; i += 2) {
+            auto *s = table.find(TransportDirection::Receive, 0, i, static_cast<Address>(round & 0xFF));
+            REQUIRE(s != nullptr);
+            CHECK(s->pgn == round);
+        }
+        table.clear();
+        CHECK(table.empty());
+    }
+}
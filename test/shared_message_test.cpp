@@ -0,0 +1,97 @@
+#include <doctest/doctest.h>
+#include <agrobus/net/loopback_bus.hpp>
+#include <agrobus/net/network_manager.hpp>
+#include <agrobus/net/shared_message.hpp>
+#include <thread>
+
+using namespace agrobus::net;
+
+TEST_CASE("adopt_payload - one buffer for every holder") {
+    BufferPool pool;
+    auto returns = std::make_shared<BufferReturns>();
+    dp::Vector<u8> bytes = pool.acquire(300);
+    bytes[0] = 0x42;
+    const u8 *at = bytes.data();
+
+    SharedPayload a = adopt_payload(std::move(bytes), returns);
+    CHECK(a->data() == at); // Adopted, not copied
+    CHECK(a->size() == 300);
+    SharedPayload b = a;
+    CHECK(a.use_count() == 2);
+
+    std::thread consumer([held = a] { CHECK(DataSpan(*held).get_u8(0) == 0x42); });
+    consumer.join();
+    a.reset();
+    CHECK(returns->drain(pool) == 0); // `b` still holds it
+    b.reset();
+    CHECK(returns->drain(pool) == 1);
+    CHECK(pool.cached(BufferPool::class_for(300)) == 1);
+
+    SharedPayload copied = copy_payload(DataSpan(at, 2), pool);
+    CHECK(copied->size() == 2);
+    CHECK(SharedMessage().bytes().empty());
+}
+
+TEST_CASE("IsoNet - transport payloads reach on_shared_message without a copy") {
+    LoopbackBus bus;
+    IsoNet tx;
+    IsoNet rx;
+    auto *tx_cf = tx.create_internal(Name::build().set_identity_number(1), 0, 0x20).value();
+    auto *rx_cf = rx.create_internal(Name::build().set_identity_number(2), 0, 0x30).value();
+    bus.attach(tx);
+    bus.attach(rx);
+    REQUIRE(tx.start_address_claiming().is_ok());
+    REQUIRE(rx.start_address_claiming().is_ok());
+    auto run = [&](u32 steps) {
+        for (u32 i = 0; i < steps; ++i) {
+            tx.update(10);
+            rx.update(10);
+        }
+    };
+    run(60);
+    REQUIRE(rx_cf->claim_state() == ClaimState::Claimed);
+
+    dp::Vector<SharedMessage> kept;
+    rx.on_shared_message.subscribe([&](const SharedMessage &msg) {
+        if (msg.pgn == 0xEF00)
+            kept.push_back(msg);
+    });
+    const u8 *seen = nullptr;
+    REQUIRE(rx.register_pgn_callback(0xEF00, [&](const Message &msg) { seen = msg.data.data(); }).is_ok());
+
+    dp::Vector<u8> payload(500);
+    for (usize i = 0; i < payload.size(); ++i)
+        payload[i] = static_cast<u8>(i);
+    ControlFunction dest;
+    dest.address = 0x30;
+    REQUIRE(tx.send(0xEF00, payload, tx_cf, &dest).is_ok());
+    run(100);
+
+    REQUIRE(kept.size() == 1);
+    const SharedMessage &msg = kept[0];
+    CHECK(msg.source == 0x20);
+    CHECK(msg.destination == 0x30);
+    REQUIRE(msg.size() == 500);
+    CHECK(msg.bytes()[499] == static_cast<u8>(499));
+    CHECK(msg.data->data() == seen); // The reassembly buffer itself
+    CHECK(msg.view().get_u16_le(2) == 0x0302);
+
+    // Let go of on another thread: the buffer is back in the pool after the next update
+    usize cached = rx.buffer_pool().cached(BufferPool::class_for(500));
+    std::thread([moved = std::move(kept)]() mutable { moved.clear(); }).join();
+    rx.update(0);
+    CHECK(rx.buffer_pool().cached(BufferPool::class_for(500)) == cached + 1);
+
+    SUBCASE("single frames are copied once") {
+        dp::Vector<SharedMessage> frames;
+        rx.on_shared_message.subscribe([&](const SharedMessage &m) {
+            if (m.pgn == 0xEF00)
+                frames.push_back(m);
+        });
+        REQUIRE(tx.send(0xEF00, dp::Vector<u8>{1, 2, 3, 4, 5, 6, 7, 8}, tx_cf, &dest).is_ok());
+        run(5);
+        REQUIRE(frames.size() == 1);
+        CHECK(frames[0].size() == 8);
+        CHECK(frames[0].bytes()[7] == 8);
+    }
+}
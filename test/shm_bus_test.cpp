@@ -0,0 +1,81 @@
+#include <doctest/doctest.h>
+#include <agrobus/net/network_manager.hpp>
+#include <agrobus/net/shm_bus.hpp>
+
+using namespace agrobus::net;
+
+namespace {
+
+    can_frame make_can(u32 id, u8 first) {
+        can_frame cf = {};
+        cf.can_id = id | CAN_EFF_FLAG;
+        cf.can_dlc = 8;
+        for (u8 i = 0; i < 8; ++i)
+            cf.data[i] = static_cast<u8>(first + i);
+        return cf;
+    }
+
+} // namespace
+
+TEST_CASE("ShmBus delivers frames to every other attached process") {
+    // Each ShmBus is what one process would open
+    ShmBus reader_a;
+    ShmBus reader_b;
+    ShmBus publisher;
+    REQUIRE(publisher.open(ShmBusConfig{}.segment("/agrobus_test_bus").frames(64).owner(true)).is_ok());
+    REQUIRE(reader_a.open(ShmBusConfig{}.segment("/agrobus_test_bus").attach_only()).is_ok());
+    REQUIRE(reader_b.open(ShmBusConfig{}.segment("/agrobus_test_bus").attach_only()).is_ok());
+    CHECK(reader_a.capacity() == 64);
+    CHECK(reader_a.writer_id() != publisher.writer_id());
+
+    for (u8 i = 0; i < 3; ++i)
+        publisher.publish(make_can(0x18FEF100 + i, i), 1000 + i);
+
+    can_frame cf;
+    for (ShmBus *bus : {&reader_a, &reader_b}) {
+        for (u8 i = 0; i < 3; ++i) {
+            REQUIRE(bus->pop_can(cf));
+            CHECK((cf.can_id & CAN_EFF_MASK) == 0x18FEF100u + i);
+            CHECK(cf.data[0] == i);
+            CHECK(bus->last_timestamp_us() == 1000u + i);
+        }
+        CHECK_FALSE(bus->pop_can(cf));
+    }
+    // Own frames are not delivered back
+    CHECK_FALSE(publisher.pop_can(cf));
+
+    // A reader that falls a whole ring behind skips ahead and counts the loss
+    for (u32 i = 0; i < 100; ++i)
+        publisher.publish(make_can(i, 0), i);
+    u32 got = 0;
+    while (reader_a.pop_can(cf))
+        ++got;
+    CHECK(got == 63);
+    CHECK(reader_a.lost() == 37);
+    CHECK((cf.can_id & CAN_EFF_MASK) == 99);
+}
+
+TEST_CASE("IsoNets exchange frames through a ShmBus") {
+    ShmBus bus_a;
+    ShmBus bus_b;
+    REQUIRE(bus_a.open(ShmBusConfig{}.segment("/agrobus_test_net").frames(256).owner(true)).is_ok());
+    REQUIRE(bus_b.open(ShmBusConfig{}.segment("/agrobus_test_net").attach_only()).is_ok());
+
+    IsoNet nm_a;
+    IsoNet nm_b;
+    nm_a.set_endpoint(0, &bus_a.can_endpoint());
+    nm_b.set_endpoint(0, &bus_b.can_endpoint());
+    nm_b.set_rx_source(0, bus_b.rx_source());
+
+    u32 received = 0;
+    nm_b.on_frame_received.subscribe([&](const Frame &f, u8) {
+        CHECK(f.pgn() == 0xFEF1);
+        ++received;
+    });
+    u8 payload[8] = {1, 2, 3, 4, 5, 6, 7, 8};
+    REQUIRE(nm_a.send_frame(Frame::from_message(Priority::Default, 0xFEF1, 0x28, BROADCAST_ADDRESS, payload, 8))
+                .is_ok());
+    nm_b.update(0);
+    CHECK(received == 1);
+    nm_a.update(0);
+}
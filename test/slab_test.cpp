@@ -0,0 +1,82 @@
+#include <doctest/doctest.h>
+#include <agrobus/net/network_manager.hpp>
+#include <agrobus/net/slab.hpp>
+
+using namespace agrobus::net;
+
+TEST_CASE("Slab keeps addresses stable and rejects stale handles") {
+    Slab<dp::String, 4> slab;
+    CHECK(slab.empty());
+
+    SlabHandle first = slab.emplace("first");
+    dp::String *first_ptr = slab.get(first);
+    dp::Vector<SlabHandle> more;
+    for (i32 i = 0; i < 20; ++i)
+        more.push_back(slab.emplace("more"));
+    CHECK(slab.size() == 21);
+    CHECK(slab.get(first) == first_ptr); // No reallocation moved it
+    CHECK(*first_ptr == "first");
+    CHECK(slab.handle_of(first_ptr) == first);
+
+    CHECK(slab.erase(first));
+    CHECK_FALSE(slab.erase(first));
+    CHECK(slab.get(first) == nullptr);
+    CHECK(slab.at(Slab<dp::String, 4>::index_of(first)) == nullptr);
+
+    // The slot is reused under a new generation
+    SlabHandle reused = slab.emplace("reused");
+    CHECK(Slab<dp::String, 4>::index_of(reused) == Slab<dp::String, 4>::index_of(first));
+    CHECK(reused != first);
+    CHECK(slab.get(first) == nullptr);
+    CHECK(*slab.get(reused) == "reused");
+
+    usize live = 0;
+    for (auto &s : slab) {
+        CHECK_FALSE(s.empty());
+        ++live;
+    }
+    CHECK(live == slab.size());
+    CHECK(slab.handle_of(nullptr) == INVALID_HANDLE);
+}
+
+TEST_CASE("IsoNet adds and removes CFs at runtime") {
+    IsoNet nm;
+    auto *tractor = nm.create_internal(Name::build().set_identity_number(1), 0, 0x28).value();
+    SlabHandle tractor_handle = nm.handle(tractor);
+
+    // Creating more CFs later no longer invalidates the first one
+    dp::Vector<InternalCF *> implements;
+    for (u32 i = 0; i < 40; ++i)
+        implements.push_back(nm.create_internal(Name::build().set_identity_number(100 + i), 0, 0x80 + i).value());
+    CHECK(nm.internal(tractor_handle) == tractor);
+    CHECK(tractor->address() == 0x28);
+    REQUIRE(nm.start_address_claiming().is_ok());
+    nm.update(300);
+    CHECK(tractor->claim_state() == ClaimState::Claimed);
+
+    // Unplug one implement: its slot and address go away, the rest stay
+    SlabHandle gone = nm.handle(implements[5]);
+    CFState last_state = CFState::Online;
+    nm.on_cf_state_change.subscribe([&](ControlFunction *, CFState s) { last_state = s; });
+    REQUIRE(nm.remove_internal(implements[5]).is_ok());
+    CHECK(last_state == CFState::Offline);
+    CHECK(nm.internal(gone) == nullptr);
+    CHECK(nm.internal_cfs().size() == 40);
+    CHECK(nm.cf_at(0, 0x85) == nullptr);
+    CHECK(nm.cf_at(0, 0x86) == &implements[6]->cf());
+    CHECK_FALSE(nm.remove_internal(implements[5]).is_ok());
+
+    // Hot-plug a new one into the freed slot
+    auto *plugged = nm.create_internal(Name::build().set_identity_number(500), 0, 0x90).value();
+    CHECK(nm.internal(gone) == nullptr);
+    CHECK(nm.handle(plugged) != gone);
+    nm.update(0);
+    CHECK(nm.cf_at(0, 0x90) == &plugged->cf());
+
+    auto *partner = nm.create_partner(0, {{NameFilterField::FunctionCode, 1}}).value();
+    SlabHandle partner_handle = nm.handle(partner);
+    CHECK(nm.partner(partner_handle) == partner);
+    REQUIRE(nm.remove_partner(partner).is_ok());
+    CHECK(nm.partner(partner_handle) == nullptr);
+    CHECK(nm.partner_cfs().empty());
+}
@@ -0,0 +1,104 @@
+#include <doctest/doctest.h>
+#include <agrobus/isobus/implement/speed_distance.hpp>
+#include <agrobus/isobus/vt/state_tracker.hpp>
+#include <agrobus/net/snapshot.hpp>
+#include <agrobus/nmea/interface.hpp>
+#include <thread>
+
+using namespace agrobus::net;
+
+namespace {
+
+    struct Pose {
+        f64 x = 0.0;
+        f64 y = 0.0;
+        f64 z = 0.0;
+        u32 n = 0;
+    };
+
+} // namespace
+
+TEST_CASE("Snapshot publishes whole values") {
+    Snapshot<Pose> snap;
+    static_assert(Snapshot<Pose>::lock_free());
+    CHECK(snap.version() == 0);
+    CHECK(snap.load().n == 0);
+
+    snap.publish(Pose{1.0, 2.0, 3.0, 7});
+    CHECK(snap.version() == 1);
+    Pose p;
+    CHECK(snap.read(p) == 1);
+    CHECK(p.y == doctest::Approx(2.0));
+    CHECK(p.n == 7);
+
+    // Non-trivial values take the guarded path
+    Snapshot<dp::String> name(dp::String("tractor"));
+    static_assert(!Snapshot<dp::String>::lock_free());
+    CHECK(name.version() == 0);
+    CHECK(name.load() == "tractor");
+    name.publish("sprayer");
+    CHECK(name.load() == "sprayer");
+    CHECK(name.version() == 1);
+}
+
+TEST_CASE("Snapshot readers never see a torn value") {
+    Snapshot<Pose> snap;
+    std::atomic<bool> done{false};
+    std::atomic<u32> torn{0};
+
+    std::thread reader([&]() {
+        Pose p;
+        while (!done.load(std::memory_order_acquire)) {
+            snap.read(p);
+            if (p.x != p.y || p.y != p.z || static_cast<u32>(p.x) != p.n)
+                torn.fetch_add(1);
+        }
+    });
+
+    for (u32 n = 0; n < 200000; ++n) {
+        f64 v = static_cast<f64>(n);
+        snap.publish(Pose{v, v, v, n});
+    }
+    done.store(true, std::memory_order_release);
+    reader.join();
+    CHECK(torn.load() == 0);
+    CHECK(snap.version() == 200000);
+}
+
+TEST_CASE("Interfaces publish decoded state into snapshots") {
+    IsoNet nm;
+    Name name;
+    auto *cf = nm.create_internal(name, 0, 0x28).value();
+
+    agrobus::isobus::implement::TECUSpeedDistance speed(nm, cf);
+    speed.initialize();
+    agrobus::nmea::NMEAInterface gnss(nm, cf);
+    gnss.initialize();
+    agrobus::isobus::vt::VTClientStateTracker tracker(nm);
+    tracker.initialize();
+
+    CHECK(speed.snapshot().version() == 0);
+    CHECK(gnss.position_snapshot().version() == 0);
+
+    nm.inject_message(Message(PGN_WHEEL_BASED_SPEED_DIST, {0x88, 0x13, 0x00, 0x00, 0x00, 0x00, 0xFF, 0xF4}, 0x80));
+    nm.inject_message(Message(PGN_REAR_PTO, {0x40, 0x1F, 0x95, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF}, 0x80));
+    auto state = speed.state();
+    CHECK(speed.snapshot().version() == 2);
+    CHECK(state.wheel.speed_mps == doctest::Approx(5.0));
+    CHECK(state.rear_pto.shaft_speed_rpm == doctest::Approx(1000.0));
+    CHECK_FALSE(state.front_pto.is_rear);
+
+    // 52.0 N, 5.0 E at 1e-7 degrees
+    nm.inject_message(Message(PGN_GNSS_POSITION_RAPID, {0x00, 0x92, 0xFE, 0x1E, 0x80, 0xF0, 0xFA, 0x02}, 0x80));
+    auto pos = gnss.position_snapshot().load();
+    CHECK(gnss.position_snapshot().version() == 1);
+    CHECK(pos.wgs.latitude == doctest::Approx(52.0));
+    CHECK(pos.wgs.longitude == doctest::Approx(5.0));
+
+    nm.inject_message(Message(PGN_VT_TO_ECU, {0xFE, 0x28, 0xE8, 0x03, 0xD0, 0x07, 0x01, 0xFF}, 0x26));
+    auto vt = tracker.status();
+    CHECK(vt.active_data_mask == 1000);
+    CHECK(vt.active_soft_key_mask == 2000);
+    CHECK(vt.vt_busy_code == 0x01);
+    CHECK(vt.vt_address == 0x26);
+}
@@ -4,7 +4,11 @@
 #include <agrobus/net/constants.hpp>
 #include <wirebit/can/can_endpoint.hpp>
 #include <wirebit/link.hpp>
+#include <chrono>
 #include <cstring>
+#include <linux/can/error.h>
+#include <mutex>
+#include <thread>
 
 using namespace agrobus::net;
 
@@ -79,6 +83,37 @@ public:
     usize tx_count() const { return tx_log_.size(); }
 };
 
+// MockLink guarded for use from an IsoNet reader thread
+class LockedMockLink : public MockLink {
+    mutable std::mutex mutex_;
+
+public:
+    wirebit::Result<wirebit::Unit, wirebit::Error> send(const wirebit::Frame& frame) override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return MockLink::send(frame);
+    }
+    wirebit::Result<wirebit::Frame, wirebit::Error> recv() override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return MockLink::recv();
+    }
+    void inject_isobus(const Frame& frame) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        MockLink::inject_isobus(frame);
+    }
+};
+
+// MockLink whose TX queue can be made to fill up, as SocketCAN does with ENOBUFS
+class BusyMockLink : public MockLink {
+public:
+    bool busy = false;
+
+    wirebit::Result<wirebit::Unit, wirebit::Error> send(const wirebit::Frame& frame) override {
+        if (busy)
+            return wirebit::Result<wirebit::Unit, wirebit::Error>::err(wirebit::Error::timeout("no buffer space"));
+        return MockLink::send(frame);
+    }
+};
+
 TEST_CASE("CanEndpoint send and recv") {
     auto link = std::make_shared<MockLink>();
     wirebit::CanEndpoint ep(link, wirebit::CanConfig{}, 1);
@@ -153,3 +188,531 @@ TEST_CASE("CanEndpoint with IsoNet") {
     auto cf_result = nm.create_internal(name, 0, 0x28);
     CHECK(cf_result.is_ok());
 }
+
+TEST_CASE("IsoNet view callbacks receive single frames without a Message") {
+    auto link = std::make_shared<MockLink>();
+    wirebit::CanEndpoint ep(link, wirebit::CanConfig{}, 1);
+
+    IsoNet nm;
+    nm.set_endpoint(0, &ep);
+
+    u32 view_calls = 0;
+    u16 speed_raw = 0;
+    nm.register_pgn_view_callback(PGN_VEHICLE_SPEED, [&](const MessageView &view) {
+        ++view_calls;
+        speed_raw = view.get_u16_le(1);
+        CHECK(view.source == 0x30);
+        CHECK(view.size() == 8);
+    });
+
+    u32 owned_calls = 0;
+    nm.register_pgn_callback(PGN_DM1, [&](const Message &) { ++owned_calls; });
+
+    Frame speed;
+    speed.id = Identifier::encode(Priority::Default, PGN_VEHICLE_SPEED, 0x30, BROADCAST_ADDRESS);
+    speed.data = {0xFF, 0x00, 0x19, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+    link->inject_isobus(speed);
+
+    Frame dm1;
+    dm1.id = Identifier::encode(Priority::Default, PGN_DM1, 0x30, BROADCAST_ADDRESS);
+    link->inject_isobus(dm1);
+
+    nm.update(10);
+
+    CHECK(view_calls == 1);
+    CHECK(speed_raw == 0x1900);
+    CHECK(owned_calls == 1);
+
+    SUBCASE("null view callback is rejected") {
+        CHECK(nm.register_pgn_view_callback(PGN_DM1, nullptr).is_err());
+    }
+}
+
+TEST_CASE("IsoNet batched receive drains every frame in order") {
+    auto link = std::make_shared<MockLink>();
+    wirebit::CanEndpoint ep(link, wirebit::CanConfig{}, 1);
+
+    IsoNet nm(NetworkConfig{}.rx_batch(2));
+    nm.set_endpoint(0, &ep);
+
+    dp::Vector<u8> seen;
+    nm.register_pgn_view_callback(PGN_VEHICLE_SPEED, [&](const MessageView &view) { seen.push_back(view.get_u8(0)); });
+
+    for (u8 i = 0; i < 5; ++i) {
+        Frame f;
+        f.id = Identifier::encode(Priority::Default, PGN_VEHICLE_SPEED, 0x30, BROADCAST_ADDRESS);
+        f.data[0] = i;
+        f.length = 3;
+        link->inject_isobus(f);
+    }
+
+    nm.update(10);
+
+    REQUIRE(seen.size() == 5);
+    for (u8 i = 0; i < 5; ++i) {
+        CHECK(seen[i] == i);
+    }
+}
+
+TEST_CASE("IsoNet stamps received frames from the RX clock") {
+    auto link = std::make_shared<MockLink>();
+    wirebit::CanEndpoint ep(link, wirebit::CanConfig{}, 1);
+
+    IsoNet nm;
+    nm.set_endpoint(0, &ep);
+
+    u64 now = 1000;
+    nm.set_rx_clock([&]() { return now += 100; });
+
+    Message speed_msg;
+    nm.register_pgn_callback(PGN_VEHICLE_SPEED, [&](const Message &msg) { speed_msg = msg; });
+    Message bam_msg;
+    nm.register_pgn_callback(0xFECA, [&](const Message &msg) { bam_msg = msg; });
+
+    Frame speed;
+    speed.id = Identifier::encode(Priority::Default, PGN_VEHICLE_SPEED, 0x30, BROADCAST_ADDRESS);
+    link->inject_isobus(speed);
+
+    Frame bam;
+    bam.id = Identifier::encode(Priority::Lowest, PGN_TP_CM, 0x30, BROADCAST_ADDRESS);
+    bam.data = {tp_cm::BAM, 14, 0, 2, 0xFF, 0xCA, 0xFE, 0x00};
+    link->inject_isobus(bam);
+    for (u8 seq = 1; seq <= 2; ++seq) {
+        Frame dt;
+        dt.id = Identifier::encode(Priority::Lowest, PGN_TP_DT, 0x30, BROADCAST_ADDRESS);
+        dt.data[0] = seq;
+        link->inject_isobus(dt);
+    }
+
+    nm.update(10);
+
+    CHECK(speed_msg.timestamp_us == 1100);
+    CHECK(speed_msg.first_timestamp_us == 1100);
+    CHECK(bam_msg.first_timestamp_us == 1200);
+    CHECK(bam_msg.timestamp_us == 1400);
+}
+
+TEST_CASE("IsoNet threaded RX drains frames read by the reader thread") {
+    auto link = std::make_shared<LockedMockLink>();
+    wirebit::CanEndpoint ep(link, wirebit::CanConfig{}, 1);
+
+    IsoNet nm(NetworkConfig{}.threaded_rx(true, 256));
+    nm.set_endpoint(0, &ep);
+    CHECK(nm.rx_threaded(0));
+
+    dp::Vector<u8> seen;
+    nm.register_pgn_view_callback(PGN_VEHICLE_SPEED, [&](const MessageView &view) { seen.push_back(view.get_u8(0)); });
+
+    for (u8 i = 0; i < 50; ++i) {
+        Frame f;
+        f.id = Identifier::encode(Priority::Default, PGN_VEHICLE_SPEED, 0x30, BROADCAST_ADDRESS);
+        f.data[0] = i;
+        link->inject_isobus(f);
+    }
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (seen.size() < 50 && std::chrono::steady_clock::now() < deadline) {
+        nm.update(1);
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    REQUIRE(seen.size() == 50);
+    for (u8 i = 0; i < 50; ++i) {
+        CHECK(seen[i] == i);
+    }
+    CHECK(nm.rx_dropped(0) == 0);
+
+    nm.stop_rx_threads();
+    CHECK_FALSE(nm.rx_threaded(0));
+}
+
+TEST_CASE("IsoNet re-announces CAN filters when registrations change") {
+    auto link = std::make_shared<MockLink>();
+    wirebit::CanEndpoint ep(link, wirebit::CanConfig{}, 1);
+
+    IsoNet nm;
+    nm.set_endpoint(0, &ep);
+
+    u32 changes = 0;
+    usize last_size = 0;
+    nm.on_can_filters_changed.subscribe([&](u8 port, const dp::Vector<can_filter> &filters) {
+        CHECK(port == 0);
+        ++changes;
+        last_size = filters.size();
+    });
+
+    nm.update(1);
+    CHECK(changes == 1);
+    nm.update(1);
+    CHECK(changes == 1); // nothing changed
+
+    nm.register_pgn_callback(PGN_VEHICLE_SPEED, [](const Message &) {});
+    usize before = last_size;
+    nm.update(1);
+    CHECK(changes == 2);
+    CHECK(last_size == before + 1);
+
+    nm.register_pgn_callback(PGN_VEHICLE_SPEED, [](const Message &) {});
+    nm.update(1);
+    CHECK(changes == 2); // same PGN, same filter set
+}
+
+TEST_CASE("IsoNet next deadline and wait") {
+    auto link = std::make_shared<MockLink>();
+    wirebit::CanEndpoint ep(link, wirebit::CanConfig{}, 1);
+
+    IsoNet nm;
+    nm.set_endpoint(0, &ep);
+    CHECK(nm.wait_fd() == -1);
+
+    SUBCASE("idle network has no deadline") {
+        nm.update(10);
+        CHECK(nm.next_deadline_ms() == NO_DEADLINE);
+    }
+
+    SUBCASE("address claim bounds the deadline") {
+        Name name;
+        name.set_identity_number(7);
+        nm.create_internal(name, 0, 0x28);
+        nm.start_address_claiming();
+        u32 deadline = nm.next_deadline_ms();
+        CHECK(deadline != NO_DEADLINE);
+        CHECK(deadline <= ADDRESS_CLAIM_TIMEOUT_MS + 200);
+    }
+
+    SUBCASE("bus load sample pending after traffic") {
+        Frame f;
+        f.id = Identifier::encode(Priority::Default, PGN_VEHICLE_SPEED, 0x30, BROADCAST_ADDRESS);
+        link->inject_isobus(f);
+        nm.update(10);
+        CHECK(nm.next_deadline_ms() == 90);
+    }
+
+    SUBCASE("wait is bounded by max_wait_ms") {
+        u32 waited = nm.wait(5);
+        CHECK(waited <= 1000);
+    }
+
+    SUBCASE("wait carries sub-ms fractions into the next call") {
+        // Calls far less than 1 ms apart still add up to the wall time
+        auto start = std::chrono::steady_clock::now();
+        u32 total = nm.wait(0);
+        while (std::chrono::steady_clock::now() - start < std::chrono::milliseconds(20)) {
+            total += nm.wait(0);
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+        auto end = std::chrono::steady_clock::now();
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+        CHECK(total >= 19);
+        CHECK(total <= elapsed);
+        CHECK(total + 1 >= elapsed);
+    }
+}
+
+TEST_CASE("IsoNet wait wakes on frames from the reader thread") {
+    auto link = std::make_shared<LockedMockLink>();
+    wirebit::CanEndpoint ep(link, wirebit::CanConfig{}, 1);
+
+    IsoNet nm(NetworkConfig{}.threaded_rx(true));
+    nm.set_endpoint(0, &ep);
+    CHECK(nm.wait_fd() >= 0);
+
+    u32 received = 0;
+    nm.register_pgn_view_callback(PGN_VEHICLE_SPEED, [&](const MessageView &) { ++received; });
+
+    Frame f;
+    f.id = Identifier::encode(Priority::Default, PGN_VEHICLE_SPEED, 0x30, BROADCAST_ADDRESS);
+    link->inject_isobus(f);
+
+    auto start = std::chrono::steady_clock::now();
+    while (received == 0 && std::chrono::steady_clock::now() - start < std::chrono::seconds(5))
+        nm.update(nm.wait(2000));
+
+    CHECK(received == 1);
+    // Woken by the frame, not by the 2 s timeout
+    CHECK(std::chrono::steady_clock::now() - start < std::chrono::milliseconds(1500));
+}
+
+TEST_CASE("NetworkConfig rx_batch clamps zero") {
+    NetworkConfig cfg;
+    cfg.rx_batch(0);
+    CHECK(cfg.rx_batch_size == 1);
+}
+
+TEST_CASE("IsoNet coalesces frames produced during update") {
+    auto link = std::make_shared<MockLink>();
+    wirebit::CanEndpoint ep(link, wirebit::CanConfig{}, 1);
+
+    IsoNet nm;
+    nm.set_endpoint(0, &ep);
+
+    Name name;
+    name.set_identity_number(7);
+    auto *cf = nm.create_internal(name, 0, 0x28).value();
+    cf->set_address(0x28);
+    cf->set_state(CFState::Online);
+
+    // Each received request answers with one bulk and one urgent frame
+    nm.register_pgn_callback(PGN_REQUEST, [&](const Message &) {
+        Frame bulk;
+        bulk.id = Identifier::encode(Priority::Lowest, 0xFF10, 0x28, BROADCAST_ADDRESS);
+        nm.send_frame(bulk, 0);
+        Frame urgent;
+        urgent.id = Identifier::encode(Priority::Normal, 0xFF20, 0x28, BROADCAST_ADDRESS);
+        nm.send_frame(urgent, 0);
+        CHECK(nm.tx_pending(0) >= 2); // queued, not yet written
+    });
+
+    Frame req;
+    req.id = Identifier::encode(Priority::Normal, PGN_REQUEST, 0x30, BROADCAST_ADDRESS);
+    link->inject_isobus(req);
+    link->inject_isobus(req);
+
+    nm.update(10);
+
+    CHECK(nm.tx_pending(0) == 0);
+    auto sent = link->transmitted_isobus();
+    REQUIRE(sent.size() == 4);
+    CHECK(sent[0].id.pgn() == 0xFF20);
+    CHECK(sent[1].id.pgn() == 0xFF20);
+    CHECK(sent[2].id.pgn() == 0xFF10);
+    CHECK(sent[3].id.pgn() == 0xFF10);
+    CHECK(nm.tx_dropped() == 0);
+}
+
+TEST_CASE("IsoNet drops queued frames for ports without an endpoint") {
+    IsoNet nm;
+    nm.register_pgn_callback(PGN_REQUEST, [&](const Message &) {
+        Frame f;
+        f.id = Identifier::encode(Priority::Normal, 0xFF20, 0x28, BROADCAST_ADDRESS);
+        nm.send_frame(f, 3);
+    });
+
+    auto link = std::make_shared<MockLink>();
+    wirebit::CanEndpoint ep(link, wirebit::CanConfig{}, 1);
+    nm.set_endpoint(0, &ep);
+
+    Frame req;
+    req.id = Identifier::encode(Priority::Normal, PGN_REQUEST, 0x30, BROADCAST_ADDRESS);
+    link->inject_isobus(req);
+    nm.update(10);
+
+    CHECK(nm.tx_dropped() == 1);
+    CHECK(link->tx_count() == 0);
+}
+
+TEST_CASE("IsoNet TX scheduler protects urgent frames from bulk traffic") {
+    auto link = std::make_shared<MockLink>();
+    wirebit::CanEndpoint ep(link, wirebit::CanConfig{}, 1);
+
+    IsoNet nm(NetworkConfig{}.bus_load(false).tx_load_limit(10.0f));
+    nm.set_endpoint(0, &ep);
+
+    constexpr PGN BULK = 0xFF10;
+    constexpr PGN STEER = 0xAD00;
+    nm.register_pgn_callback(PGN_REQUEST, [&](const Message &) {
+        for (int i = 0; i < 40; ++i) {
+            Frame bulk;
+            bulk.id = Identifier::encode(Priority::Lowest, BULK, 0x28, BROADCAST_ADDRESS);
+            nm.send_frame(bulk, 0);
+        }
+        Frame steer;
+        steer.id = Identifier::encode(Priority::Normal, STEER, 0x28, BROADCAST_ADDRESS);
+        nm.send_frame(steer, 0);
+    });
+
+    Frame req;
+    req.id = Identifier::encode(Priority::Normal, PGN_REQUEST, 0x30, BROADCAST_ADDRESS);
+    link->inject_isobus(req);
+    nm.update(0);
+
+    auto sent = link->transmitted_isobus();
+    REQUIRE(!sent.empty());
+    CHECK(sent[0].id.pgn() == STEER);
+    CHECK(sent.size() < 41);          // bucket held part of the bulk back
+    CHECK(nm.tx_pending(0) == 41 - sent.size());
+
+    // Enough time drains the backlog
+    for (int i = 0; i < 10; ++i)
+        nm.update(100);
+    CHECK(nm.tx_pending(0) == 0);
+    CHECK(link->transmitted_isobus().size() == 41);
+}
+
+TEST_CASE("IsoNet per-PGN TX rate limit") {
+    auto link = std::make_shared<MockLink>();
+    wirebit::CanEndpoint ep(link, wirebit::CanConfig{}, 1);
+
+    IsoNet nm;
+    nm.set_endpoint(0, &ep);
+    nm.set_tx_rate_limit(0xFF30, 100);
+
+    nm.register_pgn_callback(PGN_REQUEST, [&](const Message &) {
+        for (int i = 0; i < 3; ++i) {
+            Frame f;
+            f.id = Identifier::encode(Priority::Default, 0xFF30, 0x28, BROADCAST_ADDRESS);
+            f.data[0] = static_cast<u8>(i);
+            nm.send_frame(f, 0);
+        }
+    });
+
+    Frame req;
+    req.id = Identifier::encode(Priority::Normal, PGN_REQUEST, 0x30, BROADCAST_ADDRESS);
+    link->inject_isobus(req);
+    nm.update(10);
+    CHECK(link->tx_count() == 1);
+
+    nm.update(50);
+    CHECK(link->tx_count() == 1);
+    nm.update(50);
+    CHECK(link->tx_count() == 2);
+    nm.update(100);
+    auto sent = link->transmitted_isobus();
+    REQUIRE(sent.size() == 3);
+    CHECK(sent[0].data[0] == 0);
+    CHECK(sent[1].data[0] == 1);
+    CHECK(sent[2].data[0] == 2);
+}
+
+TEST_CASE("IsoNet keeps frames the driver refuses and retries them in order") {
+    auto link = std::make_shared<BusyMockLink>();
+    wirebit::CanEndpoint ep(link, wirebit::CanConfig{}, 1);
+
+    IsoNet nm(NetworkConfig{}.bus_load(false).tx_backlog(4, 2));
+    nm.set_endpoint(0, &ep);
+
+    link->busy = true;
+    for (u8 i = 0; i < 4; ++i) {
+        Frame f;
+        f.id = Identifier::encode(Priority::Default, 0xFF10, 0x28, BROADCAST_ADDRESS);
+        f.data[0] = i;
+        CHECK(nm.send_frame(f, 0).is_ok());
+    }
+    CHECK(nm.tx_pending(0) == 4);
+    CHECK(nm.tx_retries() >= 1);
+    CHECK(nm.next_deadline_ms() <= 1);
+
+    // Past the limit a frame is refused rather than queued
+    Frame extra;
+    extra.id = Identifier::encode(Priority::Default, 0xFF10, 0x28, BROADCAST_ADDRESS);
+    auto full = nm.send_frame(extra, 0);
+    REQUIRE(full.is_err());
+    CHECK(full.error().code == ErrorCode::NoResources);
+    CHECK(nm.tx_dropped() == 1);
+
+    link->busy = false;
+    nm.update(1);
+    CHECK(nm.tx_pending(0) == 0);
+    auto sent = link->transmitted_isobus();
+    REQUIRE(sent.size() == 4);
+    for (u8 i = 0; i < 4; ++i)
+        CHECK(sent[i].data[0] == i);
+}
+
+TEST_CASE("IsoNet pauses TP data while the port's TX queue is backed up") {
+    auto link = std::make_shared<BusyMockLink>();
+    wirebit::CanEndpoint ep(link, wirebit::CanConfig{}, 1);
+
+    IsoNet nm(NetworkConfig{}.bus_load(false).tx_backlog(64, 2));
+    nm.set_endpoint(0, &ep);
+    Name name;
+    name.set_identity_number(7);
+    auto *cf = nm.create_internal(name, 0, 0x28).value();
+    cf->set_address(0x28);
+    cf->set_state(CFState::Online);
+
+    ControlFunction dest;
+    dest.address = 0x30;
+    dp::Vector<u8> data(20, 0x66); // 3 packets
+    REQUIRE(nm.send(0xCB00, data, cf, &dest).is_ok()); // RTS
+    link->clear_tx();
+
+    // The driver fills up before the CTS arrives
+    link->busy = true;
+    for (u8 i = 0; i < 2; ++i) {
+        Frame f;
+        f.id = Identifier::encode(Priority::Lowest, 0xFF10, 0x28, BROADCAST_ADDRESS);
+        nm.send_frame(f, 0);
+    }
+    Frame cts;
+    cts.id = Identifier::encode(Priority::Lowest, PGN_TP_CM, 0x30, 0x28);
+    cts.data = {tp_cm::CTS, 3, 1, 0xFF, 0xFF, 0x00, 0xCB, 0x00};
+    link->inject_isobus(cts);
+    nm.update(1);
+    CHECK(nm.tx_pending(0) == 2); // No DT frames piled on top
+
+    link->busy = false;
+    for (int i = 0; i < 3; ++i)
+        nm.update(1);
+    CHECK(nm.tx_pending(0) == 0);
+    usize dts = 0;
+    for (const auto &f : link->transmitted_isobus()) {
+        if (f.id.pgn() == PGN_TP_DT)
+            CHECK(f.data[0] == ++dts);
+    }
+    CHECK(dts == 3);
+}
+
+TEST_CASE("IsoNet holds TP through a bus-off and re-claims when the controller restarts") {
+    auto link = std::make_shared<MockLink>();
+    wirebit::CanEndpoint ep(link, wirebit::CanConfig{}, 1);
+
+    IsoNet nm(NetworkConfig{}.bus_load(false));
+    nm.set_endpoint(0, &ep);
+    dp::Vector<can_frame> rx;
+    nm.set_rx_source(0, [&](can_frame &cf) {
+        if (rx.empty())
+            return false;
+        cf = rx.front();
+        rx.erase(rx.begin());
+        return true;
+    });
+    auto *cf = nm.create_internal(Name::build().set_identity_number(7), 0, 0x28).value();
+    REQUIRE(nm.start_address_claiming().is_ok());
+    nm.update(300);
+    REQUIRE(cf->claim_state() == ClaimState::Claimed);
+
+    ControlFunction dest;
+    dest.address = 0x30;
+    dp::Vector<u8> data(20, 0x66);
+    REQUIRE(nm.send(0xCB00, data, cf, &dest).is_ok()); // RTS, now waiting for a CTS
+    link->clear_tx();
+    dp::Vector<CanBusState> states;
+    nm.on_bus_state.subscribe([&](u8, CanBusState state) { states.push_back(state); });
+
+    can_frame err{};
+    err.can_id = CAN_ERR_FLAG | CAN_ERR_BUSOFF;
+    err.can_dlc = CAN_ERR_DLC;
+    rx.push_back(err);
+    nm.update(1);
+    CHECK(nm.bus_off(0));
+    CHECK(nm.bus_state(0) == CanBusState::BusOff);
+    CHECK(nm.transport_protocol().port_held(0));
+
+    // Past T3, but the session's timers stand still; sent frames wait in the queue
+    Frame f;
+    f.id = Identifier::encode(Priority::Default, 0xFF10, 0x28, BROADCAST_ADDRESS);
+    CHECK(nm.send_frame(f, 0).is_ok());
+    nm.update(1000);
+    nm.update(500);
+    CHECK(nm.transport_protocol().active_sessions().size() == 1);
+    CHECK(nm.tx_pending(0) == 1);
+    CHECK(link->transmitted_isobus().empty());
+
+    err.can_id = CAN_ERR_FLAG | CAN_ERR_RESTARTED;
+    rx.push_back(err);
+    nm.update(1);
+    CHECK_FALSE(nm.bus_off(0));
+    CHECK_FALSE(nm.transport_protocol().port_held(0));
+    REQUIRE(states.size() == 2);
+    CHECK(states[1] == CanBusState::ErrorActive);
+    CHECK(nm.can_errors(0)->bus_off == 1);
+    CHECK(nm.can_errors(0)->restarts == 1);
+    CHECK(nm.tx_pending(0) == 0);
+    bool claimed = false;
+    for (const auto &sent : link->transmitted_isobus()) {
+        if (sent.id.pgn() == PGN_ADDRESS_CLAIMED && sent.id.source() == 0x28)
+            claimed = true;
+    }
+    CHECK(claimed);
+}
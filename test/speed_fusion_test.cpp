@@ -0,0 +1,92 @@
+#include <doctest/doctest.h>
+#include <agrobus/isobus/implement/speed_distance.hpp>
+#include <agrobus/isobus/implement/speed_fusion.hpp>
+#include <agrobus/net/loopback_bus.hpp>
+
+using namespace agrobus::isobus::implement;
+
+TEST_CASE("SpeedFusion picks the preferred fresh input and integrates at receive time") {
+    IsoNet nm;
+    SpeedFusion fusion(nm);
+
+    fusion.add_sample(SpeedInput::WheelBased, 2.0, 0, MachineDirection::Forward);
+    CHECK(fusion.reading().source == SpeedInput::WheelBased);
+    CHECK(fusion.distance_m() == doctest::Approx(0.0));
+
+    // Radar comes up: preferred over the wheels from here on
+    fusion.add_sample(SpeedInput::GroundBased, 1.9, 50000);
+    CHECK(fusion.reading().source == SpeedInput::GroundBased);
+    CHECK(fusion.distance_m() == doctest::Approx(0.05 * 1.95));
+
+    fusion.add_sample(SpeedInput::WheelBased, 2.2, 100000); // Not used while radar is fresh
+    fusion.add_sample(SpeedInput::GroundBased, 1.9, 150000);
+    CHECK(fusion.distance_m() == doctest::Approx(0.0975 + 0.19));
+    CHECK(fusion.speed_mps() == doctest::Approx(1.9));
+
+    // Radar goes quiet past the stale time: the wheels take over from its last sample
+    fusion.add_sample(SpeedInput::WheelBased, 2.0, 500000, MachineDirection::Forward);
+    auto r = fusion.reading();
+    CHECK(r.source == SpeedInput::WheelBased);
+    CHECK(r.direction == MachineDirection::Forward);
+    CHECK(r.distance_m == doctest::Approx(0.2875 + 0.35 * 1.95));
+    CHECK(r.distance_at(600000) == doctest::Approx(r.distance_m + 0.2));
+    CHECK(fusion.source_switches() == 3);
+
+    fusion.add_sample(SpeedInput::WheelBased, 9.0, 400000); // Older than the newest: dropped
+    CHECK(fusion.input_speed(SpeedInput::WheelBased).value() == doctest::Approx(2.0));
+    CHECK_FALSE(fusion.input_speed(SpeedInput::Gnss).has_value());
+
+    fusion.reset_distance();
+    CHECK(fusion.distance_m() == 0.0);
+}
+
+TEST_CASE("SpeedFusion honours the configured preference and gap limit") {
+    IsoNet nm;
+    SpeedFusion fusion(nm, SpeedFusionConfig{}.prefer(SpeedInput::Gnss, SpeedInput::WheelBased).max_gap(200));
+
+    fusion.add_sample(SpeedInput::GroundBased, 3.0, 0); // Not listed: never chosen
+    CHECK(fusion.reading().source == SpeedInput::None);
+
+    fusion.add_sample(SpeedInput::Gnss, 1.0, 0);
+    fusion.add_sample(SpeedInput::Gnss, 1.0, 1000000); // A 1 s hole counts as 200 ms
+    CHECK(fusion.reading().source == SpeedInput::Gnss);
+    CHECK(fusion.distance_m() == doctest::Approx(0.2));
+}
+
+TEST_CASE("SpeedFusion decodes TECU and GNSS speed from the bus") {
+    IsoNet tecu, implement;
+    auto *tecu_cf = tecu.create_internal(Name::build().set_identity_number(1), 0, 0x10).value();
+    implement.create_internal(Name::build().set_identity_number(2), 0, 0x80);
+    LoopbackBus bus;
+    bus.attach(tecu);
+    bus.attach(implement);
+    REQUIRE(tecu.start_address_claiming().is_ok());
+    REQUIRE(implement.start_address_claiming().is_ok());
+    auto run = [&](u32 steps) {
+        for (u32 i = 0; i < steps; ++i) {
+            tecu.update(10);
+            implement.update(10);
+        }
+    };
+    run(40);
+
+    SpeedFusion fusion(implement);
+    REQUIRE(fusion.initialize().is_ok());
+    u32 updates = 0;
+    fusion.on_update.subscribe([&](const OdometerReading &) { ++updates; });
+
+    TECUSpeedDistance speed(tecu, tecu_cf);
+    WheelBasedSpeedDist wheel;
+    wheel.speed_mps = 2.5;
+    wheel.direction = MachineDirection::Reverse;
+    REQUIRE(speed.send_wheel_speed(wheel).is_ok());
+    dp::Vector<u8> cog_sog{0xFF, 0xFC, 0x00, 0x00, 0x2C, 0x01, 0xFF, 0xFF}; // 3.00 m/s
+    REQUIRE(tecu.send(PGN_GNSS_COG_SOG_RAPID, cog_sog, tecu_cf).is_ok());
+    run(4);
+
+    CHECK(updates == 1); // GNSS is ranked below the wheels, which are fresh
+    CHECK(fusion.reading().source == SpeedInput::WheelBased);
+    CHECK(fusion.speed_mps() == doctest::Approx(2.5));
+    CHECK(fusion.reading().direction == MachineDirection::Reverse);
+    CHECK(fusion.input_speed(SpeedInput::Gnss).value() == doctest::Approx(3.0));
+}
@@ -0,0 +1,60 @@
+#include <doctest/doctest.h>
+#include <agrobus/net/spsc_ring.hpp>
+#include <thread>
+
+using namespace agrobus::net;
+
+TEST_CASE("SpscRing rounds capacity up to a power of two") {
+    SpscRing<u32> ring(100);
+    CHECK(ring.capacity() == 128);
+    CHECK(ring.empty());
+}
+
+TEST_CASE("SpscRing is FIFO and counts drops when full") {
+    SpscRing<u32> ring(4);
+    for (u32 i = 0; i < 4; ++i) {
+        CHECK(ring.try_push(i));
+    }
+    CHECK_FALSE(ring.try_push(99));
+    CHECK(ring.dropped() == 1);
+    CHECK(ring.size() == 4);
+
+    u32 v = 0;
+    for (u32 i = 0; i < 4; ++i) {
+        REQUIRE(ring.try_pop(v));
+        CHECK(v == i);
+    }
+    CHECK_FALSE(ring.try_pop(v));
+
+    // Wrap around
+    CHECK(ring.try_push(7));
+    REQUIRE(ring.try_pop(v));
+    CHECK(v == 7);
+}
+
+TEST_CASE("SpscRing hands values across threads in order") {
+    SpscRing<u32> ring(64);
+    constexpr u32 COUNT = 20000;
+
+    std::thread producer([&]() {
+        for (u32 i = 0; i < COUNT;) {
+            if (ring.try_push(i))
+                ++i;
+        }
+    });
+
+    u32 expected = 0;
+    bool ordered = true;
+    while (expected < COUNT) {
+        u32 v;
+        if (ring.try_pop(v)) {
+            if (v != expected)
+                ordered = false;
+            ++expected;
+        }
+    }
+    producer.join();
+
+    CHECK(ordered);
+    CHECK(ring.empty());
+}
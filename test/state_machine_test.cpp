@@ -0,0 +1,123 @@
+#include <doctest/doctest.h>
+#include <agrobus/isobus/tc/client.hpp>
+#include <agrobus/isobus/tc/server.hpp>
+#include <agrobus/net/loopback_bus.hpp>
+#include <agrobus/net/state_machine.hpp>
+
+using namespace agrobus::net;
+
+namespace {
+    enum class Light : u8 { Off, Warming, On };
+    constexpr usize state_count(Light) { return 3; }
+
+    enum class Untimed { A, B };
+} // namespace
+
+static_assert(StateMachine<Light>::TIMED);
+static_assert(!StateMachine<Untimed>::TIMED);
+
+TEST_CASE("StateMachine - time per state and transition counts") {
+    StateMachine<Light> sm(Light::Off);
+    u32 seen = 0;
+    sm.on_transition.subscribe([&](Light, Light) { ++seen; });
+
+    sm.advance(10);
+    sm.transition(Light::Warming);
+    sm.advance(30);
+    sm.advance(20);
+    CHECK(sm.time_in_state() == 50);
+    sm.transition(Light::On);
+    sm.advance(5);
+    sm.transition(Light::Off);
+    sm.transition(Light::Warming);
+    sm.transition(Light::Warming); // Same state: not a transition
+    sm.advance(15);
+
+    CHECK(seen == 4);
+    CHECK(sm.time_in(Light::Off) == 10);
+    CHECK(sm.time_in(Light::Warming) == 65);
+    CHECK(sm.time_in(Light::On) == 5);
+    CHECK(sm.transitions(Light::Off, Light::Warming) == 2);
+    CHECK(sm.transitions(Light::Warming, Light::On) == 1);
+    CHECK(sm.transitions(Light::On, Light::Warming) == 0);
+    CHECK(sm.entries(Light::Warming) == 2);
+    CHECK(sm.entries(Light::Off) == 1);
+
+    auto summary = sm.summary();
+    REQUIRE(summary.size() == 3);
+    CHECK(summary[0].state == Light::Warming);
+    CHECK(summary[0].time_ms == 65);
+    CHECK(summary[0].entries == 2);
+    CHECK(summary[2].state == Light::On);
+
+    sm.set_timing(false);
+    sm.advance(100);
+    sm.transition(Light::On);
+    CHECK(sm.time_in(Light::Warming) == 65);
+    CHECK(sm.transitions(Light::Warming, Light::On) == 1);
+    CHECK(sm.time_in_state() == 0);
+
+    sm.reset_timing();
+    CHECK(sm.summary().empty());
+}
+
+TEST_CASE("StateMachine - enums without a count only track the state") {
+    StateMachine<Untimed> sm(Untimed::A);
+    sm.advance(10);
+    sm.transition(Untimed::B);
+    CHECK(sm.is(Untimed::B));
+    CHECK_FALSE(sm.timing());
+    CHECK(sm.time_in(Untimed::A) == 0);
+    CHECK(sm.transitions(Untimed::A, Untimed::B) == 0);
+    CHECK(sm.summary().empty());
+    CHECK(sm.time_in_state() == 0);
+}
+
+TEST_CASE("StateMachine - a TC client's connect by state") {
+    using namespace agrobus::isobus::tc;
+    LoopbackBus bus;
+    IsoNet nm_tc;
+    IsoNet nm_ecu;
+    auto *tc_cf = nm_tc.create_internal(Name::build().set_identity_number(1), 0, 0xF7).value();
+    auto *ecu_cf = nm_ecu.create_internal(Name::build().set_identity_number(2), 0, 0x80).value();
+    bus.attach(nm_tc);
+    bus.attach(nm_ecu);
+    REQUIRE(nm_tc.start_address_claiming().is_ok());
+    REQUIRE(nm_ecu.start_address_claiming().is_ok());
+
+    TaskControllerServer server(nm_tc, tc_cf);
+    REQUIRE(server.start().is_ok());
+    TaskControllerClient client(nm_ecu, ecu_cf);
+    DDOP ddop;
+    DeviceObject device;
+    device.id = 1;
+    device.designator = "Seeder";
+    ddop.add_device(device);
+    DeviceElement root;
+    root.id = 2;
+    root.type = DeviceElementType::Device;
+    root.parent_id = 1;
+    ddop.add_element(root);
+    client.set_ddop(std::move(ddop));
+
+    for (u32 i = 0; i < 60; ++i) {
+        nm_tc.update(5);
+        nm_ecu.update(5);
+    }
+    REQUIRE(client.connect().is_ok());
+    for (u32 i = 0; i < 600 && client.state() != TCState::Connected; ++i) {
+        nm_tc.update(5);
+        nm_ecu.update(5);
+        server.update(5);
+        client.update(5);
+    }
+    REQUIRE(client.state() == TCState::Connected);
+
+    const auto &sm = client.state_machine();
+    CHECK(sm.transitions(TCState::Disconnected, TCState::WaitForServerStatus) == 1);
+    CHECK(sm.entries(TCState::Connected) == 1);
+    CHECK(sm.time_in(TCState::WaitForServerStatus) > 0); // Waited for the next TC status
+    auto summary = sm.summary();
+    REQUIRE_FALSE(summary.empty());
+    CHECK(summary[0].state == TCState::WaitForServerStatus);
+}
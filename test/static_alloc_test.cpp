@@ -0,0 +1,94 @@
+#define AGROBUS_STATIC_ALLOC 1
+#define AGROBUS_MAX_EVENT_LISTENERS 2
+#define AGROBUS_MAX_INTERNAL_CFS 1
+#define AGROBUS_MAX_TRANSPORT_SESSIONS 2
+#define AGROBUS_MAX_SCHEDULER_TASKS 2
+#define AGROBUS_MAX_POOL_OBJECTS 2
+#define AGROBUS_MAX_DDOP_OBJECTS 2
+#include <doctest/doctest.h>
+#include <agrobus/isobus/tc/ddop.hpp>
+#include <agrobus/isobus/vt/objects.hpp>
+#include <agrobus/net/buffer_pool.hpp>
+#include <agrobus/net/event.hpp>
+#include <agrobus/net/network_manager.hpp>
+#include <agrobus/net/scheduler.hpp>
+
+using namespace agrobus::net;
+
+TEST_CASE("Static profile: event listeners stop at their capacity") {
+    static_assert(static_alloc::enabled);
+    Event<int> event;
+    int calls = 0;
+    ListenerToken a = event.subscribe([&](int) { ++calls; });
+    CHECK(event.try_subscribe([&](int) { ++calls; }).is_ok());
+
+    CHECK(event.subscribe([&](int) { ++calls; }) == INVALID_TOKEN);
+    auto full = event.try_subscribe([&](int) { ++calls; });
+    REQUIRE(full.is_err());
+    CHECK(full.error().code == ErrorCode::NoResources);
+
+    event.emit(1);
+    CHECK(calls == 2);
+
+    // A freed slot is usable again
+    CHECK(event.unsubscribe(a));
+    CHECK(event.subscribe([&](int) { ++calls; }) != INVALID_TOKEN);
+    CHECK(event.count() == 2);
+}
+
+TEST_CASE("Static profile: scheduler, CFs, pools and DDOPs report a full table") {
+    Scheduler scheduler;
+    CHECK(scheduler.try_add("a", 100, [] { return true; }).is_ok());
+    CHECK(scheduler.try_add("b", 100, [] { return true; }).is_ok());
+    CHECK(scheduler.try_add("c", 100, [] { return true; }).is_err());
+    CHECK(scheduler.count() == 2);
+
+    IsoNet net;
+    CHECK(net.create_internal(Name::build().set_identity_number(1), 0, 0x80).is_ok());
+    auto second = net.create_internal(Name::build().set_identity_number(2), 0, 0x81);
+    REQUIRE(second.is_err());
+    CHECK(second.error().code == ErrorCode::NoResources);
+
+    agrobus::isobus::vt::ObjectPool pool;
+    using agrobus::isobus::vt::ObjectType;
+    using agrobus::isobus::vt::VTObject;
+    CHECK(pool.add(VTObject().set_id(0).set_type(ObjectType::WorkingSet)).is_ok());
+    CHECK(pool.add(VTObject().set_id(1).set_type(ObjectType::DataMask)).is_ok());
+    CHECK(pool.add(VTObject().set_id(2).set_type(ObjectType::DataMask)).is_err());
+    CHECK(pool.size() == 2);
+
+    namespace tc = agrobus::isobus::tc;
+    tc::DDOP ddop;
+    tc::DeviceObject dev;
+    dev.designator = "Sprayer";
+    CHECK(ddop.add_device(dev).is_ok());
+    tc::DeviceElement elem;
+    CHECK(ddop.add_element(elem).is_ok());
+    CHECK(ddop.add_element(elem).is_err());
+    CHECK(ddop.object_count() == 2);
+}
+
+TEST_CASE("Static profile: transport sessions come from reserved buffers") {
+    CHECK(TransportProtocol::DEFAULT_SESSIONS == 2);
+
+    // Small requests borrow the reserved TP-sized buffers instead of allocating
+    BufferPool pool(2, 1);
+    pool.reserve(BufferPool::class_for(TP_MAX_DATA_LENGTH), 2);
+    auto first = pool.acquire(40);
+    auto second = pool.acquire(300);
+    CHECK(first.size() == 40);
+    CHECK(second.size() == 300);
+    CHECK(pool.stats().hits == 2);
+    CHECK(pool.stats().misses == 0);
+    pool.release(std::move(first));
+    CHECK(pool.cached(BufferPool::class_for(TP_MAX_DATA_LENGTH)) == 1);
+
+    // ETP refuses a send beyond its session capacity
+    ExtendedTransportProtocol etp;
+    dp::Vector<u8> data(2000, 0x55);
+    CHECK(etp.send(0xEF00, data, 0x80, 0x26).is_ok());
+    CHECK(etp.send(0xEF01, data, 0x80, 0x26).is_ok());
+    auto third = etp.send(0xEF02, data, 0x80, 0x26);
+    REQUIRE(third.is_err());
+    CHECK(third.error().code == ErrorCode::NoResources);
+}
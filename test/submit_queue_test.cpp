@@ -0,0 +1,171 @@
+#include <doctest/doctest.h>
+#include <agrobus/net/loopback_bus.hpp>
+#include <agrobus/net/mpsc_queue.hpp>
+#include <agrobus/net/network_manager.hpp>
+#include <chrono>
+#include <thread>
+
+using namespace agrobus::net;
+
+TEST_CASE("MpscQueue - every producer's values arrive once, in each producer's order") {
+    MpscQueue<u64> q(64);
+    CHECK(q.capacity() == 64);
+    constexpr u32 PRODUCERS = 4;
+    constexpr u64 EACH = 20000;
+
+    dp::Vector<std::thread> producers;
+    for (u32 p = 0; p < PRODUCERS; ++p) {
+        producers.emplace_back([&q, p] {
+            for (u64 i = 0; i < EACH; ++i) {
+                u64 v = static_cast<u64>(p) << 32 | i;
+                while (!q.try_push(std::move(v)))
+                    std::this_thread::yield();
+            }
+        });
+    }
+
+    dp::Array<u64, PRODUCERS> next{};
+    u64 received = 0;
+    bool ordered = true;
+    while (received < PRODUCERS * EACH) {
+        u64 v;
+        if (!q.try_pop(v)) {
+            std::this_thread::yield();
+            continue;
+        }
+        u32 p = static_cast<u32>(v >> 32);
+        ordered = ordered && (v & 0xFFFFFFFFu) == next[p];
+        next[p] = (v & 0xFFFFFFFFu) + 1;
+        ++received;
+    }
+    for (auto &t : producers)
+        t.join();
+    CHECK(ordered);
+    CHECK(q.empty());
+
+    MpscQueue<u64> small(2);
+    u64 a = 1, b = 2, c = 3;
+    CHECK(small.try_push(std::move(a)));
+    CHECK(small.try_push(std::move(b)));
+    CHECK_FALSE(small.try_push(std::move(c)));
+    CHECK(small.dropped() == 1);
+}
+
+namespace {
+    struct Pair {
+        LoopbackBus bus;
+        IsoNet tx{NetworkConfig{}.submit_queue(64)};
+        IsoNet rx;
+        InternalCF *tx_cf = nullptr;
+
+        Pair() {
+            tx_cf = tx.create_internal(Name::build().set_identity_number(1), 0, 0x20).value();
+            rx.create_internal(Name::build().set_identity_number(2), 0, 0x30);
+            bus.attach(tx);
+            bus.attach(rx);
+            tx.start_address_claiming();
+            rx.start_address_claiming();
+            run(60);
+        }
+
+        void run(u32 steps) {
+            for (u32 i = 0; i < steps; ++i) {
+                tx.update(10);
+                rx.update(10);
+            }
+        }
+    };
+} // namespace
+
+TEST_CASE("IsoNet - submit() from other threads goes out in the next update") {
+    Pair p;
+    REQUIRE(p.tx_cf->claim_state() == ClaimState::Claimed);
+    u32 got = 0;
+    u64 sum = 0;
+    REQUIRE(p.rx.register_pgn_callback(0xFF10, [&](const Message &m) {
+                    ++got;
+                    sum += m.data[0];
+                }).is_ok());
+
+    dp::Vector<std::thread> threads;
+    for (u8 t = 0; t < 3; ++t) {
+        threads.emplace_back([&p, t] {
+            for (u8 i = 0; i < 10; ++i) {
+                while (!p.tx.submit(0xFF10, dp::Vector<u8>(8, static_cast<u8>(t * 10 + i)), p.tx_cf).is_ok())
+                    std::this_thread::yield();
+            }
+        });
+    }
+    for (auto &t : threads)
+        t.join();
+    CHECK(p.tx.next_deadline_ms() == 0); // Queued sends wake the loop
+    p.run(3);
+    CHECK(got == 30);
+    CHECK(sum == 435); // 0 + 1 + ... + 29
+
+    // Off by default
+    IsoNet plain;
+    CHECK_FALSE(plain.submit(0xFF10, dp::Vector<u8>(8), p.tx_cf).is_ok());
+}
+
+TEST_CASE("IsoNet - submit_async() completes when the transfer is acknowledged") {
+    Pair p;
+    dp::Vector<u8> received;
+    REQUIRE(p.rx.register_pgn_callback(0xEF00, [&](const Message &m) { received = m.data; }).is_ok());
+
+    dp::Vector<u8> payload(300);
+    for (usize i = 0; i < payload.size(); ++i)
+        payload[i] = static_cast<u8>(i);
+    std::future<Result<void>> done;
+    std::thread([&] { done = p.tx.submit_async(0xEF00, payload, p.tx_cf, 0x30); }).join();
+
+    p.run(1);
+    CHECK(done.wait_for(std::chrono::seconds(0)) == std::future_status::timeout); // RTS out, not acknowledged yet
+    for (u32 i = 0; i < 100 && done.wait_for(std::chrono::seconds(0)) != std::future_status::ready; ++i)
+        p.run(1);
+    REQUIRE(done.wait_for(std::chrono::seconds(0)) == std::future_status::ready);
+    CHECK(done.get().is_ok());
+    CHECK(received == payload);
+
+    // A send that fails on the network thread reports through the future
+    auto failed = p.tx.submit_async(0xEF00, dp::Vector<u8>(3000), p.tx_cf); // ETP cannot broadcast
+    p.run(1);
+    REQUIRE(failed.wait_for(std::chrono::seconds(0)) == std::future_status::ready);
+    CHECK_FALSE(failed.get().is_ok());
+
+    // A full queue refuses at once
+    IsoNet tiny(NetworkConfig{}.submit_queue(2));
+    CHECK(tiny.submit(0xFF10, dp::Vector<u8>(8), p.tx_cf).is_ok());
+    CHECK(tiny.submit(0xFF10, dp::Vector<u8>(8), p.tx_cf).is_ok());
+    auto refused = tiny.submit_async(0xFF10, dp::Vector<u8>(8), p.tx_cf);
+    REQUIRE(refused.wait_for(std::chrono::seconds(0)) == std::future_status::ready);
+    CHECK(refused.get().error().code == ErrorCode::BufferOverflow);
+    CHECK(tiny.submits_dropped() == 1);
+}
+
+TEST_CASE("IsoNet - submit_async() futures fail on the deadline and when the IsoNet goes away") {
+    LoopbackBus bus;
+    auto tx = std::make_unique<IsoNet>(NetworkConfig{}.submit_queue(8, 100));
+    auto *cf = tx->create_internal(Name::build().set_identity_number(1), 0, 0x20).value();
+    bus.attach(*tx);
+    tx->start_address_claiming();
+    for (u32 i = 0; i < 60; ++i)
+        tx->update(10);
+    REQUIRE(cf->claim_state() == ClaimState::Claimed);
+
+    // Nobody at 0x30 answers the RTS; the wait ends after submit_timeout_ms
+    auto late = tx->submit_async(0xEF00, dp::Vector<u8>(300), cf, 0x30);
+    tx->update(10);
+    CHECK(late.wait_for(std::chrono::seconds(0)) == std::future_status::timeout);
+    for (u32 i = 0; i < 10; ++i)
+        tx->update(10);
+    REQUIRE(late.wait_for(std::chrono::seconds(0)) == std::future_status::ready);
+    CHECK(late.get().error().code == ErrorCode::Timeout);
+
+    auto orphaned = tx->submit_async(0xEF01, dp::Vector<u8>(300), cf, 0x31);
+    tx->update(10);
+    CHECK(orphaned.wait_for(std::chrono::seconds(0)) == std::future_status::timeout);
+    tx.reset();
+    REQUIRE(orphaned.wait_for(std::chrono::seconds(0)) == std::future_status::ready);
+    CHECK(orphaned.get().error().code == ErrorCode::NotConnected);
+}
@@ -1,5 +1,7 @@
 #include <doctest/doctest.h>
 #include <agrobus/isobus/tc/client.hpp>
+#include <agrobus/isobus/tc/server.hpp>
+#include <agrobus/net/loopback_bus.hpp>
 
 using namespace agrobus::isobus;
 using namespace agrobus::isobus::tc;
@@ -87,3 +89,129 @@ TEST_CASE("TaskControllerClient callbacks") {
         CHECK(!called);
     }
 }
+
+TEST_CASE("TaskControllerClient reuses the pool stored on the TC") {
+    LoopbackBus bus;
+    IsoNet nm_tc;
+    IsoNet nm_ecu;
+    auto *tc_cf = nm_tc.create_internal(Name::build().set_identity_number(1), 0, 0xF7).value();
+    auto *ecu_cf = nm_ecu.create_internal(Name::build().set_identity_number(2), 0, 0x80).value();
+    bus.attach(nm_tc);
+    bus.attach(nm_ecu);
+    REQUIRE(nm_tc.start_address_claiming().is_ok());
+    REQUIRE(nm_ecu.start_address_claiming().is_ok());
+
+    TaskControllerServer server(nm_tc, tc_cf, TCServerConfig{}.booms(1).sections(16));
+    REQUIRE(server.start().is_ok());
+    TaskControllerClient client(nm_ecu, ecu_cf);
+
+    auto labelled_ddop = [](u8 structure) {
+        DeviceObject device;
+        device.id = 1;
+        device.designator = "Sprayer";
+        device.software_version = "1.0";
+        device.set_structure_label({structure, 'S', 'P', 'R', 'A', 'Y', '1'});
+        device.set_localization_label({'e', 'n', 0, 0, 0, 0, 0xFF});
+        DeviceElement root;
+        root.id = 2;
+        root.type = DeviceElementType::Device;
+        root.parent_id = 1;
+        root.designator = "Root";
+        DDOP ddop;
+        ddop.add_device(device);
+        ddop.add_element(root);
+        return ddop;
+    };
+
+    u32 transfers = 0;
+    nm_tc.register_pgn_callback(PGN_ECU_TO_TC, [&](const Message &msg) { transfers += msg.data.size() > 8 ? 1 : 0; });
+
+    auto run = [&](u32 steps) {
+        for (u32 i = 0; i < steps; ++i) {
+            nm_tc.update(5);
+            nm_ecu.update(5);
+            server.update(5);
+            client.update(5);
+        }
+    };
+    auto connect = [&](u8 structure) {
+        client.set_ddop(labelled_ddop(structure));
+        REQUIRE(client.connect().is_ok());
+        run(600); // Waits for the next TC status
+        REQUIRE(client.state() == TCState::Connected);
+        REQUIRE(server.client(ecu_cf->address()) != nullptr);
+        CHECK(server.client(ecu_cf->address())->pool_activated);
+    };
+    run(60); // Address claims
+
+    connect('A');
+    CHECK(transfers == 1);
+    CHECK_FALSE(client.pool_reused());
+    CHECK(server.stored_pools() == 1);
+
+    // Same labels after a TC restart: activated from the stored pool
+    client.disconnect();
+    server.stop();
+    REQUIRE(server.start().is_ok());
+    connect('A');
+    CHECK(transfers == 1);
+    CHECK(client.pool_reused());
+    CHECK(server.client(ecu_cf->address())->ddop.object_count() == 2);
+
+    // A new structure label sends the pool again
+    client.disconnect();
+    connect('B');
+    CHECK(transfers == 2);
+    CHECK_FALSE(client.pool_reused());
+    REQUIRE(server.stored_pool(ecu_cf->name()) != nullptr);
+    CHECK(server.stored_pool(ecu_cf->name())->devices()[0].structure_label[0] == 'B');
+
+    server.forget_pool(ecu_cf->name());
+    CHECK(server.stored_pools() == 0);
+}
+
+TEST_CASE("TaskControllerClient connects from TC responses alone") {
+    LoopbackBus bus;
+    IsoNet nm_tc;
+    IsoNet nm_ecu;
+    auto *tc_cf = nm_tc.create_internal(Name::build().set_identity_number(1), 0, 0xF7).value();
+    auto *ecu_cf = nm_ecu.create_internal(Name::build().set_identity_number(2), 0, 0x80).value();
+    bus.attach(nm_tc);
+    bus.attach(nm_ecu);
+    REQUIRE(nm_tc.start_address_claiming().is_ok());
+    REQUIRE(nm_ecu.start_address_claiming().is_ok());
+
+    TaskControllerServer server(nm_tc, tc_cf);
+    REQUIRE(server.start().is_ok());
+    TaskControllerClient client(nm_ecu, ecu_cf);
+    DDOP ddop;
+    DeviceObject device;
+    device.id = 1;
+    device.designator = "Seeder";
+    ddop.add_device(device);
+    DeviceElement root;
+    root.id = 2;
+    root.type = DeviceElementType::Device;
+    root.parent_id = 1;
+    ddop.add_element(root);
+    client.set_ddop(std::move(ddop));
+
+    u32 wsm = 0;
+    nm_tc.register_pgn_callback(PGN_WORKING_SET_MASTER, [&](const Message &) { ++wsm; });
+    auto run_bus = [&](u32 steps) {
+        for (u32 i = 0; i < steps; ++i) {
+            nm_tc.update(5);
+            nm_ecu.update(5);
+        }
+    };
+    run_bus(60); // Address claims
+    REQUIRE(client.connect().is_ok());
+
+    // The whole sequence runs from the handlers: client.update() is never called
+    server.update(TC_STATUS_INTERVAL_MS);
+    run_bus(100);
+    CHECK(wsm == 1);
+    CHECK(client.state() == TCState::Connected);
+    REQUIRE(server.client(ecu_cf->address()) != nullptr);
+    CHECK(server.client(ecu_cf->address())->pool_activated);
+}
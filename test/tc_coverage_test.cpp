@@ -0,0 +1,132 @@
+#include <doctest/doctest.h>
+#include <agrobus/isobus/tc/coverage.hpp>
+#include <cstdio>
+
+using namespace agrobus::net;
+using namespace agrobus::isobus::tc;
+
+namespace {
+    CoverageQuad rect(f32 e0, f32 n0, f32 e1, f32 n1) { return {{e0, n0}, {e1, n0}, {e1, n1}, {e0, n1}}; }
+} // namespace
+
+TEST_CASE("CoverageMap marks swept cells") {
+    CoverageMap map(dp::Geo{48.0, 11.0, 0.0}, 0.5f);
+
+    SUBCASE("a rectangle marks the cells whose centre it holds") {
+        CHECK(map.sweep(rect(0.0f, 0.0f, 10.0f, 5.0f)) == 20 * 10);
+        CHECK(map.covered_cells() == 200);
+        CHECK(map.covered_area_m2() == doctest::Approx(50.0));
+        CHECK(map.covered({5.0f, 2.0f}));
+        CHECK_FALSE(map.covered({10.2f, 2.0f}));
+        CHECK(map.sweep(rect(0.0f, 0.0f, 10.0f, 5.0f)) == 0); // Already covered
+        CHECK(map.overlap(rect(5.0f, 0.0f, 15.0f, 5.0f)) == doctest::Approx(0.5));
+        CHECK(map.overlap(rect(20.0f, 20.0f, 30.0f, 30.0f)) == 0.0f);
+    }
+
+    SUBCASE("tile and sign boundaries") {
+        // 64 cells of 0.5 m = 32 m per tile; straddle four tiles around the origin
+        CHECK(map.sweep(rect(-40.0f, -40.0f, 40.0f, 40.0f)) == 160 * 160);
+        CHECK(map.tiles() == 16); // Tiles -2..1 on each axis
+        CHECK(map.covered({-39.9f, -39.9f}));
+        CHECK(map.covered({39.9f, 39.9f}));
+        CHECK_FALSE(map.covered({40.1f, 0.0f}));
+    }
+
+    SUBCASE("a swept turn fills its strip only once") {
+        // Section edge turning about its left end: the two sweeps share a wedge
+        CoverageQuad first = CoverageQuad::swept({0.0f, 0.0f}, {6.0f, 0.0f}, {0.0f, 2.0f}, {6.0f, 2.0f});
+        CoverageQuad back = CoverageQuad::swept({0.0f, 2.0f}, {6.0f, 2.0f}, {0.0f, 0.0f}, {6.0f, 0.0f});
+        u32 a = map.sweep(first);
+        CHECK(a == 12 * 4);
+        CHECK(map.sweep(back) == 0);
+        CHECK(map.overlap(back) == doctest::Approx(1.0));
+    }
+
+    SUBCASE("crossed edges fill even-odd") {
+        // Bow tie: the two triangles meeting at (5, 5)
+        CoverageQuad tie{{0.0f, 0.0f}, {10.0f, 10.0f}, {10.0f, 0.0f}, {0.0f, 10.0f}};
+        u32 cells = map.sweep(tie);
+        CHECK(cells > 150);
+        CHECK(cells < 250);
+        CHECK(map.covered({1.0f, 5.0f}));
+        CHECK_FALSE(map.covered({5.0f, 1.0f}));
+    }
+
+    SUBCASE("degenerate and runaway quads mark nothing") {
+        CHECK(map.sweep(rect(1.0f, 1.0f, 1.0f, 9.0f)) == 0);
+        CHECK(map.sweep(rect(0.0f, 0.0f, 1e6f, 1.0f)) == 0);
+        CHECK(map.tiles() == 0);
+    }
+
+    SUBCASE("clear") {
+        map.sweep(rect(0.0f, 0.0f, 10.0f, 5.0f));
+        map.clear();
+        CHECK(map.covered_cells() == 0);
+        CHECK(map.tiles() == 0);
+        CHECK_FALSE(map.covered({5.0f, 2.0f}));
+    }
+}
+
+TEST_CASE("CoverageMap tracks a boom") {
+    // 100 sections of 0.5 m driving north at 2 m/s, 20 Hz, over an earlier pass;
+    // a tick's thin strip of each section is marked unless the ground ahead is done
+    CoverageMap map(dp::Geo{48.0, 11.0, 0.0}, 0.25f);
+    map.sweep(rect(0.0f, 0.0f, 25.0f, 100.0f)); // Left half already applied
+
+    dp::Vector<f32> overlap(100, 0.0f);
+    for (u32 tick = 0; tick < 20; ++tick) {
+        f32 n0 = 10.0f + tick * 0.1f;
+        for (u32 s = 0; s < 100; ++s) {
+            CoverageQuad q = CoverageQuad::swept({s * 0.5f, n0}, {s * 0.5f + 0.5f, n0}, {s * 0.5f, n0 + 0.1f},
+                                                 {s * 0.5f + 0.5f, n0 + 0.1f});
+            overlap[s] = map.overlap(rect(s * 0.5f, n0 + 0.1f, s * 0.5f + 0.5f, n0 + 1.1f)); // 1 m ahead
+            if (overlap[s] < 0.5f)
+                map.sweep(q);
+        }
+    }
+    CHECK(overlap[0] == doctest::Approx(1.0));
+    CHECK(overlap[49] == doctest::Approx(1.0));
+    CHECK(overlap[50] == doctest::Approx(0.0));
+    CHECK(map.covered({40.0f, 11.0f}));
+    CHECK_FALSE(map.covered({40.0f, 13.0f}));
+}
+
+TEST_CASE("CoverageMap keeps a field in a mapped file") {
+    char path[] = "/tmp/agrobus_coverage_XXXXXX";
+    int fd = ::mkstemp(path);
+    REQUIRE(fd >= 0);
+    ::close(fd);
+    std::remove(path);
+
+    {
+        CoverageMap map(dp::Geo{52.0, 5.0, 0.0}, 0.5f);
+        REQUIRE(map.map_file(path, 8).is_ok());
+        CHECK(map.mapped());
+        CHECK(map.capacity() == 8);
+        CHECK(map.sweep(rect(0.0f, 0.0f, 10.0f, 10.0f)) == 400);
+        CHECK(map.sync().is_ok());
+
+        // Past the file's capacity new tiles are dropped
+        for (i32 i = 0; i < 10; ++i)
+            map.sweep(rect(i * 100.0f, 500.0f, i * 100.0f + 1.0f, 501.0f));
+        CHECK(map.tiles() == 8);
+    }
+
+    {
+        CoverageMap map; // Origin and cell size come from the file
+        REQUIRE(map.map_file(path, 1).is_ok());
+        CHECK(map.capacity() == 8);
+        CHECK(map.cell_size() == 0.5f);
+        CHECK(map.origin().latitude == doctest::Approx(52.0));
+        CHECK(map.tiles() == 8);
+        CHECK(map.covered({5.0f, 5.0f}));
+        CHECK(map.overlap(rect(0.0f, 0.0f, 10.0f, 10.0f)) == doctest::Approx(1.0));
+    }
+
+    {
+        CoverageMap map;
+        map.sweep(rect(0.0f, 0.0f, 1.0f, 1.0f));
+        CHECK_FALSE(map.map_file(path, 8).is_ok()); // Not empty
+    }
+    std::remove(path);
+}
@@ -0,0 +1,121 @@
+#include <doctest/doctest.h>
+#include <agrobus/isobus/tc/data_logger.hpp>
+#include <cstdio>
+
+using namespace agrobus::net;
+using namespace agrobus::isobus::tc;
+
+namespace {
+    const char *LOG_PATH = "/tmp/agrobus_tc_data_logger_test.tclog";
+} // namespace
+
+TEST_CASE("TCDataLogger writes delta-encoded blocks per series") {
+    TCDataLoggerConfig config;
+    config.block_values = 64;
+    config.initial_bytes = 4096; // Forces the file to grow
+    config.idle_us = 100;
+    TCDataLogger logger(config);
+    REQUIRE(logger.open(LOG_PATH).is_ok());
+
+    // Three series: 100 Hz steady rate, a slow ramp, a noisy negative signal
+    const u32 N = 1000;
+    for (u32 i = 0; i < N; ++i) {
+        u64 t = 1'000'000 + static_cast<u64>(i) * 10'000;
+        while (!logger.log(0x80, 1, 0x0002, 48000, t))
+            ;
+        while (!logger.log(0x80, 2, 0x0043, static_cast<i32>(i * 3), t + 5))
+            ;
+        while (!logger.log(0x81, 1, 0x0002, -static_cast<i32>((i * 7919) % 1000), t + 7))
+            ;
+    }
+    logger.close();
+    CHECK(logger.values() == 3 * N);
+    CHECK(logger.dropped() == 0);
+    CHECK_FALSE(logger.failed());
+    CHECK(logger.blocks() >= 3 * (N / 64));
+    // Steady data packs to a few bytes per value
+    CHECK(logger.bytes() < 3 * N * 4);
+
+    TCLogReader reader;
+    REQUIRE(reader.open(LOG_PATH).is_ok());
+    CHECK(reader.values() == 3 * N);
+    CHECK(reader.blocks() == logger.blocks());
+
+    dp::Vector<u32> seen(3, 0);
+    bool ok = true;
+    u64 last_ramp_t = 0;
+    auto read = reader.for_each([&](const TCLogRecord &r) {
+        if (r.client == 0x80 && r.element == 1) {
+            u32 i = seen[0]++;
+            ok &= r.value == 48000 && r.timestamp_us == 1'000'000 + static_cast<u64>(i) * 10'000;
+        } else if (r.client == 0x80 && r.element == 2) {
+            u32 i = seen[1]++;
+            ok &= r.ddi == 0x0043 && r.value == static_cast<i32>(i * 3);
+            ok &= r.timestamp_us > last_ramp_t;
+            last_ramp_t = r.timestamp_us;
+        } else if (r.client == 0x81) {
+            u32 i = seen[2]++;
+            ok &= r.value == -static_cast<i32>((i * 7919) % 1000);
+            ok &= r.timestamp_us == 1'000'000 + static_cast<u64>(i) * 10'000 + 7;
+        } else {
+            ok = false;
+        }
+    });
+    REQUIRE(read.is_ok());
+    CHECK(read.value() == 3 * N);
+    CHECK(ok);
+    CHECK(seen[0] == N);
+    CHECK(seen[1] == N);
+    CHECK(seen[2] == N);
+    reader.close();
+    std::remove(LOG_PATH);
+}
+
+TEST_CASE("TCDataLogger ingest never blocks") {
+    TCDataLoggerConfig config;
+    config.ring_records = 8;
+    TCDataLogger logger(config); // Not opened: nothing drains the ring
+    u32 queued = 0;
+    for (u32 i = 0; i < 20; ++i)
+        queued += logger.log(0x80, 0, 1, static_cast<i32>(i), i) ? 1 : 0;
+    CHECK(queued == 8);
+    CHECK(logger.dropped() == 12);
+
+    // Values queued before open() are written
+    REQUIRE(logger.open(LOG_PATH).is_ok());
+    logger.close();
+    CHECK(logger.values() == 8);
+    std::remove(LOG_PATH);
+}
+
+TEST_CASE("TCDataLogger logs server batches") {
+    ValueBatch batch;
+    batch.push(0x80, 3, 0x0002, 100, 10);
+    batch.push(0x81, 4, 0x0002, 200, 20);
+    TCDataLogger logger;
+    REQUIRE(logger.open(LOG_PATH).is_ok());
+    CHECK(logger.log(batch) == 2);
+    logger.close();
+    CHECK(logger.values() == 2);
+    CHECK(logger.blocks() == 2);
+
+    TCLogReader reader;
+    REQUIRE(reader.open(LOG_PATH).is_ok());
+    i64 sum = 0;
+    REQUIRE(reader.for_each([&](const TCLogRecord &r) { sum += r.value; }).is_ok());
+    CHECK(sum == 300);
+    reader.close();
+    std::remove(LOG_PATH);
+}
+
+TEST_CASE("TCLogReader rejects other files") {
+    FILE *f = std::fopen(LOG_PATH, "wb");
+    REQUIRE(f != nullptr);
+    const char junk[64] = "not a log";
+    std::fwrite(junk, 1, sizeof(junk), f);
+    std::fclose(f);
+    TCLogReader reader;
+    CHECK(reader.open(LOG_PATH).is_err());
+    CHECK(reader.for_each([](const TCLogRecord &) {}).is_err());
+    std::remove(LOG_PATH);
+}
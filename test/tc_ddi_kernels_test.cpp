@@ -0,0 +1,65 @@
+#include <doctest/doctest.h>
+#include <agrobus/isobus/tc/ddi_kernels.hpp>
+
+using namespace agrobus::isobus::tc;
+
+namespace {
+    // Every DDI of the database and a few unknown ones, an odd count so
+    // the scalar tail runs too
+    dp::Vector<u16> all_ddis() {
+        dp::Vector<u16> ddis;
+        for (const auto &def : DDI_DATABASE)
+            ddis.push_back(def.ddi);
+        for (u16 unknown : {u16(729), u16(9999), u16(0x7FFF), u16(0xDFFF), u16(60000)})
+            ddis.push_back(unknown);
+        if (ddis.size() % 2 == 0)
+            ddis.push_back(1);
+        return ddis;
+    }
+} // namespace
+
+TEST_CASE("DDI batch conversion - same as one value at a time") {
+    auto ddis = all_ddis();
+    usize n = ddis.size();
+    dp::Vector<i32> raw(n);
+    for (usize i = 0; i < n; ++i)
+        raw[i] = static_cast<i32>(i * 7919) - 3000000;
+
+    dp::Vector<f64> eng(n);
+    ddi_to_engineering(ddis.data(), raw.data(), n, eng.data());
+    usize to_mismatches = 0;
+    for (usize i = 0; i < n; ++i)
+        to_mismatches += eng[i] == ddi_to_engineering(ddis[i], raw[i]) ? 0 : 1;
+    CHECK(to_mismatches == 0);
+
+    dp::Vector<i32> back(n);
+    ddi_from_engineering(ddis.data(), eng.data(), n, back.data());
+    usize from_mismatches = 0;
+    for (usize i = 0; i < n; ++i)
+        from_mismatches += back[i] == ddi_from_engineering(ddis[i], eng[i]) ? 0 : 1;
+    CHECK(from_mismatches == 0);
+}
+
+TEST_CASE("DDI batch conversion - one DDI per column") {
+    const usize n = 11;
+    i32 raw[n];
+    for (usize i = 0; i < n; ++i)
+        raw[i] = static_cast<i32>(i) * 250 - 1000;
+    f64 eng[n];
+    ddi_to_engineering(ddi::SETPOINT_VOLUME_PER_AREA_APPLICATION_RATE, raw, n, eng);
+    CHECK(eng[0] == doctest::Approx(-10.0));
+    CHECK(eng[10] == doctest::Approx(15.0));
+
+    i32 back[n];
+    ddi_from_engineering(ddi::SETPOINT_VOLUME_PER_AREA_APPLICATION_RATE, eng, n, back);
+    for (usize i = 0; i < n; ++i)
+        CHECK(back[i] == ddi_from_engineering(ddi::SETPOINT_VOLUME_PER_AREA_APPLICATION_RATE, eng[i]));
+
+    // A zero resolution passes values through, as the scalar conversion does
+    f64 values[5] = {1.5, -2.5, 100.0, 0.0, 7.9};
+    i32 out[5];
+    ddi_from_engineering(u16(57344), values, 5, out);
+    CHECK(out[0] == 1);
+    CHECK(out[1] == -2);
+    CHECK(out[4] == 7);
+}
@@ -190,12 +190,113 @@ TEST_CASE("DDOP deserialize round-trip") {
     CHECK(restored.properties()[0].ddi == 0x0086);
     CHECK(restored.properties()[0].value == -500);
 
+    // The object index is rebuilt while parsing
+    REQUIRE(restored.find(4).has_value());
+    CHECK(restored.find(4)->type == TCObjectType::DeviceProperty);
+    CHECK(restored.ddi_of(3) == 0x0001);
+    CHECK(restored.parent_of(4) == &restored.elements()[0]);
+    CHECK(restored.find_value_presentation(5)->unit_designator == "mm");
+    CHECK(restored.validate().is_ok());
+
     // Re-serialize and compare
     auto reser_result = restored.serialize();
     REQUIRE(reser_result.is_ok());
     CHECK(reser_result.value() == ser_result.value());
 }
 
+TEST_CASE("DDOP object index") {
+    DDOP ddop;
+    DeviceObject dev;
+    dev.id = 1;
+    dev.designator = "Planter";
+    ddop.add_device(dev);
+
+    // A planter with 48 row units, each an element with two process data and a property
+    DeviceElement root;
+    root.id = 2;
+    root.type = DeviceElementType::Device;
+    root.parent_id = 1;
+    ObjectID next = 10;
+    for (u16 row = 0; row < 48; ++row)
+        root.child_objects.push_back(static_cast<ObjectID>(next + row * 4));
+    ddop.add_element(root);
+    for (u16 row = 0; row < 48; ++row) {
+        ObjectID base = static_cast<ObjectID>(next + row * 4);
+        DeviceElement unit;
+        unit.id = base;
+        unit.type = DeviceElementType::Unit;
+        unit.number = static_cast<ElementNumber>(row + 1);
+        unit.parent_id = 2;
+        unit.child_objects = {static_cast<ObjectID>(base + 1), static_cast<ObjectID>(base + 2),
+                              static_cast<ObjectID>(base + 3)};
+        ddop.add_element(unit);
+        DeviceProcessData rate;
+        rate.id = base + 1;
+        rate.ddi = ddi::SETPOINT_VOLUME_PER_AREA_APPLICATION_RATE;
+        ddop.add_process_data(rate);
+        DeviceProcessData state;
+        state.id = base + 2;
+        state.ddi = ddi::ACTUAL_WORK_STATE;
+        ddop.add_process_data(state);
+        DeviceProperty offset;
+        offset.id = base + 3;
+        offset.ddi = ddi::DEVICE_ELEMENT_OFFSET_Y;
+        offset.value = row * 750;
+        ddop.add_property(offset);
+    }
+    CHECK(ddop.object_count() == 2 + 48 * 4);
+    CHECK(ddop.validate().is_ok());
+
+    SUBCASE("find by ID") {
+        auto ref = ddop.find(10 + 47 * 4 + 3);
+        REQUIRE(ref.has_value());
+        CHECK(ref->type == TCObjectType::DeviceProperty);
+        CHECK(ddop.properties()[ref->index].value == 47 * 750);
+        CHECK_FALSE(ddop.find(9).has_value());
+        CHECK(ddop.contains(1));
+        CHECK(ddop.find_device(1)->designator == "Planter");
+    }
+
+    SUBCASE("typed lookups reject other types") {
+        CHECK(ddop.find_element(11) == nullptr);
+        CHECK(ddop.find_process_data(11) != nullptr);
+        CHECK(ddop.find_property(11) == nullptr);
+    }
+
+    SUBCASE("element and DDI of an object") {
+        CHECK(ddop.ddi_of(10 + 5 * 4 + 2) == ddi::ACTUAL_WORK_STATE);
+        CHECK(ddop.ddi_of(10 + 5 * 4 + 3) == ddi::DEVICE_ELEMENT_OFFSET_Y);
+        CHECK_FALSE(ddop.ddi_of(10).has_value()); // An element
+        const DeviceElement *unit = ddop.parent_of(10 + 5 * 4 + 1);
+        REQUIRE(unit != nullptr);
+        CHECK(unit->number == 6);
+        CHECK(ddop.parent_of(10)->id == 2);
+        CHECK(ddop.parent_of(2) == nullptr);
+    }
+
+    SUBCASE("validation uses the index") {
+        DeviceElement broken;
+        broken.id = 1000;
+        broken.parent_id = 2;
+        broken.child_objects = {999};
+        ddop.add_element(broken);
+        CHECK(ddop.validate().is_err());
+    }
+
+    SUBCASE("the first object under an ID is kept") {
+        DeviceProperty dup;
+        dup.id = 11;
+        ddop.add_property(dup);
+        CHECK(ddop.find(11)->type == TCObjectType::DeviceProcessData);
+    }
+
+    SUBCASE("clear drops the index") {
+        ddop.clear();
+        CHECK_FALSE(ddop.contains(1));
+        CHECK(ddop.parent_of(11) == nullptr);
+    }
+}
+
 TEST_CASE("DDOP ISOXML generation") {
     DDOP ddop;
 
@@ -250,6 +351,23 @@ TEST_CASE("DDI Database") {
         CHECK(dp::String(entry->name) == "Reserved");
     }
 
+    SUBCASE("lookup returns the database entry") {
+        auto entry = DDIDatabase::lookup(ddi::ACTUAL_WORKING_WIDTH);
+        REQUIRE(entry);
+        CHECK(entry.get() == ddi_lookup(ddi::ACTUAL_WORKING_WIDTH));
+        CHECK(entry->ddi == ddi::ACTUAL_WORKING_WIDTH);
+    }
+
+    SUBCASE("table matches every entry") {
+        for (usize i = 0; i < DDI_DATABASE_SIZE; ++i)
+            CHECK(ddi_lookup(DDI_DATABASE[i].ddi) == &DDI_DATABASE[i]);
+        CHECK(ddi_lookup(729) == nullptr);
+        CHECK(ddi_lookup(32774) == nullptr);
+        CHECK(ddi_lookup(57345) == nullptr);
+        CHECK(dp::String(ddi_name(30000)) == "Unknown");
+        CHECK(ddi_resolution(30000) == doctest::Approx(1.0));
+    }
+
     SUBCASE("unit_for") {
         CHECK(dp::String(DDIDatabase::unit_for(116)) == "m2");
     }
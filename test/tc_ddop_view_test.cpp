@@ -0,0 +1,194 @@
+#include <doctest/doctest.h>
+#include <agrobus/isobus/tc/ddi_database.hpp>
+#include <agrobus/isobus/tc/ddop.hpp>
+#include <agrobus/isobus/tc/ddop_view.hpp>
+
+using namespace agrobus::isobus;
+using namespace agrobus::isobus::tc;
+namespace ddi = agrobus::isobus::tc::ddi;
+
+namespace {
+    DDOP view_ddop() {
+        DDOP ddop;
+        DeviceObject dev;
+        dev.id = 1;
+        dev.designator = "Sprayer";
+        dev.software_version = "2.1";
+        dev.serial_number = "SN-7";
+        dev.structure_label = {1, 2, 3, 4, 5, 6, 7};
+        ddop.add_device(dev);
+
+        DeviceElement root;
+        root.id = 2;
+        root.type = DeviceElementType::Device;
+        root.designator = "Root";
+        root.parent_id = 1;
+        root.child_objects = {10, 11, 3};
+        ddop.add_element(root);
+
+        DeviceElement boom;
+        boom.id = 3;
+        boom.type = DeviceElementType::Function;
+        boom.designator = "Boom";
+        boom.number = 1;
+        boom.parent_id = 2;
+        ddop.add_element(boom);
+
+        DeviceProcessData pd;
+        pd.id = 10;
+        pd.ddi = ddi::ACTUAL_WORKING_WIDTH;
+        pd.trigger_methods = 0x03;
+        pd.presentation_object_id = 20;
+        pd.designator = "Width";
+        ddop.add_process_data(pd);
+
+        DeviceProperty prop;
+        prop.id = 11;
+        prop.ddi = ddi::MAXIMUM_WORKING_WIDTH;
+        prop.value = -24000;
+        prop.designator = "Max width";
+        ddop.add_property(prop);
+
+        DeviceValuePresentation vp;
+        vp.id = 20;
+        vp.offset = 5;
+        vp.scale = 0.001f;
+        vp.decimal_digits = 2;
+        vp.unit_designator = "m";
+        ddop.add_value_presentation(vp);
+        return ddop;
+    }
+
+    bool points_into(std::string_view s, const dp::Vector<u8> &bytes) {
+        auto *p = reinterpret_cast<const u8 *>(s.data());
+        return p >= bytes.data() && p + s.size() <= bytes.data() + bytes.size();
+    }
+} // namespace
+
+TEST_CASE("DDOP serializes in one sized pass") {
+    DDOP ddop = view_ddop();
+    auto bytes = ddop.serialize();
+    REQUIRE(bytes.is_ok());
+    CHECK(bytes.value().size() == ddop.serialized_size());
+
+    dp::Vector<u8> buffer(ddop.serialized_size() + 4, 0xAA);
+    auto written = ddop.serialize_into(buffer.data(), buffer.size());
+    REQUIRE(written.is_ok());
+    CHECK(written.value() == ddop.serialized_size());
+    for (usize i = 0; i < written.value(); ++i)
+        CHECK(buffer[i] == bytes.value()[i]);
+    CHECK(buffer[written.value()] == 0xAA);
+
+    CHECK(ddop.serialize_into(buffer.data(), ddop.serialized_size() - 1).is_err());
+
+    // Per-object sizes agree with what the objects write
+    const auto &pd = ddop.process_data()[0];
+    CHECK(pd.serialize().size() == pd.serialized_size());
+    const auto &root = ddop.elements()[0];
+    CHECK(root.serialize().size() == root.serialized_size());
+}
+
+TEST_CASE("DDOPView indexes a pool without copying it") {
+    auto bytes = view_ddop().serialize().value();
+    auto parsed = DDOPView::parse(bytes);
+    REQUIRE(parsed.is_ok());
+    const DDOPView &view = parsed.value();
+
+    CHECK(view.object_count() == 6);
+    REQUIRE(view.devices().size() == 1);
+    const auto &dev = view.devices()[0];
+    CHECK(dev.designator == "Sprayer");
+    CHECK(dev.software_version == "2.1");
+    CHECK(dev.serial_number == "SN-7");
+    CHECK(points_into(dev.designator, bytes));
+    REQUIRE(dev.structure_label.size() == 7);
+    CHECK(dev.structure_label[6] == 7);
+
+    const auto *root = view.find_element(2);
+    REQUIRE(root != nullptr);
+    CHECK(root->designator == "Root");
+    CHECK(points_into(root->designator, bytes));
+    REQUIRE(root->children.size() == 3);
+    CHECK(root->children[0] == 10);
+    CHECK(root->children[1] == 11);
+    CHECK(root->children[2] == 3);
+    CHECK(view.find_element(3)->number == 1);
+    CHECK(view.find_element(3)->children.empty());
+
+    const auto *pd = view.find_process_data(10);
+    REQUIRE(pd != nullptr);
+    CHECK(pd->trigger_methods == 0x03);
+    CHECK(pd->presentation_object_id == 20);
+    CHECK(view.find_property(11)->value == -24000);
+    CHECK(view.ddi_of(10) == ddi::ACTUAL_WORKING_WIDTH);
+    CHECK(view.ddi_of(11) == ddi::MAXIMUM_WORKING_WIDTH);
+    CHECK_FALSE(view.ddi_of(2).has_value());
+
+    const auto &vp = view.value_presentations()[0];
+    CHECK(vp.offset == 5);
+    CHECK(vp.scale == doctest::Approx(0.001f));
+    CHECK(vp.unit_designator == "m");
+
+    auto ref = view.find(20);
+    REQUIRE(ref.has_value());
+    CHECK(ref->type == TCObjectType::DeviceValuePresentation);
+    CHECK_FALSE(view.find(99).has_value());
+    CHECK(view.find_element(10) == nullptr);
+}
+
+TEST_CASE("DDOPView rejects malformed pools") {
+    auto bytes = view_ddop().serialize().value();
+
+    SUBCASE("a cut inside an object is an error") {
+        DDOP ddop = view_ddop();
+        dp::Vector<usize> ends; // Offsets where an object ends
+        usize end = 0;
+        for (const auto &d : ddop.devices())
+            ends.push_back(end += d.serialized_size());
+        for (const auto &e : ddop.elements())
+            ends.push_back(end += e.serialized_size());
+        for (const auto &pd : ddop.process_data())
+            ends.push_back(end += pd.serialized_size());
+        for (const auto &prop : ddop.properties())
+            ends.push_back(end += prop.serialized_size());
+        for (const auto &vp : ddop.value_presentations())
+            ends.push_back(end += vp.serialized_size());
+        REQUIRE(end == bytes.size());
+
+        usize next = 0;
+        for (usize len = 1; len < bytes.size(); ++len) {
+            auto parsed = DDOPView::parse(DataSpan(bytes.data(), len));
+            if (len == ends[next]) {
+                ++next;
+                REQUIRE(parsed.is_ok());
+                CHECK(parsed.value().object_count() == next);
+            } else {
+                CHECK(parsed.is_err());
+            }
+        }
+    }
+
+    SUBCASE("unknown object type") {
+        dp::Vector<u8> garbage = {0x7F, 1, 0, 0};
+        CHECK(DDOPView::parse(garbage).is_err());
+    }
+
+    SUBCASE("an empty pool is empty") {
+        dp::Vector<u8> empty;
+        auto parsed = DDOPView::parse(empty);
+        REQUIRE(parsed.is_ok());
+        CHECK(parsed.value().object_count() == 0);
+    }
+}
+
+TEST_CASE("DDOP round trip through the view is byte-identical") {
+    auto bytes = view_ddop().serialize().value();
+    auto restored = DDOP::deserialize(bytes);
+    REQUIRE(restored.is_ok());
+    auto again = restored.value().serialize().value();
+    REQUIRE(again.size() == bytes.size());
+    for (usize i = 0; i < bytes.size(); ++i)
+        CHECK(again[i] == bytes[i]);
+    CHECK(restored.value().parent_of(10)->id == 2);
+    CHECK(restored.value().next_id() == 21);
+}
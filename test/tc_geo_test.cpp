@@ -106,3 +106,70 @@ TEST_CASE("TCGEOInterface - rate at position") {
         CHECK_FALSE(rate.has_value());
     }
 }
+
+TEST_CASE("TCGEOInterface - section look-ahead rates") {
+    IsoNet nm;
+    auto* cf = nm.create_internal(Name::build().set_identity_number(1), 0, 0x10).value();
+
+    TCGEOInterface geo(nm, cf);
+
+    // Two bands, 0.0001 deg (about 11 m) deep: rate 100 in the south, 200 north of it
+    PrescriptionMap map;
+    map.structure_label = "BANDS";
+    PrescriptionZone south;
+    south.boundary = {concord::earth::WGS(48.0, 11.0, 0), concord::earth::WGS(48.0001, 11.0, 0),
+                      concord::earth::WGS(48.0001, 11.001, 0), concord::earth::WGS(48.0, 11.001, 0)};
+    south.application_rate = 100;
+    PrescriptionZone north;
+    north.boundary = {concord::earth::WGS(48.0001, 11.0, 0), concord::earth::WGS(48.0002, 11.0, 0),
+                      concord::earth::WGS(48.0002, 11.001, 0), concord::earth::WGS(48.0001, 11.001, 0)};
+    north.application_rate = 200;
+    map.zones.push_back(south);
+    map.zones.push_back(north);
+    geo.add_prescription_map(std::move(map));
+
+    // Boom 0.5 m behind the antenna, sections 5 m apart
+    geo.set_sections({{-0.5, -5.0}, {-0.5, 0.0}, {-0.5, 5.0}});
+    GeoPoint point;
+    point.position = concord::earth::WGS(48.0 + 10.0 / 111320.0, 11.0005, 0); // 10 m into the south band
+    geo.set_position(point);
+
+    u32 events = 0;
+    geo.on_section_rates_changed.subscribe([&](const dp::Vector<dp::Optional<i32>>&) { ++events; });
+
+    SUBCASE("no heading, no section rates") {
+        geo.update(100);
+        CHECK(events == 0);
+        CHECK_FALSE(geo.section_rates()[0].has_value());
+    }
+
+    SUBCASE("standing still the sections sit where they are") {
+        geo.set_motion(0.0, 0.0);
+        geo.update(100);
+        CHECK(events == 1);
+        for (const auto& rate : geo.section_rates())
+            CHECK(rate == 100);
+        geo.update(100);
+        CHECK(events == 1); // Unchanged
+    }
+
+    SUBCASE("moving north the sections see the next band ahead of time") {
+        geo.set_motion(0.0, 4.0);
+        geo.set_look_ahead(500); // 2 m ahead: 11.5 m north of the band edge
+        geo.update(100);
+        CHECK(events == 1);
+        for (const auto& rate : geo.section_rates())
+            CHECK(rate == 200);
+        CHECK(*geo.get_rate_at_position(point.position) == 100);
+    }
+
+    SUBCASE("heading east the right section is to the south") {
+        geo.set_motion(M_PI / 2.0, 0.0);
+        geo.update(100);
+        const auto& pos = geo.section_positions();
+        auto antenna = geo.prescription_index().to_local(point.position);
+        CHECK(pos[2].north == doctest::Approx(antenna.north - 5.0f).epsilon(1e-4));
+        CHECK(pos[0].north == doctest::Approx(antenna.north + 5.0f).epsilon(1e-4));
+        CHECK(pos[1].east == doctest::Approx(antenna.east - 0.5f).epsilon(1e-4)); // Boom behind
+    }
+}
@@ -0,0 +1,191 @@
+#include <doctest/doctest.h>
+#include <agrobus/isobus/tc/geo.hpp>
+#include <agrobus/isobus/tc/isoxml_reader.hpp>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <thread>
+
+using namespace agrobus::net;
+using namespace agrobus::isobus::tc;
+
+namespace {
+    // Two treatment zones of task "Field 1": a 0.01 deg square at 200 and a
+    // square with a hole at 300 (DDI 0x0001) or 7 (DDI 0x0006)
+    constexpr std::string_view TASKDATA = R"(<?xml version="1.0" encoding="UTF-8"?>
+<!-- Exported for the test -->
+<ISO11783_TaskData VersionMajor="4" VersionMinor="3" DataTransferOrigin="1">
+  <TSK A="TSK1" B="Field &amp; 1" G="1">
+    <TZN A="1" B="Low">
+      <PLN A="6">
+        <LSG A="1">
+          <PNT A="2" C="48.00" D="11.00"/>
+          <PNT A="2" C="48.01" D="11.00"/>
+          <PNT A="2" C="48.01" D="11.01"/>
+          <PNT A="2" C="48.00" D="11.01"/>
+        </LSG>
+      </PLN>
+      <PDV A="0001" B="200"/>
+    </TZN>
+    <TZN A="2" B="High">
+      <PDV A="0006" B="7"/>
+      <PDV A="0001" B="300"/>
+      <PLN A="6">
+        <LSG A='1'>
+          <PNT A="2" C="48.00" D="11.02"/>
+          <PNT A="2" C="48.01" D="11.02"/>
+          <PNT A="2" C="48.01" D="11.03"/>
+          <PNT A="2" C="48.00" D="11.03"/>
+        </LSG>
+        <LSG A="2">
+          <PNT A="2" C="48.004" D="11.024"/>
+          <PNT A="2" C="48.006" D="11.024"/>
+          <PNT A="2" C="48.006" D="11.026"/>
+        </LSG>
+      </PLN>
+    </TZN>
+    <TZN A="3"><PDV A="0006" B="9"/></TZN>
+  </TSK>
+  <TSK A="TSK2" G="1"/>
+</ISO11783_TaskData>
+)";
+
+    struct Counter {
+        u32 starts = 0;
+        u32 ends = 0;
+        dp::Vector<std::string_view> tags;
+        void start(std::string_view tag, const IsoxmlAttributes &) {
+            ++starts;
+            tags.push_back(tag);
+        }
+        void end(std::string_view) { ++ends; }
+    };
+
+    bool write_file(const char *path, std::string_view text) {
+        FILE *f = std::fopen(path, "wb");
+        if (!f)
+            return false;
+        std::fwrite(text.data(), 1, text.size(), f);
+        return std::fclose(f) == 0;
+    }
+} // namespace
+
+TEST_CASE("IsoxmlReader - elements and attributes as views") {
+    Counter counter;
+    REQUIRE(IsoxmlReader::parse(TASKDATA, counter).is_ok());
+    CHECK(counter.starts == counter.ends);
+    CHECK(counter.tags[0] == "ISO11783_TaskData");
+    CHECK(counter.tags[1] == "TSK");
+
+    IsoxmlAttributes attrs(R"( A="1"  B = 'two words' C="")");
+    CHECK(attrs.get("A") == "1");
+    CHECK(attrs.get("B") == "two words");
+    CHECK(attrs.get("C").empty());
+    CHECK(attrs.get("D").empty());
+    CHECK(isoxml::unescape("a &amp; b &lt;c&gt; &x") == "a & b <c> &x");
+}
+
+TEST_CASE("IsoxmlReader - malformed documents") {
+    Counter counter;
+    CHECK_FALSE(IsoxmlReader::parse("<A><B></A>", counter).is_ok());
+    CHECK_FALSE(IsoxmlReader::parse("<A B=\"x>\"", counter).is_ok());
+    CHECK_FALSE(IsoxmlReader::parse("<A>", counter).is_ok());
+    CHECK_FALSE(IsoxmlReader::parse("<!-- open", counter).is_ok());
+    CHECK(IsoxmlReader::parse("<A B=\"a > b\"/>", counter).is_ok());
+}
+
+TEST_CASE("read_prescriptions - polygon treatment zones") {
+    auto maps = read_prescriptions(TASKDATA);
+    REQUIRE(maps.is_ok());
+    REQUIRE(maps.value().size() == 1); // TSK2 has no zones
+    const auto &map = maps.value()[0];
+    CHECK(map.structure_label == "Field & 1");
+    REQUIRE(map.zones.size() == 2); // TZN 3 has no polygon, the hole is not a zone
+    CHECK(map.zones[0].application_rate == 200);
+    CHECK(map.zones[0].boundary.size() == 4);
+    CHECK(map.zones[0].boundary[1].latitude == doctest::Approx(48.01));
+    CHECK(map.zones[0].boundary[2].longitude == doctest::Approx(11.01));
+    CHECK(map.zones[1].application_rate == 7); // First PDV
+
+    SUBCASE("rate of one DDI") {
+        auto per_ddi = read_prescriptions(TASKDATA, TaskDataOptions{}.ddi(0x0001));
+        REQUIRE(per_ddi.is_ok());
+        REQUIRE(per_ddi.value()[0].zones.size() == 2);
+        CHECK(per_ddi.value()[0].zones[1].application_rate == 300);
+
+        auto other = read_prescriptions(TASKDATA, TaskDataOptions{}.ddi(0x0006));
+        REQUIRE(other.is_ok());
+        REQUIRE(other.value()[0].zones.size() == 1); // The 0x0001-only zone is dropped
+        CHECK(other.value()[0].zones[0].application_rate == 7);
+    }
+}
+
+TEST_CASE("load_prescriptions - mapped file with an external task file") {
+    const char *main_path = "/tmp/agrobus_isoxml_reader_TASKDATA.XML";
+    const char *ext_path = "/tmp/TSK00002.XML";
+    REQUIRE(write_file(main_path, R"(<ISO11783_TaskData><XFR A="TSK00002" B="1"/></ISO11783_TaskData>)"));
+    usize tasks = TASKDATA.find("<TSK");
+    std::string external = "<XFC>" + std::string(TASKDATA.substr(tasks, TASKDATA.find("</ISO") - tasks)) + "</XFC>";
+    REQUIRE(write_file(ext_path, external));
+
+    auto loaded = load_prescription_index(main_path);
+    REQUIRE(loaded.is_ok());
+    REQUIRE(loaded.value().maps.size() == 1);
+    CHECK(loaded.value().index.size() == 2);
+    const auto *zone = loaded.value().index.find(loaded.value().maps, concord::earth::WGS(48.005, 11.025));
+    REQUIRE(zone != nullptr);
+    CHECK(zone->application_rate == 7);
+
+    CHECK_FALSE(load_prescriptions("/nonexistent/TASKDATA.XML").is_ok());
+    std::remove(main_path);
+    std::remove(ext_path);
+}
+
+TEST_CASE("TCGEOInterface - prescription maps load in the background") {
+    const char *path = "/tmp/agrobus_isoxml_reader_geo.XML";
+    REQUIRE(write_file(path, TASKDATA));
+    IsoNet nm(NetworkConfig{}.work_pool(1));
+    auto *cf = nm.create_internal(Name::build().set_identity_number(1), 0, 0x10).value();
+    TCGEOInterface geo(nm, cf);
+    usize loaded = 0;
+    geo.on_prescription_maps_loaded.subscribe([&](usize n) { loaded = n; });
+
+    geo.load_prescription_maps(path, TaskDataOptions{}.ddi(0x0001));
+    CHECK(geo.loading_prescription_maps());
+    for (i32 i = 0; i < 1000 && geo.loading_prescription_maps(); ++i) {
+        nm.update(0);
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    CHECK_FALSE(geo.loading_prescription_maps());
+    CHECK(loaded == 1);
+    CHECK(geo.prescription_index().size() == 2);
+    CHECK(geo.get_rate_at_position(concord::earth::WGS(48.005, 11.005)) == dp::Optional<i32>(200));
+    CHECK(geo.get_rate_at_position(concord::earth::WGS(48.005, 11.025)) == dp::Optional<i32>(300));
+
+    SUBCASE("maps added meanwhile are kept") {
+        geo.clear_prescription_maps();
+        geo.load_prescription_maps(path);
+        PrescriptionMap first;
+        first.structure_label = "manual";
+        geo.add_prescription_map(std::move(first));
+        for (i32 i = 0; i < 1000 && geo.loading_prescription_maps(); ++i) {
+            nm.update(0);
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        REQUIRE(geo.prescription_maps().size() == 2);
+        CHECK(geo.prescription_maps()[0].structure_label == "manual");
+    }
+
+    SUBCASE("a missing file is reported") {
+        bool failed = false;
+        geo.on_prescription_load_failed.subscribe([&](const Error &) { failed = true; });
+        geo.load_prescription_maps("/nonexistent/TASKDATA.XML");
+        for (i32 i = 0; i < 1000 && geo.loading_prescription_maps(); ++i) {
+            nm.update(0);
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        CHECK(failed);
+        CHECK(geo.prescription_index().size() == 2);
+    }
+    std::remove(path);
+}
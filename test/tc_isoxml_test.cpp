@@ -0,0 +1,156 @@
+#include <doctest/doctest.h>
+#include <agrobus/isobus/tc/ddi_database.hpp>
+#include <agrobus/isobus/tc/ddop.hpp>
+#include <agrobus/isobus/tc/isoxml.hpp>
+#include <cstdio>
+
+using namespace agrobus::isobus;
+using namespace agrobus::isobus::tc;
+namespace ddi = agrobus::isobus::tc::ddi;
+
+namespace {
+    DDOP isoxml_ddop(const char *name) {
+        DDOP ddop;
+        DeviceObject dev;
+        dev.id = 1;
+        dev.designator = name;
+        dev.software_version = "1.0";
+        ddop.add_device(dev);
+        DeviceElement root;
+        root.id = 2;
+        root.type = DeviceElementType::Device;
+        root.designator = "Root";
+        root.parent_id = 1;
+        root.child_objects = {3};
+        ddop.add_element(root);
+        DeviceProcessData pd;
+        pd.id = 3;
+        pd.ddi = ddi::ACTUAL_WORKING_WIDTH;
+        pd.trigger_methods = 1;
+        pd.designator = "Width";
+        ddop.add_process_data(pd);
+        return ddop;
+    }
+} // namespace
+
+TEST_CASE("IsoxmlWriter streams elements through a small buffer") {
+    dp::String out;
+    u32 flushes = 0;
+    {
+        IsoxmlWriter xml(
+            [&](DataSpan bytes) {
+                ++flushes;
+                CHECK(bytes.size() <= 16);
+                out.append(reinterpret_cast<const char *>(bytes.data()), bytes.size());
+                return true;
+            },
+            16);
+        xml.open("TSK").ref("A", "TSK", 1).attr("B", "Field <3> & \"co\"").attr("C", -42);
+        xml.open("TIM").hex("A", 0x74, 4).close();
+        xml.end("TSK");
+        xml.open("VPN").close();
+        REQUIRE(xml.flush().is_ok());
+        CHECK(xml.written() == out.size());
+    }
+    CHECK(flushes > 4);
+    CHECK(out == "<TSK A=\"TSK-1\" B=\"Field &lt;3&gt; &amp; &quot;co&quot;\" C=\"-42\">\n"
+                 "  <TIM A=\"0074\"/>\n"
+                 "</TSK>\n"
+                 "<VPN/>\n");
+}
+
+TEST_CASE("IsoxmlWriter reports a failing sink") {
+    IsoxmlWriter xml([](DataSpan) { return false; }, 8);
+    xml.open("DVC").attr("B", "a long designator").close();
+    CHECK(xml.failed());
+    CHECK(xml.flush().is_err());
+}
+
+TEST_CASE("Several DDOPs stream into one document") {
+    dp::String out;
+    {
+        IsoxmlWriter xml(string_sink(out), 64);
+        xml.declaration();
+        xml.open("ISO11783_TaskData").attr("VersionMajor", 4);
+        REQUIRE(isoxml_ddop("Seeder").write_isoxml(xml).is_ok());
+        REQUIRE(isoxml_ddop("Sprayer").write_isoxml(xml).is_ok());
+        xml.end("ISO11783_TaskData");
+    }
+    CHECK(out.find("B=\"Seeder\"") != dp::String::npos);
+    CHECK(out.find("B=\"Sprayer\"") != dp::String::npos);
+    CHECK(out.find("<DPD A=\"DPD-3\" B=\"67\" C=\"1\" D=\"Width\"/>") != dp::String::npos);
+    CHECK(out.find("</ISO11783_TaskData>\n") == out.size() - 21);
+
+    // to_isoxml produces the same elements in a document of its own
+    dp::String single = isoxml_ddop("Seeder").to_isoxml();
+    CHECK(single.find("<?xml") == 0);
+    CHECK(single.find("    <DET A=\"DET-2\" B=\"1\" C=\"Root\" D=\"0\" E=\"DET-1\">") != dp::String::npos);
+}
+
+TEST_CASE("TimeLogWriter writes the header template and binary records") {
+    dp::String bin;
+    TimeLogWriter tlg(string_sink(bin));
+    auto width = tlg.add_value(ddi::ACTUAL_WORKING_WIDTH, 2);
+    auto rate = tlg.add_value(ddi::ACTUAL_VOLUME_PER_AREA_APPLICATION_RATE, 5);
+    REQUIRE(width.is_ok());
+    REQUIRE(rate.is_ok());
+    CHECK(rate.value() == 1);
+
+    dp::String header;
+    {
+        IsoxmlWriter xml(string_sink(header));
+        tlg.write_header(xml);
+    }
+    CHECK(header == "<TIM A=\"\" D=\"4\">\n"
+                    "  <PTN A=\"\" B=\"\" D=\"\"/>\n"
+                    "  <DLV A=\"0043\" B=\"\" C=\"DET-2\"/>\n"
+                    "  <DLV A=\"0002\" B=\"\" C=\"DET-5\"/>\n"
+                    "</TIM>\n");
+
+    TimeLogWriter::Position pos{480000000, 110000000, 4};
+    dp::Vector<TimeLogWriter::Sample> samples = {{width.value(), 24000}, {rate.value(), -1}};
+    REQUIRE(tlg.write(36000000, 16000, pos, samples).is_ok());
+    samples.pop_back();
+    REQUIRE(tlg.write(36001000, 16000, pos, samples).is_ok());
+    REQUIRE(tlg.flush().is_ok());
+    CHECK(tlg.records() == 2);
+    CHECK(tlg.add_value(ddi::ACTUAL_WORKING_WIDTH, 3).is_err());
+
+    const usize fixed = 4 + 2 + 4 + 4 + 1 + 1;
+    REQUIRE(bin.size() == (fixed + 2 * 5) + (fixed + 5));
+    auto byte = [&](usize i) { return static_cast<u8>(bin[i]); };
+    u32 time = byte(0) | (byte(1) << 8) | (byte(2) << 16) | (static_cast<u32>(byte(3)) << 24);
+    CHECK(time == 36000000);
+    CHECK((byte(4) | (byte(5) << 8)) == 16000);
+    CHECK(byte(14) == 4);  // Position status
+    CHECK(byte(15) == 2);  // DLV count
+    CHECK(byte(16) == 0);  // First DLV index
+    CHECK(byte(21) == 1);  // Second DLV index
+    CHECK(byte(22) == 0xFF);
+    CHECK(byte(fixed + 10 + 15) == 1);
+
+    TimeLogWriter::Sample bad{7, 0};
+    CHECK(tlg.write(0, 0, pos, &bad, 1).is_err());
+}
+
+TEST_CASE("FileSink writes a TASKDATA file") {
+    dp::String path = "/tmp/agrobus_isoxml_test.xml";
+    FileSink file;
+    REQUIRE(file.open(path).is_ok());
+    {
+        IsoxmlWriter xml(file.sink());
+        xml.declaration();
+        REQUIRE(isoxml_ddop("Seeder").write_isoxml(xml).is_ok());
+        REQUIRE(xml.flush().is_ok());
+    }
+    file.close();
+
+    FILE *f = std::fopen(path.c_str(), "rb");
+    REQUIRE(f != nullptr);
+    char buf[64] = {};
+    usize n = std::fread(buf, 1, sizeof(buf) - 1, f);
+    std::fclose(f);
+    std::remove(path.c_str());
+    CHECK(n > 0);
+    CHECK(dp::String(buf).find("<?xml") == 0);
+}
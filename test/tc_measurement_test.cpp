@@ -0,0 +1,287 @@
+#include <doctest/doctest.h>
+#include <agrobus/isobus/tc/client.hpp>
+#include <agrobus/isobus/tc/ddi_database.hpp>
+#include <agrobus/isobus/tc/measurement.hpp>
+#include <agrobus/net/loopback_bus.hpp>
+
+using namespace agrobus::net;
+using namespace agrobus::isobus::tc;
+
+namespace {
+    usize flush_all(MeasurementEngine &engine, dp::Vector<DDI> &out) {
+        return engine.flush([&](const Measurement &m) -> dp::Optional<i32> {
+            out.push_back(m.ddi);
+            return m.value ? m.value : dp::Optional<i32>(0);
+        });
+    }
+} // namespace
+
+TEST_CASE("MeasurementEngine time triggers") {
+    MeasurementEngine engine;
+    dp::Vector<DDI> sent;
+    REQUIRE(engine.command(ProcessDataCommands::MeasurementTimeInterval, 1, ddi::ACTUAL_WORKING_WIDTH, 100));
+    CHECK_FALSE(engine.command(ProcessDataCommands::RequestValue, 1, ddi::ACTUAL_WORKING_WIDTH, 0));
+    CHECK(engine.size() == 1);
+
+    SUBCASE("fires once per interval") {
+        engine.update(99);
+        CHECK(engine.pending() == 0);
+        engine.update(1);
+        CHECK(engine.pending() == 1);
+        CHECK(flush_all(engine, sent) == 1);
+        engine.update(100);
+        CHECK(flush_all(engine, sent) == 1);
+        CHECK(sent.size() == 2);
+    }
+
+    SUBCASE("a coarse update reports once") {
+        engine.update(1000);
+        CHECK(engine.pending() == 1);
+    }
+
+    SUBCASE("a zero interval stops it") {
+        engine.command(ProcessDataCommands::MeasurementTimeInterval, 1, ddi::ACTUAL_WORKING_WIDTH, 0);
+        engine.update(500);
+        CHECK(engine.pending() == 0);
+    }
+
+    SUBCASE("a new interval replaces the old one") {
+        engine.update(50);
+        engine.command(ProcessDataCommands::MeasurementTimeInterval, 1, ddi::ACTUAL_WORKING_WIDTH, 200);
+        engine.update(150);
+        CHECK(engine.pending() == 0);
+        engine.update(50);
+        CHECK(engine.pending() == 1);
+    }
+}
+
+TEST_CASE("MeasurementEngine distance triggers") {
+    MeasurementEngine engine;
+    engine.command(ProcessDataCommands::MeasurementDistanceInterval, 2, ddi::ACTUAL_WORKING_WIDTH, 1000);
+    engine.set_distance(50000); // Starting point
+    CHECK(engine.pending() == 0);
+    engine.set_distance(50900);
+    CHECK(engine.pending() == 0);
+    engine.set_distance(51000);
+    CHECK(engine.pending() == 1);
+    dp::Vector<DDI> sent;
+    flush_all(engine, sent);
+    engine.set_distance(53500); // Two intervals passed: one report, remainder kept
+    CHECK(engine.pending() == 1);
+    flush_all(engine, sent);
+    engine.set_distance(53900);
+    CHECK(engine.pending() == 0);
+    engine.set_distance(54000);
+    CHECK(engine.pending() == 1);
+}
+
+TEST_CASE("MeasurementEngine threshold and change triggers") {
+    MeasurementEngine engine;
+    dp::Vector<DDI> sent;
+    const DDI d = ddi::ACTUAL_WORKING_WIDTH;
+
+    SUBCASE("values of unwatched DDIs are ignored") {
+        engine.set_value(0, d, 5);
+        CHECK(engine.empty());
+    }
+
+    SUBCASE("change threshold") {
+        engine.command(ProcessDataCommands::MeasurementChangeThreshold, 0, d, 10);
+        engine.set_value(0, d, 100);
+        CHECK(flush_all(engine, sent) == 1); // First value
+        engine.set_value(0, d, 105);
+        CHECK(engine.pending() == 0);
+        engine.set_value(0, d, 91);
+        CHECK(engine.pending() == 0);
+        engine.set_value(0, d, 90);
+        CHECK(flush_all(engine, sent) == 1);
+        CHECK(engine.find(0, d)->sent == 90);
+    }
+
+    SUBCASE("threshold range reports on entering it") {
+        engine.command(ProcessDataCommands::MeasurementMinimumWithinThreshold, 0, d, 10);
+        engine.command(ProcessDataCommands::MeasurementMaximumWithinThreshold, 0, d, 20);
+        engine.set_value(0, d, 5);
+        CHECK(engine.pending() == 0);
+        engine.set_value(0, d, 15);
+        CHECK(flush_all(engine, sent) == 1);
+        engine.set_value(0, d, 16);
+        CHECK(engine.pending() == 0);
+        engine.set_value(0, d, 25);
+        CHECK(engine.pending() == 0);
+        engine.set_value(0, d, 12);
+        CHECK(engine.pending() == 1);
+    }
+
+    SUBCASE("a measurement fired twice is reported once") {
+        engine.command(ProcessDataCommands::MeasurementChangeThreshold, 0, d, 1);
+        engine.command(ProcessDataCommands::MeasurementTimeInterval, 0, d, 10);
+        engine.set_value(0, d, 1);
+        engine.update(10);
+        CHECK(engine.pending() == 1);
+        CHECK(flush_all(engine, sent) == 1);
+    }
+
+    SUBCASE("clear drops every trigger") {
+        engine.command(ProcessDataCommands::MeasurementTimeInterval, 0, d, 10);
+        engine.clear();
+        engine.update(100);
+        CHECK(engine.empty());
+        CHECK(engine.pending() == 0);
+    }
+}
+
+// ─── TC client against a scripted TC on a loopback bus ────────────────────────
+namespace {
+    DDOP measurement_ddop() {
+        DDOP ddop;
+        DeviceObject device;
+        device.id = 1;
+        device.designator = "Sprayer";
+        device.software_version = "1.0";
+        ddop.add_device(device);
+        DeviceElement root;
+        root.id = 2;
+        root.type = DeviceElementType::Device;
+        root.number = 0;
+        root.parent_id = 1;
+        root.designator = "Root";
+        ddop.add_element(root);
+        return ddop;
+    }
+
+    dp::Vector<u8> pd_message(ProcessDataCommands cmd, ElementNumber elem, DDI d, i32 value) {
+        dp::Vector<u8> data(8, 0xFF);
+        data[0] = (static_cast<u8>(cmd) & 0x0F) | ((static_cast<u8>(elem) & 0x0F) << 4);
+        data[1] = static_cast<u8>((elem >> 4) & 0xFF);
+        data[2] = static_cast<u8>(d & 0xFF);
+        data[3] = static_cast<u8>((d >> 8) & 0xFF);
+        for (u8 i = 0; i < 4; ++i)
+            data[4 + i] = static_cast<u8>((static_cast<u32>(value) >> (8 * i)) & 0xFF);
+        return data;
+    }
+} // namespace
+
+TEST_CASE("TaskControllerClient runs measurement commands") {
+    LoopbackBus bus;
+    IsoNet nm_tc;
+    IsoNet nm_ecu;
+    auto *tc_cf = nm_tc.create_internal(Name::build().set_identity_number(1), 0, 0xF7).value();
+    auto *ecu_cf = nm_ecu.create_internal(Name::build().set_identity_number(2), 0, 0x80).value();
+    bus.attach(nm_tc);
+    bus.attach(nm_ecu);
+    REQUIRE(nm_tc.start_address_claiming().is_ok());
+    REQUIRE(nm_ecu.start_address_claiming().is_ok());
+
+    TaskControllerClient client(nm_ecu, ecu_cf);
+    client.set_ddop(measurement_ddop());
+
+    // Scripted TC: answers the connect handshake, records Value messages
+    dp::Vector<dp::Vector<u8>> values;
+    nm_tc.register_pgn_callback(PGN_ECU_TO_TC, [&](const Message &msg) {
+        ControlFunction ecu;
+        ecu.address = msg.source;
+        dp::Vector<u8> reply(8, 0xFF);
+        if (msg.data.size() > 8) {
+            reply[0] = tc_cmd::OBJECT_POOL_RESPONSE;
+            reply[1] = 0;
+        } else if (msg.data[0] == tc_cmd::VERSION_REQUEST) {
+            reply[0] = tc_cmd::VERSION_RESPONSE;
+            reply[1] = 4;
+            reply[2] = 1;
+            reply[3] = 16;
+        } else if (msg.data[0] == tc_cmd::ACTIVATE_POOL) {
+            reply[0] = tc_cmd::ACTIVATE_RESPONSE;
+            reply[1] = 0;
+        } else {
+            if ((msg.data[0] & 0x0F) == static_cast<u8>(ProcessDataCommands::Value))
+                values.push_back(msg.data);
+            return;
+        }
+        nm_tc.send(PGN_TC_TO_ECU, reply, tc_cf, &ecu);
+    });
+
+    auto run = [&](u32 steps) {
+        for (u32 i = 0; i < steps; ++i) {
+            nm_tc.update(5);
+            nm_ecu.update(5);
+            client.update(5);
+        }
+    };
+    run(60); // Address claims
+    REQUIRE(client.connect().is_ok());
+    dp::Vector<u8> status(8, 0xFF);
+    status[0] = tc_cmd::TC_STATUS;
+    nm_tc.send(PGN_TC_TO_ECU, status, tc_cf);
+    run(200);
+    REQUIRE(client.state() == TCState::Connected);
+
+    auto command = [&](ProcessDataCommands cmd, ElementNumber elem, DDI d, i32 value) {
+        ControlFunction ecu;
+        ecu.address = ecu_cf->address();
+        nm_tc.send(PGN_TC_TO_ECU, pd_message(cmd, elem, d, value), tc_cf, &ecu);
+        run(1);
+    };
+
+    SUBCASE("time interval reports the value the application set") {
+        command(ProcessDataCommands::MeasurementTimeInterval, 3, ddi::ACTUAL_WORKING_WIDTH, 100);
+        client.set_value(3, ddi::ACTUAL_WORKING_WIDTH, 12000);
+        values.clear();
+        run(100); // 500 ms
+        REQUIRE(values.size() >= 4);
+        CHECK(values.size() <= 6);
+        auto &v = values.back();
+        ElementNumber elem = static_cast<u16>((v[0] >> 4) & 0x0F) | (static_cast<u16>(v[1]) << 4);
+        CHECK(elem == 3);
+        CHECK((static_cast<u16>(v[2]) | (static_cast<u16>(v[3]) << 8)) == ddi::ACTUAL_WORKING_WIDTH);
+        i32 value = static_cast<i32>(v[4]) | (static_cast<i32>(v[5]) << 8) | (static_cast<i32>(v[6]) << 16) |
+                    (static_cast<i32>(v[7]) << 24);
+        CHECK(value == 12000);
+    }
+
+    SUBCASE("without a value the request callback is asked") {
+        u32 asked = 0;
+        client.on_value_request([&](ElementNumber, DDI) -> Result<i32> {
+            ++asked;
+            return Result<i32>::ok(7);
+        });
+        command(ProcessDataCommands::MeasurementDistanceInterval, 0, ddi::ACTUAL_WORKING_WIDTH, 1000);
+        client.set_distance(10.0);
+        client.set_distance(11.5);
+        values.clear();
+        run(4);
+        CHECK(asked == 1);
+        REQUIRE(values.size() == 1);
+        CHECK(values[0][4] == 7);
+    }
+
+    SUBCASE("requests are answered from the value store") {
+        u32 asked = 0;
+        client.on_value_request([&](ElementNumber, DDI) -> Result<i32> {
+            ++asked;
+            return Result<i32>::ok(1);
+        });
+        client.set_value(0, ddi::ACTUAL_WORKING_WIDTH, 9000);
+        values.clear();
+        command(ProcessDataCommands::RequestValue, 0, ddi::ACTUAL_WORKING_WIDTH, 0);
+        run(2);
+        CHECK(asked == 0);
+        REQUIRE(values.size() == 1);
+        CHECK((values[0][4] | (values[0][5] << 8)) == 9000);
+    }
+
+    SUBCASE("set values go out together and setpoints land in the store") {
+        client.set_value(0, ddi::ACTUAL_WORKING_WIDTH, 1);
+        client.set_value(1, ddi::ACTUAL_WORKING_WIDTH, 2);
+        client.set_value(2, ddi::ACTUAL_WORKING_WIDTH, 3);
+        values.clear();
+        CHECK(client.send_values() == 3);
+        run(2);
+        CHECK(values.size() == 3);
+        CHECK(client.send_values() == 0);
+
+        command(ProcessDataCommands::Value, 5, ddi::SETPOINT_VOLUME_PER_AREA_APPLICATION_RATE, 250);
+        CHECK(client.values().get(5, ddi::SETPOINT_VOLUME_PER_AREA_APPLICATION_RATE) == 250);
+        CHECK(client.values().dirty_count() == 0);
+    }
+}
@@ -0,0 +1,168 @@
+#include <doctest/doctest.h>
+#include <agrobus/isobus/tc/geo.hpp>
+#include <agrobus/isobus/tc/isoxml_reader.hpp>
+#include <agrobus/isobus/tc/prescription_grid.hpp>
+#include <cstdio>
+
+using namespace agrobus::net;
+using namespace agrobus::isobus::tc;
+
+namespace {
+    // 4 columns x 3 rows of 0.001 deg from (48.0, 11.0)
+    GridSpec spec(u8 type, u8 zone_code = 0) {
+        GridSpec s;
+        s.min_north = 48.0;
+        s.min_east = 11.0;
+        s.cell_north = 0.001;
+        s.cell_east = 0.001;
+        s.columns = 4;
+        s.rows = 3;
+        s.type = type;
+        s.zone_code = zone_code;
+        return s;
+    }
+
+    dp::Vector<GridZone> zones() {
+        return {GridZone{1, {0x0001, 0x0006}, {100, 5}}, GridZone{2, {0x0001}, {200}}, GridZone{9, {0x0006}, {}}};
+    }
+
+    // Row 0 (south) is zone 1, row 1 zone 2, row 2 a code with no zone
+    dp::Vector<u8> type1_cells() { return {1, 1, 1, 1, 2, 2, 2, 2, 7, 7, 7, 7}; }
+
+    void put_i32(dp::Vector<u8> &out, i32 v) {
+        for (u8 i = 0; i < 4; ++i)
+            out.push_back(static_cast<u8>(static_cast<u32>(v) >> (8 * i)));
+    }
+
+    // Two products per cell: the cell index and minus it
+    dp::Vector<u8> type2_cells() {
+        dp::Vector<u8> out;
+        for (i32 c = 0; c < 12; ++c) {
+            put_i32(out, c * 10);
+            put_i32(out, -c);
+        }
+        return out;
+    }
+} // namespace
+
+TEST_CASE("GridMap - type 1 cells through the zone table") {
+    auto grid = GridMap::from_bytes(type1_cells(), spec(1), zones());
+    REQUIRE(grid.is_ok());
+    const GridMap &g = grid.value();
+    CHECK(g.cells() == 12);
+    REQUIRE(g.products() == 2);
+    CHECK(g.ddis()[0] == 0x0001);
+    CHECK(g.ddis()[1] == 0x0006);
+    CHECK(g.product(0x0006) == dp::Optional<u8>(1));
+    CHECK_FALSE(g.product(0x0002).has_value());
+
+    CHECK(g.cell(concord::earth::WGS(48.0005, 11.0025)) == dp::Optional<u32>(2));
+    CHECK(g.rate(concord::earth::WGS(48.0005, 11.0025)) == dp::Optional<i32>(100));
+    CHECK(g.rate(concord::earth::WGS(48.0005, 11.0025), 1) == dp::Optional<i32>(5));
+    CHECK(g.rate(concord::earth::WGS(48.0015, 11.0005)) == dp::Optional<i32>(200));
+    CHECK_FALSE(g.rate(concord::earth::WGS(48.0015, 11.0005), 1).has_value()); // Zone 2 has no 0x0006
+    CHECK_FALSE(g.rate(concord::earth::WGS(48.0025, 11.0005)).has_value());    // Code 7: no zone
+    CHECK_FALSE(g.cell(concord::earth::WGS(47.9999, 11.0005)).has_value());
+    CHECK_FALSE(g.cell(concord::earth::WGS(48.0005, 11.0041)).has_value());
+
+    i32 out[2] = {-1, -1};
+    CHECK(g.rates(0, out));
+    CHECK(out[0] == 100);
+    CHECK(out[1] == 5);
+    CHECK_FALSE(g.rates(8, out));
+}
+
+TEST_CASE("GridMap - type 2 cells hold every product") {
+    auto grid = GridMap::from_bytes(type2_cells(), spec(2, 4), {GridZone{4, {0x0001, 0x0006}, {0, 0}}});
+    REQUIRE(grid.is_ok());
+    const GridMap &g = grid.value();
+    REQUIRE(g.products() == 2);
+    CHECK(g.rate(concord::earth::WGS(48.0025, 11.0035)) == dp::Optional<i32>(110));
+    CHECK(g.rate(concord::earth::WGS(48.0025, 11.0035), 1) == dp::Optional<i32>(-11));
+
+    i32 out[2] = {};
+    CHECK(g.rates(5, out));
+    CHECK(out[0] == 50);
+    CHECK(out[1] == -5);
+
+    GridMap picked = g;
+    picked.set_rate_product(1);
+    CHECK(picked.rate(concord::earth::WGS(48.0025, 11.0035)) == dp::Optional<i32>(-11));
+    picked.set_rate_product(GridMap::NO_PRODUCT);
+    CHECK_FALSE(picked.rate(concord::earth::WGS(48.0025, 11.0035)).has_value());
+}
+
+TEST_CASE("GridMap - cells from ENU offsets") {
+    auto grid = GridMap::from_bytes(type2_cells(), spec(2, 4), {GridZone{4, {0x0001, 0x0006}, {0, 0}}});
+    REQUIRE(grid.is_ok());
+    const GridMap &g = grid.value();
+    for (f64 lat : {48.0002, 48.0013, 48.0028}) {
+        for (f64 lon : {11.0001, 11.0017, 11.0039}) {
+            concord::earth::WGS pos(lat, lon);
+            CHECK(g.cell(g.to_local(pos)) == g.cell(pos));
+        }
+    }
+    CHECK_FALSE(g.cell(LocalPoint{-1.0f, 10.0f}).has_value());
+}
+
+TEST_CASE("GridMap - malformed grids") {
+    CHECK_FALSE(GridMap::from_bytes(dp::Vector<u8>(11, 1), spec(1), zones()).is_ok()); // Short
+    CHECK_FALSE(GridMap::from_bytes(type2_cells(), spec(2, 3), zones()).is_ok());       // No zone 3
+    CHECK_FALSE(GridMap::from_bytes(type1_cells(), spec(3), zones()).is_ok());
+    GridSpec empty = spec(1);
+    empty.cell_east = 0.0;
+    CHECK_FALSE(GridMap::from_bytes(type1_cells(), empty, zones()).is_ok());
+}
+
+TEST_CASE("GridMap - loaded from TASKDATA with its binary file") {
+    const char *xml_path = "/tmp/agrobus_grid_TASKDATA.XML";
+    const char *bin_path = "/tmp/GRD00001.bin";
+    FILE *f = std::fopen(xml_path, "wb");
+    REQUIRE(f != nullptr);
+    std::fputs(R"(<ISO11783_TaskData VersionMajor="4">
+  <TSK A="TSK1" B="Grid field" G="1">
+    <TZN A="1"><PDV A="0001" B="100"/><PDV A="0006" B="5"/></TZN>
+    <TZN A="2"><PDV A="0001" B="200"/></TZN>
+    <GRD A="48.0" B="11.0" C="0.001" D="0.001" E="4" F="3" G="GRD00001" H="12" I="1"/>
+  </TSK>
+</ISO11783_TaskData>)",
+               f);
+    std::fclose(f);
+    auto cells = type1_cells();
+    f = std::fopen(bin_path, "wb");
+    REQUIRE(f != nullptr);
+    std::fwrite(cells.data(), 1, cells.size(), f);
+    std::fclose(f);
+
+    auto loaded = load_prescription_index(xml_path, TaskDataOptions{}.ddi(0x0006));
+    REQUIRE(loaded.is_ok());
+    CHECK(loaded.value().maps.empty());
+    REQUIRE(loaded.value().grids.size() == 1);
+    const GridMap &grid = loaded.value().grids[0];
+    CHECK(grid.label() == "Grid field");
+    CHECK(grid.rate_product() == 1);
+    CHECK(grid.rate(concord::earth::WGS(48.0005, 11.0005)) == dp::Optional<i32>(5));
+
+    IsoNet nm;
+    auto *cf = nm.create_internal(Name::build().set_identity_number(1), 0, 0x10).value();
+    TCGEOInterface geo(nm, cf);
+    geo.load_prescription_maps(xml_path); // No work pool: swapped in now
+    REQUIRE(geo.grid_maps().size() == 1);
+    CHECK(geo.get_rate_at_position(concord::earth::WGS(48.0015, 11.0005)) == dp::Optional<i32>(200));
+    CHECK_FALSE(geo.get_rate_at_position(concord::earth::WGS(48.0025, 11.0005)).has_value());
+
+    geo.set_sections({SectionOffset{0.0, -10.0}, SectionOffset{0.0, 10.0}});
+    geo.set_look_ahead(0);
+    geo.set_motion(0.0, 0.0); // Heading north: the sections lie west and east of the antenna
+    geo.set_position(GeoPoint{concord::earth::WGS(48.0005, 11.0015), 0});
+    REQUIRE(geo.update_section_rates());
+    CHECK(geo.section_rates()[0] == dp::Optional<i32>(100));
+    CHECK(geo.section_rates()[1] == dp::Optional<i32>(100));
+    geo.set_position(GeoPoint{concord::earth::WGS(48.0005, 11.0001), 0});
+    REQUIRE(geo.update_section_rates());
+    CHECK_FALSE(geo.section_rates()[0].has_value()); // West of the grid
+    CHECK(geo.section_rates()[1] == dp::Optional<i32>(100));
+
+    std::remove(xml_path);
+    std::remove(bin_path);
+}
@@ -0,0 +1,237 @@
+#include <doctest/doctest.h>
+#include <agrobus/isobus/tc/geo.hpp>
+#include <agrobus/isobus/tc/prescription.hpp>
+
+using namespace agrobus::net;
+using namespace agrobus::isobus::tc;
+
+namespace {
+    PrescriptionZone square(f64 lat, f64 lon, f64 size, i32 rate) {
+        PrescriptionZone zone;
+        zone.boundary = {concord::earth::WGS(lat, lon, 0), concord::earth::WGS(lat + size, lon, 0),
+                         concord::earth::WGS(lat + size, lon + size, 0), concord::earth::WGS(lat, lon + size, 0)};
+        zone.application_rate = rate;
+        return zone;
+    }
+
+    // A field of n x n square zones, rate = row * n + column
+    PrescriptionMap grid_map(u32 n, f64 size) {
+        PrescriptionMap map;
+        map.structure_label = "GRID";
+        for (u32 r = 0; r < n; ++r)
+            for (u32 c = 0; c < n; ++c)
+                map.zones.push_back(square(48.0 + r * size, 11.0 + c * size, size, static_cast<i32>(r * n + c)));
+        return map;
+    }
+
+    dp::Optional<i32> linear_rate(const dp::Vector<PrescriptionMap> &maps, const concord::earth::WGS &pos) {
+        for (const auto &map : maps)
+            for (const auto &zone : map.zones)
+                if (point_in_polygon(pos, zone.boundary))
+                    return zone.application_rate;
+        return dp::nullopt;
+    }
+} // namespace
+
+TEST_CASE("ZoneBounds") {
+    auto b = ZoneBounds::of(square(48.0, 11.0, 0.1, 0).boundary);
+    CHECK(b.min_lat == doctest::Approx(48.0));
+    CHECK(b.max_lon == doctest::Approx(11.1));
+    CHECK(b.contains(48.05, 11.05));
+    CHECK_FALSE(b.contains(48.2, 11.05));
+    CHECK(b.intersects(ZoneBounds::of(square(48.1, 11.1, 0.1, 0).boundary)));
+    CHECK_FALSE(b.intersects(ZoneBounds::of(square(48.2, 11.0, 0.1, 0).boundary)));
+}
+
+TEST_CASE("PrescriptionIndex matches a linear scan") {
+    dp::Vector<PrescriptionMap> maps;
+    maps.push_back(grid_map(20, 0.001));
+    PrescriptionIndex index;
+    index.build(maps);
+    CHECK(index.size() == 400);
+    CHECK(index.columns() * index.rows() >= 400);
+
+    for (u32 i = 0; i < 500; ++i) {
+        // Offsets keep every point at least 0.3 m off a zone edge
+        concord::earth::WGS pos(47.999503 + (i % 23) * 0.00093, 10.999503 + (i % 29) * 0.00075, 0);
+        const PrescriptionZone *zone = index.find(maps, pos);
+        auto expected = linear_rate(maps, pos);
+        REQUIRE(static_cast<bool>(zone) == expected.has_value());
+        if (zone)
+            CHECK(zone->application_rate == *expected);
+    }
+}
+
+TEST_CASE("PrescriptionIndex tests few polygons") {
+    dp::Vector<PrescriptionMap> maps;
+    maps.push_back(grid_map(32, 0.001));
+    PrescriptionIndex index;
+    index.build(maps);
+
+    // Off the field: no polygon test at all
+    CHECK(index.find(maps, concord::earth::WGS(47.0, 10.0, 0)) == nullptr);
+    CHECK(index.polygon_tests() == 0);
+
+    // Inside a zone: only the zones whose box holds the point are tested
+    concord::earth::WGS pos(48.01055, 11.02045, 0);
+    const PrescriptionZone *zone = index.find(maps, pos);
+    REQUIRE(zone != nullptr);
+    CHECK(zone->application_rate == 10 * 32 + 20);
+    CHECK(index.polygon_tests() <= 4);
+
+    // Neighbouring boxes share edges, so the cache is not taken here, but
+    // nearby positions still cost a handful of tests each
+    u64 before = index.polygon_tests();
+    for (u32 i = 0; i < 100; ++i)
+        index.find(maps, concord::earth::WGS(48.01055 + i * 0.000003, 11.02045, 0));
+    CHECK(index.polygon_tests() - before <= 400);
+}
+
+TEST_CASE("PrescriptionIndex keeps map and zone priority") {
+    dp::Vector<PrescriptionMap> maps;
+    PrescriptionMap first;
+    first.zones.push_back(square(48.0, 11.0, 0.1, 100));
+    PrescriptionMap second;
+    second.zones.push_back(square(48.05, 11.05, 0.1, 200));
+    second.zones.push_back(square(49.0, 12.0, 0.1, 300));
+    maps.push_back(first);
+    maps.push_back(second);
+
+    PrescriptionIndex index;
+    index.build(maps);
+
+    SUBCASE("an overlap goes to the earlier map") {
+        CHECK(index.find(maps, concord::earth::WGS(48.07, 11.07, 0))->application_rate == 100);
+        CHECK(index.find(maps, concord::earth::WGS(48.12, 11.12, 0))->application_rate == 200);
+        // The cached zone overlaps an earlier one: the earlier one still wins
+        CHECK(index.find(maps, concord::earth::WGS(48.07, 11.07, 0))->application_rate == 100);
+    }
+
+    SUBCASE("a separate zone is answered from the cache") {
+        CHECK(index.find(maps, concord::earth::WGS(49.05, 12.05, 0))->application_rate == 300);
+        u64 before = index.polygon_tests();
+        CHECK(index.find(maps, concord::earth::WGS(49.06, 12.04, 0))->application_rate == 300);
+        CHECK(index.polygon_tests() - before == 1);
+    }
+
+    SUBCASE("the gap between zones has no rate") {
+        CHECK(index.find(maps, concord::earth::WGS(48.5, 11.5, 0)) == nullptr);
+    }
+
+    SUBCASE("degenerate zones are skipped") {
+        PrescriptionMap line;
+        line.zones.push_back({{concord::earth::WGS(48.0, 11.0, 0), concord::earth::WGS(48.1, 11.1, 0)}, 1});
+        maps.push_back(line);
+        index.build(maps);
+        CHECK(index.size() == 3);
+    }
+}
+
+TEST_CASE("TCGEOInterface rebuilds the index with its maps") {
+    IsoNet nm;
+    auto *cf = nm.create_internal(Name::build().set_identity_number(1), 0, 0x10).value();
+    TCGEOInterface geo(nm, cf);
+
+    geo.add_prescription_map(grid_map(4, 0.01));
+    CHECK(geo.prescription_index().size() == 16);
+    CHECK(geo.get_rate_at_position(concord::earth::WGS(48.025, 11.015, 0)) == 9);
+
+    PrescriptionMap extra;
+    extra.zones.push_back(square(50.0, 13.0, 0.1, 77));
+    geo.add_prescription_map(extra);
+    CHECK(geo.prescription_index().size() == 17);
+    CHECK(geo.get_rate_at_position(concord::earth::WGS(50.05, 13.05, 0)) == 77);
+
+    geo.clear_prescription_maps();
+    CHECK(geo.prescription_index().empty());
+    CHECK_FALSE(geo.get_rate_at_position(concord::earth::WGS(50.05, 13.05, 0)).has_value());
+}
+
+TEST_CASE("PrescriptionIndex projects zones into a metric frame") {
+    dp::Vector<PrescriptionMap> maps;
+    PrescriptionMap map;
+    map.zones.push_back(square(70.0, 20.0, 0.001, 1)); // Far north: 1e-3 deg of longitude is ~38 m
+    maps.push_back(map);
+    PrescriptionIndex index;
+    index.build(maps);
+    CHECK(index.vertices() == 5); // Closed ring
+    CHECK(index.origin().latitude == doctest::Approx(70.0005));
+
+    LocalPoint sw = index.to_local(concord::earth::WGS(70.0, 20.0, 0));
+    LocalPoint ne = index.to_local(concord::earth::WGS(70.001, 20.001, 0));
+    CHECK(ne.north - sw.north == doctest::Approx(111.6).epsilon(0.01));
+    CHECK(ne.east - sw.east == doctest::Approx(38.1).epsilon(0.02));
+
+    // A position 1 m inside the east edge is in; 1 m outside is not
+    u32 hint = PrescriptionIndex::NO_HINT;
+    LocalPoint mid{(sw.east + ne.east) / 2, (sw.north + ne.north) / 2};
+    CHECK(index.find(maps, LocalPoint{ne.east - 1.0f, mid.north}, hint) != nullptr);
+    CHECK(index.find(maps, LocalPoint{ne.east + 1.0f, mid.north}, hint) == nullptr);
+}
+
+TEST_CASE("crossing_number") {
+    // Closed ring of a concave (L-shaped) polygon
+    f32 xs[] = {0, 10, 10, 5, 5, 0, 0};
+    f32 ys[] = {0, 0, 5, 5, 10, 10, 0};
+    CHECK(crossing_number(xs, ys, 6, {2, 2}));
+    CHECK(crossing_number(xs, ys, 6, {2, 8}));
+    CHECK(crossing_number(xs, ys, 6, {8, 2}));
+    CHECK_FALSE(crossing_number(xs, ys, 6, {8, 8}));
+    CHECK_FALSE(crossing_number(xs, ys, 6, {-1, 2}));
+    CHECK_FALSE(crossing_number(xs, ys, 6, {2, 11}));
+
+    SUBCASE("matches an edge at a time") {
+        // Star-shaped rings with edge counts around the vector steps, so the
+        // vector loop and the scalar tail both run
+        for (u32 edges : {3u, 4u, 7u, 8u, 9u, 16u, 17u, 37u}) {
+            CAPTURE(edges);
+            dp::Vector<f32> rx, ry;
+            for (u32 k = 0; k <= edges; ++k) {
+                f64 angle = 2.0 * 3.14159265358979 * (k % edges) / edges;
+                f64 radius = (k % 2 == 0) ? 100.0 : 40.0;
+                rx.push_back(static_cast<f32>(radius * std::cos(angle)));
+                ry.push_back(static_cast<f32>(radius * std::sin(angle)));
+            }
+            usize mismatches = 0;
+            for (f32 e = -110.3f; e < 110.0f; e += 7.1f) {
+                for (f32 n = -110.7f; n < 110.0f; n += 6.9f) {
+                    bool inside = false;
+                    for (u32 k = 0; k < edges; ++k) {
+                        f64 xa = rx[k], ya = ry[k], xb = rx[k + 1], yb = ry[k + 1];
+                        if ((ya > n) != (yb > n) && e < xa + (n - ya) * (xb - xa) / (yb - ya))
+                            inside = !inside;
+                    }
+                    mismatches += crossing_number(rx.data(), ry.data(), edges, {e, n}) != inside ? 1 : 0;
+                }
+            }
+            CHECK(mismatches == 0);
+        }
+    }
+}
+
+TEST_CASE("PrescriptionIndex batch lookup keeps a hint per position") {
+    dp::Vector<PrescriptionMap> maps;
+    PrescriptionMap map;
+    map.zones.push_back(square(48.0, 11.0, 0.1, 10));
+    map.zones.push_back(square(48.0, 11.2, 0.1, 20));
+    maps.push_back(map);
+    PrescriptionIndex index;
+    index.build(maps);
+
+    dp::Vector<concord::earth::WGS> positions = {concord::earth::WGS(48.05, 11.05, 0),
+                                                 concord::earth::WGS(48.05, 11.15, 0),
+                                                 concord::earth::WGS(48.05, 11.25, 0)};
+    dp::Vector<u32> hints;
+    dp::Vector<dp::Optional<i32>> rates;
+    index.rates_at(maps, positions, hints, rates);
+    REQUIRE(rates.size() == 3);
+    CHECK(rates[0] == 10);
+    CHECK_FALSE(rates[1].has_value());
+    CHECK(rates[2] == 20);
+    CHECK(hints[1] == PrescriptionIndex::NO_HINT);
+
+    // Each position stays in its zone: one polygon test apiece from the hints
+    u64 before = index.polygon_tests();
+    index.rates_at(maps, positions, hints, rates);
+    CHECK(index.polygon_tests() - before == 2);
+}
@@ -0,0 +1,157 @@
+#include <doctest/doctest.h>
+#include <agrobus/isobus/tc/ddi_database.hpp>
+#include <agrobus/isobus/tc/section_state.hpp>
+
+using namespace agrobus::net;
+using namespace agrobus::isobus::tc;
+
+namespace {
+    struct Sent {
+        DDI ddi;
+        i32 value;
+    };
+
+    dp::Vector<Sent> flush_actual(SectionStateEngine &engine) {
+        dp::Vector<Sent> out;
+        engine.flush_actual([&](DDI d, i32 v) { out.push_back({d, v}); });
+        return out;
+    }
+} // namespace
+
+TEST_CASE("SectionBits") {
+    SectionBits b = SectionBits::first(70);
+    CHECK(b.count() == 70);
+    CHECK(b.test(69));
+    CHECK_FALSE(b.test(70));
+    CHECK(b.block(4) == 0x003F); // Sections 65-70
+    b.set_block(4, 0xFF00);
+    CHECK(b.block(4) == 0xFF00);
+    CHECK(b.block(3) == 0xFFFF);
+    CHECK((b & ~b).none());
+    CHECK((b ^ b) == SectionBits{});
+
+    u8 overlap[8] = {0, 10, 50, 90, 100, 49, 51, 0};
+    SectionBits over = SectionBits::at_least(overlap, 8, 50);
+    CHECK(over.count() == 4);
+    CHECK(over.test(2));
+    CHECK(over.test(6));
+    CHECK_FALSE(over.test(5));
+}
+
+TEST_CASE("SectionBits::at_least matches a section at a time") {
+    // Counts around the vector steps, so the vector loop and the scalar tail both run
+    u8 levels[condensed::MAX_SECTIONS + 8];
+    for (usize i = 0; i < sizeof(levels); ++i)
+        levels[i] = static_cast<u8>((i * 73 + 11) % 256);
+    for (u16 count : {0, 15, 16, 17, 31, 32, 33, 96, 200, 255, 256, 264}) {
+        for (u8 threshold : {0, 1, 50, 128, 200, 255}) {
+            CAPTURE(count);
+            CAPTURE(threshold);
+            SectionBits bits = SectionBits::at_least(levels, count, threshold);
+            SectionBits expected;
+            for (u16 i = 0; i < count && i < condensed::MAX_SECTIONS; ++i)
+                expected.set(i, levels[i] >= threshold);
+            CHECK(bits == expected);
+        }
+    }
+}
+
+TEST_CASE("Condensed work state encoding") {
+    CHECK(condensed::spread(0x0001) == 0x00000001u);
+    CHECK(condensed::spread(0x8001) == 0x40000001u);
+    CHECK(condensed::gather(0x40000001u) == 0x8001);
+    CHECK(condensed::actual_ddi(5) == ddi::ACTUAL_CONDENSED_WORK_STATE_81_96);
+    CHECK(condensed::setpoint_ddi(15) == ddi::SETPOINT_CONDENSED_WORK_STATE_241_256);
+    CHECK(condensed::setpoint_block(ddi::SETPOINT_CONDENSED_WORK_STATE_17_32) == 1);
+    CHECK(condensed::actual_block(ddi::SETPOINT_CONDENSED_WORK_STATE_17_32) == -1);
+
+    SectionStateEngine engine(20);
+    engine.set_actual(0, true);
+    engine.set_actual(17, true);
+    engine.set_error(1, true);
+    CHECK(static_cast<u32>(engine.encode(engine.actual(), 0, true)) == 0x00000009u); // 01, 10, then off
+    // Block 1: sections 17-20 installed, 18 on, the rest not installed
+    CHECK(static_cast<u32>(engine.encode(engine.actual(), 1)) == 0xFFFFFF04u);
+}
+
+TEST_CASE("SectionStateEngine sends changed blocks only") {
+    SectionStateEngine engine(96);
+    CHECK(engine.blocks() == 6);
+
+    auto first = flush_actual(engine);
+    CHECK(first.size() == 6); // Everything once after start
+    CHECK(flush_actual(engine).empty());
+
+    engine.set_actual(40, true); // Block 2
+    engine.set_actual(95, true); // Block 5
+    auto sent = flush_actual(engine);
+    REQUIRE(sent.size() == 2);
+    CHECK(sent[0].ddi == ddi::ACTUAL_CONDENSED_WORK_STATE_33_48);
+    CHECK(sent[0].value == (1 << 16));
+    CHECK(sent[1].ddi == ddi::ACTUAL_CONDENSED_WORK_STATE_81_96);
+    CHECK(static_cast<u32>(sent[1].value) == 0x40000000u);
+
+    engine.set_error(3, true);
+    sent = flush_actual(engine);
+    REQUIRE(sent.size() == 1);
+    CHECK(sent[0].ddi == ddi::ACTUAL_CONDENSED_WORK_STATE_1_16);
+
+    engine.set_actual(100, true); // Not installed
+    CHECK(flush_actual(engine).empty());
+
+    engine.reset();
+    CHECK(flush_actual(engine).size() == 6);
+}
+
+TEST_CASE("SectionStateEngine coverage and setpoints") {
+    SectionStateEngine engine(32);
+    SectionBits all = SectionBits::first(32);
+
+    SUBCASE("covered and outside sections switch off") {
+        SectionBits covered;
+        covered.set(3);
+        covered.set(4);
+        SectionBits inside = all;
+        inside.reset(31);
+        SectionBits changed = engine.evaluate(all, covered, inside);
+        CHECK(changed.count() == 29);
+        CHECK(engine.desired().count() == 29);
+        CHECK_FALSE(engine.desired().test(3));
+        CHECK_FALSE(engine.desired().test(31));
+        CHECK(engine.mismatched().count() == 29);
+
+        covered.reset(3);
+        changed = engine.evaluate(all, covered, inside);
+        CHECK(changed.count() == 1);
+        CHECK(changed.test(3));
+    }
+
+    SUBCASE("overlap in percent") {
+        u8 overlap[32] = {};
+        overlap[10] = 80;
+        overlap[11] = 20;
+        engine.evaluate(all, overlap, 50, all);
+        CHECK(engine.desired().count() == 31);
+        CHECK_FALSE(engine.desired().test(10));
+    }
+
+    SUBCASE("setpoint flush and receive round trip") {
+        engine.set_desired(0, true);
+        engine.set_desired(20, true);
+        dp::Vector<Sent> sent;
+        engine.flush_desired([&](DDI d, i32 v) { sent.push_back({d, v}); });
+        REQUIRE(sent.size() == 2);
+        CHECK(sent[1].ddi == ddi::SETPOINT_CONDENSED_WORK_STATE_17_32);
+
+        SectionStateEngine implement(32);
+        for (auto &s : sent)
+            CHECK(implement.receive_setpoint(s.ddi, s.value));
+        CHECK(implement.desired() == engine.desired());
+        CHECK_FALSE(implement.receive_setpoint(ddi::SETPOINT_CONDENSED_WORK_STATE_33_48, 0x55555555)); // Block 2
+        CHECK_FALSE(implement.receive_setpoint(ddi::ACTUAL_WORK_STATE, 1));
+
+        // 2 (error) and 3 (not installed / no change) leave a section off
+        CHECK(implement.receive_setpoint(ddi::SETPOINT_CONDENSED_WORK_STATE_1_16, static_cast<i32>(0xFFFFFFF6u)));
+        CHECK(implement.desired().block(0) == 0x0002);
+    }
+}
@@ -83,3 +83,115 @@ TEST_CASE("TaskControllerServer - update sends status") {
         server.update(100);
     }
 }
+
+// ─── Per-client value store over a loopback bus ───────────────────────────────
+#include <agrobus/net/loopback_bus.hpp>
+
+TEST_CASE("TaskControllerServer - client value store") {
+    LoopbackBus bus;
+    IsoNet nm_tc;
+    IsoNet nm_ecu;
+    auto *tc_cf = nm_tc.create_internal(Name::build().set_identity_number(1), 0, 0xF7).value();
+    auto *ecu_cf = nm_ecu.create_internal(Name::build().set_identity_number(2), 0, 0x80).value();
+    bus.attach(nm_tc);
+    bus.attach(nm_ecu);
+    REQUIRE(nm_tc.start_address_claiming().is_ok());
+    REQUIRE(nm_ecu.start_address_claiming().is_ok());
+
+    TaskControllerServer server(nm_tc, tc_cf);
+    server.start();
+    dp::Vector<dp::Vector<u8>> received;
+    nm_ecu.register_pgn_callback(PGN_TC_TO_ECU, [&](const Message &msg) {
+        if ((msg.data[0] & 0x0F) == static_cast<u8>(ProcessDataCommands::Value))
+            received.push_back(msg.data);
+    });
+    auto run = [&](u32 steps) {
+        for (u32 i = 0; i < steps; ++i) {
+            nm_tc.update(5);
+            nm_ecu.update(5);
+            server.update(5);
+        }
+    };
+    auto send_to_tc = [&](ProcessDataCommands cmd, ElementNumber elem, DDI ddi, i32 value) {
+        dp::Vector<u8> data(8, 0xFF);
+        data[0] = (static_cast<u8>(cmd) & 0x0F) | ((static_cast<u8>(elem) & 0x0F) << 4);
+        data[1] = static_cast<u8>((elem >> 4) & 0xFF);
+        data[2] = static_cast<u8>(ddi & 0xFF);
+        data[3] = static_cast<u8>((ddi >> 8) & 0xFF);
+        for (u8 i = 0; i < 4; ++i)
+            data[4 + i] = static_cast<u8>((static_cast<u32>(value) >> (8 * i)) & 0xFF);
+        ControlFunction tc;
+        tc.address = tc_cf->address();
+        nm_ecu.send(PGN_ECU_TO_TC, data, ecu_cf, &tc);
+    };
+    auto to_tc = [&](ProcessDataCommands cmd, ElementNumber elem, DDI ddi, i32 value) {
+        send_to_tc(cmd, elem, ddi, value);
+        run(2);
+    };
+    run(60); // Address claims
+
+    Address ecu = ecu_cf->address();
+    CHECK_FALSE(server.set_value(ecu, 1, 0x0001, 5).is_ok()); // Not a client yet
+    to_tc(ProcessDataCommands::TechnicalCapabilities, 0, 0, 0);
+    REQUIRE(server.client(ecu) != nullptr);
+
+    SUBCASE("reported values are kept") {
+        to_tc(ProcessDataCommands::Value, 3, 0x0002, 480);
+        CHECK(server.client(ecu)->values.get(3, 0x0002) == 480);
+        CHECK(server.client(ecu)->values.dirty_count() == 0);
+    }
+
+    SUBCASE("setpoints answer requests and go out together") {
+        bool asked = false;
+        server.on_value_request([&](ElementNumber, DDI, TCClientInfo *) -> Result<i32> {
+            asked = true;
+            return Result<i32>::ok(0);
+        });
+        REQUIRE(server.set_value(ecu, 1, 0x0001, 300).is_ok());
+        REQUIRE(server.set_value(ecu, 2, 0x0001, 400).is_ok());
+        received.clear();
+        to_tc(ProcessDataCommands::RequestValue, 2, 0x0001, 0);
+        CHECK_FALSE(asked);
+        REQUIRE(received.size() == 1);
+        CHECK((received[0][4] | (received[0][5] << 8)) == 400);
+
+        received.clear();
+        CHECK(server.send_values(ecu) == 2);
+        run(2);
+        CHECK(received.size() == 2);
+        CHECK(server.send_values(ecu) == 0);
+    }
+
+    SUBCASE("values arrive in one batch per update") {
+        dp::Vector<usize> sizes;
+        ValueBatch last;
+        u32 single = 0;
+        server.on_value_received([&](ElementNumber, DDI, i32, TCClientInfo *) {
+            ++single;
+            return Result<ProcessDataAcknowledgeErrorCodes>::ok(ProcessDataAcknowledgeErrorCodes::NoError);
+        });
+        server.on_values_received([&](const ValueBatch &batch) {
+            sizes.push_back(batch.size());
+            last = batch;
+        });
+        for (i32 i = 0; i < 5; ++i)
+            send_to_tc(ProcessDataCommands::Value, static_cast<ElementNumber>(i), 0x0002, 100 + i);
+        nm_tc.update(5);
+        nm_ecu.update(5);
+        nm_tc.update(5);
+        CHECK(sizes.empty()); // Collected until the server update
+        server.update(5);
+        REQUIRE(sizes.size() == 1);
+        CHECK(sizes[0] == 5);
+        CHECK(single == 5);
+        REQUIRE(last.size() == 5);
+        CHECK(last.clients[4] == ecu);
+        CHECK(last.elements[3] == 3);
+        CHECK(last.ddis[0] == 0x0002);
+        CHECK(last.values[4] == 104);
+        CHECK(last.timestamps_us.size() == 5);
+        server.update(5);
+        CHECK(sizes.size() == 1); // Nothing new, no call
+        CHECK(server.client(0x42) == nullptr);
+    }
+}
@@ -0,0 +1,84 @@
+#include <doctest/doctest.h>
+#include <agrobus/isobus/tc/value_store.hpp>
+
+using namespace agrobus::net;
+using namespace agrobus::isobus::tc;
+
+namespace {
+    DDOP store_ddop() {
+        DDOP ddop;
+        ddop.add_device(DeviceObject{}.set_id(1).set_designator("Seeder"));
+        DeviceElement root;
+        root.id = 2;
+        root.type = DeviceElementType::Device;
+        root.number = 0;
+        root.parent_id = 1;
+        root.child_objects = {10, 11};
+        ddop.add_element(root);
+        DeviceElement section;
+        section.id = 3;
+        section.type = DeviceElementType::Section;
+        section.number = 4;
+        section.parent_id = 2;
+        section.child_objects = {10};
+        ddop.add_element(section);
+        ddop.add_process_data(DeviceProcessData{}.set_id(10).set_ddi(0x0001));
+        ddop.add_property(DeviceProperty{}.set_id(11).set_ddi(0x0043).set_value(12000));
+        return ddop;
+    }
+} // namespace
+
+TEST_CASE("ProcessDataStore from a DDOP") {
+    auto store = ProcessDataStore::from_ddop(store_ddop());
+    CHECK(store.size() == 3);
+    CHECK(store.contains(0, 0x0001));
+    CHECK(store.contains(4, 0x0001));
+    CHECK_FALSE(store.contains(4, 0x0043));
+
+    SUBCASE("properties start with their value, process data unset") {
+        CHECK(store.get(0, 0x0043) == 12000);
+        CHECK(store.find(0, 0x0043)->property);
+        CHECK_FALSE(store.get(0, 0x0001).has_value());
+        CHECK(store.dirty_count() == 0);
+    }
+
+    SUBCASE("writes are stamped and sent once") {
+        store.update(250);
+        store.set(4, 0x0001, 500);
+        store.set(0, 0x0001, 300);
+        store.set(4, 0x0001, 500); // Unchanged: still one entry to send
+        CHECK(store.dirty_count() == 2);
+        CHECK(store.find(4, 0x0001)->updated_ms == 250);
+
+        dp::Vector<ElementNumber> order;
+        CHECK(store.flush_dirty([&](const ProcessDataStore::Value &v) {
+            order.push_back(v.element);
+            return true;
+        }) == 2);
+        REQUIRE(order.size() == 2);
+        CHECK(order[0] == 0); // Slot order
+        CHECK(order[1] == 4);
+        CHECK(store.dirty_count() == 0);
+        CHECK(store.flush_dirty([](const ProcessDataStore::Value &) { return true; }) == 0);
+    }
+
+    SUBCASE("a failed send stays dirty") {
+        store.set(0, 0x0001, 1);
+        CHECK(store.flush_dirty([](const ProcessDataStore::Value &) { return false; }) == 0);
+        CHECK(store.dirty(0, 0x0001));
+    }
+
+    SUBCASE("values from the peer are not sent back") {
+        store.receive(4, 0x0001, 77);
+        CHECK(store.get(4, 0x0001) == 77);
+        CHECK(store.dirty_count() == 0);
+    }
+
+    SUBCASE("unknown keys are added on write") {
+        for (ElementNumber e = 0; e < 100; ++e)
+            store.set(e, 0x0086, e);
+        CHECK(store.size() == 103);
+        CHECK(store.dirty_count() == 100);
+        CHECK(store.get(99, 0x0086) == 99);
+    }
+}
@@ -0,0 +1,180 @@
+#include <doctest/doctest.h>
+#include <agrobus/net/telemetry_uplink.hpp>
+
+using namespace agrobus::net;
+
+namespace {
+
+    constexpr PGN EEC1 = 0xF004;
+    constexpr PGN ET1 = 0xFEEE;
+
+    // Engine speed (SPN 190, bytes 4-5) and coolant temperature (SPN 110, byte 1)
+    void store(LastValueCache &cache, u64 now_ms, u16 rpm_raw, u8 coolant_raw) {
+        cache.set_now(now_ms);
+        u8 eec1[8] = {0xFF, 0xFF, 0xFF, static_cast<u8>(rpm_raw), static_cast<u8>(rpm_raw >> 8), 0xFF, 0xFF, 0xFF};
+        u8 et1[8] = {coolant_raw, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+        cache.store(EEC1, 0x00, DataSpan(eec1, 8), now_ms * 1000);
+        cache.store(ET1, 0x00, DataSpan(et1, 8), now_ms * 1000);
+    }
+
+} // namespace
+
+TEST_CASE("Uplink block compressor round-trips") {
+    uplink::BlockCompressor lz;
+    dp::Vector<u8> repetitive;
+    for (u32 i = 0; i < 2000; ++i)
+        repetitive.push_back(static_cast<u8>(i % 3 == 0 ? 0x64 : i % 7));
+    dp::Vector<u8> noise;
+    u32 x = 12345;
+    for (u32 i = 0; i < 300; ++i) {
+        x = x * 1103515245u + 12345u;
+        noise.push_back(static_cast<u8>(x >> 16));
+    }
+
+    for (const auto *in : {&repetitive, &noise}) {
+        dp::Vector<u8> packed;
+        lz.compress(DataSpan(in->data(), in->size()), packed);
+        dp::Vector<u8> back;
+        REQUIRE(uplink::BlockCompressor::decompress(DataSpan(packed.data(), packed.size()), in->size(), back).is_ok());
+        CHECK(back == *in);
+        if (in == &repetitive)
+            CHECK(packed.size() < in->size() / 10);
+    }
+
+    dp::Vector<u8> empty;
+    dp::Vector<u8> packed;
+    lz.compress(DataSpan(), packed);
+    CHECK(uplink::BlockCompressor::decompress(DataSpan(packed.data(), packed.size()), 0, empty).is_ok());
+    CHECK_FALSE(uplink::BlockCompressor::decompress(DataSpan(packed.data(), packed.size()), 5, empty).is_ok());
+}
+
+TEST_CASE("TelemetryUplink - changed SPN values reach the decoder as deltas") {
+    LastValueCache cache;
+    TelemetryUplink up(cache, nullptr, TelemetryUplinkConfig{}.batch(10000).keyframes(3));
+    auto rpm = up.add_spn(EEC1, 0x00, 24, 16, 1000);
+    auto coolant = up.add_spn(ET1, 0x00, 0, 8, 5000);
+    REQUIRE(rpm.is_ok());
+    REQUIRE(coolant.is_ok());
+    CHECK(cache.tracked(EEC1));
+    CHECK_FALSE(up.add_spn(EEC1, 0x00, 60, 8, 1000).is_ok()); // Past the frame
+
+    dp::Vector<dp::Vector<u8>> packets;
+    bool link_up = true;
+    up.set_sink([&](DataSpan p) {
+        if (!link_up)
+            return false;
+        packets.push_back(dp::Vector<u8>(p.data(), p.data() + p.size()));
+        return true;
+    });
+
+    // Two minutes: EEC1 at 100 Hz, the engine speed steps every 4 s, coolant is steady
+    u64 frames = 0;
+    for (u32 ms = 10; ms <= 120000; ms += 10) {
+        store(cache, ms, static_cast<u16>(6400 + (ms / 4000) * 8), 120);
+        frames += 2;
+        up.update(10);
+    }
+    up.flush();
+
+    TelemetryDecoder rx;
+    for (const auto &p : packets) {
+        auto decoded = rx.decode(DataSpan(p.data(), p.size()));
+        REQUIRE(decoded.is_ok());
+    }
+    CHECK(rx.synced());
+    CHECK(rx.value(rpm.value()) == up.latest(rpm.value()));
+    CHECK(rx.value(coolant.value()) == 120);
+    CHECK(up.stats().unchanged > 0);
+
+    // 24 000 frames would cost ~16 bytes each forwarded raw
+    u64 raw = frames * 16;
+    CHECK(up.stats().bytes * 100 < raw);
+
+    SUBCASE("a lost packet holds samples back until the next keyframe") {
+        TelemetryDecoder late;
+        auto first = late.decode(DataSpan(packets[0].data(), packets[0].size()));
+        REQUIRE(first.is_ok());
+        CHECK(first.value().keyframe);
+        REQUIRE(first.value().samples.size() >= 2);
+        CHECK(first.value().samples[0].value == 6400); // Absolute in a keyframe
+        CHECK(first.value().samples[1].value == 120);
+        auto skipped = late.decode(DataSpan(packets[2].data(), packets[2].size()));
+        REQUIRE(skipped.is_ok());
+        CHECK_FALSE(late.synced());
+        CHECK(skipped.value().samples.empty());
+        CHECK(late.lost() == 1);
+        for (usize i = 3; i < packets.size(); ++i)
+            REQUIRE(late.decode(DataSpan(packets[i].data(), packets[i].size())).is_ok());
+        CHECK(late.synced());
+        CHECK(late.value(rpm.value()) == up.latest(rpm.value()));
+    }
+
+    SUBCASE("a refused packet makes the next one a keyframe") {
+        usize before = packets.size();
+        link_up = false;
+        for (u32 ms = 0; ms < 12000; ms += 10) {
+            store(cache, 120000 + ms, static_cast<u16>(7000 + ms), 121);
+            up.update(10);
+        }
+        CHECK(up.stats().send_failures >= 1);
+        link_up = true;
+        for (u32 ms = 0; ms < 12000; ms += 10) {
+            store(cache, 132000 + ms, 9000, 122);
+            up.update(10);
+        }
+        REQUIRE(packets.size() > before);
+        CHECK((packets[before][1] & uplink_flags::KEYFRAME) != 0);
+        for (usize i = before; i < packets.size(); ++i)
+            REQUIRE(rx.decode(DataSpan(packets[i].data(), packets[i].size())).is_ok());
+        CHECK(rx.value(rpm.value()) == 9000);
+        CHECK(rx.value(coolant.value()) == 122);
+    }
+}
+
+TEST_CASE("TelemetryUplink - stale and not-available values are not sampled") {
+    LastValueCache cache;
+    TelemetryUplink up(cache, nullptr, TelemetryUplinkConfig{}.stale(500));
+    u16 rpm = up.add_spn(EEC1, 0x00, 24, 16, 100).value();
+    store(cache, 0, 0xFFFF, 0);
+    up.update(100);
+    CHECK_FALSE(up.latest(rpm).has_value());
+    store(cache, 100, 1234, 0);
+    up.update(100);
+    CHECK(up.latest(rpm) == 1234);
+    cache.set_now(1000);
+    up.update(100);
+    CHECK(up.latest(rpm) == 1234); // Stale: the last sample stays
+    CHECK(up.stats().samples == 1);
+}
+
+TEST_CASE("TelemetryUplink - traffic summaries of the busiest streams") {
+    LastValueCache cache;
+    TrafficProfiler profiler(64);
+    TelemetryUplink up(cache, &profiler, TelemetryUplinkConfig{}.traffic(1000, 2).batch(1000));
+    dp::Vector<u8> last;
+    up.set_sink([&](DataSpan p) {
+        last.assign(p.data(), p.data() + p.size());
+        return true;
+    });
+
+    u8 data[8] = {};
+    for (u32 i = 0; i < 50; ++i) {
+        profiler.record(Frame::from_message(Priority::Default, EEC1, 0x00, BROADCAST_ADDRESS, data, 8), 0, i * 10000);
+        if (i % 5 == 0)
+            profiler.record(Frame::from_message(Priority::Default, ET1, 0x00, BROADCAST_ADDRESS, data, 8), 0, i);
+        if (i % 10 == 0)
+            profiler.record(Frame::from_message(Priority::Default, 0xFEF1, 0x17, BROADCAST_ADDRESS, data, 8), 0, i);
+    }
+    for (u32 i = 0; i < 20; ++i)
+        up.update(100);
+
+    TelemetryDecoder rx;
+    auto packet = rx.decode(DataSpan(last.data(), last.size()));
+    REQUIRE(packet.is_ok());
+    REQUIRE(packet.value().traffic.size() == 2);
+    CHECK(packet.value().traffic[0].pgn == EEC1);
+    CHECK(packet.value().traffic[0].frames == 50);
+    CHECK(packet.value().traffic[0].bytes == 400);
+    CHECK(packet.value().traffic[1].pgn == ET1);
+    CHECK(packet.value().traffic[1].frames == 10);
+}
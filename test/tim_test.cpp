@@ -123,3 +123,122 @@ TEST_CASE("TimServer - update loop") {
         server.update(50);
     }
 }
+
+namespace {
+    struct TimBus {
+        IsoNet tractor, implement;
+        InternalCF *tractor_cf = nullptr, *implement_cf = nullptr;
+        LoopbackBus bus;
+
+        TimBus() {
+            tractor_cf = tractor.create_internal(Name::build().set_identity_number(1), 0, 0x10).value();
+            implement_cf = implement.create_internal(Name::build().set_identity_number(2), 0, 0x80).value();
+            bus.attach(tractor);
+            bus.attach(implement);
+            REQUIRE(tractor.start_address_claiming().is_ok());
+            REQUIRE(implement.start_address_claiming().is_ok());
+            run(40);
+        }
+
+        void run(u32 steps, TimServer *server = nullptr) {
+            for (u32 i = 0; i < steps; ++i) {
+                tractor.update(10);
+                implement.update(10);
+                if (server)
+                    server->update(10);
+            }
+        }
+    };
+} // namespace
+
+TEST_CASE("TimServer sends changes at once and everything on the refresh") {
+    TimBus b;
+    TimServer server(b.tractor, b.tractor_cf, TimServerConfig{}.interval(100));
+    TimClient client(b.implement, b.implement_cf);
+    REQUIRE(server.initialize().is_ok());
+    REQUIRE(client.initialize().is_ok());
+    for (u8 i = 0; i < 12; ++i)
+        server.set_aux_valve_capabilities(i, true, true);
+
+    u32 pto_frames = 0;
+    client.on_front_pto_updated.subscribe([&](const PTOState &) { ++pto_frames; });
+    dp::Vector<u8> valve_updates;
+    client.on_aux_valve_updated.subscribe([&](u8 idx, const AuxValve &) { valve_updates.push_back(idx); });
+
+    b.run(10, &server); // One refresh: 4 PTO/hitch frames and 12 valves in 6 frames
+    b.run(2);
+    CHECK(server.frames_sent() == 10);
+    CHECK(pto_frames == 1);
+    CHECK(valve_updates.size() == 12);
+
+    u64 before = server.frames_sent();
+    valve_updates.clear();
+    server.set_front_pto(true, true, 540);
+    server.set_front_pto(true, true, 540); // Same value: nothing more to send
+    server.set_aux_valve(3, true, 400);
+    server.set_aux_valve(7, true, 200);
+    server.set_aux_valve(9, false, 0); // Unchanged
+    b.run(1, &server);
+    b.run(1);
+    CHECK(server.frames_sent() - before == 2); // Front PTO, valves 3 and 7 together
+    CHECK(client.get_front_pto().speed == 540);
+    REQUIRE(valve_updates.size() == 2);
+    CHECK(valve_updates[0] == 3);
+    CHECK(valve_updates[1] == 7);
+    CHECK(client.get_aux_valve(3).state);
+    CHECK(client.get_aux_valve(7).flow == 200);
+
+    before = server.frames_sent();
+    b.run(5, &server); // No change and no refresh yet
+    CHECK(server.frames_sent() == before);
+
+    // The refresh runs from IsoNet::update() on the network clock
+    b.run(2);
+    CHECK(server.frames_sent() - before == 10);
+}
+
+TEST_CASE("TimClient applies staged valve requests in the fewest frames") {
+    TimBus b;
+    TimClient client(b.implement, b.implement_cf);
+    REQUIRE(client.initialize().is_ok());
+
+    dp::Vector<u8> requested;
+    u32 frames = 0;
+    b.tractor.register_pgn_callback(PGN_AUX_VALVE_0_7, [&](const Message &msg) {
+        ++frames;
+        for (usize off = 0; off + 4 <= msg.data.size(); off += 4)
+            if (msg.data[off] < agrobus::isobus::MAX_AUX_VALVES)
+                requested.push_back(msg.data[off]);
+    });
+
+    for (u8 i = 0; i < 12; ++i)
+        REQUIRE(client.stage_aux_valve(i, false, 0).is_ok());
+    CHECK(client.stage_aux_valve(agrobus::isobus::MAX_AUX_VALVES, true, 0).is_err());
+    REQUIRE(client.apply_aux_valves().is_ok());
+    b.run(2);
+    CHECK(frames == 6); // Every valve is new
+    CHECK(requested.size() == 12);
+
+    // Same states again: nothing to send
+    for (u8 i = 0; i < 12; ++i)
+        client.stage_aux_valve(i, false, 0);
+    REQUIRE(client.apply_aux_valves().is_ok());
+    b.run(2);
+    CHECK(frames == 6);
+
+    // Three valves move: two frames
+    requested.clear();
+    AuxValveBank wanted;
+    wanted.set(2, true, 100);
+    wanted.set(5, true, 250);
+    wanted.set(11, true, 50);
+    client.stage_aux_valves(wanted, AuxValveBank::bit(2) | AuxValveBank::bit(5) | AuxValveBank::bit(11));
+    REQUIRE(client.apply_aux_valves().is_ok());
+    b.run(2);
+    CHECK(frames == 8);
+    CHECK(client.request_frames() == 8);
+    REQUIRE(requested.size() == 3);
+    CHECK(requested[0] == 2);
+    CHECK(requested[1] == 5);
+    CHECK(requested[2] == 11);
+}
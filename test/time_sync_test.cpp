@@ -0,0 +1,99 @@
+#include <doctest/doctest.h>
+#include <agrobus/j1939/time_date.hpp>
+#include <agrobus/j1939/time_sync.hpp>
+#include <agrobus/net/loopback_bus.hpp>
+
+using namespace agrobus::j1939;
+
+static_assert(TimeSync::days_from_civil(1970, 1, 1) == 0);
+static_assert(TimeSync::days_from_civil(2000, 3, 1) == 11017);
+
+TEST_CASE("TimeSync estimates offset and drift from samples") {
+    IsoNet net;
+    TimeSync sync(net);
+    CHECK_FALSE(sync.synced());
+    CHECK(sync.bus_time_at(1'000'000) == 0);
+
+    // Bus clock 1.7e15 us ahead and running 100 ppm fast
+    const u64 base = 1'700'000'000'000'000ull;
+    auto bus_at = [&](u64 local) { return base + local + local / 10'000; };
+    for (u64 t = 1; t <= 10; ++t)
+        CHECK(sync.add_sample(TimeSyncSource::SystemTime, bus_at(t * 1'000'000), t * 1'000'000));
+
+    REQUIRE(sync.synced());
+    CHECK(sync.source() == TimeSyncSource::SystemTime);
+    CHECK(sync.estimate().samples == 10);
+    CHECK(sync.estimate().drift_ppb == doctest::Approx(100'000).epsilon(0.01));
+    i64 err = static_cast<i64>(sync.bus_time_at(30'000'000) - bus_at(30'000'000));
+    CHECK(err < 10);
+    CHECK(err > -10);
+
+    SUBCASE("a jump restarts the fit") {
+        i64 step = 0;
+        sync.on_step.subscribe([&](i64 us) { step = us; });
+        CHECK(sync.add_sample(TimeSyncSource::SystemTime, bus_at(11'000'000) + 60'000'000, 11'000'000));
+        CHECK(step > 59'000'000);
+        CHECK(sync.estimate().samples == 1);
+        CHECK(sync.bus_time_at(11'000'000) == bus_at(11'000'000) + 60'000'000);
+    }
+
+    SUBCASE("the most precise recent source wins") {
+        CHECK(sync.add_sample(TimeSyncSource::GNSS, bus_at(11'000'000), 11'000'000));
+        CHECK(sync.source() == TimeSyncSource::GNSS);
+        CHECK(sync.estimate().samples == 1);
+        CHECK_FALSE(sync.add_sample(TimeSyncSource::TimeDate, bus_at(12'000'000), 12'000'000));
+        // GNSS silent for longer than the source timeout
+        CHECK(sync.add_sample(TimeSyncSource::TimeDate, bus_at(17'000'000), 17'000'000));
+        CHECK(sync.source() == TimeSyncSource::TimeDate);
+    }
+}
+
+TEST_CASE("TimeSync follows Time/Date and System Time on the bus") {
+    IsoNet sender, receiver;
+    auto *tx_cf = sender.create_internal(Name::build().set_identity_number(1), 0, 0x26).value();
+    receiver.create_internal(Name::build().set_identity_number(2), 0, 0x27).value();
+    LoopbackBus bus;
+    bus.attach(sender);
+    bus.attach(receiver);
+    REQUIRE(sender.start_address_claiming().is_ok());
+    REQUIRE(receiver.start_address_claiming().is_ok());
+    auto run = [&](u32 steps) {
+        for (u32 i = 0; i < steps; ++i) {
+            sender.update(10);
+            receiver.update(10);
+        }
+    };
+    run(40);
+
+    TimeSync sync(receiver);
+    REQUIRE(sync.initialize().is_ok());
+
+    // 2024-06-01 12:30:15
+    TimeDateInterface td(sender, tx_cf);
+    REQUIRE(td.initialize().is_ok());
+    TimeDate now;
+    now.seconds = 15;
+    now.minutes = 30;
+    now.hours = 12;
+    now.day = 1;
+    now.month = 6;
+    now.year = 2024;
+    REQUIRE(td.send(now).is_ok());
+    run(2);
+    REQUIRE(sync.synced());
+    CHECK(sync.source() == TimeSyncSource::TimeDate);
+    const u64 expected = (static_cast<u64>(TimeSync::days_from_civil(2024, 6, 1)) * 86400 + 12 * 3600 + 30 * 60 + 15) *
+                         1'000'000ull;
+    i64 err = static_cast<i64>(sync.bus_time_now() - expected);
+    CHECK(err >= 0);
+    CHECK(err < 1'000'000);
+
+    // System Time takes over: days 20000, 01:00:00.0000
+    dp::Vector<u8> st = {0x01, 0x00, 0x20, 0x4E, 0x00, 0x51, 0x25, 0x02};
+    REQUIRE(sender.send(PGN_SYSTEM_TIME, st, tx_cf).is_ok());
+    run(2);
+    CHECK(sync.source() == TimeSyncSource::SystemTime);
+    err = static_cast<i64>(sync.bus_time_now() - (20000ull * 86'400'000'000ull + 3'600'000'000ull));
+    CHECK(err >= 0);
+    CHECK(err < 1'000'000);
+}
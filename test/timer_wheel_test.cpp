@@ -0,0 +1,129 @@
+#include <doctest/doctest.h>
+#include <agrobus/net/timer_wheel.hpp>
+
+using namespace agrobus::net;
+
+TEST_CASE("TimerWheel fires one-shot timers at their deadline") {
+    TimerWheel wheel;
+    dp::Vector<u64> fired;
+    wheel.schedule(10, [&]() { fired.push_back(wheel.now_ms()); });
+    wheel.schedule(3, [&]() { fired.push_back(wheel.now_ms()); });
+    CHECK(wheel.size() == 2);
+    CHECK(wheel.next_deadline_ms() == 3);
+
+    wheel.advance(2);
+    CHECK(fired.empty());
+    wheel.advance(20);
+    REQUIRE(fired.size() == 2);
+    CHECK(fired[0] == 3);
+    CHECK(fired[1] == 10);
+    CHECK(wheel.empty());
+    CHECK(wheel.next_deadline_ms() == NO_DEADLINE);
+    CHECK(wheel.now_ms() == 22);
+}
+
+TEST_CASE("TimerWheel cascades long timers through the levels") {
+    TimerWheel wheel;
+    dp::Vector<u64> fired;
+    const u32 delays[] = {63, 64, 65, 4095, 4096, 4097, 300000, 20000000};
+    for (u32 d : delays)
+        wheel.schedule(d, [&]() { fired.push_back(wheel.now_ms()); });
+
+    u32 guard = 0;
+    while (!wheel.empty() && guard++ < 10000) {
+        u32 next = wheel.next_deadline_ms();
+        REQUIRE(next != NO_DEADLINE);
+        wheel.advance(next == 0 ? 1 : next);
+    }
+    REQUIRE(fired.size() == 8);
+    for (usize i = 0; i < 8; ++i)
+        CHECK(fired[i] == delays[i]);
+}
+
+TEST_CASE("TimerWheel cancel, reschedule and stale handles") {
+    TimerWheel wheel;
+    i32 a = 0;
+    i32 b = 0;
+    TimerId ta = wheel.schedule(5, [&]() { ++a; });
+    TimerId tb = wheel.schedule(5, [&]() { ++b; });
+    CHECK(wheel.cancel(ta));
+    CHECK_FALSE(wheel.cancel(ta));
+    CHECK(wheel.reschedule(tb, 100));
+    CHECK(wheel.remaining_ms(tb) == 100);
+
+    wheel.advance(50);
+    CHECK(a == 0);
+    CHECK(b == 0);
+    wheel.advance(50);
+    CHECK(b == 1);
+    CHECK_FALSE(wheel.armed(tb));
+
+    // The freed slot is reused; the old handle must not touch the new timer
+    TimerId tc = wheel.schedule(5, [&]() { ++a; });
+    CHECK_FALSE(wheel.cancel(ta));
+    CHECK(wheel.armed(tc));
+    wheel.advance(5);
+    CHECK(a == 1);
+}
+
+TEST_CASE("TimerWheel callbacks re-arm without drift") {
+    TimerWheel wheel;
+    dp::Vector<u64> fired;
+    Delegate<void()> tick;
+    tick = [&]() {
+        fired.push_back(wheel.now_ms());
+        wheel.schedule(100, tick);
+    };
+    wheel.schedule(100, tick);
+
+    // Coarse, uneven steps
+    const u32 steps[] = {30, 90, 45, 135, 200};
+    for (u32 s : steps)
+        wheel.advance(s);
+    REQUIRE(fired.size() == 5);
+    for (usize i = 0; i < fired.size(); ++i)
+        CHECK(fired[i] == (i + 1) * 100);
+}
+
+TEST_CASE("TimerWheel zero delay and tag timers") {
+    TimerWheel wheel;
+    dp::Vector<u32> tags;
+    wheel.schedule_tag(0, 7);
+    wheel.schedule_tag(2, 9);
+    CHECK(wheel.next_deadline_ms() == 0);
+
+    auto collect = [&](TimerId, u32 tag) { tags.push_back(tag); };
+    wheel.advance(0, collect);
+    REQUIRE(tags.size() == 1);
+    CHECK(tags[0] == 7);
+    wheel.advance(2, collect);
+    REQUIRE(tags.size() == 2);
+    CHECK(tags[1] == 9);
+}
+
+TEST_CASE("TimerWheel periodic timers stay anchored to absolute time") {
+    TimerWheel wheel;
+    dp::Vector<u64> fired;
+    wheel.schedule_every(100, 30, [&]() { fired.push_back(wheel.now_ms()); });
+
+    // Uneven ticks: 7 ms jitter per step must not accumulate
+    for (u32 i = 0; i < 40; ++i)
+        wheel.advance(i % 2 == 0 ? 13 : 27);
+    REQUIRE(fired.size() == 8); // 800 ms elapsed
+    for (usize i = 0; i < fired.size(); ++i)
+        CHECK(fired[i] == 30 + i * 100);
+}
+
+TEST_CASE("TimerWheel periodic timers skip instead of bursting after a stall") {
+    TimerWheel wheel;
+    u32 count = 0;
+    TimerId id = wheel.schedule_every(100, 0, [&]() { ++count; });
+    wheel.advance(450); // Passes 100..400
+    CHECK(count == 1);
+    CHECK(wheel.remaining_ms(id) == 50); // Next slot on the original grid: 500
+    wheel.advance(50);
+    CHECK(count == 2);
+
+    CHECK(wheel.set_period(id, 40, 10));
+    CHECK(wheel.remaining_ms(id) == 30); // 530 = 13 * 40 + 10
+}
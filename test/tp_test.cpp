@@ -20,6 +20,79 @@ TEST_CASE("Transport Protocol BAM send") {
     CHECK(msg_size == 100);
 }
 
+TEST_CASE("Transport Protocol BAM pacing follows elapsed time") {
+    TransportProtocol tp;
+    dp::Vector<u8> data(100, 0xAA); // 15 packets
+    tp.send(0xFECA, data, 0x28, BROADCAST_ADDRESS);
+
+    SUBCASE("slow ticks release several frames") {
+        auto frames = tp.update(200);
+        REQUIRE(frames.size() == 4);
+        for (u8 i = 0; i < 4; ++i)
+            CHECK(frames[i].data[0] == i + 1);
+    }
+
+    SUBCASE("fast ticks carry the remainder") {
+        usize sent = 0;
+        for (int i = 0; i < 15; ++i)
+            sent += tp.update(10).size();
+        CHECK(sent == 3); // 150 ms
+    }
+
+    SUBCASE("a stalled caller is capped at the burst limit") {
+        auto frames = tp.update(10000);
+        CHECK(frames.size() == TP_BAM_MAX_BURST);
+    }
+
+    SUBCASE("the interval is configurable") {
+        tp.set_bam_pacing(10);
+        usize completed = 0;
+        tp.on_complete.subscribe([&](TransportSession &) { ++completed; });
+        auto frames = tp.update(150);
+        CHECK(frames.size() == 8); // burst cap
+        frames = tp.update(70);
+        CHECK(frames.size() == 7);
+        CHECK(completed == 1);
+        CHECK(tp.active_sessions().empty());
+    }
+}
+
+TEST_CASE("Transport Protocol interleaves concurrent BAMs") {
+    TransportProtocol tp;
+    dp::Vector<u8> data(100, 0xAA);
+    tp.send(0xFECA, data, 0x28, BROADCAST_ADDRESS);
+    tp.send(0xFECA, data, 0x29, BROADCAST_ADDRESS);
+
+    auto frames = tp.update(100);
+    REQUIRE(frames.size() == 4);
+    CHECK(frames[0].source() == 0x28);
+    CHECK(frames[1].source() == 0x29);
+    CHECK(frames[2].source() == 0x28);
+    CHECK(frames[3].source() == 0x29);
+    CHECK(frames[2].data[0] == 2);
+}
+
+TEST_CASE("Transport Protocol next deadline") {
+    TransportProtocol tp;
+    CHECK(tp.next_deadline_ms() == NO_DEADLINE);
+
+    SUBCASE("BAM sender wakes for the next packet") {
+        dp::Vector<u8> data(100, 0xAA);
+        tp.send(0xFECA, data, 0x28, BROADCAST_ADDRESS);
+        CHECK(tp.next_deadline_ms() <= TP_BAM_INTER_PACKET_MS);
+        tp.update(20);
+        CHECK(tp.next_deadline_ms() <= TP_BAM_INTER_PACKET_MS - 20);
+    }
+
+    SUBCASE("RTS sender wakes for the CTS timeout") {
+        dp::Vector<u8> data(100, 0xAA);
+        tp.send(0xFECA, data, 0x28, 0x30);
+        CHECK(tp.next_deadline_ms() == TP_TIMEOUT_T3_MS);
+        tp.update(250);
+        CHECK(tp.next_deadline_ms() == TP_TIMEOUT_T3_MS - 250);
+    }
+}
+
 TEST_CASE("Transport Protocol CM send") {
     TransportProtocol tp;
 
@@ -107,6 +180,42 @@ TEST_CASE("Transport Protocol BAM receive") {
     CHECK(received_data.size() == 14);
 }
 
+TEST_CASE("Transport Protocol BAM receive carries first and last frame timestamps") {
+    TransportProtocol tp;
+
+    u64 first_ts = 0, last_ts = 0;
+    tp.on_complete.subscribe([&](TransportSession& session) {
+        first_ts = session.first_timestamp_us;
+        last_ts = session.last_timestamp_us;
+    });
+
+    Frame bam;
+    bam.id = Identifier::encode(Priority::Lowest, PGN_TP_CM, 0x30, BROADCAST_ADDRESS);
+    bam.data[0] = tp_cm::BAM;
+    bam.data[1] = 14;
+    bam.data[2] = 0;
+    bam.data[3] = 2;
+    bam.data[4] = 0xFF;
+    bam.data[5] = 0xCA;
+    bam.data[6] = 0xFE;
+    bam.data[7] = 0x00;
+    bam.length = 8;
+    bam.timestamp_us = 1000;
+    tp.process_frame(bam);
+
+    for (u8 seq = 1; seq <= 2; ++seq) {
+        Frame dt;
+        dt.id = Identifier::encode(Priority::Lowest, PGN_TP_DT, 0x30, BROADCAST_ADDRESS);
+        dt.data[0] = seq;
+        dt.length = 8;
+        dt.timestamp_us = 1000 + seq * 50;
+        tp.process_frame(dt);
+    }
+
+    CHECK(first_ts == 1000);
+    CHECK(last_ts == 1100);
+}
+
 TEST_CASE("Transport Protocol session exists error") {
     TransportProtocol tp;
     dp::Vector<u8> data(50, 0xDD);
@@ -115,3 +224,366 @@ TEST_CASE("Transport Protocol session exists error") {
     auto r2 = tp.send(0xFECA, data, 0x28, 0x30);
     CHECK(r2.is_err()); // Already in session
 }
+
+TEST_CASE("Transport Protocol handles many concurrent BAMs") {
+    TransportProtocol tp;
+    u32 completed = 0;
+    tp.on_complete.subscribe([&](TransportSession &session) {
+        ++completed;
+        CHECK(session.data[0] == session.source_address);
+    });
+
+    auto bam_from = [](Address src) {
+        Frame bam;
+        bam.id = Identifier::encode(Priority::Lowest, PGN_TP_CM, src, BROADCAST_ADDRESS);
+        bam.data = {tp_cm::BAM, 14, 0, 2, 0xFF, 0xCA, 0xFE, 0x00};
+        return bam;
+    };
+    auto dt_from = [](Address src, u8 seq) {
+        Frame dt;
+        dt.id = Identifier::encode(Priority::Lowest, PGN_TP_DT, src, BROADCAST_ADDRESS);
+        dt.data[0] = seq;
+        for (u8 i = 1; i < 8; ++i)
+            dt.data[i] = src;
+        return dt;
+    };
+
+    for (Address src = 0x80; src < 0x98; ++src)
+        tp.process_frame(bam_from(src));
+    CHECK(tp.active_sessions().size() == 24);
+
+    for (u8 seq = 1; seq <= 2; ++seq) {
+        for (Address src = 0x97; src >= 0x80; --src)
+            tp.process_frame(dt_from(src, seq));
+    }
+    CHECK(completed == 24);
+    CHECK(tp.active_sessions().empty());
+}
+
+TEST_CASE("Transport Protocol rejects RTS when the session table is full") {
+    TransportProtocol tp(1);
+
+    auto rts_from = [](Address src) {
+        Frame rts;
+        rts.id = Identifier::encode(Priority::Lowest, PGN_TP_CM, src, 0x28);
+        rts.data = {tp_cm::RTS, 14, 0, 2, 16, 0xCA, 0xFE, 0x00};
+        return rts;
+    };
+
+    auto first = tp.process_frame(rts_from(0x30));
+    REQUIRE(first.size() == 1);
+    CHECK(first[0].data[0] == tp_cm::CTS);
+
+    auto second = tp.process_frame(rts_from(0x31));
+    REQUIRE(second.size() == 1);
+    CHECK(second[0].data[0] == tp_cm::ABORT);
+    CHECK(second[0].data[1] == static_cast<u8>(TransportAbortReason::ResourcesUnavailable));
+
+    dp::Vector<u8> data(20, 0x11);
+    auto send = tp.send(0xFECA, data, 0x28, 0x31);
+    CHECK(send.is_err());
+}
+
+TEST_CASE("Transport Protocol reuses pooled reassembly buffers") {
+    TransportProtocol tp;
+    auto pool = std::make_shared<BufferPool>();
+    tp.set_buffer_pool(pool);
+
+    usize completed = 0;
+    tp.on_complete.subscribe([&](TransportSession &session) {
+        ++completed;
+        CHECK(session.data.size() == 14);
+    });
+
+    for (int round = 0; round < 3; ++round) {
+        Frame bam;
+        bam.id = Identifier::encode(Priority::Lowest, PGN_TP_CM, 0x30, BROADCAST_ADDRESS);
+        bam.data = {tp_cm::BAM, 14, 0, 2, 0xFF, 0xCA, 0xFE, 0x00};
+        tp.process_frame(bam);
+        for (u8 seq = 1; seq <= 2; ++seq) {
+            Frame dt;
+            dt.id = Identifier::encode(Priority::Lowest, PGN_TP_DT, 0x30, BROADCAST_ADDRESS);
+            dt.data[0] = seq;
+            tp.process_frame(dt);
+        }
+    }
+
+    CHECK(completed == 3);
+    CHECK(pool->stats().misses == 1);
+    CHECK(pool->stats().hits == 2);
+    CHECK(pool->cached(0) == 1);
+}
+
+
+TEST_CASE("Transport Protocol zero-copy send reads the caller's buffer") {
+    TransportProtocol tp;
+    auto payload = std::make_shared<dp::Vector<u8>>(20);
+    for (u8 i = 0; i < 20; ++i)
+        (*payload)[i] = i;
+
+    auto rts = tp.send_shared(0xFECA, payload, 0x28, 0x30);
+    REQUIRE(rts.is_ok());
+    CHECK(rts.value()[0].data[0] == tp_cm::RTS);
+    CHECK(payload.use_count() == 2); // held by the session, not copied
+
+    SUBCASE("DT frames come from the shared payload") {
+        Frame cts;
+        cts.id = Identifier::encode(Priority::Lowest, PGN_TP_CM, 0x30, 0x28);
+        cts.data = {tp_cm::CTS, 3, 1, 0xFF, 0xFF, 0xCA, 0xFE, 0x00};
+        tp.process_frame(cts);
+        auto dt = tp.get_pending_data_frames();
+        REQUIRE(dt.size() == 3);
+        CHECK(dt[0].data[1] == 0);
+        CHECK(dt[1].data[1] == 7);
+        CHECK(dt[2].data[6] == 19);
+        CHECK(dt[2].data[7] == 0xFF);
+
+        Frame eoma;
+        eoma.id = Identifier::encode(Priority::Lowest, PGN_TP_CM, 0x30, 0x28);
+        eoma.data = {tp_cm::EOMA, 20, 0, 3, 0xFF, 0xCA, 0xFE, 0x00};
+        tp.process_frame(eoma);
+        CHECK(tp.active_sessions().empty());
+        CHECK(payload.use_count() == 1);
+    }
+
+    SUBCASE("an aborted session releases the payload") {
+        tp.update(TP_TIMEOUT_T3_MS + 1);
+        CHECK(tp.active_sessions().empty());
+        CHECK(payload.use_count() == 1);
+    }
+
+    SUBCASE("rejects a null payload") {
+        CHECK(tp.send_shared(0xFECA, nullptr, 0x28, 0x31).is_err());
+    }
+}
+
+TEST_CASE("Transport Protocol adaptive CTS window") {
+    TransportProtocol tp;
+    CtsWindowConfig cfg;
+    cfg.adaptive = true;
+    cfg.max_packets = 64;
+    tp.set_cts_window(cfg);
+
+    // 100 packets, sender allows up to 255 per CTS
+    Frame rts;
+    rts.id = Identifier::encode(Priority::Lowest, PGN_TP_CM, 0x30, 0x28);
+    rts.data = {tp_cm::RTS, 0xBC, 0x02, 100, 0xFF, 0xCA, 0xFE, 0x00};
+    auto cts = tp.process_frame(rts);
+    REQUIRE(cts.size() == 1);
+    CHECK(cts[0].data[1] == 16);
+
+    u8 seq = 0;
+    auto feed = [&](u8 count, u32 gap_ms) {
+        dp::Vector<Frame> last;
+        for (u8 i = 0; i < count; ++i) {
+            if (gap_ms)
+                tp.update(gap_ms);
+            Frame dt;
+            dt.id = Identifier::encode(Priority::Lowest, PGN_TP_DT, 0x30, 0x28);
+            dt.data[0] = ++seq;
+            last = tp.process_frame(dt);
+        }
+        return last;
+    };
+
+    auto next = feed(16, 0);
+    REQUIRE(next.size() == 1);
+    CHECK(next[0].data[0] == tp_cm::CTS);
+    CHECK(next[0].data[1] == 32);
+    CHECK(next[0].data[2] == 17);
+
+    next = feed(32, 0);
+    REQUIRE(next.size() == 1);
+    CHECK(next[0].data[1] == 52); // 64 allowed, 52 packets remain
+
+    // A slow window shrinks the learned size for this sender
+    next = feed(52, 60);
+    REQUIRE(next.size() == 1);
+    CHECK(next[0].data[0] == tp_cm::EOMA);
+    CHECK(tp.cts_window().window(0, 0x30) == 32);
+}
+
+TEST_CASE("Transport Protocol interleaves connection-mode sessions to different destinations") {
+    TransportProtocol tp;
+    dp::Vector<u8> to_tc(50, 0x11); // 8 packets
+    dp::Vector<u8> to_vt(30, 0x22); // 5 packets
+    REQUIRE(tp.send(0xCB00, to_tc, 0x28, 0x30).is_ok());
+    REQUIRE(tp.send(0xE700, to_vt, 0x28, 0x26).is_ok());
+
+    auto cts = [&](Address from, u8 packets, PGN pgn) {
+        Frame f;
+        f.id = Identifier::encode(Priority::Lowest, PGN_TP_CM, from, 0x28);
+        f.data = {tp_cm::CTS, packets, 1, 0xFF, 0xFF, static_cast<u8>(pgn & 0xFF), static_cast<u8>((pgn >> 8) & 0xFF),
+                  static_cast<u8>((pgn >> 16) & 0xFF)};
+        tp.process_frame(f);
+    };
+    cts(0x30, 8, 0xCB00);
+    cts(0x26, 5, 0xE700);
+
+    auto frames = tp.get_pending_data_frames();
+    REQUIRE(frames.size() == 13);
+    // Alternating while both windows have packets left
+    for (usize i = 0; i < 10; ++i)
+        CHECK(frames[i].destination() == (i % 2 == 0 ? 0x30 : 0x26));
+    CHECK(frames[10].destination() == 0x30);
+    CHECK(frames[12].data[0] == 8);
+
+    CHECK(tp.get_pending_data_frames().empty()); // Both now wait for EOMA
+}
+
+TEST_CASE("Transport Protocol records session metrics") {
+    TransportProtocol tp;
+    dp::Vector<u8> data(30, 0x33); // 5 packets
+    REQUIRE(tp.send(0xCB00, data, 0x28, 0x30, 1).is_ok());
+
+    auto cm = [&](u8 ctrl, u8 b1, u8 b2) {
+        Frame f;
+        f.id = Identifier::encode(Priority::Lowest, PGN_TP_CM, 0x30, 0x28);
+        f.data = {ctrl, b1, b2, 0xFF, 0xFF, 0x00, 0xCB, 0x00};
+        tp.process_frame(f, 1);
+    };
+
+    tp.update(20);
+    cm(tp_cm::CTS, 3, 1);
+    CHECK(tp.get_pending_data_frames().size() == 3);
+    tp.update(15);
+    cm(tp_cm::CTS, 4, 2); // Asks again for packets 2 and 3
+    CHECK(tp.get_pending_data_frames().size() == 4);
+    tp.update(5);
+    cm(tp_cm::EOMA, 30, 0);
+
+    const auto &total = tp.metrics().total();
+    CHECK(total.started == 1);
+    CHECK(total.completed == 1);
+    CHECK(total.bytes == 30);
+    CHECK(total.duration_ms_sum == 40);
+    CHECK(total.retransmits == 2);
+    CHECK(total.cts_rtt_samples == 2);
+    CHECK(total.cts_rtt_ms_max == 20);
+    CHECK(total.mean_cts_rtt_ms() == doctest::Approx(17.5));
+    CHECK(total.bytes_per_second() == doctest::Approx(750.0));
+    CHECK(tp.metrics().port(1).completed == 1);
+    CHECK(tp.metrics().port(0).started == 0);
+    CHECK(tp.metrics().pgn(0xCB00).bytes == 30);
+
+    // A timed-out RX session counts as an abort by reason
+    Frame rts;
+    rts.id = Identifier::encode(Priority::Lowest, PGN_TP_CM, 0x40, 0x28);
+    rts.data = {tp_cm::RTS, 20, 0, 3, 16, 0x00, 0xE7, 0x00};
+    tp.process_frame(rts);
+    tp.update(TP_TIMEOUT_T1_MS);
+    CHECK(tp.metrics().total().aborted == 1);
+    CHECK(tp.metrics().total().aborts(TransportAbortReason::Timeout) == 1);
+    CHECK(tp.metrics().pgn(0xE700).started == 1);
+}
+
+TEST_CASE("Transport Protocol appends to a caller-owned frame vector") {
+    TransportProtocol tp;
+    dp::Vector<u8> data(30, 0x44); // 5 packets
+    REQUIRE(tp.send(0xCB00, data, 0x28, 0x30).is_ok());
+
+    Frame cts;
+    cts.id = Identifier::encode(Priority::Lowest, PGN_TP_CM, 0x30, 0x28);
+    cts.data = {tp_cm::CTS, 5, 1, 0xFF, 0xFF, 0x00, 0xCB, 0x00};
+
+    dp::Vector<Frame> out;
+    out.reserve(16);
+    const Frame *storage = out.data();
+    out.push_back(Frame{}); // Earlier content stays in front
+    tp.process_frame(cts, cts.header(), 0, out);
+    tp.get_pending_data_frames(out);
+    REQUIRE(out.size() == 6);
+    CHECK(out[1].data[0] == 1);
+    CHECK(out[5].data[0] == 5);
+    CHECK(out.data() == storage);
+
+    out.clear();
+    tp.update(10, out);
+    CHECK(out.empty());
+    CHECK(out.capacity() >= 16);
+}
+
+TEST_CASE("Transport Protocol holds data frames for a paused port") {
+    TransportProtocol tp;
+    dp::Vector<u8> data(20, 0x55); // 3 packets
+    REQUIRE(tp.send(0xCB00, data, 0x28, 0x30, 1).is_ok());
+
+    Frame cts;
+    cts.id = Identifier::encode(Priority::Lowest, PGN_TP_CM, 0x30, 0x28);
+    cts.data = {tp_cm::CTS, 3, 1, 0xFF, 0xFF, 0x00, 0xCB, 0x00};
+    tp.process_frame(cts, 1);
+
+    tp.pause_port(1, true);
+    CHECK(tp.port_paused(1));
+    CHECK_FALSE(tp.port_paused(0));
+    CHECK(tp.get_pending_data_frames().empty());
+    CHECK(tp.next_deadline_ms() != 0); // Nothing to do until the port resumes
+
+    tp.pause_port(1, false);
+    CHECK(tp.next_deadline_ms() == 0);
+    auto dt = tp.get_pending_data_frames();
+    REQUIRE(dt.size() == 3);
+    CHECK(dt[0].data[0] == 1);
+    CHECK(dt[2].data[0] == 3);
+}
+
+TEST_CASE("Transport Protocol asks again for a lost DT instead of aborting") {
+    TransportProtocol tx, rx;
+    dp::Vector<u8> payload(60); // 9 packets
+    for (usize i = 0; i < payload.size(); ++i)
+        payload[i] = static_cast<u8>(i * 3);
+
+    dp::Vector<u8> got;
+    bool aborted = false;
+    rx.on_complete.subscribe([&](TransportSession &s) { got = s.data; });
+    rx.on_abort.subscribe([&](TransportSession &, TransportAbortReason) { aborted = true; });
+    tx.on_abort.subscribe([&](TransportSession &, TransportAbortReason) { aborted = true; });
+
+    auto run = [&](u8 lose) {
+        usize lost = 0;
+        dp::Vector<Frame> to_rx = tx.send(0xCB00, payload, 0x28, 0x30).value();
+        for (int round = 0; round < 20; ++round) {
+            dp::Vector<Frame> to_tx;
+            for (const auto &f : to_rx) {
+                if (f.pgn() == PGN_TP_DT && f.data[0] == lose && lost++ == 0)
+                    continue; // Lost once, arrives when asked again
+                for (const auto &r : rx.process_frame(f))
+                    to_tx.push_back(r);
+            }
+            if (to_rx.empty())
+                rx.update(TP_TIMEOUT_T1_MS, to_tx); // Nothing more on the bus
+            to_rx.clear();
+            if (to_tx.empty())
+                break;
+            for (const auto &f : to_tx) {
+                for (const auto &r : tx.process_frame(f))
+                    to_rx.push_back(r);
+            }
+            tx.get_pending_data_frames(to_rx);
+        }
+        return lost;
+    };
+
+    SUBCASE("in the middle of a window") {
+        CHECK(run(4) == 2); // Sent twice, received once
+        CHECK_FALSE(aborted);
+        CHECK(got == payload);
+        CHECK(tx.metrics().total().retransmits >= 1);
+    }
+
+    SUBCASE("the last packet: the receiver times out and asks again") {
+        CHECK(run(9) == 2);
+        CHECK_FALSE(aborted);
+        CHECK(got == payload);
+    }
+
+    SUBCASE("without retries a gap still aborts") {
+        CtsWindowConfig config;
+        config.gap_retries = 0;
+        rx.set_cts_window(config);
+        run(4);
+        CHECK(aborted);
+        CHECK(got.empty());
+    }
+}
+
@@ -0,0 +1,58 @@
+#define AGROBUS_TRACE_LEVEL 2
+#include <doctest/doctest.h>
+#include <agrobus/net/trace.hpp>
+#include <thread>
+
+using namespace agrobus::net;
+
+TEST_CASE("Trace levels are decided at build time") {
+    CHECK(trace::enabled(1));
+    CHECK(trace::enabled(2));
+    CHECK_FALSE(trace::enabled(3));
+
+    TraceRing &ring = trace::ring();
+    ring.clear();
+    int evaluated = 0;
+    AGROBUS_TRACE_WARN(TraceEvent::TpDuplicateDt, 0xEF00, 4, 5);
+    AGROBUS_TRACE_DEBUG(TraceEvent::TransportComplete, 0xEF00, 100, 0x28);
+    AGROBUS_TRACE(TraceEvent::FrameRx, ++evaluated, 0, 8); // Above the level: not even evaluated
+    CHECK(evaluated == 0);
+
+    auto records = ring.snapshot();
+    REQUIRE(records.size() == 2);
+    CHECK(records[0].event == TraceEvent::TpDuplicateDt);
+    CHECK(records[0].level == 1);
+    CHECK(records[0].a == 0xEF00);
+    CHECK(records[0].b == 4);
+    CHECK(records[0].c == 5);
+    CHECK(records[1].event == TraceEvent::TransportComplete);
+    CHECK(records[1].timestamp_ns >= records[0].timestamp_ns);
+    CHECK(dp::String(trace_event_name(records[1].event)) == "transport_complete");
+}
+
+TEST_CASE("TraceRing keeps the newest records") {
+    TraceRing ring(0);
+    for (u32 i = 0; i < TraceRing::CAPACITY + 10; ++i)
+        ring.push(TraceRecord{i, TraceEvent::User, 3, 0, i, 0, 0});
+    auto records = ring.snapshot();
+    REQUIRE(records.size() == TraceRing::CAPACITY);
+    CHECK(records.front().a == 10);
+    CHECK(records.back().a == TraceRing::CAPACITY + 9);
+    CHECK(ring.written() == TraceRing::CAPACITY + 10);
+}
+
+TEST_CASE("Every tracing thread gets its own ring") {
+    trace::emit(2, TraceEvent::User, 1);
+    std::thread t([] { trace::emit(2, TraceEvent::User, 2); });
+    t.join();
+
+    usize rings = 0;
+    bool seen_other = false;
+    trace::for_each_ring([&](const TraceRing &r) {
+        ++rings;
+        for (const auto &rec : r.snapshot())
+            seen_other |= rec.a == 2 && &r != &trace::ring();
+    });
+    CHECK(rings >= 2);
+    CHECK(seen_other);
+}
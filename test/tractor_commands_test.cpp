@@ -1,5 +1,6 @@
 #include <doctest/doctest.h>
 #include <agrobus/isobus/implement/tractor_commands.hpp>
+#include <agrobus/net/loopback_bus.hpp>
 
 using namespace agrobus::isobus;
 using namespace agrobus::isobus::implement;
@@ -483,6 +484,75 @@ TEST_CASE("TractorCommands send methods API") {
     }
 }
 
+// ─── Command arbitration ─────────────────────────────────────────────────────
+
+TEST_CASE("TractorCommandArbiter merges requests and keeps unchanged commands alive") {
+    IsoNet implement_net, tractor_net;
+    auto *implement_cf = implement_net.create_internal(Name::build().set_identity_number(1), 0, 0x80).value();
+    auto *tecu_cf = tractor_net.create_internal(Name::build().set_identity_number(2), 0, 0xF0).value();
+    LoopbackBus bus;
+    bus.attach(implement_net);
+    bus.attach(tractor_net);
+    REQUIRE(implement_net.start_address_claiming().is_ok());
+    REQUIRE(tractor_net.start_address_claiming().is_ok());
+    auto run = [&](u32 steps) {
+        for (u32 i = 0; i < steps; ++i) {
+            implement_net.update(10);
+            tractor_net.update(10);
+        }
+    };
+    run(40);
+
+    TractorCommands tecu(tractor_net, tecu_cf);
+    REQUIRE(tecu.initialize().is_ok());
+    dp::Vector<HitchCommandMsg> hitch;
+    u32 valves = 0;
+    tecu.on_rear_hitch_command.subscribe([&](HitchCommandMsg cmd) { hitch.push_back(cmd); });
+    tecu.on_aux_valve_command.subscribe([&](AuxValveCommandMsg) { ++valves; });
+
+    TractorCommandArbiter arbiter(implement_net, implement_cf, CommandArbiterConfig{}.slot(20).keepalive(100));
+    REQUIRE(arbiter.initialize().is_ok());
+
+    // Three functions ask for the hitch in the same tick: one frame, the last request
+    HitchCommandMsg cmd;
+    cmd.command = HitchCommand::Position;
+    for (u16 pos : {10000, 20000, 30000}) {
+        cmd.target_position = pos;
+        arbiter.request_rear_hitch(cmd);
+    }
+    AuxValveCommandMsg valve;
+    valve.valve_index = 16;
+    CHECK(arbiter.request_aux_valve(valve).is_err());
+    run(3);
+    REQUIRE(hitch.size() == 1);
+    CHECK(hitch[0].target_position == 30000);
+    CHECK(arbiter.stats().merged == 2);
+
+    // The same command every tick for 300 ms: keep-alive frames only
+    for (u32 i = 0; i < 30; ++i) {
+        arbiter.request_rear_hitch(cmd);
+        run(1);
+    }
+    CHECK(hitch.size() >= 3);
+    CHECK(hitch.size() <= 5);
+    CHECK(arbiter.stats().suppressed > 0);
+
+    // A change goes out on the next slot
+    cmd.target_position = 5000;
+    arbiter.request_rear_hitch(cmd);
+    usize before = hitch.size();
+    run(2);
+    REQUIRE(hitch.size() == before + 1);
+    CHECK(hitch.back().target_position == 5000);
+
+    arbiter.release(CommandTarget::RearHitch);
+    before = hitch.size();
+    run(30);
+    CHECK(hitch.size() == before);
+    CHECK_FALSE(arbiter.active(CommandTarget::RearHitch));
+    CHECK(valves == 0);
+}
+
 // ─── Enum Value Tests ────────────────────────────────────────────────────────
 
 TEST_CASE("HitchCommand enum values") {
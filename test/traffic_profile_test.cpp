@@ -0,0 +1,107 @@
+#include <doctest/doctest.h>
+#include <agrobus/net/loopback_bus.hpp>
+#include <agrobus/net/traffic_profile.hpp>
+
+using namespace agrobus::net;
+
+static Frame broadcast(PGN pgn, Address src, u8 length = 8) {
+    u8 payload[8] = {1, 2, 3, 4, 5, 6, 7, 8};
+    return Frame::from_message(Priority::Default, pgn, src, BROADCAST_ADDRESS, payload, length);
+}
+
+TEST_CASE("TrafficProfiler counts streams, sources and ports") {
+    TrafficProfiler p(64, 2);
+    for (u64 i = 0; i < 10; ++i) {
+        p.record(broadcast(0xFEF1, 0x28), 0, i * 100000);
+        p.record(broadcast(0xFEF1, 0x30, 4), 0, i * 100000 + 50);
+    }
+    p.record(broadcast(0xF004, 0x28), 1, 900000);
+
+    CHECK(p.streams() == 3);
+    const TrafficStats *s = p.find(0, 0xFEF1, 0x28);
+    REQUIRE(s != nullptr);
+    CHECK(s->frames == 10);
+    CHECK(s->bytes == 80);
+    CHECK(s->bits == 10 * BusLoad::frame_bits(8));
+    CHECK(p.find(0, 0xFEF1, 0x30)->bytes == 40);
+    CHECK(p.find(1, 0xFEF1, 0x28) == nullptr);
+
+    CHECK(p.source(0, 0x28).frames == 10);
+    CHECK(p.source(1, 0x28).frames == 1);
+    CHECK(p.total(0).frames == 20);
+    CHECK(p.total(1).frames == 1);
+
+    auto top = p.top(2);
+    REQUIRE(top.size() == 2);
+    CHECK(top[0].pgn == 0xFEF1);
+    CHECK(top[0].source == 0x28);
+    CHECK(top[0].port == 0);
+    CHECK(top[1].source == 0x30);
+    CHECK(p.top(10, TrafficOrder::Frames).size() == 3);
+
+    p.reset();
+    CHECK(p.streams() == 0);
+    CHECK(p.total(0).frames == 0);
+}
+
+TEST_CASE("TrafficProfiler periodicity and load") {
+    TrafficProfiler p;
+    u64 t = 0;
+    for (int i = 0; i < 20; ++i) {
+        p.record(broadcast(0xFEF1, 0x28), 0, t);
+        t += (i % 2) ? 90000 : 110000; // 100 ms +/- 10 ms
+    }
+    const TrafficStats *s = p.find(0, 0xFEF1, 0x28);
+    REQUIRE(s != nullptr);
+    CHECK(s->intervals == 19);
+    CHECK(s->interval_mean_us() == doctest::Approx(100000.0).epsilon(0.02));
+    CHECK(s->interval_min_us == 90000);
+    CHECK(s->interval_max_us == 110000);
+    CHECK(s->jitter_us() == doctest::Approx(10000.0).epsilon(0.05));
+
+    // 20 frames of 8 bytes over 1.9 s on 250 kbit/s
+    f32 expected = static_cast<f32>(20 * BusLoad::frame_bits(8)) * 100.0f / (250000.0f * 1.9f);
+    CHECK(p.load_percent(*s) == doctest::Approx(expected).epsilon(0.01));
+}
+
+TEST_CASE("TrafficProfiler overflow keeps totals") {
+    TrafficProfiler p(4);
+    for (u8 sa = 0; sa < 10; ++sa)
+        p.record(broadcast(0xFEF1, sa), 0, sa);
+    CHECK(p.streams() == 4);
+    CHECK(p.overflow() == 6);
+    CHECK(p.total(0).frames == 10);
+    CHECK(p.source(0, 9).frames == 1);
+}
+
+TEST_CASE("IsoNet profiles received and sent traffic") {
+    LoopbackBus bus;
+    IsoNet a(NetworkConfig{}.profile(256));
+    IsoNet b;
+    bus.attach(a);
+    bus.attach(b);
+    auto *cf_a = a.create_internal(Name::build().set_identity_number(1), 0, 0x28).value();
+    auto *cf_b = b.create_internal(Name::build().set_identity_number(2), 0, 0x30).value();
+    a.start_address_claiming();
+    b.start_address_claiming();
+    for (int i = 0; i < 5; ++i) {
+        a.update(100);
+        b.update(100);
+    }
+
+    REQUIRE(a.traffic_profile() != nullptr);
+    CHECK(b.traffic_profile() == nullptr);
+    a.reset_traffic_profile();
+
+    for (int i = 0; i < 3; ++i)
+        b.send(0xFEF1, dp::Vector<u8>{1, 2, 3, 4, 5, 6, 7, 8}, cf_b);
+    a.send(0xFEF2, dp::Vector<u8>{1, 2, 3, 4, 5, 6, 7, 8}, cf_a);
+    a.update(1);
+
+    const TrafficProfiler &p = *a.traffic_profile();
+    REQUIRE(p.find(0, 0xFEF1, 0x30) != nullptr);
+    CHECK(p.find(0, 0xFEF1, 0x30)->frames == 3);
+    REQUIRE(p.find(0, 0xFEF2, 0x28) != nullptr);
+    CHECK(p.find(0, 0xFEF2, 0x28)->frames == 1);
+    CHECK(p.top(1)[0].source == 0x30);
+}
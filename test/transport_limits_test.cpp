@@ -0,0 +1,116 @@
+#include <doctest/doctest.h>
+#include <agrobus/net/etp.hpp>
+#include <agrobus/net/network_manager.hpp>
+#include <agrobus/net/tp.hpp>
+#include <agrobus/net/transport_limits.hpp>
+
+using namespace agrobus::net;
+
+namespace {
+    Frame tp_rts(Address from, Address to, u16 size, PGN pgn) {
+        Frame f;
+        f.id = Identifier::encode(Priority::Lowest, PGN_TP_CM, from, to);
+        f.data = {tp_cm::RTS,
+                  static_cast<u8>(size & 0xFF),
+                  static_cast<u8>(size >> 8),
+                  static_cast<u8>((size + 6) / 7),
+                  16,
+                  static_cast<u8>(pgn & 0xFF),
+                  static_cast<u8>((pgn >> 8) & 0xFF),
+                  static_cast<u8>((pgn >> 16) & 0xFF)};
+        return f;
+    }
+} // namespace
+
+TEST_CASE("TransportLimits caps sessions and bytes per source and overall") {
+    TransportLimitsConfig config;
+    config.max_sessions = 3;
+    config.max_bytes = 1000;
+    config.max_sessions_per_source = 2;
+    config.max_bytes_per_source = 600;
+    TransportLimits limits(config);
+
+    CHECK(limits.admit(0, 0x30, 300));
+    CHECK(limits.admit(0, 0x30, 300));
+    CHECK_FALSE(limits.admit(0, 0x30, 1));   // Third session from 0x30
+    CHECK_FALSE(limits.admit(0, 0x31, 500)); // Would pass the global byte cap
+    CHECK(limits.admit(1, 0x30, 300));       // Same address on another port is another source
+    CHECK_FALSE(limits.admit(0, 0x31, 10));  // Global session cap
+    CHECK(limits.rejected() == 3);
+    CHECK(limits.total().sessions == 3);
+    CHECK(limits.total().bytes == 900);
+    CHECK(limits.source(0, 0x30).bytes == 600);
+    CHECK(limits.source(0, 0x31).sessions == 0);
+
+    limits.release(0, 0x30, 300);
+    CHECK(limits.source(0, 0x30).sessions == 1);
+    CHECK(limits.admit(0, 0x31, 100));
+    CHECK(limits.total().bytes == 700);
+}
+
+TEST_CASE("TP refuses an RTS past the source's session cap") {
+    TransportLimitsConfig config;
+    config.max_sessions_per_source = 1;
+    TransportLimits limits(config);
+    TransportProtocol tp;
+    tp.set_limits(&limits);
+
+    auto out = tp.process_frame(tp_rts(0x30, 0x28, 20, 0xEF00));
+    REQUIRE(out.size() == 1);
+    CHECK(out[0].data[0] == tp_cm::CTS);
+
+    // Another session from 0x30, even to a different address of ours
+    out = tp.process_frame(tp_rts(0x30, 0x29, 20, 0xEF00));
+    REQUIRE(out.size() == 1);
+    CHECK(out[0].data[0] == tp_cm::ABORT);
+    CHECK(out[0].data[1] == static_cast<u8>(TransportAbortReason::ResourcesUnavailable));
+    CHECK(out[0].destination() == 0x30);
+
+    // A BAM from the same source is dropped as well; other sources are unaffected
+    Frame bam = tp_rts(0x30, BROADCAST_ADDRESS, 20, 0xFECA);
+    bam.data[0] = tp_cm::BAM;
+    CHECK(tp.process_frame(bam).empty());
+    CHECK(tp.active_sessions().size() == 1);
+    out = tp.process_frame(tp_rts(0x31, 0x28, 20, 0xEF00));
+    REQUIRE(out.size() == 1);
+    CHECK(out[0].data[0] == tp_cm::CTS);
+    CHECK(limits.total().sessions == 2);
+
+    // Ending the session, here by timeout, gives the reservation back
+    tp.update(TP_TIMEOUT_T1_MS);
+    CHECK(tp.active_sessions().empty());
+    CHECK(limits.total().sessions == 0);
+    CHECK(limits.total().bytes == 0);
+    out = tp.process_frame(tp_rts(0x30, 0x29, 20, 0xEF00));
+    REQUIRE(out.size() == 1);
+    CHECK(out[0].data[0] == tp_cm::CTS);
+}
+
+TEST_CASE("ETP refuses a huge announced transfer before allocating it") {
+    TransportLimitsConfig config;
+    config.max_bytes_per_source = 1u << 20;
+    TransportLimits limits(config);
+    ExtendedTransportProtocol etp;
+    etp.set_limits(&limits);
+
+    u32 size = ETP_MAX_DATA_LENGTH;
+    Frame rts;
+    rts.id = Identifier::encode(Priority::Lowest, PGN_ETP_CM, 0x30, 0x28);
+    rts.data = {etp_cm::RTS, static_cast<u8>(size), static_cast<u8>(size >> 8), static_cast<u8>(size >> 16),
+                static_cast<u8>(size >> 24), 0x00, 0xD7, 0x00};
+    auto out = etp.process_frame(rts);
+    REQUIRE(out.size() == 1);
+    CHECK(out[0].data[0] == etp_cm::ABORT);
+    CHECK(out[0].data[1] == static_cast<u8>(TransportAbortReason::ResourcesUnavailable));
+    CHECK(limits.rejected() == 1);
+    CHECK(limits.total().bytes == 0);
+}
+
+TEST_CASE("IsoNet applies NetworkConfig transport caps to TP and ETP") {
+    TransportLimitsConfig caps;
+    caps.max_sessions_per_source = 1;
+    IsoNet nm(NetworkConfig{}.transport_caps(caps));
+    CHECK(nm.transport_protocol().limits() == &nm.transport_limits());
+    CHECK(nm.extended_transport_protocol().limits() == &nm.transport_limits());
+    CHECK(nm.transport_limits().config().max_sessions_per_source == 1);
+}
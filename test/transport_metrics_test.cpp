@@ -0,0 +1,49 @@
+#include <doctest/doctest.h>
+#include <agrobus/net/transport_metrics.hpp>
+
+using namespace agrobus::net;
+
+TEST_CASE("TransportMetrics aggregates totals, ports and PGNs") {
+    TransportMetrics m;
+    m.started(0, 0xCB00);
+    m.started(1, 0xCB00);
+    m.started(1, 0xE700);
+    m.completed(0, 0xCB00, 1000, 100);
+    m.completed(1, 0xCB00, 3000, 300);
+    m.aborted(1, 0xE700, TransportAbortReason::BadSequence);
+    m.cts_round_trip(1, 0xCB00, 4);
+    m.cts_round_trip(1, 0xCB00, 8);
+
+    CHECK(m.total().started == 3);
+    CHECK(m.total().completed == 2);
+    CHECK(m.total().bytes == 4000);
+    CHECK(m.total().duration_ms_max == 300);
+    CHECK(m.total().mean_duration_ms() == doctest::Approx(200.0));
+    CHECK(m.total().bytes_per_second() == doctest::Approx(10000.0));
+    CHECK(m.total().aborts(TransportAbortReason::BadSequence) == 1);
+    CHECK(m.total().aborts(TransportAbortReason::Timeout) == 0);
+
+    CHECK(m.port(1).started == 2);
+    CHECK(m.port(1).mean_cts_rtt_ms() == doctest::Approx(6.0));
+    CHECK(m.pgn(0xCB00).completed == 2);
+    CHECK(m.pgn(0xE700).aborted == 1);
+    CHECK(m.port(7).started == 0);
+
+    usize ports = 0;
+    m.for_each_port([&](u8, const TransportCounters &) { ++ports; });
+    CHECK(ports == 2);
+    usize pgns = 0;
+    m.for_each_pgn([&](PGN, const TransportCounters &) { ++pgns; });
+    CHECK(pgns == 2);
+
+    m.reset();
+    CHECK(m.total().started == 0);
+    CHECK(m.pgn(0xCB00).completed == 0);
+}
+
+TEST_CASE("TransportCounters rates are zero without samples") {
+    TransportCounters c;
+    CHECK(c.bytes_per_second() == 0.0);
+    CHECK(c.mean_duration_ms() == 0.0);
+    CHECK(c.mean_cts_rtt_ms() == 0.0);
+}
@@ -0,0 +1,224 @@
+#include <doctest/doctest.h>
+#include <agrobus/net/tx_queue.hpp>
+#include <agrobus/net/constants.hpp>
+
+using namespace agrobus::net;
+
+static Frame frame_with(Priority prio, PGN pgn, u8 tag) {
+    Frame f;
+    f.id = Identifier::encode(prio, pgn, 0x28, BROADCAST_ADDRESS);
+    f.data[0] = tag;
+    return f;
+}
+
+TEST_CASE("TxQueue flushes highest priority first") {
+    TxQueue q;
+    q.push(frame_with(Priority::Lowest, PGN_TP_DT, 1));
+    q.push(frame_with(Priority::Lowest, PGN_TP_DT, 2));
+    q.push(frame_with(Priority::High, 0xFE00, 3));
+    q.push(frame_with(Priority::Lowest, PGN_TP_DT, 4));
+    q.push(frame_with(Priority::Normal, 0xF000, 5));
+
+    CHECK(q.size() == 5);
+    CHECK(q.lane_size(Priority::Lowest) == 3);
+
+    dp::Vector<u8> order;
+    usize sent = q.flush([&](const Frame &f) {
+        order.push_back(f.data[0]);
+        return true;
+    });
+
+    CHECK(sent == 5);
+    CHECK(q.empty());
+    REQUIRE(order.size() == 5);
+    CHECK(order[0] == 3); // priority 1
+    CHECK(order[1] == 5); // priority 3
+    CHECK(order[2] == 1); // priority 7, FIFO within lane
+    CHECK(order[3] == 2);
+    CHECK(order[4] == 4);
+}
+
+TEST_CASE("TxQueue flush counts failed writes") {
+    TxQueue q;
+    q.push(frame_with(Priority::Default, 0xFE00, 1));
+    q.push(frame_with(Priority::Default, 0xFE00, 2));
+
+    usize sent = q.flush([](const Frame &f) { return f.data[0] == 1; });
+    CHECK(sent == 1);
+    CHECK(q.empty());
+
+    SUBCASE("clear drops queued frames") {
+        q.push(frame_with(Priority::Default, 0xFE00, 3));
+        q.clear();
+        CHECK(q.size() == 0);
+    }
+}
+
+TEST_CASE("TxQueue busy flush keeps the refused frame and everything after it") {
+    TxQueue q;
+    q.push(frame_with(Priority::High, 0xFE00, 1));
+    q.push(frame_with(Priority::Lowest, PGN_TP_DT, 2));
+    q.push(frame_with(Priority::Lowest, PGN_TP_DT, 3));
+    q.push(frame_with(Priority::Lowest, PGN_TP_DT, 4));
+
+    usize room = 2;
+    dp::Vector<u8> order;
+    auto send = [&](const Frame &f) {
+        if (room == 0)
+            return false;
+        --room;
+        order.push_back(f.data[0]);
+        return true;
+    };
+    auto admit = [](const Frame &) { return TxAdmit::Send; };
+
+    CHECK(q.flush_until_busy(send, admit) == 2);
+    CHECK(q.size() == 2);
+
+    room = 8;
+    CHECK(q.flush_until_busy(send, admit) == 2);
+    CHECK(q.empty());
+    REQUIRE(order.size() == 4);
+    for (u8 i = 0; i < 4; ++i)
+        CHECK(order[i] == i + 1); // DT sequence survives the retry
+}
+
+TEST_CASE("TxQueue scheduled flush holds and stops") {
+    TxQueue q;
+    q.push(frame_with(Priority::Normal, 0xF000, 1));
+    q.push(frame_with(Priority::Normal, 0xF001, 2));
+    q.push(frame_with(Priority::Normal, 0xF000, 3));
+    q.push(frame_with(Priority::Lowest, PGN_TP_DT, 4));
+    q.push(frame_with(Priority::Lowest, PGN_TP_DT, 5));
+
+    dp::Vector<u8> order;
+    auto send = [&](const Frame &f) {
+        order.push_back(f.data[0]);
+        return true;
+    };
+
+    SUBCASE("hold keeps frames in order for the next flush") {
+        bool first_f000 = true;
+        usize sent = q.flush(send, [&](const Frame &f) {
+            if (f.pgn() == 0xF000) {
+                if (first_f000) {
+                    first_f000 = false;
+                    return TxAdmit::Send;
+                }
+                return TxAdmit::Hold;
+            }
+            return TxAdmit::Send;
+        });
+        CHECK(sent == 4);
+        CHECK(q.size() == 1);
+        order.clear();
+        q.flush(send);
+        REQUIRE(order.size() == 1);
+        CHECK(order[0] == 3);
+    }
+
+    SUBCASE("stop leaves the remainder queued") {
+        usize sent = q.flush(send, [](const Frame &f) {
+            return f.priority() == Priority::Lowest ? TxAdmit::Stop : TxAdmit::Send;
+        });
+        CHECK(sent == 3);
+        CHECK(q.size() == 2);
+        CHECK(q.lane_size(Priority::Lowest) == 2);
+    }
+}
+
+TEST_CASE("TxTokenBucket") {
+    SUBCASE("unlimited by default") {
+        TxTokenBucket b;
+        CHECK_FALSE(b.limited());
+        for (int i = 0; i < 1000; ++i)
+            CHECK(b.try_consume(8));
+    }
+
+    SUBCASE("limits to the configured share of the bus") {
+        TxTokenBucket b(10.0f); // 25 kbit/s, 100ms burst = 2500 bits
+        CHECK(b.limited());
+        u32 frames = 0;
+        while (b.try_consume(8))
+            ++frames;
+        CHECK(frames == 2500 / BusLoad::frame_bits(8));
+
+        b.refill(100);
+        u32 more = 0;
+        while (b.try_consume(8))
+            ++more;
+        CHECK(more == frames);
+    }
+
+    SUBCASE("forced consumption runs into debt") {
+        TxTokenBucket b(10.0f);
+        while (b.try_consume(8)) {
+        }
+        b.force_consume(8);
+        CHECK(b.tokens() < 0);
+        CHECK_FALSE(b.try_consume(0));
+    }
+}
+
+TEST_CASE("TxRateLimiter") {
+    TxRateLimiter rl;
+    rl.set_limit(0xFE00, 100);
+
+    CHECK(rl.ready(0xFE00));
+    rl.mark_sent(0xFE00);
+    CHECK_FALSE(rl.ready(0xFE00));
+    CHECK(rl.ready(0xFE01)); // unlimited PGN
+
+    rl.advance(50);
+    CHECK_FALSE(rl.ready(0xFE00));
+    rl.advance(50);
+    CHECK(rl.ready(0xFE00));
+
+    rl.remove_limit(0xFE00);
+    CHECK(rl.empty());
+}
+
+TEST_CASE("BusLoad bit models") {
+    auto exact = [](u32 id, dp::Array<u8, 8> data, u8 dlc = 8) {
+        return BusLoad::frame_bits_exact(id, data.data(), dlc);
+    };
+
+    SUBCASE("exact length counts the frame's stuff bits") {
+        CHECK(exact(0x00000000, {0, 0, 0, 0, 0, 0, 0, 0}) == 150);
+        CHECK(exact(0x18FEF128, {1, 2, 3, 4, 5, 6, 7, 8}) == 142);
+        CHECK(exact(0x1FFFFFFF, {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF}) == 149);
+        CHECK(exact(0x0CF00400, {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF}) == 147);
+        CHECK(exact(0x18EAFF28, {0x00, 0xEE, 0x00}, 3) == 96);
+    }
+
+    SUBCASE("exact never exceeds the worst case") {
+        for (u8 dlc = 0; dlc <= 8; ++dlc) {
+            CHECK(exact(0, {0, 0, 0, 0, 0, 0, 0, 0}, dlc) <= BusLoad::frame_bits_worst(dlc));
+            CHECK(exact(0x1FFFFFFF, {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF}, dlc) >= 67u + dlc * 8u);
+        }
+        CHECK(BusLoad::frame_bits_worst(8) == 160);
+    }
+
+    SUBCASE("load follows the configured bitrate") {
+        Frame f = frame_with(Priority::Default, 0xFEF1, 1);
+        BusLoad at_250k(250000, BitModel::Exact);
+        BusLoad at_500k(500000, BitModel::Exact);
+        for (int i = 0; i < 100; ++i) {
+            at_250k.add_frame(f);
+            at_500k.add_frame(f);
+        }
+        at_250k.update(100);
+        at_500k.update(100);
+        CHECK(at_250k.load_percent() > 0.0f);
+        CHECK(at_250k.load_percent() == doctest::Approx(at_500k.load_percent() * 2.0f));
+    }
+
+    SUBCASE("token bucket charges exact wire time") {
+        Frame f = frame_with(Priority::Default, 0xFEF1, 1);
+        TxTokenBucket b(10.0f, BusLoad::CAN_BITRATE, 100, BitModel::Exact);
+        u32 frames = 0;
+        while (b.try_consume(f))
+            ++frames;
+        CHECK(frames == 2500 / BusLoad::bits(f, BitModel::Exact));
+    }
+}
@@ -0,0 +1,73 @@
+#include <doctest/doctest.h>
+#include <agrobus/net/network_manager.hpp>
+#include <agrobus/net/udp_can.hpp>
+
+using namespace agrobus::net;
+
+namespace {
+
+    can_frame make_can(u32 id, u8 first) {
+        can_frame cf = {};
+        cf.can_id = id | CAN_EFF_FLAG;
+        cf.can_dlc = 8;
+        for (u8 i = 0; i < 8; ++i)
+            cf.data[i] = static_cast<u8>(first + i);
+        return cf;
+    }
+
+} // namespace
+
+TEST_CASE("CAN records round-trip through the shared encoding") {
+    dp::Vector<u8> buf;
+    append_can_record(buf, make_can(0x18FEF128, 1));
+    can_frame short_frame = make_can(0x0CFE4980, 9);
+    short_frame.can_dlc = 3;
+    append_can_record(buf, short_frame);
+    CHECK(buf.size() == 13 + 8);
+
+    dp::Vector<can_frame> out;
+    for_each_can_record(buf.data(), buf.size() - 1, [&](const can_frame &cf) { out.push_back(cf); });
+    REQUIRE(out.size() == 1); // Truncated record ignored
+    for_each_can_record(buf.data(), buf.size(), [&](const can_frame &cf) { out.push_back(cf); });
+    REQUIRE(out.size() == 3);
+    CHECK((out[2].can_id & CAN_EFF_MASK) == 0x0CFE4980);
+    CHECK(out[2].can_dlc == 3);
+    CHECK(out[2].data[2] == 11);
+
+    CanFrameRing ring;
+    ring.configure(3); // Rounded up to 4
+    for (u32 i = 0; i < 5; ++i)
+        ring.push(make_can(i, 0));
+    CHECK(ring.size() == 4);
+    CHECK(ring.dropped() == 1);
+    can_frame cf;
+    REQUIRE(ring.pop(cf));
+    CHECK((cf.can_id & CAN_EFF_MASK) == 0);
+}
+
+TEST_CASE("UdpCan carries batched frames over loopback") {
+    UdpCan rx(UdpCanConfig{}.group("127.0.0.1", 39117));
+    UdpCan tx(UdpCanConfig{}.group("127.0.0.1", 39117).send_only().batch(4, 1000000));
+    REQUIRE(rx.open().is_ok());
+    REQUIRE(tx.open().is_ok());
+
+    for (u32 i = 0; i < 10; ++i)
+        tx.send_can(make_can(0x18FEF100 + i, static_cast<u8>(i)));
+    tx.flush(); // Two full datagrams and a partial one
+
+    IsoNet nm;
+    nm.set_endpoint(0, &rx.can_endpoint());
+    nm.set_rx_source(0, rx.rx_source());
+    u32 seen = 0;
+    nm.on_frame_received.subscribe([&](const Frame &f, u8) {
+        CHECK(f.id.raw == 0x18FEF100 + seen);
+        CHECK(f.data[0] == seen);
+        ++seen;
+    });
+    rx.process();
+    nm.update(0);
+    CHECK(seen == 10);
+    CHECK(rx.datagrams_received() == 3);
+    CHECK(rx.datagrams_lost() == 0);
+    CHECK(tx.send_errors() == 0);
+}
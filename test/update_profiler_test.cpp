@@ -0,0 +1,99 @@
+#include <doctest/doctest.h>
+#include <agrobus/net/loopback_bus.hpp>
+#include <agrobus/net/update_profiler.hpp>
+#include <cstring>
+
+using namespace agrobus::net;
+
+static u64 fake_ns = 0;
+static u64 fake_clock() { return fake_ns; }
+
+TEST_CASE("UpdateProfiler keeps per-subsystem durations and overruns") {
+    UpdateProfiler profiler(1000000); // 1 ms for every subsystem
+    profiler.set_clock(&fake_clock);
+    profiler.set_budget("vt_client", 200000);
+    dp::Vector<const char *> overruns;
+    profiler.on_overrun.subscribe([&](const char *name, u64) { overruns.push_back(name); });
+
+    for (u64 ns : {100000, 300000, 150000}) {
+        ProfileScope scope(&profiler, "vt_client");
+        fake_ns += ns;
+    }
+    {
+        ProfileScope scope(&profiler, "tc_client");
+        fake_ns += 2000000;
+    }
+    { ProfileScope off(nullptr, "tc_client"); }
+
+    SubsystemProfile vt = profiler.profile("vt_client");
+    CHECK(vt.count == 3);
+    CHECK(vt.min_ns == 100000);
+    CHECK(vt.max_ns == 300000);
+    CHECK(vt.p99_ns == 300000);
+    CHECK(vt.mean_ns == doctest::Approx(183333.3).epsilon(0.001));
+    CHECK(vt.budget_ns == 200000);
+    CHECK(vt.overruns == 1);
+    SubsystemProfile tc = profiler.profile("tc_client");
+    CHECK(tc.count == 1);
+    CHECK(tc.overruns == 1);
+    REQUIRE(overruns.size() == 2);
+    CHECK(std::strcmp(overruns[1], "tc_client") == 0);
+    CHECK(profiler.profile("diagnostic").count == 0);
+
+    usize listed = 0;
+    profiler.for_each([&](const SubsystemProfile &p) { listed += p.count; });
+    CHECK(listed == 4);
+
+    profiler.reset();
+    CHECK(profiler.profile("vt_client").count == 0);
+    CHECK(profiler.profile("vt_client").budget_ns == 200000);
+    CHECK(profiler.size() == 2);
+}
+
+TEST_CASE("UpdateProfiler stops registering at MAX_SUBSYSTEMS") {
+    UpdateProfiler profiler;
+    dp::Vector<dp::String> names;
+    for (usize i = 0; i < UpdateProfiler::MAX_SUBSYSTEMS + 1; ++i)
+        names.push_back("subsystem " + std::to_string(i));
+    for (usize i = 0; i < UpdateProfiler::MAX_SUBSYSTEMS; ++i)
+        CHECK(profiler.slot(names[i].c_str()) == i);
+    CHECK(profiler.slot(names.back().c_str()) == UpdateProfiler::NO_SLOT);
+    CHECK(profiler.slot("subsystem 3") == 3); // Same text, another pointer
+    profiler.record(UpdateProfiler::NO_SLOT, 5);
+    CHECK(profiler.size() == UpdateProfiler::MAX_SUBSYSTEMS);
+}
+
+TEST_CASE("IsoNet profiles its update, dispatch and timers") {
+    LoopbackBus bus;
+    IsoNet a;
+    IsoNet b;
+    bus.attach(a);
+    bus.attach(b);
+    a.create_internal(Name::build().set_identity_number(1), 0, 0x28);
+    auto *cf_b = b.create_internal(Name::build().set_identity_number(2), 0, 0x30).value();
+    a.start_address_claiming();
+    b.start_address_claiming();
+    for (int i = 0; i < 5; ++i) {
+        a.update(100);
+        b.update(100);
+    }
+
+    UpdateProfiler profiler;
+    profiler.set_clock(&fake_clock);
+    a.set_update_profiler(&profiler);
+    CHECK(a.update_profiler() == &profiler);
+    a.register_pgn_callback(0xFEF1, [](const Message &) { fake_ns += 400000; });
+    a.timers().schedule(10, [] { fake_ns += 50000; });
+    b.send(0xFEF1, dp::Vector<u8>{1, 2, 3, 4, 5, 6, 7, 8}, cf_b);
+    a.update(10);
+
+    CHECK(profiler.profile("dispatch").count == 1);
+    CHECK(profiler.profile("dispatch").max_ns == 400000);
+    CHECK(profiler.profile("timers").max_ns == 50000);
+    CHECK(profiler.profile("isonet").count == 1);
+    CHECK(profiler.profile("isonet").max_ns == 450000);
+
+    a.set_update_profiler(nullptr);
+    a.update(10);
+    CHECK(profiler.profile("isonet").count == 1);
+}
@@ -0,0 +1,61 @@
+#include <doctest/doctest.h>
+#include <agrobus/isobus/vt/activation_table.hpp>
+
+using namespace agrobus::isobus;
+using namespace agrobus::isobus::vt;
+
+TEST_CASE("ActivationTable") {
+    ActivationTable table;
+    dp::Vector<ObjectID> calls;
+    for (ObjectID id = 0; id < 600; id += 3)
+        table.bind(id, [&calls, id](ActivationCode) { calls.push_back(id); });
+    CHECK(table.size() == 200);
+
+    SUBCASE("one handler per object") {
+        CHECK(table.dispatch(300, ActivationCode::Pressed));
+        CHECK_FALSE(table.dispatch(301, ActivationCode::Pressed));
+        CHECK_FALSE(table.dispatch(60000, ActivationCode::Pressed));
+        REQUIRE(calls.size() == 1);
+        CHECK(calls[0] == 300);
+    }
+
+    SUBCASE("activation code filter") {
+        u32 held = 0;
+        table.bind(7, [&held](ActivationCode code) { held += code == ActivationCode::Held; },
+                   activation::HELD | activation::PRESSED);
+        CHECK(table.dispatch(7, ActivationCode::Held));
+        CHECK(table.dispatch(7, ActivationCode::Pressed));
+        CHECK_FALSE(table.dispatch(7, ActivationCode::Released));
+        CHECK_FALSE(table.dispatch(7, ActivationCode::Aborted));
+        CHECK(held == 1);
+    }
+
+    SUBCASE("rebinding and unbinding") {
+        u32 second = 0;
+        table.bind(0, [&second](ActivationCode) { ++second; });
+        CHECK(table.size() == 200);
+        table.dispatch(0, ActivationCode::Pressed);
+        CHECK(second == 1);
+        CHECK(calls.empty());
+
+        CHECK(table.unbind(0));
+        CHECK_FALSE(table.unbind(0));
+        CHECK_FALSE(table.bound(0));
+        CHECK_FALSE(table.dispatch(0, ActivationCode::Pressed));
+        CHECK(table.size() == 199);
+        table.bind(0, [&second](ActivationCode) { ++second; });
+        CHECK(table.size() == 200);
+    }
+
+    SUBCASE("a handler may bind others") {
+        table.bind(1, [&table, &calls](ActivationCode) {
+            for (ObjectID id = 1000; id < 1100; ++id)
+                table.bind(id, [&calls, id](ActivationCode) { calls.push_back(id); });
+            calls.push_back(1);
+        });
+        CHECK(table.dispatch(1, ActivationCode::Pressed));
+        CHECK(table.dispatch(1050, ActivationCode::Pressed));
+        REQUIRE(calls.size() == 2);
+        CHECK(calls[1] == 1050);
+    }
+}
@@ -0,0 +1,108 @@
+#include <doctest/doctest.h>
+#include <agrobus/isobus/vt/change_journal.hpp>
+#include <agrobus/isobus/vt/server.hpp>
+
+using namespace agrobus::isobus;
+using namespace agrobus::isobus::vt;
+
+namespace {
+    // Working set 0 -> masks 1 and 2; mask 1 -> container 10 -> number 20; mask 2 -> number 20 and string 21
+    ObjectPool journal_pool() {
+        ObjectPool pool;
+        pool.add(VTObject().set_id(0).set_type(ObjectType::WorkingSet).set_body({0xC8, 0x00}).set_children({1, 2}));
+        pool.add(VTObject().set_id(1).set_type(ObjectType::DataMask).set_body({0x00}).set_children({10}));
+        pool.add(VTObject().set_id(2).set_type(ObjectType::DataMask).set_body({0x00}).set_children({20, 21}));
+        pool.add(VTObject().set_id(10).set_type(ObjectType::Container).set_children({20}));
+        pool.add(VTObject().set_id(20).set_type(ObjectType::OutputNumber).set_body({0, 0, 0, 0}));
+        pool.add(VTObject().set_id(21).set_type(ObjectType::OutputString).set_body({0}));
+        return pool;
+    }
+} // namespace
+
+TEST_CASE("VTChangeJournal") {
+    VTChangeJournal journal;
+    journal.set_pool(PoolImage::from_pool(journal_pool()).value());
+
+    SUBCASE("a new pool redraws everything once") {
+        auto first = journal.take();
+        CHECK(first.full_redraw);
+        CHECK(first.changed.empty());
+        CHECK(journal.take().empty());
+    }
+
+    SUBCASE("changes propagate up every parent chain") {
+        journal.take();
+        journal.mark(20);
+        journal.mark(20);
+        CHECK(journal.size() == 1);
+        auto set = journal.take();
+        CHECK_FALSE(set.full_redraw);
+        REQUIRE(set.changed.size() == 1);
+        CHECK(set.affected.size() == 5); // 20, 10, 2, 1, 0
+        for (ObjectID id : {20, 10, 1, 2, 0})
+            CHECK(set.affects(static_cast<ObjectID>(id)));
+        CHECK_FALSE(set.affects(21));
+        CHECK_FALSE(journal.pending());
+    }
+
+    SUBCASE("frames are independent") {
+        journal.take();
+        journal.mark(21);
+        auto a = journal.take();
+        CHECK(a.affected.size() == 3); // 21, 2, 0
+        CHECK_FALSE(a.affects(1));
+        journal.mark(21);
+        CHECK(journal.take().changed.size() == 1); // Marked again after the frame closed
+    }
+
+    SUBCASE("an ObjectPool gives the same index") {
+        journal.set_pool(journal_pool());
+        journal.take();
+        journal.mark(10);
+        auto set = journal.take();
+        CHECK(set.affected.size() == 3); // 10, 1, 0
+    }
+}
+
+TEST_CASE("VTServer journals the objects a client changes") {
+    IsoNet nm;
+    auto *cf = nm.create_internal(Name::build().set_identity_number(1), 0, 0x26).value();
+    VTServer server(nm, cf);
+    server.start();
+
+    auto bytes = journal_pool().serialize().value();
+    dp::Vector<u8> transfer;
+    transfer.push_back(vt_cmd::OBJECT_POOL_TRANSFER);
+    transfer.insert(transfer.end(), bytes.begin(), bytes.end());
+    nm.inject_message(Message(PGN_ECU_TO_VT, transfer, 0x80, 0x26));
+    nm.inject_message(Message(PGN_ECU_TO_VT, {vt_cmd::END_OF_POOL, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF}, 0x80,
+                              0x26));
+    REQUIRE(server.client(0x80));
+    CHECK(server.take_changes(0x80).full_redraw);
+
+    nm.inject_message(Message(PGN_ECU_TO_VT, {vt_cmd::CHANGE_NUMERIC_VALUE, 20, 0, 0xFF, 5, 0, 0, 0}, 0x80, 0x26));
+    nm.inject_message(Message(PGN_ECU_TO_VT, {vt_cmd::CHANGE_STRING_VALUE, 21, 0, 1, 0, 'x'}, 0x80, 0x26));
+    auto set = server.take_changes(0x80);
+    CHECK_FALSE(set.full_redraw);
+    REQUIRE(set.changed.size() == 2);
+    CHECK(set.changed[0] == 20);
+    CHECK(set.changed[1] == 21);
+    CHECK(server.take_changes(0x80).empty());
+    CHECK(server.take_changes(0x81).empty());
+
+    SUBCASE("a later transfer redraws only the objects it replaces") {
+        ObjectPool patch;
+        patch.add(VTObject().set_id(21).set_type(ObjectType::OutputString).set_body({1}));
+        auto patch_bytes = patch.serialize().value();
+        dp::Vector<u8> t;
+        t.push_back(vt_cmd::OBJECT_POOL_TRANSFER);
+        t.insert(t.end(), patch_bytes.begin(), patch_bytes.end());
+        nm.inject_message(Message(PGN_ECU_TO_VT, t, 0x80, 0x26));
+        nm.inject_message(Message(PGN_ECU_TO_VT, {vt_cmd::END_OF_POOL, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF},
+                                  0x80, 0x26));
+        auto patched = server.take_changes(0x80);
+        CHECK_FALSE(patched.full_redraw);
+        REQUIRE(patched.changed.size() == 1);
+        CHECK(patched.changed[0] == 21);
+    }
+}
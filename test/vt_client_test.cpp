@@ -75,3 +75,234 @@ TEST_CASE("VTClient commands require connected state") {
         CHECK(result.is_err());
     }
 }
+
+// ─── Version-first connect against a VTServer on a loopback bus ───────────────
+#include <agrobus/isobus/vt/server.hpp>
+#include <agrobus/net/loopback_bus.hpp>
+
+namespace {
+    ObjectPool version_pool() {
+        ObjectPool pool;
+        pool.add(VTObject().set_id(0).set_type(ObjectType::WorkingSet).set_body({0xC8, 0x00, 0xC8, 0x00}));
+        pool.add(VTObject().set_id(1).set_type(ObjectType::DataMask).set_body({0x00}));
+        return pool;
+    }
+
+    struct VersionBench {
+        LoopbackBus bus;
+        IsoNet nm_vt;
+        IsoNet nm_ecu;
+        VTServer server;
+        InternalCF *ecu_cf;
+
+        VersionBench()
+            : server(nm_vt, nm_vt.create_internal(Name::build().set_identity_number(1), 0, 0x26).value()),
+              ecu_cf(nm_ecu.create_internal(Name::build().set_identity_number(2), 0, 0x80).value()) {
+            bus.attach(nm_vt);
+            bus.attach(nm_ecu);
+            server.start();
+        }
+
+        // Run until `client` is connected or gives up
+        bool run(VTClient &client) {
+            for (u32 i = 0; i < 2000 && client.state() != VTState::Connected; ++i) {
+                nm_vt.update(5);
+                server.update(5);
+                nm_ecu.update(5);
+                client.update(5);
+                if (client.state() == VTState::Disconnected)
+                    return false;
+            }
+            // Let the store version round trip finish
+            for (u32 i = 0; i < 10; ++i) {
+                nm_vt.update(5);
+                nm_ecu.update(5);
+            }
+            return client.state() == VTState::Connected;
+        }
+    };
+} // namespace
+
+TEST_CASE("VTClient version-first connect") {
+    VersionBench b;
+    u32 uploads = 0;
+    b.nm_vt.register_pgn_callback(PGN_ECU_TO_VT, [&](const Message &msg) {
+        if (!msg.data.empty() && msg.data[0] == vt_cmd::OBJECT_POOL_TRANSFER)
+            ++uploads;
+    });
+
+    SUBCASE("first connect uploads and stores, the next one loads") {
+        VTClient first(b.nm_ecu, b.ecu_cf, VTClientConfig{}.stored_version());
+        first.set_object_pool(version_pool());
+        REQUIRE(first.connect().is_ok());
+        REQUIRE(b.run(first));
+        CHECK(uploads == 1);
+        CHECK_FALSE(first.pool_from_version());
+        CHECK(first.pool_version_label() == IOPParser::hash_to_version(version_pool().serialize().value()).value());
+        REQUIRE(b.server.clients().size() == 1);
+        REQUIRE(b.server.clients()[0].stored_versions.size() == 1);
+        CHECK(b.server.clients()[0].stored_versions[0].label == first.pool_version_label());
+        first.disconnect();
+
+        VTClient second(b.nm_ecu, b.ecu_cf, VTClientConfig{}.stored_version());
+        second.set_object_pool(version_pool());
+        REQUIRE(second.connect().is_ok());
+        REQUIRE(b.run(second));
+        CHECK(second.pool_from_version());
+        CHECK(uploads == 1); // No second transfer
+    }
+
+    SUBCASE("explicit label") {
+        VTClient client(b.nm_ecu, b.ecu_cf, VTClientConfig{}.stored_version("POOLV1"));
+        client.set_object_pool(version_pool());
+        REQUIRE(client.connect().is_ok());
+        REQUIRE(b.run(client));
+        CHECK(client.pool_version_label() == "POOLV1");
+        REQUIRE(b.server.clients().size() == 1);
+        REQUIRE(b.server.clients()[0].stored_versions.size() == 1);
+        CHECK(b.server.clients()[0].stored_versions[0].label == "POOLV1");
+    }
+
+    SUBCASE("without the mode every connect uploads") {
+        VTClient client(b.nm_ecu, b.ecu_cf);
+        client.set_object_pool(version_pool());
+        REQUIRE(client.connect().is_ok());
+        REQUIRE(b.run(client));
+        CHECK(uploads == 1);
+        REQUIRE(b.server.clients().size() == 1);
+        CHECK(b.server.clients()[0].stored_versions.empty());
+    }
+}
+
+TEST_CASE("VTClient pool update") {
+    VersionBench b;
+    dp::Vector<usize> transfers; // Object Pool Transfer sizes
+    b.nm_vt.register_pgn_callback(PGN_ECU_TO_VT, [&](const Message &msg) {
+        if (!msg.data.empty() && msg.data[0] == vt_cmd::OBJECT_POOL_TRANSFER)
+            transfers.push_back(msg.data.size() - 1);
+    });
+    dp::Vector<u32> numeric;
+    b.server.on_numeric_value_change.subscribe([&](ObjectID, u32 value) { numeric.push_back(value); });
+
+    auto base = version_pool();
+    base.add(VTObject().set_id(10).set_type(ObjectType::NumberVariable).set_body({1, 0, 0, 0}));
+    VTClient client(b.nm_ecu, b.ecu_cf);
+    client.set_object_pool(base);
+    REQUIRE(client.connect().is_ok());
+    REQUIRE(b.run(client));
+    REQUIRE(transfers.size() == 1);
+
+    SUBCASE("value changes go out as commands") {
+        auto newer = base;
+        (*newer.find(10))->body = {42, 0, 0, 0};
+        auto diff = client.update_pool(newer);
+        REQUIRE(diff.is_ok());
+        CHECK(diff.value().changed == dp::Vector<ObjectID>{10});
+        b.run(client);
+        CHECK(transfers.size() == 1);
+        CHECK(numeric == dp::Vector<u32>{42});
+        CHECK(client.state() == VTState::Connected);
+    }
+
+    SUBCASE("other changes are a partial transfer the VT merges") {
+        auto newer = base;
+        (*newer.find(1))->body = {0x07};
+        newer.add(VTObject().set_id(20).set_type(ObjectType::OutputString).set_body({'o', 'k'}));
+        REQUIRE(client.update_pool(newer).is_ok());
+        CHECK(client.state() == VTState::WaitForPoolActivate);
+        REQUIRE(b.run(client));
+        REQUIRE(transfers.size() == 2);
+        CHECK(transfers[1] == newer.subset({1, 20}).serialized_size());
+
+        const auto &vt_pool = b.server.clients()[0].pool;
+        CHECK(vt_pool.size() == 4);
+        REQUIRE(vt_pool.find(1).has_value());
+        CHECK(vt_pool.find(1)->body[0] == 0x07);
+        CHECK(vt_pool.contains(20));
+        CHECK(vt_pool.contains(10));
+    }
+}
+
+TEST_CASE("VTClient static pool") {
+    static constexpr auto ROM_POOL = make_static_pool([] {
+        return StaticPoolBuilder<64, 2>{}
+            .add(0, ObjectType::WorkingSet, {0xC8, 0x00, 0xC8, 0x00})
+            .add(1, ObjectType::DataMask, {0x00});
+    });
+    VersionBench b;
+    dp::Vector<u8> uploaded;
+    b.nm_vt.register_pgn_callback(PGN_ECU_TO_VT, [&](const Message &msg) {
+        if (!msg.data.empty() && msg.data[0] == vt_cmd::OBJECT_POOL_TRANSFER)
+            uploaded.assign(msg.data.begin() + 1, msg.data.end());
+    });
+
+    VTClient client(b.nm_ecu, b.ecu_cf, VTClientConfig{}.stored_version());
+    client.set_object_pool(ROM_POOL);
+    REQUIRE(client.connect().is_ok());
+    REQUIRE(b.run(client));
+    CHECK(uploaded == version_pool().serialize().value());
+    CHECK(client.pool_version_label() == ROM_POOL.version_label());
+    CHECK(client.pool_version_label() == IOPParser::hash_to_version(version_pool().serialize().value()).value());
+    REQUIRE(b.server.clients().size() == 1);
+    CHECK(b.server.clients()[0].pool.size() == 2);
+
+    SUBCASE("an update diffs against the decoded static pool") {
+        auto newer = version_pool();
+        newer.add(VTObject().set_id(10).set_type(ObjectType::NumberVariable).set_body({1, 0, 0, 0}));
+        auto diff = client.update_pool(newer);
+        REQUIRE(diff.is_ok());
+        CHECK(diff.value().added == dp::Vector<ObjectID>{10});
+        CHECK(diff.value().changed.empty());
+    }
+}
+
+TEST_CASE("VTClient scales the pool to the VT") {
+    LoopbackBus bus;
+    IsoNet nm_vt;
+    IsoNet nm_ecu;
+    VTServer server(nm_vt, nm_vt.create_internal(Name::build().set_identity_number(1), 0, 0x26).value(),
+                    VTServerConfig{}.screen(720, 720).soft_keys(90, 90));
+    auto *ecu_cf = nm_ecu.create_internal(Name::build().set_identity_number(2), 0, 0x80).value();
+    bus.attach(nm_vt);
+    bus.attach(nm_ecu);
+    server.start();
+    dp::Vector<u8> uploaded;
+    nm_vt.register_pgn_callback(PGN_ECU_TO_VT, [&](const Message &msg) {
+        if (!msg.data.empty() && msg.data[0] == vt_cmd::OBJECT_POOL_TRANSFER)
+            uploaded.assign(msg.data.begin() + 1, msg.data.end());
+    });
+    auto connect = [&](VTClient &client) {
+        REQUIRE(client.connect().is_ok());
+        for (u32 i = 0; i < 2000 && client.state() != VTState::Connected; ++i) {
+            nm_vt.update(5);
+            server.update(5);
+            nm_ecu.update(5);
+            client.update(5);
+        }
+        REQUIRE(client.state() == VTState::Connected);
+    };
+
+    ObjectPool pool = version_pool();
+    pool.add(VTObject().set_id(10).set_type(ObjectType::Container).set_body({200, 0, 100, 0, 0}));
+    VTGeometry design{480, 60, 60};
+    ScaledPoolCache cache;
+
+    VTClient first(nm_ecu, ecu_cf, VTClientConfig{}.scale_from(design).stored_version());
+    first.set_scaled_pool_cache(&cache);
+    first.set_object_pool(pool);
+    connect(first);
+    CHECK(first.pool_scaled());
+    CHECK((first.vt_geometry() == VTGeometry{720, 90, 90}));
+    CHECK(uploaded == scale_pool(pool, design, VTGeometry{720, 90, 90}));
+    CHECK(first.pool_version_label() == IOPParser::hash_to_version(uploaded).value());
+    CHECK(cache.misses() == 1);
+    first.disconnect();
+
+    VTClient second(nm_ecu, ecu_cf, VTClientConfig{}.scale_from(design));
+    second.set_scaled_pool_cache(&cache);
+    second.set_object_pool(pool);
+    uploaded.clear();
+    connect(second);
+    CHECK(cache.hits() == 1);
+    CHECK(uploaded == scale_pool(pool, design, VTGeometry{720, 90, 90}));
+}
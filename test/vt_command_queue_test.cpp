@@ -0,0 +1,183 @@
+#include <doctest/doctest.h>
+#include <agrobus/isobus/vt/client.hpp>
+#include <agrobus/isobus/vt/server.hpp>
+#include <agrobus/net/loopback_bus.hpp>
+
+using namespace agrobus::isobus;
+using namespace agrobus::isobus::vt;
+
+namespace {
+    dp::Vector<u8> numeric(ObjectID id, u32 value) {
+        return {vt_cmd::CHANGE_NUMERIC_VALUE,
+                static_cast<u8>(id & 0xFF),
+                static_cast<u8>(id >> 8),
+                0xFF,
+                static_cast<u8>(value & 0xFF),
+                static_cast<u8>((value >> 8) & 0xFF),
+                0x00,
+                0x00};
+    }
+
+    dp::Vector<u8> numeric_response(ObjectID id) {
+        return {vt_cmd::CHANGE_NUMERIC_VALUE, static_cast<u8>(id & 0xFF), static_cast<u8>(id >> 8), 0, 0, 0, 0, 0};
+    }
+
+    struct Sent {
+        dp::Vector<dp::Vector<u8>> frames;
+        bool accept = true;
+        bool operator()(const dp::Vector<u8> &data) {
+            if (accept)
+                frames.push_back(data);
+            return accept;
+        }
+    };
+} // namespace
+
+TEST_CASE("VTCommandQueue window") {
+    VTCommandQueue q(VTCommandQueueConfig{}.window(4).timeout(100).retry(1));
+    Sent sent;
+    auto send = [&](const dp::Vector<u8> &d) { return sent(d); };
+
+    for (ObjectID id = 1; id <= 10; ++id)
+        REQUIRE(q.push(numeric(id, id)));
+
+    SUBCASE("starts with one command in flight") {
+        q.dispatch(send);
+        CHECK(q.in_flight() == 1);
+        CHECK(q.waiting() == 9);
+        CHECK(sent.frames.size() == 1);
+    }
+
+    SUBCASE("grows while the VT answers") {
+        q.dispatch(send);
+        for (ObjectID id = 1; id <= 10; ++id) {
+            CHECK(q.on_response(numeric_response(id)));
+            q.dispatch(send);
+        }
+        CHECK(q.idle());
+        CHECK(q.answered() == 10);
+        CHECK(q.window() == 4);
+        CHECK(sent.frames.size() == 10);
+    }
+
+    SUBCASE("responses match by object") {
+        q.dispatch(send);
+        CHECK_FALSE(q.on_response(numeric_response(2))); // Not in flight
+        dp::Vector<u8> hide = {vt_cmd::HIDE_SHOW, 1, 0, 0, 0, 0, 0, 0};
+        CHECK_FALSE(q.on_response(hide)); // Other function
+        CHECK(q.on_response(numeric_response(1)));
+    }
+
+    SUBCASE("halves on a timeout, retries, then drops") {
+        // Open the window to 2
+        q.dispatch(send);
+        CHECK(q.on_response(numeric_response(1)));
+        q.dispatch(send);
+        CHECK(q.window() == 2);
+        CHECK(q.in_flight() == 2);
+
+        u32 drops = 0;
+        auto drop = [&](u8 func, ObjectID) {
+            CHECK(func == vt_cmd::CHANGE_NUMERIC_VALUE);
+            ++drops;
+        };
+        q.update(100, send, drop);
+        CHECK(q.resent() == 2);
+        CHECK(q.window() == 1);
+        q.update(100, send, drop);
+        CHECK(drops == 2);
+        CHECK(q.dropped() == 2);
+        CHECK(q.in_flight() == 1); // The next one went out
+    }
+
+    SUBCASE("bus refusing a frame keeps it first in line") {
+        sent.accept = false;
+        q.dispatch(send);
+        CHECK(q.in_flight() == 0);
+        sent.accept = true;
+        q.dispatch(send);
+        REQUIRE(sent.frames.size() == 1);
+        CHECK(sent.frames[0] == numeric(1, 1));
+    }
+}
+
+TEST_CASE("VTCommandQueue one command per target") {
+    VTCommandQueue q(VTCommandQueueConfig{}.window(4).timeout(100));
+    Sent sent;
+    auto send = [&](const dp::Vector<u8> &d) { return sent(d); };
+
+    q.push(numeric(7, 1));
+    q.dispatch(send);
+    q.push(numeric(7, 2));
+    q.push(numeric(7, 3)); // Replaces 2 while 1 is in flight
+    q.dispatch(send);
+    CHECK(q.in_flight() == 1);
+    CHECK(q.waiting() == 1);
+
+    SUBCASE("the latest goes out after the response") {
+        CHECK(q.on_response(numeric_response(7)));
+        q.dispatch(send);
+        REQUIRE(sent.frames.size() == 2);
+        CHECK(sent.frames[1] == numeric(7, 3));
+    }
+
+    SUBCASE("a superseded command is not resent") {
+        q.update(100, send);
+        CHECK(q.resent() == 0);
+        CHECK(q.dropped() == 0);
+        REQUIRE(sent.frames.size() == 2);
+        CHECK(sent.frames[1] == numeric(7, 3));
+    }
+}
+
+TEST_CASE("VTClient pipelined commands") {
+    LoopbackBus bus;
+    IsoNet nm_vt;
+    IsoNet nm_ecu;
+    VTServer server(nm_vt, nm_vt.create_internal(Name::build().set_identity_number(1), 0, 0x26).value());
+    auto *cf = nm_ecu.create_internal(Name::build().set_identity_number(2), 0, 0x80).value();
+    bus.attach(nm_vt);
+    bus.attach(nm_ecu);
+    server.start();
+
+    u32 received = 0;
+    server.on_numeric_value_change.subscribe([&](ObjectID, u32) { ++received; });
+
+    VTClient client(nm_ecu, cf, VTClientConfig{}.pipelined(VTCommandQueueConfig{}.window(8)));
+    ObjectPool pool;
+    pool.add(VTObject().set_id(0).set_type(ObjectType::WorkingSet).set_body({0xC8, 0x00, 0xC8, 0x00}));
+    pool.add(VTObject().set_id(1).set_type(ObjectType::DataMask).set_body({0x00}));
+    client.set_object_pool(std::move(pool));
+    REQUIRE(client.connect().is_ok());
+    auto step = [&] {
+        nm_vt.update(5);
+        server.update(5);
+        nm_ecu.update(5);
+        client.update(5);
+    };
+    for (u32 i = 0; i < 2000 && client.state() != VTState::Connected; ++i)
+        step();
+    REQUIRE(client.state() == VTState::Connected);
+
+    for (ObjectID id = 100; id < 150; ++id)
+        REQUIRE(client.change_numeric_value(id, id).is_ok());
+    CHECK(client.command_queue().in_flight() == 1);
+
+    for (u32 i = 0; i < 200 && !client.command_queue().idle(); ++i)
+        step();
+    CHECK(client.command_queue().idle());
+    CHECK(received == 50);
+    CHECK(client.command_queue().answered() == 50);
+    CHECK(client.command_queue().dropped() == 0);
+    CHECK(client.command_queue().window() == 8);
+
+    SUBCASE("unanswered commands time out") {
+        u32 timeouts = 0;
+        client.on_command_timeout.subscribe([&](u8, ObjectID) { ++timeouts; });
+        REQUIRE(client.hide_show(5, false).is_ok()); // The test VT does not answer Hide/Show
+        for (u32 i = 0; i < 1000 && !client.command_queue().idle(); ++i)
+            step();
+        CHECK(timeouts == 1);
+        CHECK(client.command_queue().resent() == 2);
+    }
+}
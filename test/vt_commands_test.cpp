@@ -352,6 +352,31 @@ TEST_CASE("VT event dispatch via frames") {
         CHECK(received_code == ActivationCode::Held);
     }
 
+    SUBCASE("per-object button handlers") {
+        u32 pressed = 0;
+        u32 other = 0;
+        fix.vt->bind_button(3000, [&](ActivationCode) { ++pressed; }, activation::PRESSED);
+        fix.vt->bind_button(3001, [&](ActivationCode) { ++other; });
+
+        auto press = [&](ObjectID id, ActivationCode code) {
+            Frame msg;
+            msg.id = Identifier::encode(Priority::Default, PGN_VT_TO_ECU, 0x26, 0x28);
+            msg.data = {vt_cmd::BUTTON_ACTIVATION, static_cast<u8>(id & 0xFF), static_cast<u8>(id >> 8),
+                        static_cast<u8>(code), 0xFF, 0xFF, 0xFF, 0xFF};
+            msg.length = 8;
+            fix.link->inject(msg);
+            fix.nm.update();
+        };
+        press(3000, ActivationCode::Pressed);
+        press(3000, ActivationCode::Released); // Filtered out
+        CHECK(pressed == 1);
+        CHECK(other == 0);
+
+        CHECK(fix.vt->unbind_button(3000));
+        press(3000, ActivationCode::Pressed);
+        CHECK(pressed == 1);
+    }
+
     SUBCASE("numeric value change event") {
         ObjectID received_id = 0;
         u32 received_value = 0;
@@ -0,0 +1,69 @@
+#include <doctest/doctest.h>
+#include <agrobus/isobus/vt/language_pools.hpp>
+
+using namespace agrobus::isobus;
+using namespace agrobus::isobus::vt;
+
+namespace {
+    VTObject label(ObjectID id, const char *text) {
+        dp::Vector<u8> body;
+        for (const char *c = text; *c; ++c)
+            body.push_back(static_cast<u8>(*c));
+        return VTObject().set_id(id).set_type(ObjectType::OutputString).set_body(std::move(body));
+    }
+
+    ObjectPool language_pool(const char *hello, const char *speed) {
+        ObjectPool pool;
+        pool.add(VTObject().set_id(0).set_type(ObjectType::WorkingSet).set_children({1}));
+        pool.add(VTObject().set_id(1).set_type(ObjectType::DataMask).set_children({10, 11, 20}));
+        pool.add(label(10, hello));
+        pool.add(label(11, speed));
+        pool.add(VTObject().set_id(20).set_type(ObjectType::OutputNumber).set_body(dp::Vector<u8>(32, 0x55)));
+        return pool;
+    }
+} // namespace
+
+TEST_CASE("LanguagePools") {
+    LanguagePools pools;
+    REQUIRE(pools.add("en", language_pool("Hello", "Speed")).is_ok());
+    REQUIRE(pools.add("de", language_pool("Hallo", "Geschwindigkeit")).is_ok());
+    REQUIRE(pools.add("nl", language_pool("Hallo", "Snelheid")).is_ok());
+    CHECK(pools.size() == 3);
+    CHECK(pools.base_language() == "en");
+
+    SUBCASE("overlays keep only what differs") {
+        CHECK(pools.overlay("en")->empty());
+        CHECK(pools.overlay("de")->size() == 2);
+        CHECK(pools.overlay("fr") == nullptr);
+        CHECK(pools.stored_size() < pools.composed_size());
+    }
+
+    SUBCASE("composed pools match the originals") {
+        auto de = pools.compose("de");
+        CHECK(de.diff(language_pool("Hallo", "Geschwindigkeit")).empty());
+        CHECK(de.objects()[2].id == 10); // Replaced in place, order kept
+        CHECK(pools.compose("en").diff(language_pool("Hello", "Speed")).empty());
+        CHECK(pools.compose("fr").diff(pools.base()).empty()); // Unknown: the base language
+        CHECK(de.serialize().value() != pools.compose("nl").serialize().value());
+    }
+
+    SUBCASE("a language may add objects, not leave any out") {
+        auto extra = language_pool("Bonjour", "Vitesse");
+        extra.add(label(12, "km/h"));
+        REQUIRE(pools.add("fr", extra).is_ok());
+        CHECK(pools.compose("fr").contains(12));
+        CHECK_FALSE(pools.compose("de").contains(12));
+
+        ObjectPool partial;
+        partial.add(VTObject().set_id(0).set_type(ObjectType::WorkingSet).set_children({1}));
+        CHECK(pools.add("it", partial).is_err());
+        CHECK_FALSE(pools.contains("it"));
+    }
+
+    SUBCASE("adding a language again replaces it") {
+        REQUIRE(pools.add("de", language_pool("Hallo", "Tempo")).is_ok());
+        CHECK(pools.size() == 3);
+        CHECK(pools.compose("de").find(11).value()->body.size() == 5);
+        CHECK(pools.add("en", language_pool("Hi", "Speed")).is_err());
+    }
+}
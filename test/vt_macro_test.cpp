@@ -108,3 +108,93 @@ TEST_CASE("VTClient - macro executed event") {
     CHECK_FALSE(result.is_ok());
     CHECK_FALSE(event_fired); // Not connected, so execute_macro returns early
 }
+
+namespace {
+    VTClient::VTMacro value_macro() {
+        VTClient::VTMacro macro;
+        macro.macro_id = 7;
+        macro.commands.push_back({vt_cmd::CHANGE_NUMERIC_VALUE, 0x64, 0x00, 0xFF, 0x2A, 0x00, 0x00, 0x00});
+        macro.commands.push_back({vt_cmd::CHANGE_STRING_VALUE, 0x65, 0x00, 0x02, 0x00, 'o', 'k'});
+        macro.commands.push_back({vt_cmd::HIDE_SHOW, 0x01, 0x00, 0x00, 0xFF, 0xFF, 0xFF, 0xFF});
+        return macro;
+    }
+} // namespace
+
+TEST_CASE("VTMacroTable - compiled from the pool") {
+    ObjectPool pool;
+    pool.add(VTObject().set_id(0).set_type(ObjectType::WorkingSet).set_children({1}));
+    pool.add(VTObject().set_id(1).set_type(ObjectType::DataMask));
+    pool.add(value_macro().to_object());
+    pool.add(VTObject().set_id(8).set_type(ObjectType::Macro).set_body({0x08, 0x00, 0xA0, 0x01})); // Cut short
+
+    auto table = VTMacroTable::compile(pool);
+    CHECK(table.size() == 1);
+    CHECK(table.rejected() == 1);
+    CHECK_FALSE(table.contains(8));
+
+    auto program = table.find(7);
+    REQUIRE(program.has_value());
+    REQUIRE(program->size() == 3);
+    CHECK((*program)[0].function == vt_cmd::CHANGE_NUMERIC_VALUE);
+    CHECK((*program)[0].object == 100);
+    CHECK((*program)[0].value == 42);
+    CHECK((*program)[1].object == 101);
+    CHECK((*program)[1].value == 2);
+    CHECK(table.bytes((*program)[1]).size() == 2);
+    CHECK(table.bytes((*program)[1])[1] == 'k');
+    CHECK(table.bytes((*program)[2]).size() == 8);
+
+    auto image = PoolImage::parse(pool.serialize().value());
+    REQUIRE(image.is_ok());
+    CHECK(VTMacroTable::compile(image.value()).commands() == 3);
+}
+
+TEST_CASE("VTServer - runs compiled macros") {
+    IsoNet nm;
+    auto *cf = nm.create_internal(Name::build().set_identity_number(1), 0, 0x10).value();
+    VTServer server(nm, cf);
+    server.start();
+
+    ObjectPool pool;
+    pool.add(VTObject().set_id(0).set_type(ObjectType::WorkingSet).set_children({1}));
+    pool.add(VTObject().set_id(1).set_type(ObjectType::DataMask));
+    pool.add(value_macro().to_object());
+    dp::Vector<u8> data;
+    data.push_back(vt_cmd::OBJECT_POOL_TRANSFER);
+    pool.serialize_into(data);
+    nm.inject_message(Message(PGN_ECU_TO_VT, {vt_cmd::GET_MEMORY, 0xFF, 0, 0, 0, 0xFF, 0xFF, 0xFF}, 0x80, 0x10));
+    nm.inject_message(Message(PGN_ECU_TO_VT, data, 0x80, 0x10));
+    nm.inject_message(
+        Message(PGN_ECU_TO_VT, {vt_cmd::END_OF_POOL, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF}, 0x80, 0x10));
+    REQUIRE(server.client(0x80));
+    CHECK(server.client(0x80)->macros.size() == 1);
+
+    u32 number = 0;
+    dp::String text;
+    u32 other = 0;
+    server.on_numeric_value_change.subscribe([&](ObjectID id, u32 value) { number = id == 100 ? value : 0; });
+    server.on_string_value_change.subscribe([&](ObjectID, dp::String value) { text = value; });
+    server.on_macro_command.subscribe([&](Address addr, DataSpan cmd) {
+        if (addr == 0x80 && cmd[0] == vt_cmd::HIDE_SHOW)
+            ++other;
+    });
+
+    SUBCASE("run by the VT") {
+        server.take_changes(0x80);
+        CHECK(server.execute_macro(0x80, 7));
+        CHECK(number == 42);
+        CHECK(text == "ok");
+        CHECK(other == 1);
+        auto changes = server.take_changes(0x80);
+        CHECK(changes.changed.size() == 2);
+        CHECK_FALSE(server.execute_macro(0x80, 9));
+        CHECK_FALSE(server.execute_macro(0x81, 7));
+    }
+
+    SUBCASE("Execute Macro from the client") {
+        nm.inject_message(
+            Message(PGN_ECU_TO_VT, {vt_cmd::EXECUTE_MACRO, 7, 0, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF}, 0x80, 0x10));
+        CHECK(number == 42);
+        CHECK(other == 1);
+    }
+}
@@ -139,6 +139,29 @@ TEST_CASE("ObjectPool") {
         CHECK((*found2)->body.size() == 3);
     }
 
+    SUBCASE("serialize_into appends the pool in one pass") {
+        pool.add(VTObject{}.set_id(1).set_type(ObjectType::WorkingSet).set_body({0x01, 0x02}).set_children({2}));
+        pool.add(VTObject{}.set_id(2).set_type(ObjectType::DataMask).set_body({0x03}));
+        pool.add(VTObject{}.set_id(3).set_type(ObjectType::NumberVariable));
+
+        // Per object: 5 header bytes, the body, and 2 + 2 per child when there are children
+        CHECK(pool.serialized_size() == (5 + 2 + 4) + (5 + 1) + 5);
+
+        dp::Vector<u8> out = {0x11};
+        pool.serialize_into(out);
+        REQUIRE(out.size() == 1 + pool.serialized_size());
+        CHECK(out[0] == 0x11);
+
+        dp::Vector<u8> expected;
+        for (const auto &obj : pool.objects()) {
+            CHECK(obj.serialize().size() == obj.serialized_size());
+            auto bytes = obj.serialize();
+            expected.insert(expected.end(), bytes.begin(), bytes.end());
+        }
+        CHECK(dp::Vector<u8>(out.begin() + 1, out.end()) == expected);
+        CHECK(pool.serialize().value() == expected);
+    }
+
     SUBCASE("deserialize truncated data") {
         dp::Vector<u8> bad_data = {0x01, 0x00, 0x00, 0xFF, 0x00}; // body_len=255 but no data
         auto result = ObjectPool::deserialize(bad_data);
@@ -159,5 +182,145 @@ TEST_CASE("ObjectPool") {
         pool.clear();
         CHECK(pool.empty());
         CHECK(pool.size() == 0);
+        CHECK_FALSE(pool.find(1).has_value());
+        CHECK(pool.add(VTObject{}.set_id(1)).is_ok());
+    }
+
+    SUBCASE("ID index over a large pool") {
+        for (u32 i = 0; i < 6000; ++i) {
+            ObjectID id = static_cast<ObjectID>((i * 7919) & 0xFFFF); // Spread over the ID space
+            REQUIRE(pool.add(VTObject{}.set_id(id).set_type(ObjectType::OutputNumber)).is_ok());
+        }
+        CHECK(pool.size() == 6000);
+        CHECK(pool.add(VTObject{}.set_id(7919)).is_err());
+        CHECK(pool.contains(0xFFFF & (5999 * 7919)));
+        CHECK_FALSE(pool.contains(1));
+        auto found = pool.find(static_cast<ObjectID>(4321 * 7919));
+        REQUIRE(found.has_value());
+        CHECK((*found)->id == static_cast<ObjectID>(4321 * 7919));
+
+        auto bytes = pool.serialize().value();
+        auto copy = ObjectPool::deserialize(bytes);
+        REQUIRE(copy.is_ok());
+        CHECK(copy.value().size() == 6000);
+        CHECK(copy.value().find(static_cast<ObjectID>(4321 * 7919)).has_value());
+    }
+
+    SUBCASE("diff by ID and content") {
+        pool.add(VTObject{}.set_id(1).set_type(ObjectType::WorkingSet).set_children({2}));
+        pool.add(VTObject{}.set_id(2).set_type(ObjectType::DataMask).set_body({0x01}));
+        pool.add(VTObject{}.set_id(3).set_type(ObjectType::NumberVariable).set_body({1, 0, 0, 0}));
+        pool.add(VTObject{}.set_id(4).set_type(ObjectType::OutputString));
+
+        ObjectPool newer;
+        newer.add(VTObject{}.set_id(1).set_type(ObjectType::WorkingSet).set_children({2, 5}));
+        newer.add(VTObject{}.set_id(2).set_type(ObjectType::DataMask).set_body({0x01}));
+        newer.add(VTObject{}.set_id(3).set_type(ObjectType::NumberVariable).set_body({2, 0, 0, 0}));
+        newer.add(VTObject{}.set_id(5).set_type(ObjectType::OutputString));
+
+        auto d = pool.diff(newer);
+        CHECK(d.changed == dp::Vector<ObjectID>{1, 3});
+        CHECK(d.removed == dp::Vector<ObjectID>{4});
+        CHECK(d.added == dp::Vector<ObjectID>{5});
+        CHECK(d.size() == 4);
+        CHECK(pool.diff(pool).empty());
+
+        auto part = newer.subset({5, 1, 99});
+        REQUIRE(part.size() == 2);
+        CHECK(part.objects()[0].id == 1); // Pool order
+        CHECK(part.objects()[1].id == 5);
+    }
+}
+
+TEST_CASE("ObjectPool reverse children index") {
+    ObjectPool pool;
+    pool.add(VTObject().set_id(0).set_type(ObjectType::WorkingSet).set_children({1, 2}));
+    pool.add(VTObject().set_id(1).set_type(ObjectType::DataMask).set_children({10, 11}));
+    pool.add(VTObject().set_id(2).set_type(ObjectType::DataMask).set_children({10}));
+    pool.add(VTObject().set_id(10).set_type(ObjectType::Container).set_children({20}));
+    pool.add(VTObject().set_id(11).set_type(ObjectType::OutputNumber));
+    pool.add(VTObject().set_id(20).set_type(ObjectType::OutputString));
+
+    auto parents = pool.parents(10);
+    REQUIRE(parents.size() == 2);
+    CHECK(parents[0] == 1);
+    CHECK(parents[1] == 2);
+    CHECK(pool.parents(20).size() == 1);
+    CHECK(pool.parents(0).empty());
+    CHECK(pool.graph().edges() == 6);
+
+    SUBCASE("rebuilt after children change") {
+        (*pool.find(2))->children.push_back(11);
+        REQUIRE(pool.parents(11).size() == 2);
+        CHECK(pool.parents(11)[1] == 2);
+    }
+
+    SUBCASE("rebuilt after an add") {
+        pool.add(VTObject().set_id(3).set_type(ObjectType::AlarmMask).set_children({20}));
+        CHECK(pool.parents(20).size() == 2);
+    }
+}
+
+TEST_CASE("ObjectPool graph") {
+    ObjectPool pool;
+    pool.add(VTObject().set_id(0).set_type(ObjectType::WorkingSet).set_children({1, 2}));
+    pool.add(VTObject().set_id(1).set_type(ObjectType::DataMask).set_children({10, 11}));
+    pool.add(VTObject().set_id(2).set_type(ObjectType::AlarmMask).set_children({10}));
+    pool.add(VTObject().set_id(10).set_type(ObjectType::Container).set_children({20}));
+    pool.add(VTObject().set_id(11).set_type(ObjectType::OutputNumber));
+    pool.add(VTObject().set_id(20).set_type(ObjectType::OutputString));
+    pool.add(VTObject().set_id(30).set_type(ObjectType::Container).set_children({31})); // Listed by nothing
+    pool.add(VTObject().set_id(31).set_type(ObjectType::Rectangle));
+    pool.add(VTObject().set_id(40).set_type(ObjectType::FontAttributes)); // Named in attributes only
+
+    const auto &g = pool.graph();
+    CHECK(g.size() == 9);
+    CHECK(g.edges() == 7);
+    CHECK(g.working_sets() == 1);
+    CHECK(g.root() == 0);
+    CHECK(g.children(1).size() == 2);
+    CHECK(g.reachable_count() == 6);
+    CHECK(g.unreachable_count() == 3);
+    CHECK(pool.reachable(20));
+    CHECK_FALSE(pool.reachable(31));
+    CHECK_FALSE(pool.reachable(99));
+    CHECK(pool.validate().is_ok());
+
+    SUBCASE("masks containing an object") {
+        auto masks = pool.masks_containing(20);
+        REQUIRE(masks.size() == 2);
+        CHECK(masks[0] == 1);
+        CHECK(masks[1] == 2);
+        CHECK(pool.masks_containing(11).size() == 1);
+        CHECK(pool.masks_containing(31).empty());
+        CHECK(pool.masks_containing(0).empty());
+    }
+
+    SUBCASE("pruning keeps what the working set and attributes reach") {
+        CHECK(pool.prune_unreachable() == 2);
+        CHECK(pool.size() == 7);
+        CHECK_FALSE(pool.contains(30));
+        CHECK_FALSE(pool.contains(31));
+        CHECK(pool.contains(40));
+        CHECK(pool.find(20).has_value());
+        CHECK(pool.graph().unreachable_count() == 1); // The font
+        CHECK(pool.prune_unreachable() == 0);
+        CHECK(pool.validate().is_ok());
+    }
+
+    SUBCASE("dangling references counted, not followed") {
+        (*pool.find(11))->children.push_back(99);
+        CHECK(pool.graph().dangling() == 1);
+        CHECK(pool.graph().dangling_parent() == 11);
+        CHECK(pool.graph().edges() == 7);
+        CHECK(pool.validate().is_err());
+    }
+
+    SUBCASE("a pool without a working set prunes nothing") {
+        ObjectPool loose;
+        loose.add(VTObject().set_id(1).set_type(ObjectType::DataMask));
+        CHECK_FALSE(loose.graph().has_root());
+        CHECK(loose.prune_unreachable() == 0);
+        CHECK(loose.size() == 1);
     }
 }
@@ -0,0 +1,179 @@
+#include <doctest/doctest.h>
+#include <agrobus/isobus/vt/pool_image.hpp>
+
+using namespace agrobus::isobus;
+using namespace agrobus::isobus::vt;
+
+namespace {
+    ObjectPool sample_pool() {
+        ObjectPool pool;
+        pool.add(VTObject().set_id(0).set_type(ObjectType::WorkingSet).set_body({0x01, 0x02}).set_children({1}));
+        pool.add(VTObject().set_id(1).set_type(ObjectType::DataMask).set_body({0xAA}).set_children({2, 3}));
+        pool.add(VTObject().set_id(2).set_type(ObjectType::OutputString).set_body({'h', 'i'}));
+        pool.add(VTObject().set_id(3).set_type(ObjectType::NumberVariable));
+        return pool;
+    }
+} // namespace
+
+TEST_CASE("PoolImage parse") {
+    auto bytes = sample_pool().serialize().value();
+    const u8 *arena = bytes.data();
+
+    SUBCASE("takes the bytes over and indexes every object") {
+        auto result = PoolImage::parse(std::move(bytes));
+        REQUIRE(result.is_ok());
+        const PoolImage &image = result.value();
+        CHECK(image.size() == 4);
+        CHECK(image.bytes().data() == arena);
+        CHECK(image.contains(2));
+        CHECK_FALSE(image.contains(9));
+
+        auto str = image.find(2);
+        REQUIRE(str.has_value());
+        CHECK(str->type == ObjectType::OutputString);
+        REQUIRE(str->body.size() == 2);
+        CHECK(str->body[0] == 'h');
+        // Body points into the arena, no copy
+        CHECK(str->body.data() >= arena);
+        CHECK(str->body.data() < arena + image.bytes().size());
+    }
+
+    SUBCASE("bodies match ObjectPool::deserialize") {
+        auto pool = ObjectPool::deserialize(bytes).value();
+        auto image = PoolImage::parse(bytes).value();
+        REQUIRE(image.size() == pool.size());
+        for (usize i = 0; i < pool.size(); ++i) {
+            const auto &obj = pool.objects()[i];
+            ObjectView view = image[i];
+            CHECK(view.id == obj.id);
+            CHECK(view.type == obj.type);
+            CHECK(view.to_object().body == obj.body);
+            CHECK(view.children.empty());
+        }
+    }
+
+    SUBCASE("truncated body is rejected") {
+        // Drop the last object and the final byte of the string before it
+        bytes.resize(bytes.size() - 6);
+        CHECK_FALSE(PoolImage::parse(bytes).is_ok());
+    }
+
+    SUBCASE("duplicate ID is rejected") {
+        auto twice = bytes;
+        twice.insert(twice.end(), bytes.begin(), bytes.end());
+        CHECK_FALSE(PoolImage::parse(twice).is_ok());
+    }
+
+    SUBCASE("empty data") {
+        auto image = PoolImage::parse(dp::Vector<u8>{}).value();
+        CHECK(image.empty());
+        CHECK_FALSE(image.find(0).has_value());
+    }
+}
+
+TEST_CASE("PoolImage from_pool") {
+    auto pool = sample_pool();
+    auto image = PoolImage::from_pool(pool).value();
+
+    SUBCASE("children are decoded from the arena") {
+        auto mask = image.find(1);
+        REQUIRE(mask.has_value());
+        REQUIRE(mask->children.size() == 2);
+        CHECK(mask->children[0] == 2);
+        CHECK(mask->children[1] == 3);
+        REQUIRE(mask->body.size() == 1);
+        CHECK(mask->body[0] == 0xAA);
+        CHECK(image.find(3)->children.empty());
+    }
+
+    SUBCASE("round trip through to_pool") {
+        auto back = image.to_pool();
+        REQUIRE(back.size() == pool.size());
+        for (usize i = 0; i < pool.size(); ++i) {
+            CHECK(back.objects()[i].body == pool.objects()[i].body);
+            CHECK(back.objects()[i].children == pool.objects()[i].children);
+        }
+        CHECK(back.validate().is_ok());
+        CHECK(back.serialize().value() == pool.serialize().value());
+    }
+
+    SUBCASE("copies share the arena") {
+        PoolImage copy = image;
+        image.clear();
+        CHECK(image.empty());
+        REQUIRE(copy.size() == 4);
+        CHECK(copy.find(2)->body[1] == 'i');
+    }
+
+    SUBCASE("for_each visits objects in pool order") {
+        dp::Vector<ObjectID> ids;
+        image.for_each([&](const ObjectView &v) { ids.push_back(v.id); });
+        CHECK(ids == dp::Vector<ObjectID>{0, 1, 2, 3});
+    }
+}
+
+TEST_CASE("PoolImage overlay") {
+    auto base = PoolImage::from_pool(sample_pool()).value();
+    ObjectPool patch_pool;
+    patch_pool.add(VTObject().set_id(2).set_type(ObjectType::OutputString).set_body({'y', 'o', '!'}));
+    patch_pool.add(VTObject().set_id(7).set_type(ObjectType::NumberVariable).set_body({7, 0, 0, 0}));
+    auto patch = PoolImage::parse(patch_pool.serialize().value()).value();
+
+    auto merged = PoolImage::overlay(base, patch).value();
+    REQUIRE(merged.size() == 5);
+    CHECK(merged[2].id == 2); // Replaced in place
+    CHECK(merged[2].body.size() == 3);
+    CHECK(merged[2].body[0] == 'y');
+    CHECK(merged[4].id == 7); // Added at the end
+    CHECK(merged.find(3).has_value());
+}
+
+TEST_CASE("PoolAssembler") {
+    auto bytes = sample_pool().serialize().value();
+
+    SUBCASE("pieces split anywhere give the parsed image") {
+        for (usize cut = 0; cut <= bytes.size(); ++cut) {
+            PoolAssembler assembler;
+            REQUIRE(assembler.append(DataSpan(bytes.data(), cut)).is_ok());
+            REQUIRE(assembler.append(DataSpan(bytes.data() + cut, bytes.size() - cut)).is_ok());
+            CHECK(assembler.objects() == 4);
+            CHECK(assembler.pending() == 0);
+            auto image = assembler.finish();
+            REQUIRE(image.is_ok());
+            CHECK(image.value().size() == 4);
+            CHECK(image.value().bytes().size() == bytes.size());
+            CHECK(image.value().find(2)->body.size() == 2);
+            CHECK(assembler.size() == 0);
+        }
+    }
+
+    SUBCASE("objects are indexed as they complete") {
+        PoolAssembler assembler;
+        assembler.reserve(bytes.size());
+        ObjectPool first;
+        first.add(sample_pool().objects()[0]);
+        usize ws = first.serialize().value().size();
+        assembler.append(DataSpan(bytes.data(), ws)); // The working set and nothing more
+        CHECK(assembler.objects() == 1);
+        assembler.append(DataSpan(bytes.data() + ws, 3));
+        CHECK(assembler.objects() == 1);
+        CHECK(assembler.pending() == 3);
+    }
+
+    SUBCASE("an object cut off at the end fails finish") {
+        PoolAssembler assembler;
+        assembler.append(DataSpan(bytes.data(), bytes.size() - 1));
+        auto image = assembler.finish();
+        CHECK(image.is_err());
+        CHECK(assembler.size() == 0);
+    }
+
+    SUBCASE("duplicate IDs fail the upload") {
+        PoolAssembler assembler;
+        assembler.append(DataSpan(bytes));
+        CHECK(assembler.append(DataSpan(bytes)).is_err());
+        CHECK(assembler.failed());
+        CHECK(assembler.finish().is_err());
+        CHECK_FALSE(assembler.failed());
+    }
+}
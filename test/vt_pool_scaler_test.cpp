@@ -0,0 +1,99 @@
+#include <doctest/doctest.h>
+#include <agrobus/isobus/vt/pool_scaler.hpp>
+#include <cstdio>
+
+using namespace agrobus::isobus::vt;
+
+namespace {
+    // Working Set -> Data Mask -> Container (200x100) -> Rectangle (80x40),
+    // and a Key with an Output String (60x30) on it
+    ObjectPool design_pool() {
+        ObjectPool pool;
+        pool.add(VTObject().set_id(0).set_type(ObjectType::WorkingSet).set_body({1, 1, 0, 0}).add_child(1));
+        pool.add(VTObject().set_id(1).set_type(ObjectType::DataMask).set_body({0, 0xFF, 0xFF}).add_child(10));
+        pool.add(VTObject().set_id(10).set_type(ObjectType::Container).set_body({200, 0, 100, 0, 0}).add_child(11));
+        pool.add(VTObject().set_id(11).set_type(ObjectType::Rectangle).set_body({0x01, 0x5E, 80, 0, 40, 0, 0}));
+        pool.add(VTObject().set_id(20).set_type(ObjectType::Key).set_body({0, 1}).add_child(21));
+        pool.add(VTObject().set_id(21).set_type(ObjectType::OutputString).set_body({60, 0, 30, 0, 0, 0}));
+        return pool;
+    }
+
+    u16 field(const ObjectPool &pool, ObjectID id, usize at) {
+        const auto &body = (*pool.find(id))->body;
+        return static_cast<u16>(body[at] | (body[at + 1] << 8));
+    }
+} // namespace
+
+TEST_CASE("scale_pool - data mask and soft key ratios") {
+    VTGeometry design{480, 60, 60};
+    VTGeometry vt{720, 90, 120}; // Masks x1.5, keys x1.5 (the smaller ratio)
+    auto bytes = scale_pool(design_pool(), design, vt);
+    CHECK(bytes.size() == design_pool().serialized_size());
+
+    auto scaled = ObjectPool::deserialize(bytes).value();
+    CHECK(field(scaled, 10, 0) == 300);
+    CHECK(field(scaled, 10, 2) == 150);
+    CHECK(field(scaled, 11, 2) == 120); // Rectangle: behind the line attributes
+    CHECK(field(scaled, 11, 4) == 60);
+    CHECK(field(scaled, 21, 0) == 90);
+    CHECK(field(scaled, 21, 2) == 45);
+    CHECK((*scaled.find(1))->body[1] == 0xFF); // No size: untouched
+}
+
+TEST_CASE("scale_pool - same geometry is the serialized pool") {
+    VTGeometry g{480, 60, 60};
+    CHECK(scale_pool(design_pool(), g, g) == design_pool().serialize().value());
+}
+
+TEST_CASE("scale_pool - keeps sizes visible") {
+    auto bytes = scale_pool(design_pool(), VTGeometry{480, 60, 60}, VTGeometry{1, 1, 1});
+    auto scaled = ObjectPool::deserialize(bytes).value();
+    CHECK(field(scaled, 10, 0) == 1);
+    CHECK(field(scaled, 21, 2) == 1);
+}
+
+TEST_CASE("ScaledPoolCache - hits, label and budget") {
+    auto pool = design_pool();
+    u64 hash = IOPParser::content_hash(pool.serialize().value());
+    VTGeometry design{480, 60, 60};
+    ScaledPoolCache cache;
+
+    auto first = cache.get(hash, pool, design, VTGeometry{800, 80, 80});
+    CHECK(cache.misses() == 1);
+    CHECK(first->label == IOPParser::hash_to_version(first->bytes).value());
+    auto again = cache.get(hash, pool, design, VTGeometry{800, 80, 80});
+    CHECK(cache.hits() == 1);
+    CHECK(again == first);
+
+    cache.get(hash, pool, design, VTGeometry{240, 40, 40});
+    CHECK(cache.size() == 2);
+    CHECK(cache.bytes() == 2 * first->bytes.size());
+
+    SUBCASE("least recently used goes first") {
+        cache.find(hash, design, VTGeometry{800, 80, 80});
+        ScaledPoolCache small(first->bytes.size() + 1);
+        small.get(hash, pool, design, VTGeometry{800, 80, 80});
+        small.get(hash, pool, design, VTGeometry{240, 40, 40});
+        CHECK(small.size() == 1);
+        CHECK(small.find(hash, design, VTGeometry{240, 40, 40}) != nullptr);
+        CHECK(small.find(hash, design, VTGeometry{800, 80, 80}) == nullptr);
+        CHECK(first->bytes.size() > 0); // Handed-out pools outlive eviction
+    }
+
+    SUBCASE("save and load") {
+        const char *path = "/tmp/agrobus_scaled_pool_cache_test.bin";
+        REQUIRE(cache.save(path).is_ok());
+        ScaledPoolCache loaded;
+        REQUIRE(loaded.load(path).is_ok());
+        CHECK(loaded.size() == 2);
+        auto hit = loaded.find(hash, design, VTGeometry{800, 80, 80});
+        REQUIRE(hit != nullptr);
+        CHECK(hit->bytes == first->bytes);
+        CHECK(hit->label == first->label);
+        std::remove(path);
+
+        ScaledPoolCache missing;
+        CHECK(missing.load("/nonexistent/scaled.bin").is_ok());
+        CHECK(missing.size() == 0);
+    }
+}
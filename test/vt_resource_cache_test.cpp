@@ -0,0 +1,213 @@
+#include <doctest/doctest.h>
+#include <agrobus/isobus/vt/resource_cache.hpp>
+
+using namespace agrobus::isobus;
+using namespace agrobus::isobus::vt;
+
+namespace {
+    dp::Vector<u8> picture_body(u16 width, u16 height, PictureFormat format, u8 options, const dp::Vector<u8> &raw) {
+        dp::Vector<u8> body = {static_cast<u8>(width & 0xFF),
+                               static_cast<u8>(width >> 8),
+                               static_cast<u8>(width & 0xFF),
+                               static_cast<u8>(width >> 8),
+                               static_cast<u8>(height & 0xFF),
+                               static_cast<u8>(height >> 8),
+                               static_cast<u8>(format),
+                               options,
+                               0x05,
+                               static_cast<u8>(raw.size() & 0xFF),
+                               static_cast<u8>((raw.size() >> 8) & 0xFF),
+                               0,
+                               0,
+                               0};
+        for (auto b : raw)
+            body.push_back(b);
+        return body;
+    }
+
+    ObjectPool resource_pool() {
+        ObjectPool pool;
+        pool.add(VTObject().set_id(0).set_type(ObjectType::WorkingSet).set_children({1}));
+        pool.add(VTObject().set_id(1).set_type(ObjectType::DataMask).set_children({10}));
+        // 4x2, 8 bit, raw
+        pool.add(VTObject().set_id(10).set_type(ObjectType::PictureGraphic).set_body(
+            picture_body(4, 2, PictureFormat::Colour8Bit, 0, {1, 2, 3, 4, 5, 6, 7, 8})));
+        pool.add(VTObject().set_id(20).set_type(ObjectType::FontAttributes).set_body({3, 2, 0, 0, 0}));
+        return pool;
+    }
+} // namespace
+
+TEST_CASE("Picture graphic decoding") {
+    SUBCASE("monochrome rows start on a byte boundary") {
+        // 10 pixels wide: two bytes per row
+        auto pic =
+            decode_picture(DataSpan(picture_body(10, 2, PictureFormat::Monochrome, 0x01, {0xA5, 0xC0, 0xFF, 0x00})));
+        REQUIRE(pic.is_ok());
+        CHECK(pic.value().transparent);
+        CHECK(pic.value().transparency_colour == 5);
+        REQUIRE(pic.value().pixels.size() == 20);
+        u8 row0[10] = {1, 0, 1, 0, 0, 1, 0, 1, 1, 1};
+        for (u16 x = 0; x < 10; ++x)
+            CHECK(pic.value().at(x, 0) == row0[x]);
+        CHECK(pic.value().at(7, 1) == 1);
+        CHECK(pic.value().at(8, 1) == 0);
+    }
+
+    SUBCASE("4 bit, high nibble first") {
+        auto pic = decode_picture(DataSpan(picture_body(3, 1, PictureFormat::Colour4Bit, 0, {0x12, 0x30})));
+        REQUIRE(pic.is_ok());
+        CHECK(pic.value().at(0, 0) == 1);
+        CHECK(pic.value().at(1, 0) == 2);
+        CHECK(pic.value().at(2, 0) == 3);
+    }
+
+    SUBCASE("run-length encoded") {
+        // 8 bit, 5x2: runs of 3 x 7, 4 x 9, 3 x 1
+        auto pic = decode_picture(DataSpan(picture_body(5, 2, PictureFormat::Colour8Bit, 0x04, {3, 7, 4, 9, 3, 1})));
+        REQUIRE(pic.is_ok());
+        u8 expected[10] = {7, 7, 7, 9, 9, 9, 9, 1, 1, 1};
+        for (usize i = 0; i < 10; ++i)
+            CHECK(pic.value().pixels[i] == expected[i]);
+
+        auto mono = decode_picture(DataSpan(picture_body(16, 1, PictureFormat::Monochrome, 0x04, {2, 0xF0})));
+        REQUIRE(mono.is_ok());
+        CHECK(mono.value().at(0, 0) == 1);
+        CHECK(mono.value().at(4, 0) == 0);
+        CHECK(mono.value().at(12, 0) == 0);
+    }
+
+    SUBCASE("malformed bodies are refused") {
+        CHECK(decode_picture(DataSpan(dp::Vector<u8>{1, 2, 3})).is_err());
+        CHECK(decode_picture(DataSpan(picture_body(4, 2, PictureFormat::Colour8Bit, 0, {1, 2, 3}))).is_err());
+        CHECK(decode_picture(DataSpan(picture_body(4, 2, PictureFormat::Colour8Bit, 0x04, {2, 1}))).is_err());
+        CHECK(decode_picture(DataSpan(picture_body(1, 1, static_cast<PictureFormat>(7), 0, {0}))).is_err());
+    }
+
+    SUBCASE("font attributes") {
+        auto font = decode_font(DataSpan(dp::Vector<u8>{3, 2, 0, 0, 0}));
+        REQUIRE(font.is_ok());
+        CHECK(font.value().colour == 3);
+        CHECK(font.value().char_width == 8);
+        CHECK(font.value().char_height == 12);
+        CHECK(decode_font(DataSpan(dp::Vector<u8>{3, 20, 0, 0, 0})).is_err());
+    }
+}
+
+TEST_CASE("Picture graphic decoding matches a pixel at a time") {
+    // Widths on both sides of the vector steps, so the vector loops and the
+    // scalar tails both run, and runs both shorter and longer than a vector
+    for (u16 width : {1, 7, 15, 16, 17, 31, 32, 33, 63, 64, 65, 100, 129}) {
+        const u16 height = 3;
+        for (auto format : {PictureFormat::Monochrome, PictureFormat::Colour4Bit, PictureFormat::Colour8Bit}) {
+            CAPTURE(width);
+            CAPTURE(static_cast<int>(format));
+            usize stride = format == PictureFormat::Monochrome  ? (width + 7) / 8
+                           : format == PictureFormat::Colour4Bit ? (width + 1) / 2
+                                                                 : width;
+            dp::Vector<u8> packed(stride * height);
+            for (usize i = 0; i < packed.size(); ++i)
+                packed[i] = static_cast<u8>(i * 37 + width);
+
+            // The same bytes as runs of 1 to 40
+            dp::Vector<u8> runs;
+            dp::Vector<u8> expanded;
+            for (usize i = 0; expanded.size() < packed.size(); ++i) {
+                u8 run = static_cast<u8>(1 + (i * 13) % 40);
+                u8 value = static_cast<u8>(i * 29);
+                runs.push_back(run);
+                runs.push_back(value);
+                for (u8 r = 0; r < run; ++r)
+                    expanded.push_back(value);
+            }
+            expanded.resize(packed.size());
+
+            auto pixel = [&](const dp::Vector<u8> &bytes, u16 x, u16 y) -> u8 {
+                const u8 *row = bytes.data() + y * stride;
+                switch (format) {
+                case PictureFormat::Monochrome:
+                    return (row[x / 8] >> (7 - x % 8)) & 1;
+                case PictureFormat::Colour4Bit:
+                    return x % 2 == 0 ? row[x / 2] >> 4 : row[x / 2] & 0x0F;
+                default:
+                    return row[x];
+                }
+            };
+
+            auto raw = decode_picture(DataSpan(picture_body(width, height, format, 0, packed)));
+            auto rle = decode_picture(DataSpan(picture_body(width, height, format, 0x04, runs)));
+            REQUIRE(raw.is_ok());
+            REQUIRE(rle.is_ok());
+            usize mismatches = 0;
+            for (u16 y = 0; y < height; ++y) {
+                for (u16 x = 0; x < width; ++x) {
+                    mismatches += raw.value().at(x, y) != pixel(packed, x, y) ? 1 : 0;
+                    mismatches += rle.value().at(x, y) != pixel(expanded, x, y) ? 1 : 0;
+                }
+            }
+            CHECK(mismatches == 0);
+        }
+    }
+}
+
+TEST_CASE("VTResourceCache") {
+    auto pool = resource_pool();
+    VTResourceCache cache;
+
+    auto pic = cache.picture(1, pool, 10);
+    REQUIRE(pic.is_ok());
+    CHECK(pic.value()->at(3, 1) == 8);
+    CHECK(cache.misses() == 1);
+    CHECK(cache.picture(1, pool, 10).value() == pic.value());
+    CHECK(cache.hits() == 1);
+    CHECK(cache.font(1, pool, 20).value().char_height == 12);
+    CHECK(cache.size() == 2);
+    CHECK(cache.picture(1, pool, 20).is_err()); // Not a picture
+    CHECK(cache.picture(1, pool, 99).is_err());
+
+    SUBCASE("keyed by pool version") {
+        CHECK(cache.picture(2, pool, 10).is_ok());
+        CHECK(cache.size() == 3);
+        cache.drop_version(1);
+        CHECK(cache.size() == 1);
+    }
+
+    SUBCASE("changed objects are decoded again") {
+        (*pool.find(10))->body = picture_body(4, 2, PictureFormat::Colour8Bit, 0, {9, 9, 9, 9, 9, 9, 9, 9});
+        VTChangeJournal journal;
+        journal.set_pool(pool);
+        journal.take();
+        journal.mark(10);
+        cache.invalidate(1, journal.take());
+        CHECK(cache.size() == 1);
+        CHECK(cache.picture(1, pool, 10).value()->at(3, 1) == 9);
+    }
+
+    SUBCASE("least recently used pictures go first") {
+        for (ObjectID id = 11; id < 14; ++id)
+            pool.add(VTObject().set_id(id).set_type(ObjectType::PictureGraphic).set_body(
+                picture_body(32, 32, PictureFormat::Colour8Bit, 0x04, {255, 1, 255, 1, 255, 1, 255, 1, 4, 1})));
+        cache.clear();
+        REQUIRE(cache.picture(1, pool, 11).is_ok());
+        usize one = cache.bytes();
+        cache.set_budget(one * 2);
+        REQUIRE(cache.picture(1, pool, 12).is_ok());
+        REQUIRE(cache.picture(1, pool, 11).is_ok()); // 12 is now the older one
+        REQUIRE(cache.picture(1, pool, 13).is_ok());
+        CHECK(cache.evictions() == 1);
+        CHECK(cache.size() == 2);
+        CHECK(cache.bytes() <= cache.budget());
+        u64 misses = cache.misses();
+        REQUIRE(cache.picture(1, pool, 11).is_ok());
+        CHECK(cache.misses() == misses);
+        REQUIRE(cache.picture(1, pool, 12).is_ok());
+        CHECK(cache.misses() == misses + 1);
+    }
+
+    SUBCASE("PoolImage pools") {
+        auto image = PoolImage::parse(pool.serialize().value());
+        REQUIRE(image.is_ok());
+        auto from_image = cache.picture(3, image.value(), 10);
+        REQUIRE(from_image.is_ok());
+        CHECK(from_image.value()->at(0, 0) == 1);
+    }
+}
@@ -53,15 +53,176 @@ TEST_CASE("VTServer - client tracking") {
     CHECK(server.clients().empty());
 }
 
-TEST_CASE("VTServer - update sends status periodically") {
+TEST_CASE("VTServer - sends status periodically from the IsoNet timer wheel") {
+    LoopbackBus bus;
+    IsoNet nm_vt;
+    IsoNet nm_ecu;
+    auto *cf = nm_vt.create_internal(Name::build().set_identity_number(1), 0, 0x26).value();
+    nm_ecu.create_internal(Name::build().set_identity_number(2), 0, 0x80);
+    bus.attach(nm_vt);
+    bus.attach(nm_ecu);
+    u32 statuses = 0;
+    nm_ecu.register_pgn_callback(PGN_VT_TO_ECU, [&](const Message &msg) {
+        if (!msg.data.empty() && msg.data[0] == vt_cmd::VT_STATUS)
+            ++statuses;
+    });
+    auto run = [&](u32 steps) {
+        for (u32 i = 0; i < steps; ++i) {
+            nm_vt.update(100);
+            nm_ecu.update(100);
+        }
+    };
+
+    VTServer server(nm_vt, cf);
+    usize idle_timers = nm_vt.timers().size();
+    run(20);
+    CHECK(statuses == 0);
+
+    REQUIRE(server.start().is_ok());
+    CHECK(nm_vt.timers().size() == idle_timers + 1);
+    run(35); // VTServer::update() is not called: the status is on the network clock
+    CHECK(statuses == 3);
+
+    REQUIRE(server.stop().is_ok());
+    CHECK(nm_vt.timers().size() == idle_timers);
+    run(20);
+    CHECK(statuses == 3);
+}
+
+// ─── Uploads ─────────────────────────────────────────────────────────────────
+#include <agrobus/isobus/vt/client.hpp>
+#include <agrobus/net/loopback_bus.hpp>
+
+namespace {
+    ObjectPool upload_pool(u32 variables) {
+        ObjectPool pool;
+        pool.add(VTObject().set_id(0).set_type(ObjectType::WorkingSet).set_body({0xC8, 0x00, 0xC8, 0x00}));
+        pool.add(VTObject().set_id(1).set_type(ObjectType::DataMask).set_body({0x00}));
+        for (u32 i = 0; i < variables; ++i)
+            pool.add(VTObject()
+                         .set_id(static_cast<ObjectID>(100 + i))
+                         .set_type(ObjectType::NumberVariable)
+                         .set_body({static_cast<u8>(i), 0, 0, 0}));
+        return pool;
+    }
+
+    Message transfer(DataSpan bytes) {
+        dp::Vector<u8> data;
+        data.push_back(vt_cmd::OBJECT_POOL_TRANSFER);
+        data.insert(data.end(), bytes.begin(), bytes.end());
+        return Message(PGN_ECU_TO_VT, data, 0x80, 0x10);
+    }
+
+    Message end_of_pool() {
+        return Message(PGN_ECU_TO_VT, {vt_cmd::END_OF_POOL, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF}, 0x80, 0x10);
+    }
+} // namespace
+
+TEST_CASE("VTServer - multi-part pool upload") {
     IsoNet nm;
-    auto* cf = nm.create_internal(Name::build().set_identity_number(1), 0, 0x10).value();
+    auto *cf = nm.create_internal(Name::build().set_identity_number(1), 0, 0x10).value();
+    VTServer server(nm, cf);
+    server.start();
 
+    auto bytes = upload_pool(3).serialize().value();
+    nm.inject_message(Message(PGN_ECU_TO_VT, {vt_cmd::GET_MEMORY, 0xFF, 0, 0, 0, 0xFF, 0xFF, 0xFF}, 0x80, 0x10));
+    REQUIRE(server.clients().size() == 1);
+    const auto &client = server.clients()[0];
+
+    SUBCASE("transfers add up, cut inside an object") {
+        usize cut = 12; // Inside the data mask
+        nm.inject_message(transfer(DataSpan(bytes.data(), cut)));
+        CHECK(client.upload.objects() == 1);
+        nm.inject_message(transfer(DataSpan(bytes.data() + cut, bytes.size() - cut)));
+        CHECK(client.upload.objects() == 5);
+        CHECK_FALSE(client.pool_uploaded); // Only End of Object Pool takes it
+        nm.inject_message(end_of_pool());
+        CHECK(client.pool_uploaded);
+        CHECK(client.pool_complete);
+        CHECK(client.pool.size() == 5);
+        CHECK(client.pool.bytes().size() == bytes.size());
+    }
+
+    SUBCASE("a pool ending inside an object is rejected") {
+        nm.inject_message(transfer(DataSpan(bytes.data(), bytes.size() - 2)));
+        nm.inject_message(end_of_pool());
+        CHECK_FALSE(client.pool_uploaded);
+        CHECK_FALSE(client.pool_complete);
+    }
+
+    SUBCASE("after End of Object Pool transfers patch the pool") {
+        nm.inject_message(transfer(DataSpan(bytes)));
+        nm.inject_message(end_of_pool());
+        REQUIRE(client.pool.size() == 5);
+
+        ObjectPool patch;
+        patch.add(VTObject().set_id(100).set_type(ObjectType::NumberVariable).set_body({9, 0, 0, 0}));
+        patch.add(VTObject().set_id(200).set_type(ObjectType::NumberVariable).set_body({1, 0, 0, 0}));
+        auto patch_bytes = patch.serialize().value();
+        nm.inject_message(transfer(DataSpan(patch_bytes.data(), 7)));
+        nm.inject_message(transfer(DataSpan(patch_bytes.data() + 7, patch_bytes.size() - 7)));
+        nm.inject_message(end_of_pool());
+        CHECK(client.pool.size() == 6);
+        CHECK(client.pool.find(100)->body[0] == 9);
+    }
+}
+
+TEST_CASE("VTServer - streamed pool upload") {
+    LoopbackBus bus;
+    IsoNet nm_vt;
+    IsoNet nm_ecu;
+    VTServer server(nm_vt, nm_vt.create_internal(Name::build().set_identity_number(1), 0, 0x26).value(),
+                    VTServerConfig{}.streamed());
+    auto *ecu_cf = nm_ecu.create_internal(Name::build().set_identity_number(2), 0, 0x80).value();
+    bus.attach(nm_vt);
+    bus.attach(nm_ecu);
+    server.start();
+
+    u32 chunks = 0;
+    nm_vt.extended_transport_protocol().on_chunk.subscribe([&](TransportSession &, u32, DataSpan) { ++chunks; });
+
+    auto pool = upload_pool(400); // ~3.6 KB: ETP
+    VTClient client(nm_ecu, ecu_cf);
+    client.set_object_pool(pool);
+    REQUIRE(client.connect().is_ok());
+    for (u32 i = 0; i < 4000 && client.state() != VTState::Connected; ++i) {
+        nm_vt.update(5);
+        server.update(5);
+        nm_ecu.update(5);
+        client.update(5);
+    }
+    REQUIRE(client.state() == VTState::Connected);
+    CHECK(chunks > 1);
+    REQUIRE(server.clients().size() == 1);
+    CHECK(server.clients()[0].pool.size() == pool.size());
+    CHECK(server.clients()[0].pool.bytes().size() == pool.serialized_size());
+    CHECK(server.clients()[0].pool.find(499)->body[0] == static_cast<u8>(399));
+}
+
+TEST_CASE("VTServer - client table") {
+    IsoNet nm;
+    auto *cf = nm.create_internal(Name::build().set_identity_number(1), 0, 0x10).value();
     VTServer server(nm, cf);
     server.start();
 
-    // Should not crash
-    for (i32 i = 0; i < 20; ++i) {
-        server.update(100);
+    auto bytes = upload_pool(1).serialize().value();
+    for (Address addr = 0x80; addr < 0x90; ++addr) {
+        Message t = transfer(DataSpan(bytes));
+        t.source = addr;
+        Message end = end_of_pool();
+        end.source = addr;
+        nm.inject_message(t);
+        nm.inject_message(end);
     }
+    REQUIRE(server.clients().size() == 16);
+    for (Address addr = 0x80; addr < 0x90; ++addr) {
+        const ServerWorkingSet *client = server.client(addr);
+        REQUIRE(client);
+        CHECK(client->client_address == addr);
+        CHECK(client->pool_uploaded);
+    }
+    CHECK(server.client(0x90) == nullptr);
+
+    server.stop();
+    CHECK(server.client(0x80) == nullptr);
 }
@@ -0,0 +1,91 @@
+#include <doctest/doctest.h>
+#include <agrobus/isobus/vt/state_tracker.hpp>
+
+using namespace agrobus::isobus;
+using namespace agrobus::isobus::vt;
+
+TEST_CASE("VTObjectStates lookups") {
+    VTObjectStates s;
+    CHECK_FALSE(s.numeric_value(1).has_value());
+    CHECK_FALSE(s.string_value(1).has_value());
+    CHECK_FALSE(s.is_visible(1).has_value());
+
+    s.set_numeric_value(1, 42);
+    s.set_numeric_value(0xFFFE, 7);
+    s.set_visibility(300, false);
+    s.set_enable_state(300, true);
+    s.set_soft_key_mask(1000, 1001);
+    s.set_string_value(5, "hello");
+
+    CHECK(*s.numeric_value(1) == 42);
+    CHECK(*s.numeric_value(0xFFFE) == 7);
+    CHECK_FALSE(s.numeric_value(2).has_value());
+    CHECK(*s.is_visible(300) == false);
+    CHECK(*s.is_enabled(300) == true);
+    CHECK_FALSE(s.is_visible(301).has_value());
+    CHECK(*s.soft_key_mask_for(1000) == 1001);
+    CHECK(*s.string_value(5) == "hello");
+
+    SUBCASE("strings are rewritten in place when they fit") {
+        usize size = s.arena_size();
+        s.set_string_value(5, "hey");
+        CHECK(*s.string_value(5) == "hey");
+        CHECK(s.arena_size() == size);
+        s.set_string_value(5, "a longer string");
+        CHECK(*s.string_value(5) == "a longer string");
+        s.set_string_value(5, "");
+        CHECK(s.string_value(5)->empty());
+    }
+
+    SUBCASE("the arena is compacted") {
+        for (u32 i = 0; i < 2000; ++i)
+            s.set_string_value(6, dp::String(i % 40 + 1, 'x'));
+        CHECK(*s.string_value(5) == "hello");
+        CHECK(*s.string_value(6) == dp::String(40, 'x'));
+        CHECK(s.arena_size() < 16384);
+    }
+}
+
+TEST_CASE("VTObjectStates copies are snapshots") {
+    VTObjectStates live;
+    live.set_numeric_value(1, 1);
+    live.set_string_value(2, "before");
+
+    VTObjectStates copy = live;
+    live.set_numeric_value(1, 2);
+    live.set_numeric_value(600, 3);
+    live.set_string_value(2, "after");
+
+    CHECK(*copy.numeric_value(1) == 1);
+    CHECK_FALSE(copy.numeric_value(600).has_value());
+    CHECK(*copy.string_value(2) == "before");
+    CHECK(*live.numeric_value(1) == 2);
+    CHECK(*live.string_value(2) == "after");
+}
+
+TEST_CASE("VTClientStateTracker publishes object states") {
+    IsoNet nm;
+    VTClientStateTracker tracker(nm);
+    tracker.initialize();
+
+    u32 before = tracker.objects_snapshot().version();
+    nm.inject_message(Message(PGN_VT_TO_ECU, {vt_cmd::HIDE_SHOW, 0x10, 0x00, 0x01, 0xFF, 0xFF, 0xFF, 0xFF}, 0x26));
+    nm.inject_message(
+        Message(PGN_VT_TO_ECU, {vt_cmd::NUMERIC_VALUE_CHANGE, 0x11, 0x00, 0xFF, 0x2A, 0x00, 0x00, 0x00}, 0x26));
+    CHECK(tracker.objects_snapshot().version() == before + 2);
+
+    VTObjectStates ui = tracker.object_states();
+    CHECK(*ui.is_visible(0x10) == true);
+    CHECK(*ui.numeric_value(0x11) == 42);
+
+    // Manual injection shows up in the live table, in the snapshot only once published
+    tracker.set_numeric_value(0x11, 43);
+    CHECK(*tracker.numeric_value(0x11) == 43);
+    CHECK(*tracker.object_states().numeric_value(0x11) == 42);
+    tracker.publish_objects();
+    CHECK(*tracker.object_states().numeric_value(0x11) == 43);
+    CHECK(*ui.numeric_value(0x11) == 42);
+
+    tracker.reset();
+    CHECK_FALSE(tracker.object_states().is_visible(0x10).has_value());
+}
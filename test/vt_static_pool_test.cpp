@@ -0,0 +1,104 @@
+#include <doctest/doctest.h>
+#include <agrobus/isobus/vt/static_pool.hpp>
+
+using namespace agrobus::isobus::vt;
+
+namespace {
+    constexpr auto POOL = make_static_pool([] {
+        return StaticPoolBuilder<256, 8>{}
+            .add(0, ObjectType::WorkingSet, {0xC8, 0x00, 0xC8, 0x00}, {1000})
+            .add(1000, ObjectType::DataMask, {0x00}, {2000, 10})
+            .add(2000, ObjectType::OutputString, {0x04, 0x00, 'r', 'a', 't', 'e'})
+            .add(10, ObjectType::NumberVariable, {0x2A, 0x00, 0x00, 0x00});
+    });
+
+    ObjectPool same_pool() {
+        ObjectPool pool;
+        pool.add(
+            VTObject().set_id(0).set_type(ObjectType::WorkingSet).set_body({0xC8, 0x00, 0xC8, 0x00}).add_child(1000));
+        pool.add(VTObject().set_id(1000).set_type(ObjectType::DataMask).set_body({0x00}).add_child(2000).add_child(10));
+        pool.add(VTObject().set_id(2000).set_type(ObjectType::OutputString).set_body({0x04, 0x00, 'r', 'a', 't', 'e'}));
+        pool.add(VTObject().set_id(10).set_type(ObjectType::NumberVariable).set_body({0x2A, 0x00, 0x00, 0x00}));
+        return pool;
+    }
+} // namespace
+
+// Everything below the builder is settled by the compiler
+static_assert(POOL.count == 4);
+static_assert(POOL.size == POOL.data.size(), "trimmed to the bytes used");
+static_assert(POOL.index.size() == 4, "trimmed to the objects used");
+static_assert(POOL.index[0].id == 0 && POOL.index[1].id == 10 && POOL.index[3].id == 2000);
+static_assert(POOL.contains(1000) && !POOL.contains(3));
+static_assert(POOL.find_ref(10)->type == ObjectType::NumberVariable);
+static_assert(POOL.hash != 0);
+
+TEST_CASE("StaticPool - bytes match ObjectPool::serialize") {
+    auto bytes = same_pool().serialize().value();
+    REQUIRE(bytes.size() == POOL.size);
+    CHECK(dp::Vector<u8>(POOL.data.begin(), POOL.data.end()) == bytes);
+}
+
+TEST_CASE("StaticPool - version label matches IOPParser") {
+    auto bytes = same_pool().serialize().value();
+    CHECK(POOL.hash == IOPParser::content_hash(bytes));
+    CHECK(POOL.version_label() == IOPParser::hash_to_version(bytes).value());
+}
+
+TEST_CASE("StaticPool - content_hash is the same at compile time and run time") {
+    // Longer than one 32-byte stripe, with an 8-, a 4- and a 1-byte tail
+    static constexpr std::array<u8, 45> DATA = [] {
+        std::array<u8, 45> d{};
+        for (usize i = 0; i < d.size(); ++i)
+            d[i] = static_cast<u8>(i * 37 + 11);
+        return d;
+    }();
+    constexpr u64 at_compile_time = IOPParser::content_hash(DataSpan(DATA));
+    CHECK(at_compile_time == IOPParser::content_hash(dp::Vector<u8>(DATA.begin(), DATA.end())));
+}
+
+TEST_CASE("StaticPool - find views into the ROM bytes") {
+    auto mask = POOL.find(1000);
+    REQUIRE(mask.has_value());
+    CHECK(mask->type == ObjectType::DataMask);
+    CHECK(mask->body.size() == 1);
+    CHECK(mask->body.data() >= POOL.data.data());
+    CHECK(mask->body.data() < POOL.data.data() + POOL.size);
+    REQUIRE(mask->children.size() == 2);
+    CHECK(mask->children[0] == 2000);
+    CHECK(mask->children[1] == 10);
+
+    auto text = POOL.find(2000);
+    REQUIRE(text.has_value());
+    CHECK(text->body.size() == 6);
+    CHECK(text->children.empty());
+    CHECK_FALSE(POOL.find(3).has_value());
+}
+
+TEST_CASE("StaticPool - image and to_pool for tools") {
+    auto image = POOL.image();
+    REQUIRE(image.is_ok());
+    CHECK(image.value().size() == 4);
+    CHECK(image.value().bytes().data() == POOL.data.data()); // Not copied
+
+    auto pool = POOL.to_pool();
+    REQUIRE(pool.is_ok());
+    CHECK(pool.value().size() == 4);
+    CHECK(pool.value().contains(2000));
+}
+
+TEST_CASE("StaticPoolBuilder - capacity left over") {
+    constexpr auto builder = StaticPoolBuilder<64, 4>{}.add(7, ObjectType::NumberVariable, {1, 0, 0, 0});
+    constexpr auto pool = builder.finish();
+    static_assert(pool.data.size() == 64 && pool.size == 9);
+    static_assert(pool.count == 1 && pool.contains(7));
+    CHECK(pool.bytes().size() == 9);
+}
+
+TEST_CASE("StaticPoolBuilder - errors at run time leave the object out") {
+    StaticPoolBuilder<16, 2> builder;
+    builder.add(1, ObjectType::NumberVariable, {1, 0, 0, 0});
+    builder.add(1, ObjectType::NumberVariable, {2, 0, 0, 0}); // Duplicate
+    builder.add(2, ObjectType::NumberVariable, {1, 0, 0, 0}); // Past 16 bytes
+    CHECK(builder.count() == 1);
+    CHECK(builder.size() == 9);
+}
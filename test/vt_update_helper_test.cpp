@@ -0,0 +1,157 @@
+#include <doctest/doctest.h>
+#include <agrobus/isobus/vt/server.hpp>
+#include <agrobus/isobus/vt/update_helper.hpp>
+#include <agrobus/net/loopback_bus.hpp>
+
+using namespace agrobus::isobus;
+using namespace agrobus::isobus::vt;
+
+namespace {
+    ObjectPool helper_pool() {
+        ObjectPool pool;
+        pool.add(VTObject().set_id(0).set_type(ObjectType::WorkingSet).set_body({0xC8, 0x00, 0xC8, 0x00}));
+        pool.add(VTObject().set_id(1).set_type(ObjectType::DataMask).set_body({0x00}));
+        return pool;
+    }
+
+    // A client connected to a VTServer, counting the commands the VT receives
+    struct HelperBench {
+        LoopbackBus bus;
+        IsoNet nm_vt;
+        IsoNet nm_ecu;
+        VTServer server;
+        VTClient client;
+        VTClientStateTracker tracker;
+        u32 numeric = 0;
+        u32 hide_show = 0;
+        dp::Vector<u32> values;
+
+        HelperBench()
+            : server(nm_vt, nm_vt.create_internal(Name::build().set_identity_number(1), 0, 0x26).value()),
+              client(nm_ecu, nm_ecu.create_internal(Name::build().set_identity_number(2), 0, 0x80).value()),
+              tracker(nm_ecu) {
+            bus.attach(nm_vt);
+            bus.attach(nm_ecu);
+            server.start();
+            nm_vt.register_pgn_callback(PGN_ECU_TO_VT, [this](const Message &msg) {
+                if (msg.data.size() < 8)
+                    return;
+                if (msg.data[0] == vt_cmd::CHANGE_NUMERIC_VALUE) {
+                    ++numeric;
+                    values.push_back(static_cast<u32>(msg.data[4]) | (static_cast<u32>(msg.data[5]) << 8));
+                } else if (msg.data[0] == vt_cmd::HIDE_SHOW) {
+                    ++hide_show;
+                }
+            });
+            client.set_object_pool(helper_pool());
+        }
+
+        bool connect() {
+            if (!client.connect().is_ok())
+                return false;
+            for (u32 i = 0; i < 2000 && client.state() != VTState::Connected; ++i)
+                step(5);
+            return client.state() == VTState::Connected;
+        }
+
+        void step(u32 ms) {
+            nm_vt.update(ms);
+            server.update(ms);
+            nm_ecu.update(ms);
+            client.update(ms);
+        }
+    };
+} // namespace
+
+TEST_CASE("VTClientUpdateHelper skips tracked values") {
+    HelperBench b;
+    REQUIRE(b.connect());
+    VTClientUpdateHelper helper(b.client, b.tracker);
+
+    b.tracker.set_numeric_value(10, 5);
+    CHECK(helper.set_numeric_value(10, 5).is_ok());
+    CHECK(helper.set_numeric_value(10, 6).is_ok());
+    CHECK(helper.set_numeric_value(10, 6).is_ok());
+    b.step(5);
+    CHECK(b.numeric == 1);
+    CHECK(helper.sent_count() == 1);
+    CHECK(helper.skipped_count() == 2);
+}
+
+TEST_CASE("VTClientUpdateHelper batch coalescing") {
+    HelperBench b;
+    REQUIRE(b.connect());
+    VTClientUpdateHelper helper(b.client, b.tracker);
+
+    SUBCASE("last value per object and attribute wins") {
+        helper.begin_batch();
+        for (u32 v = 1; v <= 50; ++v)
+            helper.set_numeric_value(10, v);
+        helper.set_numeric_value(11, 7);
+        helper.hide(10);
+        helper.show(10);
+        CHECK(helper.pending_count() == 3);
+        CHECK(helper.coalesced_count() == 50);
+        CHECK(helper.end_batch().is_ok());
+        b.step(5);
+        CHECK(b.numeric == 2);
+        CHECK(b.hide_show == 1);
+        REQUIRE(b.values.size() == 2);
+        CHECK(b.values[0] == 50); // Position of the first update, value of the last
+        CHECK(b.values[1] == 7);
+        CHECK(*b.tracker.numeric_value(10) == 50);
+    }
+
+    SUBCASE("a value returning to the tracked one is dropped") {
+        b.tracker.set_numeric_value(10, 3);
+        helper.begin_batch();
+        helper.set_numeric_value(10, 4);
+        helper.set_numeric_value(10, 3);
+        CHECK(helper.end_batch().is_ok());
+        b.step(5);
+        CHECK(b.numeric == 0);
+        CHECK(helper.pending_count() == 0);
+    }
+
+    SUBCASE("cancel drops the batch") {
+        helper.begin_batch();
+        helper.set_numeric_value(10, 1);
+        helper.cancel_batch();
+        CHECK(helper.pending_count() == 0);
+        CHECK_FALSE(helper.is_batching());
+    }
+}
+
+TEST_CASE("VTClientUpdateHelper rate limit") {
+    HelperBench b;
+    REQUIRE(b.connect());
+    VTClientUpdateHelper helper(b.client, b.tracker);
+    helper.with_min_interval(100);
+
+    // A 1 kHz gauge feed over one second
+    for (u32 ms = 0; ms < 1000; ++ms) {
+        helper.set_numeric_value(10, ms);
+        helper.update(1);
+        if (ms % 5 == 0)
+            b.step(5);
+    }
+    for (u32 i = 0; i < 10; ++i) {
+        helper.update(5);
+        b.step(5);
+    }
+    CHECK(b.numeric == 11); // Every 100 ms, the last one at 1000 ms
+    CHECK(helper.pending_count() == 0);
+    REQUIRE_FALSE(b.values.empty());
+    CHECK(b.values.back() == 999); // The held value still goes out
+    CHECK(*b.tracker.numeric_value(10) == 999);
+
+    SUBCASE("other objects are not held back") {
+        u32 before = b.numeric;
+        helper.set_numeric_value(10, 1000); // Just sent: held
+        helper.set_numeric_value(11, 1);
+        helper.set_numeric_value(12, 1);
+        b.step(5);
+        CHECK(b.numeric == before + 2);
+        CHECK(helper.pending_count() == 1);
+    }
+}
@@ -281,6 +281,9 @@ TEST_CASE("AuxCapabilityDiscovery handle_response") {
         CHECK(received_caps.channels[1].aux_type == 1);
         CHECK(received_caps.channels[1].resolution == 4096);
         CHECK(received_caps.channels[1].function_type == 3);
+        REQUIRE(received_caps.channel(1) != nullptr);
+        CHECK(received_caps.channel(1)->resolution == 4096);
+        CHECK(received_caps.channel(7) == nullptr);
     }
 
     SUBCASE("handles empty response") {
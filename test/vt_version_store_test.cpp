@@ -0,0 +1,225 @@
+#include <doctest/doctest.h>
+#include <agrobus/isobus/vt/client.hpp>
+#include <agrobus/isobus/vt/server.hpp>
+#include <agrobus/isobus/vt/version_store.hpp>
+#include <agrobus/net/loopback_bus.hpp>
+#include <cstdio>
+
+using namespace agrobus::isobus;
+using namespace agrobus::isobus::vt;
+
+namespace {
+    ObjectPool store_pool(u8 value) {
+        ObjectPool pool;
+        pool.add(VTObject().set_id(0).set_type(ObjectType::WorkingSet).set_body({0xC8, 0x00, 0xC8, 0x00}));
+        pool.add(VTObject().set_id(1).set_type(ObjectType::DataMask).set_body({0x00}));
+        pool.add(VTObject().set_id(2).set_type(ObjectType::NumberVariable).set_body({value, 0, 0, 0}));
+        return pool;
+    }
+
+    dp::Vector<u8> store_bytes(u8 value) { return store_pool(value).serialize().value(); }
+
+    constexpr Name ECU_A{0xA000000000000001ULL};
+    constexpr Name ECU_B{0xA000000000000002ULL};
+} // namespace
+
+TEST_CASE("VTVersionStore") {
+    const char *path = "/tmp/agrobus_vt_version_store_test.bin";
+    std::remove(path);
+
+    VTVersionStore store;
+    REQUIRE(store.open(path).is_ok());
+    CHECK(store.versions() == 0);
+
+    SUBCASE("versions are keyed by NAME and label") {
+        REQUIRE(store.store(ECU_A, "V1", DataSpan(store_bytes(1))).is_ok());
+        REQUIRE(store.store(ECU_A, "V2", DataSpan(store_bytes(2))).is_ok());
+        REQUIRE(store.store(ECU_B, "V1", DataSpan(store_bytes(3))).is_ok());
+        CHECK(store.versions() == 3);
+        CHECK(store.list(ECU_A).size() == 2);
+        CHECK(store.list(ECU_A)[1].label == "V2");
+
+        auto a = store.load(ECU_A, "V1");
+        auto b = store.load(ECU_B, "V1");
+        REQUIRE(a.is_ok());
+        REQUIRE(b.is_ok());
+        CHECK(a.value().size() == 3);
+        CHECK(a.value().find(2)->body[0] == 1);
+        CHECK(b.value().find(2)->body[0] == 3);
+        CHECK(store.load(ECU_B, "V2").is_err());
+        CHECK(store.store(ECU_A, "", DataSpan(store_bytes(1))).is_err());
+    }
+
+    SUBCASE("versions survive reopening") {
+        REQUIRE(store.store(ECU_A, "V1", DataSpan(store_bytes(1))).is_ok());
+        REQUIRE(store.store(ECU_A, "V1", DataSpan(store_bytes(4))).is_ok());
+        REQUIRE(store.store(ECU_A, "V2", DataSpan(store_bytes(2))).is_ok());
+        CHECK(store.erase(ECU_A, "V2"));
+        CHECK_FALSE(store.erase(ECU_A, "V2"));
+        store.close();
+
+        VTVersionStore reopened;
+        REQUIRE(reopened.open(path).is_ok());
+        CHECK(reopened.versions() == 1);
+        CHECK_FALSE(reopened.contains(ECU_A, "V2"));
+        auto image = reopened.load(ECU_A, "V1");
+        REQUIRE(image.is_ok());
+        CHECK(image.value().find(2)->body[0] == 4); // The last store wins
+        CHECK(reopened.dead_bytes() > 0);
+    }
+
+    SUBCASE("loaded images outlive later stores and compaction") {
+        store.set_compaction_threshold(0);
+        REQUIRE(store.store(ECU_A, "V1", DataSpan(store_bytes(1))).is_ok());
+        auto before = store.load(ECU_A, "V1");
+        REQUIRE(before.is_ok());
+        usize one = store.file_size();
+
+        // Superseded bytes now match the live ones: compacted right away
+        REQUIRE(store.store(ECU_A, "V1", DataSpan(store_bytes(5))).is_ok());
+        CHECK(store.dead_bytes() == 0);
+        CHECK(store.file_size() == one);
+
+        CHECK(before.value().find(2)->body[0] == 1); // Still the bytes it was loaded from
+        auto after = store.load(ECU_A, "V1");
+        REQUIRE(after.is_ok());
+        CHECK(after.value().find(2)->body[0] == 5);
+    }
+
+    SUBCASE("explicit compaction keeps every live version") {
+        for (u8 i = 0; i < 5; ++i)
+            REQUIRE(store.store(ECU_A, "V1", DataSpan(store_bytes(i))).is_ok());
+        REQUIRE(store.store(ECU_B, "V1", DataSpan(store_bytes(9))).is_ok());
+        usize size = store.file_size();
+        REQUIRE(store.compact().is_ok());
+        CHECK(store.file_size() < size);
+        CHECK(store.versions() == 2);
+        CHECK(store.load(ECU_A, "V1").value().find(2)->body[0] == 4);
+        CHECK(store.load(ECU_B, "V1").value().find(2)->body[0] == 9);
+
+        store.close();
+        VTVersionStore reopened;
+        REQUIRE(reopened.open(path).is_ok());
+        CHECK(reopened.versions() == 2);
+    }
+
+    SUBCASE("a torn record is dropped on open") {
+        REQUIRE(store.store(ECU_A, "V1", DataSpan(store_bytes(1))).is_ok());
+        usize good = store.file_size();
+        store.close();
+
+        FILE *f = std::fopen(path, "ab");
+        REQUIRE(f);
+        VersionRecordHeader rec;
+        rec.size = 400; // Body never written
+        rec.name = ECU_A.raw;
+        rec.label_len = 2;
+        rec.label[0] = 'V';
+        rec.label[1] = '2';
+        std::fwrite(&rec, sizeof(rec), 1, f);
+        std::fclose(f);
+
+        VTVersionStore reopened;
+        REQUIRE(reopened.open(path).is_ok());
+        CHECK(reopened.versions() == 1);
+        CHECK(reopened.file_size() == good);
+        CHECK(reopened.load(ECU_A, "V1").is_ok());
+    }
+
+    SUBCASE("a corrupted pool is refused") {
+        REQUIRE(store.store(ECU_A, "V1", DataSpan(store_bytes(1))).is_ok());
+        usize end = store.file_size();
+        store.close();
+
+        FILE *f = std::fopen(path, "r+b");
+        REQUIRE(f);
+        std::fseek(f, static_cast<long>(end - 8), SEEK_SET); // Inside the pool bytes
+        std::fputc(0x5A, f);
+        std::fclose(f);
+
+        VTVersionStore reopened;
+        REQUIRE(reopened.open(path).is_ok());
+        CHECK(reopened.load(ECU_A, "V1").is_err());
+    }
+
+    store.close();
+    std::remove(path);
+}
+
+namespace {
+    // One key cycle: a fresh VT over the store file and a version-first client
+    struct VersionCycle {
+        LoopbackBus bus;
+        IsoNet nm_vt;
+        IsoNet nm_ecu;
+        VTServer server;
+        InternalCF *ecu_cf;
+        u32 uploads = 0;
+
+        explicit VersionCycle(const char *path)
+            : server(nm_vt, nm_vt.create_internal(Name::build().set_identity_number(1), 0, 0x26).value(),
+                     VTServerConfig{}.version_store(path)),
+              ecu_cf(nm_ecu.create_internal(Name::build().set_identity_number(2), 0, 0x80).value()) {
+            bus.attach(nm_vt);
+            bus.attach(nm_ecu);
+            // Versions are keyed by the client's NAME: the VT has to see its claim
+            nm_vt.start_address_claiming();
+            nm_ecu.start_address_claiming();
+            for (u32 i = 0; i < 60; ++i) {
+                nm_vt.update(5);
+                nm_ecu.update(5);
+            }
+            nm_vt.register_pgn_callback(PGN_ECU_TO_VT, [this](const Message &msg) {
+                if (!msg.data.empty() && msg.data[0] == vt_cmd::OBJECT_POOL_TRANSFER)
+                    ++uploads;
+            });
+        }
+
+        // Connect, let the store version round trip finish; true if the pool came from a stored version
+        bool connect() {
+            VTClient client(nm_ecu, ecu_cf, VTClientConfig{}.stored_version("POOLV1"));
+            client.set_object_pool(store_pool(7));
+            REQUIRE(client.connect().is_ok());
+            for (u32 i = 0; i < 2000 && client.state() != VTState::Connected; ++i)
+                step(client);
+            REQUIRE(client.state() == VTState::Connected);
+            for (u32 i = 0; i < 10; ++i)
+                step(client);
+            return client.pool_from_version();
+        }
+
+        void step(VTClient &client) {
+            nm_vt.update(5);
+            server.update(5);
+            nm_ecu.update(5);
+            client.update(5);
+        }
+    };
+} // namespace
+
+TEST_CASE("VTServer keeps stored versions across restarts") {
+    const char *path = "/tmp/agrobus_vt_server_versions_test.bin";
+    std::remove(path);
+
+    {
+        VersionCycle first(path);
+        REQUIRE(first.server.start().is_ok());
+        CHECK_FALSE(first.connect());
+        CHECK(first.uploads == 1);
+        CHECK(first.server.version_store().contains(first.ecu_cf->name(), "POOLV1"));
+        REQUIRE(first.server.clients().size() == 1);
+        CHECK(first.server.clients()[0].stored_versions.empty()); // Not kept in RAM
+    }
+
+    // Power cycle: a new VT over the same file loads the pool without an upload
+    VersionCycle second(path);
+    REQUIRE(second.server.start().is_ok());
+    CHECK(second.connect());
+    CHECK(second.uploads == 0);
+    REQUIRE(second.server.clients().size() == 1);
+    CHECK(second.server.clients()[0].pool.size() == 3);
+    CHECK(second.server.clients()[0].pool.find(2)->body[0] == 7);
+
+    second.server.stop();
+    std::remove(path);
+}
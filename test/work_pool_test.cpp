@@ -0,0 +1,155 @@
+#include <doctest/doctest.h>
+#include <agrobus/isobus/vt/server.hpp>
+#include <agrobus/net/network_manager.hpp>
+#include <agrobus/net/work_pool.hpp>
+#include <chrono>
+#include <thread>
+
+using namespace agrobus::net;
+using namespace agrobus::isobus::vt;
+
+namespace {
+
+    // update() until `ready` or about a second has passed
+    template <typename F> bool pump(IsoNet &nm, F ready) {
+        for (i32 i = 0; i < 1000 && !ready(); ++i) {
+            nm.update(0);
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return ready();
+    }
+
+} // namespace
+
+TEST_CASE("WorkPool runs every job and hands continuations back") {
+    WorkPool pool(4);
+    CHECK(pool.threads() == 4);
+    std::atomic<u32> ran{0};
+    std::atomic<u32> completed{0};
+    for (u32 i = 0; i < 1000; ++i) {
+        pool.submit([&]() {
+            ran.fetch_add(1);
+            pool.complete([&]() { completed.fetch_add(1); });
+        });
+    }
+    usize drained = 0;
+    for (i32 i = 0; i < 2000 && drained < 1000; ++i) {
+        drained += pool.drain();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    CHECK(ran.load() == 1000);
+    CHECK(drained == 1000);
+    CHECK(completed.load() == 1000);
+    CHECK_FALSE(pool.has_completions());
+}
+
+TEST_CASE("IsoNet::offload runs inline without a pool") {
+    IsoNet nm;
+    CHECK(nm.work_pool() == nullptr);
+    i32 got = 0;
+    nm.offload([]() { return 41 + 1; }, [&](i32 v) { got = v; });
+    CHECK(got == 42);
+}
+
+TEST_CASE("IsoNet::offload continues on the network thread") {
+    IsoNet nm(NetworkConfig{}.work_pool(2));
+    REQUIRE(nm.work_pool() != nullptr);
+    CHECK(nm.wait_fd() >= 0);
+
+    auto network_thread = std::this_thread::get_id();
+    std::thread::id worker_thread;
+    std::thread::id done_thread;
+    bool done = false;
+    nm.offload(
+        [&]() {
+            worker_thread = std::this_thread::get_id();
+            return dp::String("parsed");
+        },
+        [&](dp::String s) {
+            done_thread = std::this_thread::get_id();
+            done = s == "parsed";
+        });
+    CHECK(pump(nm, [&]() { return done; }));
+    CHECK(worker_thread != network_thread);
+    CHECK(done_thread == network_thread);
+}
+
+TEST_CASE("VTServer parses uploaded pools off the network thread") {
+    IsoNet nm(NetworkConfig{}.work_pool(1));
+    auto *cf = nm.create_internal(Name::build().set_identity_number(1), 0, 0x26).value();
+    VTServer server(nm, cf);
+    server.start();
+
+    ObjectPool pool;
+    VTObject ws;
+    ws.id = 1;
+    ws.type = ObjectType::WorkingSet;
+    pool.add(std::move(ws));
+    auto bytes = pool.serialize();
+    REQUIRE(bytes.is_ok());
+
+    dp::Vector<u8> transfer;
+    transfer.push_back(vt_cmd::OBJECT_POOL_TRANSFER);
+    for (u8 b : bytes.value())
+        transfer.push_back(b);
+    nm.inject_message(Message(PGN_ECU_TO_VT, transfer, 0x80, 0x26));
+    Message end_of_pool(PGN_ECU_TO_VT, {vt_cmd::END_OF_POOL, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF}, 0x80, 0x26);
+    nm.inject_message(end_of_pool);
+
+    // End of Object Pool waits for the parse instead of answering "no pool"
+    REQUIRE(server.clients().size() == 1);
+    CHECK(server.clients()[0].pools_parsing == 1);
+    CHECK(server.clients()[0].end_of_pool_waiting);
+    CHECK_FALSE(server.clients()[0].pool_uploaded);
+
+    CHECK(pump(nm, [&]() { return server.clients()[0].pool_uploaded; }));
+    CHECK(server.clients()[0].pools_parsing == 0);
+    CHECK_FALSE(server.clients()[0].end_of_pool_waiting);
+    CHECK(server.clients()[0].pool.size() == 1);
+}
+
+TEST_CASE("VTServer keeps serving other clients while one's pool is indexed") {
+    IsoNet nm(NetworkConfig{}.work_pool(2));
+    auto *cf = nm.create_internal(Name::build().set_identity_number(1), 0, 0x26).value();
+    VTServer server(nm, cf);
+    server.start();
+    dp::Vector<u32> values;
+    server.on_numeric_value_change.subscribe([&](ObjectID, u32 value) { values.push_back(value); });
+    dp::Vector<Address> connected;
+    server.on_client_connected.subscribe([&](Address addr) { connected.push_back(addr); });
+
+    ObjectPool pool;
+    pool.add(VTObject().set_id(0).set_type(ObjectType::WorkingSet).set_body({0xC8, 0x00, 0xC8, 0x00}));
+    for (u16 i = 0; i < 2000; ++i)
+        pool.add(VTObject().set_id(static_cast<ObjectID>(100 + i)).set_type(ObjectType::NumberVariable).set_body(
+            {0, 0, 0, 0}));
+    auto bytes = pool.serialize().value();
+    dp::Vector<u8> transfer;
+    transfer.push_back(vt_cmd::OBJECT_POOL_TRANSFER);
+    transfer.insert(transfer.end(), bytes.begin(), bytes.end());
+
+    auto command = [](u8 function, Address source) {
+        return Message(PGN_ECU_TO_VT, {function, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF}, source, 0x26);
+    };
+    // 0x80 uploads and activates: the activation waits behind the transfer being indexed
+    nm.inject_message(Message(PGN_ECU_TO_VT, transfer, 0x80, 0x26));
+    nm.inject_message(command(vt_cmd::END_OF_POOL, 0x80));
+    nm.inject_message(command(vt_cmd::POOL_ACTIVATE, 0x80));
+    const ServerWorkingSet *slow = server.client(0x80);
+    REQUIRE(slow);
+    CHECK(slow->pools_parsing == 1);
+    CHECK(slow->deferred.size() == 2);
+
+    // 0x81 is not held up by it
+    nm.inject_message(Message(PGN_ECU_TO_VT, {vt_cmd::CHANGE_NUMERIC_VALUE, 0x64, 0x00, 0xFF, 7, 0, 0, 0}, 0x81, 0x26));
+    CHECK(values.size() == 1);
+    CHECK(connected.empty());
+
+    // Once indexed, 0x80's commands run in order: the pool is in when the activation comes
+    CHECK(pump(nm, [&]() { return !connected.empty(); }));
+    CHECK(connected[0] == 0x80);
+    CHECK(slow->pool_activated);
+    CHECK(slow->pool.size() == 2001);
+    CHECK(slow->deferred.empty());
+    CHECK_FALSE(slow->end_of_pool_waiting);
+}
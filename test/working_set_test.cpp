@@ -0,0 +1,146 @@
+#include <doctest/doctest.h>
+#include <agrobus/isobus/tc/client.hpp>
+#include <agrobus/isobus/vt/client.hpp>
+#include <agrobus/net/working_set.hpp>
+#include <wirebit/can/can_endpoint.hpp>
+#include <wirebit/link.hpp>
+#include <cstring>
+
+using namespace agrobus::net;
+
+// Records every frame written to the bus
+class WSMockLink : public wirebit::Link {
+    dp::Vector<wirebit::Frame> tx_log_;
+
+public:
+    wirebit::Result<wirebit::Unit, wirebit::Error> send(const wirebit::Frame& frame) override {
+        tx_log_.push_back(frame);
+        return wirebit::Result<wirebit::Unit, wirebit::Error>::ok(wirebit::Unit{});
+    }
+
+    wirebit::Result<wirebit::Frame, wirebit::Error> recv() override {
+        return wirebit::Result<wirebit::Frame, wirebit::Error>::err(wirebit::Error::timeout("empty"));
+    }
+
+    bool can_send() const override { return true; }
+    bool can_recv() const override { return false; }
+    wirebit::String name() const override { return "ws_mock_vcan0"; }
+
+    dp::Vector<PGN> sent_pgns() const {
+        dp::Vector<PGN> result;
+        for (const auto& f : tx_log_) {
+            if (f.payload.size() == sizeof(can_frame)) {
+                can_frame cf;
+                std::memcpy(&cf, f.payload.data(), sizeof(can_frame));
+                result.push_back(Identifier(cf.can_id & CAN_EFF_MASK).pgn());
+            }
+        }
+        return result;
+    }
+
+    usize count(PGN pgn) const {
+        usize n = 0;
+        for (PGN p : sent_pgns())
+            n += p == pgn;
+        return n;
+    }
+
+    void clear_sent() { tx_log_.clear(); }
+};
+
+struct WSFixture {
+    std::shared_ptr<WSMockLink> link = std::make_shared<WSMockLink>();
+    wirebit::CanEndpoint ep{link, wirebit::CanConfig{}, 1};
+    IsoNet nm;
+    InternalCF* cf = nullptr;
+
+    WSFixture() {
+        nm.set_endpoint(0, &ep);
+        cf = nm.create_internal(Name::build().set_identity_number(7), 0, 0x28).value();
+    }
+};
+
+TEST_CASE("WorkingSetManager sends master and members as one burst") {
+    WSFixture fx;
+    WorkingSetManager ws(fx.nm, fx.cf);
+    REQUIRE(ws.initialize().is_ok());
+    ws.add_member(Name::build().set_identity_number(8));
+    ws.add_member(Name::build().set_identity_number(9));
+
+    SUBCASE("burst") {
+        ws.set_member_interval(0);
+        REQUIRE(ws.broadcast_working_set().is_ok());
+        auto pgns = fx.link->sent_pgns();
+        REQUIRE(pgns.size() == 3);
+        CHECK(pgns[0] == PGN_WORKING_SET_MASTER);
+        CHECK(pgns[1] == PGN_WORKING_SET_MEMBER);
+        CHECK(pgns[2] == PGN_WORKING_SET_MEMBER);
+        CHECK_FALSE(ws.is_broadcasting());
+    }
+
+    SUBCASE("paced") {
+        REQUIRE(ws.broadcast_working_set().is_ok());
+        CHECK(fx.link->sent_pgns().size() == 1);
+        CHECK(ws.is_broadcasting());
+        ws.update(100);
+        ws.update(100);
+        CHECK(fx.link->count(PGN_WORKING_SET_MEMBER) == 2);
+        CHECK_FALSE(ws.is_broadcasting());
+    }
+}
+
+TEST_CASE("WorkingSetManager announces once until the set changes") {
+    WSFixture fx;
+    WorkingSetManager ws(fx.nm, fx.cf);
+    REQUIRE(ws.announce().is_ok());
+    CHECK(ws.announce().is_ok());
+    CHECK(fx.link->count(PGN_WORKING_SET_MASTER) == 1);
+
+    ws.add_member(Name::build().set_identity_number(8));
+    CHECK_FALSE(ws.is_announced());
+    CHECK(ws.announce().is_ok());
+    CHECK(fx.link->count(PGN_WORKING_SET_MASTER) == 2);
+}
+
+TEST_CASE("VT and TC clients share one working set announcement") {
+    WSFixture fx;
+    WorkingSetManager ws(fx.nm, fx.cf);
+    agrobus::isobus::vt::VTClient vt(fx.nm, fx.cf);
+    agrobus::isobus::tc::TaskControllerClient tc(fx.nm, fx.cf);
+    vt.set_working_set_manager(&ws);
+    tc.set_working_set_manager(&ws);
+
+    REQUIRE(ws.announce().is_ok()); // First client to connect
+    fx.link->clear_sent();
+    CHECK(ws.announce().is_ok()); // The next one finds it done
+    CHECK(fx.link->count(PGN_WORKING_SET_MASTER) == 0);
+}
+
+TEST_CASE("WorkingSetManager indexes remote sets by master address") {
+    IsoNet nm;
+    auto* cf = nm.create_internal(Name::build().set_identity_number(1), 0, 0x28).value();
+    WorkingSetManager ws(nm, cf);
+    REQUIRE(ws.initialize().is_ok());
+
+    auto member = Name::build().set_identity_number(42);
+    auto bytes = member.to_bytes();
+    nm.inject_message(Message(PGN_WORKING_SET_MASTER, {2, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF}, 0x80));
+    nm.inject_message(Message(PGN_WORKING_SET_MASTER, {1, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF}, 0x90));
+    nm.inject_message(Message(PGN_WORKING_SET_MEMBER, Payload(bytes.data(), 8), 0x80));
+
+    const auto* set = ws.find_remote_set(0x80);
+    REQUIRE(set != nullptr);
+    CHECK(set->master == 0x80);
+    CHECK(set->announced_size == 2);
+    REQUIRE(set->members.size() == 1);
+    CHECK(set->members[0] == member);
+    CHECK(set->complete());
+    CHECK(ws.find_remote_set(0x90)->members.empty());
+    CHECK(ws.find_remote_set(0x91) == nullptr);
+    CHECK(ws.remote_sets().size() == 2);
+
+    // A new master message starts the set over
+    nm.inject_message(Message(PGN_WORKING_SET_MASTER, {2, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF}, 0x80));
+    CHECK(ws.get_remote_set(0x80)->empty());
+    CHECK_FALSE(ws.find_remote_set(0x80)->complete());
+}